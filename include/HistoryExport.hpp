@@ -0,0 +1,660 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "MetricEvents.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ucc
+{
+
+/**
+ * @brief A GetMonitorFramesSince / GetMonitorFramesPage blob, read in place
+ *
+ * Layout: MetricsHistoryStore::querySinceFrames().  Values are copied out
+ * with memcpy, so the blob needs no alignment.
+ */
+struct MetricFramesView
+{
+  uint64_t metricMask = 0;  ///< Bit i: column for MetricId i
+  uint32_t rows = 0;
+  const uint8_t *timestamps = nullptr;
+  const uint8_t *columns = nullptr;
+
+  /// nullopt if @p size does not match the header
+  [[nodiscard]] static std::optional< MetricFramesView > parse( const uint8_t *data, size_t size ) noexcept
+  {
+    MetricFramesView v;
+    if ( size < sizeof( v.metricMask ) + sizeof( v.rows ) )
+      return std::nullopt;
+    std::memcpy( &v.metricMask, data, sizeof( v.metricMask ) );
+    std::memcpy( &v.rows, data + sizeof( v.metricMask ), sizeof( v.rows ) );
+    const size_t header = sizeof( v.metricMask ) + sizeof( v.rows );
+    const size_t expected = header + size_t( v.rows ) * sizeof( int64_t )
+                            + size_t( std::popcount( v.metricMask ) ) * v.rows * sizeof( double );
+    if ( size != expected )
+      return std::nullopt;
+    v.timestamps = data + header;
+    v.columns = v.timestamps + size_t( v.rows ) * sizeof( int64_t );
+    return v;
+  }
+
+  [[nodiscard]] size_t columnCount() const noexcept { return static_cast< size_t >( std::popcount( metricMask ) ); }
+
+  [[nodiscard]] int64_t timestamp( uint32_t row ) const noexcept
+  {
+    int64_t ts;
+    std::memcpy( &ts, timestamps + size_t( row ) * sizeof( ts ), sizeof( ts ) );
+    return ts;
+  }
+
+  /// Value of the @p column-th selected metric, NaN where it had no sample
+  [[nodiscard]] double value( size_t column, uint32_t row ) const noexcept
+  {
+    double v;
+    std::memcpy( &v, columns + ( column * rows + row ) * sizeof( v ), sizeof( v ) );
+    return v;
+  }
+};
+
+enum class HistoryExportFormat : uint8_t
+{
+  Csv,
+  Parquet,
+};
+
+/// "csv" / "parquet", or the extension of @p path ending in one of them
+[[nodiscard]] inline std::optional< HistoryExportFormat > parseHistoryExportFormat( std::string_view name ) noexcept
+{
+  const auto endsWith = [ name ]( std::string_view suffix ) {
+    return name.size() >= suffix.size()
+           && std::equal( suffix.rbegin(), suffix.rend(), name.rbegin(),
+                          []( char a, char b ) { return a == ( b >= 'A' && b <= 'Z' ? b - 'A' + 'a' : b ); } );
+  };
+  if ( endsWith( "csv" ) )
+    return HistoryExportFormat::Csv;
+  if ( endsWith( "parquet" ) )
+    return HistoryExportFormat::Parquet;
+  return std::nullopt;
+}
+
+/**
+ * @brief Streams monitoring history as a table into a file
+ *
+ * Columns: "timestamp" (Unix epoch ms), one per metric (empty / null where
+ * the metric had no sample), then "event", "eventLabel" and "eventValue",
+ * set only on the rows of event annotations.  Rows arrive in time order
+ * and leave the writer within a bounded buffer, so a long window costs no
+ * more memory than a short one.
+ */
+class HistoryExportWriter
+{
+public:
+  virtual ~HistoryExportWriter() = default;
+
+  /// Must be called first, once
+  virtual void begin( const std::vector< std::string > &metrics ) = 0;
+  /// One sample row; @p values holds one entry per metric, NaN for none
+  virtual void row( int64_t timestampMs, std::span< const double > values ) = 0;
+  virtual void event( const MetricEventRecord &event ) = 0;
+  /// Write what is buffered and the trailer; false if the stream failed
+  virtual bool finish() = 0;
+};
+
+/**
+ * @brief RFC 4180 CSV with a header line
+ */
+class CsvHistoryWriter : public HistoryExportWriter
+{
+public:
+  explicit CsvHistoryWriter( std::ostream &out ) : m_out( out ) {}
+
+  void begin( const std::vector< std::string > &metrics ) override
+  {
+    m_metrics = metrics.size();
+    m_line = "timestamp";
+    for ( const auto &name : metrics )
+      appendField( name );
+    m_line += ",event,eventLabel,eventValue\n";
+    m_out << m_line;
+  }
+
+  void row( int64_t timestampMs, std::span< const double > values ) override
+  {
+    m_line.clear();
+    appendNumber( timestampMs );
+    for ( size_t i = 0; i < m_metrics; ++i )
+    {
+      m_line += ',';
+      if ( i < values.size() && !std::isnan( values[ i ] ) )
+        appendNumber( values[ i ] );
+    }
+    m_line += ",,,\n";
+    m_out << m_line;
+  }
+
+  void event( const MetricEventRecord &event ) override
+  {
+    m_line.clear();
+    appendNumber( event.timestampMs );
+    m_line.append( m_metrics, ',' );
+    appendField( metricEventKindName( event.kind ) );
+    appendField( event.labelView() );
+    m_line += ',';
+    appendNumber( event.value );
+    m_line += '\n';
+    m_out << m_line;
+  }
+
+  bool finish() override
+  {
+    m_out.flush();
+    return static_cast< bool >( m_out );
+  }
+
+private:
+  template< typename T >
+  void appendNumber( T value )
+  {
+    char buf[ 32 ];
+    const auto result = std::to_chars( buf, buf + sizeof( buf ), value );
+    m_line.append( buf, result.ptr );
+  }
+
+  /// ",field", quoted when it holds a separator, quote or line break
+  void appendField( std::string_view field )
+  {
+    m_line += ',';
+    if ( field.find_first_of( ",\"\r\n" ) == std::string_view::npos )
+    {
+      m_line += field;
+      return;
+    }
+    m_line += '"';
+    for ( const char c : field )
+    {
+      if ( c == '"' )
+        m_line += '"';
+      m_line += c;
+    }
+    m_line += '"';
+  }
+
+  std::ostream &m_out;
+  size_t m_metrics = 0;
+  std::string m_line;
+};
+
+/**
+ * @brief Apache Parquet, uncompressed, written without a Parquet library
+ *
+ * Every ROW_GROUP_ROWS rows become one row group with one PLAIN encoded
+ * data page per column, which bounds the buffer to ROW_GROUP_ROWS rows.
+ * "timestamp" is a required INT64 annotated TIMESTAMP_MILLIS; metrics are
+ * optional DOUBLE, event kind and label optional UTF8 strings and the
+ * event value an optional INT32.  The footer is Thrift compact protocol,
+ * as the format requires; pandas, Polars, DuckDB and Arrow read the file.
+ */
+class ParquetHistoryWriter : public HistoryExportWriter
+{
+public:
+  static constexpr size_t ROW_GROUP_ROWS = 16384;
+
+  static_assert( std::endian::native == std::endian::little, "Parquet PLAIN values are little endian" );
+
+  explicit ParquetHistoryWriter( std::ostream &out, size_t rowGroupRows = ROW_GROUP_ROWS )
+    : m_out( out ), m_rowGroupRows( std::max< size_t >( rowGroupRows, 1 ) )
+  {
+  }
+
+  void begin( const std::vector< std::string > &metrics ) override
+  {
+    m_columns.clear();
+    addColumn( "timestamp", Type::Int64, false, ConvertedType::TimestampMillis );
+    for ( const auto &name : metrics )
+      addColumn( name, Type::Double, true );
+    addColumn( "event", Type::ByteArray, true, ConvertedType::Utf8 );
+    addColumn( "eventLabel", Type::ByteArray, true, ConvertedType::Utf8 );
+    addColumn( "eventValue", Type::Int32, true );
+    write( MAGIC );
+  }
+
+  void row( int64_t timestampMs, std::span< const double > values ) override
+  {
+    m_columns[ 0 ].append( timestampMs );
+    const size_t metrics = m_columns.size() - 4;
+    for ( size_t i = 0; i < metrics; ++i )
+    {
+      Column &column = m_columns[ 1 + i ];
+      if ( i < values.size() && !std::isnan( values[ i ] ) )
+        column.append( values[ i ] );
+      else
+        column.null();
+    }
+    for ( size_t i = 1 + metrics; i < m_columns.size(); ++i )
+      m_columns[ i ].null();
+    endRow();
+  }
+
+  void event( const MetricEventRecord &event ) override
+  {
+    m_columns[ 0 ].append( event.timestampMs );
+    const size_t metrics = m_columns.size() - 4;
+    for ( size_t i = 0; i < metrics; ++i )
+      m_columns[ 1 + i ].null();
+    m_columns[ 1 + metrics ].append( metricEventKindName( event.kind ) );
+    m_columns[ 2 + metrics ].append( event.labelView() );
+    m_columns[ 3 + metrics ].append( event.value );
+    endRow();
+  }
+
+  bool finish() override
+  {
+    flushRowGroup();
+
+    std::string footer;
+    Thrift t( footer );
+    t.i32( 1, 1 );  // version
+    t.list( 2, Thrift::STRUCT, m_columns.size() + 1 );
+    t.beginElement();
+    t.binary( 4, "schema" );
+    t.i32( 5, static_cast< int32_t >( m_columns.size() ) );
+    t.end();
+    for ( const Column &column : m_columns )
+    {
+      t.beginElement();
+      t.i32( 1, static_cast< int32_t >( column.type ) );
+      t.i32( 3, column.optional ? 1 : 0 );  // OPTIONAL : REQUIRED
+      t.binary( 4, column.name );
+      if ( column.converted != ConvertedType::None )
+        t.i32( 6, static_cast< int32_t >( column.converted ) );
+      t.end();
+    }
+    t.i64( 3, static_cast< int64_t >( m_totalRows ) );
+    t.list( 4, Thrift::STRUCT, m_rowGroups.size() );
+    for ( const RowGroup &group : m_rowGroups )
+    {
+      t.beginElement();
+      t.list( 1, Thrift::STRUCT, group.chunks.size() );
+      int64_t totalBytes = 0;
+      for ( size_t c = 0; c < group.chunks.size(); ++c )
+      {
+        const Chunk &chunk = group.chunks[ c ];
+        const Column &column = m_columns[ c ];
+        totalBytes += chunk.bytes;
+        t.beginElement();
+        t.i64( 2, chunk.offset );
+        t.beginStruct( 3 );  // ColumnMetaData
+        t.i32( 1, static_cast< int32_t >( column.type ) );
+        t.list( 2, Thrift::I32, 2 );
+        t.listI32( 0 );  // PLAIN
+        t.listI32( 3 );  // RLE (definition levels)
+        t.list( 3, Thrift::BINARY, 1 );
+        t.listBinary( column.name );
+        t.i32( 4, 0 );  // UNCOMPRESSED
+        t.i64( 5, static_cast< int64_t >( group.rows ) );
+        t.i64( 6, chunk.bytes );
+        t.i64( 7, chunk.bytes );
+        t.i64( 9, chunk.offset );
+        t.end();
+        t.end();
+      }
+      t.i64( 2, totalBytes );
+      t.i64( 3, static_cast< int64_t >( group.rows ) );
+      t.end();
+    }
+    t.binary( 6, "ucc" );  // created_by
+    t.stop();
+
+    write( footer );
+    const uint32_t length = static_cast< uint32_t >( footer.size() );
+    write( std::string_view( reinterpret_cast< const char * >( &length ), sizeof( length ) ) );
+    write( MAGIC );
+    m_out.flush();
+    return static_cast< bool >( m_out );
+  }
+
+private:
+  static constexpr std::string_view MAGIC = "PAR1";
+
+  enum class Type : int32_t
+  {
+    Int32 = 1,
+    Int64 = 2,
+    Double = 5,
+    ByteArray = 6,
+  };
+
+  enum class ConvertedType : int32_t
+  {
+    None = -1,
+    Utf8 = 0,
+    TimestampMillis = 9,
+  };
+
+  /// Thrift compact protocol, just the parts the footer and page headers use
+  class Thrift
+  {
+  public:
+    static constexpr uint8_t I32 = 5;
+    static constexpr uint8_t I64 = 6;
+    static constexpr uint8_t BINARY = 8;
+    static constexpr uint8_t LIST = 9;
+    static constexpr uint8_t STRUCT = 12;
+
+    explicit Thrift( std::string &out ) : m_out( out ) {}
+
+    void i32( int16_t id, int32_t v ) { field( id, I32 ); varint( zigzag( v ) ); }
+    void i64( int16_t id, int64_t v ) { field( id, I64 ); varint( zigzag( v ) ); }
+    void binary( int16_t id, std::string_view v ) { field( id, BINARY ); listBinary( v ); }
+    void beginStruct( int16_t id ) { field( id, STRUCT ); beginElement(); }
+    void list( int16_t id, uint8_t type, size_t size )
+    {
+      field( id, LIST );
+      if ( size < 15 )
+        m_out += static_cast< char >( size << 4 | type );
+      else
+      {
+        m_out += static_cast< char >( 0xf0 | type );
+        varint( size );
+      }
+    }
+    void listI32( int32_t v ) { varint( zigzag( v ) ); }
+    void listBinary( std::string_view v )
+    {
+      varint( v.size() );
+      m_out += v;
+    }
+    /// A struct inside a list: no field header
+    void beginElement()
+    {
+      m_stack.push_back( m_last );
+      m_last = 0;
+    }
+    void end()
+    {
+      stop();
+      m_last = m_stack.back();
+      m_stack.pop_back();
+    }
+    void stop() { m_out += '\0'; }
+
+  private:
+    void field( int16_t id, uint8_t type )
+    {
+      // ids only ascend here, by at most 15
+      m_out += static_cast< char >( ( id - m_last ) << 4 | type );
+      m_last = id;
+    }
+    static uint64_t zigzag( int64_t v ) { return ( static_cast< uint64_t >( v ) << 1 ) ^ static_cast< uint64_t >( v >> 63 ); }
+    void varint( uint64_t v )
+    {
+      while ( v >= 0x80 )
+      {
+        m_out += static_cast< char >( v | 0x80 );
+        v >>= 7;
+      }
+      m_out += static_cast< char >( v );
+    }
+
+    std::string &m_out;
+    int16_t m_last = 0;
+    std::vector< int16_t > m_stack;
+  };
+
+  struct Column
+  {
+    std::string name;
+    Type type = Type::Double;
+    bool optional = true;
+    ConvertedType converted = ConvertedType::None;
+    std::string values;               ///< PLAIN encoded, non-null values of this row group
+    std::vector< uint8_t > defined;   ///< Optional columns: 1 per row with a value
+
+    template< typename T >
+    void append( T v )
+    {
+      values.append( reinterpret_cast< const char * >( &v ), sizeof( v ) );
+      if ( optional )
+        defined.push_back( 1 );
+    }
+    void append( std::string_view v )
+    {
+      const uint32_t length = static_cast< uint32_t >( v.size() );
+      values.append( reinterpret_cast< const char * >( &length ), sizeof( length ) );
+      values += v;
+      defined.push_back( 1 );
+    }
+    void null() { defined.push_back( 0 ); }
+  };
+
+  struct Chunk
+  {
+    int64_t offset;  ///< Of the page header
+    int64_t bytes;   ///< Header and page
+  };
+
+  struct RowGroup
+  {
+    size_t rows;
+    std::vector< Chunk > chunks;
+  };
+
+  void addColumn( std::string name, Type type, bool optional, ConvertedType converted = ConvertedType::None )
+  {
+    Column &column = m_columns.emplace_back();
+    column.name = std::move( name );
+    column.type = type;
+    column.optional = optional;
+    column.converted = converted;
+  }
+
+  void endRow()
+  {
+    if ( ++m_rows == m_rowGroupRows )
+      flushRowGroup();
+  }
+
+  void flushRowGroup()
+  {
+    if ( m_rows == 0 )
+      return;
+    RowGroup group{ m_rows, {} };
+    std::string page, header;
+    for ( Column &column : m_columns )
+    {
+      page.clear();
+      if ( column.optional )
+        appendLevels( page, column.defined );
+      page += column.values;
+
+      header.clear();
+      Thrift t( header );
+      t.i32( 1, 0 );  // DATA_PAGE
+      t.i32( 2, static_cast< int32_t >( page.size() ) );
+      t.i32( 3, static_cast< int32_t >( page.size() ) );
+      t.beginStruct( 5 );  // DataPageHeader
+      t.i32( 1, static_cast< int32_t >( m_rows ) );
+      t.i32( 2, 0 );  // PLAIN
+      t.i32( 3, 3 );  // RLE
+      t.i32( 4, 3 );
+      t.end();
+      t.stop();
+
+      group.chunks.push_back( Chunk{ m_offset, static_cast< int64_t >( header.size() + page.size() ) } );
+      write( header );
+      write( page );
+      column.values.clear();
+      column.defined.clear();
+    }
+    m_rowGroups.push_back( std::move( group ) );
+    m_totalRows += m_rows;
+    m_rows = 0;
+  }
+
+  /// Definition levels (bit width 1) as RLE runs, prefixed by their byte length
+  static void appendLevels( std::string &out, const std::vector< uint8_t > &levels )
+  {
+    const size_t start = out.size();
+    out.append( sizeof( uint32_t ), '\0' );
+    for ( size_t i = 0; i < levels.size(); )
+    {
+      size_t run = 1;
+      while ( i + run < levels.size() && levels[ i + run ] == levels[ i ] )
+        ++run;
+      for ( uint64_t header = uint64_t( run ) << 1; ; header >>= 7 )
+      {
+        out += static_cast< char >( header >= 0x80 ? ( header & 0x7f ) | 0x80 : header );
+        if ( header < 0x80 )
+          break;
+      }
+      out += static_cast< char >( levels[ i ] );
+      i += run;
+    }
+    const uint32_t length = static_cast< uint32_t >( out.size() - start - sizeof( uint32_t ) );
+    std::memcpy( out.data() + start, &length, sizeof( length ) );
+  }
+
+  void write( std::string_view bytes )
+  {
+    m_out.write( bytes.data(), static_cast< std::streamsize >( bytes.size() ) );
+    m_offset += static_cast< int64_t >( bytes.size() );
+  }
+
+  std::ostream &m_out;
+  size_t m_rowGroupRows;
+  std::vector< Column > m_columns;
+  std::vector< RowGroup > m_rowGroups;
+  size_t m_rows = 0;        ///< In the current row group
+  size_t m_totalRows = 0;
+  int64_t m_offset = 0;
+};
+
+/**
+ * @brief Feeds frame pages and event annotations to a HistoryExportWriter
+ *        in time order
+ *
+ * Pages must arrive oldest first, each starting after the previous one;
+ * an event is written before the first row at or after its time.
+ */
+class HistoryExporter
+{
+public:
+  /**
+   * @param metricMask Columns to write, bit i = MetricId i
+   * @param names Metric key of every MetricId, indexed by id
+   * @param events Annotations of the exported span, oldest first
+   */
+  HistoryExporter( HistoryExportWriter &writer, uint64_t metricMask, const std::vector< std::string > &names,
+                   std::vector< MetricEventRecord > events )
+    : m_writer( writer ), m_mask( metricMask ), m_events( std::move( events ) )
+  {
+    for ( size_t id = 0; id < 64; ++id )
+      if ( m_mask & ( uint64_t( 1 ) << id ) )
+        m_columns.push_back( id < names.size() ? names[ id ] : "metric" + std::to_string( id ) );
+    m_values.resize( m_columns.size() );
+  }
+
+  /**
+   * @brief Write one page, see MetricFramesView
+   *
+   * Metrics the page holds beyond the mask are skipped, masked ones it
+   * lacks are written as missing.
+   * @return Timestamp of the page's last row; nullopt if the page is
+   *         malformed or empty
+   */
+  std::optional< int64_t > addPage( const uint8_t *data, size_t size )
+  {
+    const auto view = MetricFramesView::parse( data, size );
+    if ( !view || view->rows == 0 )
+      return std::nullopt;
+    begin();
+
+    std::vector< int > source( m_values.size(), -1 );
+    size_t out = 0, in = 0;
+    for ( size_t id = 0; id < 64; ++id )
+    {
+      const uint64_t bit = uint64_t( 1 ) << id;
+      if ( ( m_mask & bit ) && ( view->metricMask & bit ) )
+        source[ out ] = static_cast< int >( in );
+      out += ( m_mask & bit ) ? 1 : 0;
+      in += ( view->metricMask & bit ) ? 1 : 0;
+    }
+
+    for ( uint32_t row = 0; row < view->rows; ++row )
+    {
+      const int64_t ts = view->timestamp( row );
+      writeEventsUntil( ts );
+      for ( size_t c = 0; c < m_values.size(); ++c )
+        m_values[ c ] = source[ c ] >= 0 ? view->value( static_cast< size_t >( source[ c ] ), row )
+                                         : std::numeric_limits< double >::quiet_NaN();
+      m_writer.row( ts, m_values );
+      ++m_rows;
+    }
+    return view->timestamp( view->rows - 1 );
+  }
+
+  /// Write the remaining events and the trailer
+  bool finish()
+  {
+    begin();
+    writeEventsUntil( std::numeric_limits< int64_t >::max() );
+    return m_writer.finish();
+  }
+
+  [[nodiscard]] size_t rows() const noexcept { return m_rows; }
+  [[nodiscard]] size_t eventsWritten() const noexcept { return m_nextEvent; }
+
+private:
+  void begin()
+  {
+    if ( m_begun )
+      return;
+    m_writer.begin( m_columns );
+    m_begun = true;
+  }
+
+  void writeEventsUntil( int64_t ts )
+  {
+    while ( m_nextEvent < m_events.size() && m_events[ m_nextEvent ].timestampMs <= ts )
+      m_writer.event( m_events[ m_nextEvent++ ] );
+  }
+
+  HistoryExportWriter &m_writer;
+  uint64_t m_mask;
+  std::vector< std::string > m_columns;
+  std::vector< MetricEventRecord > m_events;
+  size_t m_nextEvent = 0;
+  bool m_begun = false;
+  std::vector< double > m_values;
+  size_t m_rows = 0;
+};
+
+} // namespace ucc
@@ -0,0 +1,151 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined( __SSE2__ ) && defined( __x86_64__ )
+#include <emmintrin.h>
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#endif
+
+namespace ucc
+{
+
+/**
+ * @brief Where a keyboard zone sits, as a fraction of the keyboard's width
+ *        and height; a screen frame is averaged over the same fraction of
+ *        the screen.
+ */
+struct KeyboardZoneCell
+{
+  int zone = 0;
+  double left = 0.0;
+  double top = 0.0;
+  double right = 1.0;
+  double bottom = 1.0;
+};
+
+/**
+ * @brief Averages 32-bit screen frames down to one colour per keyboard zone.
+ *
+ * Pixels are 4 bytes, blue first (QImage::Format_RGB32 on little endian).
+ * A 1080p frame is two million pixels per grab, so the row sums use SSE2
+ * (baseline on x86-64) or NEON on AArch64; the scalar loop covers the
+ * remainder and other targets.
+ *
+ * The result is packed RGB, three bytes per zone, as SetKeyboardBacklightFrame
+ * takes it.
+ */
+class KeyboardFrameReducer
+{
+public:
+  /// @p zones side by side, left to right: the 1-3 zone keyboards
+  [[nodiscard]] static std::vector< KeyboardZoneCell > stripes( int zones )
+  {
+    std::vector< KeyboardZoneCell > cells;
+    for ( int zone = 0; zone < zones; ++zone )
+      cells.push_back( { zone, static_cast< double >( zone ) / zones, 0.0,
+                         static_cast< double >( zone + 1 ) / zones, 1.0 } );
+    return cells;
+  }
+
+  /**
+   * @brief Reduce a @p width × @p height frame to @p zones packed RGB colours in @p rgb
+   * @param stride  Bytes per row of @p pixels
+   *
+   * Zones without a cell stay black.
+   */
+  static void reduce( const uint8_t *pixels, int width, int height, size_t stride,
+                      const std::vector< KeyboardZoneCell > &cells, int zones, std::vector< uint8_t > &rgb )
+  {
+    rgb.assign( static_cast< size_t >( std::max( zones, 0 ) ) * 3, 0 );
+    if ( not pixels or width <= 0 or height <= 0 )
+      return;
+
+    for ( const auto &cell : cells )
+    {
+      if ( cell.zone < 0 or cell.zone >= zones )
+        continue;
+      const int x0 = std::clamp( static_cast< int >( cell.left * width ), 0, width - 1 );
+      const int y0 = std::clamp( static_cast< int >( cell.top * height ), 0, height - 1 );
+      const int x1 = std::clamp( static_cast< int >( cell.right * width ), x0 + 1, width );
+      const int y1 = std::clamp( static_cast< int >( cell.bottom * height ), y0 + 1, height );
+
+      uint64_t sums[ 3 ] = { 0, 0, 0 };
+      for ( int y = y0; y < y1; ++y )
+        sumRow( pixels + static_cast< size_t >( y ) * stride + static_cast< size_t >( x0 ) * 4, x1 - x0, sums );
+
+      const uint64_t count = static_cast< uint64_t >( x1 - x0 ) * static_cast< uint64_t >( y1 - y0 );
+      uint8_t *out = rgb.data() + static_cast< size_t >( cell.zone ) * 3;
+      out[ 0 ] = static_cast< uint8_t >( sums[ 2 ] / count );
+      out[ 1 ] = static_cast< uint8_t >( sums[ 1 ] / count );
+      out[ 2 ] = static_cast< uint8_t >( sums[ 0 ] / count );
+    }
+  }
+
+  /// Add the blue, green and red bytes of @p count pixels at @p row to @p sums
+  static void sumRow( const uint8_t *row, int count, uint64_t sums[ 3 ] ) noexcept
+  {
+    int i = 0;
+#if defined( __SSE2__ ) && defined( __x86_64__ )
+    // mask one channel per pixel and let psadbw add the 16 bytes up
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i blueMask = _mm_set1_epi32( 0x000000ff );
+    const __m128i greenMask = _mm_set1_epi32( 0x0000ff00 );
+    const __m128i redMask = _mm_set1_epi32( 0x00ff0000 );
+    __m128i blue = zero, green = zero, red = zero;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+      const __m128i px = _mm_loadu_si128( reinterpret_cast< const __m128i * >( row + i * 4 ) );
+      blue = _mm_add_epi64( blue, _mm_sad_epu8( _mm_and_si128( px, blueMask ), zero ) );
+      green = _mm_add_epi64( green, _mm_sad_epu8( _mm_and_si128( px, greenMask ), zero ) );
+      red = _mm_add_epi64( red, _mm_sad_epu8( _mm_and_si128( px, redMask ), zero ) );
+    }
+    const auto total = []( __m128i v ) {
+      return static_cast< uint64_t >( _mm_cvtsi128_si64( v ) )
+             + static_cast< uint64_t >( _mm_cvtsi128_si64( _mm_unpackhi_epi64( v, v ) ) );
+    };
+    sums[ 0 ] += total( blue );
+    sums[ 1 ] += total( green );
+    sums[ 2 ] += total( red );
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+    uint32x4_t blue = vdupq_n_u32( 0 ), green = vdupq_n_u32( 0 ), red = vdupq_n_u32( 0 );
+    for ( ; i + 16 <= count; i += 16 )
+    {
+      const uint8x16x4_t px = vld4q_u8( row + i * 4 );
+      blue = vpadalq_u16( blue, vpaddlq_u8( px.val[ 0 ] ) );
+      green = vpadalq_u16( green, vpaddlq_u8( px.val[ 1 ] ) );
+      red = vpadalq_u16( red, vpaddlq_u8( px.val[ 2 ] ) );
+    }
+    sums[ 0 ] += vaddvq_u32( blue );
+    sums[ 1 ] += vaddvq_u32( green );
+    sums[ 2 ] += vaddvq_u32( red );
+#endif
+    for ( ; i < count; ++i )
+    {
+      sums[ 0 ] += row[ i * 4 ];
+      sums[ 1 ] += row[ i * 4 + 1 ];
+      sums[ 2 ] += row[ i * 4 + 2 ];
+    }
+  }
+};
+
+} // namespace ucc
@@ -0,0 +1,288 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ucc
+{
+
+/**
+ * @brief Shared-memory live metrics segment (shared by uccd and clients).
+ *
+ * uccd publishes the latest value of every metric plus a short history ring
+ * per metric in a sealed memfd.  Clients obtain a read-only fd once via the
+ * GetLiveMetricsSegment D-Bus method and then poll with plain loads.
+ *
+ * Layout (native endian — same-host only):
+ * @code
+ *   LiveMetricsHeader                              64 bytes
+ *   LiveMetricsChannel[ metricCount ]              32 bytes each
+ *   metricCount × ringCapacity × LiveMetricsPoint  16 bytes each
+ * @endcode
+ *
+ * The whole segment is guarded by one seqlock (@c sequence): the writer makes
+ * it odd before and even after every update, readers retry if it changed or
+ * was odd while they copied.  Metric indices are MetricId values.
+ */
+inline constexpr uint32_t LIVE_METRICS_MAGIC = 0x4d4c4355;  // "UCLM"
+inline constexpr uint16_t LIVE_METRICS_VERSION = 1;
+
+struct LiveMetricsHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t metricCount;
+  uint32_t ringCapacity;
+  uint32_t reserved;
+  uint64_t sequence;     ///< Seqlock: odd while the daemon is writing
+  uint64_t padding[ 5 ];
+};
+
+struct LiveMetricsChannel
+{
+  int64_t  lastTimestampMs;  ///< 0 = never written
+  double   lastValue;
+  uint64_t written;          ///< Points ever written; slot = written % ringCapacity
+  uint64_t reserved;
+};
+
+struct LiveMetricsPoint
+{
+  int64_t timestampMs;
+  double  value;
+};
+
+static_assert( sizeof( LiveMetricsHeader ) == 64 );
+static_assert( sizeof( LiveMetricsChannel ) == 32 );
+static_assert( sizeof( LiveMetricsPoint ) == 16 );
+
+namespace live_metrics
+{
+
+constexpr size_t channelOffset( size_t metric ) noexcept
+{
+  return sizeof( LiveMetricsHeader ) + metric * sizeof( LiveMetricsChannel );
+}
+
+constexpr size_t pointOffset( size_t metricCount, size_t ringCapacity,
+                              size_t metric, size_t slot ) noexcept
+{
+  return channelOffset( metricCount ) + ( metric * ringCapacity + slot ) * sizeof( LiveMetricsPoint );
+}
+
+constexpr size_t segmentSize( size_t metricCount, size_t ringCapacity ) noexcept
+{
+  return pointOffset( metricCount, ringCapacity, metricCount, 0 );
+}
+
+template< typename T >
+inline T load( const std::byte *base, size_t offset ) noexcept
+{
+  // atomic_ref< const T > is C++26; the reader mapping is PROT_READ and
+  // only ever loaded from.
+  return std::atomic_ref< T >( *static_cast< T * >(
+    static_cast< void * >( const_cast< std::byte * >( base + offset ) ) ) ).load( std::memory_order_relaxed );
+}
+
+template< typename T >
+inline void store( std::byte *base, size_t offset, T value ) noexcept
+{
+  std::atomic_ref< T >( *static_cast< T * >( static_cast< void * >( base + offset ) ) )
+    .store( value, std::memory_order_relaxed );
+}
+
+} // namespace live_metrics
+
+/**
+ * @brief Read-only client view of a live metrics segment.
+ */
+class LiveMetricsView
+{
+public:
+  LiveMetricsView() = default;
+  ~LiveMetricsView() { detach(); }
+
+  LiveMetricsView( const LiveMetricsView & ) = delete;
+  LiveMetricsView &operator=( const LiveMetricsView & ) = delete;
+
+  /**
+   * @brief Map the segment behind @p fd read-only and validate its header.
+   *
+   * The fd may be closed afterwards; the mapping stays valid.
+   */
+  bool attach( int fd ) noexcept
+  {
+    detach();
+
+    struct stat st{};
+    if ( fd < 0 || fstat( fd, &st ) != 0 ||
+         static_cast< size_t >( st.st_size ) < sizeof( LiveMetricsHeader ) )
+      return false;
+
+    const size_t size = static_cast< size_t >( st.st_size );
+    void *addr = mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+    if ( addr == MAP_FAILED )
+      return false;
+
+    m_base = static_cast< const std::byte * >( addr );
+    m_size = size;
+
+    LiveMetricsHeader hdr{};
+    std::memcpy( &hdr, m_base, sizeof( hdr ) );
+    if ( hdr.magic != LIVE_METRICS_MAGIC || hdr.version != LIVE_METRICS_VERSION ||
+         hdr.ringCapacity == 0 ||
+         live_metrics::segmentSize( hdr.metricCount, hdr.ringCapacity ) > m_size )
+    {
+      detach();
+      return false;
+    }
+
+    m_metricCount = hdr.metricCount;
+    m_ringCapacity = hdr.ringCapacity;
+    return true;
+  }
+
+  void detach() noexcept
+  {
+    if ( m_base != nullptr )
+      munmap( const_cast< std::byte * >( m_base ), m_size );
+    m_base = nullptr;
+    m_size = 0;
+    m_metricCount = 0;
+    m_ringCapacity = 0;
+  }
+
+  [[nodiscard]] bool isAttached() const noexcept { return m_base != nullptr; }
+  [[nodiscard]] size_t metricCount() const noexcept { return m_metricCount; }
+
+  /**
+   * @brief Latest (timestamp, value) of @p metric, nullopt if never written.
+   */
+  [[nodiscard]] std::optional< LiveMetricsPoint > latest( size_t metric ) const noexcept
+  {
+    if ( metric >= m_metricCount )
+      return std::nullopt;
+
+    LiveMetricsPoint pt{};
+    const bool ok = readConsistent( [&] {
+      const size_t ch = live_metrics::channelOffset( metric );
+      pt.timestampMs = live_metrics::load< int64_t >( m_base, ch + offsetof( LiveMetricsChannel, lastTimestampMs ) );
+      pt.value = live_metrics::load< double >( m_base, ch + offsetof( LiveMetricsChannel, lastValue ) );
+    } );
+    if ( !ok || pt.timestampMs == 0 )
+      return std::nullopt;
+    return pt;
+  }
+
+  /**
+   * @brief Serialize points with timestamp >= sinceMs in the
+   *        MetricsHistoryStore::querySinceBinary() layout.
+   *
+   * @return false if the segment is inconsistent or its rings no longer
+   *         reach back to @p sinceMs; the caller should then ask the daemon.
+   */
+  bool copySinceBinary( int64_t sinceMs, std::vector< uint8_t > &out ) const
+  {
+    if ( m_base == nullptr )
+      return false;
+
+    bool covered = true;
+    const bool ok = readConsistent( [&] {
+      out.clear();
+      covered = true;
+      for ( size_t m = 0; m < m_metricCount; ++m )
+      {
+        const uint64_t written = live_metrics::load< uint64_t >(
+          m_base, live_metrics::channelOffset( m ) + offsetof( LiveMetricsChannel, written ) );
+        const uint64_t n = written < m_ringCapacity ? written : m_ringCapacity;
+        if ( n == 0 )
+          continue;
+
+        uint64_t first = written - n;
+        if ( written > m_ringCapacity && loadPoint( m, first ).timestampMs > sinceMs )
+          covered = false;
+        for ( uint64_t hi = written; first < hi; )
+        {
+          const uint64_t mid = first + ( hi - first ) / 2;
+          if ( loadPoint( m, mid ).timestampMs < sinceMs )
+            first = mid + 1;
+          else
+            hi = mid;
+        }
+        if ( first == written )
+          continue;
+
+        const uint32_t count = static_cast< uint32_t >( written - first );
+        const size_t offset = out.size();
+        out.resize( offset + 1 + sizeof( count ) + count * sizeof( LiveMetricsPoint ) );
+        uint8_t *dst = out.data() + offset;
+        *dst++ = static_cast< uint8_t >( m );
+        std::memcpy( dst, &count, sizeof( count ) );
+        dst += sizeof( count );
+        for ( uint64_t seq = first; seq < written; ++seq )
+        {
+          const LiveMetricsPoint pt = loadPoint( m, seq );
+          std::memcpy( dst, &pt, sizeof( pt ) );
+          dst += sizeof( pt );
+        }
+      }
+    } );
+    return ok && covered;
+  }
+
+private:
+  template< typename Fn >
+  bool readConsistent( Fn &&fn ) const
+  {
+    const size_t seqOffset = offsetof( LiveMetricsHeader, sequence );
+    for ( int attempt = 0; attempt < 64; ++attempt )
+    {
+      const uint64_t before = std::atomic_ref< uint64_t >( *static_cast< uint64_t * >(
+        static_cast< void * >( const_cast< std::byte * >( m_base + seqOffset ) ) ) )
+        .load( std::memory_order_acquire );
+      if ( before & 1 )
+        continue;
+      fn();
+      std::atomic_thread_fence( std::memory_order_acquire );
+      if ( live_metrics::load< uint64_t >( m_base, seqOffset ) == before )
+        return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] LiveMetricsPoint loadPoint( size_t metric, uint64_t seq ) const noexcept
+  {
+    const size_t off = live_metrics::pointOffset( m_metricCount, m_ringCapacity, metric,
+                                                  static_cast< size_t >( seq % m_ringCapacity ) );
+    return { live_metrics::load< int64_t >( m_base, off ),
+             live_metrics::load< double >( m_base, off + sizeof( int64_t ) ) };
+  }
+
+  const std::byte *m_base = nullptr;
+  size_t m_size = 0;
+  size_t m_metricCount = 0;
+  size_t m_ringCapacity = 0;
+};
+
+} // namespace ucc
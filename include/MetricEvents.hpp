@@ -0,0 +1,116 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace ucc
+{
+
+/**
+ * @brief Event annotations carried next to the metric blocks of
+ *        GetMonitorDataSince (shared by uccd and clients).
+ *
+ * Events are appended as one extra block with metric id
+ * @c METRIC_EVENT_BLOCK_ID.  Its count is given in 16-byte units, like a
+ * metric block, so parsers that only know metric blocks skip it:
+ * @code
+ *   uint8_t  METRIC_EVENT_BLOCK_ID
+ *   uint32_t count                 (= events × METRIC_EVENT_UNITS)
+ *   events × MetricEventRecord     (64 bytes each)
+ * @endcode
+ */
+enum class MetricEventKind : uint16_t
+{
+  ProfileSwitch = 1,  ///< label = profile name
+  PowerState    = 2,  ///< label = state key ("power_ac", ...), value = ProfileState
+  GpuPerfLimit  = 3,  ///< label = NVML perf-limit reason, value = 0 (label "None") when cleared
+  PumpStep      = 4,  ///< label = "up/down at <t> °C" (filtered), value = pump level 0 (off) – 4 (12 V)
+};
+
+/// Stable name of @p kind for exports and logs, "unknown" for other values
+[[nodiscard]] inline constexpr std::string_view metricEventKindName( uint16_t kind ) noexcept
+{
+  switch ( static_cast< MetricEventKind >( kind ) )
+  {
+    case MetricEventKind::ProfileSwitch: return "profileSwitch";
+    case MetricEventKind::PowerState:    return "powerState";
+    case MetricEventKind::GpuPerfLimit:  return "gpuPerfLimit";
+    case MetricEventKind::PumpStep:      return "pumpStep";
+  }
+  return "unknown";
+}
+
+inline constexpr uint8_t METRIC_EVENT_BLOCK_ID = 0xff;
+inline constexpr size_t METRIC_EVENT_LABEL_SIZE = 48;
+
+struct MetricEventRecord
+{
+  int64_t  timestampMs;
+  uint16_t kind;       ///< MetricEventKind
+  uint16_t reserved;
+  int32_t  value;
+  char     label[ METRIC_EVENT_LABEL_SIZE ];  ///< NUL-padded, truncated
+
+  [[nodiscard]] std::string_view labelView() const noexcept
+  {
+    return { label, strnlen( label, sizeof( label ) ) };
+  }
+};
+
+static_assert( sizeof( MetricEventRecord ) == 64 );
+
+inline constexpr size_t METRIC_EVENT_UNITS = sizeof( MetricEventRecord ) / 16;
+
+/**
+ * @brief Visit the events of a GetMonitorDataSince blob, skipping metric blocks.
+ * @return false if the blob is truncated
+ */
+template< typename Fn >
+bool decodeMetricEvents( const uint8_t *data, size_t size, Fn &&onEvent )
+{
+  size_t pos = 0;
+  while ( pos < size )
+  {
+    if ( size - pos < 1 + sizeof( uint32_t ) )
+      return false;
+    const uint8_t id = data[ pos ];
+    uint32_t count = 0;
+    std::memcpy( &count, data + pos + 1, sizeof( count ) );
+    pos += 1 + sizeof( count );
+
+    const size_t bytes = static_cast< size_t >( count ) * 16;
+    if ( size - pos < bytes )
+      return false;
+
+    if ( id == METRIC_EVENT_BLOCK_ID )
+    {
+      for ( size_t off = 0; off + sizeof( MetricEventRecord ) <= bytes; off += sizeof( MetricEventRecord ) )
+      {
+        MetricEventRecord ev;
+        std::memcpy( &ev, data + pos + off, sizeof( ev ) );
+        onEvent( ev );
+      }
+    }
+    pos += bytes;
+  }
+  return true;
+}
+
+} // namespace ucc
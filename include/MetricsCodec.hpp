@@ -0,0 +1,370 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ucc
+{
+
+/**
+ * @brief Compressed monitoring-history wire format (shared by uccd and clients).
+ *
+ * Timestamps are encoded as delta-of-delta and values as Gorilla-style XOR
+ * against the previous value.  Sampling is nearly periodic and sensor values
+ * change slowly, so most points cost one or two bits per field.
+ *
+ * Layout:
+ * @code
+ *   uint8_t  magic[2]   'U' 'M'
+ *   uint8_t  version    METRICS_CODEC_VERSION
+ *   uint8_t  reserved   0
+ *   Repeated for each non-empty metric series:
+ *     uint8_t  metricId
+ *     uint32_t count        (little endian)
+ *     uint32_t byteLength   (little endian, size of the bit stream below)
+ *     byteLength × uint8_t  bit stream, MSB first
+ * @endcode
+ *
+ * Bit stream per series (first point stored raw):
+ *   ts:    '0'                       delta unchanged
+ *          '10'   + 7-bit  zigzag    |dod| small
+ *          '110'  + 9-bit  zigzag
+ *          '1110' + 12-bit zigzag
+ *          '1111' + 64-bit zigzag
+ *   value: '0'                       identical to previous
+ *          '10' + meaningful bits    XOR fits previous leading/trailing window
+ *          '11' + 6-bit leading zeros + 6-bit (length − 1) + meaningful bits
+ */
+inline constexpr uint8_t METRICS_CODEC_VERSION = 1;
+
+namespace metrics_codec
+{
+
+class BitWriter
+{
+public:
+  explicit BitWriter( std::vector< uint8_t > &out ) : m_out( out ) {}
+
+  void write( uint64_t bits, unsigned count )
+  {
+    while ( count > 0 )
+    {
+      if ( m_free == 0 )
+      {
+        m_out.push_back( 0 );
+        m_free = 8;
+      }
+      const unsigned take = count < m_free ? count : m_free;
+      const uint64_t chunk = ( bits >> ( count - take ) ) & ( ( uint64_t( 1 ) << take ) - 1 );
+      m_out.back() = static_cast< uint8_t >( m_out.back() | ( chunk << ( m_free - take ) ) );
+      m_free -= take;
+      count -= take;
+    }
+  }
+
+  void writeBit( bool bit ) { write( bit ? 1 : 0, 1 ); }
+
+private:
+  std::vector< uint8_t > &m_out;
+  unsigned m_free = 0;
+};
+
+class BitReader
+{
+public:
+  BitReader( const uint8_t *data, size_t size ) : m_data( data ), m_bits( size * 8 ) {}
+
+  /// Read @p count bits; returns false (and leaves @p out untouched) on truncation.
+  bool read( unsigned count, uint64_t &out )
+  {
+    if ( m_pos + count > m_bits )
+      return false;
+    uint64_t v = 0;
+    for ( unsigned i = 0; i < count; )
+    {
+      const size_t byte = m_pos >> 3;
+      const unsigned bitInByte = static_cast< unsigned >( m_pos & 7 );
+      const unsigned avail = 8 - bitInByte;
+      const unsigned take = ( count - i ) < avail ? ( count - i ) : avail;
+      const unsigned shift = avail - take;
+      const uint64_t chunk = ( m_data[ byte ] >> shift ) & ( ( 1u << take ) - 1 );
+      v = ( v << take ) | chunk;
+      i += take;
+      m_pos += take;
+    }
+    out = v;
+    return true;
+  }
+
+  bool readBit( bool &bit )
+  {
+    uint64_t v = 0;
+    if ( !read( 1, v ) )
+      return false;
+    bit = v != 0;
+    return true;
+  }
+
+private:
+  const uint8_t *m_data;
+  size_t m_bits;
+  size_t m_pos = 0;
+};
+
+inline uint64_t zigzag( int64_t v ) noexcept
+{
+  return ( static_cast< uint64_t >( v ) << 1 ) ^ static_cast< uint64_t >( v >> 63 );
+}
+
+inline int64_t unzigzag( uint64_t v ) noexcept
+{
+  return static_cast< int64_t >( v >> 1 ) ^ -static_cast< int64_t >( v & 1 );
+}
+
+inline void putLE32( std::vector< uint8_t > &out, size_t offset, uint32_t v )
+{
+  for ( int i = 0; i < 4; ++i )
+    out[ offset + static_cast< size_t >( i ) ] = static_cast< uint8_t >( v >> ( 8 * i ) );
+}
+
+inline uint32_t getLE32( const uint8_t *p )
+{
+  return static_cast< uint32_t >( p[ 0 ] ) | ( static_cast< uint32_t >( p[ 1 ] ) << 8 ) |
+         ( static_cast< uint32_t >( p[ 2 ] ) << 16 ) | ( static_cast< uint32_t >( p[ 3 ] ) << 24 );
+}
+
+} // namespace metrics_codec
+
+/**
+ * @brief Incremental encoder: call beginSeries()/addPoint() per metric.
+ */
+class MetricsEncoder
+{
+public:
+  explicit MetricsEncoder( std::vector< uint8_t > &out ) : m_out( out )
+  {
+    m_out.push_back( 'U' );
+    m_out.push_back( 'M' );
+    m_out.push_back( METRICS_CODEC_VERSION );
+    m_out.push_back( 0 );
+  }
+
+  /**
+   * @brief Encode one complete series of @p count points.
+   *
+   * @p tsAt / @p valAt are called with indices 0..count-1, which lets the
+   * caller encode straight from its own storage without an intermediate copy.
+   */
+  template< typename TsFn, typename ValFn >
+  void addSeries( uint8_t metricId, uint32_t count, TsFn &&tsAt, ValFn &&valAt )
+  {
+    if ( count == 0 )
+      return;
+
+    const size_t header = m_out.size();
+    m_out.resize( header + 9 );
+    m_out[ header ] = metricId;
+    metrics_codec::putLE32( m_out, header + 1, count );
+
+    const size_t streamStart = m_out.size();
+    metrics_codec::BitWriter bw( m_out );
+
+    int64_t prevTs = tsAt( 0 );
+    uint64_t prevBits = std::bit_cast< uint64_t >( static_cast< double >( valAt( 0 ) ) );
+    bw.write( static_cast< uint64_t >( prevTs ), 64 );
+    bw.write( prevBits, 64 );
+
+    int64_t prevDelta = 0;
+    unsigned prevLead = 65;   // 65 = no window yet
+    unsigned prevTrail = 0;
+
+    for ( uint32_t i = 1; i < count; ++i )
+    {
+      // --- timestamp: delta of delta ---
+      const int64_t ts = tsAt( i );
+      const int64_t delta = ts - prevTs;
+      const int64_t dod = delta - prevDelta;
+      prevTs = ts;
+      prevDelta = delta;
+
+      const uint64_t z = metrics_codec::zigzag( dod );
+      if ( dod == 0 )
+        bw.write( 0b0, 1 );
+      else if ( z < ( 1u << 7 ) )
+      {
+        bw.write( 0b10, 2 );
+        bw.write( z, 7 );
+      }
+      else if ( z < ( 1u << 9 ) )
+      {
+        bw.write( 0b110, 3 );
+        bw.write( z, 9 );
+      }
+      else if ( z < ( 1u << 12 ) )
+      {
+        bw.write( 0b1110, 4 );
+        bw.write( z, 12 );
+      }
+      else
+      {
+        bw.write( 0b1111, 4 );
+        bw.write( z, 64 );
+      }
+
+      // --- value: XOR with previous ---
+      const uint64_t bits = std::bit_cast< uint64_t >( static_cast< double >( valAt( i ) ) );
+      const uint64_t x = bits ^ prevBits;
+      prevBits = bits;
+
+      if ( x == 0 )
+      {
+        bw.write( 0b0, 1 );
+        continue;
+      }
+
+      const unsigned lead = static_cast< unsigned >( std::countl_zero( x ) );
+      const unsigned trail = static_cast< unsigned >( std::countr_zero( x ) );
+
+      if ( prevLead <= 64 && lead >= prevLead && trail >= prevTrail )
+      {
+        const unsigned len = 64 - prevLead - prevTrail;
+        bw.write( 0b10, 2 );
+        bw.write( x >> prevTrail, len );
+      }
+      else
+      {
+        const unsigned len = 64 - lead - trail;
+        bw.write( 0b11, 2 );
+        bw.write( lead, 6 );
+        bw.write( len - 1, 6 );
+        bw.write( x >> trail, len );
+        prevLead = lead;
+        prevTrail = trail;
+      }
+    }
+
+    metrics_codec::putLE32( m_out, header + 5,
+                            static_cast< uint32_t >( m_out.size() - streamStart ) );
+  }
+
+private:
+  std::vector< uint8_t > &m_out;
+};
+
+/**
+ * @brief Decode a compressed blob, invoking @p onPoint( metricId, ts, value ).
+ *
+ * @return false if the header is unknown or the payload is truncated; points
+ *         decoded before the error have already been delivered.
+ */
+template< typename Fn >
+bool decodeMetricsCompressed( const uint8_t *data, size_t size, Fn &&onPoint )
+{
+  if ( size < 4 || data[ 0 ] != 'U' || data[ 1 ] != 'M' || data[ 2 ] != METRICS_CODEC_VERSION )
+    return false;
+
+  const uint8_t *p = data + 4;
+  const uint8_t *end = data + size;
+
+  while ( p < end )
+  {
+    if ( end - p < 9 )
+      return false;
+
+    const uint8_t metricId = p[ 0 ];
+    const uint32_t count = metrics_codec::getLE32( p + 1 );
+    const uint32_t length = metrics_codec::getLE32( p + 5 );
+    p += 9;
+
+    if ( static_cast< size_t >( end - p ) < length )
+      return false;
+
+    metrics_codec::BitReader br( p, length );
+    p += length;
+
+    uint64_t raw = 0;
+    if ( count == 0 )
+      continue;
+    if ( !br.read( 64, raw ) )
+      return false;
+    int64_t ts = static_cast< int64_t >( raw );
+    uint64_t valBits = 0;
+    if ( !br.read( 64, valBits ) )
+      return false;
+    onPoint( metricId, ts, std::bit_cast< double >( valBits ) );
+
+    int64_t delta = 0;
+    unsigned lead = 0;
+    unsigned len = 0;
+
+    for ( uint32_t i = 1; i < count; ++i )
+    {
+      // --- timestamp ---
+      bool bit = false;
+      unsigned prefix = 0;
+      while ( prefix < 4 )
+      {
+        if ( !br.readBit( bit ) )
+          return false;
+        if ( !bit )
+          break;
+        ++prefix;
+      }
+
+      static constexpr unsigned kDodWidth[] = { 0, 7, 9, 12, 64 };
+      if ( prefix > 0 )
+      {
+        if ( !br.read( kDodWidth[ prefix ], raw ) )
+          return false;
+        delta += metrics_codec::unzigzag( raw );
+      }
+      ts += delta;
+
+      // --- value ---
+      if ( !br.readBit( bit ) )
+        return false;
+      if ( bit )
+      {
+        bool newWindow = false;
+        if ( !br.readBit( newWindow ) )
+          return false;
+        if ( newWindow )
+        {
+          uint64_t l = 0;
+          uint64_t n = 0;
+          if ( !br.read( 6, l ) || !br.read( 6, n ) )
+            return false;
+          lead = static_cast< unsigned >( l );
+          len = static_cast< unsigned >( n ) + 1;
+        }
+        if ( len == 0 || lead + len > 64 || !br.read( len, raw ) )
+          return false;
+        valBits ^= raw << ( 64 - lead - len );
+      }
+
+      onPoint( metricId, ts, std::bit_cast< double >( valBits ) );
+    }
+  }
+
+  return true;
+}
+
+} // namespace ucc
@@ -0,0 +1,172 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace ucc
+{
+
+/**
+ * @brief Streaming min/max decimation of a time series for drawing.
+ *
+ * Time is cut into buckets of a fixed width (one horizontal pixel, say),
+ * aligned to x = 0 so they stay put while the window slides.  Each bucket
+ * is drawn as its lowest and highest point in time order, so spikes
+ * survive at any zoom level with at most two points per bucket.
+ *
+ * Only the newest bucket is still open; a point landing in it replaces
+ * that bucket's drawn points.  Like SeriesRing, commit() reports the
+ * changes since the previous commit as removals at both ends plus the
+ * points to append, so feeding the drawn series costs work proportional
+ * to the new points.
+ *
+ * @tparam Point Anything with x() and y() (e.g. QPointF)
+ */
+template< typename Point >
+class MinMaxDecimator
+{
+public:
+  /// Changes to apply to the drawn series: remove at the back, then at the front, then append
+  struct Delta
+  {
+    size_t removeFront = 0;
+    size_t removeBack = 0;
+    size_t appendFrom = 0;  ///< Index into points() of the first point to append
+
+    [[nodiscard]] bool empty( size_t size ) const noexcept
+    {
+      return removeFront == 0 && removeBack == 0 && appendFrom >= size;
+    }
+  };
+
+  /// Drop everything and use buckets @p bucketWidth wide (in x units)
+  void reset( double bucketWidth ) noexcept
+  {
+    m_width = bucketWidth > 0.0 ? bucketWidth : 1.0;
+    m_points.clear();
+    m_buckets.clear();
+    m_drawn = 0;
+    m_removeFront = 0;
+    m_removeBack = 0;
+  }
+
+  [[nodiscard]] double bucketWidth() const noexcept { return m_width; }
+
+  /// The decimated series, oldest first
+  [[nodiscard]] const std::deque< Point > &points() const noexcept { return m_points; }
+
+  /// Add @p point; points must arrive in time order
+  void push( const Point &point )
+  {
+    const int64_t index = static_cast< int64_t >( std::floor( point.x() / m_width ) );
+    if ( m_buckets.empty() || index > m_buckets.back().index )
+    {
+      m_buckets.push_back( { index, 1, point, point } );
+      m_points.push_back( point );
+      return;
+    }
+
+    Bucket &open = m_buckets.back();
+    if ( point.y() < open.min.y() )
+      open.min = point;
+    else if ( point.y() > open.max.y() )
+      open.max = point;
+    else
+      return;  // inside the bucket's range; nothing to redraw
+
+    for ( ; open.drawn > 0; --open.drawn )
+      popBack();
+    draw( open );
+  }
+
+  /**
+   * @brief Drop the buckets that end at or before @p cutoff
+   */
+  void trimBefore( double cutoff ) noexcept
+  {
+    while ( !m_buckets.empty() && static_cast< double >( m_buckets.front().index + 1 ) * m_width <= cutoff )
+    {
+      for ( uint8_t n = m_buckets.front().drawn; n > 0; --n )
+        popFront();
+      m_buckets.pop_front();
+    }
+  }
+
+  /// The changes since the previous commit(); they then count as drawn
+  Delta commit() noexcept
+  {
+    const Delta delta{ m_removeFront, m_removeBack, m_drawn };
+    m_removeFront = 0;
+    m_removeBack = 0;
+    m_drawn = m_points.size();
+    return delta;
+  }
+
+private:
+  struct Bucket
+  {
+    int64_t index;
+    uint8_t drawn;  ///< Points this bucket has in m_points (1 or 2)
+    Point min;
+    Point max;
+  };
+
+  void draw( Bucket &bucket )
+  {
+    const bool minFirst = bucket.min.x() <= bucket.max.x();
+    m_points.push_back( minFirst ? bucket.min : bucket.max );
+    bucket.drawn = 1;
+    if ( bucket.min.x() != bucket.max.x() || bucket.min.y() != bucket.max.y() )
+    {
+      m_points.push_back( minFirst ? bucket.max : bucket.min );
+      bucket.drawn = 2;
+    }
+  }
+
+  void popBack() noexcept
+  {
+    // drawn points are the oldest m_drawn ones; a newer one was never drawn
+    if ( m_points.size() <= m_drawn )
+    {
+      ++m_removeBack;
+      --m_drawn;
+    }
+    m_points.pop_back();
+  }
+
+  void popFront() noexcept
+  {
+    if ( m_drawn > 0 )
+    {
+      ++m_removeFront;
+      --m_drawn;
+    }
+    m_points.pop_front();
+  }
+
+  double m_width = 1.0;
+  std::deque< Point > m_points;
+  std::deque< Bucket > m_buckets;
+  size_t m_drawn = 0;        ///< Leading points the drawn series has
+  size_t m_removeFront = 0;
+  size_t m_removeBack = 0;
+};
+
+} // namespace ucc
@@ -0,0 +1,175 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QIODevice>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace ucc
+{
+
+/**
+ * @brief Private uccd ↔ client channel beside the system bus (shared by uccd and clients).
+ *
+ * A client asks for the channel with RequestPeerChannel on the system bus
+ * and receives the address of a unix socket in the abstract namespace plus
+ * a single-use token bound to its uid.  On the socket the first request
+ * must be HELLO carrying that token; the connection then acts on behalf of
+ * the bus name that requested it.  Only the calls listed in peerServes()
+ * are answered, everything else stays on the bus.
+ *
+ * Every message is one frame:
+ * @code
+ *   uint32_t length     (little endian, size of the payload)
+ *   length × uint8_t    QDataStream (Qt_6_0) payload
+ * @endcode
+ * Request payload: quint32 serial, QString method, QVariantList args.
+ * Reply payload:   quint32 serial, bool ok, QVariant value, QString error.
+ */
+namespace peer
+{
+
+inline constexpr uint32_t MAX_FRAME_BYTES = 64u << 20;
+/// Largest frame accepted before HELLO: the token request is well under it
+inline constexpr uint32_t MAX_HELLO_BYTES = 256;
+inline constexpr const char *HELLO = "Hello";
+inline constexpr const char *ABSTRACT_PREFIX = "unix:abstract=";
+
+/// Error string of a reply refused for lack of a cached Polkit grant; retry on the bus
+inline constexpr const char *ERROR_NOT_AUTHORIZED = "NotAuthorized";
+
+/// Calls answered on the peer channel: monitoring reads, fan-curve editing
+/// and streamed keyboard frames
+inline bool peerServes( const QString &method )
+{
+  static constexpr std::array< const char *, 10 > METHODS{ {
+    "GetMonitorDataSince", "GetMonitorDataSinceCompressed", "GetMonitorDataSinceDecimated",
+    "GetMonitorFramesSince",
+    "GetCpuCoreHistorySince", "GetLiveSnapshot",
+    "SetFanProfileCPU", "SetFanProfileDGPU", "ApplyFanProfiles",
+    "SetKeyboardBacklightFrame",
+  } };
+  for ( const char *name : METHODS )
+    if ( method == QLatin1String( name ) )
+      return true;
+  return false;
+}
+
+struct Request
+{
+  quint32 serial = 0;
+  QString method;
+  QVariantList args;
+};
+
+struct Reply
+{
+  quint32 serial = 0;
+  bool ok = false;
+  QVariant value;
+  QString error;
+};
+
+namespace detail
+{
+template< typename Fn >
+QByteArray frame( Fn &&write )
+{
+  QByteArray out( 4, '\0' );
+  {
+    QDataStream stream( &out, QIODevice::WriteOnly | QIODevice::Append );
+    stream.setVersion( QDataStream::Qt_6_0 );
+    write( stream );
+  }
+  const auto length = static_cast< uint32_t >( out.size() - 4 );
+  for ( int i = 0; i < 4; ++i )
+    out[ i ] = static_cast< char >( ( length >> ( 8 * i ) ) & 0xFF );
+  return out;
+}
+} // namespace detail
+
+inline QByteArray encodeRequest( const Request &request )
+{
+  return detail::frame( [&]( QDataStream &s ) { s << request.serial << request.method << request.args; } );
+}
+
+inline QByteArray encodeReply( const Reply &reply )
+{
+  return detail::frame( [&]( QDataStream &s ) { s << reply.serial << reply.ok << reply.value << reply.error; } );
+}
+
+inline std::optional< Request > decodeRequest( const QByteArray &payload )
+{
+  QDataStream s( payload );
+  s.setVersion( QDataStream::Qt_6_0 );
+  Request request;
+  s >> request.serial >> request.method >> request.args;
+  if ( s.status() != QDataStream::Ok )
+    return std::nullopt;
+  return request;
+}
+
+inline std::optional< Reply > decodeReply( const QByteArray &payload )
+{
+  QDataStream s( payload );
+  s.setVersion( QDataStream::Qt_6_0 );
+  Reply reply;
+  s >> reply.serial >> reply.ok >> reply.value >> reply.error;
+  if ( s.status() != QDataStream::Ok )
+    return std::nullopt;
+  return reply;
+}
+
+/**
+ * @brief Remove one complete frame from the front of @p buffer.
+ *
+ * @return The payload, or nullopt while the frame is incomplete.  @p corrupt
+ *         is set when the announced length exceeds @p maxBytes; the
+ *         connection should then be dropped.
+ */
+inline std::optional< QByteArray > takeFrame( QByteArray &buffer, bool &corrupt,
+                                              uint32_t maxBytes = MAX_FRAME_BYTES )
+{
+  corrupt = false;
+  if ( buffer.size() < 4 )
+    return std::nullopt;
+
+  uint32_t length = 0;
+  for ( int i = 0; i < 4; ++i )
+    length |= static_cast< uint32_t >( static_cast< uint8_t >( buffer[ i ] ) ) << ( 8 * i );
+  if ( length > maxBytes )
+  {
+    corrupt = true;
+    return std::nullopt;
+  }
+  if ( static_cast< qsizetype >( length ) > buffer.size() - 4 )
+    return std::nullopt;
+
+  QByteArray payload = buffer.mid( 4, length );
+  buffer.remove( 0, 4 + length );
+  return payload;
+}
+
+} // namespace peer
+} // namespace ucc
@@ -0,0 +1,328 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QDBusVariant>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+
+/**
+ * @brief Typed D-Bus form of a profile (shared by uccd and clients).
+ *
+ * GetDefaultProfiles / GetCustomProfiles (aa{sv}), GetActiveProfile (a{sv}),
+ * ApplyProfileData and SaveCustomProfileData (a{sv}) carry a profile as a
+ * nested a{sv} with the same keys as the profile JSON.  The bulky parts are
+ * typed: fan curves ("tableCPU", "tableGPU", "tablePump",
+ * "tableWaterCoolerFan") are a(ii), keyboard "states" are a(iiii) and
+ * "tdpValues" is ai.  Absent and null JSON members are simply left out.
+ *
+ * jsonToWire() / wireToJson() convert between that form and a QJsonObject
+ * in memory, without going through JSON text.
+ */
+namespace ucc
+{
+
+/// One fan curve point, D-Bus (ii)
+struct WireFanPoint
+{
+  qint32 temp = 0;
+  qint32 speed = 0;
+};
+
+/// One keyboard zone, D-Bus (iiii)
+struct WireKeyboardState
+{
+  qint32 brightness = 0;
+  qint32 red = 0;
+  qint32 green = 0;
+  qint32 blue = 0;
+};
+
+using WireFanTable = QList< WireFanPoint >;
+using WireKeyboardStates = QList< WireKeyboardState >;
+
+inline QDBusArgument &operator<<( QDBusArgument &arg, const WireFanPoint &point )
+{
+  arg.beginStructure();
+  arg << point.temp << point.speed;
+  arg.endStructure();
+  return arg;
+}
+
+inline const QDBusArgument &operator>>( const QDBusArgument &arg, WireFanPoint &point )
+{
+  arg.beginStructure();
+  arg >> point.temp >> point.speed;
+  arg.endStructure();
+  return arg;
+}
+
+inline QDBusArgument &operator<<( QDBusArgument &arg, const WireKeyboardState &state )
+{
+  arg.beginStructure();
+  arg << state.brightness << state.red << state.green << state.blue;
+  arg.endStructure();
+  return arg;
+}
+
+inline const QDBusArgument &operator>>( const QDBusArgument &arg, WireKeyboardState &state )
+{
+  arg.beginStructure();
+  arg >> state.brightness >> state.red >> state.green >> state.blue;
+  arg.endStructure();
+  return arg;
+}
+
+} // namespace ucc
+
+Q_DECLARE_METATYPE( ucc::WireFanPoint )
+Q_DECLARE_METATYPE( ucc::WireKeyboardState )
+
+namespace ucc
+{
+
+/// Make the wire types known to QtDBus; call before the first typed profile call
+inline void registerProfileWireTypes()
+{
+  qDBusRegisterMetaType< WireFanPoint >();
+  qDBusRegisterMetaType< WireFanTable >();
+  qDBusRegisterMetaType< WireKeyboardState >();
+  qDBusRegisterMetaType< WireKeyboardStates >();
+}
+
+/**
+ * @brief Demarshal a received value into plain Qt types.
+ *
+ * QtDBus hands nested containers over as QDBusArgument; this turns a{sv}
+ * into QVariantMap, av / aa{sv} into QVariantList, a(ii) into WireFanTable,
+ * a(iiii) into WireKeyboardStates and ai into QList<int>, recursively.
+ */
+inline QVariant plainDBusValue( const QVariant &value )
+{
+  const QMetaType type = value.metaType();
+  if ( type == QMetaType::fromType< QDBusVariant >() )
+    return plainDBusValue( value.value< QDBusVariant >().variant() );
+  if ( type == QMetaType::fromType< QVariantMap >() )
+  {
+    QVariantMap map = value.toMap();
+    for ( auto it = map.begin(); it != map.end(); ++it )
+      it.value() = plainDBusValue( it.value() );
+    return map;
+  }
+  if ( type == QMetaType::fromType< QVariantList >() )
+  {
+    QVariantList list = value.toList();
+    for ( auto &item : list )
+      item = plainDBusValue( item );
+    return list;
+  }
+  if ( type != QMetaType::fromType< QDBusArgument >() )
+    return value;
+
+  const auto arg = value.value< QDBusArgument >();
+  const QString signature = arg.currentSignature();
+  if ( signature == QLatin1String( "a(ii)" ) )
+  {
+    WireFanTable table;
+    arg >> table;
+    return QVariant::fromValue( table );
+  }
+  if ( signature == QLatin1String( "a(iiii)" ) )
+  {
+    WireKeyboardStates states;
+    arg >> states;
+    return QVariant::fromValue( states );
+  }
+  if ( signature == QLatin1String( "ai" ) )
+  {
+    QList< int > ints;
+    arg >> ints;
+    return QVariant::fromValue( ints );
+  }
+  if ( signature == QLatin1String( "a{sv}" ) )
+  {
+    QVariantMap map;
+    arg >> map;
+    return plainDBusValue( map );
+  }
+  if ( signature == QLatin1String( "av" ) )
+  {
+    QVariantList list;
+    arg >> list;
+    return plainDBusValue( list );
+  }
+  if ( signature == QLatin1String( "aa{sv}" ) )
+  {
+    QVariantList list;
+    arg.beginArray();
+    while ( !arg.atEnd() )
+    {
+      QVariantMap map;
+      arg >> map;
+      list.append( plainDBusValue( map ) );
+    }
+    arg.endArray();
+    return list;
+  }
+  return value;
+}
+
+inline bool isFanTableKey( QStringView key )
+{
+  return key == QLatin1String( "tableCPU" ) || key == QLatin1String( "tableGPU" )
+         || key == QLatin1String( "tablePump" ) || key == QLatin1String( "tableWaterCoolerFan" );
+}
+
+inline QVariantMap jsonToWire( const QJsonObject &object );
+
+/// JSON member @p key → wire value; invalid for null, which callers drop
+inline QVariant jsonToWire( const QJsonValue &value, QStringView key )
+{
+  switch ( value.type() )
+  {
+    case QJsonValue::Object:
+      return jsonToWire( value.toObject() );
+
+    case QJsonValue::Array:
+    {
+      const QJsonArray array = value.toArray();
+      if ( isFanTableKey( key ) )
+      {
+        WireFanTable table;
+        table.reserve( array.size() );
+        for ( const auto &entry : array )
+        {
+          const QJsonObject point = entry.toObject();
+          table.append( { point.value( QLatin1String( "temp" ) ).toInt(),
+                          point.value( QLatin1String( "speed" ) ).toInt() } );
+        }
+        return QVariant::fromValue( table );
+      }
+      if ( key == QLatin1String( "states" ) )
+      {
+        WireKeyboardStates states;
+        states.reserve( array.size() );
+        for ( const auto &entry : array )
+        {
+          const QJsonObject state = entry.toObject();
+          states.append( { state.value( QLatin1String( "brightness" ) ).toInt(),
+                           state.value( QLatin1String( "red" ) ).toInt(),
+                           state.value( QLatin1String( "green" ) ).toInt(),
+                           state.value( QLatin1String( "blue" ) ).toInt() } );
+        }
+        return QVariant::fromValue( states );
+      }
+      if ( key == QLatin1String( "tdpValues" ) )
+      {
+        QList< int > ints;
+        ints.reserve( array.size() );
+        for ( const auto &entry : array )
+          ints.append( entry.toInt() );
+        return QVariant::fromValue( ints );
+      }
+      QVariantList list;
+      list.reserve( array.size() );
+      for ( const auto &entry : array )
+      {
+        if ( QVariant item = jsonToWire( entry, QStringView() ); item.isValid() )
+          list.append( item );
+      }
+      return list;
+    }
+
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+      return {};
+
+    default:
+      return value.toVariant();
+  }
+}
+
+/// Profile (or part of one) as JSON → typed wire form
+inline QVariantMap jsonToWire( const QJsonObject &object )
+{
+  QVariantMap map;
+  for ( auto it = object.constBegin(); it != object.constEnd(); ++it )
+  {
+    if ( QVariant item = jsonToWire( it.value(), it.key() ); item.isValid() )
+      map.insert( it.key(), item );
+  }
+  return map;
+}
+
+/// Plain (see plainDBusValue()) wire value → JSON
+inline QJsonValue wireToJson( const QVariant &value )
+{
+  const QMetaType type = value.metaType();
+  if ( type == QMetaType::fromType< QVariantMap >() )
+  {
+    QJsonObject object;
+    const QVariantMap map = value.toMap();
+    for ( auto it = map.constBegin(); it != map.constEnd(); ++it )
+      object.insert( it.key(), wireToJson( it.value() ) );
+    return object;
+  }
+  if ( type == QMetaType::fromType< QVariantList >() )
+  {
+    QJsonArray array;
+    for ( const auto &item : value.toList() )
+      array.append( wireToJson( item ) );
+    return array;
+  }
+  if ( type == QMetaType::fromType< WireFanTable >() )
+  {
+    QJsonArray array;
+    for ( const auto &point : value.value< WireFanTable >() )
+      array.append( QJsonObject{ { QStringLiteral( "temp" ), point.temp },
+                                 { QStringLiteral( "speed" ), point.speed } } );
+    return array;
+  }
+  if ( type == QMetaType::fromType< WireKeyboardStates >() )
+  {
+    QJsonArray array;
+    for ( const auto &state : value.value< WireKeyboardStates >() )
+      array.append( QJsonObject{ { QStringLiteral( "brightness" ), state.brightness },
+                                 { QStringLiteral( "red" ), state.red },
+                                 { QStringLiteral( "green" ), state.green },
+                                 { QStringLiteral( "blue" ), state.blue } } );
+    return array;
+  }
+  if ( type == QMetaType::fromType< QList< int > >() )
+  {
+    QJsonArray array;
+    for ( const int item : value.value< QList< int > >() )
+      array.append( item );
+    return array;
+  }
+  return QJsonValue::fromVariant( value );
+}
+
+inline QJsonObject wireToJson( const QVariantMap &map )
+{
+  return wireToJson( QVariant( map ) ).toObject();
+}
+
+} // namespace ucc
@@ -0,0 +1,38 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace ucc
+{
+
+/**
+ * @brief Sensor groups a client can subscribe to with SubscribeSensors.
+ *
+ * uccd only samples the groups some client needs.  The EC fan and CPU
+ * temperatures used by the fan loop are read regardless of subscriptions.
+ */
+namespace SensorGroup
+{
+static inline constexpr uint32_t DGpu = 1u << 0;          ///< NVML / amdgpu dGPU telemetry (wakes the dGPU)
+static inline constexpr uint32_t IGpu = 1u << 1;          ///< iGPU clocks, temperature and power
+static inline constexpr uint32_t CpuPower = 1u << 2;      ///< RAPL power domains and throttle counters
+static inline constexpr uint32_t CpuFrequency = 1u << 3;  ///< Per-core frequency and busy time
+static inline constexpr uint32_t All = DGpu | IGpu | CpuPower | CpuFrequency;
+} // namespace SensorGroup
+
+} // namespace ucc
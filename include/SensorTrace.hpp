@@ -0,0 +1,216 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "MetricEvents.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ucc
+{
+
+/**
+ * @brief Recorded sensor trace: every metric per daemon sample plus the
+ *        event annotations, for replaying a workload offline.
+ *
+ * File layout (native byte order, written by `ucc-cli record`):
+ * @code
+ *   char     magic[8]            "UCCTRACE"
+ *   uint32_t version             SensorTrace::VERSION
+ *   uint32_t metricCount
+ *   metricCount × { uint8_t length, char name[length] }   metricName() keys
+ *   records, each starting with a tag byte:
+ *     'S'  int64_t timestampMs, metricCount × float   (NaN = no sample)
+ *     'E'  MetricEventRecord                          (64 bytes)
+ * @endcode
+ * Names are stored so a trace stays readable when MetricId grows.  Records
+ * are appended as they arrive; a record cut short by an interrupted
+ * recording is ignored on reading.
+ */
+class SensorTrace
+{
+public:
+  static constexpr char MAGIC[ 8 ] = { 'U', 'C', 'C', 'T', 'R', 'A', 'C', 'E' };
+  static constexpr uint32_t VERSION = 1;
+  static constexpr char SAMPLE_TAG = 'S';
+  static constexpr char EVENT_TAG = 'E';
+
+  std::vector< std::string > metrics;       ///< Column names
+  std::vector< int64_t > timestamps;        ///< Unix epoch ms, one per sample
+  std::vector< float > values;              ///< samples × metrics, row-major
+  std::vector< MetricEventRecord > events;
+
+  [[nodiscard]] size_t samples() const noexcept { return timestamps.size(); }
+
+  /// Column of @p name, nullopt if the trace has no such metric
+  [[nodiscard]] std::optional< size_t > column( std::string_view name ) const noexcept
+  {
+    for ( size_t i = 0; i < metrics.size(); ++i )
+      if ( metrics[ i ] == name )
+        return i;
+    return std::nullopt;
+  }
+
+  /// Value of @p column in sample @p row, NaN if it had none
+  [[nodiscard]] double value( size_t row, size_t column ) const noexcept
+  {
+    return static_cast< double >( values[ row * metrics.size() + column ] );
+  }
+
+  /**
+   * @brief Read a trace written by SensorTraceWriter
+   * @return nullopt if the file is missing or not a trace of this version
+   */
+  [[nodiscard]] static std::optional< SensorTrace > load( const std::string &path )
+  {
+    std::ifstream in( path, std::ios::binary );
+    char magic[ sizeof( MAGIC ) ];
+    uint32_t version = 0, count = 0;
+    if ( !read( in, magic ) || std::memcmp( magic, MAGIC, sizeof( MAGIC ) ) != 0 ||
+         !read( in, version ) || version != VERSION || !read( in, count ) )
+      return std::nullopt;
+
+    SensorTrace trace;
+    for ( uint32_t i = 0; i < count; ++i )
+    {
+      uint8_t length = 0;
+      std::string name;
+      if ( !read( in, length ) )
+        return std::nullopt;
+      name.resize( length );
+      if ( !in.read( name.data(), length ) )
+        return std::nullopt;
+      trace.metrics.push_back( std::move( name ) );
+    }
+
+    std::vector< float > row( count );
+    char tag = 0;
+    while ( read( in, tag ) )
+    {
+      if ( tag == SAMPLE_TAG )
+      {
+        int64_t timestampMs = 0;
+        if ( !read( in, timestampMs ) ||
+             !in.read( reinterpret_cast< char * >( row.data() ), static_cast< std::streamsize >( count * sizeof( float ) ) ) )
+          break;
+        trace.timestamps.push_back( timestampMs );
+        trace.values.insert( trace.values.end(), row.begin(), row.end() );
+      }
+      else if ( tag == EVENT_TAG )
+      {
+        MetricEventRecord event;
+        if ( !read( in, event ) )
+          break;
+        trace.events.push_back( event );
+      }
+      else
+        break;  // unknown record: the rest cannot be framed
+    }
+    return trace;
+  }
+
+private:
+  template< typename T >
+  static bool read( std::istream &in, T &value )
+  {
+    return static_cast< bool >( in.read( reinterpret_cast< char * >( &value ), sizeof( T ) ) );
+  }
+};
+
+/**
+ * @brief Appends samples and events to a SensorTrace file
+ */
+class SensorTraceWriter
+{
+public:
+  /**
+   * @brief Create @p path and write the header for @p metrics
+   * @return false if the file could not be written
+   */
+  bool open( const std::string &path, const std::vector< std::string > &metrics )
+  {
+    m_out.open( path, std::ios::binary | std::ios::trunc );
+    m_columns = metrics.size();
+    m_row.assign( m_columns, 0.0f );
+
+    m_out.write( SensorTrace::MAGIC, sizeof( SensorTrace::MAGIC ) );
+    write( SensorTrace::VERSION );
+    write( static_cast< uint32_t >( m_columns ) );
+    for ( const auto &name : metrics )
+    {
+      const auto length = static_cast< uint8_t >( std::min< size_t >( name.size(), 255 ) );
+      write( length );
+      m_out.write( name.data(), length );
+    }
+    return flush();
+  }
+
+  /// Append one sample; @p values holds one entry per metric, NaN for none
+  template< typename Values >
+  void sample( int64_t timestampMs, const Values &values )
+  {
+    size_t i = 0;
+    for ( const double v : values )
+    {
+      if ( i == m_columns )
+        break;
+      m_row[ i++ ] = static_cast< float >( v );
+    }
+    for ( ; i < m_columns; ++i )
+      m_row[ i ] = std::numeric_limits< float >::quiet_NaN();
+
+    write( SensorTrace::SAMPLE_TAG );
+    write( timestampMs );
+    m_out.write( reinterpret_cast< const char * >( m_row.data() ),
+                 static_cast< std::streamsize >( m_columns * sizeof( float ) ) );
+  }
+
+  void event( const MetricEventRecord &record )
+  {
+    write( SensorTrace::EVENT_TAG );
+    write( record );
+  }
+
+  /// Push buffered records to the file, so an interrupted recording keeps them
+  bool flush()
+  {
+    m_out.flush();
+    return static_cast< bool >( m_out );
+  }
+
+private:
+  template< typename T >
+  void write( const T &value )
+  {
+    m_out.write( reinterpret_cast< const char * >( &value ), sizeof( T ) );
+  }
+
+  std::ofstream m_out;
+  size_t m_columns = 0;
+  std::vector< float > m_row;
+};
+
+} // namespace ucc
@@ -0,0 +1,145 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace ucc
+{
+
+/**
+ * @brief Fixed-capacity ring of chart points, oldest first, that tracks
+ *        what a drawn series still has to be told.
+ *
+ * Points are pushed in time order and trimmed from the front; a push into
+ * a full ring drops the oldest point.  commit() reports the changes since
+ * the previous commit as "remove N points at the front, append the points
+ * from index I on", so the drawn series is updated with work proportional
+ * to the change instead of the window.
+ *
+ * @tparam Point Anything with x() (e.g. QPointF)
+ */
+template< typename Point >
+class SeriesRing
+{
+public:
+  /// Changes to apply to the drawn series, oldest removal first
+  struct Delta
+  {
+    size_t removeFront = 0;  ///< Points to remove from the front of the series
+    size_t appendFrom = 0;   ///< Index of the first point to append; size() if none
+
+    [[nodiscard]] bool empty( size_t size ) const noexcept { return removeFront == 0 && appendFrom >= size; }
+  };
+
+  explicit SeriesRing( size_t capacity ) : m_capacity( std::max< size_t >( capacity, 1 ) ) {}
+
+  [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+  [[nodiscard]] size_t size() const noexcept { return m_size; }
+  [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+  /// Point @p i, 0 being the oldest
+  [[nodiscard]] const Point &operator[]( size_t i ) const noexcept { return m_data[ ( m_head + i ) % m_capacity ]; }
+
+  [[nodiscard]] const Point &front() const noexcept { return ( *this )[ 0 ]; }
+  [[nodiscard]] const Point &back() const noexcept { return ( *this )[ m_size - 1 ]; }
+
+  /// Points the drawn series already has; they are the oldest ones
+  [[nodiscard]] size_t committed() const noexcept { return m_size - m_pending; }
+
+  /// Append @p point, dropping the oldest one if the ring is full
+  void push( const Point &point )
+  {
+    if ( m_data.empty() )
+      m_data.resize( m_capacity );  // first use; unused metrics never allocate
+    if ( m_size == m_capacity )
+      popFront();
+    m_data[ ( m_head + m_size ) % m_capacity ] = point;
+    ++m_size;
+    ++m_pending;
+  }
+
+  /**
+   * @brief Drop the points before @p cutoff
+   * @return Number of points dropped
+   */
+  size_t trimBefore( double cutoff ) noexcept
+  {
+    size_t dropped = 0;
+    while ( m_size > 0 && front().x() < cutoff )
+    {
+      popFront();
+      ++dropped;
+    }
+    return dropped;
+  }
+
+  /// Drop every point; the caller clears the drawn series as well
+  void clear() noexcept
+  {
+    m_head = 0;
+    m_size = 0;
+    m_pending = 0;
+    m_removeFront = 0;
+  }
+
+  /// Index of the first point with x() >= @p x, size() if there is none
+  [[nodiscard]] size_t lowerBound( double x ) const noexcept
+  {
+    size_t lo = 0, hi = m_size;
+    while ( lo < hi )
+    {
+      const size_t mid = lo + ( hi - lo ) / 2;
+      if ( ( *this )[ mid ].x() < x )
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  /// The changes since the previous commit(); the ring then counts them as drawn
+  Delta commit() noexcept
+  {
+    const Delta delta{ m_removeFront, m_size - m_pending };
+    m_removeFront = 0;
+    m_pending = 0;
+    return delta;
+  }
+
+private:
+  void popFront() noexcept
+  {
+    // a point the series has gets removed from it; one it never got is just forgotten
+    if ( committed() > 0 )
+      ++m_removeFront;
+    else
+      --m_pending;
+    m_head = ( m_head + 1 ) % m_capacity;
+    --m_size;
+  }
+
+  std::vector< Point > m_data;
+  size_t m_capacity;
+  size_t m_head = 0;
+  size_t m_size = 0;
+  size_t m_pending = 0;      ///< Newest points not yet committed
+  size_t m_removeFront = 0;  ///< Committed points dropped since the last commit
+};
+
+} // namespace ucc
@@ -15,12 +15,28 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
-#include <sstream>
 #include <optional>
 #include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief How a SysfsNode obtains its value on read().
+ */
+enum class SysfsReadMode
+{
+  Reopen,  ///< open/read/close on every call (default)
+  Cached,  ///< Keep the fd open and pread() from offset 0
+};
 
 /**
  * @brief Template class for reading/writing sysfs files with type safety
@@ -36,23 +52,73 @@
  * - std::vector<int32_t> (with range support like "0-7")
  * - std::vector<std::string>
  *
+ * Reads go into a stack buffer and are parsed with std::from_chars.  In
+ * SysfsReadMode::Cached the file descriptor is opened on first use and
+ * kept; sysfs regenerates an attribute on every read at offset 0, so one
+ * pread() per call suffices.  If the node went away (ENODEV after CPU or
+ * device hotplug) it is reopened once; if open() fails for lack of fds the
+ * node falls back to a one-shot read.  Cached nodes may be read from
+ * several threads.
+ *
  * @tparam T The type of data stored in the sysfs file
  */
 template< typename T >
 class SysfsNode
 {
 public:
-  explicit SysfsNode( const std::string &path, const std::string &delimiter = "" )
+  explicit SysfsNode( const std::string &path, const std::string &delimiter = "",
+                      SysfsReadMode mode = SysfsReadMode::Reopen )
     : m_path( path )
     , m_delimiter( delimiter )
+    , m_cache( mode == SysfsReadMode::Cached ? std::make_unique< CachedFd >() : nullptr )
   {}
 
+  SysfsNode( const std::string &path, SysfsReadMode mode )
+    : SysfsNode( path, "", mode )
+  {}
+
+  // Copies get their own descriptor, opened lazily
+  SysfsNode( const SysfsNode &other )
+    : m_path( other.m_path )
+    , m_delimiter( other.m_delimiter )
+    , m_cache( other.m_cache ? std::make_unique< CachedFd >() : nullptr )
+  {}
+
+  SysfsNode &operator=( const SysfsNode &other )
+  {
+    if ( this != &other )
+    {
+      m_path = other.m_path;
+      m_delimiter = other.m_delimiter;
+      m_cache = other.m_cache ? std::make_unique< CachedFd >() : nullptr;
+    }
+    return *this;
+  }
+
+  SysfsNode( SysfsNode && ) noexcept = default;
+  SysfsNode &operator=( SysfsNode && ) noexcept = default;
+  ~SysfsNode() = default;
+
+  [[nodiscard]] SysfsReadMode mode() const noexcept
+  {
+    return m_cache ? SysfsReadMode::Cached : SysfsReadMode::Reopen;
+  }
+
   /**
    * @brief Check if the sysfs node exists and is accessible
+   *
+   * A cached node with an open descriptor answers without a stat().
    */
   [[nodiscard]] bool isAvailable() const noexcept
   {
-    return std::filesystem::exists( m_path );
+    if ( m_cache )
+    {
+      std::lock_guard< std::mutex > lock( m_cache->mutex );
+      if ( m_cache->fd >= 0 )
+        return true;
+    }
+    std::error_code ec;
+    return std::filesystem::exists( m_path, ec );
   }
 
   /**
@@ -63,12 +129,13 @@ public:
   {
     try
     {
-      std::ifstream file( m_path );
+      char buf[ BUFFER_SIZE ];
+      const ssize_t n = m_cache ? readCached( buf ) : readOnce( buf );
 
-      if ( not file.is_open() )
+      if ( n <= 0 )
         return std::nullopt;
 
-      return readImpl( file );
+      return parse( std::string_view( buf, static_cast< size_t >( n ) ) );
     }
     catch ( ... )
     {
@@ -99,20 +166,136 @@ public:
   }
 
 private:
+  /// Sysfs attributes are at most one page
+  static constexpr size_t BUFFER_SIZE = 4096;
+
+  struct CachedFd
+  {
+    std::mutex mutex;
+    int fd = -1;
+
+    CachedFd() = default;
+    CachedFd( const CachedFd & ) = delete;
+    CachedFd &operator=( const CachedFd & ) = delete;
+    ~CachedFd()
+    {
+      if ( fd >= 0 )
+        ::close( fd );
+    }
+  };
+
   std::string m_path;
   std::string m_delimiter;
+  std::unique_ptr< CachedFd > m_cache;
+
+  static ssize_t readFully( int fd, char *buf ) noexcept
+  {
+    ssize_t n;
+    do
+      n = ::pread( fd, buf, BUFFER_SIZE, 0 );
+    while ( n < 0 and errno == EINTR );
+    return n;
+  }
+
+  ssize_t readOnce( char *buf ) const noexcept
+  {
+    const int fd = ::open( m_path.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 )
+      return -1;
+    const ssize_t n = readFully( fd, buf );
+    ::close( fd );
+    return n;
+  }
+
+  ssize_t readCached( char *buf ) const noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_cache->mutex );
+
+    for ( int attempt = 0; attempt < 2; ++attempt )
+    {
+      if ( m_cache->fd < 0 )
+      {
+        m_cache->fd = ::open( m_path.c_str(), O_RDONLY | O_CLOEXEC );
+        if ( m_cache->fd < 0 )
+          return ( errno == EMFILE or errno == ENFILE ) ? readOnce( buf ) : -1;
+      }
+
+      const ssize_t n = readFully( m_cache->fd, buf );
+      if ( n >= 0 )
+        return n;
+
+      // The node vanished or was replaced: drop the fd and retry with a fresh open
+      const int err = errno;
+      ::close( m_cache->fd );
+      m_cache->fd = -1;
+      if ( err != ENODEV and err != ENOENT and err != EBADF and err != ESTALE )
+        return -1;
+    }
+    return -1;
+  }
+
+  static std::string_view trim( std::string_view sv ) noexcept
+  {
+    const auto first = sv.find_first_not_of( " \t\n\r" );
+    if ( first == std::string_view::npos )
+      return {};
+    const auto last = sv.find_last_not_of( " \t\n\r" );
+    return sv.substr( first, last - first + 1 );
+  }
+
+  /// First line without the line break, like std::getline()
+  static std::string_view firstLine( std::string_view sv ) noexcept
+  {
+    sv = sv.substr( 0, sv.find( '\n' ) );
+    if ( not sv.empty() and sv.back() == '\r' )
+      sv.remove_suffix( 1 );
+    return sv;
+  }
+
+  /// Leading integer after optional whitespace, like operator>> / std::stoi
+  template< typename Int >
+  static std::optional< Int > parseInt( std::string_view sv ) noexcept
+  {
+    const auto first = sv.find_first_not_of( " \t\n\r\v\f" );
+    if ( first == std::string_view::npos )
+      return std::nullopt;
+    sv.remove_prefix( first );
+    if ( not sv.empty() and sv.front() == '+' )
+      sv.remove_prefix( 1 );
+
+    Int value{};
+    const auto res = std::from_chars( sv.data(), sv.data() + sv.size(), value );
+    if ( res.ec != std::errc() )
+      return std::nullopt;
+    return value;
+  }
+
+  /// Calls fn( token ) for every non-empty, trimmed token of the first line
+  template< typename Fn >
+  static void forEachToken( std::string_view line, char delim, Fn &&fn )
+  {
+    while ( true )
+    {
+      const auto pos = line.find( delim );
+      const std::string_view token = trim( line.substr( 0, pos ) );
+      if ( not token.empty() )
+        fn( token );
+      if ( pos == std::string_view::npos )
+        break;
+      line.remove_prefix( pos + 1 );
+    }
+  }
 
   // Specialization for bool
-  [[nodiscard]] std::optional< T > readImpl( std::ifstream &file ) const
+  [[nodiscard]] std::optional< T > parse( std::string_view content ) const
     requires std::is_same_v< T, bool >
   {
-    int value;
-    file >> value;
+    const auto value = parseInt< int >( content );
 
-    if ( file.fail() )
+    if ( not value.has_value() )
       return std::nullopt;
 
-    return value != 0;
+    return *value != 0;
   }
 
   bool writeImpl( std::ofstream &file, const T &value ) const
@@ -123,16 +306,10 @@ private:
   }
 
   // Specialization for int32_t
-  [[nodiscard]] std::optional< T > readImpl( std::ifstream &file ) const
+  [[nodiscard]] std::optional< T > parse( std::string_view content ) const
     requires std::is_same_v< T, int32_t >
   {
-    int32_t value;
-    file >> value;
-
-    if ( file.fail() )
-      return std::nullopt;
-
-    return value;
+    return parseInt< int32_t >( content );
   }
 
   bool writeImpl( std::ofstream &file, const T &value ) const
@@ -143,16 +320,10 @@ private:
   }
 
   // Specialization for int64_t
-  [[nodiscard]] std::optional< T > readImpl( std::ifstream &file ) const
+  [[nodiscard]] std::optional< T > parse( std::string_view content ) const
     requires std::is_same_v< T, int64_t >
   {
-    int64_t value;
-    file >> value;
-
-    if ( file.fail() )
-      return std::nullopt;
-
-    return value;
+    return parseInt< int64_t >( content );
   }
 
   bool writeImpl( std::ofstream &file, const T &value ) const
@@ -163,23 +334,10 @@ private:
   }
 
   // Specialization for std::string
-  [[nodiscard]] std::optional< T > readImpl( std::ifstream &file ) const
+  [[nodiscard]] std::optional< T > parse( std::string_view content ) const
     requires std::is_same_v< T, std::string >
   {
-    std::string value;
-    std::getline( file, value );
-
-    if ( file.fail() )
-      return std::nullopt;
-
-    // Trim whitespace
-    if ( not value.empty() and value.back() == '\n' )
-      value.pop_back();
-
-    if ( not value.empty() and value.back() == '\r' )
-      value.pop_back();
-
-    return value;
+    return std::string( firstLine( content ) );
   }
 
   bool writeImpl( std::ofstream &file, const T &value ) const
@@ -190,47 +348,48 @@ private:
   }
 
   // Specialization for std::vector<int32_t>
-  [[nodiscard]] std::optional< T > readImpl( std::ifstream &file ) const
+  [[nodiscard]] std::optional< T > parse( std::string_view content ) const
     requires std::is_same_v< T, std::vector< int32_t > >
   {
-    std::string line;
-    std::getline( file, line );
+    const std::string_view line = firstLine( content );
 
-    if ( file.fail() or line.empty() )
+    if ( line.empty() )
       return std::nullopt;
 
-    std::vector< int32_t > result;
-    std::istringstream iss( line );
-
     // Handle range format (e.g., "0-7" or "0,2,4-7")
-    std::string token;
+    std::vector< int32_t > result;
     const char delim = m_delimiter.empty() ? ',' : m_delimiter[ 0 ];
+    bool valid = true;
 
-    while ( std::getline( iss, token, delim ) )
-    {
-      // Trim whitespace
-      token.erase( 0, token.find_first_not_of( " \t\n\r" ) );
-      token.erase( token.find_last_not_of( " \t\n\r" ) + 1 );
-
-      if ( token.empty() )
-        continue;
-
-      // Check for range (e.g., "0-7")
-      size_t dashPos = token.find( '-' );
+    forEachToken( line, delim, [&]( std::string_view token ) {
+      const size_t dashPos = token.find( '-' );
+      const auto start = parseInt< int32_t >( token.substr( 0, dashPos ) );
 
-      if ( dashPos != std::string::npos )
+      if ( not start.has_value() )
       {
-        int32_t start = std::stoi( token.substr( 0, dashPos ) );
-        int32_t end = std::stoi( token.substr( dashPos + 1 ) );
+        valid = false;
+        return;
+      }
 
-        for ( int32_t i = start; i <= end; ++i )
-          result.push_back( i );
+      if ( dashPos == std::string_view::npos )
+      {
+        result.push_back( *start );
+        return;
       }
-      else
+
+      const auto end = parseInt< int32_t >( token.substr( dashPos + 1 ) );
+      if ( not end.has_value() )
       {
-        result.push_back( std::stoi( token ) );
+        valid = false;
+        return;
       }
-    }
+
+      for ( int32_t i = *start; i <= *end; ++i )
+        result.push_back( i );
+    } );
+
+    if ( not valid )
+      return std::nullopt;
 
     return result;
   }
@@ -252,30 +411,18 @@ private:
   }
 
   // Specialization for std::vector<std::string>
-  [[nodiscard]] std::optional< T > readImpl( std::ifstream &file ) const
+  [[nodiscard]] std::optional< T > parse( std::string_view content ) const
     requires std::is_same_v< T, std::vector< std::string > >
   {
-    std::string line;
-    std::getline( file, line );
+    const std::string_view line = firstLine( content );
 
-    if ( file.fail() or line.empty() )
+    if ( line.empty() )
       return std::nullopt;
 
     std::vector< std::string > result;
-    std::istringstream iss( line );
     const char delim = m_delimiter.empty() ? ' ' : m_delimiter[ 0 ];
 
-    std::string token;
-
-    while ( std::getline( iss, token, delim ) )
-    {
-      // Trim whitespace
-      token.erase( 0, token.find_first_not_of( " \t\n\r" ) );
-      token.erase( token.find_last_not_of( " \t\n\r" ) + 1 );
-
-      if ( not token.empty() )
-        result.push_back( token );
-    }
+    forEachToken( line, delim, [&]( std::string_view token ) { result.emplace_back( token ); } );
 
     return result;
   }
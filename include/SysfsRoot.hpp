@@ -0,0 +1,56 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace ucc
+{
+
+/// Environment variable naming a directory that stands in for "/"
+inline constexpr const char *SYSFS_ROOT_ENV = "UCCD_SYSFS_ROOT";
+
+/**
+ * @brief Prefix under which the daemon looks for sysfs and the procfs
+ *        files it samples; empty on real hardware.
+ *
+ * Set UCCD_SYSFS_ROOT to a directory holding a fake tree (sys/class/...,
+ * proc/stat) to run uccd against simulated hardware.  Read once, so it
+ * must be set before the daemon starts.
+ */
+inline const std::string &sysfsRoot()
+{
+  static const std::string root = [] {
+    const char *value = std::getenv( SYSFS_ROOT_ENV );
+    std::string prefix = value ? value : "";
+    while ( !prefix.empty() && prefix.back() == '/' )
+      prefix.pop_back();
+    return prefix;
+  }();
+  return root;
+}
+
+/// @p path ("/sys/...") resolved against sysfsRoot()
+inline std::string sysfsPath( std::string_view path )
+{
+  std::string resolved = sysfsRoot();
+  resolved.append( path );
+  return resolved;
+}
+
+} // namespace ucc
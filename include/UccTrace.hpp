@@ -0,0 +1,84 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file UccTrace.hpp
+ * @brief Optional trace spans as USDT probes.
+ *
+ * Configured with -DUCC_TRACING=ON (needs <sys/sdt.h>), uccd carries the
+ * probes of provider "uccd":
+ *   span_begin( category, name, arg ), span_end( category, name, arg )
+ *   instant( category, name, arg )
+ * category and name are C strings, arg a uint64_t (device index, ioctl
+ * request, subsystem mask, ...).  A probe nobody attached to is a nop.
+ * Without UCC_TRACING the macros expand to nothing and their arguments are
+ * not evaluated.
+ *
+ * Any USDT consumer can record them: uccd/uccd-trace.bt turns them into
+ * Chrome trace JSON for ui.perfetto.dev; LTTng takes them as
+ * --userspace-probe=sdt:<uccd>:uccd:span_begin, perf as sdt_uccd:*.
+ * The tracer adds the thread and the timestamp.
+ */
+
+#ifdef UCC_TRACING
+
+#include <cstdint>
+#include <sys/sdt.h>
+
+namespace ucc::trace
+{
+/// span_begin on construction, span_end on destruction
+class Span
+{
+public:
+  Span( const char *category, const char *name, uint64_t arg = 0 ) noexcept
+    : m_category( category ), m_name( name ), m_arg( arg )
+  {
+    STAP_PROBE3( uccd, span_begin, m_category, m_name, m_arg );
+  }
+
+  ~Span() { STAP_PROBE3( uccd, span_end, m_category, m_name, m_arg ); }
+
+  Span( const Span & ) = delete;
+  Span &operator=( const Span & ) = delete;
+
+private:
+  const char *m_category;
+  const char *m_name;
+  uint64_t m_arg;
+};
+}
+
+#define UCC_TRACE_CONCAT_( a, b ) a##b
+#define UCC_TRACE_CONCAT( a, b ) UCC_TRACE_CONCAT_( a, b )
+
+/// Span from here to the end of the enclosing scope
+#define UCC_TRACE_SCOPE( category, name ) \
+  const ::ucc::trace::Span UCC_TRACE_CONCAT( uccTraceSpan, __COUNTER__ )( category, name )
+#define UCC_TRACE_SCOPE_ARG( category, name, arg ) \
+  const ::ucc::trace::Span UCC_TRACE_CONCAT( uccTraceSpan, __COUNTER__ )( category, name, static_cast< uint64_t >( arg ) )
+/// Point event
+#define UCC_TRACE_INSTANT( category, name, arg ) \
+  STAP_PROBE3( uccd, instant, category, name, static_cast< uint64_t >( arg ) )
+
+#else
+
+#define UCC_TRACE_SCOPE( category, name ) static_cast< void >( 0 )
+#define UCC_TRACE_SCOPE_ARG( category, name, arg ) static_cast< void >( 0 )
+#define UCC_TRACE_INSTANT( category, name, arg ) static_cast< void >( 0 )
+
+#endif
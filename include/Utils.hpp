@@ -28,6 +28,7 @@
 #include <fcntl.h>
 
 #include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
 
 extern char **environ;
 
@@ -58,7 +59,7 @@ inline constexpr std::array kSupportedDeviceSKUs = {
  */
 inline bool isDeviceSupported()
 {
-  const auto sku = SysfsNode< std::string >( "/sys/class/dmi/id/product_sku" ).read();
+  const auto sku = SysfsNode< std::string >( sysfsPath( "/sys/class/dmi/id/product_sku" ) ).read();
   if ( !sku.has_value() )
     return false;
 
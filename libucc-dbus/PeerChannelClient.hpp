@@ -0,0 +1,170 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "PeerChannelProtocol.hpp"
+
+namespace ucc
+{
+
+/**
+ * @brief Client end of the private uccd peer channel (see PeerChannelProtocol.hpp).
+ *
+ * Calls are synchronous with a short timeout; any transport error closes
+ * the channel and the caller falls back to the system bus.
+ */
+class PeerChannelClient
+{
+public:
+  static constexpr int CALL_TIMEOUT_MS = 250;
+
+  PeerChannelClient() = default;
+  ~PeerChannelClient() { close(); }
+
+  PeerChannelClient( const PeerChannelClient & ) = delete;
+  PeerChannelClient &operator=( const PeerChannelClient & ) = delete;
+
+  /// Connect to @p address (from RequestPeerChannel) and present @p token
+  bool open( const QString &address, const QByteArray &token )
+  {
+    close();
+    const QString prefix = QLatin1String( peer::ABSTRACT_PREFIX );
+    if ( !address.startsWith( prefix ) || token.isEmpty() )
+      return false;
+
+    const QByteArray name = address.mid( prefix.size() ).toLatin1();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if ( name.isEmpty() || static_cast< size_t >( name.size() ) >= sizeof( addr.sun_path ) - 1 )
+      return false;
+    std::copy( name.begin(), name.end(), addr.sun_path + 1 );  // leading NUL: abstract namespace
+
+    m_fd = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    const auto len = static_cast< socklen_t >( offsetof( sockaddr_un, sun_path ) + 1 + name.size() );
+    if ( m_fd < 0 || ::connect( m_fd, reinterpret_cast< sockaddr * >( &addr ), len ) < 0 )
+    {
+      close();
+      return false;
+    }
+
+    if ( !call( QLatin1String( peer::HELLO ), { QVariant( token ) } ) )
+    {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close()
+  {
+    if ( m_fd >= 0 )
+      ::close( m_fd );
+    m_fd = -1;
+    m_in.clear();
+  }
+
+  [[nodiscard]] bool isOpen() const noexcept { return m_fd >= 0; }
+
+  /**
+   * @brief Call @p method on the daemon.
+   * @param refused Set when the daemon answered with an error, e.g.
+   *                peer::ERROR_NOT_AUTHORIZED; the channel stays open
+   * @return The reply value; nullopt on errors and refusals
+   */
+  std::optional< QVariant > call( const QString &method, const QVariantList &args, bool *refused = nullptr )
+  {
+    if ( refused )
+      *refused = false;
+    if ( m_fd < 0 )
+      return std::nullopt;
+
+    const quint32 serial = ++m_serial;
+    const QByteArray out = peer::encodeRequest( peer::Request{ serial, method, args } );
+    for ( qsizetype sent = 0; sent < out.size(); )
+    {
+      const ssize_t n = ::send( m_fd, out.constData() + sent, static_cast< size_t >( out.size() - sent ), MSG_NOSIGNAL );
+      if ( n < 0 && errno == EINTR )
+        continue;
+      if ( n <= 0 )
+      {
+        close();
+        return std::nullopt;
+      }
+      sent += n;
+    }
+
+    const auto reply = readReply();
+    if ( !reply || reply->serial != serial )
+    {
+      close();
+      return std::nullopt;
+    }
+    if ( !reply->ok )
+    {
+      if ( refused )
+        *refused = true;
+      return std::nullopt;
+    }
+    return reply->value;
+  }
+
+private:
+  std::optional< peer::Reply > readReply()
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( CALL_TIMEOUT_MS );
+    bool corrupt = false;
+    for ( ;; )
+    {
+      if ( auto payload = peer::takeFrame( m_in, corrupt ) )
+        return peer::decodeReply( *payload );
+      if ( corrupt )
+        return std::nullopt;
+
+      const auto left = std::chrono::duration_cast< std::chrono::milliseconds >(
+        deadline - std::chrono::steady_clock::now() ).count();
+      pollfd pfd{ m_fd, POLLIN, 0 };
+      if ( left <= 0 || ::poll( &pfd, 1, static_cast< int >( left ) ) <= 0 )
+        return std::nullopt;
+
+      char chunk[ 65536 ];
+      const ssize_t n = ::recv( m_fd, chunk, sizeof( chunk ), 0 );
+      if ( n <= 0 )
+        return std::nullopt;
+      m_in.append( chunk, n );
+    }
+  }
+
+  int m_fd = -1;
+  quint32 m_serial = 0;
+  QByteArray m_in;
+};
+
+} // namespace ucc
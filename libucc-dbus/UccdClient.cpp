@@ -14,10 +14,14 @@
  */
 
 #include "UccdClient.hpp"
+#include "ProfileWireTypes.hpp"
 #include <QDBusMessage>
 #include <QDBusError>
 #include <QDBusArgument>
 #include <QDBusConnectionInterface>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusUnixFileDescriptor>
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -26,6 +30,7 @@
 #include <QThread>
 #include <QFile>
 #include <QVariantMap>
+#include <chrono>
 
 namespace ucc
 {
@@ -33,6 +38,8 @@ namespace ucc
 UccdClient::UccdClient( QObject *parent )
   : QObject( parent )
 {
+  registerProfileWireTypes();
+
   // Initial connection attempt (uccd may not be running yet — that's fine)
   connectToDaemon();
 
@@ -65,6 +72,18 @@ void UccdClient::subscribeDbusSignals()
   QDBusConnection::systemBus().disconnect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
                   "PowerStateChanged", this,
                   SLOT( onPowerStateChangedSignal( QString ) ) );
+  QDBusConnection::systemBus().disconnect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
+                  "MetricsSample", this,
+                  SLOT( onMetricsSampleSignal( qlonglong, QList< double > ) ) );
+  QDBusConnection::systemBus().disconnect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
+                  "AlertRaised", this,
+                  SLOT( onAlertRaisedSignal( QString, QString, double, qlonglong ) ) );
+  QDBusConnection::systemBus().disconnect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
+                  "AlertCleared", this,
+                  SLOT( onAlertClearedSignal( QString, QString, double, qlonglong ) ) );
+  QDBusConnection::systemBus().disconnect( DBUS_SERVICE, DBUS_PATH, DBUS_PROPERTIES_INTERFACE,
+                  "PropertiesChanged", this,
+                  SLOT( onPropertiesChangedSignal( QString, QVariantMap, QStringList ) ) );
 
   QDBusConnection::systemBus().connect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
                "ProfileChanged", this,
@@ -72,14 +91,33 @@ void UccdClient::subscribeDbusSignals()
   QDBusConnection::systemBus().connect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
                "PowerStateChanged", this,
                SLOT( onPowerStateChangedSignal( QString ) ) );
+  QDBusConnection::systemBus().connect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
+               "MetricsSample", this,
+               SLOT( onMetricsSampleSignal( qlonglong, QList< double > ) ) );
+  QDBusConnection::systemBus().connect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
+               "AlertRaised", this,
+               SLOT( onAlertRaisedSignal( QString, QString, double, qlonglong ) ) );
+  QDBusConnection::systemBus().connect( DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
+               "AlertCleared", this,
+               SLOT( onAlertClearedSignal( QString, QString, double, qlonglong ) ) );
+  QDBusConnection::systemBus().connect( DBUS_SERVICE, DBUS_PATH, DBUS_PROPERTIES_INTERFACE,
+               "PropertiesChanged", this,
+               SLOT( onPropertiesChangedSignal( QString, QVariantMap, QStringList ) ) );
 }
 
 void UccdClient::connectToDaemon()
 {
-  // Check if the service actually has an owner on the bus.  We must NOT
-  // just create a QDBusInterface, because with a D-Bus activation .service
-  // file the bus would auto-start uccd during the introspection call that
-  // QDBusInterface performs in its constructor.
+  // A new daemon instance publishes a new segment
+  m_liveMetrics.detach();
+  m_liveMetricsRequested = false;
+  invalidateReplyCache();
+  m_typedProfileApi = true;
+  m_versionedJsonApi = true;
+  m_versionedJson.clear();
+
+  // Check if the service actually has an owner on the bus.  A call to it
+  // would otherwise auto-start uccd through its D-Bus activation .service
+  // file.
   if ( auto *busIface = QDBusConnection::systemBus().interface();
        !busIface || !busIface->isServiceRegistered( QLatin1String( DBUS_SERVICE ) ) )
   {
@@ -89,12 +127,11 @@ void UccdClient::connectToDaemon()
     return;
   }
 
-  // The service is running — safe to introspect without triggering activation.
-  // Do NOT pass a parent to QDBusInterface — unique_ptr owns its lifetime.
-  m_interface = std::make_unique< QDBusInterface >(
-    DBUS_SERVICE,
-    DBUS_PATH,
-    DBUS_INTERFACE,
+  // The service is running.  No introspection: the proxy sends the calls as they are
+  m_interface = std::make_unique< UccdProxy >(
+    QString::fromLatin1( DBUS_SERVICE ),
+    QString::fromLatin1( DBUS_PATH ),
+    QString::fromLatin1( DBUS_INTERFACE ),
     QDBusConnection::systemBus() );
 
   m_connected = m_interface->isValid();
@@ -102,6 +139,15 @@ void UccdClient::connectToDaemon()
   if ( m_connected )
   {
     subscribeDbusSignals();
+    // A restarted daemon has forgotten our subscription
+    if ( m_metricsSamplesEnabled )
+      callVoidMethod( "SubscribeMetricsSamples" );
+    if ( m_fastSamplingEnabled )
+      callVoidMethod( "SubscribeFastSampling" );
+    if ( m_sensorGroups != 0 )
+      callVoidMethod( "SubscribeSensors", static_cast< uint >( m_sensorGroups ) );
+    if ( m_peerChannelEnabled )
+      openPeerChannel();
   }
   else
   {
@@ -127,6 +173,10 @@ void UccdClient::onServiceUnregistered( const QString &service )
   Q_UNUSED( service )
   qWarning() << "[UccdClient] uccd disappeared from the system bus";
   m_connected = false;
+  m_liveMetrics.detach();
+  m_liveMetricsRequested = false;
+  m_peer.close();
+  invalidateReplyCache();
   emit connectionStatusChanged( false );
 }
 
@@ -141,14 +191,63 @@ void UccdClient::onProfileChangedSignal( const QString &profileId,
                                          const QString &fanProfileId,
                                          const QString &gpuProfileId )
 {
+  invalidateReplyCache();
   emit profileChanged( profileId, keyboardProfileId, fanProfileId, gpuProfileId );
 }
 
 void UccdClient::onPowerStateChangedSignal( const QString &state )
 {
+  invalidateReplyCache();
   emit powerStateChanged( state );
 }
 
+void UccdClient::onMetricsSampleSignal( qlonglong timestampMs, const QList< double > &values )
+{
+  // a new sample supersedes every cached reading
+  invalidateReplyCache();
+  if ( m_metricsSamplesEnabled )
+    emit metricsSample( timestampMs, values );
+}
+
+void UccdClient::onAlertRaisedSignal( const QString &ruleId, const QString &metric, double value, qlonglong timestampMs )
+{
+  emit alertRaised( ruleId, metric, value, timestampMs );
+}
+
+void UccdClient::onAlertClearedSignal( const QString &ruleId, const QString &metric, double value, qlonglong timestampMs )
+{
+  emit alertCleared( ruleId, metric, value, timestampMs );
+}
+
+void UccdClient::onPropertiesChangedSignal( const QString &interfaceName,
+                                            const QVariantMap &changed,
+                                            const QStringList &invalidated )
+{
+  Q_UNUSED( invalidated )
+  if ( interfaceName != QLatin1String( DBUS_INTERFACE ) )
+    return;
+
+  invalidateReplyCache();
+  emit propertiesChanged( changed );
+}
+
+std::optional< QVariantMap > UccdClient::getProperties()
+{
+  if ( !isConnected() )
+    return std::nullopt;
+
+  QDBusMessage call = QDBusMessage::createMethodCall( DBUS_SERVICE, DBUS_PATH, DBUS_PROPERTIES_INTERFACE,
+                                                      QStringLiteral( "GetAll" ) );
+  call << QString::fromLatin1( DBUS_INTERFACE );
+  QDBusReply< QVariantMap > reply = QDBusConnection::systemBus().call( call );
+  if ( !reply.isValid() )
+  {
+    qWarning() << "DBus call failed: GetAll -" << reply.error().message();
+    return std::nullopt;
+  }
+  return reply.value();
+}
+
 // Template implementations
 template< typename T >
 std::optional< T > UccdClient::callMethod( const QString &method ) const
@@ -158,6 +257,9 @@ std::optional< T > UccdClient::callMethod( const QString &method ) const
     return std::nullopt;
   }
 
+  if ( auto value = callPeer( method ) )
+    return qvariant_cast< T >( *value );
+
   QDBusReply< T > reply = m_interface->call( method );
   if ( reply.isValid() )
   {
@@ -178,6 +280,9 @@ std::optional< T > UccdClient::callMethod( const QString &method, const Args &..
     return std::nullopt;
   }
 
+  if ( auto value = callPeer( method, { QVariant::fromValue( args )... } ) )
+    return qvariant_cast< T >( *value );
+
   QDBusReply< T > reply = m_interface->call( method, args... );
   if ( reply.isValid() )
   {
@@ -190,6 +295,40 @@ std::optional< T > UccdClient::callMethod( const QString &method, const Args &..
   }
 }
 
+template< typename T, typename... Args >
+void UccdClient::callMethodAsync( QObject *context, const QString &method, Reply< T > done, const Args &...args ) const
+{
+  if ( !isConnected() )
+  {
+    // keep the contract: never call back before returning
+    QMetaObject::invokeMethod( context, [done = std::move( done )]() { done( std::nullopt ); }, Qt::QueuedConnection );
+    return;
+  }
+
+  if ( auto value = callPeer( method, { QVariant::fromValue( args )... } ) )
+  {
+    QMetaObject::invokeMethod( context, [done = std::move( done ), value = qvariant_cast< T >( *value )]() {
+      done( value );
+    }, Qt::QueuedConnection );
+    return;
+  }
+
+  // parented to the caller's context: destroyed with it, taking the callback along
+  auto *watcher = new QDBusPendingCallWatcher( m_interface->asyncCall( method, args... ), context );
+  QObject::connect( watcher, &QDBusPendingCallWatcher::finished, context,
+                    [method, done = std::move( done )]( QDBusPendingCallWatcher *call ) {
+    QDBusPendingReply< T > reply = *call;
+    call->deleteLater();
+    if ( reply.isError() )
+    {
+      qWarning() << "DBus call failed:" << method << "-" << reply.error().message();
+      done( std::nullopt );
+      return;
+    }
+    done( reply.value() );
+  } );
+}
+
 bool UccdClient::callVoidMethod( const QString &method ) const
 {
   if ( !isConnected() )
@@ -241,11 +380,7 @@ std::optional< bool > UccdClient::isDeviceSupported()
 // Profile Management
 std::optional< std::string > UccdClient::getDefaultProfilesJSON()
 {
-  if ( auto result = callMethod< QString >( "GetDefaultProfilesJSON" ) )
-  {
-    return result->toStdString();
-  }
-  return std::nullopt;
+  return versionedJSON( "GetDefaultProfilesJSON" );
 }
 
 std::optional< std::string > UccdClient::getCpuFrequencyLimitsJSON()
@@ -268,29 +403,17 @@ std::optional< std::string > UccdClient::getDefaultValuesProfileJSON()
 
 std::optional< std::string > UccdClient::getCustomProfilesJSON()
 {
-  if ( auto result = callMethod< QString >( "GetCustomProfilesJSON" ) )
-  {
-    return result->toStdString();
-  }
-  return std::nullopt;
+  return versionedJSON( "GetCustomProfilesJSON" );
 }
 
 std::optional< std::string > UccdClient::getActiveProfileJSON()
 {
-  if ( auto result = callMethod< QString >( "GetActiveProfileJSON" ) )
-  {
-    return result->toStdString();
-  }
-  return std::nullopt;
+  return versionedJSON( "GetActiveProfileJSON" );
 }
 
 std::optional< std::string > UccdClient::getSettingsJSON()
 {
-  if ( auto result = callMethod< QString >( "GetSettingsJSON" ) )
-  {
-    return result->toStdString();
-  }
-  return std::nullopt;
+  return versionedJSON( "GetSettingsJSON" );
 }
 
 std::optional< std::string > UccdClient::getPowerState()
@@ -318,6 +441,23 @@ bool UccdClient::setBatchStateMap( const std::map< std::string, std::string > &e
   return callVoidMethod( "SetBatchStateMap", json );
 }
 
+bool UccdClient::setWorkloadRules( const std::string &rulesJSON )
+{
+  return callVoidMethod( "SetWorkloadRules", QString::fromStdString( rulesJSON ) );
+}
+
+bool UccdClient::setAlertRules( const std::string &rulesJSON )
+{
+  return callVoidMethod( "SetAlertRules", QString::fromStdString( rulesJSON ) );
+}
+
+std::optional< std::string > UccdClient::getActiveAlerts()
+{
+  if ( auto json = callMethod< QString >( "GetActiveAlerts" ) )
+    return json->toStdString();
+  return std::nullopt;
+}
+
 bool UccdClient::setActiveProfile( const std::string &profileId )
 {
   const QString id = QString::fromStdString( profileId );
@@ -334,6 +474,135 @@ bool UccdClient::saveCustomProfile( [[maybe_unused]] [[maybe_unused]] const std:
   return callVoidMethod( "SaveCustomProfile", QString::fromStdString( profileJSON ) );
 }
 
+bool UccdClient::patchProfile( const std::string &profileId, const std::string &patchJSON )
+{
+  return callVoidMethod( "PatchProfile", QString::fromStdString( profileId ),
+                         QString::fromStdString( patchJSON ) );
+}
+
+std::optional< bool > UccdClient::applyTransaction( const QJsonArray &operations )
+{
+  return callMethod< bool >( "ApplyTransaction",
+                             QString::fromUtf8( QJsonDocument( operations ).toJson( QJsonDocument::Compact ) ) );
+}
+
+std::optional< QVariant > UccdClient::callProfileDataMethod( const QString &method, const QVariantList &args )
+{
+  if ( !isConnected() || !m_typedProfileApi )
+  {
+    return std::nullopt;
+  }
+
+  const QDBusMessage reply = m_interface->callWithArgumentList( QDBus::Block, method, args );
+  if ( reply.type() == QDBusMessage::ErrorMessage )
+  {
+    // An older daemon: use the JSON methods for the rest of this connection
+    if ( reply.errorName() == QLatin1String( "org.freedesktop.DBus.Error.UnknownMethod" ) )
+      m_typedProfileApi = false;
+    else
+      qWarning() << "DBus call failed:" << method << "-" << reply.errorMessage();
+    return std::nullopt;
+  }
+  if ( reply.arguments().isEmpty() )
+  {
+    return std::nullopt;
+  }
+  return plainDBusValue( reply.arguments().constFirst() );
+}
+
+std::optional< std::string > UccdClient::versionedJSON( const QString &method )
+{
+  if ( !isConnected() )
+    return std::nullopt;
+
+  if ( m_versionedJsonApi )
+  {
+    VersionedJSON &cached = m_versionedJson[ method ];
+    const QDBusMessage reply = m_interface->call( method + QStringLiteral( "IfChanged" ),
+                                                  QVariant::fromValue( qulonglong( cached.version ) ) );
+    if ( reply.type() != QDBusMessage::ErrorMessage && !reply.arguments().isEmpty() )
+    {
+      const QVariantMap map = plainDBusValue( reply.arguments().constFirst() ).toMap();
+      if ( auto json = map.constFind( QStringLiteral( "json" ) ); json != map.constEnd() )
+        cached.json = json->toString().toStdString();
+      cached.version = map.value( QStringLiteral( "version" ) ).toULongLong();
+      return cached.json;
+    }
+
+    m_versionedJson.erase( method );
+    // An older daemon: use the plain getters for the rest of this connection
+    if ( reply.errorName() == QLatin1String( "org.freedesktop.DBus.Error.UnknownMethod" ) )
+      m_versionedJsonApi = false;
+    else
+    {
+      qWarning() << "DBus call failed:" << method << "-" << reply.errorMessage();
+      return std::nullopt;
+    }
+  }
+
+  if ( auto result = callMethod< QString >( method ) )
+    return result->toStdString();
+  return std::nullopt;
+}
+
+static std::optional< QJsonDocument > parseJsonReply( const std::optional< std::string > &json )
+{
+  if ( !json )
+    return std::nullopt;
+  return QJsonDocument::fromJson( QByteArray::fromStdString( *json ) );
+}
+
+std::optional< QJsonArray > UccdClient::getDefaultProfiles()
+{
+  if ( auto wire = callProfileDataMethod( "GetDefaultProfiles" ) )
+    return wireToJson( *wire ).toArray();
+  if ( m_typedProfileApi )
+    return std::nullopt;
+  if ( auto doc = parseJsonReply( getDefaultProfilesJSON() ); doc && doc->isArray() )
+    return doc->array();
+  return std::nullopt;
+}
+
+std::optional< QJsonArray > UccdClient::getCustomProfiles()
+{
+  if ( auto wire = callProfileDataMethod( "GetCustomProfiles" ) )
+    return wireToJson( *wire ).toArray();
+  if ( m_typedProfileApi )
+    return std::nullopt;
+  if ( auto doc = parseJsonReply( getCustomProfilesJSON() ); doc && doc->isArray() )
+    return doc->array();
+  return std::nullopt;
+}
+
+std::optional< QJsonObject > UccdClient::getActiveProfile()
+{
+  if ( auto wire = callProfileDataMethod( "GetActiveProfile" ) )
+    return wireToJson( *wire ).toObject();
+  if ( m_typedProfileApi )
+    return std::nullopt;
+  if ( auto doc = parseJsonReply( getActiveProfileJSON() ); doc && doc->isObject() )
+    return doc->object();
+  return std::nullopt;
+}
+
+bool UccdClient::applyProfile( const QJsonObject &profile )
+{
+  if ( auto ok = callProfileDataMethod( "ApplyProfileData", { jsonToWire( profile ) } ) )
+    return ok->toBool();
+  if ( m_typedProfileApi )
+    return false;
+  return applyProfile( QJsonDocument( profile ).toJson( QJsonDocument::Compact ).toStdString() );
+}
+
+bool UccdClient::saveCustomProfile( const QJsonObject &profile )
+{
+  if ( auto ok = callProfileDataMethod( "SaveCustomProfileData", { jsonToWire( profile ) } ) )
+    return ok->toBool();
+  if ( m_typedProfileApi )
+    return false;
+  return saveCustomProfile( QJsonDocument( profile ).toJson( QJsonDocument::Compact ).toStdString() );
+}
+
 bool UccdClient::deleteCustomProfile( [[maybe_unused]] const std::string &profileId )
 {
   return callVoidMethod( "DeleteCustomProfile", QString::fromStdString( profileId ) );
@@ -556,6 +825,25 @@ bool UccdClient::revertFanProfiles()
   return callMethod< bool >( "RevertFanProfiles" ).value_or( false );
 }
 
+bool UccdClient::startFanCalibration()
+{
+  return callMethod< bool >( "StartFanCalibration" ).value_or( false );
+}
+
+void UccdClient::cancelFanCalibration()
+{
+  callVoidMethod( "CancelFanCalibration" );
+}
+
+std::optional< std::string > UccdClient::getFanCalibrationJSON()
+{
+  if ( auto result = callMethod< QString >( "GetFanCalibrationJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+
 std::optional< std::string > UccdClient::getCurrentFanSpeed()
 {
   return std::nullopt;
@@ -571,6 +859,15 @@ bool UccdClient::setODMPowerLimits( [[maybe_unused]] const std::vector< int > &l
   return false;
 }
 
+std::optional< std::string > UccdClient::getODMPowerLimitsJSON()
+{
+  if ( auto result = callMethod< QString >( "ODMPowerLimitsJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+
 std::optional< std::vector< int > > UccdClient::getODMPowerLimits()
 {
   auto jsonStr = callMethod< QString >( "ODMPowerLimitsJSON" );
@@ -816,11 +1113,35 @@ bool UccdClient::resetNvidiaGpuOCAll( int deviceIndex )
   return callMethod< bool, int >( "ResetNvidiaGpuOCAll", deviceIndex ).value_or( false );
 }
 
+bool UccdClient::startNvidiaOCTuning( const std::string &optionsJSON, int deviceIndex )
+{
+  return callMethod< bool, int, QString >( "StartNvidiaOCTuning",
+      deviceIndex, QString::fromStdString( optionsJSON ) ).value_or( false );
+}
+
+std::optional< std::string > UccdClient::getNvidiaOCTuningStatus()
+{
+  if ( auto result = callMethod< QString >( "GetNvidiaOCTuningStatus" ) )
+    return result->toStdString();
+  return std::nullopt;
+}
+
+bool UccdClient::cancelNvidiaOCTuning()
+{
+  return callMethod< bool >( "CancelNvidiaOCTuning" ).value_or( false );
+}
+
 bool UccdClient::setKeyboardBacklight( const std::string &config )
 {
   return callMethod< bool, QString >( "SetKeyboardBacklightStatesJSON", QString::fromStdString( config ) ).value_or( false );
 }
 
+bool UccdClient::setKeyboardBacklightFrame( const std::vector< uint8_t > &rgb )
+{
+  const QByteArray frame( reinterpret_cast< const char * >( rgb.data() ), static_cast< qsizetype >( rgb.size() ) );
+  return callMethod< bool, QByteArray >( "SetKeyboardBacklightFrame", frame ).value_or( false );
+}
+
 std::optional< std::string > UccdClient::getKeyboardBacklightInfo()
 {
   if ( auto caps = callMethod< QString >( "GetKeyboardBacklightCapabilitiesJSON" ); caps )
@@ -832,11 +1153,7 @@ std::optional< std::string > UccdClient::getKeyboardBacklightInfo()
 
 std::optional< std::string > UccdClient::getKeyboardBacklightStates()
 {
-  if ( auto states = callMethod< QString >( "GetKeyboardBacklightStatesJSON" ); states )
-  {
-    return states->toStdString();
-  }
-  return std::nullopt;
+  return versionedJSON( "GetKeyboardBacklightStatesJSON" );
 }
 
 bool UccdClient::setODMPerformanceProfile( [[maybe_unused]] const std::string &profile )
@@ -854,36 +1171,96 @@ std::optional< std::vector< std::string > > UccdClient::getAvailableODMProfiles(
   return std::nullopt;
 }
 
-namespace
-{
-std::optional< int > readFanDataValue( QDBusInterface *iface, const QString &method, const QString &key )
+// ---------------------------------------------------------------------------
+// Reply cache
+// ---------------------------------------------------------------------------
+
+const UccdClient::CachedReply *UccdClient::cachedReply( const QString &method )
 {
-  if ( !iface )
-  {
-    return std::nullopt;
-  }
+  const qint64 now = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::steady_clock::now().time_since_epoch() ).count();
+
+  if ( auto it = m_replyCache.find( method );
+       it != m_replyCache.end() && now - it->second.fetchedMs < REPLY_CACHE_TTL_MS )
+    return it->second.valid ? &it->second : nullptr;
+
+  // Failures are cached as well, so a broken method is asked once per TTL
+  // rather than once per getter
+  CachedReply &entry = m_replyCache[ method ];
+  entry = CachedReply{};
+  entry.fetchedMs = now;
 
-  QDBusMessage reply = iface->call( method );
+  if ( !isConnected() )
+    return nullptr;
+
+  QDBusMessage reply = m_interface->call( method );
   if ( reply.type() == QDBusMessage::ErrorMessage || reply.arguments().isEmpty() )
+    return nullptr;
+
+  const QVariant argument = reply.arguments().at( 0 );
+  if ( argument.canConvert< QDBusArgument >() )
   {
-    return std::nullopt;
+    entry.fanData = decodeFanData( argument );
+  }
+  else
+  {
+    const QJsonDocument doc = QJsonDocument::fromJson( argument.toString().toUtf8() );
+    if ( doc.isNull() || !doc.isObject() )
+      return nullptr;
+    entry.json = doc.object();
   }
+  entry.valid = true;
+  return &entry;
+}
 
+std::optional< QJsonObject > UccdClient::cachedJson( const QString &method )
+{
+  if ( const CachedReply *entry = cachedReply( method ) )
+    return entry->json;
+  return std::nullopt;
+}
+
+std::optional< QVariantMap > UccdClient::cachedFanData( const QString &method )
+{
+  if ( const CachedReply *entry = cachedReply( method ) )
+    return entry->fanData;
+  return std::nullopt;
+}
+
+void UccdClient::invalidateReplyCache()
+{
+  m_replyCache.clear();
+}
+
+namespace
+{
+/// GetFanData* reply: key → { data, timestamp }, nested variants decoded
+QVariantMap decodeFanData( const QVariant &reply )
+{
   // The adaptor returns QVariantMap (D-Bus a{sv}).
   // Each value in the outer map is a variant wrapping another a{sv}.
   // Demarshall the outer map first.
-  QVariantMap outerMap = qdbus_cast< QVariantMap >( reply.arguments().at( 0 ).value< QDBusArgument >() );
-  if ( !outerMap.contains( key ) )
-    return std::nullopt;
+  const QVariantMap outerMap = qdbus_cast< QVariantMap >( reply.value< QDBusArgument >() );
 
-  // The inner value is a variant containing a QDBusArgument for the nested a{sv}.
-  QVariant innerVariant = outerMap.value( key );
-  QVariantMap innerMap;
-  if ( innerVariant.canConvert< QDBusArgument >() )
-    innerMap = qdbus_cast< QVariantMap >( innerVariant.value< QDBusArgument >() );
-  else
-    innerMap = innerVariant.toMap();
+  // The inner value is a variant containing a QDBusArgument for the nested
+  // a{sv}.  QDBusArgument can only be read once, so decode every entry now.
+  QVariantMap decoded;
+  for ( auto it = outerMap.constBegin(); it != outerMap.constEnd(); ++it )
+  {
+    if ( it->canConvert< QDBusArgument >() )
+      decoded.insert( it.key(), qdbus_cast< QVariantMap >( it->value< QDBusArgument >() ) );
+    else
+      decoded.insert( it.key(), it->toMap() );
+  }
+  return decoded;
+}
 
+std::optional< int > readFanDataValue( const std::optional< QVariantMap > &fanData, const QString &key )
+{
+  if ( !fanData || !fanData->contains( key ) )
+    return std::nullopt;
+
+  const QVariantMap innerMap = fanData->value( key ).toMap();
   if ( !innerMap.contains( "data" ) )
     return std::nullopt;
 
@@ -907,113 +1284,56 @@ std::optional< int > readFanDataValue( QDBusInterface *iface, const QString &met
   return std::nullopt;
 }
 
-std::optional< int > readJsonInt( QDBusInterface *iface, const QString &method, const QString &key )
+std::optional< int > readJsonInt( const std::optional< QJsonObject > &obj, const QString &key )
 {
-  if ( !iface )
-  {
-    return std::nullopt;
-  }
-
-  QDBusMessage reply = iface->call( method );
-  if ( reply.type() == QDBusMessage::ErrorMessage || reply.arguments().isEmpty() )
+  if ( !obj || !obj->contains( key ) )
   {
     return std::nullopt;
   }
 
-  const QString json = reply.arguments().at( 0 ).toString();
-  QJsonDocument doc = QJsonDocument::fromJson( json.toUtf8() );
-  if ( doc.isNull() || !doc.isObject() )
-  {
-    return std::nullopt;
-  }
-
-  QJsonObject obj = doc.object();
-  if ( !obj.contains( key ) )
-  {
-    return std::nullopt;
-  }
-
-  int val = obj[ key ].toInt();
+  int val = ( *obj )[ key ].toInt();
   return ( val >= 0 ) ? std::optional< int >( val ) : std::nullopt;
 }
 
-std::optional< double > readJsonDouble( QDBusInterface *iface, const QString &method, const QString &key )
+std::optional< double > readJsonDouble( const std::optional< QJsonObject > &obj, const QString &key )
 {
-  if ( !iface )
-  {
-    return std::nullopt;
-  }
-
-  QDBusMessage reply = iface->call( method );
-  if ( reply.type() == QDBusMessage::ErrorMessage || reply.arguments().isEmpty() )
+  if ( !obj || !obj->contains( key ) )
   {
     return std::nullopt;
   }
 
-  const QString json = reply.arguments().at( 0 ).toString();
-  QJsonDocument doc = QJsonDocument::fromJson( json.toUtf8() );
-  if ( doc.isNull() || !doc.isObject() )
-  {
-    return std::nullopt;
-  }
-
-  QJsonObject obj = doc.object();
-  if ( !obj.contains( key ) )
-  {
-    return std::nullopt;
-  }
-
-  double val = obj[ key ].toDouble();
+  double val = ( *obj )[ key ].toDouble();
   return ( val >= 0.0 ) ? std::optional< double >( val ) : std::nullopt;
 }
 
-std::optional< std::string > readJsonString( QDBusInterface *iface, const QString &method, const QString &key )
+std::optional< std::string > readJsonString( const std::optional< QJsonObject > &obj, const QString &key )
 {
-  if ( !iface )
-  {
-    return std::nullopt;
-  }
-
-  QDBusMessage reply = iface->call( method );
-  if ( reply.type() == QDBusMessage::ErrorMessage || reply.arguments().isEmpty() )
+  if ( !obj || !obj->contains( key ) || !( *obj )[ key ].isString() )
   {
     return std::nullopt;
   }
 
-  const QString json = reply.arguments().at( 0 ).toString();
-  QJsonDocument doc = QJsonDocument::fromJson( json.toUtf8() );
-  if ( doc.isNull() || !doc.isObject() )
-  {
-    return std::nullopt;
-  }
-
-  QJsonObject obj = doc.object();
-  if ( !obj.contains( key ) || !obj[ key ].isString() )
-  {
-    return std::nullopt;
-  }
-
-  return obj[ key ].toString().toStdString();
+  return ( *obj )[ key ].toString().toStdString();
 }
 } // namespace
 
 // System Monitoring implementations
 std::optional< int > UccdClient::getCpuTemperature()
 {
-  return readFanDataValue( m_interface.get(), "GetFanDataCPU", "temp" );
+  return readFanDataValue( cachedFanData( "GetFanDataCPU" ), "temp" );
 }
 
 std::optional< int > UccdClient::getGpuTemperature()
 {
-  if ( auto temp = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "temp" ) )
+  if ( auto temp = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "temp" ) )
     return temp;
 
-  return readJsonInt( m_interface.get(), "GetIGpuInfoValuesJSON", "temp" );
+  return readJsonInt( cachedJson( "GetIGpuInfoValuesJSON" ), "temp" );
 }
 
 std::optional< int > UccdClient::getIGpuTemperature()
 {
-  return readJsonInt( m_interface.get(), "GetIGpuInfoValuesJSON", "temp" );
+  return readJsonInt( cachedJson( "GetIGpuInfoValuesJSON" ), "temp" );
 }
 
 std::optional< int > UccdClient::getCpuFrequency()
@@ -1022,116 +1342,168 @@ std::optional< int > UccdClient::getCpuFrequency()
   return callMethod< int >( "GetCpuFrequencyMHz" );
 }
 
+std::optional< std::string > UccdClient::getCpuCoresJSON()
+{
+  if ( auto result = callMethod< QString >( "GetCpuCoresJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+
+std::optional< std::string > UccdClient::getWorkerStatsJSON()
+{
+  if ( auto result = callMethod< QString >( "GetWorkerStatsJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+
+std::optional< std::string > UccdClient::getFanTraceJSON()
+{
+  if ( auto result = callMethod< QString >( "GetFanTraceJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+std::optional< std::string > UccdClient::getIpcStatsJSON()
+{
+  if ( auto result = callMethod< QString >( "GetIpcStatsJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+std::optional< std::string > UccdClient::getStartupTimelineJSON()
+{
+  if ( auto result = callMethod< QString >( "GetStartupTimelineJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+
 std::optional< int > UccdClient::getGpuFrequency()
 {
-  if ( auto freq = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "coreFrequency" ) )
+  if ( auto freq = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "coreFrequency" ) )
   {
     return freq;
   }
-  return readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "coreFreq" );
+  return readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "coreFreq" );
 }
 
 std::optional< int > UccdClient::getIGpuFrequency()
 {
-  return readJsonInt( m_interface.get(), "GetIGpuInfoValuesJSON", "coreFrequency" );
+  return readJsonInt( cachedJson( "GetIGpuInfoValuesJSON" ), "coreFrequency" );
 }
 
 std::optional< double > UccdClient::getCpuPower()
 {
-  return readJsonDouble( m_interface.get(), "GetCpuPowerValuesJSON", "powerDraw" );
+  return readJsonDouble( cachedJson( "GetCpuPowerValuesJSON" ), "powerDraw" );
 }
 
 std::optional< double > UccdClient::getGpuPower()
 {
-  if ( auto power = readJsonDouble( m_interface.get(), "GetDGpuInfoValuesJSON", "powerDraw" ) )
+  if ( auto power = readJsonDouble( cachedJson( "GetDGpuInfoValuesJSON" ), "powerDraw" ) )
   {
     return power;
   }
-  return readJsonDouble( m_interface.get(), "GetIGpuInfoValuesJSON", "powerDraw" );
+  return readJsonDouble( cachedJson( "GetIGpuInfoValuesJSON" ), "powerDraw" );
 }
 
 std::optional< double > UccdClient::getIGpuPower()
 {
-  return readJsonDouble( m_interface.get(), "GetIGpuInfoValuesJSON", "powerDraw" );
+  return readJsonDouble( cachedJson( "GetIGpuInfoValuesJSON" ), "powerDraw" );
 }
 
 // ---- Extended discrete GPU metrics ----
 
 std::optional< int > UccdClient::getDGpuComputeUtilPct()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "computeUtilPct" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "computeUtilPct" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuMemoryUtilPct()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "memoryUtilPct" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "memoryUtilPct" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuVramUsedMiB()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "vramUsedMiB" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "vramUsedMiB" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuVramTotalMiB()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "vramTotalMiB" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "vramTotalMiB" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< std::string > UccdClient::getDGpuPerfLimitReason()
 {
-  auto v = readJsonString( m_interface.get(), "GetDGpuInfoValuesJSON", "perfLimitReason" );
+  auto v = readJsonString( cachedJson( "GetDGpuInfoValuesJSON" ), "perfLimitReason" );
   return ( v && !v->empty() ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuEncoderUtilPct()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "encoderUtilPct" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "encoderUtilPct" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuDecoderUtilPct()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "decoderUtilPct" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "decoderUtilPct" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuCurrentPstate()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "currentPstate" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "currentPstate" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuGrClockOffsetMHz()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "grClockOffsetMHz" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "grClockOffsetMHz" );
   return ( v && *v != -999 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuMemClockOffsetMHz()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "memClockOffsetMHz" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "memClockOffsetMHz" );
   return ( v && *v != -999 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuVramFrequencyMHz()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "vramFrequency" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "vramFrequency" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
 std::optional< int > UccdClient::getDGpuCoreVoltageMv()
 {
-  auto v = readJsonInt( m_interface.get(), "GetDGpuInfoValuesJSON", "coreVoltageMv" );
+  auto v = readJsonInt( cachedJson( "GetDGpuInfoValuesJSON" ), "coreVoltageMv" );
   return ( v && *v >= 0 ) ? v : std::nullopt;
 }
 
+std::optional< std::string > UccdClient::getDGpuInfoListJSON()
+{
+  if ( auto result = callMethod< QString >( "GetDGpuInfoListJSON" ) )
+  {
+    return result->toStdString();
+  }
+  return std::nullopt;
+}
+
 std::optional< int > UccdClient::getFanSpeedRPM()
 {
-  if ( auto percentage = readFanDataValue( m_interface.get(), "GetFanDataCPU", "speed" ) )
+  if ( auto percentage = readFanDataValue( cachedFanData( "GetFanDataCPU" ), "speed" ) )
   {
     return ( *percentage ) * 60;
   }
@@ -1140,8 +1512,8 @@ std::optional< int > UccdClient::getFanSpeedRPM()
 
 std::optional< int > UccdClient::getGpuFanSpeedRPM()
 {
-  auto gpu1 = readFanDataValue( m_interface.get(), "GetFanDataGPU1", "speed" );
-  auto gpu2 = readFanDataValue( m_interface.get(), "GetFanDataGPU2", "speed" );
+  auto gpu1 = readFanDataValue( cachedFanData( "GetFanDataGPU1" ), "speed" );
+  auto gpu2 = readFanDataValue( cachedFanData( "GetFanDataGPU2" ), "speed" );
 
   if ( gpu1 && gpu2 )
   {
@@ -1161,13 +1533,13 @@ std::optional< int > UccdClient::getGpuFanSpeedRPM()
 // Return raw fan speed percentage (0-100) as reported by uccd
 std::optional< int > UccdClient::getFanSpeedPercent()
 {
-  return readFanDataValue( m_interface.get(), "GetFanDataCPU", "speed" );
+  return readFanDataValue( cachedFanData( "GetFanDataCPU" ), "speed" );
 }
 
 std::optional< int > UccdClient::getGpuFanSpeedPercent()
 {
-  auto gpu1 = readFanDataValue( m_interface.get(), "GetFanDataGPU1", "speed" );
-  auto gpu2 = readFanDataValue( m_interface.get(), "GetFanDataGPU2", "speed" );
+  auto gpu1 = readFanDataValue( cachedFanData( "GetFanDataGPU1" ), "speed" );
+  auto gpu2 = readFanDataValue( cachedFanData( "GetFanDataGPU2" ), "speed" );
 
   if ( gpu1 && gpu2 )
   {
@@ -1216,6 +1588,96 @@ std::optional< int > UccdClient::getWaterCoolerPumpLevel()
   return callMethod< int >( "GetWaterCoolerPumpLevel" );
 }
 
+namespace
+{
+LiveSnapshot liveSnapshotFromMap( const QVariantMap &map )
+{
+  const auto readInt = [&map]( const char *key ) -> std::optional< int > {
+    const auto it = map.constFind( QLatin1String( key ) );
+    if ( it == map.constEnd() )
+      return std::nullopt;
+    return it->toInt();
+  };
+  const auto readDouble = [&map]( const char *key ) -> std::optional< double > {
+    const auto it = map.constFind( QLatin1String( key ) );
+    if ( it == map.constEnd() )
+      return std::nullopt;
+    return it->toDouble();
+  };
+
+  LiveSnapshot s;
+  s.timestampMs = map.value( QStringLiteral( "timestampMs" ) ).toLongLong();
+  s.cpuTemp = readInt( "cpuTemp" );
+  s.gpuTemp = readInt( "gpuTemp" );
+  s.iGpuTemp = readInt( "iGpuTemp" );
+  s.cpuFrequencyMHz = readInt( "cpuFrequencyMHz" );
+  s.gpuFrequencyMHz = readInt( "gpuFrequencyMHz" );
+  s.iGpuFrequencyMHz = readInt( "iGpuFrequencyMHz" );
+  s.cpuPowerW = readDouble( "cpuPowerW" );
+  s.gpuPowerW = readDouble( "gpuPowerW" );
+  s.iGpuPowerW = readDouble( "iGpuPowerW" );
+  s.cpuFanPercent = readInt( "cpuFanPercent" );
+  s.gpuFanPercent = readInt( "gpuFanPercent" );
+  // same scaling as getFanSpeedRPM() / getGpuFanSpeedRPM()
+  if ( s.cpuFanPercent )
+    s.cpuFanRPM = *s.cpuFanPercent * 60;
+  if ( s.gpuFanPercent )
+    s.gpuFanRPM = *s.gpuFanPercent * 60;
+  s.dGpuComputeUtilPct = readInt( "dGpuComputeUtilPct" );
+  s.dGpuMemoryUtilPct = readInt( "dGpuMemoryUtilPct" );
+  s.dGpuVramUsedMiB = readInt( "dGpuVramUsedMiB" );
+  s.dGpuVramTotalMiB = readInt( "dGpuVramTotalMiB" );
+  if ( const auto it = map.constFind( QStringLiteral( "dGpuPerfLimitReason" ) ); it != map.constEnd() )
+    s.dGpuPerfLimitReason = it->toString().toStdString();
+  s.dGpuEncoderUtilPct = readInt( "dGpuEncoderUtilPct" );
+  s.dGpuDecoderUtilPct = readInt( "dGpuDecoderUtilPct" );
+  s.dGpuCurrentPstate = readInt( "dGpuCurrentPstate" );
+  s.dGpuGrClockOffsetMHz = readInt( "dGpuGrClockOffsetMHz" );
+  s.dGpuMemClockOffsetMHz = readInt( "dGpuMemClockOffsetMHz" );
+  s.dGpuVramFrequencyMHz = readInt( "dGpuVramFrequencyMHz" );
+  s.dGpuCoreVoltageMv = readInt( "dGpuCoreVoltageMv" );
+  s.waterCoolerFanSpeed = readInt( "waterCoolerFanSpeed" );
+  s.waterCoolerPumpLevel = readInt( "waterCoolerPumpLevel" );
+  return s;
+}
+}
+
+std::optional< LiveSnapshot > UccdClient::getLiveSnapshot()
+{
+  if ( auto map = callMethod< QVariantMap >( "GetLiveSnapshot" ) )
+    return liveSnapshotFromMap( *map );
+  return std::nullopt;
+}
+
+void UccdClient::getLiveSnapshotAsync( QObject *context, Reply< LiveSnapshot > done )
+{
+  callMethodAsync< QVariantMap >( context, "GetLiveSnapshot", [done = std::move( done )]( std::optional< QVariantMap > map ) {
+    done( map ? std::optional< LiveSnapshot >( liveSnapshotFromMap( *map ) ) : std::nullopt );
+  } );
+}
+
+void UccdClient::getSystemInfoJSONAsync( QObject *context, Reply< std::string > done )
+{
+  callMethodAsync< QString >( context, "GetSystemInfoJSON", [done = std::move( done )]( std::optional< QString > json ) {
+    done( json ? std::optional< std::string >( json->toStdString() ) : std::nullopt );
+  } );
+}
+
+void UccdClient::getDisplayBrightnessAsync( QObject *context, Reply< int > done )
+{
+  callMethodAsync< int >( context, "GetDisplayBrightness", std::move( done ) );
+}
+
+void UccdClient::getWebcamEnabledAsync( QObject *context, Reply< bool > done )
+{
+  callMethodAsync< bool >( context, "GetWebcamSWStatus", std::move( done ) );
+}
+
+void UccdClient::getFnLockAsync( QObject *context, Reply< bool > done )
+{
+  callMethodAsync< bool >( context, "GetFnLockStatus", std::move( done ) );
+}
+
 // --- Monitoring history ---
 
 std::optional< QByteArray > UccdClient::getMonitorDataSince( qint64 sinceTimestampMs )
@@ -1223,6 +1685,97 @@ std::optional< QByteArray > UccdClient::getMonitorDataSince( qint64 sinceTimesta
   return callMethod< QByteArray >( "GetMonitorDataSince", static_cast< qlonglong >( sinceTimestampMs ) );
 }
 
+std::optional< QByteArray > UccdClient::getMonitorDataSinceCompressed( qint64 sinceTimestampMs )
+{
+  return callMethod< QByteArray >( "GetMonitorDataSinceCompressed", static_cast< qlonglong >( sinceTimestampMs ) );
+}
+
+std::optional< QByteArray > UccdClient::getMonitorDataSinceDecimated( qint64 sinceTimestampMs, quint32 metricMask,
+                                                                      int maxPointsPerSeries, int mode )
+{
+  return callMethod< QByteArray >( "GetMonitorDataSinceDecimated", static_cast< qlonglong >( sinceTimestampMs ),
+                                   static_cast< uint >( metricMask ), maxPointsPerSeries, mode );
+}
+
+std::optional< QByteArray > UccdClient::getMonitorFramesSince( qint64 sinceTimestampMs, quint64 metricMask )
+{
+  return callMethod< QByteArray >( "GetMonitorFramesSince", static_cast< qlonglong >( sinceTimestampMs ),
+                                   static_cast< qulonglong >( metricMask ) );
+}
+
+std::optional< QByteArray > UccdClient::getMonitorFramesPage( qint64 sinceTimestampMs, quint64 metricMask, int maxRows )
+{
+  return callMethod< QByteArray >( "GetMonitorFramesPage", static_cast< qlonglong >( sinceTimestampMs ),
+                                   static_cast< qulonglong >( metricMask ), maxRows );
+}
+
+std::optional< QByteArray > UccdClient::getMonitorEventsSince( qint64 sinceTimestampMs )
+{
+  return callMethod< QByteArray >( "GetMonitorEventsSince", static_cast< qlonglong >( sinceTimestampMs ) );
+}
+
+std::optional< std::string > UccdClient::getMetricCatalog()
+{
+  if ( auto json = callMethod< QString >( "GetMetricCatalog" ) )
+    return json->toStdString();
+  return std::nullopt;
+}
+
+void UccdClient::getMonitorDataSinceAsync( QObject *context, qint64 sinceTimestampMs, Reply< QByteArray > done )
+{
+  callMethodAsync< QByteArray >( context, "GetMonitorDataSince", std::move( done ),
+                                 static_cast< qlonglong >( sinceTimestampMs ) );
+}
+
+void UccdClient::getMonitorDataSinceCompressedAsync( QObject *context, qint64 sinceTimestampMs, Reply< QByteArray > done )
+{
+  callMethodAsync< QByteArray >( context, "GetMonitorDataSinceCompressed", std::move( done ),
+                                 static_cast< qlonglong >( sinceTimestampMs ) );
+}
+
+void UccdClient::getMonitorDataSinceDecimatedAsync( QObject *context, qint64 sinceTimestampMs, quint32 metricMask,
+                                                    int maxPointsPerSeries, Reply< QByteArray > done, int mode )
+{
+  callMethodAsync< QByteArray >( context, "GetMonitorDataSinceDecimated", std::move( done ),
+                                 static_cast< qlonglong >( sinceTimestampMs ), static_cast< uint >( metricMask ),
+                                 maxPointsPerSeries, mode );
+}
+
+void UccdClient::getMonitorFramesPageAsync( QObject *context, qint64 sinceTimestampMs, quint64 metricMask, int maxRows,
+                                            Reply< QByteArray > done )
+{
+  callMethodAsync< QByteArray >( context, "GetMonitorFramesPage", std::move( done ),
+                                 static_cast< qlonglong >( sinceTimestampMs ), static_cast< qulonglong >( metricMask ),
+                                 maxRows );
+}
+
+void UccdClient::getMonitorEventsSinceAsync( QObject *context, qint64 sinceTimestampMs, Reply< QByteArray > done )
+{
+  callMethodAsync< QByteArray >( context, "GetMonitorEventsSince", std::move( done ),
+                                 static_cast< qlonglong >( sinceTimestampMs ) );
+}
+
+void UccdClient::getMetricCatalogAsync( QObject *context, Reply< std::string > done )
+{
+  callMethodAsync< QString >( context, "GetMetricCatalog", [done = std::move( done )]( std::optional< QString > json ) {
+    done( json ? std::optional< std::string >( json->toStdString() ) : std::nullopt );
+  } );
+}
+
+std::optional< QByteArray > UccdClient::getMonitorRollupSince( qint64 sinceTimestampMs, int maxPointsPerSeries )
+{
+  return callMethod< QByteArray >( "GetMonitorRollupSince", static_cast< qlonglong >( sinceTimestampMs ),
+                                   maxPointsPerSeries );
+}
+
+std::optional< std::string > UccdClient::getMonitorStats( qint64 sinceTimestampMs, const QVariantMap &thresholds )
+{
+  if ( auto json = callMethod< QString >( "GetMonitorStatsJSON", static_cast< qlonglong >( sinceTimestampMs ),
+                                          thresholds ); json )
+    return json->toStdString();
+  return std::nullopt;
+}
+
 bool UccdClient::setMonitorHistoryHorizon( int seconds )
 {
   return callVoidMethod( "SetMonitorHistoryHorizon", seconds );
@@ -1233,6 +1786,112 @@ std::optional< int > UccdClient::getMonitorHistoryHorizon()
   return callMethod< int >( "GetMonitorHistoryHorizon" );
 }
 
+std::optional< QByteArray > UccdClient::getCpuCoreHistorySince( qint64 sinceTimestampMs )
+{
+  return callMethod< QByteArray >( "GetCpuCoreHistorySince", static_cast< qlonglong >( sinceTimestampMs ) );
+}
+
+bool UccdClient::ensureLiveMetrics()
+{
+  if ( m_liveMetrics.isAttached() )
+    return true;
+  if ( m_liveMetricsRequested || !isConnected() )
+    return false;
+
+  m_liveMetricsRequested = true;
+  const auto fd = callMethod< QDBusUnixFileDescriptor >( "GetLiveMetricsSegment" );
+  if ( !fd.has_value() || !fd->isValid() || !m_liveMetrics.attach( fd->fileDescriptor() ) )
+  {
+    qInfo() << "[UccdClient] live metrics segment unavailable, using D-Bus polling";
+    return false;
+  }
+  return true;
+}
+
+std::optional< QByteArray > UccdClient::readLiveMetricsSince( qint64 sinceTimestampMs )
+{
+  if ( !ensureLiveMetrics() )
+    return std::nullopt;
+
+  std::vector< uint8_t > raw;
+  if ( !m_liveMetrics.copySinceBinary( sinceTimestampMs, raw ) )
+    return std::nullopt;
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
+}
+
+std::optional< double > UccdClient::readLiveMetric( int metricId )
+{
+  if ( metricId < 0 || !ensureLiveMetrics() )
+    return std::nullopt;
+
+  const auto pt = m_liveMetrics.latest( static_cast< size_t >( metricId ) );
+  if ( !pt.has_value() )
+    return std::nullopt;
+  return pt->value;
+}
+
+bool UccdClient::setMetricsSamplesEnabled( bool enabled )
+{
+  if ( enabled == m_metricsSamplesEnabled )
+    return true;
+
+  m_metricsSamplesEnabled = enabled;
+  if ( !isConnected() )
+    return false;  // applied on the next connect
+  return callVoidMethod( enabled ? "SubscribeMetricsSamples" : "UnsubscribeMetricsSamples" );
+}
+
+bool UccdClient::setFastSamplingEnabled( bool enabled )
+{
+  if ( enabled == m_fastSamplingEnabled )
+    return true;
+
+  m_fastSamplingEnabled = enabled;
+  if ( !isConnected() )
+    return false;  // applied on the next connect
+  return callVoidMethod( enabled ? "SubscribeFastSampling" : "UnsubscribeFastSampling" );
+}
+
+bool UccdClient::setSensorSubscription( uint32_t groups )
+{
+  if ( groups == m_sensorGroups )
+    return true;
+
+  m_sensorGroups = groups;
+  if ( !isConnected() )
+    return false;  // applied on the next connect
+  if ( groups == 0 )
+    return callVoidMethod( "UnsubscribeSensors" );
+  return callVoidMethod( "SubscribeSensors", static_cast< uint >( groups ) );
+}
+
+bool UccdClient::setPeerChannelEnabled( bool enabled )
+{
+  m_peerChannelEnabled = enabled;
+  if ( !enabled )
+    m_peer.close();
+  else if ( !m_peer.isOpen() && isConnected() )
+    openPeerChannel();
+  return !enabled || m_peer.isOpen();
+}
+
+void UccdClient::openPeerChannel()
+{
+  m_peer.close();
+  const auto channel = callMethod< QVariantMap >( "RequestPeerChannel" );
+  if ( !channel || !m_peer.open( channel->value( QStringLiteral( "address" ) ).toString(),
+                                 channel->value( QStringLiteral( "token" ) ).toByteArray() ) )
+    qWarning() << "[UccdClient] peer channel unavailable, using the system bus";
+}
+
+std::optional< QVariant > UccdClient::callPeer( const QString &method, const QVariantList &args ) const
+{
+  if ( !m_peer.isOpen() || !peer::peerServes( method ) )
+    return std::nullopt;
+  return m_peer.call( method, args );
+}
+
 void UccdClient::subscribeProfileChanged( [[maybe_unused]] ProfileChangedCallback callback )
 {
   // Already handled via Qt signal connection
@@ -17,20 +17,65 @@
 
 #include <QObject>
 #include <QString>
-#include <QDBusInterface>
+#include <QVariantMap>
+#include <QStringList>
 #include <QDBusConnection>
 #include <QDBusReply>
 #include <QDBusServiceWatcher>
+#include <QJsonArray>
+#include <QJsonObject>
 #include <string>
 #include <memory>
 #include <optional>
 #include <functional>
 #include <vector>
 #include <map>
+#include "LiveMetricsSegment.hpp"
+#include "SensorGroups.hpp"
+#include "PeerChannelClient.hpp"
+#include "UccdProxy.hpp"
 
 namespace ucc
 {
 
+/**
+ * @brief Every live reading of the daemon from one GetLiveSnapshot call
+ *
+ * Each field matches the single-value getter of the same name; it is
+ * empty where that getter returns std::nullopt.
+ */
+struct LiveSnapshot
+{
+  int64_t timestampMs = 0;  ///< Daemon time of the snapshot, Unix epoch ms
+  std::optional< int > cpuTemp;
+  std::optional< int > gpuTemp;
+  std::optional< int > iGpuTemp;
+  std::optional< int > cpuFrequencyMHz;
+  std::optional< int > gpuFrequencyMHz;
+  std::optional< int > iGpuFrequencyMHz;
+  std::optional< double > cpuPowerW;
+  std::optional< double > gpuPowerW;
+  std::optional< double > iGpuPowerW;
+  std::optional< int > cpuFanPercent;
+  std::optional< int > gpuFanPercent;
+  std::optional< int > cpuFanRPM;
+  std::optional< int > gpuFanRPM;
+  std::optional< int > dGpuComputeUtilPct;
+  std::optional< int > dGpuMemoryUtilPct;
+  std::optional< int > dGpuVramUsedMiB;
+  std::optional< int > dGpuVramTotalMiB;
+  std::optional< std::string > dGpuPerfLimitReason;
+  std::optional< int > dGpuEncoderUtilPct;
+  std::optional< int > dGpuDecoderUtilPct;
+  std::optional< int > dGpuCurrentPstate;
+  std::optional< int > dGpuGrClockOffsetMHz;
+  std::optional< int > dGpuMemClockOffsetMHz;
+  std::optional< int > dGpuVramFrequencyMHz;
+  std::optional< int > dGpuCoreVoltageMv;
+  std::optional< int > waterCoolerFanSpeed;
+  std::optional< int > waterCoolerPumpLevel;
+};
+
 /**
  * @brief DBus client for communicating with uccd daemon
  *
@@ -62,9 +107,21 @@ public:
   std::optional< std::string > getPowerState();
   bool setStateMap( const std::string &state, const std::string &profileId );
   bool setBatchStateMap( const std::map< std::string, std::string > &entries );
+  /// JSON array of { "exe", "cgroup", "profile" } rules, replacing the current ones
+  bool setWorkloadRules( const std::string &rulesJSON );
+  /// JSON array of { "id", "metric", "condition", "threshold", "forSeconds", "hysteresis" }
+  /// rules, replacing the current ones; hits arrive as alertRaised() / alertCleared()
+  bool setAlertRules( const std::string &rulesJSON );
+  /// JSON array of the alerts currently raised: { "id", "metric", "value", "since" }
+  std::optional< std::string > getActiveAlerts();
   bool setActiveProfile( const std::string &profileId );
   bool applyProfile( const std::string &profileJSON );
   bool saveCustomProfile( const std::string &profileJSON );
+  /// JSON merge patch of a custom or the active profile, e.g. {"fan":{"sameSpeed":false}}
+  bool patchProfile( const std::string &profileId, const std::string &patchJSON );
+  /// ApplyTransaction: [{"op": "saveCustomProfile", "profile": {...}}, ...] in
+  /// one call.  nullopt when the call failed, e.g. on a daemon without it
+  std::optional< bool > applyTransaction( const QJsonArray &operations );
   bool deleteCustomProfile( const std::string &profileId );
   std::optional< std::string > getFanProfile( const std::string &fanProfileId );
   std::optional< std::string > getFanProfilesJSON();
@@ -72,6 +129,15 @@ public:
   std::optional< std::string > getGpuProfilesJSON();
   std::optional< bool > setFanProfile( const std::string &fanProfileId, const std::string &json );
 
+  // Profiles as JSON objects, carried in the daemon's typed D-Bus form
+  // (GetDefaultProfiles, ApplyProfileData, ...) instead of JSON text.  Each
+  // falls back to the *JSON method against a daemon without the typed form.
+  std::optional< QJsonArray > getDefaultProfiles();
+  std::optional< QJsonArray > getCustomProfiles();
+  std::optional< QJsonObject > getActiveProfile();
+  bool applyProfile( const QJsonObject &profile );
+  bool saveCustomProfile( const QJsonObject &profile );
+
   // Display Control
   bool setDisplayBrightness( int brightness );
   std::optional< int > getDisplayBrightness();
@@ -94,12 +160,17 @@ public:
   bool setFanProfileDGPU( const std::string &pointsJSON );
   bool applyFanProfiles( const std::string &fanProfilesJSON );
   bool revertFanProfiles();
+  bool startFanCalibration();   ///< Opt-in; needs fan control enabled, runs for 1-3 min
+  void cancelFanCalibration();
+  std::optional< std::string > getFanCalibrationJSON();  ///< Phase, last error and the fan response model
   std::optional< std::string > getCurrentFanSpeed();
   std::optional< std::string > getFanTemperatures();
 
   // Power Management
   bool setODMPowerLimits( const std::vector< int > &limits );
   std::optional< std::vector< int > > getODMPowerLimits();
+  /// [{current, min, max}] per TDP; "current" is re-read from the EC after each profile apply
+  std::optional< std::string > getODMPowerLimitsJSON();
 
   // Charging Profile (firmware-level charging modes)
   std::optional< std::string > getChargingProfilesAvailable();
@@ -146,6 +217,9 @@ public:
   bool resetNvidiaGpuPowerLimit( int deviceIndex );
   bool applyNvidiaGpuOCProfile( const std::string &profileJSON, int deviceIndex = 0 );
   bool resetNvidiaGpuOCAll( int deviceIndex = 0 );
+  bool startNvidiaOCTuning( const std::string &optionsJSON, int deviceIndex = 0 );
+  std::optional< std::string > getNvidiaOCTuningStatus();
+  bool cancelNvidiaOCTuning();
 
   // Device Capability Queries
   std::optional< bool > getWaterCoolerSupported();
@@ -153,6 +227,8 @@ public:
 
   // Keyboard Control
   bool setKeyboardBacklight( const std::string &config );
+  /// Stream one frame of packed RGB, three bytes per zone; empty ends the stream
+  bool setKeyboardBacklightFrame( const std::vector< uint8_t > &rgb );
   std::optional< std::string > getKeyboardBacklightInfo();
   std::optional< std::string > getKeyboardBacklightStates();
   bool setFnLock( bool enabled );
@@ -171,7 +247,12 @@ public:
   std::optional< int > getCpuTemperature();
   std::optional< int > getGpuTemperature();
   std::optional< int > getIGpuTemperature();
-  std::optional< int > getCpuFrequency();
+  std::optional< int > getCpuFrequency();            ///< Average over all cores, MHz
+  std::optional< std::string > getCpuCoresJSON();     ///< Per-core frequency / busy time and aggregates
+  std::optional< std::string > getWorkerStatsJSON();  ///< Daemon worker cycle timing
+  std::optional< std::string > getFanTraceJSON();     ///< Fan loop latency per stage
+  std::optional< std::string > getIpcStatsJSON();     ///< D-Bus call counts and latency per method
+  std::optional< std::string > getStartupTimelineJSON(); ///< Daemon startup phases and their timing
   std::optional< int > getGpuFrequency();
   std::optional< int > getIGpuFrequency();
   std::optional< double > getCpuPower();
@@ -190,6 +271,7 @@ public:
   std::optional< int > getDGpuMemClockOffsetMHz();    ///< Memory-clock offset at current P-state
   std::optional< int > getDGpuVramFrequencyMHz();     ///< VRAM frequency in MHz
   std::optional< int > getDGpuCoreVoltageMv();        ///< Core voltage in mV
+  std::optional< std::string > getDGpuInfoListJSON(); ///< JSON array with the values of every dGPU
   std::optional< int > getFanSpeedRPM();
   std::optional< int > getGpuFanSpeedRPM();
   std::optional< int > getFanSpeedPercent();
@@ -197,6 +279,8 @@ public:
   // Water cooler readings (if available from daemon)
   std::optional< int > getWaterCoolerFanSpeed();
   std::optional< int > getWaterCoolerPumpLevel();
+  /// All of the above in one round trip; prefer it over polling fields one by one
+  std::optional< LiveSnapshot > getLiveSnapshot();
 
   // Water cooler control
   bool enableWaterCooler( bool enable );
@@ -207,9 +291,58 @@ public:
   bool turnOffWaterCoolerLED();
 
   // Monitoring history
+  /// Metric blocks plus an optional event block; see MetricEvents.hpp and
+  /// ucc::decodeMetricEvents() for the annotations
   std::optional< QByteArray > getMonitorDataSince( qint64 sinceTimestampMs );
+  /// Delta/XOR-compressed variant (see MetricsCodec.hpp); nullopt on older daemons
+  std::optional< QByteArray > getMonitorDataSinceCompressed( qint64 sinceTimestampMs );
+  /// Server-side downsampled history: bit i of @p metricMask selects MetricId i,
+  /// @p mode 0 = LTTB, 1 = min/max buckets; same layout as getMonitorDataSince()
+  std::optional< QByteArray > getMonitorDataSinceDecimated( qint64 sinceTimestampMs, quint32 metricMask,
+                                                            int maxPointsPerSeries, int mode = 0 );
+  /// The series selected by @p metricMask (bit i = MetricId i) as columns over one shared time axis,
+  /// so samples of one daemon tick share a row; see MetricsHistoryStore::querySinceFrames()
+  std::optional< QByteArray > getMonitorFramesSince( qint64 sinceTimestampMs, quint64 metricMask );
+  /// getMonitorFramesSince() limited to the oldest @p maxRows rows; page on with the last row's time + 1
+  std::optional< QByteArray > getMonitorFramesPage( qint64 sinceTimestampMs, quint64 metricMask, int maxRows );
+  /// Only the event block of getMonitorDataSince(); empty without events
+  std::optional< QByteArray > getMonitorEventsSince( qint64 sinceTimestampMs );
+  /// Every metric the daemon records: id, key, unit, group and whether it has data on this machine
+  std::optional< std::string > getMetricCatalog();
+  /// Long-window min/max/avg history from the daemon's rollup tiers (0 = no point budget)
+  std::optional< QByteArray > getMonitorRollupSince( qint64 sinceTimestampMs, int maxPointsPerSeries );
+  /// Per-metric p50/p95/p99, min/max/avg and time above threshold as JSON;
+  /// @p thresholds maps metric names ("cpuTemp", ...) to threshold values
+  std::optional< std::string > getMonitorStats( qint64 sinceTimestampMs, const QVariantMap &thresholds = {} );
   bool setMonitorHistoryHorizon( int seconds );
   std::optional< int > getMonitorHistoryHorizon();
+  /// Dense per-core frequency / busy rows; layout in CoreHistoryRing.hpp
+  std::optional< QByteArray > getCpuCoreHistorySince( qint64 sinceTimestampMs );
+
+  // Shared-memory live metrics (mapped once, then read without D-Bus calls)
+  /// Same layout as getMonitorDataSince(); nullopt if the segment is
+  /// unavailable or no longer reaches back to @p sinceTimestampMs
+  std::optional< QByteArray > readLiveMetricsSince( qint64 sinceTimestampMs );
+  /// Latest value of @p metricId (a MetricId value)
+  std::optional< double > readLiveMetric( int metricId );
+
+  // Push-based metrics
+  /// Ask the daemon to emit MetricsSample (relayed as metricsSample()) once
+  /// per tick; the subscription is renewed automatically after reconnects
+  bool setMetricsSamplesEnabled( bool enabled );
+
+  /// Ask the daemon to sample at its fastest rate (for a visible live view);
+  /// renewed automatically after reconnects like the MetricsSample subscription
+  bool setFastSamplingEnabled( bool enabled );
+
+  /// Ask the daemon to sample the given ucc::SensorGroup bits (0 unsubscribes);
+  /// renewed automatically after reconnects like the MetricsSample subscription
+  bool setSensorSubscription( uint32_t groups );
+
+  /// Use a private socket to uccd for monitoring reads and fan-curve calls
+  /// (ucc::peer::peerServes()) instead of the system bus; reopened after
+  /// reconnects, and every call falls back to the bus if the channel fails
+  bool setPeerChannelEnabled( bool enabled );
 
   // Signal Subscription
   using ProfileChangedCallback = std::function< void( const std::string &profileId ) >;
@@ -218,6 +351,38 @@ public:
   void subscribeProfileChanged( ProfileChangedCallback callback );
   void subscribePowerStateChanged( PowerStateChangedCallback callback );
 
+  // Asynchronous reads
+  // Each returns at once; @p done runs later on the caller's event loop with
+  // the reply, or std::nullopt on error or while disconnected.  No callback
+  // is made once @p context has been destroyed.
+  template< typename T >
+  using Reply = std::function< void( std::optional< T > ) >;
+
+  void getLiveSnapshotAsync( QObject *context, Reply< LiveSnapshot > done );
+  void getSystemInfoJSONAsync( QObject *context, Reply< std::string > done );
+  void getDisplayBrightnessAsync( QObject *context, Reply< int > done );
+  void getWebcamEnabledAsync( QObject *context, Reply< bool > done );
+  void getFnLockAsync( QObject *context, Reply< bool > done );
+  void getMonitorDataSinceAsync( QObject *context, qint64 sinceTimestampMs, Reply< QByteArray > done );
+  void getMonitorDataSinceCompressedAsync( QObject *context, qint64 sinceTimestampMs, Reply< QByteArray > done );
+  void getMonitorDataSinceDecimatedAsync( QObject *context, qint64 sinceTimestampMs, quint32 metricMask,
+                                          int maxPointsPerSeries, Reply< QByteArray > done, int mode = 0 );
+  void getMonitorFramesPageAsync( QObject *context, qint64 sinceTimestampMs, quint64 metricMask, int maxRows,
+                                  Reply< QByteArray > done );
+  void getMonitorEventsSinceAsync( QObject *context, qint64 sinceTimestampMs, Reply< QByteArray > done );
+  void getMetricCatalogAsync( QObject *context, Reply< std::string > done );
+
+  /**
+   * @brief Current slow-changing daemon state (org.freedesktop.DBus.Properties.GetAll)
+   *
+   * ActiveProfileJSON, PowerState, SettingsJSON, ProfilesJSON, WebcamSWStatus,
+   * FnLockStatus, DisplayBrightness, WaterCooler{Enabled,Available,Connected},
+   * CurrentCharging{Profile,Priority} and Charge{Start,End}Threshold.
+   * Changes arrive as propertiesChanged(); std::nullopt from a daemon that
+   * predates the properties, which clients must still poll.
+   */
+  std::optional< QVariantMap > getProperties();
+
   // Connection status
   bool isConnected() const;
 
@@ -228,6 +393,13 @@ signals:
                        const QString &gpuProfileId );
   void powerStateChanged( const QString &state );
   void connectionStatusChanged( bool connected );
+  /// Newest value of every metric indexed by MetricId (NaN = no sample yet)
+  void metricsSample( qint64 timestampMs, const QList< double > &values );
+  /// Daemon properties that changed, name → new value (see getProperties())
+  void propertiesChanged( const QVariantMap &changed );
+  /// An alert rule (see setAlertRules()) started / stopped holding
+  void alertRaised( const QString &ruleId, const QString &metric, double value, qint64 timestampMs );
+  void alertCleared( const QString &ruleId, const QString &metric, double value, qint64 timestampMs );
 
 private slots:
   void onProfileChangedSignal( const QString &profileId,
@@ -235,20 +407,82 @@ private slots:
                                const QString &fanProfileId,
                                const QString &gpuProfileId );
   void onPowerStateChangedSignal( const QString &state );
+  void onMetricsSampleSignal( qlonglong timestampMs, const QList< double > &values );
+  void onAlertRaisedSignal( const QString &ruleId, const QString &metric, double value, qlonglong timestampMs );
+  void onAlertClearedSignal( const QString &ruleId, const QString &metric, double value, qlonglong timestampMs );
+  void onPropertiesChangedSignal( const QString &interfaceName,
+                                  const QVariantMap &changed,
+                                  const QStringList &invalidated );
   void onServiceRegistered( const QString &service );
   void onServiceUnregistered( const QString &service );
 
 private:
   void connectToDaemon();          ///< (Re)create the interface and subscribe to D-Bus signals
   void subscribeDbusSignals();     ///< Connect D-Bus signals (idempotent — disconnects first)
+  bool ensureLiveMetrics();        ///< Map the daemon's live segment on first use
 
-  std::unique_ptr< QDBusInterface > m_interface;
+  /**
+   * @brief Reply of a polled getter, decoded once and shared by every
+   *        accessor that reads a field of it
+   *
+   * One GetDGpuInfoValuesJSON serves getGpuTemperature(), getGpuPower(),
+   * getDGpuVramUsedMiB(), ... within REPLY_CACHE_TTL_MS.  Dropped early on
+   * MetricsSample, profile and power-state signals and on reconnects.
+   */
+  struct CachedReply
+  {
+    qint64 fetchedMs = 0;   ///< steady clock
+    bool valid = false;     ///< false caches a failed call
+    QJsonObject json;       ///< *JSON getters
+    QVariantMap fanData;    ///< GetFanData*: key → { data, timestamp }
+  };
+
+  static constexpr qint64 REPLY_CACHE_TTL_MS = 250;
+
+  const CachedReply *cachedReply( const QString &method );
+  std::optional< QJsonObject > cachedJson( const QString &method );
+  std::optional< QVariantMap > cachedFanData( const QString &method );
+  void invalidateReplyCache();
+
+  /// Last reply of a JSON getter and the daemon's version of it
+  struct VersionedJSON
+  {
+    quint64 version = 0;
+    std::string json;
+  };
+
+  /// @p method (e.g. GetSettingsJSON) through its *IfChanged variant, so an
+  /// unchanged document is not sent again; falls back to @p method itself
+  std::optional< std::string > versionedJSON( const QString &method );
+
+  /// Call a typed profile method; reply demarshalled by ucc::plainDBusValue()
+  std::optional< QVariant > callProfileDataMethod( const QString &method, const QVariantList &args = {} );
+
+  std::unique_ptr< UccdProxy > m_interface;
   QDBusServiceWatcher *m_serviceWatcher = nullptr;
   bool m_connected = false;
+  LiveMetricsView m_liveMetrics;
+  bool m_liveMetricsRequested = false;  ///< Only ask the daemon once per connection
+  bool m_metricsSamplesEnabled = false;
+  bool m_fastSamplingEnabled = false;
+  uint32_t m_sensorGroups = 0;
+  bool m_peerChannelEnabled = false;
+  mutable PeerChannelClient m_peer;
+  bool m_typedProfileApi = true;  ///< Cleared when the daemon lacks GetDefaultProfiles & co.
+  std::map< QString, CachedReply > m_replyCache;  ///< Keyed by D-Bus method
+  bool m_versionedJsonApi = true;  ///< Cleared when the daemon lacks the *IfChanged getters
+  std::map< QString, VersionedJSON > m_versionedJson;  ///< Keyed by plain getter
 
   static constexpr const char *DBUS_SERVICE = "com.uniwill.uccd";
   static constexpr const char *DBUS_PATH = "/com/uniwill/uccd";
   static constexpr const char *DBUS_INTERFACE = "com.uniwill.uccd";
+  static constexpr const char *DBUS_PROPERTIES_INTERFACE = "org.freedesktop.DBus.Properties";
+
+  void openPeerChannel();
+
+  /// Reply of @p method over the peer channel; nullopt means use the bus
+  /// (channel closed, method not served there, or refused)
+  std::optional< QVariant > callPeer( const QString &method, const QVariantList &args = {} ) const;
 
   // Helper for DBus calls
   template< typename T >
@@ -261,6 +495,9 @@ private:
 
   template< typename... Args >
   bool callVoidMethod( const QString &method, const Args &...args ) const;
+
+  template< typename T, typename... Args >
+  void callMethodAsync( QObject *context, const QString &method, Reply< T > done, const Args &...args ) const;
 };
 
 } // namespace ucc
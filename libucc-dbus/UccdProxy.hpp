@@ -0,0 +1,99 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+
+#include <type_traits>
+#include <utility>
+
+namespace ucc
+{
+
+/**
+ * @brief Method calls on one D-Bus object, built directly as messages.
+ *
+ * Stands in for QDBusInterface, whose constructor introspects the whole
+ * remote interface (a blocking round trip and an XML parse of every
+ * method) before the first call, and again on every reconnect.  The
+ * client already knows what it calls, so nothing is looked up: each call
+ * is a QDBusMessage with the arguments as passed, sent on the connection.
+ * The argument types therefore have to match the remote signature, as
+ * with QDBusInterface.
+ */
+class UccdProxy
+{
+public:
+  UccdProxy( QString service, QString path, QString interface, QDBusConnection connection )
+    : m_service( std::move( service ) ), m_path( std::move( path ) ), m_interface( std::move( interface ) ),
+      m_connection( std::move( connection ) )
+  {
+  }
+
+  /// The connection is up; whether the service answers shows at the first call
+  [[nodiscard]] bool isValid() const { return m_connection.isConnected(); }
+
+  [[nodiscard]] QDBusError lastError() const { return m_connection.lastError(); }
+
+  [[nodiscard]] QDBusMessage callWithArgumentList( QDBus::CallMode mode, const QString &method,
+                                                   const QVariantList &args ) const
+  {
+    return m_connection.call( message( method, args ), mode );
+  }
+
+  template< typename... Args >
+  [[nodiscard]] QDBusMessage call( const QString &method, const Args &...args ) const
+  {
+    return callWithArgumentList( QDBus::Block, method, { argument( args )... } );
+  }
+
+  template< typename... Args >
+  [[nodiscard]] QDBusPendingCall asyncCall( const QString &method, const Args &...args ) const
+  {
+    return m_connection.asyncCall( message( method, { argument( args )... } ) );
+  }
+
+private:
+  [[nodiscard]] QDBusMessage message( const QString &method, const QVariantList &args ) const
+  {
+    QDBusMessage msg = QDBusMessage::createMethodCall( m_service, m_path, m_interface, method );
+    if ( !args.isEmpty() )
+      msg.setArguments( args );
+    return msg;
+  }
+
+  template< typename T >
+  [[nodiscard]] static QVariant argument( const T &value )
+  {
+    if constexpr ( std::is_same_v< T, QVariant > )
+      return value;
+    else
+      return QVariant::fromValue( value );
+  }
+
+  QString m_service;
+  QString m_path;
+  QString m_interface;
+  QDBusConnection m_connection;
+};
+
+} // namespace ucc
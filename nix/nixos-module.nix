@@ -26,6 +26,11 @@ let
   ];
 in
 {
+  imports = [
+    (lib.mkRemovedOptionModule [ "services" "uccd" "enableSleepHandler" ]
+      "uccd pauses and restores the hardware state on suspend by itself.")
+  ];
+
   options.services.uccd = {
     enable = lib.mkEnableOption "Uniwill Control Center daemon (uccd)";
 
@@ -46,12 +51,6 @@ in
       example = [ "--verbose" ];
       description = "Extra arguments passed to `uccd --start`.";
     };
-
-    enableSleepHandler = lib.mkOption {
-      type = lib.types.bool;
-      default = true;
-      description = "Restart `uccd` on suspend/hibernate via a small systemd helper unit.";
-    };
   };
 
   config = lib.mkIf cfg.enable {
@@ -110,27 +109,5 @@ in
         ReadWritePaths = [ "/etc/ucc" "/run" ];
       };
     };
-
-    systemd.services.uccd-sleep = lib.mkIf cfg.enableSleepHandler {
-      description = "Uniwill Control Center Daemon Sleep Handler";
-      documentation = [ "man:uccd(8)" ];
-      after = [
-        "suspend.target"
-        "hibernate.target"
-        "hybrid-sleep.target"
-        "suspend-then-hibernate.target"
-      ];
-      wantedBy = [
-        "suspend.target"
-        "hibernate.target"
-        "hybrid-sleep.target"
-        "suspend-then-hibernate.target"
-      ];
-
-      serviceConfig = {
-        Type = "oneshot";
-        ExecStart = "${config.systemd.package}/bin/systemctl restart uccd.service";
-      };
-    };
   };
 }
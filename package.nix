@@ -83,10 +83,6 @@ stdenv.mkDerivation {
           "$out/share/dbus-1/system-services/com.uniwill.uccd.service"
       fi
     fi
-    if [ -f "$out/lib/systemd/system/uccd-sleep.service" ]; then
-      substituteInPlace "$out/lib/systemd/system/uccd-sleep.service" \
-        --replace-fail "/usr/bin/systemctl" "${systemd}/bin/systemctl"
-    fi
 
     if [ -f "$out/lib/systemd/system/uccd.service" ]; then
       if ! grep -q '^Type=dbus$' "$out/lib/systemd/system/uccd.service"; then
@@ -0,0 +1,658 @@
+/*
+ * Microbenchmarks for uccd hot paths (QBENCHMARK): history store push and
+ * queries at full horizon, fan curve lookup and control loop, profile
+ * (de)serialisation, dGPU JSON and sysfs reads on tmpfs.
+ *
+ * Built as ucc_benchmarks; not registered with CTest.  All Qt Test options
+ * apply (-iterations, -callgrind, -perf, -o).  "-json FILE" (or "-json -"
+ * for stdout) additionally writes the results in a stable JSON form:
+ *
+ *   { "schema": 1,
+ *     "benchmarks": [ { "name": "metricsPushTick", "tag": "",
+ *                       "metric": "WalltimeMilliseconds",
+ *                       "value": <per iteration>, "iterations": N }, ... ] }
+ *
+ * sorted by name and tag, so two runs can be diffed or compared by script.
+ *
+ * The binary replaces the global operator new with a counting one; the
+ * idleTick* functions fail if a steady-state tick of the daemon's hot paths
+ * (EC batch, fan logic, a whole fan worker cycle, history push and alert
+ * rules, property change check) allocates.
+ */
+
+#include <QTest>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryFile>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "AlertEngine.hpp"
+#include "EcIoService.hpp"
+#include "FanControlLogic.hpp"
+#include "GpuInfo.hpp"
+#include "MetricsHistoryStore.hpp"
+#include "ProfileManager.hpp"
+#include "PropertyChangeTracker.hpp"
+#include "SnapshotCell.hpp"
+#include "SysfsNode.hpp"
+#include "WorkerScheduler.hpp"
+#include "workers/FanControlWorker.hpp"
+
+// ---- Allocation counting -------------------------------------------------
+
+namespace
+{
+std::atomic< uint64_t > g_allocations{ 0 };
+thread_local uint64_t t_allocations = 0;
+}
+
+// Kept out of line: inlined into callers, GCC pairs malloc() with operator delete and warns
+[[gnu::noinline]] void *operator new( std::size_t size )
+{
+  g_allocations.fetch_add( 1, std::memory_order_relaxed );
+  ++t_allocations;
+  if ( void *p = std::malloc( size ? size : 1 ) )
+    return p;
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void *operator new[]( std::size_t size )
+{
+  return ::operator new( size );
+}
+
+[[gnu::noinline]] void operator delete( void *p ) noexcept
+{
+  std::free( p );
+}
+
+[[gnu::noinline]] void operator delete[]( void *p ) noexcept
+{
+  std::free( p );
+}
+
+[[gnu::noinline]] void operator delete( void *p, std::size_t ) noexcept
+{
+  std::free( p );
+}
+
+[[gnu::noinline]] void operator delete[]( void *p, std::size_t ) noexcept
+{
+  std::free( p );
+}
+
+namespace
+{
+
+constexpr int64_t TICK_MS = 1000 / MetricsHistoryStore::MAX_SAMPLE_RATE_HZ;
+
+const char *const PROFILE_JSON = R"({
+  "id": "bench-profile",
+  "name": "Benchmark Profile",
+  "description": "Profile with every section set",
+  "display": { "brightness": 80, "useBrightness": true, "refreshRate": 144, "useRefRate": true,
+               "xResolution": 2560, "yResolution": 1600, "useResolution": false },
+  "cpu": { "onlineCores": 16, "scalingMinFrequency": 800000, "scalingMaxFrequency": 4800000,
+           "governor": "powersave", "energyPerformancePreference": "balance_performance", "noTurbo": false },
+  "webcam": { "status": true, "useStatus": false },
+  "fan": { "useControl": true, "fanProfile": "fan-balanced", "sameSpeed": false,
+           "autoControlWC": true, "enableWaterCooler": false,
+           "tableCPU": [{"temp":30,"speed":0},{"temp":50,"speed":25},{"temp":65,"speed":40},
+                        {"temp":75,"speed":60},{"temp":85,"speed":80},{"temp":95,"speed":100}],
+           "tableGPU": [{"temp":30,"speed":0},{"temp":50,"speed":25},{"temp":65,"speed":40},
+                        {"temp":75,"speed":60},{"temp":85,"speed":80},{"temp":95,"speed":100}] },
+  "odmProfile": { "name": "enthusiast" },
+  "odmPowerLimits": { "tdpValues": [45, 80, 110] },
+  "keyboard": { "keyboardProfileName": "Rainbow" },
+  "selectedKeyboardProfile": "kb-uuid-001",
+  "chargingProfile": "balanced",
+  "chargingPriority": "performance",
+  "chargeType": "Standard",
+  "chargeStartThreshold": 40,
+  "chargeEndThreshold": 80
+})";
+
+/// Heap allocations, on any thread, since construction
+class AllocationCount
+{
+public:
+  AllocationCount() : m_start( g_allocations.load() ) {}
+  [[nodiscard]] uint64_t count() const { return g_allocations.load() - m_start; }
+
+private:
+  uint64_t m_start;
+};
+
+/// Two fans that always answer; nothing behind it
+class IdleDevice : public DeviceInterface
+{
+public:
+  IdleDevice() : DeviceInterface( m_noDevice ) {}
+
+  bool identify( bool &identified ) override { identified = true; return true; }
+  bool deviceInterfaceIdStr( std::string &id ) override { id = "idle"; return true; }
+  bool deviceModelIdStr( std::string &id ) override { id = "idle"; return true; }
+  bool setEnableModeSet( bool ) override { return true; }
+  bool getNumberFans( int &nrFans ) override { nrFans = 2; return true; }
+  bool setFansAuto() override { return true; }
+  bool setFanSpeedPercent( const int, const int ) override { return true; }
+  bool getFanSpeedPercent( const int, int &percent ) override { percent = 40; return true; }
+  bool getFanTemperature( const int fan, int &celsius ) override { celsius = 50 + fan; return true; }
+  bool getFansMinSpeed( int &minSpeed ) override { minSpeed = 0; return true; }
+  bool getFansOffAvailable( bool &offAvailable ) override { offAvailable = true; return true; }
+  bool setWebcam( const bool ) override { return true; }
+  bool getWebcam( bool &status ) override { status = true; return true; }
+  bool getAvailableODMPerformanceProfiles( std::vector< std::string > & ) override { return false; }
+  bool setODMPerformanceProfile( std::string ) override { return false; }
+  bool getDefaultODMPerformanceProfile( std::string & ) override { return false; }
+  bool getNumberTDPs( int &nrTDPs ) override { nrTDPs = 0; return true; }
+  bool getTDPDescriptors( std::vector< std::string > & ) override { return true; }
+  bool getTDPMin( const int, int & ) override { return false; }
+  bool getTDPMax( const int, int & ) override { return false; }
+  bool setTDP( const int, const int ) override { return false; }
+  bool getTDP( const int, int & ) override { return false; }
+
+private:
+  IO m_noDevice{ "/nonexistent/tuxedo_io" };
+};
+
+/// The daemon's fan worker, counting what its work cycles allocate
+class CountingFanWorker : public FanControlWorker
+{
+public:
+  using FanControlWorker::FanControlWorker;
+
+  ~CountingFanWorker() override { stop(); }
+
+  /// Wake the worker for @p cycles cycles; allocations in them, nullopt if one did not run
+  std::optional< uint64_t > runCycles( int cycles )
+  {
+    std::unique_lock lock( m_mutex );
+    const uint64_t before = m_allocations;
+    for ( int i = 0; i < cycles; ++i )
+    {
+      const uint64_t target = m_cycles + 1;
+      wake();
+      if ( !m_ran.wait_for( lock, std::chrono::seconds( 5 ), [&] { return m_cycles >= target; } ) )
+        return std::nullopt;
+    }
+    return m_allocations - before;
+  }
+
+protected:
+  void onWork() override
+  {
+    const uint64_t before = t_allocations;
+    FanControlWorker::onWork();
+    const uint64_t made = t_allocations - before;
+    std::lock_guard lock( m_mutex );
+    m_allocations += made;
+    ++m_cycles;
+    m_ran.notify_all();
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_ran;
+  uint64_t m_cycles = 0;
+  uint64_t m_allocations = 0;
+};
+
+FanProfile benchFanProfile()
+{
+  const std::vector< FanTableEntry > table{ { 30, 0 }, { 50, 25 }, { 65, 40 }, { 75, 60 }, { 85, 80 }, { 95, 100 } };
+  return FanProfile( "bench", "Benchmark", table, table );
+}
+
+/// Qt Test's XML log → stable JSON (see the file comment)
+bool writeJsonResults( const QString &xmlPath, const QString &jsonPath )
+{
+  QFile xml( xmlPath );
+  if ( !xml.open( QIODevice::ReadOnly ) )
+    return false;
+
+  struct Result
+  {
+    QString name;
+    QString tag;
+    QString metric;
+    double value;
+    qint64 iterations;
+  };
+  std::vector< Result > results;
+
+  QXmlStreamReader reader( &xml );
+  QString function;
+  while ( !reader.atEnd() )
+  {
+    if ( reader.readNext() != QXmlStreamReader::StartElement )
+      continue;
+    const auto attrs = reader.attributes();
+    if ( reader.name() == QLatin1StringView( "TestFunction" ) )
+      function = attrs.value( QLatin1StringView( "name" ) ).toString();
+    else if ( reader.name() == QLatin1StringView( "BenchmarkResult" ) )
+      results.push_back( { function, attrs.value( QLatin1StringView( "tag" ) ).toString(),
+                           attrs.value( QLatin1StringView( "metric" ) ).toString(),
+                           attrs.value( QLatin1StringView( "value" ) ).toDouble(),
+                           attrs.value( QLatin1StringView( "iterations" ) ).toLongLong() } );
+  }
+  if ( reader.hasError() )
+    return false;
+
+  std::ranges::sort( results, []( const Result &a, const Result &b ) {
+    return a.name != b.name ? a.name < b.name : a.tag < b.tag;
+  } );
+
+  QJsonArray benchmarks;
+  for ( const auto &r : results )
+    benchmarks.append( QJsonObject{ { "name", r.name }, { "tag", r.tag }, { "metric", r.metric },
+                                    { "value", r.value }, { "iterations", r.iterations } } );
+  const QByteArray json = QJsonDocument( QJsonObject{ { "schema", 1 }, { "benchmarks", benchmarks } } )
+                            .toJson( QJsonDocument::Indented );
+
+  if ( jsonPath == QLatin1StringView( "-" ) )
+    return std::fwrite( json.constData(), 1, static_cast< size_t >( json.size() ), stdout ) ==
+           static_cast< size_t >( json.size() );
+  QFile out( jsonPath );
+  return out.open( QIODevice::WriteOnly | QIODevice::Truncate ) && out.write( json ) == json.size();
+}
+
+} // namespace
+
+class BenchHotPaths : public QObject
+{
+  Q_OBJECT
+
+private:
+  std::unique_ptr< MetricsHistoryStore > m_store;
+  int64_t m_nextTs = 0;
+  int64_t m_horizonStart = 0;
+  std::filesystem::path m_dir;
+
+private slots:
+
+  void initTestCase()
+  {
+    // Every metric at the highest sustained rate over the default horizon
+    m_store = std::make_unique< MetricsHistoryStore >();
+    const int64_t now = QDateTime::currentMSecsSinceEpoch();
+    m_horizonStart = now - static_cast< int64_t >( m_store->horizonSeconds() ) * 1000;
+    for ( m_nextTs = m_horizonStart; m_nextTs < now; m_nextTs += TICK_MS )
+      for ( size_t id = 0; id < static_cast< size_t >( MetricId::Count ); ++id )
+        m_store->push( static_cast< MetricId >( id ), m_nextTs, 40.0 + static_cast< double >( ( m_nextTs / TICK_MS + id ) % 50 ) );
+
+    // tmpfs where available, like sysfs the reads then never touch a disk
+    const std::filesystem::path shm( "/dev/shm" );
+    m_dir = ( std::filesystem::is_directory( shm ) ? shm : std::filesystem::temp_directory_path() ) /
+            ( "ucc-bench-" + std::to_string( getpid() ) );
+    std::filesystem::create_directories( m_dir );
+    std::ofstream( m_dir / "temp1_input" ) << "54000\n";
+  }
+
+  void cleanupTestCase()
+  {
+    std::filesystem::remove_all( m_dir );
+  }
+
+  // ---- MetricsHistoryStore ---------------------------------------------
+
+  /// One daemon tick: every metric once, the store full and evicting
+  void metricsPushTick()
+  {
+    QBENCHMARK
+    {
+      for ( size_t id = 0; id < static_cast< size_t >( MetricId::Count ); ++id )
+        m_store->push( static_cast< MetricId >( id ), m_nextTs, 55.0 );
+      m_nextTs += TICK_MS;
+    }
+  }
+
+  void metricsQuerySinceBinary_data()
+  {
+    QTest::addColumn< int >( "seconds" );
+    QTest::newRow( "10s" ) << 10;
+    QTest::newRow( "full" ) << 0;
+  }
+
+  void metricsQuerySinceBinary()
+  {
+    QFETCH( int, seconds );
+    const int64_t since = seconds > 0 ? m_nextTs - seconds * 1000LL : m_horizonStart;
+    size_t bytes = 0;
+    QBENCHMARK
+    {
+      bytes = m_store->querySinceBinary( since ).size();
+    }
+    QVERIFY( bytes > 0 );
+  }
+
+  void metricsQuerySinceJSON_data()
+  {
+    metricsQuerySinceBinary_data();
+  }
+
+  void metricsQuerySinceJSON()
+  {
+    QFETCH( int, seconds );
+    const int64_t since = seconds > 0 ? m_nextTs - seconds * 1000LL : m_horizonStart;
+    std::string json;
+    QBENCHMARK
+    {
+      json.clear();
+      m_store->querySinceJSON( since, json );
+    }
+    QVERIFY( json.size() > 2 );
+  }
+
+  // ---- Fan control -----------------------------------------------------
+
+  /// The whole 0–100 °C range per iteration
+  void fanProfileGetSpeedForTemp()
+  {
+    const FanProfile profile = benchFanProfile();
+    int64_t sum = 0;
+    QBENCHMARK
+    {
+      for ( int32_t t = 0; t <= 100; ++t )
+        sum += profile.getSpeedForTemp( t );
+    }
+    QVERIFY( sum > 0 );
+  }
+
+  /// One control-loop tick (calculateSpeedPercent() through updateSpeed())
+  void fanControlLogicTick()
+  {
+    FanControlLogic logic( benchFanProfile(), FanLogicType::CPU );
+    int temp = 40;
+    int64_t sum = 0;
+    QBENCHMARK
+    {
+      logic.addTemperature( temp, 1.0 );
+      logic.updateSpeed( 1.0 );
+      sum += logic.getSpeedPercent();
+      temp = temp >= 95 ? 40 : temp + 1;
+    }
+    QVERIFY( sum > 0 );
+  }
+
+  // ---- Steady-state allocations ----------------------------------------
+
+  /// The fan worker's EC round trip: temperatures read, duties written
+  void idleTickEcBatch()
+  {
+    IdleDevice device;
+    EcIoService ec( device, 0 );
+    EcBatch batch;
+    const auto tick = [&ec, &batch]( int duty ) {
+      batch.clear();
+      batch.push_back( EcRequest::fanTemperature( 0 ) );
+      batch.push_back( EcRequest::fanTemperature( 1 ) );
+      batch.push_back( EcRequest::setFanSpeed( 0, duty ) );
+      batch.push_back( EcRequest::setFanSpeed( 1, duty ) );
+      return ec.execute( batch );
+    };
+    // warm-up: the batch, both queue buffers and the read cache reach their size
+    for ( int i = 0; i < 4; ++i )
+      QVERIFY( tick( 30 ) );
+
+    const AllocationCount allocations;
+    for ( int i = 0; i < 100; ++i )
+      QVERIFY( tick( 30 + i % 20 ) );
+    QCOMPARE( allocations.count(), uint64_t( 0 ) );
+  }
+
+  /// A whole fan worker cycle, publishing its telemetry the way the service does
+  void idleTickFanWorker()
+  {
+    IdleDevice device;
+    EcIoService ec( device, 0 );
+    WorkerScheduler scheduler( 1 );
+    MetricsHistoryStore store;
+    SnapshotCell< std::vector< FanTelemetry::Fan > > published( std::vector< FanTelemetry::Fan >( 2 ) );
+
+    UccProfile profile;
+    profile.id = "bench";
+    profile.fan.controller.preRampDegPerWatt = 0.5;  // the power trend is read as well
+
+    CountingFanWorker worker(
+      ec, [&profile]() -> const UccProfile & { return profile; }, []() { return true; },
+      [&published, &store]( const FanTelemetry &telemetry ) {
+        published.updateRecycled( [&telemetry]( std::vector< FanTelemetry::Fan > &fans ) {
+          std::copy_n( telemetry.fans.begin(), std::min( fans.size(), telemetry.fans.size() ), fans.begin() );
+        } );
+        MetricFrame frame;
+        for ( size_t i = 0; i < telemetry.fans.size() && i < 2; ++i )
+        {
+          frame.add( i == 0 ? MetricId::CpuFanDuty : MetricId::GpuFanDuty, telemetry.fans[ i ].speed );
+          frame.add( i == 0 ? MetricId::CpuTemp : MetricId::GpuTemp, telemetry.fans[ i ].temp );
+        }
+        store.pushFrame( telemetry.timestampMs, frame );
+      },
+      nullptr, scheduler );
+    worker.setPowerTrendProvider( [&store]( FanLogicType type, std::vector< MetricDataPoint > &points ) {
+      points.clear();
+      store.copySince( type == FanLogicType::CPU ? MetricId::CpuPower : MetricId::GpuPower,
+                       QDateTime::currentMSecsSinceEpoch() - 4000, points );
+      return FanPowerTrend::fromSamples( points );
+    } );
+
+    // warm-up: fan logics, cycle buffers, EC cache and the published buffers reach their size
+    QVERIFY( worker.runCycles( 5 ).has_value() );
+
+    const auto allocations = worker.runCycles( 50 );
+    QVERIFY( allocations.has_value() );
+    QCOMPARE( *allocations, uint64_t( 0 ) );
+    QCOMPARE( published.load()->front().temp, 50 );
+  }
+
+  void idleTickFanControlLogic()
+  {
+    FanControlLogic logic( benchFanProfile(), FanLogicType::CPU );
+    logic.addTemperature( 40, 1.0 );
+    logic.updateSpeed( 1.0 );
+
+    const AllocationCount allocations;
+    int64_t sum = 0;
+    for ( int temp = 40; temp < 95; ++temp )
+    {
+      logic.addTemperature( temp, 1.0 );
+      logic.updateSpeed( 1.0 );
+      sum += logic.getSpeedPercent();
+    }
+    QCOMPARE( allocations.count(), uint64_t( 0 ) );
+    QVERIFY( sum > 0 );
+  }
+
+  /// A full store evicting as it goes
+  void idleTickMetricsPush()
+  {
+    const AllocationCount allocations;
+    for ( int tick = 0; tick < 100; ++tick )
+    {
+      for ( size_t id = 0; id < static_cast< size_t >( MetricId::Count ); ++id )
+        m_store->push( static_cast< MetricId >( id ), m_nextTs, 55.0 );
+      m_nextTs += TICK_MS;
+    }
+    QCOMPARE( allocations.count(), uint64_t( 0 ) );
+  }
+
+  /// The same pushes with alert rules watching them, none of them holding
+  void idleTickAlertRules()
+  {
+    AlertEngine alerts;
+    QCOMPARE( alerts.setRules( { AlertRule{ "hot", "gpuTemp", "above", 87.0, 30, 0.0 },
+                                 AlertRule{ "spike", "cpuTemp", "rising", 2.0, 5, 0.0 } },
+                               m_store->registry() ), size_t( 2 ) );
+    m_store->setAlertEngine( &alerts );
+
+    const AllocationCount allocations;
+    for ( int tick = 0; tick < 100; ++tick )
+    {
+      for ( size_t id = 0; id < static_cast< size_t >( MetricId::Count ); ++id )
+        m_store->push( static_cast< MetricId >( id ), m_nextTs, 55.0 );
+      m_nextTs += TICK_MS;
+    }
+    const uint64_t count = allocations.count();
+    m_store->setAlertEngine( nullptr );
+    QCOMPARE( count, uint64_t( 0 ) );
+    QCOMPARE( alerts.activeCount(), size_t( 0 ) );
+  }
+
+  /// The service's PropertiesChanged check with nothing changed
+  void idleTickPropertyChanges()
+  {
+    const std::string profileJson = PROFILE_JSON;
+    const std::string chargingProfile = "balanced_charging_profile";
+    PropertyChangeTracker tracker;
+    const auto stage = [&]() {
+      tracker.set( "ActiveProfileJSON", profileJson );
+      tracker.set( "CurrentChargingProfile", chargingProfile );
+      tracker.set( "PowerState", "power_ac" );
+      tracker.set( "FnLockStatus", false );
+      tracker.set( "ChargeEndThreshold", int32_t( 80 ) );
+      return tracker.takeChanged().size();
+    };
+    QCOMPARE( stage(), size_t( 5 ) );
+
+    const AllocationCount allocations;
+    size_t changed = 0;
+    for ( int tick = 0; tick < 100; ++tick )
+      changed += stage();
+    QCOMPARE( allocations.count(), uint64_t( 0 ) );
+    QCOMPARE( changed, size_t( 0 ) );
+  }
+
+  // ---- Profiles --------------------------------------------------------
+
+  void profileParseJSON()
+  {
+    const std::string json = PROFILE_JSON;
+    UccProfile profile;
+    QBENCHMARK
+    {
+      profile = ProfileManager::parseProfileJSON( json );
+    }
+    QCOMPARE( profile.id, std::string( "bench-profile" ) );
+  }
+
+  /// A typical profile list: built-ins plus a few custom ones
+  void profilesToJSON()
+  {
+    std::vector< UccProfile > profiles( 16, ProfileManager::parseProfileJSON( PROFILE_JSON ) );
+    for ( size_t i = 0; i < profiles.size(); ++i )
+      profiles[ i ].id += std::to_string( i );
+    std::string json;
+    QBENCHMARK
+    {
+      json = ProfileManager::profilesToJSON( profiles );
+    }
+    QVERIFY( json.size() > profiles.size() );
+  }
+
+  // ---- GPU JSON --------------------------------------------------------
+
+  void dgpuInfoToJSON()
+  {
+    DGpuInfo info;
+    info.m_name = "NVIDIA GeForce RTX 4070 Laptop GPU";
+    info.m_temp = 61.0;
+    info.m_coreFrequency = 2175.0;
+    info.m_vramFrequency = 8001.0;
+    info.m_maxCoreFrequency = 3105.0;
+    info.m_powerDraw = 87.43;
+    info.m_maxPowerLimit = 140.0;
+    info.m_enforcedPowerLimit = 115.0;
+    info.m_computeUtilPct = 97;
+    info.m_memoryUtilPct = 41;
+    info.m_vramUsedMiB = 5120;
+    info.m_vramTotalMiB = 8188;
+    info.m_perfLimitReason = "SW power cap";
+    info.m_currentPstate = 0;
+    info.m_coreVoltageMv = 893;
+
+    std::string json;
+    QBENCHMARK
+    {
+      json.clear();
+      ::dgpuInfoToJSON( info, json );
+    }
+    QVERIFY( json.front() == '{' && json.back() == '}' );
+  }
+
+  // ---- SysfsNode -------------------------------------------------------
+
+  void sysfsNodeRead_data()
+  {
+    QTest::addColumn< int >( "mode" );
+    QTest::newRow( "reopen" ) << static_cast< int >( SysfsReadMode::Reopen );
+    QTest::newRow( "cached" ) << static_cast< int >( SysfsReadMode::Cached );
+  }
+
+  void sysfsNodeRead()
+  {
+    QFETCH( int, mode );
+    SysfsNode< int32_t > node( ( m_dir / "temp1_input" ).string(), static_cast< SysfsReadMode >( mode ) );
+    int64_t sum = 0;
+    QBENCHMARK
+    {
+      sum += node.read().value_or( 0 );
+    }
+    QVERIFY( sum > 0 );
+  }
+};
+
+int main( int argc, char **argv )
+{
+  QCoreApplication app( argc, argv );
+
+  // "-json FILE" is ours; everything else goes to Qt Test
+  QStringList args;
+  QString jsonPath;
+  for ( int i = 0; i < argc; ++i )
+  {
+    if ( qstrcmp( argv[ i ], "-json" ) == 0 && i + 1 < argc )
+      jsonPath = QString::fromLocal8Bit( argv[ ++i ] );
+    else
+      args << QString::fromLocal8Bit( argv[ i ] );
+  }
+
+  BenchHotPaths bench;
+  if ( jsonPath.isEmpty() )
+    return QTest::qExec( &bench, args );
+
+  QTemporaryFile xml;
+  if ( !xml.open() )
+    return 1;
+  xml.close();
+  args << QStringLiteral( "-o" ) << xml.fileName() + QStringLiteral( ",xml" );
+  if ( jsonPath != QLatin1StringView( "-" ) )
+    args << QStringLiteral( "-o" ) << QStringLiteral( "-,txt" );
+
+  const int failures = QTest::qExec( &bench, args );
+  if ( !writeJsonResults( xml.fileName(), jsonPath ) )
+  {
+    std::fprintf( stderr, "ucc_benchmarks: cannot write %s\n", qPrintable( jsonPath ) );
+    return failures > 0 ? failures : 1;
+  }
+  return failures;
+}
+
+#include "bench_hot_paths.moc"
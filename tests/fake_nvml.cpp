@@ -0,0 +1,184 @@
+/*
+ * Stand-in for libnvidia-ml.so.1 on simulated hardware.  Load it with
+ *   UCCD_NVML_LIBRARY=<dir>/libucc_fake_nvml.so UCCD_SIMULATE=... uccd
+ * One GPU whose temperature and power follow the GPU channel of its own
+ * SimulatedHardware (same UCCD_SIMULATE workload, EC fan curve); the power
+ * limit can be set and caps the reported power.  Functions it leaves out
+ * resolve to nullptr in NvmlWrapper, as on an older driver.
+ */
+
+#include "NvmlWrapper.hpp"
+#include "tuxedo_io_lib/targets/simulated.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+using namespace nvml;
+
+namespace
+{
+
+constexpr nvmlReturn_t NVML_ERROR_INVALID_ARGUMENT = 2;
+constexpr unsigned int DEFAULT_LIMIT_MW = 80'000;
+constexpr unsigned int MIN_LIMIT_MW = 10'000;
+constexpr unsigned int MAX_LIMIT_MW = 115'000;
+constexpr unsigned int MAX_CLOCK_MHZ = 2'100;
+constexpr unsigned long long VRAM_BYTES = 8ULL << 30;
+
+int g_fakeDevice = 0;
+std::atomic< unsigned int > g_limitMw { DEFAULT_LIMIT_MW };
+
+SimulatedHardware &gpu()
+{
+  static const std::shared_ptr< SimulatedHardware > hw = [] {
+    auto shared = SimulatedHardware::fromEnvironment();
+    return shared ? shared : std::make_shared< SimulatedHardware >();
+  }();
+  hw->advanceToNow();
+  return *hw;
+}
+
+bool valid( nvmlDevice_t device ) { return device == &g_fakeDevice; }
+
+double powerW() { return std::min( gpu().power( 1 ), g_limitMw.load() / 1000.0 ); }
+
+/// 0..1, from the power draw relative to the default limit
+double load() { return std::clamp( powerW() / ( DEFAULT_LIMIT_MW / 1000.0 ), 0.0, 1.0 ); }
+
+} // namespace
+
+extern "C"
+{
+
+nvmlReturn_t nvmlInit_v2() { return NVML_SUCCESS; }
+nvmlReturn_t nvmlShutdown() { return NVML_SUCCESS; }
+
+nvmlReturn_t nvmlDeviceGetCount_v2( unsigned int *count )
+{
+  *count = 1;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetHandleByIndex_v2( unsigned int index, nvmlDevice_t *device )
+{
+  if ( index != 0 )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *device = &g_fakeDevice;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetName( nvmlDevice_t device, char *name, unsigned int length )
+{
+  if ( !valid( device ) || length == 0 )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  std::strncpy( name, "Simulated GPU", length - 1 );
+  name[ length - 1 ] = '\0';
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetTemperature( nvmlDevice_t device, unsigned int, unsigned int *temp )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *temp = static_cast< unsigned int >( std::lround( gpu().temperature( 1 ) ) );
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetPowerUsage( nvmlDevice_t device, unsigned int *milliwatts )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *milliwatts = static_cast< unsigned int >( powerW() * 1000.0 );
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetPowerManagementLimit( nvmlDevice_t device, unsigned int *limit )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *limit = g_limitMw.load();
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetEnforcedPowerLimit( nvmlDevice_t device, unsigned int *limit )
+{
+  return nvmlDeviceGetPowerManagementLimit( device, limit );
+}
+
+nvmlReturn_t nvmlDeviceSetPowerManagementLimit( nvmlDevice_t device, unsigned int limit )
+{
+  if ( !valid( device ) || limit < MIN_LIMIT_MW || limit > MAX_LIMIT_MW )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  g_limitMw = limit;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetPowerManagementLimitConstraints( nvmlDevice_t device, unsigned int *minLimit,
+                                                           unsigned int *maxLimit )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *minLimit = MIN_LIMIT_MW;
+  *maxLimit = MAX_LIMIT_MW;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetPowerManagementDefaultLimit( nvmlDevice_t device, unsigned int *limit )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *limit = DEFAULT_LIMIT_MW;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetPerformanceState( nvmlDevice_t device, nvmlPstates_t *state )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *state = load() > 0.2 ? NVML_PSTATE_0 : NVML_PSTATE_8;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetClockInfo( nvmlDevice_t device, unsigned int type, unsigned int *clockMHz )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  const double scale = type == NVML_CLOCK_MEM ? 0.4 : 1.0;
+  *clockMHz = static_cast< unsigned int >( MAX_CLOCK_MHZ * scale * ( 0.1 + 0.9 * load() ) );
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetMaxClockInfo( nvmlDevice_t device, unsigned int type, unsigned int *clockMHz )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  *clockMHz = static_cast< unsigned int >( MAX_CLOCK_MHZ * ( type == NVML_CLOCK_MEM ? 0.4 : 1.0 ) );
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetUtilizationRates( nvmlDevice_t device, nvmlUtilization_t *utilization )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  utilization->gpu = static_cast< unsigned int >( std::lround( load() * 100.0 ) );
+  utilization->memory = utilization->gpu / 2;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetMemoryInfo( nvmlDevice_t device, nvmlMemory_t *memory )
+{
+  if ( !valid( device ) )
+    return NVML_ERROR_INVALID_ARGUMENT;
+  memory->total = VRAM_BYTES;
+  memory->used = static_cast< unsigned long long >( VRAM_BYTES * ( 0.05 + 0.6 * load() ) );
+  memory->free = memory->total - memory->used;
+  return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetMemoryInfo_v2( nvmlDevice_t device, nvmlMemory_t *memory )
+{
+  return nvmlDeviceGetMemoryInfo( device, memory );
+}
+
+} // extern "C"
@@ -0,0 +1,502 @@
+/*
+ * Multi-client D-Bus stress harness for uccd: N concurrent clients, each on
+ * its own bus connection (its own sender, like GUI, tray, GNOME extension
+ * and scripts), issue a weighted mix of calls for a fixed time.
+ *
+ * Built as ucc_dbus_stress; not registered with CTest.  Meant to run against
+ * the simulated hardware backend, so setters and load are safe and the fan
+ * loop sees realistic temperatures:
+ *
+ *   UCCD_SIMULATE=1 uccd --debug &
+ *   ucc_dbus_stress --clients 16 --duration 60 --mix snapshot=50,history=20,profiles=25,setters=5
+ *
+ * Reported per call class: client-side p50/p99/max and calls/s.  Daemon
+ * side, as deltas over the run: per-method handler latency (GetIpcStatsJSON),
+ * CPU time and cycle timing per worker (GetWorkerStatsJSON), fan loop stage
+ * latency (GetFanTraceJSON) and the daemon's process CPU.  Setters write the
+ * current display brightness back unchanged.  --json prints one object
+ * instead of tables.
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QDBusReply>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+constexpr const char *SERVICE = "com.uniwill.uccd";
+constexpr const char *PATH = "/com/uniwill/uccd";
+constexpr const char *INTERFACE = "com.uniwill.uccd";
+
+using Clock = std::chrono::steady_clock;
+
+enum class CallClass { Snapshot, History, Profiles, Setters, Count };
+
+constexpr std::array< const char *, static_cast< size_t >( CallClass::Count ) > CLASS_NAMES = {
+  "snapshot", "history", "profiles", "setters"
+};
+
+/// Methods of each class, taken in turn by every client
+const std::array< std::vector< const char * >, static_cast< size_t >( CallClass::Count ) > CLASS_METHODS = { {
+  { "GetLiveSnapshot", "GetFanDataCPU", "GetDisplayBrightness" },
+  { "GetMonitorDataSince" },
+  { "GetActiveProfileJSON", "GetProfilesJSON", "GetActiveProfile" },
+  { "SetDisplayBrightness" },
+} };
+
+struct Options
+{
+  int clients = 8;
+  double durationS = 30.0;
+  double rateHz = 20.0;  ///< Per client; 0 = back to back
+  int historyS = 60;
+  std::array< int, static_cast< size_t >( CallClass::Count ) > weights = { 50, 20, 25, 0 };
+  bool json = false;
+};
+
+/// Client-side latencies of one call class, in milliseconds
+struct Series
+{
+  std::vector< double > ms;
+  int failures = 0;
+};
+
+struct ClientResult
+{
+  bool connected = false;
+  std::array< Series, static_cast< size_t >( CallClass::Count ) > series;
+};
+
+double elapsedMs( Clock::time_point since )
+{
+  return std::chrono::duration< double, std::milli >( Clock::now() - since ).count();
+}
+
+/// Nearest-rank quantile of sorted @p ms
+double quantile( const std::vector< double > &ms, double q )
+{
+  if ( ms.empty() )
+    return 0.0;
+  const auto rank = static_cast< size_t >( std::ceil( q * static_cast< double >( ms.size() ) ) );
+  return ms[ std::clamp< size_t >( rank, 1, ms.size() ) - 1 ];
+}
+
+/// "snapshot=50,history=20,..."; unnamed classes keep their weight
+bool parseMix( const QString &spec, Options &options )
+{
+  for ( const QString &part : spec.split( ',', Qt::SkipEmptyParts ) )
+  {
+    const auto fields = part.split( '=' );
+    bool ok = false;
+    const int weight = fields.size() == 2 ? fields[ 1 ].toInt( &ok ) : -1;
+    const auto it = std::find_if( CLASS_NAMES.begin(), CLASS_NAMES.end(),
+                                  [&]( const char *name ) { return fields[ 0 ].trimmed() == QLatin1StringView( name ); } );
+    if ( !ok || weight < 0 || it == CLASS_NAMES.end() )
+      return false;
+    options.weights[ static_cast< size_t >( it - CLASS_NAMES.begin() ) ] = weight;
+  }
+  return std::any_of( options.weights.begin(), options.weights.end(), []( int w ) { return w > 0; } );
+}
+
+/**
+ * One simulated client: a private connection to the system bus, so the
+ * daemon sees a distinct sender, and a seeded call sequence so runs repeat.
+ */
+void runClient( int index, const Options &options, Clock::time_point until, ClientResult &result )
+{
+  const QString name = QStringLiteral( "ucc-stress-%1" ).arg( index );
+  {
+    QDBusConnection bus = QDBusConnection::connectToBus( QDBusConnection::SystemBus, name );
+    result.connected = bus.isConnected();
+    if ( !result.connected )
+    {
+      QDBusConnection::disconnectFromBus( name );
+      return;
+    }
+
+    const auto call = [&bus]( const char *method, const QVariantList &args = {} ) {
+      QDBusMessage message = QDBusMessage::createMethodCall( SERVICE, PATH, INTERFACE, method );
+      message.setArguments( args );
+      return bus.call( message );
+    };
+
+    // value the setters write back
+    const QDBusMessage brightness = call( "GetDisplayBrightness" );
+    std::optional< int > current;
+    if ( brightness.type() == QDBusMessage::ReplyMessage && !brightness.arguments().isEmpty() )
+      current = brightness.arguments().first().toInt();
+
+    std::mt19937 rng( static_cast< unsigned >( index ) + 1 );
+    std::discrete_distribution< int > pick( options.weights.begin(), options.weights.end() );
+    std::array< size_t, static_cast< size_t >( CallClass::Count ) > turn {};
+    const auto period =
+      options.rateHz > 0.0
+        ? std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double >( 1.0 / options.rateHz ) )
+        : Clock::duration::zero();
+    // spread the clients over the first period instead of calling in lockstep
+    auto next = Clock::now() + period * index / std::max( options.clients, 1 );
+
+    while ( Clock::now() < until )
+    {
+      if ( period > Clock::duration::zero() )
+      {
+        std::this_thread::sleep_until( next );
+        next += period;
+      }
+
+      const auto cls = static_cast< size_t >( pick( rng ) );
+      const auto &methods = CLASS_METHODS[ cls ];
+      const char *method = methods[ turn[ cls ]++ % methods.size() ];
+      QVariantList args;
+      if ( cls == static_cast< size_t >( CallClass::History ) )
+        args << QVariant::fromValue( static_cast< qlonglong >( QDateTime::currentMSecsSinceEpoch() -
+                                                               qint64( options.historyS ) * 1000 ) );
+      else if ( cls == static_cast< size_t >( CallClass::Setters ) )
+      {
+        if ( !current )
+        {
+          ++result.series[ cls ].failures;
+          continue;
+        }
+        args << *current;
+      }
+
+      const auto t0 = Clock::now();
+      const QDBusMessage reply = call( method, args );
+      result.series[ cls ].ms.push_back( elapsedMs( t0 ) );
+      if ( reply.type() != QDBusMessage::ReplyMessage )
+        ++result.series[ cls ].failures;
+    }
+  }
+  QDBusConnection::disconnectFromBus( name );
+}
+
+// ---------- daemon-side instrumentation ------------------------------------
+
+QJsonObject fetchJSON( const char *method )
+{
+  const QDBusReply< QString > reply = QDBusConnection::systemBus().call(
+    QDBusMessage::createMethodCall( SERVICE, PATH, INTERFACE, method ) );
+  return reply.isValid() ? QJsonDocument::fromJson( reply.value().toUtf8() ).object() : QJsonObject();
+}
+
+struct DaemonSample
+{
+  QJsonObject ipc;
+  QJsonObject workers;
+  QJsonObject fanTrace;
+  std::optional< double > cpuS;  ///< utime + stime of the daemon process
+};
+
+std::optional< uint > daemonPid()
+{
+  const QDBusReply< uint > pid = QDBusConnection::systemBus().interface()->servicePid( SERVICE );
+  return pid.isValid() ? std::optional< uint >( pid.value() ) : std::nullopt;
+}
+
+std::optional< double > processCpuSeconds( std::optional< uint > pid )
+{
+  if ( !pid )
+    return std::nullopt;
+  std::ifstream stat( "/proc/" + std::to_string( *pid ) + "/stat" );
+  std::string line;
+  if ( !std::getline( stat, line ) )
+    return std::nullopt;
+  // fields after the parenthesised command; utime and stime are 14 and 15
+  std::istringstream rest( line.substr( line.rfind( ')' ) + 2 ) );
+  std::string field;
+  unsigned long long utime = 0, stime = 0;
+  for ( int i = 3; i <= 15 && rest >> field; ++i )
+  {
+    if ( i == 14 )
+      utime = std::stoull( field );
+    else if ( i == 15 )
+      stime = std::stoull( field );
+  }
+  return static_cast< double >( utime + stime ) / static_cast< double >( sysconf( _SC_CLK_TCK ) );
+}
+
+DaemonSample sampleDaemon( std::optional< uint > pid )
+{
+  return { fetchJSON( "GetIpcStatsJSON" ), fetchJSON( "GetWorkerStatsJSON" ), fetchJSON( "GetFanTraceJSON" ),
+           processCpuSeconds( pid ) };
+}
+
+QJsonObject findByName( const QJsonArray &entries, const QString &name )
+{
+  for ( const auto &entry : entries )
+    if ( entry.toObject()[ "name" ].toString() == name )
+      return entry.toObject();
+  return {};
+}
+
+/// Histogram of @p after minus @p before, bucket by bucket
+std::vector< double > histogramDelta( const QJsonObject &after, const QJsonObject &before )
+{
+  const QJsonArray a = after[ "histogram" ].toArray(), b = before[ "histogram" ].toArray();
+  std::vector< double > delta;
+  for ( qsizetype i = 0; i < a.size(); ++i )
+    delta.push_back( a[ i ].toDouble() - ( i < b.size() ? b[ i ].toDouble() : 0.0 ) );
+  return delta;
+}
+
+/// Upper bound of the bucket holding quantile @p q; the last (open) bucket reports twice the previous bound
+double histogramQuantile( const std::vector< double > &buckets, const QJsonArray &upper, double q )
+{
+  double total = 0.0;
+  for ( const double count : buckets )
+    total += count;
+  if ( total <= 0.0 || upper.isEmpty() )
+    return 0.0;
+  double seen = 0.0;
+  for ( size_t i = 0; i < buckets.size(); ++i )
+  {
+    seen += buckets[ i ];
+    if ( seen >= q * total )
+      return i < static_cast< size_t >( upper.size() ) ? upper[ static_cast< qsizetype >( i ) ].toDouble()
+                                                       : 2.0 * upper.last().toDouble();
+  }
+  return 2.0 * upper.last().toDouble();
+}
+
+double sum( const std::vector< double > &values )
+{
+  double total = 0.0;
+  for ( const double v : values )
+    total += v;
+  return total;
+}
+
+QJsonObject report( const Options &options, const std::vector< ClientResult > &clients, double wallMs,
+                    const DaemonSample &before, const DaemonSample &after )
+{
+  QJsonObject root;
+  root[ "clients" ] = options.clients;
+  root[ "connected" ] = static_cast< int >( std::count_if( clients.begin(), clients.end(),
+                                                           []( const ClientResult &c ) { return c.connected; } ) );
+  root[ "durationS" ] = wallMs / 1000.0;
+  root[ "rateHz" ] = options.rateHz;
+
+  QJsonArray calls;
+  for ( size_t cls = 0; cls < CLASS_NAMES.size(); ++cls )
+  {
+    Series merged;
+    for ( const auto &client : clients )
+    {
+      const Series &series = client.series[ cls ];
+      merged.ms.insert( merged.ms.end(), series.ms.begin(), series.ms.end() );
+      merged.failures += series.failures;
+    }
+    if ( merged.ms.empty() && merged.failures == 0 )
+      continue;
+    std::sort( merged.ms.begin(), merged.ms.end() );
+    QJsonObject o;
+    o[ "class" ] = CLASS_NAMES[ cls ];
+    o[ "calls" ] = static_cast< qint64 >( merged.ms.size() );
+    o[ "failures" ] = merged.failures;
+    o[ "p50Ms" ] = quantile( merged.ms, 0.50 );
+    o[ "p99Ms" ] = quantile( merged.ms, 0.99 );
+    o[ "maxMs" ] = merged.ms.empty() ? 0.0 : merged.ms.back();
+    o[ "perSecond" ] = 1000.0 * static_cast< double >( merged.ms.size() ) / wallMs;
+    calls.append( o );
+  }
+  root[ "calls" ] = calls;
+
+  // daemon handler latency per method, this run only
+  QJsonArray methods;
+  const QJsonArray ipcUpper = after.ipc[ "histogramUpperUs" ].toArray();
+  for ( const auto &entry : after.ipc[ "methods" ].toArray() )
+  {
+    const QJsonObject a = entry.toObject();
+    const QJsonObject b = findByName( before.ipc[ "methods" ].toArray(), a[ "name" ].toString() );
+    const auto delta = histogramDelta( a, b );
+    const double count = sum( delta );
+    if ( count <= 0.0 )
+      continue;
+    QJsonObject o;
+    o[ "name" ] = a[ "name" ];
+    o[ "calls" ] = count;
+    o[ "p50Us" ] = histogramQuantile( delta, ipcUpper, 0.50 );
+    o[ "p99Us" ] = histogramQuantile( delta, ipcUpper, 0.99 );
+    o[ "maxUs" ] = a[ "maxUs" ];  // since daemon start
+    methods.append( o );
+  }
+  root[ "daemonMethods" ] = methods;
+
+  QJsonArray workers;
+  const QJsonArray workUpper = after.workers[ "histogramUpperMs" ].toArray();
+  for ( const auto &entry : after.workers[ "workers" ].toArray() )
+  {
+    const QJsonObject a = entry.toObject();
+    const QJsonObject b = findByName( before.workers[ "workers" ].toArray(), a[ "name" ].toString() );
+    const double cycles = a[ "cycles" ].toDouble() - b[ "cycles" ].toDouble();
+    const auto delta = histogramDelta( a, b );
+    QJsonObject o;
+    o[ "name" ] = a[ "name" ];
+    o[ "cycles" ] = cycles;
+    o[ "overruns" ] = a[ "overruns" ].toDouble() - b[ "overruns" ].toDouble();
+    o[ "cpuPct" ] = 100.0 * ( a[ "cpuTotalMs" ].toDouble() - b[ "cpuTotalMs" ].toDouble() ) / wallMs;
+    o[ "workP99Ms" ] = histogramQuantile( delta, workUpper, 0.99 );
+    o[ "nominalPeriodMs" ] = a[ "nominalPeriodMs" ];
+    // cycle-weighted averages, so the run's mean period falls out of the two totals
+    if ( cycles > 0.0 && a[ "avgPeriodMs" ].toDouble() >= 0.0 && b[ "avgPeriodMs" ].toDouble() >= 0.0 )
+      o[ "avgPeriodMs" ] = ( a[ "avgPeriodMs" ].toDouble() * a[ "cycles" ].toDouble() -
+                             b[ "avgPeriodMs" ].toDouble() * b[ "cycles" ].toDouble() ) / cycles;
+    o[ "maxLateMs" ] = a[ "maxLateMs" ];  // since daemon start
+    workers.append( o );
+  }
+  root[ "workers" ] = workers;
+
+  QJsonArray stages;
+  const QJsonArray fanUpper = after.fanTrace[ "histogramUpperUs" ].toArray();
+  for ( const auto &entry : after.fanTrace[ "stages" ].toArray() )
+  {
+    const QJsonObject a = entry.toObject();
+    const auto delta = histogramDelta( a, findByName( before.fanTrace[ "stages" ].toArray(), a[ "name" ].toString() ) );
+    if ( sum( delta ) <= 0.0 )
+      continue;
+    QJsonObject o;
+    o[ "name" ] = a[ "name" ];
+    o[ "samples" ] = sum( delta );
+    o[ "p50Us" ] = histogramQuantile( delta, fanUpper, 0.50 );
+    o[ "p99Us" ] = histogramQuantile( delta, fanUpper, 0.99 );
+    stages.append( o );
+  }
+  root[ "fanStages" ] = stages;
+
+  if ( before.cpuS && after.cpuS )
+    root[ "daemonCpuPct" ] = 100.0 * ( *after.cpuS - *before.cpuS ) / ( wallMs / 1000.0 );
+  return root;
+}
+
+void printReport( const QJsonObject &r )
+{
+  std::printf( "=== %d clients (%d connected), %.1f s, %.0f Hz each ===\n", r[ "clients" ].toInt(),
+               r[ "connected" ].toInt(), r[ "durationS" ].toDouble(), r[ "rateHz" ].toDouble() );
+  std::printf( "  %-10s %8s %6s %10s %10s %10s %9s\n", "Class", "Calls", "Fail", "p50", "p99", "Max", "Calls/s" );
+  for ( const auto &entry : r[ "calls" ].toArray() )
+  {
+    const QJsonObject o = entry.toObject();
+    std::printf( "  %-10s %8lld %6d %7.2f ms %7.2f ms %7.2f ms %9.0f\n", qPrintable( o[ "class" ].toString() ),
+                 o[ "calls" ].toInteger(), o[ "failures" ].toInt(), o[ "p50Ms" ].toDouble(), o[ "p99Ms" ].toDouble(),
+                 o[ "maxMs" ].toDouble(), o[ "perSecond" ].toDouble() );
+  }
+
+  std::printf( "\nDaemon handlers (this run)\n  %-34s %8s %10s %10s\n", "Method", "Calls", "p50", "p99" );
+  for ( const auto &entry : r[ "daemonMethods" ].toArray() )
+  {
+    const QJsonObject o = entry.toObject();
+    std::printf( "  %-34s %8.0f %7.0f us %7.0f us\n", qPrintable( o[ "name" ].toString() ), o[ "calls" ].toDouble(),
+                 o[ "p50Us" ].toDouble(), o[ "p99Us" ].toDouble() );
+  }
+
+  std::printf( "\nWorkers (this run; max late since start)\n  %-16s %7s %6s %7s %10s %10s %10s\n", "Worker", "Cycles",
+               "Overr", "CPU", "Work p99", "Period", "Max late" );
+  for ( const auto &entry : r[ "workers" ].toArray() )
+  {
+    const QJsonObject o = entry.toObject();
+    std::printf( "  %-16s %7.0f %6.0f %6.1f%% %7.0f ms", qPrintable( o[ "name" ].toString() ), o[ "cycles" ].toDouble(),
+                 o[ "overruns" ].toDouble(), o[ "cpuPct" ].toDouble(), o[ "workP99Ms" ].toDouble() );
+    if ( o.contains( "avgPeriodMs" ) )
+      std::printf( " %7.1f ms", o[ "avgPeriodMs" ].toDouble() );
+    else
+      std::printf( " %10s", "-" );
+    std::printf( " %7.1f ms\n", o[ "maxLateMs" ].toDouble() );
+  }
+
+  if ( !r[ "fanStages" ].toArray().isEmpty() )
+  {
+    std::printf( "\nFan loop stages (this run)\n  %-24s %8s %10s %10s\n", "Stage", "Samples", "p50", "p99" );
+    for ( const auto &entry : r[ "fanStages" ].toArray() )
+    {
+      const QJsonObject o = entry.toObject();
+      std::printf( "  %-24s %8.0f %7.0f us %7.0f us\n", qPrintable( o[ "name" ].toString() ), o[ "samples" ].toDouble(),
+                   o[ "p50Us" ].toDouble(), o[ "p99Us" ].toDouble() );
+    }
+  }
+
+  if ( r.contains( "daemonCpuPct" ) )
+    std::printf( "\nuccd process CPU: %.1f%%\n", r[ "daemonCpuPct" ].toDouble() );
+}
+
+} // namespace
+
+int main( int argc, char **argv )
+{
+  QCoreApplication app( argc, argv );
+  QCoreApplication::setApplicationName( QStringLiteral( "ucc_dbus_stress" ) );
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription( QStringLiteral( "Concurrent D-Bus clients against uccd" ) );
+  parser.addHelpOption();
+  const QCommandLineOption clientsOpt( { "c", "clients" }, "Concurrent clients (default 8)", "N", "8" );
+  const QCommandLineOption durationOpt( { "d", "duration" }, "Run time in seconds (default 30)", "S", "30" );
+  const QCommandLineOption rateOpt( { "r", "rate" }, "Calls per second per client, 0 = back to back (default 20)",
+                                    "HZ", "20" );
+  const QCommandLineOption mixOpt( "mix", "Call weights, e.g. snapshot=50,history=20,profiles=25,setters=5 "
+                                          "(default: no setters)", "SPEC" );
+  const QCommandLineOption historyOpt( "history", "Seconds GetMonitorDataSince asks for (default 60)", "S", "60" );
+  const QCommandLineOption jsonOpt( "json", "Print one JSON object instead of tables" );
+  parser.addOptions( { clientsOpt, durationOpt, rateOpt, mixOpt, historyOpt, jsonOpt } );
+  parser.process( app );
+
+  Options options;
+  options.clients = std::max( 1, parser.value( clientsOpt ).toInt() );
+  options.durationS = std::max( 1.0, parser.value( durationOpt ).toDouble() );
+  options.rateHz = std::max( 0.0, parser.value( rateOpt ).toDouble() );
+  options.historyS = std::max( 1, parser.value( historyOpt ).toInt() );
+  options.json = parser.isSet( jsonOpt );
+  if ( parser.isSet( mixOpt ) && !parseMix( parser.value( mixOpt ), options ) )
+  {
+    std::fprintf( stderr, "ucc_dbus_stress: bad --mix '%s'\n", qPrintable( parser.value( mixOpt ) ) );
+    return 2;
+  }
+
+  if ( !QDBusConnection::systemBus().interface()->isServiceRegistered( SERVICE ) )
+  {
+    std::fprintf( stderr, "ucc_dbus_stress: %s is not on the system bus\n", SERVICE );
+    return 1;
+  }
+
+  const auto pid = daemonPid();
+  const DaemonSample before = sampleDaemon( pid );
+
+  std::vector< ClientResult > results( static_cast< size_t >( options.clients ) );
+  std::vector< std::thread > threads;
+  const auto start = Clock::now();
+  const auto until =
+    start + std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double >( options.durationS ) );
+  for ( int i = 0; i < options.clients; ++i )
+    threads.emplace_back( runClient, i, std::cref( options ), until, std::ref( results[ static_cast< size_t >( i ) ] ) );
+  for ( auto &thread : threads )
+    thread.join();
+  const double wallMs = elapsedMs( start );
+
+  const QJsonObject r = report( options, results, wallMs, before, sampleDaemon( pid ) );
+  if ( options.json )
+    std::puts( QJsonDocument( r ).toJson( QJsonDocument::Compact ).constData() );
+  else
+    printReport( r );
+  return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * Unit tests for AdaptiveEppGovernor – bursts and load raising the level,
+ * the hold before it falls, and the battery and power-limit ceilings.
+ */
+
+#include <QTest>
+#include "AdaptiveEppGovernor.hpp"
+
+class TestAdaptiveEppGovernor : public QObject
+{
+  Q_OBJECT
+
+private:
+  static constexpr int64_t HOLD = AdaptiveEppGovernor::LOWER_HOLD_MS;
+
+  static AdaptiveEppSample load( double avg, double peak, bool onBattery = false, bool powerLimited = false )
+  {
+    return AdaptiveEppSample{ avg, peak, onBattery, powerLimited };
+  }
+
+private slots:
+
+  void oneLevelIsOff()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 1 );
+    QVERIFY( !g.enabled() );
+    QVERIFY( !g.update( 0, load( 1.0, 1.0 ) ) );
+  }
+
+  void burstGoesStraightToTheTop()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 3 );
+    QCOMPARE( g.level(), size_t( 0 ) );
+    QVERIFY( !g.update( 0, load( 0.1, 0.3 ) ) );
+    QVERIFY( g.update( 1000, load( 0.15, 0.9 ) ) );
+    QCOMPARE( g.level(), size_t( 2 ) );
+  }
+
+  void averageLoadStepsUp()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 3 );
+    QVERIFY( g.update( 0, load( 0.6, 0.7 ) ) );
+    QCOMPARE( g.level(), size_t( 1 ) );
+    QVERIFY( g.update( 1000, load( 0.6, 0.7 ) ) );
+    QCOMPARE( g.level(), size_t( 2 ) );
+    QVERIFY( !g.update( 2000, load( 0.6, 0.7 ) ) );
+  }
+
+  void fallsOneLevelPerHold()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 3 );
+    g.update( 0, load( 1.0, 1.0 ) );
+    QCOMPARE( g.level(), size_t( 2 ) );
+
+    QVERIFY( !g.update( 1000, load( 0.05, 0.1 ) ) );
+    QVERIFY( !g.update( 1000 + HOLD - 1, load( 0.05, 0.1 ) ) );
+    QVERIFY( g.update( 1000 + HOLD, load( 0.05, 0.1 ) ) );
+    QCOMPARE( g.level(), size_t( 1 ) );
+
+    // the hold starts over after each step
+    QVERIFY( !g.update( 2000 + HOLD, load( 0.05, 0.1 ) ) );
+    QVERIFY( g.update( 2000 + 2 * HOLD, load( 0.05, 0.1 ) ) );
+    QCOMPARE( g.level(), size_t( 0 ) );
+  }
+
+  void moderateLoadHoldsTheLevel()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 3 );
+    g.update( 0, load( 1.0, 1.0 ) );
+    // neither light on average nor on the busiest core
+    QVERIFY( !g.update( 1000, load( 0.3, 0.4 ) ) );
+    QVERIFY( !g.update( 1000 + 10 * HOLD, load( 0.1, 0.6 ) ) );
+    QCOMPARE( g.level(), size_t( 2 ) );
+  }
+
+  void batteryLeavesOutTheTopLevel()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 3 );
+    QVERIFY( g.update( 0, load( 1.0, 1.0, true ) ) );
+    QCOMPARE( g.level(), size_t( 1 ) );
+
+    // plugged in: up; unplugged again: down at once
+    QVERIFY( g.update( 1000, load( 1.0, 1.0 ) ) );
+    QCOMPARE( g.level(), size_t( 2 ) );
+    QVERIFY( g.update( 2000, load( 1.0, 1.0, true ) ) );
+    QCOMPARE( g.level(), size_t( 1 ) );
+
+    // with only two levels both stay usable
+    g.configure( 2 );
+    QVERIFY( g.update( 3000, load( 1.0, 1.0, true ) ) );
+    QCOMPARE( g.level(), size_t( 1 ) );
+  }
+
+  void powerLimitBlocksRaising()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 3 );
+    g.update( 0, load( 0.6, 0.6 ) );
+    QCOMPARE( g.level(), size_t( 1 ) );
+    QVERIFY( !g.update( 1000, load( 1.0, 1.0, false, true ) ) );
+    QCOMPARE( g.level(), size_t( 1 ) );
+    QVERIFY( g.update( 2000, load( 1.0, 1.0 ) ) );
+    QCOMPARE( g.level(), size_t( 2 ) );
+  }
+
+  void reconfigureStartsLow()
+  {
+    AdaptiveEppGovernor g;
+    g.configure( 3 );
+    g.update( 0, load( 1.0, 1.0 ) );
+    g.configure( 3 );
+    QCOMPARE( g.level(), size_t( 2 ) );
+    g.configure( 4 );
+    QCOMPARE( g.level(), size_t( 0 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestAdaptiveEppGovernor )
+#include "test_adaptive_epp_governor.moc"
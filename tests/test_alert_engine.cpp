@@ -0,0 +1,261 @@
+/*
+ * Unit tests for AlertEngine – duration and hysteresis of threshold rules,
+ * rate-of-change rules, rule replacement and the store hookup.
+ */
+
+#include <QTest>
+#include "AlertEngine.hpp"
+#include "MetricsHistoryStore.hpp"
+
+class TestAlertEngine : public QObject
+{
+  Q_OBJECT
+
+private:
+  struct Recorder
+  {
+    std::vector< AlertEngine::Event > events;
+    AlertEngine::Notify notify()
+    {
+      return [ this ]( const AlertEngine::Event &event ) { events.push_back( event ); };
+    }
+  };
+
+  static AlertRule rule( const char *id, const char *metric, const char *condition, double threshold,
+                         int forSeconds = 0, double hysteresis = 0.0 )
+  {
+    return AlertRule{ id, metric, condition, threshold, forSeconds, hysteresis };
+  }
+
+private slots:
+
+  void validateRejectsBadRules()
+  {
+    const MetricRegistry registry;
+    QVERIFY( !AlertEngine::validate( rule( "hot", "gpuTemp", "above", 87.0, 30 ), registry ) );
+    QVERIFY( AlertEngine::validate( rule( "", "gpuTemp", "above", 87.0 ), registry ) );
+    QVERIFY( AlertEngine::validate( rule( "hot", "noSuchMetric", "above", 87.0 ), registry ) );
+    QVERIFY( AlertEngine::validate( rule( "hot", "gpuTemp", "sideways", 87.0 ), registry ) );
+    QVERIFY( AlertEngine::validate( rule( "hot", "gpuTemp", "above", 87.0, -1 ), registry ) );
+    QVERIFY( AlertEngine::validate( rule( "hot", "gpuTemp", "above", 87.0, 0, -2.0 ), registry ) );
+  }
+
+  void aboveRaisesAfterTheDuration()
+  {
+    const MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    QCOMPARE( engine.setRules( { rule( "hot", "gpuTemp", "above", 87.0, 30 ) }, registry ), size_t( 1 ) );
+
+    engine.observe( MetricId::GpuTemp, 0, 90.0 );
+    engine.observe( MetricId::GpuTemp, 29'999, 91.0 );
+    QVERIFY( rec.events.empty() );
+    engine.observe( MetricId::GpuTemp, 30'000, 92.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    QVERIFY( rec.events[ 0 ].raised );
+    QCOMPARE( rec.events[ 0 ].ruleId, std::string( "hot" ) );
+    QCOMPARE( rec.events[ 0 ].metric, std::string( "gpuTemp" ) );
+    QCOMPARE( rec.events[ 0 ].value, 92.0 );
+    QCOMPARE( rec.events[ 0 ].timestampMs, int64_t( 30'000 ) );
+
+    // raised once, not per sample
+    engine.observe( MetricId::GpuTemp, 31'000, 93.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    QCOMPARE( engine.activeCount(), size_t( 1 ) );
+
+    engine.observe( MetricId::GpuTemp, 32'000, 80.0 );
+    QCOMPARE( rec.events.size(), size_t( 2 ) );
+    QVERIFY( !rec.events[ 1 ].raised );
+    QCOMPARE( engine.activeCount(), size_t( 0 ) );
+  }
+
+  void dipRestartsTheDuration()
+  {
+    const MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    engine.setRules( { rule( "fan", "cpuFanDuty", "above", 99.0, 120 ) }, registry );
+
+    engine.observe( MetricId::CpuFanDuty, 0, 100.0 );
+    engine.observe( MetricId::CpuFanDuty, 100'000, 60.0 );
+    engine.observe( MetricId::CpuFanDuty, 110'000, 100.0 );
+    engine.observe( MetricId::CpuFanDuty, 200'000, 100.0 );
+    QVERIFY( rec.events.empty() );
+    engine.observe( MetricId::CpuFanDuty, 230'000, 100.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+  }
+
+  void hysteresisDelaysTheClear()
+  {
+    const MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    engine.setRules( { rule( "low", "batCapacity", "below", 10.0, 0, 2.0 ) }, registry );
+
+    engine.observe( MetricId::BatteryCapacity, 0, 9.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    engine.observe( MetricId::BatteryCapacity, 1000, 11.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    engine.observe( MetricId::BatteryCapacity, 2000, 12.0 );
+    QCOMPARE( rec.events.size(), size_t( 2 ) );
+    QVERIFY( !rec.events[ 1 ].raised );
+  }
+
+  void risingComparesTheRateOverTheWindow()
+  {
+    const MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    engine.setRules( { rule( "spike", "cpuTemp", "rising", 2.0, 5 ) }, registry );
+
+    // 1 °C/s for 5 s, then 3 °C/s: raised once the 5 s window averages 2 °C/s
+    for ( int64_t t = 0; t <= 5000; t += 1000 )
+      engine.observe( MetricId::CpuTemp, t, 50.0 + static_cast< double >( t ) / 1000 );
+    engine.observe( MetricId::CpuTemp, 6000, 58.0 );  // 7 °C in 5 s
+    engine.observe( MetricId::CpuTemp, 7000, 61.0 );  // 9 °C
+    QVERIFY( rec.events.empty() );
+    engine.observe( MetricId::CpuTemp, 8000, 64.0 );  // 11 °C
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    QVERIFY( rec.events[ 0 ].raised );
+    QCOMPARE( rec.events[ 0 ].value, 2.2 );
+    engine.observe( MetricId::CpuTemp, 9000, 67.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+
+    // flat again: cleared once the window's rate drops below the threshold
+    engine.observe( MetricId::CpuTemp, 10'000, 67.0 );  // 12 °C in 5 s
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    engine.observe( MetricId::CpuTemp, 11'000, 67.0 );  // 9 °C
+    QCOMPARE( rec.events.size(), size_t( 2 ) );
+    QVERIFY( !rec.events[ 1 ].raised );
+  }
+
+  void fallingUsesThePositiveRate()
+  {
+    const MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    engine.setRules( { rule( "drain", "batEnergy", "falling", 0.5, 2 ) }, registry );
+
+    engine.observe( MetricId::BatteryEnergy, 0, 50.0 );
+    engine.observe( MetricId::BatteryEnergy, 1000, 49.0 );
+    QVERIFY( rec.events.empty() );
+    engine.observe( MetricId::BatteryEnergy, 2000, 48.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    QCOMPARE( rec.events[ 0 ].value, 1.0 );
+  }
+
+  void denseSamplesFitTheRateWindow()
+  {
+    const MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    engine.setRules( { rule( "spike", "cpuTemp", "rising", 1.5, 2 ) }, registry );
+
+    // 2 °C/s sampled every millisecond: far more samples than the window keeps
+    for ( int64_t t = 0; t < 2000; ++t )
+      engine.observe( MetricId::CpuTemp, t, 50.0 + static_cast< double >( t ) / 500 );
+    QVERIFY( rec.events.empty() );
+    engine.observe( MetricId::CpuTemp, 2000, 54.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    QCOMPARE( rec.events[ 0 ].value, 2.0 );
+
+    // flat for a whole window: the rate over the window drops to 0
+    for ( int64_t t = 2001; t <= 4000; ++t )
+      engine.observe( MetricId::CpuTemp, t, 54.0 );
+    QCOMPARE( rec.events.size(), size_t( 2 ) );
+    QVERIFY( !rec.events[ 1 ].raised );
+  }
+
+  void replacingRulesKeepsOrClearsState()
+  {
+    const MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    const AlertRule hot = rule( "hot", "gpuTemp", "above", 87.0 );
+    engine.setRules( { hot }, registry );
+    engine.observe( MetricId::GpuTemp, 0, 90.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+
+    // unchanged: stays raised without a second signal
+    engine.setRules( { rule( "cold", "gpuTemp", "below", 20.0 ), hot }, registry );
+    engine.observe( MetricId::GpuTemp, 1000, 91.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+
+    // removed while raised: cleared
+    engine.setRules( {}, registry );
+    QCOMPARE( rec.events.size(), size_t( 2 ) );
+    QVERIFY( !rec.events[ 1 ].raised );
+    QCOMPARE( rec.events[ 1 ].ruleId, std::string( "hot" ) );
+  }
+
+  void invalidRulesAreSkipped()
+  {
+    const MetricRegistry registry;
+    AlertEngine engine;
+    QCOMPARE( engine.setRules( { rule( "a", "gpuTemp", "above", 1.0 ), rule( "b", "nope", "above", 1.0 ) },
+                               registry ), size_t( 1 ) );
+  }
+
+  void rulesOnLaterMetricsAreArmedOnRegistration()
+  {
+    MetricRegistry registry;
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    QCOMPARE( engine.setRules( { rule( "hot", "gpuTemp", "above", 87.0 ), rule( "fan3", "fan3Duty", "above", 90.0 ) },
+                               registry ), size_t( 1 ) );
+    QCOMPARE( engine.metricsRegistered( registry ), size_t( 1 ) );
+
+    // the fan shows up with its first sample
+    const auto duty = registry.add( "fan3Duty", "%", "duty" );
+    QVERIFY( duty.has_value() );
+    QCOMPARE( engine.metricsRegistered( registry ), size_t( 2 ) );
+    engine.observe( *duty, 1000, 95.0 );
+    QCOMPARE( rec.events.size(), size_t( 1 ) );
+    QCOMPARE( rec.events[ 0 ].ruleId, std::string( "fan3" ) );
+
+    // nothing waits any more: the raised alert keeps its state
+    QCOMPARE( engine.metricsRegistered( registry ), size_t( 2 ) );
+    QCOMPARE( engine.activeCount(), size_t( 1 ) );
+  }
+
+  void activeJSONListsRaisedAlerts()
+  {
+    const MetricRegistry registry;
+    AlertEngine engine;
+    engine.setRules( { rule( "hot", "gpuTemp", "above", 87.0 ), rule( "low", "batCapacity", "below", 5.0 ) },
+                     registry );
+    engine.observe( MetricId::GpuTemp, 1000, 90.5 );
+
+    std::string json;
+    engine.activeJSON( json );
+    QCOMPARE( json, std::string( "[{\"id\":\"hot\",\"metric\":\"gpuTemp\",\"value\":90.50,\"since\":1000}]" ) );
+  }
+
+  void storeFeedsPushesAndFrames()
+  {
+    Recorder rec;
+    AlertEngine engine( rec.notify() );
+    MetricsHistoryStore store( 16 );
+    store.setAlertEngine( &engine );
+    engine.setRules( { rule( "hot", "gpuTemp", "above", 87.0 ), rule( "fast", "cpuFanDuty", "above", 90.0 ) },
+                     store.registry() );
+
+    store.push( MetricId::GpuTemp, 1000, 88.0 );
+    MetricFrame frame;
+    frame.add( MetricId::CpuTemp, 60.0 );
+    frame.add( MetricId::CpuFanDuty, 95.0 );
+    store.pushFrame( 2000, frame );
+
+    QCOMPARE( rec.events.size(), size_t( 2 ) );
+    QCOMPARE( rec.events[ 0 ].ruleId, std::string( "hot" ) );
+    QCOMPARE( rec.events[ 1 ].ruleId, std::string( "fast" ) );
+    QCOMPARE( rec.events[ 1 ].timestampMs, int64_t( 2000 ) );
+
+    store.setAlertEngine( nullptr );
+    store.push( MetricId::GpuTemp, 3000, 20.0 );
+    QCOMPARE( rec.events.size(), size_t( 2 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestAlertEngine )
+#include "test_alert_engine.moc"
@@ -0,0 +1,158 @@
+/*
+ * Unit tests for the amdgpu gpu_metrics decoder.
+ */
+
+#include <QTest>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "AmdGpuMetrics.hpp"
+
+class TestAmdGpuMetrics : public QObject
+{
+  Q_OBJECT
+
+private:
+  /// Zeroed table with a valid header
+  static std::vector< uint8_t > table( size_t size, uint8_t format, uint8_t content )
+  {
+    std::vector< uint8_t > t( size, 0 );
+    const uint16_t structureSize = static_cast< uint16_t >( size );
+    std::memcpy( t.data(), &structureSize, sizeof( structureSize ) );
+    t[ 2 ] = format;
+    t[ 3 ] = content;
+    return t;
+  }
+
+  template< typename T >
+  static void put( std::vector< uint8_t > &t, size_t offset, T value )
+  {
+    std::memcpy( t.data() + offset, &value, sizeof( value ) );
+  }
+
+private slots:
+
+  void dGpuV13()
+  {
+    auto t = table( 120, 1, 3 );
+    put< uint16_t >( t, 4, 52 );     // temperature_edge
+    put< uint16_t >( t, 6, 61 );     // temperature_hotspot
+    put< uint16_t >( t, 16, 87 );    // average_gfx_activity
+    put< uint16_t >( t, 18, 12 );    // average_umc_activity
+    put< uint16_t >( t, 22, 95 );    // average_socket_power
+    put< uint16_t >( t, 40, 2400 );  // average_gfxclk_frequency
+    put< uint16_t >( t, 54, 2450 );  // current_gfxclk
+    put< uint16_t >( t, 58, 1124 );  // current_uclk
+    put< uint32_t >( t, 68, 0x4 );   // throttle_status
+
+    const auto m = AmdGpuMetricsDecoder::decode( t.data(), t.size() );
+    QVERIFY( m.has_value() );
+    QCOMPARE( m->temperatureC, 52.0 );
+    QCOMPARE( m->hotspotC, 61.0 );
+    QCOMPARE( m->gfxActivityPct, 87.0 );
+    QCOMPARE( m->memActivityPct, 12.0 );
+    QCOMPARE( m->socketPowerW, 95.0 );
+    QCOMPARE( m->gfxClockMHz, 2450.0 );
+    QCOMPARE( m->memClockMHz, 1124.0 );
+    QCOMPARE( m->throttleStatus, int64_t( 4 ) );
+    QVERIFY( m->cpuCoreClockMHz.empty() );
+  }
+
+  void dGpuV10TimestampFirst()
+  {
+    auto t = table( 80, 1, 0 );
+    put< uint16_t >( t, 16, 48 );    // temperature_edge
+    put< uint16_t >( t, 34, 30 );    // average_socket_power
+    put< uint16_t >( t, 54, 800 );
+    const auto m = AmdGpuMetricsDecoder::decode( t.data(), t.size() );
+    QVERIFY( m.has_value() );
+    QCOMPARE( m->temperatureC, 48.0 );
+    QCOMPARE( m->socketPowerW, 30.0 );
+    QCOMPARE( m->gfxClockMHz, 800.0 );
+  }
+
+  void apuV21CentiDegreesAndMilliwatts()
+  {
+    auto t = table( 136, 2, 1 );
+    put< uint16_t >( t, 4, 4525 );      // temperature_gfx (centi-°C)
+    put< uint16_t >( t, 28, 33 );       // average_gfx_activity
+    put< uint16_t >( t, 40, 15250 );    // average_socket_power (mW)
+    put< uint16_t >( t, 64, 1600 );     // average_gfxclk_frequency
+    put< uint16_t >( t, 76, 0xFFFF );   // current_gfxclk unsupported
+    for ( size_t i = 0; i < 8; ++i )
+      put< uint16_t >( t, 88 + i * 2, static_cast< uint16_t >( 3000 + i ) );
+    put< uint32_t >( t, 108, 0 );
+
+    const auto m = AmdGpuMetricsDecoder::decode( t.data(), t.size() );
+    QVERIFY( m.has_value() );
+    QCOMPARE( m->temperatureC, 45.25 );
+    QCOMPARE( m->socketPowerW, 15.25 );
+    QCOMPARE( m->gfxClockMHz, 1600.0 );
+    QCOMPARE( m->cpuCoreClockMHz.size(), size_t( 8 ) );
+    QCOMPARE( m->cpuCoreClockMHz[ 7 ], 3007.0 );
+    QCOMPARE( m->throttleStatus, int64_t( 0 ) );
+    QCOMPARE( m->hotspotC, -1.0 );
+  }
+
+  void apuV20ShiftedLayout()
+  {
+    auto t = table( 120, 2, 0 );
+    put< uint16_t >( t, 16, 5000 );     // temperature_gfx
+    put< uint16_t >( t, 80, 1800 );     // current_gfxclk
+    put< uint32_t >( t, 112, 0x10 );    // throttle_status
+    const auto m = AmdGpuMetricsDecoder::decode( t.data(), t.size() );
+    QVERIFY( m.has_value() );
+    QCOMPARE( m->temperatureC, 50.0 );
+    QCOMPARE( m->gfxClockMHz, 1800.0 );
+    QCOMPARE( m->throttleStatus, int64_t( 0x10 ) );
+  }
+
+  void apuV30()
+  {
+    auto t = table( 256, 3, 0 );
+    put< uint16_t >( t, 4, 6100 );
+    put< uint32_t >( t, 112, 28000 );   // average_socket_power (mW)
+    put< uint16_t >( t, 172, 2100 );    // average_gfxclk_frequency
+    put< uint16_t >( t, 188, 4800 );    // current_coreclk[0]
+    put< uint16_t >( t, 222, 2900 );    // current_gfx_maxfreq
+    const auto m = AmdGpuMetricsDecoder::decode( t.data(), t.size() );
+    QVERIFY( m.has_value() );
+    QCOMPARE( m->temperatureC, 61.0 );
+    QCOMPARE( m->socketPowerW, 28.0 );
+    QCOMPARE( m->gfxClockMHz, 2100.0 );
+    QCOMPARE( m->gfxMaxClockMHz, 2900.0 );
+    QCOMPARE( m->cpuCoreClockMHz.size(), size_t( 16 ) );
+    QCOMPARE( m->cpuCoreClockMHz[ 0 ], 4800.0 );
+    QCOMPARE( m->throttleStatus, int64_t( -1 ) );
+  }
+
+  void rejectsUnknownAndTruncatedTables()
+  {
+    auto mi300 = table( 1024, 1, 5 );
+    QVERIFY( !AmdGpuMetricsDecoder::decode( mi300.data(), mi300.size() ).has_value() );
+
+    auto v4 = table( 256, 4, 0 );
+    QVERIFY( !AmdGpuMetricsDecoder::decode( v4.data(), v4.size() ).has_value() );
+
+    auto apu = table( 136, 2, 1 );
+    QVERIFY( !AmdGpuMetricsDecoder::decode( apu.data(), 64 ).has_value() );
+
+    // structure_size smaller than the read
+    auto shortHeader = table( 136, 2, 1 );
+    put< uint16_t >( shortHeader, 0, 32 );
+    QVERIFY( !AmdGpuMetricsDecoder::decode( shortHeader.data(), shortHeader.size() ).has_value() );
+
+    QVERIFY( !AmdGpuMetricsDecoder::decode( nullptr, 0 ).has_value() );
+  }
+
+  void dpmTableMaximum()
+  {
+    QCOMPARE( AmdGpuMetricsDecoder::parseDpmMaxMHz( "0: 400Mhz\n1: 1200Mhz *\n2: 2200Mhz\n" ), 2200.0 );
+    QCOMPARE( AmdGpuMetricsDecoder::parseDpmMaxMHz( "0: 800Mhz *\n" ), 800.0 );
+    QCOMPARE( AmdGpuMetricsDecoder::parseDpmMaxMHz( "" ), -1.0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestAmdGpuMetrics )
+
+#include "test_amd_gpu_metrics.moc"
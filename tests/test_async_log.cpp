@@ -0,0 +1,181 @@
+/*
+ * Unit tests for AsyncLog – order per thread, dropping instead of blocking
+ * behind a stalled sink, rate limiting of repeated lines and several
+ * posting threads.
+ */
+
+#include <QTest>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsyncLog.hpp"
+
+using ucc::AsyncLog;
+using ucc::LogTarget;
+
+namespace
+{
+/// Records what reaches the sink; can hold the writer like a stalled journald
+struct RecordingSink
+{
+  std::mutex mutex;
+  std::condition_variable released;
+  bool stalled = false;
+  std::vector< std::string > lines;
+  std::vector< LogTarget > targets;
+
+  AsyncLog::Sink sink()
+  {
+    return [this]( LogTarget target, int, std::string_view text ) {
+      std::unique_lock< std::mutex > lock( mutex );
+      released.wait( lock, [this] { return not stalled; } );
+      lines.emplace_back( text );
+      targets.push_back( target );
+    };
+  }
+
+  void release()
+  {
+    {
+      std::lock_guard< std::mutex > lock( mutex );
+      stalled = false;
+    }
+    released.notify_all();
+  }
+
+  std::vector< std::string > snapshot()
+  {
+    std::lock_guard< std::mutex > lock( mutex );
+    return lines;
+  }
+};
+}
+
+class TestAsyncLog : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void linesOfOneThreadKeepTheirOrder()
+  {
+    RecordingSink sink;
+    AsyncLog log( sink.sink() );
+    for ( int i = 0; i < 50; ++i )
+      QVERIFY( log.post( LogTarget::Syslog, LOG_INFO, "line " + std::to_string( i ) ) );
+    QVERIFY( log.post( LogTarget::Stderr, LOG_ERR, "failed" ) );
+    log.flush();
+
+    const auto lines = sink.snapshot();
+    QCOMPARE( lines.size(), size_t( 51 ) );
+    for ( int i = 0; i < 50; ++i )
+      QCOMPARE( lines[ i ], "line " + std::to_string( i ) );
+    QCOMPARE( sink.targets.back(), LogTarget::Stderr );
+  }
+
+  void stalledSinkDropsInsteadOfBlocking()
+  {
+    RecordingSink sink;
+    sink.stalled = true;
+    AsyncLog log( sink.sink(), AsyncLog::Options{ 16, 10'000, 1000 } );
+
+    int accepted = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < 100; ++i )
+      accepted += log.post( LogTarget::Syslog, LOG_INFO, "line " + std::to_string( i ) ) ? 1 : 0;
+    QVERIFY( std::chrono::steady_clock::now() - start < std::chrono::seconds( 1 ) );
+    // the ring holds 16; the writer may have taken one before it stalled
+    QVERIFY( accepted >= 16 && accepted <= 17 );
+
+    sink.release();
+    log.flush();
+    const auto lines = sink.snapshot();
+    QCOMPARE( lines.size(), size_t( accepted + 1 ) );
+    QCOMPARE( lines.front(), std::string( "line 0" ) );
+    QCOMPARE( lines.back(), "[AsyncLog] Dropped " + std::to_string( 100 - accepted ) + " log messages (queue full)" );
+  }
+
+  void repeatedLinesAreRateLimited()
+  {
+    RecordingSink sink;
+    std::atomic< int64_t > now{ 0 };
+    AsyncLog log( sink.sink(), AsyncLog::Options{ 128, 10'000, 3 }, [&now] { return now.load(); } );
+
+    for ( int i = 0; i < 10; ++i )
+      log.post( LogTarget::Stderr, LOG_ERR, "[KeyboardBacklight] Failed to set brightness to 3" );
+    log.post( LogTarget::Stderr, LOG_ERR, "other" );
+    log.flush();
+    QCOMPARE( sink.snapshot().size(), size_t( 4 ) );
+
+    // the window ends: the rest is summed up, and the line passes again
+    now = 10'000;
+    log.post( LogTarget::Stderr, LOG_ERR, "[KeyboardBacklight] Failed to set brightness to 3" );
+    log.flush();
+    const auto lines = sink.snapshot();
+    QCOMPARE( lines.size(), size_t( 6 ) );
+    QCOMPARE( lines[ 4 ], std::string( "[KeyboardBacklight] Failed to set brightness to 3 (repeated 7 more times)" ) );
+    QCOMPARE( lines[ 5 ], std::string( "[KeyboardBacklight] Failed to set brightness to 3" ) );
+  }
+
+  void summaryIsWrittenWithoutANewLine()
+  {
+    RecordingSink sink;
+    std::atomic< int64_t > now{ 0 };
+    {
+      AsyncLog log( sink.sink(), AsyncLog::Options{ 128, 10'000, 1 }, [&now] { return now.load(); } );
+      for ( int i = 0; i < 3; ++i )
+        log.post( LogTarget::Syslog, LOG_INFO, "tick" );
+      log.flush();
+      QCOMPARE( sink.snapshot().size(), size_t( 1 ) );
+
+      // the writer checks the window on its own
+      now = 10'000;
+      for ( int i = 0; i < 50 && sink.snapshot().size() < 2; ++i )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+      QCOMPARE( sink.snapshot().back(), std::string( "tick (repeated 2 more times)" ) );
+    }
+    QCOMPARE( sink.snapshot().size(), size_t( 2 ) );
+  }
+
+  void longLinesAreCut()
+  {
+    RecordingSink sink;
+    AsyncLog log( sink.sink() );
+    log.post( LogTarget::Syslog, LOG_INFO, std::string( AsyncLog::SLOT_TEXT + 100, 'x' ) );
+    log.flush();
+    QCOMPARE( sink.snapshot().front(), std::string( AsyncLog::SLOT_TEXT, 'x' ) );
+  }
+
+  void threadsPostConcurrently()
+  {
+    RecordingSink sink;
+    std::vector< std::string > expected;
+    {
+      AsyncLog log( sink.sink(), AsyncLog::Options{ 1024, 10'000, 1000 } );
+      std::vector< std::thread > threads;
+      for ( int t = 0; t < 4; ++t )
+        threads.emplace_back( [&log, t] {
+          for ( int i = 0; i < 200; ++i )
+            log.post( LogTarget::Syslog, LOG_INFO, std::to_string( t ) + ":" + std::to_string( i ) );
+        } );
+      for ( auto &thread : threads )
+        thread.join();
+      // lines of exited threads are still written
+    }
+
+    const auto lines = sink.snapshot();
+    QCOMPARE( lines.size(), size_t( 800 ) );
+    std::vector< int > next( 4, 0 );
+    for ( const std::string &line : lines )
+    {
+      const int t = line[ 0 ] - '0';
+      QCOMPARE( line, std::to_string( t ) + ":" + std::to_string( next[ t ]++ ) );
+    }
+  }
+};
+
+QTEST_GUILESS_MAIN( TestAsyncLog )
+#include "test_async_log.moc"
@@ -0,0 +1,63 @@
+/*
+ * Unit tests for AuthDecisionCache – Polkit grant lookup, expiry and
+ * per-sender invalidation.
+ */
+
+#include <QTest>
+#include "AuthDecisionCache.hpp"
+
+class TestAuthDecisionCache : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void grantHoldsForTtl()
+  {
+    AuthDecisionCache cache;
+    QVERIFY( !cache.allowed( ":1.5", 100, "control", 1000 ) );
+    cache.grant( ":1.5", 100, "control", 1000 );
+    QVERIFY( cache.allowed( ":1.5", 100, "control", 1000 ) );
+    QVERIFY( cache.allowed( ":1.5", 100, "control", 1000 + AuthDecisionCache::TTL_MS - 1 ) );
+    QVERIFY( !cache.allowed( ":1.5", 100, "control", 1000 + AuthDecisionCache::TTL_MS ) );
+    QCOMPARE( cache.grants(), size_t( 0 ) );
+  }
+
+  void keyIncludesActionAndProcess()
+  {
+    AuthDecisionCache cache;
+    cache.grant( ":1.5", 100, "control", 1000 );
+    QVERIFY( !cache.allowed( ":1.5", 100, "manage-hardware", 1000 ) );
+    QVERIFY( !cache.allowed( ":1.5", 101, "control", 1000 ) );
+    QVERIFY( !cache.allowed( ":1.6", 100, "control", 1000 ) );
+  }
+
+  void clockGoingBackwardsExpires()
+  {
+    AuthDecisionCache cache;
+    cache.grant( ":1.5", 100, "control", 5000 );
+    QVERIFY( !cache.allowed( ":1.5", 100, "control", 4000 ) );
+  }
+
+  void forgetSenderDropsOnlyThatSender()
+  {
+    AuthDecisionCache cache;
+    cache.setPid( ":1.5", 42 );
+    cache.setPid( ":1.50", 43 );
+    cache.grant( ":1.5", 100, "control", 1000 );
+    cache.grant( ":1.5", 100, "manage-hardware", 1000 );
+    cache.grant( ":1.50", 100, "control", 1000 );
+
+    cache.forgetSender( ":1.5" );
+    QVERIFY( !cache.knowsSender( ":1.5" ) );
+    QVERIFY( !cache.pid( ":1.5" ) );
+    QVERIFY( !cache.allowed( ":1.5", 100, "control", 1000 ) );
+    QCOMPARE( cache.pid( ":1.50" ).value_or( 0 ), uint32_t( 43 ) );
+    QVERIFY( cache.allowed( ":1.50", 100, "control", 1000 ) );
+    QCOMPARE( cache.grants(), size_t( 1 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestAuthDecisionCache )
+
+#include "test_auth_decision_cache.moc"
@@ -0,0 +1,138 @@
+/*
+ * Unit tests for BatterySampler (unit conversion, energy / charge drivers).
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "BatterySampler.hpp"
+
+class TestBatterySampler : public QObject
+{
+  Q_OBJECT
+
+private:
+  static void file( const std::filesystem::path &path, const std::string &content )
+  {
+    std::filesystem::create_directories( path.parent_path() );
+    std::ofstream( path, std::ios::trunc ) << content;
+  }
+
+  static bool near( double a, double b ) { return std::fabs( a - b ) < 1e-6; }
+
+private slots:
+
+  void powerAndEnergyDriver()
+  {
+    BatterySampler::Readings r;
+    r.powerNow = 12'500'000;
+    r.voltageNow = 12'000'000;
+    r.energyNow = 50'000'000;
+    r.capacity = 80;
+    r.discharging = true;
+
+    const auto m = BatterySampler::compute( r );
+    QVERIFY( near( m.powerW, 12.5 ) );
+    QVERIFY( near( m.voltageV, 12.0 ) );
+    QVERIFY( near( m.energyWh, 50.0 ) );
+    QVERIFY( near( m.capacityPct, 80.0 ) );
+    QVERIFY( near( m.timeToEmptyMin, 240.0 ) );
+    QVERIFY( near( m.systemPowerW, 12.5 ) );
+  }
+
+  void currentAndChargeDriver()
+  {
+    // some drivers report the discharge current as negative
+    BatterySampler::Readings r;
+    r.currentNow = -1'500'000;
+    r.voltageNow = 15'000'000;
+    r.chargeNow = 4'000'000;
+    r.discharging = true;
+
+    const auto m = BatterySampler::compute( r );
+    QVERIFY( near( m.powerW, 22.5 ) );
+    QVERIFY( near( m.energyWh, 60.0 ) );
+    QVERIFY( near( m.timeToEmptyMin, 160.0 ) );
+    QCOMPARE( m.capacityPct, -1.0 );
+  }
+
+  void chargingHasNoSystemPower()
+  {
+    BatterySampler::Readings r;
+    r.powerNow = 30'000'000;
+    r.energyNow = 40'000'000;
+    r.discharging = false;
+
+    const auto m = BatterySampler::compute( r );
+    QVERIFY( near( m.powerW, 30.0 ) );
+    QCOMPARE( m.systemPowerW, -1.0 );
+    QCOMPARE( m.timeToEmptyMin, -1.0 );
+  }
+
+  void currentWithoutVoltageIsUnknown()
+  {
+    BatterySampler::Readings r;
+    r.currentNow = 1'000'000;
+    r.chargeNow = 1'000'000;
+    r.discharging = true;
+
+    const auto m = BatterySampler::compute( r );
+    QCOMPARE( m.powerW, -1.0 );
+    QCOMPARE( m.energyWh, -1.0 );
+    QCOMPARE( m.systemPowerW, -1.0 );
+  }
+
+  void samplesFirstBatteryThroughPoller()
+  {
+    QTemporaryDir dir;
+    const std::filesystem::path root( dir.path().toStdString() );
+    file( root / "AC" / "type", "Mains\n" );
+    file( root / "AC" / "online", "0\n" );
+    file( root / "BAT0" / "type", "Battery\n" );
+    file( root / "BAT0" / "power_now", "9000000\n" );
+    file( root / "BAT0" / "voltage_now", "11500000\n" );
+    file( root / "BAT0" / "energy_now", "45000000\n" );
+    file( root / "BAT0" / "capacity", "75\n" );
+    file( root / "BAT0" / "status", "Discharging\n" );
+
+    auto poller = std::make_shared< SensorPoller >();
+    BatterySampler sampler( poller );
+    QVERIFY( sampler.discover( root.string() ) );
+    QCOMPARE( sampler.name(), std::string( "BAT0" ) );
+    QCOMPARE( poller->size(), size_t( 5 ) );  // only the nodes the driver has
+
+    poller->refresh();
+    const auto m = sampler.sample();
+    QVERIFY( m.discharging );
+    QVERIFY( near( m.powerW, 9.0 ) );
+    QVERIFY( near( m.energyWh, 45.0 ) );
+    QVERIFY( near( m.capacityPct, 75.0 ) );
+    QVERIFY( near( m.timeToEmptyMin, 300.0 ) );
+    QVERIFY( near( m.systemPowerW, 9.0 ) );
+
+    file( root / "BAT0" / "status", "Charging\n" );
+    poller->refresh();
+    QCOMPARE( sampler.sample().systemPowerW, -1.0 );
+  }
+
+  void noBattery()
+  {
+    QTemporaryDir dir;
+    const std::filesystem::path root( dir.path().toStdString() );
+    file( root / "AC" / "type", "Mains\n" );
+
+    auto poller = std::make_shared< SensorPoller >();
+    BatterySampler sampler( poller );
+    QVERIFY( !sampler.discover( root.string() ) );
+    QVERIFY( !sampler.available() );
+    QCOMPARE( sampler.sample().powerW, -1.0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestBatterySampler )
+
+#include "test_battery_sampler.moc"
@@ -0,0 +1,97 @@
+/*
+ * Unit tests for BleCommandQueue – latest-wins slots for state commands,
+ * priority order and how every ticket ends.
+ */
+
+#include <QTest>
+#include <string>
+#include <vector>
+#include "BleCommandQueue.hpp"
+
+using Queue = BleCommandQueue< std::string >;
+
+class TestBleCommandQueue : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void stateCommandsKeepTheNewest()
+  {
+    Queue queue;
+    std::vector< std::pair< uint64_t, BleCommandOutcome > > finished;
+    queue.setCompletionHandler( [ & ]( const Queue::Command &command, BleCommandOutcome outcome )
+                                { finished.emplace_back( command.ticket, outcome ); } );
+
+    const uint64_t first = queue.push( BleCommandKind::Fan, "fan 30" );
+    queue.push( BleCommandKind::Fan, "fan 40" );
+    const uint64_t last = queue.push( BleCommandKind::Fan, "fan 50" );
+    QCOMPARE( queue.size(), size_t( 1 ) );
+    QCOMPARE( queue.coalescedCount(), uint64_t( 2 ) );
+    QCOMPARE( finished.size(), size_t( 2 ) );
+    QCOMPARE( finished[ 0 ].first, first );
+    QVERIFY( finished[ 0 ].second == BleCommandOutcome::Superseded );
+
+    const auto command = queue.pop();
+    QVERIFY( command.has_value() );
+    QCOMPARE( command->data, std::string( "fan 50" ) );
+    QCOMPARE( command->ticket, last );
+    queue.written( *command );
+    QVERIFY( finished.back().second == BleCommandOutcome::Written );
+    QCOMPARE( queue.writtenCount(), uint64_t( 1 ) );
+    QVERIFY( queue.empty() );
+  }
+
+  void resetsAndUnknownCommandsAreNeverMerged()
+  {
+    Queue queue;
+    queue.push( BleCommandKind::Other, "a" );
+    queue.push( BleCommandKind::Other, "b" );
+    queue.push( BleCommandKind::Reset, "r1" );
+    queue.push( BleCommandKind::Reset, "r2" );
+    QCOMPARE( queue.size(), size_t( 4 ) );
+    QCOMPARE( queue.coalescedCount(), uint64_t( 0 ) );
+    QCOMPARE( queue.pop()->data, std::string( "r1" ) );
+    QCOMPARE( queue.pop()->data, std::string( "r2" ) );
+    QCOMPARE( queue.pop()->data, std::string( "a" ) );
+    QCOMPARE( queue.pop()->data, std::string( "b" ) );
+  }
+
+  void pumpGoesBeforeFanAndLedLast()
+  {
+    Queue queue;
+    queue.push( BleCommandKind::Led, "led" );
+    queue.push( BleCommandKind::Fan, "fan" );
+    queue.push( BleCommandKind::Other, "other" );
+    queue.push( BleCommandKind::Pump, "pump" );
+
+    std::vector< std::string > order;
+    while ( auto command = queue.pop() )
+      order.push_back( command->data );
+    QCOMPARE( order, ( std::vector< std::string >{ "pump", "fan", "other", "led" } ) );
+  }
+
+  void clearDropsEverythingPending()
+  {
+    Queue queue;
+    std::vector< BleCommandKind > dropped;
+    queue.setCompletionHandler( [ & ]( const Queue::Command &command, BleCommandOutcome outcome )
+                                {
+                                  if ( outcome == BleCommandOutcome::Dropped )
+                                    dropped.push_back( command.kind );
+                                } );
+    queue.push( BleCommandKind::Led, "led" );
+    queue.push( BleCommandKind::Pump, "pump" );
+    queue.clear();
+
+    QVERIFY( queue.empty() );
+    QCOMPARE( queue.droppedCount(), uint64_t( 2 ) );
+    QCOMPARE( dropped.size(), size_t( 2 ) );
+    QVERIFY( dropped[ 0 ] == BleCommandKind::Pump );
+    QVERIFY( !queue.pop().has_value() );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestBleCommandQueue )
+
+#include "test_ble_command_queue.moc"
@@ -0,0 +1,93 @@
+/*
+ * Unit tests for BrightnessRamp – fixed-step fades that follow the clock,
+ * skip repeated values and retarget mid-fade.
+ */
+
+#include <QTest>
+#include "BrightnessRamp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestBrightnessRamp : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void fadesInFixedSteps()
+  {
+    BrightnessRamp ramp;
+    const auto t0 = BrightnessRamp::Clock::now();
+    ramp.start( 0, 100, 64ms, t0 );
+
+    // 64 ms are four steps of 16 ms
+    QCOMPARE( ramp.step( t0 ).value_or( -1 ), 25 );
+    QCOMPARE( ramp.step( t0 + 16ms ).value_or( -1 ), 50 );
+    QCOMPARE( ramp.step( t0 + 32ms ).value_or( -1 ), 75 );
+    QVERIFY( ramp.active() );
+    QCOMPARE( ramp.step( t0 + 48ms ).value_or( -1 ), 100 );
+    QVERIFY( not ramp.active() );
+    QVERIFY( not ramp.step( t0 + 64ms ) );
+  }
+
+  void lateStepsSkipAhead()
+  {
+    BrightnessRamp ramp;
+    const auto t0 = BrightnessRamp::Clock::now();
+    ramp.start( 400, 0, 160ms, t0 );
+    QCOMPARE( ramp.step( t0 ).value_or( -1 ), 360 );
+    QCOMPARE( ramp.step( t0 + 100ms ).value_or( -1 ), 120 );
+    QCOMPARE( ramp.step( t0 + 1s ).value_or( -1 ), 0 );
+    QVERIFY( not ramp.active() );
+  }
+
+  void repeatedValuesAreNotWritten()
+  {
+    // a panel with 3 levels cannot show ten steps
+    BrightnessRamp ramp;
+    const auto t0 = BrightnessRamp::Clock::now();
+    ramp.start( 0, 2, 160ms, t0 );
+    int writes = 0;
+    for ( int i = 0; i < 10; ++i )
+      if ( ramp.step( t0 + i * BrightnessRamp::STEP ) )
+        ++writes;
+    QCOMPARE( writes, 2 );
+    QCOMPARE( ramp.current(), 2 );
+    QVERIFY( not ramp.active() );
+  }
+
+  void zeroDurationJumps()
+  {
+    BrightnessRamp ramp;
+    const auto t0 = BrightnessRamp::Clock::now();
+    ramp.start( 10, 90, 0ms, t0 );
+    QCOMPARE( ramp.step( t0 ).value_or( -1 ), 90 );
+    QVERIFY( not ramp.active() );
+
+    ramp.start( 90, 90, 100ms, t0 );
+    for ( int i = 0; i < 6; ++i )
+      QVERIFY( not ramp.step( t0 + i * BrightnessRamp::STEP ) );
+    QVERIFY( not ramp.active() );
+  }
+
+  void retargetContinuesFromTheCurrentValue()
+  {
+    BrightnessRamp ramp;
+    const auto t0 = BrightnessRamp::Clock::now();
+    ramp.start( 0, 100, 64ms, t0 );
+    QCOMPARE( ramp.step( t0 + 16ms ).value_or( -1 ), 50 );
+
+    ramp.start( ramp.current(), 0, 32ms, t0 + 20ms );
+    QCOMPARE( ramp.target(), 0 );
+    QCOMPARE( ramp.step( t0 + 20ms ).value_or( -1 ), 25 );
+    QCOMPARE( ramp.step( t0 + 36ms ).value_or( -1 ), 0 );
+
+    ramp.start( 0, 50, 64ms, t0 );
+    ramp.cancel();
+    QVERIFY( not ramp.step( t0 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestBrightnessRamp )
+
+#include "test_brightness_ramp.moc"
@@ -0,0 +1,147 @@
+/*
+ * Unit tests for CapabilityCache – facts reused across instances,
+ * invalidation on DMI, module or BIOS changes, revalidation and damaged
+ * profiles.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <fstream>
+#include "CapabilityCache.hpp"
+
+namespace
+{
+const CapabilityIdentity MACHINE{ "TUXEDO/GMxRGxx/STELLARIS1XI05", "0.4.2", "N.1.10A09/04/2024" };
+
+void writeFile( const std::string &path, const std::string &content )
+{
+  std::ofstream( path, std::ios::trunc ) << content;
+}
+}
+
+class TestCapabilityCache : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void factsOutliveTheInstance()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "capabilities" ).toStdString();
+
+    {
+      CapabilityCache cache( cachePath );
+      QVERIFY( !cache.open( MACHINE ) );
+      QVERIFY( !cache.find( "fans" ) );
+      QVERIFY( cache.revalidate( "fans", "2 25 1" ) );
+      QVERIFY( cache.revalidate( "system-info", "{\"model\":\"Stellaris\"}" ) );
+      cache.flush();
+    }
+
+    CapabilityCache restarted( cachePath );
+    QVERIFY( restarted.open( MACHINE ) );
+    QCOMPARE( restarted.find( "fans" ), std::optional< std::string >( "2 25 1" ) );
+    QCOMPARE( restarted.find( "system-info" ), std::optional< std::string >( "{\"model\":\"Stellaris\"}" ) );
+    QVERIFY( !restarted.find( "keyboard" ) );
+  }
+
+  void revalidationReportsChanges()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "capabilities" ).toStdString();
+    {
+      CapabilityCache cache( cachePath );
+      cache.open( MACHINE );
+      cache.revalidate( "fans", "2 25 1" );
+      cache.flush();
+    }
+
+    CapabilityCache cache( cachePath );
+    QVERIFY( cache.open( MACHINE ) );
+    QVERIFY( !cache.revalidate( "fans", "2 25 1" ) );
+    QVERIFY( cache.revalidate( "fans", "2 30 1" ) );
+    QVERIFY( cache.revalidate( "odm-profiles", "" ) );
+    cache.flush();
+
+    CapabilityCache restarted( cachePath );
+    QVERIFY( restarted.open( MACHINE ) );
+    QCOMPARE( restarted.find( "fans" ), std::optional< std::string >( "2 30 1" ) );
+    QCOMPARE( restarted.find( "odm-profiles" ), std::optional< std::string >( "" ) );
+  }
+
+  void anotherIdentityProbesAgain()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "capabilities" ).toStdString();
+    {
+      CapabilityCache cache( cachePath );
+      cache.open( MACHINE );
+      cache.revalidate( "fans", "2 25 1" );
+      cache.flush();
+    }
+
+    CapabilityIdentity module = MACHINE;
+    module.moduleVersion = "0.4.3";
+    CapabilityIdentity bios = MACHINE;
+    bios.biosVersion = "N.1.11A01/02/2025";
+    CapabilityIdentity board = MACHINE;
+    board.dmi = "TUXEDO/GMxRGxx/STELLARIS1XA05";
+
+    for ( const CapabilityIdentity &identity : { module, bios, board } )
+    {
+      CapabilityCache cache( cachePath );
+      QVERIFY( !cache.open( identity ) );
+      QVERIFY( !cache.find( "fans" ) );
+    }
+
+    // a new identity replaces the profile once something is stored
+    {
+      CapabilityCache cache( cachePath );
+      cache.open( module );
+      cache.revalidate( "fans", "3 20 0" );
+      cache.flush();
+    }
+    CapabilityCache restarted( cachePath );
+    QVERIFY( !restarted.open( MACHINE ) );
+    QVERIFY( restarted.open( module ) );
+    QCOMPARE( restarted.find( "fans" ), std::optional< std::string >( "3 20 0" ) );
+  }
+
+  void unstorableValuesAreNotCached()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "capabilities" ).toStdString();
+    {
+      CapabilityCache cache( cachePath );
+      cache.open( MACHINE );
+      QVERIFY( cache.revalidate( "keyboard", "line\nbreak" ) );
+      cache.flush();
+    }
+    CapabilityCache restarted( cachePath );
+    QVERIFY( !restarted.open( MACHINE ) );
+  }
+
+  void damagedProfilesAreIgnored()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "capabilities" ).toStdString();
+    const std::string header = "ucc-capabilities 1\ndmi\t" + MACHINE.dmi + "\nmodule\t" + MACHINE.moduleVersion
+                               + "\nbios\t" + MACHINE.biosVersion + "\n";
+
+    writeFile( cachePath, header + "fans\t2 25 1\n" );
+    QVERIFY( CapabilityCache( cachePath ).open( MACHINE ) );
+
+    for ( const std::string &damaged : { std::string( "ucc-capabilities 0\n" ), header + "fans 2 25 1\n",
+                                         header.substr( 0, 30 ), std::string() } )
+    {
+      writeFile( cachePath, damaged );
+      CapabilityCache cache( cachePath );
+      QVERIFY( !cache.open( MACHINE ) );
+      QVERIFY( !cache.find( "fans" ) );
+    }
+  }
+};
+
+QTEST_GUILESS_MAIN( TestCapabilityCache )
+#include "test_capability_cache.moc"
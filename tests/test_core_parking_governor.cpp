@@ -0,0 +1,161 @@
+/*
+ * Unit tests for CoreParkingGovernor – parking with hysteresis and rate
+ * limit, instant unparking under load or run queue pressure, and the split
+ * between core classes per policy.
+ */
+
+#include <QTest>
+#include "CoreParkingGovernor.hpp"
+
+class TestCoreParkingGovernor : public QObject
+{
+  Q_OBJECT
+
+private:
+  static constexpr int64_t HOLD = CoreParkingGovernor::PARK_HOLD_MS;
+  static constexpr int64_t INTERVAL = CoreParkingGovernor::PARK_INTERVAL_MS;
+
+private slots:
+
+  void offDoesNothing()
+  {
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Off, 16, 0, 0 );
+    QVERIFY( !g.enabled() );
+    QVERIFY( !g.update( 0, 0.0, 1 ) );
+    QVERIFY( !g.update( 60'000, 0.0, 1 ) );
+  }
+
+  void parksOneCoreAfterTheHold()
+  {
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Performance, 8, 0, 0 );
+    QCOMPARE( g.online(), 8 );
+
+    QVERIFY( !g.update( 0, 0.5, 1 ) );
+    QVERIFY( !g.update( HOLD - 1, 0.5, 1 ) );
+    QVERIFY( g.update( HOLD, 0.5, 1 ) );
+    QCOMPARE( g.online(), 7 );
+
+    // still idle: the next core only after the interval
+    QVERIFY( !g.update( HOLD + INTERVAL - 1, 0.5, 1 ) );
+    QVERIFY( g.update( HOLD + INTERVAL, 0.5, 1 ) );
+    QCOMPARE( g.online(), 6 );
+  }
+
+  void neverBelowTheMinimum()
+  {
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Performance, 4, 0, 0 );
+    int64_t now = 0;
+    for ( int i = 0; i < 20; ++i, now += HOLD )
+      g.update( now, 0.0, 1 );
+    QCOMPARE( g.online(), CoreParkingGovernor::MIN_ONLINE );
+  }
+
+  void busyCoresBlockParking()
+  {
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Performance, 8, 0, 0 );
+    // 3 busy cores on 7 would be above PARK_UTILIZATION
+    QVERIFY( !g.update( 0, 3.0, 1 ) );
+    QVERIFY( !g.update( HOLD * 4, 3.0, 1 ) );
+    QCOMPARE( g.online(), 8 );
+
+    // one high sample restarts the hold
+    QVERIFY( !g.update( HOLD * 5, 1.0, 1 ) );
+    QVERIFY( !g.update( HOLD * 6 - 1, 3.0, 1 ) );
+    QVERIFY( !g.update( HOLD * 6, 1.0, 1 ) );
+    QVERIFY( !g.update( HOLD * 7 - 1, 1.0, 1 ) );
+    QVERIFY( g.update( HOLD * 7, 1.0, 1 ) );
+  }
+
+  void unparksAtOnceOnLoad()
+  {
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Performance, 16, 0, 0 );
+    int64_t now = 0;
+    while ( g.online() > CoreParkingGovernor::MIN_ONLINE )
+      g.update( now += INTERVAL, 0.1, 1 );
+
+    // 1.8 of 2 cores busy: enough for 1.8 / 0.75 plus one spare, in one step
+    QVERIFY( g.update( now + 1, 1.8, 1 ) );
+    QCOMPARE( g.online(), 4 );
+
+    // and no parking right after it
+    QVERIFY( !g.update( now + INTERVAL, 0.1, 1 ) );
+    QVERIFY( !g.update( now + 1 + HOLD, 0.1, 1 ) );
+    QVERIFY( g.update( now + INTERVAL + HOLD, 0.1, 1 ) );
+    QCOMPARE( g.online(), 3 );
+  }
+
+  void unparksOnRunQueuePressure()
+  {
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Performance, 16, 0, 0 );
+    int64_t now = 0;
+    while ( g.online() > 4 )
+      g.update( now += INTERVAL, 0.1, 1 );
+
+    // the sampling thread itself does not count
+    QVERIFY( !g.update( now + 1, 0.1, 5 ) );
+    // short bursts: ten tasks waiting for four cores
+    QVERIFY( g.update( now + 2, 0.5, 11 ) );
+    QCOMPARE( g.online(), 10 );
+    QVERIFY( g.update( now + 3, 0.5, 40 ) );
+    QCOMPARE( g.online(), 16 );
+  }
+
+  void reconfigureKeepsOrResets()
+  {
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Performance, 8, 0, 0 );
+    g.update( 0, 0.0, 1 );
+    g.update( HOLD, 0.0, 1 );
+    QCOMPARE( g.online(), 7 );
+
+    g.configure( CoreParkingPolicy::Performance, 8, 0, 0 );
+    QCOMPARE( g.online(), 7 );
+    g.configure( CoreParkingPolicy::Performance, 6, 0, 0 );
+    QCOMPARE( g.online(), 6 );
+  }
+
+  void splitPerPolicy()
+  {
+    // 6 P-cores and 8 E-cores, 10 of them online
+    CoreParkingGovernor g;
+    g.configure( CoreParkingPolicy::Efficiency, 14, 6, 8 );
+    int64_t now = 0;
+    while ( g.online() > 10 )
+      g.update( now += HOLD, 0.0, 1 );
+
+    auto limits = g.limits();
+    QVERIFY( !limits.all );
+    QCOMPARE( *limits.performance, 2 );
+    QCOMPARE( *limits.efficiency, 8 );
+
+    g.configure( CoreParkingPolicy::Performance, 14, 6, 8 );
+    while ( g.online() > 10 )
+      g.update( now += HOLD, 0.0, 1 );
+    limits = g.limits();
+    QCOMPARE( *limits.performance, 6 );
+    QCOMPARE( *limits.efficiency, 4 );
+
+    // all the way down: one P-core stays for core 0
+    g.configure( CoreParkingPolicy::Efficiency, 14, 6, 8 );
+    while ( g.online() > CoreParkingGovernor::MIN_ONLINE )
+      g.update( now += HOLD, 0.0, 1 );
+    limits = g.limits();
+    QCOMPARE( *limits.performance, 1 );
+    QCOMPARE( *limits.efficiency, 1 );
+
+    // no core classes: the total
+    g.configure( CoreParkingPolicy::Efficiency, 8, 0, 0 );
+    limits = g.limits();
+    QCOMPARE( *limits.all, 8 );
+    QVERIFY( !limits.performance );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestCoreParkingGovernor )
+#include "test_core_parking_governor.moc"
@@ -0,0 +1,274 @@
+/*
+ * Unit tests for CpuController's shadow state – what was written to each
+ * core – the per-core comparison CpuWorker validates with, the batched
+ * writes (unchanged values skipped, one write per cpufreq policy) and the
+ * limits per core class.
+ */
+
+#include <QTest>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "CpuController.hpp"
+
+class TestCpuController : public QObject
+{
+  Q_OBJECT
+
+private:
+  std::filesystem::path m_dir;
+
+  void file( const std::string &name, const std::string &content )
+  {
+    const auto path = m_dir / name;
+    std::filesystem::create_directories( path.parent_path() );
+    std::ofstream( path, std::ios::trunc ) << content;
+  }
+
+  std::string readFile( const std::string &name )
+  {
+    std::string content;
+    std::getline( std::ifstream( m_dir / name ), content );
+    return content;
+  }
+
+  static std::string freqNode( int core, const char *name )
+  {
+    return "cpu" + std::to_string( core ) + "/cpufreq/" + name;
+  }
+
+  // Like acpi-cpufreq on older CPUs: @p perPolicy CPUs share each cpufreq/policyN
+  void sharePolicies( int perPolicy )
+  {
+    for ( int core = 0; core < 8; ++core )
+    {
+      const auto link = m_dir / ( "cpu" + std::to_string( core ) ) / "cpufreq";
+      const auto policy = m_dir / "cpufreq" / ( "policy" + std::to_string( core - core % perPolicy ) );
+      if ( core % perPolicy == 0 )
+      {
+        std::filesystem::create_directories( policy.parent_path() );
+        std::filesystem::rename( link, policy );
+      }
+      else
+      {
+        std::filesystem::remove_all( link );
+      }
+      std::filesystem::create_directory_symlink( policy, link );
+    }
+  }
+
+private slots:
+
+  // A hybrid CPU: cores 0-3 boost to 5 GHz, cores 4-7 to 3.8 GHz; the gap
+  // alone classifies them as P- and E-cores
+  void init()
+  {
+    m_dir = std::filesystem::temp_directory_path() / ( "ucc-test-cpu-" + std::to_string( getpid() ) );
+    std::filesystem::remove_all( m_dir );
+    file( "possible", "0-7\n" );
+    file( "present", "0-7\n" );
+    file( "intel_pstate/no_turbo", "0\n" );
+    for ( int core = 0; core < 8; ++core )
+    {
+      if ( core > 0 )
+        file( "cpu" + std::to_string( core ) + "/online", "1\n" );
+      file( freqNode( core, "cpuinfo_min_freq" ), "400000\n" );
+      file( freqNode( core, "cpuinfo_max_freq" ), core < 4 ? "5000000\n" : "3800000\n" );
+      file( freqNode( core, "scaling_min_freq" ), "400000\n" );
+      file( freqNode( core, "scaling_max_freq" ), core < 4 ? "5000000\n" : "3800000\n" );
+      file( freqNode( core, "scaling_driver" ), "intel_pstate\n" );
+      file( freqNode( core, "scaling_available_governors" ), "performance powersave\n" );
+      file( freqNode( core, "scaling_governor" ), "powersave\n" );
+      file( freqNode( core, "energy_performance_available_preferences" ),
+            "default performance balance_performance balance_power power\n" );
+      file( freqNode( core, "energy_performance_preference" ), "balance_performance\n" );
+    }
+  }
+
+  void cleanup()
+  {
+    std::filesystem::remove_all( m_dir );
+  }
+
+  void shadowHoldsThePerCoreValue()
+  {
+    CpuController ctrl( m_dir.string() );
+    QCOMPARE( ctrl.cores.size(), size_t( 8 ) );
+    QVERIFY( !ctrl.cores[ 0 ].shadow.scalingMaxFreq );
+
+    ctrl.setGovernorScalingMaxFrequency( 4500000 );
+    QCOMPARE( ctrl.cores[ 1 ].shadow.scalingMaxFreq, std::optional< int32_t >( 4500000 ) );
+    // clamped to the E-core's own ceiling
+    QCOMPARE( ctrl.cores[ 6 ].shadow.scalingMaxFreq, std::optional< int32_t >( 3800000 ) );
+    QCOMPARE( readFile( freqNode( 6, "scaling_max_freq" ) ), std::string( "3800000" ) );
+
+    ctrl.setGovernor( std::string( "performance" ) );
+    ctrl.setEnergyPerformancePreference( std::string( "power" ) );
+    ctrl.setNoTurbo( true );
+    QCOMPARE( ctrl.cores[ 7 ].shadow.governor, std::optional< std::string >( "performance" ) );
+    QCOMPARE( ctrl.cores[ 7 ].shadow.energyPerformancePreference, std::optional< std::string >( "power" ) );
+    QCOMPARE( ctrl.noTurboShadow, std::optional< bool >( true ) );
+  }
+
+  void unavailableGovernorIsNotRecorded()
+  {
+    CpuController ctrl( m_dir.string() );
+    ctrl.setGovernor( std::string( "schedutil" ) );
+    QVERIFY( !ctrl.cores[ 0 ].shadow.governor );
+    QCOMPARE( readFile( freqNode( 0, "scaling_governor" ) ), std::string( "powersave" ) );
+  }
+
+  void mismatchNamesTheForeignWrite()
+  {
+    CpuController ctrl( m_dir.string() );
+    ctrl.setGovernorScalingMaxFrequency( 4500000 );
+    ctrl.setGovernor( std::string( "performance" ) );
+
+    CpuController::ExpectedCoreState expected;
+    expected.core = 5;
+    expected.scalingMaxFreq = ctrl.cores[ 5 ].shadow.scalingMaxFreq;
+    expected.governor = ctrl.cores[ 5 ].shadow.governor;
+    QVERIFY( !ctrl.findMismatch( expected ) );
+
+    // e.g. power-profiles-daemon switching the profile underneath
+    file( freqNode( 5, "scaling_governor" ), "powersave\n" );
+    QCOMPARE( ctrl.findMismatch( expected ),
+              std::optional< std::string >( "core5 scaling governor 'powersave' instead of 'performance'" ) );
+
+    file( freqNode( 5, "scaling_max_freq" ), "2000000\n" );
+    QCOMPARE( ctrl.findMismatch( expected ),
+              std::optional< std::string >( "core5 maximum scaling frequency 2000000 instead of 3800000" ) );
+  }
+
+  void offlineCoresAreNotCompared()
+  {
+    CpuController ctrl( m_dir.string() );
+    ctrl.setGovernorScalingMinFrequency( 800000 );
+    ctrl.useCores( 4 );
+    QCOMPARE( ctrl.cores[ 5 ].shadow.online, std::optional< bool >( false ) );
+    QCOMPARE( readFile( "cpu5/online" ), std::string( "0" ) );
+
+    CpuController::ExpectedCoreState expected;
+    expected.core = 5;
+    expected.scalingMinFreq = 800000;
+    file( freqNode( 5, "scaling_min_freq" ), "400000\n" );
+    QVERIFY( !ctrl.findMismatch( expected ) );
+
+    expected.core = 99;
+    QVERIFY( !ctrl.findMismatch( expected ) );
+  }
+
+  void uncheckedFieldsAreIgnored()
+  {
+    CpuController ctrl( m_dir.string() );
+    file( freqNode( 2, "energy_performance_preference" ), "power\n" );
+
+    CpuController::ExpectedCoreState expected;
+    expected.core = 2;
+    QVERIFY( !ctrl.findMismatch( expected ) );
+    expected.energyPerformancePreference = "balance_performance";
+    QVERIFY( ctrl.findMismatch( expected ).has_value() );
+  }
+
+  void unchangedValuesAreNotWritten()
+  {
+    CpuController ctrl( m_dir.string() );
+    ctrl.setGovernor( std::string( "powersave" ) );
+    QCOMPARE( ctrl.writes(), uint64_t( 0 ) );
+    QCOMPARE( ctrl.skippedWrites(), uint64_t( 8 ) );
+    // still recorded: the value is in place, whoever wrote it
+    QCOMPARE( ctrl.cores[ 3 ].shadow.governor, std::optional< std::string >( "powersave" ) );
+
+    ctrl.setGovernor( std::string( "performance" ) );
+    QCOMPARE( ctrl.writes(), uint64_t( 8 ) );
+    ctrl.setGovernor( std::string( "performance" ) );
+    QCOMPARE( ctrl.writes(), uint64_t( 8 ) );
+
+    ctrl.useCores( std::nullopt );
+    ctrl.setNoTurbo( false );
+    QCOMPARE( ctrl.writes(), uint64_t( 8 ) );
+  }
+
+  void sharedPolicyIsWrittenOnce()
+  {
+    sharePolicies( 2 );
+    CpuController ctrl( m_dir.string() );
+    QCOMPARE( ctrl.cores[ 1 ].policyPath, ctrl.cores[ 0 ].policyPath );
+    QVERIFY( ctrl.cores[ 2 ].policyPath != ctrl.cores[ 0 ].policyPath );
+
+    ctrl.setEnergyPerformancePreference( std::string( "power" ) );
+    QCOMPARE( ctrl.writes(), uint64_t( 4 ) );
+    QCOMPARE( readFile( freqNode( 5, "energy_performance_preference" ) ), std::string( "power" ) );
+    QCOMPARE( ctrl.cores[ 5 ].shadow.energyPerformancePreference, std::optional< std::string >( "power" ) );
+
+    // with its first CPU offline, the next online one writes the policy
+    ctrl.useCores( 5 );
+    ctrl.setGovernorScalingMaxFrequency( 2000000 );
+    QCOMPARE( readFile( "cpufreq/policy4/scaling_max_freq" ), std::string( "2000000" ) );
+    QCOMPARE( ctrl.cores[ 4 ].shadow.scalingMaxFreq, std::optional< int32_t >( 2000000 ) );
+    QVERIFY( !ctrl.cores[ 5 ].shadow.scalingMaxFreq );
+  }
+
+  void coresHaveTheirClass()
+  {
+    CpuController ctrl( m_dir.string() );
+    QVERIFY( ctrl.topology.isHybrid() );
+    QVERIFY( ctrl.cores[ 3 ].type == CpuCoreType::Performance );
+    QVERIFY( ctrl.cores[ 4 ].type == CpuCoreType::Efficiency );
+  }
+
+  void classLimitsOverrideTheCpuWide()
+  {
+    CpuController ctrl( m_dir.string() );
+    // on battery: P-cores capped, E-cores at their full range
+    ctrl.setScalingFrequencies( std::nullopt, PerCoreClass< int32_t >{ std::nullopt, 2500000, std::nullopt } );
+    QCOMPARE( readFile( freqNode( 1, "scaling_max_freq" ) ), std::string( "2500000" ) );
+    QCOMPARE( readFile( freqNode( 5, "scaling_max_freq" ) ), std::string( "3800000" ) );
+
+    ctrl.setEnergyPerformancePreference( PerCoreClass< std::string >{ "balance_power", std::nullopt, "power" } );
+    QCOMPARE( readFile( freqNode( 0, "energy_performance_preference" ) ), std::string( "balance_power" ) );
+    QCOMPARE( readFile( freqNode( 7, "energy_performance_preference" ) ), std::string( "power" ) );
+  }
+
+  void parkingACoreClass()
+  {
+    CpuController ctrl( m_dir.string() );
+    // on AC: every E-core parked
+    ctrl.useCores( PerCoreClass< int32_t >{ std::nullopt, std::nullopt, 0 } );
+    QCOMPARE( readFile( "cpu3/online" ), std::string( "1" ) );
+    QCOMPARE( readFile( "cpu4/online" ), std::string( "0" ) );
+    QCOMPARE( readFile( "cpu7/online" ), std::string( "0" ) );
+
+    // both limits apply: the first 6 CPUs, of them 2 P-cores
+    ctrl.useCores( PerCoreClass< int32_t >{ 6, 2, std::nullopt } );
+    QCOMPARE( readFile( "cpu1/online" ), std::string( "1" ) );
+    QCOMPARE( readFile( "cpu2/online" ), std::string( "0" ) );
+    QCOMPARE( readFile( "cpu5/online" ), std::string( "1" ) );
+    QCOMPARE( readFile( "cpu6/online" ), std::string( "0" ) );
+  }
+
+  void frequenciesMoveInOneStep()
+  {
+    CpuController ctrl( m_dir.string() );
+    ctrl.setScalingFrequencies( std::nullopt, 1000000 );
+    QCOMPARE( readFile( freqNode( 0, "scaling_max_freq" ) ), std::string( "1000000" ) );
+
+    // the new minimum is above the current maximum: computed against the
+    // full range, not clamped to the 1 GHz still in place
+    const uint64_t before = ctrl.writes();
+    ctrl.setScalingFrequencies( 3000000, std::nullopt );
+    QCOMPARE( readFile( freqNode( 0, "scaling_min_freq" ) ), std::string( "3000000" ) );
+    QCOMPARE( readFile( freqNode( 0, "scaling_max_freq" ) ), std::string( "5000000" ) );
+    QCOMPARE( readFile( freqNode( 7, "scaling_max_freq" ) ), std::string( "3800000" ) );
+    QCOMPARE( ctrl.cores[ 7 ].shadow.scalingMinFreq, std::optional< int32_t >( 3000000 ) );
+    QCOMPARE( ctrl.writes() - before, uint64_t( 16 ) );
+
+    ctrl.setScalingFrequencies( 3000000, std::nullopt );
+    QCOMPARE( ctrl.writes() - before, uint64_t( 16 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestCpuController )
+#include "test_cpu_controller.moc"
@@ -0,0 +1,199 @@
+/*
+ * Unit tests for CpuCoreSampler (APERF/MPERF, cpufreq fallback, /proc/stat).
+ */
+
+#include <QTest>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include "CpuCoreSampler.hpp"
+
+class TestCpuCoreSampler : public QObject
+{
+  Q_OBJECT
+
+private:
+  std::filesystem::path m_root;
+  std::filesystem::path m_dir;
+
+  void file( const std::filesystem::path &path, const std::string &content )
+  {
+    std::filesystem::create_directories( path.parent_path() );
+    std::ofstream( path, std::ios::trunc ) << content;
+  }
+
+  /// Fake /dev/cpu/N/msr; the registers overlap as byte offsets, so only
+  /// the probe read and a constant counter can be emulated
+  void msr( int cpu )
+  {
+    const auto path = m_dir / "dev" / std::to_string( cpu ) / "msr";
+    std::filesystem::create_directories( path.parent_path() );
+    file( path, std::string( 0x100, '\x01' ) );
+  }
+
+  void cpu( int n, int64_t curKHz, int64_t baseKHz = 0 )
+  {
+    const auto cpufreq = m_dir / "sys" / ( "cpu" + std::to_string( n ) ) / "cpufreq";
+    file( cpufreq / "scaling_cur_freq", std::to_string( curKHz ) + "\n" );
+    if ( baseKHz > 0 )
+      file( cpufreq / "base_frequency", std::to_string( baseKHz ) + "\n" );
+  }
+
+  void fresh( const std::string &name )
+  {
+    m_dir = m_root / name;
+    std::filesystem::create_directories( m_dir / "sys" );
+    std::filesystem::create_directories( m_dir / "pmu" );
+    file( m_dir / "stat", "cpu  0 0 0 0 0 0 0 0 0 0\n" );
+  }
+
+  CpuCoreSampler::Paths paths() const
+  {
+    CpuCoreSampler::Paths p;
+    p.cpuRoot = ( m_dir / "sys" ).string();
+    p.pmuRoot = ( m_dir / "pmu" ).string();
+    p.procStat = ( m_dir / "stat" ).string();
+    p.msrRoot = ( m_dir / "dev" ).string();
+    return p;
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    m_root = std::filesystem::temp_directory_path() / ( "ucc-test-cores-" + std::to_string( getpid() ) );
+    std::filesystem::create_directories( m_root );
+  }
+
+  void cleanupTestCase()
+  {
+    std::filesystem::remove_all( m_root );
+  }
+
+  void cpufreqFallbackPerCore()
+  {
+    fresh( "cpufreq" );
+    file( m_dir / "sys" / "online", "0-3\n" );
+    cpu( 0, 800'000 );
+    cpu( 1, 4'700'000 );
+    cpu( 2, 1'200'000 );
+    cpu( 3, 2'100'000 );
+
+    auto poller = std::make_shared< SensorPoller >();
+    CpuCoreSampler sampler( poller, paths() );
+    sampler.discover();
+    QCOMPARE( sampler.coreCount(), size_t( 4 ) );
+    QVERIFY( !sampler.usesMsr() );
+
+    poller->refresh();
+    const auto &m = sampler.sample();
+    QVERIFY( !m.effective );
+    QCOMPARE( m.freqMHz[ 1 ], 4700.0 );
+    QCOMPARE( m.maxMHz, 4700.0 );
+    QCOMPARE( m.avgMHz, 2200.0 );
+    QCOMPARE( m.pCoreAvgMHz, -1.0 );
+  }
+
+  void hybridAggregates()
+  {
+    fresh( "hybrid" );
+    file( m_dir / "sys" / "online", "0-3\n" );
+    file( m_dir / "pmu" / "cpu_core" / "cpus", "0-1\n" );
+    file( m_dir / "pmu" / "cpu_atom" / "cpus", "2-3\n" );
+    cpu( 0, 5'000'000 );
+    cpu( 1, 4'000'000 );
+    cpu( 2, 1'000'000 );
+    cpu( 3, 2'000'000 );
+
+    auto poller = std::make_shared< SensorPoller >();
+    CpuCoreSampler sampler( poller, paths() );
+    sampler.discover();
+    poller->refresh();
+    const auto &m = sampler.sample();
+    QVERIFY( m.types[ 0 ] == CpuCoreType::Performance );
+    QVERIFY( m.types[ 3 ] == CpuCoreType::Efficiency );
+    QCOMPARE( m.pCoreAvgMHz, 4500.0 );
+    QCOMPARE( m.eCoreAvgMHz, 1500.0 );
+    QCOMPARE( m.avgMHz, 3000.0 );
+  }
+
+  void aperfMperfRatio()
+  {
+    QCOMPARE( CpuCoreSampler::effectiveMHz( 2'000'000, 2'300'000, 1'000'000 ), 4600.0 );
+    QCOMPARE( CpuCoreSampler::effectiveMHz( 2'000'000, 400'000, 1'000'000 ), 800.0 );
+    // halted the whole interval
+    QCOMPARE( CpuCoreSampler::effectiveMHz( 2'000'000, 0, 0 ), -1.0 );
+  }
+
+  void msrSourceWithBaseFrequency()
+  {
+    fresh( "msr" );
+    file( m_dir / "sys" / "online", "0-1\n" );
+    cpu( 0, 800'000, 2'000'000 );
+    cpu( 1, 900'000, 2'000'000 );
+    msr( 0 );
+    msr( 1 );
+
+    auto poller = std::make_shared< SensorPoller >();
+    CpuCoreSampler sampler( poller, paths() );
+    sampler.discover();
+    QVERIFY( sampler.usesMsr() );
+
+    // no delta yet, and an unchanged counter means halted: scaling_cur_freq
+    poller->refresh();
+    QCOMPARE( sampler.sample().freqMHz[ 1 ], 900.0 );
+    const auto &m = sampler.sample();
+    QVERIFY( m.effective );
+    QCOMPARE( m.freqMHz[ 0 ], 800.0 );
+  }
+
+  void msrNeedsBaseFrequency()
+  {
+    fresh( "nobase" );
+    file( m_dir / "sys" / "online", "0\n" );
+    cpu( 0, 800'000 );
+    msr( 0 );
+
+    CpuCoreSampler sampler( std::make_shared< SensorPoller >(), paths() );
+    sampler.discover();
+    QVERIFY( !sampler.usesMsr() );
+  }
+
+  void busyFromProcStat()
+  {
+    fresh( "stat" );
+    file( m_dir / "sys" / "online", "0-1\n" );
+    cpu( 0, 800'000 );
+    cpu( 1, 800'000 );
+    file( m_dir / "stat", "cpu  0 0 0 0 0 0 0 0 0 0\n"
+                          "cpu0 100 0 100 800 0 0 0 0 0 0\n"
+                          "cpu1 0 0 0 1000 0 0 0 0 0 0\n"
+                          "intr 12345 0 0\n" );
+
+    auto poller = std::make_shared< SensorPoller >();
+    CpuCoreSampler sampler( poller, paths() );
+    sampler.discover();
+    poller->refresh();
+    QCOMPARE( sampler.sample().busyPct[ 0 ], -1.0 );
+    QCOMPARE( sampler.sample().runnable, -1 );
+
+    // cpu0: 150 busy of 200 ticks; cpu1: 50 of 200 including iowait as idle
+    file( m_dir / "stat", "cpu  0 0 0 0 0 0 0 0 0 0\n"
+                          "cpu0 200 10 140 850 0 0 0 0 0 0\n"
+                          "cpu1 0 0 40 1100 50 5 5 0 0 0\n"
+                          "intr 12399 0 0\n"
+                          "procs_running 3\n"
+                          "procs_blocked 0\n" );
+    const auto &m = sampler.sample();
+    QCOMPARE( m.busyPct[ 0 ], 75.0 );
+    QCOMPARE( m.busyPct[ 1 ], 25.0 );
+    QCOMPARE( m.runnable, 3 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestCpuCoreSampler )
+
+#include "test_cpu_core_sampler.moc"
@@ -0,0 +1,162 @@
+/*
+ * Unit tests for CpuThrottleSampler against a fake sysfs tree.
+ */
+
+#include <QTest>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "CpuThrottleSampler.hpp"
+
+class TestCpuThrottleSampler : public QObject
+{
+  Q_OBJECT
+
+private:
+  std::filesystem::path m_root;
+  std::filesystem::path m_dir;
+
+  void file( const std::filesystem::path &path, const std::string &content )
+  {
+    std::filesystem::create_directories( path.parent_path() );
+    std::ofstream( path, std::ios::trunc ) << content;
+  }
+
+  void fresh( const std::string &name, const std::string &online )
+  {
+    m_dir = m_root / name;
+    file( m_dir / "cpu" / "online", online + "\n" );
+    std::filesystem::create_directories( m_dir / "powercap" );
+  }
+
+  void cpu( int index, int package )
+  {
+    file( m_dir / "cpu" / ( "cpu" + std::to_string( index ) ) / "topology" / "physical_package_id",
+          std::to_string( package ) + "\n" );
+  }
+
+  void counter( int index, const std::string &kind, int64_t count, int64_t totalMs = -1 )
+  {
+    const auto dir = m_dir / "cpu" / ( "cpu" + std::to_string( index ) ) / "thermal_throttle";
+    file( dir / ( kind + "_throttle_count" ), std::to_string( count ) + "\n" );
+    if ( totalMs >= 0 )
+      file( dir / ( kind + "_throttle_total_time_ms" ), std::to_string( totalMs ) + "\n" );
+  }
+
+  CpuThrottleSampler sampler() const
+  {
+    CpuThrottleSampler::Paths paths;
+    paths.cpuRoot = ( m_dir / "cpu" ).string();
+    paths.powercapZone = ( m_dir / "powercap" ).string();
+    paths.pmuRoot = ( m_dir / "pmu" ).string();
+    return CpuThrottleSampler( paths );
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    m_root = std::filesystem::temp_directory_path() / ( "ucc-test-cpu-throttle-" + std::to_string( getpid() ) );
+    std::filesystem::create_directories( m_root );
+  }
+
+  void cleanupTestCase()
+  {
+    std::filesystem::remove_all( m_root );
+  }
+
+  void firstSampleIsUnprimed()
+  {
+    fresh( "unprimed", "0" );
+    cpu( 0, 0 );
+    counter( 0, "core", 3, 100 );
+    auto s = sampler();
+    s.discover( false );
+    QVERIFY( s.hasThermalCounters() );
+    QVERIFY( !s.hasPowerLimits() );
+
+    const auto m = s.sample( 10.0, 1000 );
+    QCOMPARE( m.coreThrottlePct, -1.0 );
+    QCOMPARE( m.packageThrottlePct, -1.0 );
+    QCOMPARE( m.coreThrottleEvents, uint64_t( 0 ) );
+    QCOMPARE( m.powerLimitedPct, -1.0 );
+    QCOMPARE( m.pkgCstatePct, -1.0 );
+  }
+
+  void totalTimeGivesWorstCoreShare()
+  {
+    fresh( "total", "0-1" );
+    cpu( 0, 0 );
+    cpu( 1, 0 );
+    counter( 0, "core", 1, 100 );
+    counter( 1, "core", 5, 2000 );
+    auto s = sampler();
+    s.discover( false );
+    (void)s.sample( -1.0, 1000 );
+
+    counter( 0, "core", 2, 300 );   // 200 ms of 1000
+    counter( 1, "core", 7, 2250 );  // 250 ms of 1000
+    const auto m = s.sample( -1.0, 2000 );
+    QCOMPARE( m.coreThrottlePct, 25.0 );
+    QCOMPARE( m.coreThrottleEvents, uint64_t( 3 ) );
+  }
+
+  void countOnlyMarksWholeInterval()
+  {
+    fresh( "count", "0" );
+    cpu( 0, 0 );
+    counter( 0, "core", 4 );
+    auto s = sampler();
+    s.discover( false );
+    (void)s.sample( -1.0, 1000 );
+
+    QCOMPARE( s.sample( -1.0, 2000 ).coreThrottlePct, 0.0 );
+    counter( 0, "core", 5 );
+    QCOMPARE( s.sample( -1.0, 3000 ).coreThrottlePct, 100.0 );
+  }
+
+  void packageCountersReadOncePerPackage()
+  {
+    fresh( "packages", "0-3" );
+    for ( int i = 0; i < 4; ++i )
+    {
+      cpu( i, i / 2 );
+      counter( i, "package", 10, 0 );
+    }
+    auto s = sampler();
+    s.discover( false );
+    (void)s.sample( -1.0, 1000 );
+
+    for ( int i = 0; i < 4; ++i )
+      counter( i, "package", 12, 100 );
+    const auto m = s.sample( -1.0, 1500 );
+    // cpu0 and cpu2 represent the two packages
+    QCOMPARE( m.packageThrottleEvents, uint64_t( 4 ) );
+    QCOMPARE( m.packageThrottlePct, 20.0 );
+  }
+
+  void powerLimitHit()
+  {
+    fresh( "limits", "0" );
+    cpu( 0, 0 );
+    file( m_dir / "powercap" / "constraint_0_power_limit_uw", "45000000\n" );
+    file( m_dir / "powercap" / "constraint_1_power_limit_uw", "65000000\n" );
+    auto s = sampler();
+    s.discover( false );
+    QVERIFY( s.hasPowerLimits() );
+    QVERIFY( !s.hasThermalCounters() );
+
+    QCOMPARE( s.sample( 30.0, 1000 ).powerLimitedPct, 0.0 );
+    QCOMPARE( s.sample( 44.5, 2000 ).powerLimitedPct, 100.0 );
+    QCOMPARE( s.sample( -1.0, 3000 ).powerLimitedPct, -1.0 );
+
+    // a profile lowering PL1 takes effect without rediscovery
+    file( m_dir / "powercap" / "constraint_0_power_limit_uw", "25000000\n" );
+    QCOMPARE( s.sample( 30.0, 4000 ).powerLimitedPct, 100.0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestCpuThrottleSampler )
+
+#include "test_cpu_throttle_sampler.moc"
@@ -0,0 +1,125 @@
+/*
+ * Unit tests for CpuTopology – core classes from topology/core_type, the
+ * hybrid PMUs, cpu_capacity or a cpuinfo_max_freq gap, and the policy
+ * groups from related_cpus.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "CpuTopology.hpp"
+
+class TestCpuTopology : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir m_dir;
+
+  void file( const std::string &name, const std::string &content )
+  {
+    const std::filesystem::path path = m_dir.filePath( QString::fromStdString( name ) ).toStdString();
+    std::filesystem::create_directories( path.parent_path() );
+    std::ofstream( path, std::ios::trunc ) << content;
+  }
+
+  CpuTopology::Paths paths() const
+  {
+    return { m_dir.filePath( "cpu" ).toStdString(), m_dir.filePath( "pmu" ).toStdString() };
+  }
+
+  void cpus( int count, int maxKHz )
+  {
+    file( "cpu/present", "0-" + std::to_string( count - 1 ) + "\n" );
+    for ( int cpu = 0; cpu < count; ++cpu )
+      file( "cpu/cpu" + std::to_string( cpu ) + "/cpufreq/cpuinfo_max_freq", std::to_string( maxKHz ) + "\n" );
+  }
+
+  void maxFreq( int cpu, int maxKHz )
+  {
+    file( "cpu/cpu" + std::to_string( cpu ) + "/cpufreq/cpuinfo_max_freq", std::to_string( maxKHz ) + "\n" );
+  }
+
+private slots:
+
+  void init()
+  {
+    std::filesystem::remove_all( m_dir.filePath( "cpu" ).toStdString() );
+    std::filesystem::remove_all( m_dir.filePath( "pmu" ).toStdString() );
+  }
+
+  void uniformCpuHasNoClasses()
+  {
+    cpus( 4, 4'800'000 );
+    // favoured cores boost a little higher, that is no class
+    maxFreq( 2, 5'100'000 );
+    const auto topology = CpuTopology::discover( paths() );
+    QCOMPARE( topology.cores().size(), size_t( 4 ) );
+    QVERIFY( !topology.isHybrid() );
+    QVERIFY( topology.typeOf( 2 ) == CpuCoreType::Unknown );
+  }
+
+  void pmuListsWin()
+  {
+    cpus( 4, 4'800'000 );
+    file( "pmu/cpu_core/cpus", "0-1\n" );
+    file( "pmu/cpu_atom/cpus", "2-3\n" );
+    const auto topology = CpuTopology::discover( paths() );
+    QVERIFY( topology.isHybrid() );
+    QVERIFY( topology.typeOf( 1 ) == CpuCoreType::Performance );
+    QVERIFY( topology.typeOf( 2 ) == CpuCoreType::Efficiency );
+    QCOMPARE( topology.count( CpuCoreType::Efficiency ), size_t( 2 ) );
+  }
+
+  void coreTypeBeforePmu()
+  {
+    cpus( 2, 4'800'000 );
+    file( "cpu/cpu0/topology/core_type", "intel_atom\n" );
+    file( "cpu/cpu1/topology/core_type", "intel_core\n" );
+    file( "pmu/cpu_core/cpus", "0\n" );
+    file( "pmu/cpu_atom/cpus", "1\n" );
+    const auto topology = CpuTopology::discover( paths() );
+    QVERIFY( topology.typeOf( 0 ) == CpuCoreType::Efficiency );
+    QVERIFY( topology.typeOf( 1 ) == CpuCoreType::Performance );
+  }
+
+  void capacityClassifies()
+  {
+    cpus( 4, 3'000'000 );
+    for ( int cpu = 0; cpu < 4; ++cpu )
+      file( "cpu/cpu" + std::to_string( cpu ) + "/cpu_capacity", cpu < 2 ? "1024\n" : "870\n" );
+    const auto topology = CpuTopology::discover( paths() );
+    QVERIFY( topology.typeOf( 0 ) == CpuCoreType::Performance );
+    QVERIFY( topology.typeOf( 3 ) == CpuCoreType::Efficiency );
+    QCOMPARE( topology.cores()[ 3 ].capacity, 870 );
+  }
+
+  // Zen 4c: the dense cores top out far below the full ones
+  void frequencyGapClassifies()
+  {
+    cpus( 8, 5'100'000 );
+    for ( int cpu = 4; cpu < 8; ++cpu )
+      maxFreq( cpu, 3'500'000 );
+    file( "cpu/cpu4/cpufreq/related_cpus", "4 5\n" );
+    file( "cpu/cpu4/topology/cluster_id", "1\n" );
+    const auto topology = CpuTopology::discover( paths() );
+    QVERIFY( topology.typeOf( 3 ) == CpuCoreType::Performance );
+    QVERIFY( topology.typeOf( 4 ) == CpuCoreType::Efficiency );
+    QCOMPARE( topology.cores()[ 4 ].relatedCpus, ( std::vector< int32_t >{ 4, 5 } ) );
+    QCOMPARE( topology.cores()[ 4 ].clusterId, 1 );
+    // without related_cpus a CPU is its own policy
+    QCOMPARE( topology.cores()[ 0 ].relatedCpus, std::vector< int32_t >{ 0 } );
+  }
+
+  void missingTreeIsEmpty()
+  {
+    const auto topology = CpuTopology::discover( paths() );
+    QVERIFY( topology.cores().empty() );
+    QVERIFY( topology.typeOf( 0 ) == CpuCoreType::Unknown );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestCpuTopology )
+#include "test_cpu_topology.moc"
@@ -0,0 +1,170 @@
+/*
+ * Unit tests for DaemonWorker cycle timing statistics.
+ */
+
+#include <QTest>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "workers/DaemonWorker.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+  class SleepyWorker : public DaemonWorker
+  {
+  public:
+    SleepyWorker( std::chrono::milliseconds timeout, std::chrono::milliseconds work )
+      : DaemonWorker( timeout, false ), m_work( work )
+    {
+    }
+
+    ~SleepyWorker() override { stop(); }
+
+    std::atomic< int > starts { 0 };
+    std::atomic< int > works { 0 };
+    std::atomic< int > exits { 0 };
+
+  protected:
+    void onStart() override { ++starts; }
+    void onWork() override
+    {
+      std::this_thread::sleep_for( m_work );
+      ++works;
+    }
+    void onExit() override { ++exits; }
+
+  private:
+    std::chrono::milliseconds m_work;
+  };
+
+  template< typename Pred >
+  bool waitFor( Pred pred, std::chrono::milliseconds timeout = 2s )
+  {
+    const auto until = std::chrono::steady_clock::now() + timeout;
+    while ( !pred() )
+    {
+      if ( std::chrono::steady_clock::now() > until )
+        return false;
+      std::this_thread::sleep_for( 1ms );
+    }
+    return true;
+  }
+}
+
+class TestDaemonWorker : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void histogramBuckets()
+  {
+    QCOMPARE( DaemonWorkerStats::bucketOf( 0.3 ), size_t( 0 ) );
+    QCOMPARE( DaemonWorkerStats::bucketOf( 1.0 ), size_t( 1 ) );
+    QCOMPARE( DaemonWorkerStats::bucketOf( 3.9 ), size_t( 2 ) );
+    QCOMPARE( DaemonWorkerStats::bucketOf( 600.0 ), size_t( 10 ) );
+    QCOMPARE( DaemonWorkerStats::bucketOf( 1e6 ), DaemonWorkerStats::HISTOGRAM_BUCKETS - 1 );
+    QCOMPARE( DaemonWorkerStats::bucketOf( -5.0 ), size_t( 0 ) );
+  }
+
+  void lifecycleRunsOnceEach()
+  {
+    SleepyWorker w( 10ms, 0ms );
+    QVERIFY( w.isFinished() );
+    w.start();
+    QVERIFY( waitFor( [&] { return w.works.load() >= 3; } ) );
+    w.stop();
+    QVERIFY( w.isFinished() );
+    QCOMPARE( w.starts.load(), 1 );
+    QCOMPARE( w.exits.load(), 1 );
+  }
+
+  void stopIsImmediateDespiteLongPeriod()
+  {
+    SleepyWorker w( 60s, 0ms );
+    w.start();
+    QVERIFY( waitFor( [&] { return w.works.load() == 1; } ) );
+    const auto begin = std::chrono::steady_clock::now();
+    w.stop();
+    QVERIFY( std::chrono::steady_clock::now() - begin < 500ms );
+    QCOMPARE( w.exits.load(), 1 );
+  }
+
+  void statsCountOverrunsAndPeriods()
+  {
+    SleepyWorker w( 20ms, 30ms );
+    w.start();
+    QVERIFY( waitFor( [&] { return w.works.load() >= 5; } ) );
+    w.stop();
+
+    const DaemonWorkerStats s = w.stats();
+    QCOMPARE( s.cycles, uint64_t( w.works.load() ) );
+    QCOMPARE( s.overruns, s.cycles );
+    QCOMPARE( s.nominalPeriodMs, 20.0 );
+    QVERIFY( s.maxWorkMs >= 30.0 );
+    QVERIFY( s.totalWorkMs >= 30.0 * static_cast< double >( s.cycles ) );
+    // back-to-back cycles of the 30 ms work, each 10 ms late
+    QCOMPARE( s.periods, s.cycles - 1 );
+    QVERIFY( s.totalPeriodMs / static_cast< double >( s.periods ) >= 29.0 );
+    QVERIFY( s.maxLateMs >= 9.0 );
+    QCOMPARE( s.durationHistogram[ DaemonWorkerStats::bucketOf( 30.0 ) ] +
+              s.durationHistogram[ DaemonWorkerStats::bucketOf( 40.0 ) ], s.cycles );
+  }
+
+  void wakesAreNotPeriods()
+  {
+    SleepyWorker w( 60s, 0ms );
+    w.start();
+    QVERIFY( waitFor( [&] { return w.works.load() == 1; } ) );
+    w.wake();
+    QVERIFY( waitFor( [&] { return w.works.load() == 2; } ) );
+    w.stop();
+
+    const DaemonWorkerStats s = w.stats();
+    QCOMPARE( s.cycles, uint64_t( 2 ) );
+    QCOMPARE( s.wakes, uint64_t( 1 ) );
+    QCOMPARE( s.periods, uint64_t( 0 ) );
+    QCOMPARE( s.overruns, uint64_t( 0 ) );
+  }
+
+  void pauseSkipsCyclesUntilResume()
+  {
+    SleepyWorker w( 10ms, 0ms );
+    w.start();
+    QVERIFY( waitFor( [&] { return w.works.load() >= 2; } ) );
+    QVERIFY( !w.isPaused() );
+
+    w.pause();
+    QVERIFY( waitFor( [&] { return w.isPaused(); } ) );
+    const int worksWhilePaused = w.works.load();
+    std::this_thread::sleep_for( 50ms );
+    QCOMPARE( w.works.load(), worksWhilePaused );
+
+    w.resume();
+    QVERIFY( waitFor( [&] { return w.works.load() > worksWhilePaused; } ) );
+    QVERIFY( !w.isPaused() );
+    w.stop();
+    QCOMPARE( w.starts.load(), 1 );
+  }
+
+  void pausedWorkerStillExits()
+  {
+    SleepyWorker w( 60s, 0ms );
+    w.start();
+    QVERIFY( waitFor( [&] { return w.works.load() == 1; } ) );
+    w.pause();
+    QVERIFY( waitFor( [&] { return w.isPaused(); } ) );
+
+    const auto begin = std::chrono::steady_clock::now();
+    w.stop();
+    QVERIFY( std::chrono::steady_clock::now() - begin < 500ms );
+    QCOMPARE( w.works.load(), 1 );
+    QCOMPARE( w.exits.load(), 1 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestDaemonWorker )
+
+#include "test_daemon_worker.moc"
@@ -0,0 +1,76 @@
+/*
+ * Unit tests for DrmDisplayModes – refresh rates computed from DRM mode
+ * timings and the kernel's mode list grouped by resolution.
+ */
+
+#include <QTest>
+#include "DrmDisplayModes.hpp"
+
+namespace
+{
+drm_mode_modeinfo timing( uint32_t clockKHz, uint16_t htotal, uint16_t vtotal, uint32_t flags = 0 )
+{
+  drm_mode_modeinfo mode{};
+  mode.clock = clockKHz;
+  mode.htotal = htotal;
+  mode.vtotal = vtotal;
+  mode.flags = flags;
+  mode.vrefresh = 60;
+  return mode;
+}
+}
+
+class TestDrmDisplayModes : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void refreshRateFromTimings()
+  {
+    // a 2560x1600 panel and 1080p timings, rounded as xrandr prints them
+    QCOMPARE( DrmDisplayModes::refreshRate( timing( 750000, 2720, 1671 ) ), 165.01 );
+    QCOMPARE( DrmDisplayModes::refreshRate( timing( 148500, 2200, 1125 ) ), 60.0 );
+    QCOMPARE( DrmDisplayModes::refreshRate( timing( 74250, 2200, 1125, DRM_MODE_FLAG_INTERLACE ) ), 60.0 );
+    QCOMPARE( DrmDisplayModes::refreshRate( timing( 148500, 2200, 1125, DRM_MODE_FLAG_DBLSCAN ) ), 30.0 );
+  }
+
+  void missingTimingsFallBackToTheNominalRate()
+  {
+    QCOMPARE( DrmDisplayModes::refreshRate( timing( 148500, 0, 1125 ) ), 60.0 );
+  }
+
+  void modesAreGroupedByResolution()
+  {
+    const std::vector< DrmDisplayModes::Mode > modes{
+      { 2560, 1600, 165.0 }, { 2560, 1600, 60.0 }, { 1920, 1200, 165.0 }, { 2560, 1600, 165.0 }, { 1920, 1200, 60.0 },
+    };
+    const auto info = DrmDisplayModes::group( "eDP-1", modes, DrmDisplayModes::Mode{ 2560, 1600, 60.0 } );
+
+    QCOMPARE( info.displayName, std::string( "eDP-1" ) );
+    QCOMPARE( info.displayModes.size(), size_t( 2 ) );
+    QCOMPARE( info.displayModes[ 0 ].xResolution, 2560 );
+    QCOMPARE( info.displayModes[ 0 ].refreshRates, ( std::vector< double >{ 165.0, 60.0 } ) );
+    QCOMPARE( info.displayModes[ 1 ].yResolution, 1200 );
+    QCOMPARE( info.displayModes[ 1 ].refreshRates, ( std::vector< double >{ 165.0, 60.0 } ) );
+    QCOMPARE( info.activeMode.xResolution, 2560 );
+    QCOMPARE( info.activeMode.refreshRates, ( std::vector< double >{ 60.0 } ) );
+  }
+
+  void noActiveModeLeavesItEmpty()
+  {
+    const auto info = DrmDisplayModes::group( "LVDS-1", { { 1366, 768, 60.0 } }, std::nullopt );
+    QCOMPARE( info.displayModes.size(), size_t( 1 ) );
+    QCOMPARE( info.activeMode.xResolution, 0 );
+    QVERIFY( info.activeMode.refreshRates.empty() );
+  }
+
+  void missingDriDirectoryFindsNoPanel()
+  {
+    QVERIFY( not DrmDisplayModes::readInternalPanel( "/nonexistent/dri" ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestDrmDisplayModes )
+
+#include "test_drm_display_modes.moc"
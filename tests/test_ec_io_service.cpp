@@ -0,0 +1,200 @@
+/*
+ * Unit tests for EcIoService – reads coalesced within the window, writes
+ * ahead of reads and dropping the reads they affect, call() and several
+ * submitting threads.
+ */
+
+#include <QTest>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EcIoService.hpp"
+
+namespace
+{
+/// Two fans and a TDP; counts what reaches it
+class CountingDevice : public DeviceInterface
+{
+public:
+  CountingDevice() : DeviceInterface( m_noDevice ) {}
+
+  std::atomic< int > calls{ 0 };
+  std::vector< std::string > log;   ///< EC thread only
+  int temps[ 2 ] = { 50, 60 };
+  int duties[ 2 ] = { 0, 0 };
+  int tdp = 25;
+
+  bool identify( bool &identified ) override { identified = true; return true; }
+  bool deviceInterfaceIdStr( std::string &id ) override { id = "counting"; return true; }
+  bool deviceModelIdStr( std::string &id ) override { ++calls; id = "model"; return true; }
+  bool setEnableModeSet( bool ) override { return true; }
+  bool getNumberFans( int &nrFans ) override { nrFans = 2; return true; }
+  bool setFansAuto() override { ++calls; log.push_back( "auto" ); return true; }
+  bool setFanSpeedPercent( const int fan, const int percent ) override
+  {
+    ++calls;
+    log.push_back( "set" + std::to_string( fan ) );
+    duties[ fan ] = percent;
+    return true;
+  }
+  bool getFanSpeedPercent( const int fan, int &percent ) override
+  {
+    ++calls;
+    log.push_back( "speed" + std::to_string( fan ) );
+    percent = duties[ fan ];
+    return true;
+  }
+  bool getFanTemperature( const int fan, int &celsius ) override
+  {
+    ++calls;
+    log.push_back( "temp" + std::to_string( fan ) );
+    celsius = temps[ fan ];
+    return fan < 2;
+  }
+  bool getFansMinSpeed( int &minSpeed ) override { minSpeed = 0; return true; }
+  bool getFansOffAvailable( bool &offAvailable ) override { offAvailable = true; return true; }
+  bool setWebcam( const bool ) override { return true; }
+  bool getWebcam( bool &status ) override { status = true; return true; }
+  bool getAvailableODMPerformanceProfiles( std::vector< std::string > & ) override { return false; }
+  bool setODMPerformanceProfile( std::string ) override { return false; }
+  bool getDefaultODMPerformanceProfile( std::string & ) override { return false; }
+  bool getNumberTDPs( int &nrTDPs ) override { nrTDPs = 1; return true; }
+  bool getTDPDescriptors( std::vector< std::string > &descriptors ) override { descriptors = { "pl1" }; return true; }
+  bool getTDPMin( const int, int &value ) override { value = 10; return true; }
+  bool getTDPMax( const int, int &value ) override { value = 60; return true; }
+  bool setTDP( const int, const int value ) override { ++calls; tdp = value; return true; }
+  bool getTDP( const int, int &value ) override { ++calls; value = tdp; return true; }
+
+private:
+  IO m_noDevice{ "/nonexistent/tuxedo_io" };
+};
+}
+
+class TestEcIoService : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void readsWithinTheWindowAreCoalesced()
+  {
+    CountingDevice device;
+    std::atomic< int64_t > now{ 0 };
+    EcIoService ec( device, 250, [&now] { return now.load(); } );
+
+    EcBatch temps{ EcRequest::fanTemperature( 0 ), EcRequest::fanTemperature( 1 ), EcRequest::fanTemperature( 0 ) };
+    QVERIFY( ec.execute( temps ) );
+    QCOMPARE( temps[ 0 ].value, 50 );
+    QCOMPARE( temps[ 1 ].value, 60 );
+    QCOMPARE( temps[ 2 ].value, 50 );
+    QCOMPARE( device.calls.load(), 2 );
+
+    device.temps[ 0 ] = 70;
+    now = 100;
+    EcBatch again{ EcRequest::fanTemperature( 0 ) };
+    ec.execute( again );
+    QCOMPARE( again[ 0 ].value, 50 );
+    QCOMPARE( device.calls.load(), 2 );
+
+    now = 250;
+    ec.execute( again );
+    QCOMPARE( again[ 0 ].value, 70 );
+    QCOMPARE( device.calls.load(), 3 );
+    QCOMPARE( ec.stats().coalescedReads, uint64_t( 2 ) );
+    QCOMPARE( ec.stats().deviceCalls, uint64_t( 3 ) );
+  }
+
+  void failedRequestsReportPerRequest()
+  {
+    CountingDevice device;
+    EcIoService ec( device );
+    EcBatch batch{ EcRequest::fanTemperature( 0 ), EcRequest::fanTemperature( 2 ) };
+    QVERIFY( not ec.execute( batch ) );
+    QVERIFY( batch[ 0 ].ok );
+    QVERIFY( not batch[ 1 ].ok );
+  }
+
+  void writesRunFirstAndDropTheirReads()
+  {
+    CountingDevice device;
+    std::atomic< int64_t > now{ 0 };
+    EcIoService ec( device, 250, [&now] { return now.load(); } );
+
+    EcBatch readback{ EcRequest::fanSpeed( 0 ), EcRequest::fanSpeed( 1 ) };
+    ec.execute( readback );
+    QCOMPARE( readback[ 0 ].value, 0 );
+
+    EcBatch mixed{ EcRequest::fanSpeed( 0 ), EcRequest::fanSpeed( 1 ), EcRequest::setFanSpeed( 0, 40 ) };
+    QVERIFY( ec.execute( mixed ) );
+    // the write went first; fan 1 was not written and stays coalesced
+    QCOMPARE( mixed[ 0 ].value, 40 );
+    QCOMPARE( mixed[ 1 ].value, 0 );
+    const std::vector< std::string > expected{ "speed0", "speed1", "set0", "speed0" };
+    QCOMPARE( ec.call( [&device]( DeviceInterface & ) { return device.log; } ), expected );
+
+    EcBatch tdp{ EcRequest::tdp( 0 ) };
+    ec.execute( tdp );
+    EcBatch setTdp{ EcRequest::setTdp( 0, 35 ), EcRequest::tdp( 0 ) };
+    ec.execute( setTdp );
+    QCOMPARE( setTdp[ 1 ].value, 35 );
+  }
+
+  void callRunsOnTheEcThreadAndForgetsReads()
+  {
+    CountingDevice device;
+    EcIoService ec( device, 10'000 );
+
+    EcBatch temp{ EcRequest::fanTemperature( 0 ) };
+    ec.execute( temp );
+
+    std::thread::id ranOn;
+    const std::string model = ec.call( [&ranOn]( DeviceInterface &d ) {
+      ranOn = std::this_thread::get_id();
+      std::string id;
+      d.deviceModelIdStr( id );
+      return id;
+    } );
+    QCOMPARE( model, std::string( "model" ) );
+    QVERIFY( ranOn != std::this_thread::get_id() );
+
+    // the call may have changed anything: the next read goes to the device
+    const int before = device.calls.load();
+    ec.execute( temp );
+    QCOMPARE( device.calls.load(), before + 1 );
+
+    // nested use from the EC thread runs inline
+    const int nested = ec.call( [&ec]( DeviceInterface & ) {
+      EcBatch inner{ EcRequest::tdp( 0 ) };
+      ec.execute( inner );
+      return inner[ 0 ].value;
+    } );
+    QCOMPARE( nested, 25 );
+  }
+
+  void threadsShareTheDevice()
+  {
+    CountingDevice device;
+    EcIoService ec( device );
+    std::vector< std::thread > threads;
+    std::atomic< int > wrong{ 0 };
+    for ( int t = 0; t < 4; ++t )
+      threads.emplace_back( [&ec, &wrong] {
+        for ( int i = 0; i < 200; ++i )
+        {
+          EcBatch batch{ EcRequest::fanTemperature( 0 ), EcRequest::fanTemperature( 1 ) };
+          if ( not ec.execute( batch ) or batch[ 0 ].value != 50 or batch[ 1 ].value != 60 )
+            ++wrong;
+        }
+      } );
+    for ( auto &thread : threads )
+      thread.join();
+    QCOMPARE( wrong.load(), 0 );
+    // 1600 reads, mostly answered from the window
+    QVERIFY( ec.stats().deviceCalls < 1600 );
+    QCOMPARE( ec.stats().deviceCalls + ec.stats().coalescedReads, uint64_t( 1600 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestEcIoService )
+#include "test_ec_io_service.moc"
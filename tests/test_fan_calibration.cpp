@@ -0,0 +1,244 @@
+/*
+ * Unit tests for the fan response calibration – FanStepResponse,
+ * FanCalibrationRun against a simulated fan, FanResponseModel storage and
+ * FanControlLogic using a measured response.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <cmath>
+#include <fstream>
+#include "FanCalibration.hpp"
+#include "FanControlLogic.hpp"
+
+class TestFanCalibration : public QObject
+{
+  Q_OBJECT
+
+private:
+  /// First-order fan with a dead time that stops below a stall duty
+  struct SimFan
+  {
+    int64_t deadMs = 250;
+    double riseTauMs = 1000.0;
+    double fallTauMs = 3000.0;
+    int stallDuty = 20;
+
+    double speed = 0.0;
+    std::vector< std::pair< int64_t, int > > commands;  // (ms, duty)
+
+    int update( int64_t nowMs, int64_t dtMs )
+    {
+      int duty = 0;
+      for ( const auto &[ ms, d ] : commands )
+        if ( ms + deadMs <= nowMs )
+          duty = d;
+      const double target = duty < stallDuty ? 0.0 : duty;
+      const double tau = target > speed ? riseTauMs : fallTauMs;
+      speed += ( target - speed ) * ( 1.0 - std::exp( -static_cast< double >( dtMs ) / tau ) );
+      return static_cast< int >( std::lround( speed ) );
+    }
+  };
+
+  /// Run @p run against @p fans until it ends, at most @p limitMs
+  static void simulate( FanCalibrationRun &run, std::vector< SimFan > &fans, int64_t limitMs = 300'000 )
+  {
+    static constexpr int64_t TICK_MS = 250;
+    run.start( fans.size(), 0, 0 );
+    int duty = run.duty();
+    for ( SimFan &fan : fans )
+      fan.commands.emplace_back( 0, duty );
+    for ( int64_t now = TICK_MS; now < limitMs && run.running(); now += TICK_MS )
+    {
+      std::vector< int > speeds;
+      for ( SimFan &fan : fans )
+        speeds.push_back( fan.update( now, TICK_MS ) );
+      const int next = run.update( now, speeds );
+      if ( next != duty )
+        for ( SimFan &fan : fans )
+          fan.commands.emplace_back( now, next );
+      duty = next;
+    }
+  }
+
+  static FanProfile flatProfile()
+  {
+    return FanProfile( "flat", "Flat",
+                       { { 40, 20 }, { 80, 60 }, { 95, 100 } },
+                       { { 40, 20 }, { 80, 60 }, { 95, 100 } } );
+  }
+
+private slots:
+
+  // ---- FanStepResponse ----------------------------------------------
+
+  void step_up()
+  {
+    const auto r = FanStepResponse::analyze(
+      { { 250, 0 }, { 500, 10 }, { 750, 50 }, { 1000, 80 }, { 1250, 105 }, { 1500, 100 }, { 1750, 100 } }, 0 );
+    QVERIFY( r.has_value() );
+    QCOMPARE( r->deadTimeMs, 500 );
+    QCOMPARE( r->tauMs, 500 );
+    QCOMPARE( r->settleMs, 1250 );
+    QCOMPARE( r->overshootPct, 5 );
+  }
+
+  void step_downAndTooSmall()
+  {
+    const auto r = FanStepResponse::analyze( { { 500, 100 }, { 1000, 60 }, { 1500, 30 }, { 2000, 30 } }, 100 );
+    QVERIFY( r.has_value() );
+    QCOMPARE( r->deadTimeMs, 1000 );
+    QCOMPARE( r->tauMs, 500 );
+    QCOMPARE( r->overshootPct, 0 );
+
+    // a fan that did not follow has no response
+    QVERIFY( !FanStepResponse::analyze( { { 500, 52 }, { 1000, 52 } }, 50 ).has_value() );
+    QVERIFY( !FanStepResponse::analyze( {}, 0 ).has_value() );
+  }
+
+  // ---- FanCalibrationRun --------------------------------------------
+
+  void run_measuresSimulatedFans()
+  {
+    std::vector< SimFan > fans( 2 );
+    fans[ 1 ].riseTauMs = 2000.0;
+    fans[ 1 ].stallDuty = 30;
+
+    FanCalibrationRun run;
+    simulate( run, fans );
+    QCOMPARE( run.phase(), FanCalibrationRun::Phase::Done );
+    QCOMPARE( run.duty(), 0 );
+
+    const auto result = run.result();
+    QCOMPARE( result.size(), size_t( 2 ) );
+    // the lowest duty of the sweep that still turned the fan
+    QCOMPARE( result[ 0 ].minDuty, 20 );
+    QCOMPARE( result[ 1 ].minDuty, 30 );
+    for ( const FanResponse &fan : result )
+    {
+      QVERIFY( fan.deadTimeMs >= 250 && fan.deadTimeMs <= 750 );
+      QVERIFY( fan.settleMs > fan.riseTauMs );
+      QCOMPARE( fan.overshootPct, 0 );
+    }
+    QVERIFY( std::abs( result[ 0 ].riseTauMs - 1000 ) <= 500 );
+    QVERIFY( std::abs( result[ 1 ].riseTauMs - 2000 ) <= 500 );
+    QVERIFY( std::abs( result[ 0 ].fallTauMs - 3000 ) <= 750 );
+  }
+
+  void run_failsWhenSpeedDoesNotFollow()
+  {
+    FanCalibrationRun run;
+    run.start( 1, 0, 0 );
+    int64_t now = 0;
+    while ( run.running() && now < 100'000 )
+    {
+      now += 250;
+      run.update( now, { 40 } );
+    }
+    QCOMPARE( run.phase(), FanCalibrationRun::Phase::Failed );
+    QVERIFY( !run.error().empty() );
+    // settle times out at once (stable), then the step up times out
+    QVERIFY( now <= FanCalibrationRun::STABLE_MS + FanCalibrationRun::STEP_TIMEOUT_MS + 250 );
+  }
+
+  void run_failAndIdleStopCommanding()
+  {
+    FanCalibrationRun run;
+    QVERIFY( !run.running() );
+    QCOMPARE( run.update( 1000, { 50 } ), 0 );
+
+    run.start( 1, 25, 0 );
+    QCOMPARE( run.duty(), 25 );
+    QVERIFY( run.running() );
+    run.fail( "cancelled" );
+    QVERIFY( !run.running() );
+    QCOMPARE( std::string( FanCalibrationRun::phaseName( run.phase() ) ), std::string( "failed" ) );
+  }
+
+  // ---- FanResponseModel ---------------------------------------------
+
+  void model_loadsBackForTheSameMachineOnly()
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath( "state/fan-response" ).toStdString();
+
+    const FanResponseModel model{ "TUXEDO/NL5xNU/SKU", { { 20, 500, 1250, 4000, 3500, 4 }, { 30, 250, 2000, 5000, 6000, 0 } } };
+    QVERIFY( model.save( path ) );
+
+    const auto loaded = FanResponseModel::load( model.dmi, path );
+    QVERIFY( loaded.has_value() );
+    QCOMPARE( loaded->fans.size(), size_t( 2 ) );
+    QVERIFY( loaded->fans[ 0 ] == model.fans[ 0 ] );
+    QVERIFY( loaded->fans[ 1 ] == model.fans[ 1 ] );
+
+    QVERIFY( !FanResponseModel::load( "TUXEDO/other/SKU", path ).has_value() );
+    FanResponseModel::forget( path );
+    QVERIFY( !FanResponseModel::load( model.dmi, path ).has_value() );
+  }
+
+  void model_damagedFilesAreIgnored()
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath( "fan-response" ).toStdString();
+    std::ofstream( path, std::ios::trunc ) << "ucc-fan-response 1\ndmi\tX\n20\t500\tbroken\n";
+    QVERIFY( !FanResponseModel::load( "X", path ).has_value() );
+    std::ofstream( path, std::ios::trunc ) << "ucc-fan-response 1\ndmi\tX\n";
+    QVERIFY( !FanResponseModel::load( "X", path ).has_value() );
+  }
+
+  void model_json()
+  {
+    std::string json;
+    JsonWriter w( json );
+    FanResponseModel::fansJSON( w, { { 20, 500, 1250, 4000, 3500, 4 } } );
+    QCOMPARE( json, std::string( "[{\"minDuty\":20,\"deadTimeMs\":500,\"riseTauMs\":1250,\"fallTauMs\":4000,"
+                                 "\"settleMs\":3500,\"overshootPct\":4}]" ) );
+  }
+
+  // ---- FanControlLogic ----------------------------------------------
+
+  void logic_measuredMinimumDutyReplacesStalls()
+  {
+    FanControlLogic logic( flatProfile(), FanLogicType::CPU );
+    logic.reportTemperature( 40 );
+    QCOMPARE( logic.getSpeedPercent(), 20 );
+
+    FanControlLogic tuned( flatProfile(), FanLogicType::CPU );
+    tuned.setResponseModel( FanResponse{ 25, 0, 0, 0, 0, 0 } );
+    QCOMPARE( tuned.minSpeed(), 25 );
+    tuned.reportTemperature( 40 );
+    QCOMPARE( tuned.getSpeedPercent(), 25 );
+
+    // the firmware minimum still applies where it is higher
+    tuned.setFansMinSpeedHWLimit( 30 );
+    QCOMPARE( tuned.minSpeed(), 30 );
+  }
+
+  void logic_slowFanShortensSmoothing()
+  {
+    FanControlLogic defaults( flatProfile(), FanLogicType::CPU );
+    FanControlLogic tuned( flatProfile(), FanLogicType::CPU );
+    tuned.setResponseModel( FanResponse{ 0, 500, 1000, 6000, 0, 0 } );
+
+    defaults.reportTemperature( 40 );
+    tuned.reportTemperature( 40 );
+    for ( int i = 0; i < 3; ++i )
+    {
+      defaults.reportTemperature( 80 );
+      tuned.reportTemperature( 80 );
+    }
+    QVERIFY( tuned.getSpeedPercent() > defaults.getSpeedPercent() );
+
+    // a default response restores the default smoothing
+    FanControlLogic reset( flatProfile(), FanLogicType::CPU );
+    reset.setResponseModel( FanResponse{ 0, 500, 1000, 6000, 0, 0 } );
+    reset.setResponseModel( FanResponse{} );
+    reset.reportTemperature( 40 );
+    for ( int i = 0; i < 3; ++i )
+      reset.reportTemperature( 80 );
+    QCOMPARE( reset.getSpeedPercent(), defaults.getSpeedPercent() );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestFanCalibration )
+#include "test_fan_calibration.moc"
@@ -0,0 +1,285 @@
+/*
+ * Unit tests for the closed-loop fan controller – FanPidController,
+ * FanControlLogic in FanControlMode::Pid – FanLoadPredictor and
+ * FanWriteLimiter
+ */
+
+#include <QTest>
+#include "FanControlLogic.hpp"
+
+class TestFanControlLogic : public QObject
+{
+  Q_OBJECT
+
+private:
+  static FanControllerSettings pidSettings()
+  {
+    FanControllerSettings s;
+    s.mode = FanControlMode::Pid;
+    s.targetTemp = 75;
+    return s;
+  }
+
+  static FanProfile makeProfile( FanControllerSettings controller )
+  {
+    // CPU: 40°→20%  80°→60%  (flat 20 % below 40 °C)
+    FanProfile fp( "pid", "PID",
+                   { { 40, 20 }, { 80, 60 }, { 95, 100 } },
+                   { { 40, 20 }, { 80, 60 }, { 95, 100 } } );
+    fp.controller = controller;
+    return fp;
+  }
+
+private slots:
+
+  // ---- FanPidController ---------------------------------------------
+
+  void pid_firstUpdateStartsAtLowerLimit()
+  {
+    FanPidController pid;
+    QCOMPARE( pid.update( pidSettings(), 60.0, 30.0, 1.0, 25.0 ), 25.0 );
+  }
+
+  void pid_feedForwardLeadsTemperature()
+  {
+    const auto s = pidSettings();
+    FanPidController pid;
+    pid.update( s, 60.0, 10.0, 1.0, 20.0 );
+    const double idle = pid.update( s, 60.0, 10.0, 1.0, 20.0 );
+
+    // render start: power steps up, the sensor has not moved yet
+    const double loaded = pid.update( s, 60.0, 80.0, 1.0, 20.0 );
+    QVERIFY( loaded - idle >= 0.9 * s.feedForwardPerWatt * 70.0 );
+  }
+
+  void pid_unknownPowerHasNoFeedForward()
+  {
+    const auto s = pidSettings();
+    FanPidController a;
+    FanPidController b;
+    a.update( s, 80.0, -1.0, 1.0, 0.0 );
+    b.update( s, 80.0, 0.0, 1.0, 0.0 );
+    QCOMPARE( a.update( s, 80.0, -1.0, 1.0, 0.0 ), b.update( s, 80.0, 0.0, 1.0, 0.0 ) );
+  }
+
+  void pid_risingTemperatureAddsDerivative()
+  {
+    auto s = pidSettings();
+    s.ki = 0.0;
+    FanPidController steady;
+    FanPidController rising;
+    steady.update( s, 70.0, -1.0, 1.0, 0.0 );
+    rising.update( s, 68.0, -1.0, 1.0, 0.0 );
+    QVERIFY( rising.update( s, 70.0, -1.0, 1.0, 0.0 ) > steady.update( s, 70.0, -1.0, 1.0, 0.0 ) );
+  }
+
+  void pid_antiWindupReleasesPromptly()
+  {
+    const auto s = pidSettings();
+    FanPidController pid;
+    pid.update( s, 75.0, 10.0, 1.0, 0.0 );
+    // long saturation at 100 %
+    for ( int i = 0; i < 600; ++i )
+      QCOMPARE( pid.update( s, 95.0, 100.0, 1.0, 0.0 ), 100.0 );
+
+    // load gone and well below target: the integral must not keep it pinned
+    double out = 100.0;
+    for ( int i = 0; i < 10; ++i )
+      out = pid.update( s, 60.0, 10.0, 1.0, 0.0 );
+    QVERIFY( out < 50.0 );
+  }
+
+  void pid_holdsTargetOnThermalPlant()
+  {
+    // first-order plant: 40 °C ambient, 1 °C per W, fans remove up to 60 %
+    const auto s = pidSettings();
+    FanPidController pid;
+    double temp = 45.0;
+    double fan = 0.0;
+    for ( int i = 0; i < 900; ++i )
+    {
+      const double watts = i < 60 ? 10.0 : 60.0;
+      fan = pid.update( s, temp, watts, 1.0, 0.0 );
+      const double equilibrium = 40.0 + watts * ( 1.0 - 0.6 * fan / 100.0 );
+      temp += ( equilibrium - temp ) / 20.0;
+    }
+    QVERIFY( std::abs( temp - 75.0 ) < 1.0 );
+    QVERIFY( fan > 0.0 && fan < 100.0 );
+  }
+
+  // ---- FanControlLogic in PID mode -----------------------------------
+
+  void logic_curveIsLowerBound()
+  {
+    FanControlLogic logic( makeProfile( pidSettings() ), FanLogicType::CPU );
+    // far below target the PID asks for nothing; the curve still holds 40 %
+    for ( int i = 0; i < 30; ++i )
+      logic.reportTemperature( 60, 1.0, 5.0 );
+    QCOMPARE( logic.getSpeedPercent(), 40 );
+  }
+
+  void logic_releaseIsRateLimited()
+  {
+    FanControlLogic logic( makeProfile( pidSettings() ), FanLogicType::CPU );
+    for ( int i = 0; i < 30; ++i )
+      logic.reportTemperature( 88, 1.0, 90.0 );
+    const int loaded = logic.getSpeedPercent();
+    QVERIFY( loaded >= 90 );
+
+    logic.reportTemperature( 88, 1.0, 5.0 );
+    QVERIFY( loaded - logic.getSpeedPercent() <= static_cast< int >( FanControlLogic::PID_RELEASE_PCT_PER_S ) + 1 );
+  }
+
+  void logic_defaultControllerKeepsCurve()
+  {
+    FanControlLogic curve( makeProfile( FanControllerSettings() ), FanLogicType::CPU );
+    curve.reportTemperature( 60, 1.0, 90.0 );
+    QCOMPARE( curve.getSpeedPercent(), 40 );
+  }
+
+  void logic_switchingModeIsBumpless()
+  {
+    FanControlLogic logic( makeProfile( FanControllerSettings() ), FanLogicType::CPU );
+    for ( int i = 0; i < 10; ++i )
+      logic.reportTemperature( 70, 1.0, 30.0 );
+    const int before = logic.getSpeedPercent();
+
+    logic.updateFanProfile( makeProfile( pidSettings() ) );
+    logic.reportTemperature( 70, 1.0, 30.0 );
+    QVERIFY( std::abs( logic.getSpeedPercent() - before ) <= 1 );
+  }
+
+  // ---- FanLoadPredictor / pre-ramp ----------------------------------
+
+  static FanPowerTrend flat( double watts )
+  {
+    return FanPowerTrend{ 4, watts, 0.0 };
+  }
+
+  void trend_fromSamples()
+  {
+    struct Point { int64_t timestampMs; double value; };
+    const std::vector< Point > ramp{ { 10'000, 10.0 }, { 11'000, 20.0 }, { 12'000, 30.0 }, { 13'000, 40.0 } };
+    const FanPowerTrend trend = FanPowerTrend::fromSamples( ramp );
+    QCOMPARE( trend.samples, size_t( 4 ) );
+    QCOMPARE( trend.minWatts, 10.0 );
+    QVERIFY( std::abs( trend.slopeWps - 10.0 ) < 1e-9 );
+
+    QCOMPARE( FanPowerTrend::fromSamples( std::vector< Point >{ { 0, 5.0 } } ).slopeWps, 0.0 );
+  }
+
+  void predictor_disabledByDefault()
+  {
+    FanLoadPredictor predictor;
+    const FanControllerSettings s;
+    predictor.update( s, flat( 10.0 ), 1.0 );
+    QCOMPARE( predictor.update( s, flat( 60.0 ), 1.0 ), 0.0 );
+  }
+
+  void predictor_sustainedStepBoostsThenDecays()
+  {
+    FanControllerSettings s;
+    s.preRampDegPerWatt = 0.25;
+    FanLoadPredictor predictor;
+    for ( int i = 0; i < 10; ++i )
+      QCOMPARE( predictor.update( s, flat( 10.0 ), 1.0 ), 0.0 );
+
+    // the whole window sits 30 W higher: 0.25 °C/W × 30 W = 7.5 °C
+    const double boost = predictor.update( s, flat( 40.0 ), 1.0 );
+    QVERIFY( std::abs( boost - 7.5 ) < 0.5 );
+
+    double later = boost;
+    for ( int i = 0; i < 60; ++i )
+      later = predictor.update( s, flat( 40.0 ), 1.0 );
+    QVERIFY( later < 0.5 * boost );
+  }
+
+  void predictor_ignoresSpikesAndCaps()
+  {
+    FanControllerSettings s;
+    s.preRampDegPerWatt = 1.0;
+    s.preRampMaxDeg = 6;
+    FanLoadPredictor predictor;
+    predictor.update( s, flat( 10.0 ), 1.0 );
+
+    // a spike leaves the window minimum at idle
+    QCOMPARE( predictor.update( s, FanPowerTrend{ 4, 10.0, 20.0 }, 1.0 ), 0.0 );
+    QCOMPARE( predictor.update( s, flat( 90.0 ), 1.0 ), 6.0 );
+  }
+
+  void logic_preRampRaisesCurveBeforeTemperature()
+  {
+    auto controller = FanControllerSettings();
+    controller.preRampDegPerWatt = 0.5;
+    FanControlLogic ramped( makeProfile( controller ), FanLogicType::CPU );
+    FanControlLogic plain( makeProfile( FanControllerSettings() ), FanLogicType::CPU );
+    QVERIFY( ramped.wantsPowerTrend() );
+    QVERIFY( !plain.wantsPowerTrend() );
+
+    for ( int i = 0; i < 10; ++i )
+    {
+      ramped.reportTemperature( 60, 1.0, 10.0, flat( 10.0 ) );
+      plain.reportTemperature( 60, 1.0, 10.0, flat( 10.0 ) );
+    }
+    QCOMPARE( ramped.getSpeedPercent(), plain.getSpeedPercent() );
+
+    // render start: 40 W step, sensor still at 60 °C
+    ramped.reportTemperature( 60, 1.0, 50.0, flat( 50.0 ) );
+    plain.reportTemperature( 60, 1.0, 50.0, flat( 50.0 ) );
+    QCOMPARE( ramped.getPreRampDeg(), static_cast< int >( controller.preRampMaxDeg ) );
+    QVERIFY( ramped.getSpeedPercent() > plain.getSpeedPercent() );
+  }
+
+  // ---- FanWriteLimiter -----------------------------------------------
+
+  void writes_firstAndAfterInvalidate()
+  {
+    FanWriteLimiter limiter;
+    limiter.resize( 2 );
+    QVERIFY( limiter.shouldWrite( 0, 40, 1000 ) );
+    limiter.written( 0, 40, 1000 );
+    QVERIFY( !limiter.shouldWrite( 0, 40, 1500 ) );
+    QCOMPARE( limiter.sent( 0 ), 40 );
+    QCOMPARE( limiter.sent( 1 ), -1 );
+
+    limiter.invalidate();
+    QVERIFY( limiter.shouldWrite( 0, 40, 2000 ) );
+  }
+
+  void writes_deadband()
+  {
+    FanWriteLimiter limiter;
+    limiter.resize( 1 );
+    limiter.written( 0, 40, 1000 );
+    QVERIFY( !limiter.shouldWrite( 0, 40 + FanWriteLimiter::DEADBAND_PCT - 1, 1500 ) );
+    QVERIFY( !limiter.shouldWrite( 0, 40 - FanWriteLimiter::DEADBAND_PCT + 1, 1500 ) );
+    QVERIFY( limiter.shouldWrite( 0, 40 + FanWriteLimiter::DEADBAND_PCT, 1500 ) );
+    QVERIFY( limiter.shouldWrite( 0, 40 - FanWriteLimiter::DEADBAND_PCT, 1500 ) );
+  }
+
+  void writes_offOnAndFullIgnoreDeadband()
+  {
+    FanWriteLimiter limiter;
+    limiter.resize( 1 );
+    limiter.written( 0, 0, 1000 );
+    QVERIFY( limiter.shouldWrite( 0, 1, 1500 ) );
+    limiter.written( 0, 1, 1500 );
+    QVERIFY( limiter.shouldWrite( 0, 0, 2000 ) );
+    limiter.written( 0, 99, 2000 );
+    QVERIFY( limiter.shouldWrite( 0, 100, 2500 ) );
+  }
+
+  void writes_refreshAfterTimeout()
+  {
+    FanWriteLimiter limiter;
+    limiter.resize( 1 );
+    limiter.written( 0, 40, 1000 );
+    QVERIFY( !limiter.shouldWrite( 0, 41, 1000 + FanWriteLimiter::REFRESH_MS - 1 ) );
+    QVERIFY( limiter.shouldWrite( 0, 41, 1000 + FanWriteLimiter::REFRESH_MS ) );
+    QVERIFY( limiter.shouldWrite( 0, 40, 1000 + FanWriteLimiter::REFRESH_MS ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestFanControlLogic )
+
+#include "test_fan_control_logic.moc"
@@ -0,0 +1,174 @@
+/*
+ * Unit tests for SensorTrace (record file round trip) and FanCurveReplay
+ * (offline fan-curve evaluation against a trace).
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "FanCurveReplay.hpp"
+
+using ucc::SensorTrace;
+using ucc::SensorTraceWriter;
+
+class TestFanCurveReplay : public QObject
+{
+  Q_OBJECT
+
+private:
+  /// CPU-only trace, one sample per second: temps[i] °C at duties[i] %
+  static SensorTrace cpuTrace( const std::vector< double > &temps, const std::vector< double > &duties )
+  {
+    SensorTrace trace;
+    trace.metrics = { "cpuTemp", "cpuFanDuty", "cpuPower" };
+    for ( size_t i = 0; i < temps.size(); ++i )
+    {
+      trace.timestamps.push_back( static_cast< int64_t >( i ) * 1000 );
+      trace.values.push_back( static_cast< float >( temps[ i ] ) );
+      trace.values.push_back( static_cast< float >( duties[ i ] ) );
+      trace.values.push_back( 20.0f );
+    }
+    return trace;
+  }
+
+  static FanProfile flat( int speed )
+  {
+    return FanProfile( "flat", "Flat", { { 0, speed }, { 100, speed } }, { { 0, speed }, { 100, speed } } );
+  }
+
+  static bool near( double a, double b, double eps = 1e-6 ) { return std::fabs( a - b ) < eps; }
+
+private slots:
+
+  // ---- SensorTrace -----------------------------------------------------
+
+  void traceRoundTrip()
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath( "run.trace" ).toStdString();
+
+    SensorTraceWriter writer;
+    QVERIFY( writer.open( path, { "cpuTemp", "cpuFanDuty", "gpuTemp" } ) );
+    writer.sample( 1000, std::vector< double >{ 55.0, 30.0, 60.0 } );
+    writer.sample( 2000, std::vector< double >{ 56.5 } );   // short row: rest is NaN
+
+    ucc::MetricEventRecord event{};
+    event.timestampMs = 1500;
+    event.kind = static_cast< uint16_t >( ucc::MetricEventKind::ProfileSwitch );
+    std::strcpy( event.label, "Quiet" );
+    writer.event( event );
+    QVERIFY( writer.flush() );
+
+    const auto trace = SensorTrace::load( path );
+    QVERIFY( trace.has_value() );
+    QCOMPARE( trace->metrics.size(), size_t( 3 ) );
+    QCOMPARE( trace->metrics[ 2 ], std::string( "gpuTemp" ) );
+    QCOMPARE( trace->samples(), size_t( 2 ) );
+    QCOMPARE( trace->timestamps[ 1 ], int64_t( 2000 ) );
+    QCOMPARE( trace->value( 0, 1 ), 30.0 );
+    QCOMPARE( trace->value( 1, 0 ), 56.5 );
+    QVERIFY( std::isnan( trace->value( 1, 2 ) ) );
+    QCOMPARE( trace->events.size(), size_t( 1 ) );
+    QVERIFY( trace->events[ 0 ].labelView() == "Quiet" );
+    QCOMPARE( *trace->column( "cpuFanDuty" ), size_t( 1 ) );
+    QVERIFY( !trace->column( "batPower" ).has_value() );
+  }
+
+  void truncatedRecordIsDropped()
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath( "cut.trace" ).toStdString();
+    {
+      SensorTraceWriter writer;
+      QVERIFY( writer.open( path, { "cpuTemp" } ) );
+      writer.sample( 1000, std::vector< double >{ 50.0 } );
+      QVERIFY( writer.flush() );
+    }
+    std::ofstream( path, std::ios::binary | std::ios::app ) << SensorTrace::SAMPLE_TAG << "abc";
+
+    const auto trace = SensorTrace::load( path );
+    QVERIFY( trace.has_value() );
+    QCOMPARE( trace->samples(), size_t( 1 ) );
+  }
+
+  void rejectsForeignFile()
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath( "other.bin" ).toStdString();
+    std::ofstream( path, std::ios::binary ) << "not a trace at all";
+    QVERIFY( !SensorTrace::load( path ).has_value() );
+    QVERIFY( !SensorTrace::load( dir.filePath( "missing" ).toStdString() ).has_value() );
+  }
+
+  // ---- FanCurveReplay --------------------------------------------------
+
+  void recordedStatsAreTimeWeighted()
+  {
+    std::vector< double > temps, duties;
+    for ( int i = 0; i < 20; ++i )
+    {
+      temps.push_back( i < 10 ? 80.0 : 90.0 );
+      duties.push_back( i < 10 ? 40.0 : 100.0 );
+    }
+    FanReplayOptions options;
+    options.thresholdC = 85.0;
+
+    const auto result = FanCurveReplay::recorded( cpuTrace( temps, duties ), options );
+    QVERIFY( near( result.seconds, 19.0 ) );
+    QVERIFY( result.cpu.available );
+    QVERIFY( !result.gpu.available );
+    QVERIFY( near( result.cpu.secondsAbove, 10.0 ) );
+    QVERIFY( near( result.cpu.avgDuty, ( 9 * 40.0 + 10 * 100.0 ) / 19.0 ) );
+    QCOMPARE( result.cpu.maxDuty, 100 );
+    QCOMPARE( result.cpu.steps, 1 );
+    QCOMPARE( result.cpu.maxTemp, 90.0 );
+  }
+
+  void flatCurveWithoutThermalModel()
+  {
+    const auto trace = cpuTrace( std::vector< double >( 60, 60.0 ), std::vector< double >( 60, 50.0 ) );
+    FanReplayOptions options;
+    options.thermalGainCPerPct = 0.0;
+
+    const auto result = FanCurveReplay::simulate( trace, flat( 30 ), options );
+    QVERIFY( near( result.cpu.avgDuty, 30.0 ) );
+    QCOMPARE( result.cpu.maxDuty, 30 );
+    QCOMPARE( result.cpu.steps, 0 );
+    QCOMPARE( result.cpu.maxTemp, 60.0 );
+    QVERIFY( result.cpu.noiseDb < FanCurveReplay::recorded( trace, options ).cpu.noiseDb );
+  }
+
+  void quieterCurveRunsWarmer()
+  {
+    const auto trace = cpuTrace( std::vector< double >( 300, 80.0 ), std::vector< double >( 300, 60.0 ) );
+    FanReplayOptions options;
+    options.thresholdC = 82.0;
+
+    // 30 % below the recorded duty: the chip settles ~4.5 °C warmer
+    const auto quiet = FanCurveReplay::simulate( trace, flat( 30 ), options );
+    QVERIFY( quiet.cpu.secondsAbove > 100.0 );
+    QVERIFY( quiet.cpu.maxTemp > 83.0 && quiet.cpu.maxTemp < 85.0 );
+
+    options.thermalGainCPerPct = 0.0;
+    QCOMPARE( FanCurveReplay::simulate( trace, flat( 30 ), options ).cpu.secondsAbove, 0.0 );
+
+    // same duty as recorded: no shift
+    options.thermalGainCPerPct = 0.15;
+    QCOMPARE( FanCurveReplay::simulate( trace, flat( 60 ), options ).cpu.secondsAbove, 0.0 );
+  }
+
+  void gapsAreNotIntegrated()
+  {
+    SensorTrace trace = cpuTrace( { 50.0, 50.0 }, { 30.0, 30.0 } );
+    trace.timestamps[ 1 ] = 3'600'000;   // resumed an hour later
+    QCOMPARE( FanCurveReplay::recorded( trace, {} ).seconds, 0.0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestFanCurveReplay )
+
+#include "test_fan_curve_replay.moc"
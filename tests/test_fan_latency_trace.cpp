@@ -0,0 +1,97 @@
+/*
+ * Unit tests for FanLatencyTrace – log2 bucketing, snapshot quantiles
+ * and the Span helper.
+ */
+
+#include <QTest>
+#include "FanLatencyTrace.hpp"
+
+class TestFanLatencyTrace : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void bucketBoundaries()
+  {
+    QCOMPARE( LatencyHistogram::bucketFor( 0 ), size_t( 0 ) );
+    QCOMPARE( LatencyHistogram::bucketFor( 1000 ), size_t( 0 ) );
+    QCOMPARE( LatencyHistogram::bucketFor( 1001 ), size_t( 1 ) );
+    QCOMPARE( LatencyHistogram::bucketFor( 2000 ), size_t( 1 ) );
+    QCOMPARE( LatencyHistogram::bucketFor( 2001 ), size_t( 2 ) );
+    QCOMPARE( LatencyHistogram::bucketFor( 1024000 ), size_t( 10 ) );
+    QCOMPARE( LatencyHistogram::bucketFor( 1024001 ), size_t( 11 ) );
+    QCOMPARE( LatencyHistogram::bucketFor( uint64_t( 1 ) << 40 ), LatencySnapshot::BUCKETS - 1 );
+  }
+
+  void everyValueFitsItsBucketBound()
+  {
+    for ( uint64_t us = 1; us < 5000; us += 7 )
+    {
+      const size_t i = LatencyHistogram::bucketFor( us * 1000 );
+      QVERIFY( us <= LatencySnapshot::upperUs( i ) );
+      if ( i > 0 )
+        QVERIFY( us > LatencySnapshot::upperUs( i - 1 ) );
+    }
+  }
+
+  void snapshotCountsAndQuantiles()
+  {
+    FanLatencyTrace trace;
+    QCOMPARE( trace.snapshot( FanTraceStage::EcWrite ).quantileUpperUs( 0.5 ), uint64_t( 0 ) );
+
+    // 90 fast writes (~3 µs) and 10 slow ones (~300 µs)
+    for ( int i = 0; i < 90; ++i )
+      trace.record( FanTraceStage::EcWrite, 3000 );
+    for ( int i = 0; i < 10; ++i )
+      trace.record( FanTraceStage::EcWrite, 300000 );
+
+    const LatencySnapshot s = trace.snapshot( FanTraceStage::EcWrite );
+    QCOMPARE( s.count, uint64_t( 100 ) );
+    QCOMPARE( s.totalNs, uint64_t( 90 * 3000 + 10 * 300000 ) );
+    QCOMPARE( s.maxNs, uint64_t( 300000 ) );
+    QCOMPARE( s.quantileUpperUs( 0.50 ), uint64_t( 4 ) );
+    QCOMPARE( s.quantileUpperUs( 0.90 ), uint64_t( 4 ) );
+    QCOMPARE( s.quantileUpperUs( 0.95 ), uint64_t( 512 ) );
+
+    // stages are independent
+    QCOMPARE( trace.snapshot( FanTraceStage::SensorRead ).count, uint64_t( 0 ) );
+  }
+
+  void overflowQuantileUsesMax()
+  {
+    FanLatencyTrace trace;
+    trace.record( FanTraceStage::Cycle, uint64_t( 5 ) * 1000 * 1000 * 1000 );
+    QCOMPARE( trace.snapshot( FanTraceStage::Cycle ).quantileUpperUs( 0.99 ), uint64_t( 5 ) * 1000 * 1000 );
+  }
+
+  void spanRecordsOnce()
+  {
+    FanLatencyTrace trace;
+    {
+      FanLatencyTrace::Span span( &trace, FanTraceStage::Filter );
+    }
+    QCOMPARE( trace.snapshot( FanTraceStage::Filter ).count, uint64_t( 1 ) );
+
+    // tracing disabled
+    {
+      FanLatencyTrace::Span span( nullptr, FanTraceStage::Filter );
+    }
+    QCOMPARE( trace.snapshot( FanTraceStage::Filter ).count, uint64_t( 1 ) );
+  }
+
+  void negativeIntervalClampsToZero()
+  {
+    FanLatencyTrace trace;
+    const auto now = FanLatencyTrace::Clock::now();
+    trace.record( FanTraceStage::ReadToWrite, now, now - std::chrono::milliseconds( 5 ) );
+    const LatencySnapshot s = trace.snapshot( FanTraceStage::ReadToWrite );
+    QCOMPARE( s.count, uint64_t( 1 ) );
+    QCOMPARE( s.totalNs, uint64_t( 0 ) );
+    QCOMPARE( s.buckets[ 0 ], uint64_t( 1 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestFanLatencyTrace )
+
+#include "test_fan_latency_trace.moc"
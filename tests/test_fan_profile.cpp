@@ -142,6 +142,65 @@ private slots:
     QCOMPARE( fp.getWaterCoolerFanSpeedForTemp( 50 ), 30 );
   }
 
+  // ---- compileCurves() – per-degree lookup tables ----------------------
+
+  void lut_emptyUntilCompiled()
+  {
+    auto fp = makeSimple();
+    QVERIFY( fp.cpuCurve().empty() );
+    QCOMPARE( fp.cpuCurve()( 50 ), -1 );
+    fp.compileCurves();
+    QVERIFY( !fp.cpuCurve().empty() );
+  }
+
+  void lut_matchesInterpolation()
+  {
+    auto fp = makeSimple();
+    fp.compileCurves();
+    for ( int32_t t = 0; t <= FanCurveLut::MAX_TEMP; ++t )
+    {
+      QCOMPARE( fp.cpuCurve()( t ), fp.getSpeedForTemp( t, true ) );
+      QCOMPARE( fp.gpuCurve()( t ), fp.getSpeedForTemp( t, false ) );
+      QCOMPARE( fp.waterCoolerFanCurve()( t ), fp.getWaterCoolerFanSpeedForTemp( t ) );
+    }
+  }
+
+  void lut_clampsOutOfRange()
+  {
+    auto fp = makeSimple();
+    fp.compileCurves();
+    QCOMPARE( fp.cpuCurve()( -20 ), 20 );
+    QCOMPARE( fp.cpuCurve()( 400 ), 100 );
+  }
+
+  void lut_ownWaterCoolerTable()
+  {
+    auto fp = makeSimple();
+    fp.tableWaterCoolerFan = { { 30, 10 }, { 70, 50 } };
+    fp.compileCurves();
+    QCOMPARE( fp.waterCoolerFanCurve()( 50 ), 30 );
+  }
+
+  void lut_emptyTableStaysEmpty()
+  {
+    FanProfile fp( "a", "A", { { 30, 20 } }, {} );
+    fp.compileCurves();
+    QVERIFY( !fp.cpuCurve().empty() );
+    QVERIFY( fp.gpuCurve().empty() );
+    QCOMPARE( fp.gpuCurve()( 60 ), -1 );
+  }
+
+  void lut_sameCurves()
+  {
+    auto a = makeSimple();
+    auto b = makeSimple();
+    b.name = "other";
+    b.tablePump = { { 40, 1 } };
+    QVERIFY( a.sameCurves( b ) );
+    b.tableGPU.back().speed = 90;
+    QVERIFY( !a.sameCurves( b ) );
+  }
+
   // ---- getPumpSpeedForTemp() – step-wise lookup ------------------------
 
   void pump_emptyTable()
@@ -0,0 +1,78 @@
+/*
+ * Unit tests for FanWatchdog – the deadline after a beat, tripping once
+ * per stall, disarming, and the watchdog thread calling its action.
+ */
+
+#include <QTest>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "FanWatchdog.hpp"
+
+class TestFanWatchdog : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void disarmedNeverTrips()
+  {
+    FanWatchdog w;
+    QVERIFY( !w.expired( 1'000'000 ) );
+  }
+
+  void tripsOnceAfterMissedCycles()
+  {
+    FanWatchdog w;
+    w.beat( 10'000, 1000 );
+    QVERIFY( !w.expired( 10'000 + 2999 ) );
+    QVERIFY( w.expired( 10'000 + 3000 ) );
+    QVERIFY( !w.expired( 20'000 ) );
+    QCOMPARE( w.trips(), uint64_t( 1 ) );
+
+    // the loop runs again: armed afresh
+    w.beat( 21'000, 1000 );
+    QVERIFY( !w.expired( 22'000 ) );
+    QVERIFY( w.expired( 24'000 ) );
+    QCOMPARE( w.trips(), uint64_t( 2 ) );
+  }
+
+  void deadlineScalesWithTheInterval()
+  {
+    FanWatchdog w;
+    // fast loop: never shorter than MIN_DEADLINE_MS
+    w.beat( 0, 500 );
+    QVERIFY( !w.expired( FanWatchdog::MIN_DEADLINE_MS - 1 ) );
+    QVERIFY( w.expired( FanWatchdog::MIN_DEADLINE_MS ) );
+
+    // slowed by the sampling governor: three of its intervals
+    w.beat( 0, 4000 );
+    QVERIFY( !w.expired( 11'999 ) );
+    QVERIFY( w.expired( 12'000 ) );
+  }
+
+  void disarmStopsAPendingDeadline()
+  {
+    FanWatchdog w;
+    w.beat( 0, 1000 );
+    w.disarm();
+    QVERIFY( !w.expired( 60'000 ) );
+    QCOMPARE( w.trips(), uint64_t( 0 ) );
+  }
+
+  void threadCallsTheActionOnce()
+  {
+    FanWatchdog w;
+    std::atomic< int > missed{ 0 };
+    std::atomic< bool > initialized{ false };
+    w.beat( FanWatchdog::steadyMs() - FanWatchdog::MIN_DEADLINE_MS, 1000 );
+    w.start( [&missed] { ++missed; }, [&initialized] { initialized = true; } );
+    std::this_thread::sleep_for( FanWatchdog::CHECK_PERIOD * 3 );
+    w.stop();
+    QVERIFY( initialized.load() );
+    QCOMPARE( missed.load(), 1 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestFanWatchdog )
+#include "test_fan_watchdog.moc"
@@ -0,0 +1,222 @@
+/*
+ * Unit tests for GpuOcTuner – offset climb and back-off, candidate choice
+ * by objective, waiting for the load, rejected settings and the profile
+ * it produces.
+ */
+
+#include <QTest>
+#include <functional>
+#include <string>
+#include "GpuOcTuner.hpp"
+
+namespace
+{
+/// Clock, power and perf-cap reason a model GPU shows for a setting at a time
+struct ModelReading
+{
+  double clockMHz;
+  double powerW;
+  int utilPct = 99;
+  std::string reason = "Power Limit";
+};
+
+using GpuModel = std::function< ModelReading( const GpuOcSetting &, int64_t timestampMs ) >;
+
+GpuOcTuningOptions fastOptions()
+{
+  GpuOcTuningOptions options;
+  options.offsetStepMHz = 30;
+  options.maxOffsetMHz = 150;
+  options.settleS = 2.0;
+  options.measureS = 10.0;
+  options.loadTimeoutS = 20.0;
+  return options;
+}
+
+/// Feed one sample per second until the job ends; applies what the tuner asks for
+void run( GpuOcTuner &tuner, const GpuModel &model, int64_t limitMs = 3'600'000 )
+{
+  tuner.start( 0 );
+  for ( int64_t t = 1000; tuner.state() == GpuOcTuningState::Running && t < limitMs; t += 1000 )
+  {
+    const ModelReading reading = model( tuner.current(), t );
+    tuner.onSample( GpuOcSample{ t, reading.clockMHz, reading.powerW, reading.utilPct, reading.reason } );
+  }
+}
+}
+
+class TestGpuOcTuner : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void climbsAndBacksOffAfterInstability()
+  {
+    // gains 1 MHz per MHz of offset, jitters by ±100 MHz above +60
+    GpuOcTuner tuner( fastOptions() );
+    run( tuner, []( const GpuOcSetting &s, int64_t t ) {
+      const double jitter = s.offsetMHz > 60 ? ( ( t / 1000 ) % 2 ? 100.0 : -100.0 ) : 0.0;
+      return ModelReading{ 1800.0 + s.offsetMHz + jitter, 80.0 };
+    } );
+
+    QCOMPARE( tuner.state(), GpuOcTuningState::Finished );
+    QCOMPARE( tuner.steps().size(), size_t( 4 ) );  // 0, 30, 60 stable; 90 unstable
+    QCOMPARE( tuner.steps().back().outcome, GpuOcStepOutcome::Unstable );
+    const auto best = tuner.recommendation();
+    QVERIFY( best.has_value() );
+    QCOMPARE( best->setting.offsetMHz, 30 );  // one safety step below +60
+    QVERIFY( std::abs( best->meanClockMHz - 1830.0 ) < 1e-6 );
+  }
+
+  void stopsAtTheOffsetLimit()
+  {
+    GpuOcTuningOptions options = fastOptions();
+    options.maxOffsetMHz = 60;
+    GpuOcTuner tuner( options );
+    run( tuner, []( const GpuOcSetting &s, int64_t ) { return ModelReading{ 1800.0 + s.offsetMHz, 80.0 }; } );
+
+    QCOMPARE( tuner.state(), GpuOcTuningState::Finished );
+    QCOMPARE( tuner.recommendation()->setting.offsetMHz, 60 );
+  }
+
+  void clockRegressionEndsTheClimbWithoutBackOff()
+  {
+    GpuOcTuner tuner( fastOptions() );
+    run( tuner, []( const GpuOcSetting &s, int64_t ) {
+      return ModelReading{ s.offsetMHz <= 60 ? 1800.0 + s.offsetMHz : 1700.0, 80.0 };
+    } );
+
+    QCOMPARE( tuner.steps().back().outcome, GpuOcStepOutcome::NoGain );
+    QCOMPARE( tuner.recommendation()->setting.offsetMHz, 60 );
+  }
+
+  void hwCappingIsUnstableButPowerLimitIsNot()
+  {
+    GpuOcTuningOptions options = fastOptions();
+    options.safetySteps = 0;
+    GpuOcTuner tuner( options );
+    run( tuner, []( const GpuOcSetting &s, int64_t ) {
+      return ModelReading{ 1800.0 + s.offsetMHz, 80.0, 99, s.offsetMHz >= 90 ? "HW Slowdown" : "Power Limit" };
+    } );
+
+    QCOMPARE( tuner.steps().back().hwLimitedFraction, 1.0 );
+    QCOMPARE( tuner.recommendation()->setting.offsetMHz, 60 );
+    QCOMPARE( tuner.recommendation()->limitReason, std::string( "Power Limit" ) );
+  }
+
+  void objectiveChoosesTheCandidate()
+  {
+    GpuOcTuningOptions options = fastOptions();
+    options.maxOffsetMHz = 0;
+    options.powerLimitsW = { 60.0, 80.0 };
+    const GpuModel model = []( const GpuOcSetting &s, int64_t ) {
+      return s.powerLimitW < 70.0 ? ModelReading{ 1500.0, 60.0 } : ModelReading{ 1700.0, 80.0 };
+    };
+
+    GpuOcTuner efficient( options );
+    run( efficient, model );
+    QCOMPARE( efficient.candidateResults().size(), size_t( 2 ) );
+    QCOMPARE( efficient.recommendation()->setting.powerLimitW, 60.0 );
+
+    options.objective = GpuOcObjective::Performance;
+    GpuOcTuner fast( options );
+    run( fast, model );
+    QCOMPARE( fast.recommendation()->setting.powerLimitW, 80.0 );
+  }
+
+  void samplesWithoutLoadWait()
+  {
+    GpuOcTuningOptions options = fastOptions();
+    options.maxOffsetMHz = 0;
+    GpuOcTuner tuner( options );
+    // idle for 15 s, then loaded: the idle samples must not count
+    run( tuner, []( const GpuOcSetting &, int64_t t ) {
+      return t < 15'000 ? ModelReading{ 300.0, 5.0, 3, "Idle" } : ModelReading{ 1800.0, 80.0 };
+    } );
+    QCOMPARE( tuner.state(), GpuOcTuningState::Finished );
+    QCOMPARE( tuner.recommendation()->meanClockMHz, 1800.0 );
+
+    GpuOcTuner idle( options );
+    run( idle, []( const GpuOcSetting &, int64_t ) { return ModelReading{ 300.0, 5.0, 3, "Idle" }; } );
+    QCOMPARE( idle.state(), GpuOcTuningState::Failed );
+    QCOMPARE( idle.error(), std::string( "GPU not under load" ) );
+  }
+
+  void lostTelemetryFails()
+  {
+    GpuOcTuner tuner( fastOptions() );
+    run( tuner, []( const GpuOcSetting &s, int64_t ) {
+      return s.offsetMHz >= 60 ? ModelReading{ -1.0, -1.0, -1, "" } : ModelReading{ 1800.0 + s.offsetMHz, 80.0 };
+    } );
+    QCOMPARE( tuner.state(), GpuOcTuningState::Failed );
+    QCOMPARE( tuner.error(), std::string( "GPU telemetry or load lost" ) );
+    QVERIFY( !tuner.recommendation() );
+  }
+
+  void rejectedSettingEndsItsCandidate()
+  {
+    GpuOcTuningOptions options = fastOptions();
+    options.powerLimitsW = { 200.0, 80.0 };
+    options.maxOffsetMHz = 0;
+    GpuOcTuner tuner( options );
+    tuner.start( 0 );
+    const auto next = tuner.onApplyFailed( 0 );
+    QVERIFY( next.has_value() );
+    QCOMPARE( next->powerLimitW, 80.0 );
+    QCOMPARE( tuner.steps().front().limitReason, std::string( "rejected" ) );
+
+    for ( int64_t t = 1000; tuner.state() == GpuOcTuningState::Running; t += 1000 )
+      tuner.onSample( GpuOcSample{ t, 1800.0, 80.0, 99, "Power Limit" } );
+    QCOMPARE( tuner.candidateResults().size(), size_t( 1 ) );
+    QCOMPARE( tuner.recommendation()->setting.powerLimitW, 80.0 );
+  }
+
+  void cancelStops()
+  {
+    GpuOcTuner tuner( fastOptions() );
+    tuner.start( 0 );
+    tuner.cancel();
+    QCOMPARE( tuner.state(), GpuOcTuningState::Cancelled );
+    QVERIFY( !tuner.onSample( GpuOcSample{ 5000, 1800.0, 80.0, 99, "None" } ) );
+    QVERIFY( !tuner.recommendation() );
+  }
+
+  void profileAndStatusJSON()
+  {
+    QCOMPARE( GpuOcTuner::profileJSON( GpuOcSetting{ 75.0, 1800, 90 }, 210 ),
+              std::string( "{\"offsets\":[{\"pstate\":0,\"gpuOffsetMHz\":90}],"
+                           "\"gpuLockedClocks\":{\"enabled\":true,\"min\":210,\"max\":1800},"
+                           "\"powerLimitW\":75.0}" ) );
+    QCOMPARE( GpuOcTuner::profileJSON( GpuOcSetting{}, 210 ),
+              std::string( "{\"offsets\":[{\"pstate\":0,\"gpuOffsetMHz\":0}],"
+                           "\"gpuLockedClocks\":{\"enabled\":false,\"min\":0,\"max\":0},"
+                           "\"powerLimitW\":0.0}" ) );
+
+    GpuOcTuningOptions options = fastOptions();
+    options.maxOffsetMHz = 0;
+    GpuOcTuner tuner( options );
+    run( tuner, []( const GpuOcSetting &, int64_t ) { return ModelReading{ 1800.0, 80.0 }; } );
+    const std::string status = tuner.statusJSON();
+    QVERIFY( status.starts_with( "{\"state\":\"finished\"" ) );
+    QVERIFY( status.find( "\"recommendation\":{\"step\":" ) != std::string::npos );
+    QVERIFY( status.find( "\"profile\":{\"offsets\"" ) != std::string::npos );
+  }
+
+  void optionsAreValidated()
+  {
+    QVERIFY( fastOptions().validate().empty() );
+    GpuOcTuningOptions options = fastOptions();
+    options.offsetStepMHz = 0;
+    QVERIFY( !options.validate().empty() );
+    options = fastOptions();
+    options.powerLimitsW.clear();
+    QVERIFY( !options.validate().empty() );
+    options = fastOptions();
+    options.loadTimeoutS = options.settleS;
+    QVERIFY( !options.validate().empty() );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestGpuOcTuner )
+#include "test_gpu_oc_tuner.moc"
@@ -0,0 +1,129 @@
+/*
+ * Unit tests for GpuTopologyScanner path discovery.
+ */
+
+#include <QTest>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "GpuTopology.hpp"
+
+class TestGpuTopology : public QObject
+{
+  Q_OBJECT
+
+private:
+  std::filesystem::path m_root;
+  std::filesystem::path m_dir;
+
+  void file( const std::filesystem::path &path, const std::string &content )
+  {
+    std::filesystem::create_directories( path.parent_path() );
+    std::ofstream( path, std::ios::trunc ) << content;
+  }
+
+  void fresh( const std::string &name )
+  {
+    m_dir = m_root / name;
+    for ( const char *sub : { "pci", "hwmon", "drm" } )
+      std::filesystem::create_directories( m_dir / sub );
+  }
+
+  GpuTopologyScanner scanner() const
+  {
+    GpuTopologyScanner::Paths paths;
+    paths.pciRoot = ( m_dir / "pci" ).string();
+    paths.hwmonRoot = ( m_dir / "hwmon" ).string();
+    paths.drmRoot = ( m_dir / "drm" ).string();
+    return GpuTopologyScanner( { "8086:(A780|7D55)", "1002:(15BF|1681)", "1002:(7480)" }, paths );
+  }
+
+  void amdHwmon( const std::string &hwmon, const std::string &pciId, const std::string &driver = "amdgpu" )
+  {
+    file( m_dir / "hwmon" / hwmon / "device" / "uevent",
+          "DRIVER=" + driver + "\nPCI_CLASS=30000\nPCI_ID=" + pciId + "\n" );
+  }
+
+  void connector( const std::string &name, const std::string &vendor, const std::string &status )
+  {
+    file( m_dir / "drm" / name / "device" / "device" / "vendor", vendor + "\n" );
+    file( m_dir / "drm" / name / "status", status + "\n" );
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    m_root = std::filesystem::temp_directory_path() / ( "ucc-test-gpu-topology-" + std::to_string( getpid() ) );
+    std::filesystem::create_directories( m_root );
+  }
+
+  void cleanupTestCase()
+  {
+    std::filesystem::remove_all( m_root );
+  }
+
+  void emptyTreeHasNoDevices()
+  {
+    fresh( "empty" );
+    QVERIFY( scanner().scan() == GpuTopology() );
+  }
+
+  void intelCardSkipsRenderNodesAndConnectors()
+  {
+    fresh( "intel" );
+    const auto drm = m_dir / "pci" / "0000:00:02.0" / "drm";
+    const std::string uevent = "DRIVER=i915\nPCI_ID=8086:7D55\n";
+    file( drm / "card1-eDP-1" / "device" / "uevent", uevent );
+    file( drm / "renderD128" / "device" / "uevent", uevent );
+    file( drm / "card1" / "device" / "uevent", uevent );
+    file( m_dir / "pci" / "0000:01:00.0" / "drm" / "card0" / "device" / "uevent", "PCI_ID=10DE:2860\n" );
+
+    QCOMPARE( scanner().scan().intelIGpuDrmPath, ( drm / "card1" ).string() );
+  }
+
+  void amdHwmonNeedsDriverAndMatchingId()
+  {
+    fresh( "amd" );
+    amdHwmon( "hwmon0", "1002:15BF", "k10temp" );
+    amdHwmon( "hwmon3", "1002:7480" );
+    amdHwmon( "hwmon5", "1002:15BF" );
+
+    const GpuTopology t = scanner().scan();
+    QCOMPARE( t.amdIGpuHwmonPath, ( m_dir / "hwmon" / "hwmon5" ).string() );
+    QCOMPARE( t.amdDGpuHwmonPath, ( m_dir / "hwmon" / "hwmon3" ).string() );
+    QVERIFY( t.intelIGpuDrmPath.empty() );
+  }
+
+  void edpOnNvidiaOnlyWhenConnected()
+  {
+    fresh( "edp" );
+    connector( "card0-eDP-1", "0x8086", "connected" );
+    connector( "card1-eDP-2", "0x10de", "disconnected" );
+    connector( "card1-DP-1", "0x10de", "connected" );
+    QVERIFY( scanner().scan().nvidiaEdpConnector.empty() );
+
+    connector( "card1-eDP-2", "0x10de", "connected" );
+    QCOMPARE( scanner().scan().nvidiaEdpConnector, std::string( "card1-eDP-2" ) );
+  }
+
+  void rescanSeesHotplug()
+  {
+    fresh( "hotplug" );
+    const GpuTopologyScanner s = scanner();
+    const GpuTopology before = s.scan();
+
+    amdHwmon( "hwmon7", "1002:7480" );
+    const GpuTopology after = s.scan();
+    QVERIFY( !( after == before ) );
+    QCOMPARE( after.amdDGpuHwmonPath, ( m_dir / "hwmon" / "hwmon7" ).string() );
+
+    std::filesystem::remove_all( m_dir / "hwmon" / "hwmon7" );
+    QVERIFY( s.scan() == before );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestGpuTopology )
+
+#include "test_gpu_topology.moc"
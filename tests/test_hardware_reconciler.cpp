@@ -0,0 +1,183 @@
+/*
+ * Unit tests for HardwareReconciler – probe backoff, reapply on drift,
+ * giving up against a persistent agent, desired-state changes and the
+ * /proc scan that names the agent.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <filesystem>
+#include <fstream>
+#include "HardwareReconciler.hpp"
+
+namespace
+{
+/// A setting another agent can overwrite
+struct FakeSetting
+{
+  uint64_t wanted = 1;
+  uint64_t actual = 1;
+  int probes = 0;
+  int applies = 0;
+
+  ReconcileTarget target( std::vector< std::string > suspects = {} )
+  {
+    return ReconcileTarget{ "fake",
+                            [this] { return wanted; },
+                            [this] { ++probes; return actual == wanted; },
+                            [this] { ++applies; actual = wanted; return true; },
+                            std::move( suspects ) };
+  }
+};
+
+HardwareReconciler::AgentScan fixedAgents( std::vector< std::string > agents )
+{
+  return [agents]( const std::vector< std::string > & ) { return agents; };
+}
+
+/// Run every second from @p fromMs to @p toMs (inclusive)
+void runSeconds( HardwareReconciler &r, int64_t fromMs, int64_t toMs )
+{
+  for ( int64_t t = fromMs; t <= toMs; t += 1000 )
+    r.runDue( t );
+}
+}
+
+class TestHardwareReconciler : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void stableStateBacksOff()
+  {
+    FakeSetting s;
+    HardwareReconciler r( fixedAgents( {} ) );
+    r.add( s.target() );
+
+    // first run only records the desired state; probes at 2, 6, 14, 30, 62, 94 s
+    runSeconds( r, 0, 100'000 );
+    QCOMPARE( s.probes, 6 );
+    QCOMPARE( s.applies, 0 );
+    QCOMPARE( r.status().front().intervalMs, HardwareReconciler::MAX_INTERVAL_MS );
+  }
+
+  void driftIsReappliedAndProbedSoon()
+  {
+    FakeSetting s;
+    HardwareReconciler r( fixedAgents( { "tuned" } ) );
+    r.add( s.target() );
+    runSeconds( r, 0, 30'000 );  // interval now 32 s, next probe at 62 s
+
+    s.actual = 7;
+    runSeconds( r, 31'000, 62'000 );
+    QCOMPARE( s.applies, 1 );
+    QCOMPARE( s.actual, s.wanted );
+    const auto status = r.status().front();
+    QCOMPARE( status.drifts, uint64_t( 1 ) );
+    QCOMPARE( status.reapplies, uint64_t( 1 ) );
+    QCOMPARE( status.intervalMs, HardwareReconciler::MIN_INTERVAL_MS );
+    QCOMPARE( status.agents.at( "tuned" ), uint64_t( 1 ) );
+  }
+
+  void persistentAgentMakesItGiveUp()
+  {
+    FakeSetting s;
+    HardwareReconciler r( fixedAgents( {} ) );
+    ReconcileTarget target = s.target();
+    // the agent undoes every write right away
+    target.apply = [&s] { ++s.applies; return true; };
+    r.add( std::move( target ) );
+    s.actual = 0;
+
+    runSeconds( r, 0, 200'000 );
+    QCOMPARE( s.applies, HardwareReconciler::MAX_ATTEMPTS );
+    auto status = r.status().front();
+    QVERIFY( status.gaveUp );
+    QCOMPARE( status.agents.at( "unknown" ), status.drifts );
+    QCOMPARE( status.intervalMs, HardwareReconciler::MAX_INTERVAL_MS );
+
+    // the agent went away and the state came back: watched normally again
+    s.actual = s.wanted;
+    runSeconds( r, 201'000, 240'000 );
+    QVERIFY( !r.status().front().gaveUp );
+  }
+
+  void newDesiredStateRestartsTheSchedule()
+  {
+    FakeSetting s;
+    HardwareReconciler r( fixedAgents( {} ) );
+    ReconcileTarget target = s.target();
+    target.apply = [&s] { ++s.applies; return true; };
+    r.add( std::move( target ) );
+    s.actual = 0;
+    runSeconds( r, 0, 200'000 );
+    QVERIFY( r.status().front().gaveUp );
+
+    // a profile apply writes the new state and changes the token
+    s.wanted = s.actual = 2;
+    r.runDue( 201'000 );
+    const auto status = r.status().front();
+    QVERIFY( !status.gaveUp );
+    QCOMPARE( status.intervalMs, HardwareReconciler::MIN_INTERVAL_MS );
+    const int probes = s.probes;
+    r.runDue( 203'000 );
+    QCOMPARE( s.probes, probes + 1 );
+  }
+
+  void ownApplyIsNotANewDesiredState()
+  {
+    // a target whose token is a generation bumped by every apply
+    uint64_t generation = 1;
+    bool inPlace = false;
+    int applies = 0;
+    HardwareReconciler r( fixedAgents( {} ) );
+    r.add( ReconcileTarget{ "generation",
+                            [&] { return generation; },
+                            [&] { return inPlace; },
+                            [&] { ++applies; ++generation; return true; },
+                            {} } );
+
+    runSeconds( r, 0, 200'000 );
+    QCOMPARE( applies, HardwareReconciler::MAX_ATTEMPTS );
+    QVERIFY( r.status().front().gaveUp );
+  }
+
+  void pokeProbesRightAway()
+  {
+    FakeSetting s;
+    HardwareReconciler r( fixedAgents( {} ) );
+    r.add( s.target() );
+    runSeconds( r, 0, 40'000 );
+    const int probes = s.probes;
+
+    r.poke();
+    r.runDue( 41'000 );
+    QCOMPARE( s.probes, probes + 1 );
+    r.runDue( 42'000 );
+    QCOMPARE( s.probes, probes + 1 );
+  }
+
+  void runningProcessesMatchesComm()
+  {
+    QTemporaryDir dir;
+    const std::filesystem::path root = dir.path().toStdString();
+    const auto addProcess = [&root]( const std::string &pid, const std::string &comm ) {
+      std::filesystem::create_directories( root / pid );
+      std::ofstream( root / pid / "comm" ) << comm << '\n';
+    };
+    addProcess( "1", "systemd" );
+    addProcess( "812", "tuned" );
+    addProcess( "950", "power-profiles-" );
+    addProcess( "951", "power-profiles-" );
+    addProcess( "self", "tuned" );
+
+    const auto found = HardwareReconciler::runningProcesses(
+      { "power-profiles-daemon", "tuned", "auto-cpufreq" }, root.string() );
+    QCOMPARE( found, ( std::vector< std::string >{ "power-profiles-daemon", "tuned" } ) );
+    QVERIFY( HardwareReconciler::runningProcesses( {}, root.string() ).empty() );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestHardwareReconciler )
+#include "test_hardware_reconciler.moc"
@@ -0,0 +1,168 @@
+/*
+ * Unit tests for the history export – frame page parsing, CSV and Parquet
+ * output and the merge of samples with event annotations.
+ */
+
+#include <QTest>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include "HistoryExport.hpp"
+
+using namespace ucc;
+
+class TestHistoryExport : public QObject
+{
+  Q_OBJECT
+
+private:
+  static constexpr double NaN = std::numeric_limits< double >::quiet_NaN();
+
+  /// A querySinceFrames() blob; @p columns holds one vector per set mask bit
+  static std::vector< uint8_t > frames( uint64_t mask, const std::vector< int64_t > &timestamps,
+                                        const std::vector< std::vector< double > > &columns )
+  {
+    const uint32_t rows = static_cast< uint32_t >( timestamps.size() );
+    std::vector< uint8_t > out( sizeof( mask ) + sizeof( rows ) );
+    std::memcpy( out.data(), &mask, sizeof( mask ) );
+    std::memcpy( out.data() + sizeof( mask ), &rows, sizeof( rows ) );
+    const auto append = [ &out ]( const void *p, size_t n ) {
+      out.insert( out.end(), static_cast< const uint8_t * >( p ), static_cast< const uint8_t * >( p ) + n );
+    };
+    append( timestamps.data(), timestamps.size() * sizeof( int64_t ) );
+    for ( const auto &column : columns )
+      append( column.data(), column.size() * sizeof( double ) );
+    return out;
+  }
+
+  static MetricEventRecord event( int64_t ms, MetricEventKind kind, const char *label, int32_t value )
+  {
+    MetricEventRecord e{};
+    e.timestampMs = ms;
+    e.kind = static_cast< uint16_t >( kind );
+    e.value = value;
+    std::strncpy( e.label, label, sizeof( e.label ) );
+    return e;
+  }
+
+  static uint32_t u32At( const std::string &s, size_t pos )
+  {
+    uint32_t v;
+    std::memcpy( &v, s.data() + pos, sizeof( v ) );
+    return v;
+  }
+
+private slots:
+
+  // ---- MetricFramesView ---------------------------------------------
+
+  void frames_parse()
+  {
+    const auto blob = frames( 0b101, { 1000, 2000 }, { { 1.0, 2.0 }, { NaN, 4.5 } } );
+    const auto view = MetricFramesView::parse( blob.data(), blob.size() );
+    QVERIFY( view.has_value() );
+    QCOMPARE( view->rows, uint32_t( 2 ) );
+    QCOMPARE( view->columnCount(), size_t( 2 ) );
+    QCOMPARE( view->timestamp( 1 ), int64_t( 2000 ) );
+    QCOMPARE( view->value( 0, 1 ), 2.0 );
+    QVERIFY( std::isnan( view->value( 1, 0 ) ) );
+
+    QVERIFY( !MetricFramesView::parse( blob.data(), blob.size() - 1 ).has_value() );
+    QVERIFY( !MetricFramesView::parse( blob.data(), 4 ).has_value() );
+  }
+
+  void format_fromNameOrExtension()
+  {
+    QVERIFY( parseHistoryExportFormat( "csv" ) == HistoryExportFormat::Csv );
+    QVERIFY( parseHistoryExportFormat( "/tmp/run.PARQUET" ) == HistoryExportFormat::Parquet );
+    QVERIFY( !parseHistoryExportFormat( "run.json" ).has_value() );
+  }
+
+  // ---- CSV ----------------------------------------------------------
+
+  void csv_mergesEventsAndPages()
+  {
+    std::ostringstream out;
+    CsvHistoryWriter writer( out );
+    HistoryExporter exporter( writer, 0b11, { "cpuTemp", "cpuPower" },
+                              { event( 1500, MetricEventKind::ProfileSwitch, "Quiet, \"low\"", 0 ),
+                                event( 9000, MetricEventKind::PumpStep, "up", 3 ) } );
+
+    const auto first = frames( 0b11, { 1000, 2000 }, { { 50.5, 51.0 }, { NaN, 12.25 } } );
+    QCOMPARE( exporter.addPage( first.data(), first.size() ).value_or( -1 ), int64_t( 2000 ) );
+    // a later page without cpuPower still fills its column
+    const auto second = frames( 0b1, { 3000 }, { { 52.0 } } );
+    QCOMPARE( exporter.addPage( second.data(), second.size() ).value_or( -1 ), int64_t( 3000 ) );
+    QVERIFY( exporter.finish() );
+
+    QCOMPARE( out.str(), std::string( "timestamp,cpuTemp,cpuPower,event,eventLabel,eventValue\n"
+                                      "1000,50.5,,,,\n"
+                                      "1500,,,profileSwitch,\"Quiet, \"\"low\"\"\",0\n"
+                                      "2000,51,12.25,,,\n"
+                                      "3000,52,,,,\n"
+                                      "9000,,,pumpStep,up,3\n" ) );
+    QCOMPARE( exporter.rows(), size_t( 3 ) );
+    QCOMPARE( exporter.eventsWritten(), size_t( 2 ) );
+  }
+
+  void csv_malformedPageIsRejected()
+  {
+    std::ostringstream out;
+    CsvHistoryWriter writer( out );
+    HistoryExporter exporter( writer, 0b1, { "cpuTemp" }, {} );
+    const uint8_t junk[ 5 ] = {};
+    QVERIFY( !exporter.addPage( junk, sizeof( junk ) ).has_value() );
+    QVERIFY( exporter.finish() );
+    QCOMPARE( out.str(), std::string( "timestamp,cpuTemp,event,eventLabel,eventValue\n" ) );
+  }
+
+  // ---- Parquet ------------------------------------------------------
+
+  void parquet_frameAndRowGroups()
+  {
+    std::ostringstream out;
+    ParquetHistoryWriter writer( out, 2 );
+    HistoryExporter exporter( writer, 0b1, { "cpuTemp" },
+                              { event( 1500, MetricEventKind::PowerState, "battery", 1 ) } );
+    const auto page = frames( 0b1, { 1000, 2000, 3000 }, { { 40.0, NaN, 42.0 } } );
+    QVERIFY( exporter.addPage( page.data(), page.size() ).has_value() );
+    QVERIFY( exporter.finish() );
+
+    const std::string file = out.str();
+    QVERIFY( file.size() > 12 );
+    QCOMPARE( file.substr( 0, 4 ), std::string( "PAR1" ) );
+    QCOMPARE( file.substr( file.size() - 4 ), std::string( "PAR1" ) );
+    const uint32_t footer = u32At( file, file.size() - 8 );
+    QVERIFY( footer > 0 && footer < file.size() - 12 );
+
+    // the footer names every column; four rows in row groups of two
+    const std::string meta = file.substr( file.size() - 8 - footer, footer );
+    for ( const char *name : { "timestamp", "cpuTemp", "event", "eventLabel", "eventValue" } )
+      QVERIFY( meta.find( name ) != std::string::npos );
+    QVERIFY( meta.find( std::string( "\x16\x08", 2 ) ) != std::string::npos );  // num_rows = 4
+    QVERIFY( meta.find( std::string( "\x19\x2c", 2 ) ) != std::string::npos );  // 2 row groups
+
+    // first page: timestamp column, PLAIN int64 values right after its header
+    int64_t first;
+    const size_t values = file.find( std::string( "\xe8\x03\0\0\0\0\0\0", 8 ), 4 );
+    QVERIFY( values != std::string::npos );
+    std::memcpy( &first, file.data() + values, sizeof( first ) );
+    QCOMPARE( first, int64_t( 1000 ) );
+  }
+
+  void parquet_emptyExportIsValid()
+  {
+    std::ostringstream out;
+    ParquetHistoryWriter writer( out );
+    HistoryExporter exporter( writer, 0, {}, {} );
+    QVERIFY( exporter.finish() );
+    const std::string file = out.str();
+    QCOMPARE( file.substr( 0, 4 ), std::string( "PAR1" ) );
+    QCOMPARE( file.substr( file.size() - 4 ), std::string( "PAR1" ) );
+    QCOMPARE( size_t( u32At( file, file.size() - 8 ) ) + 12, file.size() );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestHistoryExport )
+#include "test_history_export.moc"
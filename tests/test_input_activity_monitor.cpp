@@ -0,0 +1,104 @@
+/*
+ * Unit tests for InputActivityMonitor – finding the keyboard and mouse
+ * nodes, and the time of the newest queued event.  FIFOs stand in for the
+ * evdev nodes.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include "InputActivityMonitor.hpp"
+
+#include <poll.h>
+#include <sys/stat.h>
+
+class TestInputActivityMonitor : public QObject
+{
+  Q_OBJECT
+
+private:
+  static input_event event( int64_t ms )
+  {
+    input_event e{};
+    e.input_event_sec = static_cast< decltype( e.input_event_sec ) >( ms / 1000 );
+    e.input_event_usec = static_cast< decltype( e.input_event_usec ) >( ( ms % 1000 ) * 1000 );
+    e.type = EV_KEY;
+    e.value = 1;
+    return e;
+  }
+
+  static bool readable( int fd )
+  {
+    pollfd p{ fd, POLLIN, 0 };
+    return ::poll( &p, 1, 0 ) == 1;
+  }
+
+private slots:
+
+  void findsKeyboardsAndMice()
+  {
+    QTemporaryDir dir;
+    const std::string base = dir.path().toStdString();
+    for ( const char *name : { "platform-i8042-serio-0-event-kbd", "pci-0000:00:15.0-platform-i2c_designware.0-event-mouse",
+                               "pci-0000:00:15.0-platform-i2c_designware.0-mouse", "platform-pcspkr-event-spkr" } )
+      ::close( ::open( ( base + "/" + name ).c_str(), O_CREAT | O_WRONLY, 0600 ) );
+
+    const auto devices = InputActivityMonitor::findDevices( base );
+    QCOMPARE( devices.size(), size_t( 2 ) );
+    QVERIFY( devices[ 0 ].ends_with( "-event-mouse" ) );
+    QVERIFY( devices[ 1 ].ends_with( "-event-kbd" ) );
+    QVERIFY( InputActivityMonitor::findDevices( base + "/missing" ).empty() );
+  }
+
+  void drainReportsTheNewestEvent()
+  {
+    QTemporaryDir dir;
+    const std::string kbd = dir.path().toStdString() + "/kbd";
+    const std::string mouse = dir.path().toStdString() + "/mouse";
+    QVERIFY( ::mkfifo( kbd.c_str(), 0600 ) == 0 );
+    QVERIFY( ::mkfifo( mouse.c_str(), 0600 ) == 0 );
+
+    InputActivityMonitor monitor;
+    QVERIFY( monitor.sync( { kbd, mouse } ) );
+    QCOMPARE( monitor.devices(), size_t( 2 ) );
+    const int kbdWriter = ::open( kbd.c_str(), O_WRONLY | O_NONBLOCK );
+    const int mouseWriter = ::open( mouse.c_str(), O_WRONLY | O_NONBLOCK );
+    QVERIFY( kbdWriter >= 0 and mouseWriter >= 0 );
+
+    QVERIFY( !readable( monitor.fd() ) );
+    QVERIFY( !monitor.drain() );
+
+    const input_event keys[] = { event( 5'000 ), event( 7'250 ) };
+    const input_event motion = event( 6'000 );
+    QVERIFY( ::write( kbdWriter, keys, sizeof( keys ) ) == sizeof( keys ) );
+    QVERIFY( ::write( mouseWriter, &motion, sizeof( motion ) ) == sizeof( motion ) );
+    QVERIFY( readable( monitor.fd() ) );
+
+    QCOMPARE( *monitor.drain(), int64_t( 7'250 ) );
+    // all read: quiet until the next event
+    QVERIFY( !readable( monitor.fd() ) );
+    QVERIFY( !monitor.drain() );
+
+    ::close( kbdWriter );
+    ::close( mouseWriter );
+  }
+
+  void syncClosesTheGoneDevices()
+  {
+    QTemporaryDir dir;
+    const std::string kbd = dir.path().toStdString() + "/kbd";
+    QVERIFY( ::mkfifo( kbd.c_str(), 0600 ) == 0 );
+
+    InputActivityMonitor monitor;
+    QVERIFY( monitor.sync( { kbd, dir.path().toStdString() + "/missing" } ) );
+    QCOMPARE( monitor.devices(), size_t( 1 ) );
+    QVERIFY( monitor.sync( {} ) );
+    QCOMPARE( monitor.devices(), size_t( 0 ) );
+    QVERIFY( monitor.fd() >= 0 );
+
+    monitor.close();
+    QCOMPARE( monitor.fd(), -1 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestInputActivityMonitor )
+#include "test_input_activity_monitor.moc"
@@ -0,0 +1,113 @@
+/*
+ * Unit tests for IpcStats – per-method D-Bus call counts, latency
+ * histograms, recent call rate and the bounded sender breakdown.
+ */
+
+#include <QTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "IpcStats.hpp"
+
+class TestIpcStats : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void countsAndLatencyPerMethod()
+  {
+    IpcStats stats;
+    stats.record( "GetSettingsJSON", ":1.10", 40'000, 1'000 );
+    stats.record( "GetSettingsJSON", ":1.10", 3'000'000, 1'100 );
+    stats.record( "GetPowerState", ":1.11", 2'000, 1'200 );
+
+    const auto &m = stats.methods().at( "GetSettingsJSON" );
+    QCOMPARE( m.latency.count, uint64_t( 2 ) );
+    QCOMPARE( m.latency.totalNs, uint64_t( 3'040'000 ) );
+    QCOMPARE( m.latency.maxNs, uint64_t( 3'000'000 ) );
+    QCOMPARE( m.latency.buckets[ LatencyHistogram::bucketFor( 40'000 ) ], uint64_t( 1 ) );
+    QCOMPARE( m.senders.at( ":1.10" ).calls, uint64_t( 2 ) );
+    QCOMPARE( stats.senders().at( ":1.11" ).calls, uint64_t( 1 ) );
+  }
+
+  void recentRateCoversTheWindow()
+  {
+    IpcStats stats;
+    for ( int64_t s = 0; s < 100; ++s )
+      stats.record( "GetFanData", ":1.5", 1'000, 10'000'000 + s * 1'000 );
+
+    const auto &m = stats.methods().at( "GetFanData" );
+    const int64_t last = 10'000'000 + 99'000;
+    QCOMPARE( m.recentCalls( last ), uint64_t( IpcStats::RATE_WINDOW_S ) );
+    QCOMPARE( m.recentCalls( last + 30'000 ), uint64_t( IpcStats::RATE_WINDOW_S - 30 ) );
+    QCOMPARE( m.recentCalls( last + 120'000 ), uint64_t( 0 ) );
+    QCOMPARE( m.latency.count, uint64_t( 100 ) );
+  }
+
+  void rateSlotsAreClearedAfterAGap()
+  {
+    IpcStats stats;
+    stats.record( "M", ":1.1", 1, 5'000 );
+    stats.record( "M", ":1.1", 1, 5'000 );
+    stats.record( "M", ":1.1", 1, 5'000 + int64_t( IpcStats::RATE_WINDOW_S ) * 1'000 );
+    QCOMPARE( stats.methods().at( "M" ).recentCalls( 5'000 + int64_t( IpcStats::RATE_WINDOW_S ) * 1'000 ),
+              uint64_t( 1 ) );
+  }
+
+  void quietSendersFoldIntoOther()
+  {
+    IpcStats stats;
+    // a long-lived poller, then many one-shot clients
+    for ( int i = 0; i < 50; ++i )
+      stats.record( "GetLiveSnapshot", ":1.2", 1'000, i );
+    for ( int i = 0; i < 100; ++i )
+      stats.record( "GetActiveProfileJSON", ":1." + std::to_string( 100 + i ), 1'000, i );
+
+    QVERIFY( stats.senders().size() <= IpcStats::MAX_SENDERS );
+    QCOMPARE( stats.senders().at( ":1.2" ).calls, uint64_t( 50 ) );
+    QVERIFY( stats.senders().contains( std::string( IpcStats::OTHER_SENDER ) ) );
+
+    // nothing is lost in the fold
+    uint64_t total = 0;
+    for ( const auto &[ sender, c ] : stats.senders() )
+      total += c.calls;
+    QCOMPARE( total, uint64_t( 150 ) );
+    uint64_t perMethod = 0;
+    for ( const auto &[ sender, c ] : stats.methods().at( "GetActiveProfileJSON" ).senders )
+      perMethod += c.calls;
+    QCOMPARE( perMethod, uint64_t( 100 ) );
+  }
+
+  void jsonListsBusiestMethodFirst()
+  {
+    IpcStats stats( 0 );
+    stats.record( "A", ":1.1", 1'000, 1'000 );
+    for ( int i = 0; i < 3; ++i )
+      stats.record( "B", "", 1'000, 1'000 );
+
+    std::string json;
+    JsonWriter w( json );
+    stats.toJSON( w, 2'000, []( std::string_view sender ) {
+      return sender == ":1.1" ? std::string( "tray (42)" ) : std::string();
+    } );
+
+    const QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( json ) ).object();
+    QCOMPARE( obj["calls"].toInt(), 4 );
+    QCOMPARE( obj["uptimeS"].toDouble(), 2.0 );
+    const QJsonArray methods = obj["methods"].toArray();
+    QCOMPARE( methods.size(), 2 );
+    QCOMPARE( methods[ 0 ].toObject()["name"].toString(), QStringLiteral( "B" ) );
+    QCOMPARE( methods[ 0 ].toObject()["senders"].toObject()["other"].toInt(), 3 );
+    QCOMPARE( methods[ 0 ].toObject()["histogram"].toArray().size(), qsizetype( LatencySnapshot::BUCKETS ) );
+
+    bool described = false;
+    for ( const auto &entry : obj["senders"].toArray() )
+      if ( entry.toObject()["sender"].toString() == QLatin1String( ":1.1" ) )
+        described = entry.toObject()["process"].toString() == QLatin1String( "tray (42)" );
+    QVERIFY( described );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestIpcStats )
+#include "test_ipc_stats.moc"
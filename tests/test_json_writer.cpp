@@ -0,0 +1,104 @@
+/*
+ * Unit tests for JsonWriter (to_chars-based JSON serialiser).
+ */
+
+#include <QTest>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <string>
+#include "JsonWriter.hpp"
+#include "MetricsHistoryStore.hpp"
+
+class TestJsonWriter : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void object_commasAndNesting()
+  {
+    std::string out;
+    JsonWriter w( out );
+    w.beginObject()
+     .key( "a" ).value( 1 )
+     .key( "b" ).beginArray().value( true ).value( false ).null().endArray()
+     .key( "c" ).beginObject().endObject()
+     .key( "d" ).beginArray().beginArray().value( 1 ).endArray().beginArray().endArray().endArray()
+     .endObject();
+    QCOMPARE( out, std::string( R"({"a":1,"b":[true,false,null],"c":{},"d":[[1],[]]})" ) );
+  }
+
+  void numbers_fixedAndShortest()
+  {
+    std::string out;
+    JsonWriter w( out );
+    w.beginArray()
+     .value( 45.5, 2 ).value( -1.0, 2 ).value( 46.0 ).value( 0.1 )
+     .value( INT_MIN ).value( int64_t( 1'700'000'000'000 ) ).value( 7u )
+     .endArray();
+    QCOMPARE( out, std::string( "[45.50,-1.00,46,0.1,-2147483648,1700000000000,7]" ) );
+  }
+
+  void numbers_nonFiniteBecomeNull()
+  {
+    std::string out;
+    JsonWriter w( out );
+    w.beginArray()
+     .value( std::numeric_limits< double >::quiet_NaN() )
+     .value( std::numeric_limits< double >::infinity(), 2 )
+     .endArray();
+    QCOMPARE( out, std::string( "[null,null]" ) );
+  }
+
+  void strings_escaped()
+  {
+    std::string out;
+    JsonWriter w( out );
+    w.beginObject().key( "s" ).value( std::string( "a\"b\\c\n\x01" ) ).endObject();
+    QCOMPARE( out, std::string( R"({"s":"a\"b\\c\n\u0001"})" ) );
+  }
+
+  void raw_insertedAsValue()
+  {
+    std::string out;
+    JsonWriter w( out );
+    w.beginObject().key( "x" ).raw( "[1,2]" ).key( "y" ).raw( "{}" ).endObject();
+    QCOMPARE( out, std::string( R"({"x":[1,2],"y":{}})" ) );
+  }
+
+  void buffer_reusedWithoutShrinking()
+  {
+    std::string out;
+    {
+      JsonWriter w( out );
+      w.beginArray();
+      for ( int i = 0; i < 100; ++i )
+        w.value( i );
+      w.endArray();
+    }
+    const size_t cap = out.capacity();
+    {
+      JsonWriter w( out );
+      w.beginArray().value( 1 ).endArray();
+    }
+    QCOMPARE( out, std::string( "[1]" ) );
+    QCOMPARE( out.capacity(), cap );
+  }
+
+  void historyJSON_format()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::CpuTemp, 1000, 45.5 );
+    store.push( MetricId::CpuTemp, 2000, 46.0 );
+    store.push( MetricId::GpuPower, 1500, 12.25 );
+
+    QCOMPARE( store.querySinceJSON( 0 ),
+              std::string( R"({"cpuTemp":[[1000,45.5],[2000,46]],"gpuPower":[[1500,12.25]]})" ) );
+    QCOMPARE( MetricsHistoryStore( 4 ).querySinceJSON( 0 ), std::string( "{}" ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestJsonWriter )
+
+#include "test_json_writer.moc"
@@ -0,0 +1,112 @@
+/*
+ * Unit tests for the keyboard backlight effects – parsing of the profile's
+ * "effect" object and the frames KeyboardEffectRenderer draws.
+ */
+
+#include <QTest>
+#include "KeyboardEffects.hpp"
+
+namespace
+{
+const KeyboardRgb RED{ 255, 0, 0 };
+const KeyboardRgb BLUE{ 0, 0, 255 };
+const KeyboardRgb BLACK{ 0, 0, 0 };
+
+KeyboardEffect effectOf( KeyboardEffectType type, std::vector< KeyboardRgb > colors, double speed = 1.0 )
+{
+  KeyboardEffect effect;
+  effect.type = type;
+  effect.colors = std::move( colors );
+  effect.speed = speed;
+  return effect;
+}
+}
+
+class TestKeyboardEffects : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void parseClampsAndRejectsUnknownTypes()
+  {
+    const auto effect = KeyboardEffect::fromJson( nlohmann::json::parse(
+      R"({"type":"wave","speed":50,"fps":500,"colors":[{"red":300,"green":-4,"blue":12},7]})" ) );
+    QVERIFY( effect.has_value() );
+    QCOMPARE( effect->type, KeyboardEffectType::Wave );
+    QCOMPARE( effect->speed, KeyboardEffect::MAX_SPEED );
+    QCOMPARE( effect->fps, KeyboardEffect::MAX_FPS );
+    QCOMPARE( effect->colors.size(), size_t( 1 ) );
+    QVERIFY( ( effect->colors[ 0 ] == KeyboardRgb{ 255, 0, 12 } ) );
+
+    QVERIFY( !KeyboardEffect::fromJson( nlohmann::json::parse( R"({"type":"disco"})" ) ) );
+    QVERIFY( !KeyboardEffect::fromJson( nlohmann::json::parse( R"({"speed":1})" ) ) );
+    QVERIFY( !KeyboardEffect::fromJson( nlohmann::json::parse( "[]" ) ) );
+
+    const auto defaults = KeyboardEffect::fromJson( nlohmann::json::parse( R"({"type":"reactive"})" ) );
+    QVERIFY( defaults.has_value() );
+    QCOMPARE( defaults->fps, 30 );
+    QVERIFY( defaults->colors.empty() );
+  }
+
+  void breathingFadesInAndOut()
+  {
+    std::vector< KeyboardRgb > frame( 3 );
+    const auto effect = effectOf( KeyboardEffectType::Breathing, { RED } );
+
+    KeyboardEffectRenderer::render( effect, 0.0, -1.0, frame );
+    QVERIFY( ( frame[ 0 ] == BLACK ) );
+    KeyboardEffectRenderer::render( effect, 0.5, -1.0, frame );
+    QVERIFY( ( frame[ 0 ] == RED ) );
+    QVERIFY( ( frame[ 2 ] == RED ) );
+    KeyboardEffectRenderer::render( effect, 0.25, -1.0, frame );
+    QVERIFY( frame[ 1 ].red >= 127 && frame[ 1 ].red <= 128 );
+  }
+
+  void reactiveFlashesOnPressAndFades()
+  {
+    std::vector< KeyboardRgb > frame( 2 );
+    const auto effect = effectOf( KeyboardEffectType::Reactive, { RED, BLUE } );
+
+    KeyboardEffectRenderer::render( effect, 3.0, -1.0, frame );
+    QVERIFY( ( frame[ 0 ] == BLUE ) );
+    KeyboardEffectRenderer::render( effect, 3.0, 0.0, frame );
+    QVERIFY( ( frame[ 0 ] == RED ) );
+    KeyboardEffectRenderer::render( effect, 3.0, 10.0 * KeyboardEffectRenderer::REACTIVE_DECAY_S, frame );
+    QVERIFY( ( frame[ 1 ] == BLUE ) );
+  }
+
+  void gradientSpansTheZones()
+  {
+    std::vector< KeyboardRgb > frame( 3 );
+    KeyboardEffectRenderer::render( effectOf( KeyboardEffectType::Gradient, { RED, BLUE } ), 7.0, -1.0, frame );
+    QVERIFY( ( frame[ 0 ] == RED ) );
+    QVERIFY( ( frame[ 1 ] == KeyboardRgb{ 128, 0, 128 } ) );
+    QVERIFY( ( frame[ 2 ] == BLUE ) );
+  }
+
+  void waveMovesOneZonePerStep()
+  {
+    std::vector< KeyboardRgb > before( 4 ), after( 4 );
+    const auto effect = effectOf( KeyboardEffectType::Wave, {}, 0.25 );
+
+    KeyboardEffectRenderer::render( effect, 0.0, -1.0, before );
+    // a quarter cycle later every colour has moved on by one of the four zones
+    KeyboardEffectRenderer::render( effect, 1.0, -1.0, after );
+    for ( size_t zone = 1; zone < 4; ++zone )
+      QVERIFY( ( after[ zone ] == before[ zone - 1 ] ) );
+    QVERIFY( ( after[ 0 ] == before[ 3 ] ) );
+    QVERIFY( ( before[ 0 ] == KeyboardEffectRenderer::hue( 0.0 ) ) );
+  }
+
+  void hueCircleClosesOnRed()
+  {
+    QVERIFY( ( KeyboardEffectRenderer::hue( 0.0 ) == RED ) );
+    QVERIFY( ( KeyboardEffectRenderer::hue( 1.0 ) == RED ) );
+    QVERIFY( ( KeyboardEffectRenderer::hue( 2.0 / 3.0 ) == BLUE ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestKeyboardEffects )
+
+#include "test_keyboard_effects.moc"
@@ -0,0 +1,131 @@
+/*
+ * Unit tests for KeyboardFrameReducer – vectorised row sums against a
+ * plain loop, and screen frames averaged per keyboard zone.
+ */
+
+#include <QTest>
+#include <random>
+#include "KeyboardFrameReducer.hpp"
+
+using ucc::KeyboardFrameReducer;
+using ucc::KeyboardZoneCell;
+
+namespace
+{
+/// A frame of 32-bit pixels, blue first, with @p padding spare bytes per row
+struct Frame
+{
+  int width = 0;
+  int height = 0;
+  size_t stride = 0;
+  std::vector< uint8_t > bytes;
+
+  Frame( int w, int h, size_t padding = 0 )
+    : width( w ), height( h ), stride( static_cast< size_t >( w ) * 4 + padding ),
+      bytes( stride * static_cast< size_t >( h ), 0xee )
+  {
+  }
+
+  void set( int x, int y, uint8_t red, uint8_t green, uint8_t blue )
+  {
+    uint8_t *px = bytes.data() + static_cast< size_t >( y ) * stride + static_cast< size_t >( x ) * 4;
+    px[ 0 ] = blue;
+    px[ 1 ] = green;
+    px[ 2 ] = red;
+    px[ 3 ] = 0xff;
+  }
+
+  void fill( int x0, int y0, int x1, int y1, uint8_t red, uint8_t green, uint8_t blue )
+  {
+    for ( int y = y0; y < y1; ++y )
+      for ( int x = x0; x < x1; ++x )
+        set( x, y, red, green, blue );
+  }
+};
+}
+
+class TestKeyboardFrameReducer : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void rowSumsMatchAPlainLoop()
+  {
+    std::mt19937 random( 7 );
+    std::vector< uint8_t > row( 4 * 1000 );
+    for ( auto &byte : row )
+      byte = static_cast< uint8_t >( random() );
+
+    // every length, so the vector loop ends on each possible remainder
+    for ( int count : { 0, 1, 3, 4, 5, 15, 16, 17, 63, 999, 1000 } )
+    {
+      uint64_t expected[ 3 ] = { 0, 0, 0 };
+      for ( int i = 0; i < count; ++i )
+        for ( int c = 0; c < 3; ++c )
+          expected[ c ] += row[ static_cast< size_t >( i ) * 4 + static_cast< size_t >( c ) ];
+
+      uint64_t sums[ 3 ] = { 1, 2, 3 };
+      KeyboardFrameReducer::sumRow( row.data(), count, sums );
+      QCOMPARE( sums[ 0 ], expected[ 0 ] + 1 );
+      QCOMPARE( sums[ 1 ], expected[ 1 ] + 2 );
+      QCOMPARE( sums[ 2 ], expected[ 2 ] + 3 );
+    }
+  }
+
+  void stripesSplitTheWidth()
+  {
+    const auto cells = KeyboardFrameReducer::stripes( 3 );
+    QCOMPARE( cells.size(), size_t( 3 ) );
+    QCOMPARE( cells[ 1 ].zone, 1 );
+    QCOMPARE( cells[ 1 ].right, 2.0 / 3.0 );
+    QCOMPARE( cells[ 2 ].bottom, 1.0 );
+  }
+
+  void zonesAverageTheirPartOfTheScreen()
+  {
+    // left half red, right half blue; the padding must never be read
+    Frame frame( 64, 8, 12 );
+    frame.fill( 0, 0, 32, 8, 200, 0, 0 );
+    frame.fill( 32, 0, 64, 8, 0, 0, 100 );
+
+    std::vector< uint8_t > rgb;
+    KeyboardFrameReducer::reduce( frame.bytes.data(), frame.width, frame.height, frame.stride,
+                                  KeyboardFrameReducer::stripes( 2 ), 2, rgb );
+    QCOMPARE( rgb, ( std::vector< uint8_t >{ 200, 0, 0, 0, 0, 100 } ) );
+
+    KeyboardFrameReducer::reduce( frame.bytes.data(), frame.width, frame.height, frame.stride,
+                                  KeyboardFrameReducer::stripes( 1 ), 1, rgb );
+    QCOMPARE( rgb, ( std::vector< uint8_t >{ 100, 0, 50 } ) );
+  }
+
+  void keyCellsAndZonesWithoutOne()
+  {
+    Frame frame( 40, 20 );
+    frame.fill( 0, 0, 40, 20, 10, 20, 30 );
+    frame.fill( 30, 10, 40, 20, 250, 250, 250 );
+
+    // zone 2 sits bottom right; zone 1 has no key on the layout
+    const std::vector< KeyboardZoneCell > cells{ { 0, 0.0, 0.0, 0.25, 0.5 }, { 2, 0.75, 0.5, 1.0, 1.0 } };
+    std::vector< uint8_t > rgb;
+    KeyboardFrameReducer::reduce( frame.bytes.data(), frame.width, frame.height, frame.stride, cells, 3, rgb );
+    QCOMPARE( rgb, ( std::vector< uint8_t >{ 10, 20, 30, 0, 0, 0, 250, 250, 250 } ) );
+  }
+
+  void tinyCellsStillCoverAPixel()
+  {
+    Frame frame( 4, 4 );
+    frame.fill( 0, 0, 4, 4, 9, 9, 9 );
+    std::vector< uint8_t > rgb;
+    KeyboardFrameReducer::reduce( frame.bytes.data(), frame.width, frame.height, frame.stride,
+                                  { { 0, 0.5, 0.5, 0.5, 0.5 } }, 1, rgb );
+    QCOMPARE( rgb, ( std::vector< uint8_t >{ 9, 9, 9 } ) );
+
+    KeyboardFrameReducer::reduce( nullptr, 0, 0, 0, KeyboardFrameReducer::stripes( 2 ), 2, rgb );
+    QCOMPARE( rgb, ( std::vector< uint8_t >( 6, 0 ) ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestKeyboardFrameReducer )
+
+#include "test_keyboard_frame_reducer.moc"
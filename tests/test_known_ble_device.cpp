@@ -0,0 +1,65 @@
+/*
+ * Unit tests for KnownBleDevice – the water cooler's address kept across
+ * daemon restarts, and files that are missing, foreign or damaged.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <fstream>
+#include "KnownBleDevice.hpp"
+
+class TestKnownBleDevice : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void savedDeviceLoadsBack()
+  {
+    QTemporaryDir dir;
+    // the state directory does not exist on a fresh install
+    const std::string path = dir.filePath( "state/water-cooler" ).toStdString();
+
+    const KnownBleDevice device{ "D0:1A:2B:3C:4D:5E", "LCT21001 Water Cooler" };
+    QVERIFY( device.save( path ) );
+    const auto loaded = KnownBleDevice::load( path );
+    QVERIFY( loaded.has_value() );
+    QVERIFY( *loaded == device );
+
+    KnownBleDevice::forget( path );
+    QVERIFY( !KnownBleDevice::load( path ).has_value() );
+  }
+
+  void foreignOrDamagedFilesAreIgnored()
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath( "water-cooler" ).toStdString();
+    QVERIFY( !KnownBleDevice::load( path ).has_value() );
+
+    std::ofstream( path, std::ios::trunc ) << "something else\nD0:1A:2B:3C:4D:5E\tLCT\n";
+    QVERIFY( !KnownBleDevice::load( path ).has_value() );
+
+    std::ofstream( path, std::ios::trunc ) << "ucc-water-cooler 1\nD0:1A:2B:3C:4D\tLCT\n";
+    QVERIFY( !KnownBleDevice::load( path ).has_value() );
+
+    // a device without a name still connects; the model falls back to the default
+    std::ofstream( path, std::ios::trunc ) << "ucc-water-cooler 1\nd0:1a:2b:3c:4d:5e\n";
+    const auto bare = KnownBleDevice::load( path );
+    QVERIFY( bare.has_value() );
+    QCOMPARE( bare->name, std::string() );
+  }
+
+  void invalidDevicesAreNotSaved()
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath( "water-cooler" ).toStdString();
+    QVERIFY( !( KnownBleDevice{ "D0-1A-2B-3C-4D-5E", "LCT" }.save( path ) ) );
+    QVERIFY( !( KnownBleDevice{ "D0:1A:2B:3C:4D:5E", "two\nlines" }.save( path ) ) );
+    QVERIFY( !KnownBleDevice::validAddress( "G0:1A:2B:3C:4D:5E" ) );
+    QVERIFY( KnownBleDevice::validAddress( "00:00:00:00:00:00" ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestKnownBleDevice )
+
+#include "test_known_ble_device.moc"
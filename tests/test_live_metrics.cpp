@@ -0,0 +1,215 @@
+/*
+ * Unit tests for the shared-memory live metrics segment:
+ * LiveMetricsPublisher (uccd) and LiveMetricsView (clients).
+ */
+
+#include <QTest>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include "LiveMetricsPublisher.hpp"
+#include "MetricsHistoryStore.hpp"
+
+namespace
+{
+uint32_t blockCount( const std::vector< uint8_t > &blob )
+{
+  uint32_t count = 0;
+  if ( blob.size() >= 5 )
+    std::memcpy( &count, blob.data() + 1, sizeof( count ) );
+  return count;
+}
+} // namespace
+
+class TestLiveMetrics : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void publishAndAttach()
+  {
+    LiveMetricsPublisher pub( 4, 8 );
+    QVERIFY( pub.isValid() );
+
+    ucc::LiveMetricsView view;
+    QVERIFY( view.attach( pub.readOnlyFd() ) );
+    QCOMPARE( view.metricCount(), size_t( 4 ) );
+    QVERIFY( !view.latest( 2 ).has_value() );
+
+    pub.publish( 2, 1000, 42.5 );
+    const auto pt = view.latest( 2 );
+    QVERIFY( pt.has_value() );
+    QCOMPARE( pt->timestampMs, int64_t( 1000 ) );
+    QCOMPARE( pt->value, 42.5 );
+  }
+
+  void copySince_matchesBinaryLayout()
+  {
+    LiveMetricsPublisher pub( 2, 8 );
+    ucc::LiveMetricsView view;
+    QVERIFY( view.attach( pub.readOnlyFd() ) );
+
+    for ( int i = 0; i < 5; ++i )
+      pub.publish( 1, 100 * i, static_cast< double >( i ) );
+
+    std::vector< uint8_t > blob;
+    QVERIFY( view.copySinceBinary( 250, blob ) );
+    QCOMPARE( blob.size(), size_t( 1 + 4 + 2 * 16 ) );
+    QCOMPARE( blob[ 0 ], uint8_t( 1 ) );
+    QCOMPARE( blockCount( blob ), 2u );
+
+    int64_t ts;
+    std::memcpy( &ts, blob.data() + 5, sizeof( ts ) );
+    QCOMPARE( ts, int64_t( 300 ) );
+  }
+
+  void copySince_reportsMissingCoverage()
+  {
+    LiveMetricsPublisher pub( 1, 4 );
+    ucc::LiveMetricsView view;
+    QVERIFY( view.attach( pub.readOnlyFd() ) );
+
+    for ( int i = 0; i < 10; ++i )
+      pub.publish( 0, 100 * i, 1.0 );
+
+    // Ring holds ts 600..900 only
+    std::vector< uint8_t > blob;
+    QVERIFY( !view.copySinceBinary( 0, blob ) );
+    QVERIFY( view.copySinceBinary( 600, blob ) );
+    QCOMPARE( blockCount( blob ), 4u );
+  }
+
+  void store_mirrorsPushes()
+  {
+    LiveMetricsPublisher pub( static_cast< size_t >( MetricId::Count ), 16 );
+    MetricsHistoryStore store( 16 );
+    store.setLiveSegment( &pub );
+
+    ucc::LiveMetricsView view;
+    QVERIFY( view.attach( pub.readOnlyFd() ) );
+
+    store.push( MetricId::GpuPower, 5000, 80.0 );
+    const auto pt = view.latest( static_cast< size_t >( MetricId::GpuPower ) );
+    QVERIFY( pt.has_value() );
+    QCOMPARE( pt->value, 80.0 );
+
+    std::vector< uint8_t > live;
+    QVERIFY( view.copySinceBinary( 0, live ) );
+    QCOMPARE( live, store.querySinceBinary( 0 ) );
+
+    store.setLiveSegment( nullptr );
+  }
+
+  void store_publishesFrameWhole()
+  {
+    LiveMetricsPublisher pub( static_cast< size_t >( MetricId::Count ), 16 );
+    MetricsHistoryStore store( 16 );
+    store.setLiveSegment( &pub );
+
+    ucc::LiveMetricsView view;
+    QVERIFY( view.attach( pub.readOnlyFd() ) );
+
+    MetricFrame frame;
+    frame.add( MetricId::CpuTemp, 70.0 );
+    frame.add( MetricId::CpuFanDuty, 55.0 );
+    store.pushFrame( 7000, frame );
+
+    const auto temp = view.latest( static_cast< size_t >( MetricId::CpuTemp ) );
+    const auto duty = view.latest( static_cast< size_t >( MetricId::CpuFanDuty ) );
+    QVERIFY( temp.has_value() && duty.has_value() );
+    QCOMPARE( temp->timestampMs, int64_t( 7000 ) );
+    QCOMPARE( duty->timestampMs, int64_t( 7000 ) );
+    QCOMPARE( duty->value, 55.0 );
+
+    std::vector< uint8_t > live;
+    QVERIFY( view.copySinceBinary( 0, live ) );
+    QCOMPARE( live, store.querySinceBinary( 0 ) );
+
+    store.setLiveSegment( nullptr );
+  }
+
+  void clientFd_isReadOnly()
+  {
+    LiveMetricsPublisher pub( 1, 4 );
+    void *addr = mmap( nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, pub.readOnlyFd(), 0 );
+    QVERIFY( addr == MAP_FAILED );
+  }
+
+  void attach_rejectsForeignFd()
+  {
+    const int fd = memfd_create( "not-ucc", MFD_CLOEXEC );
+    QVERIFY( fd >= 0 );
+    QVERIFY( ftruncate( fd, 4096 ) == 0 );
+
+    ucc::LiveMetricsView view;
+    QVERIFY( !view.attach( fd ) );
+    QVERIFY( !view.isAttached() );
+    ::close( fd );
+  }
+
+  void concurrentReaders_seeConsistentSnapshots()
+  {
+    LiveMetricsPublisher pub( 2, 64 );
+    std::atomic< bool > done{ false };
+    std::atomic< int > bad{ 0 };
+
+    std::thread writer( [&] {
+      for ( int64_t i = 1; i <= 100000; ++i )
+      {
+        pub.publish( 0, i, static_cast< double >( i ) );
+        pub.publish( 1, i, static_cast< double >( -i ) );
+      }
+      done = true;
+    } );
+
+    auto reader = [&] {
+      ucc::LiveMetricsView view;
+      if ( !view.attach( pub.readOnlyFd() ) )
+      {
+        ++bad;
+        return;
+      }
+      std::vector< uint8_t > blob;
+      while ( !done.load() )
+      {
+        if ( !view.copySinceBinary( 0, blob ) )
+          continue;  // ring wrapped past 0 or writer busy – both expected
+
+        // Walk all blocks: values must match their timestamps
+        size_t off = 0;
+        while ( off + 5 <= blob.size() )
+        {
+          const uint8_t id = blob[ off ];
+          uint32_t count;
+          std::memcpy( &count, blob.data() + off + 1, sizeof( count ) );
+          off += 5;
+          for ( uint32_t j = 0; j < count; ++j, off += 16 )
+          {
+            int64_t ts;
+            double val;
+            std::memcpy( &ts, blob.data() + off, sizeof( ts ) );
+            std::memcpy( &val, blob.data() + off + 8, sizeof( val ) );
+            const double expect = id == 0 ? static_cast< double >( ts ) : static_cast< double >( -ts );
+            if ( val != expect )
+              ++bad;
+          }
+        }
+      }
+    };
+
+    std::thread r1( reader );
+    std::thread r2( reader );
+    writer.join();
+    r1.join();
+    r2.join();
+
+    QCOMPARE( bad.load(), 0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestLiveMetrics )
+
+#include "test_live_metrics.moc"
@@ -0,0 +1,144 @@
+/*
+ * Unit tests for the compressed monitoring wire format (MetricsCodec.hpp)
+ * and MetricsHistoryStore::querySinceCompressed().
+ */
+
+#include <QTest>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "MetricsCodec.hpp"
+#include "MetricsHistoryStore.hpp"
+
+namespace
+{
+struct DecodedPoint
+{
+  uint8_t id;
+  int64_t ts;
+  double  val;
+};
+
+std::vector< DecodedPoint > decodeAll( const std::vector< uint8_t > &blob, bool *ok = nullptr )
+{
+  std::vector< DecodedPoint > pts;
+  const bool res = ucc::decodeMetricsCompressed(
+    blob.data(), blob.size(),
+    [&]( uint8_t id, int64_t ts, double v ) { pts.push_back( { id, ts, v } ); } );
+  if ( ok )
+    *ok = res;
+  return pts;
+}
+
+std::vector< uint8_t > encodeSeries( uint8_t id, const std::vector< int64_t > &ts,
+                                     const std::vector< double > &vals )
+{
+  std::vector< uint8_t > out;
+  ucc::MetricsEncoder enc( out );
+  enc.addSeries( id, static_cast< uint32_t >( ts.size() ),
+                 [&]( uint32_t i ) { return ts[ i ]; },
+                 [&]( uint32_t i ) { return vals[ i ]; } );
+  return out;
+}
+}
+
+class TestMetricsCodec : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void emptyStore_headerOnly()
+  {
+    MetricsHistoryStore store;
+    auto blob = store.querySinceCompressed( 0 );
+    QCOMPARE( blob.size(), size_t( 4 ) );
+    QCOMPARE( blob[ 2 ], ucc::METRICS_CODEC_VERSION );
+
+    bool ok = false;
+    QVERIFY( decodeAll( blob, &ok ).empty() );
+    QVERIFY( ok );
+  }
+
+  void roundTrip_regularSamples()
+  {
+    std::vector< int64_t > ts;
+    std::vector< double > vals;
+    for ( int i = 0; i < 1000; ++i )
+    {
+      ts.push_back( 1700000000000 + i * 800 + ( i % 7 == 0 ? 3 : 0 ) );
+      vals.push_back( 45.0 + ( i / 50 ) );
+    }
+
+    auto blob = encodeSeries( 3, ts, vals );
+    bool ok = false;
+    auto pts = decodeAll( blob, &ok );
+    QVERIFY( ok );
+    QCOMPARE( pts.size(), ts.size() );
+    for ( size_t i = 0; i < pts.size(); ++i )
+    {
+      QCOMPARE( pts[ i ].id, uint8_t( 3 ) );
+      QCOMPARE( pts[ i ].ts, ts[ i ] );
+      QCOMPARE( pts[ i ].val, vals[ i ] );
+    }
+
+    // Raw format costs 16 bytes per point; expect at least 10x less
+    QVERIFY( blob.size() * 10 < ts.size() * 16 );
+  }
+
+  void roundTrip_irregularValues()
+  {
+    std::vector< int64_t > ts = { -5, 0, 1, 100000, 100001, 99999999999, 100000000000 };
+    std::vector< double > vals = { 0.0, -0.0, 1e300, -1e-300, 12.345,
+                                   std::numeric_limits< double >::infinity(), 3.0 };
+
+    bool ok = false;
+    auto pts = decodeAll( encodeSeries( 0, ts, vals ), &ok );
+    QVERIFY( ok );
+    QCOMPARE( pts.size(), ts.size() );
+    for ( size_t i = 0; i < pts.size(); ++i )
+    {
+      QCOMPARE( pts[ i ].ts, ts[ i ] );
+      QVERIFY( std::memcmp( &pts[ i ].val, &vals[ i ], sizeof( double ) ) == 0 );
+    }
+  }
+
+  void store_matchesBinaryQuery()
+  {
+    MetricsHistoryStore store;
+    for ( int i = 0; i < 200; ++i )
+    {
+      store.push( MetricId::CpuTemp, 1000 + i * 1000, 50.0 + i % 5 );
+      store.push( MetricId::GpuPower, 1000 + i * 1000, 80.25 );
+    }
+
+    auto pts = decodeAll( store.querySinceCompressed( 51000 ) );
+    QCOMPARE( pts.size(), size_t( 300 ) );
+    QCOMPARE( pts.front().id, static_cast< uint8_t >( MetricId::CpuTemp ) );
+    QCOMPARE( pts.front().ts, int64_t( 51000 ) );
+    QCOMPARE( pts.back().id, static_cast< uint8_t >( MetricId::GpuPower ) );
+    QCOMPARE( pts.back().val, 80.25 );
+  }
+
+  void decode_rejectsBadHeader()
+  {
+    std::vector< uint8_t > blob = { 'U', 'M', 99, 0 };
+    bool ok = true;
+    decodeAll( blob, &ok );
+    QVERIFY( !ok );
+  }
+
+  void decode_rejectsTruncated()
+  {
+    auto blob = encodeSeries( 1, { 10, 20, 30 }, { 1.0, 2.0, 3.0 } );
+    blob.resize( blob.size() - 1 );
+    bool ok = true;
+    decodeAll( blob, &ok );
+    QVERIFY( !ok );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestMetricsCodec )
+
+#include "test_metrics_codec.moc"
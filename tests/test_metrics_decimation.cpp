@@ -0,0 +1,120 @@
+/*
+ * Unit tests for server-side decimation (MetricsDecimation.hpp) and
+ * MetricsHistoryStore::querySinceDecimated().
+ */
+
+#include <QTest>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "MetricsDecimation.hpp"
+#include "MetricsHistoryStore.hpp"
+
+namespace
+{
+std::vector< MetricDataPoint > sine( size_t n )
+{
+  std::vector< MetricDataPoint > pts;
+  for ( size_t i = 0; i < n; ++i )
+    pts.push_back( { static_cast< int64_t >( i ) * 1000, std::sin( static_cast< double >( i ) * 0.01 ) } );
+  return pts;
+}
+
+bool sorted( const std::vector< MetricDataPoint > &pts )
+{
+  for ( size_t i = 1; i < pts.size(); ++i )
+    if ( pts[ i ].timestampMs <= pts[ i - 1 ].timestampMs )
+      return false;
+  return true;
+}
+} // namespace
+
+class TestMetricsDecimation : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void lttb_respectsBudgetAndEndpoints()
+  {
+    const auto in = sine( 7200 );
+    std::vector< MetricDataPoint > out;
+    decimateLttb( in, 500, out );
+
+    QCOMPARE( out.size(), size_t( 500 ) );
+    QCOMPARE( out.front().timestampMs, in.front().timestampMs );
+    QCOMPARE( out.back().timestampMs, in.back().timestampMs );
+    QVERIFY( sorted( out ) );
+  }
+
+  void lttb_keepsIsolatedSpike()
+  {
+    auto in = sine( 5000 );
+    in[ 2345 ].value = 100.0;
+    std::vector< MetricDataPoint > out;
+    decimateLttb( in, 200, out );
+
+    bool found = false;
+    for ( const auto &pt : out )
+      found = found || pt.value == 100.0;
+    QVERIFY( found );
+  }
+
+  void lttb_smallInputCopied()
+  {
+    const auto in = sine( 10 );
+    std::vector< MetricDataPoint > out;
+    decimateLttb( in, 100, out );
+    QCOMPARE( out.size(), in.size() );
+  }
+
+  void minMax_keepsExtremesInOrder()
+  {
+    auto in = sine( 4000 );
+    in[ 100 ].value = -50.0;
+    in[ 3900 ].value = 50.0;
+    std::vector< MetricDataPoint > out;
+    decimateMinMax( in, 100, out );
+
+    QVERIFY( out.size() <= 100 );
+    QVERIFY( sorted( out ) );
+    double lo = 0.0;
+    double hi = 0.0;
+    for ( const auto &pt : out )
+    {
+      lo = std::min( lo, pt.value );
+      hi = std::max( hi, pt.value );
+    }
+    QCOMPARE( lo, -50.0 );
+    QCOMPARE( hi, 50.0 );
+  }
+
+  void store_maskSelectsMetrics()
+  {
+    MetricsHistoryStore store;
+    for ( int i = 0; i < 1000; ++i )
+    {
+      store.push( MetricId::CpuTemp, 1000LL * i, 40.0 + i % 7 );
+      store.push( MetricId::GpuTemp, 1000LL * i, 50.0 );
+    }
+
+    const uint32_t mask = 1u << static_cast< unsigned >( MetricId::GpuTemp );
+    const auto blob = store.querySinceDecimated( 0, mask, 100 );
+    QCOMPARE( blob.size(), size_t( 1 + 4 + 100 * 16 ) );
+    QCOMPARE( blob[ 0 ], static_cast< uint8_t >( MetricId::GpuTemp ) );
+  }
+
+  void store_zeroBudgetMatchesBinary()
+  {
+    MetricsHistoryStore store;
+    for ( int i = 0; i < 50; ++i )
+      store.push( MetricId::CpuPower, 1000LL * i, static_cast< double >( i ) );
+
+    QCOMPARE( store.querySinceDecimated( 0, ~0u, 0 ), store.querySinceBinary( 0 ) );
+    QCOMPARE( store.querySinceDecimated( 0, ~0u, 0, DecimationMode::MinMax ), store.querySinceBinary( 0 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestMetricsDecimation )
+
+#include "test_metrics_decimation.moc"
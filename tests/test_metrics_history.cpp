@@ -1,11 +1,20 @@
 /*
  * Unit tests for MetricsHistoryStore – push, querySinceJSON,
- * horizon clamping, eviction, and metricName().
+ * horizon clamping, eviction, ring wrap-around, concurrent readers,
+ * rollup tiers, file-backed persistence, per-core rows, tick frames and
+ * metricName().
  */
 
 #include <QTest>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
 #include <cstring>
+#include <filesystem>
 #include <string>
+#include <thread>
+#include <unistd.h>
 #include "MetricsHistoryStore.hpp"
 
 // C++20 helper — std::string::contains() is C++23
@@ -14,6 +23,33 @@ static bool strContains( const std::string &haystack, const char *needle )
   return haystack.find( needle ) != std::string::npos;
 }
 
+// Decode the header of the first block of a querySinceRollup() blob;
+// the result points into @p blob, which must outlive it
+struct RollupBlock
+{
+  uint32_t bucketMs = 0;
+  uint32_t count = 0;
+  const uint8_t *points = nullptr;
+};
+
+static RollupBlock firstRollupBlock( const std::vector< uint8_t > &blob )
+{
+  RollupBlock b;
+  if ( blob.size() < 9 )
+    return b;
+  std::memcpy( &b.bucketMs, blob.data() + 1, sizeof( b.bucketMs ) );
+  std::memcpy( &b.count, blob.data() + 5, sizeof( b.count ) );
+  b.points = blob.data() + 9;
+  return b;
+}
+
+static double rollupField( const RollupBlock &b, uint32_t idx, int field )
+{
+  double v;
+  std::memcpy( &v, b.points + idx * 32 + 8 + field * 8, sizeof( v ) );
+  return v;
+}
+
 class TestMetricsHistory : public QObject
 {
   Q_OBJECT
@@ -30,6 +66,10 @@ private slots:
               std::string( "gpuPower" ) );
     QCOMPARE( std::string( metricName( MetricId::GpuCoreVoltage ) ),
               std::string( "gpuCoreVoltage" ) );
+    QCOMPARE( std::string( metricName( MetricId::Gpu2Temp ) ),
+              std::string( "gpu2Temp" ) );
+    QCOMPARE( std::string( metricName( MetricId::GpuComputeUtil ) ),
+              std::string( "gpuComputeUtil" ) );
   }
 
   void metricName_sentinel()
@@ -130,6 +170,94 @@ private slots:
     QCOMPARE( count, 1u );
   }
 
+  // ---- pushFrame() / querySinceFrames() --------------------------------
+
+  void frame_sharesOneTimestamp()
+  {
+    MetricsHistoryStore store( 16 );
+    MetricFrame frame;
+    frame.add( MetricId::CpuTemp, 61.0 );
+    frame.add( MetricId::CpuFanDuty, 40.0 );
+    store.pushFrame( 5000, frame );
+
+    QCOMPARE( store.latest( MetricId::CpuTemp )->timestampMs, int64_t( 5000 ) );
+    QCOMPARE( store.latest( MetricId::CpuFanDuty )->timestampMs, int64_t( 5000 ) );
+    QCOMPARE( store.latest( MetricId::CpuFanDuty )->value, 40.0 );
+    QVERIFY( !store.latest( MetricId::GpuTemp ) );
+  }
+
+  void frame_holdsOneSamplePerMetric()
+  {
+    MetricFrame frame;
+    QVERIFY( frame.empty() );
+    for ( size_t i = 0; i < MetricRegistry::MAX_METRICS + 3; ++i )
+      frame.add( MetricId::CpuTemp, static_cast< double >( i ) );
+    QCOMPARE( std::span< const MetricSample >( frame ).size(), MetricRegistry::MAX_METRICS );
+  }
+
+  void frames_columnar()
+  {
+    MetricsHistoryStore store( 16 );
+    const std::array< MetricSample, 2 > tick{ { { MetricId::CpuTemp, 60.0 }, { MetricId::CpuFanDuty, 30.0 } } };
+    store.pushFrame( 1000, tick );
+    store.pushFrame( 2000, tick );
+    store.push( MetricId::CpuTemp, 2500, 62.0 );  // pushed alone: the duty column has a gap
+    store.push( MetricId::GpuTemp, 2500, 50.0 );  // not selected
+
+    const auto bit = []( MetricId id ) { return uint64_t( 1 ) << static_cast< int >( id ); };
+    const uint64_t mask = bit( MetricId::CpuTemp ) | bit( MetricId::CpuFanDuty ) | bit( MetricId::CpuPower )
+                          | bit( MetricId::SystemPowerOnBattery );
+    const auto blob = store.querySinceFrames( 1500, mask );
+
+    uint64_t present = 0;
+    uint32_t rows = 0;
+    std::memcpy( &present, blob.data(), 8 );
+    std::memcpy( &rows, blob.data() + 8, 4 );
+    QCOMPARE( present, bit( MetricId::CpuTemp ) | bit( MetricId::CpuFanDuty ) );
+    QCOMPARE( rows, uint32_t( 2 ) );
+    QCOMPARE( blob.size(), size_t( 12 + 2 * 8 + 2 * 2 * 8 ) );
+
+    int64_t ts[ 2 ];
+    double temp[ 2 ], duty[ 2 ];
+    std::memcpy( ts, blob.data() + 12, sizeof( ts ) );
+    std::memcpy( temp, blob.data() + 28, sizeof( temp ) );
+    std::memcpy( duty, blob.data() + 44, sizeof( duty ) );
+    QCOMPARE( ts[ 0 ], int64_t( 2000 ) );
+    QCOMPARE( ts[ 1 ], int64_t( 2500 ) );
+    QCOMPARE( temp[ 0 ], 60.0 );
+    QCOMPARE( temp[ 1 ], 62.0 );
+    QCOMPARE( duty[ 0 ], 30.0 );
+    QVERIFY( std::isnan( duty[ 1 ] ) );
+
+    QCOMPARE( store.querySinceFrames( 0, bit( MetricId::CpuPower ) ).size(), size_t( 12 ) );
+  }
+
+  void frames_pagedByMaxRows()
+  {
+    MetricsHistoryStore store( 16 );
+    for ( int64_t ts = 1000; ts <= 5000; ts += 1000 )
+      store.push( MetricId::CpuTemp, ts, static_cast< double >( ts ) / 100.0 );
+
+    // the oldest rows first; the next page starts after the last row
+    const uint64_t mask = uint64_t( 1 ) << static_cast< int >( MetricId::CpuTemp );
+    std::vector< int64_t > seen;
+    for ( int64_t since = 0;; )
+    {
+      const auto page = store.querySinceFrames( since, mask, 2 );
+      uint32_t rows = 0;
+      std::memcpy( &rows, page.data() + 8, 4 );
+      QVERIFY( rows <= 2 );
+      QCOMPARE( page.size(), size_t( 12 + rows * 16 ) );
+      if ( rows == 0 )
+        break;
+      int64_t ts[ 2 ];
+      std::memcpy( ts, page.data() + 12, rows * 8 );
+      seen.insert( seen.end(), ts, ts + rows );
+      since = ts[ rows - 1 ] + 1;
+    }
+    QCOMPARE( seen, ( std::vector< int64_t >{ 1000, 2000, 3000, 4000, 5000 } ) );
+  }
+
   // ---- setHorizon() – clamping -----------------------------------------
 
   void horizon_default()
@@ -183,6 +311,608 @@ private slots:
     std::memcpy( &count, blob.data() + 1, sizeof( count ) );
     QCOMPARE( count, 1u );
   }
+
+  // ---- fixed-capacity ring ---------------------------------------------
+
+  void ring_wrapKeepsNewest()
+  {
+    MetricsHistoryStore store( 8 );
+    QCOMPARE( store.capacityPerMetric(), size_t( 8 ) );
+
+    for ( int i = 0; i < 20; ++i )
+      store.push( MetricId::CpuTemp, 1000 + i, static_cast< double >( i ) );
+
+    auto blob = store.querySinceBinary( 0 );
+    uint32_t count;
+    std::memcpy( &count, blob.data() + 1, sizeof( count ) );
+    QCOMPARE( count, 8u );
+
+    // Oldest retained point is #12, newest #19
+    int64_t firstTs;
+    double lastVal;
+    std::memcpy( &firstTs, blob.data() + 5, sizeof( firstTs ) );
+    std::memcpy( &lastVal, blob.data() + 5 + 7 * 16 + 8, sizeof( lastVal ) );
+    QCOMPARE( firstTs, int64_t( 1012 ) );
+    QCOMPARE( lastVal, 19.0 );
+  }
+
+  void ring_sinceAcrossWrap()
+  {
+    MetricsHistoryStore store( 4 );
+    for ( int i = 0; i < 10; ++i )
+      store.push( MetricId::GpuPower, 100 * i, static_cast< double >( i ) );
+
+    // Retained: ts 600, 700, 800, 900 — query from 750 returns 2 points
+    auto blob = store.querySinceBinary( 750 );
+    QCOMPARE( blob.size(), size_t( 1 + 4 + 2 * 16 ) );
+  }
+
+  void ring_concurrentReadersSeeConsistentData()
+  {
+    // One writer laps a tiny ring while readers copy it; every copied point
+    // must be an intact (ts, value) pair in ascending order.
+    MetricsHistoryStore store( 64 );
+    std::atomic< bool > done{ false };
+    std::atomic< int > bad{ 0 };
+
+    std::thread writer( [&] {
+      for ( int64_t i = 1; i <= 200000; ++i )
+        store.push( MetricId::CpuPower, i, static_cast< double >( i ) * 0.5 );
+      done = true;
+    } );
+
+    auto reader = [&] {
+      while ( !done.load() )
+      {
+        const auto blob = store.querySinceBinary( 0 );
+        if ( blob.size() < 5 )
+          continue;
+        uint32_t count;
+        std::memcpy( &count, blob.data() + 1, sizeof( count ) );
+        int64_t prev = 0;
+        for ( uint32_t j = 0; j < count; ++j )
+        {
+          int64_t ts;
+          double val;
+          std::memcpy( &ts, blob.data() + 5 + j * 16, sizeof( ts ) );
+          std::memcpy( &val, blob.data() + 5 + j * 16 + 8, sizeof( val ) );
+          if ( val != static_cast< double >( ts ) * 0.5 || ts <= prev )
+            ++bad;
+          prev = ts;
+        }
+      }
+    };
+
+    std::thread r1( reader );
+    std::thread r2( reader );
+    writer.join();
+    r1.join();
+    r2.join();
+
+    QCOMPARE( bad.load(), 0 );
+  }
+
+  // ---- rollup tiers ----------------------------------------------------
+
+  void rollup_budgetPrefersRaw()
+  {
+    MetricsHistoryStore store;
+    for ( int i = 0; i < 30; ++i )
+      store.push( MetricId::CpuTemp, 1000 * i, static_cast< double >( i ) );
+
+    const auto blob = store.querySinceRollup( 0, 100 );
+    const auto b = firstRollupBlock( blob );
+    QCOMPARE( b.bucketMs, 0u );
+    QCOMPARE( b.count, 30u );
+    QCOMPARE( rollupField( b, 7, 0 ), 7.0 );
+    QCOMPARE( rollupField( b, 7, 2 ), 7.0 );
+  }
+
+  void rollup_tenSecondBuckets()
+  {
+    MetricsHistoryStore store;
+    for ( int i = 0; i < 30; ++i )
+      store.push( MetricId::CpuTemp, 1000 * i, static_cast< double >( i ) );
+
+    // 30 raw points exceed the budget; buckets [0,10) and [10,20) are closed,
+    // [20,30) is still open and not yet visible.
+    const auto blob = store.querySinceRollup( 0, 5 );
+    QCOMPARE( blob[ 0 ], static_cast< uint8_t >( MetricId::CpuTemp ) );
+    const auto b = firstRollupBlock( blob );
+    QCOMPARE( b.bucketMs, 10000u );
+    QCOMPARE( b.count, 2u );
+    QCOMPARE( rollupField( b, 0, 0 ), 0.0 );
+    QCOMPARE( rollupField( b, 0, 1 ), 9.0 );
+    QCOMPARE( rollupField( b, 0, 2 ), 4.5 );
+    QCOMPARE( rollupField( b, 1, 0 ), 10.0 );
+    QCOMPARE( rollupField( b, 1, 2 ), 14.5 );
+  }
+
+  void rollup_longWindowBeyondRawRing()
+  {
+    // Raw ring only holds 8 samples; an hour of 1 Hz data must come from
+    // the rollups, and a tighter budget must move to the 1 min tier.
+    MetricsHistoryStore store( 8 );
+    for ( int i = 0; i < 3600; ++i )
+      store.push( MetricId::GpuPower, 1000LL * i, 50.0 );
+
+    const auto fine = store.querySinceRollup( 0, 1000 );
+    auto b = firstRollupBlock( fine );
+    QCOMPARE( b.bucketMs, 10000u );
+    QCOMPARE( b.count, 359u );
+
+    const auto coarse = store.querySinceRollup( 0, 100 );
+    b = firstRollupBlock( coarse );
+    QCOMPARE( b.bucketMs, 60000u );
+    QCOMPARE( b.count, 59u );
+    QCOMPARE( rollupField( b, 0, 2 ), 50.0 );
+  }
+
+  void rollup_recentWindowStaysRaw()
+  {
+    MetricsHistoryStore store( 8 );
+    for ( int i = 0; i < 3600; ++i )
+      store.push( MetricId::GpuPower, 1000LL * i, 50.0 );
+
+    // The last 5 s are still in the raw ring
+    const auto blob = store.querySinceRollup( 3595000, 100 );
+    const auto b = firstRollupBlock( blob );
+    QCOMPARE( b.bucketMs, 0u );
+    QCOMPARE( b.count, 5u );
+  }
+
+  // ---- file-backed persistence -----------------------------------------
+
+  void backing_reattachAfterRestart()
+  {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ( "ucc-test-history-" + std::to_string( getpid() ) );
+    std::filesystem::remove( path );
+
+    {
+      MetricsHistoryStore store( 16, path.string() );
+      for ( int i = 0; i < 20; ++i )
+        store.push( MetricId::CpuTemp, 1000 * i, static_cast< double >( i ) );
+    }
+
+    {
+      MetricsHistoryStore store( 16, path.string() );
+      auto blob = store.querySinceBinary( 0 );
+      QVERIFY( blob.size() >= 5 );
+      uint32_t count;
+      std::memcpy( &count, blob.data() + 1, sizeof( count ) );
+      QCOMPARE( count, 16u );
+
+      // Rollups survive as well, and new samples append after the old ones
+      store.push( MetricId::CpuTemp, 20000, 20.0 );
+      blob = store.querySinceBinary( 19000 );
+      QCOMPARE( blob.size(), size_t( 1 + 4 + 2 * 16 ) );
+      const auto rollup = store.querySinceRollup( 0, 1 );
+      const auto b = firstRollupBlock( rollup );
+      QCOMPARE( b.bucketMs, 10000u );
+    }
+
+    // A different layout must not reinterpret the old contents
+    {
+      MetricsHistoryStore store( 32, path.string() );
+      QCOMPARE( store.querySinceJSON( 0 ), std::string( "{}" ) );
+    }
+
+    std::filesystem::remove( path );
+  }
+
+  void backing_reattachCreatesWrittenSeriesOnly()
+  {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ( "ucc-test-history-present-" + std::to_string( getpid() ) );
+    std::filesystem::remove( path );
+
+    {
+      MetricsHistoryStore store( 16, path.string() );
+      store.push( MetricId::GpuPower, 1000, 30.0 );
+    }
+    {
+      MetricsHistoryStore store( 16, path.string() );
+      QCOMPARE( store.presentMask(), uint64_t( 1 ) << static_cast< size_t >( MetricId::GpuPower ) );
+      QCOMPARE( store.latest( MetricId::GpuPower )->value, 30.0 );
+    }
+
+    std::filesystem::remove( path );
+  }
+
+  void backing_unwritablePathFallsBackToHeap()
+  {
+    MetricsHistoryStore store( 16, "/proc/ucc-no-such-dir/history" );
+    store.push( MetricId::CpuTemp, 1000, 42.0 );
+    QVERIFY( strContains( store.querySinceJSON( 0 ), "42" ) );
+  }
+
+  void ring_recoverDropsTornSuffix()
+  {
+    // Simulate a power loss where the head counter reached disk but the
+    // newest slot did not: the stale slot breaks timestamp order.
+    std::vector< std::byte > region( MetricRing::regionBytes( 8 ) );
+    {
+      MetricRing ring( 8, region.data() );
+      ring.reset();
+      for ( int i = 1; i <= 5; ++i )
+        ring.push( 100 * i, static_cast< double >( i ), 1'000'000 );
+    }
+
+    // Slot layout: 64-byte counters, then 9 timestamps; seq 4 is the newest
+    int64_t stale = 0;
+    std::memcpy( region.data() + 64 + 4 * sizeof( int64_t ), &stale, sizeof( stale ) );
+
+    MetricRing ring( 8, region.data() );
+    ring.recover();
+    QCOMPARE( ring.size(), size_t( 4 ) );
+  }
+
+  // ---- latest() --------------------------------------------------------
+
+  void latest_emptyIsNullopt()
+  {
+    MetricsHistoryStore store( 16 );
+    QVERIFY( !store.latest( MetricId::CpuTemp ).has_value() );
+    QVERIFY( !store.latest( MetricId::Count ).has_value() );
+  }
+
+  void latest_returnsNewestAcrossWrap()
+  {
+    MetricsHistoryStore store( 4 );
+    for ( int i = 1; i <= 10; ++i )
+      store.push( MetricId::GpuPower, 1000 * i, static_cast< double >( i ) );
+
+    const auto pt = store.latest( MetricId::GpuPower );
+    QVERIFY( pt.has_value() );
+    QCOMPARE( pt->timestampMs, int64_t( 10000 ) );
+    QCOMPARE( pt->value, 10.0 );
+    QVERIFY( !store.latest( MetricId::CpuTemp ).has_value() );
+  }
+
+  void copySince_singleMetric()
+  {
+    MetricsHistoryStore store( 16 );
+    for ( int i = 1; i <= 6; ++i )
+      store.push( MetricId::CpuPower, 1000 * i, 10.0 * i );
+    store.push( MetricId::GpuPower, 6000, 99.0 );
+
+    std::vector< MetricDataPoint > out;
+    store.copySince( MetricId::CpuPower, 4000, out );
+    QCOMPARE( out.size(), size_t( 3 ) );
+    QCOMPARE( out.front().timestampMs, int64_t( 4000 ) );
+    QCOMPARE( out.back().value, 60.0 );
+
+    store.copySince( MetricId::Count, 0, out );
+    QCOMPARE( out.size(), size_t( 3 ) );
+  }
+
+  void latest_afterHorizonEviction()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::CpuTemp, 1000, 40.0 );
+    // Far past the maximum horizon — evicts the first point, keeps the new one
+    store.push( MetricId::CpuTemp, 1000 + MetricsHistoryStore::MAX_HORIZON_S * 2000, 50.0 );
+
+    const auto pt = store.latest( MetricId::CpuTemp );
+    QVERIFY( pt.has_value() );
+    QCOMPARE( pt->value, 50.0 );
+  }
+
+  // ---- streaming statistics ----------------------------------------------
+
+  void stats_emptyHasNoSamples()
+  {
+    MetricsHistoryStore store( 16 );
+    QCOMPARE( store.statsSince( MetricId::CpuTemp, 0 ).samples, uint64_t( 0 ) );
+    QCOMPARE( store.statsSince( MetricId::Count, 0 ).samples, uint64_t( 0 ) );
+  }
+
+  void stats_percentilesOfUniformRamp()
+  {
+    MetricsHistoryStore store( 16 );
+    const int64_t t0 = 1000 * StreamingStats::PANE_MS;
+    for ( int i = 0; i < 1000; ++i )
+      store.push( MetricId::CpuTemp, t0 + 1000 * i, static_cast< double >( i % 100 ) );
+
+    const auto st = store.statsSince( MetricId::CpuTemp, t0 );
+    QCOMPARE( st.samples, uint64_t( 1000 ) );
+    QCOMPARE( st.min, 0.0 );
+    QCOMPARE( st.max, 99.0 );
+    QVERIFY( std::abs( st.avg - 49.5 ) < 0.1 );
+    QVERIFY( std::abs( st.p50 - 50.0 ) <= 1.0 );
+    QVERIFY( std::abs( st.p95 - 95.0 ) <= 1.0 );
+    QVERIFY( std::abs( st.p99 - 99.0 ) <= 1.0 );
+    QVERIFY( std::abs( st.seconds - 1000.0 ) < 1e-9 );
+  }
+
+  void stats_timeAboveThreshold()
+  {
+    MetricsHistoryStore store( 16 );
+    const int64_t t0 = 1000 * StreamingStats::PANE_MS;
+    for ( int i = 0; i < 900; ++i )
+      store.push( MetricId::GpuTemp, t0 + 1000 * i, i < 600 ? 50.0 : 95.0 );
+
+    QVERIFY( std::abs( store.statsSince( MetricId::GpuTemp, t0, 90.0 ).secondsAbove - 300.0 ) < 1e-9 );
+    QCOMPARE( store.statsSince( MetricId::GpuTemp, t0, 95.0 ).secondsAbove, 0.0 );
+    QVERIFY( std::abs( store.statsSince( MetricId::GpuTemp, t0, 10.0 ).secondsAbove - 900.0 ) < 1e-9 );
+  }
+
+  void stats_weightsSamplesByInterval()
+  {
+    MetricsHistoryStore store( 16 );
+    const int64_t t0 = 1000 * StreamingStats::PANE_MS;
+    // A burst of fast samples must not outweigh a long steady stretch
+    for ( int i = 0; i < 10; ++i )
+      store.push( MetricId::CpuPower, t0 + 1000 * i, 10.0 );
+    for ( int i = 0; i < 100; ++i )
+      store.push( MetricId::CpuPower, t0 + 10'000 + 10 * i, 100.0 );
+
+    const auto st = store.statsSince( MetricId::CpuPower, t0 );
+    QCOMPARE( st.samples, uint64_t( 110 ) );
+    QVERIFY( st.p50 < 20.0 );
+    QVERIFY( st.avg < 60.0 );
+  }
+
+  void stats_sinceSkipsOlderMinutes()
+  {
+    MetricsHistoryStore store( 16 );
+    const int64_t t0 = 1000 * StreamingStats::PANE_MS;
+    store.push( MetricId::CpuTemp, t0, 100.0 );
+    for ( int i = 0; i < 60; ++i )
+      store.push( MetricId::CpuTemp, t0 + 5 * StreamingStats::PANE_MS + 1000 * i, 40.0 );
+
+    const auto st = store.statsSince( MetricId::CpuTemp, t0 + 5 * StreamingStats::PANE_MS );
+    QCOMPARE( st.samples, uint64_t( 60 ) );
+    QCOMPARE( st.max, 40.0 );
+    QCOMPARE( store.statsSince( MetricId::CpuTemp, t0 ).max, 100.0 );
+  }
+
+  void stats_windowDropsPanesOlderThanTwoHours()
+  {
+    MetricsHistoryStore store( 16 );
+    const int64_t t0 = 1000 * StreamingStats::PANE_MS;
+    store.push( MetricId::CpuTemp, t0, 100.0 );
+    store.push( MetricId::CpuTemp, t0 + StreamingStats::WINDOW_MS + StreamingStats::PANE_MS, 40.0 );
+
+    const auto st = store.statsSince( MetricId::CpuTemp, 0 );
+    QCOMPARE( st.samples, uint64_t( 1 ) );
+    QCOMPARE( st.max, 40.0 );
+  }
+
+  void stats_jsonListsThresholdOnlyWhenRequested()
+  {
+    MetricsHistoryStore store( 16 );
+    for ( int i = 0; i < 10; ++i )
+    {
+      store.push( MetricId::CpuTemp, 1000 * i, 80.0 );
+      store.push( MetricId::GpuTemp, 1000 * i, 60.0 );
+    }
+
+    std::array< double, static_cast< size_t >( MetricId::Count ) > thresholds;
+    thresholds.fill( std::numeric_limits< double >::quiet_NaN() );
+    thresholds[ static_cast< size_t >( MetricId::CpuTemp ) ] = 75.0;
+
+    std::string json;
+    store.queryStatsJSON( 0, thresholds, json );
+    QVERIFY( strContains( json, "\"cpuTemp\":{\"samples\":10," ) );
+    QVERIFY( strContains( json, "\"threshold\":75.00,\"secondsAbove\":10.0}" ) );
+    QVERIFY( strContains( json, "\"gpuTemp\":{" ) );
+    QVERIFY( !strContains( json, "cpuPower" ) );
+    QCOMPARE( json.find( "threshold" ), json.rfind( "threshold" ) );
+  }
+
+  void stats_rebuiltFromBackingFile()
+  {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ( "ucc-test-history-stats-" + std::to_string( getpid() ) );
+    std::filesystem::remove( path );
+
+    {
+      MetricsHistoryStore store( 16, path.string() );
+      for ( int i = 0; i < 10; ++i )
+        store.push( MetricId::CpuTemp, 1000 * i, 50.0 + i );
+    }
+    {
+      MetricsHistoryStore store( 16, path.string() );
+      const auto st = store.statsSince( MetricId::CpuTemp, 0 );
+      QCOMPARE( st.samples, uint64_t( 10 ) );
+      QCOMPARE( st.max, 59.0 );
+    }
+
+    std::filesystem::remove( path );
+  }
+
+  // ---- event annotations -------------------------------------------------
+
+  void events_appendedAfterMetricBlocks()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::CpuTemp, 1000, 40.0 );
+    store.recordEvent( 1500, ucc::MetricEventKind::ProfileSwitch, 0, "Quiet" );
+    store.recordEvent( 2500, ucc::MetricEventKind::PowerState, 1, "power_bat" );
+
+    const auto blob = store.querySinceBinary( 0 );
+
+    // A parser that only knows metric blocks skips the event block cleanly
+    size_t pos = 0;
+    std::vector< uint8_t > ids;
+    while ( pos + 5 <= blob.size() )
+    {
+      uint32_t count = 0;
+      std::memcpy( &count, blob.data() + pos + 1, sizeof( count ) );
+      ids.push_back( blob[ pos ] );
+      pos += 5 + size_t( count ) * 16;
+    }
+    QCOMPARE( pos, blob.size() );
+    QCOMPARE( ids, ( std::vector< uint8_t >{ 0, ucc::METRIC_EVENT_BLOCK_ID } ) );
+
+    std::vector< ucc::MetricEventRecord > events;
+    QVERIFY( ucc::decodeMetricEvents( blob.data(), blob.size(),
+                                      [&]( const ucc::MetricEventRecord &ev ) { events.push_back( ev ); } ) );
+    QCOMPARE( events.size(), size_t( 2 ) );
+    QCOMPARE( events[ 0 ].timestampMs, int64_t( 1500 ) );
+    QCOMPARE( events[ 0 ].kind, uint16_t( ucc::MetricEventKind::ProfileSwitch ) );
+    QVERIFY( events[ 0 ].labelView() == "Quiet" );
+    QCOMPARE( events[ 1 ].value, 1 );
+    QVERIFY( events[ 1 ].labelView() == "power_bat" );
+
+    QVERIFY( !ucc::decodeMetricEvents( blob.data(), blob.size() - 1, []( const ucc::MetricEventRecord & ) {} ) );
+  }
+
+  void events_sinceFiltersAndNoBlockWhenEmpty()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::CpuTemp, 1000, 40.0 );
+    QCOMPARE( store.querySinceBinary( 0 ).size(), size_t( 5 + 16 ) );
+
+    store.recordEvent( 1000, ucc::MetricEventKind::GpuPerfLimit, 1, "Power Limit" );
+    store.recordEvent( 3000, ucc::MetricEventKind::GpuPerfLimit, 0, "None" );
+    QCOMPARE( store.eventsSince( 2000 ).size(), size_t( 1 ) );
+    QCOMPARE( store.querySinceBinary( 4000 ).size(), size_t( 0 ) );
+
+    // the event block alone, without the metric blocks
+    const auto events = store.queryEventsSinceBinary( 0 );
+    QCOMPARE( events.size(), size_t( 5 + 2 * sizeof( ucc::MetricEventRecord ) ) );
+    QCOMPARE( events[ 0 ], ucc::METRIC_EVENT_BLOCK_ID );
+    QVERIFY( store.queryEventsSinceBinary( 4000 ).empty() );
+  }
+
+  void events_ringKeepsNewestAndTruncatesLabels()
+  {
+    MetricsHistoryStore store( 16 );
+    const std::string longName( 100, 'x' );
+    for ( size_t i = 0; i < MetricEventRing::CAPACITY + 10; ++i )
+      store.recordEvent( int64_t( i ), ucc::MetricEventKind::ProfileSwitch, 0, longName );
+
+    const auto events = store.eventsSince( 0 );
+    QCOMPARE( events.size(), MetricEventRing::CAPACITY );
+    QCOMPARE( events.front().timestampMs, int64_t( 10 ) );
+    QCOMPARE( events.back().labelView().size(), ucc::METRIC_EVENT_LABEL_SIZE - 1 );
+  }
+
+  void cores_denseRowsSinceTimestamp()
+  {
+    MetricsHistoryStore store( 16 );
+    QVERIFY( store.queryCoresSinceBinary( 0 ).empty() );
+
+    const int64_t now = std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::system_clock::now().time_since_epoch() ).count();
+    store.setCoreLayout( { 0, 2 }, { 1, 2 } );
+    store.pushCores( now - 2000, { 4700.4, 1200.0 }, { 99.6, 3.0 } );
+    store.pushCores( now - 1000, { -1.0, 800.0 }, { -1.0, 0.0 } );
+    store.pushCores( now, { 1.0 }, { 1.0 } );  // wrong width, dropped
+
+    const auto blob = store.queryCoresSinceBinary( now - 1500 );
+    uint32_t cores = 0, rows = 0;
+    std::memcpy( &cores, blob.data(), 4 );
+    std::memcpy( &rows, blob.data() + 4, 4 );
+    QCOMPARE( cores, uint32_t( 2 ) );
+    QCOMPARE( rows, uint32_t( 1 ) );
+    QCOMPARE( blob.size(), size_t( 8 + 2 * 5 + 8 + 2 * 3 ) );
+
+    int32_t cpu = 0;
+    std::memcpy( &cpu, blob.data() + 8 + 5, 4 );
+    QCOMPARE( cpu, int32_t( 2 ) );
+    QCOMPARE( blob[ 8 + 5 + 4 ], uint8_t( 2 ) );
+
+    const uint8_t *row = blob.data() + 8 + 10;
+    int64_t ts = 0;
+    uint16_t freq[ 2 ] = {};
+    std::memcpy( &ts, row, 8 );
+    std::memcpy( freq, row + 8, 4 );
+    QCOMPARE( ts, now - 1000 );
+    QCOMPARE( freq[ 0 ], uint16_t( 0 ) );
+    QCOMPARE( freq[ 1 ], uint16_t( 800 ) );
+    QCOMPARE( row[ 12 ], CoreHistoryRing::NO_BUSY );
+    QCOMPARE( row[ 13 ], uint8_t( 0 ) );
+
+    // the same layout keeps the rows, a new one drops them
+    store.setCoreLayout( { 0, 2 }, { 1, 2 } );
+    std::memcpy( &rows, store.queryCoresSinceBinary( 0 ).data() + 4, 4 );
+    QCOMPARE( rows, uint32_t( 2 ) );
+    store.setCoreLayout( { 0, 1, 2 }, { 1, 1, 2 } );
+    std::memcpy( &rows, store.queryCoresSinceBinary( 0 ).data() + 4, 4 );
+    QCOMPARE( rows, uint32_t( 0 ) );
+  }
+
+  // ---- metric registry ---------------------------------------------------
+
+  void registry_builtinsKeepTheirIds()
+  {
+    MetricRegistry registry;
+    QCOMPARE( registry.size(), static_cast< size_t >( MetricId::Count ) );
+    QCOMPARE( *registry.find( "gpuPower" ), MetricId::GpuPower );
+    QCOMPARE( registry.key( MetricId::BatteryVoltage ), std::string( "batVoltage" ) );
+    QCOMPARE( registry.info( MetricId::CpuTemp )->unit, std::string( "°C" ) );
+    QCOMPARE( registry.info( MetricId::GpuCoreVoltage )->group, std::string( "volt" ) );
+    QCOMPARE( registry.info( MetricId::GpuComputeUtil )->group, std::string( "duty" ) );
+    QVERIFY( !registry.find( "fan3Duty" ) );
+    QCOMPARE( registry.key( MetricId::Count ), std::string( "unknown" ) );
+  }
+
+  void registry_addIsIdempotentAndBounded()
+  {
+    MetricRegistry registry;
+    const auto id = registry.add( "fan3Duty", "%", "duty" );
+    QCOMPARE( *id, MetricId::Count );
+    QCOMPARE( *registry.add( "fan3Duty", "%", "duty" ), MetricId::Count );
+    QCOMPARE( *registry.add( "cpuTemp", "°C", "temp" ), MetricId::CpuTemp );
+
+    for ( size_t i = registry.size(); i < MetricRegistry::MAX_METRICS; ++i )
+      QVERIFY( registry.add( "extra" + std::to_string( i ), "", "other" ).has_value() );
+    QCOMPARE( registry.size(), MetricRegistry::MAX_METRICS );
+    QVERIFY( !registry.add( "oneTooMany", "", "other" ) );
+  }
+
+  void store_createsSeriesOnFirstSample()
+  {
+    MetricsHistoryStore store( 16 );
+    QCOMPARE( store.presentMask(), uint64_t( 0 ) );
+    QCOMPARE( store.querySinceJSON( 0 ), std::string( "{}" ) );
+    QVERIFY( store.querySinceRollup( 0, 0 ).empty() );
+
+    store.push( MetricId::CpuTemp, 1000, 50.0 );
+    QCOMPARE( store.presentMask(), uint64_t( 1 ) );
+    QVERIFY( !store.latest( MetricId::GpuTemp ) );
+
+    // unregistered ids are dropped
+    store.push( MetricId::Count, 1000, 1.0 );
+    QCOMPARE( store.presentMask(), uint64_t( 1 ) );
+  }
+
+  void store_recordsRuntimeMetrics()
+  {
+    MetricsHistoryStore store( 16 );
+    const auto fan3 = store.registry().add( "fan3Duty", "%", "duty" );
+    QVERIFY( fan3.has_value() );
+    store.push( *fan3, 1000, 35.0 );
+    store.push( *fan3, 2000, 45.0 );
+
+    QCOMPARE( store.latest( *fan3 )->value, 45.0 );
+    QVERIFY( strContains( store.querySinceJSON( 0 ), "\"fan3Duty\":[[1000,35],[2000,45]]" ) );
+    QCOMPARE( store.statsSince( *fan3, 0 ).samples, uint64_t( 2 ) );
+
+    const uint64_t bit = uint64_t( 1 ) << static_cast< size_t >( *fan3 );
+    QCOMPARE( store.presentMask(), bit );
+    uint64_t present = 0;
+    const auto frames = store.querySinceFrames( 0, bit );
+    std::memcpy( &present, frames.data(), sizeof( present ) );
+    QCOMPARE( present, bit );
+  }
+
+  void catalog_listsEveryMetricWithPresence()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::CpuTemp, 1000, 50.0 );
+    store.registry().add( "fan3Temp", "°C", "temp" );
+
+    std::string json;
+    store.catalogJSON( json );
+    QVERIFY( json.starts_with( "[{\"id\":0,\"key\":\"cpuTemp\",\"unit\":\"°C\",\"group\":\"temp\",\"present\":true}," ) );
+    QVERIFY( strContains( json, "{\"id\":1,\"key\":\"cpuFanDuty\",\"unit\":\"%\",\"group\":\"duty\",\"present\":false}" ) );
+    QVERIFY( strContains( json, "\"key\":\"fan3Temp\",\"unit\":\"°C\",\"group\":\"temp\",\"present\":false}]" ) );
+  }
 };
 
 QTEST_GUILESS_MAIN( TestMetricsHistory )
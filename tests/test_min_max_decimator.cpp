@@ -0,0 +1,162 @@
+/*
+ * Unit tests for MinMaxDecimator (per-bucket min/max, incremental commits).
+ */
+
+#include <QTest>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "MinMaxDecimator.hpp"
+
+using ucc::MinMaxDecimator;
+
+namespace
+{
+
+struct Pt
+{
+  double px = 0.0;
+  double py = 0.0;
+  double x() const { return px; }
+  double y() const { return py; }
+};
+
+/// A drawn series fed only through commit() deltas
+struct Mirror
+{
+  std::vector< Pt > pts;
+
+  void apply( const MinMaxDecimator< Pt > &lod, const MinMaxDecimator< Pt >::Delta &delta )
+  {
+    pts.resize( pts.size() - delta.removeBack );
+    pts.erase( pts.begin(), pts.begin() + static_cast< std::ptrdiff_t >( delta.removeFront ) );
+    for ( size_t i = delta.appendFrom; i < lod.points().size(); ++i )
+      pts.push_back( lod.points()[ i ] );
+  }
+
+  bool matches( const MinMaxDecimator< Pt > &lod ) const
+  {
+    if ( pts.size() != lod.points().size() )
+      return false;
+    for ( size_t i = 0; i < pts.size(); ++i )
+      if ( pts[ i ].x() != lod.points()[ i ].x() || pts[ i ].y() != lod.points()[ i ].y() )
+        return false;
+    return true;
+  }
+};
+
+} // namespace
+
+class TestMinMaxDecimator : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void atMostTwoPointsPerBucket()
+  {
+    MinMaxDecimator< Pt > lod;
+    lod.reset( 10.0 );
+    for ( int i = 0; i < 1000; ++i )
+      lod.push( { double( i ), std::sin( i * 0.37 ) } );
+    QVERIFY( lod.points().size() <= 200 );
+    QVERIFY( lod.points().size() >= 100 );
+  }
+
+  void keepsSpikesInTimeOrder()
+  {
+    MinMaxDecimator< Pt > lod;
+    lod.reset( 100.0 );
+    lod.push( { 0.0, 50.0 } );
+    lod.push( { 10.0, 90.0 } );   // spike
+    lod.push( { 20.0, 50.0 } );
+    lod.push( { 30.0, 5.0 } );    // dip
+    lod.push( { 40.0, 50.0 } );
+
+    const auto &pts = lod.points();
+    QCOMPARE( pts.size(), size_t( 2 ) );
+    QCOMPARE( pts[ 0 ].y(), 90.0 );
+    QCOMPARE( pts[ 1 ].y(), 5.0 );
+    QVERIFY( pts[ 0 ].x() < pts[ 1 ].x() );
+  }
+
+  void sparseDataPassesThrough()
+  {
+    MinMaxDecimator< Pt > lod;
+    lod.reset( 1.0 );
+    for ( int i = 0; i < 5; ++i )
+      lod.push( { i * 10.0, double( i ) } );
+    QCOMPARE( lod.points().size(), size_t( 5 ) );
+  }
+
+  void openBucketIsRedrawnFromTheBack()
+  {
+    MinMaxDecimator< Pt > lod;
+    lod.reset( 100.0 );
+    lod.push( { 0.0, 1.0 } );
+    lod.push( { 10.0, 2.0 } );
+    auto delta = lod.commit();
+    QCOMPARE( delta.appendFrom, size_t( 0 ) );
+
+    lod.push( { 20.0, 3.0 } );   // new maximum in the open bucket
+    delta = lod.commit();
+    QCOMPARE( delta.removeBack, size_t( 2 ) );
+    QCOMPARE( delta.removeFront, size_t( 0 ) );
+    QCOMPARE( delta.appendFrom, size_t( 0 ) );
+    QCOMPARE( lod.points().back().y(), 3.0 );
+
+    lod.push( { 30.0, 2.5 } );   // within range: nothing to draw
+    QVERIFY( lod.commit().empty( lod.points().size() ) );
+  }
+
+  void trimDropsWholeBuckets()
+  {
+    MinMaxDecimator< Pt > lod;
+    lod.reset( 10.0 );
+    for ( int i = 0; i < 40; ++i )
+      lod.push( { double( i ), double( i % 7 ) } );
+    ( void ) lod.commit();
+
+    lod.trimBefore( 25.0 );   // buckets [0,10) and [10,20) end before it
+    QVERIFY( lod.points().front().x() >= 20.0 );
+    const auto delta = lod.commit();
+    QCOMPARE( delta.removeFront, size_t( 4 ) );
+
+    lod.trimBefore( 1e9 );
+    QVERIFY( lod.points().empty() );
+  }
+
+  void mirrorStaysInSync()
+  {
+    MinMaxDecimator< Pt > lod;
+    lod.reset( 8.0 );
+    Mirror mirror;
+    double t = 0.0;
+    for ( int tick = 0; tick < 200; ++tick )
+    {
+      for ( int k = 0; k < tick % 5; ++k, t += 1.5 )
+        lod.push( { t, std::sin( t * 0.9 ) * ( tick % 3 ) } );
+      lod.trimBefore( t - 60.0 );
+      mirror.apply( lod, lod.commit() );
+      QVERIFY( mirror.matches( lod ) );
+    }
+  }
+
+  void resetStartsOver()
+  {
+    MinMaxDecimator< Pt > lod;
+    lod.reset( 10.0 );
+    lod.push( { 1.0, 1.0 } );
+    ( void ) lod.commit();
+    lod.reset( 5.0 );
+    QCOMPARE( lod.bucketWidth(), 5.0 );
+    QVERIFY( lod.points().empty() );
+    const auto delta = lod.commit();
+    QCOMPARE( delta.removeFront, size_t( 0 ) );
+    QCOMPARE( delta.removeBack, size_t( 0 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestMinMaxDecimator )
+
+#include "test_min_max_decimator.moc"
@@ -0,0 +1,121 @@
+/*
+ * Unit tests for NvmlProbeCache – probe results reused across instances,
+ * invalidation on driver or VBIOS changes and damaged caches.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <filesystem>
+#include <fstream>
+#include "NvmlProbeCache.hpp"
+
+namespace
+{
+const NvmlGpuIdentity GPU { "GPU-0f8c6a2e-1b3d-4e5f-9a7b-123456789abc", "95.07.3a.00.1f" };
+
+NvmlProbeResult sampleResult()
+{
+  // graphics key = pstate, memory key = 200 + pstate
+  return NvmlProbeResult{ { 0, 2, 5, 8 }, { { 0, true }, { 2, true }, { 5, false }, { 8, false },
+                                            { 200, true }, { 202, false }, { 205, false }, { 208, false } } };
+}
+
+void writeFile( const std::string &path, const std::string &content )
+{
+  std::ofstream( path, std::ios::trunc ) << content;
+}
+}
+
+class TestNvmlProbeCache : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void resultsOutliveTheInstance()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "nvml-probe" ).toStdString();
+
+    {
+      NvmlProbeCache cache( cachePath );
+      QVERIFY( !cache.find( "570.86.16", GPU ) );
+      cache.store( "570.86.16", GPU, sampleResult() );
+    }
+
+    NvmlProbeCache restarted( cachePath );
+    const auto cached = restarted.find( "570.86.16", GPU );
+    QVERIFY( cached.has_value() );
+    QVERIFY( *cached == sampleResult() );
+  }
+
+  void emptyResultsRoundTrip()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "nvml-probe" ).toStdString();
+    NvmlProbeCache( cachePath ).store( "570.86.16", GPU, NvmlProbeResult{} );
+
+    NvmlProbeCache restarted( cachePath );
+    const auto cached = restarted.find( "570.86.16", GPU );
+    QVERIFY( cached.has_value() );
+    QVERIFY( cached->pstates.empty() && cached->writableOffsets.empty() );
+  }
+
+  void driverUpdateDropsEveryGpu()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "nvml-probe" ).toStdString();
+    const NvmlGpuIdentity other { "GPU-11111111-2222-3333-4444-555555555555", "95.07.3a.00.1f" };
+
+    {
+      NvmlProbeCache cache( cachePath );
+      cache.store( "570.86.16", GPU, sampleResult() );
+      cache.store( "570.86.16", other, sampleResult() );
+      cache.store( "575.51.02", GPU, NvmlProbeResult{ { 0, 8 }, {} } );
+    }
+
+    NvmlProbeCache restarted( cachePath );
+    QVERIFY( !restarted.find( "570.86.16", GPU ) );
+    QVERIFY( !restarted.find( "575.51.02", other ) );
+    const auto cached = restarted.find( "575.51.02", GPU );
+    QVERIFY( cached.has_value() );
+    QCOMPARE( cached->pstates.size(), size_t( 2 ) );
+  }
+
+  void vbiosUpdateDropsThatGpu()
+  {
+    QTemporaryDir dir;
+    NvmlProbeCache cache( dir.filePath( "nvml-probe" ).toStdString() );
+    cache.store( "570.86.16", GPU, sampleResult() );
+
+    NvmlGpuIdentity flashed = GPU;
+    flashed.vbios = "95.07.3a.00.2c";
+    QVERIFY( !cache.find( "570.86.16", flashed ) );
+    QVERIFY( cache.find( "570.86.16", GPU ).has_value() );
+  }
+
+  void damagedCacheIsIgnored()
+  {
+    QTemporaryDir dir;
+    const std::string cachePath = dir.filePath( "nvml-probe" ).toStdString();
+    writeFile( cachePath, "ucc-nvml-probe 1\ndriver\t570.86.16\n@\t" + GPU.uuid + '\t' + GPU.vbios
+                            + "\npstates\t0 x\noffsets\t0=1\n" );
+    QVERIFY( !NvmlProbeCache( cachePath ).find( "570.86.16", GPU ) );
+
+    writeFile( cachePath, "ucc-nvml-probe 1\ndriver\t570.86.16\npstates\t0\n" );
+    QVERIFY( !NvmlProbeCache( cachePath ).find( "570.86.16", GPU ) );
+  }
+
+  void unstorableIdentitiesAreNotCached()
+  {
+    QTemporaryDir dir;
+    NvmlProbeCache cache( dir.filePath( "nvml-probe" ).toStdString() );
+    cache.store( "570.86.16", NvmlGpuIdentity{ "", GPU.vbios }, sampleResult() );
+    cache.store( "570.86.16", NvmlGpuIdentity{ "GPU-a\tb", GPU.vbios }, sampleResult() );
+    QVERIFY( !cache.find( "570.86.16", NvmlGpuIdentity{ "", GPU.vbios } ) );
+    QVERIFY( !std::filesystem::exists( dir.filePath( "nvml-probe" ).toStdString() ) );
+  }
+};
+
+QTEST_MAIN( TestNvmlProbeCache )
+#include "test_nvml_probe_cache.moc"
@@ -0,0 +1,119 @@
+/*
+ * Unit tests for OpenMetricsExporter (node_exporter textfile output).
+ */
+
+#include <QTest>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "OpenMetricsExporter.hpp"
+
+namespace
+{
+bool contains( const std::string &haystack, const char *needle )
+{
+  return haystack.find( needle ) != std::string::npos;
+}
+} // namespace
+
+class TestOpenMetricsExporter : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void render_storeMetricsInBaseUnits()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::CpuTemp, 100'000, 45.5 );
+    store.push( MetricId::CpuFrequency, 100'000, 3200.0 );
+    store.push( MetricId::GpuCoreVoltage, 100'000, 850.0 );
+
+    OpenMetricsExporter exporter;
+    const std::string out = exporter.render( store, TelemetrySnapshot{}, 101'000 );
+
+    QVERIFY( contains( out, "# TYPE ucc_cpu_temperature_celsius gauge\n" ) );
+    QVERIFY( contains( out, "# UNIT ucc_cpu_temperature_celsius celsius\n" ) );
+    QVERIFY( contains( out, "\nucc_cpu_temperature_celsius 45.5\n" ) );
+    QVERIFY( contains( out, "\nucc_cpu_frequency_hertz 3200000000\n" ) );
+    QVERIFY( contains( out, "\nucc_gpu_core_voltage_volts 0.85\n" ) );
+    QVERIFY( !contains( out, "ucc_gpu_power_watts" ) );
+    QVERIFY( out.size() >= 6 && out.compare( out.size() - 6, 6, "# EOF\n" ) == 0 );
+  }
+
+  void render_skipsStaleSamples()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::CpuTemp, 1'000, 45.0 );
+
+    TelemetrySnapshot snap;
+    snap.fans.push_back( { 1'000, 40, 1'000, 50 } );
+
+    OpenMetricsExporter exporter;
+    const std::string out = exporter.render( store, snap, 1'000 + OpenMetricsExporter::STALE_MS + 1 );
+    QCOMPARE( out, std::string( "# EOF\n" ) );
+  }
+
+  void render_fansAndGpuExtras()
+  {
+    MetricsHistoryStore store( 16 );
+    store.push( MetricId::GpuComputeUtil, 5'000, 87.0 );  // already covered by the engine family
+    TelemetrySnapshot snap;
+    snap.fans.push_back( { 5'000, 40, 5'000, 61 } );
+    snap.fans.push_back( { 0, -1, 0, -1 } );       // never sampled
+    snap.fans.push_back( { 5'000, 55, 5'000, 70 } );
+    snap.gpu.computeUtilPct = 87;
+    snap.gpu.encoderUtilPct = 3;
+    snap.gpu.vramUsedMiB = 1024;
+    snap.gpu.currentPstate = 2;
+
+    OpenMetricsExporter exporter;
+    const std::string out = exporter.render( store, snap, 6'000 );
+
+    QVERIFY( contains( out, "ucc_fan_duty_percent{fan=\"0\"} 40\n" ) );
+    QVERIFY( contains( out, "ucc_fan_duty_percent{fan=\"2\"} 55\n" ) );
+    QVERIFY( !contains( out, "fan=\"1\"" ) );
+    QVERIFY( contains( out, "ucc_fan_sensor_temperature_celsius{fan=\"2\"} 70\n" ) );
+    QVERIFY( contains( out, "ucc_gpu_utilization_percent{engine=\"compute\"} 87\n" ) );
+    QCOMPARE( out.find( "# TYPE ucc_gpu_utilization_percent" ), out.rfind( "# TYPE ucc_gpu_utilization_percent" ) );
+    QVERIFY( contains( out, "ucc_gpu_utilization_percent{engine=\"encoder\"} 3\n" ) );
+    QVERIFY( !contains( out, "engine=\"memory\"" ) );
+    QVERIFY( contains( out, "ucc_gpu_vram_used_bytes 1073741824\n" ) );
+    QVERIFY( contains( out, "ucc_gpu_pstate 2\n" ) );
+    QVERIFY( !contains( out, "ucc_gpu_vram_total_bytes" ) );
+
+    // One TYPE line per family, even with several samples
+    size_t types = 0;
+    for ( size_t pos = 0; ( pos = out.find( "# TYPE ucc_fan_duty_percent", pos ) ) != std::string::npos; ++pos )
+      ++types;
+    QCOMPARE( types, size_t( 1 ) );
+  }
+
+  void writeTextfile_replacesAtomically()
+  {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ( "ucc-openmetrics-" + std::to_string( getpid() ) + ".prom" );
+
+    QVERIFY( OpenMetricsExporter::writeTextfile( path.string(), "a 1\n# EOF\n" ) );
+    QVERIFY( OpenMetricsExporter::writeTextfile( path.string(), "b 2\n# EOF\n" ) );
+
+    std::ifstream in( path );
+    std::stringstream ss;
+    ss << in.rdbuf();
+    QCOMPARE( ss.str(), std::string( "b 2\n# EOF\n" ) );
+    QVERIFY( !std::filesystem::exists( path.string() + ".tmp" ) );
+
+    std::filesystem::remove( path );
+  }
+
+  void writeTextfile_failsForMissingDirectory()
+  {
+    QVERIFY( !OpenMetricsExporter::writeTextfile( "/proc/ucc-no-such-dir/x.prom", "# EOF\n" ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestOpenMetricsExporter )
+
+#include "test_openmetrics_exporter.moc"
@@ -0,0 +1,69 @@
+/*
+ * Unit tests for PanelRefreshPolicy – the lowest rate while saving, the
+ * profile's rate or the highest otherwise, within the active resolution.
+ */
+
+#include <QTest>
+#include "PanelRefreshPolicy.hpp"
+
+class TestPanelRefreshPolicy : public QObject
+{
+  Q_OBJECT
+
+private:
+  // 2560x1600 at 60/120/165 Hz, running at 165; 1920x1200 at 60 only
+  static DisplayInfo panel()
+  {
+    return DrmDisplayModes::group( "eDP-1",
+                                   { { 2560, 1600, 165.01 }, { 2560, 1600, 120.0 }, { 2560, 1600, 60.0 },
+                                     { 1920, 1200, 60.0 } },
+                                   DrmDisplayModes::Mode{ 2560, 1600, 165.01 } );
+  }
+
+private slots:
+
+  void savingPicksTheLowestRate()
+  {
+    QCOMPARE( *PanelRefreshPolicy::target( panel(), true, 0 ), 60.0 );
+    // the profile's rate does not hold it up
+    QCOMPARE( *PanelRefreshPolicy::target( panel(), true, 165 ), 60.0 );
+  }
+
+  void noProfileRateRestoresTheHighest()
+  {
+    QCOMPARE( *PanelRefreshPolicy::target( panel(), false, 0 ), 165.01 );
+  }
+
+  void profileRatePicksTheClosest()
+  {
+    QCOMPARE( *PanelRefreshPolicy::target( panel(), false, 120 ), 120.0 );
+    QCOMPARE( *PanelRefreshPolicy::target( panel(), false, 165 ), 165.01 );
+    QCOMPARE( *PanelRefreshPolicy::target( panel(), false, 90 ), 120.0 );
+  }
+
+  void staysAtTheActiveResolution()
+  {
+    auto info = DrmDisplayModes::group( "eDP-1", { { 2560, 1600, 165.01 }, { 1920, 1200, 90.0 }, { 1920, 1200, 48.0 } },
+                                        DrmDisplayModes::Mode{ 1920, 1200, 90.0 } );
+    QCOMPARE( *PanelRefreshPolicy::target( info, false, 0 ), 90.0 );
+    QCOMPARE( *PanelRefreshPolicy::target( info, true, 0 ), 48.0 );
+  }
+
+  void unknownActiveModeHasNoTarget()
+  {
+    const auto info = DrmDisplayModes::group( "eDP-1", { { 2560, 1600, 165.01 } }, std::nullopt );
+    QVERIFY( !PanelRefreshPolicy::target( info, true, 0 ) );
+  }
+
+  void activeWithinTolerance()
+  {
+    const auto info = panel();
+    QVERIFY( PanelRefreshPolicy::isActive( info, 165.0 ) );
+    QVERIFY( PanelRefreshPolicy::isActive( info, 165.01 ) );
+    QVERIFY( !PanelRefreshPolicy::isActive( info, 120.0 ) );
+    QVERIFY( !PanelRefreshPolicy::isActive( DisplayInfo(), 60.0 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestPanelRefreshPolicy )
+#include "test_panel_refresh_policy.moc"
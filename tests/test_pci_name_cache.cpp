@@ -0,0 +1,160 @@
+/*
+ * Unit tests for PciNameCache – pci.ids scanning, answers reused across
+ * instances, invalidation when the database changes and damaged caches.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "PciNameCache.hpp"
+
+namespace
+{
+const char *const PCI_IDS =
+  "# pci.ids excerpt\n"
+  "\n"
+  "10de  NVIDIA Corporation\n"
+  "\t2860  AD106M [GeForce RTX 4070 Max-Q / Mobile]\n"
+  "\t\t1d05 1234  Subsystem\n"
+  "\t28a0  AD107M [GeForce RTX 4060 Max-Q / Mobile]  \n"
+  "1002  Advanced Micro Devices, Inc. [AMD/ATI]\n"
+  "\t1900  Phoenix3\n";
+
+void writeFile( const std::string &path, const std::string &content )
+{
+  std::ofstream( path, std::ios::trunc ) << content;
+}
+
+void setMtime( const std::string &path, time_t seconds )
+{
+  const struct timeval times[ 2 ] = { { seconds, 0 }, { seconds, 0 } };
+  ::utimes( path.c_str(), times );
+}
+}
+
+class TestPciNameCache : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void scanFindsDevicesOfTheVendorOnly()
+  {
+    std::istringstream a( PCI_IDS ), b( PCI_IDS ), c( PCI_IDS ), d( PCI_IDS );
+    QCOMPARE( scanPciIds( a, 0x10de, 0x2860 ), std::string( "AD106M [GeForce RTX 4070 Max-Q / Mobile]" ) );
+    QCOMPARE( scanPciIds( b, 0x10de, 0x28a0 ), std::string( "AD107M [GeForce RTX 4060 Max-Q / Mobile]" ) );
+    // 1900 is listed, but under another vendor
+    QCOMPARE( scanPciIds( c, 0x10de, 0x1900 ), std::string() );
+    QCOMPARE( scanPciIds( d, 0x1002, 0x1900 ), std::string( "Phoenix3" ) );
+  }
+
+  void answersOutliveTheInstance()
+  {
+    QTemporaryDir dir;
+    const std::string ids = dir.filePath( "pci.ids" ).toStdString();
+    const std::string cachePath = dir.filePath( "pci-names" ).toStdString();
+    writeFile( ids, PCI_IDS );
+
+    {
+      PciNameCache cache( cachePath );
+      QCOMPARE( cache.lookup( *PciNameCache::identify( ids ), 0x10de, 0x2860 ),
+                std::string( "AD106M [GeForce RTX 4070 Max-Q / Mobile]" ) );
+      QCOMPARE( cache.scans(), uint64_t( 1 ) );
+    }
+
+    PciNameCache restarted( cachePath );
+    QCOMPARE( restarted.lookup( *PciNameCache::identify( ids ), 0x10de, 0x2860 ),
+              std::string( "AD106M [GeForce RTX 4070 Max-Q / Mobile]" ) );
+    QCOMPARE( restarted.scans(), uint64_t( 0 ) );
+    QCOMPARE( restarted.hits(), uint64_t( 1 ) );
+  }
+
+  void missesAreCachedToo()
+  {
+    QTemporaryDir dir;
+    const std::string ids = dir.filePath( "pci.ids" ).toStdString();
+    writeFile( ids, PCI_IDS );
+
+    PciNameCache cache( dir.filePath( "pci-names" ).toStdString() );
+    const auto source = *PciNameCache::identify( ids );
+    QCOMPARE( cache.lookup( source, 0x8086, 0x7d55 ), std::string() );
+    QCOMPARE( cache.lookup( source, 0x8086, 0x7d55 ), std::string() );
+    QCOMPARE( cache.scans(), uint64_t( 1 ) );
+    QCOMPARE( cache.hits(), uint64_t( 1 ) );
+  }
+
+  void changedDatabaseIsRescanned()
+  {
+    QTemporaryDir dir;
+    const std::string ids = dir.filePath( "pci.ids" ).toStdString();
+    const std::string cachePath = dir.filePath( "pci-names" ).toStdString();
+    writeFile( ids, PCI_IDS );
+    setMtime( ids, 1'700'000'000 );
+
+    {
+      PciNameCache cache( cachePath );
+      QCOMPARE( cache.lookup( *PciNameCache::identify( ids ), 0x1002, 0x1900 ), std::string( "Phoenix3" ) );
+    }
+
+    // a distribution update renames the device
+    std::string updated = PCI_IDS;
+    updated.replace( updated.find( "Phoenix3" ), 8, "Phoenix 3" );
+    writeFile( ids, updated );
+    setMtime( ids, 1'700'000'600 );
+
+    PciNameCache restarted( cachePath );
+    QCOMPARE( restarted.lookup( *PciNameCache::identify( ids ), 0x1002, 0x1900 ), std::string( "Phoenix 3" ) );
+    QCOMPARE( restarted.scans(), uint64_t( 1 ) );
+  }
+
+  void databasesAreCachedSeparately()
+  {
+    QTemporaryDir dir;
+    const std::string hwdata = dir.filePath( "hwdata.ids" ).toStdString();
+    const std::string misc = dir.filePath( "misc.ids" ).toStdString();
+    const std::string cachePath = dir.filePath( "pci-names" ).toStdString();
+    writeFile( hwdata, "10de  NVIDIA Corporation\n" );
+    writeFile( misc, PCI_IDS );
+
+    {
+      PciNameCache cache( cachePath );
+      QCOMPARE( cache.lookup( *PciNameCache::identify( hwdata ), 0x10de, 0x2860 ), std::string() );
+      QCOMPARE( cache.lookup( *PciNameCache::identify( misc ), 0x10de, 0x2860 ),
+                std::string( "AD106M [GeForce RTX 4070 Max-Q / Mobile]" ) );
+    }
+
+    // falling through to the second database must not evict the first
+    PciNameCache restarted( cachePath );
+    QCOMPARE( restarted.lookup( *PciNameCache::identify( hwdata ), 0x10de, 0x2860 ), std::string() );
+    QCOMPARE( restarted.lookup( *PciNameCache::identify( misc ), 0x10de, 0x2860 ),
+              std::string( "AD106M [GeForce RTX 4070 Max-Q / Mobile]" ) );
+    QCOMPARE( restarted.scans(), uint64_t( 0 ) );
+  }
+
+  void damagedCacheIsIgnored()
+  {
+    QTemporaryDir dir;
+    const std::string ids = dir.filePath( "pci.ids" ).toStdString();
+    const std::string cachePath = dir.filePath( "pci-names" ).toStdString();
+    writeFile( ids, PCI_IDS );
+    writeFile( cachePath, "ucc-pci-names 1\n@\t" + ids + "\tbogus\n10de2860\tWrong\n" );
+
+    PciNameCache cache( cachePath );
+    QCOMPARE( cache.lookup( *PciNameCache::identify( ids ), 0x10de, 0x2860 ),
+              std::string( "AD106M [GeForce RTX 4070 Max-Q / Mobile]" ) );
+    QCOMPARE( cache.scans(), uint64_t( 1 ) );
+  }
+
+  void identifyRejectsMissingFiles()
+  {
+    QTemporaryDir dir;
+    QVERIFY( !PciNameCache::identify( dir.filePath( "absent" ).toStdString() ) );
+    QVERIFY( !PciNameCache::identify( dir.path().toStdString() ) );
+  }
+};
+
+QTEST_MAIN( TestPciNameCache )
+#include "test_pci_name_cache.moc"
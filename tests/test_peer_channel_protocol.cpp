@@ -0,0 +1,104 @@
+/*
+ * Unit tests for the peer channel wire protocol – framing, request/reply
+ * round trips and the served method list.
+ */
+
+#include <QTest>
+#include "PeerChannelProtocol.hpp"
+
+using namespace ucc;
+
+class TestPeerChannelProtocol : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void requestRoundTrip()
+  {
+    QByteArray buffer = peer::encodeRequest( peer::Request{ 7, QStringLiteral( "GetMonitorDataSince" ),
+                                                            { QVariant::fromValue( qlonglong( 1234 ) ) } } );
+    bool corrupt = true;
+    const auto payload = peer::takeFrame( buffer, corrupt );
+    QVERIFY( payload.has_value() );
+    QVERIFY( !corrupt );
+    QVERIFY( buffer.isEmpty() );
+
+    const auto request = peer::decodeRequest( *payload );
+    QVERIFY( request.has_value() );
+    QCOMPARE( request->serial, quint32( 7 ) );
+    QCOMPARE( request->method, QStringLiteral( "GetMonitorDataSince" ) );
+    QCOMPARE( request->args.size(), 1 );
+    QCOMPARE( request->args.front().toLongLong(), qlonglong( 1234 ) );
+  }
+
+  void replyRoundTrip()
+  {
+    QVariantMap snapshot{ { QStringLiteral( "cpuTemp" ), 55 } };
+    QByteArray buffer = peer::encodeReply( peer::Reply{ 3, true, QVariant( snapshot ), QString() } );
+    bool corrupt = false;
+    const auto reply = peer::decodeReply( peer::takeFrame( buffer, corrupt ).value() );
+    QVERIFY( reply.has_value() );
+    QCOMPARE( reply->serial, quint32( 3 ) );
+    QVERIFY( reply->ok );
+    QCOMPARE( reply->value.toMap().value( QStringLiteral( "cpuTemp" ) ).toInt(), 55 );
+  }
+
+  void partialFramesWait()
+  {
+    const QByteArray frame = peer::encodeReply( peer::Reply{ 1, true, QVariant( QByteArray( 1000, 'x' ) ), {} } );
+    QByteArray buffer = frame.left( 3 );
+    bool corrupt = false;
+    QVERIFY( !peer::takeFrame( buffer, corrupt ) );
+    buffer = frame.left( frame.size() - 1 );
+    QVERIFY( !peer::takeFrame( buffer, corrupt ) );
+    QVERIFY( !corrupt );
+
+    // two frames back to back come out one at a time
+    buffer = frame + frame;
+    QVERIFY( peer::takeFrame( buffer, corrupt ) );
+    QCOMPARE( buffer, frame );
+    QVERIFY( peer::takeFrame( buffer, corrupt ) );
+    QVERIFY( buffer.isEmpty() );
+  }
+
+  void oversizedFrameIsCorrupt()
+  {
+    QByteArray buffer( "\xff\xff\xff\xff", 4 );
+    bool corrupt = false;
+    QVERIFY( !peer::takeFrame( buffer, corrupt ) );
+    QVERIFY( corrupt );
+  }
+
+  void helloFitsThePreAuthLimit()
+  {
+    QByteArray buffer = peer::encodeRequest(
+      peer::Request{ 1, QString::fromLatin1( peer::HELLO ), { QVariant( QByteArray( 32, 't' ) ) } } );
+    bool corrupt = false;
+    QVERIFY( peer::takeFrame( buffer, corrupt, peer::MAX_HELLO_BYTES ) );
+
+    // anything bigger is refused before the token was checked
+    buffer = peer::encodeRequest(
+      peer::Request{ 2, QStringLiteral( "SetKeyboardBacklightFrame" ), { QVariant( QByteArray( 1000, 'x' ) ) } } );
+    QVERIFY( !peer::takeFrame( buffer, corrupt, peer::MAX_HELLO_BYTES ) );
+    QVERIFY( corrupt );
+  }
+
+  void truncatedPayloadFailsToDecode()
+  {
+    QVERIFY( !peer::decodeRequest( QByteArray( "\x00\x00", 2 ) ) );
+  }
+
+  void servedMethods()
+  {
+    QVERIFY( peer::peerServes( QStringLiteral( "GetMonitorDataSinceCompressed" ) ) );
+    QVERIFY( peer::peerServes( QStringLiteral( "ApplyFanProfiles" ) ) );
+    QVERIFY( peer::peerServes( QStringLiteral( "SetKeyboardBacklightFrame" ) ) );
+    QVERIFY( !peer::peerServes( QStringLiteral( "SetChargeType" ) ) );
+    QVERIFY( !peer::peerServes( QLatin1String( peer::HELLO ) ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestPeerChannelProtocol )
+
+#include "test_peer_channel_protocol.moc"
@@ -0,0 +1,114 @@
+/*
+ * Unit tests for PersistQueue – coalescing of changes into one write,
+ * the maximum delay, retries – and writeFileDurably().
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include "PersistQueue.hpp"
+
+using namespace std::chrono_literals;
+
+class TestPersistQueue : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void coalescesBurst()
+  {
+    int writes = 0;
+    PersistQueue queue( [&] { ++writes; return true; }, 1000ms, 10000ms );
+    const auto t0 = PersistQueue::Clock::time_point{} + 1h;
+
+    QVERIFY( !queue.deadline() );
+    for ( int i = 0; i < 20; ++i )
+      queue.markDirty( t0 + i * 100ms );
+
+    QVERIFY( queue.dirty() );
+    QVERIFY( *queue.deadline() == t0 + 1900ms + 1000ms );
+    QVERIFY( queue.flushIfDue( t0 + 2500ms ) );
+    QCOMPARE( writes, 0 );
+    QVERIFY( queue.flushIfDue( t0 + 2900ms ) );
+    QCOMPARE( writes, 1 );
+    QVERIFY( !queue.dirty() );
+    QCOMPARE( queue.coalesced(), uint64_t( 19 ) );
+  }
+
+  void maxDelayBoundsTheWait()
+  {
+    int writes = 0;
+    PersistQueue queue( [&] { ++writes; return true; }, 1000ms, 5000ms );
+    const auto t0 = PersistQueue::Clock::time_point{} + 1h;
+
+    // a change every half second never leaves a quiet second
+    for ( int i = 0; i <= 12; ++i )
+      queue.markDirty( t0 + i * 500ms );
+    QVERIFY( *queue.deadline() == t0 + 5000ms );
+    QVERIFY( queue.flushIfDue( t0 + 6000ms ) );
+    QCOMPARE( writes, 1 );
+  }
+
+  void failedWriteStaysPending()
+  {
+    bool succeed = false;
+    PersistQueue queue( [&] { return succeed; }, 1000ms, 10000ms );
+    const auto t0 = PersistQueue::Clock::time_point{} + 1h;
+
+    queue.markDirty( t0 );
+    QVERIFY( !queue.flushIfDue( t0 + 1000ms ) );
+    QVERIFY( queue.dirty() );
+    QCOMPARE( queue.failures(), uint64_t( 1 ) );
+    QVERIFY( *queue.deadline() == t0 + 2000ms );
+
+    succeed = true;
+    QVERIFY( queue.flush() );
+    QVERIFY( !queue.dirty() );
+    QVERIFY( queue.flush() );  // nothing pending
+    QCOMPARE( queue.writes(), uint64_t( 1 ) );
+  }
+
+  void zeroQuietPeriodWritesAtOnce()
+  {
+    int writes = 0;
+    PersistQueue queue( [&] { ++writes; return true; }, 1000ms, 10000ms );
+    queue.setQuietPeriod( 0ms );
+    const auto t0 = PersistQueue::Clock::time_point{} + 1h;
+    queue.markDirty( t0 );
+    QVERIFY( queue.flushIfDue( t0 ) );
+    QCOMPARE( writes, 1 );
+  }
+
+  void writeFileDurablyReplaces()
+  {
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const std::string path = dir.filePath( "settings" ).toStdString();
+
+    QVERIFY( writeFileDurably( path, "first", 0640 ) );
+    QVERIFY( writeFileDurably( path, "second", 0640 ) );
+
+    std::ifstream in( path );
+    std::stringstream content;
+    content << in.rdbuf();
+    QCOMPARE( content.str(), std::string( "second" ) );
+
+    struct stat st{};
+    QCOMPARE( ::stat( path.c_str(), &st ), 0 );
+    QCOMPARE( st.st_mode & 0777u, 0640u );
+    QVERIFY( !std::filesystem::exists( path + ".tmp" ) );
+  }
+
+  void writeFileDurablyReportsErrors()
+  {
+    std::string error;
+    QVERIFY( !writeFileDurably( "/nonexistent-dir/settings", "x", 0644, &error ) );
+    QVERIFY( error.find( "cannot open" ) != std::string::npos );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestPersistQueue )
+#include "test_persist_queue.moc"
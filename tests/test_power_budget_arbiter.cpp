@@ -0,0 +1,118 @@
+/*
+ * Unit tests for PowerBudgetArbiter – which side is the bottleneck, the
+ * shift towards it within its limits, holding while both are loaded and
+ * relaxing back once both idle.
+ */
+
+#include <QTest>
+#include "PowerBudgetArbiter.hpp"
+
+namespace
+{
+/// CPU at 45 W of a 45 W limit, GPU at 60 of 100 W and 40 % busy
+PowerBudgetSample cpuBound()
+{
+  PowerBudgetSample s;
+  s.cpuWatts = 44.0;
+  s.cpuLimitedPct = 80.0;
+  s.cpuLimitWatts = 45.0;
+  s.gpuWatts = 60.0;
+  s.gpuUtilPct = 40.0;
+  s.gpuLimitWatts = 100.0;
+  return s;
+}
+
+/// A game: GPU pinned at its limit, CPU well below
+PowerBudgetSample gpuBound()
+{
+  PowerBudgetSample s;
+  s.cpuWatts = 20.0;
+  s.cpuLimitedPct = 0.0;
+  s.cpuLimitWatts = 45.0;
+  s.gpuWatts = 98.0;
+  s.gpuUtilPct = 99.0;
+  s.gpuLimitWatts = 100.0;
+  return s;
+}
+}
+
+class TestPowerBudgetArbiter : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void classifiesTheBottleneck()
+  {
+    QVERIFY( PowerBudgetArbiter::classify( cpuBound() ) == PowerBottleneck::Cpu );
+    QVERIFY( PowerBudgetArbiter::classify( gpuBound() ) == PowerBottleneck::Gpu );
+
+    PowerBudgetSample both = gpuBound();
+    both.cpuWatts = 44.0;
+    QVERIFY( PowerBudgetArbiter::classify( both ) == PowerBottleneck::None );
+
+    PowerBudgetSample idle = cpuBound();
+    idle.cpuWatts = 5.0;
+    idle.cpuLimitedPct = 0.0;
+    idle.gpuWatts = 10.0;
+    idle.gpuUtilPct = 0.0;
+    QVERIFY( PowerBudgetArbiter::classify( idle ) == PowerBottleneck::Idle );
+
+    // no GPU reading: nothing to arbitrate
+    PowerBudgetSample noGpu = cpuBound();
+    noGpu.gpuWatts = -1.0;
+    QVERIFY( PowerBudgetArbiter::classify( noGpu ) == PowerBottleneck::None );
+
+    // a GPU at its power limit but mostly waiting is not the bottleneck
+    PowerBudgetSample stalled = gpuBound();
+    stalled.gpuUtilPct = 60.0;
+    QVERIFY( PowerBudgetArbiter::classify( stalled ) == PowerBottleneck::None );
+  }
+
+  void shiftsInStepsWithinTheLimits()
+  {
+    PowerBudgetArbiter a;
+    QCOMPARE( a.update( gpuBound(), -15, 20, 1.0 ), 0 );
+    QCOMPARE( a.update( gpuBound(), -15, 20, 1.0 ), 0 );
+    QCOMPARE( a.update( gpuBound(), -15, 20, 1.0 ), 5 );
+    for ( int i = 0; i < 30; ++i )
+      a.update( gpuBound(), -15, 20, 1.0 );
+    QCOMPARE( a.shift(), 20 );
+
+    for ( int i = 0; i < 30; ++i )
+      a.update( cpuBound(), -15, 20, 1.0 );
+    QCOMPARE( a.shift(), -15 );
+
+    // limits that shrink take effect at once
+    QCOMPARE( a.update( cpuBound(), -10, 20, 1.0 ), -10 );
+  }
+
+  void holdsWhileLoadedAndRelaxesWhenIdle()
+  {
+    PowerBudgetArbiter a;
+    for ( int i = 0; i < 10; ++i )
+      a.update( gpuBound(), -15, 20, 1.0 );
+    QCOMPARE( a.shift(), 20 );
+
+    // the GPU now runs below its raised limit, but is still loaded: hold
+    PowerBudgetSample both = gpuBound();
+    both.cpuWatts = 30.0;
+    both.gpuWatts = 85.0;
+    for ( int i = 0; i < 60; ++i )
+      a.update( both, -15, 20, 1.0 );
+    QCOMPARE( a.shift(), 20 );
+
+    PowerBudgetSample idle = both;
+    idle.cpuWatts = 5.0;
+    idle.gpuWatts = 10.0;
+    idle.gpuUtilPct = 2.0;
+    a.update( idle, -15, 20, 10.0 );
+    QCOMPARE( a.shift(), 15 );
+    for ( int i = 0; i < 10; ++i )
+      a.update( idle, -15, 20, 10.0 );
+    QCOMPARE( a.shift(), 0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestPowerBudgetArbiter )
+#include "test_power_budget_arbiter.moc"
@@ -0,0 +1,152 @@
+/*
+ * Unit tests for PowerLimitController – bounds from the profile and the
+ * hardware, the bumpless start, slew limits in both directions, the
+ * deadband and the fan-duty limit on rising.
+ */
+
+#include <QTest>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "PowerLimitController.hpp"
+
+namespace
+{
+PowerLimitControllerSettings dynamicSettings()
+{
+  PowerLimitControllerSettings s;
+  s.mode = PowerLimitMode::Dynamic;
+  s.targetTemp = 90;
+  s.fanDutyLimit = 95;
+  s.floorPercent = 50;
+  s.riseWattsPerSecond = 0.5;
+  s.fallWattsPerSecond = 3.0;
+  return s;
+}
+
+bool near( double a, double b )
+{
+  return std::abs( a - b ) < 1e-9;
+}
+
+/// PL1 and PL2 ceilings of 40 and 80 W: 20 W of room on PL1, 40 W on PL2
+const std::vector< PowerLimitBounds > BOUNDS{ { 20, 40 }, { 40, 80 } };
+}
+
+class TestPowerLimitController : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void boundsFollowProfileAndHardware()
+  {
+    const auto s = dynamicSettings();
+    const auto bounds = PowerLimitController::boundsFor( s, { 40, 200, 10 }, { { 5, 60 }, { 5, 90 }, { 15, 30 } } );
+    QCOMPARE( static_cast< int >( bounds.size() ), 3 );
+    QVERIFY( bounds[ 0 ] == ( PowerLimitBounds{ 20, 40 } ) );
+    // above the hardware maximum
+    QVERIFY( bounds[ 1 ] == ( PowerLimitBounds{ 45, 90 } ) );
+    // below the hardware minimum: pinned
+    QVERIFY( bounds[ 2 ] == ( PowerLimitBounds{ 15, 15 } ) );
+
+    // indices the hardware does not have are dropped
+    QCOMPARE( static_cast< int >( PowerLimitController::boundsFor( s, { 40, 80 }, { { 5, 60 } } ).size() ), 1 );
+  }
+
+  void startsAtTheProfileValues()
+  {
+    PowerLimitController c;
+    const auto values = c.update( dynamicSettings(), BOUNDS, 99.0, 100.0, 1.0 );
+    QVERIFY( values == ( std::vector< int32_t >{ 40, 80 } ) );
+    QCOMPARE( c.level(), 1.0 );
+  }
+
+  void fallIsSlewLimited()
+  {
+    PowerLimitController c;
+    const auto s = dynamicSettings();
+    c.update( s, BOUNDS, 95.0, 100.0, 1.0 );
+
+    // 20 °C over target asks for 9.5 W/s; the slew limit allows 3 W/s on the widest index
+    auto values = c.update( s, BOUNDS, 110.0, 100.0, 1.0 );
+    QVERIFY( values == ( std::vector< int32_t >{ 39, 77 } ) );
+
+    for ( int i = 0; i < 20; ++i )
+      values = c.update( s, BOUNDS, 110.0, 100.0, 1.0 );
+    QVERIFY( values == ( std::vector< int32_t >{ 20, 40 } ) );
+    QCOMPARE( c.level(), 0.0 );
+  }
+
+  void holdsInsideTheDeadband()
+  {
+    PowerLimitController c;
+    const auto s = dynamicSettings();
+    c.update( s, BOUNDS, 90.0, 50.0, 1.0 );
+    for ( int i = 0; i < 10; ++i )
+      c.update( s, BOUNDS, 93.0, 50.0, 1.0 );
+    const double level = c.level();
+    QVERIFY( level < 1.0 );
+
+    for ( int i = 0; i < 100; ++i )
+      c.update( s, BOUNDS, i % 2 ? 89.2 : 90.8, 50.0, 1.0 );
+    QCOMPARE( c.level(), level );
+  }
+
+  void riseIsSlewLimitedAndNeedsFanRoom()
+  {
+    PowerLimitController c;
+    const auto s = dynamicSettings();
+    c.update( s, BOUNDS, 60.0, 50.0, 1.0 );
+    for ( int i = 0; i < 20; ++i )
+      c.update( s, BOUNDS, 120.0, 100.0, 1.0 );
+    QCOMPARE( c.level(), 0.0 );
+
+    // close to the target with the fan at its limit: no more power
+    c.update( s, BOUNDS, 86.0, 96.0, 1.0 );
+    QCOMPARE( c.level(), 0.0 );
+
+    // half the fan margin left: half the rise rate
+    c.update( s, BOUNDS, 86.0, 90.0, 1.0 );
+    QVERIFY( near( c.level(), 0.25 / 40.0 ) );
+
+    // fan has room: 0.5 W/s however cool it is
+    c.update( s, BOUNDS, 40.0, 30.0, 2.0 );
+    QVERIFY( near( c.level(), 1.25 / 40.0 ) );
+
+    // far below the target the fan duty does not matter, nor does an unknown one
+    c.update( s, BOUNDS, 60.0, 100.0, 1.0 );
+    QVERIFY( near( c.level(), 1.75 / 40.0 ) );
+    c.update( s, BOUNDS, 86.0, -1.0, 1.0 );
+    QVERIFY( near( c.level(), 2.25 / 40.0 ) );
+  }
+
+  void settlesAtWhatTheChassisCools()
+  {
+    // heat above ambient grows with package power; the fan saturates early
+    const auto s = dynamicSettings();
+    PowerLimitController c;
+    double temp = 45.0;
+    std::vector< int32_t > values = c.update( s, BOUNDS, temp, 50.0, 1.0 );
+    int32_t minPl1 = values[ 0 ];
+    int32_t maxPl1 = 0;
+    for ( int second = 0; second < 600; ++second )
+    {
+      const double steady = 45.0 + 1.5 * values[ 0 ];
+      temp += 0.2 * ( steady - temp );
+      values = c.update( s, BOUNDS, temp, 100.0, 1.0 );
+      if ( second >= 300 )
+      {
+        minPl1 = std::min( minPl1, values[ 0 ] );
+        maxPl1 = std::max( maxPl1, values[ 0 ] );
+      }
+    }
+    // rests between the fan guard and the deadband (85..91 °C: 26.7..30.7 W) without swinging
+    QVERIFY( maxPl1 - minPl1 <= 1 );
+    QVERIFY( values[ 0 ] >= 26 && values[ 0 ] <= 31 );
+    QVERIFY( temp > 84.0 && temp < 92.0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestPowerLimitController )
+#include "test_power_limit_controller.moc"
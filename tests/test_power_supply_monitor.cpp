@@ -0,0 +1,98 @@
+/*
+ * Unit tests for PowerSupplyMonitor – the AC/BAT state followed through
+ * power_supply uevents, and the mains lookup it shares with
+ * PowerSupplyController.
+ */
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <filesystem>
+#include <fstream>
+#include "PowerSupplyMonitor.hpp"
+
+namespace
+{
+void addSupply( const QTemporaryDir &dir, const char *name, const char *type, const char *online )
+{
+  const std::filesystem::path path = dir.filePath( name ).toStdString();
+  std::filesystem::create_directories( path );
+  std::ofstream( path / "type" ) << type << "\n";
+  if ( online != nullptr )
+    std::ofstream( path / "online" ) << online << "\n";
+}
+}
+
+class TestPowerSupplyMonitor : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void firstMainsWithAnOnlineNode()
+  {
+    QTemporaryDir dir;
+    addSupply( dir, "BAT0", "Battery", nullptr );
+    addSupply( dir, "ucsi-source-psy", "USB", "0" );
+    addSupply( dir, "AC", "Mains", "0" );
+    const std::string root = dir.path().toStdString();
+
+    const auto mains = PowerSupplyController::getFirstMains( root );
+    QVERIFY( mains.has_value() );
+    QCOMPARE( mains->getName(), std::string( "AC" ) );
+    QVERIFY( not mains->isOnline() );
+    QCOMPARE( PowerSupplyController::getPowerSupplies( PowerSupplyType::Battery, root ).size(), size_t( 1 ) );
+
+    PowerSupplyMonitor monitor;
+    (void) monitor.start( root );
+    QCOMPARE( monitor.state(), ProfileState::BAT );
+  }
+
+  void noMainsMeansAC()
+  {
+    QTemporaryDir dir;
+    addSupply( dir, "BAT0", "Battery", nullptr );
+    QVERIFY( not PowerSupplyController::getFirstMains( dir.path().toStdString() ) );
+
+    PowerSupplyMonitor monitor;
+    (void) monitor.start( dir.path().toStdString() );
+    QCOMPARE( monitor.state(), ProfileState::AC );
+  }
+
+  void mainsEventsSwitchTheState()
+  {
+    QTemporaryDir dir;
+    addSupply( dir, "ADP1", "Mains", "1" );
+    PowerSupplyMonitor monitor;
+    (void) monitor.start( dir.path().toStdString() );
+
+    QCOMPARE( monitor.apply( "change", "ADP1", "Mains", "0" ), std::optional( ProfileState::BAT ) );
+    QCOMPARE( monitor.apply( "change", "ADP1", "Mains", "1" ), std::optional( ProfileState::AC ) );
+    // older kernels leave POWER_SUPPLY_TYPE out; the name still matches
+    QCOMPARE( monitor.apply( "change", "ADP1", "", "0" ), std::optional( ProfileState::BAT ) );
+  }
+
+  void otherSuppliesAreIgnored()
+  {
+    PowerSupplyMonitor monitor;
+    QVERIFY( not monitor.apply( "change", "BAT0", "Battery", "" ) );
+    QVERIFY( not monitor.apply( "change", "ucsi-source-psy-1", "USB", "1" ) );
+
+    // the first adapter that reports becomes the tracked one
+    QCOMPARE( monitor.apply( "add", "AC", "Mains", "1" ), std::optional( ProfileState::AC ) );
+    QVERIFY( not monitor.apply( "change", "AC2", "Mains", "0" ) );
+    QVERIFY( not monitor.apply( "change", "AC", "Mains", "" ) );
+  }
+
+  void removedAdapterFallsBackToAC()
+  {
+    PowerSupplyMonitor monitor;
+    QCOMPARE( monitor.apply( "change", "AC", "Mains", "0" ), std::optional( ProfileState::BAT ) );
+    QVERIFY( not monitor.apply( "remove", "AC2", "Mains", "" ) );
+    QCOMPARE( monitor.apply( "remove", "AC", "", "" ), std::optional( ProfileState::AC ) );
+    QCOMPARE( monitor.apply( "add", "AC2", "Mains", "0" ), std::optional( ProfileState::BAT ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestPowerSupplyMonitor )
+
+#include "test_power_supply_monitor.moc"
@@ -1,6 +1,6 @@
 /*
  * Unit tests for ProfileManager – parseProfileJSON() / profileToJSON()
- * round-trip, and the low-level extract helpers.
+ * round-trip, parseProfilesJSON() and the fan table parser.
  */
 
 #include <QTest>
@@ -175,6 +175,153 @@ private slots:
     }
   }
 
+  void parseProfile_fanControllerDefaultsToCurve()
+  {
+    auto p = ProfileManager::parseProfileJSON( minimalJSON() );
+    QVERIFY( p.fan.controller == FanControllerSettings() );
+    QVERIFY( ProfileManager::profileToJSON( p ).find( "\"controller\"" ) == std::string::npos );
+  }
+
+  void parseProfile_fanControllerPid()
+  {
+    std::string json = minimalJSON();
+    const std::string anchor = R"("enableWaterCooler": false,)";
+    json.insert( json.find( anchor ) + anchor.size(),
+                 R"( "controller": { "mode": "pid", "targetTemp": 70, "kp": 2.5, "feedForwardPerWatt": 0.75, "preRampDegPerWatt": 0.4 },)" );
+
+    auto p = ProfileManager::parseProfileJSON( json );
+    QVERIFY( p.fan.controller.mode == FanControlMode::Pid );
+    QCOMPARE( p.fan.controller.targetTemp, 70 );
+    QCOMPARE( p.fan.controller.kp, 2.5 );
+    QCOMPARE( p.fan.controller.feedForwardPerWatt, 0.75 );
+    QCOMPARE( p.fan.controller.ki, FanControllerSettings().ki );
+    QCOMPARE( p.fan.controller.preRampDegPerWatt, 0.4 );
+    QCOMPARE( p.fan.controller.preRampMaxDeg, FanControllerSettings().preRampMaxDeg );
+    QCOMPARE( static_cast< int >( p.fan.tableCPU.size() ), 2 );
+
+    auto reparsed = ProfileManager::parseProfileJSON( ProfileManager::profileToJSON( p ) );
+    QVERIFY( reparsed.fan.controller == p.fan.controller );
+  }
+
+  void parseProfile_powerLimitControllerDynamic()
+  {
+    auto p = ProfileManager::parseProfileJSON( minimalJSON() );
+    QVERIFY( p.odmPowerLimits.controller == PowerLimitControllerSettings() );
+    QVERIFY( ProfileManager::profileToJSON( p ).find( "\"controller\"" ) == std::string::npos );
+
+    std::string json = minimalJSON();
+    const std::string anchor = R"("tdpValues": [45, 80])";
+    json.insert( json.find( anchor ) + anchor.size(),
+                 R"(, "controller": { "mode": "dynamic", "targetTemp": 85, "floorPercent": 5, "fallWattsPerSecond": 2.5, "gpuShareWatts": 20 })" );
+
+    p = ProfileManager::parseProfileJSON( json );
+    QVERIFY( p.odmPowerLimits.controller.mode == PowerLimitMode::Dynamic );
+    QCOMPARE( p.odmPowerLimits.controller.targetTemp, 85 );
+    QCOMPARE( p.odmPowerLimits.controller.floorPercent, 10 );  // clamped
+    QCOMPARE( p.odmPowerLimits.controller.fallWattsPerSecond, 2.5 );
+    QCOMPARE( p.odmPowerLimits.controller.fanDutyLimit, PowerLimitControllerSettings().fanDutyLimit );
+    QCOMPARE( p.odmPowerLimits.controller.gpuShareWatts, 20 );
+    QCOMPARE( static_cast< int >( p.odmPowerLimits.tdpValues.size() ), 2 );
+
+    auto reparsed = ProfileManager::parseProfileJSON( ProfileManager::profileToJSON( p ) );
+    QVERIFY( reparsed.odmPowerLimits.controller == p.odmPowerLimits.controller );
+    QVERIFY( reparsed.odmPowerLimits.tdpValues == p.odmPowerLimits.tdpValues );
+  }
+
+  void parseProfile_coreClassLimits()
+  {
+    auto p = ProfileManager::parseProfileJSON( minimalJSON() );
+    QVERIFY( p.cpu.efficiencyCores == UccProfileCpuClass() );
+    QVERIFY( ProfileManager::profileToJSON( p ).find( "\"efficiencyCores\"" ) == std::string::npos );
+
+    std::string json = minimalJSON();
+    const std::string anchor = R"("noTurbo": false)";
+    json.insert( json.find( anchor ) + anchor.size(),
+                 R"(, "efficiencyCores": { "onlineCores": 0 },
+                    "performanceCores": { "scalingMaxFrequency": 3000000, "energyPerformancePreference": "power" })" );
+
+    p = ProfileManager::parseProfileJSON( json );
+    QCOMPARE( p.cpu.efficiencyCores.onlineCores, std::optional< int32_t >( 0 ) );
+    QVERIFY( !p.cpu.efficiencyCores.scalingMaxFrequency );
+    QCOMPARE( p.cpu.performanceCores.scalingMaxFrequency, std::optional< int32_t >( 3000000 ) );
+    QCOMPARE( p.cpu.performanceCores.energyPerformancePreference, std::string( "power" ) );
+
+    auto reparsed = ProfileManager::parseProfileJSON( ProfileManager::profileToJSON( p ) );
+    QVERIFY( reparsed.cpu.performanceCores == p.cpu.performanceCores );
+    QVERIFY( reparsed.cpu.efficiencyCores == p.cpu.efficiencyCores );
+  }
+
+  void parseProfile_coreParking()
+  {
+    auto p = ProfileManager::parseProfileJSON( minimalJSON() );
+    QVERIFY( p.cpu.coreParking.empty() );
+    QVERIFY( ProfileManager::profileToJSON( p ).find( "\"coreParking\"" ) == std::string::npos );
+
+    std::string json = minimalJSON();
+    const std::string anchor = R"("noTurbo": false)";
+    json.insert( json.find( anchor ) + anchor.size(), R"(, "coreParking": "efficiency")" );
+    p = ProfileManager::parseProfileJSON( json );
+    QCOMPARE( p.cpu.coreParking, std::string( "efficiency" ) );
+    QCOMPARE( ProfileManager::parseProfileJSON( ProfileManager::profileToJSON( p ) ).cpu.coreParking,
+              std::string( "efficiency" ) );
+
+    // unknown policies leave parking off
+    json = minimalJSON();
+    json.insert( json.find( anchor ) + anchor.size(), R"(, "coreParking": "always")" );
+    QVERIFY( ProfileManager::parseProfileJSON( json ).cpu.coreParking.empty() );
+  }
+
+  void parseProfile_adaptiveEpp()
+  {
+    auto p = ProfileManager::parseProfileJSON( minimalJSON() );
+    QVERIFY( p.cpu.adaptiveEpp.empty() );
+    QVERIFY( ProfileManager::profileToJSON( p ).find( "\"adaptiveEpp\"" ) == std::string::npos );
+
+    std::string json = minimalJSON();
+    const std::string anchor = R"("noTurbo": false)";
+    json.insert( json.find( anchor ) + anchor.size(),
+                 R"(, "adaptiveEpp": [ "power", 7, "", "balance_performance", "performance" ])" );
+    p = ProfileManager::parseProfileJSON( json );
+    const std::vector< std::string > levels{ "power", "balance_performance", "performance" };
+    QVERIFY( p.cpu.adaptiveEpp == levels );
+    QVERIFY( ProfileManager::parseProfileJSON( ProfileManager::profileToJSON( p ) ).cpu.adaptiveEpp == levels );
+
+    // a single level is no adaptive mode
+    json = minimalJSON();
+    json.insert( json.find( anchor ) + anchor.size(), R"(, "adaptiveEpp": [ "power" ])" );
+    QVERIFY( ProfileManager::parseProfileJSON( json ).cpu.adaptiveEpp.empty() );
+  }
+
+  void parseProfile_nestedKeysStayNested()
+  {
+    // "name" of the ODM profile must not be taken for the profile name
+    auto p = ProfileManager::parseProfileJSON(
+      R"({"odmProfile":{"name":"enthusiast"},"id":"x","name":"Outer","display":{"brightness":"high"}})" );
+    QCOMPARE( p.name, std::string( "Outer" ) );
+    QCOMPARE( *p.odmProfile.name, std::string( "enthusiast" ) );
+    QCOMPARE( p.display.brightness, 100 );  // wrong type keeps the default
+  }
+
+  // ---- parseProfilesJSON() ---------------------------------------------
+
+  void parseProfiles_array()
+  {
+    // braces inside strings must not split a profile
+    auto profiles = ProfileManager::parseProfilesJSON(
+      R"([{"id":"a","name":"curly } { name"},{"name":"no id"},42,{"id":"b","fan":{"tableCPU":[{"temp":40,"speed":30}]}}])" );
+    QCOMPARE( static_cast< int >( profiles.size() ), 2 );
+    QCOMPARE( profiles[0].name, std::string( "curly } { name" ) );
+    QCOMPARE( profiles[1].id, std::string( "b" ) );
+    QCOMPARE( static_cast< int >( profiles[1].fan.tableCPU.size() ), 1 );
+  }
+
+  void parseProfiles_invalid()
+  {
+    QVERIFY( ProfileManager::parseProfilesJSON( "" ).empty() );
+    QVERIFY( ProfileManager::parseProfilesJSON( R"([{"id":"a")" ).empty() );
+    QVERIFY( ProfileManager::parseProfilesJSON( R"({"id":"a"})" ).empty() );
+  }
+
   // ---- parseFanTableFromJSON() -----------------------------------------
 
   void parseFanTable_valid()
@@ -0,0 +1,102 @@
+/*
+ * Unit tests for ProfilePatch – JSON merge patches of profiles and the
+ * subsystems a change touches.
+ */
+
+#include <QTest>
+#include "ProfilePatch.hpp"
+
+class TestProfilePatch : public QObject
+{
+  Q_OBJECT
+
+private:
+  static UccProfile sampleProfile()
+  {
+    UccProfile profile( "custom-1", "Quiet" );
+    profile.cpu.scalingMaxFrequency = 3200000;
+    profile.fan.tableCPU = { { 40, 20 }, { 90, 100 } };
+    profile.fan.tableGPU = { { 40, 25 }, { 90, 100 } };
+    profile.odmPowerLimits.tdpValues = { 25, 35, 45 };
+    profile.keyboard.keyboardProfileData = R"({"brightness": 50, "states": [1, 2]})";
+    profile.chargeEndThreshold = 90;
+    return profile;
+  }
+
+private slots:
+
+  void fanPatchTouchesOnlyFans()
+  {
+    const UccProfile base = sampleProfile();
+    auto patched = mergePatchProfile(
+      base, R"({"fan":{"tableCPU":[{"temp":40,"speed":30},{"temp":90,"speed":100}]}})" );
+    QVERIFY( patched.has_value() );
+    QCOMPARE( patched->fan.tableCPU.front().speed, 30 );
+    QVERIFY( patched->fan.tableGPU == base.fan.tableGPU );
+    QCOMPARE( changedProfileSubsystems( base, *patched ), ProfileSubsystem::Fan );
+  }
+
+  void untouchedFieldsSurvive()
+  {
+    const UccProfile base = sampleProfile();
+    auto patched = mergePatchProfile( base, R"({"name":"Silent"})" );
+    QVERIFY( patched.has_value() );
+    QCOMPARE( patched->name, std::string( "Silent" ) );
+    QCOMPARE( patched->cpu.scalingMaxFrequency.value_or( -1 ), 3200000 );
+    QVERIFY( patched->odmPowerLimits.tdpValues == base.odmPowerLimits.tdpValues );
+    QCOMPARE( patched->chargeEndThreshold, 90 );
+    // keyboard data comes back re-serialized, yet is the same document
+    QCOMPARE( changedProfileSubsystems( base, *patched ), ProfileSubsystem::Passive );
+  }
+
+  void severalSubsystems()
+  {
+    const UccProfile base = sampleProfile();
+    auto patched = mergePatchProfile( base, R"({"cpu":{"noTurbo":true},"chargeEndThreshold":80})" );
+    QVERIFY( patched.has_value() );
+    QCOMPARE( changedProfileSubsystems( base, *patched ),
+              ProfileSubsystem::Cpu | ProfileSubsystem::Charging );
+  }
+
+  void brightnessIsItsOwnSubsystem()
+  {
+    const UccProfile base = sampleProfile();
+    auto patched = mergePatchProfile( base, R"({"display":{"brightness":30,"useBrightness":true}})" );
+    QVERIFY( patched.has_value() );
+    QCOMPARE( changedProfileSubsystems( base, *patched ), ProfileSubsystem::Display );
+
+    patched = mergePatchProfile( base, R"({"display":{"refreshRate":120}})" );
+    QVERIFY( patched.has_value() );
+    QCOMPARE( changedProfileSubsystems( base, *patched ), ProfileSubsystem::Passive );
+  }
+
+  void nullRemovesKey()
+  {
+    const UccProfile base = sampleProfile();
+    auto patched = mergePatchProfile( base, R"({"chargeEndThreshold":null})" );
+    QVERIFY( patched.has_value() );
+    QCOMPARE( patched->chargeEndThreshold, -1 );
+  }
+
+  void rejectsBadPatches()
+  {
+    const UccProfile base = sampleProfile();
+    QVERIFY( !mergePatchProfile( base, "not json" ).has_value() );
+    QVERIFY( !mergePatchProfile( base, "[1,2]" ).has_value() );
+    QVERIFY( !mergePatchProfile( base, R"({"id":"other"})" ).has_value() );
+    QVERIFY( mergePatchProfile( base, R"({"id":"custom-1"})" ).has_value() );
+  }
+
+  void identicalProfilesHaveNoChanges()
+  {
+    const UccProfile base = sampleProfile();
+    QCOMPARE( changedProfileSubsystems( base, base ), uint32_t( 0 ) );
+    UccProfile other = base;
+    other.gpuOCProfileData = R"({"powerLimitW":80})";
+    QCOMPARE( changedProfileSubsystems( base, other ), ProfileSubsystem::GpuOC );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestProfilePatch )
+
+#include "test_profile_patch.moc"
@@ -0,0 +1,96 @@
+/*
+ * Unit tests for ProfileRepository – id lookup, insertion order, in-place
+ * replacement and snapshots that outlive later changes.
+ */
+
+#include <QTest>
+#include "ProfileRepository.hpp"
+
+class TestProfileRepository : public QObject
+{
+  Q_OBJECT
+
+private:
+  static UccProfile make( const std::string &id, const std::string &name )
+  {
+    UccProfile p;
+    p.id = id;
+    p.name = name;
+    return p;
+  }
+
+private slots:
+
+  void findsById()
+  {
+    ProfileRepository repo;
+    QVERIFY( repo.empty() );
+    repo.upsert( make( "a", "Quiet" ) );
+    repo.upsert( make( "b", "Loud" ) );
+
+    QCOMPARE( repo.size(), size_t( 2 ) );
+    QVERIFY( repo.contains( "b" ) );
+    QCOMPARE( repo.find( "a" )->name, std::string( "Quiet" ) );
+    QVERIFY( !repo.find( "c" ) );
+    QCOMPARE( repo.findByName( "Loud" )->id, std::string( "b" ) );
+    QVERIFY( !repo.findByName( "Missing" ) );
+  }
+
+  void upsertReplacesInPlace()
+  {
+    ProfileRepository repo;
+    repo.upsert( make( "a", "One" ) );
+    repo.upsert( make( "b", "Two" ) );
+    repo.upsert( make( "a", "One renamed" ) );
+
+    const auto list = repo.list();
+    QCOMPARE( list.size(), size_t( 2 ) );
+    QCOMPARE( list[ 0 ].name, std::string( "One renamed" ) );
+    QCOMPARE( list[ 1 ].id, std::string( "b" ) );
+  }
+
+  void eraseKeepsOrder()
+  {
+    ProfileRepository repo;
+    repo.assign( { make( "a", "A" ), make( "b", "B" ), make( "c", "A" ) } );
+
+    QVERIFY( !repo.erase( "x" ) );
+    QVERIFY( repo.erase( "b" ) );
+    QVERIFY( !repo.contains( "b" ) );
+    QCOMPARE( repo.eraseIf( []( const UccProfile &p ) { return p.name == "A" && p.id != "a"; } ), size_t( 1 ) );
+
+    const auto list = repo.list();
+    QCOMPARE( list.size(), size_t( 1 ) );
+    QCOMPARE( list[ 0 ].id, std::string( "a" ) );
+  }
+
+  void snapshotIsStable()
+  {
+    ProfileRepository repo;
+    repo.upsert( make( "a", "Before" ) );
+    const auto before = repo.snapshot();
+
+    repo.upsert( make( "a", "After" ) );
+    repo.upsert( make( "b", "New" ) );
+
+    QCOMPARE( before->ordered.size(), size_t( 1 ) );
+    QCOMPARE( before->byId.at( "a" )->name, std::string( "Before" ) );
+    QCOMPARE( repo.find( "a" )->name, std::string( "After" ) );
+    // untouched profiles are shared, not copied
+    QCOMPARE( repo.snapshot()->byId.at( "b" ), repo.find( "b" ) );
+  }
+
+  void assignLastDuplicateWins()
+  {
+    ProfileRepository repo;
+    repo.upsert( make( "old", "Old" ) );
+    repo.assign( { make( "a", "First" ), make( "a", "Second" ) } );
+
+    QVERIFY( !repo.contains( "old" ) );
+    QCOMPARE( repo.size(), size_t( 1 ) );
+    QCOMPARE( repo.find( "a" )->name, std::string( "Second" ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestProfileRepository )
+#include "test_profile_repository.moc"
@@ -0,0 +1,113 @@
+/*
+ * Unit tests for the typed D-Bus profile form – jsonToWire() / wireToJson()
+ * and profileToWire() / profileFromWire()
+ */
+
+#include <QTest>
+#include <QJsonDocument>
+#include "ProfileWireCodec.hpp"
+
+class TestProfileWire : public QObject
+{
+  Q_OBJECT
+
+private:
+  static QJsonObject sampleJson()
+  {
+    return QJsonDocument::fromJson( R"({
+      "id": "wire-1",
+      "name": "Wire Test",
+      "display": { "brightness": 70, "useBrightness": true },
+      "cpu": { "onlineCores": -1, "scalingMaxFrequency": 3200000, "governor": "powersave" },
+      "fan": {
+        "fanProfile": "fan-quiet",
+        "sameSpeed": false,
+        "tableCPU": [ { "temp": 40, "speed": 20 }, { "temp": 80, "speed": 70 } ],
+        "tableGPU": [ { "temp": 45, "speed": 25 } ],
+        "controller": { "mode": "pid", "targetTemp": 200, "kp": 3.5 }
+      },
+      "odmPowerLimits": { "tdpValues": [ 35, 60, 90 ] },
+      "keyboard": { "brightness": 2, "states": [ { "brightness": 2, "red": 255, "green": 0, "blue": 10 } ] },
+      "selectedKeyboardProfile": "kb-7",
+      "chargingPriority": null,
+      "chargeEndThreshold": 85
+    })" ).object();
+  }
+
+private slots:
+
+  void jsonToWire_typesBulkyParts()
+  {
+    const QVariantMap wire = ucc::jsonToWire( sampleJson() );
+    const QVariantMap fan = wire.value( "fan" ).toMap();
+    QCOMPARE( fan.value( "tableCPU" ).metaType(), QMetaType::fromType< ucc::WireFanTable >() );
+    QCOMPARE( fan.value( "tableCPU" ).value< ucc::WireFanTable >().size(), 2 );
+    QCOMPARE( fan.value( "tableCPU" ).value< ucc::WireFanTable >()[ 1 ].speed, 70 );
+
+    const QVariantMap keyboard = wire.value( "keyboard" ).toMap();
+    QCOMPARE( keyboard.value( "states" ).metaType(), QMetaType::fromType< ucc::WireKeyboardStates >() );
+    QCOMPARE( keyboard.value( "states" ).value< ucc::WireKeyboardStates >()[ 0 ].red, 255 );
+
+    const QVariantMap odm = wire.value( "odmPowerLimits" ).toMap();
+    QCOMPARE( odm.value( "tdpValues" ).value< QList< int > >(), QList< int >( { 35, 60, 90 } ) );
+  }
+
+  void jsonToWire_dropsNulls()
+  {
+    QVERIFY( !ucc::jsonToWire( sampleJson() ).contains( "chargingPriority" ) );
+  }
+
+  void wireToJson_roundTrip()
+  {
+    QJsonObject expected = sampleJson();
+    expected.remove( "chargingPriority" );
+    QCOMPARE( ucc::wireToJson( ucc::jsonToWire( expected ) ), expected );
+  }
+
+  void profileFromWire_matchesParseProfileJSON()
+  {
+    const QJsonObject json = sampleJson();
+    const UccProfile typed = profileFromWire( ucc::jsonToWire( json ) );
+    const UccProfile parsed =
+      ProfileManager::parseProfileJSON( QJsonDocument( json ).toJson( QJsonDocument::Compact ).toStdString() );
+
+    QCOMPARE( typed.id, parsed.id );
+    QCOMPARE( typed.display.brightness, parsed.display.brightness );
+    QCOMPARE( typed.display.refreshRate, parsed.display.refreshRate );
+    QCOMPARE( typed.cpu.onlineCores.has_value(), parsed.cpu.onlineCores.has_value() );
+    QCOMPARE( typed.cpu.scalingMaxFrequency, parsed.cpu.scalingMaxFrequency );
+    QCOMPARE( typed.fan.fanProfile, parsed.fan.fanProfile );
+    QCOMPARE( typed.fan.sameSpeed, parsed.fan.sameSpeed );
+    QCOMPARE( typed.fan.tableCPU.size(), parsed.fan.tableCPU.size() );
+    QCOMPARE( typed.fan.tableCPU[ 1 ].temp, parsed.fan.tableCPU[ 1 ].temp );
+    QVERIFY( typed.fan.controller == parsed.fan.controller );
+    QCOMPARE( typed.fan.controller.targetTemp, 95 );
+    QCOMPARE( typed.odmPowerLimits.tdpValues, parsed.odmPowerLimits.tdpValues );
+    QCOMPARE( typed.keyboard.keyboardProfileId, parsed.keyboard.keyboardProfileId );
+    QCOMPARE( typed.chargingPriority, parsed.chargingPriority );
+    QCOMPARE( typed.chargeEndThreshold, 85 );
+    QCOMPARE( typed.chargeStartThreshold, -1 );
+  }
+
+  void profileWire_roundTrip()
+  {
+    const UccProfile original = profileFromWire( ucc::jsonToWire( sampleJson() ) );
+    const UccProfile copy = profileFromWire( profileToWire( original ) );
+
+    QCOMPARE( copy.name, original.name );
+    QCOMPARE( copy.cpu.governor, original.cpu.governor );
+    QCOMPARE( copy.fan.tableGPU.size(), size_t( 1 ) );
+    QCOMPARE( copy.fan.tableGPU[ 0 ].speed, 25 );
+    QVERIFY( copy.fan.controller == original.fan.controller );
+    QCOMPARE( copy.odmPowerLimits.tdpValues, original.odmPowerLimits.tdpValues );
+    QCOMPARE( copy.keyboard.keyboardProfileId, std::string( "kb-7" ) );
+
+    const QJsonObject keyboard =
+      QJsonDocument::fromJson( QByteArray::fromStdString( copy.keyboard.keyboardProfileData ) ).object();
+    QCOMPARE( keyboard.value( "states" ).toArray().first().toObject().value( "blue" ).toInt(), 10 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestProfileWire )
+
+#include "test_profile_wire.moc"
@@ -0,0 +1,100 @@
+/*
+ * Unit tests for PropertyChangeTracker – the change sets uccd sends as
+ * org.freedesktop.DBus.Properties.PropertiesChanged.
+ */
+
+#include <QTest>
+#include "PropertyChangeTracker.hpp"
+
+class TestPropertyChangeTracker : public QObject
+{
+  Q_OBJECT
+
+private:
+  static PropertyMap snapshot( bool fnLock, int32_t threshold, const std::string &profile )
+  {
+    return PropertyMap{ { "FnLockStatus", fnLock },
+                        { "ChargeEndThreshold", threshold },
+                        { "ActiveProfileJSON", profile } };
+  }
+
+private slots:
+
+  void firstUpdateReportsEverything()
+  {
+    PropertyChangeTracker tracker;
+    const PropertyMap changed = tracker.update( snapshot( false, 80, "{}" ) );
+    QCOMPARE( changed.size(), size_t( 3 ) );
+    QCOMPARE( std::get< int32_t >( changed.at( "ChargeEndThreshold" ) ), int32_t( 80 ) );
+  }
+
+  void unchangedSnapshotReportsNothing()
+  {
+    PropertyChangeTracker tracker;
+    (void)tracker.update( snapshot( false, 80, "{}" ) );
+    QVERIFY( tracker.update( snapshot( false, 80, "{}" ) ).empty() );
+  }
+
+  void onlyChangedEntriesAreReported()
+  {
+    PropertyChangeTracker tracker;
+    (void)tracker.update( snapshot( false, 80, "{\"id\":\"a\"}" ) );
+
+    const PropertyMap changed = tracker.update( snapshot( true, 80, "{\"id\":\"b\"}" ) );
+    QCOMPARE( changed.size(), size_t( 2 ) );
+    QVERIFY( std::get< bool >( changed.at( "FnLockStatus" ) ) );
+    QCOMPARE( std::get< std::string >( changed.at( "ActiveProfileJSON" ) ), std::string( "{\"id\":\"b\"}" ) );
+    QCOMPARE( std::get< bool >( tracker.published().at( "FnLockStatus" ) ), true );
+  }
+
+  void typeChangeCountsAsChange()
+  {
+    PropertyChangeTracker tracker;
+    (void)tracker.update( PropertyMap{ { "X", int32_t( 1 ) } } );
+    QCOMPARE( tracker.update( PropertyMap{ { "X", true } } ).size(), size_t( 1 ) );
+  }
+
+  void newPropertyIsReported()
+  {
+    PropertyChangeTracker tracker;
+    (void)tracker.update( snapshot( false, 80, "{}" ) );
+    PropertyMap next = snapshot( false, 80, "{}" );
+    next.emplace( "WaterCoolerConnected", true );
+    const PropertyMap changed = tracker.update( next );
+    QCOMPARE( changed.size(), size_t( 1 ) );
+    QVERIFY( changed.count( "WaterCoolerConnected" ) == 1 );
+  }
+
+  void setReportsOnlyChangesInPlace()
+  {
+    PropertyChangeTracker tracker;
+    tracker.set( "FnLockStatus", false );
+    tracker.set( "ChargeEndThreshold", int32_t( 80 ) );
+    tracker.set( "ActiveProfileJSON", std::string( "{}" ) );
+    QCOMPARE( tracker.takeChanged().size(), size_t( 3 ) );
+
+    tracker.set( "FnLockStatus", false );
+    tracker.set( "ChargeEndThreshold", int32_t( 80 ) );
+    tracker.set( "ActiveProfileJSON", "{}" );
+    QVERIFY( tracker.takeChanged().empty() );
+
+    tracker.set( "ActiveProfileJSON", "{\"id\":\"b\"}" );
+    const PropertyMap changed = tracker.takeChanged();
+    QCOMPARE( changed.size(), size_t( 1 ) );
+    QCOMPARE( std::get< std::string >( changed.at( "ActiveProfileJSON" ) ), std::string( "{\"id\":\"b\"}" ) );
+    QCOMPARE( std::get< std::string >( tracker.published().at( "ActiveProfileJSON" ) ),
+              std::string( "{\"id\":\"b\"}" ) );
+  }
+
+  void resetRepublishes()
+  {
+    PropertyChangeTracker tracker;
+    (void)tracker.update( snapshot( false, 80, "{}" ) );
+    tracker.reset();
+    QCOMPARE( tracker.update( snapshot( false, 80, "{}" ) ).size(), size_t( 3 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestPropertyChangeTracker )
+
+#include "test_property_change_tracker.moc"
@@ -0,0 +1,240 @@
+/*
+ * Unit tests for EnergyCounter wrap handling and RaplDomainSampler discovery.
+ */
+
+#include <QTest>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "RaplDomains.hpp"
+
+class TestRaplDomains : public QObject
+{
+  Q_OBJECT
+
+private:
+  static constexpr int64_t SECOND_NS = 1'000'000'000;
+
+  std::filesystem::path m_root;
+  std::filesystem::path m_dir;
+
+  void file( const std::filesystem::path &path, const std::string &content )
+  {
+    std::filesystem::create_directories( path.parent_path() );
+    std::ofstream( path, std::ios::trunc ) << content;
+  }
+
+  void zone( const std::string &dir, const std::string &name, int64_t energyUj,
+             int64_t maxRangeUj = 262143328850 )
+  {
+    const auto base = m_dir / "powercap" / dir;
+    file( base / "name", name + "\n" );
+    file( base / "energy_uj", std::to_string( energyUj ) + "\n" );
+    file( base / "max_energy_range_uj", std::to_string( maxRangeUj ) + "\n" );
+  }
+
+  /// Fresh powercap/ and hwmon/ trees for one test case
+  RaplDomainSampler sampler()
+  {
+    return RaplDomainSampler( ( m_dir / "powercap" ).string(), ( m_dir / "hwmon" ).string() );
+  }
+
+  void fresh( const std::string &name )
+  {
+    m_dir = m_root / name;
+    std::filesystem::create_directories( m_dir / "powercap" );
+    std::filesystem::create_directories( m_dir / "hwmon" );
+  }
+
+  static double at( const RaplDomainWatts &w, RaplDomain d )
+  {
+    return w[ static_cast< size_t >( d ) ];
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    m_root = std::filesystem::temp_directory_path() / ( "ucc-test-rapl-" + std::to_string( getpid() ) );
+    std::filesystem::create_directories( m_root );
+  }
+
+  void cleanupTestCase()
+  {
+    std::filesystem::remove_all( m_root );
+  }
+
+  void counterNeedsTwoReadings()
+  {
+    EnergyCounter c( 1'000'000 );
+    QVERIFY( !c.update( 100, 0 ).has_value() );
+    QCOMPARE( c.update( 15'100, SECOND_NS / 2 ), std::optional< double >( 0.03 ) );
+  }
+
+  void counterHandlesWrap()
+  {
+    EnergyCounter c( 1'000'000 );
+    ( void ) c.update( 990'000, 0 );
+    // 10 000 µJ to the wrap plus 20 000 µJ after it, in one second
+    QCOMPARE( c.update( 20'000, SECOND_NS ), std::optional< double >( 0.03 ) );
+  }
+
+  void counterWithoutRangeRestarts()
+  {
+    EnergyCounter c;
+    ( void ) c.update( 5'000'000, 0 );
+    QVERIFY( !c.update( 1'000, SECOND_NS ).has_value() );
+    QCOMPARE( c.update( 2'001'000, 2 * SECOND_NS ), std::optional< double >( 2.0 ) );
+  }
+
+  void counterIgnoresStalledClock()
+  {
+    EnergyCounter c( 1'000'000 );
+    ( void ) c.update( 0, SECOND_NS );
+    QVERIFY( !c.update( 1'000, SECOND_NS ).has_value() );
+    QCOMPARE( c.update( 2'000, 2 * SECOND_NS ), std::optional< double >( 0.002 ) );
+  }
+
+  void powercapDomainsByName()
+  {
+    fresh( "powercapDomainsByName" );
+    zone( "intel-rapl:0", "package-0", 0 );
+    zone( "intel-rapl:0:0", "core", 0 );
+    zone( "intel-rapl:0:1", "uncore", 0 );
+    zone( "intel-rapl:1", "psys", 0 );
+    zone( "intel-rapl-mmio:0", "package-0", 0 );
+    file( m_dir / "powercap" / "intel-rapl" / "enabled", "1\n" );
+
+    auto s = sampler();
+    s.discover();
+    QVERIFY( s.source() == RaplDomainSampler::Source::Powercap );
+    QVERIFY( s.available( RaplDomain::Package ) );
+    QVERIFY( s.available( RaplDomain::Core ) );
+    QVERIFY( s.available( RaplDomain::Uncore ) );
+    QVERIFY( !s.available( RaplDomain::Dram ) );
+    QVERIFY( s.available( RaplDomain::Psys ) );
+
+    const auto first = s.sample( 0 );
+    QCOMPARE( at( first, RaplDomain::Package ), -1.0 );
+
+    zone( "intel-rapl:0", "package-0", 15'000'000 );
+    zone( "intel-rapl:0:0", "core", 10'000'000 );
+    zone( "intel-rapl:0:1", "uncore", 2'000'000 );
+    zone( "intel-rapl:1", "psys", 30'000'000 );
+    // the MMIO duplicate must not be added to the package
+    zone( "intel-rapl-mmio:0", "package-0", 15'000'000 );
+
+    const auto w = s.sample( SECOND_NS );
+    QCOMPARE( at( w, RaplDomain::Package ), 15.0 );
+    QCOMPARE( at( w, RaplDomain::Core ), 10.0 );
+    QCOMPARE( at( w, RaplDomain::Uncore ), 2.0 );
+    QCOMPARE( at( w, RaplDomain::Dram ), -1.0 );
+    QCOMPARE( at( w, RaplDomain::Psys ), 30.0 );
+  }
+
+  void packagesAreSummed()
+  {
+    fresh( "packagesAreSummed" );
+    zone( "intel-rapl:0", "package-0", 9'000'000, 10'000'000 );
+    zone( "intel-rapl:1", "package-1", 0 );
+
+    auto s = sampler();
+    s.discover();
+    ( void ) s.sample( 0 );
+
+    // package-0 wraps at 10 J
+    zone( "intel-rapl:0", "package-0", 5'000'000, 10'000'000 );
+    zone( "intel-rapl:1", "package-1", 8'000'000 );
+    QCOMPARE( at( s.sample( 2 * SECOND_NS ), RaplDomain::Package ), 7.0 );
+
+    zone( "intel-rapl:0", "package-0", 7'000'000, 10'000'000 );
+    zone( "intel-rapl:1", "package-1", 16'000'000 );
+    QCOMPARE( at( s.sample( 4 * SECOND_NS ), RaplDomain::Package ), 5.0 );
+  }
+
+  void amdEnergyFallback()
+  {
+    fresh( "amdEnergyFallback" );
+    const auto hwmon = m_dir / "hwmon" / "hwmon3";
+    file( hwmon / "name", "amd_energy\n" );
+    file( hwmon / "energy1_label", "Ecore000\n" );
+    file( hwmon / "energy1_input", "0\n" );
+    file( hwmon / "energy2_label", "Ecore001\n" );
+    file( hwmon / "energy2_input", "0\n" );
+    file( hwmon / "energy3_label", "Esocket0\n" );
+    file( hwmon / "energy3_input", "0\n" );
+
+    auto s = sampler();
+    s.discover();
+    QVERIFY( s.source() == RaplDomainSampler::Source::AmdEnergy );
+    QVERIFY( s.available( RaplDomain::Package ) );
+    QVERIFY( s.available( RaplDomain::Core ) );
+    QVERIFY( !s.available( RaplDomain::Uncore ) );
+    ( void ) s.sample( 0 );
+
+    file( hwmon / "energy1_input", "3000000\n" );
+    file( hwmon / "energy2_input", "4000000\n" );
+    file( hwmon / "energy3_input", "12000000\n" );
+    const auto w = s.sample( SECOND_NS );
+    QCOMPARE( at( w, RaplDomain::Package ), 12.0 );
+    QCOMPARE( at( w, RaplDomain::Core ), 7.0 );
+  }
+
+  void nothingFound()
+  {
+    fresh( "nothingFound" );
+    auto s = sampler();
+    s.discover();
+    QVERIFY( s.source() == RaplDomainSampler::Source::None );
+    QCOMPARE( at( s.sample( 0 ), RaplDomain::Package ), -1.0 );
+  }
+
+  void powerLimitsWrittenAndRestored()
+  {
+    fresh( "powerLimits" );
+    zone( "intel-rapl:0", "package-0", 0 );
+    zone( "intel-rapl:0:0", "core", 0 );
+    const auto base = m_dir / "powercap" / "intel-rapl:0";
+    file( base / "constraint_0_name", "long_term\n" );
+    file( base / "constraint_0_power_limit_uw", "45000000\n" );
+    file( base / "constraint_1_name", "short_term\n" );
+    file( base / "constraint_1_power_limit_uw", "90000000\n" );
+    file( m_dir / "powercap" / "intel-rapl:0:0" / "constraint_0_name", "long_term\n" );
+    file( m_dir / "powercap" / "intel-rapl:0:0" / "constraint_0_power_limit_uw", "0\n" );
+
+    const auto read = [&base]( const char *name ) {
+      return SysfsNode< int64_t >( ( base / name ).string() ).read().value_or( -1 );
+    };
+
+    RaplPowerLimits limits( ( m_dir / "powercap" ).string() );
+    limits.discover();
+    QVERIFY( limits.available() );
+
+    QVERIFY( limits.write( 35, 0 ) );
+    QCOMPARE( read( "constraint_0_power_limit_uw" ), int64_t( 35000000 ) );
+    QCOMPARE( read( "constraint_1_power_limit_uw" ), int64_t( 90000000 ) );
+
+    QVERIFY( limits.write( 30, 60 ) );
+    QCOMPARE( read( "constraint_1_power_limit_uw" ), int64_t( 60000000 ) );
+
+    limits.restore();
+    QCOMPARE( read( "constraint_0_power_limit_uw" ), int64_t( 45000000 ) );
+    QCOMPARE( read( "constraint_1_power_limit_uw" ), int64_t( 90000000 ) );
+  }
+
+  void powerLimitsAbsent()
+  {
+    fresh( "powerLimitsAbsent" );
+    zone( "intel-rapl:0", "package-0", 0 );
+    RaplPowerLimits limits( ( m_dir / "powercap" ).string() );
+    limits.discover();
+    QVERIFY( !limits.available() );
+    QVERIFY( limits.write( 20, 40 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestRaplDomains )
+
+#include "test_rapl_domains.moc"
@@ -0,0 +1,118 @@
+/*
+ * Unit tests for SamplingGovernor mode selection and interval mapping.
+ */
+
+#include <QTest>
+#include <chrono>
+#include <cstdint>
+#include "SamplingGovernor.hpp"
+
+using std::chrono::milliseconds;
+
+class TestSamplingGovernor : public QObject
+{
+  Q_OBJECT
+
+private:
+  static constexpr milliseconds NORMAL{ 800 };
+
+  /// Report a constant temperature every second over [fromMs, toMs)
+  static void steady( SamplingGovernor &g, double celsius, int64_t fromMs, int64_t toMs )
+  {
+    for ( int64_t t = fromMs; t < toMs; t += 1000 )
+      g.reportTemperature( celsius, t );
+  }
+
+private slots:
+
+  void normalAtStart()
+  {
+    SamplingGovernor g( 0 );
+    QVERIFY( g.mode( 0 ) == SamplingMode::Normal );
+    QCOMPARE( g.interval( NORMAL, true, 0 ), NORMAL );
+  }
+
+  void idleOnceStable()
+  {
+    SamplingGovernor g( 0 );
+    steady( g, 45.0, 0, SamplingGovernor::IDLE_AFTER_MS );
+    QVERIFY( g.mode( SamplingGovernor::IDLE_AFTER_MS - 1 ) == SamplingMode::Normal );
+    QVERIFY( g.mode( SamplingGovernor::IDLE_AFTER_MS ) == SamplingMode::Idle );
+    QCOMPARE( g.interval( NORMAL, true, SamplingGovernor::IDLE_AFTER_MS ), SamplingGovernor::IDLE_INTERVAL );
+  }
+
+  void jitterInsideBandStaysIdle()
+  {
+    SamplingGovernor g( 0 );
+    for ( int64_t t = 0; t < 60'000; t += 1000 )
+      g.reportTemperature( ( t / 1000 ) % 2 ? 46.0 : 45.0, t );
+    QVERIFY( g.mode( 60'000 ) == SamplingMode::Idle );
+  }
+
+  void driftOutsideBandResetsIdle()
+  {
+    SamplingGovernor g( 0 );
+    steady( g, 45.0, 0, 40'000 );
+    QVERIFY( g.mode( 40'000 ) == SamplingMode::Idle );
+
+    // +2.5 °C over 20 s: not a ramp, but it leaves the stable band
+    for ( int64_t t = 40'000; t <= 60'000; t += 4000 )
+      g.reportTemperature( 45.0 + 0.5 * static_cast< double >( ( t - 40'000 ) / 4000 ), t );
+    QVERIFY( g.mode( 60'000 ) == SamplingMode::Normal );
+  }
+
+  void rampSwitchesToFastAndHolds()
+  {
+    SamplingGovernor g( 0 );
+    steady( g, 45.0, 0, 40'000 );
+    QVERIFY( g.mode( 40'000 ) == SamplingMode::Idle );
+
+    // idle cadence: the next sample is 4 s later and 5 °C hotter
+    g.reportTemperature( 50.0, 44'000 );
+    QVERIFY( g.mode( 44'000 ) == SamplingMode::Fast );
+    QCOMPARE( g.interval( NORMAL, true, 44'000 ), SamplingGovernor::FAST_INTERVAL );
+    QCOMPARE( g.interval( milliseconds( 1000 ), false, 44'000 ), milliseconds( 1000 ) );
+
+    QVERIFY( g.mode( 44'000 + SamplingGovernor::FAST_HOLD_MS - 1 ) == SamplingMode::Fast );
+    QVERIFY( g.mode( 44'000 + SamplingGovernor::FAST_HOLD_MS ) == SamplingMode::Normal );
+  }
+
+  void slowRiseIsNotARamp()
+  {
+    SamplingGovernor g( 0 );
+    for ( int64_t t = 0; t < 20'000; t += 1000 )
+      g.reportTemperature( 45.0 + 0.5 * static_cast< double >( t / 1000 ), t );
+    QVERIFY( g.mode( 20'000 ) != SamplingMode::Fast );
+  }
+
+  void clientActivityPreventsIdle()
+  {
+    SamplingGovernor g( 0 );
+    steady( g, 45.0, 0, 40'000 );
+    g.noteClientActivity( 39'000 );
+    QVERIFY( g.mode( 40'000 ) == SamplingMode::Normal );
+    QVERIFY( g.mode( 39'000 + SamplingGovernor::CLIENT_TIMEOUT_MS ) == SamplingMode::Idle );
+  }
+
+  void fastClientsForceFast()
+  {
+    SamplingGovernor g( 0 );
+    steady( g, 45.0, 0, 40'000 );
+    g.setFastClients( 1 );
+    QVERIFY( g.mode( 40'000 ) == SamplingMode::Fast );
+    QCOMPARE( g.interval( milliseconds( 100 ), true, 40'000 ), milliseconds( 100 ) );
+    g.setFastClients( 0 );
+    QVERIFY( g.mode( 40'000 ) == SamplingMode::Idle );
+  }
+
+  void slowWorkersKeepTheirPeriod()
+  {
+    SamplingGovernor g( 0 );
+    steady( g, 45.0, 0, 40'000 );
+    QCOMPARE( g.interval( milliseconds( 10'000 ), true, 40'000 ), milliseconds( 10'000 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestSamplingGovernor )
+
+#include "test_sampling_governor.moc"
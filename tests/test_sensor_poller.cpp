@@ -0,0 +1,152 @@
+/*
+ * Unit tests for SensorPoller batch reads and snapshot handling.
+ */
+
+#include <QTest>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "SensorPoller.hpp"
+
+class TestSensorPoller : public QObject
+{
+  Q_OBJECT
+
+private:
+  std::filesystem::path m_dir;
+
+  std::string file( const std::string &name, const std::string &content )
+  {
+    const auto path = m_dir / name;
+    std::ofstream( path, std::ios::trunc ) << content;
+    return path.string();
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    m_dir = std::filesystem::temp_directory_path() / ( "ucc-test-poller-" + std::to_string( getpid() ) );
+    std::filesystem::create_directories( m_dir );
+  }
+
+  void cleanupTestCase()
+  {
+    std::filesystem::remove_all( m_dir );
+  }
+
+  void emptyBeforeFirstRefresh()
+  {
+    SensorPoller poller;
+    const auto h = poller.add( file( "t", "42000\n" ) );
+    QVERIFY( !poller.readInt( h ).has_value() );
+    QCOMPARE( poller.snapshotTimestampMs(), int64_t( 0 ) );
+    QVERIFY( !poller.readInt( SensorPoller::INVALID_HANDLE ).has_value() );
+  }
+
+  void refreshReadsAllNodes()
+  {
+    SensorPoller poller;
+    const auto temp = poller.add( file( "temp1_input", "42000\n" ) );
+    const auto freq = poller.add( file( "freq1_input", "-12\n" ) );
+    const auto type = poller.add( file( "type", "Mains\n" ) );
+    QCOMPARE( poller.size(), size_t( 3 ) );
+
+    poller.refresh();
+    QCOMPARE( poller.readInt( temp ), std::optional< int64_t >( 42000 ) );
+    QCOMPARE( poller.readInt( freq ), std::optional< int64_t >( -12 ) );
+    QCOMPARE( poller.readString( type ), std::optional< std::string >( "Mains" ) );
+    QVERIFY( !poller.readInt( type ).has_value() );
+    QVERIFY( poller.snapshotTimestampMs() > 0 );
+  }
+
+  void duplicatePathSharesHandle()
+  {
+    SensorPoller poller;
+    const auto a = poller.add( file( "online", "1\n" ) );
+    const auto b = poller.add( ( m_dir / "online" ).string() );
+    QCOMPARE( a, b );
+    QCOMPARE( poller.size(), size_t( 1 ) );
+  }
+
+  void snapshotTracksRewrites()
+  {
+    SensorPoller poller;
+    const auto h = poller.add( file( "cur", "800000\n" ) );
+    poller.refresh();
+    QCOMPARE( poller.readInt( h ), std::optional< int64_t >( 800000 ) );
+
+    // Rewritten in place: the persistent fd must see the new content
+    file( "cur", "4700000\n" );
+    QCOMPARE( poller.readInt( h ), std::optional< int64_t >( 800000 ) );
+    poller.refresh();
+    QCOMPARE( poller.readInt( h ), std::optional< int64_t >( 4700000 ) );
+  }
+
+  void truncatesToReadSize()
+  {
+    SensorPoller poller;
+    const auto h = poller.add( file( "long", "0: 400Mhz\n1: 1900Mhz *\n" ), 9 );
+    poller.refresh();
+    QCOMPARE( poller.readString( h ), std::optional< std::string >( "0: 400Mhz" ) );
+  }
+
+  void binaryContentIsKeptVerbatim()
+  {
+    SensorPoller poller;
+    const std::string blob( "\x78\x00\x02\x01\n \n", 7 );
+    const auto h = poller.add( file( "gpu_metrics", blob ), 256 );
+    poller.refresh();
+
+    char buf[ 16 ] = {};
+    QCOMPARE( poller.readBytes( h, buf, sizeof( buf ) ), blob.size() );
+    QCOMPARE( std::string( buf, blob.size() ), blob );
+    QCOMPARE( poller.readBytes( h, buf, 2 ), size_t( 2 ) );
+    QCOMPARE( poller.readBytes( SensorPoller::INVALID_HANDLE, buf, sizeof( buf ) ), size_t( 0 ) );
+  }
+
+  void missingNodeIsRetried()
+  {
+    SensorPoller poller;
+    const auto path = ( m_dir / "late" ).string();
+    const auto h = poller.add( path );
+    poller.refresh();
+    QVERIFY( !poller.readInt( h ).has_value() );
+
+    file( "late", "7\n" );
+    for ( uint32_t i = 0; i < SensorPoller::REOPEN_INTERVAL; ++i )
+      poller.refresh();
+    QVERIFY( !poller.readInt( h ).has_value() );
+    poller.refresh();
+    QCOMPARE( poller.readInt( h ), std::optional< int64_t >( 7 ) );
+  }
+
+  void nodesAddedLaterJoinTheBatch()
+  {
+    SensorPoller poller;
+    const auto a = poller.add( file( "a", "1\n" ) );
+    poller.refresh();
+    const auto b = poller.add( file( "b", "2\n" ) );
+    QVERIFY( !poller.readInt( b ).has_value() );
+    poller.refresh();
+    QCOMPARE( poller.readInt( a ), std::optional< int64_t >( 1 ) );
+    QCOMPARE( poller.readInt( b ), std::optional< int64_t >( 2 ) );
+  }
+
+  void manyNodesSpanSeveralBatches()
+  {
+    SensorPoller poller;
+    std::vector< SensorPoller::Handle > handles;
+    for ( int i = 0; i < 150; ++i )
+      handles.push_back( poller.add( file( "n" + std::to_string( i ), std::to_string( i * 3 ) + "\n" ) ) );
+    poller.refresh();
+    for ( int i = 0; i < 150; ++i )
+      QCOMPARE( poller.readInt( handles[ static_cast< size_t >( i ) ] ), std::optional< int64_t >( i * 3 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestSensorPoller )
+
+#include "test_sensor_poller.moc"
@@ -0,0 +1,66 @@
+/*
+ * Unit tests for SensorSubscriptions – per-sender sensor group masks and
+ * their union.
+ */
+
+#include <QTest>
+#include "SensorSubscriptions.hpp"
+
+using namespace ucc;
+
+class TestSensorSubscriptions : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void emptyByDefault()
+  {
+    SensorSubscriptions subs;
+    QCOMPARE( subs.mask(), uint32_t( 0 ) );
+    QCOMPARE( subs.subscribers(), size_t( 0 ) );
+  }
+
+  void maskIsUnionOfSenders()
+  {
+    SensorSubscriptions subs;
+    QCOMPARE( subs.subscribe( ":1.5", SensorGroup::CpuPower ), SensorGroup::CpuPower );
+    QCOMPARE( subs.subscribe( ":1.6", SensorGroup::DGpu ), SensorGroup::CpuPower | SensorGroup::DGpu );
+    QCOMPARE( subs.subscribers(), size_t( 2 ) );
+  }
+
+  void resubscribeReplacesMask()
+  {
+    SensorSubscriptions subs;
+    subs.subscribe( ":1.5", SensorGroup::All );
+    QCOMPARE( subs.subscribe( ":1.5", SensorGroup::IGpu ), SensorGroup::IGpu );
+    QCOMPARE( subs.subscribers(), size_t( 1 ) );
+  }
+
+  void unsubscribeDropsOnlyThatSender()
+  {
+    SensorSubscriptions subs;
+    subs.subscribe( ":1.5", SensorGroup::DGpu | SensorGroup::IGpu );
+    subs.subscribe( ":1.50", SensorGroup::IGpu );
+    QCOMPARE( subs.unsubscribe( ":1.5" ), SensorGroup::IGpu );
+    QVERIFY( !subs.contains( ":1.5" ) );
+    QVERIFY( subs.contains( ":1.50" ) );
+    QCOMPARE( subs.unsubscribe( ":1.50" ), uint32_t( 0 ) );
+    QCOMPARE( subs.unsubscribe( ":1.50" ), uint32_t( 0 ) );
+  }
+
+  void emptyOrUnknownGroupsUnsubscribe()
+  {
+    SensorSubscriptions subs;
+    subs.subscribe( ":1.5", SensorGroup::CpuFrequency );
+    QCOMPARE( subs.subscribe( ":1.5", 0 ), uint32_t( 0 ) );
+    QVERIFY( !subs.contains( ":1.5" ) );
+    QCOMPARE( subs.subscribe( ":1.5", 1u << 31 ), uint32_t( 0 ) );
+    QVERIFY( !subs.contains( ":1.5" ) );
+    QCOMPARE( subs.subscribe( ":1.5", ( 1u << 31 ) | SensorGroup::DGpu ), SensorGroup::DGpu );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestSensorSubscriptions )
+
+#include "test_sensor_subscriptions.moc"
@@ -0,0 +1,172 @@
+/*
+ * Unit tests for SeriesRing (chart point ring with incremental commits).
+ */
+
+#include <QTest>
+#include <cstddef>
+#include <vector>
+#include "SeriesRing.hpp"
+
+using ucc::SeriesRing;
+
+namespace
+{
+
+struct Pt
+{
+  double px = 0.0;
+  double py = 0.0;
+  double x() const { return px; }
+  double y() const { return py; }
+};
+
+/// A drawn series fed only through commit() deltas
+struct Mirror
+{
+  std::vector< double > xs;
+
+  void apply( const SeriesRing< Pt > &ring, const SeriesRing< Pt >::Delta &delta )
+  {
+    xs.erase( xs.begin(), xs.begin() + static_cast< std::ptrdiff_t >( delta.removeFront ) );
+    for ( size_t i = delta.appendFrom; i < ring.size(); ++i )
+      xs.push_back( ring[ i ].x() );
+  }
+
+  bool matches( const SeriesRing< Pt > &ring ) const
+  {
+    if ( xs.size() != ring.size() )
+      return false;
+    for ( size_t i = 0; i < xs.size(); ++i )
+      if ( xs[ i ] != ring[ i ].x() )
+        return false;
+    return true;
+  }
+};
+
+} // namespace
+
+class TestSeriesRing : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void commitReportsOnlyNewPoints()
+  {
+    SeriesRing< Pt > ring( 16 );
+    for ( int i = 0; i < 5; ++i )
+      ring.push( { double( i ), 0.0 } );
+
+    auto delta = ring.commit();
+    QCOMPARE( delta.removeFront, size_t( 0 ) );
+    QCOMPARE( delta.appendFrom, size_t( 0 ) );
+    QCOMPARE( ring.committed(), size_t( 5 ) );
+
+    ring.push( { 5.0, 0.0 } );
+    ring.push( { 6.0, 0.0 } );
+    delta = ring.commit();
+    QCOMPARE( delta.removeFront, size_t( 0 ) );
+    QCOMPARE( delta.appendFrom, size_t( 5 ) );
+
+    QVERIFY( ring.commit().empty( ring.size() ) );
+  }
+
+  void trimRemovesCommittedFromFront()
+  {
+    SeriesRing< Pt > ring( 16 );
+    for ( int i = 0; i < 6; ++i )
+      ring.push( { double( i ), 0.0 } );
+    ( void ) ring.commit();
+
+    ring.push( { 6.0, 0.0 } );
+    QCOMPARE( ring.trimBefore( 2.0 ), size_t( 2 ) );
+    QCOMPARE( ring.front().x(), 2.0 );
+
+    const auto delta = ring.commit();
+    QCOMPARE( delta.removeFront, size_t( 2 ) );
+    QCOMPARE( delta.appendFrom, size_t( 4 ) );
+    QCOMPARE( ring[ delta.appendFrom ].x(), 6.0 );
+  }
+
+  void trimOfUncommittedPointsIsNotReported()
+  {
+    SeriesRing< Pt > ring( 16 );
+    ring.push( { 0.0, 0.0 } );
+    ( void ) ring.commit();
+    ring.push( { 1.0, 0.0 } );
+    ring.push( { 2.0, 0.0 } );
+
+    // the committed point and one that never reached the series expire
+    QCOMPARE( ring.trimBefore( 2.0 ), size_t( 2 ) );
+    const auto delta = ring.commit();
+    QCOMPARE( delta.removeFront, size_t( 1 ) );
+    QCOMPARE( delta.appendFrom, size_t( 0 ) );
+    QCOMPARE( ring.size(), size_t( 1 ) );
+  }
+
+  void fullRingDropsOldest()
+  {
+    SeriesRing< Pt > ring( 4 );
+    Mirror mirror;
+    for ( int i = 0; i < 4; ++i )
+      ring.push( { double( i ), 0.0 } );
+    mirror.apply( ring, ring.commit() );
+
+    for ( int i = 4; i < 7; ++i )
+      ring.push( { double( i ), 0.0 } );
+    QCOMPARE( ring.size(), size_t( 4 ) );
+    QCOMPARE( ring.front().x(), 3.0 );
+    QCOMPARE( ring.back().x(), 6.0 );
+
+    const auto delta = ring.commit();
+    QCOMPARE( delta.removeFront, size_t( 3 ) );
+    mirror.apply( ring, delta );
+    QVERIFY( mirror.matches( ring ) );
+  }
+
+  void mirrorStaysInSyncAcrossWraps()
+  {
+    SeriesRing< Pt > ring( 8 );
+    Mirror mirror;
+    double t = 0.0;
+    for ( int tick = 0; tick < 50; ++tick )
+    {
+      for ( int k = 0; k < tick % 4; ++k )
+        ring.push( { t++, 0.0 } );
+      ring.trimBefore( t - 6.0 );
+      mirror.apply( ring, ring.commit() );
+      QVERIFY( mirror.matches( ring ) );
+    }
+  }
+
+  void clearForgetsEverything()
+  {
+    SeriesRing< Pt > ring( 4 );
+    ring.push( { 1.0, 0.0 } );
+    ( void ) ring.commit();
+    ring.push( { 2.0, 0.0 } );
+    ring.clear();
+    QVERIFY( ring.empty() );
+    QVERIFY( ring.commit().empty( ring.size() ) );
+
+    ring.push( { 3.0, 0.0 } );
+    const auto delta = ring.commit();
+    QCOMPARE( delta.removeFront, size_t( 0 ) );
+    QCOMPARE( delta.appendFrom, size_t( 0 ) );
+  }
+
+  void lowerBoundAcrossWrap()
+  {
+    SeriesRing< Pt > ring( 4 );
+    for ( int i = 0; i < 6; ++i )
+      ring.push( { double( i * 10 ), 0.0 } );   // holds 20, 30, 40, 50
+    QCOMPARE( ring.lowerBound( 0.0 ), size_t( 0 ) );
+    QCOMPARE( ring.lowerBound( 25.0 ), size_t( 1 ) );
+    QCOMPARE( ring.lowerBound( 50.0 ), size_t( 3 ) );
+    QCOMPARE( ring.lowerBound( 51.0 ), size_t( 4 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestSeriesRing )
+
+#include "test_series_ring.moc"
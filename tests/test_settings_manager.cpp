@@ -82,6 +82,24 @@ private slots:
     QCOMPARE( *opt->chargingPriority, std::string( "performance" ) );
   }
 
+  void parse_workloadRules()
+  {
+    auto opt = mgr.parseSettingsJSON( R"({
+      "workloadRules": [
+        { "exe": "*/steamapps/common/*", "profile": "profile-perf" },
+        { "exe": "/usr/bin/blender", "cgroup": "*app-*", "profile": "profile-perf" },
+        { "exe": "*/cc1*" },
+        { "profile": "profile-quiet" },
+        { "exe": 42, "profile": "profile-quiet" },
+        "junk"
+      ]
+    })" );
+    QVERIFY( opt.has_value() );
+    QCOMPARE( static_cast< int >( opt->workloadRules.size() ), 2 );
+    QVERIFY( opt->workloadRules[ 0 ] == ( WorkloadRule{ "*/steamapps/common/*", "", "profile-perf" } ) );
+    QVERIFY( opt->workloadRules[ 1 ] == ( WorkloadRule{ "/usr/bin/blender", "*app-*", "profile-perf" } ) );
+  }
+
   // ---- malformed input → nullopt ----------------------------------------
 
   void parse_malformedJSON()
@@ -144,7 +162,11 @@ private slots:
     QVERIFY( !opt->fahrenheit );             // default false
     QVERIFY( opt->cpuSettingsEnabled );      // default true
     QVERIFY( opt->fanControlEnabled );       // default true
+    QVERIFY( !opt->fanControlFastLoop );     // default false
     QVERIFY( opt->keyboardBacklightControlEnabled ); // default true
+    QVERIFY( !opt->displayRefreshSaver );    // default false
+    QCOMPARE( opt->keyboardIdleTimeoutAcS, 0 );  // default never
+    QCOMPARE( opt->keyboardIdleTimeoutBatS, 0 );
     // Optional strings default to nullopt
     QVERIFY( !opt->shutdownTime.has_value() );
     QVERIFY( !opt->chargingProfile.has_value() );
@@ -0,0 +1,149 @@
+/*
+ * Unit tests for SimulatedHardware (thermal/power model, workloads) and
+ * SimulatedDevice (the DeviceInterface uccd drives).
+ */
+
+#include <QTest>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "tuxedo_io_lib/tuxedo_io_api.hh"
+
+using LoadPoint = SimulatedHardware::LoadPoint;
+
+class TestSimulatedDevice : public QObject
+{
+  Q_OBJECT
+
+private:
+  /// Constant @p cpuW / @p gpuW forever
+  static std::vector< LoadPoint > constant( double cpuW, double gpuW )
+  {
+    return { { 0.0, { cpuW, gpuW } } };
+  }
+
+private slots:
+
+  void settlesAtSteadyState()
+  {
+    SimulatedHardware hw( constant( 30.0, 30.0 ) );
+    hw.setFanDuty( 0, 50 );
+    hw.setFanDuty( 1, 50 );
+    hw.advance( 1200.0 );
+
+    // ambient + P / (G0 + G1 * 0.5)
+    QVERIFY( std::fabs( hw.temperature( 0 ) - ( 30.0 + 30.0 / ( 0.35 + 0.7 ) ) ) < 0.1 );
+    QVERIFY( std::fabs( hw.temperature( 1 ) - ( 30.0 + 30.0 / ( 0.5 + 1.1 ) ) ) < 0.1 );
+    QCOMPARE( hw.fanSpeed( 0 ), 50.0 );
+  }
+
+  void fasterFansRunCooler()
+  {
+    SimulatedHardware quiet( constant( 30.0, 30.0 ) ), loud( constant( 30.0, 30.0 ) );
+    quiet.setFanDuty( 0, 20 );
+    loud.setFanDuty( 0, 80 );
+    quiet.advance( 600.0 );
+    loud.advance( 600.0 );
+    QVERIFY( loud.temperature( 0 ) < quiet.temperature( 0 ) - 10.0 );
+  }
+
+  void fanSpeedIsSlewLimited()
+  {
+    SimulatedHardware hw( constant( 10.0, 10.0 ) );
+    hw.setFanDuty( 0, 100 );
+    hw.advance( 2.0 );
+    QCOMPARE( hw.fanSpeed( 0 ), 50.0 );
+    hw.advance( 10.0 );
+    QCOMPARE( hw.fanSpeed( 0 ), 100.0 );
+  }
+
+  void throttlesAtTjMaxAndObeysTdp()
+  {
+    SimulatedHardware hw( constant( 200.0, 200.0 ) );
+    hw.setFanDuty( 0, 0 );
+    hw.setFanDuty( 1, 0 );
+    hw.advance( 3600.0 );
+    QVERIFY( hw.temperature( 0 ) <= 100.0 + 1e-6 );
+    QVERIFY( hw.power( 0 ) < 200.0 );
+
+    SimulatedHardware capped( constant( 60.0, 0.0 ) );
+    capped.setTdp( 0, 25 );
+    capped.setFanDuty( 0, 100 );
+    capped.advance( 10.0 );
+    QCOMPARE( capped.power( 0 ), 25.0 );
+  }
+
+  void workloadLoops()
+  {
+    // 10 s idle, 10 s load, then from the top
+    SimulatedHardware hw( { { 0.0, { 5.0, 0.0 } }, { 10.0, { 40.0, 0.0 } }, { 20.0, { 5.0, 0.0 } } } );
+    hw.setFanDuty( 0, 100 );
+    hw.advance( 5.0 );
+    QCOMPARE( hw.power( 0 ), 5.0 );
+    hw.advance( 10.0 );
+    QCOMPARE( hw.power( 0 ), 40.0 );
+    hw.advance( 10.0 );
+    QCOMPARE( hw.power( 0 ), 5.0 );
+  }
+
+  void parsesWorkloadScript()
+  {
+    std::istringstream script( "# t cpu gpu\n0 10 5\n\n30 45 80  # load\n60 10 5\n" );
+    const auto points = SimulatedHardware::parseWorkload( script );
+    QVERIFY( points.has_value() );
+    QCOMPARE( points->size(), size_t( 3 ) );
+    QCOMPARE( ( *points )[ 1 ].watts[ 1 ], 80.0 );
+
+    std::istringstream backwards( "10 1 1\n5 1 1\n" );
+    QVERIFY( !SimulatedHardware::parseWorkload( backwards ).has_value() );
+    std::istringstream partial( "0 10\n" );
+    QVERIFY( !SimulatedHardware::parseWorkload( partial ).has_value() );
+  }
+
+  void traceWithoutPowerReplaysTemperatures()
+  {
+    ucc::SensorTrace trace;
+    trace.metrics = { "cpuTemp", "gpuPower" };
+    trace.timestamps = { 1000, 2000, 3000 };
+    trace.values = { 50.0f, 20.0f, 60.0f, 20.0f, 70.0f, 20.0f };
+
+    const auto points = SimulatedHardware::workloadFromTrace( trace );
+    QVERIFY( points.has_value() );
+    SimulatedHardware hw( *points );
+    hw.advance( 1.5 );
+    QCOMPARE( hw.temperature( 0 ), 60.0 );
+    QCOMPARE( hw.power( 1 ), 20.0 );
+  }
+
+  void deviceSharesTheModel()
+  {
+    IO io( "/nonexistent/tuxedo_io" );
+    auto hw = std::make_shared< SimulatedHardware >( constant( 20.0, 20.0 ) );
+    SimulatedDevice a( io, hw ), b( io, hw );
+
+    int fans = 0;
+    QVERIFY( a.getNumberFans( fans ) );
+    QCOMPARE( fans, 2 );
+    QVERIFY( a.setFanSpeedPercent( 1, 70 ) );
+    QVERIFY( !a.setFanSpeedPercent( 2, 70 ) );
+    hw->advance( 10.0 );
+    int speed = 0;
+    QVERIFY( b.getFanSpeedPercent( 1, speed ) );
+    QCOMPARE( speed, 70 );
+
+    QVERIFY( a.setTDP( 0, 30 ) );
+    QVERIFY( !a.setTDP( 0, 500 ) );
+    int tdp = 0;
+    QVERIFY( b.getTDP( 0, tdp ) );
+    QCOMPARE( tdp, 30 );
+
+    QVERIFY( a.setODMPerformanceProfile( "power_save" ) );
+    QVERIFY( !a.setODMPerformanceProfile( "turbo" ) );
+    QCOMPARE( hw->odmProfile(), std::string( "power_save" ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestSimulatedDevice )
+
+#include "test_simulated_device.moc"
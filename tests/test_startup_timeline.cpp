@@ -0,0 +1,143 @@
+/*
+ * Unit tests for StartupTimeline – per-phase timing of the daemon startup,
+ * parallel initializers joined through their futures, deferred phases and
+ * the JSON report.
+ */
+
+#include <QTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <stdexcept>
+#include <thread>
+#include "StartupTimeline.hpp"
+
+using namespace std::chrono_literals;
+
+class TestStartupTimeline : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void runRecordsAMainPhase()
+  {
+    StartupTimeline timeline;
+    const int value = timeline.run( "profiles", []() { return 42; } );
+    timeline.run( "settings", []() {} );
+
+    QCOMPARE( value, 42 );
+    const auto phases = timeline.phases();
+    QCOMPARE( phases.size(), size_t( 2 ) );
+    QCOMPARE( phases[ 0 ].name, std::string( "profiles" ) );
+    QVERIFY( phases[ 0 ].lane == StartupTimeline::Lane::Main );
+    QVERIFY( phases[ 1 ].startUs >= phases[ 0 ].startUs );
+  }
+
+  void recordUsesTheOrigin()
+  {
+    const auto origin = StartupTimeline::Clock::now();
+    StartupTimeline timeline( origin );
+    timeline.record( "late", StartupTimeline::Lane::Deferred, origin + 2s, origin + 2s + 5ms );
+    timeline.record( "early", StartupTimeline::Lane::Main, origin + 1ms, origin + 4ms );
+
+    const auto phases = timeline.phases();
+    QCOMPARE( phases[ 0 ].name, std::string( "early" ) );
+    QCOMPARE( phases[ 0 ].startUs, int64_t( 1'000 ) );
+    QCOMPARE( phases[ 0 ].durationUs, int64_t( 3'000 ) );
+    QCOMPARE( phases[ 1 ].startUs, int64_t( 2'000'000 ) );
+    QCOMPARE( phases[ 1 ].durationUs, int64_t( 5'000 ) );
+    QCOMPARE( timeline.mainUs(), int64_t( 3'000 ) );
+  }
+
+  void spawnRunsAlongsideAndIsJoinedByGet()
+  {
+    StartupTimeline timeline;
+    auto slow = timeline.spawn( "nvml", []() {
+      std::this_thread::sleep_for( 20ms );
+      return std::string( "loaded" );
+    } );
+    timeline.run( "display-modes", []() {} );
+    QCOMPARE( slow.get(), std::string( "loaded" ) );
+
+    bool sawParallel = false;
+    for ( const auto &phase : timeline.phases() )
+      if ( phase.name == "nvml" )
+      {
+        sawParallel = true;
+        QVERIFY( phase.lane == StartupTimeline::Lane::Parallel );
+        QVERIFY( phase.durationUs >= 20'000 );
+      }
+    QVERIFY( sawParallel );
+    // the parallel phase is not part of the main thread's time
+    QVERIFY( timeline.mainUs() < 20'000 );
+  }
+
+  void throwingPhaseIsStillRecorded()
+  {
+    StartupTimeline timeline;
+    auto failing = timeline.spawn( "system-info", []() -> int { throw std::runtime_error( "no pci.ids" ); } );
+    bool rethrown = false;
+    try { failing.get(); } catch ( const std::runtime_error & ) { rethrown = true; }
+    QVERIFY( rethrown );
+
+    rethrown = false;
+    try { timeline.run( "settings", []() { throw std::runtime_error( "no settings" ); } ); }
+    catch ( const std::runtime_error & ) { rethrown = true; }
+    QVERIFY( rethrown );
+    QCOMPARE( timeline.phases().size(), size_t( 2 ) );
+  }
+
+  void readyIsMarkedOnce()
+  {
+    const auto origin = StartupTimeline::Clock::now();
+    StartupTimeline timeline( origin );
+    QVERIFY( !timeline.readyUs() );
+    timeline.markReady( origin + 300ms );
+    timeline.markReady( origin + 900ms );
+    QCOMPARE( *timeline.readyUs(), int64_t( 300'000 ) );
+  }
+
+  void jsonListsEveryPhase()
+  {
+    const auto origin = StartupTimeline::Clock::now();
+    StartupTimeline timeline( origin );
+    timeline.record( "dbus-name", StartupTimeline::Lane::Main, origin, origin + 2ms );
+    timeline.record( "nvml", StartupTimeline::Lane::Parallel, origin + 3ms, origin + 250ms );
+    timeline.record( "nvidia-oc", StartupTimeline::Lane::Deferred, origin + 60s, origin + 60s + 40ms );
+    timeline.markReady( origin + 400ms );
+
+    std::string json;
+    JsonWriter w( json );
+    timeline.toJSON( w );
+    const QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( json ) ).object();
+    QCOMPARE( obj[ "readyMs" ].toDouble(), 400.0 );
+    QCOMPARE( obj[ "mainMs" ].toDouble(), 2.0 );
+    const QJsonArray phases = obj[ "phases" ].toArray();
+    QCOMPARE( phases.size(), 3 );
+    QCOMPARE( phases[ 1 ].toObject()[ "name" ].toString(), QStringLiteral( "nvml" ) );
+    QCOMPARE( phases[ 1 ].toObject()[ "lane" ].toString(), QStringLiteral( "parallel" ) );
+    QCOMPARE( phases[ 1 ].toObject()[ "startMs" ].toDouble(), 3.0 );
+    QCOMPARE( phases[ 1 ].toObject()[ "durationMs" ].toDouble(), 247.0 );
+    QCOMPARE( phases[ 2 ].toObject()[ "lane" ].toString(), QStringLiteral( "deferred" ) );
+  }
+
+  void summaryLeavesOutDeferredPhases()
+  {
+    const auto origin = StartupTimeline::Clock::now();
+    StartupTimeline timeline( origin );
+    timeline.record( "profiles", StartupTimeline::Lane::Main, origin, origin + 1500us );
+    timeline.record( "nvml", StartupTimeline::Lane::Parallel, origin, origin + 80ms );
+    timeline.record( "water-cooler", StartupTimeline::Lane::Deferred, origin + 5s, origin + 6s );
+    timeline.markReady( origin + 90ms );
+
+    const std::string line = timeline.summary();
+    QVERIFY( line.starts_with( "ready after 90.0 ms: " ) );
+    QVERIFY( line.find( "profiles 1.5 ms" ) != std::string::npos );
+    QVERIFY( line.find( "nvml 80.0 ms (parallel)" ) != std::string::npos );
+    QVERIFY( line.find( "water-cooler" ) == std::string::npos );
+  }
+};
+
+QTEST_MAIN( TestStartupTimeline )
+#include "test_startup_timeline.moc"
@@ -0,0 +1,135 @@
+/*
+ * Unit tests for SysfsNode parsing and the cached (persistent fd) read mode.
+ */
+
+#include <QTest>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "SysfsNode.hpp"
+
+class TestSysfsNode : public QObject
+{
+  Q_OBJECT
+
+private:
+  std::filesystem::path m_dir;
+
+  std::string file( const std::string &name, const std::string &content )
+  {
+    const auto path = m_dir / name;
+    std::ofstream( path, std::ios::trunc ) << content;
+    return path.string();
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    m_dir = std::filesystem::temp_directory_path() / ( "ucc-test-sysfs-" + std::to_string( getpid() ) );
+    std::filesystem::create_directories( m_dir );
+  }
+
+  void cleanupTestCase()
+  {
+    std::filesystem::remove_all( m_dir );
+  }
+
+  void parse_scalars()
+  {
+    QCOMPARE( SysfsNode< bool >( file( "b", "1\n" ) ).read(), std::optional< bool >( true ) );
+    QCOMPARE( SysfsNode< bool >( file( "b", "0\n" ) ).read(), std::optional< bool >( false ) );
+    QCOMPARE( SysfsNode< int32_t >( file( "i", "  4800000\n" ) ).read(), std::optional< int32_t >( 4800000 ) );
+    QCOMPARE( SysfsNode< int32_t >( file( "i", "-12\n" ) ).read(), std::optional< int32_t >( -12 ) );
+    QCOMPARE( SysfsNode< int64_t >( file( "l", "123456789012\n" ) ).read(),
+              std::optional< int64_t >( 123456789012 ) );
+    QVERIFY( !SysfsNode< int32_t >( file( "i", "abc\n" ) ).read().has_value() );
+    QVERIFY( !SysfsNode< int32_t >( file( "i", "99999999999\n" ) ).read().has_value() );
+    QVERIFY( !SysfsNode< int32_t >( file( "i", "" ) ).read().has_value() );
+  }
+
+  void parse_stringFirstLine()
+  {
+    QCOMPARE( SysfsNode< std::string >( file( "s", "powersave\r\nignored\n" ) ).read(),
+              std::optional< std::string >( "powersave" ) );
+    QCOMPARE( SysfsNode< std::string >( file( "s", "\n" ) ).read(), std::optional< std::string >( "" ) );
+  }
+
+  void parse_vectors()
+  {
+    const auto ranges = SysfsNode< std::vector< int32_t > >( file( "v", "0,2,4-7\n" ) ).read();
+    QCOMPARE( ranges, std::optional< std::vector< int32_t > >( { 0, 2, 4, 5, 6, 7 } ) );
+
+    const auto freqs = SysfsNode< std::vector< int32_t > >( file( "v", "800000 1600000 \n" ), " " ).read();
+    QCOMPARE( freqs, std::optional< std::vector< int32_t > >( { 800000, 1600000 } ) );
+
+    QVERIFY( !SysfsNode< std::vector< int32_t > >( file( "v", "0,x\n" ) ).read().has_value() );
+    QVERIFY( !SysfsNode< std::vector< int32_t > >( file( "v", "\n" ) ).read().has_value() );
+
+    const auto words = SysfsNode< std::vector< std::string > >( file( "w", "performance  powersave\n" ) ).read();
+    QCOMPARE( words, std::optional< std::vector< std::string > >( { "performance", "powersave" } ) );
+  }
+
+  void missingNode()
+  {
+    SysfsNode< int32_t > node( ( m_dir / "missing" ).string(), SysfsReadMode::Cached );
+    QVERIFY( !node.isAvailable() );
+    QVERIFY( !node.read().has_value() );
+  }
+
+  void cached_seesRewrittenContent()
+  {
+    const auto path = file( "c", "1000\n" );
+    SysfsNode< int32_t > node( path, SysfsReadMode::Cached );
+    QCOMPARE( node.mode(), SysfsReadMode::Cached );
+    QCOMPARE( node.read(), std::optional< int32_t >( 1000 ) );
+
+    // Same inode, new contents – pread at offset 0 picks them up
+    std::ofstream( path, std::ios::trunc ) << "2000\n";
+    QCOMPARE( node.read(), std::optional< int32_t >( 2000 ) );
+    QVERIFY( node.isAvailable() );
+  }
+
+  void cached_opensLazilyAfterNodeAppears()
+  {
+    const auto path = ( m_dir / "late" ).string();
+    SysfsNode< std::string > node( path, SysfsReadMode::Cached );
+    QVERIFY( !node.read().has_value() );
+
+    file( "late", "online\n" );
+    QCOMPARE( node.read(), std::optional< std::string >( "online" ) );
+  }
+
+  void cached_copyAndMove()
+  {
+    const auto path = file( "m", "42\n" );
+    SysfsNode< int32_t > node( path, SysfsReadMode::Cached );
+    QVERIFY( node.read().has_value() );
+
+    SysfsNode< int32_t > copy( node );
+    QCOMPARE( copy.mode(), SysfsReadMode::Cached );
+    QCOMPARE( copy.read(), std::optional< int32_t >( 42 ) );
+
+    std::vector< SysfsNode< int32_t > > nodes;
+    nodes.push_back( std::move( copy ) );
+    nodes.emplace_back( path );
+    QCOMPARE( nodes[ 0 ].read(), std::optional< int32_t >( 42 ) );
+    QCOMPARE( nodes[ 1 ].mode(), SysfsReadMode::Reopen );
+    QCOMPARE( node.read(), std::optional< int32_t >( 42 ) );
+  }
+
+  void write_roundTrip()
+  {
+    const auto path = file( "rw", "0\n" );
+    SysfsNode< std::vector< int32_t > > node( path );
+    QVERIFY( node.write( { 1, 2, 3 } ) );
+    QCOMPARE( node.read(), std::optional< std::vector< int32_t > >( { 1, 2, 3 } ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestSysfsNode )
+
+#include "test_sysfs_node.moc"
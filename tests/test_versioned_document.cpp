@@ -0,0 +1,92 @@
+/*
+ * Unit tests for VersionedDocument – content versions and lazy rebuilds
+ * behind the Get*JSONIfChanged methods.
+ */
+
+#include <QTest>
+#include "VersionedDocument.hpp"
+
+class TestVersionedDocument : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void initialContentHasAVersion()
+  {
+    VersionedDocument doc( "[]" );
+    QCOMPARE( doc.get(), std::string( "[]" ) );
+    QVERIFY( doc.version() != 0 );
+  }
+
+  void versionMovesOnlyOnChange()
+  {
+    VersionedDocument doc( "{}" );
+    const uint64_t v0 = doc.version();
+    doc = std::string( "{}" );
+    QCOMPARE( doc.version(), v0 );
+    doc = std::string( "{\"a\":1}" );
+    QVERIFY( doc.version() > v0 );
+  }
+
+  void versionsAreUniqueAcrossDocuments()
+  {
+    VersionedDocument a( "x" );
+    VersionedDocument b( "x" );
+    QVERIFY( a.version() != b.version() );
+  }
+
+  void builderRunsOnceAfterInvalidations()
+  {
+    int builds = 0;
+    std::string input = "1";
+    VersionedDocument doc;
+    doc.setBuilder( [&]() { ++builds; return input; } );
+    QCOMPARE( builds, 0 );
+
+    QCOMPARE( doc.get(), std::string( "1" ) );
+    QCOMPARE( doc.get(), std::string( "1" ) );
+    QCOMPARE( builds, 1 );
+
+    input = "2";
+    doc.invalidate();
+    doc.invalidate();
+    QCOMPARE( builds, 1 );
+    QCOMPARE( doc.get(), std::string( "2" ) );
+    QCOMPARE( builds, 2 );
+  }
+
+  void rebuildWithSameContentKeepsVersion()
+  {
+    VersionedDocument doc;
+    doc.setBuilder( []() { return std::string( "same" ); } );
+    const uint64_t v0 = doc.version();
+    doc.invalidate();
+    QCOMPARE( doc.version(), v0 );
+  }
+
+  void versionBuildsStaleContent()
+  {
+    std::string input = "a";
+    VersionedDocument doc;
+    doc.setBuilder( [&]() { return input; } );
+    const uint64_t v0 = doc.version();
+    input = "b";
+    doc.invalidate();
+    QVERIFY( doc.version() != v0 );
+    QCOMPARE( doc.get(), std::string( "b" ) );
+  }
+
+  void invalidateWithoutBuilderIsNoop()
+  {
+    VersionedDocument doc( "keep" );
+    const uint64_t v0 = doc.version();
+    doc.invalidate();
+    QCOMPARE( doc.get(), std::string( "keep" ) );
+    QCOMPARE( doc.version(), v0 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestVersionedDocument )
+
+#include "test_versioned_document.moc"
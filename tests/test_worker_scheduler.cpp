@@ -0,0 +1,245 @@
+/*
+ * Unit tests for the shared worker scheduler.
+ */
+
+#include <QTest>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include "WorkerScheduler.hpp"
+
+using namespace std::chrono_literals;
+
+class TestWorkerScheduler : public QObject
+{
+  Q_OBJECT
+
+private:
+  template< typename Pred >
+  static bool waitFor( Pred pred, std::chrono::milliseconds timeout = 1s )
+  {
+    const auto until = std::chrono::steady_clock::now() + timeout;
+    while ( !pred() )
+    {
+      if ( std::chrono::steady_clock::now() > until )
+        return false;
+      std::this_thread::sleep_for( 1ms );
+    }
+    return true;
+  }
+
+private slots:
+
+  void runsUntilCallbackFinishes()
+  {
+    WorkerScheduler scheduler( 2 );
+    std::atomic< int > runs { 0 };
+    std::promise< void > done;
+    const auto start = WorkerScheduler::Clock::now();
+    scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      if ( ++runs == 5 )
+      {
+        done.set_value();
+        return std::nullopt;
+      }
+      return 20ms;
+    } );
+
+    QVERIFY( done.get_future().wait_for( 2s ) == std::future_status::ready );
+    QVERIFY( WorkerScheduler::Clock::now() - start >= 80ms );
+    QVERIFY( waitFor( [&] { return scheduler.size() == size_t( 0 ); } ) );
+    std::this_thread::sleep_for( 50ms );
+    QCOMPARE( runs.load(), 5 );
+  }
+
+  void firstRunHonoursDeadline()
+  {
+    WorkerScheduler scheduler( 1 );
+    std::promise< WorkerScheduler::Clock::time_point > ran;
+    const auto due = WorkerScheduler::Clock::now() + 60ms;
+    scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      ran.set_value( WorkerScheduler::Clock::now() );
+      return std::nullopt;
+    }, due );
+
+    auto future = ran.get_future();
+    QVERIFY( future.wait_for( 2s ) == std::future_status::ready );
+    QVERIFY( future.get() >= due );
+  }
+
+  void wakeCutsLongSleepShort()
+  {
+    WorkerScheduler scheduler( 2 );
+    std::atomic< int > runs { 0 };
+    const auto id = scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      ++runs;
+      return 60s;
+    } );
+    QVERIFY( waitFor( [&] { return runs.load() == 1; } ) );
+
+    scheduler.wake( id );
+    QVERIFY( waitFor( [&] { return runs.load() == 2; }, 500ms ) );
+    scheduler.wake( id );
+    QVERIFY( waitFor( [&] { return runs.load() == 3; }, 500ms ) );
+  }
+
+  void wakeWhileRunningRerunsOnce()
+  {
+    WorkerScheduler scheduler( 2 );
+    std::atomic< int > runs { 0 };
+    std::promise< void > entered;
+    std::promise< void > release;
+    auto released = release.get_future().share();
+    WorkerScheduler::TaskId id = 0;
+    id = scheduler.add( [&, released]() -> std::optional< std::chrono::milliseconds > {
+      if ( ++runs == 1 )
+      {
+        entered.set_value();
+        released.wait();
+      }
+      return 60s;
+    } );
+
+    entered.get_future().wait();
+    scheduler.wake( id );
+    scheduler.wake( id );
+    release.set_value();
+    QVERIFY( waitFor( [&] { return runs.load() == 2; }, 500ms ) );
+    std::this_thread::sleep_for( 100ms );
+    QCOMPARE( runs.load(), 2 );
+  }
+
+  void periodExcludesRunTime()
+  {
+    WorkerScheduler scheduler( 1 );
+    std::vector< WorkerScheduler::Clock::time_point > starts;
+    std::promise< void > done;
+    scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      starts.push_back( WorkerScheduler::Clock::now() );
+      std::this_thread::sleep_for( 30ms );
+      if ( starts.size() == 10 )
+      {
+        done.set_value();
+        return std::nullopt;
+      }
+      return 50ms;
+    } );
+
+    QVERIFY( done.get_future().wait_for( 3s ) == std::future_status::ready );
+    // nine periods of 50 ms, not of 50 ms + 30 ms of work
+    const auto span = starts.back() - starts.front();
+    QVERIFY( span >= 450ms );
+    QVERIFY( span < 600ms );
+  }
+
+  void overrunDoesNotBurst()
+  {
+    WorkerScheduler scheduler( 1 );
+    std::vector< WorkerScheduler::Clock::time_point > starts;
+    std::promise< void > done;
+    scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      starts.push_back( WorkerScheduler::Clock::now() );
+      // the first run takes five periods
+      std::this_thread::sleep_for( starts.size() == 1 ? 100ms : 1ms );
+      if ( starts.size() == 3 )
+      {
+        done.set_value();
+        return std::nullopt;
+      }
+      return 20ms;
+    } );
+
+    QVERIFY( done.get_future().wait_for( 2s ) == std::future_status::ready );
+    // the late second run is not followed by catch-up runs
+    QVERIFY( starts[ 2 ] - starts[ 1 ] >= 15ms );
+  }
+
+  void taskNeverOverlapsItself()
+  {
+    WorkerScheduler scheduler( 3 );
+    std::atomic< int > active { 0 };
+    std::atomic< int > maxActive { 0 };
+    std::atomic< int > runs { 0 };
+    WorkerScheduler::TaskId id = 0;
+    id = scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      const int now = ++active;
+      maxActive = std::max( maxActive.load(), now );
+      std::this_thread::sleep_for( 5ms );
+      --active;
+      return ++runs < 20 ? std::optional( 0ms ) : std::nullopt;
+    } );
+    for ( int i = 0; i < 20; ++i )
+      scheduler.wake( id );
+
+    QVERIFY( waitFor( [&] { return scheduler.size() == size_t( 0 ); }, 2000ms ) );
+    QCOMPARE( maxActive.load(), 1 );
+  }
+
+  void tasksRunInParallelOnThePool()
+  {
+    WorkerScheduler scheduler( 2 );
+    std::promise< void > release;
+    auto released = release.get_future().share();
+    std::atomic< int > entered { 0 };
+    for ( int i = 0; i < 2; ++i )
+      scheduler.add( [&, released]() -> std::optional< std::chrono::milliseconds > {
+        ++entered;
+        released.wait();
+        return std::nullopt;
+      } );
+
+    // both block at once only if they run on different threads
+    QVERIFY( waitFor( [&] { return entered.load() == 2; }, 1000ms ) );
+    release.set_value();
+  }
+
+  void distantDeadlineBeyondOneRevolution()
+  {
+    WorkerScheduler scheduler( 1 );
+    std::atomic< int > runs { 0 };
+    const auto revolution = WorkerScheduler::TICK * WorkerScheduler::WHEEL_SLOTS;
+    // lands in the bucket of the current tick, one round later
+    scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      ++runs;
+      return std::nullopt;
+    }, WorkerScheduler::Clock::now() + revolution );
+
+    std::this_thread::sleep_for( 100ms );
+    QCOMPARE( runs.load(), 0 );
+    QCOMPARE( scheduler.size(), size_t( 1 ) );
+  }
+
+  void destructionIsImmediate()
+  {
+    const auto start = WorkerScheduler::Clock::now();
+    {
+      WorkerScheduler scheduler( 2 );
+      scheduler.add( []() -> std::optional< std::chrono::milliseconds > { return 60s; } );
+      std::this_thread::sleep_for( 20ms );
+    }
+    QVERIFY( WorkerScheduler::Clock::now() - start < 500ms );
+  }
+
+  void threadInitRunsOnEveryThreadFirst()
+  {
+    std::atomic< int > initialized { 0 };
+    std::atomic< int > seenAtRun { -1 };
+    std::promise< void > done;
+    WorkerScheduler scheduler( 2, [&initialized] { ++initialized; } );
+    scheduler.add( [&]() -> std::optional< std::chrono::milliseconds > {
+      seenAtRun = initialized.load();
+      done.set_value();
+      return std::nullopt;
+    } );
+    QVERIFY( done.get_future().wait_for( 1s ) == std::future_status::ready );
+    std::this_thread::sleep_for( 20ms );
+    // the dispatcher and both pool threads; the task ran after its thread's init
+    QCOMPARE( initialized.load(), 3 );
+    QVERIFY( seenAtRun.load() >= 1 );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestWorkerScheduler )
+
+#include "test_worker_scheduler.moc"
@@ -0,0 +1,114 @@
+/*
+ * Unit tests for WorkloadProfileSelector – exe and cgroup globs, rule
+ * order, immediate switching on exec and the release delay after exit.
+ */
+
+#include <QTest>
+#include <optional>
+#include <string>
+#include "WorkloadProfileSelector.hpp"
+
+namespace
+{
+std::optional< ProcessIdentity > process( std::string exe, std::string cgroup = "/user.slice" )
+{
+  return ProcessIdentity{ std::move( exe ), std::move( cgroup ) };
+}
+
+WorkloadProfileSelector selector()
+{
+  WorkloadProfileSelector s;
+  s.setRules( { { "", "*/app-steam-*.scope*", "gaming" },
+                { "/usr/bin/blender", "", "render" },
+                { "*/cc1*", "", "build" } } );
+  return s;
+}
+}
+
+class TestWorkloadProfileSelector : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void matchesExeAndCgroupGlobs()
+  {
+    const auto s = selector();
+    QVERIFY( s.match( *process( "/home/u/.steam/steamapps/common/Game/game.x86_64",
+                                "/user.slice/user-1000.slice/user@1000.service/app.slice/app-steam-1234.scope" ) ) == 0u );
+    QVERIFY( s.match( *process( "/usr/bin/blender" ) ) == 1u );
+    QVERIFY( s.match( *process( "/usr/libexec/gcc/x86_64-linux-gnu/13/cc1plus" ) ) == 2u );
+    QVERIFY( !s.match( *process( "/usr/bin/blender-thumbnailer" ) ) );
+    QVERIFY( !s.match( *process( "/usr/bin/bash" ) ) );
+
+    // a rule with both patterns needs both
+    WorkloadProfileSelector both;
+    both.setRules( { { "*/wine*", "*steam*", "gaming" } } );
+    QVERIFY( both.match( *process( "/usr/bin/wine64", "/app-steam-1.scope" ) ) );
+    QVERIFY( !both.match( *process( "/usr/bin/wine64" ) ) );
+  }
+
+  void switchesOnExecAndLingersAfterExit()
+  {
+    auto s = selector();
+    QCOMPARE( s.profile( 0 ), std::string() );
+
+    QVERIFY( s.exec( 100, process( "/usr/bin/blender" ), 1000 ) );
+    QCOMPARE( s.profile( 1000 ), std::string( "render" ) );
+
+    QVERIFY( s.exit( 100, 5000 ) );
+    QVERIFY( s.releaseAtMs() == 5000 + WorkloadProfileSelector::RELEASE_MS );
+    QCOMPARE( s.profile( 5000 + WorkloadProfileSelector::RELEASE_MS - 1 ), std::string( "render" ) );
+
+    // relaunched within the delay: no drop in between
+    QVERIFY( s.exec( 101, process( "/usr/bin/blender" ), 6000 ) );
+    QVERIFY( !s.releaseAtMs() );
+    QVERIFY( s.exit( 101, 7000 ) );
+    QCOMPARE( s.profile( 7000 + WorkloadProfileSelector::RELEASE_MS ), std::string() );
+
+    // unmatched processes are not tracked
+    QVERIFY( !s.exec( 102, process( "/usr/bin/bash" ), 8000 ) );
+    QVERIFY( !s.exec( 103, std::nullopt, 8000 ) );
+    QVERIFY( !s.exit( 102, 8000 ) );
+  }
+
+  void earlierRuleTakesOverAtOnceLaterOneWaits()
+  {
+    auto s = selector();
+    s.exec( 200, process( "/usr/libexec/gcc/cc1" ), 0 );
+    QCOMPARE( s.profile( 0 ), std::string( "build" ) );
+
+    s.exec( 201, process( "/usr/bin/blender" ), 100 );
+    QCOMPARE( s.profile( 100 ), std::string( "render" ) );
+
+    // blender quits while the build goes on: render is held, then build
+    s.exit( 201, 200 );
+    QCOMPARE( s.profile( 300 ), std::string( "render" ) );
+    QCOMPARE( s.profile( 200 + WorkloadProfileSelector::RELEASE_MS ), std::string( "build" ) );
+  }
+
+  void execOfAnotherBinaryDropsTheProcess()
+  {
+    auto s = selector();
+    s.exec( 300, process( "/usr/bin/blender" ), 0 );
+    QCOMPARE( s.profile( 0 ), std::string( "render" ) );
+
+    // the same pid execs something no rule matches
+    QVERIFY( s.exec( 300, process( "/usr/bin/python3" ), 1000 ) );
+    QCOMPARE( s.profile( 1000 + WorkloadProfileSelector::RELEASE_MS ), std::string() );
+  }
+
+  void newRulesStartOver()
+  {
+    auto s = selector();
+    s.exec( 400, process( "/usr/bin/blender" ), 0 );
+    QCOMPARE( s.profile( 0 ), std::string( "render" ) );
+
+    s.setRules( {} );
+    QCOMPARE( s.profile( 0 ), std::string() );
+    QVERIFY( !s.exec( 400, process( "/usr/bin/blender" ), 0 ) );
+  }
+};
+
+QTEST_GUILESS_MAIN( TestWorkloadProfileSelector )
+#include "test_workload_profile_selector.moc"
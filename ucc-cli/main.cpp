@@ -17,25 +17,45 @@
 
 #include "UccdClient.hpp"
 #include "CommonTypes.hpp"
+#include "FanCurveReplay.hpp"
+#include "HistoryExport.hpp"
+#include "SensorTrace.hpp"
 #include "version.h"
 
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QSettings>
 #include <QDir>
+#include <QFile>
 #include <QTimer>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 // ---------------------------------------------------------------------------
 // Helpers
 // ---------------------------------------------------------------------------
@@ -91,15 +111,16 @@ static void printVal( const char *label, const std::optional< std::string > &v )
     std::printf( "  %-24s n/a\n", label );
 }
 
-static void ok( bool success )
+/// Report a setter's result; returns the exit code
+static int ok( bool success )
 {
   if ( success )
-    std::puts( "OK" );
-  else
   {
-    std::fputs( "FAILED\n", stderr );
-    std::exit( 1 );
+    std::puts( "OK" );
+    return 0;
   }
+  std::fputs( "FAILED\n", stderr );
+  return 1;
 }
 
 static const char *tdpLabel( int idx )
@@ -398,22 +419,17 @@ static int cmdProfileList( ucc::UccdClient &c )
   LocalAssignments assignments = loadLocalAssignments();
 
   // Default (built-in) profiles from daemon
-  auto defJSON = c.getDefaultProfilesJSON();
-  if ( defJSON )
+  if ( auto defaults = c.getDefaultProfiles() )
   {
-    QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *defJSON ) );
-    if ( doc.isArray() )
+    std::puts( "Built-in profiles:" );
+    for ( const QJsonValue &v : *defaults )
     {
-      std::puts( "Built-in profiles:" );
-      for ( const QJsonValue &v : doc.array() )
+      if ( v.isObject() )
       {
-        if ( v.isObject() )
-        {
-          QJsonObject obj = v.toObject();
-          std::printf( "  %-36s  %s\n",
-                       obj["id"].toString().toStdString().c_str(),
-                       obj["name"].toString().toStdString().c_str() );
-        }
+        QJsonObject obj = v.toObject();
+        std::printf( "  %-36s  %s\n",
+                     obj["id"].toString().toStdString().c_str(),
+                     obj["name"].toString().toStdString().c_str() );
       }
     }
   }
@@ -425,15 +441,10 @@ static int cmdProfileList( ucc::UccdClient &c )
 
   // Also collect IDs from daemon custom list so we can merge without duplicates
   QSet<QString> daemonIds;
-  auto custJSON = c.getCustomProfilesJSON();
-  if ( custJSON )
-  {
-    QJsonDocument dd = QJsonDocument::fromJson( QByteArray::fromStdString( *custJSON ) );
-    if ( dd.isArray() )
-      for ( const QJsonValue &v : dd.array() )
-        if ( v.isObject() )
-          daemonIds.insert( v.toObject()["id"].toString() );
-  }
+  const QJsonArray daemonCustom = c.getCustomProfiles().value_or( QJsonArray() );
+  for ( const QJsonValue &v : daemonCustom )
+    if ( v.isObject() )
+      daemonIds.insert( v.toObject()["id"].toString() );
 
   // Collect all custom profiles: start from uccrc, then add any daemon-only ones
   QList<QJsonObject> customProfiles;
@@ -451,14 +462,9 @@ static int cmdProfileList( ucc::UccdClient &c )
     }
   }
   // Daemon-only entries not in uccrc
-  if ( custJSON )
-  {
-    QJsonDocument dd = QJsonDocument::fromJson( QByteArray::fromStdString( *custJSON ) );
-    if ( dd.isArray() )
-      for ( const QJsonValue &v : dd.array() )
-        if ( v.isObject() && !shownIds.contains( v.toObject()["id"].toString() ) )
-          customProfiles.append( v.toObject() );
-  }
+  for ( const QJsonValue &v : daemonCustom )
+    if ( v.isObject() && !shownIds.contains( v.toObject()["id"].toString() ) )
+      customProfiles.append( v.toObject() );
 
   if ( !customProfiles.isEmpty() )
   {
@@ -476,9 +482,10 @@ static int cmdProfileList( ucc::UccdClient &c )
   }
 
   // Active profile
-  auto active = c.getActiveProfileJSON();
-  if ( active )
-    std::printf( "\nActive: %s (%s)\n", profileName( *active ).c_str(), profileId( *active ).c_str() );
+  if ( auto active = c.getActiveProfile() )
+    std::printf( "\nActive: %s (%s)\n",
+                 ( *active )["name"].toString().toStdString().c_str(),
+                 ( *active )["id"].toString().toStdString().c_str() );
 
   return 0;
 }
@@ -510,8 +517,16 @@ static void printProfileSummary( const QJsonObject &obj, bool showHeader = true
     QString epp = cpu["energyPerformancePreference"].toString();
     if ( !epp.isEmpty() )
       std::printf( "    %-22s %s\n", "EPP:", epp.toStdString().c_str() );
+    QStringList eppLevels;
+    for ( const auto &level : cpu["adaptiveEpp"].toArray() )
+      eppLevels << level.toString();
+    if ( !eppLevels.isEmpty() )
+      std::printf( "    %-22s %s\n", "Adaptive EPP:", eppLevels.join( " -> " ).toStdString().c_str() );
     std::printf( "    %-22s %d\n", "Online cores:", cpu["onlineCores"].toInt() );
     std::printf( "    %-22s %s\n", "No turbo:", cpu["noTurbo"].toBool() ? "yes" : "no" );
+    QString parking = cpu["coreParking"].toString();
+    if ( !parking.isEmpty() )
+      std::printf( "    %-22s %s\n", "Core parking:", parking.toStdString().c_str() );
     int minFreq = cpu["scalingMinFrequency"].toInt();
     int maxFreq = cpu["scalingMaxFrequency"].toInt();
     if ( minFreq > 0 )
@@ -580,6 +595,11 @@ static void printProfileSummary( const QJsonObject &obj, bool showHeader = true
       for ( int i = 0; i < tdp.size(); ++i )
         std::printf( "    %-22s %d W\n", tdpLabel( i ), tdp[i].toInt() );
     }
+    if ( const QJsonObject c = odm["controller"].toObject(); c["mode"].toString() == "dynamic" )
+      std::printf( "  %-24s dynamic, target %d °C, fan limit %d %%, floor %d %%\n", "ODM power mode:",
+                   c["targetTemp"].toInt(), c["fanDutyLimit"].toInt(), c["floorPercent"].toInt() );
+    if ( const int share = odm["controller"].toObject()["gpuShareWatts"].toInt(); share > 0 )
+      std::printf( "  %-24s up to %d W between CPU and GPU\n", "Shared power budget:", share );
   }
 
   // NVIDIA cTGP (from embedded GPU OC profile data)
@@ -620,43 +640,30 @@ static void printProfileSummary( const QJsonObject &obj, bool showHeader = true
 
 static int cmdProfileGet( ucc::UccdClient &c )
 {
-  auto json = c.getActiveProfileJSON();
-  if ( !json )
+  auto active = c.getActiveProfile();
+  if ( !active )
   {
     std::fputs( "Error: Could not retrieve active profile\n", stderr );
     return 1;
   }
-  QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) );
-  if ( !doc.isObject() )
-  {
-    std::puts( json->c_str() );
-    return 0;
-  }
-  printProfileSummary( doc.object() );
+  printProfileSummary( *active );
   return 0;
 }
 
 static int cmdProfileSet( ucc::UccdClient &c, const char *profileId )
 {
-  ok( c.setActiveProfile( profileId ) );
-  return 0;
+  return ok( c.setActiveProfile( profileId ) );
 }
 
 static int cmdProfileGetDefault( ucc::UccdClient &c )
 {
-  auto json = c.getDefaultProfilesJSON();
-  if ( !json )
+  auto profiles = c.getDefaultProfiles();
+  if ( !profiles )
   {
     std::fputs( "Error: Could not retrieve default profiles\n", stderr );
     return 1;
   }
-  QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) );
-  if ( !doc.isArray() )
-  {
-    std::puts( json->c_str() );
-    return 0;
-  }
-  QJsonArray arr = doc.array();
+  const QJsonArray &arr = *profiles;
   std::printf( "Built-in profiles (%d):\n", (int)arr.size() );
   for ( int i = 0; i < arr.size(); ++i )
   {
@@ -671,19 +678,18 @@ static int cmdProfileGetDefault( ucc::UccdClient &c )
 
 static int cmdProfileGetCustom( ucc::UccdClient &c )
 {
-  auto json = c.getCustomProfilesJSON();
-  if ( !json )
+  auto profiles = c.getCustomProfiles();
+  if ( !profiles )
   {
     std::fputs( "Error: Could not retrieve custom profiles\n", stderr );
     return 1;
   }
-  QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) );
-  if ( !doc.isArray() || doc.array().isEmpty() )
+  if ( profiles->isEmpty() )
   {
     std::puts( "No custom profiles." );
     return 0;
   }
-  QJsonArray arr = doc.array();
+  const QJsonArray &arr = *profiles;
   std::printf( "Custom profiles (%d):\n", (int)arr.size() );
   for ( int i = 0; i < arr.size(); ++i )
   {
@@ -698,20 +704,17 @@ static int cmdProfileGetCustom( ucc::UccdClient &c )
 
 static int cmdProfileApply( ucc::UccdClient &c, const char *jsonStr )
 {
-  ok( c.applyProfile( jsonStr ) );
-  return 0;
+  return ok( c.applyProfile( jsonStr ) );
 }
 
 static int cmdProfileSave( ucc::UccdClient &c, const char *jsonStr )
 {
-  ok( c.saveCustomProfile( jsonStr ) );
-  return 0;
+  return ok( c.saveCustomProfile( jsonStr ) );
 }
 
 static int cmdProfileDelete( ucc::UccdClient &c, const char *id )
 {
-  ok( c.deleteCustomProfile( id ) );
-  return 0;
+  return ok( c.deleteCustomProfile( id ) );
 }
 
 // --- Fan ---
@@ -868,14 +871,12 @@ static int cmdFanGet( ucc::UccdClient &c, const char *fanProfileId )
 static int cmdFanApply( ucc::UccdClient &c, const char *jsonStr )
 {
   // The apply method expects keys: cpu, gpu, pump, waterCoolerFan
-  ok( c.applyFanProfiles( jsonStr ) );
-  return 0;
+  return ok( c.applyFanProfiles( jsonStr ) );
 }
 
 static int cmdFanRevert( ucc::UccdClient &c )
 {
-  ok( c.revertFanProfiles() );
-  return 0;
+  return ok( c.revertFanProfiles() );
 }
 
 /// Activate a fan profile by ID: fetch its curves, remap keys, and apply.
@@ -936,13 +937,53 @@ static int cmdFanSet( ucc::UccdClient &c, const char *fanProfileId )
   if ( src.contains( "waterCoolerFan" ) ) dst["waterCoolerFan"] = src["waterCoolerFan"];
 
   std::string applyJson = QJsonDocument( dst ).toJson( QJsonDocument::Compact ).toStdString();
-  ok( c.applyFanProfiles( applyJson ) );
-  return 0;
+  return ok( c.applyFanProfiles( applyJson ) );
 }
 
 // --- Dashboard / Monitor ---
 
-static int cmdMonitor( ucc::UccdClient &c, int count, int interval )
+// Daemon metrics in MetricId order (uccd/inc/MetricsHistoryStore.hpp); key is metricName()
+struct MetricRow { const char *key; const char *label; const char *unit; };
+static const MetricRow kMetricRows[] = {
+  { "cpuTemp",          "CPU temp",      "°C"  },
+  { "cpuFanDuty",       "CPU fan",       "%"   },
+  { "cpuPower",         "CPU power",     "W"   },
+  { "cpuFrequency",     "CPU freq",      "MHz" },
+  { "gpuTemp",          "GPU temp",      "°C"  },
+  { "gpuFanDuty",       "GPU fan",       "%"   },
+  { "gpuPower",         "GPU power",     "W"   },
+  { "gpuFrequency",     "GPU freq",      "MHz" },
+  { "gpuVramFrequency", "GPU VRAM freq", "MHz" },
+  { "gpuCoreVoltage",   "GPU voltage",   "mV"  },
+  { "gpu2Temp",         "GPU 2 temp",    "°C"  },
+  { "gpu2Power",        "GPU 2 power",   "W"   },
+  { "gpu2Frequency",    "GPU 2 freq",    "MHz" },
+  { "gpuComputeUtil",   "GPU util",      "%"   },
+  { "gpuMemoryUtil",    "GPU mem util",  "%"   },
+  { "cpuPowerCore",     "Core power",    "W"   },
+  { "cpuPowerUncore",   "Uncore power",  "W"   },
+  { "cpuPowerDram",     "DRAM power",    "W"   },
+  { "cpuPowerPsys",     "Psys power",    "W"   },
+  { "cpuFrequencyMax",  "CPU max freq",  "MHz" },
+  { "cpuFrequencyPCore", "P-core freq",  "MHz" },
+  { "cpuFrequencyECore", "E-core freq",  "MHz" },
+  { "cpuThrottleCore",  "Core throttle", "%"   },
+  { "cpuThrottlePackage", "Pkg throttle", "%"  },
+  { "cpuPowerLimited",  "Power limited", "%"   },
+  { "cpuPkgCstate",     "Pkg C-state",   "%"   },
+  { "wcFanDuty",        "WC fan",        "%"   },
+  { "wcPumpLevel",      "WC pump",       "%"   },
+  { "wcRssi",           "WC RSSI",       "dBm" },
+  { "wcLatency",        "WC latency",    "ms"  },
+  { "batPower",         "Bat power",     "W"   },
+  { "batVoltage",       "Bat voltage",   "V"   },
+  { "batEnergy",        "Bat energy",    "Wh"  },
+  { "batCapacity",      "Bat charge",    "%"   },
+  { "batTimeToEmpty",   "Bat runtime",   "min" },
+  { "systemPowerOnBattery", "System power", "W" },
+};
+
+static int cmdMonitor( ucc::UccdClient &c, int count, int intervalMs )
 {
   // If count == 0, run indefinitely
   int remaining = count;
@@ -954,7 +995,7 @@ static int cmdMonitor( ucc::UccdClient &c, int count, int interval )
     {
       // Use QCoreApplication event loop for timer
       QEventLoop loop;
-      QTimer::singleShot( interval * 1000, &loop, &QEventLoop::quit );
+      QTimer::singleShot( intervalMs, &loop, &QEventLoop::quit );
       loop.exec();
     }
     first = false;
@@ -983,208 +1024,1177 @@ static int cmdMonitor( ucc::UccdClient &c, int count, int interval )
   return 0;
 }
 
-// --- Keyboard ---
+// Snapshot readings outside the MetricId set: per-fan RPM, iGPU and extended NVML fields
+struct SnapshotField { const char *key; std::optional< int > ucc::LiveSnapshot::*value; };
+static const SnapshotField kSnapshotFields[] = {
+  { "cpuFanRpm",         &ucc::LiveSnapshot::cpuFanRPM },
+  { "gpuFanRpm",         &ucc::LiveSnapshot::gpuFanRPM },
+  { "iGpuTemp",          &ucc::LiveSnapshot::iGpuTemp },
+  { "iGpuFrequency",     &ucc::LiveSnapshot::iGpuFrequencyMHz },
+  { "gpuEncoderUtil",    &ucc::LiveSnapshot::dGpuEncoderUtilPct },
+  { "gpuDecoderUtil",    &ucc::LiveSnapshot::dGpuDecoderUtilPct },
+  { "gpuPstate",         &ucc::LiveSnapshot::dGpuCurrentPstate },
+  { "gpuVramUsed",       &ucc::LiveSnapshot::dGpuVramUsedMiB },
+  { "gpuVramTotal",      &ucc::LiveSnapshot::dGpuVramTotalMiB },
+  { "gpuGrClockOffset",  &ucc::LiveSnapshot::dGpuGrClockOffsetMHz },
+  { "gpuMemClockOffset", &ucc::LiveSnapshot::dGpuMemClockOffsetMHz },
+};
 
-static int cmdKeyboardInfo( ucc::UccdClient &c )
+/**
+ * Stream every daemon metric as NDJSON or CSV, one row per sample.
+ *
+ * Rows come from the daemon's MetricsSample push, so the daemon does no
+ * work for this reader beyond emitting the signal it already builds each
+ * tick; intervals below one second additionally request fast sampling.
+ * Daemons without the push are read from the shared-memory live segment
+ * on a local timer instead.  Metrics without a sample are null (NDJSON)
+ * or empty (CSV).  @p extended adds the kSnapshotFields from one
+ * GetLiveSnapshot call per row.
+ */
+static int cmdMonitorStream( ucc::UccdClient &c, int count, int intervalMs, bool csv, bool extended )
 {
-  auto info = c.getKeyboardBacklightInfo();
-  if ( !info )
+  constexpr qsizetype metricCount = static_cast< qsizetype >( std::size( kMetricRows ) );
+
+  if ( csv )
   {
-    std::fputs( "Error: Could not retrieve keyboard backlight info\n", stderr );
-    return 1;
+    std::fputs( "timestampMs", stdout );
+    for ( const auto &row : kMetricRows )
+      std::printf( ",%s", row.key );
+    if ( extended )
+      for ( const auto &field : kSnapshotFields )
+        std::printf( ",%s", field.key );
+    std::putchar( '\n' );
+    std::fflush( stdout );
   }
-  QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *info ) );
-  if ( !doc.isObject() )
+
+  QEventLoop loop;
+  int remaining = count;
+  qint64 lastRowMs = -1;
+
+  auto printValue = [csv]( const char *key, std::optional< double > value ) {
+    if ( csv )
+      std::putchar( ',' );
+    else
+      std::printf( ",\"%s\":", key );
+    if ( value && std::isfinite( *value ) )
+      std::printf( "%.10g", *value );
+    else if ( !csv )
+      std::fputs( "null", stdout );
+  };
+
+  auto printRow = [&]( qint64 timestampMs, const QList< double > &values ) {
+    // daemon ticks jitter around the interval; don't drop every other one
+    if ( lastRowMs >= 0 && timestampMs - lastRowMs < intervalMs - intervalMs / 4 )
+      return;
+    lastRowMs = timestampMs;
+
+    std::printf( csv ? "%lld" : "{\"t\":%lld", static_cast< long long >( timestampMs ) );
+    for ( qsizetype i = 0; i < metricCount; ++i )
+      printValue( kMetricRows[ i ].key, i < values.size() ? std::optional< double >( values[ i ] ) : std::nullopt );
+    if ( extended )
+    {
+      const auto snapshot = c.getLiveSnapshot();
+      for ( const auto &field : kSnapshotFields )
+      {
+        const std::optional< int > value = snapshot ? ( *snapshot ).*field.value : std::nullopt;
+        printValue( field.key, value ? std::optional< double >( *value ) : std::nullopt );
+      }
+    }
+    std::fputs( csv ? "\n" : "}\n", stdout );
+    std::fflush( stdout );
+
+    if ( count > 0 && --remaining == 0 )
+      loop.quit();
+  };
+
+  const bool fast = intervalMs < 1000;
+  if ( c.setMetricsSamplesEnabled( true ) )
   {
-    std::puts( info->c_str() );
+    QObject::connect( &c, &ucc::UccdClient::metricsSample, &loop, printRow );
+    if ( fast )
+      c.setFastSamplingEnabled( true );
+    loop.exec();
+    c.setFastSamplingEnabled( false );
+    c.setMetricsSamplesEnabled( false );
     return 0;
   }
-  QJsonObject obj = doc.object();
-  std::puts( "=== Keyboard Backlight ===" );
-  std::printf( "  %-24s %d\n",  "Zones:", obj["zones"].toInt() );
-  std::printf( "  %-24s %d\n",  "Max brightness:", obj["maxBrightness"].toInt() );
-  std::printf( "  %-24s %d\n",  "Max red:", obj["maxRed"].toInt() );
-  std::printf( "  %-24s %d\n",  "Max green:", obj["maxGreen"].toInt() );
-  std::printf( "  %-24s %d\n",  "Max blue:", obj["maxBlue"].toInt() );
-  if ( obj.contains( "modes" ) && obj["modes"].isArray() )
-  {
-    QJsonArray modes = obj["modes"].toArray();
-    std::string mstr;
-    for ( int i = 0; i < modes.size(); ++i )
+
+  // older daemon: read the live segment locally, no D-Bus call per row
+  if ( fast )
+    c.setFastSamplingEnabled( true );
+  bool anyValue = false;
+  QTimer timer;
+  QObject::connect( &timer, &QTimer::timeout, &loop, [&]() {
+    QList< double > values;
+    values.reserve( metricCount );
+    for ( qsizetype i = 0; i < metricCount; ++i )
     {
-      if ( i > 0 ) mstr += ", ";
-      int m = modes[i].toInt();
-      switch ( m )
+      const auto value = c.readLiveMetric( static_cast< int >( i ) );
+      anyValue = anyValue || value.has_value();
+      values.append( value.value_or( std::numeric_limits< double >::quiet_NaN() ) );
+    }
+    if ( !anyValue )
+    {
+      std::fputs( "Error: The daemon provides neither metric samples nor live metrics\n", stderr );
+      loop.exit( 1 );
+      return;
+    }
+    printRow( QDateTime::currentMSecsSinceEpoch(), values );
+  } );
+  timer.start( intervalMs );
+  const int rc = loop.exec();
+  c.setFastSamplingEnabled( false );
+  return rc;
+}
+
+// --- Sensor traces ---
+
+static volatile std::sig_atomic_t g_interrupted = 0;
+
+/**
+ * Record every daemon metric per sample into a SensorTrace file until
+ * @p durationS passed (0 = until Ctrl+C), then append the events the
+ * daemon logged meanwhile.  Samples come from the MetricsSample push.
+ */
+static int cmdRecord( ucc::UccdClient &c, const char *path, int durationS, int intervalMs )
+{
+  std::vector< std::string > names;
+  for ( const auto &row : kMetricRows )
+    names.emplace_back( row.key );
+
+  ucc::SensorTraceWriter writer;
+  if ( !writer.open( path, names ) )
+  {
+    std::fprintf( stderr, "Error: Cannot write %s\n", path );
+    return 1;
+  }
+  if ( !c.setMetricsSamplesEnabled( true ) )
+  {
+    std::fputs( "Error: The daemon does not push metric samples\n", stderr );
+    return 1;
+  }
+  const bool fast = intervalMs < 1000;
+  if ( fast )
+    c.setFastSamplingEnabled( true );
+
+  QEventLoop loop;
+  const qint64 startMs = QDateTime::currentMSecsSinceEpoch();
+  qint64 lastMs = -1;
+  size_t samples = 0;
+  QObject::connect( &c, &ucc::UccdClient::metricsSample, &loop,
+                    [&]( qint64 timestampMs, const QList< double > &values ) {
+    if ( lastMs >= 0 && timestampMs - lastMs < intervalMs - intervalMs / 4 )
+      return;
+    lastMs = timestampMs;
+    writer.sample( timestampMs, values );
+    writer.flush();
+    ++samples;
+  } );
+
+  if ( durationS > 0 )
+    QTimer::singleShot( durationS * 1000, &loop, &QEventLoop::quit );
+
+  // Ctrl+C ends the recording normally, so the events still get appended
+  std::signal( SIGINT, []( int ) { g_interrupted = 1; } );
+  QTimer interruptPoll;
+  QObject::connect( &interruptPoll, &QTimer::timeout, &loop, [&loop]() {
+    if ( g_interrupted )
+      loop.quit();
+  } );
+  interruptPoll.start( 200 );
+
+  std::fprintf( stderr, "Recording to %s%s\n", path, durationS > 0 ? "" : " (Ctrl+C to stop)" );
+  loop.exec();
+  std::signal( SIGINT, SIG_DFL );
+
+  if ( fast )
+    c.setFastSamplingEnabled( false );
+  c.setMetricsSamplesEnabled( false );
+
+  size_t events = 0;
+  if ( const auto blob = c.getMonitorDataSince( startMs ) )
+    ucc::decodeMetricEvents( reinterpret_cast< const uint8_t * >( blob->constData() ),
+                             static_cast< size_t >( blob->size() ), [&]( const ucc::MetricEventRecord &event ) {
+      if ( event.timestampMs >= startMs )
       {
-        case 0: mstr += "static"; break;
-        case 1: mstr += "breathe"; break;
-        case 2: mstr += "colorful"; break;
-        case 3: mstr += "breathe-color"; break;
-        default: mstr += std::to_string( m ); break;
+        writer.event( event );
+        ++events;
       }
-    }
-    std::printf( "  %-24s %s\n", "Modes:", mstr.c_str() );
+    } );
+  if ( !writer.flush() )
+  {
+    std::fprintf( stderr, "Error: Writing %s failed\n", path );
+    return 1;
   }
+
+  std::fprintf( stderr, "Recorded %zu samples and %zu events over %.0f s\n", samples, events,
+                static_cast< double >( QDateTime::currentMSecsSinceEpoch() - startMs ) / 1000.0 );
   return 0;
 }
 
-static int cmdKeyboardGet( ucc::UccdClient &c )
+/**
+ * Write the daemon's history since @p sinceMs, with its events, to
+ * @p path.  The history is fetched in pages of EXPORT_PAGE_ROWS rows and
+ * each page is written before the next is requested, so memory stays
+ * bounded however long the history is.
+ */
+static int cmdExport( ucc::UccdClient &c, const char *path, ucc::HistoryExportFormat format, qint64 sinceMs )
 {
-  auto states = c.getKeyboardBacklightStates();
-  if ( !states )
+  static constexpr int EXPORT_PAGE_ROWS = 4096;
+
+  const auto catalog = c.getMetricCatalog();
+  if ( !catalog )
   {
-    std::fputs( "Error: Could not retrieve keyboard backlight states\n", stderr );
+    std::fputs( "Error: Cannot read the daemon's metric catalog\n", stderr );
     return 1;
   }
-  QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *states ) );
-  if ( !doc.isObject() )
+  std::vector< std::string > names;
+  uint64_t mask = 0;
+  for ( const QJsonValue &v : QJsonDocument::fromJson( QByteArray::fromStdString( *catalog ) ).array() )
   {
-    std::puts( states->c_str() );
-    return 0;
+    const int id = v["id"].toInt( -1 );
+    if ( id < 0 || id >= 64 )
+      continue;
+    if ( names.size() <= static_cast< size_t >( id ) )
+      names.resize( static_cast< size_t >( id ) + 1 );
+    names[ static_cast< size_t >( id ) ] = v["key"].toString().toStdString();
+    if ( v["present"].toBool() )
+      mask |= uint64_t( 1 ) << id;
   }
-  QJsonObject root = doc.object();
-  int brightness = root["brightness"].toInt();
-  QJsonArray arr = root["states"].toArray();
 
-  std::puts( "=== Keyboard Backlight State ===" );
-  std::printf( "  %-24s %d\n", "Global brightness:", brightness );
-  std::printf( "  %-24s %d\n", "Zones:", (int)arr.size() );
+  std::vector< ucc::MetricEventRecord > events;
+  if ( const auto blob = c.getMonitorEventsSince( sinceMs ) )
+    ucc::decodeMetricEvents( reinterpret_cast< const uint8_t * >( blob->constData() ),
+                             static_cast< size_t >( blob->size() ),
+                             [&events]( const ucc::MetricEventRecord &event ) { events.push_back( event ); } );
 
-  if ( arr.isEmpty() )
-    return 0;
+  std::ofstream out( path, std::ios::binary | std::ios::trunc );
+  if ( !out )
+  {
+    std::fprintf( stderr, "Error: Cannot write %s\n", path );
+    return 1;
+  }
+  ucc::CsvHistoryWriter csv( out );
+  ucc::ParquetHistoryWriter parquet( out );
+  ucc::HistoryExportWriter &writer = format == ucc::HistoryExportFormat::Parquet
+                                       ? static_cast< ucc::HistoryExportWriter & >( parquet ) : csv;
+  ucc::HistoryExporter exporter( writer, mask, names, std::move( events ) );
 
-  // Check if all zones are uniform
-  QJsonObject first = arr[0].toObject();
-  bool uniform = true;
-  for ( int i = 1; i < arr.size(); ++i )
+  for ( qint64 since = sinceMs;; )
   {
-    QJsonObject z = arr[i].toObject();
-    if ( z["red"].toInt() != first["red"].toInt() ||
-         z["green"].toInt() != first["green"].toInt() ||
-         z["blue"].toInt() != first["blue"].toInt() ||
-         z["mode"].toInt() != first["mode"].toInt() ||
-         z["brightness"].toInt() != first["brightness"].toInt() )
+    const auto page = c.getMonitorFramesPage( since, mask, EXPORT_PAGE_ROWS );
+    if ( !page )
     {
-      uniform = false;
-      break;
+      std::fputs( "Error: The daemon does not serve history pages\n", stderr );
+      return 1;
     }
+    const auto last = exporter.addPage( reinterpret_cast< const uint8_t * >( page->constData() ),
+                                        static_cast< size_t >( page->size() ) );
+    if ( !last )
+      break;
+    since = *last + 1;
   }
 
-  if ( uniform )
-  {
-    std::printf( "  %-24s uniform\n", "Pattern:" );
-    std::printf( "  %-24s rgb(%d, %d, %d)\n", "Color:",
-                 first["red"].toInt(), first["green"].toInt(), first["blue"].toInt() );
-    std::printf( "  %-24s %d\n", "Zone brightness:", first["brightness"].toInt() );
-    int m = first["mode"].toInt();
-    const char *modeName = m == 0 ? "static" : m == 1 ? "breathe" :
-                           m == 2 ? "colorful" : m == 3 ? "breathe-color" : "unknown";
-    std::printf( "  %-24s %s\n", "Mode:", modeName );
-  }
-  else
+  if ( !exporter.finish() )
   {
-    // Print a compact table for differing zones
-    std::puts( "" );
-    std::printf( "  %-6s %-6s %-14s %-12s %s\n", "Zone", "Mode", "Color", "Brightness", "" );
-    std::printf( "  %-6s %-6s %-14s %-12s %s\n", "----", "----", "-----------", "----------", "" );
-    for ( int i = 0; i < arr.size(); ++i )
-    {
-      QJsonObject z = arr[i].toObject();
-      int m = z["mode"].toInt();
-      const char *modeName = m == 0 ? "static" : m == 1 ? "breathe" :
-                             m == 2 ? "color" : m == 3 ? "br-color" : "?";
-      char color[32];
-      std::snprintf( color, sizeof(color), "(%d,%d,%d)",
-                     z["red"].toInt(), z["green"].toInt(), z["blue"].toInt() );
-      std::printf( "  %-6d %-6s %-14s %-12d\n", i + 1, modeName, color, z["brightness"].toInt() );
-    }
+    std::fprintf( stderr, "Error: Writing %s failed\n", path );
+    return 1;
   }
+  std::fprintf( stderr, "Exported %zu rows and %zu events to %s\n", exporter.rows(), exporter.eventsWritten(), path );
   return 0;
 }
 
-static int cmdKeyboardSet( ucc::UccdClient &c, const char *jsonStr )
+/// Fan profile from a fan profile JSON object ("fan get" format); nullopt without a CPU table
+static std::optional< FanProfile > fanProfileFromJson( const QJsonObject &obj )
+{
+  const auto table = []( const QJsonValue &value ) {
+    std::vector< FanTableEntry > entries;
+    for ( const QJsonValue &v : value.toArray() )
+      entries.emplace_back( v["temp"].toInt(), v["speed"].toInt() );
+    return entries;
+  };
+
+  FanProfile profile( obj["id"].toString().toStdString(), obj["name"].toString().toStdString() );
+  profile.tableCPU = table( obj["tableCPU"] );
+  profile.tableGPU = table( obj["tableGPU"] );
+  if ( profile.tableCPU.empty() )
+    return std::nullopt;
+  if ( profile.tableGPU.empty() )
+    profile.tableGPU = profile.tableCPU;
+
+  const QJsonObject c = obj["controller"].toObject();
+  FanControllerSettings &controller = profile.controller;
+  controller.mode = FanControllerSettings::parseMode( c["mode"].toString( "curve" ).toStdString() )
+                      .value_or( FanControlMode::Curve );
+  controller.targetTemp = c["targetTemp"].toInt( controller.targetTemp );
+  controller.kp = c["kp"].toDouble( controller.kp );
+  controller.ki = c["ki"].toDouble( controller.ki );
+  controller.kd = c["kd"].toDouble( controller.kd );
+  controller.feedForwardPerWatt = c["feedForwardPerWatt"].toDouble( controller.feedForwardPerWatt );
+  controller.idleWatts = c["idleWatts"].toDouble( controller.idleWatts );
+  controller.preRampDegPerWatt = c["preRampDegPerWatt"].toDouble( controller.preRampDegPerWatt );
+  controller.preRampMaxDeg = c["preRampMaxDeg"].toInt( controller.preRampMaxDeg );
+  return profile;
+}
+
+static QJsonObject replayStatsJson( const FanReplayStats &s )
+{
+  QJsonObject o;
+  o["avgDuty"] = s.avgDuty;
+  o["maxDuty"] = s.maxDuty;
+  o["noiseDb"] = s.noiseDb;
+  o["steps"] = s.steps;
+  o["maxTemp"] = s.maxTemp;
+  o["secondsAbove"] = s.secondsAbove;
+  return o;
+}
+
+/**
+ * Replay a recorded trace through FanCurveReplay for each candidate fan
+ * profile.  A candidate is a JSON file in "fan get" format or, failing
+ * that, a fan profile ID fetched from the daemon.
+ */
+static int cmdReplay( const char *path, const std::vector< const char * > &candidates,
+                      const FanReplayOptions &options, bool jsonMode )
 {
-  ok( c.setKeyboardBacklight( jsonStr ) );
-  return 0;
-}
+  const auto trace = ucc::SensorTrace::load( path );
+  if ( !trace )
+  {
+    std::fprintf( stderr, "Error: %s is not a sensor trace\n", path );
+    return 1;
+  }
 
-/// List custom keyboard profiles from local settings.
-static int cmdKeyboardProfileList()
-{
-  LocalAssignments assignments = loadLocalAssignments();
+  std::vector< std::pair< QString, FanReplayResult > > results;
+  results.emplace_back( "recorded", FanCurveReplay::recorded( *trace, options ) );
 
-  QSettings settings = localSettings();
-  QByteArray customKP = settings.value( "customKeyboardProfiles", "[]" ).toByteArray();
-  if ( customKP.isEmpty() || customKP == "[]" )
+  std::unique_ptr< ucc::UccdClient > client;
+  for ( const char *candidate : candidates )
   {
-    std::puts( "No custom keyboard profiles found." );
-    return 0;
+    QByteArray json;
+    if ( QFile file( QString::fromLocal8Bit( candidate ) ); file.open( QIODevice::ReadOnly ) )
+      json = file.readAll();
+    else
+    {
+      if ( !client )
+        client = std::make_unique< ucc::UccdClient >();
+      if ( const auto fetched = client->getFanProfile( candidate ) )
+        json = QByteArray::fromStdString( *fetched );
+    }
+
+    const auto profile = fanProfileFromJson( QJsonDocument::fromJson( json ).object() );
+    if ( !profile )
+    {
+      std::fprintf( stderr, "Error: No fan curve in '%s' (expected a fan profile file or ID)\n", candidate );
+      return 1;
+    }
+    const QString name = QString::fromStdString( profile->name.empty() ? candidate : profile->name );
+    results.emplace_back( name, FanCurveReplay::simulate( *trace, *profile, options ) );
   }
-  QJsonDocument doc = QJsonDocument::fromJson( customKP );
-  if ( !doc.isArray() || doc.array().isEmpty() )
+
+  if ( jsonMode )
   {
-    std::puts( "No custom keyboard profiles found." );
+    QJsonArray rows;
+    for ( const auto &[ name, result ] : results )
+    {
+      QJsonObject o;
+      o["name"] = name;
+      if ( result.cpu.available )
+        o["cpu"] = replayStatsJson( result.cpu );
+      if ( result.gpu.available )
+        o["gpu"] = replayStatsJson( result.gpu );
+      rows.append( o );
+    }
+    QJsonObject root;
+    root["seconds"] = results.front().second.seconds;
+    root["samples"] = static_cast< qint64 >( trace->samples() );
+    root["events"] = static_cast< qint64 >( trace->events.size() );
+    root["results"] = rows;
+    std::puts( QJsonDocument( root ).toJson( QJsonDocument::Compact ).constData() );
     return 0;
   }
-  std::puts( "Keyboard profiles:" );
-  for ( const QJsonValue &v : doc.array() )
+
+  std::printf( "=== Replay of %s (%.0f s, %zu samples, %zu events) ===\n", path, results.front().second.seconds,
+               trace->samples(), trace->events.size() );
+  std::printf( "  Above %.0f °C; thermal model %.2f °C per %% duty, tau %.0f s\n\n", options.thresholdC,
+               options.thermalGainCPerPct, options.thermalTauS );
+  std::printf( "  %-24s %-4s %9s %5s %9s %6s %9s %8s\n", "Curve", "Fan", "Avg duty", "Max", "Noise", "Steps",
+               "Max temp", "Above" );
+  for ( const auto &[ name, result ] : results )
   {
-    if ( v.isObject() )
+    bool first = true;
+    for ( const auto &[ fan, s ] : { std::pair{ "CPU", result.cpu }, std::pair{ "GPU", result.gpu } } )
     {
-      QJsonObject obj = v.toObject();
-      QString id = obj["id"].toString();
-      QString tag = assignmentTag( assignments.kbStates.value( id ) );
-      std::printf( "  %-36s  %s%s\n",
-                   id.toStdString().c_str(),
-                   obj["name"].toString().toStdString().c_str(),
-                   tag.toStdString().c_str() );
+      if ( !s.available )
+        continue;
+      std::printf( "  %-24s %-4s %7.1f %% %5d %6.1f dB %6d %6.1f °C %6.0f s\n",
+                   first ? name.left( 24 ).toUtf8().constData() : "", fan, s.avgDuty, s.maxDuty, s.noiseDb,
+                   s.steps, s.maxTemp, s.secondsAbove );
+      first = false;
     }
   }
   return 0;
 }
 
-/// Set a keyboard profile by ID from local settings.
-static int cmdKeyboardProfileSet( ucc::UccdClient &c, const char *profileId )
+static int cmdMonitorStats( ucc::UccdClient &c, int windowSecs, const QVariantMap &thresholds, bool jsonMode )
 {
-  QSettings settings = localSettings();
-  QByteArray customKP = settings.value( "customKeyboardProfiles", "[]" ).toByteArray();
-  if ( customKP.isEmpty() || customKP == "[]" )
+  const qint64 nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::system_clock::now().time_since_epoch() ).count();
+  auto json = c.getMonitorStats( nowMs - static_cast< qint64 >( windowSecs ) * 1000, thresholds );
+  if ( !json )
   {
-    std::fputs( "Error: No custom keyboard profiles found\n", stderr );
+    std::fputs( "Error: Could not retrieve monitoring statistics\n", stderr );
     return 1;
   }
-  QJsonDocument doc = QJsonDocument::fromJson( customKP );
-  if ( !doc.isArray() )
+  if ( jsonMode )
   {
-    std::fputs( "Error: Invalid keyboard profiles data\n", stderr );
-    return 1;
+    std::puts( json->c_str() );
+    return 0;
   }
-  QString qId = QString::fromUtf8( profileId );
-  for ( const QJsonValue &v : doc.array() )
+
+  QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) ).object();
+  if ( obj.isEmpty() )
   {
-    if ( v.isObject() && v.toObject()["id"].toString() == qId )
+    std::puts( "No samples in the requested window." );
+    return 0;
+  }
+
+
+  std::printf( "=== Statistics (last %d s, time-weighted) ===\n", windowSecs );
+  std::printf( "  %-14s %-4s %8s %8s %8s %8s %8s %8s  %s\n",
+               "Metric", "", "Min", "Avg", "p50", "p95", "p99", "Max", "Above threshold" );
+  for ( const auto &row : kMetricRows )
+  {
+    if ( !obj.contains( row.key ) )
+      continue;
+    const QJsonObject m = obj[ row.key ].toObject();
+    std::printf( "  %-14s %-4s %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f",
+                 row.label, row.unit, m["min"].toDouble(), m["avg"].toDouble(), m["p50"].toDouble(),
+                 m["p95"].toDouble(), m["p99"].toDouble(), m["max"].toDouble() );
+    if ( m.contains( "threshold" ) )
     {
-      QString json = v.toObject()["json"].toString();
-      if ( json.isEmpty() )
-      {
-        std::fputs( "Error: Keyboard profile has no data\n", stderr );
-        return 1;
-      }
-      ok( c.setKeyboardBacklight( json.toStdString() ) );
-      return 0;
+      const double seconds = m["secondsAbove"].toDouble();
+      const double covered = m["seconds"].toDouble();
+      std::printf( "  %.0f s > %g (%.1f%%)", seconds, m["threshold"].toDouble(),
+                   covered > 0.0 ? 100.0 * seconds / covered : 0.0 );
     }
+    std::putchar( '\n' );
   }
-  std::fputs( "Error: Keyboard profile not found\n", stderr );
-  return 1;
+  return 0;
 }
 
-static int cmdKeyboardColor( ucc::UccdClient &c, int r, int g, int b, int brightness )
+// --- Daemon diagnostics ---
+
+static int cmdWorkerStats( ucc::UccdClient &c, bool jsonMode )
 {
-  // Get current capabilities to determine zone count
-  auto info = c.getKeyboardBacklightInfo();
-  if ( !info )
+  auto json = c.getWorkerStatsJSON();
+  if ( !json )
   {
-    std::fputs( "Error: Could not retrieve keyboard capabilities\n", stderr );
+    std::fputs( "Error: Could not retrieve worker statistics\n", stderr );
+    return 1;
+  }
+  if ( jsonMode )
+  {
+    std::puts( json->c_str() );
+    return 0;
+  }
+
+  const QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) ).object();
+  const QJsonArray bounds = obj["histogramUpperMs"].toArray();
+
+  std::puts( "=== Worker timing (since daemon start) ===" );
+  std::printf( "  %-16s %8s %8s %7s %9s %9s %8s %9s %9s %9s\n", "Worker", "Cycles", "Overruns", "Wakes",
+               "Work avg", "Work max", "p95 <=", "CPU s", "Period", "Actual" );
+  for ( const auto &entry : obj["workers"].toArray() )
+  {
+    const QJsonObject w = entry.toObject();
+    const QJsonArray histogram = w["histogram"].toArray();
+
+    // upper bound of the bucket holding the 95th percentile
+    const double cycles = w["cycles"].toDouble();
+    double seen = 0.0;
+    QString p95 = "-";
+    for ( qsizetype i = 0; i < histogram.size() && cycles > 0.0; ++i )
+    {
+      seen += histogram[ i ].toDouble();
+      if ( seen >= 0.95 * cycles )
+      {
+        p95 = i < bounds.size() ? QString::number( bounds[ i ].toInt() ) + " ms" : QStringLiteral( "more" );
+        break;
+      }
+    }
+
+    const double actual = w["avgPeriodMs"].toDouble();
+    std::printf( "  %-16s %8lld %8lld %7lld %6.1f ms %6.1f ms %8s %9.1f %6.0f ms ",
+                 w["name"].toString().toUtf8().constData(),
+                 static_cast< long long >( w["cycles"].toDouble() ),
+                 static_cast< long long >( w["overruns"].toDouble() ),
+                 static_cast< long long >( w["wakes"].toDouble() ),
+                 w["workAvgMs"].toDouble(), w["workMaxMs"].toDouble(), p95.toUtf8().constData(),
+                 w["cpuTotalMs"].toDouble() / 1000.0, w["nominalPeriodMs"].toDouble() );
+    if ( actual >= 0.0 )
+      std::printf( "%6.0f ms\n", actual );
+    else
+      std::puts( "       -" );
+  }
+
+  const QJsonArray targets = obj["reconcile"].toArray();
+  if ( !targets.isEmpty() )
+  {
+    std::puts( "\n=== Drift reconciliation ===" );
+    std::printf( "  %-20s %8s %8s %9s %9s  %s\n", "Setting", "Probes", "Drifts", "Reapplied", "Interval",
+                 "Changed by" );
+    for ( const auto &entry : targets )
+    {
+      const QJsonObject t = entry.toObject();
+      QStringList agents;
+      const QJsonObject counts = t["agents"].toObject();
+      for ( auto it = counts.begin(); it != counts.end(); ++it )
+        agents << QString( "%1 (%2)" ).arg( it.key() ).arg( it.value().toInteger() );
+      std::printf( "  %-20s %8lld %8lld %9lld %6.0f s  %s%s\n",
+                   t["name"].toString().toUtf8().constData(),
+                   static_cast< long long >( t["probes"].toDouble() ),
+                   static_cast< long long >( t["drifts"].toDouble() ),
+                   static_cast< long long >( t["reapplies"].toDouble() ),
+                   t["intervalMs"].toDouble() / 1000.0,
+                   agents.isEmpty() ? "-" : agents.join( ", " ).toUtf8().constData(),
+                   t["gaveUp"].toBool() ? " [gave up]" : "" );
+    }
+  }
+  return 0;
+}
+
+static int cmdIpcStats( ucc::UccdClient &c, bool jsonMode )
+{
+  auto json = c.getIpcStatsJSON();
+  if ( !json )
+  {
+    std::fputs( "Error: Could not retrieve D-Bus call statistics\n", stderr );
+    return 1;
+  }
+  if ( jsonMode )
+  {
+    std::puts( json->c_str() );
+    return 0;
+  }
+
+  const QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) ).object();
+
+  // sender -> "comm (pid)" for the senders the daemon could still resolve
+  QMap< QString, QString > processes;
+  for ( const auto &entry : obj["senders"].toArray() )
+  {
+    const QJsonObject s = entry.toObject();
+    processes.insert( s["sender"].toString(), s["process"].toString() );
+  }
+  const auto who = [&processes]( const QString &sender ) {
+    const QString process = processes.value( sender );
+    return ( process.isEmpty() ? sender : process ).toUtf8();
+  };
+
+  std::printf( "=== D-Bus calls (%lld in %.0f s, quantiles are bucket upper bounds) ===\n",
+               static_cast< long long >( obj["calls"].toDouble() ), obj["uptimeS"].toDouble() );
+  std::printf( "  %-36s %9s %7s %10s %9s %10s  %s\n", "Method", "Count",
+               QString( "/%1s" ).arg( obj["rateWindowS"].toInt() ).toUtf8().constData(),
+               "Avg", "p95 <=", "Max", "Top caller" );
+  for ( const auto &entry : obj["methods"].toArray() )
+  {
+    const QJsonObject m = entry.toObject();
+    const QJsonObject senders = m["senders"].toObject();
+    QString top;
+    double topCalls = 0.0;
+    for ( auto it = senders.begin(); it != senders.end(); ++it )
+      if ( it.value().toDouble() > topCalls )
+      {
+        topCalls = it.value().toDouble();
+        top = it.key();
+      }
+
+    std::printf( "  %-36s %9lld %7lld %7.1f us %6lld us %7.1f us  %s (%lld)\n",
+                 m["name"].toString().toUtf8().constData(),
+                 static_cast< long long >( m["count"].toDouble() ),
+                 static_cast< long long >( m["recent"].toDouble() ), m["avgUs"].toDouble(),
+                 static_cast< long long >( m["p95Us"].toDouble() ), m["maxUs"].toDouble(),
+                 who( top ).constData(), static_cast< long long >( topCalls ) );
+  }
+
+  std::puts( "\n=== Callers ===" );
+  std::printf( "  %-12s %-28s %9s %10s\n", "Sender", "Process", "Calls", "Time" );
+  for ( const auto &entry : obj["senders"].toArray() )
+  {
+    const QJsonObject s = entry.toObject();
+    const QString process = s["process"].toString();
+    std::printf( "  %-12s %-28s %9lld %7.1f ms\n", s["sender"].toString().toUtf8().constData(),
+                 process.isEmpty() ? "-" : process.toUtf8().constData(),
+                 static_cast< long long >( s["calls"].toDouble() ), s["totalUs"].toDouble() / 1000.0 );
+  }
+  return 0;
+}
+
+static int cmdStartupTimeline( ucc::UccdClient &c, bool jsonMode )
+{
+  auto json = c.getStartupTimelineJSON();
+  if ( !json )
+  {
+    std::fputs( "Error: Could not retrieve daemon startup timeline\n", stderr );
+    return 1;
+  }
+  if ( jsonMode )
+  {
+    std::puts( json->c_str() );
+    return 0;
+  }
+
+  const QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) ).object();
+  const double readyMs = obj["readyMs"].toDouble();
+  if ( readyMs >= 0.0 )
+    std::printf( "=== Daemon startup (ready after %.1f ms, %.1f ms on the main thread) ===\n",
+                 readyMs, obj["mainMs"].toDouble() );
+  else
+    std::puts( "=== Daemon startup (not ready yet) ===" );
+  std::printf( "  %-24s %-9s %10s %12s\n", "Phase", "Lane", "Start", "Duration" );
+  for ( const auto &entry : obj["phases"].toArray() )
+  {
+    const QJsonObject p = entry.toObject();
+    std::printf( "  %-24s %-9s %7.1f ms %9.1f ms\n", p["name"].toString().toUtf8().constData(),
+                 p["lane"].toString().toUtf8().constData(), p["startMs"].toDouble(), p["durationMs"].toDouble() );
+  }
+  return 0;
+}
+
+static int cmdFanTrace( ucc::UccdClient &c, bool jsonMode )
+{
+  auto json = c.getFanTraceJSON();
+  if ( !json )
+  {
+    std::fputs( "Error: Could not retrieve fan latency trace\n", stderr );
+    return 1;
+  }
+  if ( jsonMode )
+  {
+    std::puts( json->c_str() );
+    return 0;
+  }
+
+  const QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) ).object();
+  const QJsonArray bounds = obj["histogramUpperUs"].toArray();
+
+  std::puts( "=== Fan loop latency (since daemon start, quantiles are bucket upper bounds) ===" );
+  std::printf( "  %-12s %9s %10s %9s %9s %9s %10s\n", "Stage", "Count", "Avg", "p50 <=", "p95 <=", "p99 <=", "Max" );
+  for ( const auto &entry : obj["stages"].toArray() )
+  {
+    const QJsonObject s = entry.toObject();
+    const auto count = static_cast< long long >( s["count"].toDouble() );
+    if ( count == 0 )
+    {
+      std::printf( "  %-12s %9d %10s %9s %9s %9s %10s\n", s["name"].toString().toUtf8().constData(), 0,
+                   "-", "-", "-", "-", "-" );
+      continue;
+    }
+    std::printf( "  %-12s %9lld %7.1f us %6lld us %6lld us %6lld us %7.1f us\n",
+                 s["name"].toString().toUtf8().constData(), count, s["avgUs"].toDouble(),
+                 static_cast< long long >( s["p50Us"].toDouble() ),
+                 static_cast< long long >( s["p95Us"].toDouble() ),
+                 static_cast< long long >( s["p99Us"].toDouble() ), s["maxUs"].toDouble() );
+  }
+
+  // histogram of the end-to-end latency, one row per non-empty bucket
+  for ( const auto &entry : obj["stages"].toArray() )
+  {
+    const QJsonObject s = entry.toObject();
+    if ( s["name"].toString() != QLatin1String( "readToWrite" ) || s["count"].toDouble() <= 0.0 )
+      continue;
+    const QJsonArray histogram = s["histogram"].toArray();
+    double peak = 0.0;
+    for ( const auto &bucket : histogram )
+      peak = std::max( peak, bucket.toDouble() );
+
+    std::puts( "\n  Sensor read to EC write:" );
+    for ( qsizetype i = 0; i < histogram.size(); ++i )
+    {
+      const double n = histogram[ i ].toDouble();
+      if ( n <= 0.0 )
+        continue;
+      const QString label = i < bounds.size() ? "<= " + QString::number( bounds[ i ].toInteger() ) + " us"
+                                              : QStringLiteral( "more" );
+      const int bar = static_cast< int >( 40.0 * n / peak + 0.5 );
+      std::printf( "  %12s %9lld %s\n", label.toUtf8().constData(), static_cast< long long >( n ),
+                   std::string( static_cast< size_t >( std::max( bar, 1 ) ), '#' ).c_str() );
+    }
+  }
+  return 0;
+}
+
+static int cmdFanCalibrateStart( ucc::UccdClient &c )
+{
+  if ( !c.startFanCalibration() )
+  {
+    std::fputs( "Error: Could not start fan calibration (is fan control enabled?)\n", stderr );
+    return 1;
+  }
+  std::puts( "Fan calibration started; the fans will step between low and full speed for 1-3 minutes." );
+  return 0;
+}
+
+static int cmdFanCalibrateCancel( ucc::UccdClient &c )
+{
+  c.cancelFanCalibration();
+  return 0;
+}
+
+static int cmdFanCalibrateStatus( ucc::UccdClient &c, bool jsonMode )
+{
+  auto json = c.getFanCalibrationJSON();
+  if ( !json )
+  {
+    std::fputs( "Error: Could not retrieve fan calibration\n", stderr );
+    return 1;
+  }
+  if ( jsonMode )
+  {
+    std::puts( json->c_str() );
+    return 0;
+  }
+
+  const QJsonObject obj = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) ).object();
+  std::printf( "Calibration: %s", obj["phase"].toString().toUtf8().constData() );
+  if ( !obj["error"].toString().isEmpty() )
+    std::printf( " (%s)", obj["error"].toString().toUtf8().constData() );
+  std::puts( "" );
+
+  const QJsonArray fans = obj["fans"].toArray();
+  if ( fans.isEmpty() )
+  {
+    std::puts( "No fan response model; firmware limits and default smoothing in use" );
+    return 0;
+  }
+  std::printf( "  %-4s %8s %10s %10s %10s %10s %10s\n", "Fan", "Min duty", "Dead time", "Rise tau", "Fall tau",
+               "Settle", "Overshoot" );
+  for ( qsizetype i = 0; i < fans.size(); ++i )
+  {
+    const QJsonObject f = fans[ i ].toObject();
+    std::printf( "  %-4lld %7d%% %7d ms %7d ms %7d ms %7d ms %9d%%\n", static_cast< long long >( i ),
+                 f["minDuty"].toInt(), f["deadTimeMs"].toInt(), f["riseTauMs"].toInt(), f["fallTauMs"].toInt(),
+                 f["settleMs"].toInt(), f["overshootPct"].toInt() );
+  }
+  return 0;
+}
+
+// --- Benchmark ---
+
+using BenchClock = std::chrono::steady_clock;
+
+static double elapsedMs( BenchClock::time_point since )
+{
+  return std::chrono::duration< double, std::milli >( BenchClock::now() - since ).count();
+}
+
+/// Latencies of one benchmarked call, sorted, in milliseconds
+struct BenchSeries
+{
+  QString name;
+  std::vector< double > ms;
+  int failures = 0;
+  double wallMs = 0.0;  ///< Whole run, for the call rate; 0 if the rate is meaningless
+};
+
+/// Nearest-rank quantile of sorted @p ms
+static double benchQuantile( const std::vector< double > &ms, double q )
+{
+  if ( ms.empty() )
+    return 0.0;
+  const auto rank = static_cast< size_t >( std::ceil( q * static_cast< double >( ms.size() ) ) );
+  return ms[ std::clamp< size_t >( rank, 1, ms.size() ) - 1 ];
+}
+
+static BenchSeries benchCall( const QString &name, int iterations, const std::function< bool() > &call )
+{
+  BenchSeries series{ name, {}, 0, 0.0 };
+  series.ms.reserve( static_cast< size_t >( iterations ) );
+  ( void ) call();  // warm-up: bus connection, daemon-side caches
+
+  const auto start = BenchClock::now();
+  for ( int i = 0; i < iterations; ++i )
+  {
+    const auto t0 = BenchClock::now();
+    const bool success = call();
+    series.ms.push_back( elapsedMs( t0 ) );
+    if ( !success )
+      ++series.failures;
+  }
+  series.wallMs = elapsedMs( start );
+  std::sort( series.ms.begin(), series.ms.end() );
+  return series;
+}
+
+/**
+ * Switch to @p target and back @p switches times.  Per switch this times
+ * the SetActiveProfile call, the arrival of the matching ProfileChanged
+ * signal and the first ODMPowerLimitsJSON reply whose TDP readings (which
+ * the daemon re-reads from the EC after applying) differ from before.
+ * The last one is skipped once a switch leaves the TDPs unchanged.
+ */
+static std::vector< BenchSeries > benchProfileSwitch( ucc::UccdClient &c, const std::string &target, int switches )
+{
+  constexpr int SWITCH_TIMEOUT_MS = 5000;
+
+  const auto active = c.getActiveProfile();
+  if ( !active )
+    return {};
+  const std::string original = ( *active )["id"].toString().toStdString();
+
+  BenchSeries callSeries{ "SetActiveProfile", {}, 0, 0.0 };
+  BenchSeries signalSeries{ "  until ProfileChanged", {}, 0, 0.0 };
+  BenchSeries hardwareSeries{ "  until TDP changed", {}, 0, 0.0 };
+  bool trackHardware = c.getODMPowerLimitsJSON().has_value();
+
+  for ( int i = 0; i < 2 * switches; ++i )
+  {
+    const std::string &id = i % 2 == 0 ? target : original;
+    const auto before = trackHardware ? c.getODMPowerLimitsJSON() : std::nullopt;
+
+    QEventLoop loop;
+    std::optional< double > signalMs;
+    const auto t0 = BenchClock::now();
+    QObject::connect( &c, &ucc::UccdClient::profileChanged, &loop, [&]( const QString &profileId ) {
+      if ( !signalMs && profileId.toStdString() == id )
+      {
+        signalMs = elapsedMs( t0 );
+        loop.quit();
+      }
+    } );
+
+    const bool success = c.setActiveProfile( id );
+    callSeries.ms.push_back( elapsedMs( t0 ) );
+    if ( !success )
+    {
+      ++callSeries.failures;
+      continue;
+    }
+
+    if ( !signalMs )
+    {
+      QTimer timeout;
+      timeout.setSingleShot( true );
+      QObject::connect( &timeout, &QTimer::timeout, &loop, &QEventLoop::quit );
+      timeout.start( SWITCH_TIMEOUT_MS );
+      loop.exec();
+    }
+    if ( signalMs )
+      signalSeries.ms.push_back( *signalMs );
+    else
+      ++signalSeries.failures;
+
+    if ( before )
+    {
+      bool changed = false;
+      while ( !changed && elapsedMs( t0 ) < SWITCH_TIMEOUT_MS )
+      {
+        const auto now = c.getODMPowerLimitsJSON();
+        changed = now && *now != *before;
+        if ( !changed )
+          std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+      }
+      if ( changed )
+        hardwareSeries.ms.push_back( elapsedMs( t0 ) );
+      else
+        trackHardware = false;  // both profiles use the same TDPs
+    }
+  }
+
+  std::vector< BenchSeries > result;
+  for ( BenchSeries *series : { &callSeries, &signalSeries, &hardwareSeries } )
+  {
+    std::sort( series->ms.begin(), series->ms.end() );
+    if ( !series->ms.empty() || series->failures > 0 )
+      result.push_back( std::move( *series ) );
+  }
+  return result;
+}
+
+static int cmdBench( ucc::UccdClient &c, int iterations, bool setters, const char *profileId, int switches,
+                     bool jsonMode )
+{
+  std::vector< BenchSeries > results;
+  results.push_back( benchCall( "GetDisplayBrightness", iterations, [&c]() {
+    return c.getDisplayBrightness().has_value();
+  } ) );
+  results.push_back( benchCall( "GetActiveProfile", iterations, [&c]() {
+    return c.getActiveProfile().has_value();
+  } ) );
+  results.push_back( benchCall( "GetLiveSnapshot", iterations, [&c]() {
+    return c.getLiveSnapshot().has_value();
+  } ) );
+
+  const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+  for ( const int horizonS : { 10, 60, 600, 1800 } )
+  {
+    const qint64 since = nowMs - static_cast< qint64 >( horizonS ) * 1000;
+    results.push_back( benchCall( QString( "GetMonitorDataSince (%1 s)" ).arg( horizonS ), iterations, [&c, since]() {
+      return c.getMonitorDataSince( since ).has_value();
+    } ) );
+  }
+
+  // dry run: write back the current value, so the authorized path runs without changing anything
+  if ( setters )
+  {
+    if ( const auto brightness = c.getDisplayBrightness() )
+      results.push_back( benchCall( "SetDisplayBrightness (unchanged)", iterations, [&c, value = *brightness]() {
+        return c.setDisplayBrightness( value );
+      } ) );
+    else
+      std::fputs( "Warning: No display brightness to write back; skipping setters\n", stderr );
+  }
+
+  if ( profileId )
+  {
+    auto switchSeries = benchProfileSwitch( c, profileId, switches );
+    if ( switchSeries.empty() )
+    {
+      std::fputs( "Error: Could not read the active profile\n", stderr );
+      return 1;
+    }
+    for ( auto &series : switchSeries )
+      results.push_back( std::move( series ) );
+  }
+
+  if ( jsonMode )
+  {
+    QJsonArray calls;
+    for ( const auto &r : results )
+    {
+      QJsonObject o;
+      o["name"] = r.name.trimmed();
+      o["calls"] = static_cast< qint64 >( r.ms.size() );
+      o["failures"] = r.failures;
+      o["p50Ms"] = benchQuantile( r.ms, 0.50 );
+      o["p99Ms"] = benchQuantile( r.ms, 0.99 );
+      o["maxMs"] = r.ms.empty() ? 0.0 : r.ms.back();
+      if ( r.wallMs > 0.0 )
+        o["perSecond"] = 1000.0 * static_cast< double >( r.ms.size() ) / r.wallMs;
+      calls.append( o );
+    }
+    QJsonObject root;
+    root["iterations"] = iterations;
+    root["calls"] = calls;
+    std::puts( QJsonDocument( root ).toJson( QJsonDocument::Compact ).constData() );
+    return 0;
+  }
+
+  std::printf( "=== uccd round trips (%d calls each after one warm-up) ===\n", iterations );
+  std::printf( "  %-34s %6s %5s %10s %10s %10s %9s\n", "Call", "Calls", "Fail", "p50", "p99", "Max", "Calls/s" );
+  for ( const auto &r : results )
+  {
+    std::printf( "  %-34s %6zu %5d %7.2f ms %7.2f ms %7.2f ms", r.name.toUtf8().constData(), r.ms.size(),
+                 r.failures, benchQuantile( r.ms, 0.50 ), benchQuantile( r.ms, 0.99 ),
+                 r.ms.empty() ? 0.0 : r.ms.back() );
+    if ( r.wallMs > 0.0 )
+      std::printf( " %9.0f\n", 1000.0 * static_cast< double >( r.ms.size() ) / r.wallMs );
+    else
+      std::printf( " %9s\n", "-" );
+  }
+  return 0;
+}
+
+// --- Keyboard ---
+
+static int cmdKeyboardInfo( ucc::UccdClient &c )
+{
+  auto info = c.getKeyboardBacklightInfo();
+  if ( !info )
+  {
+    std::fputs( "Error: Could not retrieve keyboard backlight info\n", stderr );
+    return 1;
+  }
+  QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *info ) );
+  if ( !doc.isObject() )
+  {
+    std::puts( info->c_str() );
+    return 0;
+  }
+  QJsonObject obj = doc.object();
+  std::puts( "=== Keyboard Backlight ===" );
+  std::printf( "  %-24s %d\n",  "Zones:", obj["zones"].toInt() );
+  std::printf( "  %-24s %d\n",  "Max brightness:", obj["maxBrightness"].toInt() );
+  std::printf( "  %-24s %d\n",  "Max red:", obj["maxRed"].toInt() );
+  std::printf( "  %-24s %d\n",  "Max green:", obj["maxGreen"].toInt() );
+  std::printf( "  %-24s %d\n",  "Max blue:", obj["maxBlue"].toInt() );
+  if ( obj.contains( "modes" ) && obj["modes"].isArray() )
+  {
+    QJsonArray modes = obj["modes"].toArray();
+    std::string mstr;
+    for ( int i = 0; i < modes.size(); ++i )
+    {
+      if ( i > 0 ) mstr += ", ";
+      int m = modes[i].toInt();
+      switch ( m )
+      {
+        case 0: mstr += "static"; break;
+        case 1: mstr += "breathe"; break;
+        case 2: mstr += "colorful"; break;
+        case 3: mstr += "breathe-color"; break;
+        default: mstr += std::to_string( m ); break;
+      }
+    }
+    std::printf( "  %-24s %s\n", "Modes:", mstr.c_str() );
+  }
+  return 0;
+}
+
+static int cmdKeyboardGet( ucc::UccdClient &c )
+{
+  auto states = c.getKeyboardBacklightStates();
+  if ( !states )
+  {
+    std::fputs( "Error: Could not retrieve keyboard backlight states\n", stderr );
+    return 1;
+  }
+  QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *states ) );
+  if ( !doc.isObject() )
+  {
+    std::puts( states->c_str() );
+    return 0;
+  }
+  QJsonObject root = doc.object();
+  int brightness = root["brightness"].toInt();
+  QJsonArray arr = root["states"].toArray();
+
+  std::puts( "=== Keyboard Backlight State ===" );
+  std::printf( "  %-24s %d\n", "Global brightness:", brightness );
+  std::printf( "  %-24s %d\n", "Zones:", (int)arr.size() );
+
+  if ( arr.isEmpty() )
+    return 0;
+
+  // Check if all zones are uniform
+  QJsonObject first = arr[0].toObject();
+  bool uniform = true;
+  for ( int i = 1; i < arr.size(); ++i )
+  {
+    QJsonObject z = arr[i].toObject();
+    if ( z["red"].toInt() != first["red"].toInt() ||
+         z["green"].toInt() != first["green"].toInt() ||
+         z["blue"].toInt() != first["blue"].toInt() ||
+         z["mode"].toInt() != first["mode"].toInt() ||
+         z["brightness"].toInt() != first["brightness"].toInt() )
+    {
+      uniform = false;
+      break;
+    }
+  }
+
+  if ( uniform )
+  {
+    std::printf( "  %-24s uniform\n", "Pattern:" );
+    std::printf( "  %-24s rgb(%d, %d, %d)\n", "Color:",
+                 first["red"].toInt(), first["green"].toInt(), first["blue"].toInt() );
+    std::printf( "  %-24s %d\n", "Zone brightness:", first["brightness"].toInt() );
+    int m = first["mode"].toInt();
+    const char *modeName = m == 0 ? "static" : m == 1 ? "breathe" :
+                           m == 2 ? "colorful" : m == 3 ? "breathe-color" : "unknown";
+    std::printf( "  %-24s %s\n", "Mode:", modeName );
+  }
+  else
+  {
+    // Print a compact table for differing zones
+    std::puts( "" );
+    std::printf( "  %-6s %-6s %-14s %-12s %s\n", "Zone", "Mode", "Color", "Brightness", "" );
+    std::printf( "  %-6s %-6s %-14s %-12s %s\n", "----", "----", "-----------", "----------", "" );
+    for ( int i = 0; i < arr.size(); ++i )
+    {
+      QJsonObject z = arr[i].toObject();
+      int m = z["mode"].toInt();
+      const char *modeName = m == 0 ? "static" : m == 1 ? "breathe" :
+                             m == 2 ? "color" : m == 3 ? "br-color" : "?";
+      char color[32];
+      std::snprintf( color, sizeof(color), "(%d,%d,%d)",
+                     z["red"].toInt(), z["green"].toInt(), z["blue"].toInt() );
+      std::printf( "  %-6d %-6s %-14s %-12d\n", i + 1, modeName, color, z["brightness"].toInt() );
+    }
+  }
+  return 0;
+}
+
+static int cmdKeyboardSet( ucc::UccdClient &c, const char *jsonStr )
+{
+  return ok( c.setKeyboardBacklight( jsonStr ) );
+}
+
+/// List custom keyboard profiles from local settings.
+static int cmdKeyboardProfileList()
+{
+  LocalAssignments assignments = loadLocalAssignments();
+
+  QSettings settings = localSettings();
+  QByteArray customKP = settings.value( "customKeyboardProfiles", "[]" ).toByteArray();
+  if ( customKP.isEmpty() || customKP == "[]" )
+  {
+    std::puts( "No custom keyboard profiles found." );
+    return 0;
+  }
+  QJsonDocument doc = QJsonDocument::fromJson( customKP );
+  if ( !doc.isArray() || doc.array().isEmpty() )
+  {
+    std::puts( "No custom keyboard profiles found." );
+    return 0;
+  }
+  std::puts( "Keyboard profiles:" );
+  for ( const QJsonValue &v : doc.array() )
+  {
+    if ( v.isObject() )
+    {
+      QJsonObject obj = v.toObject();
+      QString id = obj["id"].toString();
+      QString tag = assignmentTag( assignments.kbStates.value( id ) );
+      std::printf( "  %-36s  %s%s\n",
+                   id.toStdString().c_str(),
+                   obj["name"].toString().toStdString().c_str(),
+                   tag.toStdString().c_str() );
+    }
+  }
+  return 0;
+}
+
+/// Set a keyboard profile by ID from local settings.
+static int cmdKeyboardProfileSet( ucc::UccdClient &c, const char *profileId )
+{
+  QSettings settings = localSettings();
+  QByteArray customKP = settings.value( "customKeyboardProfiles", "[]" ).toByteArray();
+  if ( customKP.isEmpty() || customKP == "[]" )
+  {
+    std::fputs( "Error: No custom keyboard profiles found\n", stderr );
+    return 1;
+  }
+  QJsonDocument doc = QJsonDocument::fromJson( customKP );
+  if ( !doc.isArray() )
+  {
+    std::fputs( "Error: Invalid keyboard profiles data\n", stderr );
+    return 1;
+  }
+  QString qId = QString::fromUtf8( profileId );
+  for ( const QJsonValue &v : doc.array() )
+  {
+    if ( v.isObject() && v.toObject()["id"].toString() == qId )
+    {
+      QString json = v.toObject()["json"].toString();
+      if ( json.isEmpty() )
+      {
+        std::fputs( "Error: Keyboard profile has no data\n", stderr );
+        return 1;
+      }
+      return ok( c.setKeyboardBacklight( json.toStdString() ) );
+    }
+  }
+  std::fputs( "Error: Keyboard profile not found\n", stderr );
+  return 1;
+}
+
+static int cmdKeyboardColor( ucc::UccdClient &c, int r, int g, int b, int brightness )
+{
+  // Get current capabilities to determine zone count
+  auto info = c.getKeyboardBacklightInfo();
+  if ( !info )
+  {
+    std::fputs( "Error: Could not retrieve keyboard capabilities\n", stderr );
     return 1;
   }
 
@@ -1207,8 +2217,7 @@ static int cmdKeyboardColor( ucc::UccdClient &c, int r, int g, int b, int bright
   }
 
   QString json = QJsonDocument( states ).toJson( QJsonDocument::Compact );
-  ok( c.setKeyboardBacklight( json.toStdString() ) );
-  return 0;
+  return ok( c.setKeyboardBacklight( json.toStdString() ) );
 }
 
 // --- Hardware controls ---
@@ -1227,8 +2236,7 @@ static int cmdBrightnessGet( ucc::UccdClient &c )
 
 static int cmdBrightnessSet( ucc::UccdClient &c, int val )
 {
-  ok( c.setDisplayBrightness( val ) );
-  return 0;
+  return ok( c.setDisplayBrightness( val ) );
 }
 
 static int cmdWebcamGet( ucc::UccdClient &c )
@@ -1245,8 +2253,7 @@ static int cmdWebcamGet( ucc::UccdClient &c )
 
 static int cmdWebcamSet( ucc::UccdClient &c, bool enabled )
 {
-  ok( c.setWebcamEnabled( enabled ) );
-  return 0;
+  return ok( c.setWebcamEnabled( enabled ) );
 }
 
 static int cmdFnLockGet( ucc::UccdClient &c )
@@ -1263,8 +2270,7 @@ static int cmdFnLockGet( ucc::UccdClient &c )
 
 static int cmdFnLockSet( ucc::UccdClient &c, bool enabled )
 {
-  ok( c.setFnLock( enabled ) );
-  return 0;
+  return ok( c.setFnLock( enabled ) );
 }
 
 // --- Water Cooler ---
@@ -1300,32 +2306,27 @@ static int cmdWaterCoolerStatus( ucc::UccdClient &c )
 
 static int cmdWaterCoolerEnable( ucc::UccdClient &c, bool enable )
 {
-  ok( c.enableWaterCooler( enable ) );
-  return 0;
+  return ok( c.enableWaterCooler( enable ) );
 }
 
 static int cmdWaterCoolerFanSet( ucc::UccdClient &c, int percent )
 {
-  ok( c.setWaterCoolerFanSpeed( percent ) );
-  return 0;
+  return ok( c.setWaterCoolerFanSpeed( percent ) );
 }
 
 static int cmdWaterCoolerPumpSet( ucc::UccdClient &c, int voltageCode )
 {
-  ok( c.setWaterCoolerPumpVoltage( voltageCode ) );
-  return 0;
+  return ok( c.setWaterCoolerPumpVoltage( voltageCode ) );
 }
 
 static int cmdWaterCoolerLed( ucc::UccdClient &c, int r, int g, int b, int mode )
 {
-  ok( c.setWaterCoolerLEDColor( r, g, b, mode ) );
-  return 0;
+  return ok( c.setWaterCoolerLEDColor( r, g, b, mode ) );
 }
 
 static int cmdWaterCoolerLedOff( ucc::UccdClient &c )
 {
-  ok( c.turnOffWaterCoolerLED() );
-  return 0;
+  return ok( c.turnOffWaterCoolerLED() );
 }
 
 // --- Charging ---
@@ -1401,22 +2402,19 @@ static int cmdChargingStatus( ucc::UccdClient &c )
 
 static int cmdChargingSetProfile( ucc::UccdClient &c, const char *profile )
 {
-  ok( c.setChargingProfile( profile ) );
-  return 0;
+  return ok( c.setChargingProfile( profile ) );
 }
 
 static int cmdChargingSetPriority( ucc::UccdClient &c, const char *priority )
 {
-  ok( c.setChargingPriority( priority ) );
-  return 0;
+  return ok( c.setChargingPriority( priority ) );
 }
 
 static int cmdChargingSetThresholds( ucc::UccdClient &c, int start, int end )
 {
   bool s = c.setChargeStartThreshold( start );
   bool e = c.setChargeEndThreshold( end );
-  ok( s && e );
-  return 0;
+  return ok( s && e );
 }
 
 // --- GPU ---
@@ -1453,6 +2451,26 @@ static int cmdGpuInfo( ucc::UccdClient &c )
   return 0;
 }
 
+static int cmdGpuTuneStart( ucc::UccdClient &c, const std::string &optionsJSON )
+{
+  if ( const int rc = ok( c.startNvidiaOCTuning( optionsJSON ) ) )
+    return rc;
+  std::puts( "Keep a GPU load running; follow progress with: ucc-cli gpu tune status" );
+  return 0;
+}
+
+static int cmdGpuTuneStatus( ucc::UccdClient &c )
+{
+  auto status = c.getNvidiaOCTuningStatus();
+  if ( !status )
+  {
+    std::fputs( "Failed to query tuning status\n", stderr );
+    return 1;
+  }
+  std::puts( status->c_str() );
+  return 0;
+}
+
 // --- State Map ---
 
 static int cmdStateMapGet( ucc::UccdClient &c )
@@ -1486,6 +2504,20 @@ static int cmdStateMapGet( ucc::UccdClient &c )
     }
   }
 
+  // Per-application profiles
+  if ( obj.contains( "workloadRules" ) && !obj["workloadRules"].toArray().isEmpty() )
+  {
+    std::puts( "\n  Application → Profile rules:" );
+    for ( const auto &value : obj["workloadRules"].toArray() )
+    {
+      const QJsonObject rule = value.toObject();
+      QString match = rule["exe"].toString();
+      if ( !rule["cgroup"].toString().isEmpty() )
+        match += ( match.isEmpty() ? "cgroup " : " in cgroup " ) + rule["cgroup"].toString();
+      std::printf( "    %-40s %s\n", match.toStdString().c_str(), rule["profile"].toString().toStdString().c_str() );
+    }
+  }
+
   // Feature toggles
   std::puts( "\n  Feature controls:" );
   if ( obj.contains( "cpuSettingsEnabled" ) )
@@ -1516,8 +2548,12 @@ static int cmdStateMapGet( ucc::UccdClient &c )
 
 static int cmdStateMapSet( ucc::UccdClient &c, const char *state, const char *profileId )
 {
-  ok( c.setStateMap( state, profileId ) );
-  return 0;
+  return ok( c.setStateMap( state, profileId ) );
+}
+
+static int cmdStateMapRules( ucc::UccdClient &c, const char *rulesJSON )
+{
+  return ok( c.setWorkloadRules( rulesJSON ) );
 }
 
 // --- CPU Info ---
@@ -1601,6 +2637,32 @@ static void printUsage()
     "Commands:\n"
     "  status                        Show full system status (dashboard)\n"
     "  monitor [-n COUNT] [-i SECS]  Live monitor (like top). Default: continuous, 2s\n"
+    "  monitor --stream [-n COUNT] [-i SECS] [--format ndjson|csv] [--extended]\n"
+    "                                Every metric per daemon sample as NDJSON (default) or\n"
+    "                                CSV; SECS may be fractional (default 1, fastest 0.25)\n"
+    "  monitor --stats [-w SECS] [-t METRIC=VALUE]...\n"
+    "                                Percentiles and time above threshold over the last\n"
+    "                                SECS (default 1800, max 7200), e.g. -t cpuTemp=90\n"
+    "  stats                         Daemon worker timing (cycle duration, overruns, period)\n"
+    "  stats ipc                     D-Bus calls per method: count, rate, latency, callers\n"
+    "  stats startup                 Daemon startup phases: start, duration, thread lane\n"
+    "  record -o FILE [-d SECS] [-i SECS]\n"
+    "                                Record every metric and event to a trace file\n"
+    "                                (default: until Ctrl+C, 1 s per sample)\n"
+    "  export -o FILE [-f csv|parquet] [-s SECS]\n"
+    "                                Write the daemon's history of the last SECS (default:\n"
+    "                                all of it) with its events as CSV or Parquet; the\n"
+    "                                format defaults to the file extension\n"
+    "  replay TRACE [--fan-profile FILE|ID]... [-T CELSIUS] [--gain G] [--tau SECS]\n"
+    "                                Replay a trace through fan curves offline: duty,\n"
+    "                                noise proxy and time above CELSIUS (default 85)\n"
+    "  bench [-n ITER] [--setters] [--profile ID [--switches N]]\n"
+    "                                D-Bus round-trip p50/p99 and calls/s (default 200);\n"
+    "                                --setters writes current values back, --profile times\n"
+    "                                switching to ID and back until the TDP changes\n"
+    "  batch [FILE|-] [--keep-going]\n"
+    "                                Run one command per line from FILE or stdin over one\n"
+    "                                daemon connection; with --json one result per line\n"
     "\n"
     "Profile management:\n"
     "  profile list                  List all profiles (built-in + custom)\n"
@@ -1615,6 +2677,8 @@ static void printUsage()
     "State map (auto-switch on power state change):\n"
     "  statemap get                  Show current settings/state map\n"
     "  statemap set <STATE> <ID>     Set profile for power state\n"
+    "  statemap rules <JSON>         Per-application profiles, e.g.\n"
+    "                                '[{\"exe\":\"*/steamapps/*\",\"profile\":\"ID\"}]'\n"
     "                                States: power_ac, power_bat, power_wc\n"
     "\n"
     "Fan control:\n"
@@ -1623,6 +2687,9 @@ static void printUsage()
     "  fan set <ID>                  Activate a fan profile by ID\n"
     "  fan apply <JSON>              Apply fan curves (keys: cpu, gpu, pump, waterCoolerFan)\n"
     "  fan revert                    Revert to saved fan profile\n"
+    "  fan trace                     Show fan loop latency histograms per stage\n"
+    "  fan calibrate [start|cancel|status]\n"
+    "                                Measure fan response, tune fan control to it\n"
     "\n"
     "Keyboard backlight:\n"
     "  keyboard info                 Show keyboard backlight capabilities\n"
@@ -1662,6 +2729,9 @@ static void printUsage()
     "System info:\n"
     "  cpu                           Show CPU info and capabilities\n"
     "  gpu                           Show GPU info and NVIDIA power control\n"
+    "  gpu tune start [JSON]         Search NVIDIA OC settings under your load\n"
+    "  gpu tune status               Show tuning progress and recommendation\n"
+    "  gpu tune cancel               Stop tuning and restore the profile's settings\n"
     "  power-limits                  Show ODM power limits\n"
     "\n"
     "General:\n"
@@ -1805,82 +2875,187 @@ static int cmdStatusJSON( ucc::UccdClient &c )
 }
 
 // ---------------------------------------------------------------------------
-// Main
+// Dispatch
 // ---------------------------------------------------------------------------
 
-int main( int argc, char *argv[] )
+/// replay TRACE [--fan-profile FILE|ID]... (offline; the daemon only serves profile IDs)
+static int runReplay( const std::vector< const char * > &args, bool jsonMode )
 {
-  QCoreApplication app( argc, argv );
-  app.setApplicationName( "ucc-cli" );
-  app.setApplicationVersion( UCC_VERSION_FULL );
-  app.setOrganizationName( "Uniwill" );
-
-  if ( argc < 2 )
+  if ( args.size() < 2 )
   {
-    printUsage();
+    std::fputs( "Usage: ucc-cli replay TRACE [--fan-profile FILE|ID]... [-T CELSIUS] [--gain G] [--tau SECS]\n",
+                stderr );
     return 1;
   }
-
-  // Check for global flags
-  bool jsonMode = false;
-  std::vector< const char * > args;
-  for ( int i = 1; i < argc; ++i )
-  {
-    if ( matchArg( argv[i], "--json" ) )
-      jsonMode = true;
-    else
-      args.push_back( argv[i] );
-  }
-
-  if ( args.empty() )
+  std::vector< const char * > candidates;
+  FanReplayOptions options;
+  for ( size_t i = 2; i < args.size(); ++i )
   {
-    printUsage();
-    return 1;
+    if ( matchArg( args[i], "--fan-profile" ) && i + 1 < args.size() )
+      candidates.push_back( args[++i] );
+    else if ( matchArg( args[i], "-T" ) && i + 1 < args.size() )
+      options.thresholdC = std::atof( args[++i] );
+    else if ( matchArg( args[i], "--gain" ) && i + 1 < args.size() )
+      options.thermalGainCPerPct = std::max( 0.0, std::atof( args[++i] ) );
+    else if ( matchArg( args[i], "--tau" ) && i + 1 < args.size() )
+      options.thermalTauS = std::max( 0.0, std::atof( args[++i] ) );
+    else if ( matchArg( args[i], "--min-speed" ) && i + 1 < args.size() )
+      options.minSpeed = std::atoi( args[++i] );
   }
+  return cmdReplay( args[1], candidates, options, jsonMode );
+}
 
+/// Run one command over an established daemon connection
+static int dispatch( ucc::UccdClient &client, const std::vector< const char * > &args, bool jsonMode )
+{
   const char *cmd = args[0];
 
-  // Help / version (no daemon needed)
-  if ( matchArg( cmd, "--help" ) || matchArg( cmd, "-h" ) || matchArg( cmd, "help" ) )
-  {
-    printUsage();
-    return 0;
-  }
-  if ( matchArg( cmd, "--version" ) || matchArg( cmd, "-v" ) || matchArg( cmd, "version" ) )
-  {
-    printVersion();
-    return 0;
-  }
-
-  // Create D-Bus client
-  ucc::UccdClient client;
-
-  if ( !client.isConnected() )
-  {
-    std::fputs( "Error: Cannot connect to uccd daemon (com.uniwill.uccd on system bus).\n"
-                "Make sure uccd is running: systemctl status uccd\n", stderr );
-    return 2;
-  }
-
-  // --- Dispatch commands ---
+  if ( matchArg( cmd, "replay" ) )
+    return runReplay( args, jsonMode );
 
   // status
   if ( matchArg( cmd, "status" ) )
     return jsonMode ? cmdStatusJSON( client ) : cmdStatus( client );
 
-  // monitor [-n COUNT] [-i INTERVAL]
+  // monitor [-n COUNT] [-i INTERVAL] | monitor --stream [--format ndjson|csv] [--extended]
+  // | monitor --stats [-w SECS] [-t METRIC=VALUE]...
   if ( matchArg( cmd, "monitor" ) || matchArg( cmd, "mon" ) )
   {
     int count = 0;       // 0 = infinite
-    int interval = 2;    // seconds
+    double interval = -1.0;  // seconds; default depends on the mode
+    bool stats = false;
+    bool stream = false;
+    bool csv = false;
+    bool extended = false;
+    int window = 1800;   // seconds
+    QVariantMap thresholds;
     for ( size_t i = 1; i < args.size(); ++i )
     {
       if ( matchArg( args[i], "-n" ) && i + 1 < args.size() )
         count = std::atoi( args[++i] );
       else if ( matchArg( args[i], "-i" ) && i + 1 < args.size() )
-        interval = std::atoi( args[++i] );
+        interval = std::atof( args[++i] );
+      else if ( matchArg( args[i], "--stats" ) )
+        stats = true;
+      else if ( matchArg( args[i], "--stream" ) )
+        stream = true;
+      else if ( matchArg( args[i], "--extended" ) )
+        extended = true;
+      else if ( matchArg( args[i], "--format" ) && i + 1 < args.size() )
+      {
+        const std::string format = args[++i];
+        if ( format != "ndjson" && format != "csv" )
+        {
+          std::fprintf( stderr, "Error: Unknown format '%s' (expected ndjson or csv)\n", format.c_str() );
+          return 1;
+        }
+        csv = format == "csv";
+      }
+      else if ( matchArg( args[i], "-w" ) && i + 1 < args.size() )
+        window = std::atoi( args[++i] );
+      else if ( matchArg( args[i], "-t" ) && i + 1 < args.size() )
+      {
+        const QString spec = QString::fromLocal8Bit( args[++i] );
+        const qsizetype eq = spec.indexOf( '=' );
+        bool valid = false;
+        const double value = eq > 0 ? spec.mid( eq + 1 ).toDouble( &valid ) : 0.0;
+        if ( !valid )
+        {
+          std::fprintf( stderr, "Error: Invalid threshold '%s' (expected METRIC=VALUE)\n", args[i] );
+          return 1;
+        }
+        thresholds.insert( spec.left( eq ), value );
+      }
+    }
+    if ( stats )
+      return cmdMonitorStats( client, std::max( window, 1 ), thresholds, jsonMode );
+    if ( interval < 0.0 )
+      interval = stream ? 1.0 : 2.0;
+    const int intervalMs = std::max( 1, static_cast< int >( std::lround( interval * 1000.0 ) ) );
+    if ( stream )
+      return cmdMonitorStream( client, count, intervalMs, csv, extended );
+    return cmdMonitor( client, count, intervalMs );
+  }
+
+  // stats [ipc]
+  if ( matchArg( cmd, "stats" ) )
+  {
+    if ( args.size() >= 2 && matchArg( args[1], "ipc" ) )
+      return cmdIpcStats( client, jsonMode );
+    if ( args.size() >= 2 && matchArg( args[1], "startup" ) )
+      return cmdStartupTimeline( client, jsonMode );
+    return cmdWorkerStats( client, jsonMode );
+  }
+
+  // record -o FILE [-d SECS] [-i SECS]
+  if ( matchArg( cmd, "record" ) )
+  {
+    const char *path = nullptr;
+    int duration = 0;        // 0 = until Ctrl+C
+    double interval = 1.0;   // seconds
+    for ( size_t i = 1; i < args.size(); ++i )
+    {
+      if ( matchArg( args[i], "-o" ) && i + 1 < args.size() )
+        path = args[++i];
+      else if ( matchArg( args[i], "-d" ) && i + 1 < args.size() )
+        duration = std::max( 0, std::atoi( args[++i] ) );
+      else if ( matchArg( args[i], "-i" ) && i + 1 < args.size() )
+        interval = std::atof( args[++i] );
+    }
+    if ( !path )
+    {
+      std::fputs( "Usage: ucc-cli record -o FILE [-d SECS] [-i SECS]\n", stderr );
+      return 1;
+    }
+    return cmdRecord( client, path, duration,
+                      std::max( 1, static_cast< int >( std::lround( interval * 1000.0 ) ) ) );
+  }
+
+  // export -o FILE [-f csv|parquet] [-s SECS]
+  if ( matchArg( cmd, "export" ) )
+  {
+    const char *path = nullptr;
+    const char *formatName = nullptr;
+    int seconds = 0;         // 0 = all history
+    for ( size_t i = 1; i < args.size(); ++i )
+    {
+      if ( matchArg( args[i], "-o" ) && i + 1 < args.size() )
+        path = args[++i];
+      else if ( matchArg( args[i], "-f" ) && i + 1 < args.size() )
+        formatName = args[++i];
+      else if ( matchArg( args[i], "-s" ) && i + 1 < args.size() )
+        seconds = std::max( 0, std::atoi( args[++i] ) );
+    }
+    const auto format = path ? ucc::parseHistoryExportFormat( formatName ? formatName : path )
+                             : std::nullopt;
+    if ( !format )
+    {
+      std::fputs( "Usage: ucc-cli export -o FILE [-f csv|parquet] [-s SECS]\n", stderr );
+      return 1;
+    }
+    return cmdExport( client, path, *format,
+                      seconds > 0 ? QDateTime::currentMSecsSinceEpoch() - qint64( seconds ) * 1000 : 0 );
+  }
+
+  // bench [-n ITER] [--setters] [--profile ID [--switches N]]
+  if ( matchArg( cmd, "bench" ) )
+  {
+    int iterations = 200;
+    bool setters = false;
+    const char *profileId = nullptr;
+    int switches = 5;
+    for ( size_t i = 1; i < args.size(); ++i )
+    {
+      if ( matchArg( args[i], "-n" ) && i + 1 < args.size() )
+        iterations = std::max( 1, std::atoi( args[++i] ) );
+      else if ( matchArg( args[i], "--setters" ) )
+        setters = true;
+      else if ( matchArg( args[i], "--profile" ) && i + 1 < args.size() )
+        profileId = args[++i];
+      else if ( matchArg( args[i], "--switches" ) && i + 1 < args.size() )
+        switches = std::max( 1, std::atoi( args[++i] ) );
     }
-    return cmdMonitor( client, count, interval );
+    return cmdBench( client, iterations, setters, profileId, switches, jsonMode );
   }
 
   // profile ...
@@ -1929,7 +3104,7 @@ int main( int argc, char *argv[] )
   {
     if ( args.size() < 2 )
     {
-      std::fputs( "Usage: ucc-cli statemap <get|set>\n", stderr );
+      std::fputs( "Usage: ucc-cli statemap <get|set|rules>\n", stderr );
       return 1;
     }
     const char *sub = args[1];
@@ -1940,6 +3115,11 @@ int main( int argc, char *argv[] )
       if ( args.size() < 4 ) { std::fputs( "Usage: ucc-cli statemap set <STATE> <PROFILE_ID>\n", stderr ); return 1; }
       return cmdStateMapSet( client, args[2], args[3] );
     }
+    if ( matchArg( sub, "rules" ) )
+    {
+      if ( args.size() < 3 ) { std::fputs( "Usage: ucc-cli statemap rules '<JSON array>'\n", stderr ); return 1; }
+      return cmdStateMapRules( client, args[2] );
+    }
     std::fprintf( stderr, "Unknown statemap subcommand: %s\n", sub );
     return 1;
   }
@@ -1949,7 +3129,7 @@ int main( int argc, char *argv[] )
   {
     if ( args.size() < 2 )
     {
-      std::fputs( "Usage: ucc-cli fan <list|get|set|apply|revert>\n", stderr );
+      std::fputs( "Usage: ucc-cli fan <list|get|set|apply|revert|trace|calibrate>\n", stderr );
       return 1;
     }
     const char *sub = args[1];
@@ -1972,6 +3152,20 @@ int main( int argc, char *argv[] )
     }
     if ( matchArg( sub, "revert" ) )
       return cmdFanRevert( client );
+    if ( matchArg( sub, "trace" ) )
+      return cmdFanTrace( client, jsonMode );
+    if ( matchArg( sub, "calibrate" ) )
+    {
+      const char *action = args.size() > 2 ? args[2] : "status";
+      if ( matchArg( action, "start" ) )
+        return cmdFanCalibrateStart( client );
+      if ( matchArg( action, "cancel" ) )
+        return cmdFanCalibrateCancel( client );
+      if ( matchArg( action, "status" ) )
+        return cmdFanCalibrateStatus( client, jsonMode );
+      std::fprintf( stderr, "Unknown fan calibrate action: %s\n", action );
+      return 1;
+    }
     std::fprintf( stderr, "Unknown fan subcommand: %s\n", sub );
     return 1;
   }
@@ -2159,7 +3353,21 @@ int main( int argc, char *argv[] )
 
   // gpu
   if ( matchArg( cmd, "gpu" ) )
-    return cmdGpuInfo( client );
+  {
+    if ( args.size() < 2 || !matchArg( args[1], "tune" ) )
+      return cmdGpuInfo( client );
+    const char *sub = args.size() > 2 ? args[2] : "status";
+    if ( matchArg( sub, "start" ) )
+      return cmdGpuTuneStart( client, args.size() > 3 ? args[3] : "" );
+    if ( matchArg( sub, "status" ) )
+      return cmdGpuTuneStatus( client );
+    if ( matchArg( sub, "cancel" ) )
+    {
+      return ok( client.cancelNvidiaOCTuning() );
+    }
+    std::fprintf( stderr, "Unknown gpu tune subcommand: %s\n", sub );
+    return 1;
+  }
 
   // power-limits
   if ( matchArg( cmd, "power-limits" ) || matchArg( cmd, "odm" ) )
@@ -2168,3 +3376,304 @@ int main( int argc, char *argv[] )
   std::fprintf( stderr, "Unknown command: %s\nTry: ucc-cli --help\n", cmd );
   return 1;
 }
+
+// ---------------------------------------------------------------------------
+// Batch mode
+// ---------------------------------------------------------------------------
+
+/// Split a batch line into words like a shell does: single and double
+/// quotes, backslash escapes and # comments, but no expansion.
+/// @return nullopt on an unterminated quote
+static std::optional< std::vector< std::string > > splitWords( const std::string &line )
+{
+  std::vector< std::string > words;
+  std::string word;
+  bool inWord = false;
+  char quote = 0;
+  for ( size_t i = 0; i < line.size(); ++i )
+  {
+    const char ch = line[i];
+    if ( quote == '\'' )
+    {
+      if ( ch == '\'' )
+        quote = 0;
+      else
+        word += ch;
+      continue;
+    }
+    if ( quote == '"' )
+    {
+      if ( ch == '"' )
+        quote = 0;
+      else if ( ch == '\\' && i + 1 < line.size() && ( line[i + 1] == '"' || line[i + 1] == '\\' ) )
+        word += line[++i];
+      else
+        word += ch;
+      continue;
+    }
+    if ( ch == ' ' || ch == '\t' || ch == '\r' )
+    {
+      if ( inWord )
+        words.push_back( std::exchange( word, {} ) );
+      inWord = false;
+      continue;
+    }
+    if ( ch == '#' && !inWord )
+      break;
+    inWord = true;
+    if ( ch == '\'' || ch == '"' )
+      quote = ch;
+    else if ( ch == '\\' && i + 1 < line.size() )
+      word += line[++i];
+    else
+      word += ch;
+  }
+  if ( quote )
+    return std::nullopt;
+  if ( inWord )
+    words.push_back( std::move( word ) );
+  return words;
+}
+
+/// Redirects stdout or stderr into memory until finish()
+class OutputCapture
+{
+public:
+  explicit OutputCapture( int fd ) : m_fd( fd )
+  {
+    flushAll();
+    m_buffer = ::memfd_create( "ucc-cli-batch", MFD_CLOEXEC );
+    m_saved = m_buffer >= 0 ? ::dup( fd ) : -1;
+    if ( m_saved >= 0 )
+      ::dup2( m_buffer, fd );
+  }
+
+  ~OutputCapture() { finish(); }
+
+  OutputCapture( const OutputCapture & ) = delete;
+  OutputCapture &operator=( const OutputCapture & ) = delete;
+
+  /// Restore the stream; @return everything written to it meanwhile
+  std::string finish()
+  {
+    std::string text;
+    if ( m_saved >= 0 )
+    {
+      flushAll();
+      ::dup2( m_saved, m_fd );
+      ::close( m_saved );
+      m_saved = -1;
+      char buf[4096];
+      ssize_t n;
+      ::lseek( m_buffer, 0, SEEK_SET );
+      while ( ( n = ::read( m_buffer, buf, sizeof( buf ) ) ) > 0 )
+        text.append( buf, static_cast< size_t >( n ) );
+    }
+    if ( m_buffer >= 0 )
+      ::close( m_buffer );
+    m_buffer = -1;
+    return text;
+  }
+
+private:
+  static void flushAll()
+  {
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush( nullptr );
+  }
+
+  int m_fd;
+  int m_buffer = -1;
+  int m_saved = -1;
+};
+
+/// One NDJSON result line: the command's exit code, its output (parsed when
+/// it is JSON) and what it wrote to stderr
+static void printBatchResult( int lineNo, const std::string &line, int rc,
+                              const std::string &out, const std::string &err )
+{
+  QJsonObject result;
+  result["line"] = lineNo;
+  result["command"] = QString::fromStdString( line );
+  result["exit"] = rc;
+
+  QJsonParseError parseError;
+  const QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( out ), &parseError );
+  if ( parseError.error == QJsonParseError::NoError && doc.isObject() )
+    result["result"] = doc.object();
+  else if ( parseError.error == QJsonParseError::NoError && doc.isArray() )
+    result["result"] = doc.array();
+  else if ( !out.empty() )
+    result["output"] = QString::fromStdString( out ).trimmed();
+  if ( !err.empty() )
+    result["error"] = QString::fromStdString( err ).trimmed();
+
+  const QByteArray json = QJsonDocument( result ).toJson( QJsonDocument::Compact );
+  std::fwrite( json.constData(), 1, static_cast< size_t >( json.size() ), stdout );
+  std::fputc( '\n', stdout );
+  std::fflush( stdout );
+}
+
+/// batch [FILE|-] [--keep-going]: run one command per line over this
+/// connection, so scripts pay the D-Bus setup once instead of per command
+static int cmdBatch( ucc::UccdClient &c, const char *path, bool keepGoing, bool jsonMode )
+{
+  std::ifstream file;
+  if ( path && !matchArg( path, "-" ) )
+  {
+    file.open( path );
+    if ( !file )
+    {
+      std::fprintf( stderr, "Error: Cannot open %s: %s\n", path, std::strerror( errno ) );
+      return 1;
+    }
+  }
+  std::istream &in = file.is_open() ? file : std::cin;
+
+  int status = 0;
+  int lineNo = 0;
+  std::string line;
+  while ( std::getline( in, line ) )
+  {
+    ++lineNo;
+    const auto words = splitWords( line );
+    if ( words && words->empty() )
+      continue;
+
+    // --json applies to the line it is on, or to every line when given to batch
+    bool lineJson = jsonMode;
+    std::vector< const char * > args;
+    for ( const auto &w : words.value_or( std::vector< std::string >{} ) )
+    {
+      if ( w == "--json" )
+        lineJson = true;
+      else
+        args.push_back( w.c_str() );
+    }
+
+    std::optional< OutputCapture > out, err;
+    if ( jsonMode )
+    {
+      out.emplace( STDOUT_FILENO );
+      err.emplace( STDERR_FILENO );
+    }
+
+    int rc;
+    if ( !words )
+    {
+      std::fprintf( stderr, "Error: Unterminated quote on line %d\n", lineNo );
+      rc = 1;
+    }
+    else if ( args.empty() )
+    {
+      std::fprintf( stderr, "Error: No command on line %d\n", lineNo );
+      rc = 1;
+    }
+    else if ( matchArg( args[0], "batch" ) )
+    {
+      std::fputs( "Error: batch cannot run inside a batch\n", stderr );
+      rc = 1;
+    }
+    else
+      rc = dispatch( c, args, lineJson );
+
+    if ( jsonMode )
+    {
+      const std::string outText = out->finish();
+      const std::string errText = err->finish();
+      printBatchResult( lineNo, line, rc, outText, errText );
+    }
+    else
+      std::fflush( stdout );
+
+    if ( rc != 0 )
+    {
+      if ( status == 0 )
+        status = rc;
+      if ( !keepGoing )
+        break;
+    }
+  }
+  return status;
+}
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+  QCoreApplication app( argc, argv );
+  app.setApplicationName( "ucc-cli" );
+  app.setApplicationVersion( UCC_VERSION_FULL );
+  app.setOrganizationName( "Uniwill" );
+
+  if ( argc < 2 )
+  {
+    printUsage();
+    return 1;
+  }
+
+  // Check for global flags
+  bool jsonMode = false;
+  std::vector< const char * > args;
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( matchArg( argv[i], "--json" ) )
+      jsonMode = true;
+    else
+      args.push_back( argv[i] );
+  }
+
+  if ( args.empty() )
+  {
+    printUsage();
+    return 1;
+  }
+
+  const char *cmd = args[0];
+
+  // Help / version (no daemon needed)
+  if ( matchArg( cmd, "--help" ) || matchArg( cmd, "-h" ) || matchArg( cmd, "help" ) )
+  {
+    printUsage();
+    return 0;
+  }
+  if ( matchArg( cmd, "--version" ) || matchArg( cmd, "-v" ) || matchArg( cmd, "version" ) )
+  {
+    printVersion();
+    return 0;
+  }
+
+  // replay (offline)
+  if ( matchArg( cmd, "replay" ) )
+    return runReplay( args, jsonMode );
+
+  // Create D-Bus client
+  ucc::UccdClient client;
+
+  if ( !client.isConnected() )
+  {
+    std::fputs( "Error: Cannot connect to uccd daemon (com.uniwill.uccd on system bus).\n"
+                "Make sure uccd is running: systemctl status uccd\n", stderr );
+    return 2;
+  }
+
+  // batch [FILE|-] [--keep-going]
+  if ( matchArg( cmd, "batch" ) )
+  {
+    const char *path = nullptr;
+    bool keepGoing = false;
+    for ( size_t i = 1; i < args.size(); ++i )
+    {
+      if ( matchArg( args[i], "--keep-going" ) )
+        keepGoing = true;
+      else
+        path = args[i];
+    }
+    return cmdBatch( client, path, keepGoing, jsonMode );
+  }
+
+  return dispatch( client, args, jsonMode );
+}
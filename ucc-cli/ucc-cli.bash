@@ -19,18 +19,21 @@ _ucc_cli()
     local cur prev words cword
     _init_completion || return
 
-    local commands="status monitor cpu gpu power-limits profile statemap fan keyboard brightness webcam fnlock watercooler charging help version"
+    local commands="status monitor stats bench record replay batch cpu gpu power-limits profile statemap fan keyboard brightness webcam fnlock watercooler charging help version"
 
     # Sub-commands per top-level command
     local profile_cmds="list get set defaults customs apply save delete"
     local statemap_cmds="get set"
-    local fan_cmds="list get set apply revert"
+    local fan_cmds="list get set apply revert trace"
     local keyboard_cmds="info get set color profiles activate"
     local brightness_cmds="get set"
     local webcam_cmds="get set"
     local fnlock_cmds="get set"
     local watercooler_cmds="status enable disable fan pump led led-off"
     local charging_cmds="status set-profile set-priority set-thresholds"
+    local stats_cmds="ipc"
+    local gpu_cmds="tune"
+    local gpu_tune_cmds="start status cancel"
 
     # Global flags
     local global_flags="--json --help --version"
@@ -88,7 +91,29 @@ _ucc_cli()
                 COMPREPLY=( $(compgen -W "$charging_cmds" -- "$cur") )
                 return ;;
             monitor|mon)
-                COMPREPLY=( $(compgen -W "-n -i" -- "$cur") )
+                COMPREPLY=( $(compgen -W "-n -i --stream --format --extended --stats -w -t" -- "$cur") )
+                return ;;
+            stats)
+                COMPREPLY=( $(compgen -W "$stats_cmds" -- "$cur") )
+                return ;;
+            gpu)
+                COMPREPLY=( $(compgen -W "$gpu_cmds" -- "$cur") )
+                return ;;
+            bench)
+                COMPREPLY=( $(compgen -W "-n --setters --profile --switches" -- "$cur") )
+                return ;;
+            record)
+                COMPREPLY=( $(compgen -W "-o -d -i" -- "$cur") )
+                return ;;
+            replay)
+                _filedir
+                return ;;
+            batch)
+                if [[ "$cur" == -* ]]; then
+                    COMPREPLY=( $(compgen -W "--keep-going" -- "$cur") )
+                else
+                    _filedir
+                fi
                 return ;;
         esac
         return
@@ -96,6 +121,12 @@ _ucc_cli()
 
     # Complete arguments to subcommands
     case "$cmd" in
+        gpu)
+            if [[ "$subcmd" == "tune" && "$prev" == "tune" ]]; then
+                COMPREPLY=( $(compgen -W "$gpu_tune_cmds" -- "$cur") )
+                return
+            fi
+            ;;
         profile|prof)
             case "$subcmd" in
                 set|activate|delete|del|rm)
@@ -25,6 +25,9 @@ import * as Slider from 'resource:///org/gnome/shell/ui/slider.js';
 
 import { UccdClient } from './uccdClient.js';
 
+// MetricsSample pushes older than this no longer replace the fast poll
+const SAMPLE_STALE_US = 3 * GLib.USEC_PER_SEC;
+
 // ---------------------------------------------------------------------------
 // Helpers
 // ---------------------------------------------------------------------------
@@ -148,12 +151,7 @@ class UccIndicator extends PanelMenu.Button {
         this._client.watch(connected => {
             this._state.connected = connected;
             this._updateConnectionUI();
-            if (connected) {
-                this._loadCapabilities();
-                this._loadProfiles();
-                this._pollMetrics();
-                this._pollSlowState();
-            }
+            if (connected) this._onDaemonAppeared();
         });
 
         // Watch ~/.config/uccrc for changes (so we pick up edits from the GUI)
@@ -164,9 +162,33 @@ class UccIndicator extends PanelMenu.Button {
         // Timers
         this._fastTimerId = 0;
         this._slowTimerId = 0;
+        this._propertiesPushed = false;
+        this._lastSampleAt = 0;
+        this._metricsInFlight = false;
+        this._slowStateInFlight = false;
+        this._destroyed = false;
         this._startTimers();
     }
 
+    /** Load everything once and subscribe to the daemon's pushes. */
+    async _onDaemonAppeared() {
+        this._client.subscribeMetricsSamples(
+            (ts, values) => this._onMetricsSample(ts, values));
+        // Profiles and toggles are pushed as PropertiesChanged where the
+        // daemon supports it; poll them only otherwise
+        const [props] = await Promise.all([
+            this._client.subscribePropertiesChanged(changed => this._applySlowState(changed)),
+            this._loadCapabilities(),
+            this._loadProfiles(),
+            this._pollMetrics(),
+        ]);
+        if (this._destroyed) return;
+        this._propertiesPushed = props !== null;
+        if (props) this._applySlowState(props);
+        else this._pollSlowState();
+        if (this._fastTimerId) this._updateSlowTimer();
+    }
+
     // -----------------------------------------------------------------------
     // Popup layout
     // -----------------------------------------------------------------------
@@ -613,13 +635,14 @@ class UccIndicator extends PanelMenu.Button {
             const id = s.profileIds[i];
             const name = s.profileNames[i] ?? id;
             const isActive = id === s.activeProfileId;
-            const row = this._makeChooserRow(name, isActive, () => {
-                if (this._client.setActiveProfile(id)) {
-                    s.activeProfileId = id;
-                    s.activeProfileName = name;
-                    this._rebuildProfileButtons();
-                    this._pollSlowState(); // refresh fan/keyboard sub-profiles
-                }
+            const row = this._makeChooserRow(name, isActive, async () => {
+                if (!await this._client.setActiveProfile(id) || this._destroyed) return;
+                s.activeProfileId = id;
+                s.activeProfileName = name;
+                this._rebuildProfileButtons();
+                // fan/keyboard sub-profiles follow as ActiveProfileJSON
+                // changes where the daemon pushes them
+                if (!this._propertiesPushed) this._pollSlowState();
             });
             this._profileListBox.add_child(row);
         }
@@ -667,8 +690,8 @@ class UccIndicator extends PanelMenu.Button {
         }
     }
 
-    _applyFanProfile(fanProfileId) {
-        const raw = this._client.getFanProfile(fanProfileId);
+    async _applyFanProfile(fanProfileId) {
+        const raw = await this._client.getFanProfile(fanProfileId);
         if (!raw) return;
         try {
             const src = JSON.parse(raw);
@@ -718,15 +741,21 @@ class UccIndicator extends PanelMenu.Button {
     // Data loading
     // -----------------------------------------------------------------------
 
-    _loadCapabilities() {
-        if (!this._client.isDeviceSupported()) {
+    async _loadCapabilities() {
+        const [supported, wc, sysInfoRaw] = await Promise.all([
+            this._client.isDeviceSupported(),
+            this._client.getWaterCoolerSupported(),
+            this._client.getSystemInfoJSON(),
+        ]);
+        if (this._destroyed || !this._client.connected) return;
+
+        if (!supported) {
             log('[UCC] Device not supported — hiding indicator');
             this._stopTimers();
             this.visible = false;
             return;
         }
 
-        const wc = this._client.getWaterCoolerSupported();
         if (wc !== this._state.waterCoolerSupported) {
             this._state.waterCoolerSupported = wc;
             this._wcMetricsBox.visible = wc;
@@ -736,7 +765,6 @@ class UccIndicator extends PanelMenu.Button {
             }
         }
 
-        const sysInfoRaw = this._client.getSystemInfoJSON();
         if (sysInfoRaw) {
             try {
                 const si = JSON.parse(sysInfoRaw);
@@ -749,12 +777,18 @@ class UccIndicator extends PanelMenu.Button {
         }
     }
 
-    _loadProfiles() {
+    async _loadProfiles() {
         const s = this._state;
 
+        const [raw, ap, fpRaw] = await Promise.all([
+            this._client.getDefaultProfilesJSON(),
+            this._client.getActiveProfileJSON(),
+            this._client.getFanProfileNames(),
+        ]);
+        if (this._destroyed) return;
+
         // Built-in profiles
         const names = [], ids = [];
-        const raw = this._client.getDefaultProfilesJSON();
         if (raw) {
             try {
                 for (const p of JSON.parse(raw)) {
@@ -792,7 +826,6 @@ class UccIndicator extends PanelMenu.Button {
         s.profileIds = ids;
 
         // Active profile
-        const ap = this._client.getActiveProfileJSON();
         if (ap) {
             try {
                 const obj = JSON.parse(ap);
@@ -805,7 +838,6 @@ class UccIndicator extends PanelMenu.Button {
 
         // Fan profiles
         const fanNames = [], fanIds = [];
-        const fpRaw = this._client.getFanProfileNames();
         if (fpRaw) {
             try {
                 for (const p of JSON.parse(fpRaw)) {
@@ -887,10 +919,19 @@ class UccIndicator extends PanelMenu.Button {
             this._pollMetrics();
             return GLib.SOURCE_CONTINUE;
         });
-        this._slowTimerId = GLib.timeout_add(GLib.PRIORITY_DEFAULT, 5000, () => {
-            this._pollSlowState();
-            return GLib.SOURCE_CONTINUE;
-        });
+        this._updateSlowTimer();
+    }
+
+    /** Poll slow state every 5 s unless the daemon pushes its changes. */
+    _updateSlowTimer() {
+        if (this._propertiesPushed) {
+            if (this._slowTimerId) { GLib.source_remove(this._slowTimerId); this._slowTimerId = 0; }
+        } else if (!this._slowTimerId) {
+            this._slowTimerId = GLib.timeout_add(GLib.PRIORITY_DEFAULT, 5000, () => {
+                this._pollSlowState();
+                return GLib.SOURCE_CONTINUE;
+            });
+        }
     }
 
     _stopTimers() {
@@ -898,46 +939,101 @@ class UccIndicator extends PanelMenu.Button {
         if (this._slowTimerId) { GLib.source_remove(this._slowTimerId); this._slowTimerId = 0; }
     }
 
-    _pollMetrics() {
-        if (!this._client.connected) return;
+    /** Fetch one GetLiveSnapshot unless MetricsSample already covers it. */
+    async _pollMetrics() {
+        if (!this._client.connected || this._metricsInFlight) return;
         const s = this._state;
 
-        s.cpuTemp   = this._client.getCpuTemperature();
-        s.gpuTemp   = this._client.getGpuTemperature();
-        s.cpuFreq   = this._client.getCpuFrequency();
-        s.gpuFreq   = this._client.getGpuFrequency();
-        s.cpuPower  = this._client.getCpuPower();
-        s.gpuPower  = this._client.getGpuPower();
-        s.cpuFanRPM = this._client.getFanSpeedRPM();
-        s.gpuFanRPM = this._client.getGpuFanSpeedRPM();
-        s.cpuFanPct = this._client.getFanSpeedPercent();
-        s.gpuFanPct = this._client.getGpuFanSpeedPercent();
+        // Temperatures, clocks, power and duty arrive via MetricsSample
+        // while the daemon keeps pushing; poll them only as a fallback.
+        const pushed = this._lastSampleAt &&
+            GLib.get_monotonic_time() - this._lastSampleAt < SAMPLE_STALE_US;
+        if (pushed && !s.waterCoolerSupported) return;
+
+        this._metricsInFlight = true;
+        const snap = await this._client.getLiveSnapshot();
+        this._metricsInFlight = false;
+        if (!snap || this._destroyed) return;
+
+        const take = (key, field) => { s[key] = snap[field] ?? -1; };
+        if (!pushed) {
+            take('cpuTemp', 'cpuTemp');
+            take('gpuTemp', 'gpuTemp');
+            take('cpuFreq', 'cpuFrequencyMHz');
+            take('gpuFreq', 'gpuFrequencyMHz');
+            take('cpuPower', 'cpuPowerW');
+            take('gpuPower', 'gpuPowerW');
+            take('cpuFanPct', 'cpuFanPercent');
+            take('gpuFanPct', 'gpuFanPercent');
+            this._updateFanRPM();
+        }
 
         if (s.waterCoolerSupported) {
-            s.wcFanSpeed  = this._client.getWaterCoolerFanSpeed();
-            s.wcPumpLevel = this._client.getWaterCoolerPumpLevel();
+            take('wcFanSpeed', 'waterCoolerFanSpeed');
+            take('wcPumpLevel', 'waterCoolerPumpLevel');
         }
 
         this._updateDashboard();
     }
 
-    _pollSlowState() {
-        if (!this._client.connected) return;
+    /** The daemon reports fan duty only; RPM is estimated from it. */
+    _updateFanRPM() {
+        const s = this._state;
+        s.cpuFanRPM = s.cpuFanPct >= 0 ? s.cpuFanPct * 60 : -1;
+        s.gpuFanRPM = s.gpuFanPct >= 0 ? s.gpuFanPct * 60 : -1;
+    }
+
+    /** Apply a MetricsSample push (values in uccd MetricId order). */
+    _onMetricsSample(_ts, values) {
+        const s = this._state;
+        const take = (key, idx, round = true) => {
+            const v = values[idx];
+            if (v !== undefined && !Number.isNaN(v)) s[key] = round ? Math.round(v) : v;
+        };
+        take('cpuTemp', 0);
+        take('cpuFanPct', 1);
+        take('cpuPower', 2, false);
+        take('cpuFreq', 3);
+        take('gpuTemp', 4);
+        take('gpuFanPct', 5);
+        take('gpuPower', 6, false);
+        take('gpuFreq', 7);
+        this._updateFanRPM();
+        this._lastSampleAt = GLib.get_monotonic_time();
+        this._updateDashboard();
+    }
+
+    /** Fallback for daemons without D-Bus properties: read them all at once. */
+    async _pollSlowState() {
+        if (!this._client.connected || this._slowStateInFlight) return;
+        this._slowStateInFlight = true;
+        const state = await this._client.getSlowState();
+        this._slowStateInFlight = false;
+        if (state && !this._destroyed) this._applySlowState(state);
+    }
+
+    /**
+     * Apply slow state keyed by the daemon's property names, either all of
+     * them or just the ones a PropertiesChanged signal carries.
+     */
+    _applySlowState(props) {
         const s = this._state;
 
         // Active profile
-        const ap = this._client.getActiveProfileJSON();
+        const ap = props.ActiveProfileJSON;
         if (ap) {
             try {
                 const obj = JSON.parse(ap);
                 const newId = obj.id ?? '';
-                if (newId !== s.activeProfileId) {
+                const fanId = obj.fan?.fanProfile ?? '';
+                // Extract keyboard profile reference
+                const kbId = this._resolveKeyboardProfileId(obj.selectedKeyboardProfile ?? '');
+                if (newId !== s.activeProfileId || fanId !== s.activeProfileFanId ||
+                    kbId !== s.activeKeyboardProfileId) {
                     s.activeProfileId = newId;
                     s.activeProfileName = obj.name ?? '';
-                    s.activeProfileFanId = obj.fan?.fanProfile ?? '';
-                    // Extract keyboard profile reference
-                    const kbRef = obj.selectedKeyboardProfile ?? '';
-                    s.activeKeyboardProfileId = this._resolveKeyboardProfileId(kbRef);
+                    s.activeProfileFanId = fanId;
+                    s.activeKeyboardProfileId = kbId;
                     this._rebuildProfileButtons();
                     this._rebuildFanProfileButtons();
                     this._rebuildKeyboardProfileButtons();
@@ -951,7 +1047,7 @@ class UccIndicator extends PanelMenu.Button {
         }
 
         // Power state
-        const ps = this._client.getPowerState();
+        const ps = props.PowerState;
         if (ps && ps !== s.powerState) {
             s.powerState = ps;
             this._powerLabel.text = mapPowerState(ps);
@@ -964,35 +1060,33 @@ class UccIndicator extends PanelMenu.Button {
         }
 
         // Hardware toggles
-        const webcam = this._client.getWebcamEnabled();
-        if (webcam !== s.webcamEnabled) {
+        const webcam = props.WebcamSWStatus;
+        if (webcam !== undefined && webcam !== s.webcamEnabled) {
             s.webcamEnabled = webcam;
             this._webcamSwitch.checked = webcam;
             this._webcamSwitch.label = webcam ? 'ON' : 'OFF';
         }
 
-        const fn = this._client.getFnLock();
-        if (fn !== s.fnLock) {
+        const fn = props.FnLockStatus;
+        if (fn !== undefined && fn !== s.fnLock) {
             s.fnLock = fn;
             this._fnLockSwitch.checked = fn;
             this._fnLockSwitch.label = fn ? 'ON' : 'OFF';
         }
 
-        const br = this._client.getDisplayBrightness();
-        if (br !== s.displayBrightness) {
+        const br = props.DisplayBrightness;
+        if (br !== undefined && br >= 0 && br !== s.displayBrightness) {
             s.displayBrightness = br;
             this._brightnessSlider.value = br / 100;
             this._brightnessValueLabel.text = `${br}%`;
         }
 
         // Water cooler
-        if (s.waterCoolerSupported) {
-            const wcEn = this._client.isWaterCoolerEnabled();
-            if (wcEn !== s.wcEnabled) {
-                s.wcEnabled = wcEn;
-                this._wcEnableSwitch.checked = wcEn;
-                this._wcEnableSwitch.label = wcEn ? 'ON' : 'OFF';
-            }
+        const wcEn = props.WaterCoolerEnabled;
+        if (s.waterCoolerSupported && wcEn !== undefined && wcEn !== s.wcEnabled) {
+            s.wcEnabled = wcEn;
+            this._wcEnableSwitch.checked = wcEn;
+            this._wcEnableSwitch.label = wcEn ? 'ON' : 'OFF';
         }
     }
 
@@ -1120,6 +1214,7 @@ class UccIndicator extends PanelMenu.Button {
     }
 
     destroy() {
+        this._destroyed = true;
         this._stopTimers();
         this._stopUccrcMonitor();
         this._client?.destroy();
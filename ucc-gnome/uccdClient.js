@@ -18,6 +18,10 @@
  *
  * Mirrors the functionality of libucc-dbus/UccdClient but in pure GJS/Gio.
  * All calls go to the system bus: com.uniwill.uccd /com/uniwill/uccd.
+ *
+ * Every call is asynchronous and returns a Promise: this code runs on the
+ * compositor thread, where a blocking call would stall the whole session
+ * for as long as the daemon takes to answer.
  */
 
 import Gio from 'gi://Gio';
@@ -27,17 +31,29 @@ const BUS_NAME    = 'com.uniwill.uccd';
 const OBJECT_PATH = '/com/uniwill/uccd';
 const IFACE_NAME  = 'com.uniwill.uccd';
 
+const CALL_TIMEOUT_MS = 2000;
+const UNKNOWN_METHOD  = 'org.freedesktop.DBus.Error.UnknownMethod';
+
 /**
- * Synchronous D-Bus wrapper around uccd.
+ * Asynchronous D-Bus wrapper around uccd.
  *
  * Connection state is tracked via Gio.bus_watch_name_on_connection().
+ * Calls made while the daemon is away resolve to null (false for setters)
+ * without touching the bus; destroy() cancels the ones in flight.
  */
 export class UccdClient {
     constructor() {
         this._bus = Gio.bus_get_sync(Gio.BusType.SYSTEM, null);
+        this._cancellable = new Gio.Cancellable();
         this._connected = false;
         this._watchId = 0;
         this._onConnectionChanged = null;
+        this._sampleSignalId = 0;
+        this._onMetricsSample = null;
+        this._propsSignalId = 0;
+        this._onPropertiesChanged = null;
+        // null: not tried yet; false: daemon predates GetLiveSnapshot
+        this._snapshotApi = null;
     }
 
     get connected() { return this._connected; }
@@ -50,7 +66,7 @@ export class UccdClient {
         this._onConnectionChanged = cb;
         this._watchId = Gio.bus_watch_name_on_connection(
             this._bus, BUS_NAME, Gio.BusNameWatcherFlags.NONE,
-            () => { this._connected = true;  cb?.(true);  },
+            () => { this._connected = true;  this._snapshotApi = null; cb?.(true);  },
             () => { this._connected = false; cb?.(false); },
         );
     }
@@ -59,40 +75,55 @@ export class UccdClient {
     // Low-level helpers
     // -----------------------------------------------------------------------
 
-    /** Call a D-Bus method and return the first result value (or null). */
-    _call(method, args = null, signature = null) {
-        if (!this._connected) return null;
-        try {
-            const params = args !== null
-                ? new GLib.Variant(`(${signature})`, args)
-                : null;
-            const result = this._bus.call_sync(
-                BUS_NAME, OBJECT_PATH, IFACE_NAME,
+    /**
+     * Call a method on the uccd object.
+     * @returns {Promise<GLib.Variant>} the reply tuple; rejects with the
+     *          GLib.Error of a failed call
+     */
+    _invoke(iface, method, params, cancellable = this._cancellable) {
+        return new Promise((resolve, reject) => {
+            this._bus.call(
+                BUS_NAME, OBJECT_PATH, iface,
                 method, params, null,
-                Gio.DBusCallFlags.NONE, 2000, null,
+                Gio.DBusCallFlags.NONE, CALL_TIMEOUT_MS, cancellable,
+                (conn, res) => {
+                    try {
+                        resolve(conn.call_finish(res));
+                    } catch (e) {
+                        reject(e);
+                    }
+                },
             );
-            if (!result) return null;
-            const child = result.get_child_value(0);
-            return child.get_type_string() === 'v'
-                ? child.recursiveUnpack()
-                : child.recursiveUnpack();
+        });
+    }
+
+    static _params(args, signature) {
+        return args !== null ? new GLib.Variant(`(${signature})`, args) : null;
+    }
+
+    static _isUnknownMethod(e) {
+        return e instanceof GLib.Error &&
+            Gio.DBusError.is_remote_error(e) &&
+            Gio.DBusError.get_remote_error(e) === UNKNOWN_METHOD;
+    }
+
+    /** Call a D-Bus method and resolve to the first result value (or null). */
+    async _call(method, args = null, signature = null) {
+        if (!this._connected) return null;
+        try {
+            const result = await this._invoke(
+                IFACE_NAME, method, UccdClient._params(args, signature));
+            return result ? result.get_child_value(0).recursiveUnpack() : null;
         } catch (_e) {
             return null;
         }
     }
 
-    /** Call a void-returning method; returns true on success. */
-    _callVoid(method, args = null, signature = null) {
+    /** Call a void-returning method; resolves to true on success. */
+    async _callVoid(method, args = null, signature = null, cancellable = this._cancellable) {
         if (!this._connected) return false;
         try {
-            const params = args !== null
-                ? new GLib.Variant(`(${signature})`, args)
-                : null;
-            this._bus.call_sync(
-                BUS_NAME, OBJECT_PATH, IFACE_NAME,
-                method, params, null,
-                Gio.DBusCallFlags.NONE, 2000, null,
-            );
+            await this._invoke(IFACE_NAME, method, UccdClient._params(args, signature), cancellable);
             return true;
         } catch (_e) {
             return false;
@@ -106,10 +137,8 @@ export class UccdClient {
      * The daemon returns a{sv} → { speed: a{sv}{timestamp:x, data:i},
      *                               temp:  a{sv}{timestamp:x, data:i} }
      */
-    _readFanData(method, key) {
-        const outer = this._call(method);
-        if (!outer) return null;
-        const inner = outer[key];
+    static _fanValue(outer, key) {
+        const inner = outer?.[key];
         if (!inner) return null;
         // Treat timestamp==0 as missing data (daemon not yet populated)
         if (inner.timestamp === 0 || inner.timestamp === 0n) return null;
@@ -117,9 +146,8 @@ export class UccdClient {
         return v >= 0 ? v : null;
     }
 
-    /** Parse a JSON-returning D-Bus method and extract a numeric key. */
-    _readJsonNum(method, key) {
-        const raw = this._call(method);
+    /** Numeric key of a JSON document, null if absent or negative. */
+    static _jsonNum(raw, key) {
         if (!raw) return null;
         try {
             const v = JSON.parse(raw)[key];
@@ -128,68 +156,69 @@ export class UccdClient {
     }
 
     // -----------------------------------------------------------------------
-    // Monitoring — fast poll (temperatures, frequencies, power, fans)
+    // Monitoring — one snapshot per fast poll
     // -----------------------------------------------------------------------
 
-    getCpuTemperature() {
-        return this._readFanData('GetFanDataCPU', 'temp') ?? -1;
-    }
-
-    getGpuTemperature() {
-        // Prefer dGPU JSON, fall back to iGPU JSON
-        return this._readJsonNum('GetDGpuInfoValuesJSON', 'temp')
-            ?? this._readJsonNum('GetIGpuInfoValuesJSON', 'temp')
-            ?? -1;
-    }
-
-    getCpuFrequency() { return this._call('GetCpuFrequencyMHz') ?? -1; }
-
-    getGpuFrequency() {
-        return this._readJsonNum('GetDGpuInfoValuesJSON', 'coreFrequency')
-            ?? this._readJsonNum('GetDGpuInfoValuesJSON', 'coreFreq')
-            ?? -1;
-    }
-
-    getCpuPower() {
-        return this._readJsonNum('GetCpuPowerValuesJSON', 'powerDraw') ?? -1;
-    }
-
-    getGpuPower() {
-        return this._readJsonNum('GetDGpuInfoValuesJSON', 'powerDraw')
-            ?? this._readJsonNum('GetIGpuInfoValuesJSON', 'powerDraw')
-            ?? -1;
-    }
-
-    getFanSpeedRPM() {
-        const pct = this._readFanData('GetFanDataCPU', 'speed');
-        return pct !== null ? pct * 60 : -1;
-    }
-
-    getGpuFanSpeedRPM() {
-        const g1 = this._readFanData('GetFanDataGPU1', 'speed');
-        const g2 = this._readFanData('GetFanDataGPU2', 'speed');
-        if (g1 !== null && g2 !== null) return Math.round((g1 + g2) / 2) * 60;
-        if (g1 !== null) return g1 * 60;
-        if (g2 !== null) return g2 * 60;
-        return -1;
-    }
-
-    getFanSpeedPercent() {
-        return this._readFanData('GetFanDataCPU', 'speed') ?? -1;
+    /**
+     * All live readings in one round trip (uccd's GetLiveSnapshot).
+     *
+     * Keys are those of the daemon's reply: cpuTemp, gpuTemp,
+     * cpuFrequencyMHz, gpuFrequencyMHz, cpuPowerW, gpuPowerW, cpuFanPercent,
+     * gpuFanPercent, waterCoolerFanSpeed, waterCoolerPumpLevel, ...; a
+     * reading the daemon does not have is left out.  Daemons without the
+     * method are asked field by field, concurrently.
+     * @returns {Promise<object|null>}
+     */
+    async getLiveSnapshot() {
+        if (!this._connected) return null;
+        if (this._snapshotApi !== false) {
+            try {
+                const result = await this._invoke(IFACE_NAME, 'GetLiveSnapshot', null);
+                this._snapshotApi = true;
+                return result.get_child_value(0).recursiveUnpack();
+            } catch (e) {
+                if (!UccdClient._isUnknownMethod(e)) return null;
+                this._snapshotApi = false;
+            }
+        }
+        return this._getLiveSnapshotPerField();
     }
 
-    getGpuFanSpeedPercent() {
-        const g1 = this._readFanData('GetFanDataGPU1', 'speed');
-        const g2 = this._readFanData('GetFanDataGPU2', 'speed');
-        if (g1 !== null && g2 !== null) return Math.round((g1 + g2) / 2);
-        return g1 ?? g2 ?? -1;
+    async _getLiveSnapshotPerField() {
+        const [fanCpu, fanGpu1, fanGpu2, dGpu, iGpu, cpuPower, cpuFreq, wcFan, wcPump] =
+            await Promise.all([
+                this._call('GetFanDataCPU'),
+                this._call('GetFanDataGPU1'),
+                this._call('GetFanDataGPU2'),
+                this._call('GetDGpuInfoValuesJSON'),
+                this._call('GetIGpuInfoValuesJSON'),
+                this._call('GetCpuPowerValuesJSON'),
+                this._call('GetCpuFrequencyMHz'),
+                this._call('GetWaterCoolerFanSpeed'),
+                this._call('GetWaterCoolerPumpLevel'),
+            ]);
+
+        const snapshot = {};
+        const put = (key, v) => { if (v !== null && v !== undefined && v >= 0) snapshot[key] = v; };
+        const num = UccdClient._jsonNum;
+
+        put('cpuTemp', UccdClient._fanValue(fanCpu, 'temp'));
+        put('cpuFanPercent', UccdClient._fanValue(fanCpu, 'speed'));
+        const g1 = UccdClient._fanValue(fanGpu1, 'speed');
+        const g2 = UccdClient._fanValue(fanGpu2, 'speed');
+        put('gpuFanPercent', g1 !== null && g2 !== null ? Math.round((g1 + g2) / 2) : g1 ?? g2);
+        put('gpuTemp', num(dGpu, 'temp') ?? num(iGpu, 'temp'));
+        put('gpuFrequencyMHz', num(dGpu, 'coreFrequency') ?? num(dGpu, 'coreFreq'));
+        put('cpuPowerW', num(cpuPower, 'powerDraw'));
+        put('gpuPowerW', num(dGpu, 'powerDraw') ?? num(iGpu, 'powerDraw'));
+        put('cpuFrequencyMHz', cpuFreq);
+        put('waterCoolerFanSpeed', wcFan);
+        put('waterCoolerPumpLevel', wcPump);
+        return snapshot;
     }
 
-    getWaterCoolerFanSpeed()  { return this._call('GetWaterCoolerFanSpeed')  ?? -1; }
-    getWaterCoolerPumpLevel() { return this._call('GetWaterCoolerPumpLevel') ?? -1; }
-
     // -----------------------------------------------------------------------
-    // Slow poll — profiles, state, hardware toggles
+    // Slow state — profiles, power state, hardware toggles
     // -----------------------------------------------------------------------
 
     getActiveProfileJSON()   { return this._call('GetActiveProfileJSON'); }
@@ -197,20 +226,48 @@ export class UccdClient {
     getDefaultProfilesJSON() { return this._call('GetDefaultProfilesJSON'); }
     getFanProfileNames()     { return this._call('GetFanProfileNames'); }
 
-    getWebcamEnabled()      { return this._call('GetWebcamSWStatus') ?? false; }
-    getFnLock()             { return this._call('GetFnLockStatus') ?? false; }
-    getDisplayBrightness()  { return this._call('GetDisplayBrightness') ?? 50; }
+    async getWebcamEnabled()     { return (await this._call('GetWebcamSWStatus')) ?? false; }
+    async getFnLock()            { return (await this._call('GetFnLockStatus')) ?? false; }
+    async getDisplayBrightness() { return (await this._call('GetDisplayBrightness')) ?? 50; }
 
-    getAvailableODMProfiles() { return this._call('ODMProfilesAvailable') ?? []; }
-    getWaterCoolerSupported() { return this._call('GetWaterCoolerSupported') ?? false; }
-    isWaterCoolerEnabled()    { return this._call('IsWaterCoolerEnabled') ?? false; }
-    isDeviceSupported()       { return this._call('IsDeviceSupported') ?? false; }
-    getSystemInfoJSON()       { return this._call('GetSystemInfoJSON'); }
+    async getAvailableODMProfiles() { return (await this._call('ODMProfilesAvailable')) ?? []; }
+    async getWaterCoolerSupported() { return (await this._call('GetWaterCoolerSupported')) ?? false; }
+    async isWaterCoolerEnabled()    { return (await this._call('IsWaterCoolerEnabled')) ?? false; }
+    async isDeviceSupported()       { return (await this._call('IsDeviceSupported')) ?? false; }
+    getSystemInfoJSON()             { return this._call('GetSystemInfoJSON'); }
 
     getFanProfile(name) { return this._call('GetFanProfile', [name], 's'); }
 
+    /**
+     * Slow state under the names of the daemon's D-Bus properties
+     * (ActiveProfileJSON, PowerState, WebcamSWStatus, FnLockStatus,
+     * DisplayBrightness, WaterCoolerEnabled), for daemons that do not
+     * export them; values it could not read are left out.
+     * @returns {Promise<object|null>}
+     */
+    async getSlowState() {
+        if (!this._connected) return null;
+        const [ap, ps, webcam, fn, br, wc] = await Promise.all([
+            this._call('GetActiveProfileJSON'),
+            this._call('GetPowerState'),
+            this._call('GetWebcamSWStatus'),
+            this._call('GetFnLockStatus'),
+            this._call('GetDisplayBrightness'),
+            this._call('IsWaterCoolerEnabled'),
+        ]);
+        const state = {};
+        const put = (key, v) => { if (v !== null) state[key] = v; };
+        put('ActiveProfileJSON', ap);
+        put('PowerState', ps);
+        put('WebcamSWStatus', webcam);
+        put('FnLockStatus', fn);
+        put('DisplayBrightness', br);
+        put('WaterCoolerEnabled', wc);
+        return state;
+    }
+
     // -----------------------------------------------------------------------
-    // Setters
+    // Setters — resolve to true on success
     // -----------------------------------------------------------------------
 
     setActiveProfile(id) {
@@ -226,7 +283,6 @@ export class UccdClient {
     }
 
     setWebcamEnabled(v) {
-        // Try both method names for compatibility
         return this._callVoid('SetWebcam', [v], 'b');
     }
 
@@ -258,11 +314,103 @@ export class UccdClient {
         return this._callVoid('TurnOffWaterCoolerLED');
     }
 
+    // -----------------------------------------------------------------------
+    // Push-based metrics
+    // -----------------------------------------------------------------------
+
+    /**
+     * Receive the daemon's per-tick MetricsSample broadcast.
+     *
+     * Values are indexed like uccd's MetricId; NaN means "no sample yet".
+     * Call again after the daemon reappears — it forgets subscribers on exit.
+     * @param {function(number, number[])} cb  Invoked with (timestampMs, values)
+     * @returns {Promise<boolean>} true if the daemon accepted the subscription
+     */
+    subscribeMetricsSamples(cb) {
+        this._onMetricsSample = cb;
+        if (!this._sampleSignalId) {
+            this._sampleSignalId = this._bus.signal_subscribe(
+                BUS_NAME, IFACE_NAME, 'MetricsSample', OBJECT_PATH, null,
+                Gio.DBusSignalFlags.NONE,
+                (_conn, _sender, _path, _iface, _signal, params) => {
+                    const [ts, values] = params.deep_unpack();
+                    this._onMetricsSample?.(Number(ts), values);
+                },
+            );
+        }
+        return this._callVoid('SubscribeMetricsSamples');
+    }
+
+    unsubscribeMetricsSamples() {
+        if (this._sampleSignalId) {
+            this._bus.signal_unsubscribe(this._sampleSignalId);
+            this._sampleSignalId = 0;
+        }
+        this._onMetricsSample = null;
+        // not cancelled by destroy(), which calls this right before
+        this._callVoid('UnsubscribeMetricsSamples', null, null, null);
+    }
+
+    // -----------------------------------------------------------------------
+    // Property change notifications
+    // -----------------------------------------------------------------------
+
+    /**
+     * Current slow-changing daemon state (ActiveProfileJSON, PowerState,
+     * WebcamSWStatus, FnLockStatus, DisplayBrightness, WaterCooler*, ...).
+     * @returns {Promise<object|null>} name → value, null if the daemon has
+     *          no properties
+     */
+    async getAllProperties() {
+        if (!this._connected) return null;
+        try {
+            const result = await this._invoke(
+                'org.freedesktop.DBus.Properties', 'GetAll',
+                new GLib.Variant('(s)', [IFACE_NAME]));
+            const props = result?.get_child_value(0).recursiveUnpack() ?? null;
+            return props && Object.keys(props).length > 0 ? props : null;
+        } catch (_e) {
+            return null;
+        }
+    }
+
+    /**
+     * Receive PropertiesChanged for the uccd interface.
+     * @param {function(object)} cb  Invoked with the changed name → value pairs
+     * @returns {Promise<object|null>} all current properties, or null if the
+     *          daemon exports none; then the caller has to keep polling
+     */
+    subscribePropertiesChanged(cb) {
+        this._onPropertiesChanged = cb;
+        if (!this._propsSignalId) {
+            this._propsSignalId = this._bus.signal_subscribe(
+                BUS_NAME, 'org.freedesktop.DBus.Properties', 'PropertiesChanged',
+                OBJECT_PATH, IFACE_NAME, Gio.DBusSignalFlags.NONE,
+                (_conn, _sender, _path, _iface, _signal, params) => {
+                    const [, changed] = params.recursiveUnpack();
+                    this._onPropertiesChanged?.(changed);
+                },
+            );
+        }
+        return this.getAllProperties();
+    }
+
+    unsubscribePropertiesChanged() {
+        if (this._propsSignalId) {
+            this._bus.signal_unsubscribe(this._propsSignalId);
+            this._propsSignalId = 0;
+        }
+        this._onPropertiesChanged = null;
+    }
+
     // -----------------------------------------------------------------------
     // Cleanup
     // -----------------------------------------------------------------------
 
     destroy() {
+        this.unsubscribeMetricsSamples();
+        this.unsubscribePropertiesChanged();
+        this._cancellable.cancel();
         if (this._watchId) {
             Gio.bus_unwatch_name(this._watchId);
             this._watchId = 0;
@@ -50,6 +50,10 @@ namespace ucc
     /** Update the water-cooler enable checkbox without re-triggering signals. */
     void setWaterCoolerEnabled( bool enabled );
 
+    /** Show the hardware names from the daemon's system info in the headers. */
+    void setSystemInfo( const QString &laptopModel, const QString &cpuModel,
+                        const QString &dGpuModel, const QString &iGpuModel );
+
     /** Trigger an immediate water-cooler status query and emit waterCoolerStatusChanged. */
     void refreshWaterCoolerStatus();
 
@@ -86,6 +90,8 @@ namespace ucc
     void setupUI();
     void connectSignals();
     void updateWaterCoolerStatus();
+    void showWaterCoolerStatus( bool wcEnabled, bool connected, bool scanning );
+    void updateModelLabels();
     void switchGpuView( bool showIGpu );
     void updateGpuSwitchVisibility();
 
@@ -93,6 +99,7 @@ namespace ucc
     ProfileManager *m_profileManager;
     // DBus interface for water cooler status
     QDBusInterface *m_waterCoolerDbus = nullptr;
+    bool m_waterCoolerPollPending = false;
     QTimer *m_waterCoolerPollTimer = nullptr;
 
     // Dashboard widgets
@@ -132,6 +139,8 @@ namespace ucc
     QString m_iGpuModel;
 
     // GPU section header label (updated when toggling dGPU / iGPU)
+    QLabel *m_titleLabel = nullptr;
+    QLabel *m_cpuHeaderLabel = nullptr;
     QLabel *m_gpuHeaderLabel = nullptr;
 
     // GPU view toggle (dGPU / iGPU)
@@ -6,6 +6,7 @@
 namespace ucc
 {
 
+/// Layout of the session's keyboard ("us", "de", ...); detected once per process
 QString detectKeyboardLayout();
 
 }
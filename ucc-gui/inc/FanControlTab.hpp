@@ -107,6 +107,10 @@ signals:
   void pumpPointsChanged( const QVector<PumpCurveEditorWidget::Point> &points );
   void waterCoolerEnableChanged( bool enabled );
 
+protected:
+  void showEvent( QShowEvent *event ) override;
+  void hideEvent( QHideEvent *event ) override;
+
 private slots:
   // Water cooler hardware slots
   void onWaterCoolerEnableToggled( bool enabled );
@@ -147,6 +151,7 @@ private:
   // Water cooler hardware controls (moved from HardwareTab)
   QDBusInterface *m_waterCoolerDbus = nullptr;
   QTimer *m_waterCoolerPollTimer = nullptr;
+  bool m_waterCoolerPolling = false;  ///< Enabled; the timer only runs while the tab is shown
   bool m_isWcConnected = false;
   QPushButton *m_waterCoolerEnableCheckBox = nullptr;
   QComboBox *m_pumpVoltageCombo = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 #include <QWidget>
 #include <QPainter>
+#include <QPixmap>
 #include <QVector>
 #include <QPointF>
 #include <QSet>
@@ -23,7 +24,7 @@ public:
     bool isEditable() const { return m_editable; }
 
     /** Set a title string drawn at the top of the widget. */
-    void setTitle(const QString &title) { m_title = title; update(); }
+    void setTitle(const QString &title) { m_title = title; m_backgroundDirty = true; update(); }
     QString title() const { return m_title; }
 
     /** Set the live crosshair position (temperature in °C, duty in %). */
@@ -36,6 +37,8 @@ signals:
 
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
@@ -62,6 +65,14 @@ private:
     QVector<double> m_dragStartDuties;
     double m_dragStartY = 0.0;
 
+    // Title, grid, axes and tick labels at device resolution; redrawn only
+    // after a resize or a palette, font or style change
+    QPixmap m_background;
+    bool m_backgroundDirty = true;
+    void renderBackground();
+    /// Widget area the curve and its points cover (for partial repaints)
+    QRect curveBounds() const;
+
     QRectF pointRect(const Point &pt) const;
     QPointF toWidget(const Point &pt) const;
     Point fromWidget(const QPointF &pos) const;
@@ -88,6 +88,10 @@ signals:
   void gpuProfileRenamed( const QString &oldName, const QString &newName );
   void changed();   ///< emitted when any slider/spin is modified
 
+protected:
+  void showEvent( QShowEvent *event ) override;
+  void hideEvent( QHideEvent *event ) override;
+
 private slots:
   void onGpuProfileComboRenamed();
   void onRefreshClicked();
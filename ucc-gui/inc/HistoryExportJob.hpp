@@ -0,0 +1,83 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <memory>
+#include <optional>
+#include "HistoryExport.hpp"
+
+namespace ucc
+{
+
+class UccdClient;
+
+/**
+ * @brief Streams the daemon's monitoring history into a CSV or Parquet file
+ *        without blocking the GUI
+ *
+ * The D-Bus requests are asynchronous on the GUI thread; the file is
+ * written on a QThreadPool thread.  The next page is requested while the
+ * previous one is written, and no further one before that write is done,
+ * so at most two pages are held however long the history is.  The job
+ * deletes itself after finished().
+ */
+class HistoryExportJob : public QObject
+{
+  Q_OBJECT
+
+public:
+  static constexpr int PAGE_ROWS = 4096;
+
+  HistoryExportJob( UccdClient *client, const QString &path, HistoryExportFormat format, QObject *parent = nullptr );
+  ~HistoryExportJob() override;
+
+  /// Export everything since @p sinceMs (0 = all history)
+  void start( qint64 sinceMs = 0 );
+
+signals:
+  void progress( qulonglong rows );
+  /// @p error is empty on success
+  void finished( qulonglong rows, qulonglong events, const QString &error );
+
+private:
+  struct Output;
+
+  void requestPage();
+  void onPage( std::optional< QByteArray > page );
+  void writePage( QByteArray page );
+  void onPageWritten( qulonglong rows );
+  void finishOutput();
+  void fail( const QString &error );
+
+  UccdClient *m_client;
+  QString m_path;
+  HistoryExportFormat m_format;
+  QThreadPool m_pool;                  ///< The writer thread
+  std::shared_ptr< Output > m_output;  ///< Shared with the write in flight
+  uint64_t m_mask = 0;
+  qint64 m_nextSinceMs = 0;
+  bool m_writing = false;
+  bool m_fetching = false;
+  bool m_lastPage = false;             ///< A page came back empty: no more to request
+  bool m_failed = false;
+  std::optional< QByteArray > m_pending;  ///< Fetched while the previous page was written
+};
+
+} // namespace ucc
@@ -27,8 +27,10 @@
 #include <QJsonDocument>
 #include <QSet>
 #include <QMap>
+#include <cstdint>
 #include <vector>
 #include <map>
+#include "KeyboardFrameReducer.hpp"
 
 namespace ucc
 {
@@ -40,7 +42,7 @@ struct KeyboardKey
 {
   int zoneId = -1;
   QString label;
-  QRect geometry;  // Position and size in the layout
+  QRect geometry;  // Position and size in the layout, in grid cells
   QColor color = Qt::white;
   int brightness = 255;
 };
@@ -90,6 +92,19 @@ public:
    * @brief Get the key label for a zone ID
    */
   QString getKeyLabel( int zoneId ) const;
+
+  /**
+   * @brief Where each key sits on the keyboard, for mapping a screen onto it
+   */
+  std::vector< KeyboardZoneCell > zoneCells() const;
+
+  /**
+   * @brief Preview a live frame (R, G, B per zone) without changing the key state
+   *
+   * Only keys whose colour differs from what they show are restyled, so this
+   * can follow a 30 fps effect.  An empty frame shows the key state again.
+   */
+  void showFrame( const std::vector< uint8_t > &rgb );
 signals:
   /**
    * @brief Emitted when a key is selected
@@ -111,10 +126,12 @@ private:
   void createKeyButton( int zoneId, const QString &label, int row, int col, int width = 1, int height = 1 );
   QColor applyBrightness( const QColor &color, int brightness ) const;
   void updateKeyAppearance( QPushButton *button, const QColor &color, int brightness );
+  void updateKeyAppearance( int zoneId );
 
   int m_zones;
   int m_maxBrightness = 255;
   std::vector< KeyboardKey > m_keys;
+  std::vector< QPushButton * > m_buttons;  ///< By zone ID; nullptr for zones the layout does not place
   QGridLayout *m_layout = nullptr;
   QScrollArea *m_scrollArea = nullptr;
   QWidget *m_keyboardWidget = nullptr;
@@ -32,6 +32,7 @@
 #include <QInputDialog>
 #include <QColorDialog>
 #include <QStackedWidget>
+#include <QTimer>
 #include <QtWidgets/QTableWidget>
 #include <memory>
 #include "ProfileManager.hpp"
@@ -59,6 +60,10 @@ namespace ucc
     explicit MainWindow( QWidget *parent = nullptr );
     ~MainWindow() override;
 
+  protected:
+    /// Pauses live monitoring while the window is minimized
+    void changeEvent( QEvent *event ) override;
+
   private slots:
     // Status bar slots
     void updateConnectionStatusLabel();
@@ -95,6 +100,8 @@ namespace ucc
     void onKeyboardBrightnessChanged( int value );
     void onKeyboardColorClicked();
     void onKeyboardVisualizerColorsChanged();
+    void onKeyboardAmbientToggled( bool enabled );
+    void onKeyboardAmbientTick();
     void onKeyboardProfileChanged(const QString& profileId);
     void onCopyKeyboardProfileClicked();
     void onSaveKeyboardProfileClicked();
@@ -118,6 +125,8 @@ namespace ucc
     };
 
     void setupUI();
+    /// (De)activate SystemMonitor and the Monitor tab for the current tab and window state
+    void updateMonitoringActivity();
     void setupDashboardPage();
     void setupProfilesPage();
     void setupHardwarePage();
@@ -163,7 +172,8 @@ namespace ucc
     // Hardware tab
     HardwareTab *m_hardwareTab = nullptr;
 
-    // Monitor tab
+    // Monitor tab (created inside m_monitorPage when first shown)
+    QWidget *m_monitorPage = nullptr;
     MonitorTab *m_monitorTab = nullptr;
 
     // Profiles widgets
@@ -218,6 +228,8 @@ namespace ucc
     QLabel *m_maxFrequencyValue = nullptr;
     int m_cpuMinFreqKHz = 400000;   // hardware min frequency in kHz
     int m_cpuMaxFreqKHz = 6000000;  // hardware max frequency in kHz
+    QJsonObject m_cpuCoreClassLimits;  // per core class limits, core parking and adaptive EPP of the loaded profile, saved back as they were
+    QJsonObject m_odmPowerLimitController;  // dynamic power limit settings of the loaded profile, saved back as they were
     // ODM Power Limit (TDP) widgets
     QSlider *m_odmPowerLimit1Slider = nullptr;
     QLabel *m_odmPowerLimit1Value = nullptr;
@@ -241,6 +253,14 @@ namespace ucc
     // Keyboard color widgets
     QLabel *m_keyboardColorLabel = nullptr;
 
+    // Screen ambient keyboard lighting: the screen averaged per zone, streamed to uccd
+    static constexpr int KEYBOARD_AMBIENT_INTERVAL_MS = 33;
+    QCheckBox *m_keyboardAmbientCheck = nullptr;
+    QTimer *m_keyboardAmbientTimer = nullptr;
+    int m_keyboardZones = 0;
+    std::vector< KeyboardZoneCell > m_keyboardAmbientCells;
+    std::vector< uint8_t > m_keyboardAmbientFrame;
+
     // Change tracking
     bool m_profileChanged = false;
     QString m_currentLoadedProfile;
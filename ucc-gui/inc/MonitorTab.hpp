@@ -40,6 +40,8 @@
 #include <QWheelEvent>
 #include <QGraphicsSceneMouseEvent>
 #include <QRubberBand>
+#include "MinMaxDecimator.hpp"
+#include "SeriesRing.hpp"
 #include <map>
 #include <vector>
 #include <functional>
@@ -81,14 +83,24 @@ public:
 protected:
   void keyPressEvent( QKeyEvent *event ) override;
   void wheelEvent( QWheelEvent *event ) override;
+  void resizeEvent( QResizeEvent *event ) override;
   bool eventFilter( QObject *watched, QEvent *event ) override;
 
 private slots:
   void fetchData();
+  void onMetricsSample( qint64 timestampMs, const QList< double > &values );
+  /** Ask for a file and stream the daemon's history into it (HistoryExportJob). */
+  void exportHistory();
 
 private:
   // --- Setup helpers ---
   void setupUI();
+
+  // --- Data fetching (asynchronous over D-Bus) ---
+  void fetchIncremental();
+  quint64 beginFetch();                ///< Mark a request in flight; returns its serial
+  bool endFetch( quint64 serial );     ///< False if the reply was superseded
+  void applyFetchedData( const QByteArray &data, bool compressed );
   void setupTemperatureChart();
   void setupDutyChart();
   void setupPowerChart();
@@ -109,15 +121,34 @@ private:
   /** Destroy shadow series for unified chart (reclaim memory). */
   void destroyUnifiedSeries();
 
+  /** Draw all metric series with OpenGL or the software raster, per m_acceleratedCharts. */
+  void setAcceleratedCharts( bool accelerated );
+
   /** Install hover callout on every series in the given chart view. */
   void installHoverCallout( QChart *chart );
 
   /** Decode the binary payload returned by GetMonitorDataSince and append to buffers. */
   void applyBinaryData( const QByteArray &data );
 
-  /** Push in-memory buffers into QLineSeries via replace() (single repaint per series). */
+  /** Decode the compressed payload from GetMonitorDataSinceCompressed and append to buffers. */
+  void applyCompressedData( const QByteArray &data );
+
+  /** Apply the points added to / trimmed from the rings since the last commit to the QLineSeries. */
   void commitSeries();
 
+  /** Is the unified chart shown with a zoomed X range? */
+  bool zoomedView() const;
+
+  /** Time per horizontal pixel of the visible span (window or zoom), in ms. */
+  double lodBucketMs() const;
+
+  /**
+   * Re-decimate every ring for the current span and plot width and replace
+   * the QLineSeries with the result.  Only points in the zoomed range (if
+   * any) are drawn.
+   */
+  void rebuildLod();
+
   /** Hide per-group chart views when all metrics in that group are disabled. */
   void updateGroupChartVisibility();
 
@@ -143,13 +174,18 @@ private:
   void updateAxes();
 
   // --- Data model ---
+  /// Points kept per metric: the longest window (30 min) at the fastest
+  /// sampling (250 ms), with headroom
+  static constexpr size_t SERIES_CAPACITY = 8192;
+
   struct SeriesInfo
   {
     QLineSeries    *series = nullptr;
     QCheckBox      *toggle = nullptr;
     QString         label;
     QColor          color;
-    QList< QPointF > buffer;   ///< In-memory point buffer (source of truth)
+    SeriesRing< QPointF > buffer{ SERIES_CAPACITY };  ///< In-memory points (source of truth)
+    MinMaxDecimator< QPointF > lod;  ///< What the QLineSeries draws: ≤ 2 points per pixel
   };
 
   // One entry per metric key string (e.g. "cpuTemp")
@@ -273,14 +309,24 @@ private:
   // --- Controls ---
   QCheckBox *m_unifiedCheckBox = nullptr;
   QLabel    *m_pauseLabel      = nullptr;  ///< Status indicator for pause mode
+  QCheckBox *m_acceleratedCheckBox = nullptr;  ///< Hidden when no OpenGL context can be created
+  QPushButton *m_exportButton  = nullptr;  ///< Disabled while an export runs
 
   // --- State ---
+  static constexpr int POLL_INTERVAL_MS = 1000;           ///< Without MetricsSample push
+  static constexpr int FALLBACK_POLL_INTERVAL_MS = 3000;  ///< Safety net while pushes arrive
+
   UccdClient *m_client = nullptr;
   QTimer      m_fetchTimer;
   qint64      m_lastTimestamp = 0;    ///< Last fetched timestamp (ms since epoch)
   int         m_windowSeconds = 300;  ///< Visible time window (default 5 min)
   bool        m_unifiedSeriesActive = false;  ///< Shadow series created?
   bool        m_paused = false;                ///< Pause mode active?
+  bool        m_compressedFetch = true;        ///< Daemon supports the compressed query?
+  bool        m_acceleratedCharts = false;     ///< Series drawn with OpenGL (QAbstractSeries::useOpenGL)
+  bool        m_decimateNextFetch = false;     ///< Next fetch refills the whole window
+  bool        m_fetchInFlight = false;         ///< A D-Bus history request is outstanding
+  quint64     m_fetchSerial = 0;               ///< Serial of the newest request
   int         m_maxPowerW = 150;               ///< Platform max power (TDP); adjust for your hardware
 };
 
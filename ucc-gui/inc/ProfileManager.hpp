@@ -81,7 +81,10 @@ public slots:
   void refresh();
   void setActiveProfile( const QString &profileId );
   void setActiveProfileByIndex( int index );
-  void saveProfile( const QString &profileJSON );
+  /// Save a custom profile; @p stateMapUpdates (state → profile id) go to
+  /// the daemon in the same transaction
+  void saveProfile( const QString &profileJSON,
+                    const std::map< QString, QString > &stateMapUpdates = {} );
   void deleteProfile( const QString &profileId );
   QString getProfileDetails( const QString &profileId );
   QString createProfileFromDefault( const QString &name );
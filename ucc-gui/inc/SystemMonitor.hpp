@@ -159,9 +159,15 @@ signals:
 
 private slots:
   void updateMetrics();
+  void onMetricsSample( qint64 timestampMs, const QList< double > &values );
+  void applyProperties( const QVariantMap &props );
 
 private:
+  static constexpr int POLL_INTERVAL_MS = 500;            ///< Without MetricsSample push
+  static constexpr int FALLBACK_POLL_INTERVAL_MS = 3000;  ///< Safety net while pushes arrive
+
   void initializeChargingState();
+  void applySnapshot( const LiveSnapshot &s );
 
   std::unique_ptr< UccdClient > m_client;
   QTimer *m_updateTimer;
@@ -189,6 +195,8 @@ private:
   bool m_webcamEnabled = true;
   bool m_fnLock = false;
   bool m_monitoringActive = false;
+  int m_pendingReads = 0;  ///< Async replies of the current updateMetrics() tick still outstanding
+  bool m_propertiesPushed = false;  ///< Daemon sends brightness/webcam/Fn lock as property changes
   bool m_isACPower = false;
 
   // Charging state
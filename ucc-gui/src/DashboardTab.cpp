@@ -18,6 +18,8 @@
 #include "ProfileManager.hpp"
 #include <QDBusInterface>
 #include <QDBusReply>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QTimer>
 
 #include <QWidget>
@@ -86,6 +88,7 @@ DashboardTab::DashboardTab( SystemMonitor *systemMonitor, ProfileManager *profil
   , m_iGpuModel( iGpuModel )
 {
   setupUI();
+  updateModelLabels();
   connectSignals();
 
   // m_activeProfileLabel is created but hidden; it's only for internal use
@@ -125,8 +128,8 @@ void DashboardTab::setupUI()
   // Use a grid so the title is centered over the full row width while
   // the checkbox floats to the right edge, both occupying the same cell.
   QGridLayout *titleLayout = new QGridLayout();
-  const QString titleText = m_laptopModel.isEmpty() ? QStringLiteral( "System Monitor" ) : m_laptopModel;
-  QLabel *titleLabel = new QLabel( titleText );
+  m_titleLabel = new QLabel();
+  QLabel *titleLabel = m_titleLabel;
   titleLabel->setStyleSheet( QString("font-size: 22px; font-weight: bold;") );
 
   // Water Cooler Enable toggle button (synced with FanControlTab)
@@ -253,8 +256,8 @@ void DashboardTab::setupUI()
   };
 
   // CPU section
-  const QString cpuHeaderText = m_cpuModel.isEmpty() ? QStringLiteral( "Main Processor Monitor" ) : m_cpuModel;
-  QLabel *cpuHeader = new QLabel( cpuHeaderText );
+  m_cpuHeaderLabel = new QLabel();
+  QLabel *cpuHeader = m_cpuHeaderLabel;
   cpuHeader->setStyleSheet( "font-size: 14px; font-weight: bold;" );
   cpuHeader->setAlignment( Qt::AlignCenter );
   layout->addWidget( cpuHeader );
@@ -267,11 +270,7 @@ void DashboardTab::setupUI()
   }) );
 
   // GPU section — single section with toggle between dGPU and iGPU
-  // Initial GPU header text: prefer dGPU model, fall back to iGPU model
-  const QString gpuHeaderText = !m_dGpuModel.isEmpty() ? m_dGpuModel
-                               : !m_iGpuModel.isEmpty() ? m_iGpuModel
-                               : QStringLiteral( "Graphics Card Monitor" );
-  m_gpuHeaderLabel = new QLabel( gpuHeaderText );
+  m_gpuHeaderLabel = new QLabel();
   m_gpuHeaderLabel->setStyleSheet( "font-size: 14px; font-weight: bold;" );
 
   m_gpuToggleButton = new QPushButton( "Show iGPU" );
@@ -445,26 +444,58 @@ void DashboardTab::updateWaterCoolerStatus()
   if ( not m_waterCoolerDbus || not m_waterCoolerHeader )
     return;
 
-  auto setWCStatus = [ this ]( const bool connected )
+  // Check if water cooler is enabled
+  const bool wcEnabled = m_waterCoolerEnableCheckBox ? m_waterCoolerEnableCheckBox->isChecked() : false;
+  if ( !wcEnabled )
+  {
+    showWaterCoolerStatus( false, false, false );
+    return;
+  }
+
+  // Get water cooler state from daemon without blocking the UI thread; one
+  // poll at a time, so a busy daemon does not pile up requests.
+  // Note: GetWaterCoolerAvailable returns true when scanning is active (not when a device is found)
+  // GetWaterCoolerConnected returns true only when a device is actually connected
+  if ( m_waterCoolerPollPending )
+    return;
+  m_waterCoolerPollPending = true;
+
+  auto *connectedCall = new QDBusPendingCallWatcher(
+    m_waterCoolerDbus->asyncCall( QStringLiteral( "GetWaterCoolerConnected" ) ), this );
+  connect( connectedCall, &QDBusPendingCallWatcher::finished, this, [this]( QDBusPendingCallWatcher *call ) {
+    call->deleteLater();
+    const QDBusPendingReply< bool > connected = *call;
+    if ( connected.isValid() && connected.value() )
+    {
+      m_waterCoolerPollPending = false;
+      showWaterCoolerStatus( true, true, false );
+      return;
+    }
+
+    auto *scanningCall = new QDBusPendingCallWatcher(
+      m_waterCoolerDbus->asyncCall( QStringLiteral( "GetWaterCoolerAvailable" ) ), this );
+    connect( scanningCall, &QDBusPendingCallWatcher::finished, this, [this]( QDBusPendingCallWatcher *next ) {
+      next->deleteLater();
+      const QDBusPendingReply< bool > scanning = *next;
+      m_waterCoolerPollPending = false;
+      showWaterCoolerStatus( true, false, scanning.isValid() && scanning.value() );
+    } );
+  } );
+}
+
+void DashboardTab::showWaterCoolerStatus( bool wcEnabled, bool connected, bool scanning )
+{
+  auto setWCStatus = [ this ]( const bool visible )
   {
     for ( int i = 0; i < m_waterCoolerGrid->count(); ++i )
     {
       if ( QWidget *w = m_waterCoolerGrid->itemAt( i )->widget() )
-        w->setVisible( connected );
+        w->setVisible( visible );
     }
 
-    m_waterCoolerHeader->setVisible( connected );
+    m_waterCoolerHeader->setVisible( visible );
   };
 
-  // Check if water cooler is enabled
-  bool wcEnabled = m_waterCoolerEnableCheckBox ? m_waterCoolerEnableCheckBox->isChecked() : false;
-
-  // Get water cooler state from daemon
-  // Note: GetWaterCoolerAvailable returns true when scanning is active (not when a device is found)
-  // GetWaterCoolerConnected returns true only when a device is actually connected
-  QDBusReply<bool> scanning = m_waterCoolerDbus->call(QStringLiteral("GetWaterCoolerAvailable"));
-  QDBusReply<bool> connected = m_waterCoolerDbus->call(QStringLiteral("GetWaterCoolerConnected"));
-
   // Compute explicit hex colors from the current palette so styles are consistent.
   QPalette pal = this->palette();
   const QString textHex = pal.color(QPalette::WindowText).name();
@@ -485,12 +516,12 @@ void DashboardTab::updateWaterCoolerStatus()
     emitStatus( QStringLiteral("Disabled"), m_ringColorHex );
     setWCStatus( false );
   }
-  else if ( connected.isValid() && connected.value() )
+  else if ( connected )
   {
     emitStatus( QStringLiteral("Connected"), highlightHex );
     setWCStatus( true );
   }
-  else if ( scanning.isValid() && scanning.value() )
+  else if ( scanning )
   {
     // GetWaterCoolerAvailable == true means the daemon is actively scanning
     emitStatus( QStringLiteral("Searching..."), searchingColorHex );
@@ -788,6 +819,33 @@ void DashboardTab::setWaterCoolerEnabled( bool enabled )
   m_waterCoolerEnableCheckBox->blockSignals( false );
 }
 
+void DashboardTab::setSystemInfo( const QString &laptopModel, const QString &cpuModel,
+                                  const QString &dGpuModel, const QString &iGpuModel )
+{
+  m_laptopModel = laptopModel;
+  m_cpuModel = cpuModel;
+  m_dGpuModel = dGpuModel;
+  m_iGpuModel = iGpuModel;
+  updateModelLabels();
+}
+
+void DashboardTab::updateModelLabels()
+{
+  if ( m_titleLabel )
+    m_titleLabel->setText( m_laptopModel.isEmpty() ? QStringLiteral( "System Monitor" ) : m_laptopModel );
+  if ( m_cpuHeaderLabel )
+    m_cpuHeaderLabel->setText( m_cpuModel.isEmpty() ? QStringLiteral( "Main Processor Monitor" ) : m_cpuModel );
+
+  if ( !m_gpuHeaderLabel )
+    return;
+  if ( m_showingIGpu )
+    m_gpuHeaderLabel->setText( m_iGpuModel.isEmpty() ? QStringLiteral( "Integrated GPU" ) : m_iGpuModel );
+  else  // prefer the dGPU model, fall back to the iGPU model
+    m_gpuHeaderLabel->setText( !m_dGpuModel.isEmpty() ? m_dGpuModel
+                               : !m_iGpuModel.isEmpty() ? m_iGpuModel
+                               : QStringLiteral( "Graphics Card Monitor" ) );
+}
+
 void DashboardTab::switchGpuView( bool showIGpu )
 {
   m_showingIGpu = showIGpu;
@@ -59,7 +59,10 @@ QString normalizeLayout(const QString &layout)
   return lower;
 }
 
-QString detectKeyboardLayout()
+namespace
+{
+
+QString runLayoutDetection()
 {
   QProcess process;
 
@@ -256,4 +259,14 @@ QString detectKeyboardLayout()
   return "us"; // Default to US
 }
 
+} // namespace
+
+QString detectKeyboardLayout()
+{
+  // Detection starts helper processes with multi-second timeouts; the
+  // layout is not expected to change while the GUI runs
+  static const QString layout = runLayoutDetection();
+  return layout;
+}
+
 }
\ No newline at end of file
@@ -24,6 +24,8 @@
 #include <QMainWindow>
 #include <QStatusBar>
 #include <QDBusReply>
+#include <QHideEvent>
+#include <QShowEvent>
 #include <QDebug>
 #include "CommonTypes.hpp"
 
@@ -644,10 +646,13 @@ void FanControlTab::updateWaterCoolerPolling()
   bool wcEnabled = m_waterCoolerEnableCheckBox ? m_waterCoolerEnableCheckBox->isChecked() : false;
 
   if ( wcEnabled ) {
-    if ( !m_waterCoolerPollTimer->isActive() )
+    m_waterCoolerPolling = true;
+    // The connection state is only shown here; hideEvent() stops the timer again
+    if ( isVisible() && !m_waterCoolerPollTimer->isActive() )
       m_waterCoolerPollTimer->start( 1000 );
   } else {
-    if ( m_waterCoolerPollTimer->isActive() ) {
+    if ( m_waterCoolerPolling ) {
+      m_waterCoolerPolling = false;
       m_waterCoolerPollTimer->stop();
       // Force disconnect when disabled
       onDisconnected();
@@ -658,6 +663,19 @@ void FanControlTab::updateWaterCoolerPolling()
   }
 }
 
+void FanControlTab::showEvent( QShowEvent *event )
+{
+  QWidget::showEvent( event );
+  updateWaterCoolerPolling();
+}
+
+void FanControlTab::hideEvent( QHideEvent *event )
+{
+  QWidget::hideEvent( event );
+  if ( m_waterCoolerPollTimer )
+    m_waterCoolerPollTimer->stop();
+}
+
 void FanControlTab::updateColorButtonState()
 {
   if ( !m_colorPickerButton || !m_ledModeCombo ) return;
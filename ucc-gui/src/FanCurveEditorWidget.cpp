@@ -2,6 +2,7 @@
 #include <QPainter>
 #include <QPalette>
 #include <QMouseEvent>
+#include <QResizeEvent>
 #include <QMenu>
 #include <algorithm>
 #include <ranges>
@@ -75,6 +76,14 @@ QRectF FanCurveEditorWidget::pointRect(const Point& pt) const {
     return QRectF(c.x() - 7.0, c.y() - 7.0, 14.0, 14.0);
 }
 
+QRect FanCurveEditorWidget::curveBounds() const {
+    // The curve is monotonic, so it stays inside the box around its points
+    QRectF r;
+    for (const auto &pt : m_points)
+        r = r.united(pointRect(pt));
+    return r.toAlignedRect().adjusted(-2, -2, 2, 2);  // point outline pen
+}
+
 void FanCurveEditorWidget::enforceMonotonicity(int modifiedIndex) {
     if (modifiedIndex < 0 || modifiedIndex >= m_points.size()) return;
 
@@ -94,25 +103,38 @@ void FanCurveEditorWidget::enforceMonotonicity(int modifiedIndex) {
     }
 }
 
-void FanCurveEditorWidget::paintEvent(QPaintEvent*) {
-    QPainter p(this);
+void FanCurveEditorWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    m_backgroundDirty = true;
+}
+
+void FanCurveEditorWidget::changeEvent(QEvent *event) {
+    QWidget::changeEvent(event);
+    switch (event->type()) {
+        case QEvent::PaletteChange:
+        case QEvent::FontChange:
+        case QEvent::StyleChange:
+            m_backgroundDirty = true;
+            update();
+            break;
+        default:
+            break;
+    }
+}
+
+void FanCurveEditorWidget::renderBackground() {
+    const qreal dpr = devicePixelRatioF();
+    m_background = QPixmap(size() * dpr);
+    m_background.setDevicePixelRatio(dpr);
+    m_backgroundDirty = false;
+
+    QPainter p(&m_background);
     p.setRenderHint(QPainter::Antialiasing);
 
     const QPalette &pal = palette();
     const QColor bgColor       = pal.color(QPalette::Base);
     const QColor gridColor     = pal.color(QPalette::Mid);
     const QColor labelColor    = pal.color(QPalette::Text);
-    const QColor brightText    = pal.color(QPalette::BrightText);
-    const QColor disabledFill  = pal.color(QPalette::Disabled, QPalette::Mid);
-    const QColor disabledBorder= pal.color(QPalette::Disabled, QPalette::Light);
-
-    // Data-visualization colors: warm tones that won't collide with
-    // typical blue-ish GUI highlight/link palette roles.
-    const bool darkTheme = bgColor.lightnessF() < 0.5;
-    const QColor curveColor    = darkTheme ? QColor( 0x3f, 0xa9, 0xf5 ) : QColor( 0x19, 0x76, 0xd2 );
-    const QColor accentColor   = darkTheme ? QColor( 0xff, 0x57, 0x22 ) : QColor( 0xe6, 0x4a, 0x19 );
-    const QColor selectedFill  = darkTheme ? QColor( 0xff, 0xa7, 0x26 ) : QColor( 0xfb, 0x8c, 0x00 );
-    const QColor selectedBorder= darkTheme ? QColor( 0xff, 0x6f, 0x00 ) : QColor( 0xe6, 0x51, 0x00 );
 
     p.fillRect(rect(), bgColor);
     // Margins for axes
@@ -195,6 +217,36 @@ void FanCurveEditorWidget::paintEvent(QPaintEvent*) {
     QRectF borderRect(qRound(plotRect.left()) + 0.5, qRound(plotRect.top()) + 0.5,
                       qRound(plotRect.width()) - 1.0, qRound(plotRect.height()) - 1.0);
     p.drawRect(borderRect);
+}
+
+void FanCurveEditorWidget::paintEvent(QPaintEvent*) {
+    if (m_backgroundDirty || m_background.size() != size() * devicePixelRatioF())
+        renderBackground();
+
+    QPainter p(this);
+    p.drawPixmap(0, 0, m_background);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    const QPalette &pal = palette();
+    const QColor bgColor       = pal.color(QPalette::Base);
+    const QColor brightText    = pal.color(QPalette::BrightText);
+    const QColor disabledFill  = pal.color(QPalette::Disabled, QPalette::Mid);
+    const QColor disabledBorder= pal.color(QPalette::Disabled, QPalette::Light);
+
+    // Data-visualization colors: warm tones that won't collide with
+    // typical blue-ish GUI highlight/link palette roles.
+    const bool darkTheme = bgColor.lightnessF() < 0.5;
+    const QColor curveColor    = darkTheme ? QColor( 0x3f, 0xa9, 0xf5 ) : QColor( 0x19, 0x76, 0xd2 );
+    const QColor accentColor   = darkTheme ? QColor( 0xff, 0x57, 0x22 ) : QColor( 0xe6, 0x4a, 0x19 );
+    const QColor selectedFill  = darkTheme ? QColor( 0xff, 0xa7, 0x26 ) : QColor( 0xfb, 0x8c, 0x00 );
+    const QColor selectedBorder= darkTheme ? QColor( 0xff, 0x6f, 0x00 ) : QColor( 0xe6, 0x51, 0x00 );
+
+    const int left = 80, right = 20, top = 28, bottom = 68;
+    QRectF plotRect(left, top, width() - left - right, height() - top - bottom);
+
+    QFont tickFont = font();
+    tickFont.setPointSize(9);
+    tickFont.setWeight(QFont::Normal);
 
     // Draw curve
     p.setFont(tickFont);
@@ -326,6 +378,7 @@ void FanCurveEditorWidget::mouseMoveEvent(QMouseEvent* e) {
 
     // Rubber band selection
     if (m_rubberBandActive) {
+        const QRect oldBand = m_rubberBandRect;
         m_rubberBandRect = QRect(m_rubberBandOrigin, e->pos()).normalized();
         // Preview: select all points inside the rubber band
         if (!m_ctrlHeld)
@@ -335,13 +388,15 @@ void FanCurveEditorWidget::mouseMoveEvent(QMouseEvent* e) {
             if (m_rubberBandRect.contains(wp.toPoint()))
                 m_selectedIndices.insert(i);
         }
-        update();
+        update(oldBand.united(m_rubberBandRect).adjusted(-1, -1, 1, 1).united(curveBounds()));
         return;
     }
 
     // Dragging selected points
     if (m_draggedIndex < 0) return;
 
+    const QRect oldBounds = curveBounds();
+
     const int top = 28, bottom = 68;
     double plotH = height() - top - bottom;
     double deltaY = e->pos().y() - m_dragStartY;
@@ -362,7 +417,7 @@ void FanCurveEditorWidget::mouseMoveEvent(QMouseEvent* e) {
         enforceMonotonicity(idx);
     }
 
-    update();
+    update(oldBounds.united(curveBounds()));
     emit pointsChanged(m_points);
 }
 
@@ -23,6 +23,8 @@
 #include <QScrollArea>
 #include <QMainWindow>
 #include <QStatusBar>
+#include <QHideEvent>
+#include <QShowEvent>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -63,7 +65,7 @@ GpuProfileTab::GpuProfileTab( UccdClient *client,
     m_liveMetricsTimer = new QTimer( this );
     m_liveMetricsTimer->setInterval( 1000 );
     connect( m_liveMetricsTimer, &QTimer::timeout, this, &GpuProfileTab::refreshLiveMetrics );
-    m_liveMetricsTimer->start();
+    // started by showEvent(); nobody sees the live labels on another tab
   }
 }
 
@@ -418,7 +420,8 @@ void GpuProfileTab::refreshOCState()
 
   // Update info labels
   m_gpuNameLabel->setText( state["gpuName"].toString( "Unknown" ) );
-  refreshLiveMetrics();
+  if ( isVisible() )  // otherwise showEvent() reads them
+    refreshLiveMetrics();
 
   // cTGP range (Profiles-page compatible semantics)
   m_powerMinW = state["powerMinW"].toDouble();
@@ -569,6 +572,23 @@ void GpuProfileTab::refreshOCState()
   updateButtonStates( m_uccdClient && m_uccdClient->isConnected() );
 }
 
+void GpuProfileTab::showEvent( QShowEvent *event )
+{
+  QWidget::showEvent( event );
+  if ( m_liveMetricsTimer )
+  {
+    refreshLiveMetrics();
+    m_liveMetricsTimer->start();
+  }
+}
+
+void GpuProfileTab::hideEvent( QHideEvent *event )
+{
+  QWidget::hideEvent( event );
+  if ( m_liveMetricsTimer )
+    m_liveMetricsTimer->stop();
+}
+
 void GpuProfileTab::refreshLiveMetrics()
 {
   if ( !m_ocAvailable || !m_uccdClient )
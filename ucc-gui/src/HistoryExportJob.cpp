@@ -0,0 +1,206 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "HistoryExportJob.hpp"
+#include "../libucc-dbus/UccdClient.hpp"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <fstream>
+
+namespace ucc
+{
+
+struct HistoryExportJob::Output
+{
+  std::ofstream file;
+  std::unique_ptr< HistoryExportWriter > writer;
+  std::unique_ptr< HistoryExporter > exporter;
+};
+
+HistoryExportJob::HistoryExportJob( UccdClient *client, const QString &path, HistoryExportFormat format,
+                                    QObject *parent )
+  : QObject( parent ), m_client( client ), m_path( path ), m_format( format )
+{
+  // one thread: the pages are written in the order they are handed over
+  m_pool.setMaxThreadCount( 1 );
+}
+
+HistoryExportJob::~HistoryExportJob()
+{
+  m_pool.waitForDone();
+}
+
+void HistoryExportJob::start( qint64 sinceMs )
+{
+  m_nextSinceMs = sinceMs;
+  m_client->getMetricCatalogAsync( this, [this, sinceMs]( std::optional< std::string > catalog ) {
+    if ( !catalog )
+    {
+      fail( tr( "Cannot read the daemon's metric catalog" ) );
+      return;
+    }
+    std::vector< std::string > names;
+    const QJsonArray metrics = QJsonDocument::fromJson( QByteArray::fromStdString( *catalog ) ).array();
+    for ( const QJsonValue &v : metrics )
+    {
+      const int id = v[ "id" ].toInt( -1 );
+      if ( id < 0 || id >= 64 )
+        continue;
+      if ( names.size() <= static_cast< size_t >( id ) )
+        names.resize( static_cast< size_t >( id ) + 1 );
+      names[ static_cast< size_t >( id ) ] = v[ "key" ].toString().toStdString();
+      if ( v[ "present" ].toBool() )
+        m_mask |= uint64_t( 1 ) << id;
+    }
+
+    m_client->getMonitorEventsSinceAsync( this, sinceMs,
+                                          [this, names]( std::optional< QByteArray > blob ) {
+      std::vector< MetricEventRecord > events;
+      if ( blob )
+        decodeMetricEvents( reinterpret_cast< const uint8_t * >( blob->constData() ),
+                            static_cast< size_t >( blob->size() ),
+                            [&events]( const MetricEventRecord &event ) { events.push_back( event ); } );
+
+      m_output = std::make_shared< Output >();
+      m_output->file.open( m_path.toStdString(), std::ios::binary | std::ios::trunc );
+      if ( !m_output->file )
+      {
+        fail( tr( "Cannot write %1" ).arg( m_path ) );
+        return;
+      }
+      if ( m_format == HistoryExportFormat::Parquet )
+        m_output->writer = std::make_unique< ParquetHistoryWriter >( m_output->file );
+      else
+        m_output->writer = std::make_unique< CsvHistoryWriter >( m_output->file );
+      m_output->exporter = std::make_unique< HistoryExporter >( *m_output->writer, m_mask, names,
+                                                                std::move( events ) );
+      requestPage();
+    } );
+  } );
+}
+
+void HistoryExportJob::requestPage()
+{
+  m_fetching = true;
+  m_client->getMonitorFramesPageAsync( this, m_nextSinceMs, m_mask, PAGE_ROWS,
+                                       [this]( std::optional< QByteArray > page ) { onPage( std::move( page ) ); } );
+}
+
+void HistoryExportJob::onPage( std::optional< QByteArray > page )
+{
+  m_fetching = false;
+  if ( m_failed )
+    return;
+  if ( !page )
+  {
+    fail( tr( "The daemon does not serve history pages" ) );
+    return;
+  }
+  // only the header is read here, the rows are left to the writer thread
+  const auto view = MetricFramesView::parse( reinterpret_cast< const uint8_t * >( page->constData() ),
+                                             static_cast< size_t >( page->size() ) );
+  if ( !view )
+  {
+    fail( tr( "The daemon sent a malformed history page" ) );
+    return;
+  }
+  if ( view->rows == 0 )
+  {
+    m_lastPage = true;
+    if ( !m_writing )
+      finishOutput();
+    return;
+  }
+
+  m_nextSinceMs = view->timestamp( view->rows - 1 ) + 1;
+  if ( m_writing )
+  {
+    m_pending = std::move( *page );
+    return;
+  }
+  writePage( std::move( *page ) );
+  requestPage();
+}
+
+void HistoryExportJob::writePage( QByteArray page )
+{
+  m_writing = true;
+  m_pool.start( [this, output = m_output, page = std::move( page )]() {
+    output->exporter->addPage( reinterpret_cast< const uint8_t * >( page.constData() ),
+                               static_cast< size_t >( page.size() ) );
+    const qulonglong rows = output->exporter->rows();
+    // the destructor waits for this task, so the job is still alive
+    QMetaObject::invokeMethod( this, [this, rows]() { onPageWritten( rows ); }, Qt::QueuedConnection );
+  } );
+}
+
+void HistoryExportJob::onPageWritten( qulonglong rows )
+{
+  m_writing = false;
+  if ( m_failed )
+    return;
+  emit progress( rows );
+
+  if ( m_pending )
+  {
+    QByteArray page = std::move( *m_pending );
+    m_pending.reset();
+    writePage( std::move( page ) );
+    if ( !m_lastPage && !m_fetching )
+      requestPage();
+  }
+  else if ( m_lastPage )
+    finishOutput();
+}
+
+void HistoryExportJob::finishOutput()
+{
+  m_writing = true;
+  m_pool.start( [this, output = m_output]() {
+    const bool ok = output->exporter->finish();
+    output->file.close();
+    const qulonglong rows = output->exporter->rows();
+    const qulonglong events = output->exporter->eventsWritten();
+    QMetaObject::invokeMethod( this, [this, ok, rows, events]() {
+      m_writing = false;
+      if ( !ok )
+      {
+        fail( tr( "Writing %1 failed" ).arg( m_path ) );
+        return;
+      }
+      emit finished( rows, events, QString() );
+      deleteLater();
+    }, Qt::QueuedConnection );
+  } );
+}
+
+void HistoryExportJob::fail( const QString &error )
+{
+  if ( m_failed )
+    return;
+  m_failed = true;
+  m_pool.waitForDone();
+  if ( m_output )
+  {
+    m_output->file.close();
+    QFile::remove( m_path );
+  }
+  emit finished( 0, 0, error );
+  deleteLater();
+}
+
+} // namespace ucc
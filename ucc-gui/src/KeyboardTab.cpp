@@ -30,6 +30,11 @@
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QUuid>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPixmap>
+#include <QScreen>
+#include <QTimer>
 
 namespace ucc
 {
@@ -65,6 +70,10 @@ void MainWindow::connectKeyboardBacklightPageWidgets()
 
   connect( m_removeKeyboardProfileButton, &QPushButton::clicked,
            this, &MainWindow::onRemoveKeyboardProfileClicked );
+
+  if ( m_keyboardAmbientCheck )
+    connect( m_keyboardAmbientCheck, &QCheckBox::toggled,
+             this, &MainWindow::onKeyboardAmbientToggled );
 }
 
 void MainWindow::setupKeyboardBacklightPage()
@@ -121,6 +130,7 @@ void MainWindow::setupKeyboardBacklightPage()
 
       if ( zones > 0 )
       {
+        m_keyboardZones = zones;
         QHBoxLayout *brightnessLayout = new QHBoxLayout();
         brightnessLayout->setContentsMargins( 5, 5, 5, 5 );
         brightnessLayout->setSpacing( 0 );
@@ -144,6 +154,13 @@ void MainWindow::setupKeyboardBacklightPage()
           m_keyboardColorButton = new QPushButton( "Choose Color" );
           brightnessLayout->addWidget( m_keyboardColorLabel );
           brightnessLayout->addWidget( m_keyboardColorButton );
+
+          m_keyboardAmbientCheck = new QCheckBox( "Screen ambient" );
+          m_keyboardAmbientCheck->setToolTip( "Light the keyboard with the colours on screen" );
+          brightnessLayout->addWidget( m_keyboardAmbientCheck );
+          m_keyboardAmbientTimer = new QTimer( this );
+          m_keyboardAmbientTimer->setInterval( KEYBOARD_AMBIENT_INTERVAL_MS );
+          connect( m_keyboardAmbientTimer, &QTimer::timeout, this, &MainWindow::onKeyboardAmbientTick );
         }
 
         mainLayout->addLayout( brightnessLayout );
@@ -277,6 +294,49 @@ void MainWindow::onKeyboardColorClicked()
   }
 }
 
+void MainWindow::onKeyboardAmbientToggled( bool enabled )
+{
+  if ( !enabled )
+  {
+    m_keyboardAmbientTimer->stop();
+    // hand the keyboard back to the profile's states or effect
+    m_UccdClient->setKeyboardBacklightFrame( {} );
+    if ( m_keyboardVisualizer )
+      m_keyboardVisualizer->showFrame( {} );
+    return;
+  }
+
+  m_keyboardAmbientCells = m_keyboardVisualizer && m_keyboardZones > 3
+                             ? m_keyboardVisualizer->zoneCells()
+                             : KeyboardFrameReducer::stripes( m_keyboardZones );
+  m_keyboardAmbientTimer->start();
+  onKeyboardAmbientTick();
+}
+
+void MainWindow::onKeyboardAmbientTick()
+{
+  QScreen *screen = QGuiApplication::primaryScreen();
+  const QImage image = screen ? screen->grabWindow( 0 ).toImage().convertToFormat( QImage::Format_RGB32 ) : QImage();
+  if ( image.isNull() )
+  {
+    // Wayland sessions do not let applications grab the screen this way
+    m_keyboardAmbientCheck->setChecked( false );
+    statusBar()->showMessage( "Screen capture is not available in this session", 3000 );
+    return;
+  }
+
+  KeyboardFrameReducer::reduce( image.constBits(), image.width(), image.height(),
+                                static_cast< size_t >( image.bytesPerLine() ),
+                                m_keyboardAmbientCells, m_keyboardZones, m_keyboardAmbientFrame );
+  if ( m_keyboardVisualizer )
+    m_keyboardVisualizer->showFrame( m_keyboardAmbientFrame );
+  if ( !m_UccdClient->setKeyboardBacklightFrame( m_keyboardAmbientFrame ) )
+  {
+    m_keyboardAmbientCheck->setChecked( false );
+    statusBar()->showMessage( "Failed to set keyboard backlight", 3000 );
+  }
+}
+
 void MainWindow::onKeyboardVisualizerColorsChanged()
 {
   if ( m_initializing )
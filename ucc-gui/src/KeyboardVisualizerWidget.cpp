@@ -24,6 +24,7 @@
 #include <QDBusInterface>
 #include <QDBusReply>
 #include <QDBusArgument>
+#include <algorithm>
 #include "DetectLayout.hpp"
 #include "AssignKeyZones.hpp"
 
@@ -43,6 +44,7 @@ KeyboardVisualizerWidget::KeyboardVisualizerWidget( int zones, int maxBrightness
 
   // Initialize m_keys with default entries for all zones
   m_keys.resize( m_zones );
+  m_buttons.assign( m_zones, nullptr );
   for ( int i = 0; i < m_zones; ++i )
   {
     m_keys[i].zoneId = i;
@@ -208,8 +210,10 @@ void ucc::KeyboardVisualizerWidget::createKeyButton( int zoneId, const QString &
   if ( zoneId >= 0 && zoneId < static_cast< int >( m_keys.size() ) )
   {
     m_keys[zoneId].label = label;
+    m_keys[zoneId].geometry = QRect( col, row, width, height );
     m_keys[zoneId].color = Qt::white;
     m_keys[zoneId].brightness = m_maxBrightness;
+    m_buttons[zoneId] = button;
   }
 
   connect( button, &QPushButton::clicked, this, &KeyboardVisualizerWidget::onKeyClicked );
@@ -290,15 +294,7 @@ void ucc::KeyboardVisualizerWidget::onColorChanged( const QColor &color )
     if ( zoneId >= 0 && zoneId < static_cast< int >( m_keys.size() ) )
     {
       m_keys[zoneId].color = color;
-      // Find the button for this zone
-      for ( QPushButton *button : m_selectedButtons )
-      {
-        if ( button->property( "zoneId" ).toInt() == zoneId )
-        {
-          updateKeyAppearance( button, color, m_keys[zoneId].brightness );
-          break;
-        }
-      }
+      updateKeyAppearance( zoneId );
     }
   }
   emit colorsChanged();
@@ -310,7 +306,16 @@ void ucc::KeyboardVisualizerWidget::updateKeyAppearance( QPushButton *button, co
   QString style = QString( "background-color: %1; color: %2; border: 1px solid #666; border-radius: 3px;" )
                   .arg( adjustedColor.name() )
                   .arg( adjustedColor.lightness() > 128 ? "#000000" : "#ffffff" );
-  button->setStyleSheet( style );
+  // restyling re-polishes the button; skip keys that already look like this
+  if ( button->styleSheet() != style )
+    button->setStyleSheet( style );
+}
+
+void ucc::KeyboardVisualizerWidget::updateKeyAppearance( int zoneId )
+{
+  if ( zoneId < 0 || zoneId >= static_cast< int >( m_buttons.size() ) || !m_buttons[zoneId] )
+    return;
+  updateKeyAppearance( m_buttons[zoneId], m_keys[zoneId].color, m_keys[zoneId].brightness );
 }
 
 QColor ucc::KeyboardVisualizerWidget::applyBrightness( const QColor &color, int brightness ) const
@@ -344,21 +349,7 @@ void ucc::KeyboardVisualizerWidget::updateFromJSON( const QJsonArray &states )
 
     m_keys[i].color = color;
     m_keys[i].brightness = brightness;
-
-    // Find the button for this zone
-    for ( int j = 0; j < m_layout->count(); ++j )
-    {
-      QLayoutItem *item = m_layout->itemAt( j );
-      if ( item && item->widget() )
-      {
-        QPushButton *button = qobject_cast< QPushButton * >( item->widget() );
-        if ( button && button->property( "zoneId" ).toInt() == i )
-        {
-          updateKeyAppearance( button, color, brightness );
-          break;
-        }
-      }
-    }
+    updateKeyAppearance( i );
   }
 }
 
@@ -383,24 +374,7 @@ void ucc::KeyboardVisualizerWidget::setGlobalBrightness( int brightness )
   for ( auto &key : m_keys )
   {
     key.brightness = brightness;
-  }
-
-  // Update all button appearances
-  for ( int i = 0; i < m_layout->count(); ++i )
-  {
-    QLayoutItem *item = m_layout->itemAt( i );
-    if ( item && item->widget() )
-    {
-      QPushButton *button = qobject_cast< QPushButton * >( item->widget() );
-      if ( button )
-      {
-        int zoneId = button->property( "zoneId" ).toInt();
-        if ( zoneId >= 0 && zoneId < static_cast< int >( m_keys.size() ) )
-        {
-          updateKeyAppearance( button, m_keys[zoneId].color, brightness );
-        }
-      }
-    }
+    updateKeyAppearance( key.zoneId );
   }
 
   emit colorsChanged();
@@ -411,24 +385,7 @@ void ucc::KeyboardVisualizerWidget::setGlobalColor( const QColor &color )
   for ( auto &key : m_keys )
   {
     key.color = color;
-  }
-
-  // Update all button appearances
-  for ( int i = 0; i < m_layout->count(); ++i )
-  {
-    QLayoutItem *item = m_layout->itemAt( i );
-    if ( item && item->widget() )
-    {
-      QPushButton *button = qobject_cast< QPushButton * >( item->widget() );
-      if ( button )
-      {
-        int zoneId = button->property( "zoneId" ).toInt();
-        if ( zoneId >= 0 && zoneId < static_cast< int >( m_keys.size() ) )
-        {
-          updateKeyAppearance( button, color, m_keys[zoneId].brightness );
-        }
-      }
-    }
+    updateKeyAppearance( key.zoneId );
   }
 
   emit colorsChanged();
@@ -439,4 +396,47 @@ QString KeyboardVisualizerWidget::getKeyLabel( int zoneId ) const
   return m_zoneMappings.value( zoneId, QString( "Zone %1" ).arg( zoneId ) );
 }
 
+std::vector< KeyboardZoneCell > KeyboardVisualizerWidget::zoneCells() const
+{
+  int columns = 0, rows = 0;
+  for ( const auto &key : m_keys )
+  {
+    columns = std::max( columns, key.geometry.x() + key.geometry.width() );
+    rows = std::max( rows, key.geometry.y() + key.geometry.height() );
+  }
+
+  std::vector< KeyboardZoneCell > cells;
+  if ( columns == 0 || rows == 0 )
+    return cells;
+  for ( const auto &key : m_keys )
+  {
+    // keys the layout does not place have an empty geometry
+    if ( key.geometry.isEmpty() )
+      continue;
+    cells.push_back( { key.zoneId,
+                       static_cast< double >( key.geometry.x() ) / columns,
+                       static_cast< double >( key.geometry.y() ) / rows,
+                       static_cast< double >( key.geometry.x() + key.geometry.width() ) / columns,
+                       static_cast< double >( key.geometry.y() + key.geometry.height() ) / rows } );
+  }
+  return cells;
+}
+
+void KeyboardVisualizerWidget::showFrame( const std::vector< uint8_t > &rgb )
+{
+  if ( rgb.empty() )
+  {
+    for ( const auto &key : m_keys )
+      updateKeyAppearance( key.zoneId );
+    return;
+  }
+
+  const size_t zones = std::min( m_buttons.size(), rgb.size() / 3 );
+  for ( size_t i = 0; i < zones; ++i )
+  {
+    if ( m_buttons[i] )
+      updateKeyAppearance( m_buttons[i], QColor( rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2] ), m_maxBrightness );
+  }
+}
+
 } // namespace ucc
\ No newline at end of file
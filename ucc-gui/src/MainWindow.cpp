@@ -102,6 +102,9 @@ MainWindow::MainWindow( QWidget *parent )
 {
   m_UccdClient = std::make_unique< UccdClient >( this );
 
+  // MonitorTab history fetches and fan-curve edits skip dbus-daemon
+  m_UccdClient->setPeerChannelEnabled( true );
+
   // Query device capabilities from daemon
   if ( auto waterCooler = m_UccdClient->getWaterCoolerSupported() )
     m_waterCoolerSupported = *waterCooler;
@@ -161,7 +164,7 @@ MainWindow::MainWindow( QWidget *parent )
   m_initializing = false;
 
   // Start monitoring since dashboard is the first tab
-  m_systemMonitor->setMonitoringActive( true );
+  updateMonitoringActivity();
 }
 
 MainWindow::~MainWindow()
@@ -178,25 +181,23 @@ void MainWindow::setupUI()
   // Connect tab changes to control monitoring
   connect( m_tabs, &QTabWidget::currentChanged, this, &MainWindow::onTabChanged );
 
-  // Fetch system hardware info from daemon and pass to DashboardTab
-  QString laptopModel, cpuModel, dGpuModel, iGpuModel;
-  if ( auto sysInfoJson = m_UccdClient->getSystemInfoJSON() )
-  {
-    QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *sysInfoJson ) );
-    if ( doc.isObject() )
-    {
-      const QJsonObject obj = doc.object();
-      laptopModel = obj.value( "laptopModel" ).toString();
-      cpuModel    = obj.value( "cpuModel" ).toString();
-      dGpuModel   = obj.value( "dGpuModel" ).toString();
-      iGpuModel   = obj.value( "iGpuModel" ).toString();
-    }
-  }
-
-  // Now create DashboardTab (daemon-backed water cooler; no controller pointer)
+  // Create DashboardTab (daemon-backed water cooler; no controller pointer)
   m_dashboardTab = new DashboardTab( m_systemMonitor.get(), m_profileManager.get(), m_waterCoolerSupported,
-                                     laptopModel, cpuModel, dGpuModel, iGpuModel, this );
+                                     {}, {}, {}, {}, this );
   m_tabs->addTab( m_dashboardTab, "Dashboard" );
+
+  // System hardware info only names the headers; don't hold up the window for it
+  m_UccdClient->getSystemInfoJSONAsync( m_dashboardTab, [this]( std::optional< std::string > sysInfoJson ) {
+    if ( !sysInfoJson )
+      return;
+    QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( *sysInfoJson ) );
+    if ( !doc.isObject() )
+      return;
+    const QJsonObject obj = doc.object();
+    m_dashboardTab->setSystemInfo( obj.value( "laptopModel" ).toString(), obj.value( "cpuModel" ).toString(),
+                                   obj.value( "dGpuModel" ).toString(), obj.value( "iGpuModel" ).toString() );
+  } );
+
   setupProfilesPage();
 
   // Place the Fan Control tab directly after Profiles and rename it
@@ -205,9 +206,11 @@ void MainWindow::setupUI()
   // Place the GPU OC tab after Fan Control
   setupGpuProfileTab();
 
-  // Add Monitoring graph tab
-  m_monitorTab = new MonitorTab( m_UccdClient.get(), this );
-  m_tabs->addTab( m_monitorTab, "Monitor" );
+  // Add Monitoring graph tab; the MonitorTab itself is built on first activation
+  m_monitorPage = new QWidget( this );
+  QVBoxLayout *monitorLayout = new QVBoxLayout( m_monitorPage );
+  monitorLayout->setContentsMargins( 0, 0, 0, 0 );
+  m_tabs->addTab( m_monitorPage, "Monitor" );
 
   setupKeyboardBacklightPage();
   setupHardwarePage();
@@ -1233,20 +1236,50 @@ void MainWindow::updateFanCrosshairs()
   }
 }
 
-void MainWindow::onTabChanged( int index )
+void MainWindow::changeEvent( QEvent *event )
 {
+  QMainWindow::changeEvent( event );
+  if ( event->type() == QEvent::WindowStateChange && m_tabs )
+    updateMonitoringActivity();
+}
+
+void MainWindow::updateMonitoringActivity()
+{
+  const int index = m_tabs->currentIndex();
   const int fanTabIndex = m_fanControlTab ? m_tabs->indexOf( m_fanControlTab ) : -1;
-  const int monitorTabIndex = m_monitorTab ? m_tabs->indexOf( m_monitorTab ) : -1;
+  const int monitorTabIndex = m_monitorPage ? m_tabs->indexOf( m_monitorPage ) : -1;
+  const bool minimized = isMinimized();
 
   // Enable monitoring when dashboard (0) or fan control tab is visible
-  bool needsMonitoring = ( index == 0 || index == fanTabIndex );
-  qDebug() << "Tab changed to" << index << "- Monitoring active:" << needsMonitoring
-           << "(fan tab =" << fanTabIndex << ")";
+  const bool needsMonitoring = !minimized && ( index == 0 || index == fanTabIndex );
+  const bool needsHistory = !minimized && index == monitorTabIndex;
+  qDebug() << "Tab" << index << "- Monitoring active:" << needsMonitoring
+           << "(fan tab =" << fanTabIndex << ", minimized =" << minimized << ")";
+
+  // Both share this process's bus name, which the daemon keys MetricsSample
+  // subscriptions by: stop the one going idle before starting the other
+  if ( m_monitorTab && !needsHistory )
+    m_monitorTab->setMonitoringActive( false );
   m_systemMonitor->setMonitoringActive( needsMonitoring );
+  if ( m_monitorTab && needsHistory )
+    m_monitorTab->setMonitoringActive( true );
+}
 
-  // Activate / deactivate the Monitor tab's incremental fetch
-  if ( m_monitorTab )
-    m_monitorTab->setMonitoringActive( index == monitorTabIndex );
+void MainWindow::onTabChanged( int index )
+{
+  const int fanTabIndex = m_fanControlTab ? m_tabs->indexOf( m_fanControlTab ) : -1;
+  const int monitorTabIndex = m_monitorPage ? m_tabs->indexOf( m_monitorPage ) : -1;
+
+  // Build the Monitor tab on first use: it reads power limits and history
+  // from the daemon that nothing else needs at startup
+  if ( index == monitorTabIndex && !m_monitorTab )
+  {
+    m_monitorTab = new MonitorTab( m_UccdClient.get(), m_monitorPage );
+    m_monitorPage->layout()->addWidget( m_monitorTab );
+  }
+
+  // Live gauges (SystemMonitor) and the Monitor tab's incremental fetch
+  updateMonitoringActivity();
 
   // Update or clear fan curve crosshairs
   if ( index == fanTabIndex )
@@ -1752,10 +1785,14 @@ void MainWindow::loadProfileDetails( const QString &profileId )
 
   // Load CPU settings (nested in cpu object)
 
+  m_cpuCoreClassLimits = QJsonObject();
   if ( obj.contains( "cpu" ) && obj["cpu"].isObject() )
   {
     QJsonObject cpuObj = obj["cpu"].toObject();
 
+    for ( const char *key : { "performanceCores", "efficiencyCores", "coreParking", "adaptiveEpp" } )
+      if ( cpuObj.contains( key ) )
+        m_cpuCoreClassLimits[ key ] = cpuObj[ key ];
 
     if ( cpuObj.contains( "onlineCores" ) )
       m_cpuCoresSlider->setValue( cpuObj["onlineCores"].toInt( m_cpuCoresSlider->maximum() ) );
@@ -1847,10 +1884,13 @@ void MainWindow::loadProfileDetails( const QString &profileId )
 
   // Then, set slider values from profile
 
+  m_odmPowerLimitController = QJsonObject();
   if ( obj.contains( "odmPowerLimits" ) && obj["odmPowerLimits"].isObject() )
   {
     QJsonObject odmLimitsObj = obj["odmPowerLimits"].toObject();
 
+    if ( odmLimitsObj.contains( "controller" ) && odmLimitsObj["controller"].isObject() )
+      m_odmPowerLimitController = odmLimitsObj["controller"].toObject();
 
     if ( odmLimitsObj.contains( "tdpValues" ) && odmLimitsObj["tdpValues"].isArray() )
     {
@@ -2193,6 +2233,7 @@ QString MainWindow::buildProfileJSON() const
       if ( fp.contains( "tableGPU" ) )           fanObj["tableGPU"]           = fp["tableGPU"];
       if ( fp.contains( "tablePump" ) )          fanObj["tablePump"]          = fp["tablePump"];
       if ( fp.contains( "tableWaterCoolerFan" ) ) fanObj["tableWaterCoolerFan"] = fp["tableWaterCoolerFan"];
+      if ( fp.contains( "controller" ) )         fanObj["controller"]         = fp["controller"];
     }
   }
   fanObj["fanProfile"]       = fanProfileId;
@@ -2208,6 +2249,8 @@ QString MainWindow::buildProfileJSON() const
   cpuObj["energyPerformancePreference"] = m_eppCombo ? m_eppCombo->currentData().toString() : QString();
   cpuObj["scalingMinFrequency"]         = std::clamp( m_minFrequencySlider->value(), m_cpuMinFreqKHz, m_cpuMaxFreqKHz );
   cpuObj["scalingMaxFrequency"]         = std::clamp( m_maxFrequencySlider->value(), m_cpuMinFreqKHz, m_cpuMaxFreqKHz );
+  for ( auto it = m_cpuCoreClassLimits.constBegin(); it != m_cpuCoreClassLimits.constEnd(); ++it )
+    cpuObj[ it.key() ] = it.value();
   profileObj["cpu"] = cpuObj;
 
   // ODM Power Limits (TDP)
@@ -2217,6 +2260,8 @@ QString MainWindow::buildProfileJSON() const
   tdpArray.append( m_odmPowerLimit2Slider->value() );
   tdpArray.append( m_odmPowerLimit3Slider->value() );
   odmObj["tdpValues"] = tdpArray;
+  if ( !m_odmPowerLimitController.isEmpty() )
+    odmObj["controller"] = m_odmPowerLimitController;
   profileObj["odmPowerLimits"] = odmObj;
 
   // GPU OC profile — embed complete GPU OC data (like keyboard data)
@@ -2324,11 +2369,6 @@ void MainWindow::onSaveClicked()
   QString profileId = m_profileCombo->currentData().toString();
   const bool isCustom = m_profileManager->isCustomProfile( profileId );
 
-  if ( isCustom )
-  {
-    m_profileManager->saveProfile( buildProfileJSON() );
-  }
-
   // For both custom and built-in profiles, update stateMap based on mains/battery button states
   // Batch all stateMap changes into a single D-Bus call (single backup + write)
   std::map< QString, QString > stateMapUpdates;
@@ -2339,7 +2379,10 @@ void MainWindow::onSaveClicked()
   if ( m_waterCoolerButton->isChecked() )
     stateMapUpdates["power_wc"] = profileId;
 
-  if ( !stateMapUpdates.empty() )
+  // a custom profile goes to the daemon together with the stateMap changes
+  if ( isCustom )
+    m_profileManager->saveProfile( buildProfileJSON(), stateMapUpdates );
+  else if ( !stateMapUpdates.empty() )
     m_profileManager->setBatchStateMap( stateMapUpdates );
 
   // Indicate saving; actual success will be reflected when ProfileManager signals
@@ -15,6 +15,8 @@
 
 #include "MonitorTab.hpp"
 #include "../libucc-dbus/UccdClient.hpp"
+#include "MetricsCodec.hpp"
+#include "HistoryExportJob.hpp"
 #include <QDateTime>
 #include <QLabel>
 #include <QScrollArea>
@@ -22,13 +24,17 @@
 #include <QStackedWidget>
 #include <QToolTip>
 #include <QDir>
+#include <QFileDialog>
 #include <QSettings>
 #include <QMainWindow>
 #include <QStatusBar>
 #include <QApplication>
+#include <QDebug>
+#include <QOpenGLContext>
 #include <cstring>
 #include <algorithm>
 #include <functional>
+#include <limits>
 
 namespace ucc
 {
@@ -73,9 +79,11 @@ struct MetricDef
   MetricGroup group;
 };
 
-static constexpr int METRIC_COUNT = 10;
+static constexpr int METRIC_COUNT = 28;
 
-// Order matches MetricId enum in MetricsHistoryStore.hpp
+// Order matches MetricId enum in MetricsHistoryStore.hpp.  The water
+// cooler's RSSI and command latency follow; they have no chart here and
+// are read with ucc-cli or the OpenMetrics exporter.
 static const MetricDef kMetrics[ METRIC_COUNT ] =
 {
   { "cpuTemp",             "CPU Temp",            QColor( 124, 179, 66 ),  MetricGroup::Temp  },
@@ -88,6 +96,24 @@ static const MetricDef kMetrics[ METRIC_COUNT ] =
   { "gpuFrequency",        "dGPU Frequency",      QColor( 255, 167, 38 ),  MetricGroup::Freq  },
   { "gpuVramFrequency",    "dGPU VRAM Freq",      QColor( 46, 204, 113 ),  MetricGroup::Freq  },
   { "gpuCoreVoltage",      "dGPU Core Voltage",   QColor( 174, 234, 0 ),   MetricGroup::Volt  },
+  { "gpu2Temp",            "dGPU 2 Temp",         QColor( 0, 150, 136 ),   MetricGroup::Temp  },
+  { "gpu2Power",           "dGPU 2 Power",        QColor( 123, 31, 162 ),  MetricGroup::Power },
+  { "gpu2Frequency",       "dGPU 2 Frequency",    QColor( 230, 81, 0 ),    MetricGroup::Freq  },
+  { "gpuComputeUtil",      "dGPU Utilization",    QColor( 3, 169, 244 ),   MetricGroup::Duty  },
+  { "gpuMemoryUtil",       "dGPU Memory Util",    QColor( 255, 112, 67 ),  MetricGroup::Duty  },
+  { "cpuPowerCore",        "CPU Cores Power",     QColor( 56, 142, 60 ),   MetricGroup::Power },
+  { "cpuPowerUncore",      "CPU Uncore Power",    QColor( 41, 121, 255 ),  MetricGroup::Power },
+  { "cpuPowerDram",        "DRAM Power",          QColor( 141, 110, 99 ),  MetricGroup::Power },
+  { "cpuPowerPsys",        "Platform Power",      QColor( 244, 67, 54 ),   MetricGroup::Power },
+  { "cpuFrequencyMax",     "CPU Max Frequency",   QColor( 27, 94, 32 ),    MetricGroup::Freq  },
+  { "cpuFrequencyPCore",   "P-core Frequency",    QColor( 0, 137, 123 ),   MetricGroup::Freq  },
+  { "cpuFrequencyECore",   "E-core Frequency",    QColor( 129, 199, 132 ), MetricGroup::Freq  },
+  { "cpuThrottleCore",     "CPU Core Throttle",   QColor( 229, 57, 53 ),   MetricGroup::Duty  },
+  { "cpuThrottlePackage",  "CPU Pkg Throttle",    QColor( 183, 28, 28 ),   MetricGroup::Duty  },
+  { "cpuPowerLimited",     "CPU Power Limited",   QColor( 255, 145, 0 ),   MetricGroup::Duty  },
+  { "cpuPkgCstate",        "CPU Pkg C-state",     QColor( 96, 125, 139 ),  MetricGroup::Duty  },
+  { "wcFanDuty",           "Water Cooler Fan",    QColor( 38, 198, 218 ),  MetricGroup::Duty  },
+  { "wcPumpLevel",         "Water Cooler Pump",   QColor( 21, 101, 192 ),  MetricGroup::Duty  },
 };
 
 // ---------------------------------------------------------------------------
@@ -208,6 +234,17 @@ static QValueAxis *createYAxis( const QString &title, double min, double max )
   return axis;
 }
 
+/// Whether an OpenGL context can be created for accelerated series
+/// (not on software-only X servers, VNC sessions, or Qt builds without GL)
+static bool openGlAvailable()
+{
+  static const bool available = [] {
+    QOpenGLContext context;
+    return context.create() && context.isValid();
+  }();
+  return available;
+}
+
 static QChartView *createChartView( QChart *chart )
 {
   auto *view = new QChartView( chart );
@@ -229,45 +266,69 @@ MonitorTab::MonitorTab( UccdClient *client, QWidget *parent )
 
   setFocusPolicy( Qt::StrongFocus );  // Enable keyboard events for spacebar pause
 
-  m_fetchTimer.setInterval( 1000 );
+  m_fetchTimer.setInterval( POLL_INTERVAL_MS );
   connect( &m_fetchTimer, &QTimer::timeout, this, &MonitorTab::fetchData );
+
+  // The daemon pushes a MetricsSample per tick while we are subscribed;
+  // each one triggers an incremental fetch and re-arms the fallback poll.
+  if ( m_client )
+    connect( m_client, &UccdClient::metricsSample, this, &MonitorTab::onMetricsSample );
 }
 
 void MonitorTab::setMonitoringActive( bool active )
 {
+  if ( active && m_fetchTimer.isActive() )
+    return;  // already live (e.g. the window was only maximized); keep the graph
+
   if ( active )
   {
     // Clear all in-memory buffers and series to avoid overlapping time ranges
     // (which cause crossed lines when the same timestamps appear twice).
     for ( auto &[key, info] : m_seriesMap )
-    {
       info.buffer.clear();
-      info.series->clear();
-
-      QVariant uv = info.series->property( "_uniSeries" );
-      if ( uv.isValid() )
-      {
-        auto *uni = qobject_cast< QLineSeries * >( uv.value< QObject * >() );
-        if ( uni )
-          uni->clear();
-      }
-    }
+    rebuildLod();
 
     // Only fetch data that fits in the current visible window — not the full
     // daemon history horizon (which can be 30 minutes).  This bounds the
     // initial render cost to m_windowSeconds worth of points.
     const qint64 now = QDateTime::currentMSecsSinceEpoch();
     m_lastTimestamp = now - static_cast< qint64 >( m_windowSeconds ) * 1000;
+    m_decimateNextFetch = true;
     fetchData();
+
+    const bool pushed = m_client && m_client->setMetricsSamplesEnabled( true );
+    if ( m_client )
+    {
+      m_client->setFastSamplingEnabled( true );
+      m_client->setSensorSubscription( ucc::SensorGroup::All );
+    }
+    m_fetchTimer.setInterval( pushed ? FALLBACK_POLL_INTERVAL_MS : POLL_INTERVAL_MS );
     m_fetchTimer.start();
     m_unifiedChartView->setFocus();  // Immediate key events (crosshair Ctrl)
   }
   else
   {
     m_fetchTimer.stop();
+    if ( m_client )
+    {
+      m_client->setMetricsSamplesEnabled( false );
+      m_client->setFastSamplingEnabled( false );
+      m_client->setSensorSubscription( 0 );
+    }
   }
 }
 
+void MonitorTab::onMetricsSample( qint64 timestampMs, const QList< double > &values )
+{
+  Q_UNUSED( values )
+  if ( !m_fetchTimer.isActive() || timestampMs < m_lastTimestamp )
+    return;
+
+  fetchData();
+  m_fetchTimer.setInterval( FALLBACK_POLL_INTERVAL_MS );
+  m_fetchTimer.start();
+}
+
 // ---------------------------------------------------------------------------
 // UI Setup
 // ---------------------------------------------------------------------------
@@ -304,7 +365,7 @@ void MonitorTab::setupUI()
 
     connect( cb, &QCheckBox::toggled, series, &QLineSeries::setVisible );
 
-    m_seriesMap[ md.key ] = { series, cb, md.label, md.color, {} };
+    m_seriesMap[ md.key ] = { series, cb, md.label, md.color };
   }
 
   m_unifiedCheckBox = new QCheckBox( "Unified Graph" );
@@ -312,6 +373,21 @@ void MonitorTab::setupUI()
   connect( m_unifiedCheckBox, &QCheckBox::toggled, this, &MonitorTab::setUnifiedMode );
   legendLayout->addWidget( m_unifiedCheckBox, row, col );
 
+  if ( ++col >= 5 ) { col = 0; ++row; }
+  // Draw the series on the GPU; the software raster repaints every point
+  // of every series each second, which dominates CPU time on long windows
+  m_acceleratedCheckBox = new QCheckBox( "Accelerated" );
+  m_acceleratedCheckBox->setToolTip( "Draw graphs with OpenGL" );
+  m_acceleratedCheckBox->setVisible( openGlAvailable() );
+  connect( m_acceleratedCheckBox, &QCheckBox::toggled, this, &MonitorTab::setAcceleratedCharts );
+  legendLayout->addWidget( m_acceleratedCheckBox, row, col );
+
+  if ( ++col >= 5 ) { col = 0; ++row; }
+  m_exportButton = new QPushButton( "Export…" );
+  m_exportButton->setToolTip( "Save the whole monitoring history with its events as CSV or Parquet" );
+  connect( m_exportButton, &QPushButton::clicked, this, &MonitorTab::exportHistory );
+  legendLayout->addWidget( m_exportButton, row, col );
+
   if ( ++col >= 5 ) { col = 0; ++row; }
   // Pause indicator (hidden by default, shown when spacebar pauses updates)
   m_pauseLabel = new QLabel( "⏸ PAUSED" );
@@ -383,6 +459,9 @@ void MonitorTab::setupUI()
              this, &MonitorTab::updateStickyMarkPositions );
   }
 
+  connect( m_acceleratedCheckBox, &QCheckBox::toggled,
+           this, &MonitorTab::saveCheckboxStates );
+
   // Apply initial group visibility after loading saved states
   updateGroupChartVisibility();
 }
@@ -415,6 +494,7 @@ void MonitorTab::setTimeWindow( int seconds )
     // When paused we cannot re-fetch, so just shift the visible axis range.
     // Do NOT trim or clear buffers — the data must survive zoom-in so that a
     // subsequent zoom-out can reveal it again.
+    rebuildLod();
     updateAxes();
     updateStickyMarkPositions();
   }
@@ -423,16 +503,11 @@ void MonitorTab::setTimeWindow( int seconds )
     // Clear all in-memory buffers and re-fetch from the new horizon so that
     // widening the window loads fresh history and narrowing immediately trims.
     for ( auto &[key, info] : m_seriesMap )
-    {
       info.buffer.clear();
-      info.series->clear();
-      QVariant uv = info.series->property( "_uniSeries" );
-      if ( uv.isValid() )
-        if ( auto *uni = qobject_cast< QLineSeries * >( uv.value< QObject * >() ) )
-          uni->clear();
-    }
+    rebuildLod();
     const qint64 now = QDateTime::currentMSecsSinceEpoch();
     m_lastTimestamp = now - static_cast< qint64 >( m_windowSeconds ) * 1000;
+    m_decimateNextFetch = true;
     fetchData();
     updateAxes();
   }
@@ -445,6 +520,60 @@ void MonitorTab::setTimeWindow( int seconds )
   settings.sync();
 }
 
+void MonitorTab::exportHistory()
+{
+  if ( !m_client )
+    return;
+
+  QString filter;
+  QString path = QFileDialog::getSaveFileName( this, "Export Monitoring History",
+                                               QDir::homePath() + "/ucc-history.csv",
+                                               "CSV (*.csv);;Parquet (*.parquet)", &filter );
+  if ( path.isEmpty() )
+    return;
+  auto format = parseHistoryExportFormat( path.toStdString() );
+  if ( !format )
+  {
+    format = filter.startsWith( "Parquet" ) ? HistoryExportFormat::Parquet : HistoryExportFormat::Csv;
+    path += format == HistoryExportFormat::Parquet ? ".parquet" : ".csv";
+  }
+
+  const auto status = [this]( const QString &text, int timeoutMs ) {
+    if ( auto *mw = qobject_cast< QMainWindow * >( window() ) )
+      mw->statusBar()->showMessage( text, timeoutMs );
+  };
+
+  // the file is written on a worker thread; charts keep updating meanwhile
+  m_exportButton->setEnabled( false );
+  auto *job = new HistoryExportJob( m_client, path, *format, this );
+  connect( job, &HistoryExportJob::progress, this, [status]( qulonglong rows ) {
+    status( QStringLiteral( "Exporting history: %1 rows" ).arg( rows ), 0 );
+  } );
+  connect( job, &HistoryExportJob::finished, this,
+           [this, status, path]( qulonglong rows, qulonglong events, const QString &error ) {
+    m_exportButton->setEnabled( true );
+    if ( error.isEmpty() )
+      status( QStringLiteral( "Exported %1 rows and %2 events to %3" ).arg( rows ).arg( events ).arg( path ), 5000 );
+    else
+      status( QStringLiteral( "Export failed: %1" ).arg( error ), 5000 );
+  } );
+  job->start();
+}
+
+void MonitorTab::resizeEvent( QResizeEvent *event )
+{
+  QWidget::resizeEvent( event );
+
+  // Re-decimate when the plot width changed noticeably (not on every pixel
+  // of a drag-resize)
+  if ( m_seriesMap.empty() )
+    return;
+  const double bucket = lodBucketMs();
+  const double current = m_seriesMap.begin()->second.lod.bucketWidth();
+  if ( std::abs( bucket - current ) > 0.1 * current )
+    rebuildLod();
+}
+
 void MonitorTab::wheelEvent( QWheelEvent *event )
 {
   // Only change the time window when Ctrl is held; otherwise let the
@@ -520,6 +649,7 @@ void MonitorTab::createUnifiedSeries()
     QPen pen( md.color );
     pen.setWidth( 1 );
     ns->setPen( pen );
+    ns->setUseOpenGL( m_acceleratedCharts );
 
     m_unifiedChart->addSeries( ns );
     ns->attachAxis( m_unifiedXAxis );
@@ -542,15 +672,16 @@ void MonitorTab::createUnifiedSeries()
              ns, &QLineSeries::setVisible );
     ns->setVisible( m_seriesMap[ md.key ].toggle->isChecked() );
 
-    // Copy existing raw data into the shadow series (normalised)
-    // so the unified chart is immediately populated with all visible history.
-    auto &rawBuffer = m_seriesMap[ md.key ].buffer;
+    // Copy what the raw series draws into the shadow series (normalised)
+    // so the unified chart is immediately populated with all visible
+    // history; newer points reach both through commitSeries().
+    const auto &drawn = m_seriesMap[ md.key ].lod.points();
     const double scale = metricToNormalisedScale( md.group );
-    if ( !rawBuffer.isEmpty() )
+    if ( !drawn.empty() )
     {
       QList< QPointF > pts;
-      pts.reserve( rawBuffer.size() );
-      for ( const auto &pt : rawBuffer )
+      pts.reserve( static_cast< qsizetype >( drawn.size() ) );
+      for ( const auto &pt : drawn )
         pts.append( QPointF( pt.x(), pt.y() * scale ) );
       ns->replace( pts );
     }
@@ -603,10 +734,29 @@ void MonitorTab::setUnifiedMode( bool unified )
     destroyUnifiedSeries();
   }
   m_chartStack->setCurrentIndex( unified ? 1 : 0 );
+  rebuildLod();
   updateAxes();
   updateStickyMarkPositions();
 }
 
+void MonitorTab::setAcceleratedCharts( bool accelerated )
+{
+  m_acceleratedCharts = accelerated && openGlAvailable();
+
+  // Accelerated series are drawn on a transparent GL overlay of the plot
+  // area; hover, click (sticky marks), the crosshair and zoom keep working
+  // because the overlay passes mouse events through to the chart view.
+  // The invisible unified anchor series stays on the raster.
+  for ( auto &[key, info] : m_seriesMap )
+  {
+    info.series->setUseOpenGL( m_acceleratedCharts );
+    QVariant uv = info.series->property( "_uniSeries" );
+    if ( uv.isValid() )
+      if ( auto *uni = qobject_cast< QLineSeries * >( uv.value< QObject * >() ) )
+        uni->setUseOpenGL( m_acceleratedCharts );
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Hover callout — shows exact value under the pointer
 // ---------------------------------------------------------------------------
@@ -818,15 +968,16 @@ void MonitorTab::handleSeriesClick( QLineSeries *ls, const QPointF &point )
 
   // Snap to the nearest actual data point in the raw buffer
   auto &buf = m_seriesMap[ key ].buffer;
-  if ( buf.isEmpty() )
+  if ( buf.empty() )
     return;
 
   qint64 snapTs  = clickTs;
   double snapVal = rawValue;
   qint64 bestDist = m_windowSeconds * 1000LL + 1;
 
-  for ( const auto &pt : buf )
+  for ( size_t i = 0; i < buf.size(); ++i )
   {
+    const QPointF &pt = buf[ i ];
     const qint64 d = std::abs( static_cast< qint64 >( pt.x() ) - clickTs );
     if ( d < bestDist )
     {
@@ -1329,7 +1480,7 @@ void MonitorTab::updateCrosshair( const QPointF &widgetPos, bool ctrlHeld )
   {
     const auto &md  = kMetrics[ i ];
     const auto &info = m_seriesMap[ md.key ];
-    if ( info.toggle->isChecked() && !info.buffer.isEmpty() )
+    if ( info.toggle->isChecked() && !info.buffer.empty() )
       ++totalLabels;
   }
 
@@ -1343,22 +1494,14 @@ void MonitorTab::updateCrosshair( const QPointF &widgetPos, bool ctrlHeld )
       continue;
 
     const auto &buf = info.buffer;
-    if ( buf.isEmpty() )
+    if ( buf.empty() )
       continue;
 
     // Binary search for the nearest timestamp in the raw buffer
-    int lo = 0, hi = buf.size() - 1;
-    while ( lo < hi )
-    {
-      const int mid = lo + ( hi - lo ) / 2;
-      if ( static_cast< qint64 >( buf[ mid ].x() ) < cursorTs )
-        lo = mid + 1;
-      else
-        hi = mid;
-    }
+    const size_t lo = std::min( buf.lowerBound( static_cast< double >( cursorTs ) ), buf.size() - 1 );
 
     // Check the neighbor as well to find the truly closest
-    int bestIdx = lo;
+    size_t bestIdx = lo;
     if ( lo > 0 )
     {
       const qint64 dLo = std::abs( static_cast< qint64 >( buf[ lo ].x() ) - cursorTs );
@@ -1492,21 +1635,13 @@ void MonitorTab::crosshairClick( const QPointF &widgetPos )
       continue;
 
     const auto &buf = info.buffer;
-    if ( buf.isEmpty() )
+    if ( buf.empty() )
       continue;
 
     // Binary search for the nearest timestamp
-    int lo = 0, hi = buf.size() - 1;
-    while ( lo < hi )
-    {
-      const int mid = lo + ( hi - lo ) / 2;
-      if ( static_cast< qint64 >( buf[ mid ].x() ) < cursorTs )
-        lo = mid + 1;
-      else
-        hi = mid;
-    }
+    const size_t lo = std::min( buf.lowerBound( static_cast< double >( cursorTs ) ), buf.size() - 1 );
 
-    int bestIdx = lo;
+    size_t bestIdx = lo;
     if ( lo > 0 )
     {
       const qint64 dLo = std::abs( static_cast< qint64 >( buf[ lo ].x() ) - cursorTs );
@@ -1576,6 +1711,7 @@ void MonitorTab::applyZoomRect( const QRect &viewportRect )
   m_unifiedYAxis->setRange( yLo, yHi );
 
   m_zoomed = true;
+  rebuildLod();
   updateStickyMarkPositions();
 }
 
@@ -1586,6 +1722,7 @@ void MonitorTab::resetZoom()
 
   m_unifiedYAxis->setRange( 0, 100 );
   m_zoomed = false;
+  rebuildLod();
   updateStickyMarkPositions();
   // The X axis will be restored by updateAxes() on the next tick
 }
@@ -1697,9 +1834,90 @@ void MonitorTab::fetchData()
 {
   if ( !m_client || m_paused )
     return;
+  // A whole-window refill supersedes an incremental fetch still in flight
+  if ( m_fetchInFlight && !m_decimateNextFetch )
+    return;
+
+  // A whole-window refill is downsampled by the daemon to roughly two points
+  // per horizontal pixel; later incremental fetches append raw samples.
+  if ( m_decimateNextFetch )
+  {
+    m_decimateNextFetch = false;
+    const int budget = std::max( 2 * m_unifiedChartView->width(), 300 );
+    const quint64 serial = beginFetch();
+    m_client->getMonitorDataSinceDecimatedAsync( this, m_lastTimestamp, ( 1u << METRIC_COUNT ) - 1, budget,
+                                                 [this, serial]( std::optional< QByteArray > result ) {
+      if ( !endFetch( serial ) )
+        return;
+      if ( result.has_value() )
+        applyFetchedData( *result, false );
+      else
+        fetchIncremental();
+    } );
+    return;
+  }
+  fetchIncremental();
+}
+
+quint64 MonitorTab::beginFetch()
+{
+  m_fetchInFlight = true;
+  return ++m_fetchSerial;
+}
+
+bool MonitorTab::endFetch( quint64 serial )
+{
+  if ( serial != m_fetchSerial )
+    return false;  // superseded by a refill
+  m_fetchInFlight = false;
+  return true;
+}
+
+void MonitorTab::fetchIncremental()
+{
+  // Read straight from the daemon's shared-memory segment when it covers
+  // the range; otherwise prefer the compressed wire format and fall back
+  // permanently to the raw layout once the daemon turns out not to support it.
+  // Only the D-Bus paths are asynchronous; the segment read never blocks.
+  if ( auto local = m_client->readLiveMetricsSince( m_lastTimestamp ) )
+  {
+    applyFetchedData( *local, false );
+    return;
+  }
+
+  const auto fetchRaw = [this]( bool afterCompressed ) {
+    const quint64 serial = beginFetch();
+    m_client->getMonitorDataSinceAsync( this, m_lastTimestamp,
+                                        [this, serial, afterCompressed]( std::optional< QByteArray > result ) {
+      if ( !endFetch( serial ) || !result.has_value() )
+        return;
+      if ( afterCompressed )
+        m_compressedFetch = false;
+      applyFetchedData( *result, false );
+    } );
+  };
 
-  auto result = m_client->getMonitorDataSince( m_lastTimestamp );
-  if ( !result.has_value() || result->isEmpty() )
+  if ( !m_compressedFetch )
+  {
+    fetchRaw( false );
+    return;
+  }
+
+  const quint64 serial = beginFetch();
+  m_client->getMonitorDataSinceCompressedAsync( this, m_lastTimestamp,
+                                                [this, serial, fetchRaw]( std::optional< QByteArray > result ) {
+    if ( !endFetch( serial ) )
+      return;
+    if ( result.has_value() )
+      applyFetchedData( *result, true );
+    else
+      fetchRaw( true );
+  } );
+}
+
+void MonitorTab::applyFetchedData( const QByteArray &data, bool compressed )
+{
+  if ( data.isEmpty() )
     return;
 
   // ── Suspend painting on ALL chart views during the batch update ────
@@ -1710,7 +1928,10 @@ void MonitorTab::fetchData()
   m_voltChartView->setUpdatesEnabled( false );
   m_unifiedChartView->setUpdatesEnabled( false );
 
-  applyBinaryData( *result );
+  if ( compressed )
+    applyCompressedData( data );
+  else
+    applyBinaryData( data );
   trimSeries();
   commitSeries();
   updateAxes();
@@ -1757,10 +1978,9 @@ void MonitorTab::applyBinaryData( const QByteArray &data )
   //   per non-empty metric: uint8_t metricId, uint32_t count,
   //                         count × { int64_t timestampMs, double value }  (16 bytes each)
   //
-  // Points are appended to in-memory buffers only.  The actual QLineSeries
-  // objects are updated in commitSeries() via a single replace() call,
-  // which emits exactly one signal per series instead of one per append +
-  // one per trim.
+  // Points are pushed into the in-memory rings only.  The QLineSeries
+  // objects are updated in commitSeries() with just the points that
+  // arrived or expired since the previous commit.
 
   static constexpr size_t kPointSize = sizeof( int64_t ) + sizeof( double );  // 16
 
@@ -1795,7 +2015,7 @@ void MonitorTab::applyBinaryData( const QByteArray &data )
 
       if ( valid )
       {
-        m_seriesMap[ kMetrics[ metricId ].key ].buffer.append(
+        m_seriesMap[ kMetrics[ metricId ].key ].buffer.push(
             QPointF( static_cast< qreal >( ts ), val ) );
         if ( ts > maxTs )
           maxTs = ts;
@@ -1808,50 +2028,173 @@ void MonitorTab::applyBinaryData( const QByteArray &data )
     m_lastTimestamp = maxTs + 1;
 }
 
+void MonitorTab::applyCompressedData( const QByteArray &data )
+{
+  // Delta-of-delta timestamps + XOR values, see MetricsCodec.hpp.  Decoded
+  // points go to the same in-memory buffers as applyBinaryData().
+  qint64 maxTs = m_lastTimestamp;
+
+  const bool ok = decodeMetricsCompressed(
+    reinterpret_cast< const uint8_t * >( data.constData() ), static_cast< size_t >( data.size() ),
+    [&]( uint8_t metricId, int64_t ts, double val )
+    {
+      if ( metricId >= METRIC_COUNT )
+        return;
+      auto it = m_seriesMap.find( kMetrics[ metricId ].key );
+      if ( it == m_seriesMap.end() )
+        return;
+      it->second.buffer.push( QPointF( static_cast< qreal >( ts ), val ) );
+      if ( ts > maxTs )
+        maxTs = ts;
+    } );
+
+  if ( !ok )
+    qWarning() << "[MonitorTab] Malformed compressed monitor data";
+
+  if ( maxTs > m_lastTimestamp )
+    m_lastTimestamp = maxTs + 1;
+}
+
 void MonitorTab::trimSeries()
 {
   const qint64 now = QDateTime::currentMSecsSinceEpoch();
   const qreal cutoff = static_cast< qreal >( now - static_cast< qint64 >( m_windowSeconds ) * 1000 );
 
-  // Trim leading stale points from in-memory buffers only.
-  // The QLineSeries objects are updated in commitSeries().
+  // Drop leading stale points from the rings; this only advances their
+  // heads.  The QLineSeries objects are updated in commitSeries().
   for ( auto &[key, info] : m_seriesMap )
+    info.buffer.trimBefore( cutoff );
+}
+
+void MonitorTab::commitSeries()
+{
+  // Feed the points that arrived since the previous commit through each
+  // metric's decimator and bring its QLineSeries (and unified shadow) up
+  // to date with what changed: points of expired buckets go at the front,
+  // the redrawn open bucket at the back, new buckets are appended.  The
+  // cost follows the number of new points, not the window; the shadow
+  // series gets only the appended points normalised.
+
+  QList< QPointF > added;
+  for ( int i = 0; i < METRIC_COUNT; ++i )
   {
-    auto &buf = info.buffer;
-    int stale = 0;
-    while ( stale < buf.size() && buf[ stale ].x() < cutoff )
-      ++stale;
-    if ( stale > 0 )
-      buf.remove( 0, stale );
+    auto &info = m_seriesMap[ kMetrics[ i ].key ];
+    const auto ringDelta = info.buffer.commit();
+    for ( size_t j = ringDelta.appendFrom; j < info.buffer.size(); ++j )
+      info.lod.push( info.buffer[ j ] );
+    info.lod.trimBefore( info.buffer.empty() ? std::numeric_limits< double >::infinity()
+                                             : info.buffer.front().x() );
+
+    const auto &drawn = info.lod.points();
+    const auto delta = info.lod.commit();
+    if ( delta.empty( drawn.size() ) )
+      continue;
+
+    QLineSeries *uni = nullptr;
+    QVariant uv = info.series->property( "_uniSeries" );
+    if ( uv.isValid() )
+      uni = qobject_cast< QLineSeries * >( uv.value< QObject * >() );
+
+    for ( QLineSeries *series : { info.series, uni } )
+    {
+      if ( !series )
+        continue;
+      if ( delta.removeBack > 0 )
+        series->removePoints( series->count() - static_cast< int >( delta.removeBack ),
+                              static_cast< int >( delta.removeBack ) );
+      if ( delta.removeFront > 0 )
+        series->removePoints( 0, static_cast< int >( delta.removeFront ) );
+    }
+
+    if ( delta.appendFrom >= drawn.size() )
+      continue;
+
+    added.clear();
+    added.reserve( static_cast< qsizetype >( drawn.size() - delta.appendFrom ) );
+    for ( size_t j = delta.appendFrom; j < drawn.size(); ++j )
+      added.append( drawn[ j ] );
+    info.series->append( added );
+
+    if ( uni )
+    {
+      const double scale = metricToNormalisedScale( kMetrics[ i ].group );
+      for ( auto &pt : added )
+        pt.setY( pt.y() * scale );
+      uni->append( added );
+    }
   }
 }
 
-void MonitorTab::commitSeries()
+bool MonitorTab::zoomedView() const
+{
+  // Zoom applies to the unified chart; the per-group page always shows the window
+  return m_zoomed && m_unifiedXAxis && m_chartStack && m_chartStack->currentIndex() == 1;
+}
+
+double MonitorTab::lodBucketMs() const
 {
-  // Push in-memory buffers into QLineSeries via a single replace() call.
-  // This emits exactly ONE pointsReplaced signal per series, instead of
-  // separate pointsAdded + pointsRemoved signals from append() + removePoints().
+  // Both pages span the stack's width; the plot area is a little narrower,
+  // which only makes the result slightly finer than one pixel
+  const int widthPx = std::max( m_chartStack ? m_chartStack->width() : 0, 300 );
+
+  double spanMs = static_cast< double >( m_windowSeconds ) * 1000.0;
+  if ( zoomedView() )
+    spanMs = static_cast< double >( m_unifiedXAxis->min().msecsTo( m_unifiedXAxis->max() ) );
+
+  return std::max( spanMs / widthPx, 1.0 );
+}
+
+void MonitorTab::rebuildLod()
+{
+  const double bucketMs = lodBucketMs();
+
+  // Zoomed: decimate just the visible range (plus a neighbour either side
+  // so the lines run to the edges) at the zoom's resolution
+  double from = -std::numeric_limits< double >::infinity();
+  double to = std::numeric_limits< double >::infinity();
+  const bool zoomed = zoomedView();
+  if ( zoomed )
+  {
+    from = static_cast< double >( m_unifiedXAxis->min().toMSecsSinceEpoch() );
+    to = static_cast< double >( m_unifiedXAxis->max().toMSecsSinceEpoch() );
+  }
 
+  QList< QPointF > pts;
   for ( int i = 0; i < METRIC_COUNT; ++i )
   {
     auto &info = m_seriesMap[ kMetrics[ i ].key ];
-    info.series->replace( info.buffer );
+    auto &buf = info.buffer;
+    ( void ) buf.commit();  // everything is redrawn below
+
+    size_t begin = 0, end = buf.size();
+    if ( zoomed )
+    {
+      begin = buf.lowerBound( from );
+      begin = begin > 0 ? begin - 1 : 0;
+      end = std::min( buf.lowerBound( to ) + 1, buf.size() );
+    }
+
+    info.lod.reset( bucketMs );
+    for ( size_t j = begin; j < end; ++j )
+      info.lod.push( buf[ j ] );
+    ( void ) info.lod.commit();
+
+    const auto &drawn = info.lod.points();
+    pts.clear();
+    pts.reserve( static_cast< qsizetype >( drawn.size() ) );
+    for ( const auto &pt : drawn )
+      pts.append( pt );
+    info.series->replace( pts );
 
-    // Update unified shadow series if active — build normalised list on the fly
     QVariant uv = info.series->property( "_uniSeries" );
     if ( uv.isValid() )
-    {
-      auto *uni = qobject_cast< QLineSeries * >( uv.value< QObject * >() );
-      if ( uni )
+      if ( auto *uni = qobject_cast< QLineSeries * >( uv.value< QObject * >() ) )
       {
         const double scale = metricToNormalisedScale( kMetrics[ i ].group );
-        QList< QPointF > scaled;
-        scaled.reserve( info.buffer.size() );
-        for ( const auto &pt : info.buffer )
-          scaled.append( QPointF( pt.x(), pt.y() * scale ) );
-        uni->replace( scaled );
+        for ( auto &pt : pts )
+          pt.setY( pt.y() * scale );
+        uni->replace( pts );
       }
-    }
   }
 }
 
@@ -1929,6 +2272,7 @@ void MonitorTab::saveCheckboxStates()
 
   // Save unified mode checkbox state
   settings.setValue( "UnifiedMode", m_unifiedCheckBox->isChecked() );
+  settings.setValue( "AcceleratedCharts", m_acceleratedCheckBox->isChecked() );
 
   settings.endGroup();
   settings.sync();
@@ -1953,6 +2297,9 @@ void MonitorTab::loadCheckboxStates()
   const bool unifiedMode = settings.value( "UnifiedMode", false ).toBool();
   m_unifiedCheckBox->setChecked( unifiedMode );
 
+  // Accelerated rendering defaults to on wherever OpenGL works
+  m_acceleratedCheckBox->setChecked( settings.value( "AcceleratedCharts", true ).toBool() );
+
   settings.endGroup();
 }
 
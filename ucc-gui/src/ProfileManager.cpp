@@ -110,22 +110,18 @@ void ProfileManager::updateProfiles()
   if ( m_defaultProfilesData.isEmpty() )
   {
     try {
-      if ( auto json = m_client->getDefaultProfilesJSON() )
+      if ( auto profiles = m_client->getDefaultProfiles() )
       {
-        QJsonDocument doc = QJsonDocument::fromJson( QString::fromStdString( *json ).toUtf8() );
-        if ( doc.isArray() )
+        m_defaultProfilesData = *profiles;
+        m_defaultProfiles.clear();
+        for ( const auto &profile : m_defaultProfilesData )
         {
-          m_defaultProfilesData = doc.array();
-          m_defaultProfiles.clear();
-          for ( const auto &profile : m_defaultProfilesData )
+          if ( profile.isObject() )
           {
-            if ( profile.isObject() )
+            QString name = profile.toObject()["name"].toString();
+            if ( !name.isEmpty() )
             {
-              QString name = profile.toObject()["name"].toString();
-              if ( !name.isEmpty() )
-              {
-                m_defaultProfiles.append( name );
-              }
+              m_defaultProfiles.append( name );
             }
           }
         }
@@ -173,19 +169,14 @@ void ProfileManager::updateProfiles()
   {
     try
     {
-      if ( auto json = m_client->getActiveProfileJSON() )
+      if ( auto obj = m_client->getActiveProfile() )
       {
-        QJsonDocument doc = QJsonDocument::fromJson( QString::fromStdString( *json ).toUtf8() );
-        if ( doc.isObject() )
-        {
-          QJsonObject obj = doc.object();
-          QString id = obj["id"].toString();
+        QString id = ( *obj )["id"].toString();
 
-          if ( !id.isEmpty() )
-          {
-            m_activeProfileId = id;
-            emit activeProfileChanged();
-          }
+        if ( !id.isEmpty() )
+        {
+          m_activeProfileId = id;
+          emit activeProfileChanged();
         }
       }
     } catch ( const std::exception &e ) {
@@ -198,29 +189,25 @@ void ProfileManager::updateProfiles()
   // client (e.g. the tray applet) changed them at runtime.
   try
   {
-    if ( auto json = m_client->getActiveProfileJSON() )
+    if ( auto active = m_client->getActiveProfile() )
     {
-      QJsonDocument doc = QJsonDocument::fromJson( QString::fromStdString( *json ).toUtf8() );
-      if ( doc.isObject() )
-      {
-        QJsonObject obj = doc.object();
-
-        // Keyboard profile ID
-        QString kbId = obj[ "selectedKeyboardProfile" ].toString();
-        if ( !kbId.isEmpty() )
-          m_activeKeyboardProfileId = kbId;
-
-        // Fan profile ID
-        auto fanObj = obj[ "fan" ].toObject();
-        QString fpId = fanObj[ "fanProfile" ].toString();
-        if ( !fpId.isEmpty() )
-          m_activeFanProfileId = fpId;
-
-        // GPU profile ID
-        QString gpId = obj[ "gpuProfileId" ].toString();
-        if ( !gpId.isEmpty() )
-          m_activeGpuProfileId = gpId;
-      }
+      const QJsonObject &obj = *active;
+
+      // Keyboard profile ID
+      QString kbId = obj[ "selectedKeyboardProfile" ].toString();
+      if ( !kbId.isEmpty() )
+        m_activeKeyboardProfileId = kbId;
+
+      // Fan profile ID
+      auto fanObj = obj[ "fan" ].toObject();
+      QString fpId = fanObj[ "fanProfile" ].toString();
+      if ( !fpId.isEmpty() )
+        m_activeFanProfileId = fpId;
+
+      // GPU profile ID
+      QString gpId = obj[ "gpuProfileId" ].toString();
+      if ( !gpId.isEmpty() )
+        m_activeGpuProfileId = gpId;
     }
   }
   catch ( ... ) {}
@@ -286,14 +273,14 @@ void ProfileManager::setActiveProfile( const QString &profileId )
 {
   // Check if this is a custom profile
   bool isCustom = false;
-  QString profileData;
+  QJsonObject profileData;
   for ( const auto &profile : m_customProfilesData )
   {
     QJsonObject obj = profile.toObject();
     if ( obj.value( "id" ).toString() == profileId )
     {
       isCustom = true;
-      profileData = QJsonDocument( obj ).toJson( QJsonDocument::Compact );
+      profileData = obj;
       break;
     }
   }
@@ -302,7 +289,7 @@ void ProfileManager::setActiveProfile( const QString &profileId )
   if ( isCustom && !profileData.isEmpty() )
   {
     try {
-      success = m_client->applyProfile( profileData.toStdString() );
+      success = m_client->applyProfile( profileData );
     } catch ( const std::exception &e ) {
       qWarning() << "Failed to apply custom profile:" << e.what();
     }
@@ -336,7 +323,8 @@ void ProfileManager::setActiveProfile( const QString &profileId )
 // Save / delete / create profiles
 // ---------------------------------------------------------------------------
 
-void ProfileManager::saveProfile( const QString &profileJSON )
+void ProfileManager::saveProfile( const QString &profileJSON,
+                                  const std::map< QString, QString > &stateMapUpdates )
 {
   QJsonDocument doc = QJsonDocument::fromJson( profileJSON.toUtf8() );
   if ( !doc.isObject() )
@@ -386,11 +374,37 @@ void ProfileManager::saveProfile( const QString &profileJSON )
     }
   }
 
+  for ( const auto &[state, stateProfileId] : stateMapUpdates )
+    m_stateMap[state] = stateProfileId;
   saveCustomProfilesToSettings();
 
   if ( m_connected )
   {
-    bool success = m_client->saveCustomProfile( profileJSON.toStdString() );
+    // Profile and state map in one call, so the daemon authorizes and
+    // applies once
+    std::optional< bool > applied;
+    std::map< std::string, std::string > stdEntries;
+    if ( !stateMapUpdates.empty() )
+    {
+      QJsonObject stateMap;
+      for ( const auto &[state, stateProfileId] : stateMapUpdates )
+      {
+        stateMap[state] = stateProfileId;
+        stdEntries[state.toStdString()] = stateProfileId.toStdString();
+      }
+      applied = m_client->applyTransaction( QJsonArray{
+        QJsonObject{ { "op", "saveCustomProfile" }, { "profile", profileObj } },
+        QJsonObject{ { "op", "setStateMap" }, { "stateMap", stateMap } } } );
+    }
+
+    bool success = applied.value_or( false );
+    if ( !applied )
+    {
+      // nothing to batch, or a daemon without ApplyTransaction
+      success = m_client->saveCustomProfile( profileObj );
+      if ( !stdEntries.empty() )
+        m_client->setBatchStateMap( stdEntries );
+    }
     if ( !success )
       qWarning() << "Failed to save profile to daemon:" << profileName;
     else
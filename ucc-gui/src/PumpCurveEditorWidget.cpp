@@ -2,6 +2,7 @@
 #include <QPainter>
 #include <QPalette>
 #include <QMouseEvent>
+#include <QResizeEvent>
 #include <algorithm>
 #include <ranges>
 
@@ -93,6 +94,17 @@ QRectF PumpCurveEditorWidget::pointRect(const Point& pt) const {
     return QRectF(c.x() - 8.0, c.y() - 8.0, 16.0, 16.0);
 }
 
+QRect PumpCurveEditorWidget::curveBounds() const {
+    // The step curve runs across the whole plot; add the points' labels
+    const int left = 80, right = 20, top = 28, bottom = 68;
+    QRectF r(left, top, width() - left - right, height() - top - bottom);
+    for (const auto &pt : m_points) {
+        const QPointF wp = toWidget(pt);
+        r = r.united(pointRect(pt)).united(QRectF(wp.x() - 50, wp.y() + 6, 42, 16));
+    }
+    return r.toAlignedRect().adjusted(-2, -2, 2, 2);  // curve pen
+}
+
 void PumpCurveEditorWidget::enforceOrdering() {
     // Ensure temperatures are in ascending order with minimum 1°C gap
     for (int i = 1; i < m_points.size(); ++i) {
@@ -108,25 +120,38 @@ void PumpCurveEditorWidget::enforceOrdering() {
     }
 }
 
-void PumpCurveEditorWidget::paintEvent(QPaintEvent*) {
-    QPainter p(this);
+void PumpCurveEditorWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    m_backgroundDirty = true;
+}
+
+void PumpCurveEditorWidget::changeEvent(QEvent *event) {
+    QWidget::changeEvent(event);
+    switch (event->type()) {
+        case QEvent::PaletteChange:
+        case QEvent::FontChange:
+        case QEvent::StyleChange:
+            m_backgroundDirty = true;
+            update();
+            break;
+        default:
+            break;
+    }
+}
+
+void PumpCurveEditorWidget::renderBackground() {
+    const qreal dpr = devicePixelRatioF();
+    m_background = QPixmap(size() * dpr);
+    m_background.setDevicePixelRatio(dpr);
+    m_backgroundDirty = false;
+
+    QPainter p(&m_background);
     p.setRenderHint(QPainter::Antialiasing);
 
     const QPalette &pal = palette();
     const QColor bgColor       = pal.color(QPalette::Base);
     const QColor gridColor     = pal.color(QPalette::Mid);
     const QColor labelColor    = pal.color(QPalette::Text);
-    const QColor brightText    = pal.color(QPalette::BrightText);
-    const QColor disabledFill  = pal.color(QPalette::Disabled, QPalette::Mid);
-    const QColor disabledBorder= pal.color(QPalette::Disabled, QPalette::Light);
-
-    // Data-visualization colors: warm tones that won't collide with
-    // typical blue-ish GUI highlight/link palette roles.
-    const bool darkTheme = bgColor.lightnessF() < 0.5;
-    const QColor curveColor    = darkTheme ? QColor( 0x3f, 0xa9, 0xf5 ) : QColor( 0x19, 0x76, 0xd2 );
-    const QColor accentColor   = darkTheme ? QColor( 0xff, 0x57, 0x22 ) : QColor( 0xe6, 0x4a, 0x19 );
-    const QColor selectedFill  = darkTheme ? QColor( 0xff, 0xa7, 0x26 ) : QColor( 0xfb, 0x8c, 0x00 );
-    const QColor selectedBorder= darkTheme ? QColor( 0xff, 0x6f, 0x00 ) : QColor( 0xe6, 0x51, 0x00 );
 
     p.fillRect(rect(), bgColor);
 
@@ -204,6 +229,37 @@ void PumpCurveEditorWidget::paintEvent(QPaintEvent*) {
     QRectF borderRect(qRound(plotRect.left()) + 0.5, qRound(plotRect.top()) + 0.5,
                       qRound(plotRect.width()) - 1.0, qRound(plotRect.height()) - 1.0);
     p.drawRect(borderRect);
+}
+
+void PumpCurveEditorWidget::paintEvent(QPaintEvent*) {
+    if (m_backgroundDirty || m_background.size() != size() * devicePixelRatioF())
+        renderBackground();
+
+    QPainter p(this);
+    p.drawPixmap(0, 0, m_background);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    const QPalette &pal = palette();
+    const QColor bgColor       = pal.color(QPalette::Base);
+    const QColor labelColor    = pal.color(QPalette::Text);
+    const QColor brightText    = pal.color(QPalette::BrightText);
+    const QColor disabledFill  = pal.color(QPalette::Disabled, QPalette::Mid);
+    const QColor disabledBorder= pal.color(QPalette::Disabled, QPalette::Light);
+
+    // Data-visualization colors: warm tones that won't collide with
+    // typical blue-ish GUI highlight/link palette roles.
+    const bool darkTheme = bgColor.lightnessF() < 0.5;
+    const QColor curveColor    = darkTheme ? QColor( 0x3f, 0xa9, 0xf5 ) : QColor( 0x19, 0x76, 0xd2 );
+    const QColor accentColor   = darkTheme ? QColor( 0xff, 0x57, 0x22 ) : QColor( 0xe6, 0x4a, 0x19 );
+    const QColor selectedFill  = darkTheme ? QColor( 0xff, 0xa7, 0x26 ) : QColor( 0xfb, 0x8c, 0x00 );
+    const QColor selectedBorder= darkTheme ? QColor( 0xff, 0x6f, 0x00 ) : QColor( 0xe6, 0x51, 0x00 );
+
+    const int left = 80, right = 20, top = 28, bottom = 68;
+    QRectF plotRect(left, top, width() - left - right, height() - top - bottom);
+
+    QFont tickFont = font();
+    tickFont.setPointSize(9);
+    tickFont.setWeight(QFont::Normal);
 
     // Draw step curve: Off from left edge to first point, then steps
     p.setPen(QPen(curveColor, 3));
@@ -355,6 +411,7 @@ void PumpCurveEditorWidget::mouseMoveEvent(QMouseEvent* e) {
     if (!m_editable) return;
 
     if (m_rubberBandActive) {
+        const QRect oldBand = m_rubberBandRect;
         m_rubberBandRect = QRect(m_rubberBandOrigin, e->pos()).normalized();
         if (!m_ctrlHeld)
             m_selectedIndices.clear();
@@ -363,12 +420,14 @@ void PumpCurveEditorWidget::mouseMoveEvent(QMouseEvent* e) {
             if (m_rubberBandRect.contains(wp.toPoint()))
                 m_selectedIndices.insert(i);
         }
-        update();
+        update(oldBand.united(m_rubberBandRect).adjusted(-1, -1, 1, 1).united(curveBounds()));
         return;
     }
 
     if (m_draggedIndex < 0) return;
 
+    const QRect oldBounds = curveBounds();
+
     // Drag horizontally (temperature only; levels are fixed 1..4)
     const int left = 110, right = 20;
     double plotW = width() - left - right;
@@ -382,7 +441,7 @@ void PumpCurveEditorWidget::mouseMoveEvent(QMouseEvent* e) {
     }
 
     enforceOrdering();
-    update();
+    update(oldBounds.united(curveBounds()));
     emit pointsChanged(m_points);
 }
 
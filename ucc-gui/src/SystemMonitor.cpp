@@ -28,9 +28,12 @@ SystemMonitor::SystemMonitor( QObject *parent )
   , m_client( std::make_unique< UccdClient >( this ) )
   , m_updateTimer( new QTimer( this ) )
 {
-  // Update metrics every 500ms when active
+  // While active, the daemon's MetricsSample push drives the updates; the
+  // timer polls daemons without it and is a safety net otherwise
   connect( m_updateTimer, &QTimer::timeout, this, &SystemMonitor::updateMetrics );
-  m_updateTimer->setInterval( 500 );
+  m_updateTimer->setInterval( POLL_INTERVAL_MS );
+  connect( m_client.get(), &UccdClient::metricsSample, this, &SystemMonitor::onMetricsSample );
+  connect( m_client.get(), &UccdClient::propertiesChanged, this, &SystemMonitor::applyProperties );
 
   // Load charging capabilities (these don't change at runtime)
   initializeChargingState();
@@ -52,12 +55,102 @@ SystemMonitor::SystemMonitor( QObject *parent )
 SystemMonitor::~SystemMonitor() = default;
 
 void SystemMonitor::updateMetrics()
+{
+  // All reads are asynchronous so a busy daemon never blocks the UI thread.
+  // While replies of the previous tick are outstanding the tick is skipped
+  // instead of queueing more calls behind them.
+  if ( m_pendingReads > 0 )
+    return;
+  m_pendingReads = m_propertiesPushed ? 1 : 4;
+
+  m_client->getLiveSnapshotAsync( this, [this]( std::optional< LiveSnapshot > snapshot ) {
+    --m_pendingReads;
+    applySnapshot( snapshot.value_or( LiveSnapshot{} ) );
+  } );
+
+  // Brightness, webcam and Fn lock arrive through applyProperties() where
+  // the daemon has them as properties
+  if ( m_propertiesPushed )
+    return;
+
+  m_client->getDisplayBrightnessAsync( this, [this]( std::optional< int > brightness ) {
+    --m_pendingReads;
+    if ( brightness && m_displayBrightness != *brightness )
+    {
+      m_displayBrightness = *brightness;
+      emit displayBrightnessChanged();
+    }
+  } );
+
+  m_client->getWebcamEnabledAsync( this, [this]( std::optional< bool > enabled ) {
+    --m_pendingReads;
+    if ( enabled && m_webcamEnabled != *enabled )
+    {
+      m_webcamEnabled = *enabled;
+      emit webcamEnabledChanged();
+    }
+  } );
+
+  m_client->getFnLockAsync( this, [this]( std::optional< bool > fnLock ) {
+    --m_pendingReads;
+    if ( fnLock && m_fnLock != *fnLock )
+    {
+      m_fnLock = *fnLock;
+      emit fnLockChanged();
+    }
+  } );
+}
+
+void SystemMonitor::onMetricsSample( qint64 timestampMs, const QList< double > &values )
+{
+  Q_UNUSED( timestampMs )
+  Q_UNUSED( values )
+  if ( !m_monitoringActive )
+    return;
+
+  // Read the snapshot the sample announced and push the fallback poll back
+  updateMetrics();
+  m_updateTimer->setInterval( FALLBACK_POLL_INTERVAL_MS );
+  m_updateTimer->start();
+}
+
+void SystemMonitor::applyProperties( const QVariantMap &props )
+{
+  if ( auto it = props.constFind( QStringLiteral( "DisplayBrightness" ) ); it != props.constEnd() )
+  {
+    if ( const int brightness = it->toInt(); m_displayBrightness != brightness )
+    {
+      m_displayBrightness = brightness;
+      emit displayBrightnessChanged();
+    }
+  }
+
+  if ( auto it = props.constFind( QStringLiteral( "WebcamSWStatus" ) ); it != props.constEnd() )
+  {
+    if ( const bool enabled = it->toBool(); m_webcamEnabled != enabled )
+    {
+      m_webcamEnabled = enabled;
+      emit webcamEnabledChanged();
+    }
+  }
+
+  if ( auto it = props.constFind( QStringLiteral( "FnLockStatus" ) ); it != props.constEnd() )
+  {
+    if ( const bool fnLock = it->toBool(); m_fnLock != fnLock )
+    {
+      m_fnLock = fnLock;
+      emit fnLockChanged();
+    }
+  }
+}
+
+void SystemMonitor::applySnapshot( const LiveSnapshot &s )
 {
   // Get CPU Temperature
   {
     QString cpuTemp = "--";
 
-    if ( auto temp = m_client->getCpuTemperature() )
+    if ( auto temp = s.cpuTemp )
     {
       cpuTemp = QString::number( *temp ) + "°C";
     }
@@ -73,7 +166,7 @@ void SystemMonitor::updateMetrics()
   {
     QString cpuFreq = "--";
 
-    if ( auto freq = m_client->getCpuFrequency() )
+    if ( auto freq = s.cpuFrequencyMHz )
     {
       cpuFreq = QString::number( *freq ) + " MHz";
     }
@@ -89,7 +182,7 @@ void SystemMonitor::updateMetrics()
   {
     QString cpuPow = "--";
 
-    if ( auto power = m_client->getCpuPower() )
+    if ( auto power = s.cpuPowerW )
     {
       cpuPow = QString::number( *power, 'f', 1 ) + " W";
     }
@@ -105,7 +198,7 @@ void SystemMonitor::updateMetrics()
   {
     QString gpuTemp = "--";
 
-    if ( auto temp = m_client->getGpuTemperature() )
+    if ( auto temp = s.gpuTemp )
     {
       gpuTemp = QString::number( *temp ) + "°C";
     }
@@ -120,7 +213,7 @@ void SystemMonitor::updateMetrics()
   {
     QString gpuFreq = "--";
 
-    if ( auto freq = m_client->getGpuFrequency() )
+    if ( auto freq = s.gpuFrequencyMHz )
     {
       gpuFreq = QString::number( *freq ) + " MHz";
     }
@@ -136,7 +229,7 @@ void SystemMonitor::updateMetrics()
   {
     QString gpuPow = "--";
 
-    if ( auto power = m_client->getGpuPower() )
+    if ( auto power = s.gpuPowerW )
     {
       gpuPow = QString::number( *power, 'f', 1 ) + " W";
     }
@@ -151,7 +244,7 @@ void SystemMonitor::updateMetrics()
   {
     QString iGpuFreq = "--";
 
-    if ( auto freq = m_client->getIGpuFrequency(); freq && *freq > 0 )
+    if ( auto freq = s.iGpuFrequencyMHz; freq && *freq > 0 )
       iGpuFreq = QString::number( *freq ) + " MHz";
 
     if ( m_iGpuFrequency != iGpuFreq )
@@ -165,7 +258,7 @@ void SystemMonitor::updateMetrics()
   {
     QString iGpuPow = "--";
 
-    if ( auto power = m_client->getIGpuPower(); power && *power > 0.0 )
+    if ( auto power = s.iGpuPowerW; power && *power > 0.0 )
       iGpuPow = QString::number( *power, 'f', 1 ) + " W";
 
     if ( m_iGpuPower != iGpuPow )
@@ -179,7 +272,7 @@ void SystemMonitor::updateMetrics()
   {
     QString iGpuTmp = "--";
 
-    if ( auto temp = m_client->getIGpuTemperature(); temp && *temp > 0 )
+    if ( auto temp = s.iGpuTemp; temp && *temp > 0 )
       iGpuTmp = QString::number( *temp ) + "°C";
 
     if ( m_iGpuTemp != iGpuTmp )
@@ -193,7 +286,7 @@ void SystemMonitor::updateMetrics()
   {
     QString fanSpd = "--";
 
-    if ( auto pct = m_client->getFanSpeedPercent() )
+    if ( auto pct = s.cpuFanPercent )
     {
       fanSpd = QString::number( *pct ) + " %";
     }
@@ -209,7 +302,7 @@ void SystemMonitor::updateMetrics()
   {
     QString fanSpd = "--";
 
-    if ( auto pct = m_client->getGpuFanSpeedPercent() )
+    if ( auto pct = s.gpuFanPercent )
     {
       fanSpd = QString::number( *pct ) + " %";
     }
@@ -223,34 +316,34 @@ void SystemMonitor::updateMetrics()
   // Get dGPU extended metrics (NVIDIA-only; getters return nullopt when unavailable)
   {
     int val = -1;
-    if ( auto v = m_client->getDGpuComputeUtilPct() ) val = *v;
+    if ( auto v = s.dGpuComputeUtilPct ) val = *v;
     if ( m_dGpuComputeUtil != val ) { m_dGpuComputeUtil = val; emit dGpuComputeUtilChanged(); }
   }
   {
     int val = -1;
-    if ( auto v = m_client->getDGpuMemoryUtilPct() ) val = *v;
+    if ( auto v = s.dGpuMemoryUtilPct ) val = *v;
     if ( m_dGpuMemoryUtil != val ) { m_dGpuMemoryUtil = val; emit dGpuMemoryUtilChanged(); }
   }
   {
     int val = -1;
-    if ( auto v = m_client->getDGpuCurrentPstate() ) val = *v;
+    if ( auto v = s.dGpuCurrentPstate ) val = *v;
     if ( m_dGpuPstate != val ) { m_dGpuPstate = val; emit dGpuPstateChanged(); }
   }
   {
     int val = -999;
-    if ( auto v = m_client->getDGpuGrClockOffsetMHz() ) val = *v;
+    if ( auto v = s.dGpuGrClockOffsetMHz ) val = *v;
     if ( m_dGpuGrClockOffset != val ) { m_dGpuGrClockOffset = val; emit dGpuGrClockOffsetChanged(); }
   }
   {
     int val = -999;
-    if ( auto v = m_client->getDGpuMemClockOffsetMHz() ) val = *v;
+    if ( auto v = s.dGpuMemClockOffsetMHz ) val = *v;
     if ( m_dGpuMemClockOffset != val ) { m_dGpuMemClockOffset = val; emit dGpuMemClockOffsetChanged(); }
   }
 
   // Get water cooler fan speed (percentage) if available via uccd
   {
     QString wcFan = "--";
-    if ( auto pct = m_client->getWaterCoolerFanSpeed() )
+    if ( auto pct = s.waterCoolerFanSpeed )
     {
       wcFan = QString::number( *pct ) + " %";
     }
@@ -265,7 +358,7 @@ void SystemMonitor::updateMetrics()
   // Get water cooler pump level/voltage if available via uccd
   {
     QString wcPump = "--";
-    if ( auto level = m_client->getWaterCoolerPumpLevel() )
+    if ( auto level = s.waterCoolerPumpLevel )
     {
       wcPump = *level == static_cast< int >( ucc::PumpVoltage::V7 )  ? "Low" :
                *level == static_cast< int >( ucc::PumpVoltage::V8 )  ? "Med" :
@@ -280,38 +373,6 @@ void SystemMonitor::updateMetrics()
       emit waterCoolerPumpLevelChanged();
     }
   }
-
-  // Get display brightness
-
-  if ( auto brightness = m_client->getDisplayBrightness() )
-  {
-
-    if ( m_displayBrightness != *brightness )
-    {
-      m_displayBrightness = *brightness;
-      emit displayBrightnessChanged();
-    }
-  }
-
-  // Get webcam status
-  if ( auto enabled = m_client->getWebcamEnabled() )
-  {
-    if ( m_webcamEnabled != *enabled )
-    {
-      m_webcamEnabled = *enabled;
-      emit webcamEnabledChanged();
-    }
-  }
-
-  // Get Fn lock status
-  if ( auto fnLock = m_client->getFnLock() )
-  {
-    if ( m_fnLock != *fnLock )
-    {
-      m_fnLock = *fnLock;
-      emit fnLockChanged();
-    }
-  }
 }
 
 void SystemMonitor::setDisplayBrightness( int brightness )
@@ -520,16 +581,26 @@ void SystemMonitor::setMonitoringActive( bool active )
       m_waterCoolerFanSpeed = "";
       m_waterCoolerPumpLevel = "";
 
-      // Start timer first - this gives uccd time to collect initial sensor data
-      // The first update will happen after 500ms
+      // Slow-changing state once; later changes are pushed as properties
+      if ( auto props = m_client->getProperties() )
+      {
+        m_propertiesPushed = true;
+        applyProperties( *props );
+      }
+
+      // Updates follow the daemon's samples; without them, poll.  Either
+      // way the first update gives uccd time to collect sensor data.
+      const bool pushed = m_client->setMetricsSamplesEnabled( true );
+      m_updateTimer->setInterval( pushed ? FALLBACK_POLL_INTERVAL_MS : POLL_INTERVAL_MS );
       m_updateTimer->start();
-      qDebug() << "[SystemMonitor] Timer started, first update in 500ms. Timer active:" << m_updateTimer->isActive();
+      qDebug() << "[SystemMonitor] Monitoring started," << ( pushed ? "following MetricsSample" : "polling" );
     }
     else
     {
       // Stop monitoring
       qDebug() << "[SystemMonitor] Stopping monitoring";
       m_updateTimer->stop();
+      m_client->setMetricsSamplesEnabled( false );
     }
   }
 }
@@ -17,6 +17,9 @@ PlasmoidItem {
 
     TrayBackend {
         id: trayBackend
+        // Popup-only readings are fetched and notified only while expanded;
+        // on the desktop the full representation stays on screen
+        popupExpanded: main.expanded || Plasmoid.formFactor === PlasmaCore.Types.Planar
     }
 
     switchWidth: Kirigami.Units.gridUnit * 20
@@ -53,6 +56,9 @@ PlasmoidItem {
         hoverEnabled: true
         acceptedButtons: Qt.LeftButton
 
+        // The tooltip temperatures are kept live only while it can show
+        onContainsMouseChanged: trayBackend.panelHovered = containsMouse
+
         onPressed: mouse => {
             if (mouse.button === Qt.LeftButton) {
                 wasExpanded = main.expanded
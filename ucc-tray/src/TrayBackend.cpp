@@ -17,8 +17,43 @@
 #include <QDir>
 #include <QFile>
 #include <QDebug>
+#include <QDateTime>
 
 #include <algorithm>
+#include <cmath>
+#include <optional>
+#include <type_traits>
+
+namespace
+{
+
+// Indices into MetricsSample values (uccd's MetricId order)
+enum SampleIndex : int
+{
+  SampleCpuTemp,
+  SampleCpuFanDuty,
+  SampleCpuPower,
+  SampleCpuFrequency,
+  SampleGpuTemp,
+  SampleGpuFanDuty,
+  SampleGpuPower,
+  SampleGpuFrequency,
+  SampleGpuVramFrequency,
+  SampleGpuCoreVoltage,
+  SampleCount
+};
+
+// Samples older than this no longer replace the corresponding polls
+constexpr qint64 SAMPLE_STALE_MS = 3000;
+
+// Property groups with their own NOTIFY signal
+enum MetricSet : int
+{
+  PanelMetrics = 1 << 0,  // panel tooltip
+  PopupMetrics = 1 << 1   // dashboard tab
+};
+
+} // namespace
 
 // ---------------------------------------------------------------------------
 // Construction
@@ -28,12 +63,14 @@ TrayBackend::TrayBackend( QObject *parent )
   : QObject( parent )
   , m_client( std::make_unique< ucc::UccdClient >() )
 {
-  // Fast timer: temperatures, fan speeds (every 1.5 s)
+  // Fast timer: readings MetricsSample does not carry (every 1.5 s), only
+  // while the popup is open or while the daemon pushes nothing
   m_fastTimer = new QTimer( this );
   m_fastTimer->setInterval( 1500 );
   connect( m_fastTimer, &QTimer::timeout, this, &TrayBackend::pollMetrics );
 
-  // Slow timer: profiles, hw toggles (every 5 s)
+  // Slow timer: profiles, hw toggles (every 5 s), only for daemons that do
+  // not announce changes of these with PropertiesChanged
   m_slowTimer = new QTimer( this );
   m_slowTimer->setInterval( 5000 );
   connect( m_slowTimer, &QTimer::timeout, this, &TrayBackend::pollSlowState );
@@ -43,6 +80,10 @@ TrayBackend::TrayBackend( QObject *parent )
            this, &TrayBackend::onDaemonProfileChanged );
   connect( m_client.get(), &ucc::UccdClient::connectionStatusChanged,
            this, &TrayBackend::onConnectionStatusChanged );
+  connect( m_client.get(), &ucc::UccdClient::metricsSample,
+           this, &TrayBackend::onMetricsSample );
+  connect( m_client.get(), &ucc::UccdClient::propertiesChanged,
+           this, &TrayBackend::onDaemonPropertiesChanged );
 
   // Watch the shared settings file so we pick up changes from the GUI immediately
   m_settingsWatcher = new QFileSystemWatcher( this );
@@ -66,8 +107,8 @@ TrayBackend::TrayBackend( QObject *parent )
   pollMetrics();
   pollSlowState();
 
-  m_fastTimer->start();
-  m_slowTimer->start();
+  updateMetricsMode();
+  updateSlowTimer();
 }
 
 // ---------------------------------------------------------------------------
@@ -85,7 +126,33 @@ bool TrayBackend::deviceSupported() const
 }
 
 // ---------------------------------------------------------------------------
-// Monitoring getters
+// Popup state
+// ---------------------------------------------------------------------------
+
+bool TrayBackend::popupExpanded() const { return m_popupExpanded; }
+
+void TrayBackend::setPopupExpanded( bool expanded )
+{
+  if ( expanded == m_popupExpanded )
+    return;
+  m_popupExpanded = expanded;
+  emit popupExpandedChanged();
+
+  updateMetricsMode();
+  notifyMetrics();  // what changed while collapsed, before the fresh snapshot
+}
+
+bool TrayBackend::panelHovered() const { return m_panelHovered; }
+
+void TrayBackend::setPanelHovered( bool hovered )
+{
+  if ( hovered == m_panelHovered )
+    return;
+  m_panelHovered = hovered;
+  emit panelHoveredChanged();
+  updateMetricsMode();
+}
+
 // ---------------------------------------------------------------------------
 // System info getters
 // ---------------------------------------------------------------------------
@@ -437,143 +504,226 @@ void TrayBackend::refreshAll()
 
 void TrayBackend::pollMetrics()
 {
-  bool changed = false;
+  // Collapsed, only the panel set is on screen and MetricsSample carries it
+  const bool pushed = QDateTime::currentMSecsSinceEpoch() - m_lastMetricsSampleAt < SAMPLE_STALE_MS;
+  if ( !m_popupExpanded && pushed )
+  {
+    m_fastTimer->stop();
+    return;
+  }
 
-  auto update = [&]<typename F, typename O>( F &field, O optVal ) {
+  // Asynchronous so a busy daemon never blocks plasmashell; a tick whose
+  // predecessor is still outstanding is skipped
+  if ( m_snapshotPending )
+    return;
+  m_snapshotPending = true;
+  m_client->getLiveSnapshotAsync( this, [this]( std::optional< ucc::LiveSnapshot > snapshot ) {
+    m_snapshotPending = false;
+    if ( snapshot )
+      applySnapshot( *snapshot );
+  } );
+}
+
+void TrayBackend::applySnapshot( const ucc::LiveSnapshot &s )
+{
+  auto update = [this]<typename F, typename O>( F &field, O optVal, MetricSet set ) {
     if ( optVal )
     {
       auto val = static_cast< std::decay_t< F > >( *optVal );
       if ( field != val )
       {
         field = val;
-        changed = true;
+        m_dirtyMetrics |= set;
       }
     }
   };
 
-  update( m_cpuTemp,       m_client->getCpuTemperature() );
-  update( m_gpuTemp,       m_client->getGpuTemperature() );
-  update( m_cpuFreqMHz,    m_client->getCpuFrequency() );
-  update( m_gpuFreqMHz,    m_client->getGpuFrequency() );
-  update( m_cpuPowerW,     m_client->getCpuPower() );
-  update( m_gpuPowerW,     m_client->getGpuPower() );
-  update( m_cpuFanRPM,     m_client->getFanSpeedRPM() );
-  update( m_gpuFanRPM,     m_client->getGpuFanSpeedRPM() );
-  update( m_cpuFanPercent, m_client->getFanSpeedPercent() );
-  update( m_gpuFanPercent, m_client->getGpuFanSpeedPercent() );
+  // MetricsSample covers the pushed fields while the daemon keeps sending them
+  const bool pushed = QDateTime::currentMSecsSinceEpoch() - m_lastMetricsSampleAt < SAMPLE_STALE_MS;
+  if ( !pushed )
+  {
+    update( m_cpuTemp,       s.cpuTemp,         PanelMetrics );
+    update( m_gpuTemp,       s.gpuTemp,         PanelMetrics );
+    update( m_cpuFreqMHz,    s.cpuFrequencyMHz, PopupMetrics );
+    update( m_gpuFreqMHz,    s.gpuFrequencyMHz, PopupMetrics );
+    update( m_cpuPowerW,     s.cpuPowerW,       PopupMetrics );
+    update( m_gpuPowerW,     s.gpuPowerW,       PopupMetrics );
+    update( m_cpuFanPercent, s.cpuFanPercent,   PopupMetrics );
+    update( m_gpuFanPercent, s.gpuFanPercent,   PopupMetrics );
+  }
+  update( m_cpuFanRPM,     s.cpuFanRPM, PopupMetrics );
+  update( m_gpuFanRPM,     s.gpuFanRPM, PopupMetrics );
 
   // Extended NVIDIA dGPU metrics
-  update( m_gpuComputeUtilPct,   m_client->getDGpuComputeUtilPct() );
-  update( m_gpuMemoryUtilPct,    m_client->getDGpuMemoryUtilPct() );
-  update( m_gpuVramUsedMiB,      m_client->getDGpuVramUsedMiB() );
-  update( m_gpuVramTotalMiB,     m_client->getDGpuVramTotalMiB() );
+  update( m_gpuComputeUtilPct,   s.dGpuComputeUtilPct, PopupMetrics );
+  update( m_gpuMemoryUtilPct,    s.dGpuMemoryUtilPct,  PopupMetrics );
+  update( m_gpuVramUsedMiB,      s.dGpuVramUsedMiB,    PopupMetrics );
+  update( m_gpuVramTotalMiB,     s.dGpuVramTotalMiB,   PopupMetrics );
 
-  if ( auto v = m_client->getDGpuPerfLimitReason() )
+  const QString reason = s.dGpuPerfLimitReason ? QString::fromStdString( *s.dGpuPerfLimitReason ) : QString();
+  if ( m_gpuPerfLimitReason != reason )
   {
-    QString reason = QString::fromStdString( *v );
-    if ( m_gpuPerfLimitReason != reason )
-    {
-      m_gpuPerfLimitReason = reason;
-      changed = true;
-    }
+    m_gpuPerfLimitReason = reason;
+    m_dirtyMetrics |= PopupMetrics;
   }
-  else if ( !m_gpuPerfLimitReason.isEmpty() )
+
+  update( m_gpuEncoderUtilPct,    s.dGpuEncoderUtilPct,    PopupMetrics );
+  update( m_gpuDecoderUtilPct,    s.dGpuDecoderUtilPct,    PopupMetrics );
+  update( m_gpuCurrentPstate,     s.dGpuCurrentPstate,     PopupMetrics );
+  update( m_gpuGrClockOffsetMHz,  s.dGpuGrClockOffsetMHz,  PopupMetrics );
+  update( m_gpuMemClockOffsetMHz, s.dGpuMemClockOffsetMHz, PopupMetrics );
+  if ( !pushed )
   {
-    m_gpuPerfLimitReason.clear();
-    changed = true;
+    update( m_gpuVramFreqMHz,    s.dGpuVramFrequencyMHz, PopupMetrics );
+    update( m_gpuCoreVoltageMv,  s.dGpuCoreVoltageMv,    PopupMetrics );
   }
 
-  update( m_gpuEncoderUtilPct,   m_client->getDGpuEncoderUtilPct() );
-  update( m_gpuDecoderUtilPct,   m_client->getDGpuDecoderUtilPct() );
-  update( m_gpuCurrentPstate,    m_client->getDGpuCurrentPstate() );
-  update( m_gpuGrClockOffsetMHz,  m_client->getDGpuGrClockOffsetMHz() );
-  update( m_gpuMemClockOffsetMHz, m_client->getDGpuMemClockOffsetMHz() );
-  update( m_gpuVramFreqMHz,      m_client->getDGpuVramFrequencyMHz() );
-  update( m_gpuCoreVoltageMv,    m_client->getDGpuCoreVoltageMv() );
-
   if ( m_waterCoolerSupported )
   {
-    update( m_wcFanSpeed,  m_client->getWaterCoolerFanSpeed() );
-    update( m_wcPumpLevel, m_client->getWaterCoolerPumpLevel() );
+    update( m_wcFanSpeed,  s.waterCoolerFanSpeed,  PopupMetrics );
+    update( m_wcPumpLevel, s.waterCoolerPumpLevel, PopupMetrics );
   }
 
-  if ( changed )
-    emit metricsUpdated();
+  notifyMetrics();
+}
+
+void TrayBackend::onMetricsSample( qint64 timestampMs, const QList< double > &values )
+{
+  Q_UNUSED( timestampMs )
+  if ( values.size() < SampleCount )
+    return;
+
+  m_lastMetricsSampleAt = QDateTime::currentMSecsSinceEpoch();
+
+  auto update = [&]<typename F>( F &field, int index, MetricSet set ) {
+    const double v = values[ index ];
+    if ( std::isnan( v ) )
+      return;
+    F val;
+    if constexpr ( std::is_integral_v< F > )
+      val = static_cast< F >( std::lround( v ) );
+    else
+      val = v;
+    if ( field != val )
+    {
+      field = val;
+      m_dirtyMetrics |= set;
+    }
+  };
+
+  update( m_cpuTemp,          SampleCpuTemp,          PanelMetrics );
+  update( m_gpuTemp,          SampleGpuTemp,          PanelMetrics );
+  update( m_cpuFreqMHz,       SampleCpuFrequency,     PopupMetrics );
+  update( m_gpuFreqMHz,       SampleGpuFrequency,     PopupMetrics );
+  update( m_cpuPowerW,        SampleCpuPower,         PopupMetrics );
+  update( m_gpuPowerW,        SampleGpuPower,         PopupMetrics );
+  update( m_cpuFanPercent,    SampleCpuFanDuty,       PopupMetrics );
+  update( m_gpuFanPercent,    SampleGpuFanDuty,       PopupMetrics );
+  update( m_gpuVramFreqMHz,   SampleGpuVramFrequency, PopupMetrics );
+  update( m_gpuCoreVoltageMv, SampleGpuCoreVoltage,   PopupMetrics );
+
+  notifyMetrics();
+}
+
+void TrayBackend::notifyMetrics()
+{
+  // One notification per set and update; the popup set waits while
+  // collapsed so its bindings are not re-evaluated off screen
+  if ( m_dirtyMetrics & PanelMetrics )
+    emit panelMetricsChanged();
+  if ( m_popupExpanded && ( m_dirtyMetrics & PopupMetrics ) )
+    emit popupMetricsChanged();
+  m_dirtyMetrics = m_popupExpanded ? 0 : ( m_dirtyMetrics & PopupMetrics );
+}
+
+void TrayBackend::updateMetricsMode()
+{
+  // Idle in the panel nothing shows a reading, so the daemon pushes nothing
+  // and no timer runs.  The tooltip needs the temperatures MetricsSample
+  // carries; only the popup needs the snapshot-only readings and the
+  // optional sensor groups (NVML wakes the dGPU).
+  const bool live = m_popupExpanded || m_panelHovered;
+  m_client->setMetricsSamplesEnabled( live );
+  m_client->setSensorSubscription( m_popupExpanded ? ucc::SensorGroup::All : 0 );
+
+  if ( live )
+  {
+    m_fastTimer->start();
+    pollMetrics();  // at once: the cached readings may be minutes old
+  }
+  else
+    m_fastTimer->stop();
 }
 
 void TrayBackend::pollSlowState()
 {
   // Active profile
-  if ( auto json = m_client->getActiveProfileJSON() )
+  if ( auto active = m_client->getActiveProfile() )
   {
-    auto doc = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) );
-    if ( doc.isObject() )
-    {
-      auto obj = doc.object();
-      auto newId = obj[ "id" ].toString();
-      bool profileSwitched = ( newId != m_activeProfileId );
-      m_activeProfileId = newId;
-      m_activeProfileName = obj[ "name" ].toString();
-      bool changed = profileSwitched;
-
-      // Reset overrides when the system profile itself changes
-      if ( profileSwitched )
-      {
-        m_fanProfileOverride = false;
-        m_keyboardProfileOverride = false;
-        m_gpuProfileOverride = false;
-        m_wcEnabledOverride = false;
-      }
+    const QJsonObject &obj = *active;
+    auto newId = obj[ "id" ].toString();
+    bool profileSwitched = ( newId != m_activeProfileId );
+    m_activeProfileId = newId;
+    m_activeProfileName = obj[ "name" ].toString();
+    bool changed = profileSwitched;
 
-      // Extract fan profile reference — skip if user manually overrode it
-      auto fanObj = obj[ "fan" ].toObject();
-      auto fanId = fanObj[ "fanProfile" ].toString();
+    // Reset overrides when the system profile itself changes
+    if ( profileSwitched )
+    {
+      m_fanProfileOverride = false;
+      m_keyboardProfileOverride = false;
+      m_gpuProfileOverride = false;
+      m_wcEnabledOverride = false;
+    }
 
-      // Extract water cooler auto-control flag
-      bool autoWC = fanObj[ "autoControlWC" ].toBool( true );
-      if ( autoWC != m_wcAutoControl )
-      {
-        m_wcAutoControl = autoWC;
-        emit wcAutoControlChanged();
-      }
+    // Extract fan profile reference — skip if user manually overrode it
+    auto fanObj = obj[ "fan" ].toObject();
+    auto fanId = fanObj[ "fanProfile" ].toString();
 
-      // Query daemon directly for the runtime water-cooler enable state
-      if ( !m_wcEnabledOverride )
-      {
-        bool wcEn = m_client->isWaterCoolerEnabled().value_or( m_wcEnabled );
-        if ( wcEn != m_wcEnabled )
-        {
-          m_wcEnabled = wcEn;
-          emit wcEnabledChanged();
-        }
-      }
-      if ( !m_fanProfileOverride && fanId != m_activeProfileFanId )
-      {
-        m_activeProfileFanId = fanId;
-        m_activeProfileFanName = resolveFanProfileName( fanId );
-        changed = true;
-      }
+    // Extract water cooler auto-control flag
+    bool autoWC = fanObj[ "autoControlWC" ].toBool( true );
+    if ( autoWC != m_wcAutoControl )
+    {
+      m_wcAutoControl = autoWC;
+      emit wcAutoControlChanged();
+    }
 
-      // Extract keyboard profile reference — skip if user manually overrode it
-      auto kbId = obj[ "selectedKeyboardProfile" ].toString();
-      if ( !m_keyboardProfileOverride && kbId != m_activeProfileKeyboardId )
+    // Query daemon directly for the runtime water-cooler enable state
+    if ( !m_wcEnabledOverride )
+    {
+      bool wcEn = m_client->isWaterCoolerEnabled().value_or( m_wcEnabled );
+      if ( wcEn != m_wcEnabled )
       {
-        m_activeProfileKeyboardId = kbId;
-        m_activeProfileKeyboardName = resolveKeyboardProfileName( kbId );
-        changed = true;
+        m_wcEnabled = wcEn;
+        emit wcEnabledChanged();
       }
+    }
+    if ( !m_fanProfileOverride && fanId != m_activeProfileFanId )
+    {
+      m_activeProfileFanId = fanId;
+      m_activeProfileFanName = resolveFanProfileName( fanId );
+      changed = true;
+    }
 
-      const QString gpuId = obj[ "gpuProfileId" ].toString();
-      if ( !m_gpuProfileOverride && gpuId != m_activeProfileGpuId )
-      {
-        m_activeProfileGpuId = gpuId;
-        m_activeProfileGpuName = resolveGpuProfileName( gpuId );
-        changed = true;
-      }
+    // Extract keyboard profile reference — skip if user manually overrode it
+    auto kbId = obj[ "selectedKeyboardProfile" ].toString();
+    if ( !m_keyboardProfileOverride && kbId != m_activeProfileKeyboardId )
+    {
+      m_activeProfileKeyboardId = kbId;
+      m_activeProfileKeyboardName = resolveKeyboardProfileName( kbId );
+      changed = true;
+    }
 
-      if ( changed )
-        emit activeProfileChanged();
+    const QString gpuId = obj[ "gpuProfileId" ].toString();
+    if ( !m_gpuProfileOverride && gpuId != m_activeProfileGpuId )
+    {
+      m_activeProfileGpuId = gpuId;
+      m_activeProfileGpuName = resolveGpuProfileName( gpuId );
+      changed = true;
     }
+
+    if ( changed )
+      emit activeProfileChanged();
   }
 
   // Power state
@@ -678,6 +828,21 @@ void TrayBackend::onDaemonProfileChanged( const QString &profileId,
   }
 }
 
+void TrayBackend::onDaemonPropertiesChanged( const QVariantMap &changed )
+{
+  if ( changed.contains( QStringLiteral( "ProfilesJSON" ) ) )
+    loadProfiles();
+  pollSlowState();
+}
+
+void TrayBackend::updateSlowTimer()
+{
+  if ( m_client->getProperties() )
+    m_slowTimer->stop();
+  else
+    m_slowTimer->start();
+}
+
 void TrayBackend::onSettingsFileChanged( const QString &path )
 {
   // Some editors replace the file (delete + create) rather than writing in-place,
@@ -705,11 +870,9 @@ void TrayBackend::onConnectionStatusChanged( bool connected )
     pollMetrics();
     pollSlowState();
 
-    // Ensure timers are running (they may have been started already, but
-    // calling start() on a running QTimer simply resets the interval which
-    // is harmless).
-    m_fastTimer->start();
-    m_slowTimer->start();
+    // Restart whichever timers the current popup state needs
+    updateMetricsMode();
+    updateSlowTimer();
   }
   else
   {
@@ -727,20 +890,16 @@ void TrayBackend::loadProfiles()
   QStringList names, ids;
 
   // Built-in profiles from daemon
-  if ( auto json = m_client->getDefaultProfilesJSON() )
+  if ( auto profiles = m_client->getDefaultProfiles() )
   {
-    auto doc = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) );
-    if ( doc.isArray() )
+    for ( const auto &val : *profiles )
     {
-      for ( const auto &val : doc.array() )
-      {
-        auto obj = val.toObject();
-        QString id   = obj[ "id" ].toString();
-        QString name = obj[ "name" ].toString();
-        if ( id.isEmpty() ) continue;
-        ids.append( id );
-        names.append( name );
-      }
+      auto obj = val.toObject();
+      QString id   = obj[ "id" ].toString();
+      QString name = obj[ "name" ].toString();
+      if ( id.isEmpty() ) continue;
+      ids.append( id );
+      names.append( name );
     }
   }
 
@@ -775,18 +934,14 @@ void TrayBackend::loadProfiles()
   }
 
   // Active profile
-  if ( auto json = m_client->getActiveProfileJSON() )
+  if ( auto active = m_client->getActiveProfile() )
   {
-    auto doc = QJsonDocument::fromJson( QByteArray::fromStdString( *json ) );
-    if ( doc.isObject() )
-    {
-      auto obj = doc.object();
-      m_activeProfileId = obj[ "id" ].toString();
-      m_activeProfileName = obj[ "name" ].toString();
-      fprintf( stderr, "[TrayBackend] Active profile: %s / %s\n",
-               qPrintable( m_activeProfileId ), qPrintable( m_activeProfileName ) );
-      emit activeProfileChanged();
-    }
+    const QJsonObject &obj = *active;
+    m_activeProfileId = obj[ "id" ].toString();
+    m_activeProfileName = obj[ "name" ].toString();
+    fprintf( stderr, "[TrayBackend] Active profile: %s / %s\n",
+             qPrintable( m_activeProfileId ), qPrintable( m_activeProfileName ) );
+    emit activeProfileChanged();
   }
 
   // Fan profiles
@@ -48,32 +48,38 @@ class TrayBackend : public QObject
   Q_PROPERTY( QString dGpuModel    READ dGpuModel    NOTIFY systemInfoChanged )
   Q_PROPERTY( QString iGpuModel    READ iGpuModel    NOTIFY systemInfoChanged )
 
+  // ── Popup state (set from QML) ──
+  Q_PROPERTY( bool popupExpanded READ popupExpanded WRITE setPopupExpanded NOTIFY popupExpandedChanged )
+  Q_PROPERTY( bool panelHovered  READ panelHovered  WRITE setPanelHovered  NOTIFY panelHoveredChanged )
+
   // ── Dashboard / Monitoring ──
-  Q_PROPERTY( int cpuTemp        READ cpuTemp        NOTIFY metricsUpdated )
-  Q_PROPERTY( int gpuTemp        READ gpuTemp        NOTIFY metricsUpdated )
-  Q_PROPERTY( int cpuFreqMHz     READ cpuFreqMHz     NOTIFY metricsUpdated )
-  Q_PROPERTY( int gpuFreqMHz     READ gpuFreqMHz     NOTIFY metricsUpdated )
-  Q_PROPERTY( double cpuPowerW   READ cpuPowerW      NOTIFY metricsUpdated )
-  Q_PROPERTY( double gpuPowerW   READ gpuPowerW      NOTIFY metricsUpdated )
-  Q_PROPERTY( int cpuFanRPM      READ cpuFanRPM      NOTIFY metricsUpdated )
-  Q_PROPERTY( int gpuFanRPM      READ gpuFanRPM      NOTIFY metricsUpdated )
-  Q_PROPERTY( int cpuFanPercent  READ cpuFanPercent   NOTIFY metricsUpdated )
-  Q_PROPERTY( int gpuFanPercent  READ gpuFanPercent   NOTIFY metricsUpdated )
-  Q_PROPERTY( int wcFanSpeed     READ wcFanSpeed      NOTIFY metricsUpdated )
-  Q_PROPERTY( int wcPumpLevel    READ wcPumpLevel     NOTIFY metricsUpdated )
+  // Panel set: shown in the panel tooltip, kept live while hovered or expanded
+  Q_PROPERTY( int cpuTemp        READ cpuTemp        NOTIFY panelMetricsChanged )
+  Q_PROPERTY( int gpuTemp        READ gpuTemp        NOTIFY panelMetricsChanged )
+  // Popup set: only fetched and notified while the popup is expanded
+  Q_PROPERTY( int cpuFreqMHz     READ cpuFreqMHz     NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int gpuFreqMHz     READ gpuFreqMHz     NOTIFY popupMetricsChanged )
+  Q_PROPERTY( double cpuPowerW   READ cpuPowerW      NOTIFY popupMetricsChanged )
+  Q_PROPERTY( double gpuPowerW   READ gpuPowerW      NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int cpuFanRPM      READ cpuFanRPM      NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int gpuFanRPM      READ gpuFanRPM      NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int cpuFanPercent  READ cpuFanPercent   NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int gpuFanPercent  READ gpuFanPercent   NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int wcFanSpeed     READ wcFanSpeed      NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int wcPumpLevel    READ wcPumpLevel     NOTIFY popupMetricsChanged )
   // Extended NVIDIA dGPU metrics
-  Q_PROPERTY( int  gpuComputeUtilPct   READ gpuComputeUtilPct   NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuMemoryUtilPct    READ gpuMemoryUtilPct    NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuVramUsedMiB      READ gpuVramUsedMiB      NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuVramTotalMiB     READ gpuVramTotalMiB     NOTIFY metricsUpdated )
-  Q_PROPERTY( QString gpuPerfLimitReason READ gpuPerfLimitReason NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuEncoderUtilPct   READ gpuEncoderUtilPct   NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuDecoderUtilPct   READ gpuDecoderUtilPct   NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuCurrentPstate    READ gpuCurrentPstate    NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuGrClockOffsetMHz READ gpuGrClockOffsetMHz NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuMemClockOffsetMHz READ gpuMemClockOffsetMHz NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuVramFreqMHz READ gpuVramFreqMHz NOTIFY metricsUpdated )
-  Q_PROPERTY( int  gpuCoreVoltageMv READ gpuCoreVoltageMv NOTIFY metricsUpdated )
+  Q_PROPERTY( int  gpuComputeUtilPct   READ gpuComputeUtilPct   NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuMemoryUtilPct    READ gpuMemoryUtilPct    NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuVramUsedMiB      READ gpuVramUsedMiB      NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuVramTotalMiB     READ gpuVramTotalMiB     NOTIFY popupMetricsChanged )
+  Q_PROPERTY( QString gpuPerfLimitReason READ gpuPerfLimitReason NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuEncoderUtilPct   READ gpuEncoderUtilPct   NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuDecoderUtilPct   READ gpuDecoderUtilPct   NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuCurrentPstate    READ gpuCurrentPstate    NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuGrClockOffsetMHz READ gpuGrClockOffsetMHz NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuMemClockOffsetMHz READ gpuMemClockOffsetMHz NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuVramFreqMHz READ gpuVramFreqMHz NOTIFY popupMetricsChanged )
+  Q_PROPERTY( int  gpuCoreVoltageMv READ gpuCoreVoltageMv NOTIFY popupMetricsChanged )
 
   // ── Profiles ──
   Q_PROPERTY( QString      activeProfileId READ activeProfileId NOTIFY activeProfileChanged )
@@ -138,6 +144,12 @@ public:
   QString dGpuModel() const;
   QString iGpuModel() const;
 
+  // ── Popup state ──
+  bool popupExpanded() const;
+  void setPopupExpanded( bool expanded );
+  bool panelHovered() const;
+  void setPanelHovered( bool hovered );
+
   // ── Monitoring ──
   int cpuTemp() const;
   int gpuTemp() const;
@@ -236,7 +248,10 @@ signals:
   void connectedChanged();
   void deviceSupportedChanged();
   void systemInfoChanged();
-  void metricsUpdated();
+  void popupExpandedChanged();
+  void panelHoveredChanged();
+  void panelMetricsChanged();
+  void popupMetricsChanged();
   void profilesChanged();
   void activeProfileChanged();
   void powerStateChanged();
@@ -263,6 +278,8 @@ private slots:
                                const QString &gpuProfileId );
   void onSettingsFileChanged( const QString &path );
   void onConnectionStatusChanged( bool connected );
+  void onMetricsSample( qint64 timestampMs, const QList< double > &values );
+  void onDaemonPropertiesChanged( const QVariantMap &changed );
 
 private:
   void loadProfiles();
@@ -271,11 +288,20 @@ private:
   QString resolveFanProfileName( const QString &fanProfileId ) const;
   QString resolveKeyboardProfileName( const QString &kbProfileId ) const;
   QString resolveGpuProfileName( const QString &gpuProfileId ) const;
+  void updateSlowTimer();  // poll only daemons that do not announce property changes
+  void updateMetricsMode();  // push, sensor groups and polling for what is on screen
+  void applySnapshot( const ucc::LiveSnapshot &s );
+  void notifyMetrics();
 
   std::unique_ptr< ucc::UccdClient > m_client;
-  QTimer *m_fastTimer = nullptr;   // ~1 s  — temps, fans
-  QTimer *m_slowTimer = nullptr;   // ~5 s  — profiles, hw toggles
+  QTimer *m_fastTimer = nullptr;   // 1.5 s — snapshot-only readings while expanded, fallback without push
+  QTimer *m_slowTimer = nullptr;   // ~5 s  — profiles, hw toggles (daemons without PropertiesChanged)
   QFileSystemWatcher *m_settingsWatcher = nullptr;
+  qint64 m_lastMetricsSampleAt = 0;  // local receive time of the last MetricsSample (ms)
+  bool m_popupExpanded = false;
+  bool m_panelHovered = false;
+  bool m_snapshotPending = false;    // a GetLiveSnapshot reply is outstanding
+  int m_dirtyMetrics = 0;            // MetricSet bits changed but not yet notified
 
   // Cached monitoring values
   int m_cpuTemp = 0;
@@ -0,0 +1,414 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "interface.h"
+#include "SensorTrace.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Environment variable that replaces the tuxedo_io device with SimulatedDevice
+#define UCCD_SIMULATE_ENV "UCCD_SIMULATE"
+
+/*!
+ * Thermal and power model of a two-fan laptop, standing in for the EC.
+ *
+ * Each channel (0 = CPU, 1 = GPU) is one thermal mass C with a conductance
+ * to ambient that grows with fan speed, G = G0 + G1 * speed / 100, so
+ *   C * dT/dt = P - G * (T - ambient).
+ * P comes from a looped workload: a script of power steps or a recorded
+ * ucc::SensorTrace.  The CPU power is capped by the first TDP, and both
+ * channels throttle at tjMax, so fan curves and TDP changes feed back into
+ * the temperatures the daemon reads.  A trace without power columns is
+ * replayed open loop, temperatures as recorded.
+ *
+ * Fans follow their set duty at a limited slew rate; setFansAuto() hands
+ * them to a simple EC curve.  Time is advanced by the caller, so the model
+ * can run at wall clock in the daemon and stepped in tests.
+ */
+class SimulatedHardware
+{
+public:
+  static constexpr int FAN_COUNT = 2;
+
+  struct Parameters
+  {
+    double ambientC = 30.0;
+    double tjMaxC = 100.0;
+    std::array< double, FAN_COUNT > capacityJPerK = { 60.0, 90.0 };
+    std::array< double, FAN_COUNT > idleConductanceWPerK = { 0.35, 0.5 };
+    std::array< double, FAN_COUNT > fanConductanceWPerK = { 1.4, 2.2 };  ///< Added at 100 % duty
+    double fanSlewPctPerS = 25.0;
+    double maxStepS = 1.0;  ///< Longer advances are integrated in steps of this size
+  };
+
+  /// Workload from @p seconds into the loop until the next point
+  struct LoadPoint
+  {
+    double seconds = 0.0;
+    std::array< double, FAN_COUNT > watts = { 0.0, 0.0 };
+    std::array< double, FAN_COUNT > tempC = { std::nan( "" ), std::nan( "" ) };  ///< Open-loop replay
+  };
+
+  /// Idle, full load, half load; 4 minutes per loop
+  static std::vector< LoadPoint > defaultWorkload()
+  {
+    return { { 0.0, { 8.0, 5.0 } }, { 60.0, { 45.0, 80.0 } }, { 180.0, { 25.0, 30.0 } }, { 240.0, { 8.0, 5.0 } } };
+  }
+
+  /**
+   * @brief Parse a workload script: one "<seconds> <cpuWatts> <gpuWatts>"
+   *        step per line, '#' starts a comment.  The loop ends at the last
+   *        step, so end a script with the point it should restart from.
+   */
+  static std::optional< std::vector< LoadPoint > > parseWorkload( std::istream &in )
+  {
+    std::vector< LoadPoint > points;
+    std::string line;
+    while ( std::getline( in, line ) )
+    {
+      line = line.substr( 0, line.find( '#' ) );
+      std::istringstream fields( line );
+      LoadPoint point;
+      if ( !( fields >> point.seconds ) )
+        continue;
+      if ( !( fields >> point.watts[ 0 ] >> point.watts[ 1 ] ) ||
+           ( !points.empty() && point.seconds < points.back().seconds ) )
+        return std::nullopt;
+      points.push_back( point );
+    }
+    if ( points.empty() )
+      return std::nullopt;
+    return points;
+  }
+
+  /// Workload from a recording: cpuPower/gpuPower if present, temperatures otherwise
+  static std::optional< std::vector< LoadPoint > > workloadFromTrace( const ucc::SensorTrace &trace )
+  {
+    const std::array< std::optional< size_t >, FAN_COUNT > power = { trace.column( "cpuPower" ),
+                                                                     trace.column( "gpuPower" ) };
+    const std::array< std::optional< size_t >, FAN_COUNT > temp = { trace.column( "cpuTemp" ),
+                                                                    trace.column( "gpuTemp" ) };
+    std::vector< LoadPoint > points;
+    for ( size_t row = 0; row < trace.samples(); ++row )
+    {
+      LoadPoint point;
+      point.seconds = static_cast< double >( trace.timestamps[ row ] - trace.timestamps.front() ) / 1000.0;
+      for ( int ch = 0; ch < FAN_COUNT; ++ch )
+      {
+        if ( power[ ch ] )
+          point.watts[ ch ] = std::max( 0.0, finiteOr( trace.value( row, *power[ ch ] ), 0.0 ) );
+        else if ( temp[ ch ] )
+          point.tempC[ ch ] = trace.value( row, *temp[ ch ] );
+      }
+      if ( points.empty() || point.seconds >= points.back().seconds )
+        points.push_back( point );
+    }
+    if ( points.empty() )
+      return std::nullopt;
+    return points;
+  }
+
+  explicit SimulatedHardware( std::vector< LoadPoint > workload = defaultWorkload() )
+    : SimulatedHardware( std::move( workload ), Parameters() )
+  {
+  }
+
+  SimulatedHardware( std::vector< LoadPoint > workload, Parameters parameters )
+    : m_params( parameters ), m_workload( std::move( workload ) )
+  {
+    m_temp.fill( m_params.ambientC );
+    if ( m_workload.empty() )
+      m_workload = defaultWorkload();
+  }
+
+  /**
+   * @brief Model selected by UCCD_SIMULATE, shared by every SimulatedDevice
+   *        of the process; nullptr when simulation is off.
+   *
+   * "1" or "model" runs defaultWorkload(), anything else names a workload
+   * script or a SensorTrace file.  An unreadable file falls back to the
+   * default workload rather than to real hardware.
+   */
+  static std::shared_ptr< SimulatedHardware > fromEnvironment()
+  {
+    static const std::shared_ptr< SimulatedHardware > shared = []() -> std::shared_ptr< SimulatedHardware > {
+      const char *value = std::getenv( UCCD_SIMULATE_ENV );
+      if ( !value || !*value )
+        return nullptr;
+
+      const std::string spec = value;
+      std::optional< std::vector< LoadPoint > > workload;
+      if ( spec != "1" && spec != "model" )
+      {
+        if ( const auto trace = ucc::SensorTrace::load( spec ) )
+          workload = workloadFromTrace( *trace );
+        else if ( std::ifstream script( spec ); script )
+          workload = parseWorkload( script );
+      }
+      return std::make_shared< SimulatedHardware >( workload.value_or( defaultWorkload() ) );
+    }();
+    return shared;
+  }
+
+  /// Advance the model to the steady clock; the first call only sets the origin
+  void advanceToNow()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    std::scoped_lock lock( m_mutex );
+    if ( m_lastUpdate )
+      step( std::chrono::duration< double >( now - *m_lastUpdate ).count() );
+    m_lastUpdate = now;
+  }
+
+  void advance( double seconds )
+  {
+    std::scoped_lock lock( m_mutex );
+    step( seconds );
+  }
+
+  double temperature( int fan ) const { std::scoped_lock lock( m_mutex ); return m_temp[ fan ]; }
+  double power( int fan ) const { std::scoped_lock lock( m_mutex ); return m_power[ fan ]; }
+  double fanSpeed( int fan ) const { std::scoped_lock lock( m_mutex ); return m_speed[ fan ]; }
+
+  void setFanDuty( int fan, int percent )
+  {
+    std::scoped_lock lock( m_mutex );
+    m_auto = false;
+    m_duty[ fan ] = std::clamp( percent, 0, 100 );
+  }
+
+  void setFansAuto() { std::scoped_lock lock( m_mutex ); m_auto = true; }
+
+  /// TDPs in W; the first one caps the CPU power
+  static constexpr int TDP_COUNT = 3;
+  static constexpr std::array< int, TDP_COUNT > TDP_MAX = { 65, 90, 140 };
+
+  int tdp( int index ) const { std::scoped_lock lock( m_mutex ); return m_tdp[ index ]; }
+  void setTdp( int index, int watts ) { std::scoped_lock lock( m_mutex ); m_tdp[ index ] = watts; }
+
+  // State the daemon only reads back
+  bool webcam() const { std::scoped_lock lock( m_mutex ); return m_webcam; }
+  void setWebcam( bool on ) { std::scoped_lock lock( m_mutex ); m_webcam = on; }
+  std::string odmProfile() const { std::scoped_lock lock( m_mutex ); return m_odmProfile; }
+  void setOdmProfile( std::string profile ) { std::scoped_lock lock( m_mutex ); m_odmProfile = std::move( profile ); }
+
+private:
+  static double finiteOr( double value, double fallback ) { return std::isfinite( value ) ? value : fallback; }
+
+  const LoadPoint &loadAt( double seconds ) const
+  {
+    const double period = m_workload.back().seconds;
+    const double t = period > 0.0 ? std::fmod( seconds, period ) : 0.0;
+    auto it = std::upper_bound( m_workload.begin(), m_workload.end(), t,
+                                []( double s, const LoadPoint &p ) { return s < p.seconds; } );
+    return it == m_workload.begin() ? *it : *std::prev( it );
+  }
+
+  void step( double seconds )
+  {
+    while ( seconds > 0.0 )
+    {
+      const double dt = std::min( seconds, m_params.maxStepS );
+      seconds -= dt;
+      m_clock += dt;
+      const LoadPoint &load = loadAt( m_clock );
+
+      for ( int ch = 0; ch < FAN_COUNT; ++ch )
+      {
+        const double target = m_auto ? std::clamp( ( m_temp[ ch ] - 40.0 ) * 2.0, 20.0, 100.0 ) : m_duty[ ch ];
+        const double slew = m_params.fanSlewPctPerS * dt;
+        m_speed[ ch ] += std::clamp( target - m_speed[ ch ], -slew, slew );
+
+        if ( std::isfinite( load.tempC[ ch ] ) )
+        {
+          m_temp[ ch ] = load.tempC[ ch ];
+          m_power[ ch ] = 0.0;
+          continue;
+        }
+
+        double watts = load.watts[ ch ];
+        if ( ch == 0 )
+          watts = std::min( watts, static_cast< double >( m_tdp[ 0 ] ) );
+        const double conductance = m_params.idleConductanceWPerK[ ch ] +
+                                   m_params.fanConductanceWPerK[ ch ] * m_speed[ ch ] / 100.0;
+        // throttle: no more power than holds the chip at tjMax
+        watts = std::min( watts, conductance * ( m_params.tjMaxC - m_params.ambientC ) );
+        m_power[ ch ] = watts;
+
+        // exact for constant power and conductance over the step
+        const double steady = m_params.ambientC + watts / conductance;
+        m_temp[ ch ] = steady + ( m_temp[ ch ] - steady ) *
+                                  std::exp( -dt * conductance / m_params.capacityJPerK[ ch ] );
+      }
+    }
+  }
+
+  mutable std::mutex m_mutex;
+  Parameters m_params;
+  std::vector< LoadPoint > m_workload;
+  std::optional< std::chrono::steady_clock::time_point > m_lastUpdate;
+  double m_clock = 0.0;
+  bool m_auto = true;
+  std::array< int, TDP_COUNT > m_tdp = TDP_MAX;
+  bool m_webcam = true;
+  std::string m_odmProfile = "enthusiast";
+  std::array< double, FAN_COUNT > m_temp {};
+  std::array< double, FAN_COUNT > m_power {};
+  std::array< double, FAN_COUNT > m_speed {};
+  std::array< int, FAN_COUNT > m_duty {};
+};
+
+/*!
+ * DeviceInterface on top of SimulatedHardware, for running uccd without a
+ * TUXEDO laptop (load and soak testing).  Selected by TuxedoIOAPI when
+ * UCCD_SIMULATE is set; never touches m_io.
+ */
+class SimulatedDevice : public DeviceInterface
+{
+public:
+  SimulatedDevice( IO &io, std::shared_ptr< SimulatedHardware > hardware )
+    : DeviceInterface( io ), m_hw( std::move( hardware ) )
+  {
+  }
+
+  virtual bool identify( bool &identified )
+  { identified = true; return true; }
+
+  virtual bool deviceInterfaceIdStr( std::string &interfaceIdStr )
+  { interfaceIdStr = "simulated"; return true; }
+
+  virtual bool deviceModelIdStr( std::string &modelIdStr )
+  { modelIdStr = "simulated"; return true; }
+
+  virtual bool setEnableModeSet( [[maybe_unused]] bool enabled )
+  { return true; }
+
+  virtual bool getFansMinSpeed( int &minSpeed )
+  { minSpeed = 0; return true; }
+
+  virtual bool getFansOffAvailable( bool &offAvailable )
+  { offAvailable = true; return true; }
+
+  virtual bool getNumberFans( int &nrFans )
+  { nrFans = SimulatedHardware::FAN_COUNT; return true; }
+
+  virtual bool setFansAuto()
+  { m_hw->advanceToNow(); m_hw->setFansAuto(); return true; }
+
+  virtual bool setFanSpeedPercent( const int fanNr, const int fanSpeedPercent )
+  {
+    if ( !validFan( fanNr ) )
+      return false;
+    m_hw->advanceToNow();
+    m_hw->setFanDuty( fanNr, fanSpeedPercent );
+    return true;
+  }
+
+  virtual bool getFanSpeedPercent( const int fanNr, int &fanSpeedPercent )
+  {
+    if ( !validFan( fanNr ) )
+      return false;
+    m_hw->advanceToNow();
+    fanSpeedPercent = static_cast< int >( std::lround( m_hw->fanSpeed( fanNr ) ) );
+    return true;
+  }
+
+  virtual bool getFanTemperature( const int fanNr, int &temperatureCelcius )
+  {
+    if ( !validFan( fanNr ) )
+      return false;
+    m_hw->advanceToNow();
+    temperatureCelcius = static_cast< int >( std::lround( m_hw->temperature( fanNr ) ) );
+    return true;
+  }
+
+  virtual bool setWebcam( const bool status )
+  { m_hw->setWebcam( status ); return true; }
+
+  virtual bool getWebcam( bool &status )
+  { status = m_hw->webcam(); return true; }
+
+  virtual bool getAvailableODMPerformanceProfiles( std::vector< std::string > &profiles )
+  { profiles = { "power_save", "enthusiast", "overboost" }; return true; }
+
+  virtual bool setODMPerformanceProfile( std::string performanceProfile )
+  {
+    std::vector< std::string > profiles;
+    getAvailableODMPerformanceProfiles( profiles );
+    if ( std::find( profiles.begin(), profiles.end(), performanceProfile ) == profiles.end() )
+      return false;
+    m_hw->setOdmProfile( std::move( performanceProfile ) );
+    return true;
+  }
+
+  virtual bool getDefaultODMPerformanceProfile( std::string &profileName )
+  { profileName = "enthusiast"; return true; }
+
+  virtual bool getNumberTDPs( int &nrTDPs )
+  { nrTDPs = SimulatedHardware::TDP_COUNT; return true; }
+
+  virtual bool getTDPDescriptors( std::vector< std::string > &tdpDescriptors )
+  { tdpDescriptors = { "pl1", "pl2", "pl4" }; return true; }
+
+  virtual bool getTDPMin( const int tdpIndex, int &minValue )
+  {
+    if ( !validTDP( tdpIndex ) )
+      return false;
+    minValue = 5;
+    return true;
+  }
+
+  virtual bool getTDPMax( const int tdpIndex, int &maxValue )
+  {
+    if ( !validTDP( tdpIndex ) )
+      return false;
+    maxValue = SimulatedHardware::TDP_MAX[ tdpIndex ];
+    return true;
+  }
+
+  virtual bool setTDP( const int tdpIndex, const int tdpValue )
+  {
+    if ( !validTDP( tdpIndex ) || tdpValue < 5 || tdpValue > SimulatedHardware::TDP_MAX[ tdpIndex ] )
+      return false;
+    m_hw->advanceToNow();
+    m_hw->setTdp( tdpIndex, tdpValue );
+    return true;
+  }
+
+  virtual bool getTDP( const int tdpIndex, int &tdpValue )
+  {
+    if ( !validTDP( tdpIndex ) )
+      return false;
+    tdpValue = m_hw->tdp( tdpIndex );
+    return true;
+  }
+
+private:
+  static bool validFan( int fanNr ) { return fanNr >= 0 && fanNr < SimulatedHardware::FAN_COUNT; }
+  static bool validTDP( int tdpIndex ) { return tdpIndex >= 0 && tdpIndex < SimulatedHardware::TDP_COUNT; }
+
+  std::shared_ptr< SimulatedHardware > m_hw;
+};
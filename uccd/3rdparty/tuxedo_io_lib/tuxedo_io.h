@@ -21,9 +21,13 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 
+#include "UccTrace.hpp"
+
 /**
  * @brief IO device interface for TUXEDO I/O operations
  *
@@ -33,6 +37,11 @@
 class IO
 {
 public:
+  /**
+   * @brief Receives the request code and duration of every ioctl
+   */
+  using Observer = std::function< void( unsigned long request, std::chrono::nanoseconds duration ) >;
+
   /**
    * @brief Construct an IO device handle
    * @param devicePath Path to the device file to open
@@ -66,6 +75,17 @@ public:
     return m_fileHandle >= 0;
   }
 
+  /**
+   * @brief Install an observer for ioctl timing
+   *
+   * Not synchronised with running calls; set it before the device is
+   * shared between threads.
+   */
+  void setObserver(Observer observer)
+  {
+    m_observer = std::move(observer);
+  }
+
   /**
    * @brief Execute an ioctl call without arguments
    * @param request The ioctl request code
@@ -76,7 +96,7 @@ public:
     if ( not isAvailable() )
       return false;
 
-    int result = ioctl(m_fileHandle, request);
+    int result = timedIoctl(request, nullptr);
     return result >= 0;
   }
 
@@ -91,7 +111,7 @@ public:
     if ( not isAvailable() )
       return false;
 
-    int result = ioctl(m_fileHandle, request, &argument);
+    int result = timedIoctl(request, &argument);
     return result >= 0;
   }
 
@@ -111,7 +131,7 @@ public:
     auto buffer = std::make_unique<char[]>(bufferLength + 1);
     buffer[bufferLength] = '\0';  // Prevent buffer overread in case kernel doesn't NUL-term
 
-    int result = ioctl(m_fileHandle, request, buffer.get());
+    int result = timedIoctl(request, buffer.get());
     if ( result >= 0 )
     {
       argument.clear();
@@ -122,6 +142,19 @@ public:
 
 private:
   int m_fileHandle;  ///< File descriptor for the device
+  Observer m_observer;
+
+  int timedIoctl(unsigned long request, void *argument)
+  {
+    UCC_TRACE_SCOPE_ARG("ioctl", "tuxedo_io", request);
+    if ( not m_observer )
+      return ioctl(m_fileHandle, request, argument);
+
+    const auto begin = std::chrono::steady_clock::now();
+    const int result = ioctl(m_fileHandle, request, argument);
+    m_observer(request, std::chrono::steady_clock::now() - begin);
+    return result;
+  }
 
   /**
    * @brief Open the device file
@@ -33,6 +33,7 @@
 #include "targets/clevo.h"
 #include "targets/uniwill.h"
 #include "targets/dummy.h"
+#include "targets/simulated.h"
 
 #define TUXEDO_IO_DEVICE_FILE "/dev/tuxedo_io"
 
@@ -46,6 +47,10 @@ private:
   {
     bool identified = false;
 
+    // Simulated hardware replaces the driver entirely (UCCD_SIMULATE)
+    if ( auto hardware = SimulatedHardware::fromEnvironment() )
+      return std::make_unique< SimulatedDevice >( m_io, std::move( hardware ) );
+
     // Try Clevo device
     if ( ClevoDevice::canIdentify( m_io, identified ) and identified )
       return std::make_unique< ClevoDevice >( m_io );
@@ -65,7 +70,13 @@ public:
   }
 
   bool wmiAvailable()
-  { return m_io.isAvailable(); }
+  { return SimulatedHardware::fromEnvironment() or m_io.isAvailable(); }
+
+  /**
+   * @brief Time every ioctl of this device; call before sharing it between threads
+   */
+  void setIoctlObserver(IO::Observer observer)
+  { m_io.setObserver( std::move( observer ) ); }
 
   bool getModuleVersion(std::string &version)
   { return m_io.ioctlCall( R_MOD_VERSION, version, 20 ); }
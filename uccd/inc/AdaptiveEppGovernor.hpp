@@ -0,0 +1,118 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief One monitor sample as seen by AdaptiveEppGovernor
+ */
+struct AdaptiveEppSample
+{
+  double avgBusy = 0.0;        ///< Mean busy fraction of the online cores, 0..1
+  double peakBusy = 0.0;       ///< Busiest core
+  bool onBattery = false;
+  bool powerLimited = false;   ///< The package ran at its power limit most of the interval
+};
+
+/**
+ * @brief Picks one of a profile's EPP levels from the load
+ *
+ * Levels run from the most efficient (0) to the most responsive.  A core
+ * at BURST_BUSY, typically an interactive burst on one thread, moves to the
+ * highest allowed level at once; an average above RAISE_BUSY moves up one
+ * level.  Down is one level at a time, once both the average and the
+ * busiest core have stayed light for LOWER_HOLD_MS since the last change.
+ *
+ * On battery the top level is left out when there are three or more.  While
+ * the package sits at its power limit there is no headroom for a more
+ * responsive preference to use, so the level does not rise.
+ *
+ * Not thread-safe; CpuWorker calls it under its own lock.
+ */
+class AdaptiveEppGovernor
+{
+public:
+  static constexpr double BURST_BUSY = 0.85;
+  static constexpr double RAISE_BUSY = 0.50;
+  static constexpr double LOWER_BUSY = 0.20;
+  static constexpr int64_t LOWER_HOLD_MS = 3000;
+
+  /// Number of levels; starts from the lowest when it changes
+  void configure( size_t levels ) noexcept
+  {
+    if ( levels == m_levels )
+      return;
+    m_levels = levels;
+    m_level = 0;
+    m_lightSinceMs = NEVER;
+  }
+
+  [[nodiscard]] bool enabled() const noexcept { return m_levels >= 2; }
+  [[nodiscard]] size_t level() const noexcept { return m_level; }
+
+  /// @return true when level() changed
+  bool update( int64_t nowMs, const AdaptiveEppSample &sample ) noexcept
+  {
+    if ( not enabled() )
+      return false;
+
+    size_t ceiling = m_levels - 1;
+    if ( sample.onBattery and m_levels >= 3 )
+      --ceiling;
+
+    if ( m_level > ceiling )
+      return setLevel( ceiling );
+
+    if ( sample.powerLimited )
+      ceiling = m_level;
+
+    if ( sample.peakBusy >= BURST_BUSY )
+      return setLevel( ceiling );
+    if ( sample.avgBusy >= RAISE_BUSY )
+      return setLevel( std::min( m_level + 1, ceiling ) );
+
+    if ( m_level == 0 or sample.avgBusy >= LOWER_BUSY or sample.peakBusy >= RAISE_BUSY )
+    {
+      m_lightSinceMs = NEVER;
+      return false;
+    }
+    if ( m_lightSinceMs == NEVER )
+      m_lightSinceMs = nowMs;
+    if ( nowMs - m_lightSinceMs < LOWER_HOLD_MS )
+      return false;
+    return setLevel( m_level - 1 );
+  }
+
+private:
+  static constexpr int64_t NEVER = std::numeric_limits< int64_t >::min();
+
+  bool setLevel( size_t level ) noexcept
+  {
+    if ( level == m_level )
+      return false;
+    m_level = level;
+    m_lightSinceMs = NEVER;
+    return true;
+  }
+
+  size_t m_levels = 0;
+  size_t m_level = 0;
+  int64_t m_lightSinceMs = NEVER;
+};
@@ -0,0 +1,491 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "JsonWriter.hpp"
+#include "MetricRegistry.hpp"
+#include "SnapshotCell.hpp"
+#include "TccSettings.hpp"
+
+/**
+ * @brief Evaluates AlertRules on every sample as it is recorded
+ *
+ * MetricsHistoryStore hands each pushed sample to observe().  Samples of
+ * metrics no rule watches return after one atomic load; the others update
+ * the state of their rules, found through a snapshot of the rule set, so
+ * the push path takes no lock and, with the rate window in a fixed ring,
+ * allocates nothing.  A rule that starts or stops holding calls the
+ * notify callback once; nothing happens per sample otherwise, so clients
+ * can wait for AlertRaised / AlertCleared instead of polling.
+ *
+ * "above" and "below" raise once the value has stayed past the threshold
+ * for forSeconds, and clear once it is back by more than the hysteresis.
+ * "rising" and "falling" compare the rate of change over the last
+ * forSeconds (at least one second), in units per second, with the
+ * threshold.
+ */
+class AlertEngine
+{
+public:
+  static constexpr size_t MAX_RULES = 64;
+  static constexpr int MAX_FOR_SECONDS = 3600;
+  static constexpr int64_t MIN_RATE_WINDOW_MS = 1000;
+
+  enum class Condition : uint8_t
+  {
+    Above,
+    Below,
+    Rising,
+    Falling,
+  };
+
+  [[nodiscard]] static std::optional< Condition > parseCondition( std::string_view name ) noexcept
+  {
+    if ( name == "above" )
+      return Condition::Above;
+    if ( name == "below" )
+      return Condition::Below;
+    if ( name == "rising" )
+      return Condition::Rising;
+    if ( name == "falling" )
+      return Condition::Falling;
+    return std::nullopt;
+  }
+
+  /// One rule starting or stopping to hold
+  struct Event
+  {
+    std::string ruleId;
+    std::string metric;
+    bool raised;          ///< false: cleared
+    double value;         ///< The metric's value, or its rate for rising / falling
+    int64_t timestampMs;
+  };
+
+  using Notify = std::function< void( const Event & ) >;
+
+  explicit AlertEngine( Notify notify = {} )
+    : m_notify( std::move( notify ) )
+  {
+  }
+
+  AlertEngine( const AlertEngine & ) = delete;
+  AlertEngine &operator=( const AlertEngine & ) = delete;
+
+  /**
+   * @brief Why @p rule cannot be evaluated, nullopt if it can.
+   */
+  [[nodiscard]] static std::optional< std::string > validate( const AlertRule &rule, const MetricRegistry &registry )
+  {
+    if ( auto error = validateShape( rule ) )
+      return error;
+    if ( !registry.find( rule.metric ) )
+      return "unknown metric '" + rule.metric + "'";
+    return std::nullopt;
+  }
+
+  /**
+   * @brief validate() without the metric lookup: whether @p rule could be
+   *        evaluated once its metric is registered.
+   */
+  [[nodiscard]] static std::optional< std::string > validateShape( const AlertRule &rule )
+  {
+    if ( rule.id.empty() )
+      return "rule without an id";
+    if ( !parseCondition( rule.condition ) )
+      return "unknown condition '" + rule.condition + "'";
+    if ( !std::isfinite( rule.threshold ) || !std::isfinite( rule.hysteresis ) || rule.hysteresis < 0.0 )
+      return "threshold and hysteresis must be finite, hysteresis not negative";
+    if ( rule.forSeconds < 0 || rule.forSeconds > MAX_FOR_SECONDS )
+      return "forSeconds out of range";
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Evaluate @p rules from now on; invalid ones are skipped.
+   *
+   * Rules that are unchanged keep their state, so an active alert is not
+   * raised a second time.  Active alerts whose rule is gone are cleared.
+   * A rule on a metric that is not registered yet (extra fans show up with
+   * the first fan sample) waits for metricsRegistered().
+   * @return Number of rules in effect
+   */
+  size_t setRules( const std::vector< AlertRule > &rules, const MetricRegistry &registry )
+  {
+    std::vector< Event > cleared;
+    size_t count = 0;
+    {
+      std::lock_guard lock( m_configMutex );
+      m_rules = rules;
+      count = arm( registry, cleared );
+    }
+
+    for ( const Event &event : cleared )
+      notify( event );
+    return count;
+  }
+
+  /**
+   * @brief Arm the rules that wait for a metric, now that @p registry grew.
+   *
+   * Call after MetricRegistry::add(); returns at once when no rule waits.
+   * @return Number of rules in effect
+   */
+  size_t metricsRegistered( const MetricRegistry &registry )
+  {
+    std::lock_guard lock( m_configMutex );
+    if ( !m_waiting )
+      return m_set.load()->states.size();
+    // the rules in effect are all kept, so nothing is cleared
+    std::vector< Event > cleared;
+    return arm( registry, cleared );
+  }
+
+  /**
+   * @brief Feed one sample.  Safe to call from any thread.
+   *
+   * Takes no lock and allocates nothing unless a rule starts or stops
+   * holding.  Should two producers feed the same metric at the same
+   * moment, the one that finds the rule busy drops its sample.
+   */
+  void observe( MetricId id, int64_t timestampMs, double value ) noexcept
+  {
+    const auto idx = static_cast< size_t >( id );
+    if ( idx >= MetricRegistry::MAX_METRICS
+         || ( m_watched.load( std::memory_order_acquire ) >> idx & 1u ) == 0
+         || std::isnan( value ) )
+      return;
+
+    // a transition is rare: at most a few per sample, allocated only then
+    std::vector< Event > events;
+    try
+    {
+      const auto set = m_set.load();
+      for ( const auto &state : set->states )
+      {
+        if ( state->metric != id )
+          continue;
+        const Claim claim( *state );
+        if ( !claim || state->retired )
+          continue;
+        const bool changed = update( *state, timestampMs, value );
+        state->shownValue.store( state->lastValue, std::memory_order_relaxed );
+        if ( !changed )
+          continue;
+        state->shownSinceMs.store( state->raisedMs, std::memory_order_relaxed );
+        state->shownActive.store( state->active, std::memory_order_release );
+        events.push_back( Event{ state->rule.id, state->rule.metric, state->active,
+                                 state->lastValue, timestampMs } );
+      }
+    }
+    catch ( const std::exception & )
+    {
+      return;
+    }
+
+    for ( const Event &event : events )
+      notify( event );
+  }
+
+  /**
+   * @brief The alerts currently raised as JSON
+   *
+   * @code
+   * [ { "id": "gpu-hot", "metric": "gpuTemp", "value": 88.0, "since": 1700000000000 }, ... ]
+   * @endcode
+   */
+  void activeJSON( std::string &out ) const
+  {
+    const auto set = m_set.load();
+    JsonWriter w( out );
+    w.beginArray();
+    for ( const auto &state : set->states )
+    {
+      if ( !state->shownActive.load( std::memory_order_acquire ) )
+        continue;
+      w.beginObject()
+        .key( "id" ).value( state->rule.id )
+        .key( "metric" ).value( state->rule.metric )
+        .key( "value" ).value( state->shownValue.load( std::memory_order_relaxed ), 2 )
+        .key( "since" ).value( state->shownSinceMs.load( std::memory_order_relaxed ) )
+        .endObject();
+    }
+    w.endArray();
+  }
+
+  [[nodiscard]] size_t activeCount() const
+  {
+    const auto set = m_set.load();
+    return static_cast< size_t >( std::count_if( set->states.begin(), set->states.end(), []( const auto &state ) {
+      return state->shownActive.load( std::memory_order_acquire );
+    } ) );
+  }
+
+private:
+  static constexpr int64_t NEVER = std::numeric_limits< int64_t >::min();
+
+  /// Samples a rate window holds, including the base at or before its start
+  static constexpr size_t RATE_WINDOW_SAMPLES = 64;
+
+  /// rising / falling: the samples of the rate window, oldest first, in a fixed ring
+  struct RateWindow
+  {
+    struct Sample
+    {
+      int64_t ms = 0;
+      double value = 0.0;
+    };
+
+    std::array< Sample, RATE_WINDOW_SAMPLES > ring{};
+    size_t first = 0;
+    size_t count = 0;
+
+    [[nodiscard]] const Sample &operator[]( size_t i ) const noexcept { return ring[ ( first + i ) % ring.size() ]; }
+    [[nodiscard]] const Sample &back() const noexcept { return ( *this )[ count - 1 ]; }
+
+    void push( int64_t ms, double value ) noexcept
+    {
+      if ( count == ring.size() )
+        popFront();
+      ring[ ( first + count ) % ring.size() ] = Sample{ ms, value };
+      ++count;
+    }
+
+    void popFront() noexcept
+    {
+      first = ( first + 1 ) % ring.size();
+      --count;
+    }
+  };
+
+  /**
+   * @brief One rule in effect
+   *
+   * observe() changes it while holding busy; the shown* copies are what
+   * activeJSON() / activeCount() read without it.
+   */
+  struct State
+  {
+    State( AlertRule r, MetricId m, Condition c ) : rule( std::move( r ) ), metric( m ), condition( c ) {}
+
+    const AlertRule rule;
+    const MetricId metric;
+    const Condition condition;
+
+    std::atomic_flag busy;   ///< Held by the producer updating the fields below
+    bool retired = false;    ///< The rule was removed; set while holding busy
+    bool active = false;
+    int64_t holdingSinceMs = NEVER;  ///< above / below: first sample past the threshold
+    int64_t raisedMs = 0;
+    int64_t lastMs = 0;
+    int64_t lastSeenMs = NEVER;      ///< rising / falling: newest sample, stored in window or not
+    double lastValue = 0.0;
+    RateWindow window;
+
+    std::atomic< bool > shownActive{ false };
+    std::atomic< double > shownValue{ 0.0 };
+    std::atomic< int64_t > shownSinceMs{ 0 };
+  };
+
+  /// The rules in effect, replaced as a whole by arm()
+  struct RuleSet
+  {
+    std::vector< std::shared_ptr< State > > states;
+  };
+
+  /// Holds State::busy if it was free
+  class Claim
+  {
+  public:
+    explicit Claim( State &state ) noexcept
+      : m_state( state ), m_owned( !state.busy.test_and_set( std::memory_order_acquire ) )
+    {
+    }
+    ~Claim()
+    {
+      if ( m_owned )
+        m_state.busy.clear( std::memory_order_release );
+    }
+    Claim( const Claim & ) = delete;
+    Claim &operator=( const Claim & ) = delete;
+
+    explicit operator bool() const noexcept { return m_owned; }
+
+  private:
+    State &m_state;
+    bool m_owned;
+  };
+
+  /// Rebuild the rule set from m_rules; m_configMutex held.  @return Number of rules in effect
+  size_t arm( const MetricRegistry &registry, std::vector< Event > &cleared )
+  {
+    const auto current = m_set.load();
+    RuleSet next;
+    std::vector< bool > kept( current->states.size(), false );
+    uint64_t watched = 0;
+    m_waiting = false;
+    for ( const AlertRule &rule : m_rules )
+    {
+      if ( next.states.size() >= MAX_RULES || validateShape( rule ) )
+        continue;
+      const auto metric = registry.find( rule.metric );
+      if ( !metric )
+      {
+        m_waiting = true;
+        continue;
+      }
+      size_t old = 0;
+      while ( old < current->states.size() && ( kept[ old ] || !( current->states[ old ]->rule == rule ) ) )
+        ++old;
+      if ( old < current->states.size() )
+      {
+        kept[ old ] = true;
+        next.states.push_back( current->states[ old ] );
+      }
+      else
+        next.states.push_back( std::make_shared< State >( rule, *metric, *parseCondition( rule.condition ) ) );
+      watched |= uint64_t( 1 ) << static_cast< size_t >( next.states.back()->metric );
+    }
+
+    const size_t count = next.states.size();
+    m_set.store( std::move( next ) );
+    m_watched.store( watched, std::memory_order_release );
+
+    // a producer may still hold the old set: wait for it, then stop the rule for good
+    for ( size_t i = 0; i < current->states.size(); ++i )
+    {
+      if ( kept[ i ] )
+        continue;
+      State &state = *current->states[ i ];
+      while ( state.busy.test_and_set( std::memory_order_acquire ) )
+        std::this_thread::yield();
+      state.retired = true;
+      state.shownActive.store( false, std::memory_order_release );
+      if ( state.active )
+        cleared.push_back( Event{ state.rule.id, state.rule.metric, false, state.lastValue, state.lastMs } );
+      state.busy.clear( std::memory_order_release );
+    }
+    return count;
+  }
+
+  /// @return true when the rule started or stopped holding
+  static bool update( State &state, int64_t nowMs, double value )
+  {
+    const AlertRule &rule = state.rule;
+    const int64_t forMs = static_cast< int64_t >( rule.forSeconds ) * 1000;
+
+    if ( state.condition == Condition::Above || state.condition == Condition::Below )
+    {
+      const bool above = state.condition == Condition::Above;
+      state.lastValue = value;
+      state.lastMs = nowMs;
+      if ( state.active )
+      {
+        const bool clear = above ? value <= rule.threshold - rule.hysteresis
+                                 : value >= rule.threshold + rule.hysteresis;
+        if ( !clear )
+          return false;
+        state.active = false;
+        state.holdingSinceMs = NEVER;
+        return true;
+      }
+
+      if ( above ? value <= rule.threshold : value >= rule.threshold )
+      {
+        state.holdingSinceMs = NEVER;
+        return false;
+      }
+      if ( state.holdingSinceMs == NEVER )
+        state.holdingSinceMs = nowMs;
+      if ( nowMs - state.holdingSinceMs < forMs )
+        return false;
+      state.active = true;
+      state.raisedMs = nowMs;
+      return true;
+    }
+
+    // a second producer of the same metric may lag behind by a few ms
+    if ( nowMs <= state.lastSeenMs )
+      return false;
+    state.lastSeenMs = nowMs;
+
+    // the ring holds a window's worth at this spacing; the rate always ends at
+    // the current sample, stored or not
+    const int64_t windowMs = std::max( forMs, MIN_RATE_WINDOW_MS );
+    const auto span = static_cast< int64_t >( RATE_WINDOW_SAMPLES - 2 );
+    const int64_t spacingMs = ( windowMs + span - 1 ) / span;
+    RateWindow &window = state.window;
+    if ( window.count == 0 || nowMs - window.back().ms >= spacingMs )
+      window.push( nowMs, value );
+
+    // keep one sample at or before the window start as the rate's base
+    while ( window.count > 2 && window[ 1 ].ms <= nowMs - windowMs )
+      window.popFront();
+    const auto [ baseMs, baseValue ] = window[ 0 ];
+    if ( nowMs - baseMs < windowMs )
+      return false;
+
+    double rate = ( value - baseValue ) * 1000.0 / static_cast< double >( nowMs - baseMs );
+    if ( state.condition == Condition::Falling )
+      rate = -rate;
+    state.lastValue = rate;
+    state.lastMs = nowMs;
+
+    const bool holds = state.active ? rate > rule.threshold - rule.hysteresis : rate >= rule.threshold;
+    if ( holds == state.active )
+      return false;
+    state.active = holds;
+    if ( holds )
+      state.raisedMs = nowMs;
+    return true;
+  }
+
+  void notify( const Event &event ) const noexcept
+  {
+    if ( !m_notify )
+      return;
+    try
+    {
+      m_notify( event );
+    }
+    catch ( const std::exception & )
+    {
+    }
+  }
+
+  Notify m_notify;
+  std::mutex m_configMutex;          ///< Serialises setRules() / metricsRegistered()
+  std::vector< AlertRule > m_rules;  ///< As set, including the ones not in effect
+  bool m_waiting = false;            ///< A rule in m_rules names a metric not registered yet
+  SnapshotCell< RuleSet > m_set;
+  std::atomic< uint64_t > m_watched{ 0 };  ///< Bit i: a rule watches MetricId i
+};
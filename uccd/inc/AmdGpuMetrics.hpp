@@ -0,0 +1,246 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief Telemetry decoded from an amdgpu gpu_metrics table.
+ *
+ * Converted to °C, W and MHz; -1 where the table lacks the field or the
+ * firmware reports it as unsupported (all bits set).
+ */
+struct AmdGpuMetrics
+{
+  uint8_t formatRevision = 0;          ///< 1 = dGPU, 2/3 = APU
+  uint8_t contentRevision = 0;
+  double temperatureC = -1.0;          ///< Edge (dGPU) or GFX (APU) temperature
+  double hotspotC = -1.0;              ///< dGPU only
+  double memoryTemperatureC = -1.0;    ///< dGPU only
+  double socketPowerW = -1.0;
+  double gfxClockMHz = -1.0;           ///< Current clock, else the time-filtered average
+  double gfxMaxClockMHz = -1.0;        ///< Enforced limit (v3 only)
+  double memClockMHz = -1.0;           ///< dGPU only
+  double gfxActivityPct = -1.0;
+  double memActivityPct = -1.0;        ///< Memory controller, dGPU only
+  int64_t throttleStatus = -1;         ///< ASIC-specific throttler bit mask (v1/v2)
+  std::vector< double > cpuCoreClockMHz;  ///< APU CPU cores
+};
+
+/**
+ * @brief Decoder for the versioned gpu_metrics blob of the amdgpu driver.
+ *
+ * One read of device/gpu_metrics replaces the separate hwmon temperature,
+ * clock and power files.  The offsets follow the kernel's
+ * gpu_metrics_vX_Y structures (kgd_pp_interface.h, natural alignment):
+ *   - v1.0, v1.1–v1.3 (dGPU; v1.2 and v1.3 only append to v1.1)
+ *   - v2.0, v2.1–v2.4 (APU; same prefix from v2.1 on)
+ *   - v3.0 (APU)
+ * Other revisions (the v1.4+ data-center layouts) are rejected, and the
+ * caller falls back to hwmon.
+ */
+class AmdGpuMetricsDecoder
+{
+public:
+  static constexpr size_t MAX_BYTES = 1024;  ///< Largest supported table is 256 bytes
+
+  [[nodiscard]] static std::optional< AmdGpuMetrics > decode( const uint8_t *data, size_t size )
+  {
+    if ( data == nullptr || size < 4 )
+      return std::nullopt;
+
+    Blob blob{ data, std::min< size_t >( size, u16( data, 0 ) ) };
+    AmdGpuMetrics m;
+    m.formatRevision = data[ 2 ];
+    m.contentRevision = data[ 3 ];
+
+    bool ok = false;
+    if ( m.formatRevision == 1 )
+      ok = decodeV1( blob, m );
+    else if ( m.formatRevision == 2 )
+      ok = decodeV2( blob, m );
+    else if ( m.formatRevision == 3 && m.contentRevision == 0 )
+      ok = decodeV3( blob, m );
+
+    if ( !ok )
+      return std::nullopt;
+    return m;
+  }
+
+  /**
+   * @brief True if @p path is a gpu_metrics file with a supported layout.
+   */
+  [[nodiscard]] static bool probe( const std::string &path ) noexcept
+  {
+    const int fd = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 )
+      return false;
+    uint8_t buf[ MAX_BYTES ];
+    const ssize_t n = pread( fd, buf, sizeof( buf ), 0 );
+    close( fd );
+    try
+    {
+      return n > 0 && decode( buf, static_cast< size_t >( n ) ).has_value();
+    }
+    catch ( ... )
+    {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Highest level of a pp_dpm_* table ("0: 400Mhz\n1: 2200Mhz *\n"), -1 if none.
+   */
+  [[nodiscard]] static double parseDpmMaxMHz( std::string_view table ) noexcept
+  {
+    int64_t maxMHz = -1;
+    for ( size_t pos = table.find( ':' ); pos != std::string_view::npos; pos = table.find( ':', pos + 1 ) )
+    {
+      size_t begin = pos + 1;
+      while ( begin < table.size() && table[ begin ] == ' ' )
+        ++begin;
+      int64_t mhz = 0;
+      const auto res = std::from_chars( table.data() + begin, table.data() + table.size(), mhz );
+      const auto rest = table.substr( static_cast< size_t >( res.ptr - table.data() ) );
+      if ( res.ec == std::errc() && rest.starts_with( "Mhz" ) )
+        maxMHz = std::max( maxMHz, mhz );
+    }
+    return static_cast< double >( maxMHz );
+  }
+
+private:
+  struct Blob
+  {
+    const uint8_t *data;
+    size_t size;  ///< min( bytes read, structure_size )
+
+    [[nodiscard]] bool has( size_t offset, size_t bytes ) const noexcept { return offset + bytes <= size; }
+  };
+
+  static uint16_t u16( const uint8_t *data, size_t offset ) noexcept
+  {
+    uint16_t v;
+    std::memcpy( &v, data + offset, sizeof( v ) );
+    return v;
+  }
+
+  static uint32_t u32( const uint8_t *data, size_t offset ) noexcept
+  {
+    uint32_t v;
+    std::memcpy( &v, data + offset, sizeof( v ) );
+    return v;
+  }
+
+  /// u16 field scaled by @p scale, -1 if absent or 0xFFFF
+  static double field16( const Blob &b, size_t offset, double scale = 1.0 ) noexcept
+  {
+    if ( !b.has( offset, 2 ) )
+      return -1.0;
+    const uint16_t v = u16( b.data, offset );
+    return v == UINT16_MAX ? -1.0 : static_cast< double >( v ) * scale;
+  }
+
+  static double field32( const Blob &b, size_t offset, double scale = 1.0 ) noexcept
+  {
+    if ( !b.has( offset, 4 ) )
+      return -1.0;
+    const uint32_t v = u32( b.data, offset );
+    return v == UINT32_MAX ? -1.0 : static_cast< double >( v ) * scale;
+  }
+
+  static int64_t status32( const Blob &b, size_t offset ) noexcept
+  {
+    if ( !b.has( offset, 4 ) )
+      return -1;
+    const uint32_t v = u32( b.data, offset );
+    return v == UINT32_MAX ? -1 : static_cast< int64_t >( v );
+  }
+
+  static double firstValid( double a, double b ) noexcept { return a > 0.0 ? a : b; }
+
+  static void coreClocks( const Blob &b, size_t offset, size_t count, AmdGpuMetrics &m )
+  {
+    if ( !b.has( offset, count * 2 ) )
+      return;
+    m.cpuCoreClockMHz.resize( count );
+    for ( size_t i = 0; i < count; ++i )
+      m.cpuCoreClockMHz[ i ] = field16( b, offset + i * 2 );
+  }
+
+  /// dGPU tables: temperatures in °C, power in W
+  static bool decodeV1( const Blob &b, AmdGpuMetrics &m )
+  {
+    // v1.0 has the 64-bit timestamp right after the header; v1.1 moved it
+    const bool v10 = m.contentRevision == 0;
+    const size_t temps = v10 ? 16 : 4;
+    const size_t activity = v10 ? 28 : 16;
+    const size_t power = v10 ? 34 : 22;
+    if ( m.contentRevision > 3 || !b.has( 68, 4 ) )
+      return false;
+
+    m.temperatureC = field16( b, temps );
+    m.hotspotC = field16( b, temps + 2 );
+    m.memoryTemperatureC = field16( b, temps + 4 );
+    m.gfxActivityPct = field16( b, activity );
+    m.memActivityPct = field16( b, activity + 2 );
+    m.socketPowerW = field16( b, power );
+    m.gfxClockMHz = firstValid( field16( b, 54 ), field16( b, 40 ) );
+    m.memClockMHz = firstValid( field16( b, 58 ), field16( b, 44 ) );
+    m.throttleStatus = status32( b, 68 );
+    return true;
+  }
+
+  /// APU tables: temperatures in centi-°C, power in mW
+  static bool decodeV2( const Blob &b, AmdGpuMetrics &m )
+  {
+    const bool v20 = m.contentRevision == 0;
+    const size_t base = v20 ? 4 : 0;  // v2.0 has 4 more bytes before the clocks
+    if ( m.contentRevision > 4 || !b.has( 108 + base, 4 ) )
+      return false;
+
+    m.temperatureC = field16( b, v20 ? 16 : 4, 0.01 );
+    m.gfxActivityPct = field16( b, v20 ? 40 : 28 );
+    m.socketPowerW = field16( b, v20 ? 44 : 40, 0.001 );
+    m.gfxClockMHz = firstValid( field16( b, 76 + base ), field16( b, 64 + base ) );
+    coreClocks( b, 88 + base, 8, m );
+    m.throttleStatus = status32( b, 108 + base );
+    return true;
+  }
+
+  static bool decodeV3( const Blob &b, AmdGpuMetrics &m )
+  {
+    if ( !b.has( 224, 0 ) )
+      return false;
+
+    m.temperatureC = field16( b, 4, 0.01 );
+    m.gfxActivityPct = field16( b, 42 );
+    m.socketPowerW = field32( b, 112, 0.001 );
+    m.gfxClockMHz = field16( b, 172 );
+    coreClocks( b, 188, 16, m );
+    m.gfxMaxClockMHz = field16( b, 222 );
+    return true;
+  }
+};
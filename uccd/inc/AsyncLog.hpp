@@ -0,0 +1,440 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <syslog.h>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ucc
+{
+
+/// Where a log line ends up
+enum class LogTarget : uint8_t
+{
+  Syslog,
+  Stdout,
+  Stderr,
+};
+
+/// Tuning of an AsyncLog
+struct AsyncLogOptions
+{
+  size_t ringSlots = 128;  ///< per thread, rounded up to a power of two
+  int64_t rateWindowMs = 10'000;
+  unsigned rateBurst = 5;
+};
+
+/**
+ * @brief Logging that never blocks the posting thread.
+ *
+ * Each posting thread owns a single-producer/single-consumer ring of
+ * fixed-size slots; post() copies the line into the next slot and wakes
+ * the writer thread, which hands it to the sink (syslog, stdout, stderr).
+ * A stalled journald therefore only stalls the writer: once a thread's
+ * ring is full its lines are dropped and counted, and the writer reports
+ * the count when it catches up.  Lines longer than SLOT_TEXT are cut.
+ *
+ * The writer also rate-limits: the same line (target and text) is passed
+ * on at most rateBurst times per rateWindowMs; the rest of the window is
+ * summed up as "<line> (repeated N more times)" once the window ends.
+ *
+ * Lines of one thread keep their order; lines of different threads are
+ * only ordered by when the writer gets to them.
+ */
+class AsyncLog
+{
+public:
+  static constexpr size_t SLOT_TEXT = 496;
+
+  using Sink = std::function< void( LogTarget, int priority, std::string_view text ) >;
+  using Clock = std::function< int64_t() >;
+
+  using Options = AsyncLogOptions;
+
+  explicit AsyncLog( Sink sink, Options options = {}, Clock clock = steadyMs )
+    : m_sink( std::move( sink ) ),
+      m_options( options ),
+      m_clock( std::move( clock ) ),
+      m_id( s_nextId.fetch_add( 1 ) )
+  {
+    m_options.ringSlots = std::bit_ceil( std::max< size_t >( m_options.ringSlots, 2 ) );
+    m_writer = std::thread( [this] { writerLoop(); } );
+  }
+
+  ~AsyncLog()
+  {
+    m_stop.store( true );
+    m_pending.store( true );
+    m_pending.notify_one();
+    if ( m_writer.joinable() )
+      m_writer.join();
+
+    std::lock_guard< std::mutex > drainLock( m_drainMutex );
+    drainLocked();
+    flushSummariesLocked( true );
+    std::lock_guard< std::mutex > lock( m_ringsMutex );
+    for ( const auto &ring : m_rings )
+      ring->closed.store( true );
+  }
+
+  AsyncLog( const AsyncLog & ) = delete;
+  AsyncLog &operator=( const AsyncLog & ) = delete;
+
+  /// The daemon's log, writing to syslog, stdout and stderr
+  static AsyncLog &instance()
+  {
+    static AsyncLog log( defaultSink );
+    return log;
+  }
+
+  /**
+   * @brief Queue @p text for the writer.
+   * @return false if the line was dropped because this thread's ring is full
+   */
+  bool post( LogTarget target, int priority, std::string_view text ) noexcept
+  {
+    Ring *ring = localRing();
+    if ( ring == nullptr )
+      return false;
+
+    const uint64_t head = ring->head.load( std::memory_order_relaxed );
+    if ( head - ring->tail.load( std::memory_order_acquire ) >= ring->buffer.size() )
+    {
+      ring->dropped.fetch_add( 1, std::memory_order_relaxed );
+      return false;
+    }
+
+    Slot &slot = ring->buffer[ head & ( ring->buffer.size() - 1 ) ];
+    slot.target = target;
+    slot.priority = priority;
+    slot.length = static_cast< uint32_t >( std::min( text.size(), SLOT_TEXT ) );
+    std::memcpy( slot.text, text.data(), slot.length );
+    ring->head.store( head + 1, std::memory_order_release );
+
+    if ( not m_pending.exchange( true, std::memory_order_acq_rel ) )
+      m_pending.notify_one();
+    return true;
+  }
+
+  /// Hand everything queued so far to the sink (blocks on the sink)
+  void flush()
+  {
+    std::lock_guard< std::mutex > lock( m_drainMutex );
+    drainLocked();
+  }
+
+  static int64_t steadyMs()
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+private:
+  struct Slot
+  {
+    LogTarget target = LogTarget::Syslog;
+    int priority = LOG_INFO;
+    uint32_t length = 0;
+    char text[ SLOT_TEXT ];
+  };
+
+  struct Ring
+  {
+    explicit Ring( size_t n ) : buffer( n ) {}
+
+    std::vector< Slot > buffer;
+    alignas( 64 ) std::atomic< uint64_t > head{ 0 };  ///< written by the owning thread
+    alignas( 64 ) std::atomic< uint64_t > tail{ 0 };  ///< written by the drainer
+    std::atomic< uint64_t > dropped{ 0 };
+    std::atomic< bool > orphaned{ false };  ///< owning thread has exited
+    std::atomic< bool > closed{ false };    ///< log has been destroyed
+  };
+
+  /// Rings of the calling thread, one per log; marks them orphaned on thread exit
+  struct ThreadRings
+  {
+    std::vector< std::pair< uint64_t, std::shared_ptr< Ring > > > rings;
+
+    ~ThreadRings()
+    {
+      for ( const auto &entry : rings )
+        entry.second->orphaned.store( true );
+    }
+  };
+
+  struct RateEntry
+  {
+    int64_t windowStartMs = 0;
+    unsigned count = 0;
+    uint64_t suppressed = 0;
+    LogTarget target = LogTarget::Syslog;
+    int priority = LOG_INFO;
+  };
+
+  static constexpr size_t MAX_RATE_ENTRIES = 256;
+
+  Ring *localRing() noexcept
+  {
+    thread_local ThreadRings local;
+    for ( const auto &entry : local.rings )
+      if ( entry.first == m_id )
+        return entry.second.get();
+
+    // first line of this thread: the only time a poster takes a lock
+    try
+    {
+      std::erase_if( local.rings, []( const auto &entry ) { return entry.second->closed.load(); } );
+      auto ring = std::make_shared< Ring >( m_options.ringSlots );
+      {
+        std::lock_guard< std::mutex > lock( m_ringsMutex );
+        m_rings.push_back( ring );
+      }
+      local.rings.emplace_back( m_id, ring );
+      return ring.get();
+    }
+    catch ( ... )
+    {
+      return nullptr;
+    }
+  }
+
+  void writerLoop()
+  {
+    while ( not m_stop.load() )
+    {
+      if ( m_summariesDue.load() )
+      {
+        // repeat summaries are waiting for their window to end
+        std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+      }
+      else
+      {
+        m_pending.wait( false, std::memory_order_acquire );
+      }
+      // pairs with the exchange in post(): everything posted before is visible
+      m_pending.exchange( false, std::memory_order_acq_rel );
+
+      std::lock_guard< std::mutex > lock( m_drainMutex );
+      drainLocked();
+    }
+  }
+
+  void drainLocked()
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_ringsMutex );
+      m_snapshot.assign( m_rings.begin(), m_rings.end() );
+    }
+
+    uint64_t dropped = 0;
+    Slot slot;
+    for ( const auto &ring : m_snapshot )
+    {
+      uint64_t tail = ring->tail.load( std::memory_order_relaxed );
+      while ( tail != ring->head.load( std::memory_order_acquire ) )
+      {
+        const Slot &queued = ring->buffer[ tail & ( ring->buffer.size() - 1 ) ];
+        slot.target = queued.target;
+        slot.priority = queued.priority;
+        slot.length = queued.length;
+        std::memcpy( slot.text, queued.text, queued.length );
+        // free the slot before the (possibly slow) sink
+        ring->tail.store( ++tail, std::memory_order_release );
+        emitLimited( slot.target, slot.priority, std::string_view( slot.text, slot.length ) );
+      }
+      dropped += ring->dropped.exchange( 0, std::memory_order_relaxed );
+    }
+    m_snapshot.clear();
+
+    if ( dropped > 0 )
+    {
+      const std::string line = "[AsyncLog] Dropped " + std::to_string( dropped ) + " log messages (queue full)";
+      emit( LogTarget::Syslog, LOG_WARNING, line );
+    }
+    flushSummariesLocked( false );
+
+    std::lock_guard< std::mutex > lock( m_ringsMutex );
+    std::erase_if( m_rings, []( const auto &ring ) {
+      return ring->orphaned.load() and ring->tail.load() == ring->head.load();
+    } );
+  }
+
+  void emitLimited( LogTarget target, int priority, std::string_view text )
+  {
+    const int64_t now = m_clock();
+    std::string key;
+    key.reserve( text.size() + 1 );
+    key.push_back( static_cast< char >( target ) );
+    key.append( text );
+
+    auto it = m_rate.find( key );
+    if ( it == m_rate.end() )
+    {
+      if ( m_rate.size() >= MAX_RATE_ENTRIES )
+      {
+        flushSummariesLocked( true );
+        m_rate.clear();
+      }
+      m_rate.emplace( std::move( key ), RateEntry{ now, 1, 0, target, priority } );
+      emit( target, priority, text );
+      return;
+    }
+
+    RateEntry &entry = it->second;
+    if ( now - entry.windowStartMs >= m_options.rateWindowMs )
+    {
+      summarize( it->first, entry );
+      entry = RateEntry{ now, 0, 0, target, priority };
+    }
+    if ( ++entry.count <= m_options.rateBurst )
+    {
+      emit( target, priority, text );
+      return;
+    }
+    ++entry.suppressed;
+    m_summariesDue.store( true );
+  }
+
+  /// Summarize the windows that ended (all of them if @p all) and forget quiet lines
+  void flushSummariesLocked( bool all )
+  {
+    const int64_t now = m_clock();
+    bool due = false;
+    for ( auto it = m_rate.begin(); it != m_rate.end(); )
+    {
+      RateEntry &entry = it->second;
+      if ( all or now - entry.windowStartMs >= m_options.rateWindowMs )
+      {
+        summarize( it->first, entry );
+        it = m_rate.erase( it );
+        continue;
+      }
+      due = due or entry.suppressed > 0;
+      ++it;
+    }
+    m_summariesDue.store( due );
+  }
+
+  void summarize( const std::string &key, RateEntry &entry )
+  {
+    if ( entry.suppressed == 0 )
+      return;
+    const std::string line = key.substr( 1 ) + " (repeated " + std::to_string( entry.suppressed ) + " more times)";
+    entry.suppressed = 0;
+    emit( entry.target, entry.priority, line );
+  }
+
+  void emit( LogTarget target, int priority, std::string_view text )
+  {
+    try
+    {
+      m_sink( target, priority, text );
+    }
+    catch ( ... )
+    {
+    }
+  }
+
+  static void defaultSink( LogTarget target, int priority, std::string_view text )
+  {
+    switch ( target )
+    {
+      case LogTarget::Syslog:
+        syslog( priority, "%.*s", static_cast< int >( text.size() ), text.data() );
+        break;
+      case LogTarget::Stdout:
+        std::cout << text << std::endl;
+        break;
+      case LogTarget::Stderr:
+        std::cerr << text << std::endl;
+        break;
+    }
+  }
+
+  inline static std::atomic< uint64_t > s_nextId{ 1 };
+
+  Sink m_sink;
+  Options m_options;
+  Clock m_clock;
+  const uint64_t m_id;
+
+  std::mutex m_ringsMutex;
+  std::vector< std::shared_ptr< Ring > > m_rings;
+
+  std::mutex m_drainMutex;  ///< one drainer at a time; guards the members below
+  std::vector< std::shared_ptr< Ring > > m_snapshot;
+  std::unordered_map< std::string, RateEntry > m_rate;
+
+  std::atomic< bool > m_pending{ false };
+  std::atomic< bool > m_summariesDue{ false };
+  std::atomic< bool > m_stop{ false };
+  std::thread m_writer;
+};
+
+/// Queue a syslog line
+inline bool asyncLog( int priority, std::string_view text ) noexcept
+{
+  return AsyncLog::instance().post( LogTarget::Syslog, priority, text );
+}
+
+/// Queue a printf-formatted syslog line
+template< typename... Args >
+inline bool asyncLogf( int priority, const char *fmt, Args &&...args ) noexcept
+{
+  char buf[ AsyncLog::SLOT_TEXT + 1 ];
+#if defined( __GNUC__ )
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+#endif
+  const int n = std::snprintf( buf, sizeof( buf ), fmt, std::forward< Args >( args )... );
+#if defined( __GNUC__ )
+#pragma GCC diagnostic pop
+#endif
+  if ( n < 0 )
+    return false;
+  return asyncLog( priority, std::string_view( buf, std::min( static_cast< size_t >( n ), AsyncLog::SLOT_TEXT ) ) );
+}
+
+/// Queue a line for stdout
+inline bool asyncOut( std::string_view line ) noexcept
+{
+  return AsyncLog::instance().post( LogTarget::Stdout, LOG_INFO, line );
+}
+
+/// Queue a line for stderr
+inline bool asyncErr( std::string_view line ) noexcept
+{
+  return AsyncLog::instance().post( LogTarget::Stderr, LOG_ERR, line );
+}
+
+}
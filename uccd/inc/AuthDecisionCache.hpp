@@ -0,0 +1,90 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+
+/**
+ * @brief Positive Polkit decisions per D-Bus caller.
+ *
+ * A decision is keyed by the sender's unique bus name, the start time of
+ * its process and the action ID, and holds for TTL_MS.  Unique names are
+ * never reused while the bus runs, and the start time tells a recycled PID
+ * apart, so a hit always refers to the process Polkit approved.  Denials
+ * are not cached: a user who just authenticated must not be refused.
+ *
+ * The PID of each sender is kept as well, saving the bus daemon round trip
+ * on later calls.  Drop a sender with forgetSender() once it leaves the
+ * bus.  Not thread-safe; used from the D-Bus (main) thread only.
+ */
+class AuthDecisionCache
+{
+public:
+  static constexpr int64_t TTL_MS = 30000;
+
+  /// True if @p action was granted to this sender and process within TTL_MS
+  [[nodiscard]] bool allowed( const std::string &sender, uint64_t startTime,
+                              const std::string &action, int64_t nowMs )
+  {
+    const auto it = m_grants.find( Key{ sender, startTime, action } );
+    if ( it == m_grants.end() )
+      return false;
+    if ( nowMs - it->second >= TTL_MS || nowMs < it->second )
+    {
+      m_grants.erase( it );
+      return false;
+    }
+    return true;
+  }
+
+  void grant( const std::string &sender, uint64_t startTime, const std::string &action, int64_t nowMs )
+  {
+    m_grants[ Key{ sender, startTime, action } ] = nowMs;
+  }
+
+  [[nodiscard]] std::optional< uint32_t > pid( const std::string &sender ) const
+  {
+    const auto it = m_pids.find( sender );
+    if ( it == m_pids.end() )
+      return std::nullopt;
+    return it->second;
+  }
+
+  void setPid( const std::string &sender, uint32_t pid ) { m_pids[ sender ] = pid; }
+
+  [[nodiscard]] bool knowsSender( const std::string &sender ) const { return m_pids.count( sender ) > 0; }
+
+  /// Drop the PID and every decision of @p sender
+  void forgetSender( const std::string &sender )
+  {
+    m_pids.erase( sender );
+    for ( auto it = m_grants.lower_bound( Key{ sender, 0, std::string() } );
+          it != m_grants.end() && std::get< 0 >( it->first ) == sender; )
+      it = m_grants.erase( it );
+  }
+
+  [[nodiscard]] size_t grants() const noexcept { return m_grants.size(); }
+
+private:
+  using Key = std::tuple< std::string, uint64_t, std::string >;
+
+  std::map< Key, int64_t > m_grants;  ///< → time granted, ms
+  std::map< std::string, uint32_t > m_pids;
+};
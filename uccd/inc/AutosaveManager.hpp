@@ -21,6 +21,7 @@
 #include <sstream>
 #include <iostream>
 #include <sys/stat.h>
+#include "PersistQueue.hpp"
 
 /**
  * @brief Autosave data structure
@@ -105,32 +106,15 @@ public:
       // Serialize to JSON
       std::string json = autosaveToJSON( autosave );
 
-      // Write to temporary file first for atomic operation
-      std::string tempPath = m_autosavePath + ".tmp";
-      std::ofstream file( tempPath, std::ios::trunc );
-      if ( !file.is_open() )
+      // Write to temporary file, fsync, then atomically rename; the
+      // permissions are set on the temporary file, so there is no race
+      std::string error;
+      if ( !writeFileDurably( m_autosavePath, json, m_autosaveFileMod, &error ) )
       {
+        std::cerr << "[Autosave] Failed to write autosave: " << error << std::endl;
         return false;
       }
 
-      file << json;
-      file.close();
-
-      // Atomic rename (POSIX guarantees this is atomic)
-      try
-      {
-        std::filesystem::rename( tempPath, m_autosavePath );
-      }
-      catch ( const std::exception &e )
-      {
-        std::filesystem::remove( tempPath );
-        std::cerr << "[Autosave] Failed to rename temp file: " << e.what() << std::endl;
-        return false;
-      }
-
-      // Set file permissions after atomic write to prevent race
-      chmod( m_autosavePath.c_str(), m_autosaveFileMod );
-
       return true;
     }
     catch ( const std::exception &e )
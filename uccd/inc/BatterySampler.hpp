@@ -0,0 +1,179 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "PowerSupplyController.hpp"
+#include "SensorPoller.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+
+/**
+ * @brief One sample of the battery; values are -1.0 where unknown.
+ */
+struct BatteryMetrics
+{
+  double powerW = -1.0;          ///< Charge or discharge rate, always positive
+  double voltageV = -1.0;
+  double energyWh = -1.0;        ///< Energy left
+  double capacityPct = -1.0;
+  double timeToEmptyMin = -1.0;  ///< Only while discharging
+  double systemPowerW = -1.0;    ///< Whole-system draw: the discharge rate while on battery
+  bool discharging = false;
+};
+
+/**
+ * @brief Charge, discharge rate and energy of the first battery.
+ *
+ * The battery is resolved once by discover() and its power_supply
+ * attributes are registered with the shared SensorPoller, so sample()
+ * must run after its refresh().  Drivers report either power_now and
+ * energy_now (µW, µWh) or current_now and charge_now (µA, µAh); the
+ * latter are converted with voltage_now (µV).
+ *
+ * Not thread-safe; owned by the polling worker.
+ */
+class BatterySampler
+{
+public:
+  /// Raw attribute values in the kernel's units, nullopt where absent
+  struct Readings
+  {
+    std::optional< int64_t > powerNow;
+    std::optional< int64_t > currentNow;
+    std::optional< int64_t > voltageNow;
+    std::optional< int64_t > energyNow;
+    std::optional< int64_t > chargeNow;
+    std::optional< int64_t > capacity;
+    bool discharging = false;
+  };
+
+  explicit BatterySampler( std::shared_ptr< SensorPoller > poller ) : m_poller( std::move( poller ) ) {}
+
+  /**
+   * @brief Resolve the first battery under @p root and register its nodes
+   * @return false if there is no battery
+   */
+  bool discover( const std::string &root = ucc::sysfsPath( PowerSupplyController::POWER_SUPPLY_ROOT ) )
+  {
+    m_nodes = Nodes();
+    m_name.clear();
+
+    const auto batteries = PowerSupplyController::getPowerSupplies( PowerSupplyType::Battery, root );
+    if ( batteries.empty() )
+      return false;
+
+    const std::string base = batteries.front().getBasePath();
+    const auto node = [ & ]( const char *attribute ) {
+      std::error_code ec;
+      const std::string path = base + "/" + attribute;
+      return std::filesystem::exists( path, ec ) ? m_poller->add( path ) : SensorPoller::INVALID_HANDLE;
+    };
+    m_nodes.powerNow = node( "power_now" );
+    m_nodes.currentNow = node( "current_now" );
+    m_nodes.voltageNow = node( "voltage_now" );
+    m_nodes.energyNow = node( "energy_now" );
+    m_nodes.chargeNow = node( "charge_now" );
+    m_nodes.capacity = node( "capacity" );
+    m_nodes.status = node( "status" );
+    m_name = batteries.front().getName();
+    return true;
+  }
+
+  [[nodiscard]] bool available() const noexcept { return not m_name.empty(); }
+
+  /// e.g. "BAT0"; empty before a successful discover()
+  [[nodiscard]] const std::string &name() const noexcept { return m_name; }
+
+  /**
+   * @brief Convert raw readings; a sign on the rate (some drivers report
+   *        discharge as negative) is dropped, the status decides direction.
+   */
+  [[nodiscard]] static BatteryMetrics compute( const Readings &r ) noexcept
+  {
+    BatteryMetrics m;
+    m.discharging = r.discharging;
+
+    if ( r.voltageNow and *r.voltageNow > 0 )
+      m.voltageV = static_cast< double >( *r.voltageNow ) / 1e6;
+
+    if ( r.powerNow )
+      m.powerW = static_cast< double >( std::llabs( *r.powerNow ) ) / 1e6;
+    else if ( r.currentNow and m.voltageV > 0.0 )
+      m.powerW = static_cast< double >( std::llabs( *r.currentNow ) ) / 1e6 * m.voltageV;
+
+    if ( r.energyNow and *r.energyNow >= 0 )
+      m.energyWh = static_cast< double >( *r.energyNow ) / 1e6;
+    else if ( r.chargeNow and *r.chargeNow >= 0 and m.voltageV > 0.0 )
+      m.energyWh = static_cast< double >( *r.chargeNow ) / 1e6 * m.voltageV;
+
+    if ( r.capacity and *r.capacity >= 0 )
+      m.capacityPct = static_cast< double >( *r.capacity );
+
+    if ( m.discharging and m.powerW >= 0.0 )
+    {
+      m.systemPowerW = m.powerW;
+      if ( m.powerW > 0.0 and m.energyWh >= 0.0 )
+        m.timeToEmptyMin = m.energyWh / m.powerW * 60.0;
+    }
+    return m;
+  }
+
+  /**
+   * @brief Take one sample from the poller's last snapshot
+   */
+  [[nodiscard]] BatteryMetrics sample() const
+  {
+    if ( not available() )
+      return BatteryMetrics();
+
+    const auto read = [ this ]( SensorPoller::Handle handle ) -> std::optional< int64_t > {
+      if ( handle == SensorPoller::INVALID_HANDLE )
+        return std::nullopt;
+      return m_poller->readInt( handle );
+    };
+    Readings r;
+    r.powerNow = read( m_nodes.powerNow );
+    r.currentNow = read( m_nodes.currentNow );
+    r.voltageNow = read( m_nodes.voltageNow );
+    r.energyNow = read( m_nodes.energyNow );
+    r.chargeNow = read( m_nodes.chargeNow );
+    r.capacity = read( m_nodes.capacity );
+    if ( m_nodes.status != SensorPoller::INVALID_HANDLE )
+      r.discharging = m_poller->readString( m_nodes.status ).value_or( "" ) == "Discharging";
+    return compute( r );
+  }
+
+private:
+  struct Nodes
+  {
+    SensorPoller::Handle powerNow = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle currentNow = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle voltageNow = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle energyNow = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle chargeNow = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle capacity = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle status = SensorPoller::INVALID_HANDLE;
+  };
+
+  std::shared_ptr< SensorPoller > m_poller;
+  Nodes m_nodes;
+  std::string m_name;
+};
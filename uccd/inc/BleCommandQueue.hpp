@@ -0,0 +1,165 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief What a queued BLE command controls, highest priority first.
+ *
+ * Reset and pump commands keep the loop safe and go out ahead of fan
+ * changes; LED colours are cosmetic and go last.
+ */
+enum class BleCommandKind
+{
+  Reset,
+  Pump,
+  Fan,
+  Other,
+  Led
+};
+
+/// How a queued command ended
+enum class BleCommandOutcome
+{
+  Written,    ///< handed to the UART characteristic
+  Superseded, ///< replaced by a newer command of the same kind before it went out
+  Dropped     ///< discarded, e.g. because the link went down
+};
+
+/**
+ * @brief Pending BLE commands, one slot per kind.
+ *
+ * Pump, fan and LED commands set a state, so only the newest of each
+ * kind is kept: a burst of fan updates while the link is throttled
+ * collapses into one write.  Resets and unknown commands keep their
+ * order and are never merged.
+ *
+ * Every push gets a ticket, and the completion handler learns how each
+ * ticket ended.  Not thread safe; the owner drives it from one thread.
+ */
+template< typename Payload >
+class BleCommandQueue
+{
+public:
+  struct Command
+  {
+    BleCommandKind kind = BleCommandKind::Other;
+    Payload data{};
+    uint64_t ticket = 0;
+    std::chrono::steady_clock::time_point queuedAt{};
+  };
+
+  using CompletionHandler = std::function< void( const Command &, BleCommandOutcome ) >;
+
+  void setCompletionHandler( CompletionHandler handler ) { m_onComplete = std::move( handler ); }
+
+  /// Queue @p data; returns its ticket
+  uint64_t push( BleCommandKind kind, Payload data )
+  {
+    Command command{ kind, std::move( data ), ++m_lastTicket, std::chrono::steady_clock::now() };
+    auto &slot = m_slots[ static_cast< size_t >( kind ) ];
+
+    if ( not coalesces( kind ) )
+      slot.push_back( std::move( command ) );
+    else if ( slot.empty() )
+      slot.push_back( std::move( command ) );
+    else
+    {
+      Command old = std::exchange( slot.front(), std::move( command ) );
+      ++m_coalesced;
+      finish( old, BleCommandOutcome::Superseded );
+    }
+    return m_lastTicket;
+  }
+
+  /// Take the most urgent command, to be written now
+  std::optional< Command > pop()
+  {
+    for ( auto &slot : m_slots )
+    {
+      if ( slot.empty() )
+        continue;
+      Command command = std::move( slot.front() );
+      slot.pop_front();
+      return command;
+    }
+    return std::nullopt;
+  }
+
+  /// Report @p command, taken with pop(), as written
+  void written( const Command &command )
+  {
+    ++m_written;
+    finish( command, BleCommandOutcome::Written );
+  }
+
+  /// Drop everything still pending
+  void clear()
+  {
+    while ( auto command = pop() )
+    {
+      ++m_dropped;
+      finish( *command, BleCommandOutcome::Dropped );
+    }
+  }
+
+  [[nodiscard]] bool empty() const noexcept
+  {
+    for ( const auto &slot : m_slots )
+      if ( not slot.empty() )
+        return false;
+    return true;
+  }
+
+  [[nodiscard]] size_t size() const noexcept
+  {
+    size_t count = 0;
+    for ( const auto &slot : m_slots )
+      count += slot.size();
+    return count;
+  }
+
+  [[nodiscard]] uint64_t writtenCount() const noexcept { return m_written; }
+  [[nodiscard]] uint64_t coalescedCount() const noexcept { return m_coalesced; }
+  [[nodiscard]] uint64_t droppedCount() const noexcept { return m_dropped; }
+
+  [[nodiscard]] static constexpr bool coalesces( BleCommandKind kind ) noexcept
+  {
+    return kind == BleCommandKind::Pump or kind == BleCommandKind::Fan or kind == BleCommandKind::Led;
+  }
+
+private:
+  void finish( const Command &command, BleCommandOutcome outcome )
+  {
+    if ( m_onComplete )
+      m_onComplete( command, outcome );
+  }
+
+  std::array< std::deque< Command >, static_cast< size_t >( BleCommandKind::Led ) + 1 > m_slots;
+  CompletionHandler m_onComplete;
+  uint64_t m_lastTicket = 0;
+  uint64_t m_written = 0;
+  uint64_t m_coalesced = 0;
+  uint64_t m_dropped = 0;
+};
@@ -0,0 +1,89 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief Linear fade between two raw backlight values in fixed steps.
+ *
+ * The owner calls step() once per STEP; the value follows the wall clock,
+ * so a late call skips ahead instead of stretching the fade, and steps
+ * that round to the value already written are not returned.  A new
+ * start() retargets from wherever the running fade is.
+ */
+class BrightnessRamp
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// One step per display frame at 60 Hz
+  static constexpr std::chrono::milliseconds STEP{ 16 };
+
+  /// Fade from @p from to @p to over @p duration; a zero duration jumps
+  void start( int from, int to, std::chrono::milliseconds duration, Clock::time_point now ) noexcept
+  {
+    m_from = from;
+    m_to = to;
+    m_last = from;
+    m_start = now;
+    m_steps = std::max< int64_t >( 1, duration / STEP );
+    m_active = true;
+  }
+
+  /**
+   * @brief The value to write now
+   * @return nullopt if it equals the last one returned; the final value
+   *         ends the fade
+   */
+  [[nodiscard]] std::optional< int > step( Clock::time_point now ) noexcept
+  {
+    if ( not m_active )
+      return std::nullopt;
+
+    const int64_t done = std::clamp< int64_t >( ( now - m_start ) / STEP + 1, 1, m_steps );
+    const int value = done == m_steps
+                        ? m_to
+                        : m_from + static_cast< int >( std::lround( static_cast< double >( m_to - m_from ) * done / m_steps ) );
+    if ( done == m_steps )
+      m_active = false;
+    if ( value == m_last )
+      return std::nullopt;
+    m_last = value;
+    return value;
+  }
+
+  void cancel() noexcept { m_active = false; }
+
+  [[nodiscard]] bool active() const noexcept { return m_active; }
+
+  /// The value last returned by step(), or the start value
+  [[nodiscard]] int current() const noexcept { return m_last; }
+
+  [[nodiscard]] int target() const noexcept { return m_to; }
+
+private:
+  Clock::time_point m_start{};
+  int64_t m_steps = 1;
+  int m_from = 0;
+  int m_to = 0;
+  int m_last = 0;
+  bool m_active = false;
+};
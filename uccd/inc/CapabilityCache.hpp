@@ -0,0 +1,177 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "PersistQueue.hpp"
+#include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+
+/// What a capability profile belongs to; any change means probe again
+struct CapabilityIdentity
+{
+  std::string dmi;            ///< vendor, board, SKU
+  std::string moduleVersion;  ///< tuxedo_io
+  std::string biosVersion;    ///< version and date
+
+  bool operator==( const CapabilityIdentity & ) const = default;
+
+  /// DMI and BIOS from sysfs, with the module version the caller read from tuxedo_io
+  static CapabilityIdentity read( std::string moduleVersion )
+  {
+    const std::string dmiBase = ucc::sysfsPath( "/sys/class/dmi/id" );
+    const auto field = [&dmiBase]( const char *name ) {
+      return SysfsNode< std::string >( dmiBase + "/" + name ).read().value_or( "" );
+    };
+    return { field( "sys_vendor" ) + "/" + field( "board_name" ) + "/" + field( "product_sku" ),
+             std::move( moduleVersion ),
+             field( "bios_version" ) + "/" + field( "bios_date" ) };
+  }
+};
+
+/**
+ * @brief Hardware facts kept across daemon restarts.
+ *
+ * System info, keyboard backlight capabilities, TDP limits, fan limits and
+ * the ODM profile list never change on a given machine, yet every start
+ * probed them again.  They are stored under the DMI data, the tuxedo_io
+ * module version and the BIOS version: open() loads them synchronously and
+ * the daemon answers with them before touching the hardware; the probes
+ * that still run, or a later background pass, revalidate() each fact and
+ * flush() writes the profile once something changed.
+ *
+ * Values are opaque single-line strings, encoded by their owners.
+ *
+ * File format: "ucc-capabilities 1", "dmi\t<dmi>", "module\t<version>",
+ * "bios\t<version>", then one "<name>\t<value>" line per fact.
+ *
+ * Thread-safe: startup, the workers and the service tick revalidate.
+ */
+class CapabilityCache
+{
+public:
+  static constexpr const char *DEFAULT_PATH = "/var/cache/ucc/capabilities";
+
+  explicit CapabilityCache( std::string cachePath = DEFAULT_PATH ) : m_cachePath( std::move( cachePath ) ) {}
+
+  /**
+   * @brief Load the stored profile of @p identity
+   * @return true if there is one; otherwise every fact is probed afresh
+   */
+  bool open( const CapabilityIdentity &identity )
+  {
+    std::lock_guard lock( m_mutex );
+    m_identity = identity;
+    m_facts.clear();
+    m_dirty = false;
+    m_hit = load( identity );
+    return m_hit;
+  }
+
+  /// The stored value of @p name, if open() found the profile
+  [[nodiscard]] std::optional< std::string > find( const std::string &name ) const
+  {
+    std::lock_guard lock( m_mutex );
+    if ( !m_hit )
+      return std::nullopt;
+    const auto it = m_facts.find( name );
+    if ( it == m_facts.end() )
+      return std::nullopt;
+    return it->second;
+  }
+
+  /**
+   * @brief Record what a probe found for @p name
+   * @return true if it differs from the stored value (or there was none);
+   *         values with tabs or newlines are not cached
+   */
+  bool revalidate( const std::string &name, const std::string &value )
+  {
+    if ( !storable( name ) || !storable( value ) )
+      return true;
+    std::lock_guard lock( m_mutex );
+    auto [ it, inserted ] = m_facts.try_emplace( name, value );
+    if ( !inserted && it->second == value )
+      return false;
+    it->second = value;
+    m_dirty = true;
+    return true;
+  }
+
+  /// Write the profile if a fact changed since open() or the last flush()
+  void flush()
+  {
+    std::lock_guard lock( m_mutex );
+    if ( !m_dirty )
+      return;
+    m_dirty = false;
+    save();
+  }
+
+private:
+  static constexpr const char *MAGIC = "ucc-capabilities 1";
+
+  static bool storable( const std::string &field ) { return field.find_first_of( "\t\n" ) == std::string::npos; }
+
+  /// A damaged file or one of another identity is ignored and rewritten on flush()
+  bool load( const CapabilityIdentity &identity )
+  {
+    std::ifstream in( m_cachePath );
+    std::string line;
+    const auto header = [&in, &line]( const char *prefix, const std::string &expected ) {
+      return std::getline( in, line ) && line == prefix + expected;
+    };
+    if ( !std::getline( in, line ) || line != MAGIC || !header( "dmi\t", identity.dmi )
+         || !header( "module\t", identity.moduleVersion ) || !header( "bios\t", identity.biosVersion ) )
+      return false;
+
+    std::map< std::string, std::string > facts;
+    while ( std::getline( in, line ) )
+    {
+      const auto tab = line.find( '\t' );
+      if ( tab == std::string::npos || tab == 0 )
+        return false;
+      facts[ line.substr( 0, tab ) ] = line.substr( tab + 1 );
+    }
+    m_facts = std::move( facts );
+    return true;
+  }
+
+  void save() const
+  {
+    if ( !storable( m_identity.dmi ) || !storable( m_identity.moduleVersion ) || !storable( m_identity.biosVersion ) )
+      return;
+    std::string content = std::string( MAGIC ) + "\ndmi\t" + m_identity.dmi + "\nmodule\t" + m_identity.moduleVersion
+                          + "\nbios\t" + m_identity.biosVersion + '\n';
+    for ( const auto &[ name, value ] : m_facts )
+      content += name + '\t' + value + '\n';
+    // best effort: a profile that cannot be written only costs the next start its head start
+    (void)writeFileDurably( m_cachePath, content, 0644 );
+  }
+
+  const std::string m_cachePath;
+  mutable std::mutex m_mutex;
+  CapabilityIdentity m_identity;
+  std::map< std::string, std::string > m_facts;
+  bool m_hit = false;
+  bool m_dirty = false;
+};
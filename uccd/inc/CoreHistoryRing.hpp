@@ -0,0 +1,180 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Dense ring of per-core rows (frequency and busy time of every CPU).
+ *
+ * One row holds a timestamp and a fixed-width column per core, stored
+ * compactly: frequency as uint16_t MHz (0 = unknown) and busy time as
+ * uint8_t percent (NO_BUSY = unknown), so 16 cores over CAPACITY rows cost
+ * about 0.4 MiB.  The core list is set with setLayout(); a different list
+ * (CPU hotplug) drops the history.
+ *
+ * Heap only.  Writer and readers share one spin flag like MetricEventRing;
+ * samples arrive at most once per worker cycle.
+ */
+class CoreHistoryRing
+{
+public:
+  static constexpr size_t CAPACITY = 7200;  ///< 96 min at the 800 ms worker cycle
+  static constexpr uint8_t NO_BUSY = 0xFF;
+
+  /**
+   * @brief Set the logical CPU numbers and core types of the columns.
+   *
+   * Allocates; keeps the rows if nothing changed.
+   */
+  void setLayout( const std::vector< int32_t > &cpus, const std::vector< uint8_t > &types )
+  {
+    lock();
+    if ( cpus != m_cpus || types != m_types )
+    {
+      m_cpus = cpus;
+      m_types = types;
+      m_types.resize( m_cpus.size(), 0 );
+      m_ts.assign( CAPACITY, 0 );
+      m_freq.assign( CAPACITY * m_cpus.size(), 0 );
+      m_busy.assign( CAPACITY * m_cpus.size(), NO_BUSY );
+      m_written = 0;
+    }
+    unlock();
+  }
+
+  [[nodiscard]] size_t coreCount() const noexcept
+  {
+    lock();
+    const size_t n = m_cpus.size();
+    unlock();
+    return n;
+  }
+
+  /**
+   * @brief Append one row; both spans hold one value per core (-1 = unknown).
+   *
+   * Rows whose width does not match the layout are dropped.
+   */
+  void push( int64_t timestampMs, const std::vector< double > &freqMHz,
+             const std::vector< double > &busyPct ) noexcept
+  {
+    lock();
+    const size_t n = m_cpus.size();
+    if ( n > 0 && freqMHz.size() == n && busyPct.size() == n )
+    {
+      const size_t slot = static_cast< size_t >( m_written % CAPACITY );
+      m_ts[ slot ] = timestampMs;
+      for ( size_t c = 0; c < n; ++c )
+      {
+        const double f = freqMHz[ c ];
+        const double b = busyPct[ c ];
+        m_freq[ slot * n + c ] = f > 0.0 ? static_cast< uint16_t >( std::min( std::lround( f ), 65535L ) ) : 0;
+        m_busy[ slot * n + c ] = b >= 0.0 ? static_cast< uint8_t >( std::min( std::lround( b ), 100L ) ) : NO_BUSY;
+      }
+      ++m_written;
+    }
+    unlock();
+  }
+
+  /**
+   * @brief Rows with timestamps >= @p sinceMs as a binary blob.
+   *
+   * Wire layout (native endian — same-host IPC only):
+   * @code
+   *   uint32_t coreCount
+   *   uint32_t rowCount
+   *   coreCount × { int32_t cpu, uint8_t type }                       (5 bytes each)
+   *   rowCount × { int64_t timestampMs, coreCount × uint16_t freqMHz,
+   *                coreCount × uint8_t busyPct }
+   * @endcode
+   *
+   * type is CpuCoreType (0 unknown, 1 performance, 2 efficiency).  Empty
+   * when no layout has been set.
+   */
+  void copySinceBinary( int64_t sinceMs, std::vector< uint8_t > &out ) const
+  {
+    lock();
+    const size_t n = m_cpus.size();
+    if ( n == 0 )
+    {
+      unlock();
+      return;
+    }
+
+    const uint64_t first = m_written > CAPACITY ? m_written - CAPACITY : 0;
+    uint64_t lo = first;
+    uint64_t hi = m_written;
+    while ( lo < hi )
+    {
+      const uint64_t mid = lo + ( hi - lo ) / 2;
+      if ( m_ts[ static_cast< size_t >( mid % CAPACITY ) ] < sinceMs )
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+    const uint32_t cores = static_cast< uint32_t >( n );
+    const uint32_t rows = static_cast< uint32_t >( m_written - lo );
+    const size_t rowBytes = sizeof( int64_t ) + n * ( sizeof( uint16_t ) + sizeof( uint8_t ) );
+    const size_t offset = out.size();
+    out.resize( offset + 2 * sizeof( uint32_t ) + n * 5 + rows * rowBytes );
+    uint8_t *dst = out.data() + offset;
+    std::memcpy( dst, &cores, sizeof( cores ) );
+    std::memcpy( dst + 4, &rows, sizeof( rows ) );
+    dst += 8;
+    for ( size_t c = 0; c < n; ++c )
+    {
+      std::memcpy( dst, &m_cpus[ c ], sizeof( int32_t ) );
+      dst[ 4 ] = m_types[ c ];
+      dst += 5;
+    }
+    for ( uint64_t seq = lo; seq < m_written; ++seq )
+    {
+      const size_t slot = static_cast< size_t >( seq % CAPACITY );
+      std::memcpy( dst, &m_ts[ slot ], sizeof( int64_t ) );
+      dst += sizeof( int64_t );
+      std::memcpy( dst, &m_freq[ slot * n ], n * sizeof( uint16_t ) );
+      dst += n * sizeof( uint16_t );
+      std::memcpy( dst, &m_busy[ slot * n ], n );
+      dst += n;
+    }
+    unlock();
+  }
+
+private:
+  void lock() const noexcept
+  {
+    while ( m_flag.test_and_set( std::memory_order_acquire ) )
+      ;
+  }
+
+  void unlock() const noexcept { m_flag.clear( std::memory_order_release ); }
+
+  std::vector< int32_t > m_cpus;
+  std::vector< uint8_t > m_types;
+  std::vector< int64_t > m_ts;
+  std::vector< uint16_t > m_freq;   ///< CAPACITY × cores, row-major
+  std::vector< uint8_t > m_busy;
+  uint64_t m_written = 0;
+  mutable std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+};
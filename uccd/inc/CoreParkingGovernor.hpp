@@ -0,0 +1,161 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "CpuController.hpp"
+#include "profiles/UccProfile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Number of online cores from the measured load
+ *
+ * Fed at the monitor cadence with the busy time of the online cores, in
+ * cores (sum of busy% / 100), and the run queue length.  Cores come back at
+ * once when the online ones average above UNPARK_UTILIZATION or more tasks
+ * are runnable than cores are online.  One core is parked at a time, only
+ * while the remaining ones would stay below PARK_UTILIZATION, once the
+ * load has been that low for PARK_HOLD_MS and at least PARK_INTERVAL_MS
+ * after the previous change.  Every unpark restarts that hold, so a bursty load costs at most one offline/online pair per
+ * PARK_HOLD_MS instead of a hotplug per sample.
+ *
+ * Not thread-safe; CpuWorker calls it under its own lock.
+ */
+class CoreParkingGovernor
+{
+public:
+  static constexpr double UNPARK_UTILIZATION = 0.75;
+  static constexpr double PARK_UTILIZATION = 0.40;
+  static constexpr int64_t PARK_HOLD_MS = 5000;
+  static constexpr int64_t PARK_INTERVAL_MS = 2000;
+  static constexpr int32_t MIN_ONLINE = 2;
+
+  /**
+   * @brief Set the policy and the cores it may keep online
+   * @param maxOnline Upper bound from the profile's static limits
+   * @param performanceCores P-cores available, 0 on CPUs without core classes
+   * @param efficiencyCores E-cores available, 0 on CPUs without core classes
+   *
+   * Keeps the current count when nothing changed; otherwise every allowed
+   * core starts online.
+   */
+  void configure( CoreParkingPolicy policy, int32_t maxOnline, int32_t performanceCores,
+                  int32_t efficiencyCores ) noexcept
+  {
+    if ( performanceCores > 0 and efficiencyCores > 0 )
+      maxOnline = std::min( maxOnline, performanceCores + efficiencyCores );
+    else
+      performanceCores = efficiencyCores = 0;
+
+    if ( policy == m_policy and maxOnline == m_max and performanceCores == m_performance
+         and efficiencyCores == m_efficiency )
+      return;
+
+    m_policy = policy;
+    m_max = std::max( maxOnline, 1 );
+    m_performance = performanceCores;
+    m_efficiency = efficiencyCores;
+    m_online = m_max;
+    m_lowSinceMs = NEVER;
+    m_lastChangeMs = NEVER;
+  }
+
+  [[nodiscard]] bool enabled() const noexcept { return m_policy != CoreParkingPolicy::Off and m_max > MIN_ONLINE; }
+  [[nodiscard]] int32_t online() const noexcept { return m_online; }
+
+  /**
+   * @brief Feed one sample
+   * @param busyCores Busy time of the online cores over the sample, in cores
+   * @param runnable procs_running, counting the sampling thread; -1 if unknown
+   * @return true when online() changed
+   */
+  bool update( int64_t nowMs, double busyCores, int32_t runnable ) noexcept
+  {
+    if ( not enabled() or busyCores < 0.0 )
+      return false;
+
+    const int32_t waiting = runnable - 1;
+    if ( busyCores > UNPARK_UTILIZATION * m_online or waiting > m_online )
+    {
+      m_lowSinceMs = NEVER;
+      const int32_t needed = std::max( static_cast< int32_t >( std::ceil( busyCores / UNPARK_UTILIZATION ) ) + 1,
+                                       waiting );
+      return setOnline( std::max( needed, m_online + 1 ), nowMs );
+    }
+
+    if ( m_online <= MIN_ONLINE or busyCores >= PARK_UTILIZATION * ( m_online - 1 ) )
+    {
+      m_lowSinceMs = NEVER;
+      return false;
+    }
+
+    if ( m_lowSinceMs == NEVER )
+      m_lowSinceMs = nowMs;
+    if ( nowMs - m_lowSinceMs < PARK_HOLD_MS
+         or ( m_lastChangeMs != NEVER and nowMs - m_lastChangeMs < PARK_INTERVAL_MS ) )
+      return false;
+    return setOnline( m_online - 1, nowMs );
+  }
+
+  /**
+   * @brief online() split into the counts for CpuController::useCores()
+   *
+   * On CPUs with core classes the policy picks which class gives up its
+   * cores first; one P-core always stays, as core 0 is one.  Elsewhere the
+   * total is set.
+   */
+  [[nodiscard]] PerCoreClass< int32_t > limits() const noexcept
+  {
+    if ( m_performance == 0 )
+      return PerCoreClass< int32_t >{ m_online, std::nullopt, std::nullopt };
+
+    int32_t performance, efficiency;
+    if ( m_policy == CoreParkingPolicy::Efficiency )
+    {
+      efficiency = std::min( m_efficiency, m_online - 1 );
+      performance = m_online - efficiency;
+    }
+    else
+    {
+      performance = std::min( m_performance, m_online );
+      efficiency = m_online - performance;
+    }
+    return PerCoreClass< int32_t >{ std::nullopt, performance, efficiency };
+  }
+
+private:
+  static constexpr int64_t NEVER = std::numeric_limits< int64_t >::min();
+
+  bool setOnline( int32_t online, int64_t nowMs ) noexcept
+  {
+    online = std::clamp( online, MIN_ONLINE, m_max );
+    if ( online == m_online )
+      return false;
+    m_online = online;
+    m_lastChangeMs = nowMs;
+    return true;
+  }
+
+  CoreParkingPolicy m_policy = CoreParkingPolicy::Off;
+  int32_t m_max = 0;
+  int32_t m_performance = 0;
+  int32_t m_efficiency = 0;
+  int32_t m_online = 0;
+  int64_t m_lowSinceMs = NEVER;  ///< Since when parking a core would be possible
+  int64_t m_lastChangeMs = NEVER;
+};
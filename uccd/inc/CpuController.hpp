@@ -15,13 +15,23 @@
 
 #pragma once
 
+#include "CpuTopology.hpp"
 #include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+#include "UccTrace.hpp"
 #include <string>
 #include <vector>
 #include <optional>
 #include <algorithm>
+#include <atomic>
 #include <ranges>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <unordered_map>
+#include <utility>
 
 enum class ScalingDriver
 {
@@ -44,11 +54,14 @@ public:
   const int32_t coreIndex;
   const std::string cpuPath;
   const std::string cpufreqPath;
+  const std::string policyPath;  ///< cpufreq/policyN, shared by the CPUs of one policy
+  CpuCoreType type = CpuCoreType::Unknown;  ///< from CpuController::topology
 
   // cpuX/online
   SysfsNode< bool > online;
 
-  // cpuX/cpufreq/*
+  // cpuX/cpufreq/* – nodes read on every CpuWorker validation pass keep
+  // their fd open (SysfsReadMode::Cached)
   SysfsNode< int32_t > scalingCurFreq;
   SysfsNode< int32_t > scalingMinFreq;
   SysfsNode< int32_t > scalingMaxFreq;
@@ -61,25 +74,45 @@ public:
   SysfsNode< int32_t > cpuinfoMinFreq;
   SysfsNode< int32_t > cpuinfoMaxFreq;
 
+  /// What CpuController last wrote to this core; nullopt if it never did
+  struct Shadow
+  {
+    std::optional< bool > online;
+    std::optional< int32_t > scalingMinFreq;
+    std::optional< int32_t > scalingMaxFreq;
+    std::optional< std::string > governor;
+    std::optional< std::string > energyPerformancePreference;
+  };
+  Shadow shadow;
+
   explicit LogicalCpuController( const std::string &base, int32_t index )
     : basePath( base )
     , coreIndex( index )
     , cpuPath( base + "/cpu" + std::to_string( index ) )
     , cpufreqPath( cpuPath + "/cpufreq" )
-    , online( cpuPath + "/online" )
-    , scalingCurFreq( cpufreqPath + "/scaling_cur_freq" )
-    , scalingMinFreq( cpufreqPath + "/scaling_min_freq" )
-    , scalingMaxFreq( cpufreqPath + "/scaling_max_freq" )
-    , scalingAvailableFrequencies( cpufreqPath + "/scaling_available_frequencies", " " )
+    , policyPath( resolvePolicyPath( cpufreqPath ) )
+    , online( cpuPath + "/online", SysfsReadMode::Cached )
+    , scalingCurFreq( cpufreqPath + "/scaling_cur_freq", SysfsReadMode::Cached )
+    , scalingMinFreq( cpufreqPath + "/scaling_min_freq", SysfsReadMode::Cached )
+    , scalingMaxFreq( cpufreqPath + "/scaling_max_freq", SysfsReadMode::Cached )
+    , scalingAvailableFrequencies( cpufreqPath + "/scaling_available_frequencies", " ", SysfsReadMode::Cached )
     , scalingDriver( cpufreqPath + "/scaling_driver" )
     , energyPerformanceAvailablePreferences( cpufreqPath + "/energy_performance_available_preferences", " " )
-    , energyPerformancePreference( cpufreqPath + "/energy_performance_preference" )
+    , energyPerformancePreference( cpufreqPath + "/energy_performance_preference", SysfsReadMode::Cached )
     , scalingAvailableGovernors( cpufreqPath + "/scaling_available_governors", " " )
-    , scalingGovernor( cpufreqPath + "/scaling_governor" )
-    , cpuinfoMinFreq( cpufreqPath + "/cpuinfo_min_freq" )
-    , cpuinfoMaxFreq( cpufreqPath + "/cpuinfo_max_freq" )
+    , scalingGovernor( cpufreqPath + "/scaling_governor", SysfsReadMode::Cached )
+    , cpuinfoMinFreq( cpufreqPath + "/cpuinfo_min_freq", SysfsReadMode::Cached )
+    , cpuinfoMaxFreq( cpufreqPath + "/cpuinfo_max_freq", SysfsReadMode::Cached )
   {}
 
+  /// cpuX/cpufreq links to the policy directory; itself if it does not resolve
+  static std::string resolvePolicyPath( const std::string &cpufreq )
+  {
+    std::error_code ec;
+    const auto policy = std::filesystem::canonical( cpufreq, ec );
+    return ec ? cpufreq : policy.string();
+  }
+
   /**
    * @brief Get reduced available frequency (middle of frequency range)
    */
@@ -105,6 +138,29 @@ public:
   }
 };
 
+/**
+ * @brief A setting for all cores, optionally overridden per core class
+ *
+ * On a uniform CPU every core is CpuCoreType::Unknown and gets @c all.
+ */
+template< typename T >
+struct PerCoreClass
+{
+  std::optional< T > all;
+  std::optional< T > performance;
+  std::optional< T > efficiency;
+
+  /// The value for a core of @p type
+  [[nodiscard]] const std::optional< T > &of( CpuCoreType type ) const noexcept
+  {
+    if ( type == CpuCoreType::Performance and performance )
+      return performance;
+    if ( type == CpuCoreType::Efficiency and efficiency )
+      return efficiency;
+    return all;
+  }
+};
+
 /**
  * @brief Controller for CPU frequency and governor settings
  *
@@ -116,6 +172,9 @@ class CpuController
 public:
   static constexpr const char *basePath = "/sys/devices/system/cpu";
 
+  const std::string rootPath;  ///< basePath under ucc::sysfsRoot(), or a fake tree in tests
+  const std::string pmuRoot;   ///< /sys/devices, for the hybrid PMUs
+  CpuTopology topology;
   std::vector< LogicalCpuController > cores;
 
   // /sys/devices/system/cpu/...
@@ -131,14 +190,35 @@ public:
   // boost
   SysfsNode< bool > boost;
 
-  explicit CpuController()
-    : kernelMax( std::string( basePath ) + "/kernel_max" )
-    , offline( std::string( basePath ) + "/offline", " " )
-    , online( std::string( basePath ) + "/online", " " )
-    , possible( std::string( basePath ) + "/possible", " " )
-    , present( std::string( basePath ) + "/present", " " )
-    , intelPstateNoTurbo( std::string( basePath ) + "/intel_pstate/no_turbo" )
-    , boost( std::string( basePath ) + "/cpufreq/boost" )
+  /// intel_pstate/no_turbo as last written by setNoTurbo()
+  std::optional< bool > noTurboShadow;
+
+  /**
+   * @brief Settings of one core that a validation pass compares against
+   *
+   * Taken from the core's shadow once per apply, so a pass reads only the
+   * nodes it checks and computes nothing.  Unset fields are not checked.
+   */
+  struct ExpectedCoreState
+  {
+    size_t core = 0;  ///< index into cores
+    std::optional< int32_t > scalingMinFreq;
+    std::optional< int32_t > scalingMaxFreq;
+    std::optional< std::string > governor;
+    std::optional< std::string > energyPerformancePreference;
+  };
+
+  explicit CpuController( std::string root = ucc::sysfsPath( basePath ),
+                          std::string pmu = ucc::sysfsPath( "/sys/devices" ) )
+    : rootPath( std::move( root ) )
+    , pmuRoot( std::move( pmu ) )
+    , kernelMax( rootPath + "/kernel_max" )
+    , offline( rootPath + "/offline", " " )
+    , online( rootPath + "/online", " " )
+    , possible( rootPath + "/possible", " " )
+    , present( rootPath + "/present", " " )
+    , intelPstateNoTurbo( rootPath + "/intel_pstate/no_turbo" )
+    , boost( rootPath + "/cpufreq/boost" )
   {
     getAvailableLogicalCores();
   }
@@ -149,6 +229,7 @@ public:
   void getAvailableLogicalCores()
   {
     cores.clear();
+    topology = CpuTopology::discover( { rootPath, pmuRoot } );
 
     auto possibleCores = possible.read();
     auto presentCores = present.read();
@@ -170,7 +251,8 @@ public:
 
     for ( int32_t coreIndex : coreIndexToAdd )
     {
-      LogicalCpuController newCore( basePath, coreIndex );
+      LogicalCpuController newCore( rootPath, coreIndex );
+      newCore.type = topology.typeOf( coreIndex );
 
       // core 0 doesn't have online control, always include it
       if ( coreIndex == 0 or newCore.online.isAvailable() )
@@ -187,25 +269,39 @@ public:
    */
   void useCores( std::optional< int32_t > numberOfCores = std::nullopt )
   {
-    if ( not numberOfCores.has_value() )
-      numberOfCores = static_cast< int32_t >( cores.size() );
+    useCores( PerCoreClass< int32_t >{ numberOfCores, std::nullopt, std::nullopt } );
+  }
 
+  /**
+   * @brief Set number of online CPU cores, in total and per core class
+   *
+   * A core stays online if it is among the first @c all cores and among the
+   * first cores of its class, e.g. { 16, std::nullopt, 0 } parks every
+   * E-core.  Core 0 always stays online.
+   */
+  void useCores( const PerCoreClass< int32_t > &numberOfCores )
+  {
     // Clamp to valid range [1, cores.size()]
-    numberOfCores = std::clamp( *numberOfCores, 1, static_cast< int32_t >( cores.size() ) );
+    const int32_t total = std::clamp( numberOfCores.all.value_or( static_cast< int32_t >( cores.size() ) ),
+                                      1, static_cast< int32_t >( cores.size() ) );
+    int32_t performanceSeen = 0;
+    int32_t efficiencySeen = 0;
 
-    for ( size_t i = 1; i < cores.size(); ++i )
+    for ( size_t i = 0; i < cores.size(); ++i )
     {
-      if ( not cores[ i ].online.isAvailable() )
+      bool withinClass = true;
+      if ( cores[ i ].type == CpuCoreType::Performance )
+        withinClass = not numberOfCores.performance or performanceSeen++ < *numberOfCores.performance;
+      else if ( cores[ i ].type == CpuCoreType::Efficiency )
+        withinClass = not numberOfCores.efficiency or efficiencySeen++ < *numberOfCores.efficiency;
+
+      if ( i == 0 or not cores[ i ].online.isAvailable() )
         continue;
 
-      if ( static_cast< int32_t >( i ) < *numberOfCores )
-      {
-        cores[ i ].online.write( true );
-      }
-      else
-      {
-        cores[ i ].online.write( false );
-      }
+      // hotplug is by far the most expensive write, never repeat it
+      const bool coreOnline = static_cast< int32_t >( i ) < total and withinClass;
+      writeIfChanged( cores[ i ].online, coreOnline );
+      cores[ i ].shadow.online = coreOnline;
     }
   }
 
@@ -246,11 +342,13 @@ public:
    * @param core          The logical core to compute for
    * @param targetMax     The requested maximum frequency (same semantics as setGovernorScalingMaxFrequency)
    * @param acpiFallback  True when scaling driver is acpi-cpufreq and boost is available
+   * @param floor         Lowest allowed value; the current scaling_min_freq if unset
    * @return The effective frequency that will be set, or nullopt if sysfs nodes are unavailable
    */
   static std::optional< int32_t > computeEffectiveMaxFreq( const LogicalCpuController &core,
                                                            std::optional< int32_t > targetMax,
-                                                           bool acpiFallback )
+                                                           bool acpiFallback,
+                                                           std::optional< int32_t > floor = std::nullopt )
   {
     if ( not core.scalingMinFreq.isAvailable() or not core.scalingMaxFreq.isAvailable()
          or not core.cpuinfoMinFreq.isAvailable() or not core.cpuinfoMaxFreq.isAvailable() )
@@ -258,7 +356,7 @@ public:
 
     auto coreMin = core.cpuinfoMinFreq.read();
     auto coreMax = core.cpuinfoMaxFreq.read();
-    auto scalingMin = core.scalingMinFreq.read();
+    auto scalingMin = floor ? floor : core.scalingMinFreq.read();
     auto avail = core.scalingAvailableFrequencies.read();
 
     if ( not coreMin or not coreMax or not scalingMin )
@@ -311,10 +409,12 @@ public:
    *
    * @param core       The logical core to compute for
    * @param targetMin  The requested minimum frequency (same semantics as setGovernorScalingMinFrequency)
+   * @param ceiling    Highest allowed value; the current scaling_max_freq if unset
    * @return The effective frequency that will be set, or nullopt if sysfs nodes are unavailable
    */
   static std::optional< int32_t > computeEffectiveMinFreq( const LogicalCpuController &core,
-                                                           std::optional< int32_t > targetMin )
+                                                           std::optional< int32_t > targetMin,
+                                                           std::optional< int32_t > ceiling = std::nullopt )
   {
     if ( not core.scalingMinFreq.isAvailable() or not core.scalingMaxFreq.isAvailable()
          or not core.cpuinfoMinFreq.isAvailable() or not core.cpuinfoMaxFreq.isAvailable() )
@@ -322,7 +422,7 @@ public:
 
     auto coreMin = core.cpuinfoMinFreq.read();
     auto coreMax = core.cpuinfoMaxFreq.read();
-    auto scalingMax = core.scalingMaxFreq.read();
+    auto scalingMax = ceiling ? ceiling : core.scalingMaxFreq.read();
     auto avail = core.scalingAvailableFrequencies.read();
 
     if ( not coreMin or not coreMax or not scalingMax )
@@ -359,61 +459,87 @@ public:
   }
 
   /**
-   * @brief Set maximum scaling frequency for all cores
+   * @brief Set minimum and maximum scaling frequency for all cores
    *
-   * @param setMaxFrequency Target frequency (-1 for reduced, undefined for max)
+   * Both bounds are computed first, as if the cores were at their full
+   * range, and written in the order the kernel accepts: the maximum first
+   * if the new minimum is above the current maximum.  Unlike calling the
+   * two setters in turn, no bound is ever moved twice.
+   *
+   * @param setMinFrequency Target minimum (-2 for max, undefined for min)
+   * @param setMaxFrequency Target maximum (-1 for reduced, undefined for max)
    */
-  void setGovernorScalingMaxFrequency( std::optional< int32_t > setMaxFrequency = std::nullopt )
+  void setScalingFrequencies( std::optional< int32_t > setMinFrequency,
+                              std::optional< int32_t > setMaxFrequency )
   {
-    std::optional< std::string > scalingDriverStr;
-    bool acpiFallback = false;
-
-    for ( auto &core : cores )
-    {
-      if ( not core.scalingMinFreq.isAvailable() or not core.scalingMaxFreq.isAvailable()
-           or not core.cpuinfoMinFreq.isAvailable() or not core.cpuinfoMaxFreq.isAvailable() )
-        continue;
-
-      if ( core.coreIndex != 0 and not core.online.read().value_or( false ) )
-        continue;
-
-      if ( not scalingDriverStr.has_value() )
-      {
-        scalingDriverStr = core.scalingDriver.read();
-        acpiFallback = boost.isAvailable() and scalingDriverStr.has_value()
-                       and *scalingDriverStr == "acpi-cpufreq";
-      }
-
-      auto effective = computeEffectiveMaxFreq( core, setMaxFrequency, acpiFallback );
-      if ( effective )
-        core.scalingMaxFreq.write( *effective );
-    }
-
-    // handle boost for AMD (boost not included in max frequency)
-    if ( cores.empty() )
-      return;
-
-    auto maxFrequency = cores[ 0 ].cpuinfoMaxFreq.read();
-    auto availableFrequencies = cores[ 0 ].scalingAvailableFrequencies.read();
-
-    int32_t maximumAvailableFrequency = maxFrequency.value_or( 0 );
+    setScalingFrequencies( setMinFrequency, PerCoreClass< int32_t >{ setMaxFrequency, std::nullopt, std::nullopt } );
+  }
 
-    if ( availableFrequencies.has_value() and not availableFrequencies->empty() )
+  /**
+   * @brief Set scaling frequencies, with a maximum per core class
+   */
+  void setScalingFrequencies( std::optional< int32_t > setMinFrequency,
+                              const PerCoreClass< int32_t > &setMaxFrequency )
+  {
+    const auto scalingDriverStr = firstScalingDriver();
+    const bool acpiFallback = boost.isAvailable() and scalingDriverStr == "acpi-cpufreq";
+
+    forEachPolicy( [&]( LogicalCpuController &core ) {
+        if ( not hasFrequencyNodes( core ) )
+          return;
+        const auto coreMax = core.cpuinfoMaxFreq.read();
+        const auto newMin = computeEffectiveMinFreq( core, setMinFrequency, coreMax );
+        const auto newMax = computeEffectiveMaxFreq( core, setMaxFrequency.of( core.type ), acpiFallback, newMin );
+        if ( not newMin or not newMax )
+          return;
+
+        if ( *newMin > core.scalingMaxFreq.read().value_or( 0 ) )
+        {
+          writeIfChanged( core.scalingMaxFreq, *newMax );
+          writeIfChanged( core.scalingMinFreq, *newMin );
+        }
+        else
+        {
+          writeIfChanged( core.scalingMinFreq, *newMin );
+          writeIfChanged( core.scalingMaxFreq, *newMax );
+        }
+        core.shadow.scalingMinFreq = newMin;
+        core.shadow.scalingMaxFreq = newMax;
+      },
+      &LogicalCpuController::Shadow::scalingMinFreq, &LogicalCpuController::Shadow::scalingMaxFreq );
+
+    // boost is package-wide: keep it while any core may use its full range
+    std::optional< int32_t > loosestMax = cores.empty() ? setMaxFrequency.all : setMaxFrequency.of( cores[ 0 ].type );
+    for ( const auto &core : cores )
     {
-      maximumAvailableFrequency = availableFrequencies->front();
+      const auto &target = setMaxFrequency.of( core.type );
+      if ( loosestMax and ( not target or *target > *loosestMax ) )
+        loosestMax = target;
     }
+    updateBoost( loosestMax, scalingDriverStr );
+  }
 
-    if ( boost.isAvailable() and scalingDriverStr.has_value() and *scalingDriverStr == "acpi-cpufreq" )
-    {
-      if ( not setMaxFrequency.has_value() or *setMaxFrequency > maximumAvailableFrequency )
-      {
-        boost.write( true );
-      }
-      else
-      {
-        boost.write( false );
-      }
-    }
+  /**
+   * @brief Set maximum scaling frequency for all cores
+   *
+   * @param setMaxFrequency Target frequency (-1 for reduced, undefined for max)
+   */
+  void setGovernorScalingMaxFrequency( std::optional< int32_t > setMaxFrequency = std::nullopt )
+  {
+    const auto scalingDriverStr = firstScalingDriver();
+    const bool acpiFallback = boost.isAvailable() and scalingDriverStr == "acpi-cpufreq";
+
+    forEachPolicy( [&]( LogicalCpuController &core ) {
+        if ( not hasFrequencyNodes( core ) )
+          return;
+        auto effective = computeEffectiveMaxFreq( core, setMaxFrequency, acpiFallback );
+        if ( effective )
+          writeIfChanged( core.scalingMaxFreq, *effective );
+        core.shadow.scalingMaxFreq = effective;
+      },
+      &LogicalCpuController::Shadow::scalingMaxFreq );
+
+    updateBoost( setMaxFrequency, scalingDriverStr );
   }
 
   /**
@@ -423,19 +549,15 @@ public:
    */
   void setGovernorScalingMinFrequency( std::optional< int32_t > setMinFrequency = std::nullopt )
   {
-    for ( auto &core : cores )
-    {
-      if ( not core.scalingMinFreq.isAvailable() or not core.scalingMaxFreq.isAvailable()
-           or not core.cpuinfoMinFreq.isAvailable() or not core.cpuinfoMaxFreq.isAvailable() )
-        continue;
-
-      if ( core.coreIndex != 0 and core.online.read().value_or( false ) == false )
-        continue;
-
-      auto effective = computeEffectiveMinFreq( core, setMinFrequency );
-      if ( effective )
-        core.scalingMinFreq.write( *effective );
-    }
+    forEachPolicy( [&]( LogicalCpuController &core ) {
+        if ( not hasFrequencyNodes( core ) )
+          return;
+        auto effective = computeEffectiveMinFreq( core, setMinFrequency );
+        if ( effective )
+          writeIfChanged( core.scalingMinFreq, *effective );
+        core.shadow.scalingMinFreq = effective;
+      },
+      &LogicalCpuController::Shadow::scalingMinFreq );
   }
 
   /**
@@ -446,24 +568,20 @@ public:
     if ( not governor.has_value() )
       return;
 
-    for ( auto &core : cores )
-    {
-      if ( not core.scalingGovernor.isAvailable() or not core.scalingAvailableGovernors.isAvailable() )
-        continue;
-
-      if ( core.coreIndex != 0 and core.online.read().value_or( false ) == false )
-        return;
-
-      auto availableGovernors = core.scalingAvailableGovernors.read();
+    forEachPolicy( [&]( LogicalCpuController &core ) {
+        if ( not core.scalingGovernor.isAvailable() or not core.scalingAvailableGovernors.isAvailable() )
+          return;
 
-      if ( not availableGovernors.has_value() )
-        continue;
+        auto availableGovernors = core.scalingAvailableGovernors.read();
 
-      if ( std::ranges::find( *availableGovernors, *governor ) != availableGovernors->end() )
-      {
-        core.scalingGovernor.write( *governor );
-      }
-    }
+        if ( availableGovernors.has_value()
+             and std::ranges::find( *availableGovernors, *governor ) != availableGovernors->end() )
+        {
+          writeIfChanged( core.scalingGovernor, *governor );
+          core.shadow.governor = *governor;
+        }
+      },
+      &LogicalCpuController::Shadow::governor );
   }
 
   /**
@@ -471,28 +589,86 @@ public:
    */
   void setEnergyPerformancePreference( const std::optional< std::string > &preference )
   {
-    if ( not preference.has_value() )
+    setEnergyPerformancePreference( PerCoreClass< std::string >{ preference, std::nullopt, std::nullopt } );
+  }
+
+  /**
+   * @brief Set energy performance preference, per core class
+   */
+  void setEnergyPerformancePreference( const PerCoreClass< std::string > &preferences )
+  {
+    forEachPolicy( [&]( LogicalCpuController &core ) {
+        const auto &preference = preferences.of( core.type );
+        if ( not preference.has_value() )
+          return;
+        if ( not core.energyPerformancePreference.isAvailable()
+             or not core.energyPerformanceAvailablePreferences.isAvailable() )
+          return;
+
+        auto availablePreferences = core.energyPerformanceAvailablePreferences.read();
+
+        if ( availablePreferences.has_value()
+             and std::ranges::find( *availablePreferences, *preference ) != availablePreferences->end() )
+        {
+          writeIfChanged( core.energyPerformancePreference, *preference );
+          core.shadow.energyPerformancePreference = *preference;
+        }
+      },
+      &LogicalCpuController::Shadow::energyPerformancePreference );
+  }
+
+  /// sysfs writes issued, and those skipped because the node already held the value
+  [[nodiscard]] uint64_t writes() const noexcept { return m_writes.load( std::memory_order_relaxed ); }
+  [[nodiscard]] uint64_t skippedWrites() const noexcept { return m_skippedWrites.load( std::memory_order_relaxed ); }
+
+  /**
+   * @brief Set intel_pstate/no_turbo if the driver has it
+   */
+  void setNoTurbo( bool noTurbo )
+  {
+    if ( not intelPstateNoTurbo.isAvailable() )
       return;
+    writeIfChanged( intelPstateNoTurbo, noTurbo );
+    noTurboShadow = noTurbo;
+  }
 
-    for ( auto &core : cores )
-    {
-      if ( not core.energyPerformancePreference.isAvailable()
-           or not core.energyPerformanceAvailablePreferences.isAvailable() )
-        continue;
+  /**
+   * @brief First setting of @p expected.core that differs from @p expected
+   *
+   * A core that is offline now, or a node that cannot be read, counts as
+   * matching, like the full validation did.
+   * @return Description for the log, nullopt if everything matches
+   */
+  [[nodiscard]] std::optional< std::string > findMismatch( const ExpectedCoreState &expected ) const
+  {
+    if ( expected.core >= cores.size() )
+      return std::nullopt;
+    const LogicalCpuController &core = cores[ expected.core ];
+    if ( core.coreIndex != 0 and not core.online.read().value_or( false ) )
+      return std::nullopt;
 
-      if ( core.coreIndex != 0 and core.online.read().value_or( false ) == false )
-        return;
+    const std::string name = "core" + std::to_string( core.coreIndex );
+    if ( expected.scalingMinFreq )
+      if ( auto current = core.scalingMinFreq.read(); current and *current != *expected.scalingMinFreq )
+        return name + " minimum scaling frequency " + std::to_string( *current )
+               + " instead of " + std::to_string( *expected.scalingMinFreq );
 
-      auto availablePreferences = core.energyPerformanceAvailablePreferences.read();
+    if ( expected.scalingMaxFreq )
+      if ( auto current = core.scalingMaxFreq.read(); current and *current != *expected.scalingMaxFreq )
+        return name + " maximum scaling frequency " + std::to_string( *current )
+               + " instead of " + std::to_string( *expected.scalingMaxFreq );
 
-      if ( not availablePreferences.has_value() )
-        continue;
+    if ( expected.governor )
+      if ( auto current = core.scalingGovernor.read(); current and *current != *expected.governor )
+        return name + " scaling governor '" + *current + "' instead of '" + *expected.governor + "'";
 
-      if ( std::ranges::find( *availablePreferences, *preference ) != availablePreferences->end() )
-      {
-        core.energyPerformancePreference.write( *preference );
-      }
-    }
+    if ( expected.energyPerformancePreference )
+      if ( auto current = core.energyPerformancePreference.read();
+           current and *current != *expected.energyPerformancePreference )
+        return name + " energy performance preference '" + *current
+               + "' instead of '" + *expected.energyPerformancePreference + "'";
+
+    return std::nullopt;
   }
 
   /**
@@ -514,4 +690,100 @@ public:
 
     return ScalingDriver::unknown;
   }
+
+private:
+  // Policies are written concurrently from this many on; below, the
+  // threads cost more than the writes they overlap
+  static constexpr size_t PARALLEL_MIN_POLICIES = 8;
+  static constexpr size_t MAX_WRITE_THREADS = 4;
+
+  std::atomic< uint64_t > m_writes{ 0 };
+  std::atomic< uint64_t > m_skippedWrites{ 0 };
+
+  /// Every cpufreq write is a policy update in the kernel; skip those that change nothing
+  template< typename T >
+  bool writeIfChanged( SysfsNode< T > &node, const T &value )
+  {
+    if ( node.read() == value )
+    {
+      m_skippedWrites.fetch_add( 1, std::memory_order_relaxed );
+      return true;
+    }
+    m_writes.fetch_add( 1, std::memory_order_relaxed );
+    return node.write( value );
+  }
+
+  static bool hasFrequencyNodes( const LogicalCpuController &core )
+  {
+    return core.scalingMinFreq.isAvailable() and core.scalingMaxFreq.isAvailable()
+           and core.cpuinfoMinFreq.isAvailable() and core.cpuinfoMaxFreq.isAvailable();
+  }
+
+  std::optional< std::string > firstScalingDriver() const
+  {
+    for ( const auto &core : cores )
+      if ( auto driver = core.scalingDriver.read() )
+        return driver;
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Run @p write once per cpufreq policy, on its first online core
+   *
+   * Policies are independent in the kernel, so many of them are written
+   * from a few threads at once.  The other online cores of a policy get
+   * the writer's @p fields of the shadow, since they read the same nodes.
+   */
+  template< typename Fn, typename... Fields >
+  void forEachPolicy( Fn &&write, Fields... fields )
+  {
+    UCC_TRACE_SCOPE( "sysfs", "CpuController::forEachPolicy" );
+    std::vector< size_t > writers;
+    std::vector< std::pair< size_t, size_t > > followers;  ///< core, its writer
+    std::unordered_map< std::string, size_t > writerOf;
+    for ( size_t i = 0; i < cores.size(); ++i )
+    {
+      if ( cores[ i ].coreIndex != 0 and not cores[ i ].online.read().value_or( false ) )
+        continue;
+      const auto [it, inserted] = writerOf.try_emplace( cores[ i ].policyPath, i );
+      if ( inserted )
+        writers.push_back( i );
+      else
+        followers.emplace_back( i, it->second );
+    }
+
+    const size_t threads = writers.size() >= PARALLEL_MIN_POLICIES ? MAX_WRITE_THREADS : 1;
+    const auto writeShare = [&]( size_t share ) {
+      for ( size_t k = share; k < writers.size(); k += threads )
+        write( cores[ writers[ k ] ] );
+    };
+    std::vector< std::future< void > > jobs;
+    for ( size_t share = 1; share < threads; ++share )
+      jobs.push_back( std::async( std::launch::async, writeShare, share ) );
+    writeShare( 0 );
+    for ( auto &job : jobs )
+      job.get();
+
+    for ( const auto &[ core, writer ] : followers )
+      ( ( cores[ core ].shadow.*fields = cores[ writer ].shadow.*fields ), ... );
+  }
+
+  /// acpi-cpufreq keeps the boost frequencies out of the maximum; switch boost with it
+  void updateBoost( std::optional< int32_t > setMaxFrequency, const std::optional< std::string > &scalingDriverStr )
+  {
+    if ( cores.empty() or not boost.isAvailable() or scalingDriverStr != "acpi-cpufreq" )
+      return;
+
+    auto maxFrequency = cores[ 0 ].cpuinfoMaxFreq.read();
+    auto availableFrequencies = cores[ 0 ].scalingAvailableFrequencies.read();
+
+    int32_t maximumAvailableFrequency = maxFrequency.value_or( 0 );
+
+    if ( availableFrequencies.has_value() and not availableFrequencies->empty() )
+    {
+      maximumAvailableFrequency = availableFrequencies->front();
+    }
+
+    writeIfChanged( boost, not setMaxFrequency.has_value() or *setMaxFrequency > maximumAvailableFrequency );
+  }
 };
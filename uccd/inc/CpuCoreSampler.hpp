@@ -0,0 +1,322 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "CpuTopology.hpp"
+#include "SensorPoller.hpp"
+#include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief One sample of every online logical CPU plus the aggregates.
+ *
+ * The vectors are parallel and indexed by position in @c cpus; values are
+ * -1.0 where unknown.  Busy time is measured since the previous sample.
+ */
+struct CpuCoreMetrics
+{
+  std::vector< int32_t > cpus;          ///< Logical CPU numbers, ascending
+  std::vector< CpuCoreType > types;
+  std::vector< double > freqMHz;
+  std::vector< double > busyPct;
+  double maxMHz = -1.0;
+  double avgMHz = -1.0;
+  double pCoreAvgMHz = -1.0;            ///< Only on hybrid CPUs
+  double eCoreAvgMHz = -1.0;
+  int32_t runnable = -1;                ///< procs_running, the sampling thread included
+  bool effective = false;               ///< freqMHz from APERF/MPERF
+};
+
+/**
+ * @brief Per-core effective frequency and busy time.
+ *
+ * With the msr driver loaded (and readable by the daemon) the frequency is
+ * the APERF/MPERF ratio over the sample interval times the base frequency,
+ * i.e. the average clock while the core was not halted.  Otherwise, and
+ * for cores that were halted the whole interval, each core's
+ * scaling_cur_freq is used; those nodes are registered with the shared
+ * SensorPoller, so sample() must run after its refresh().  Busy time comes
+ * from one read of /proc/stat per sample.
+ *
+ * Not thread-safe; owned by the polling worker.
+ */
+class CpuCoreSampler
+{
+public:
+  static constexpr off_t MSR_MPERF = 0xE7;
+  static constexpr off_t MSR_APERF = 0xE8;
+
+  struct Paths
+  {
+    std::string cpuRoot = ucc::sysfsPath( "/sys/devices/system/cpu" );
+    std::string pmuRoot = "/sys/devices";   ///< cpu_core / cpu_atom PMUs on hybrid parts
+    std::string procStat = ucc::sysfsPath( "/proc/stat" );
+    std::string msrRoot = "/dev/cpu";
+  };
+
+  explicit CpuCoreSampler( std::shared_ptr< SensorPoller > poller )
+    : CpuCoreSampler( std::move( poller ), Paths() )
+  {
+  }
+
+  CpuCoreSampler( std::shared_ptr< SensorPoller > poller, Paths paths )
+    : m_poller( std::move( poller ) )
+    , m_paths( std::move( paths ) )
+  {
+  }
+
+  ~CpuCoreSampler() { closeMsr(); }
+
+  CpuCoreSampler( const CpuCoreSampler & ) = delete;
+  CpuCoreSampler &operator=( const CpuCoreSampler & ) = delete;
+
+  /**
+   * @brief Enumerate the online CPUs and pick the frequency source.
+   */
+  void discover()
+  {
+    closeMsr();
+    m_cores.clear();
+
+    auto online = SysfsNode< std::vector< int32_t > >( m_paths.cpuRoot + "/online" ).read();
+    if ( !online )
+      online = std::vector< int32_t >{ 0 };
+    std::sort( online->begin(), online->end() );
+
+    const auto pCores = SysfsNode< std::vector< int32_t > >( m_paths.pmuRoot + "/cpu_core/cpus" ).read();
+    const auto eCores = SysfsNode< std::vector< int32_t > >( m_paths.pmuRoot + "/cpu_atom/cpus" ).read();
+    const auto contains = []( const auto &list, int32_t cpu ) {
+      return list && std::find( list->begin(), list->end(), cpu ) != list->end();
+    };
+
+    bool msrUsable = true;
+    for ( const int32_t cpu : *online )
+    {
+      Core core;
+      core.cpu = cpu;
+      if ( contains( pCores, cpu ) )
+        core.type = CpuCoreType::Performance;
+      else if ( contains( eCores, cpu ) )
+        core.type = CpuCoreType::Efficiency;
+
+      const std::string cpufreq = m_paths.cpuRoot + "/cpu" + std::to_string( cpu ) + "/cpufreq";
+      core.curFreq = m_poller->add( cpufreq + "/scaling_cur_freq" );
+      core.baseKHz = SysfsNode< int64_t >( cpufreq + "/base_frequency" ).read().value_or( 0 );
+
+      if ( msrUsable )
+      {
+        const std::string msr = m_paths.msrRoot + "/" + std::to_string( cpu ) + "/msr";
+        core.msrFd = open( msr.c_str(), O_RDONLY | O_CLOEXEC );
+        uint64_t probe;
+        msrUsable = core.baseKHz > 0 && core.msrFd >= 0 && readMsr( core.msrFd, MSR_MPERF, probe );
+      }
+      m_cores.push_back( core );
+    }
+
+    // one source for all cores, so they stay comparable
+    m_useMsr = msrUsable && !m_cores.empty();
+    if ( !m_useMsr )
+      closeMsr();
+
+    m_metrics = CpuCoreMetrics();
+    m_metrics.effective = m_useMsr;
+    for ( const auto &core : m_cores )
+    {
+      m_metrics.cpus.push_back( core.cpu );
+      m_metrics.types.push_back( core.type );
+    }
+    m_metrics.freqMHz.assign( m_cores.size(), -1.0 );
+    m_metrics.busyPct.assign( m_cores.size(), -1.0 );
+  }
+
+  /**
+   * @brief Average unhalted clock from APERF/MPERF deltas, -1.0 if the core
+   *        was halted the whole interval.
+   */
+  static constexpr double effectiveMHz( int64_t baseKHz, uint64_t dAperf, uint64_t dMperf ) noexcept
+  {
+    if ( dMperf == 0 || baseKHz <= 0 )
+      return -1.0;
+    return static_cast< double >( baseKHz ) / 1000.0 * static_cast< double >( dAperf ) / static_cast< double >( dMperf );
+  }
+
+  [[nodiscard]] bool usesMsr() const noexcept { return m_useMsr; }
+  [[nodiscard]] size_t coreCount() const noexcept { return m_cores.size(); }
+
+  /**
+   * @brief Take one sample; the reference stays valid until the next call.
+   */
+  [[nodiscard]] const CpuCoreMetrics &sample() noexcept
+  {
+    readProcStat();
+
+    for ( size_t i = 0; i < m_cores.size(); ++i )
+    {
+      Core &core = m_cores[ i ];
+      double freq = -1.0;
+
+      uint64_t aperf, mperf;
+      if ( m_useMsr && readMsr( core.msrFd, MSR_APERF, aperf ) && readMsr( core.msrFd, MSR_MPERF, mperf ) )
+      {
+        // unsigned subtraction handles the (theoretical) 64-bit wrap
+        if ( core.msrPrimed )
+          freq = effectiveMHz( core.baseKHz, aperf - core.aperf, mperf - core.mperf );
+        core.aperf = aperf;
+        core.mperf = mperf;
+        core.msrPrimed = true;
+      }
+      if ( freq <= 0.0 )
+        if ( const auto khz = m_poller->readInt( core.curFreq ); khz && *khz > 0 )
+          freq = static_cast< double >( *khz ) / 1000.0;
+      m_metrics.freqMHz[ i ] = freq;
+    }
+
+    aggregate();
+    return m_metrics;
+  }
+
+private:
+  struct Core
+  {
+    int32_t cpu = 0;
+    CpuCoreType type = CpuCoreType::Unknown;
+    SensorPoller::Handle curFreq = SensorPoller::INVALID_HANDLE;
+    int64_t baseKHz = 0;
+    int msrFd = -1;
+    bool msrPrimed = false;
+    uint64_t aperf = 0;
+    uint64_t mperf = 0;
+    bool statPrimed = false;
+    uint64_t busyTicks = 0;
+    uint64_t totalTicks = 0;
+  };
+
+  static bool readMsr( int fd, off_t reg, uint64_t &value ) noexcept
+  {
+    return fd >= 0 && pread( fd, &value, sizeof( value ), reg ) == static_cast< ssize_t >( sizeof( value ) );
+  }
+
+  void closeMsr() noexcept
+  {
+    for ( auto &core : m_cores )
+    {
+      if ( core.msrFd >= 0 )
+        close( core.msrFd );
+      core.msrFd = -1;
+    }
+  }
+
+  /// "cpuN user nice system idle iowait irq softirq steal ..." per online CPU, and "procs_running N"
+  void readProcStat() noexcept
+  {
+    for ( auto &busy : m_metrics.busyPct )
+      busy = -1.0;
+    m_metrics.runnable = -1;
+
+    try
+    {
+      std::ifstream stat( m_paths.procStat );
+      std::string label;
+      while ( stat >> label )
+      {
+        if ( label == "procs_running" )
+        {
+          stat >> m_metrics.runnable;
+          if ( !stat )
+            break;
+          continue;
+        }
+        if ( label.size() <= 3 || label.rfind( "cpu", 0 ) != 0 )
+        {
+          stat.ignore( std::numeric_limits< std::streamsize >::max(), '\n' );
+          continue;
+        }
+
+        uint64_t f[ 8 ] = {};
+        for ( auto &field : f )
+          stat >> field;
+        stat.ignore( std::numeric_limits< std::streamsize >::max(), '\n' );
+        if ( !stat )
+          break;
+
+        const int32_t cpu = std::atoi( label.c_str() + 3 );
+        const auto it = std::lower_bound( m_metrics.cpus.begin(), m_metrics.cpus.end(), cpu );
+        if ( it == m_metrics.cpus.end() || *it != cpu )
+          continue;
+        const size_t i = static_cast< size_t >( it - m_metrics.cpus.begin() );
+
+        Core &core = m_cores[ i ];
+        const uint64_t busy = f[ 0 ] + f[ 1 ] + f[ 2 ] + f[ 5 ] + f[ 6 ];
+        const uint64_t total = busy + f[ 3 ] + f[ 4 ] + f[ 7 ];
+        if ( core.statPrimed && total > core.totalTicks && busy >= core.busyTicks )
+          m_metrics.busyPct[ i ] = std::min( 100.0, 100.0 * static_cast< double >( busy - core.busyTicks ) /
+                                                       static_cast< double >( total - core.totalTicks ) );
+        core.busyTicks = busy;
+        core.totalTicks = total;
+        core.statPrimed = true;
+      }
+    }
+    catch ( ... ) {}
+  }
+
+  void aggregate() noexcept
+  {
+    double sum = 0.0, pSum = 0.0, eSum = 0.0;
+    size_t n = 0, pN = 0, eN = 0;
+    m_metrics.maxMHz = -1.0;
+
+    for ( size_t i = 0; i < m_cores.size(); ++i )
+    {
+      const double f = m_metrics.freqMHz[ i ];
+      if ( f <= 0.0 )
+        continue;
+      m_metrics.maxMHz = std::max( m_metrics.maxMHz, f );
+      sum += f;
+      ++n;
+      if ( m_cores[ i ].type == CpuCoreType::Performance )
+      {
+        pSum += f;
+        ++pN;
+      }
+      else if ( m_cores[ i ].type == CpuCoreType::Efficiency )
+      {
+        eSum += f;
+        ++eN;
+      }
+    }
+
+    m_metrics.avgMHz = n > 0 ? sum / static_cast< double >( n ) : -1.0;
+    m_metrics.pCoreAvgMHz = pN > 0 ? pSum / static_cast< double >( pN ) : -1.0;
+    m_metrics.eCoreAvgMHz = eN > 0 ? eSum / static_cast< double >( eN ) : -1.0;
+  }
+
+  std::shared_ptr< SensorPoller > m_poller;
+  Paths m_paths;
+  std::vector< Core > m_cores;
+  CpuCoreMetrics m_metrics;
+  bool m_useMsr = false;
+};
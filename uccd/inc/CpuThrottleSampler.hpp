@@ -0,0 +1,321 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <linux/perf_event.h>
+#include <optional>
+#include <set>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Throttling and package idle over one sample interval.
+ *
+ * Percentages are of the interval since the previous sample, -1.0 where
+ * the source is missing or not yet primed.
+ */
+struct CpuThrottleMetrics
+{
+  double coreThrottlePct = -1.0;      ///< Most-throttled core (thermal)
+  double packageThrottlePct = -1.0;   ///< Most-throttled package (thermal)
+  uint64_t coreThrottleEvents = 0;    ///< New core_throttle_count events, all cores
+  uint64_t packageThrottleEvents = 0;
+  double powerLimitedPct = -1.0;      ///< 100 if package power reached PL1/PL2, else 0
+  double pkgCstatePct = -1.0;         ///< Time in any package C-state (PC2 and deeper)
+};
+
+/**
+ * @brief Delta counters that tell a power-limited from a thermally
+ *        throttled CPU.
+ *
+ *   - Thermal: each CPU's thermal_throttle/core_throttle_* and, once per
+ *     package, package_throttle_* (x86 therm_throt).  The *_total_time_ms
+ *     counters give the throttled share of the interval; on kernels
+ *     without them an increased *_count marks the whole interval.
+ *   - Power: the package RAPL power of the worker compared against the
+ *     zone's long- and short-term limits (constraint_0/1), re-read each
+ *     sample so profile changes apply.  Hits are within LIMIT_MARGIN.
+ *   - Idle: the perf cstate_pkg PMU residency counters, which tick at the
+ *     TSC rate, divided by the TSC delta.
+ *
+ * Not thread-safe; owned by the polling worker.
+ */
+class CpuThrottleSampler
+{
+public:
+  static constexpr double LIMIT_MARGIN = 0.97;
+
+  struct Paths
+  {
+    std::string cpuRoot = ucc::sysfsPath( "/sys/devices/system/cpu" );
+    std::string powercapZone = ucc::sysfsPath( "/sys/devices/virtual/powercap/intel-rapl/intel-rapl:0" );
+    std::string pmuRoot = ucc::sysfsPath( "/sys/bus/event_source/devices" );
+  };
+
+  CpuThrottleSampler()
+    : CpuThrottleSampler( Paths() )
+  {
+  }
+
+  explicit CpuThrottleSampler( Paths paths )
+    : m_paths( std::move( paths ) )
+  {
+  }
+
+  ~CpuThrottleSampler() { closeResidency(); }
+
+  CpuThrottleSampler( const CpuThrottleSampler & ) = delete;
+  CpuThrottleSampler &operator=( const CpuThrottleSampler & ) = delete;
+
+  static int64_t nowMs() noexcept
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  /**
+   * @brief Find the counters; previous readings are dropped.
+   * @param openPmu false to skip perf_event_open (tests)
+   */
+  void discover( bool openPmu = true )
+  {
+    m_cores.clear();
+    m_packages.clear();
+    m_limits.clear();
+    m_lastMs = 0;
+    closeResidency();
+
+    auto online = SysfsNode< std::vector< int32_t > >( m_paths.cpuRoot + "/online" ).read();
+    if ( !online )
+      online = std::vector< int32_t >{ 0 };
+
+    std::set< int64_t > seenPackages;
+    for ( const int32_t cpu : *online )
+    {
+      const std::string base = m_paths.cpuRoot + "/cpu" + std::to_string( cpu );
+      if ( auto core = makeCounter( base + "/thermal_throttle/core_throttle" ) )
+        m_cores.push_back( std::move( *core ) );
+
+      const int64_t package = SysfsNode< int64_t >( base + "/topology/physical_package_id" ).read().value_or( 0 );
+      if ( seenPackages.insert( package ).second )
+        if ( auto pkg = makeCounter( base + "/thermal_throttle/package_throttle" ) )
+          m_packages.push_back( std::move( *pkg ) );
+    }
+
+    for ( const char *constraint : { "constraint_0", "constraint_1" } )
+    {
+      SysfsNode< int64_t > limit( m_paths.powercapZone + "/" + constraint + "_power_limit_uw", SysfsReadMode::Cached );
+      if ( limit.read() )
+        m_limits.push_back( std::move( limit ) );
+    }
+
+    if ( openPmu )
+      openResidency();
+  }
+
+  [[nodiscard]] bool hasThermalCounters() const noexcept { return !m_cores.empty() || !m_packages.empty(); }
+  [[nodiscard]] bool hasPowerLimits() const noexcept { return !m_limits.empty(); }
+  [[nodiscard]] size_t residencyCounters() const noexcept { return m_residency.size(); }
+
+  /**
+   * @brief Read all counters once.
+   * @param packageWatts Package power over the same interval, < 0 if unknown
+   */
+  [[nodiscard]] CpuThrottleMetrics sample( double packageWatts, int64_t timestampMs = nowMs() ) noexcept
+  {
+    CpuThrottleMetrics m;
+    const int64_t elapsedMs = m_lastMs > 0 ? timestampMs - m_lastMs : 0;
+    m_lastMs = timestampMs;
+
+    m.coreThrottlePct = update( m_cores, elapsedMs, m.coreThrottleEvents );
+    m.packageThrottlePct = update( m_packages, elapsedMs, m.packageThrottleEvents );
+
+    if ( packageWatts >= 0.0 && !m_limits.empty() )
+    {
+      m.powerLimitedPct = 0.0;
+      for ( auto &limit : m_limits )
+      {
+        const int64_t uw = limit.read().value_or( 0 );
+        if ( uw > 0 && packageWatts >= LIMIT_MARGIN * static_cast< double >( uw ) / 1e6 )
+          m.powerLimitedPct = 100.0;
+      }
+    }
+
+    m.pkgCstatePct = residency();
+    return m;
+  }
+
+private:
+  struct Counter
+  {
+    SysfsNode< int64_t > count;
+    std::optional< SysfsNode< int64_t > > totalMs;
+    bool primed = false;
+    int64_t lastCount = 0;
+    int64_t lastTotalMs = 0;
+  };
+
+  struct Residency
+  {
+    int fd = -1;
+    uint64_t last = 0;
+  };
+
+  static std::optional< Counter > makeCounter( const std::string &prefix )
+  {
+    SysfsNode< int64_t > count( prefix + "_count", SysfsReadMode::Cached );
+    if ( !count.read() )
+      return std::nullopt;
+
+    Counter counter{ std::move( count ), std::nullopt };
+    SysfsNode< int64_t > totalMs( prefix + "_total_time_ms", SysfsReadMode::Cached );
+    if ( totalMs.read() )
+      counter.totalMs = std::move( totalMs );
+    return counter;
+  }
+
+  /// Largest throttled share over @p counters, -1.0 while unprimed
+  static double update( std::vector< Counter > &counters, int64_t elapsedMs, uint64_t &events ) noexcept
+  {
+    double worst = -1.0;
+    for ( auto &c : counters )
+    {
+      const auto count = c.count.read();
+      std::optional< int64_t > totalMs;
+      if ( c.totalMs )
+        totalMs = c.totalMs->read();
+      if ( !count )
+        continue;
+
+      if ( c.primed && elapsedMs > 0 && *count >= c.lastCount )
+      {
+        const int64_t newEvents = *count - c.lastCount;
+        events += static_cast< uint64_t >( newEvents );
+        double pct;
+        if ( totalMs && *totalMs >= c.lastTotalMs )
+          pct = 100.0 * static_cast< double >( *totalMs - c.lastTotalMs ) / static_cast< double >( elapsedMs );
+        else
+          pct = newEvents > 0 ? 100.0 : 0.0;
+        worst = std::max( worst, std::min( pct, 100.0 ) );
+      }
+      c.primed = true;
+      c.lastCount = *count;
+      c.lastTotalMs = totalMs.value_or( 0 );
+    }
+    return worst;
+  }
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+  void openResidency()
+  {
+    const std::string pmu = m_paths.pmuRoot + "/cstate_pkg";
+    const auto type = SysfsNode< int64_t >( pmu + "/type" ).read();
+    const auto cpus = SysfsNode< std::vector< int32_t > >( pmu + "/cpumask" ).read();
+    if ( !type || !cpus || cpus->empty() )
+      return;
+
+    std::error_code ec;
+    for ( const auto &entry : std::filesystem::directory_iterator( pmu + "/events", ec ) )
+    {
+      // c2-residency ... c10-residency, content "event=0x06"
+      const std::string name = entry.path().filename().string();
+      if ( name.size() < 12 || name[ 0 ] != 'c' || !name.ends_with( "-residency" ) )
+        continue;
+      const auto spec = SysfsNode< std::string >( entry.path().string() ).read();
+      if ( !spec || spec->rfind( "event=", 0 ) != 0 )
+        continue;
+      const uint64_t config = std::strtoull( spec->c_str() + 6, nullptr, 0 );
+
+      for ( const int32_t cpu : *cpus )
+      {
+        perf_event_attr attr{};
+        attr.type = static_cast< uint32_t >( *type );
+        attr.size = sizeof( attr );
+        attr.config = config;
+        const long fd = syscall( SYS_perf_event_open, &attr, -1, cpu, -1, PERF_FLAG_FD_CLOEXEC );
+        if ( fd >= 0 )
+          m_residency.push_back( Residency{ static_cast< int >( fd ), 0 } );
+      }
+    }
+    m_packageCount = cpus->size();
+  }
+
+  double residency() noexcept
+  {
+    if ( m_residency.empty() )
+      return -1.0;
+
+    const uint64_t tsc = __rdtsc();
+    uint64_t ticks = 0;
+    bool complete = true;
+    for ( auto &r : m_residency )
+    {
+      uint64_t value = 0;
+      if ( read( r.fd, &value, sizeof( value ) ) != static_cast< ssize_t >( sizeof( value ) ) )
+      {
+        complete = false;
+        continue;
+      }
+      ticks += value - r.last;
+      r.last = value;
+    }
+
+    const bool primed = m_lastTsc != 0;
+    const uint64_t elapsed = tsc - m_lastTsc;
+    m_lastTsc = tsc;
+    if ( !primed || !complete || elapsed == 0 )
+      return -1.0;
+    // the states are exclusive, so their sum is the idle share of each package
+    const double pct = 100.0 * static_cast< double >( ticks ) /
+                       ( static_cast< double >( elapsed ) * static_cast< double >( m_packageCount ) );
+    return std::clamp( pct, 0.0, 100.0 );
+  }
+#else
+  void openResidency() {}
+  double residency() noexcept { return -1.0; }
+#endif
+
+  void closeResidency() noexcept
+  {
+    for ( auto &r : m_residency )
+      close( r.fd );
+    m_residency.clear();
+    m_lastTsc = 0;
+    m_packageCount = 0;
+  }
+
+  Paths m_paths;
+  std::vector< Counter > m_cores;
+  std::vector< Counter > m_packages;
+  std::vector< SysfsNode< int64_t > > m_limits;
+  std::vector< Residency > m_residency;
+  size_t m_packageCount = 0;
+  uint64_t m_lastTsc = 0;
+  int64_t m_lastMs = 0;
+};
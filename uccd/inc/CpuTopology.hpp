@@ -0,0 +1,190 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Core type on hybrid CPUs.
+ */
+enum class CpuCoreType : uint8_t
+{
+  Unknown,      ///< Not a hybrid part
+  Performance,  ///< Listed in cpu_core/cpus
+  Efficiency,   ///< Listed in cpu_atom/cpus
+};
+
+/**
+ * @brief Where one logical CPU sits on the package.
+ */
+struct CpuTopologyCore
+{
+  int32_t cpu = 0;
+  CpuCoreType type = CpuCoreType::Unknown;
+  int32_t clusterId = -1;                ///< topology/cluster_id, -1 if absent
+  int32_t capacity = -1;                 ///< cpu_capacity, -1 if absent
+  int32_t maxFreqKHz = -1;               ///< cpufreq/cpuinfo_max_freq
+  std::vector< int32_t > relatedCpus;    ///< CPUs of its cpufreq policy, itself included
+
+  bool operator==( const CpuTopologyCore & ) const = default;
+};
+
+/**
+ * @brief Core classes of a hybrid CPU, read once from sysfs.
+ *
+ * The type of each CPU comes from the first source that distinguishes
+ * the cores:
+ *   1. topology/core_type, where the kernel exposes it
+ *   2. the cpu_core / cpu_atom PMUs of Intel hybrid parts
+ *   3. cpu_capacity, the scheduler's view on ARM and newer x86 kernels
+ *   4. cpuinfo_max_freq, for parts like Zen 4c whose dense cores top out
+ *      far below the others; a gap of less than MIN_CLASS_FREQ_GAP is the
+ *      favoured-core spread of a uniform part and classifies nothing
+ *
+ * On a uniform CPU every core stays Unknown.
+ */
+class CpuTopology
+{
+public:
+  static constexpr double MIN_CLASS_FREQ_GAP = 0.2;
+
+  struct Paths
+  {
+    std::string cpuRoot = ucc::sysfsPath( "/sys/devices/system/cpu" );
+    std::string pmuRoot = ucc::sysfsPath( "/sys/devices" );
+  };
+
+  CpuTopology() = default;
+
+  [[nodiscard]] static CpuTopology discover() { return discover( Paths() ); }
+
+  [[nodiscard]] static CpuTopology discover( const Paths &paths )
+  {
+    CpuTopology topology;
+    auto present = SysfsNode< std::vector< int32_t > >( paths.cpuRoot + "/present" ).read();
+    if ( not present )
+      return topology;
+    std::ranges::sort( *present );
+
+    for ( const int32_t cpu : *present )
+    {
+      const std::string cpuPath = paths.cpuRoot + "/cpu" + std::to_string( cpu );
+      CpuTopologyCore core;
+      core.cpu = cpu;
+      core.clusterId = SysfsNode< int32_t >( cpuPath + "/topology/cluster_id" ).read().value_or( -1 );
+      core.capacity = SysfsNode< int32_t >( cpuPath + "/cpu_capacity" ).read().value_or( -1 );
+      core.maxFreqKHz = SysfsNode< int32_t >( cpuPath + "/cpufreq/cpuinfo_max_freq" ).read().value_or( -1 );
+      core.relatedCpus = SysfsNode< std::vector< int32_t > >( cpuPath + "/cpufreq/related_cpus", " " )
+                           .read()
+                           .value_or( std::vector< int32_t >{ cpu } );
+      topology.m_cores.push_back( std::move( core ) );
+    }
+
+    if ( not topology.classifyByCoreType( paths ) and not topology.classifyByPmu( paths )
+         and not topology.classifyByValue( &CpuTopologyCore::capacity, 0.0 ) )
+      topology.classifyByValue( &CpuTopologyCore::maxFreqKHz, MIN_CLASS_FREQ_GAP );
+    return topology;
+  }
+
+  [[nodiscard]] const std::vector< CpuTopologyCore > &cores() const noexcept { return m_cores; }
+
+  [[nodiscard]] CpuCoreType typeOf( int32_t cpu ) const noexcept
+  {
+    const auto it = std::ranges::find( m_cores, cpu, &CpuTopologyCore::cpu );
+    return it != m_cores.end() ? it->type : CpuCoreType::Unknown;
+  }
+
+  [[nodiscard]] size_t count( CpuCoreType type ) const noexcept
+  {
+    return static_cast< size_t >( std::ranges::count( m_cores, type, &CpuTopologyCore::type ) );
+  }
+
+  [[nodiscard]] bool isHybrid() const noexcept
+  {
+    return count( CpuCoreType::Performance ) > 0 and count( CpuCoreType::Efficiency ) > 0;
+  }
+
+private:
+  std::vector< CpuTopologyCore > m_cores;
+
+  /// Keep a classification only if it found both classes
+  bool commit( const std::vector< CpuCoreType > &types )
+  {
+    const bool hybrid = std::ranges::find( types, CpuCoreType::Performance ) != types.end()
+                        and std::ranges::find( types, CpuCoreType::Efficiency ) != types.end();
+    if ( hybrid )
+      for ( size_t i = 0; i < m_cores.size(); ++i )
+        m_cores[ i ].type = types[ i ];
+    return hybrid;
+  }
+
+  bool classifyByCoreType( const Paths &paths )
+  {
+    std::vector< CpuCoreType > types;
+    for ( const auto &core : m_cores )
+    {
+      const auto coreType = SysfsNode< std::string >( paths.cpuRoot + "/cpu" + std::to_string( core.cpu )
+                                                      + "/topology/core_type" ).read();
+      if ( not coreType )
+        types.push_back( CpuCoreType::Unknown );
+      else if ( coreType->find( "atom" ) != std::string::npos or coreType->find( "eff" ) != std::string::npos )
+        types.push_back( CpuCoreType::Efficiency );
+      else
+        types.push_back( CpuCoreType::Performance );
+    }
+    return commit( types );
+  }
+
+  bool classifyByPmu( const Paths &paths )
+  {
+    const auto pCores = SysfsNode< std::vector< int32_t > >( paths.pmuRoot + "/cpu_core/cpus" ).read();
+    const auto eCores = SysfsNode< std::vector< int32_t > >( paths.pmuRoot + "/cpu_atom/cpus" ).read();
+    const auto contains = []( const auto &list, int32_t cpu ) {
+      return list and std::ranges::find( *list, cpu ) != list->end();
+    };
+
+    std::vector< CpuCoreType > types;
+    for ( const auto &core : m_cores )
+      types.push_back( contains( pCores, core.cpu )   ? CpuCoreType::Performance
+                       : contains( eCores, core.cpu ) ? CpuCoreType::Efficiency
+                                                      : CpuCoreType::Unknown );
+    return commit( types );
+  }
+
+  /// Cores within @p minGap of the highest @p field are Performance, the others Efficiency
+  bool classifyByValue( int32_t CpuTopologyCore::*field, double minGap )
+  {
+    int32_t highest = -1;
+    for ( const auto &core : m_cores )
+      highest = std::max( highest, core.*field );
+    if ( highest <= 0 )
+      return false;
+
+    const double threshold = static_cast< double >( highest ) * ( 1.0 - minGap );
+    std::vector< CpuCoreType > types;
+    for ( const auto &core : m_cores )
+      types.push_back( core.*field <= 0           ? CpuCoreType::Unknown
+                       : core.*field < threshold  ? CpuCoreType::Efficiency
+                                                  : CpuCoreType::Performance );
+    return commit( types );
+  }
+};
@@ -0,0 +1,317 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <drm/drm.h>
+#include <drm/drm_mode.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**
+ * @brief Display mode structure
+ */
+struct DisplayMode
+{
+  std::vector< double > refreshRates;
+  int xResolution;
+  int yResolution;
+
+  DisplayMode() : xResolution( 0 ), yResolution( 0 ) {}
+};
+
+/**
+ * @brief Display information structure
+ */
+struct DisplayInfo
+{
+  std::string displayName;
+  DisplayMode activeMode;
+  std::vector< DisplayMode > displayModes;
+
+  DisplayInfo() : displayName( "" ) {}
+};
+
+/**
+ * @brief Modes of the internal panel, read from the kernel's mode setting.
+ *
+ * Uses the DRM mode ioctls of /dev/dri/card* directly (kernel UAPI, no
+ * libdrm), so it needs no X server and works the same under Wayland.
+ * Connectors are read without a forced probe: the kernel answers from
+ * the mode list of its last hotplug, which is what the compositor uses.
+ *
+ * Setting a mode needs DRM master, i.e. no compositor or X server running
+ * on the card (a text console, a greeter-less boot); with one running the
+ * mode has to go through it instead.
+ */
+class DrmDisplayModes
+{
+public:
+  static constexpr const char *DRI_DIR = "/dev/dri";
+
+  /// One mode as the kernel lists it
+  struct Mode
+  {
+    int width = 0;
+    int height = 0;
+    double refreshHz = 0.0;
+  };
+
+  /**
+   * @brief The connected eDP or LVDS panel of the first card that has one
+   * @return nullopt if no card drives an internal panel (e.g. no KMS driver)
+   */
+  [[nodiscard]] static std::optional< DisplayInfo > readInternalPanel( const std::string &driDir = DRI_DIR )
+  {
+    for ( const auto &card : listCards( driDir ) )
+    {
+      const int fd = ::open( card.c_str(), O_RDWR | O_CLOEXEC );
+      if ( fd < 0 )
+        continue;
+      auto info = readCard( fd );
+      ::close( fd );
+      if ( info )
+        return info;
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Switch the internal panel to @p width x @p height at @p refreshHz
+   *
+   * Keeps the framebuffer being scanned out.  Returns false, changing
+   * nothing, while another process holds DRM master or no listed mode
+   * matches.
+   */
+  static bool setInternalPanelMode( int width, int height, double refreshHz, const std::string &driDir = DRI_DIR )
+  {
+    for ( const auto &card : listCards( driDir ) )
+    {
+      const int fd = ::open( card.c_str(), O_RDWR | O_CLOEXEC );
+      if ( fd < 0 )
+        continue;
+      std::optional< bool > result;
+      if ( auto panel = findPanel( fd ) )
+        result = ioctlRetry( fd, DRM_IOCTL_SET_MASTER, nullptr ) and setMode( fd, *panel, width, height, refreshHz );
+      if ( result )
+        ioctlRetry( fd, DRM_IOCTL_DROP_MASTER, nullptr );
+      ::close( fd );
+      if ( result )
+        return *result;
+    }
+    return false;
+  }
+
+  /// Vertical refresh of @p mode in Hz, to two decimals as xrandr shows it
+  [[nodiscard]] static double refreshRate( const drm_mode_modeinfo &mode ) noexcept
+  {
+    if ( mode.htotal == 0 or mode.vtotal == 0 )
+      return static_cast< double >( mode.vrefresh );
+
+    double rate = mode.clock * 1000.0 / ( static_cast< double >( mode.htotal ) * mode.vtotal );
+    if ( mode.flags & DRM_MODE_FLAG_INTERLACE )
+      rate *= 2.0;
+    if ( mode.flags & DRM_MODE_FLAG_DBLSCAN )
+      rate /= 2.0;
+    if ( mode.vscan > 1 )
+      rate /= mode.vscan;
+    return std::round( rate * 100.0 ) / 100.0;
+  }
+
+  /**
+   * @brief Group @p modes by resolution, in the kernel's order (preferred first)
+   * @param active The mode the panel's CRTC scans out, if any
+   */
+  [[nodiscard]] static DisplayInfo group( std::string name, const std::vector< Mode > &modes,
+                                          const std::optional< Mode > &active )
+  {
+    DisplayInfo info;
+    info.displayName = std::move( name );
+    for ( const auto &mode : modes )
+    {
+      auto it = std::find_if( info.displayModes.begin(), info.displayModes.end(), [ & ]( const DisplayMode &m ) {
+        return m.xResolution == mode.width and m.yResolution == mode.height;
+      } );
+      if ( it == info.displayModes.end() )
+      {
+        info.displayModes.emplace_back();
+        it = std::prev( info.displayModes.end() );
+        it->xResolution = mode.width;
+        it->yResolution = mode.height;
+      }
+      if ( std::find( it->refreshRates.begin(), it->refreshRates.end(), mode.refreshHz ) == it->refreshRates.end() )
+        it->refreshRates.push_back( mode.refreshHz );
+    }
+
+    if ( active )
+    {
+      info.activeMode.xResolution = active->width;
+      info.activeMode.yResolution = active->height;
+      info.activeMode.refreshRates = { active->refreshHz };
+    }
+    return info;
+  }
+
+private:
+  static bool ioctlRetry( int fd, unsigned long request, void *arg ) noexcept
+  {
+    int ret;
+    do
+      ret = ::ioctl( fd, request, arg );
+    while ( ret == -1 and ( errno == EINTR or errno == EAGAIN ) );
+    return ret == 0;
+  }
+
+  template< typename T >
+  static uint64_t ptr( T *p ) noexcept
+  {
+    return static_cast< uint64_t >( reinterpret_cast< uintptr_t >( p ) );
+  }
+
+  static Mode toMode( const drm_mode_modeinfo &mode ) noexcept
+  {
+    return { mode.hdisplay, mode.vdisplay, refreshRate( mode ) };
+  }
+
+  /// The connected eDP or LVDS connector of a card and its modes
+  struct Panel
+  {
+    std::string name;
+    uint32_t connectorId = 0;
+    uint32_t encoderId = 0;
+    std::vector< drm_mode_modeinfo > modes;
+  };
+
+  static std::vector< std::string > listCards( const std::string &driDir )
+  {
+    std::error_code ec;
+    std::vector< std::string > cards;
+    for ( const auto &entry : std::filesystem::directory_iterator( driDir, ec ) )
+      if ( entry.path().filename().string().starts_with( "card" ) )
+        cards.push_back( entry.path().string() );
+    std::sort( cards.begin(), cards.end() );
+    return cards;
+  }
+
+  static std::optional< Panel > findPanel( int fd )
+  {
+    drm_mode_card_res res{};
+    if ( not ioctlRetry( fd, DRM_IOCTL_MODE_GETRESOURCES, &res ) or res.count_connectors == 0 )
+      return std::nullopt;
+    std::vector< uint32_t > connectors( res.count_connectors );
+    drm_mode_card_res ids{};
+    ids.connector_id_ptr = ptr( connectors.data() );
+    ids.count_connectors = res.count_connectors;
+    if ( not ioctlRetry( fd, DRM_IOCTL_MODE_GETRESOURCES, &ids ) )
+      return std::nullopt;
+    connectors.resize( std::min( ids.count_connectors, res.count_connectors ) );
+
+    for ( const uint32_t id : connectors )
+    {
+      // A non-zero mode count with room for one keeps the kernel from probing
+      drm_mode_modeinfo stub{};
+      drm_mode_get_connector conn{};
+      conn.connector_id = id;
+      conn.modes_ptr = ptr( &stub );
+      conn.count_modes = 1;
+      if ( not ioctlRetry( fd, DRM_IOCTL_MODE_GETCONNECTOR, &conn ) )
+        continue;
+
+      const char *type = conn.connector_type == DRM_MODE_CONNECTOR_eDP    ? "eDP"
+                         : conn.connector_type == DRM_MODE_CONNECTOR_LVDS ? "LVDS"
+                                                                          : nullptr;
+      if ( type == nullptr or conn.connection != 1 or conn.count_modes == 0 )
+        continue;
+
+      Panel panel;
+      panel.modes.resize( conn.count_modes );
+      drm_mode_get_connector full{};
+      full.connector_id = id;
+      full.modes_ptr = ptr( panel.modes.data() );
+      full.count_modes = conn.count_modes;
+      if ( not ioctlRetry( fd, DRM_IOCTL_MODE_GETCONNECTOR, &full ) )
+        continue;
+      panel.modes.resize( std::min( full.count_modes, conn.count_modes ) );
+      panel.name = std::string( type ) + "-" + std::to_string( full.connector_type_id );
+      panel.connectorId = id;
+      panel.encoderId = full.encoder_id;
+      return panel;
+    }
+    return std::nullopt;
+  }
+
+  static std::optional< DisplayInfo > readCard( int fd )
+  {
+    auto panel = findPanel( fd );
+    if ( not panel )
+      return std::nullopt;
+
+    std::vector< Mode > list;
+    for ( const auto &mode : panel->modes )
+      list.push_back( toMode( mode ) );
+    return group( std::move( panel->name ), list, activeMode( fd, panel->encoderId ) );
+  }
+
+  static std::optional< drm_mode_crtc > activeCrtc( int fd, uint32_t encoderId )
+  {
+    if ( encoderId == 0 )
+      return std::nullopt;
+    drm_mode_get_encoder encoder{};
+    encoder.encoder_id = encoderId;
+    if ( not ioctlRetry( fd, DRM_IOCTL_MODE_GETENCODER, &encoder ) or encoder.crtc_id == 0 )
+      return std::nullopt;
+    drm_mode_crtc crtc{};
+    crtc.crtc_id = encoder.crtc_id;
+    if ( not ioctlRetry( fd, DRM_IOCTL_MODE_GETCRTC, &crtc ) or not crtc.mode_valid )
+      return std::nullopt;
+    return crtc;
+  }
+
+  static bool setMode( int fd, const Panel &panel, int width, int height, double refreshHz )
+  {
+    const auto mode = std::find_if( panel.modes.begin(), panel.modes.end(), [ & ]( const drm_mode_modeinfo &m ) {
+      return m.hdisplay == width and m.vdisplay == height and std::abs( refreshRate( m ) - refreshHz ) < 0.1;
+    } );
+    auto crtc = activeCrtc( fd, panel.encoderId );
+    if ( mode == panel.modes.end() or not crtc or crtc->fb_id == 0 )
+      return false;
+
+    uint32_t connectorId = panel.connectorId;
+    crtc->set_connectors_ptr = ptr( &connectorId );
+    crtc->count_connectors = 1;
+    crtc->mode = *mode;
+    crtc->mode_valid = 1;
+    return ioctlRetry( fd, DRM_IOCTL_MODE_SETCRTC, &*crtc );
+  }
+
+  static std::optional< Mode > activeMode( int fd, uint32_t encoderId )
+  {
+    const auto crtc = activeCrtc( fd, encoderId );
+    if ( not crtc )
+      return std::nullopt;
+    return toMode( crtc->mode );
+  }
+};
@@ -0,0 +1,355 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "UccTrace.hpp"
+#include "tuxedo_io_lib/targets/interface.h"
+
+/**
+ * @brief One typed EC access within an EcBatch
+ */
+struct EcRequest
+{
+  enum class Op : uint8_t
+  {
+    // writes
+    SetFanSpeed,
+    SetFansAuto,
+    SetWebcam,
+    SetTdp,
+    // reads
+    FanTemperature,
+    FanSpeed,
+    Webcam,
+    Tdp,
+  };
+
+  Op op;
+  int index = 0;   ///< fan or TDP number
+  int value = 0;   ///< argument of a write, result of a read
+  bool ok = false; ///< set by EcIoService::execute()
+
+  [[nodiscard]] bool isWrite() const noexcept { return op < Op::FanTemperature; }
+
+  static EcRequest fanTemperature( int fan ) { return { Op::FanTemperature, fan }; }
+  static EcRequest fanSpeed( int fan ) { return { Op::FanSpeed, fan }; }
+  static EcRequest webcam() { return { Op::Webcam }; }
+  static EcRequest tdp( int index ) { return { Op::Tdp, index }; }
+  static EcRequest setFanSpeed( int fan, int percent ) { return { Op::SetFanSpeed, fan, percent }; }
+  static EcRequest setFansAuto() { return { Op::SetFansAuto }; }
+  static EcRequest setWebcam( bool on ) { return { Op::SetWebcam, 0, on ? 1 : 0 }; }
+  static EcRequest setTdp( int index, int value ) { return { Op::SetTdp, index, value }; }
+};
+
+using EcBatch = std::vector< EcRequest >;
+
+/**
+ * @brief The one thread that talks to the EC behind /dev/tuxedo_io
+ *
+ * The fan loop, the service tick, the profile worker and the webcam probe
+ * all reach the same slow EC.  Instead of each of them issuing ioctls from
+ * its own thread, they hand execute() a batch ("all fan temperatures") and
+ * wait for it; the EC thread takes every batch queued meanwhile and runs
+ * their writes first, in submission order, then their reads.  A read of
+ * the same quantity within COALESCE_WINDOW_MS of an earlier one (in the
+ * same drain or a previous one) is answered from that result instead of
+ * the EC; a write drops the cached reads it affects.
+ *
+ * call() runs anything else on the device (TDP descriptors, model id, ...)
+ * on the EC thread, ordered with the writes; it forgets every cached read.
+ * Both may be used from the EC thread itself and then run inline.
+ */
+class EcIoService
+{
+public:
+  /// Well below the fastest fan cycle (250 ms): a cycle never reuses the previous one's reading
+  static constexpr int64_t COALESCE_WINDOW_MS = 100;
+
+  using Clock = std::function< int64_t() >;
+
+  struct Stats
+  {
+    uint64_t deviceCalls = 0;    ///< requests that reached the device
+    uint64_t coalescedReads = 0; ///< reads answered from an earlier one
+    uint64_t drains = 0;         ///< rounds of the EC thread
+  };
+
+  explicit EcIoService( DeviceInterface &device, int64_t coalesceWindowMs = COALESCE_WINDOW_MS,
+                        Clock clock = steadyMs )
+    : m_device( device ), m_windowMs( coalesceWindowMs ), m_clock( std::move( clock ) )
+  {
+    m_thread = std::thread( [this] { run(); } );
+  }
+
+  ~EcIoService()
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+  }
+
+  EcIoService( const EcIoService & ) = delete;
+  EcIoService &operator=( const EcIoService & ) = delete;
+
+  /**
+   * @brief Run @p batch on the EC thread and wait for it
+   * @return true if every request succeeded; each one carries its own ok
+   */
+  bool execute( EcBatch &batch )
+  {
+    Pending pending;
+    pending.batch = &batch;
+    submit( pending );
+
+    bool allOk = true;
+    for ( const EcRequest &request : batch )
+      allOk = allOk and request.ok;
+    return allOk;
+  }
+
+  /**
+   * @brief Run @p f( DeviceInterface & ) on the EC thread and return its result
+   */
+  template< typename F >
+  auto call( F &&f ) -> std::invoke_result_t< F &, DeviceInterface & >
+  {
+    using Result = std::invoke_result_t< F &, DeviceInterface & >;
+    Pending pending;
+    if constexpr ( std::is_void_v< Result > )
+    {
+      pending.task = [&f]( DeviceInterface &device ) { f( device ); };
+      submit( pending );
+    }
+    else
+    {
+      std::optional< Result > result;
+      pending.task = [&f, &result]( DeviceInterface &device ) { result.emplace( f( device ) ); };
+      submit( pending );
+      return std::move( *result );
+    }
+  }
+
+  [[nodiscard]] Stats stats() const noexcept
+  {
+    return { m_deviceCalls.load( std::memory_order_relaxed ), m_coalescedReads.load( std::memory_order_relaxed ),
+             m_drains.load( std::memory_order_relaxed ) };
+  }
+
+private:
+  struct Pending
+  {
+    EcBatch *batch = nullptr;
+    std::function< void( DeviceInterface & ) > task;
+    bool done = false;
+  };
+
+  struct CachedRead
+  {
+    int64_t atMs;
+    int value;
+    bool ok;
+    bool valid = true;  ///< Cleared by a write; the entry stays so the next read reuses its node
+  };
+
+  static int64_t steadyMs()
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  void submit( Pending &pending )
+  {
+    if ( std::this_thread::get_id() == m_thread.get_id() )
+    {
+      Pending *const work[] = { &pending };
+      process( work );
+      return;
+    }
+
+    std::unique_lock< std::mutex > lock( m_mutex );
+    m_queue.push_back( &pending );
+    m_wake.notify_one();
+    m_done.wait( lock, [&pending] { return pending.done; } );
+  }
+
+  void run()
+  {
+    for ( ;; )
+    {
+      // the two buffers trade places, so neither submit() nor the drain allocates once warm
+      m_work.clear();
+      {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        m_wake.wait( lock, [this] { return m_stop or not m_queue.empty(); } );
+        if ( m_queue.empty() )
+          return;
+        m_work.swap( m_queue );
+      }
+
+      process( m_work );
+
+      {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        for ( Pending *pending : m_work )
+          pending->done = true;
+      }
+      m_done.notify_all();
+    }
+  }
+
+  void process( std::span< Pending *const > work )
+  {
+    UCC_TRACE_SCOPE_ARG( "ec", "drain", work.size() );
+    m_drains.fetch_add( 1, std::memory_order_relaxed );
+
+    // writes and other calls first, so the reads see their effect
+    for ( Pending *pending : work )
+    {
+      if ( pending->task )
+      {
+        pending->task( m_device );
+        for ( auto &entry : m_reads )
+          entry.second.valid = false;
+        continue;
+      }
+      for ( EcRequest &request : *pending->batch )
+        if ( request.isWrite() )
+          write( request );
+    }
+
+    const int64_t now = m_clock();
+    for ( Pending *pending : work )
+    {
+      if ( pending->task )
+        continue;
+      for ( EcRequest &request : *pending->batch )
+        if ( not request.isWrite() )
+          read( request, now );
+    }
+  }
+
+  void write( EcRequest &request )
+  {
+    m_deviceCalls.fetch_add( 1, std::memory_order_relaxed );
+    switch ( request.op )
+    {
+      case EcRequest::Op::SetFanSpeed:
+        request.ok = m_device.setFanSpeedPercent( request.index, request.value );
+        forget( EcRequest::Op::FanSpeed, request.index );
+        break;
+      case EcRequest::Op::SetFansAuto:
+        request.ok = m_device.setFansAuto();
+        for ( auto &[ key, cached ] : m_reads )
+          if ( key.first == EcRequest::Op::FanSpeed )
+            cached.valid = false;
+        break;
+      case EcRequest::Op::SetWebcam:
+        request.ok = m_device.setWebcam( request.value != 0 );
+        forget( EcRequest::Op::Webcam, 0 );
+        break;
+      case EcRequest::Op::SetTdp:
+        request.ok = m_device.setTDP( request.index, request.value );
+        forget( EcRequest::Op::Tdp, request.index );
+        break;
+      default:
+        request.ok = false;
+        break;
+    }
+  }
+
+  void forget( EcRequest::Op op, int index )
+  {
+    if ( const auto it = m_reads.find( { op, index } ); it != m_reads.end() )
+      it->second.valid = false;
+  }
+
+  void read( EcRequest &request, int64_t now )
+  {
+    const std::pair< EcRequest::Op, int > key{ request.op, request.index };
+    if ( const auto it = m_reads.find( key );
+         it != m_reads.end() and it->second.valid and now - it->second.atMs < m_windowMs )
+    {
+      request.value = it->second.value;
+      request.ok = it->second.ok;
+      m_coalescedReads.fetch_add( 1, std::memory_order_relaxed );
+      return;
+    }
+
+    m_deviceCalls.fetch_add( 1, std::memory_order_relaxed );
+    int value = -1;
+    switch ( request.op )
+    {
+      case EcRequest::Op::FanTemperature:
+        request.ok = m_device.getFanTemperature( request.index, value );
+        break;
+      case EcRequest::Op::FanSpeed:
+        request.ok = m_device.getFanSpeedPercent( request.index, value );
+        break;
+      case EcRequest::Op::Webcam:
+      {
+        bool on = false;
+        request.ok = m_device.getWebcam( on );
+        value = on ? 1 : 0;
+        break;
+      }
+      case EcRequest::Op::Tdp:
+        request.ok = m_device.getTDP( request.index, value );
+        break;
+      default:
+        request.ok = false;
+        break;
+    }
+    request.value = value;
+    m_reads[ key ] = CachedRead{ now, value, request.ok, true };
+  }
+
+  DeviceInterface &m_device;
+  const int64_t m_windowMs;
+  const Clock m_clock;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  std::vector< Pending * > m_queue;
+  bool m_stop = false;
+
+  // EC thread only
+  std::vector< Pending * > m_work;
+  std::map< std::pair< EcRequest::Op, int >, CachedRead > m_reads;
+
+  std::atomic< uint64_t > m_deviceCalls{ 0 };
+  std::atomic< uint64_t > m_coalescedReads{ 0 };
+  std::atomic< uint64_t > m_drains{ 0 };
+
+  std::thread m_thread;
+};
@@ -0,0 +1,417 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "JsonWriter.hpp"
+#include "PersistQueue.hpp"
+
+/**
+ * @brief How one fan answers a duty change, measured by FanCalibrationRun
+ *
+ * Times are from the write to the speed the EC reports back.  All zero
+ * means not measured; FanControlLogic then keeps its defaults.
+ */
+struct FanResponse
+{
+  int minDuty = 0;       ///< Lowest duty that keeps the fan turning, 0 if unknown
+  int deadTimeMs = 0;    ///< Until the speed moved 5 % of a step
+  int riseTauMs = 0;     ///< Dead time to 63 % of a step up
+  int fallTauMs = 0;     ///< Dead time to 63 % of a step down
+  int settleMs = 0;      ///< Until a step up stays within 5 % of its end
+  int overshootPct = 0;  ///< Past the end of a step up, in % of the step
+
+  bool operator==( const FanResponse & ) const = default;
+
+  [[nodiscard]] bool measured() const noexcept { return riseTauMs > 0 || fallTauMs > 0 || minDuty > 0; }
+};
+
+/**
+ * @brief Timing of one recorded duty step, see analyze()
+ */
+struct FanStepResponse
+{
+  int deadTimeMs = 0;
+  int tauMs = 0;       ///< Dead time to 63 % of the step
+  int settleMs = 0;
+  int overshootPct = 0;
+
+  /**
+   * @param speeds Speeds read back after the write, as (ms since the write, speed)
+   * @param initial Speed before the write
+   * @return nullopt if the speed moved by less than MIN_STEP
+   */
+  [[nodiscard]] static std::optional< FanStepResponse >
+  analyze( const std::vector< std::pair< int64_t, int > > &speeds, int initial )
+  {
+    static constexpr int MIN_STEP = 5;
+    if ( speeds.empty() )
+      return std::nullopt;
+
+    const int final = speeds.back().second;
+    const int step = final - initial;
+    if ( std::abs( step ) < MIN_STEP )
+      return std::nullopt;
+
+    const auto moved = [ initial, step ]( int speed, double fraction ) {
+      return ( speed - initial ) * ( step > 0 ? 1 : -1 ) >= fraction * std::abs( step );
+    };
+    const auto firstMoved = [ & ]( double fraction ) {
+      const auto it = std::find_if( speeds.begin(), speeds.end(),
+                                    [ & ]( const auto &s ) { return moved( s.second, fraction ); } );
+      return it->first;  // the last sample always qualifies
+    };
+
+    FanStepResponse r;
+    r.deadTimeMs = static_cast< int >( firstMoved( 0.05 ) );
+    r.tauMs = static_cast< int >( firstMoved( 0.632 ) ) - r.deadTimeMs;
+
+    // settled from the sample after the last one outside the 5 % band
+    const double band = 0.05 * std::abs( step );
+    int64_t settle = 0;
+    int peak = 0;
+    for ( size_t i = 0; i < speeds.size(); ++i )
+    {
+      if ( std::abs( speeds[ i ].second - final ) > band )
+        settle = i + 1 < speeds.size() ? speeds[ i + 1 ].first : speeds[ i ].first;
+      peak = std::max( peak, ( speeds[ i ].second - final ) * ( step > 0 ? 1 : -1 ) );
+    }
+    r.settleMs = static_cast< int >( settle );
+    r.overshootPct = peak * 100 / std::abs( step );
+    return r;
+  }
+};
+
+/**
+ * @brief The calibration sequence, fed with speed readbacks by the fan worker
+ *
+ * One duty is commanded to all fans; each fan's readback is judged on its
+ * own:
+ *   1. Settle at the lowest duty (off where the EC allows it).
+ *   2. Step to 100 % and record the rise until the speed holds still.
+ *   3. Step back down and record the fall.
+ *   4. Walk down from SWEEP_START in SWEEP_STEP steps, each held at least
+ *      SWEEP_HOLD_MS and until the speeds hold still; the duty above the
+ *      one a fan stopped at (fell below half the duty) is its minimum.
+ *
+ * A speed holds still once it stayed within STABLE_TOLERANCE for
+ * STABLE_MS; a phase that does not settle ends after its timeout.  The
+ * whole run takes one to three minutes.
+ *
+ * Not thread-safe; only the fan worker touches it.
+ */
+class FanCalibrationRun
+{
+public:
+  enum class Phase : uint8_t
+  {
+    Idle,
+    Settle,
+    StepUp,
+    StepDown,
+    Sweep,
+    Done,
+    Failed,
+  };
+
+  static constexpr int64_t STABLE_MS = 3000;
+  static constexpr int STABLE_TOLERANCE = 2;
+  static constexpr int64_t SETTLE_TIMEOUT_MS = 15'000;
+  static constexpr int64_t STEP_TIMEOUT_MS = 20'000;
+  static constexpr int SWEEP_START = 50;
+  static constexpr int SWEEP_STEP = 5;
+  static constexpr int64_t SWEEP_HOLD_MS = 4000;
+
+  [[nodiscard]] static const char *phaseName( Phase phase ) noexcept
+  {
+    switch ( phase )
+    {
+      case Phase::Idle: return "idle";
+      case Phase::Settle: return "settle";
+      case Phase::StepUp: return "step-up";
+      case Phase::StepDown: return "step-down";
+      case Phase::Sweep: return "sweep";
+      case Phase::Done: return "done";
+      case Phase::Failed: return "failed";
+    }
+    return "unknown";
+  }
+
+  /**
+   * @param lowDuty Duty of the settle and step-down phases: 0 if the fans
+   *        may stop, else the EC's minimum
+   */
+  void start( size_t fans, int lowDuty, int64_t nowMs )
+  {
+    m_fans.assign( fans, Fan{} );
+    m_lowDuty = std::clamp( lowDuty, 0, SWEEP_START );
+    m_error.clear();
+    enter( Phase::Settle, m_lowDuty, nowMs );
+  }
+
+  /// Stop with @p error; the fans go back to regular control
+  void fail( std::string error )
+  {
+    m_error = std::move( error );
+    m_phase = Phase::Failed;
+  }
+
+  [[nodiscard]] bool running() const noexcept
+  {
+    return m_phase != Phase::Idle && m_phase != Phase::Done && m_phase != Phase::Failed;
+  }
+
+  [[nodiscard]] Phase phase() const noexcept { return m_phase; }
+  [[nodiscard]] int duty() const noexcept { return m_duty; }
+  [[nodiscard]] const std::string &error() const noexcept { return m_error; }
+
+  /**
+   * @brief Feed the speeds read back at @p nowMs, -1 for a failed read
+   * @return The duty to command from now on
+   */
+  int update( int64_t nowMs, const std::vector< int > &speeds )
+  {
+    if ( !running() )
+      return m_duty;
+
+    const int64_t elapsed = nowMs - m_phaseMs;
+    for ( size_t i = 0; i < m_fans.size() && i < speeds.size(); ++i )
+      if ( speeds[ i ] >= 0 )
+        m_fans[ i ].samples.emplace_back( elapsed, speeds[ i ] );
+
+    switch ( m_phase )
+    {
+      case Phase::Settle:
+        if ( allStable() || elapsed >= SETTLE_TIMEOUT_MS )
+          enter( Phase::StepUp, 100, nowMs );
+        break;
+
+      case Phase::StepUp:
+        if ( allStable() || elapsed >= STEP_TIMEOUT_MS )
+        {
+          for ( Fan &fan : m_fans )
+            if ( const auto step = FanStepResponse::analyze( fan.samples, fan.initial ) )
+            {
+              fan.response.deadTimeMs = step->deadTimeMs;
+              fan.response.riseTauMs = step->tauMs;
+              fan.response.settleMs = step->settleMs;
+              fan.response.overshootPct = step->overshootPct;
+            }
+          if ( std::none_of( m_fans.begin(), m_fans.end(), []( const Fan &fan ) { return fan.response.riseTauMs > 0; } ) )
+          {
+            fail( "no fan speed followed the duty" );
+            break;
+          }
+          enter( Phase::StepDown, m_lowDuty, nowMs );
+        }
+        break;
+
+      case Phase::StepDown:
+        if ( allStable() || elapsed >= STEP_TIMEOUT_MS )
+        {
+          for ( Fan &fan : m_fans )
+            if ( const auto step = FanStepResponse::analyze( fan.samples, fan.initial ) )
+              fan.response.fallTauMs = step->tauMs;
+          enter( Phase::Sweep, SWEEP_START, nowMs );
+        }
+        break;
+
+      case Phase::Sweep:
+        // a fan coasting down to a stop reads as turning until it settled
+        if ( elapsed >= SWEEP_HOLD_MS && ( allStable() || elapsed >= STEP_TIMEOUT_MS ) )
+        {
+          for ( Fan &fan : m_fans )
+            if ( fan.response.minDuty == 0 && !fan.samples.empty() && stopped( fan.samples.back().second ) )
+              fan.response.minDuty = std::min( m_duty + SWEEP_STEP, 100 );
+          const bool allStopped = std::all_of( m_fans.begin(), m_fans.end(),
+                                               []( const Fan &fan ) { return fan.response.minDuty > 0; } );
+          const int next = m_duty - SWEEP_STEP;
+          if ( allStopped || next < std::max( m_lowDuty, 1 ) )
+          {
+            m_phase = Phase::Done;
+            m_duty = m_lowDuty;
+          }
+          else
+            enter( Phase::Sweep, next, nowMs );
+        }
+        break;
+
+      default:
+        break;
+    }
+    return m_duty;
+  }
+
+  /// The measured response of every fan, once phase() is Done
+  [[nodiscard]] std::vector< FanResponse > result() const
+  {
+    std::vector< FanResponse > responses;
+    responses.reserve( m_fans.size() );
+    for ( const Fan &fan : m_fans )
+      responses.push_back( fan.response );
+    return responses;
+  }
+
+private:
+  struct Fan
+  {
+    int initial = 0;  ///< Speed when the phase began
+    std::vector< std::pair< int64_t, int > > samples;  ///< This phase: (ms since its start, speed)
+    FanResponse response;
+  };
+
+  void enter( Phase phase, int duty, int64_t nowMs )
+  {
+    for ( Fan &fan : m_fans )
+    {
+      if ( !fan.samples.empty() )
+        fan.initial = fan.samples.back().second;
+      fan.samples.clear();
+    }
+    m_phase = phase;
+    m_duty = duty;
+    m_phaseMs = nowMs;
+  }
+
+  /// Below half the duty: stalled, possibly still coasting down
+  [[nodiscard]] bool stopped( int speed ) const noexcept { return speed * 2 < m_duty; }
+
+  /// Every fan's speed stayed within STABLE_TOLERANCE for the last STABLE_MS
+  [[nodiscard]] bool allStable() const
+  {
+    for ( const Fan &fan : m_fans )
+    {
+      if ( fan.samples.empty() || fan.samples.back().first < STABLE_MS )
+        return false;
+      const int64_t from = fan.samples.back().first - STABLE_MS;
+      int lo = fan.samples.back().second, hi = lo;
+      for ( auto it = fan.samples.rbegin(); it != fan.samples.rend() && it->first >= from; ++it )
+      {
+        lo = std::min( lo, it->second );
+        hi = std::max( hi, it->second );
+      }
+      if ( hi - lo > STABLE_TOLERANCE )
+        return false;
+    }
+    return true;
+  }
+
+  Phase m_phase = Phase::Idle;
+  int m_duty = 0;
+  int m_lowDuty = 0;
+  int64_t m_phaseMs = 0;
+  std::vector< Fan > m_fans;
+  std::string m_error;
+};
+
+/**
+ * @brief The measured fan responses of this machine, kept across restarts
+ *
+ * Stored under the DMI identity; a model of another machine (a moved disk
+ * or a swapped board) is not loaded.
+ *
+ * File format: "ucc-fan-response 1", "dmi\t<dmi>", then one line per fan:
+ * "<minDuty>\t<deadTimeMs>\t<riseTauMs>\t<fallTauMs>\t<settleMs>\t<overshootPct>".
+ */
+struct FanResponseModel
+{
+  static constexpr const char *DEFAULT_PATH = "/var/lib/ucc/fan-response";
+
+  std::string dmi;
+  std::vector< FanResponse > fans;
+
+  /// The model saved at @p path for @p dmi, nullopt if there is none
+  [[nodiscard]] static std::optional< FanResponseModel > load( const std::string &dmi,
+                                                               const std::string &path = DEFAULT_PATH )
+  {
+    std::ifstream in( path );
+    std::string line;
+    if ( !std::getline( in, line ) || line != MAGIC || !std::getline( in, line ) || line != "dmi\t" + dmi )
+      return std::nullopt;
+
+    FanResponseModel model{ dmi, {} };
+    while ( std::getline( in, line ) )
+    {
+      std::replace( line.begin(), line.end(), '\t', ' ' );
+      std::istringstream fields( line );
+      FanResponse fan;
+      if ( !( fields >> fan.minDuty >> fan.deadTimeMs >> fan.riseTauMs >> fan.fallTauMs >> fan.settleMs
+                     >> fan.overshootPct ) )
+        return std::nullopt;
+      model.fans.push_back( fan );
+    }
+    if ( model.fans.empty() )
+      return std::nullopt;
+    return model;
+  }
+
+  bool save( const std::string &path = DEFAULT_PATH ) const
+  {
+    if ( dmi.find( '\n' ) != std::string::npos )
+      return false;
+    std::string content = std::string( MAGIC ) + "\ndmi\t" + dmi + '\n';
+    for ( const FanResponse &fan : fans )
+      content += std::to_string( fan.minDuty ) + '\t' + std::to_string( fan.deadTimeMs ) + '\t'
+                 + std::to_string( fan.riseTauMs ) + '\t' + std::to_string( fan.fallTauMs ) + '\t'
+                 + std::to_string( fan.settleMs ) + '\t' + std::to_string( fan.overshootPct ) + '\n';
+    std::error_code ec;
+    std::filesystem::create_directories( std::filesystem::path( path ).parent_path(), ec );
+    return writeFileDurably( path, content, 0644 );
+  }
+
+  /// Forget the model saved at @p path
+  static void forget( const std::string &path = DEFAULT_PATH )
+  {
+    std::error_code ec;
+    std::filesystem::remove( path, ec );
+  }
+
+  /**
+   * @brief The fans as JSON
+   *
+   * @code
+   * [ { "minDuty": 20, "deadTimeMs": 500, "riseTauMs": 1250, "fallTauMs": 4000,
+   *     "settleMs": 3500, "overshootPct": 4 }, ... ]
+   * @endcode
+   */
+  static void fansJSON( JsonWriter &w, const std::vector< FanResponse > &fans )
+  {
+    w.beginArray();
+    for ( const FanResponse &fan : fans )
+      w.beginObject()
+        .key( "minDuty" ).value( fan.minDuty )
+        .key( "deadTimeMs" ).value( fan.deadTimeMs )
+        .key( "riseTauMs" ).value( fan.riseTauMs )
+        .key( "fallTauMs" ).value( fan.fallTauMs )
+        .key( "settleMs" ).value( fan.settleMs )
+        .key( "overshootPct" ).value( fan.overshootPct )
+        .endObject();
+    w.endArray();
+  }
+
+private:
+  static constexpr const char *MAGIC = "ucc-fan-response 1";
+};
@@ -0,0 +1,633 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "profiles/FanProfile.hpp"
+#include "FanCalibration.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+enum class FanLogicType { CPU, GPU };
+
+/**
+ * @brief Per-cycle EWMA weight rescaled to a cycle of @p dtSeconds.
+ *
+ * The smoothing constants below were tuned for the historic 1 s fan tick;
+ * with an adaptive tick the weight is compounded so the response in wall
+ * time stays the same: 1 - (1 - alpha)^dt.
+ */
+inline double ewmaAlphaForInterval( double alpha, double dtSeconds )
+{
+  if ( dtSeconds == 1.0 )
+    return alpha;
+  return 1.0 - std::pow( 1.0 - alpha, std::clamp( dtSeconds, 0.0, 10.0 ) );
+}
+
+/**
+ * @brief Temperature filter using Exponentially Weighted Moving Average (EWMA)
+ *
+ * Replaces the old trimmed-mean buffer.  EWMA reacts faster to genuine
+ * temperature changes while still rejecting single-sample noise.
+ * Two different smoothing factors are used:
+ *   - alphaRising  (0.5) — when new reading is above current estimate,
+ *                           respond quickly to heating.
+ *   - alphaFalling (0.15) — when new reading is below current estimate,
+ *                           cool-down is smoothed more aggressively to
+ *                           prevent premature fan-speed drops.
+ */
+class TemperatureFilter
+{
+public:
+  TemperatureFilter()
+    : m_value( -1.0 )
+    , m_alphaRising( 0.5 )
+    , m_alphaFalling( 0.15 )
+  {}
+
+  void addValue( int raw, double dtSeconds = 1.0 )
+  {
+    if ( m_value < 0.0 )
+    {
+      // First sample — initialise immediately
+      m_value = static_cast< double >( raw );
+      return;
+    }
+
+    const double alpha = ewmaAlphaForInterval( ( raw > m_value ) ? m_alphaRising : m_alphaFalling, dtSeconds );
+    m_value = m_value + alpha * ( static_cast< double >( raw ) - m_value );
+  }
+
+  int getFilteredValue() const
+  {
+    return ( m_value < 0.0 ) ? 0 : static_cast< int >( std::round( m_value ) );
+  }
+
+private:
+  double m_value;
+  double m_alphaRising;   // weight for rising temperatures (fast response)
+  double m_alphaFalling;  // weight for falling temperatures (slow decay)
+};
+
+/**
+ * @brief PID on the temperature error with a package-power feed-forward
+ *
+ *   out = ff * max( 0, P - idle ) + kp * e + integral( ki * e ) + kd * dT/dt,
+ *   e = T - target
+ *
+ * The power term moves the fans as soon as a load draws power, before the
+ * heat reaches the sensor; the PID trims whatever the power does not explain.
+ *   - The derivative uses the measured temperature, not the error, so a
+ *     new target does not kick the output, and is low-pass filtered.
+ *   - The integral is held while the output sits at a limit in the
+ *     direction of the error (anti-windup).
+ *   - The first update seeds the integral so that the output starts at the
+ *     lower limit, which makes switching from curve mode bumpless.
+ */
+class FanPidController
+{
+public:
+  static constexpr double DERIVATIVE_ALPHA = 0.3;  ///< Per-second weight of a new dT/dt sample
+
+  void reset() noexcept { m_primed = false; }
+
+  /**
+   * @param temp Filtered temperature, °C
+   * @param watts Package power of the fan's heat source, < 0 if unknown
+   * @param minSpeed Lowest output; the integral does not wind below it
+   * @return Fan speed in [minSpeed, 100]
+   */
+  double update( const FanControllerSettings &s, double temp, double watts, double dtSeconds, double minSpeed ) noexcept
+  {
+    const double lo = std::clamp( minSpeed, 0.0, 100.0 );
+    const double error = temp - static_cast< double >( s.targetTemp );
+    const double feedForward = watts > 0.0 ? s.feedForwardPerWatt * std::max( 0.0, watts - s.idleWatts ) : 0.0;
+
+    if ( !m_primed )
+    {
+      m_primed = true;
+      m_lastTemp = temp;
+      m_derivative = 0.0;
+      m_integral = std::clamp( lo - feedForward - s.kp * error, -100.0, 100.0 );
+      return lo;
+    }
+
+    if ( dtSeconds > 0.0 )
+    {
+      const double rate = ( temp - m_lastTemp ) / dtSeconds;
+      m_derivative += ewmaAlphaForInterval( DERIVATIVE_ALPHA, dtSeconds ) * ( rate - m_derivative );
+    }
+    m_lastTemp = temp;
+
+    const double proportional = feedForward + s.kp * error + s.kd * m_derivative;
+    const double integral = m_integral + s.ki * error * std::max( dtSeconds, 0.0 );
+    const double out = proportional + integral;
+    const bool saturated = ( out > 100.0 && error > 0.0 ) || ( out < lo && error < 0.0 );
+    if ( !saturated )
+      m_integral = std::clamp( integral, -100.0, 100.0 );
+
+    return std::clamp( proportional + m_integral, lo, 100.0 );
+  }
+
+private:
+  bool m_primed = false;
+  double m_lastTemp = 0.0;
+  double m_derivative = 0.0;  // filtered dT/dt, °C/s
+  double m_integral = 0.0;
+};
+
+/**
+ * @brief Recent package power of a fan's heat source, from the metrics history
+ */
+struct FanPowerTrend
+{
+  size_t samples = 0;     ///< Samples in the window; fewer than 2 means unknown
+  double minWatts = 0.0;  ///< Lowest sample in the window
+  double slopeWps = 0.0;  ///< Least-squares slope over the window, W/s
+
+  /**
+   * @param points Samples in time order with @c timestampMs (ms) and @c value (W)
+   */
+  template< typename Points >
+  [[nodiscard]] static FanPowerTrend fromSamples( const Points &points ) noexcept
+  {
+    FanPowerTrend trend;
+    trend.samples = std::size( points );
+    if ( trend.samples < 2 )
+      return trend;
+
+    // centred on the first sample to keep the sums small
+    const int64_t t0 = std::begin( points )->timestampMs;
+    double sumT = 0.0, sumW = 0.0, sumTT = 0.0, sumTW = 0.0;
+    trend.minWatts = std::begin( points )->value;
+    for ( const auto &p : points )
+    {
+      const double t = static_cast< double >( p.timestampMs - t0 ) / 1000.0;
+      sumT += t;
+      sumW += p.value;
+      sumTT += t * t;
+      sumTW += t * p.value;
+      trend.minWatts = std::min( trend.minWatts, p.value );
+    }
+    const double n = static_cast< double >( trend.samples );
+    const double denom = n * sumTT - sumT * sumT;
+    if ( denom > 1e-9 )
+      trend.slopeWps = ( n * sumTW - sumT * sumW ) / denom;
+    return trend;
+  }
+};
+
+/**
+ * @brief Curve pre-ramp on sustained package power steps
+ *
+ * Temperature lags power by seconds, so a curve alone only reacts once the
+ * heat is in the heatpipe.  The predictor keeps a slow baseline of the
+ * power-window minimum; when even the window minimum stands STEP_WATTS
+ * above it (a sustained step, not a spike), the curve temperature is
+ * boosted by degPerWatt × (step + rising slope × LOOKAHEAD_S), capped at
+ * maxDeg.  The boost then decays with DECAY_TAU_S while the baseline
+ * catches up with the new load, handing over to the real temperature.
+ */
+class FanLoadPredictor
+{
+public:
+  static constexpr double STEP_WATTS = 8.0;
+  static constexpr double LOOKAHEAD_S = 2.0;
+  static constexpr double DECAY_TAU_S = 15.0;
+  static constexpr double BASELINE_TAU_S = 30.0;
+
+  void reset() noexcept
+  {
+    m_primed = false;
+    m_baseline = 0.0;
+    m_boost = 0.0;
+  }
+
+  /**
+   * @return Degrees to add to the curve temperature
+   */
+  double update( const FanControllerSettings &settings, const FanPowerTrend &trend, double dtSeconds ) noexcept
+  {
+    if ( settings.preRampDegPerWatt <= 0.0 || settings.preRampMaxDeg <= 0 )
+    {
+      reset();
+      return 0.0;
+    }
+
+    const double dt = std::clamp( dtSeconds, 0.0, 10.0 );
+    m_boost *= std::exp( -dt / DECAY_TAU_S );
+
+    if ( trend.samples >= 2 )
+    {
+      if ( !m_primed )
+      {
+        m_primed = true;
+        m_baseline = trend.minWatts;
+      }
+
+      const double step = trend.minWatts - m_baseline;
+      if ( step >= STEP_WATTS )
+      {
+        const double lead = step + std::max( 0.0, trend.slopeWps ) * LOOKAHEAD_S;
+        m_boost = std::max( m_boost, std::min( settings.preRampDegPerWatt * lead,
+                                               static_cast< double >( settings.preRampMaxDeg ) ) );
+      }
+      m_baseline += ( trend.minWatts - m_baseline ) * ( 1.0 - std::exp( -dt / BASELINE_TAU_S ) );
+    }
+    return m_boost;
+  }
+
+  [[nodiscard]] double boost() const noexcept { return m_boost; }
+
+private:
+  bool m_primed = false;
+  double m_baseline = 0.0;  // slow EWMA of the window minimum, W
+  double m_boost = 0.0;     // °C
+};
+
+/**
+ * @brief Fan speed controller with interpolation, hysteresis, and EWMA smoothing
+ *
+ * Improvements over the original algorithm:
+ *
+ * 1. **Linear interpolation** — Uses FanProfile's interpolated curves instead
+ *    of step-wise table lookup. Eliminates discrete jumps between curve points.
+ *    The curves are sampled per degree when the profile is set, so a tick
+ *    costs one table load.
+ *
+ * 2. **Hysteresis** — The temperature used for curve lookup is biased:
+ *    when the filtered temperature is falling and near a curve inflection
+ *    point, the effective temperature is held slightly higher (by HYSTERESIS_DEG)
+ *    to prevent the fan from dropping prematurely. This avoids the classic
+ *    heat→fan-up→cool→fan-down→heat cycle.
+ *
+ * 3. **EWMA speed smoothing** — The raw curve speed is fed through an
+ *    exponentially weighted moving average with asymmetric weights:
+ *      - Rising (alphaUp = 0.4): fans spin up within 2-3 seconds
+ *      - Falling (alphaDown = 0.08): fans spin down over ~12 seconds
+ *    This replaces both the old trimmed-mean temperature filter and the
+ *    hard −2%/sec rate limiter, giving much smoother transitions.
+ *
+ * 4. **Critical temperature override** is preserved unchanged.
+ *
+ * A profile whose controller is FanControlMode::Pid replaces steps 2 and 3
+ * with FanPidController; the curve at the filtered temperature stays the
+ * lower bound, and the output falls by at most PID_RELEASE_PCT_PER_S.
+ *
+ * In both modes FanLoadPredictor may raise the temperature the curve is
+ * read at ahead of a load; the critical override uses the real one.
+ *
+ * A measured FanResponse replaces the firmware's minimum duty where the fan
+ * stalls above it, and shortens the speed smoothing by the fan's own lag:
+ * the defaults aim at a response of SPEED_TAU_UP_S / SPEED_TAU_DOWN_S, part
+ * of which a slow fan already contributes.
+ */
+class FanControlLogic
+{
+public:
+  static constexpr double PID_RELEASE_PCT_PER_S = 4.0;
+  static constexpr double SPEED_TAU_UP_S = 1.96;     ///< Time constant of ALPHA_UP per 1 s cycle
+  static constexpr double SPEED_TAU_DOWN_S = 12.0;   ///< Time constant of ALPHA_DOWN
+  static constexpr double MIN_SMOOTHING_TAU_S = 0.5;
+
+  FanControlLogic( const FanProfile &fanProfile, FanLogicType type )
+    : m_fanProfile( fanProfile )
+    , m_type( type )
+    , m_latestSpeedPercent( 0 )
+    , m_smoothedSpeed( -1.0 )
+    , m_lastEffectiveTemp( -1 )
+    , m_fansMinSpeedHWLimit( 0 )
+    , m_fansOffAvailable( true )
+  {
+    m_fanProfile.compileCurves();
+  }
+
+  void setFansMinSpeedHWLimit( int speed )
+  { m_fansMinSpeedHWLimit = std::clamp( speed, 0, 100 ); }
+
+  void setFansOffAvailable( bool available )
+  { m_fansOffAvailable = available; }
+
+  /// Use the measured response of this fan; a default FanResponse restores the defaults
+  void setResponseModel( const FanResponse &response )
+  {
+    m_modelMinSpeed = std::clamp( response.minDuty, 0, 100 );
+    const auto alphaFor = []( double fanTauMs, double targetTauS, double fallback ) {
+      if ( fanTauMs <= 0.0 )
+        return fallback;
+      const double tau = std::max( MIN_SMOOTHING_TAU_S, targetTauS - fanTauMs / 1000.0 );
+      return 1.0 - std::exp( -1.0 / tau );
+    };
+    m_alphaUp = alphaFor( response.deadTimeMs + response.riseTauMs, SPEED_TAU_UP_S, ALPHA_UP );
+    m_alphaDown = alphaFor( response.deadTimeMs + response.fallTauMs, SPEED_TAU_DOWN_S, ALPHA_DOWN );
+  }
+
+  /// Lowest duty other than off that is written
+  int minSpeed() const
+  { return std::max( m_fansMinSpeedHWLimit, m_modelMinSpeed ); }
+
+  void updateFanProfile( const FanProfile &fanProfile )
+  {
+    if ( fanProfile.controller != m_fanProfile.controller )
+    {
+      m_pid.reset();
+      m_predictor.reset();
+    }
+
+    // The worker re-sends the profile every cycle; keep the compiled
+    // curves unless a table actually changed.
+    if ( m_fanProfile.sameCurves( fanProfile ) and not m_fanProfile.cpuCurve().empty() )
+    {
+      m_fanProfile.id = fanProfile.id;
+      m_fanProfile.name = fanProfile.name;
+      m_fanProfile.tablePump = fanProfile.tablePump;
+      m_fanProfile.controller = fanProfile.controller;
+      return;
+    }
+    m_fanProfile = fanProfile;
+    m_fanProfile.compileCurves();
+  }
+
+  /**
+   * @param dtSeconds Time since the previous report; scales the smoothing
+   * @param packageWatts Power of the fan's heat source for the PID
+   *        feed-forward, < 0 if unknown
+   * @param powerTrend Recent power of the heat source for the pre-ramp
+   */
+  void reportTemperature( int temperatureValue, double dtSeconds = 1.0, double packageWatts = -1.0,
+                          const FanPowerTrend &powerTrend = {} )
+  {
+    addTemperature( temperatureValue, dtSeconds );
+    updateSpeed( dtSeconds, packageWatts, powerTrend );
+  }
+
+  /// First half of reportTemperature(): filter the new reading
+  void addTemperature( int temperatureValue, double dtSeconds = 1.0 )
+  { m_tempFilter.addValue( temperatureValue, dtSeconds ); }
+
+  /// Second half of reportTemperature(): derive the speed from the filtered reading
+  void updateSpeed( double dtSeconds = 1.0, double packageWatts = -1.0, const FanPowerTrend &powerTrend = {} )
+  {
+    m_preRampDeg = static_cast< int >( std::lround( m_predictor.update( m_fanProfile.controller, powerTrend, dtSeconds ) ) );
+    m_latestSpeedPercent = m_fanProfile.controller.mode == FanControlMode::Pid
+                             ? calculateClosedLoopSpeedPercent( dtSeconds, packageWatts )
+                             : calculateSpeedPercent( dtSeconds );
+  }
+
+  int getSpeedPercent() const
+  { return m_latestSpeedPercent; }
+
+  /// True if updateSpeed() uses its powerTrend argument
+  bool wantsPowerTrend() const
+  { return m_fanProfile.controller.preRampDegPerWatt > 0.0 && m_fanProfile.controller.preRampMaxDeg > 0; }
+
+  /// Degrees the curve is currently read above the filtered temperature
+  int getPreRampDeg() const
+  { return m_preRampDeg; }
+
+  const FanProfile &getFanProfile() const
+  { return m_fanProfile; }
+
+private:
+  /**
+   * @brief Apply hysteresis to prevent oscillation at curve boundaries.
+   *
+   * When temperature is falling, the effective temperature is held up to
+   * HYSTERESIS_DEG above the filtered reading.  It tracks
+   * min(lastEffective, filteredTemp + HYSTERESIS_DEG), so large drops
+   * are damped but it still converges.
+   * When temperature is rising, the effective temperature follows immediately.
+   */
+  int applyHysteresis( int filteredTemp )
+  {
+    static constexpr int HYSTERESIS_DEG = 3;
+
+    if ( m_lastEffectiveTemp < 0 )
+    {
+      // First call — no history
+      m_lastEffectiveTemp = filteredTemp;
+      return filteredTemp;
+    }
+
+    if ( filteredTemp >= m_lastEffectiveTemp )
+    {
+      // Temperature rising or stable — follow immediately
+      m_lastEffectiveTemp = filteredTemp;
+    }
+    else
+    {
+      // Temperature falling — hold the effective temp higher by up to HYSTERESIS_DEG
+      int floor = filteredTemp + HYSTERESIS_DEG;
+      int newEffective = std::min( m_lastEffectiveTemp, floor );
+      // Never go below the actual filtered temperature
+      newEffective = std::max( newEffective, filteredTemp );
+      m_lastEffectiveTemp = newEffective;
+    }
+
+    return m_lastEffectiveTemp;
+  }
+
+  int applyHwFanLimitations( int speed ) const
+  {
+    const int minSpeed = this->minSpeed();
+    const int halfMinSpeed = minSpeed / 2;
+
+    if ( speed < minSpeed )
+    {
+      if ( m_fansOffAvailable && speed < halfMinSpeed )
+      {
+        return 0;
+      }
+      else if ( m_fansOffAvailable || speed >= halfMinSpeed )
+      {
+        return minSpeed;
+      }
+    }
+
+    return speed;
+  }
+
+  /**
+   * @brief EWMA smoothing on the speed output.
+   *
+   * Uses asymmetric alpha:
+   *   - alphaUp   = 0.4  → fans reach target in ~3 cycles (3 sec)
+   *   - alphaDown = 0.08 → fans take ~12 cycles to settle
+   * or the ones setResponseModel() derived.
+   *
+   * This replaces both the old trimmed-mean filter and the hard rate limiter.
+   */
+  int smoothSpeed( int targetSpeed, double dtSeconds )
+  {
+    if ( m_smoothedSpeed < 0.0 )
+    {
+      m_smoothedSpeed = static_cast< double >( targetSpeed );
+      return targetSpeed;
+    }
+
+    const double alpha = ewmaAlphaForInterval( ( targetSpeed > m_smoothedSpeed ) ? m_alphaUp : m_alphaDown, dtSeconds );
+    m_smoothedSpeed = m_smoothedSpeed + alpha * ( static_cast< double >( targetSpeed ) - m_smoothedSpeed );
+
+    return static_cast< int >( std::round( m_smoothedSpeed ) );
+  }
+
+  int manageCriticalTemperature( int temp, int speed ) const
+  {
+    constexpr int CRITICAL_TEMPERATURE = 85;
+    constexpr int OVERHEAT_TEMPERATURE = 90;
+
+    if ( temp >= OVERHEAT_TEMPERATURE )
+    {
+      return 100;
+    }
+    else if ( temp >= CRITICAL_TEMPERATURE )
+    {
+      return std::max( speed, 80 );
+    }
+
+    return speed;
+  }
+
+  int calculateSpeedPercent( double dtSeconds )
+  {
+    const int filteredTemp = m_tempFilter.getFilteredValue();
+
+    // Apply hysteresis — effective temp may lag behind during cool-down,
+    // then lead a load the power history announces
+    const int effectiveTemp = applyHysteresis( filteredTemp ) + m_preRampDeg;
+
+    // Linearly interpolated curve, precomputed per degree by compileCurves()
+    const bool isCPU = ( m_type == FanLogicType::CPU );
+    int curveSpeed = ( isCPU ? m_fanProfile.cpuCurve() : m_fanProfile.gpuCurve() )( effectiveTemp );
+    if ( curveSpeed < 0 ) curveSpeed = 0;
+
+    curveSpeed = std::clamp( curveSpeed, 0, 100 );
+
+    // Apply hardware limitations
+    curveSpeed = applyHwFanLimitations( curveSpeed );
+
+    // EWMA smoothing (replaces old rate limiter)
+    int speed = smoothSpeed( curveSpeed, dtSeconds );
+
+    // Critical temperature override (uses raw filtered temp, not hysteresis-adjusted)
+    speed = manageCriticalTemperature( filteredTemp, speed );
+
+    return speed;
+  }
+
+  int calculateClosedLoopSpeedPercent( double dtSeconds, double packageWatts )
+  {
+    const int filteredTemp = m_tempFilter.getFilteredValue();
+    const bool isCPU = ( m_type == FanLogicType::CPU );
+    const int curveSpeed = std::clamp( ( isCPU ? m_fanProfile.cpuCurve() : m_fanProfile.gpuCurve() )( filteredTemp + m_preRampDeg ), 0, 100 );
+
+    double target = m_pid.update( m_fanProfile.controller, static_cast< double >( filteredTemp ), packageWatts,
+                                  dtSeconds, static_cast< double >( curveSpeed ) );
+
+    // Spin down gradually after a burst; spin-up is not delayed
+    if ( m_smoothedSpeed >= 0.0 )
+      target = std::max( target, m_smoothedSpeed - PID_RELEASE_PCT_PER_S * std::clamp( dtSeconds, 0.0, 10.0 ) );
+    m_smoothedSpeed = target;
+    m_lastEffectiveTemp = filteredTemp;
+
+    int speed = applyHwFanLimitations( static_cast< int >( std::round( target ) ) );
+    return manageCriticalTemperature( filteredTemp, speed );
+  }
+
+  FanProfile m_fanProfile;
+  FanLogicType m_type;
+  TemperatureFilter m_tempFilter;
+  FanPidController m_pid;
+  FanLoadPredictor m_predictor;
+  int m_preRampDeg = 0;
+  int m_latestSpeedPercent;
+  double m_smoothedSpeed;       // EWMA state for speed output
+  int m_lastEffectiveTemp;      // hysteresis state
+
+  int m_fansMinSpeedHWLimit;
+  bool m_fansOffAvailable;
+
+  static constexpr double ALPHA_UP   = 0.4;
+  static constexpr double ALPHA_DOWN = 0.08;
+  int m_modelMinSpeed = 0;      // measured stall duty + one step, 0 if unknown
+  double m_alphaUp = ALPHA_UP;
+  double m_alphaDown = ALPHA_DOWN;
+};
+
+/**
+ * @brief Decides which commanded fan duties are worth an EC write
+ *
+ * Every write is an ioctl into the EC: slow, serialised with all other
+ * EC traffic and, on Uniwill firmware, an audible step.  A duty is sent
+ * when it differs from the last one sent by at least DEADBAND_PCT, when it
+ * switches the fan off or on or reaches 100 %, and otherwise once
+ * REFRESH_MS passed, so the exact value still lands and an EC that
+ * reverted on its own is corrected.
+ */
+class FanWriteLimiter
+{
+public:
+  static constexpr int DEADBAND_PCT = 2;
+  static constexpr int64_t REFRESH_MS = 10'000;
+
+  void resize( size_t fans ) { m_fans.assign( fans, Fan{} ); }
+
+  /// Forget what was sent; the next duty of every fan is written
+  void invalidate() noexcept
+  {
+    for ( auto &fan : m_fans )
+      fan.sent = -1;
+  }
+
+  [[nodiscard]] bool shouldWrite( size_t fanIndex, int speed, int64_t nowMs ) const noexcept
+  {
+    if ( fanIndex >= m_fans.size() )
+      return true;
+    const Fan &fan = m_fans[ fanIndex ];
+    if ( fan.sent < 0 || nowMs - fan.sentMs >= REFRESH_MS )
+      return true;
+    if ( speed == fan.sent )
+      return false;
+    if ( ( speed == 0 ) != ( fan.sent == 0 ) || speed == 100 )
+      return true;
+    return std::abs( speed - fan.sent ) >= DEADBAND_PCT;
+  }
+
+  void written( size_t fanIndex, int speed, int64_t nowMs ) noexcept
+  {
+    if ( fanIndex < m_fans.size() )
+      m_fans[ fanIndex ] = Fan{ speed, nowMs };
+  }
+
+  /// Duty the fan was last set to, -1 if none
+  [[nodiscard]] int sent( size_t fanIndex ) const noexcept
+  {
+    return fanIndex < m_fans.size() ? m_fans[ fanIndex ].sent : -1;
+  }
+
+private:
+  struct Fan
+  {
+    int sent = -1;
+    int64_t sentMs = 0;
+  };
+
+  std::vector< Fan > m_fans;
+};
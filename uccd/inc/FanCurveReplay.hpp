@@ -0,0 +1,249 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FanControlLogic.hpp"
+#include "SensorTrace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+struct FanReplayOptions
+{
+  double thresholdC = 85.0;          ///< Time above this temperature is reported
+  double thermalGainCPerPct = 0.15;  ///< Steady-state °C per % of duty below the recorded one
+  double thermalTauS = 20.0;         ///< Time constant of that temperature shift
+  int minSpeed = 0;                  ///< EC limits, as FanControlLogic takes them
+  bool offAvailable = true;
+};
+
+/// One fan over the whole trace; averages are time-weighted
+struct FanReplayStats
+{
+  bool available = false;     ///< The trace has this fan's temperature
+  double avgDuty = 0.0;       ///< %
+  int maxDuty = 0;
+  double noiseDb = -99.0;     ///< 10·log10 of the mean (duty/100)^5; 0 dB = full speed throughout
+  int steps = 0;              ///< Duty changes of at least FanCurveReplay::STEP_PCT
+  double maxTemp = 0.0;       ///< °C
+  double secondsAbove = 0.0;  ///< Time above FanReplayOptions::thresholdC
+};
+
+struct FanReplayResult
+{
+  FanReplayStats cpu;
+  FanReplayStats gpu;
+  double seconds = 0.0;  ///< Trace time covered
+};
+
+/**
+ * @brief Runs a recorded ucc::SensorTrace through FanControlLogic offline.
+ *
+ * The CPU fan follows cpuTemp and cpuPower, the GPU fan gpuTemp and
+ * gpuPower, each with the same filter, hysteresis, smoothing, PID and
+ * pre-ramp a live fan gets, at the trace's own sample spacing.  Fans are
+ * evaluated independently (no "same speed" coupling).
+ *
+ * A recorded temperature only holds for the duty that was recorded, so a
+ * curve that runs quieter has to see a warmer chip.  simulate() models
+ * that to first order: the temperature is shifted towards
+ * thermalGainCPerPct × (recorded − simulated duty) with time constant
+ * thermalTauS, and the shifted temperature feeds the controller.  The
+ * shift is an estimate; a gain of 0 replays the recorded temperatures.
+ *
+ * The noise proxy follows the fan laws (sound power ∝ speed⁵), so time at
+ * high duty dominates; steps counts the audible duty changes.
+ */
+class FanCurveReplay
+{
+public:
+  static constexpr int STEP_PCT = 5;
+  static constexpr double MAX_GAP_S = 10.0;        ///< Longer gaps (suspend) are not integrated
+  static constexpr int64_t POWER_WINDOW_MS = 4000; ///< Same window as the daemon's power trend
+
+  /// The fans as recorded, for comparison with simulate()
+  [[nodiscard]] static FanReplayResult recorded( const ucc::SensorTrace &trace, const FanReplayOptions &options )
+  {
+    FanReplayResult result;
+    result.seconds = duration( trace );
+    result.cpu = recordedFan( trace, channel( trace, FanLogicType::CPU ), options );
+    result.gpu = recordedFan( trace, channel( trace, FanLogicType::GPU ), options );
+    return result;
+  }
+
+  /// The fans as @p profile would have driven them over the same trace
+  [[nodiscard]] static FanReplayResult simulate( const ucc::SensorTrace &trace, const FanProfile &profile,
+                                                 const FanReplayOptions &options )
+  {
+    FanReplayResult result;
+    result.seconds = duration( trace );
+    result.cpu = simulatedFan( trace, channel( trace, FanLogicType::CPU ), profile, options );
+    result.gpu = simulatedFan( trace, channel( trace, FanLogicType::GPU ), profile, options );
+    return result;
+  }
+
+private:
+  struct Channel
+  {
+    FanLogicType type;
+    std::optional< size_t > temp;
+    std::optional< size_t > duty;
+    std::optional< size_t > power;
+  };
+
+  struct PowerPoint
+  {
+    int64_t timestampMs;
+    double value;
+  };
+
+  /// Time-weighted statistics of one fan
+  class Accumulator
+  {
+  public:
+    explicit Accumulator( double thresholdC ) : m_threshold( thresholdC ) {}
+
+    void add( int duty, double temp, double dtSeconds )
+    {
+      m_stats.available = true;
+      m_stats.maxDuty = std::max( m_stats.maxDuty, duty );
+      m_stats.maxTemp = std::max( m_stats.maxTemp, temp );
+      if ( m_lastDuty >= 0 && std::abs( duty - m_lastDuty ) >= STEP_PCT )
+        ++m_stats.steps;
+      if ( m_lastDuty < 0 || std::abs( duty - m_lastDuty ) >= STEP_PCT )
+        m_lastDuty = duty;
+
+      const double fraction = duty / 100.0;
+      m_dutySum += duty * dtSeconds;
+      m_powerSum += std::pow( fraction, 5.0 ) * dtSeconds;
+      m_seconds += dtSeconds;
+      if ( temp > m_threshold )
+        m_stats.secondsAbove += dtSeconds;
+    }
+
+    [[nodiscard]] FanReplayStats finish()
+    {
+      if ( m_seconds > 0.0 )
+      {
+        m_stats.avgDuty = m_dutySum / m_seconds;
+        const double meanPower = m_powerSum / m_seconds;
+        m_stats.noiseDb = meanPower > 0.0 ? std::max( -99.0, 10.0 * std::log10( meanPower ) ) : -99.0;
+      }
+      return m_stats;
+    }
+
+  private:
+    double m_threshold;
+    FanReplayStats m_stats;
+    int m_lastDuty = -1;  // last duty counted as a step
+    double m_dutySum = 0.0;
+    double m_powerSum = 0.0;
+    double m_seconds = 0.0;
+  };
+
+  static Channel channel( const ucc::SensorTrace &trace, FanLogicType type )
+  {
+    const bool cpu = type == FanLogicType::CPU;
+    return { type, trace.column( cpu ? "cpuTemp" : "gpuTemp" ), trace.column( cpu ? "cpuFanDuty" : "gpuFanDuty" ),
+             trace.column( cpu ? "cpuPower" : "gpuPower" ) };
+  }
+
+  static double duration( const ucc::SensorTrace &trace )
+  {
+    double seconds = 0.0;
+    for ( size_t row = 1; row < trace.samples(); ++row )
+      seconds += gapSeconds( trace, row );
+    return seconds;
+  }
+
+  /// Seconds since the previous sample, 0 for the first one and across gaps
+  static double gapSeconds( const ucc::SensorTrace &trace, size_t row )
+  {
+    if ( row == 0 )
+      return 0.0;
+    const double dt = static_cast< double >( trace.timestamps[ row ] - trace.timestamps[ row - 1 ] ) / 1000.0;
+    return dt > 0.0 && dt <= MAX_GAP_S ? dt : 0.0;
+  }
+
+  static double at( const ucc::SensorTrace &trace, size_t row, const std::optional< size_t > &column )
+  {
+    return column ? trace.value( row, *column ) : std::nan( "" );
+  }
+
+  static FanReplayStats recordedFan( const ucc::SensorTrace &trace, const Channel &ch, const FanReplayOptions &options )
+  {
+    Accumulator acc( options.thresholdC );
+    for ( size_t row = 0; row < trace.samples(); ++row )
+    {
+      const double temp = at( trace, row, ch.temp );
+      const double duty = at( trace, row, ch.duty );
+      if ( std::isfinite( temp ) && std::isfinite( duty ) )
+        acc.add( static_cast< int >( std::lround( duty ) ), temp, gapSeconds( trace, row ) );
+    }
+    return acc.finish();
+  }
+
+  static FanReplayStats simulatedFan( const ucc::SensorTrace &trace, const Channel &ch, const FanProfile &profile,
+                                      const FanReplayOptions &options )
+  {
+    FanControlLogic logic( profile, ch.type );
+    logic.setFansMinSpeedHWLimit( options.minSpeed );
+    logic.setFansOffAvailable( options.offAvailable );
+
+    Accumulator acc( options.thresholdC );
+    std::deque< PowerPoint > window;
+    double shift = 0.0;  // °C the simulated chip runs above the recorded one
+    bool first = true;
+
+    for ( size_t row = 0; row < trace.samples(); ++row )
+    {
+      const double recordedTemp = at( trace, row, ch.temp );
+      if ( !std::isfinite( recordedTemp ) )
+        continue;
+
+      const double gap = gapSeconds( trace, row );
+      const double dt = first || gap <= 0.0 ? 1.0 : gap;
+      first = false;
+
+      const int64_t nowMs = trace.timestamps[ row ];
+      const double watts = at( trace, row, ch.power );
+      if ( std::isfinite( watts ) )
+        window.push_back( { nowMs, watts } );
+      while ( !window.empty() && window.front().timestampMs < nowMs - POWER_WINDOW_MS )
+        window.pop_front();
+
+      const double temp = recordedTemp + shift;
+      logic.addTemperature( static_cast< int >( std::lround( temp ) ), dt );
+      logic.updateSpeed( dt, std::isfinite( watts ) ? watts : -1.0,
+                         logic.wantsPowerTrend() ? FanPowerTrend::fromSamples( window ) : FanPowerTrend{} );
+      const int duty = logic.getSpeedPercent();
+      acc.add( duty, temp, gap );
+
+      const double recordedDuty = at( trace, row, ch.duty );
+      const double target = std::isfinite( recordedDuty )
+                              ? options.thermalGainCPerPct * ( recordedDuty - static_cast< double >( duty ) )
+                              : 0.0;
+      if ( options.thermalTauS > 0.0 )
+        shift += ( target - shift ) * ( 1.0 - std::exp( -dt / options.thermalTauS ) );
+      else
+        shift = target;
+    }
+    return acc.finish();
+  }
+};
@@ -0,0 +1,200 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Stages of one fan-control cycle, sensor read to EC write.
+ */
+enum class FanTraceStage : uint8_t
+{
+  SensorRead,   ///< getFanTemperature(), per fan
+  Filter,       ///< TemperatureFilter update, per fan
+  Control,      ///< Curve / PID speed calculation, per fan
+  EcWrite,      ///< setFanSpeedPercent(), per write actually sent
+  ReadToWrite,  ///< Start of the cycle's first sensor read to the end of each EC write
+  Cycle,        ///< Whole onWork()
+  IoctlRead,    ///< Every tuxedo_io ioctl that reads, daemon-wide
+  IoctlWrite,   ///< Every tuxedo_io ioctl that writes, daemon-wide
+  Count
+};
+
+constexpr const char *fanTraceStageName( FanTraceStage stage ) noexcept
+{
+  switch ( stage )
+  {
+    case FanTraceStage::SensorRead:  return "sensorRead";
+    case FanTraceStage::Filter:      return "filter";
+    case FanTraceStage::Control:     return "control";
+    case FanTraceStage::EcWrite:     return "ecWrite";
+    case FanTraceStage::ReadToWrite: return "readToWrite";
+    case FanTraceStage::Cycle:       return "cycle";
+    case FanTraceStage::IoctlRead:   return "ioctlRead";
+    case FanTraceStage::IoctlWrite:  return "ioctlWrite";
+    case FanTraceStage::Count:       break;
+  }
+  return "unknown";
+}
+
+/**
+ * @brief Copy of one stage's histogram.
+ */
+struct LatencySnapshot
+{
+  static constexpr size_t BUCKETS = 22;  ///< <= 1 µs, <= 2 µs, ... <= 2^20 µs, more
+
+  std::array< uint64_t, BUCKETS > buckets{};
+  uint64_t count = 0;
+  uint64_t totalNs = 0;
+  uint64_t maxNs = 0;
+
+  /// Inclusive upper bound of bucket @p i in µs; the last bucket is open
+  static constexpr uint64_t upperUs( size_t i ) noexcept { return uint64_t( 1 ) << i; }
+
+  /// Upper bound of the bucket holding quantile @p q, 0 if empty
+  [[nodiscard]] uint64_t quantileUpperUs( double q ) const noexcept
+  {
+    if ( count == 0 )
+      return 0;
+    const double target = q * static_cast< double >( count );
+    uint64_t seen = 0;
+    for ( size_t i = 0; i + 1 < BUCKETS; ++i )
+    {
+      seen += buckets[ i ];
+      if ( static_cast< double >( seen ) >= target )
+        return upperUs( i );
+    }
+    return maxNs / 1000;
+  }
+};
+
+/**
+ * @brief Lock-free log2 histogram of durations.
+ *
+ * record() is a handful of relaxed atomic adds, cheap enough to sit
+ * around every ioctl; readers get a consistent-enough snapshot() without
+ * stopping writers.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr size_t BUCKETS = LatencySnapshot::BUCKETS;
+
+  static constexpr size_t bucketFor( uint64_t ns ) noexcept
+  {
+    const uint64_t us = ( ns + 999 ) / 1000;
+    if ( us <= 1 )
+      return 0;
+    const size_t i = static_cast< size_t >( std::bit_width( us - 1 ) );
+    return i < BUCKETS ? i : BUCKETS - 1;
+  }
+
+  void record( uint64_t ns ) noexcept
+  {
+    m_buckets[ bucketFor( ns ) ].fetch_add( 1, std::memory_order_relaxed );
+    m_count.fetch_add( 1, std::memory_order_relaxed );
+    m_totalNs.fetch_add( ns, std::memory_order_relaxed );
+    uint64_t max = m_maxNs.load( std::memory_order_relaxed );
+    while ( ns > max && !m_maxNs.compare_exchange_weak( max, ns, std::memory_order_relaxed ) )
+    {
+    }
+  }
+
+  [[nodiscard]] LatencySnapshot snapshot() const noexcept
+  {
+    LatencySnapshot s;
+    for ( size_t i = 0; i < BUCKETS; ++i )
+      s.buckets[ i ] = m_buckets[ i ].load( std::memory_order_relaxed );
+    s.count = m_count.load( std::memory_order_relaxed );
+    s.totalNs = m_totalNs.load( std::memory_order_relaxed );
+    s.maxNs = m_maxNs.load( std::memory_order_relaxed );
+    return s;
+  }
+
+private:
+  std::array< std::atomic< uint64_t >, BUCKETS > m_buckets{};
+  std::atomic< uint64_t > m_count{ 0 };
+  std::atomic< uint64_t > m_totalNs{ 0 };
+  std::atomic< uint64_t > m_maxNs{ 0 };
+};
+
+/**
+ * @brief Per-stage latency histograms of the fan loop.
+ *
+ * Written by FanControlWorker and by the tuxedo_io ioctl observer, read by
+ * the D-Bus layer (`ucc-cli fan trace`).  All methods are thread-safe.
+ */
+class FanLatencyTrace
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t STAGES = static_cast< size_t >( FanTraceStage::Count );
+
+  void record( FanTraceStage stage, uint64_t ns ) noexcept
+  {
+    const auto idx = static_cast< size_t >( stage );
+    if ( idx < STAGES )
+      m_stages[ idx ].record( ns );
+  }
+
+  void record( FanTraceStage stage, Clock::time_point begin, Clock::time_point end = Clock::now() ) noexcept
+  {
+    const auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >( end - begin ).count();
+    record( stage, ns > 0 ? static_cast< uint64_t >( ns ) : 0 );
+  }
+
+  [[nodiscard]] LatencySnapshot snapshot( FanTraceStage stage ) const noexcept
+  {
+    const auto idx = static_cast< size_t >( stage );
+    return idx < STAGES ? m_stages[ idx ].snapshot() : LatencySnapshot{};
+  }
+
+  /**
+   * @brief Records the time from construction to destruction.
+   */
+  class Span
+  {
+  public:
+    Span( FanLatencyTrace *trace, FanTraceStage stage ) noexcept
+      : m_trace( trace ), m_stage( stage ), m_begin( trace ? Clock::now() : Clock::time_point{} )
+    {
+    }
+
+    ~Span()
+    {
+      if ( m_trace )
+        m_trace->record( m_stage, m_begin );
+    }
+
+    Span( const Span & ) = delete;
+    Span &operator=( const Span & ) = delete;
+
+  private:
+    FanLatencyTrace *m_trace;
+    FanTraceStage m_stage;
+    Clock::time_point m_begin;
+  };
+
+private:
+  std::array< LatencyHistogram, STAGES > m_stages{};
+};
@@ -0,0 +1,133 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Hands the fans back to the EC when the fan loop stops keeping time
+ *
+ * Every cycle that drives the fans beat()s with the interval to the next
+ * one.  If no beat comes within MISSED_CYCLES of those intervals (at least
+ * MIN_DEADLINE_MS), the duty last written may no longer fit the
+ * temperature: the watchdog thread calls the action once, which puts the
+ * fans in EC auto mode, and stays quiet until the loop beats again and
+ * takes them back.  disarm() while the daemon does not drive the fans or
+ * the loop is paused on purpose.
+ */
+class FanWatchdog
+{
+public:
+  static constexpr int MISSED_CYCLES = 3;
+  static constexpr int64_t MIN_DEADLINE_MS = 3000;
+  static constexpr std::chrono::milliseconds CHECK_PERIOD{ 250 };
+
+  FanWatchdog() = default;
+  ~FanWatchdog() { stop(); }
+
+  FanWatchdog( const FanWatchdog & ) = delete;
+  FanWatchdog &operator=( const FanWatchdog & ) = delete;
+
+  /**
+   * @brief Check the deadline every CHECK_PERIOD on a thread of its own
+   * @param onMissed Called on that thread once per missed deadline
+   * @param threadInit Called first on that thread, e.g. to raise its priority
+   */
+  void start( std::function< void() > onMissed, std::function< void() > threadInit = nullptr )
+  {
+    stop();
+    m_stop = false;
+    m_thread = std::thread( [this, onMissed = std::move( onMissed ), threadInit = std::move( threadInit )] {
+      if ( threadInit )
+        threadInit();
+      std::unique_lock< std::mutex > lock( m_threadMutex );
+      while ( !m_wake.wait_for( lock, CHECK_PERIOD, [this] { return m_stop; } ) )
+      {
+        lock.unlock();
+        if ( expired( steadyMs() ) )
+          onMissed();
+        lock.lock();
+      }
+    } );
+  }
+
+  void stop()
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_threadMutex );
+      m_stop = true;
+    }
+    m_wake.notify_one();
+    if ( m_thread.joinable() )
+      m_thread.join();
+  }
+
+  /// A cycle that drove the fans ended at @p nowMs (steady clock); the next is due in @p intervalMs
+  void beat( int64_t nowMs, int64_t intervalMs ) noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_deadlineMs = nowMs + std::max( MISSED_CYCLES * intervalMs, MIN_DEADLINE_MS );
+    m_tripped = false;
+  }
+
+  void disarm() noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_deadlineMs = 0;
+  }
+
+  /// @return true once when @p nowMs is past the deadline of the last beat
+  bool expired( int64_t nowMs ) noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    if ( m_deadlineMs == 0 || m_tripped || nowMs < m_deadlineMs )
+      return false;
+    m_tripped = true;
+    ++m_trips;
+    return true;
+  }
+
+  /// Missed deadlines so far
+  [[nodiscard]] uint64_t trips() const noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_trips;
+  }
+
+  static int64_t steadyMs() noexcept
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  int64_t m_deadlineMs = 0;  ///< 0: disarmed
+  bool m_tripped = false;
+  uint64_t m_trips = 0;
+
+  std::mutex m_threadMutex;
+  std::condition_variable m_wake;
+  bool m_stop = false;
+  std::thread m_thread;
+};
@@ -0,0 +1,139 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JsonWriter.hpp"
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Data structure for discrete GPU information
+ */
+struct DGpuInfo
+{
+  int m_deviceIndex = 0;         ///< NVML device index (0 for AMD / no dGPU)
+  std::string m_name;            ///< GPU model name, empty when unknown
+  double m_temp = -1.0;
+  double m_coreFrequency = -1.0;
+  double m_vramFrequency = -1.0;
+  double m_maxCoreFrequency = -1.0;
+  double m_powerDraw = -1.0;
+  double m_maxPowerLimit = -1.0;
+  double m_enforcedPowerLimit = -1.0;
+  bool m_d0MetricsUsage = false;
+
+  // Extended metrics (NVIDIA only, -1 / INT_MIN when unavailable)
+  int m_computeUtilPct = -1;     ///< GPU compute utilization in % (0–100), or -1
+  int m_memoryUtilPct  = -1;     ///< GPU memory-controller utilization in % (0–100), or -1
+  int m_vramUsedMiB    = -1;     ///< Used VRAM in MiB, or -1
+  int m_vramTotalMiB   = -1;     ///< Total VRAM in MiB, or -1
+  std::string m_perfLimitReason; ///< Current perf-cap/throttle reason, empty when unavailable
+  int m_encoderUtilPct = -1;     ///< NVENC utilization in %, or -1
+  int m_decoderUtilPct = -1;     ///< NVDEC utilization in %, or -1
+  int m_currentPstate  = -1;     ///< Current P-state index (0–15), or -1 if unknown
+  int m_grClockOffsetMHz  = INT_MIN; ///< Graphics-clock offset at current P-state, INT_MIN = unavailable
+  int m_memClockOffsetMHz = INT_MIN; ///< Memory-clock offset at current P-state, INT_MIN = unavailable
+  int m_coreVoltageMv = -1;      ///< Core voltage in mV, or -1
+  int64_t m_throttleStatus = -1; ///< AMD gpu_metrics throttler bit mask, or -1
+
+  void print() const noexcept;
+};
+
+/**
+ * @brief Data structure for integrated GPU information
+ */
+struct IGpuInfo
+{
+  double m_temp = -1.0;
+  double m_coreFrequency = -1.0;
+  double m_maxCoreFrequency = -1.0;
+  double m_powerDraw = -1.0;
+  double m_gfxActivityPct = -1.0;           ///< AMD gpu_metrics only
+  int64_t m_throttleStatus = -1;            ///< AMD gpu_metrics throttler bit mask
+  std::vector< double > m_cpuCoreClocksMHz; ///< AMD APU CPU core clocks from gpu_metrics
+  std::string m_vendor = "unknown";
+
+  void print() const noexcept;
+};
+
+/// One DGpuInfo as a JSON object, for dgpuInfoToJSON() and dgpuInfoListToJSON()
+inline void writeDGpuInfo( JsonWriter &w, const DGpuInfo &info )
+{
+  w.beginObject()
+   .key( "deviceIndex" ).value( info.m_deviceIndex )
+   .key( "name" ).value( info.m_name )
+   .key( "temp" ).value( info.m_temp, 2 )
+   .key( "coreFrequency" ).value( info.m_coreFrequency, 2 )
+   .key( "vramFrequency" ).value( info.m_vramFrequency, 2 )
+   .key( "maxCoreFrequency" ).value( info.m_maxCoreFrequency, 2 )
+   .key( "powerDraw" ).value( info.m_powerDraw, 2 )
+   .key( "maxPowerLimit" ).value( info.m_maxPowerLimit, 2 )
+   .key( "enforcedPowerLimit" ).value( info.m_enforcedPowerLimit, 2 )
+   .key( "computeUtilPct" ).value( info.m_computeUtilPct )
+   .key( "memoryUtilPct" ).value( info.m_memoryUtilPct )
+   .key( "vramUsedMiB" ).value( info.m_vramUsedMiB )
+   .key( "vramTotalMiB" ).value( info.m_vramTotalMiB )
+   .key( "perfLimitReason" ).value( info.m_perfLimitReason )
+   .key( "encoderUtilPct" ).value( info.m_encoderUtilPct )
+   .key( "decoderUtilPct" ).value( info.m_decoderUtilPct )
+   .key( "currentPstate" ).value( info.m_currentPstate )
+   .key( "grClockOffsetMHz" ).value( info.m_grClockOffsetMHz == INT_MIN ? -999 : info.m_grClockOffsetMHz )
+   .key( "memClockOffsetMHz" ).value( info.m_memClockOffsetMHz == INT_MIN ? -999 : info.m_memClockOffsetMHz )
+   .key( "coreVoltageMv" ).value( info.m_coreVoltageMv )
+   .key( "throttleStatus" ).value( info.m_throttleStatus )
+   .key( "d0MetricsUsage" ).value( info.m_d0MetricsUsage )
+   .endObject();
+}
+
+// helper functions to convert GPU info to JSON (hot path: reuse @p out)
+inline void dgpuInfoToJSON( const DGpuInfo &info, std::string &out )
+{
+  JsonWriter w( out );
+  writeDGpuInfo( w, info );
+}
+
+inline void dgpuInfoListToJSON( const std::vector< DGpuInfo > &infos, std::string &out )
+{
+  JsonWriter w( out );
+  w.beginArray();
+  for ( const auto &info : infos )
+    writeDGpuInfo( w, info );
+  w.endArray();
+}
+
+inline void igpuInfoToJSON( const IGpuInfo &info, std::string &out )
+{
+  JsonWriter w( out );
+  w.beginObject()
+   .key( "temp" ).value( info.m_temp, 2 )
+   .key( "coreFrequency" ).value( info.m_coreFrequency, 2 )
+   .key( "maxCoreFrequency" ).value( info.m_maxCoreFrequency, 2 )
+   .key( "powerDraw" ).value( info.m_powerDraw, 2 )
+   .key( "gfxActivityPct" ).value( info.m_gfxActivityPct, 1 )
+   .key( "throttleStatus" ).value( info.m_throttleStatus )
+   .key( "vendor" ).value( info.m_vendor );
+  if ( not info.m_cpuCoreClocksMHz.empty() )
+  {
+    w.key( "cpuCoreClocksMHz" ).beginArray();
+    for ( const double mhz : info.m_cpuCoreClocksMHz )
+      w.value( mhz, 0 );
+    w.endArray();
+  }
+  w.endObject();
+}
+
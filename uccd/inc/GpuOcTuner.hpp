@@ -0,0 +1,454 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JsonWriter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// One point of the tuning grid, applied as a GPU OC profile
+struct GpuOcSetting
+{
+  double powerLimitW = 0.0;   ///< 0 = driver default
+  unsigned lockedMaxMHz = 0;  ///< Locked-clock ceiling, 0 = not locked
+  int offsetMHz = 0;          ///< P0 graphics clock offset
+
+  bool operator==( const GpuOcSetting & ) const = default;
+};
+
+enum class GpuOcObjective
+{
+  Efficiency,  ///< Highest mean clock per watt
+  Performance, ///< Highest mean clock
+};
+
+struct GpuOcTuningOptions
+{
+  std::vector< double > powerLimitsW { 0.0 };  ///< Candidates, 0 = default
+  std::vector< unsigned > lockedMaxMHz { 0 };  ///< Candidates, 0 = unlocked
+  unsigned lockedMinMHz = 0;                   ///< Floor used whenever clocks are locked
+  int offsetStepMHz = 15;
+  int maxOffsetMHz = 240;
+  int safetySteps = 1;             ///< Steps to back off from the last stable offset after an unstable one
+  double settleS = 5.0;            ///< Samples ignored after each change
+  double measureS = 20.0;          ///< Loaded time measured per step
+  int minUtilPct = 80;             ///< Samples below this GPU utilisation wait for the load
+  double maxClockCv = 0.03;        ///< Clock stddev / mean above this is unstable
+  double maxHwLimitedFraction = 0.25;  ///< Share of HW/thermal-capped samples above this is unstable
+  double loadTimeoutS = 30.0;      ///< No loaded, valid sample for this long fails the job
+  GpuOcObjective objective = GpuOcObjective::Efficiency;
+
+  /// Empty if usable, otherwise what is wrong
+  [[nodiscard]] std::string validate() const
+  {
+    if ( powerLimitsW.empty() || lockedMaxMHz.empty() )
+      return "no power limit or locked clock candidates";
+    if ( std::any_of( powerLimitsW.begin(), powerLimitsW.end(), []( double w ) { return !( w >= 0.0 ); } ) )
+      return "power limits must be >= 0";
+    if ( offsetStepMHz <= 0 || maxOffsetMHz < 0 || safetySteps < 0 )
+      return "offset step must be > 0, max offset and safety steps >= 0";
+    if ( !( settleS >= 0.0 ) || !( measureS > 0.0 ) || !( loadTimeoutS > settleS ) )
+      return "settle must be >= 0, measure > 0 and the load timeout longer than settle";
+    if ( minUtilPct < 0 || minUtilPct > 100 || !( maxClockCv > 0.0 ) || !( maxHwLimitedFraction >= 0.0 ) )
+      return "invalid stability thresholds";
+    return {};
+  }
+};
+
+/// One telemetry reading; negative clock or power means the driver did not answer
+struct GpuOcSample
+{
+  int64_t timestampMs = 0;
+  double clockMHz = -1.0;
+  double powerW = -1.0;
+  int utilPct = -1;
+  std::string_view perfLimitReason;  ///< NvmlWrapper's name, e.g. "Power Limit"
+};
+
+enum class GpuOcStepOutcome
+{
+  Stable,
+  Unstable,  ///< Clock jitter or HW/thermal capping
+  NoGain,    ///< Stable, but the clock stopped rising with the offset
+};
+
+struct GpuOcStepResult
+{
+  GpuOcSetting setting;
+  GpuOcStepOutcome outcome = GpuOcStepOutcome::Stable;
+  int samples = 0;
+  double meanClockMHz = 0.0;
+  double clockCv = 0.0;
+  double meanPowerW = 0.0;
+  double hwLimitedFraction = 0.0;
+  std::string limitReason;  ///< Most frequent perfLimitReason
+
+  [[nodiscard]] double mhzPerW() const noexcept { return meanPowerW > 0.0 ? meanClockMHz / meanPowerW : 0.0; }
+};
+
+enum class GpuOcTuningState
+{
+  Idle,
+  Running,
+  Finished,
+  Failed,
+  Cancelled,
+};
+
+/**
+ * @brief Search for a stable, efficient NVIDIA clock offset under a running load.
+ *
+ * For every power limit × locked-clock candidate the P0 graphics offset
+ * climbs from 0 in offsetStepMHz steps.  Each step waits settleS after the
+ * change, then measures measureS of samples taken while the user's load
+ * keeps the GPU at least minUtilPct busy.  A step is unstable when the
+ * clock jitters (coefficient of variation above maxClockCv) or the GPU is
+ * HW/thermal capped for more than maxHwLimitedFraction of the samples;
+ * "Power Limit" capping is expected and does not count.  A step whose mean
+ * clock falls more than half a step below the previous one ends the climb
+ * as NoGain.
+ *
+ * A candidate's result is its last stable step, moved safetySteps back
+ * after an unstable one.  The recommendation is the candidate result with
+ * the best objective.  The tuner only decides: the caller applies each
+ * setting it returns and feeds telemetry; time comes from the samples.
+ */
+class GpuOcTuner
+{
+public:
+  explicit GpuOcTuner( GpuOcTuningOptions options ) : m_options( std::move( options ) )
+  {
+    for ( double powerLimit : m_options.powerLimitsW )
+      for ( unsigned lockedMax : m_options.lockedMaxMHz )
+        m_candidates.push_back( GpuOcSetting{ powerLimit, lockedMax, 0 } );
+  }
+
+  [[nodiscard]] const GpuOcTuningOptions &options() const noexcept { return m_options; }
+  [[nodiscard]] GpuOcTuningState state() const noexcept { return m_state; }
+  [[nodiscard]] const std::string &error() const noexcept { return m_error; }
+  [[nodiscard]] const std::vector< GpuOcStepResult > &steps() const noexcept { return m_steps; }
+  [[nodiscard]] const GpuOcSetting &current() const noexcept { return m_current; }
+  [[nodiscard]] size_t candidateIndex() const noexcept { return m_candidate; }
+  [[nodiscard]] size_t candidateCount() const noexcept { return m_candidates.size(); }
+
+  /// The first setting to apply, made at @p nowMs
+  GpuOcSetting start( int64_t nowMs )
+  {
+    m_state = GpuOcTuningState::Running;
+    m_candidate = 0;
+    beginStep( m_candidates.front(), nowMs );
+    return m_current;
+  }
+
+  /**
+   * @brief Account one sample of the setting in effect.
+   * @return The next setting to apply once the step is decided; nullopt
+   *         while measuring and once the job has ended (see state())
+   */
+  std::optional< GpuOcSetting > onSample( const GpuOcSample &sample )
+  {
+    if ( m_state != GpuOcTuningState::Running )
+      return std::nullopt;
+
+    if ( sample.timestampMs - m_lastGoodMs > static_cast< int64_t >( m_options.loadTimeoutS * 1000.0 ) )
+    {
+      fail( m_anyLoaded ? "GPU telemetry or load lost" : "GPU not under load" );
+      return std::nullopt;
+    }
+    if ( sample.timestampMs < m_stepStartMs + static_cast< int64_t >( m_options.settleS * 1000.0 ) )
+      return std::nullopt;
+    if ( sample.clockMHz < 0.0 || sample.powerW < 0.0 || sample.utilPct < m_options.minUtilPct )
+      return std::nullopt;
+
+    m_lastGoodMs = sample.timestampMs;
+    m_anyLoaded = true;
+    if ( m_window.empty() )
+      m_windowStartMs = sample.timestampMs;
+    m_window.push_back( sample.clockMHz );
+    m_powerSum += sample.powerW;
+    if ( isHwLimit( sample.perfLimitReason ) )
+      ++m_hwLimited;
+    ++m_reasons[ std::string( sample.perfLimitReason.empty() ? "None" : sample.perfLimitReason ) ];
+
+    if ( m_window.size() < 2
+         || sample.timestampMs - m_windowStartMs < static_cast< int64_t >( m_options.measureS * 1000.0 ) )
+      return std::nullopt;
+    return finishStep( sample.timestampMs );
+  }
+
+  /// The driver rejected the setting in effect: it counts as unstable and ends its candidate
+  std::optional< GpuOcSetting > onApplyFailed( int64_t nowMs )
+  {
+    if ( m_state != GpuOcTuningState::Running )
+      return std::nullopt;
+    GpuOcStepResult rejected;
+    rejected.setting = m_current;
+    rejected.outcome = GpuOcStepOutcome::Unstable;
+    rejected.limitReason = "rejected";
+    m_steps.push_back( rejected );
+    return nextCandidate( GpuOcStepOutcome::Unstable, nowMs );
+  }
+
+  void cancel()
+  {
+    if ( m_state == GpuOcTuningState::Running )
+      m_state = GpuOcTuningState::Cancelled;
+  }
+
+  /// The chosen result of every finished candidate, in grid order
+  [[nodiscard]] const std::vector< GpuOcStepResult > &candidateResults() const noexcept { return m_results; }
+
+  /// Best candidate result by the objective; only once Finished
+  [[nodiscard]] std::optional< GpuOcStepResult > recommendation() const
+  {
+    if ( m_state != GpuOcTuningState::Finished || m_results.empty() )
+      return std::nullopt;
+    const bool efficiency = m_options.objective == GpuOcObjective::Efficiency;
+    return *std::max_element( m_results.begin(), m_results.end(),
+                              [efficiency]( const GpuOcStepResult &a, const GpuOcStepResult &b ) {
+                                return efficiency ? a.mhzPerW() < b.mhzPerW() : a.meanClockMHz < b.meanClockMHz;
+                              } );
+  }
+
+  /// @p setting as a profile for NvidiaOCWorker::applyGpuOCProfile()
+  [[nodiscard]] static std::string profileJSON( const GpuOcSetting &setting, unsigned lockedMinMHz )
+  {
+    std::string out;
+    JsonWriter w( out );
+    w.beginObject()
+      .key( "offsets" ).beginArray()
+        .beginObject().key( "pstate" ).value( 0 ).key( "gpuOffsetMHz" ).value( setting.offsetMHz ).endObject()
+      .endArray()
+      .key( "gpuLockedClocks" ).beginObject()
+        .key( "enabled" ).value( setting.lockedMaxMHz > 0 )
+        .key( "min" ).value( std::min( lockedMinMHz, setting.lockedMaxMHz ) )
+        .key( "max" ).value( setting.lockedMaxMHz )
+      .endObject()
+      .key( "powerLimitW" ).value( setting.powerLimitW, 1 )
+      .endObject();
+    return out;
+  }
+
+  /// Job status for GetNvidiaOCTuningStatus
+  [[nodiscard]] std::string statusJSON() const
+  {
+    std::string out;
+    JsonWriter w( out );
+    w.beginObject()
+      .key( "state" ).value( stateName( m_state ) )
+      .key( "error" ).value( m_error )
+      .key( "candidate" ).value( m_candidate )
+      .key( "candidates" ).value( m_candidates.size() );
+    w.key( "current" );
+    writeSetting( w, m_current );
+    w.key( "steps" ).beginArray();
+    for ( const auto &step : m_steps )
+      writeStep( w, step );
+    w.endArray();
+    w.key( "results" ).beginArray();
+    for ( const auto &result : m_results )
+      writeStep( w, result );
+    w.endArray();
+    w.key( "recommendation" );
+    if ( const auto best = recommendation() )
+    {
+      w.beginObject().key( "step" );
+      writeStep( w, *best );
+      w.key( "profile" ).raw( profileJSON( best->setting, m_options.lockedMinMHz ) ).endObject();
+    }
+    else
+    {
+      w.null();
+    }
+    w.endObject();
+    return out;
+  }
+
+  [[nodiscard]] static const char *stateName( GpuOcTuningState state ) noexcept
+  {
+    switch ( state )
+    {
+      case GpuOcTuningState::Idle:      return "idle";
+      case GpuOcTuningState::Running:   return "running";
+      case GpuOcTuningState::Finished:  return "finished";
+      case GpuOcTuningState::Failed:    return "failed";
+      case GpuOcTuningState::Cancelled: return "cancelled";
+    }
+    return "idle";
+  }
+
+private:
+  static bool isHwLimit( std::string_view reason ) noexcept
+  {
+    return reason.starts_with( "HW" ) || reason == "SW Thermal";
+  }
+
+  static const char *outcomeName( GpuOcStepOutcome outcome ) noexcept
+  {
+    switch ( outcome )
+    {
+      case GpuOcStepOutcome::Stable:   return "stable";
+      case GpuOcStepOutcome::Unstable: return "unstable";
+      case GpuOcStepOutcome::NoGain:   return "no-gain";
+    }
+    return "stable";
+  }
+
+  static void writeSetting( JsonWriter &w, const GpuOcSetting &setting )
+  {
+    w.beginObject()
+      .key( "powerLimitW" ).value( setting.powerLimitW, 1 )
+      .key( "lockedMaxMHz" ).value( setting.lockedMaxMHz )
+      .key( "offsetMHz" ).value( setting.offsetMHz )
+      .endObject();
+  }
+
+  static void writeStep( JsonWriter &w, const GpuOcStepResult &step )
+  {
+    w.beginObject().key( "setting" );
+    writeSetting( w, step.setting );
+    w.key( "outcome" ).value( outcomeName( step.outcome ) )
+      .key( "samples" ).value( step.samples )
+      .key( "meanClockMHz" ).value( step.meanClockMHz, 1 )
+      .key( "clockCv" ).value( step.clockCv, 4 )
+      .key( "meanPowerW" ).value( step.meanPowerW, 2 )
+      .key( "mhzPerW" ).value( step.mhzPerW(), 2 )
+      .key( "hwLimitedFraction" ).value( step.hwLimitedFraction, 3 )
+      .key( "limitReason" ).value( step.limitReason )
+      .endObject();
+  }
+
+  void beginStep( const GpuOcSetting &setting, int64_t nowMs )
+  {
+    m_current = setting;
+    m_stepStartMs = nowMs;
+    m_lastGoodMs = nowMs;
+    m_window.clear();
+    m_powerSum = 0.0;
+    m_hwLimited = 0;
+    m_reasons.clear();
+  }
+
+  void fail( std::string error )
+  {
+    m_state = GpuOcTuningState::Failed;
+    m_error = std::move( error );
+  }
+
+  std::optional< GpuOcSetting > finishStep( int64_t nowMs )
+  {
+    GpuOcStepResult step;
+    step.setting = m_current;
+    step.samples = static_cast< int >( m_window.size() );
+    double sum = 0.0;
+    for ( double clock : m_window )
+      sum += clock;
+    step.meanClockMHz = sum / m_window.size();
+    double variance = 0.0;
+    for ( double clock : m_window )
+      variance += ( clock - step.meanClockMHz ) * ( clock - step.meanClockMHz );
+    variance /= m_window.size();
+    step.clockCv = step.meanClockMHz > 0.0 ? std::sqrt( variance ) / step.meanClockMHz : 0.0;
+    step.meanPowerW = m_powerSum / m_window.size();
+    step.hwLimitedFraction = static_cast< double >( m_hwLimited ) / m_window.size();
+    step.limitReason = std::max_element( m_reasons.begin(), m_reasons.end(), []( const auto &a, const auto &b ) {
+                         return a.second < b.second;
+                       } )->first;
+
+    const GpuOcStepResult *previous = lastStableOfCandidate();
+    if ( step.clockCv > m_options.maxClockCv || step.hwLimitedFraction > m_options.maxHwLimitedFraction )
+      step.outcome = GpuOcStepOutcome::Unstable;
+    else if ( previous && step.meanClockMHz < previous->meanClockMHz - m_options.offsetStepMHz / 2.0 )
+      step.outcome = GpuOcStepOutcome::NoGain;
+    m_steps.push_back( step );
+
+    if ( step.outcome == GpuOcStepOutcome::Stable && m_current.offsetMHz + m_options.offsetStepMHz <= m_options.maxOffsetMHz )
+    {
+      GpuOcSetting next = m_current;
+      next.offsetMHz += m_options.offsetStepMHz;
+      beginStep( next, nowMs );
+      return m_current;
+    }
+    return nextCandidate( step.outcome, nowMs );
+  }
+
+  /// Newest stable step of the running candidate
+  const GpuOcStepResult *lastStableOfCandidate() const
+  {
+    for ( auto it = m_steps.rbegin(); it != m_steps.rend(); ++it )
+    {
+      if ( it->setting.powerLimitW != m_current.powerLimitW || it->setting.lockedMaxMHz != m_current.lockedMaxMHz
+           || it->setting.offsetMHz >= m_current.offsetMHz )
+        break;
+      if ( it->outcome == GpuOcStepOutcome::Stable )
+        return &*it;
+    }
+    return nullptr;
+  }
+
+  /// Record the running candidate's result after a step with @p outcome and move on
+  std::optional< GpuOcSetting > nextCandidate( GpuOcStepOutcome outcome, int64_t nowMs )
+  {
+    // steps of this candidate ascend by offset from 0, so going back is a search
+    std::vector< const GpuOcStepResult * > stable;
+    for ( const auto &step : m_steps )
+      if ( step.setting.powerLimitW == m_current.powerLimitW && step.setting.lockedMaxMHz == m_current.lockedMaxMHz
+           && step.outcome == GpuOcStepOutcome::Stable )
+        stable.push_back( &step );
+    if ( !stable.empty() )
+    {
+      const size_t back = outcome == GpuOcStepOutcome::Unstable ? static_cast< size_t >( m_options.safetySteps ) : 0;
+      m_results.push_back( *stable[ stable.size() - 1 - std::min( back, stable.size() - 1 ) ] );
+    }
+
+    if ( ++m_candidate >= m_candidates.size() )
+    {
+      if ( m_results.empty() )
+        fail( "no stable setting found" );
+      else
+        m_state = GpuOcTuningState::Finished;
+      return std::nullopt;
+    }
+    beginStep( m_candidates[ m_candidate ], nowMs );
+    return m_current;
+  }
+
+  GpuOcTuningOptions m_options;
+  std::vector< GpuOcSetting > m_candidates;
+  size_t m_candidate = 0;
+  GpuOcTuningState m_state = GpuOcTuningState::Idle;
+  std::string m_error;
+  GpuOcSetting m_current;
+  std::vector< GpuOcStepResult > m_steps;
+  std::vector< GpuOcStepResult > m_results;
+
+  // measurement of the step in effect
+  int64_t m_stepStartMs = 0;
+  int64_t m_lastGoodMs = 0;
+  int64_t m_windowStartMs = 0;
+  bool m_anyLoaded = false;
+  std::vector< double > m_window;
+  double m_powerSum = 0.0;
+  size_t m_hwLimited = 0;
+  std::map< std::string, size_t > m_reasons;
+};
@@ -0,0 +1,176 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sysfs locations of the GPUs the hardware monitor reads.
+ *
+ * Empty strings mean "not present".
+ */
+struct GpuTopology
+{
+  std::string intelIGpuDrmPath;    ///< .../drm/cardN of the Intel iGPU
+  std::string amdIGpuHwmonPath;    ///< /sys/class/hwmon/hwmonN of the AMD iGPU
+  std::string amdDGpuHwmonPath;    ///< /sys/class/hwmon/hwmonN of the AMD dGPU
+  std::string nvidiaEdpConnector;  ///< Connected eDP connector driven by an NVIDIA GPU (display mux)
+
+  bool operator==( const GpuTopology & ) const = default;
+};
+
+/**
+ * @brief One-shot scan of the PCI, hwmon and DRM directories.
+ *
+ * The PCI_ID patterns are compiled once at construction, so a rescan after
+ * a hotplug event only costs the directory walks.  Entries are visited in
+ * sorted order, making the result independent of readdir order.
+ */
+class GpuTopologyScanner
+{
+public:
+  /// PCI_ID regular expressions, e.g. "8086:(A780|A781)"
+  struct Patterns
+  {
+    std::string intelIGpu;
+    std::string amdIGpu;
+    std::string amdDGpu;
+  };
+
+  struct Paths
+  {
+    std::string pciRoot = ucc::sysfsPath( "/sys/bus/pci/devices" );
+    std::string hwmonRoot = ucc::sysfsPath( "/sys/class/hwmon" );
+    std::string drmRoot = ucc::sysfsPath( "/sys/class/drm" );
+  };
+
+  explicit GpuTopologyScanner( const Patterns &patterns )
+    : GpuTopologyScanner( patterns, Paths() )
+  {
+  }
+
+  GpuTopologyScanner( const Patterns &patterns, Paths paths )
+    : m_paths( std::move( paths ) )
+    , m_intelIGpu( compile( patterns.intelIGpu ) )
+    , m_amdIGpu( compile( patterns.amdIGpu ) )
+    , m_amdDGpu( compile( patterns.amdDGpu ) )
+  {
+  }
+
+  [[nodiscard]] GpuTopology scan() const noexcept
+  {
+    GpuTopology topology;
+    try
+    {
+      topology.intelIGpuDrmPath = findIntelDrmCard();
+      topology.amdIGpuHwmonPath = findAmdGpuHwmon( m_amdIGpu );
+      topology.amdDGpuHwmonPath = findAmdGpuHwmon( m_amdDGpu );
+      topology.nvidiaEdpConnector = findNvidiaEdp();
+    }
+    catch ( ... ) {}
+    return topology;
+  }
+
+private:
+  static std::regex compile( const std::string &pattern )
+  {
+    // an empty pattern must not match every uevent
+    return std::regex( pattern.empty() ? std::string( "$^" ) : "PCI_ID=" + pattern );
+  }
+
+  static std::vector< std::filesystem::path > sortedEntries( const std::filesystem::path &root )
+  {
+    std::vector< std::filesystem::path > entries;
+    std::error_code ec;
+    for ( const auto &entry : std::filesystem::directory_iterator( root, ec ) )
+      entries.push_back( entry.path() );
+    std::sort( entries.begin(), entries.end() );
+    return entries;
+  }
+
+  /// Whether the uevent file has a matching PCI_ID line (and DRIVER=amdgpu if @p amdgpu)
+  static bool ueventMatches( const std::filesystem::path &uevent, const std::regex &id, bool amdgpu )
+  {
+    std::ifstream file( uevent );
+    bool idMatches = false;
+    bool driverMatches = not amdgpu;
+    std::string line;
+    while ( std::getline( file, line ) )
+    {
+      if ( line == "DRIVER=amdgpu" )
+        driverMatches = true;
+      else if ( std::regex_search( line, id ) )
+        idMatches = true;
+      if ( idMatches and driverMatches )
+        return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] std::string findIntelDrmCard() const
+  {
+    for ( const auto &pciDev : sortedEntries( m_paths.pciRoot ) )
+    {
+      for ( const auto &card : sortedEntries( pciDev / "drm" ) )
+      {
+        // cardN only; renderDN has no gt_* attributes
+        const std::string name = card.filename().string();
+        if ( name.rfind( "card", 0 ) != 0 or name.find( '-' ) != std::string::npos )
+          continue;
+        if ( ueventMatches( card / "device" / "uevent", m_intelIGpu, false ) )
+          return card.string();
+      }
+    }
+    return "";
+  }
+
+  [[nodiscard]] std::string findAmdGpuHwmon( const std::regex &id ) const
+  {
+    for ( const auto &hwmon : sortedEntries( m_paths.hwmonRoot ) )
+      if ( ueventMatches( hwmon / "device" / "uevent", id, true ) )
+        return hwmon.string();
+    return "";
+  }
+
+  [[nodiscard]] std::string findNvidiaEdp() const
+  {
+    for ( const auto &connector : sortedEntries( m_paths.drmRoot ) )
+    {
+      // e.g. card0-eDP-1, card1-eDP-2
+      if ( connector.filename().string().find( "eDP" ) == std::string::npos )
+        continue;
+
+      // 0x10de = NVIDIA vendor ID
+      const auto vendor = SysfsNode< std::string >( ( connector / "device" / "device" / "vendor" ).string() ).read();
+      const auto status = SysfsNode< std::string >( ( connector / "status" ).string() ).read();
+      if ( vendor and status and *vendor == "0x10de" and *status == "connected" )
+        return connector.filename().string();
+    }
+    return "";
+  }
+
+  Paths m_paths;
+  std::regex m_intelIGpu;
+  std::regex m_amdIGpu;
+  std::regex m_amdDGpu;
+};
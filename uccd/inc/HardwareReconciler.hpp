@@ -0,0 +1,248 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <syslog.h>
+#include <utility>
+#include <vector>
+
+/// A piece of hardware state the daemon keeps in place
+struct ReconcileTarget
+{
+  std::string name;
+  /// Cheap token of the state the daemon wants; a change restarts the probe schedule
+  std::function< uint64_t() > desired;
+  /// True while the hardware still holds the desired state
+  std::function< bool() > probe;
+  /// Idempotent write of the desired state; false if the write failed
+  std::function< bool() > apply;
+  /// Process names (/proc/<pid>/comm) known to write this state
+  std::vector< std::string > suspects;
+};
+
+/// Counters of one target, for GetWorkerStatsJSON
+struct ReconcileStatus
+{
+  std::string name;
+  uint64_t probes = 0;
+  uint64_t drifts = 0;
+  uint64_t reapplies = 0;
+  int64_t intervalMs = 0;
+  bool gaveUp = false;
+  /// Drifts per suspect that was running at the time; "unknown" when none was
+  std::map< std::string, uint64_t > agents;
+};
+
+/**
+ * @brief Keeps the daemon's hardware settings in place against other agents.
+ *
+ * Each subsystem registers what it wants (a token that changes with its
+ * desired state), a cheap probe and an idempotent apply.  runDue(), called
+ * from the service tick, probes a target once its interval has passed:
+ *   - In place: the interval doubles, from MIN_INTERVAL_MS up to
+ *     MAX_INTERVAL_MS, so stable settings are rarely read.
+ *   - Drifted: the running suspects are noted as the likely culprits, the
+ *     state is reapplied and the interval drops back to MIN_INTERVAL_MS.
+ *     After MAX_ATTEMPTS reapplies without a clean probe in between the
+ *     target gives up, and stays probed at MAX_INTERVAL_MS, until a clean
+ *     probe or a new desired state.
+ * A new desired state (a profile apply) restarts the schedule, so the
+ * write is checked MIN_INTERVAL_MS later; poke() probes every target on
+ * the next run, e.g. after resume.
+ *
+ * Register every target before the first runDue().  runDue() must not
+ * run concurrently with itself; poke() and status() are thread-safe.
+ * Callbacks run without the lock held.
+ */
+class HardwareReconciler
+{
+public:
+  static constexpr int64_t MIN_INTERVAL_MS = 2'000;
+  static constexpr int64_t MAX_INTERVAL_MS = 32'000;
+  static constexpr int MAX_ATTEMPTS = 3;
+
+  /// Suspects (of the given ones) that are running
+  using AgentScan = std::function< std::vector< std::string >( const std::vector< std::string > & ) >;
+
+  HardwareReconciler()
+    : HardwareReconciler( []( const std::vector< std::string > &names ) { return runningProcesses( names ); } )
+  {
+  }
+
+  explicit HardwareReconciler( AgentScan scan ) : m_scan( std::move( scan ) ) {}
+
+  void add( ReconcileTarget target )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_targets.emplace_back( std::move( target ) );
+  }
+
+  /// Probe and, on drift, reapply every target that is due at @p nowMs
+  void runDue( int64_t nowMs )
+  {
+    const bool poked = m_poked.exchange( false );
+    for ( Entry &t : m_targets )
+    {
+      const uint64_t desired = t.target.desired ? t.target.desired() : 0;
+      std::unique_lock< std::mutex > lock( m_mutex );
+      if ( !t.known || desired != t.desired )
+      {
+        t.known = true;
+        t.desired = desired;
+        t.consecutiveDrifts = 0;
+        t.gaveUp = false;
+        schedule( t, nowMs, MIN_INTERVAL_MS );
+        continue;
+      }
+      if ( !poked && nowMs < t.nextProbeMs )
+        continue;
+
+      lock.unlock();
+      const bool inPlace = t.target.probe();
+      lock.lock();
+      ++t.status.probes;
+      if ( inPlace )
+      {
+        if ( t.gaveUp )
+          syslog( LOG_INFO, "[Reconcile] %s is back in place", t.target.name.c_str() );
+        t.consecutiveDrifts = 0;
+        t.gaveUp = false;
+        schedule( t, nowMs, std::min( t.status.intervalMs * 2, MAX_INTERVAL_MS ) );
+        continue;
+      }
+
+      ++t.status.drifts;
+      lock.unlock();
+      const std::vector< std::string > agents = m_scan( t.target.suspects );
+      lock.lock();
+      std::string culprits;
+      for ( const std::string &agent : agents )
+      {
+        ++t.status.agents[ agent ];
+        culprits += ( culprits.empty() ? "" : ", " ) + agent;
+      }
+      if ( agents.empty() )
+      {
+        ++t.status.agents[ "unknown" ];
+        culprits = "unknown";
+      }
+
+      if ( t.gaveUp )
+      {
+        schedule( t, nowMs, MAX_INTERVAL_MS );
+        continue;
+      }
+      if ( ++t.consecutiveDrifts > MAX_ATTEMPTS )
+      {
+        syslog( LOG_WARNING, "[Reconcile] %s keeps being changed (likely by: %s), giving up after %d attempts",
+                t.target.name.c_str(), culprits.c_str(), MAX_ATTEMPTS );
+        t.gaveUp = true;
+        schedule( t, nowMs, MAX_INTERVAL_MS );
+        continue;
+      }
+      syslog( LOG_INFO, "[Reconcile] %s changed externally (likely by: %s), reapplying (attempt %d/%d)",
+              t.target.name.c_str(), culprits.c_str(), t.consecutiveDrifts, MAX_ATTEMPTS );
+
+      lock.unlock();
+      const bool applied = t.target.apply();
+      // the apply may move the token itself (e.g. a new generation); that is not a new wish
+      const uint64_t after = t.target.desired ? t.target.desired() : 0;
+      lock.lock();
+      if ( applied )
+        ++t.status.reapplies;
+      t.desired = after;
+      schedule( t, nowMs, MIN_INTERVAL_MS );
+    }
+  }
+
+  /// Probe every target on the next runDue()
+  void poke() noexcept { m_poked = true; }
+
+  [[nodiscard]] std::vector< ReconcileStatus > status() const
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    std::vector< ReconcileStatus > result;
+    result.reserve( m_targets.size() );
+    for ( const Entry &t : m_targets )
+    {
+      result.push_back( t.status );
+      result.back().name = t.target.name;
+      result.back().gaveUp = t.gaveUp;
+    }
+    return result;
+  }
+
+  /// Those of @p names that match the comm of a process under @p procRoot
+  static std::vector< std::string > runningProcesses( const std::vector< std::string > &names,
+                                                      const std::string &procRoot = "/proc" )
+  {
+    std::vector< std::string > found;
+    if ( names.empty() )
+      return found;
+    std::error_code ec;
+    for ( const auto &dir : std::filesystem::directory_iterator( procRoot, ec ) )
+    {
+      const std::string pid = dir.path().filename().string();
+      if ( pid.empty() || !std::all_of( pid.begin(), pid.end(), []( char c ) { return c >= '0' && c <= '9'; } ) )
+        continue;
+      std::string comm;
+      if ( !std::getline( std::ifstream( dir.path() / "comm" ), comm ) )
+        continue;
+      for ( const std::string &name : names )
+      {
+        // the kernel cuts comm to 15 characters
+        if ( comm == name.substr( 0, 15 ) && std::find( found.begin(), found.end(), name ) == found.end() )
+          found.push_back( name );
+      }
+    }
+    std::sort( found.begin(), found.end() );
+    return found;
+  }
+
+private:
+  struct Entry
+  {
+    explicit Entry( ReconcileTarget t ) : target( std::move( t ) ) {}
+
+    ReconcileTarget target;
+    ReconcileStatus status{};
+    uint64_t desired = 0;
+    bool known = false;
+    int64_t nextProbeMs = 0;
+    int consecutiveDrifts = 0;
+    bool gaveUp = false;
+  };
+
+  static void schedule( Entry &t, int64_t nowMs, int64_t intervalMs )
+  {
+    t.status.intervalMs = intervalMs;
+    t.nextProbeMs = nowMs + intervalMs;
+  }
+
+  AgentScan m_scan;
+  mutable std::mutex m_mutex;
+  std::vector< Entry > m_targets;
+  std::atomic< bool > m_poked{ false };
+};
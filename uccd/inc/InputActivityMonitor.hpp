@@ -0,0 +1,169 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**
+ * @brief When the keyboards and pointing devices were last used.
+ *
+ * Every "-event-kbd" and "-event-mouse" node (built-in keyboard, touchpad,
+ * USB keyboards and mice) is opened without a grab and added to one epoll
+ * set.  The owner watches fd() in its event loop only while it waits for
+ * the first event, e.g. to light a dimmed keyboard; the rest of the time
+ * the events queue up unread, and drain() reports the newest one's time,
+ * so typing costs no wakeups.  An overflowing queue is fine: evdev then
+ * drops the older events and keeps the newest.
+ *
+ * Event times are switched to CLOCK_MONOTONIC, the clock of
+ * std::chrono::steady_clock.  Only the time of an event is kept, never
+ * what it was.
+ */
+class InputActivityMonitor
+{
+public:
+  static constexpr const char *INPUT_BY_PATH = "/dev/input/by-path";
+
+  InputActivityMonitor() = default;
+  ~InputActivityMonitor() { close(); }
+
+  InputActivityMonitor( const InputActivityMonitor & ) = delete;
+  InputActivityMonitor &operator=( const InputActivityMonitor & ) = delete;
+
+  /// The keyboard and mouse event nodes in @p byPath, sorted
+  [[nodiscard]] static std::vector< std::string > findDevices( const std::string &byPath = INPUT_BY_PATH )
+  {
+    std::error_code ec;
+    std::vector< std::string > devices;
+    for ( const auto &entry : std::filesystem::directory_iterator( byPath, ec ) )
+    {
+      const std::string name = entry.path().filename().string();
+      if ( name.ends_with( "-event-kbd" ) or name.ends_with( "-event-mouse" ) )
+        devices.push_back( entry.path().string() );
+    }
+    std::sort( devices.begin(), devices.end() );
+    return devices;
+  }
+
+  /**
+   * @brief Watch exactly @p devices: open the new ones, close the gone ones
+   * @return false if the epoll set cannot be created
+   */
+  bool sync( const std::vector< std::string > &devices )
+  {
+    if ( m_epollFd < 0 )
+      m_epollFd = ::epoll_create1( EPOLL_CLOEXEC );
+    if ( m_epollFd < 0 )
+      return false;
+
+    for ( auto it = m_devices.begin(); it != m_devices.end(); )
+    {
+      if ( std::find( devices.begin(), devices.end(), it->first ) == devices.end() )
+      {
+        ::close( it->second );
+        it = m_devices.erase( it );
+      }
+      else
+        ++it;
+    }
+
+    for ( const auto &path : devices )
+    {
+      if ( m_devices.contains( path ) )
+        continue;
+      const int fd = ::open( path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+      if ( fd < 0 )
+        continue;
+      int clock = CLOCK_MONOTONIC;
+      (void) ::ioctl( fd, EVIOCSCLOCKID, &clock );
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.fd = fd;
+      if ( ::epoll_ctl( m_epollFd, EPOLL_CTL_ADD, fd, &event ) != 0 )
+      {
+        ::close( fd );
+        continue;
+      }
+      m_devices.emplace( path, fd );
+    }
+    return true;
+  }
+
+  void close()
+  {
+    for ( const auto &[ path, fd ] : m_devices )
+      ::close( fd );
+    m_devices.clear();
+    if ( m_epollFd >= 0 )
+      ::close( m_epollFd );
+    m_epollFd = -1;
+  }
+
+  /// The epoll set; readable while an event is queued
+  [[nodiscard]] int fd() const noexcept { return m_epollFd; }
+
+  [[nodiscard]] size_t devices() const noexcept { return m_devices.size(); }
+
+  /**
+   * @brief Read every queued event
+   * @return Time of the newest, in steady_clock milliseconds; nullopt if
+   *         none was queued
+   */
+  std::optional< int64_t > drain()
+  {
+    std::optional< int64_t > newest;
+    for ( auto it = m_devices.begin(); it != m_devices.end(); )
+    {
+      input_event events[ 64 ];
+      ssize_t n;
+      while ( ( n = ::read( it->second, events, sizeof( events ) ) ) > 0 )
+        for ( size_t i = 0; i < static_cast< size_t >( n ) / sizeof( input_event ); ++i )
+        {
+          const int64_t ms = static_cast< int64_t >( events[ i ].input_event_sec ) * 1000
+                             + static_cast< int64_t >( events[ i ].input_event_usec ) / 1000;
+          newest = std::max( newest.value_or( ms ), ms );
+        }
+
+      // unplugged: the node is gone until the next sync()
+      if ( n < 0 and errno == ENODEV )
+      {
+        ::close( it->second );
+        it = m_devices.erase( it );
+      }
+      else
+        ++it;
+    }
+    return newest;
+  }
+
+private:
+  int m_epollFd = -1;
+  std::map< std::string, int > m_devices;  ///< path -> open event node
+};
@@ -0,0 +1,230 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FanLatencyTrace.hpp"
+#include "JsonWriter.hpp"
+
+/**
+ * @brief Call counts and latencies of the daemon's D-Bus methods.
+ *
+ * One entry per method name, each with a LatencySnapshot-style log2
+ * histogram, a per-second ring for the recent call rate and a breakdown by
+ * sender.  Unique bus names churn (every ucc-cli run is a new one), so at
+ * most MAX_SENDERS are kept; a new sender beyond that folds the one with
+ * the fewest calls into OTHER_SENDER, which keeps the heavy pollers visible.
+ *
+ * Not thread-safe: D-Bus and peer-channel calls are dispatched on the main
+ * thread, which is the only one to touch it.
+ */
+class IpcStats
+{
+public:
+  static constexpr size_t MAX_SENDERS = 32;
+  static constexpr size_t RATE_WINDOW_S = 60;
+  static constexpr std::string_view OTHER_SENDER = "other";
+
+  struct SenderCalls
+  {
+    uint64_t calls = 0;
+    uint64_t totalNs = 0;
+  };
+
+  struct Method
+  {
+    LatencySnapshot latency;
+    std::map< std::string, SenderCalls, std::less<> > senders;
+    std::array< uint32_t, RATE_WINDOW_S > perSecond{};
+    int64_t lastSecond = 0;
+
+    /// Calls in the RATE_WINDOW_S seconds up to @p nowMs
+    [[nodiscard]] uint64_t recentCalls( int64_t nowMs ) const noexcept
+    {
+      const int64_t now = nowMs / 1000;
+      uint64_t sum = 0;
+      for ( int64_t s = std::max< int64_t >( std::max( lastSecond, now ) - int64_t( RATE_WINDOW_S ) + 1, 0 );
+            s <= lastSecond; ++s )
+        sum += perSecond[ static_cast< size_t >( s ) % RATE_WINDOW_S ];
+      return sum;
+    }
+  };
+
+  explicit IpcStats( int64_t startMs = 0 ) noexcept : m_startMs( startMs ) {}
+
+  /**
+   * @param method Method name as exported
+   * @param sender Unique bus name or peer-channel caller; empty is OTHER_SENDER
+   * @param ns     Time spent in the method
+   * @param nowMs  Steady-clock time of the call
+   */
+  void record( std::string_view method, std::string_view sender, uint64_t ns, int64_t nowMs )
+  {
+    auto it = m_methods.find( method );
+    if ( it == m_methods.end() )
+      it = m_methods.emplace( std::string( method ), Method{} ).first;
+    Method &m = it->second;
+
+    m.latency.buckets[ LatencyHistogram::bucketFor( ns ) ] += 1;
+    m.latency.count += 1;
+    m.latency.totalNs += ns;
+    m.latency.maxNs = std::max( m.latency.maxNs, ns );
+
+    const int64_t second = nowMs / 1000;
+    if ( second != m.lastSecond )
+    {
+      // zero the slots of the seconds without calls since the last one
+      const int64_t gap = std::min< int64_t >( second - m.lastSecond, RATE_WINDOW_S );
+      for ( int64_t s = second - gap + 1; s <= second; ++s )
+        m.perSecond[ static_cast< size_t >( s ) % RATE_WINDOW_S ] = 0;
+      m.lastSecond = second;
+    }
+    m.perSecond[ static_cast< size_t >( second ) % RATE_WINDOW_S ] += 1;
+
+    const std::string_view key = admitSender( sender.empty() ? OTHER_SENDER : sender );
+    SenderCalls &byMethod = m.senders[ std::string( key ) ];
+    byMethod.calls += 1;
+    byMethod.totalNs += ns;
+    SenderCalls &total = m_senders.find( key )->second;
+    total.calls += 1;
+    total.totalNs += ns;
+  }
+
+  [[nodiscard]] const std::map< std::string, Method, std::less<> > &methods() const noexcept { return m_methods; }
+  [[nodiscard]] const std::map< std::string, SenderCalls, std::less<> > &senders() const noexcept { return m_senders; }
+
+  /**
+   * @brief Serialise everything, methods by descending call count.
+   *
+   * @param describe Optional; adds a "process" field (e.g. "ucc-tray
+   *                 (1234)") to each sender for which it returns non-empty
+   */
+  void toJSON( JsonWriter &w, int64_t nowMs,
+               const std::function< std::string( std::string_view ) > &describe = {} ) const
+  {
+    std::vector< const std::pair< const std::string, Method > * > order;
+    order.reserve( m_methods.size() );
+    uint64_t calls = 0;
+    for ( const auto &entry : m_methods )
+    {
+      order.push_back( &entry );
+      calls += entry.second.latency.count;
+    }
+    std::ranges::stable_sort( order, std::greater<>{},
+                              []( const auto *e ) { return e->second.latency.count; } );
+
+    w.beginObject()
+      .key( "uptimeS" ).value( static_cast< double >( std::max< int64_t >( nowMs - m_startMs, 0 ) ) / 1000.0, 1 )
+      .key( "rateWindowS" ).value( RATE_WINDOW_S )
+      .key( "calls" ).value( calls )
+      .key( "histogramUpperUs" ).beginArray();
+    for ( size_t i = 0; i + 1 < LatencySnapshot::BUCKETS; ++i )
+      w.value( LatencySnapshot::upperUs( i ) );
+    w.endArray().key( "methods" ).beginArray();
+
+    for ( const auto *entry : order )
+    {
+      const Method &m = entry->second;
+      const LatencySnapshot &s = m.latency;
+      const double count = static_cast< double >( std::max< uint64_t >( s.count, 1 ) );
+      w.beginObject()
+        .key( "name" ).value( entry->first )
+        .key( "count" ).value( s.count )
+        .key( "recent" ).value( m.recentCalls( nowMs ) )
+        .key( "avgUs" ).value( static_cast< double >( s.totalNs ) / count / 1000.0, 1 )
+        .key( "maxUs" ).value( static_cast< double >( s.maxNs ) / 1000.0, 1 )
+        .key( "p50Us" ).value( s.quantileUpperUs( 0.50 ) )
+        .key( "p95Us" ).value( s.quantileUpperUs( 0.95 ) )
+        .key( "p99Us" ).value( s.quantileUpperUs( 0.99 ) )
+        .key( "histogram" ).beginArray();
+      for ( const uint64_t bucket : s.buckets )
+        w.value( bucket );
+      w.endArray().key( "senders" ).beginObject();
+      for ( const auto &[ sender, c ] : m.senders )
+        w.key( sender ).value( c.calls );
+      w.endObject().endObject();
+    }
+
+    w.endArray().key( "senders" ).beginArray();
+    for ( const auto &[ sender, c ] : m_senders )
+    {
+      w.beginObject()
+        .key( "sender" ).value( sender )
+        .key( "calls" ).value( c.calls )
+        .key( "totalUs" ).value( c.totalNs / 1000 );
+      if ( describe )
+        if ( const std::string process = describe( sender ); !process.empty() )
+          w.key( "process" ).value( process );
+      w.endObject();
+    }
+    w.endArray().endObject();
+  }
+
+private:
+  /// Key under which @p sender is counted, making room for it if needed
+  std::string_view admitSender( std::string_view sender )
+  {
+    if ( auto it = m_senders.find( sender ); it != m_senders.end() )
+      return it->first;
+
+    // folding the first victim may only replace it by OTHER_SENDER
+    while ( m_senders.size() >= MAX_SENDERS && !m_senders.contains( sender ) )
+    {
+      auto victim = m_senders.end();
+      for ( auto it = m_senders.begin(); it != m_senders.end(); ++it )
+        if ( it->first != OTHER_SENDER && ( victim == m_senders.end() || it->second.calls < victim->second.calls ) )
+          victim = it;
+      if ( victim == m_senders.end() )
+      {
+        sender = OTHER_SENDER;
+        break;
+      }
+      fold( victim->first );
+    }
+    return m_senders.try_emplace( std::string( sender ) ).first->first;
+  }
+
+  /// Merge every count of @p sender into OTHER_SENDER
+  void fold( std::string sender )
+  {
+    for ( auto &[ name, m ] : m_methods )
+    {
+      auto node = m.senders.extract( sender );
+      if ( node.empty() )
+        continue;
+      SenderCalls &other = m.senders[ std::string( OTHER_SENDER ) ];
+      other.calls += node.mapped().calls;
+      other.totalNs += node.mapped().totalNs;
+    }
+    auto node = m_senders.extract( sender );
+    SenderCalls &other = m_senders[ std::string( OTHER_SENDER ) ];
+    other.calls += node.mapped().calls;
+    other.totalNs += node.mapped().totalNs;
+  }
+
+  int64_t m_startMs;
+  std::map< std::string, Method, std::less<> > m_methods;
+  std::map< std::string, SenderCalls, std::less<> > m_senders;
+};
@@ -0,0 +1,199 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Minimal streaming JSON writer for hot-path serialisation.
+ *
+ * Appends to a caller-owned std::string: clear() keeps its capacity, so a
+ * buffer that is reused across ticks stops allocating once it has grown to
+ * the largest document.  Numbers go through std::to_chars (no locale, no
+ * iostream state).  Commas are inserted automatically; nesting is limited
+ * to 64 levels.
+ *
+ * @code
+ *   JsonWriter w( buffer );
+ *   w.beginObject().key( "temp" ).value( 45.5, 2 ).key( "ok" ).value( true ).endObject();
+ * @endcode
+ */
+class JsonWriter
+{
+public:
+  /**
+   * @param out Destination; cleared, capacity retained.
+   */
+  explicit JsonWriter( std::string &out ) noexcept : m_out( out ) { m_out.clear(); }
+
+  JsonWriter &beginObject() { prefix(); m_out.push_back( '{' ); push(); return *this; }
+  JsonWriter &endObject() { pop(); m_out.push_back( '}' ); return *this; }
+  JsonWriter &beginArray() { prefix(); m_out.push_back( '[' ); push(); return *this; }
+  JsonWriter &endArray() { pop(); m_out.push_back( ']' ); return *this; }
+
+  /**
+   * @brief Object key; @p name is written verbatim (keys are literals).
+   */
+  JsonWriter &key( std::string_view name )
+  {
+    prefix();
+    m_out.push_back( '"' );
+    m_out.append( name );
+    m_out.append( "\":", 2 );
+    m_afterKey = true;
+    return *this;
+  }
+
+  /**
+   * @brief Floating-point value.
+   *
+   * @param precision Fixed digits after the point, or -1 for the shortest
+   *                  representation that round-trips.  NaN/inf become null.
+   */
+  JsonWriter &value( double v, int precision = -1 )
+  {
+    prefix();
+    if ( !std::isfinite( v ) )
+    {
+      m_out.append( "null", 4 );
+      return *this;
+    }
+
+    char buf[ 64 ];
+    const auto res = precision < 0
+      ? std::to_chars( buf, buf + sizeof( buf ), v )
+      : std::to_chars( buf, buf + sizeof( buf ), v, std::chars_format::fixed, precision );
+    m_out.append( buf, res.ec == std::errc() ? static_cast< size_t >( res.ptr - buf ) : 0 );
+    return *this;
+  }
+
+  template< typename Int,
+            typename = std::enable_if_t< std::is_integral_v< Int > && !std::is_same_v< Int, bool > > >
+  JsonWriter &value( Int v )
+  {
+    prefix();
+    char buf[ 24 ];
+    const auto res = std::to_chars( buf, buf + sizeof( buf ), v );
+    m_out.append( buf, static_cast< size_t >( res.ptr - buf ) );
+    return *this;
+  }
+
+  JsonWriter &value( bool v )
+  {
+    prefix();
+    if ( v )
+      m_out.append( "true", 4 );
+    else
+      m_out.append( "false", 5 );
+    return *this;
+  }
+
+  /**
+   * @brief String value, escaped.
+   */
+  JsonWriter &value( std::string_view s )
+  {
+    prefix();
+    m_out.push_back( '"' );
+    appendEscaped( s );
+    m_out.push_back( '"' );
+    return *this;
+  }
+
+  JsonWriter &value( const char *s ) { return value( std::string_view( s ) ); }
+  JsonWriter &value( const std::string &s ) { return value( std::string_view( s ) ); }
+
+  JsonWriter &null()
+  {
+    prefix();
+    m_out.append( "null", 4 );
+    return *this;
+  }
+
+  /**
+   * @brief Already-serialised JSON fragment, inserted as one value.
+   */
+  JsonWriter &raw( std::string_view json )
+  {
+    prefix();
+    m_out.append( json );
+    return *this;
+  }
+
+private:
+  void prefix()
+  {
+    if ( m_afterKey )
+    {
+      m_afterKey = false;
+      return;
+    }
+    const uint64_t bit = uint64_t( 1 ) << ( m_depth & 63 );
+    if ( m_hasItems & bit )
+      m_out.push_back( ',' );
+    m_hasItems |= bit;
+  }
+
+  void push() noexcept
+  {
+    ++m_depth;
+    m_hasItems &= ~( uint64_t( 1 ) << ( m_depth & 63 ) );
+  }
+
+  void pop() noexcept
+  {
+    if ( m_depth > 0 )
+      --m_depth;
+  }
+
+  void appendEscaped( std::string_view s )
+  {
+    static constexpr char HEX[] = "0123456789abcdef";
+    for ( const char c : s )
+    {
+      switch ( c )
+      {
+        case '"': m_out.append( "\\\"", 2 ); break;
+        case '\\': m_out.append( "\\\\", 2 ); break;
+        case '\b': m_out.append( "\\b", 2 ); break;
+        case '\f': m_out.append( "\\f", 2 ); break;
+        case '\n': m_out.append( "\\n", 2 ); break;
+        case '\r': m_out.append( "\\r", 2 ); break;
+        case '\t': m_out.append( "\\t", 2 ); break;
+        default:
+          if ( static_cast< unsigned char >( c ) < 0x20 )
+          {
+            const auto u = static_cast< unsigned char >( c );
+            const char esc[ 6 ] = { '\\', 'u', '0', '0', HEX[ u >> 4 ], HEX[ u & 0xf ] };
+            m_out.append( esc, sizeof( esc ) );
+          }
+          else
+            m_out.push_back( c );
+          break;
+      }
+    }
+  }
+
+  std::string &m_out;
+  uint64_t m_hasItems = 0;  ///< Bit d: container at depth d already has an element
+  unsigned m_depth = 0;
+  bool m_afterKey = false;
+};
@@ -15,16 +15,27 @@
 
 #pragma once
 
+#include "AsyncLog.hpp"
+#include "BrightnessRamp.hpp"
 #include "SysfsNode.hpp"
+#include "KeyboardEffects.hpp"
 #include <string>
 #include <vector>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <ranges>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace fs = std::filesystem;
 
 /**
@@ -55,18 +66,31 @@ struct KeyboardBacklightState
  *
  * Replaces the former KeyboardBacklightListener polling thread with a
  * direct, non-threaded implementation.  All public methods are meant to
- * be called from the main / D-Bus thread.
+ * be called from the main / D-Bus thread, except writeFrame(), which
+ * KeyboardEffectWorker calls from its own; a mutex serialises the writes.
+ *
+ * The brightness, buffer_input and multi_intensity nodes are opened once
+ * after detection and written in place, and a zone is only written when
+ * its colour changed, so an animation frame costs one buffer_input
+ * bracket and a write per changed zone.  The brightness is read back
+ * rather than remembered, since the Fn keys change it too.
  *
  * Supports:
  * - White-only backlights
  * - RGB zone backlights (1-3 zones)
  * - Per-key RGB backlights
+ * - Animated effects on RGB backlights (see KeyboardEffect)
+ * - Fading out while the user is away (setIdle())
  */
 class KeyboardBacklightController
 {
 public:
   KeyboardBacklightController() = default;
-  ~KeyboardBacklightController() = default;
+
+  ~KeyboardBacklightController()
+  {
+    closeNodes();
+  }
 
   // non-copyable, non-movable
   KeyboardBacklightController( const KeyboardBacklightController & ) = delete;
@@ -84,6 +108,7 @@ public:
 
     if ( m_capabilities.zones > 0 )
     {
+      openNodes();
       std::cout << "[KeyboardBacklight] Detected " << m_capabilities.zones
                 << " zone(s), max brightness: " << m_capabilities.maxBrightness << std::endl;
       return capabilitiesToJSON();
@@ -125,70 +150,192 @@ public:
    */
   bool applyStatesFromJSON( const std::string &statesJSON )
   {
-    if ( m_capabilities.zones == 0 )
-      return false;
+    // explicit states replace whatever effect was running
+    return applyStatesFromJSON( statesJSON, std::nullopt );
+  }
 
-    if ( statesJSON.empty() || statesJSON == "[]" )
+  /**
+   * @brief Apply keyboard backlight states from a profile's keyboard data.
+   * @param keyboardDataJSON  JSON object string: {"brightness":N,"states":[...],"effect":{...}}
+   * @return true on success
+   *
+   * The states set the brightness and the colours shown when the effect
+   * stops; an optional "effect" object then animates RGB backlights.
+   */
+  bool applyProfileKeyboardStates( const std::string &keyboardDataJSON )
+  {
+    if ( m_capabilities.zones == 0 )
       return false;
 
     try
     {
-      std::vector< KeyboardBacklightState > newStates;
-
-      size_t pos = 0;
-      while ( ( pos = statesJSON.find( '{', pos ) ) != std::string::npos )
+      std::optional< KeyboardEffect > effect;
+      if ( m_capabilities.maxRed > 0 and keyboardDataJSON.find( "\"effect\"" ) != std::string::npos )
       {
-        size_t end = statesJSON.find( '}', pos );
-        if ( end == std::string::npos )
-          break;
-
-        std::string stateObj = statesJSON.substr( pos, end - pos + 1 );
-        KeyboardBacklightState kbs;
-
-        kbs.brightness = std::clamp( extractInt( stateObj, "brightness" ), 0, m_capabilities.maxBrightness );
-        kbs.red   = std::clamp( extractInt( stateObj, "red" ),   0, 255 );
-        kbs.green = std::clamp( extractInt( stateObj, "green" ), 0, 255 );
-        kbs.blue  = std::clamp( extractInt( stateObj, "blue" ),  0, 255 );
-
-        newStates.push_back( kbs );
-        pos = end + 1;
+        const auto data = nlohmann::json::parse( keyboardDataJSON, nullptr, false );
+        if ( data.is_object() and data.contains( "effect" ) )
+          effect = KeyboardEffect::fromJson( data[ "effect" ] );
       }
 
-      if ( !newStates.empty() )
+      std::string statesJSON = extractStatesArray( keyboardDataJSON );
+      if ( applyStatesFromJSON( statesJSON, effect ) )
+        return true;
+      if ( effect )
       {
-        applyStates( newStates );
-        m_currentStates = newStates;
+        setEffect( effect );
         return true;
       }
     }
     catch ( const std::exception &e )
     {
-      std::cerr << "[KeyboardBacklight] Error parsing states JSON: " << e.what() << std::endl;
+      ucc::asyncErr( std::string( "[KeyboardBacklight] Failed to apply profile keyboard states: " ) + e.what() );
     }
     return false;
   }
 
   /**
-   * @brief Apply keyboard backlight states from a profile's keyboard data.
-   * @param keyboardDataJSON  JSON object string: {"brightness":N,"states":[...]}
-   * @return true on success
+   * @brief Start @p effect, or stop the running one with nullopt.
+   *
+   * Every call starts a new generation, so frames the worker rendered for
+   * the previous effect are dropped by writeFrame().
    */
-  bool applyProfileKeyboardStates( const std::string &keyboardDataJSON )
+  void setEffect( std::optional< KeyboardEffect > effect )
   {
-    if ( m_capabilities.zones == 0 )
+    std::function< void() > listener;
+    {
+      std::lock_guard lock( m_writeMutex );
+      if ( effect and m_capabilities.maxRed == 0 )
+        return;
+      if ( not effect and not m_effect )
+        return;
+      m_effect = std::move( effect );
+      ++m_effectGeneration;
+      listener = m_effectListener;
+      if ( not m_effect )
+        writeColors( stateColors() );
+    }
+    if ( listener )
+      listener();
+  }
+
+  /// The running effect and, through @p generation, the generation it belongs to
+  [[nodiscard]] std::optional< KeyboardEffect > effect( uint64_t &generation ) const
+  {
+    std::lock_guard lock( m_writeMutex );
+    generation = m_effectGeneration;
+    return m_effect;
+  }
+
+  /// Called after every effect change, from the thread that made it
+  void setEffectListener( std::function< void() > listener )
+  {
+    std::lock_guard lock( m_writeMutex );
+    m_effectListener = std::move( listener );
+  }
+
+  /**
+   * @brief Write every zone again on the next apply, e.g. after a suspend
+   *        in which the keyboard lost its lighting.
+   */
+  void forgetShownState()
+  {
+    std::lock_guard lock( m_writeMutex );
+    std::ranges::fill( m_shownColors, std::nullopt );
+  }
+
+  /**
+   * @brief Show one rendered frame of the effect of @p generation.
+   * @return false if the frame belongs to an effect that has been replaced,
+   *         or a client is streaming frames
+   */
+  bool writeFrame( const std::vector< KeyboardRgb > &frame, uint64_t generation )
+  {
+    std::lock_guard lock( m_writeMutex );
+    if ( generation != m_effectGeneration or not m_effect or streaming() )
       return false;
+    writeColors( frame );
+    return true;
+  }
 
-    try
+  /// How long a streamed frame holds the keyboard against the effect
+  static constexpr std::chrono::milliseconds STREAM_HOLD{ 1000 };
+
+  /**
+   * @brief Show a frame a client rendered, e.g. the GUI's screen ambient mode.
+   *
+   * The running effect pauses while frames keep coming and resumes
+   * STREAM_HOLD after the last one; an empty frame hands the keyboard back
+   * at once, to the effect or to the current states.
+   */
+  bool showStreamFrame( const std::vector< KeyboardRgb > &frame )
+  {
+    std::lock_guard lock( m_writeMutex );
+    if ( m_capabilities.maxRed == 0 )
+      return false;
+    if ( frame.empty() )
     {
-      std::string statesJSON = extractStatesArray( keyboardDataJSON );
-      if ( !statesJSON.empty() )
-        return applyStatesFromJSON( statesJSON );
+      if ( m_streamUntil and not m_effect )
+        writeColors( stateColors() );
+      m_streamUntil.reset();
+      return true;
     }
-    catch ( const std::exception &e )
+    m_streamUntil = std::chrono::steady_clock::now() + STREAM_HOLD;
+    writeColors( frame );
+    return true;
+  }
+
+  /// How long the backlight takes to go dark once the user is idle
+  static constexpr std::chrono::milliseconds IDLE_FADE{ 2000 };
+
+  /**
+   * @brief Fade the backlight dark while the user is away, or light it again.
+   *
+   * The fade starts from the brightness shown, Fn key changes included,
+   * and lighting up returns to it at once.  Brightness applied while dark
+   * is kept for then.  The effect listener wakes KeyboardEffectWorker,
+   * which steps the fade with stepIdleFade().
+   */
+  void setIdle( bool idle )
+  {
+    std::function< void() > listener;
     {
-      std::cerr << "[KeyboardBacklight] Failed to apply profile keyboard states: " << e.what() << std::endl;
+      std::lock_guard lock( m_writeMutex );
+      if ( idle == m_idleRestore.has_value() or m_brightnessFd < 0 )
+        return;
+      if ( idle )
+      {
+        const int shown = readNode( m_brightnessFd ).value_or( 0 );
+        m_idleRestore = shown;
+        m_idleRamp.start( shown, 0, IDLE_FADE, BrightnessRamp::Clock::now() );
+      }
+      else
+      {
+        m_idleRamp.cancel();
+        writeNode( m_brightnessFd, std::to_string( *m_idleRestore ) );
+        m_idleRestore.reset();
+      }
+      listener = m_effectListener;
     }
-    return false;
+    if ( listener )
+      listener();
+  }
+
+  /// Write the idle fade's next step; true while it runs
+  bool stepIdleFade()
+  {
+    std::lock_guard lock( m_writeMutex );
+    if ( not m_idleRamp.active() )
+      return false;
+    if ( const auto raw = m_idleRamp.step( BrightnessRamp::Clock::now() ) )
+      writeNode( m_brightnessFd, std::to_string( *raw ) );
+    return m_idleRamp.active();
+  }
+
+  /// Dark for idle, the fade done: frames would not show
+  [[nodiscard]] bool idleDark() const
+  {
+    std::lock_guard lock( m_writeMutex );
+    return m_idleRestore and not m_idleRamp.active();
   }
 
   /** @brief Current states serialised as a JSON array */
@@ -207,11 +354,82 @@ private:
   std::vector< KeyboardBacklightState > m_currentStates;
   std::vector< std::string > m_ledPaths;
 
+  // open sysfs nodes, -1 where absent; guarded by m_writeMutex like the state below
+  int m_brightnessFd = -1;
+  int m_bufferInputFd = -1;
+  std::vector< int > m_intensityFds;
+  std::vector< std::optional< KeyboardRgb > > m_shownColors;  ///< what each zone shows, nullopt if unknown
+  std::optional< KeyboardEffect > m_effect;
+  uint64_t m_effectGeneration = 0;
+  std::optional< std::chrono::steady_clock::time_point > m_streamUntil;
+  std::function< void() > m_effectListener;
+  std::optional< int > m_idleRestore;  ///< brightness to light up to, set while idle
+  BrightnessRamp m_idleRamp;
+  mutable std::mutex m_writeMutex;
+
   // Common LED paths
   static constexpr const char *LEDS_WHITE_ONLY = "/sys/devices/platform/tuxedo_keyboard/leds/white:kbd_backlight";
   static constexpr const char *LEDS_WHITE_ONLY_NB05 = "/sys/bus/platform/devices/tuxedo_nb05_kbd_backlight/leds/white:kbd_backlight";
   static constexpr const char *LEDS_RGB_BASE = "/sys/devices/platform/tuxedo_keyboard/leds/rgb:kbd_backlight";
 
+  /// Apply @p statesJSON and make @p effect the running effect
+  bool applyStatesFromJSON( const std::string &statesJSON, std::optional< KeyboardEffect > effect )
+  {
+    if ( m_capabilities.zones == 0 )
+      return false;
+
+    if ( statesJSON.empty() || statesJSON == "[]" )
+      return false;
+
+    try
+    {
+      std::vector< KeyboardBacklightState > newStates;
+
+      size_t pos = 0;
+      while ( ( pos = statesJSON.find( '{', pos ) ) != std::string::npos )
+      {
+        size_t end = statesJSON.find( '}', pos );
+        if ( end == std::string::npos )
+          break;
+
+        std::string stateObj = statesJSON.substr( pos, end - pos + 1 );
+        KeyboardBacklightState kbs;
+
+        kbs.brightness = std::clamp( extractInt( stateObj, "brightness" ), 0, m_capabilities.maxBrightness );
+        kbs.red   = std::clamp( extractInt( stateObj, "red" ),   0, 255 );
+        kbs.green = std::clamp( extractInt( stateObj, "green" ), 0, 255 );
+        kbs.blue  = std::clamp( extractInt( stateObj, "blue" ),  0, 255 );
+
+        newStates.push_back( kbs );
+        pos = end + 1;
+      }
+
+      if ( !newStates.empty() )
+      {
+        std::function< void() > listener;
+        {
+          std::lock_guard lock( m_writeMutex );
+          if ( effect or m_effect )
+          {
+            m_effect = std::move( effect );
+            ++m_effectGeneration;
+            listener = m_effectListener;
+          }
+          m_currentStates = newStates;
+          applyStates( newStates );
+        }
+        if ( listener )
+          listener();
+        return true;
+      }
+    }
+    catch ( const std::exception &e )
+    {
+      std::cerr << "[KeyboardBacklight] Error parsing states JSON: " << e.what() << std::endl;
+    }
+    return false;
+  }
+
   // ---- hardware detection ----
 
   void detectKeyboardBacklight()
@@ -374,6 +592,7 @@ private:
       oss << ",\"maxRed\":" << m_capabilities.maxRed;
       oss << ",\"maxGreen\":" << m_capabilities.maxGreen;
       oss << ",\"maxBlue\":" << m_capabilities.maxBlue;
+      oss << ",\"effects\":[\"breathing\",\"wave\",\"reactive\",\"gradient\"]";
     }
 
     oss << "}";
@@ -454,73 +673,123 @@ private:
 
   // ---- hardware sysfs writes ----
 
-  void applyStates( const std::vector< KeyboardBacklightState > &states )
+  void openNodes()
   {
-    if ( states.empty() || m_ledPaths.empty() )
+    closeNodes();
+    if ( m_ledPaths.empty() )
       return;
 
-    setBrightness( states[0].brightness );
-
+    const auto openNode = []( const std::string &path ) { return ::open( path.c_str(), O_WRONLY | O_CLOEXEC ); };
+    // read back as well: the Fn keys change the brightness behind our back
+    m_brightnessFd = ::open( ( m_ledPaths[0] + "/brightness" ).c_str(), O_RDWR | O_CLOEXEC );
     if ( m_capabilities.maxRed > 0 )
     {
-      setBufferInput( true );
-
-      for ( size_t i = 0; i < m_ledPaths.size() && i < states.size(); ++i )
-        setMultiIntensity( i, states[i].red, states[i].green, states[i].blue );
-
-      setBufferInput( false );
+      m_bufferInputFd = openNode( m_ledPaths[0] + "/device/controls/buffer_input" );
+      for ( const auto &path : m_ledPaths )
+        m_intensityFds.push_back( openNode( path + "/multi_intensity" ) );
     }
   }
 
-  void setBrightness( int brightness )
+  void closeNodes()
   {
-    if ( m_ledPaths.empty() )
-      return;
+    for ( int *fd : { &m_brightnessFd, &m_bufferInputFd } )
+      if ( *fd >= 0 )
+      {
+        ::close( *fd );
+        *fd = -1;
+      }
+    for ( const int fd : m_intensityFds )
+      if ( fd >= 0 )
+        ::close( fd );
+    m_intensityFds.clear();
+    m_shownColors.clear();
+  }
 
-    SysfsNode< int > brightnessNode( m_ledPaths[0] + "/brightness" );
-    if ( !brightnessNode.write( brightness ) )
-      std::cerr << "[KeyboardBacklight] Failed to set brightness to " << brightness << std::endl;
+  static bool writeNode( int fd, const std::string &value )
+  {
+    return fd >= 0 and ::pwrite( fd, value.data(), value.size(), 0 ) == static_cast< ssize_t >( value.size() );
   }
 
-  void setMultiIntensity( size_t zoneIndex, int red, int green, int blue )
+  static std::optional< int > readNode( int fd )
   {
-    if ( zoneIndex >= m_ledPaths.size() )
-      return;
+    char buffer[ 16 ];
+    const ssize_t n = fd >= 0 ? ::pread( fd, buffer, sizeof( buffer ) - 1, 0 ) : -1;
+    if ( n <= 0 )
+      return std::nullopt;
+    buffer[ n ] = '\0';
+    char *end = nullptr;
+    const long value = std::strtol( buffer, &end, 10 );
+    return end != buffer ? std::optional( static_cast< int >( value ) ) : std::nullopt;
+  }
 
-    std::string multiIntensityPath = m_ledPaths[zoneIndex] + "/multi_intensity";
-    std::error_code ec;
+  bool streaming() const
+  {
+    return m_streamUntil and std::chrono::steady_clock::now() < *m_streamUntil;
+  }
+
+  std::vector< KeyboardRgb > stateColors() const
+  {
+    std::vector< KeyboardRgb > colors;
+    for ( const auto &state : m_currentStates )
+      colors.push_back( { static_cast< uint8_t >( state.red ), static_cast< uint8_t >( state.green ),
+                          static_cast< uint8_t >( state.blue ) } );
+    return colors;
+  }
 
-    if ( !fs::exists( multiIntensityPath, ec ) )
+  void applyStates( const std::vector< KeyboardBacklightState > &states )
+  {
+    if ( states.empty() || m_ledPaths.empty() )
       return;
 
-    std::string value = std::to_string( red ) + " " +
-                       std::to_string( green ) + " " +
-                       std::to_string( blue );
+    setBrightness( states[0].brightness );
 
-    std::ofstream file( multiIntensityPath, std::ios::app );
-    if ( file.is_open() )
+    if ( m_capabilities.maxRed > 0 )
     {
-      file << value;
-      file.close();
+      std::vector< KeyboardRgb > colors;
+      for ( const auto &state : states )
+        colors.push_back( { static_cast< uint8_t >( state.red ), static_cast< uint8_t >( state.green ),
+                            static_cast< uint8_t >( state.blue ) } );
+      // a running effect owns the colours; the states show once it stops
+      if ( not m_effect )
+        writeColors( colors );
     }
   }
 
-  void setBufferInput( bool bufferOn )
+  void setBrightness( int brightness )
   {
-    if ( m_ledPaths.empty() )
+    // dark for idle: shown once the user is back
+    if ( m_idleRestore )
+    {
+      m_idleRestore = brightness;
       return;
-
-    std::string bufferPath = m_ledPaths[0] + "/device/controls/buffer_input";
-    std::error_code ec;
-
-    if ( !fs::exists( bufferPath, ec ) )
+    }
+    if ( readNode( m_brightnessFd ) == brightness )
       return;
+    if ( !writeNode( m_brightnessFd, std::to_string( brightness ) ) )
+      ucc::asyncErr( "[KeyboardBacklight] Failed to set brightness to " + std::to_string( brightness ) );
+  }
 
-    std::ofstream file( bufferPath, std::ios::app );
-    if ( file.is_open() )
+  /// Write the zones of @p colors that changed, inside one buffer_input bracket
+  void writeColors( const std::vector< KeyboardRgb > &colors )
+  {
+    const size_t zones = std::min( colors.size(), m_intensityFds.size() );
+    m_shownColors.resize( m_intensityFds.size() );
+
+    bool buffering = false;
+    for ( size_t i = 0; i < zones; ++i )
     {
-      file << ( bufferOn ? "1" : "0" );
-      file.close();
+      if ( m_intensityFds[i] < 0 or m_shownColors[i] == colors[i] )
+        continue;
+      if ( not buffering )
+      {
+        writeNode( m_bufferInputFd, "1" );
+        buffering = true;
+      }
+      const std::string value = std::to_string( colors[i].red ) + " " + std::to_string( colors[i].green ) + " "
+                                + std::to_string( colors[i].blue );
+      m_shownColors[i] = writeNode( m_intensityFds[i], value ) ? std::optional( colors[i] ) : std::nullopt;
     }
+    if ( buffering )
+      writeNode( m_bufferInputFd, "0" );
   }
 };
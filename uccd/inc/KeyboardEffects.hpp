@@ -0,0 +1,219 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Colour of one keyboard zone (or key), 8 bits per channel.
+ */
+struct KeyboardRgb
+{
+  uint8_t red = 0;
+  uint8_t green = 0;
+  uint8_t blue = 0;
+
+  bool operator==( const KeyboardRgb & ) const = default;
+};
+
+enum class KeyboardEffectType : uint8_t
+{
+  Breathing,  ///< colors[0] fading in and out
+  Wave,       ///< the colors running across the zones
+  Reactive,   ///< colors[0] flashing on key presses, fading back to colors[1]
+  Gradient,   ///< colors spread across the zones, standing still
+};
+
+/**
+ * @brief An animated backlight effect, as set in a keyboard profile:
+ *
+ *   "effect": { "type": "wave", "speed": 0.5, "fps": 30,
+ *               "colors": [ { "red": 255, "green": 0, "blue": 0 }, ... ] }
+ *
+ * speed is in cycles per second.  A wave or gradient without colours runs
+ * through the hues; the others default to white.
+ */
+struct KeyboardEffect
+{
+  static constexpr int MIN_FPS = 5;
+  static constexpr int MAX_FPS = 60;
+  static constexpr double MAX_SPEED = 10.0;
+
+  KeyboardEffectType type = KeyboardEffectType::Breathing;
+  std::vector< KeyboardRgb > colors;
+  double speed = 0.5;
+  int fps = 30;
+
+  bool operator==( const KeyboardEffect & ) const = default;
+
+  [[nodiscard]] static const char *typeName( KeyboardEffectType type ) noexcept
+  {
+    switch ( type )
+    {
+      case KeyboardEffectType::Breathing: return "breathing";
+      case KeyboardEffectType::Wave: return "wave";
+      case KeyboardEffectType::Reactive: return "reactive";
+      case KeyboardEffectType::Gradient: return "gradient";
+    }
+    return "breathing";
+  }
+
+  /// The effect described by @p json, nullopt if it is not an object of a known type
+  [[nodiscard]] static std::optional< KeyboardEffect > fromJson( const nlohmann::json &json )
+  {
+    if ( not json.is_object() )
+      return std::nullopt;
+    const auto type = json.find( "type" );
+    if ( type == json.end() or not type->is_string() )
+      return std::nullopt;
+
+    KeyboardEffect effect;
+    const std::string name = type->get< std::string >();
+    if ( name == "breathing" )
+      effect.type = KeyboardEffectType::Breathing;
+    else if ( name == "wave" )
+      effect.type = KeyboardEffectType::Wave;
+    else if ( name == "reactive" )
+      effect.type = KeyboardEffectType::Reactive;
+    else if ( name == "gradient" )
+      effect.type = KeyboardEffectType::Gradient;
+    else
+      return std::nullopt;
+
+    if ( const auto speed = json.find( "speed" ); speed != json.end() and speed->is_number() )
+      effect.speed = std::clamp( speed->get< double >(), 0.0, MAX_SPEED );
+    if ( const auto fps = json.find( "fps" ); fps != json.end() and fps->is_number() )
+      effect.fps = std::clamp( static_cast< int >( fps->get< double >() ), MIN_FPS, MAX_FPS );
+    if ( const auto colors = json.find( "colors" ); colors != json.end() and colors->is_array() )
+      for ( const auto &color : *colors )
+        if ( color.is_object() )
+          effect.colors.push_back( { channel( color, "red" ), channel( color, "green" ), channel( color, "blue" ) } );
+    return effect;
+  }
+
+private:
+  static uint8_t channel( const nlohmann::json &color, const char *key )
+  {
+    const auto it = color.find( key );
+    return it != color.end() and it->is_number()
+             ? static_cast< uint8_t >( std::clamp( static_cast< int >( it->get< double >() ), 0, 255 ) )
+             : 0;
+  }
+};
+
+/**
+ * @brief Renders the frames of a KeyboardEffect; pure, so it is cheap to test.
+ */
+class KeyboardEffectRenderer
+{
+public:
+  /// Seconds a reactive flash takes to fade to about a third
+  static constexpr double REACTIVE_DECAY_S = 0.4;
+
+  /**
+   * @brief Colours of @p frame's zones @p t seconds into @p effect
+   * @param sinceKeyPress  Seconds since the last key press, for Reactive
+   */
+  static void render( const KeyboardEffect &effect, double t, double sinceKeyPress,
+                      std::vector< KeyboardRgb > &frame ) noexcept
+  {
+    const size_t zones = frame.size();
+    const KeyboardRgb first = effect.colors.empty() ? KeyboardRgb{ 255, 255, 255 } : effect.colors[ 0 ];
+
+    switch ( effect.type )
+    {
+      case KeyboardEffectType::Breathing:
+      {
+        const double level = 0.5 - 0.5 * std::cos( 2.0 * M_PI * effect.speed * t );
+        std::ranges::fill( frame, scale( first, level ) );
+        break;
+      }
+      case KeyboardEffectType::Reactive:
+      {
+        const KeyboardRgb rest = effect.colors.size() > 1 ? effect.colors[ 1 ] : KeyboardRgb{};
+        const double level = sinceKeyPress < 0.0 ? 0.0 : std::exp( -sinceKeyPress / REACTIVE_DECAY_S );
+        std::ranges::fill( frame, mix( rest, first, level ) );
+        break;
+      }
+      case KeyboardEffectType::Wave:
+        for ( size_t zone = 0; zone < zones; ++zone )
+          frame[ zone ] = along( effect.colors, static_cast< double >( zone ) / static_cast< double >( zones )
+                                                  - effect.speed * t, true );
+        break;
+      case KeyboardEffectType::Gradient:
+        for ( size_t zone = 0; zone < zones; ++zone )
+          frame[ zone ] = along( effect.colors,
+                                 zones > 1 ? static_cast< double >( zone ) / static_cast< double >( zones - 1 ) : 0.0,
+                                 false );
+        break;
+    }
+  }
+
+  /// Colour at @p position of a hue circle, 0 and 1 being red
+  [[nodiscard]] static KeyboardRgb hue( double position ) noexcept
+  {
+    const double h = ( position - std::floor( position ) ) * 6.0;
+    const double x = 1.0 - std::abs( std::fmod( h, 2.0 ) - 1.0 );
+    const auto c = []( double v ) { return static_cast< uint8_t >( std::lround( v * 255.0 ) ); };
+    switch ( static_cast< int >( h ) % 6 )
+    {
+      case 0: return { 255, c( x ), 0 };
+      case 1: return { c( x ), 255, 0 };
+      case 2: return { 0, 255, c( x ) };
+      case 3: return { 0, c( x ), 255 };
+      case 4: return { c( x ), 0, 255 };
+      default: return { 255, 0, c( x ) };
+    }
+  }
+
+  [[nodiscard]] static KeyboardRgb mix( KeyboardRgb a, KeyboardRgb b, double f ) noexcept
+  {
+    const auto lerp = [f]( uint8_t from, uint8_t to ) {
+      return static_cast< uint8_t >( std::lround( from + ( to - from ) * std::clamp( f, 0.0, 1.0 ) ) );
+    };
+    return { lerp( a.red, b.red ), lerp( a.green, b.green ), lerp( a.blue, b.blue ) };
+  }
+
+private:
+  static KeyboardRgb scale( KeyboardRgb color, double f ) noexcept
+  {
+    return mix( KeyboardRgb{}, color, f );
+  }
+
+  /// Colour at @p position along @p colors; wrapping joins the last back to the first
+  static KeyboardRgb along( const std::vector< KeyboardRgb > &colors, double position, bool wrap ) noexcept
+  {
+    if ( colors.size() < 2 )
+      return colors.empty() ? hue( position ) : colors[ 0 ];
+
+    if ( wrap )
+      position -= std::floor( position );
+    else
+      position = std::clamp( position, 0.0, 1.0 );
+
+    const size_t segments = wrap ? colors.size() : colors.size() - 1;
+    const double scaled = position * static_cast< double >( segments );
+    const size_t index = std::min( static_cast< size_t >( scaled ), segments - 1 );
+    return mix( colors[ index ], colors[ ( index + 1 ) % colors.size() ], scaled - static_cast< double >( index ) );
+  }
+};
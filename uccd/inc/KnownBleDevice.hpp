@@ -0,0 +1,95 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>
+
+#include "PersistQueue.hpp"
+
+/**
+ * @brief The BLE device the water cooler was last connected to, kept across
+ *        daemon restarts.
+ *
+ * With the address known the worker connects directly instead of running
+ * a discovery scan first; BlueZ keeps the device's GATT table under the
+ * same address, so the service discovery after connect is served from
+ * its cache.
+ *
+ * File format: "ucc-water-cooler 1", then "<address>\t<name>".
+ */
+struct KnownBleDevice
+{
+  static constexpr const char *DEFAULT_PATH = "/var/lib/ucc/water-cooler";
+
+  std::string address; ///< "AA:BB:CC:DD:EE:FF"
+  std::string name;    ///< Advertised name; selects the device model
+
+  bool operator==( const KnownBleDevice & ) const = default;
+
+  /// The device saved at @p path, nullopt if there is none or the file is not ours
+  [[nodiscard]] static std::optional< KnownBleDevice > load( const std::string &path = DEFAULT_PATH )
+  {
+    std::ifstream in( path );
+    std::string magic, line;
+    if ( !std::getline( in, magic ) || magic != MAGIC || !std::getline( in, line ) )
+      return std::nullopt;
+
+    const auto tab = line.find( '\t' );
+    KnownBleDevice device{ line.substr( 0, tab ), tab == std::string::npos ? std::string() : line.substr( tab + 1 ) };
+    if ( !validAddress( device.address ) )
+      return std::nullopt;
+    return device;
+  }
+
+  /// Best effort: a device that cannot be saved only costs the next start a scan
+  bool save( const std::string &path = DEFAULT_PATH ) const
+  {
+    if ( !validAddress( address ) || name.find( '\n' ) != std::string::npos )
+      return false;
+    std::error_code ec;
+    std::filesystem::create_directories( std::filesystem::path( path ).parent_path(), ec );
+    return writeFileDurably( path, std::string( MAGIC ) + '\n' + address + '\t' + name + '\n', 0644 );
+  }
+
+  /// Forget the device saved at @p path
+  static void forget( const std::string &path = DEFAULT_PATH )
+  {
+    std::error_code ec;
+    std::filesystem::remove( path, ec );
+  }
+
+  /// Six colon-separated hex octets
+  [[nodiscard]] static bool validAddress( const std::string &address ) noexcept
+  {
+    if ( address.size() != 17 )
+      return false;
+    for ( size_t i = 0; i < address.size(); ++i )
+    {
+      const char c = address[ i ];
+      const bool hex = ( c >= '0' && c <= '9' ) || ( c >= 'a' && c <= 'f' ) || ( c >= 'A' && c <= 'F' );
+      if ( i % 3 == 2 ? c != ':' : !hex )
+        return false;
+    }
+    return true;
+  }
+
+private:
+  static constexpr const char *MAGIC = "ucc-water-cooler 1";
+};
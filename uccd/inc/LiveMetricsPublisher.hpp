@@ -0,0 +1,197 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include "LiveMetricsSegment.hpp"
+
+/**
+ * @brief Daemon-side writer of the shared live metrics segment.
+ *
+ * Creates a sealed memfd laid out as described in LiveMetricsSegment.hpp and
+ * keeps it mapped writable.  Clients receive readOnlyFd(), a second open
+ * file description of the same memfd with O_RDONLY, so they can only map it
+ * PROT_READ; F_SEAL_FUTURE_WRITE additionally blocks new writable mappings
+ * where the kernel supports it.
+ *
+ * publish() is a handful of plain stores inside a seqlock; a Frame writes
+ * the samples of one tick inside a single one.  Producers on different
+ * threads are serialised by a spin flag that is uncontended in practice.
+ */
+class LiveMetricsPublisher
+{
+public:
+  static constexpr uint32_t DEFAULT_RING_CAPACITY = 1024;  ///< ~17 min at 1 Hz
+
+  explicit LiveMetricsPublisher( size_t metricCount, uint32_t ringCapacity = DEFAULT_RING_CAPACITY )
+    : m_metricCount( metricCount ),
+      m_ringCapacity( ringCapacity ),
+      m_size( ucc::live_metrics::segmentSize( metricCount, ringCapacity ) )
+  {
+    const int fd = memfd_create( "ucc-live-metrics", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+    if ( fd < 0 )
+    {
+      syslog( LOG_WARNING, "LiveMetricsPublisher: memfd_create failed: %s", strerror( errno ) );
+      return;
+    }
+
+    if ( ftruncate( fd, static_cast< off_t >( m_size ) ) != 0 )
+    {
+      syslog( LOG_WARNING, "LiveMetricsPublisher: ftruncate failed: %s", strerror( errno ) );
+      ::close( fd );
+      return;
+    }
+
+    void *addr = mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if ( addr == MAP_FAILED )
+    {
+      syslog( LOG_WARNING, "LiveMetricsPublisher: mmap failed: %s", strerror( errno ) );
+      ::close( fd );
+      return;
+    }
+    m_base = static_cast< std::byte * >( addr );
+
+    ucc::LiveMetricsHeader hdr{};
+    hdr.magic = ucc::LIVE_METRICS_MAGIC;
+    hdr.version = ucc::LIVE_METRICS_VERSION;
+    hdr.metricCount = static_cast< uint16_t >( metricCount );
+    hdr.ringCapacity = ringCapacity;
+    std::memcpy( m_base, &hdr, sizeof( hdr ) );
+
+    // Hand out a read-only description of the same file
+    const std::string self = "/proc/self/fd/" + std::to_string( fd );
+    m_readOnlyFd = ::open( self.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( m_readOnlyFd < 0 )
+      syslog( LOG_WARNING, "LiveMetricsPublisher: cannot reopen memfd read-only: %s", strerror( errno ) );
+
+    int seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+#ifdef F_SEAL_FUTURE_WRITE
+    seals |= F_SEAL_FUTURE_WRITE;
+#endif
+    if ( fcntl( fd, F_ADD_SEALS, seals ) != 0 )
+      syslog( LOG_WARNING, "LiveMetricsPublisher: sealing failed: %s", strerror( errno ) );
+
+    ::close( fd );
+  }
+
+  ~LiveMetricsPublisher()
+  {
+    if ( m_readOnlyFd >= 0 )
+      ::close( m_readOnlyFd );
+    if ( m_base != nullptr )
+      munmap( m_base, m_size );
+  }
+
+  LiveMetricsPublisher( const LiveMetricsPublisher & ) = delete;
+  LiveMetricsPublisher &operator=( const LiveMetricsPublisher & ) = delete;
+
+  /**
+   * @brief fd for clients (duplicated by QDBusUnixFileDescriptor), or -1.
+   */
+  [[nodiscard]] int readOnlyFd() const noexcept { return m_readOnlyFd; }
+
+  [[nodiscard]] bool isValid() const noexcept { return m_base != nullptr && m_readOnlyFd >= 0; }
+
+  /**
+   * @brief Samples written inside one seqlock section.
+   *
+   * Takes the writer flag and opens the section on construction, closes it
+   * on destruction, so a reader sees either none or all of the samples
+   * added in between.  Does nothing if the segment could not be created.
+   */
+  class Frame
+  {
+  public:
+    explicit Frame( LiveMetricsPublisher &pub ) noexcept
+      : m_pub( pub.m_base != nullptr ? &pub : nullptr )
+    {
+      if ( m_pub == nullptr )
+        return;
+
+      while ( m_pub->m_writer.test_and_set( std::memory_order_acquire ) )
+        ;  // spin – producers only overlap when two workers push at once
+
+      const uint64_t s = m_pub->sequence().load( std::memory_order_relaxed );
+      m_pub->sequence().store( s + 1, std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_release );
+    }
+
+    ~Frame()
+    {
+      if ( m_pub == nullptr )
+        return;
+      m_pub->sequence().store( m_pub->sequence().load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+      m_pub->m_writer.clear( std::memory_order_release );
+    }
+
+    Frame( const Frame & ) = delete;
+    Frame &operator=( const Frame & ) = delete;
+
+    void add( size_t metric, int64_t timestampMs, double value ) noexcept
+    {
+      namespace lm = ucc::live_metrics;
+
+      if ( m_pub == nullptr || metric >= m_pub->m_metricCount )
+        return;
+
+      std::byte *base = m_pub->m_base;
+      const size_t ch = lm::channelOffset( metric );
+      const uint64_t written = lm::load< uint64_t >( base, ch + offsetof( ucc::LiveMetricsChannel, written ) );
+      const size_t pt = lm::pointOffset( m_pub->m_metricCount, m_pub->m_ringCapacity, metric,
+                                         static_cast< size_t >( written % m_pub->m_ringCapacity ) );
+      lm::store< int64_t >( base, pt, timestampMs );
+      lm::store< double >( base, pt + sizeof( int64_t ), value );
+      lm::store< int64_t >( base, ch + offsetof( ucc::LiveMetricsChannel, lastTimestampMs ), timestampMs );
+      lm::store< double >( base, ch + offsetof( ucc::LiveMetricsChannel, lastValue ), value );
+      lm::store< uint64_t >( base, ch + offsetof( ucc::LiveMetricsChannel, written ), written + 1 );
+    }
+
+  private:
+    LiveMetricsPublisher *m_pub;
+  };
+
+  /**
+   * @brief Record a new sample for @p metric.  Lock-free for readers.
+   */
+  void publish( size_t metric, int64_t timestampMs, double value ) noexcept
+  {
+    Frame( *this ).add( metric, timestampMs, value );
+  }
+
+private:
+  [[nodiscard]] std::atomic_ref< uint64_t > sequence() const noexcept
+  {
+    return std::atomic_ref< uint64_t >( *static_cast< uint64_t * >(
+      static_cast< void * >( m_base + offsetof( ucc::LiveMetricsHeader, sequence ) ) ) );
+  }
+
+  const size_t m_metricCount;
+  const uint32_t m_ringCapacity;
+  const size_t m_size;
+  std::byte *m_base = nullptr;
+  int m_readOnlyFd = -1;
+  std::atomic_flag m_writer = ATOMIC_FLAG_INIT;
+};
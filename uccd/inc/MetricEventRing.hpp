@@ -0,0 +1,85 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "MetricEvents.hpp"
+
+/**
+ * @brief Fixed-capacity ring of timestamped event annotations.
+ *
+ * Events are rare (profile switches, power-state flips, throttle changes)
+ * and come from several threads, so writers and readers share one spin
+ * flag; a reader holds it only while copying at most CAPACITY records.
+ * The metric rings never wait on it.
+ */
+class MetricEventRing
+{
+public:
+  static constexpr size_t CAPACITY = 256;
+
+  void push( int64_t timestampMs, ucc::MetricEventKind kind, int32_t value, std::string_view label ) noexcept
+  {
+    ucc::MetricEventRecord ev{};
+    ev.timestampMs = timestampMs;
+    ev.kind = static_cast< uint16_t >( kind );
+    ev.value = value;
+    std::memcpy( ev.label, label.data(), std::min( label.size(), sizeof( ev.label ) - 1 ) );
+
+    lock();
+    m_events[ m_written % CAPACITY ] = ev;
+    ++m_written;
+    unlock();
+  }
+
+  /**
+   * @brief Append events with timestamps >= @p sinceMs, oldest first.
+   */
+  void copySince( int64_t sinceMs, std::vector< ucc::MetricEventRecord > &out ) const
+  {
+    out.reserve( out.size() + CAPACITY );  // no allocation while holding the flag
+    lock();
+    const uint64_t first = m_written > CAPACITY ? m_written - CAPACITY : 0;
+    for ( uint64_t seq = first; seq < m_written; ++seq )
+    {
+      const auto &ev = m_events[ seq % CAPACITY ];
+      if ( ev.timestampMs >= sinceMs )
+        out.push_back( ev );
+    }
+    unlock();
+  }
+
+private:
+  void lock() const noexcept
+  {
+    while ( m_flag.test_and_set( std::memory_order_acquire ) )
+      ;
+  }
+
+  void unlock() const noexcept { m_flag.clear( std::memory_order_release ); }
+
+  std::array< ucc::MetricEventRecord, CAPACITY > m_events{};
+  uint64_t m_written = 0;
+  mutable std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+};
@@ -0,0 +1,348 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JsonWriter.hpp"
+#include "MetricsStatistics.hpp"
+
+/**
+ * @brief Identifiers for each tracked metric.
+ *
+ * The underlying value is used as an index into the per-metric ring buffers.
+ */
+enum class MetricId : uint8_t
+{
+  CpuTemp,
+  CpuFanDuty,
+  CpuPower,
+  CpuFrequency,
+  GpuTemp,
+  GpuFanDuty,
+  GpuPower,
+  GpuFrequency,
+  GpuVramFrequency,
+  GpuCoreVoltage,
+  Gpu2Temp,          ///< Second NVIDIA GPU (NVML index 1), e.g. eGPU or dual dGPU
+  Gpu2Power,
+  Gpu2Frequency,
+  GpuComputeUtil,
+  GpuMemoryUtil,
+  CpuPowerCore,      ///< RAPL domains; CpuPower is the package domain
+  CpuPowerUncore,
+  CpuPowerDram,
+  CpuPowerPsys,
+  CpuFrequencyMax,   ///< Fastest core; CpuFrequency is the average over all cores
+  CpuFrequencyPCore, ///< Average over performance / efficiency cores (hybrid CPUs)
+  CpuFrequencyECore,
+  CpuThrottleCore,   ///< Thermal throttling of the worst core, % of the interval
+  CpuThrottlePackage,
+  CpuPowerLimited,   ///< 100 while package power is at PL1/PL2
+  CpuPkgCstate,      ///< Package C-state residency, %
+  WaterCoolerFanDuty,   ///< LCT water cooler, pushed on each BLE write
+  WaterCoolerPumpLevel, ///< Pump drive, % of the 12 V top level
+  WaterCoolerRssi,      ///< BLE link RSSI, dBm
+  WaterCoolerLatency,   ///< Time a BLE command waited in the queue, ms
+  BatteryPower,         ///< Charge or discharge rate, W
+  BatteryVoltage,
+  BatteryEnergy,        ///< Energy left, Wh
+  BatteryCapacity,      ///< Charge level, %
+  BatteryTimeToEmpty,   ///< Minutes left at the current rate, only while discharging
+  SystemPowerOnBattery, ///< Whole-system draw, i.e. the discharge rate; not recorded on AC
+  Count  ///< Sentinel — must be last
+};
+
+/**
+ * @brief Human-readable name for a metric (matches JSON key).
+ */
+constexpr const char *metricName( MetricId id ) noexcept
+{
+  switch ( id )
+  {
+    case MetricId::CpuTemp:             return "cpuTemp";
+    case MetricId::CpuFanDuty:          return "cpuFanDuty";
+    case MetricId::CpuPower:            return "cpuPower";
+    case MetricId::CpuFrequency:        return "cpuFrequency";
+    case MetricId::GpuTemp:             return "gpuTemp";
+    case MetricId::GpuFanDuty:          return "gpuFanDuty";
+    case MetricId::GpuPower:            return "gpuPower";
+    case MetricId::GpuFrequency:        return "gpuFrequency";
+    case MetricId::GpuVramFrequency:    return "gpuVramFrequency";
+    case MetricId::GpuCoreVoltage:      return "gpuCoreVoltage";
+    case MetricId::Gpu2Temp:            return "gpu2Temp";
+    case MetricId::Gpu2Power:           return "gpu2Power";
+    case MetricId::Gpu2Frequency:       return "gpu2Frequency";
+    case MetricId::GpuComputeUtil:      return "gpuComputeUtil";
+    case MetricId::GpuMemoryUtil:       return "gpuMemoryUtil";
+    case MetricId::CpuPowerCore:        return "cpuPowerCore";
+    case MetricId::CpuPowerUncore:      return "cpuPowerUncore";
+    case MetricId::CpuPowerDram:        return "cpuPowerDram";
+    case MetricId::CpuPowerPsys:        return "cpuPowerPsys";
+    case MetricId::CpuFrequencyMax:     return "cpuFrequencyMax";
+    case MetricId::CpuFrequencyPCore:   return "cpuFrequencyPCore";
+    case MetricId::CpuFrequencyECore:   return "cpuFrequencyECore";
+    case MetricId::CpuThrottleCore:     return "cpuThrottleCore";
+    case MetricId::CpuThrottlePackage:  return "cpuThrottlePackage";
+    case MetricId::CpuPowerLimited:     return "cpuPowerLimited";
+    case MetricId::CpuPkgCstate:        return "cpuPkgCstate";
+    case MetricId::WaterCoolerFanDuty:  return "wcFanDuty";
+    case MetricId::WaterCoolerPumpLevel: return "wcPumpLevel";
+    case MetricId::WaterCoolerRssi:     return "wcRssi";
+    case MetricId::WaterCoolerLatency:  return "wcLatency";
+    case MetricId::BatteryPower:        return "batPower";
+    case MetricId::BatteryVoltage:      return "batVoltage";
+    case MetricId::BatteryEnergy:       return "batEnergy";
+    case MetricId::BatteryCapacity:     return "batCapacity";
+    case MetricId::BatteryTimeToEmpty:  return "batTimeToEmpty";
+    case MetricId::SystemPowerOnBattery: return "systemPowerOnBattery";
+    default:                            return "unknown";
+  }
+}
+
+/**
+ * @brief Histogram bins for the streaming statistics of a metric.
+ *
+ * StreamingStats::BIN_COUNT (128) bins each; ranges cover what the
+ * hardware reports in practice at a resolution finer than the sensors.
+ */
+constexpr StatsBinSpec statsBinSpec( MetricId id ) noexcept
+{
+  switch ( id )
+  {
+    case MetricId::CpuTemp:
+    case MetricId::GpuTemp:
+    case MetricId::Gpu2Temp:            return { 0.0, 1.0 };    // 0–128 °C
+    case MetricId::CpuFanDuty:
+    case MetricId::GpuFanDuty:
+    case MetricId::GpuComputeUtil:
+    case MetricId::GpuMemoryUtil:
+    case MetricId::CpuThrottleCore:
+    case MetricId::CpuThrottlePackage:
+    case MetricId::CpuPowerLimited:
+    case MetricId::CpuPkgCstate:
+    case MetricId::WaterCoolerFanDuty:
+    case MetricId::WaterCoolerPumpLevel:
+    case MetricId::BatteryCapacity:     return { 0.0, 1.0 };    // 0–128 %
+    case MetricId::WaterCoolerRssi:     return { -128.0, 1.0 }; // -128–0 dBm
+    case MetricId::WaterCoolerLatency:  return { 0.0, 4.0 };    // 0–512 ms
+    case MetricId::BatteryPower:
+    case MetricId::SystemPowerOnBattery:
+    case MetricId::BatteryEnergy:       return { 0.0, 1.0 };    // 0–128 W / Wh
+    case MetricId::BatteryVoltage:      return { 0.0, 0.2 };    // 0–25.6 V
+    case MetricId::BatteryTimeToEmpty:  return { 0.0, 10.0 };   // 0–21 h
+    case MetricId::CpuPower:
+    case MetricId::CpuPowerCore:
+    case MetricId::CpuPowerUncore:
+    case MetricId::CpuPowerDram:
+    case MetricId::CpuPowerPsys:
+    case MetricId::GpuPower:
+    case MetricId::Gpu2Power:           return { 0.0, 2.5 };    // 0–320 W
+    case MetricId::CpuFrequency:
+    case MetricId::CpuFrequencyMax:
+    case MetricId::CpuFrequencyPCore:
+    case MetricId::CpuFrequencyECore:   return { 0.0, 50.0 };   // 0–6.4 GHz
+    case MetricId::GpuFrequency:
+    case MetricId::Gpu2Frequency:       return { 0.0, 25.0 };   // 0–3.2 GHz
+    case MetricId::GpuVramFrequency:    return { 0.0, 100.0 };  // 0–12.8 GHz
+    case MetricId::GpuCoreVoltage:      return { 0.0, 10.0 };   // 0–1.28 V
+    default:                            return { 0.0, 1.0 };
+  }
+}
+
+/**
+ * @brief Unit of a metric's values as the store keeps them.
+ */
+constexpr const char *metricUnit( MetricId id ) noexcept
+{
+  switch ( id )
+  {
+    case MetricId::CpuTemp:
+    case MetricId::GpuTemp:
+    case MetricId::Gpu2Temp:            return "°C";
+    case MetricId::CpuPower:
+    case MetricId::GpuPower:
+    case MetricId::Gpu2Power:
+    case MetricId::CpuPowerCore:
+    case MetricId::CpuPowerUncore:
+    case MetricId::CpuPowerDram:
+    case MetricId::CpuPowerPsys:
+    case MetricId::BatteryPower:
+    case MetricId::SystemPowerOnBattery: return "W";
+    case MetricId::CpuFrequency:
+    case MetricId::GpuFrequency:
+    case MetricId::GpuVramFrequency:
+    case MetricId::Gpu2Frequency:
+    case MetricId::CpuFrequencyMax:
+    case MetricId::CpuFrequencyPCore:
+    case MetricId::CpuFrequencyECore:   return "MHz";
+    case MetricId::GpuCoreVoltage:      return "mV";
+    case MetricId::WaterCoolerRssi:     return "dBm";
+    case MetricId::WaterCoolerLatency:  return "ms";
+    case MetricId::BatteryVoltage:      return "V";
+    case MetricId::BatteryEnergy:       return "Wh";
+    case MetricId::BatteryTimeToEmpty:  return "min";
+    default:                            return "%";
+  }
+}
+
+/**
+ * @brief Kind of quantity, for putting metrics on a shared chart axis:
+ *        "temp", "duty" (percentages), "power", "freq", "volt" or "other".
+ */
+constexpr const char *metricGroup( MetricId id ) noexcept
+{
+  const std::string_view unit = metricUnit( id );
+  if ( unit == "°C" )
+    return "temp";
+  if ( unit == "%" )
+    return "duty";
+  if ( unit == "W" )
+    return "power";
+  if ( unit == "MHz" )
+    return "freq";
+  if ( unit == "mV" || unit == "V" )
+    return "volt";
+  return "other";
+}
+
+/**
+ * @brief Every metric the daemon can record, with its key, unit and group.
+ *
+ * The built-in MetricIds are registered up front under their own values;
+ * telemetry found at runtime (e.g. a third fan) is added with the next free
+ * id, up to MAX_METRICS.  Ids stay the same for the daemon's lifetime, and
+ * clients learn the ones they were not built with from catalogJSON()
+ * instead of a compiled-in table.
+ *
+ * Lookups take a mutex: they happen when a series is created and when a
+ * query names its metrics, not per sample.
+ */
+class MetricRegistry
+{
+public:
+  static constexpr size_t MAX_METRICS = 64;  ///< Metric masks are 64 bits wide
+
+  struct Info
+  {
+    std::string key;
+    std::string unit;
+    std::string group;
+    StatsBinSpec bins;
+  };
+
+  MetricRegistry()
+  {
+    m_metrics.reserve( MAX_METRICS );
+    for ( size_t i = 0; i < static_cast< size_t >( MetricId::Count ); ++i )
+    {
+      const auto id = static_cast< MetricId >( i );
+      m_metrics.push_back( Info{ metricName( id ), metricUnit( id ), metricGroup( id ), statsBinSpec( id ) } );
+    }
+    m_size.store( m_metrics.size(), std::memory_order_release );
+  }
+
+  /**
+   * @brief Id of the metric called @p key, registered first if it is new.
+   * @return nullopt once MAX_METRICS are registered
+   */
+  std::optional< MetricId > add( std::string_view key, std::string_view unit, std::string_view group,
+                                 StatsBinSpec bins = { 0.0, 1.0 } )
+  {
+    std::lock_guard lock( m_mutex );
+    if ( const auto id = findLocked( key ) )
+      return id;
+    if ( m_metrics.size() >= MAX_METRICS )
+      return std::nullopt;
+    m_metrics.push_back( Info{ std::string( key ), std::string( unit ), std::string( group ), bins } );
+    m_size.store( m_metrics.size(), std::memory_order_release );
+    return static_cast< MetricId >( m_metrics.size() - 1 );
+  }
+
+  [[nodiscard]] std::optional< MetricId > find( std::string_view key ) const
+  {
+    std::lock_guard lock( m_mutex );
+    return findLocked( key );
+  }
+
+  /// Number of registered metrics; ids are 0 .. size() - 1
+  [[nodiscard]] size_t size() const noexcept { return m_size.load( std::memory_order_acquire ); }
+
+  [[nodiscard]] std::optional< Info > info( MetricId id ) const
+  {
+    std::lock_guard lock( m_mutex );
+    const auto idx = static_cast< size_t >( id );
+    if ( idx >= m_metrics.size() )
+      return std::nullopt;
+    return m_metrics[ idx ];
+  }
+
+  /// JSON key of @p id, "unknown" if it is not registered
+  [[nodiscard]] std::string key( MetricId id ) const
+  {
+    const auto metric = info( id );
+    return metric ? metric->key : std::string( "unknown" );
+  }
+
+  /**
+   * @brief The registered metrics as a JSON array, in id order.
+   *
+   * @code
+   * [ { "id": 0, "key": "cpuTemp", "unit": "°C", "group": "temp", "present": true }, ... ]
+   * @endcode
+   *
+   * "present" is bit id of @p presentMask: whether the metric has been
+   * recorded on this machine.
+   */
+  void catalogJSON( uint64_t presentMask, std::string &out ) const
+  {
+    std::lock_guard lock( m_mutex );
+    JsonWriter w( out );
+    w.beginArray();
+    for ( size_t i = 0; i < m_metrics.size(); ++i )
+    {
+      const Info &metric = m_metrics[ i ];
+      w.beginObject()
+        .key( "id" ).value( static_cast< int >( i ) )
+        .key( "key" ).value( metric.key )
+        .key( "unit" ).value( metric.unit )
+        .key( "group" ).value( metric.group )
+        .key( "present" ).value( ( presentMask >> i & 1u ) != 0 )
+        .endObject();
+    }
+    w.endArray();
+  }
+
+private:
+  [[nodiscard]] std::optional< MetricId > findLocked( std::string_view key ) const
+  {
+    for ( size_t i = 0; i < m_metrics.size(); ++i )
+      if ( m_metrics[ i ].key == key )
+        return static_cast< MetricId >( i );
+    return std::nullopt;
+  }
+
+  mutable std::mutex m_mutex;
+  std::vector< Info > m_metrics;
+  std::atomic< size_t > m_size{ 0 };
+};
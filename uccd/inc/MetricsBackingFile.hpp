@@ -0,0 +1,170 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <syslog.h>
+#include <unistd.h>
+
+/**
+ * @brief Memory-mapped file that backs the metrics history rings.
+ *
+ * Layout:
+ * @code
+ *   [0, DATA_OFFSET)       Header (magic, version, layout fingerprint, size)
+ *   [DATA_OFFSET, ...)     Ring regions, laid out by MetricsHistoryStore
+ * @endcode
+ *
+ * The mapping is MAP_SHARED, so samples reach the page cache with a plain
+ * store and the kernel writes them back in the background — there is no
+ * syscall on the hot path.  The header magic is written last when a file is
+ * (re)initialised, so an interrupted initialisation is detected on the next
+ * start and simply redone.
+ */
+class MetricsBackingFile
+{
+public:
+  static constexpr size_t DATA_OFFSET = 4096;
+  static constexpr uint32_t VERSION = 1;
+
+  MetricsBackingFile() = default;
+  ~MetricsBackingFile() { unmap(); }
+
+  MetricsBackingFile( const MetricsBackingFile & ) = delete;
+  MetricsBackingFile &operator=( const MetricsBackingFile & ) = delete;
+
+  /**
+   * @brief Map @p path with room for @p dataSize bytes of ring data.
+   *
+   * @param layoutHash Fingerprint of the ring layout; a mismatch discards
+   *                   the old contents.
+   * @param attached   Set to true if existing data with the same layout was
+   *                   found (caller should recover the rings), false if the
+   *                   data area is fresh (caller should reset the rings).
+   * @return Start of the data area, or nullptr on failure.
+   */
+  [[nodiscard]] std::byte *map( const std::string &path, uint64_t layoutHash,
+                                size_t dataSize, bool &attached ) noexcept
+  {
+    unmap();
+    attached = false;
+
+    try
+    {
+      std::filesystem::create_directories( std::filesystem::path( path ).parent_path() );
+    }
+    catch ( ... )
+    {
+      // open() below reports the actual problem
+    }
+
+    const int fd = ::open( path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600 );
+    if ( fd < 0 )
+    {
+      syslog( LOG_WARNING, "MetricsBackingFile: cannot open %s: %s", path.c_str(), strerror( errno ) );
+      return nullptr;
+    }
+
+    const size_t total = DATA_OFFSET + dataSize;
+    struct stat st{};
+    if ( fstat( fd, &st ) != 0 ||
+         ( static_cast< size_t >( st.st_size ) != total &&
+           ftruncate( fd, static_cast< off_t >( total ) ) != 0 ) )
+    {
+      syslog( LOG_WARNING, "MetricsBackingFile: cannot size %s: %s", path.c_str(), strerror( errno ) );
+      ::close( fd );
+      return nullptr;
+    }
+
+    void *addr = mmap( nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if ( addr == MAP_FAILED )
+    {
+      syslog( LOG_WARNING, "MetricsBackingFile: cannot map %s: %s", path.c_str(), strerror( errno ) );
+      return nullptr;
+    }
+
+    m_base = static_cast< std::byte * >( addr );
+    m_size = total;
+
+    Header hdr{};
+    std::memcpy( &hdr, m_base, sizeof( hdr ) );
+    attached = std::memcmp( hdr.magic, MAGIC, sizeof( hdr.magic ) ) == 0 &&
+               hdr.version == VERSION && hdr.layoutHash == layoutHash &&
+               hdr.dataSize == dataSize;
+
+    if ( attached )
+      syslog( LOG_INFO, "MetricsBackingFile: reattached to %s", path.c_str() );
+    else
+      syslog( LOG_INFO, "MetricsBackingFile: initialised %s", path.c_str() );
+
+    m_pendingHeader = attached ? Header{} : Header{ {}, VERSION, layoutHash, dataSize };
+    if ( !attached )
+      std::memset( m_base, 0, sizeof( Header ) );
+
+    return m_base + DATA_OFFSET;
+  }
+
+  /**
+   * @brief Mark freshly initialised data as valid.
+   *
+   * Call after the caller has reset all rings; a no-op for attached files.
+   */
+  void commit() noexcept
+  {
+    if ( m_base == nullptr || m_pendingHeader.version == 0 )
+      return;
+
+    std::memcpy( m_pendingHeader.magic, MAGIC, sizeof( m_pendingHeader.magic ) );
+    std::memcpy( m_base, &m_pendingHeader, sizeof( m_pendingHeader ) );
+    m_pendingHeader = Header{};
+  }
+
+  [[nodiscard]] bool isMapped() const noexcept { return m_base != nullptr; }
+
+private:
+  struct Header
+  {
+    char magic[ 8 ];
+    uint32_t version;
+    uint64_t layoutHash;
+    uint64_t dataSize;
+  };
+
+  static constexpr char MAGIC[ 8 ] = { 'U', 'C', 'C', 'H', 'I', 'S', 'T', '\0' };
+
+  void unmap() noexcept
+  {
+    if ( m_base != nullptr )
+    {
+      munmap( m_base, m_size );
+      m_base = nullptr;
+      m_size = 0;
+    }
+  }
+
+  std::byte *m_base = nullptr;
+  size_t m_size = 0;
+  Header m_pendingHeader{};
+};
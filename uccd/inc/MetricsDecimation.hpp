@@ -0,0 +1,150 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Server-side downsampling strategies for chart queries.
+ */
+enum class DecimationMode : uint8_t
+{
+  Lttb,    ///< Largest-triangle-three-buckets: keeps the visual shape
+  MinMax,  ///< Per-bucket min and max: keeps every spike
+};
+
+/**
+ * @brief Largest-triangle-three-buckets downsampling.
+ *
+ * Keeps the first and last point and, for each of the (maxPoints – 2)
+ * buckets in between, the point that forms the largest triangle with the
+ * previously selected point and the average of the next bucket.  Output is
+ * appended to @p out; inputs with at most @p maxPoints points (or a budget
+ * below 3) are copied unchanged.
+ *
+ * @tparam Point Any type with @c timestampMs and @c value members
+ */
+template< typename Point >
+void decimateLttb( const std::vector< Point > &in, size_t maxPoints, std::vector< Point > &out )
+{
+  const size_t n = in.size();
+  if ( maxPoints < 3 || n <= maxPoints )
+  {
+    out.insert( out.end(), in.begin(), in.end() );
+    return;
+  }
+
+  out.reserve( out.size() + maxPoints );
+  out.push_back( in.front() );
+
+  const double every = static_cast< double >( n - 2 ) / static_cast< double >( maxPoints - 2 );
+  size_t selected = 0;
+
+  for ( size_t b = 0; b < maxPoints - 2; ++b )
+  {
+    // Current bucket [start, end) and the next bucket used for the average
+    const size_t start = static_cast< size_t >( std::floor( static_cast< double >( b ) * every ) ) + 1;
+    const size_t end = static_cast< size_t >( std::floor( static_cast< double >( b + 1 ) * every ) ) + 1;
+    const size_t nextEnd = std::min( static_cast< size_t >(
+      std::floor( static_cast< double >( b + 2 ) * every ) ) + 1, n );
+
+    double avgX = 0.0;
+    double avgY = 0.0;
+    for ( size_t i = end; i < nextEnd; ++i )
+    {
+      avgX += static_cast< double >( in[ i ].timestampMs );
+      avgY += in[ i ].value;
+    }
+    const size_t nextCount = nextEnd > end ? nextEnd - end : 0;
+    if ( nextCount > 0 )
+    {
+      avgX /= static_cast< double >( nextCount );
+      avgY /= static_cast< double >( nextCount );
+    }
+    else
+    {
+      avgX = static_cast< double >( in.back().timestampMs );
+      avgY = in.back().value;
+    }
+
+    const double ax = static_cast< double >( in[ selected ].timestampMs );
+    const double ay = in[ selected ].value;
+    double bestArea = -1.0;
+    size_t best = start;
+    for ( size_t i = start; i < end && i < n - 1; ++i )
+    {
+      const double area = std::abs( ( ax - avgX ) * ( in[ i ].value - ay ) -
+                                    ( ax - static_cast< double >( in[ i ].timestampMs ) ) * ( avgY - ay ) );
+      if ( area > bestArea )
+      {
+        bestArea = area;
+        best = i;
+      }
+    }
+
+    out.push_back( in[ best ] );
+    selected = best;
+  }
+
+  out.push_back( in.back() );
+}
+
+/**
+ * @brief Min/max bucketing: emit the extremes of each of maxPoints / 2 buckets.
+ *
+ * Within a bucket the two points are emitted in time order, so the result
+ * stays sorted.  Inputs that already fit (or a budget below 2) are copied.
+ */
+template< typename Point >
+void decimateMinMax( const std::vector< Point > &in, size_t maxPoints, std::vector< Point > &out )
+{
+  const size_t n = in.size();
+  if ( maxPoints < 2 || n <= maxPoints )
+  {
+    out.insert( out.end(), in.begin(), in.end() );
+    return;
+  }
+
+  const size_t buckets = maxPoints / 2;
+  out.reserve( out.size() + buckets * 2 );
+
+  for ( size_t b = 0; b < buckets; ++b )
+  {
+    const size_t start = b * n / buckets;
+    const size_t end = ( b + 1 ) * n / buckets;
+    size_t lo = start;
+    size_t hi = start;
+    for ( size_t i = start + 1; i < end; ++i )
+    {
+      if ( in[ i ].value < in[ lo ].value )
+        lo = i;
+      if ( in[ i ].value > in[ hi ].value )
+        hi = i;
+    }
+
+    if ( lo == hi )
+      out.push_back( in[ lo ] );
+    else
+    {
+      out.push_back( in[ std::min( lo, hi ) ] );
+      out.push_back( in[ std::max( lo, hi ) ] );
+    }
+  }
+}
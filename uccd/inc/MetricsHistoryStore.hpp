@@ -16,85 +16,709 @@
 #pragma once
 
 #include <array>
+#include <bit>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <chrono>
-#include <deque>
+#include <limits>
+#include <memory>
 #include <mutex>
-#include <shared_mutex>
+#include <optional>
+#include <span>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 
+#include "AlertEngine.hpp"
+#include "CoreHistoryRing.hpp"
+#include "JsonWriter.hpp"
+#include "MetricsBackingFile.hpp"
+#include "MetricsCodec.hpp"
+#include "MetricsDecimation.hpp"
+#include "MetricEventRing.hpp"
+#include "MetricRegistry.hpp"
+#include "MetricsStatistics.hpp"
+#include "LiveMetricsPublisher.hpp"
+
+/**
+ * @brief A single timestamped data point.
+ */
+struct MetricDataPoint
+{
+  int64_t timestampMs;  ///< Unix epoch milliseconds
+  double  value;
+};
+
+/**
+ * @brief One metric's value within a MetricsHistoryStore::pushFrame().
+ */
+struct MetricSample
+{
+  MetricId id;
+  double value;
+};
+
 /**
- * @brief Identifiers for each tracked metric.
+ * @brief The samples of one tick, collected without allocating.
  *
- * The underlying value is used as an index into the per-metric ring buffers.
+ * Holds at most one entry per registered metric; further add()s are dropped.
  */
-enum class MetricId : uint8_t
+class MetricFrame
 {
-  CpuTemp,
-  CpuFanDuty,
-  CpuPower,
-  CpuFrequency,
-  GpuTemp,
-  GpuFanDuty,
-  GpuPower,
-  GpuFrequency,
-  GpuVramFrequency,
-  GpuCoreVoltage,
-  Count  ///< Sentinel — must be last
+public:
+  void add( MetricId id, double value ) noexcept
+  {
+    if ( m_size < m_samples.size() )
+      m_samples[ m_size++ ] = MetricSample{ id, value };
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+  operator std::span< const MetricSample >() const noexcept { return { m_samples.data(), m_size }; }
+
+private:
+  std::array< MetricSample, MetricRegistry::MAX_METRICS > m_samples{};
+  size_t m_size = 0;
 };
 
 /**
- * @brief Human-readable name for a metric (matches JSON key).
+ * @brief One min/max/avg bucket of a rollup tier.
  */
-constexpr const char *metricName( MetricId id ) noexcept
+struct RollupPoint
 {
-  switch ( id )
-  {
-    case MetricId::CpuTemp:             return "cpuTemp";
-    case MetricId::CpuFanDuty:          return "cpuFanDuty";
-    case MetricId::CpuPower:            return "cpuPower";
-    case MetricId::CpuFrequency:        return "cpuFrequency";
-    case MetricId::GpuTemp:             return "gpuTemp";
-    case MetricId::GpuFanDuty:          return "gpuFanDuty";
-    case MetricId::GpuPower:            return "gpuPower";
-    case MetricId::GpuFrequency:        return "gpuFrequency";
-    case MetricId::GpuVramFrequency:    return "gpuVramFrequency";
-    case MetricId::GpuCoreVoltage:      return "gpuCoreVoltage";
-    default:                            return "unknown";
-  }
-}
+  int64_t bucketStartMs;  ///< Unix epoch milliseconds, aligned to the tier width
+  double  min;
+  double  max;
+  double  avg;
+};
 
 /**
- * @brief A single timestamped data point.
+ * @brief Fixed-capacity single-writer / multi-reader ring of timestamped rows.
+ *
+ * Timestamps and each value column live in separate preallocated arrays
+ * (SoA) so a reader that only needs the time axis (binary search) touches
+ * as few cache lines as possible.  The arrays are allocated once without
+ * initialisation, so untouched pages are never committed by the kernel.
+ *
+ * Synchronisation uses two monotonically increasing sequence counters
+ * instead of a mutex:
+ *   - @c m_head  – number of rows ever written; slot = seq % (capacity + 1).
+ *                  The writer fills the slot first, then publishes head+1
+ *                  with release semantics.
+ *   - @c m_tail  – first sequence that is still inside the horizon.  Only the
+ *                  writer advances it (age-based eviction).
+ *
+ * Readers copy a range and afterwards re-read @c m_head: any slot whose
+ * sequence may have been reused while copying is discarded.  Readers never
+ * block the writer and the writer never allocates.  Callers must serialise
+ * writers themselves.
+ *
+ * Counters and arrays live in one contiguous region of regionBytes() bytes,
+ * either owned by the ring or supplied by the caller (e.g. a mapped file,
+ * see MetricsBackingFile), so the history can outlive the process.
+ *
+ * @tparam Columns Number of double values stored per row
  */
-struct MetricDataPoint
+template< size_t Columns >
+class HistoryRing
 {
-  int64_t timestampMs;  ///< Unix epoch milliseconds
-  double  value;
+public:
+  using Row = std::array< double, Columns >;
+
+  /**
+   * @brief Size of the storage region for @p capacity rows (multiple of 64).
+   */
+  static constexpr size_t regionBytes( size_t capacity ) noexcept
+  {
+    const size_t slotCount = std::max< size_t >( capacity, 1 ) + 1;
+    return ( COUNTERS_BYTES + slotCount * sizeof( int64_t ) * ( 1 + Columns ) + 63 ) & ~size_t( 63 );
+  }
+
+  /**
+   * @brief Ring with its own heap storage, starting empty.
+   */
+  explicit HistoryRing( size_t capacity )
+    : HistoryRing( capacity, nullptr )
+  {
+  }
+
+  /**
+   * @brief Ring over caller-owned storage of regionBytes( capacity ) bytes.
+   *
+   * The region is not initialised: call reset() for fresh storage or
+   * recover() when reattaching to data written by an earlier process.
+   * A null @p region allocates owned storage and resets it.
+   */
+  HistoryRing( size_t capacity, std::byte *region )
+    : m_capacity( std::max< size_t >( capacity, 1 ) ),
+      m_slots( m_capacity + 1 )
+  {
+    if ( region == nullptr )
+    {
+      m_owned = std::make_unique_for_overwrite< std::byte[] >( regionBytes( m_capacity ) );
+      region = m_owned.get();
+    }
+    m_head = static_cast< uint64_t * >( static_cast< void * >( region ) );
+    m_tail = m_head + 1;
+    m_ts = static_cast< int64_t * >( static_cast< void * >( region + COUNTERS_BYTES ) );
+    for ( size_t c = 0; c < Columns; ++c )
+      m_cols[ c ] = static_cast< double * >( static_cast< void * >(
+        region + COUNTERS_BYTES + ( c + 1 ) * m_slots * sizeof( int64_t ) ) );
+    if ( m_owned )
+      reset();
+  }
+
+  HistoryRing( const HistoryRing & ) = delete;
+  HistoryRing &operator=( const HistoryRing & ) = delete;
+
+  [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+
+  /// Rows ever pushed since the last reset(), evicted ones included
+  [[nodiscard]] uint64_t written() const noexcept { return headRef().load( std::memory_order_acquire ); }
+
+  /**
+   * @brief Drop all rows.  Not safe against concurrent readers or writers.
+   */
+  void reset() noexcept
+  {
+    *m_head = 0;
+    *m_tail = 0;
+  }
+
+  /**
+   * @brief Repair the cursors of reattached storage.
+   *
+   * The writer publishes head only after the slot is filled, so a crashed
+   * process leaves consistent data behind; after power loss, however, the
+   * counter page and the data pages may have been written back unevenly.
+   * Keep the ascending run of timestamps from the oldest row and cut the
+   * head back to the first row that breaks it.  Not safe against concurrent
+   * readers or writers.
+   */
+  void recover() noexcept
+  {
+    uint64_t head = *m_head;
+    uint64_t tail = std::min( *m_tail, head );
+    if ( head - tail > m_capacity )
+      tail = head - m_capacity;
+
+    for ( uint64_t seq = tail + 1; seq < head; ++seq )
+      if ( loadTs( seq ) < loadTs( seq - 1 ) )
+      {
+        head = seq;
+        break;
+      }
+
+    *m_head = head;
+    *m_tail = tail;
+  }
+
+  /**
+   * @brief Append a row and evict everything older than (ts – horizonMs).
+   */
+  void pushRow( int64_t timestampMs, const Row &row, int64_t horizonMs ) noexcept
+  {
+    const uint64_t head = headRef().load( std::memory_order_relaxed );
+    const size_t slot = static_cast< size_t >( head % m_slots );
+    std::atomic_ref< int64_t >( m_ts[ slot ] ).store( timestampMs, std::memory_order_relaxed );
+    for ( size_t c = 0; c < Columns; ++c )
+      std::atomic_ref< double >( m_cols[ c ][ slot ] ).store( row[ c ], std::memory_order_relaxed );
+    headRef().store( head + 1, std::memory_order_release );
+
+    // Age-based eviction: advance the tail past rows outside the horizon.
+    // Rows overwritten by the ring wrap are implicitly evicted as well.
+    const uint64_t newHead = head + 1;
+    uint64_t tail = std::max( tailRef().load( std::memory_order_relaxed ),
+                              newHead > m_capacity ? newHead - m_capacity : 0 );
+    const int64_t cutoff = timestampMs - horizonMs;
+    while ( tail < newHead && loadTs( tail ) < cutoff )
+      ++tail;
+    tailRef().store( tail, std::memory_order_release );
+  }
+
+  /**
+   * @brief Append make( ts, row ) for every row with timestamp >= sinceMs.
+   *
+   * Lock-free: retries a bounded number of times if the writer lapped the
+   * region being copied, otherwise just drops the overwritten prefix.
+   */
+  template< typename Out, typename MakeFn >
+  void copySince( int64_t sinceMs, std::vector< Out > &out, MakeFn &&make ) const
+  {
+    const size_t base = out.size();
+
+    for ( int attempt = 0; attempt < 4; ++attempt )
+    {
+      out.resize( base );
+
+      const uint64_t head = headRef().load( std::memory_order_acquire );
+      const uint64_t lo = lowerBound( firstRetained( head ), head, sinceMs );
+
+      out.reserve( base + static_cast< size_t >( head - lo ) );
+      Row row;
+      for ( uint64_t seq = lo; seq < head; ++seq )
+      {
+        for ( size_t c = 0; c < Columns; ++c )
+          row[ c ] = loadCol( c, seq );
+        out.push_back( make( loadTs( seq ), row ) );
+      }
+
+      // Validate: the writer filling sequence `headAfter` reuses the slot of
+      // sequence (headAfter – slots), so everything below headAfter – capacity
+      // may have been overwritten while we were copying.
+      std::atomic_thread_fence( std::memory_order_acquire );
+      const uint64_t headAfter = headRef().load( std::memory_order_relaxed );
+      const uint64_t firstSafe = headAfter > m_capacity ? headAfter - m_capacity : 0;
+
+      if ( lo >= firstSafe )
+        return;
+
+      // The copied range was partially overwritten.  If the search itself
+      // may have been misled, try again; on the last attempt keep the
+      // intact suffix.
+      if ( attempt == 3 )
+      {
+        const size_t drop = static_cast< size_t >( std::min( firstSafe - lo, head - lo ) );
+        out.erase( out.begin() + static_cast< std::ptrdiff_t >( base ),
+                   out.begin() + static_cast< std::ptrdiff_t >( base + drop ) );
+      }
+    }
+  }
+
+  /**
+   * @brief Approximate number of rows with timestamp >= sinceMs (no copy).
+   */
+  [[nodiscard]] size_t countSince( int64_t sinceMs ) const noexcept
+  {
+    const uint64_t head = headRef().load( std::memory_order_acquire );
+    return static_cast< size_t >( head - lowerBound( firstRetained( head ), head, sinceMs ) );
+  }
+
+  /**
+   * @brief True if no row at or after @p sinceMs has been evicted yet.
+   */
+  [[nodiscard]] bool covers( int64_t sinceMs ) const noexcept
+  {
+    const uint64_t head = headRef().load( std::memory_order_acquire );
+    const uint64_t lo = firstRetained( head );
+    return lo == 0 || ( lo < head && loadTs( lo ) <= sinceMs );
+  }
+
+  /**
+   * @brief Newest retained row, or false if the ring is empty.
+   *
+   * The slot of the newest row is only reused after @c m_slots further
+   * pushes, so a re-check of head after the copy is sufficient.
+   */
+  bool latestRow( int64_t &timestampMs, Row &row ) const noexcept
+  {
+    for ( int attempt = 0; attempt < 4; ++attempt )
+    {
+      const uint64_t head = headRef().load( std::memory_order_acquire );
+      if ( head == firstRetained( head ) )
+        return false;
+
+      timestampMs = loadTs( head - 1 );
+      for ( size_t c = 0; c < Columns; ++c )
+        row[ c ] = loadCol( c, head - 1 );
+
+      std::atomic_thread_fence( std::memory_order_acquire );
+      if ( headRef().load( std::memory_order_relaxed ) - head < m_slots - 1 )
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Number of rows currently retained (inside horizon and capacity).
+   */
+  [[nodiscard]] size_t size() const noexcept
+  {
+    const uint64_t head = headRef().load( std::memory_order_acquire );
+    return static_cast< size_t >( head - firstRetained( head ) );
+  }
+
+private:
+  static constexpr size_t COUNTERS_BYTES = 64;  ///< head + tail, padded to a cache line
+
+  [[nodiscard]] std::atomic_ref< uint64_t > headRef() const noexcept { return std::atomic_ref< uint64_t >( *m_head ); }
+  [[nodiscard]] std::atomic_ref< uint64_t > tailRef() const noexcept { return std::atomic_ref< uint64_t >( *m_tail ); }
+
+  /// Clamped to @p head: the writer may publish and evict between the
+  /// caller's head load and the tail load here
+  [[nodiscard]] uint64_t firstRetained( uint64_t head ) const noexcept
+  {
+    return std::min( head, std::max( tailRef().load( std::memory_order_acquire ),
+                                     head > m_capacity ? head - m_capacity : 0 ) );
+  }
+
+  /// First sequence in [lo, hi) with ts >= sinceMs
+  [[nodiscard]] uint64_t lowerBound( uint64_t lo, uint64_t hi, int64_t sinceMs ) const noexcept
+  {
+    while ( lo < hi )
+    {
+      const uint64_t mid = lo + ( hi - lo ) / 2;
+      if ( loadTs( mid ) < sinceMs )
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  [[nodiscard]] int64_t loadTs( uint64_t seq ) const noexcept
+  {
+    return std::atomic_ref< int64_t >( m_ts[ static_cast< size_t >( seq % m_slots ) ] )
+      .load( std::memory_order_relaxed );
+  }
+
+  [[nodiscard]] double loadCol( size_t col, uint64_t seq ) const noexcept
+  {
+    return std::atomic_ref< double >( m_cols[ col ][ static_cast< size_t >( seq % m_slots ) ] )
+      .load( std::memory_order_relaxed );
+  }
+
+  const size_t m_capacity;  ///< Rows retained
+  const size_t m_slots;     ///< capacity + 1 spare slot the writer fills while readers copy
+  std::unique_ptr< std::byte[] > m_owned;  ///< Only set when not caller-provided
+  uint64_t *m_head = nullptr;
+  uint64_t *m_tail = nullptr;
+  int64_t *m_ts = nullptr;
+  std::array< double *, Columns > m_cols{};
+};
+
+/**
+ * @brief Raw sample ring for one metric.
+ */
+class MetricRing : public HistoryRing< 1 >
+{
+public:
+  using HistoryRing< 1 >::HistoryRing;
+  using HistoryRing< 1 >::copySince;
+
+  void push( int64_t timestampMs, double value, int64_t horizonMs ) noexcept
+  {
+    pushRow( timestampMs, { value }, horizonMs );
+  }
+
+  void copySince( int64_t sinceMs, std::vector< MetricDataPoint > &out ) const
+  {
+    copySince( sinceMs, out, []( int64_t ts, const Row &row ) {
+      return MetricDataPoint{ ts, row[ 0 ] };
+    } );
+  }
+  [[nodiscard]] std::optional< MetricDataPoint > latest() const noexcept
+  {
+    MetricDataPoint pt{};
+    Row row;
+    if ( !latestRow( pt.timestampMs, row ) )
+      return std::nullopt;
+    pt.value = row[ 0 ];
+    return pt;
+  }
+};
+
+/**
+ * @brief Downsampled min/max/avg ring for one metric and bucket width.
+ */
+class RollupRing : public HistoryRing< 3 >
+{
+public:
+  using HistoryRing< 3 >::HistoryRing;
+  using HistoryRing< 3 >::copySince;
+
+  void copySince( int64_t sinceMs, std::vector< RollupPoint > &out ) const
+  {
+    copySince( sinceMs, out, []( int64_t ts, const Row &row ) {
+      return RollupPoint{ ts, row[ 0 ], row[ 1 ], row[ 2 ] };
+    } );
+  }
+};
+
+/**
+ * @brief Static description of one rollup tier.
+ */
+struct RollupTierSpec
+{
+  int64_t bucketMs;   ///< Bucket width
+  int64_t horizonMs;  ///< Retention; capacity = horizonMs / bucketMs
+};
+
+/**
+ * @brief Downsampled tiers kept next to the raw ring, finest first.
+ *
+ * 10 s buckets for a day and 1 min buckets for a week cost about
+ * 0.6 MiB per metric, committed lazily as buckets are filled.
+ */
+inline constexpr std::array< RollupTierSpec, 2 > kRollupTiers = { {
+  { 10'000, 24LL * 3600 * 1000 },
+  { 60'000, 7LL * 24 * 3600 * 1000 },
+} };
+
+/**
+ * @brief Raw ring plus incrementally maintained rollup tiers for one metric.
+ *
+ * push() folds every sample into the open bucket of each tier; when a sample
+ * lands in a later bucket the open one is closed and published to its ring.
+ * Readers therefore only see closed buckets — the newest rollup lags by at
+ * most one bucket width, the raw ring is always current.
+ *
+ * The same push also feeds a StreamingStats window (heap only, not part of
+ * the backing file), so percentile queries never scan the raw ring.
+ *
+ * Multiple producers for the same metric (e.g. GpuTemp is fed by both the fan
+ * loop and the NVML callback) are serialised by a tiny spin flag that is
+ * uncontended in practice.  stats() takes the same flag while copying one
+ * pane at a time, so a reader delays a producer by at most one pane copy.
+ */
+class MetricSeries
+{
+public:
+  static constexpr size_t TIER_COUNT = kRollupTiers.size();
+
+  static constexpr size_t tierCapacity( size_t t ) noexcept
+  {
+    return static_cast< size_t >( kRollupTiers[ t ].horizonMs / kRollupTiers[ t ].bucketMs );
+  }
+
+  /**
+   * @brief Bytes needed for the raw ring and all tiers when externally backed.
+   */
+  static constexpr size_t regionBytes( size_t rawCapacity ) noexcept
+  {
+    size_t bytes = MetricRing::regionBytes( rawCapacity );
+    for ( size_t t = 0; t < TIER_COUNT; ++t )
+      bytes += RollupRing::regionBytes( tierCapacity( t ) );
+    return bytes;
+  }
+
+  /**
+   * @brief Empty the rings in a region without creating the series.
+   */
+  static void resetRegion( size_t rawCapacity, std::byte *region ) noexcept
+  {
+    MetricRing( rawCapacity, region ).reset();
+    region += MetricRing::regionBytes( rawCapacity );
+    for ( size_t t = 0; t < TIER_COUNT; ++t )
+    {
+      RollupRing( tierCapacity( t ), region ).reset();
+      region += RollupRing::regionBytes( tierCapacity( t ) );
+    }
+  }
+
+  /**
+   * @brief Whether the raw ring in a region ever held a sample.
+   */
+  static bool regionWritten( size_t rawCapacity, std::byte *region ) noexcept
+  {
+    return MetricRing( rawCapacity, region ).written() != 0;
+  }
+
+  /**
+   * @param statsSpec Histogram layout for the streaming statistics
+   * @param region    regionBytes( rawCapacity ) bytes of external storage, or
+   *                  nullptr for owned heap storage
+   * @param recover   Reattach to existing contents instead of starting empty
+   */
+  MetricSeries( size_t rawCapacity, StatsBinSpec statsSpec, std::byte *region = nullptr,
+                bool recover = false )
+    : m_raw( rawCapacity, region ),
+      m_stats( std::make_unique< StreamingStats >( statsSpec ) )
+  {
+    if ( region != nullptr )
+      region += MetricRing::regionBytes( rawCapacity );
+
+    for ( size_t t = 0; t < TIER_COUNT; ++t )
+    {
+      m_tiers[ t ] = std::make_unique< RollupRing >( tierCapacity( t ), region );
+      if ( region != nullptr )
+        region += RollupRing::regionBytes( tierCapacity( t ) );
+    }
+
+    if ( region == nullptr )
+      return;
+
+    if ( recover )
+    {
+      m_raw.recover();
+      for ( auto &tier : m_tiers )
+        tier->recover();
+
+      // Statistics are not persisted; rebuild what the raw ring still covers
+      std::vector< MetricDataPoint > points;
+      m_raw.copySince( std::numeric_limits< int64_t >::min(), points );
+      for ( const auto &pt : points )
+        m_stats->add( pt.timestampMs, pt.value );
+    }
+    else
+    {
+      m_raw.reset();
+      for ( auto &tier : m_tiers )
+        tier->reset();
+    }
+  }
+
+  void push( int64_t timestampMs, double value, int64_t rawHorizonMs ) noexcept
+  {
+    while ( m_writer.test_and_set( std::memory_order_acquire ) )
+      ;  // spin – only contended when two producers share one metric
+
+    m_raw.push( timestampMs, value, rawHorizonMs );
+
+    for ( size_t t = 0; t < TIER_COUNT; ++t )
+    {
+      const int64_t width = kRollupTiers[ t ].bucketMs;
+      const int64_t bucket = timestampMs - ( ( timestampMs % width ) + width ) % width;
+      Accumulator &acc = m_open[ t ];
+
+      if ( acc.count > 0 && bucket != acc.startMs )
+      {
+        m_tiers[ t ]->pushRow( acc.startMs,
+                               { acc.min, acc.max, acc.sum / static_cast< double >( acc.count ) },
+                               kRollupTiers[ t ].horizonMs );
+        acc.count = 0;
+      }
+
+      if ( acc.count == 0 )
+      {
+        acc.startMs = bucket;
+        acc.min = acc.max = acc.sum = value;
+      }
+      else
+      {
+        acc.min = std::min( acc.min, value );
+        acc.max = std::max( acc.max, value );
+        acc.sum += value;
+      }
+      ++acc.count;
+    }
+
+    m_stats->add( timestampMs, value );
+
+    m_writer.clear( std::memory_order_release );
+  }
+
+  [[nodiscard]] const MetricRing &raw() const noexcept { return m_raw; }
+  [[nodiscard]] const RollupRing &tier( size_t t ) const noexcept { return *m_tiers[ t ]; }
+
+  /**
+   * @brief Streaming statistics from @p sinceMs (rounded down to the minute)
+   *        up to the newest sample, limited to StreamingStats::WINDOW_MS.
+   *
+   * @param threshold Value for MetricStats::secondsAbove; NaN skips it
+   */
+  [[nodiscard]] MetricStats stats( int64_t sinceMs, double threshold ) const noexcept
+  {
+    StreamingStats::Summary summary( m_stats->spec() );
+    StreamingStats::Pane pane;
+    int64_t firstMinute = StreamingStats::minuteOf( sinceMs );
+
+    for ( size_t slot = 0; slot < StreamingStats::PANE_COUNT; ++slot )
+    {
+      while ( m_writer.test_and_set( std::memory_order_acquire ) )
+        ;
+      pane = m_stats->pane( slot );
+      const int64_t lastMs = m_stats->lastTimestampMs();
+      m_writer.clear( std::memory_order_release );
+
+      // Slots left over from before a gap longer than the window
+      if ( lastMs != StreamingStats::NO_MINUTE )
+        firstMinute = std::max( firstMinute, StreamingStats::minuteOf( lastMs ) -
+                                             static_cast< int64_t >( StreamingStats::PANE_COUNT ) + 1 );
+      if ( pane.minute != StreamingStats::NO_MINUTE && pane.minute >= firstMinute )
+        summary.merge( pane );
+    }
+
+    return summary.result( threshold );
+  }
+
+private:
+  struct Accumulator
+  {
+    int64_t startMs = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    uint32_t count = 0;
+  };
+
+  MetricRing m_raw;
+  std::array< std::unique_ptr< RollupRing >, TIER_COUNT > m_tiers;
+  std::array< Accumulator, TIER_COUNT > m_open{};  ///< Writer-owned open buckets
+  std::unique_ptr< StreamingStats > m_stats;
+  mutable std::atomic_flag m_writer = ATOMIC_FLAG_INIT;
 };
 
 /**
- * @brief Thread-safe ring buffer for hardware monitoring metrics.
+ * @brief Lock-free history store for hardware monitoring metrics.
  *
  * Workers push data from their own threads; the D-Bus adaptor reads via
- * querySince().  A shared_mutex allows concurrent readers with exclusive
- * writers (each push only locks one metric's deque, so contention is minimal).
+ * querySince*().  Metrics are looked up in registry(); a metric's
+ * MetricSeries (rings, rollups and about 66 KiB of streaming statistics) is
+ * created on its first sample, so hardware the machine does not have costs
+ * nothing.  After that push() never allocates or takes a lock and readers
+ * never stall the sampling threads.
  *
- * Eviction is age-based: points older than the configured horizon are pruned
- * on every push().
+ * Raw eviction is age-based: points older than the configured horizon are
+ * dropped on every push().  The raw ring capacity bounds memory regardless
+ * of sample rate; it is sized for MAX_HORIZON_S at MAX_SAMPLE_RATE_HZ.
+ * Longer windows (up to MAX_ROLLUP_HORIZON_S) are served from the rollup
+ * tiers in kRollupTiers via querySinceRollup().
  */
 class MetricsHistoryStore
 {
 public:
-  static constexpr int DEFAULT_HORIZON_S = 1800;  ///< 30 minutes
-  static constexpr int MIN_HORIZON_S     = 60;
-  static constexpr int MAX_HORIZON_S     = 7200;  ///< 2 hours
+  static constexpr int DEFAULT_HORIZON_S  = 1800;  ///< 30 minutes
+  static constexpr int MIN_HORIZON_S      = 60;
+  static constexpr int MAX_HORIZON_S      = 7200;  ///< 2 hours
+  static constexpr int MAX_SAMPLE_RATE_HZ = 4;     ///< Sustained rate a ring can hold for MAX_HORIZON_S
+  static constexpr int MAX_ROLLUP_HORIZON_S =
+    static_cast< int >( kRollupTiers.back().horizonMs / 1000 );  ///< 7 days
+
+  static constexpr size_t DEFAULT_CAPACITY =
+    static_cast< size_t >( MAX_HORIZON_S ) * MAX_SAMPLE_RATE_HZ;
+
+  static constexpr const char *DEFAULT_BACKING_PATH = "/var/lib/ucc/metrics-history";
+
+  explicit MetricsHistoryStore( size_t capacityPerMetric = DEFAULT_CAPACITY )
+    : m_capacity( capacityPerMetric )
+  {
+  }
+
+  /**
+   * @brief Store whose rings live in a memory-mapped file at @p backingPath.
+   *
+   * History written by a previous daemon instance with the same layout is
+   * picked up again; otherwise the file is reinitialised.  If the file cannot
+   * be mapped the store falls back to heap storage and starts empty.
+   *
+   * Only the built-in MetricIds have a place in the file; metrics registered
+   * at runtime are kept on the heap.  Of the reattached series only those
+   * that ever held a sample are created up front.
+   */
+  MetricsHistoryStore( size_t capacityPerMetric, const std::string &backingPath )
+    : m_capacity( capacityPerMetric )
+  {
+    bool attached = false;
+    m_region = m_backing.map( backingPath, layoutHash( capacityPerMetric ),
+                              regionBytes() * BACKED_METRICS, attached );
+    if ( m_region == nullptr )
+      return;
+
+    for ( size_t i = 0; i < BACKED_METRICS; ++i )
+    {
+      std::byte *region = m_region + i * regionBytes();
+      if ( !attached )
+        MetricSeries::resetRegion( m_capacity, region );
+      else if ( MetricSeries::regionWritten( m_capacity, region ) )
+        createSeries( i, true );
+    }
 
-  MetricsHistoryStore() = default;
+    m_backing.commit();
+  }
 
   // -----------------------------------------------------------------------
   // Writer API (called from worker threads)
@@ -103,35 +727,190 @@ public:
   /**
    * @brief Push a new data point for the given metric.
    *
-   * Automatically trims points outside the configured horizon.
-   * Thread-safe (exclusive lock on the metric's deque).
+   * Automatically drops points outside the configured horizon, and points
+   * of ids that are not registered.  Lock-free and allocation-free except
+   * for the metric's first sample, which creates its series.
    */
-  void push( MetricId id, int64_t timestampMs, double value )
+  void push( MetricId id, int64_t timestampMs, double value ) noexcept
   {
     const auto idx = static_cast< size_t >( id );
-    if ( idx >= static_cast< size_t >( MetricId::Count ) )
+    MetricSeries *series = seriesForWrite( idx );
+    if ( series == nullptr )
       return;
 
-    std::unique_lock lock( m_mutex );
-    auto &buf = m_buffers[ idx ];
-    buf.push_back( { timestampMs, value } );
-    trim( buf, timestampMs );
+    series->push( timestampMs, value, m_horizonMs.load( std::memory_order_relaxed ) );
+
+    if ( auto *live = m_live.load( std::memory_order_acquire ) )
+      live->publish( idx, timestampMs, value );
+    if ( auto *alerts = m_alerts.load( std::memory_order_acquire ) )
+      alerts->observe( id, timestampMs, value );
   }
 
   /**
    * @brief Convenience overload using the current wall-clock time.
    */
-  void push( MetricId id, double value )
+  void push( MetricId id, double value ) noexcept
   {
-    const auto now = std::chrono::duration_cast< std::chrono::milliseconds >(
-      std::chrono::system_clock::now().time_since_epoch() ).count();
-    push( id, now, value );
+    push( id, nowMs(), value );
+  }
+
+  /**
+   * @brief Push the samples of one tick under a single timestamp.
+   *
+   * Every sample gets exactly @p timestampMs, so series sampled together
+   * line up row for row (see querySinceFrames()), and the live segment is
+   * written in one seqlock section instead of one per sample.
+   */
+  void pushFrame( int64_t timestampMs, std::span< const MetricSample > samples ) noexcept
+  {
+    const int64_t horizonMs = m_horizonMs.load( std::memory_order_relaxed );
+    for ( const auto &sample : samples )
+    {
+      if ( MetricSeries *series = seriesForWrite( static_cast< size_t >( sample.id ) ) )
+        series->push( timestampMs, sample.value, horizonMs );
+    }
+
+    if ( auto *live = m_live.load( std::memory_order_acquire ) )
+    {
+      LiveMetricsPublisher::Frame frame( *live );
+      for ( const auto &sample : samples )
+        frame.add( static_cast< size_t >( sample.id ), timestampMs, sample.value );
+    }
+    if ( auto *alerts = m_alerts.load( std::memory_order_acquire ) )
+      for ( const auto &sample : samples )
+        alerts->observe( sample.id, timestampMs, sample.value );
+  }
+
+  void pushFrame( std::span< const MetricSample > samples ) noexcept
+  {
+    pushFrame( nowMs(), samples );
+  }
+
+  /**
+   * @brief Annotate the timeline, e.g. with a profile switch.
+   *
+   * Kept in a separate ring of MetricEventRing::CAPACITY entries (heap
+   * only) and returned by querySinceBinary().  @p label is truncated to
+   * fit ucc::MetricEventRecord.
+   */
+  void recordEvent( int64_t timestampMs, ucc::MetricEventKind kind, int32_t value,
+                    std::string_view label ) noexcept
+  {
+    m_events.push( timestampMs, kind, value, label );
+  }
+
+  void recordEvent( ucc::MetricEventKind kind, int32_t value, std::string_view label ) noexcept
+  {
+    recordEvent( nowMs(), kind, value, label );
+  }
+
+  /**
+   * @brief Set the columns of the per-core series (see CoreHistoryRing).
+   */
+  void setCoreLayout( const std::vector< int32_t > &cpus, const std::vector< uint8_t > &types )
+  {
+    m_cores.setLayout( cpus, types );
+  }
+
+  /**
+   * @brief Append one row of per-core frequency (MHz) and busy time (%).
+   */
+  void pushCores( int64_t timestampMs, const std::vector< double > &freqMHz,
+                  const std::vector< double > &busyPct ) noexcept
+  {
+    m_cores.push( timestampMs, freqMHz, busyPct );
+  }
+
+  void pushCores( const std::vector< double > &freqMHz, const std::vector< double > &busyPct ) noexcept
+  {
+    pushCores( nowMs(), freqMHz, busyPct );
   }
 
   // -----------------------------------------------------------------------
   // Reader API (called from D-Bus thread)
   // -----------------------------------------------------------------------
 
+  /**
+   * @brief Newest retained sample of @p id, nullopt if there is none.
+   */
+  [[nodiscard]] std::optional< MetricDataPoint > latest( MetricId id ) const noexcept
+  {
+    const MetricSeries *series = seriesAt( static_cast< size_t >( id ) );
+    if ( series == nullptr )
+      return std::nullopt;
+    return series->raw().latest();
+  }
+
+  /**
+   * @brief Append the raw samples of @p id with timestamps >= sinceMs to @p out.
+   */
+  void copySince( MetricId id, int64_t sinceMs, std::vector< MetricDataPoint > &out ) const
+  {
+    if ( const MetricSeries *series = seriesAt( static_cast< size_t >( id ) ) )
+      series->raw().copySince( sinceMs, out );
+  }
+
+  /**
+   * @brief Streaming statistics of @p id since @p sinceMs (see MetricSeries::stats()).
+   *
+   * O(panes × bins) regardless of sample rate; the window reaches back at
+   * most StreamingStats::WINDOW_MS.
+   */
+  [[nodiscard]] MetricStats statsSince( MetricId id, int64_t sinceMs,
+                                        double threshold = std::numeric_limits< double >::quiet_NaN() ) const noexcept
+  {
+    const MetricSeries *series = seriesAt( static_cast< size_t >( id ) );
+    if ( series == nullptr )
+      return {};
+    return series->stats( sinceMs, threshold );
+  }
+
+  /**
+   * @brief statsSince() for every metric as JSON.
+   *
+   * @code
+   * {
+   *   "cpuTemp": { "samples": 1800, "seconds": 1800.0, "min": 41.0, "max": 93.0,
+   *                "avg": 62.4, "p50": 60.5, "p95": 88.1, "p99": 91.7,
+   *                "threshold": 90.0, "secondsAbove": 42.0 },
+   *   ...
+   * }
+   * @endcode
+   *
+   * Metrics without samples are omitted; "threshold" / "secondsAbove" only
+   * appear where @p thresholds (indexed by id) holds a non-NaN value.
+   */
+  void queryStatsJSON( int64_t sinceMs, std::span< const double > thresholds, std::string &out ) const
+  {
+    JsonWriter w( out );
+    w.beginObject();
+    for ( size_t i = 0; i < m_series.size(); ++i )
+    {
+      const MetricSeries *series = seriesAt( i );
+      if ( series == nullptr )
+        continue;
+      const double threshold = i < thresholds.size() ? thresholds[ i ]
+                                                     : std::numeric_limits< double >::quiet_NaN();
+      const MetricStats st = series->stats( sinceMs, threshold );
+      if ( st.samples == 0 )
+        continue;
+
+      w.key( m_registry.key( static_cast< MetricId >( i ) ) ).beginObject()
+        .key( "samples" ).value( st.samples )
+        .key( "seconds" ).value( st.seconds, 1 )
+        .key( "min" ).value( st.min, 2 )
+        .key( "max" ).value( st.max, 2 )
+        .key( "avg" ).value( st.avg, 2 )
+        .key( "p50" ).value( st.p50, 2 )
+        .key( "p95" ).value( st.p95, 2 )
+        .key( "p99" ).value( st.p99, 2 );
+      if ( !std::isnan( threshold ) )
+        w.key( "threshold" ).value( threshold, 2 ).key( "secondsAbove" ).value( st.secondsAbove, 1 );
+      w.endObject();
+    }
+    w.endObject();
+  }
+
   /**
    * @brief Serialize all metrics with timestamps >= sinceMs to a JSON string.
    *
@@ -144,47 +923,42 @@ public:
    * }
    * @endcode
    *
-   * Empty series are omitted.
+   * Empty series are omitted.  Values use the shortest round-trip form.
    */
   [[nodiscard]] std::string querySinceJSON( int64_t sinceMs ) const
   {
-    std::shared_lock lock( m_mutex );
+    std::string out;
+    querySinceJSON( sinceMs, out );
+    return out;
+  }
 
-    std::ostringstream os;
-    os << '{';
-    bool firstMetric = true;
+  /**
+   * @brief querySinceJSON() into a reusable buffer (capacity is kept).
+   */
+  void querySinceJSON( int64_t sinceMs, std::string &out ) const
+  {
+    JsonWriter w( out );
+    w.beginObject();
 
-    for ( size_t i = 0; i < static_cast< size_t >( MetricId::Count ); ++i )
+    std::vector< MetricDataPoint > points;
+    for ( size_t i = 0; i < m_series.size(); ++i )
     {
-      const auto &buf = m_buffers[ i ];
-      if ( buf.empty() )
+      const MetricSeries *series = seriesAt( i );
+      if ( series == nullptr )
         continue;
-
-      // Binary search for the first element >= sinceMs
-      auto it = std::lower_bound(
-        buf.begin(), buf.end(), sinceMs,
-        []( const MetricDataPoint &pt, int64_t ts ) { return pt.timestampMs < ts; } );
-
-      if ( it == buf.end() )
+      points.clear();
+      series->raw().copySince( sinceMs, points );
+      if ( points.empty() )
         continue;
 
-      if ( !firstMetric )
-        os << ',';
-      firstMetric = false;
-
-      os << '"' << metricName( static_cast< MetricId >( i ) ) << "\":[";
-      bool firstPt = true;
-      for ( ; it != buf.end(); ++it )
-      {
-        if ( !firstPt )
-          os << ',';
-        firstPt = false;
-        os << '[' << it->timestampMs << ',' << it->value << ']';
-      }
-      os << ']';
+      // "[ts,value]," is at most ~48 bytes
+      out.reserve( out.size() + points.size() * 48 + 32 );
+      w.key( m_registry.key( static_cast< MetricId >( i ) ) ).beginArray();
+      for ( const auto &pt : points )
+        w.beginArray().value( pt.timestampMs ).value( pt.value ).endArray();
+      w.endArray();
     }
-    os << '}';
-    return os.str();
+    w.endObject();
   }
 
   /**
@@ -196,49 +970,274 @@ public:
    *     uint8_t  metricId
    *     uint32_t count         (number of data points)
    *     count × { int64_t timestampMs, double value }   (16 bytes each)
+   *   Optionally followed by one event block (see MetricEvents.hpp):
+   *     uint8_t  ucc::METRIC_EVENT_BLOCK_ID
+   *     uint32_t count         (events × ucc::METRIC_EVENT_UNITS)
+   *     events × ucc::MetricEventRecord                 (64 bytes each)
    * @endcode
    *
-   * Empty series are omitted.  The caller detects end-of-data by consuming
-   * exactly (1 + 4 + count * 16) bytes per block until the buffer is exhausted.
+   * Empty series and an empty event block are omitted.  The caller detects
+   * end-of-data by consuming exactly (1 + 4 + count * 16) bytes per block
+   * until the buffer is exhausted.
    */
   [[nodiscard]] std::vector< uint8_t > querySinceBinary( int64_t sinceMs ) const
   {
-    std::shared_lock lock( m_mutex );
+    std::vector< uint8_t > out;
+    out.reserve( 2048 );
+
+    std::vector< MetricDataPoint > points;
+    for ( size_t i = 0; i < m_series.size(); ++i )
+    {
+      const MetricSeries *series = seriesAt( i );
+      if ( series == nullptr )
+        continue;
+      points.clear();
+      series->raw().copySince( sinceMs, points );
+      appendBinaryBlock( out, i, points );
+    }
+
+    appendEventBlock( out, eventsSince( sinceMs ) );
+    return out;
+  }
+
+  /**
+   * @brief Just the event block of querySinceBinary(); empty without events.
+   */
+  [[nodiscard]] std::vector< uint8_t > queryEventsSinceBinary( int64_t sinceMs ) const
+  {
+    std::vector< uint8_t > out;
+    appendEventBlock( out, eventsSince( sinceMs ) );
+    return out;
+  }
+
+  /**
+   * @brief Per-core rows since @p sinceMs, limited to the horizon.
+   *
+   * Layout: CoreHistoryRing::copySinceBinary().
+   */
+  [[nodiscard]] std::vector< uint8_t > queryCoresSinceBinary( int64_t sinceMs ) const
+  {
+    std::vector< uint8_t > out;
+    m_cores.copySinceBinary( std::max( sinceMs, nowMs() - m_horizonMs.load( std::memory_order_relaxed ) ), out );
+    return out;
+  }
+
+  /**
+   * @brief Events with timestamps >= @p sinceMs, oldest first.
+   */
+  [[nodiscard]] std::vector< ucc::MetricEventRecord > eventsSince( int64_t sinceMs ) const
+  {
+    std::vector< ucc::MetricEventRecord > events;
+    m_events.copySince( sinceMs, events );
+    return events;
+  }
 
+  /**
+   * @brief querySinceBinary() restricted to @p metricMask and downsampled
+   *        server-side to at most @p maxPointsPerSeries points per series.
+   *
+   * Bit i of @p metricMask selects MetricId i, so only ids below 32 can be
+   * selected; use querySinceFrames() for the rest.  A budget of 0 disables
+   * decimation.  The wire layout is identical to querySinceBinary().
+   */
+  [[nodiscard]] std::vector< uint8_t > querySinceDecimated( int64_t sinceMs, uint32_t metricMask,
+                                                            size_t maxPointsPerSeries,
+                                                            DecimationMode mode = DecimationMode::Lttb ) const
+  {
     std::vector< uint8_t > out;
     out.reserve( 2048 );
 
-    for ( size_t i = 0; i < static_cast< size_t >( MetricId::Count ); ++i )
+    std::vector< MetricDataPoint > points;
+    std::vector< MetricDataPoint > reduced;
+    for ( size_t i = 0; i < 32; ++i )
+    {
+      const MetricSeries *series = seriesAt( i );
+      if ( ( metricMask & ( 1u << i ) ) == 0 || series == nullptr )
+        continue;
+
+      points.clear();
+      series->raw().copySince( sinceMs, points );
+
+      reduced.clear();
+      if ( mode == DecimationMode::MinMax )
+        decimateMinMax( points, maxPointsPerSeries, reduced );
+      else
+        decimateLttb( points, maxPointsPerSeries, reduced );
+      appendBinaryBlock( out, i, reduced );
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief The series selected by @p metricMask as columns over one shared
+   *        time axis.
+   *
+   * Rows are the distinct timestamps of the selected series since
+   * @p sinceMs; samples pushed in one pushFrame() share a row.  A series
+   * without a sample at a row's timestamp reads NaN there.
+   *
+   * A @p maxRows above 0 keeps only the oldest maxRows rows, so a long
+   * span can be read in pages by passing the last row's timestamp + 1 as
+   * the next @p sinceMs.
+   *
+   * Wire layout (native endian — same-host IPC only):
+   * @code
+   *   uint64_t metricMask    (selected series that have data)
+   *   uint32_t rows
+   *   rows × int64_t timestampMs
+   *   for each bit set in metricMask, ascending:
+   *     rows × double value
+   * @endcode
+   */
+  [[nodiscard]] std::vector< uint8_t > querySinceFrames( int64_t sinceMs, uint64_t metricMask,
+                                                         size_t maxRows = 0 ) const
+  {
+    std::array< std::vector< MetricDataPoint >, MetricRegistry::MAX_METRICS > series;
+    std::vector< int64_t > timestamps;
+    uint64_t present = 0;
+    for ( size_t i = 0; i < series.size(); ++i )
+    {
+      const MetricSeries *source = seriesAt( i );
+      if ( ( metricMask & ( uint64_t( 1 ) << i ) ) == 0 || source == nullptr )
+        continue;
+      source->raw().copySince( sinceMs, series[ i ] );
+      if ( series[ i ].empty() )
+        continue;
+      present |= uint64_t( 1 ) << i;
+      for ( const auto &pt : series[ i ] )
+        timestamps.push_back( pt.timestampMs );
+    }
+    std::sort( timestamps.begin(), timestamps.end() );
+    timestamps.erase( std::unique( timestamps.begin(), timestamps.end() ), timestamps.end() );
+    if ( maxRows > 0 && timestamps.size() > maxRows )
+      timestamps.resize( maxRows );
+
+    const uint32_t rows = static_cast< uint32_t >( timestamps.size() );
+    std::vector< uint8_t > out( sizeof( present ) + sizeof( rows ) + rows * sizeof( int64_t )
+                                + static_cast< size_t >( std::popcount( present ) ) * rows * sizeof( double ) );
+    uint8_t *dst = out.data();
+    std::memcpy( dst, &present, sizeof( present ) );
+    std::memcpy( dst + sizeof( present ), &rows, sizeof( rows ) );
+    dst += sizeof( present ) + sizeof( rows );
+    if ( rows > 0 )
+      std::memcpy( dst, timestamps.data(), rows * sizeof( int64_t ) );
+    dst += rows * sizeof( int64_t );
+
+    for ( size_t i = 0; i < series.size(); ++i )
     {
-      const auto &buf = m_buffers[ i ];
-      if ( buf.empty() )
+      if ( ( present & ( uint64_t( 1 ) << i ) ) == 0 )
         continue;
+      // both sides ascending: one merge pass per column
+      auto pt = series[ i ].begin();
+      for ( const int64_t ts : timestamps )
+      {
+        while ( pt != series[ i ].end() && pt->timestampMs < ts )
+          ++pt;
+        const double value = pt != series[ i ].end() && pt->timestampMs == ts
+                               ? pt->value : std::numeric_limits< double >::quiet_NaN();
+        std::memcpy( dst, &value, sizeof( value ) );
+        dst += sizeof( value );
+      }
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief Same selection as querySinceBinary(), delta/XOR-compressed.
+   *
+   * See MetricsCodec.hpp for the versioned wire layout.  Decoded with
+   * ucc::decodeMetricsCompressed().
+   */
+  [[nodiscard]] std::vector< uint8_t > querySinceCompressed( int64_t sinceMs ) const
+  {
+    std::vector< uint8_t > out;
+    out.reserve( 512 );
+    ucc::MetricsEncoder enc( out );
+
+    std::vector< MetricDataPoint > points;
+    for ( size_t i = 0; i < m_series.size(); ++i )
+    {
+      const MetricSeries *series = seriesAt( i );
+      if ( series == nullptr )
+        continue;
+      points.clear();
+      series->raw().copySince( sinceMs, points );
+      enc.addSeries( static_cast< uint8_t >( i ), static_cast< uint32_t >( points.size() ),
+                     [&]( uint32_t j ) { return points[ j ].timestampMs; },
+                     [&]( uint32_t j ) { return points[ j ].value; } );
+    }
 
-      auto it = std::lower_bound(
-        buf.begin(), buf.end(), sinceMs,
-        []( const MetricDataPoint &pt, int64_t ts ) { return pt.timestampMs < ts; } );
+    return out;
+  }
+
+  /**
+   * @brief Query a possibly long window within a per-series point budget.
+   *
+   * For every metric the finest resolution (raw, then each rollup tier)
+   * is chosen that still holds data back to @p sinceMs and returns at most
+   * @p maxPointsPerSeries points (0 = unlimited).  If none qualifies the
+   * coarsest tier is used.
+   *
+   * Wire layout (native endian — same-host IPC only):
+   * @code
+   *   Repeated for each non-empty metric series:
+   *     uint8_t  metricId
+   *     uint32_t bucketMs      (0 = raw samples)
+   *     uint32_t count
+   *     count × { int64_t timestampMs, double min, double max, double avg }   (32 bytes each)
+   * @endcode
+   *
+   * Raw samples carry min == max == avg; rollup timestamps are bucket starts.
+   */
+  [[nodiscard]] std::vector< uint8_t > querySinceRollup( int64_t sinceMs,
+                                                         size_t maxPointsPerSeries ) const
+  {
+    std::vector< uint8_t > out;
+    out.reserve( 2048 );
 
-      if ( it == buf.end() )
+    std::vector< RollupPoint > points;
+    for ( size_t i = 0; i < m_series.size(); ++i )
+    {
+      if ( seriesAt( i ) == nullptr )
         continue;
+      const MetricSeries &series = *seriesAt( i );
+      const size_t tier = selectResolution( series, sinceMs, maxPointsPerSeries );
 
-      const uint32_t count = static_cast< uint32_t >( std::distance( it, buf.end() ) );
+      points.clear();
+      uint32_t bucketMs = 0;
+      if ( tier == 0 )
+      {
+        series.raw().copySince( sinceMs, points, []( int64_t ts, const MetricRing::Row &row ) {
+          return RollupPoint{ ts, row[ 0 ], row[ 0 ], row[ 0 ] };
+        } );
+      }
+      else
+      {
+        series.tier( tier - 1 ).copySince( sinceMs, points );
+        bucketMs = static_cast< uint32_t >( kRollupTiers[ tier - 1 ].bucketMs );
+      }
+      if ( points.empty() )
+        continue;
 
-      // --- header: metricId (1 byte) + count (4 bytes) ---
-      const uint8_t id = static_cast< uint8_t >( i );
-      out.push_back( id );
-      out.insert( out.end(),
-                  reinterpret_cast< const uint8_t * >( &count ),
-                  reinterpret_cast< const uint8_t * >( &count ) + sizeof( count ) );
+      const uint32_t count = static_cast< uint32_t >( points.size() );
+      const size_t offset = out.size();
+      out.resize( offset + 1 + sizeof( bucketMs ) + sizeof( count ) + points.size() * ROLLUP_WIRE_SIZE );
+      uint8_t *dst = out.data() + offset;
+      *dst++ = static_cast< uint8_t >( i );
+      std::memcpy( dst, &bucketMs, sizeof( bucketMs ) );
+      dst += sizeof( bucketMs );
+      std::memcpy( dst, &count, sizeof( count ) );
+      dst += sizeof( count );
 
-      // --- data points: int64_t ts + double value (16 bytes each) ---
-      for ( ; it != buf.end(); ++it )
+      for ( const auto &pt : points )
       {
-        out.insert( out.end(),
-                    reinterpret_cast< const uint8_t * >( &it->timestampMs ),
-                    reinterpret_cast< const uint8_t * >( &it->timestampMs ) + sizeof( it->timestampMs ) );
-        out.insert( out.end(),
-                    reinterpret_cast< const uint8_t * >( &it->value ),
-                    reinterpret_cast< const uint8_t * >( &it->value ) + sizeof( it->value ) );
+        std::memcpy( dst, &pt.bucketStartMs, sizeof( pt.bucketStartMs ) );
+        std::memcpy( dst + 8, &pt.min, sizeof( pt.min ) );
+        std::memcpy( dst + 16, &pt.max, sizeof( pt.max ) );
+        std::memcpy( dst + 24, &pt.avg, sizeof( pt.avg ) );
+        dst += ROLLUP_WIRE_SIZE;
       }
     }
 
@@ -254,29 +1253,214 @@ public:
    *
    * Points older than (now – horizon) will be evicted on the next push().
    */
-  void setHorizon( int seconds )
+  void setHorizon( int seconds ) noexcept
+  {
+    m_horizonMs.store( static_cast< int64_t >(
+      std::clamp( seconds, MIN_HORIZON_S, MAX_HORIZON_S ) ) * 1000, std::memory_order_relaxed );
+  }
+
+  [[nodiscard]] int horizonSeconds() const noexcept
+  {
+    return static_cast< int >( m_horizonMs.load( std::memory_order_relaxed ) / 1000 );
+  }
+
+  /**
+   * @brief Mirror every future push() into @p live (may be nullptr).
+   *
+   * @p live must outlive the store or be detached first.
+   */
+  void setLiveSegment( LiveMetricsPublisher *live ) noexcept
+  {
+    m_live.store( live, std::memory_order_release );
+  }
+
+  /**
+   * @brief Hand every future sample to @p alerts (may be nullptr).
+   *
+   * @p alerts must outlive the store or be detached first.
+   */
+  void setAlertEngine( AlertEngine *alerts ) noexcept
+  {
+    m_alerts.store( alerts, std::memory_order_release );
+  }
+
+  /**
+   * @brief Ring capacity (points per metric).
+   */
+  [[nodiscard]] size_t capacityPerMetric() const noexcept
+  {
+    return std::max< size_t >( m_capacity, 1 );
+  }
+
+  // -----------------------------------------------------------------------
+  // Metric catalog
+  // -----------------------------------------------------------------------
+
+  /**
+   * @brief The metrics this store accepts; add() to record a new one.
+   */
+  [[nodiscard]] MetricRegistry &registry() noexcept { return m_registry; }
+  [[nodiscard]] const MetricRegistry &registry() const noexcept { return m_registry; }
+
+  /**
+   * @brief Bit i is set when metric i has a series, i.e. was ever recorded.
+   */
+  [[nodiscard]] uint64_t presentMask() const noexcept
   {
-    std::unique_lock lock( m_mutex );
-    m_horizonMs = static_cast< int64_t >(
-      std::clamp( seconds, MIN_HORIZON_S, MAX_HORIZON_S ) ) * 1000;
+    uint64_t mask = 0;
+    for ( size_t i = 0; i < m_series.size(); ++i )
+      if ( seriesAt( i ) != nullptr )
+        mask |= uint64_t( 1 ) << i;
+    return mask;
   }
 
-  [[nodiscard]] int horizonSeconds() const
+  /**
+   * @brief MetricRegistry::catalogJSON() with "present" from presentMask().
+   */
+  void catalogJSON( std::string &out ) const
   {
-    std::shared_lock lock( m_mutex );
-    return static_cast< int >( m_horizonMs / 1000 );
+    m_registry.catalogJSON( presentMask(), out );
   }
 
 private:
-  void trim( std::deque< MetricDataPoint > &buf, int64_t nowMs ) const
+  static constexpr size_t POINT_WIRE_SIZE = sizeof( int64_t ) + sizeof( double );
+  static constexpr size_t BACKED_METRICS = static_cast< size_t >( MetricId::Count );
+
+  [[nodiscard]] size_t regionBytes() const noexcept { return MetricSeries::regionBytes( m_capacity ); }
+
+  [[nodiscard]] const MetricSeries *seriesAt( size_t idx ) const noexcept
+  {
+    return idx < m_series.size() ? m_series[ idx ].load( std::memory_order_acquire ) : nullptr;
+  }
+
+  /// The series of @p idx, created on first use; nullptr for unregistered ids
+  MetricSeries *seriesForWrite( size_t idx ) noexcept
+  {
+    if ( idx >= m_series.size() )
+      return nullptr;
+    if ( MetricSeries *series = m_series[ idx ].load( std::memory_order_acquire ) )
+      return series;
+    if ( idx >= m_registry.size() )
+      return nullptr;
+
+    try
+    {
+      std::lock_guard lock( m_createMutex );
+      if ( MetricSeries *series = m_series[ idx ].load( std::memory_order_relaxed ) )
+        return series;
+      return createSeries( idx, false );
+    }
+    catch ( const std::exception & )
+    {
+      return nullptr;  // out of memory: drop the sample
+    }
+  }
+
+  /// Caller holds m_createMutex, or is the constructor
+  MetricSeries *createSeries( size_t idx, bool recover )
+  {
+    const auto id = static_cast< MetricId >( idx );
+    const StatsBinSpec bins = idx < BACKED_METRICS ? statsBinSpec( id ) : m_registry.info( id )->bins;
+    std::byte *region = m_region != nullptr && idx < BACKED_METRICS ? m_region + idx * regionBytes() : nullptr;
+    m_owned[ idx ] = std::make_unique< MetricSeries >( m_capacity, bins, region, recover );
+    m_series[ idx ].store( m_owned[ idx ].get(), std::memory_order_release );
+    return m_owned[ idx ].get();
+  }
+
+  static int64_t nowMs() noexcept
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::system_clock::now().time_since_epoch() ).count();
+  }
+  static constexpr size_t ROLLUP_WIRE_SIZE = sizeof( int64_t ) + 3 * sizeof( double );
+
+  /// The querySinceBinary() event block; nothing for no events
+  static void appendEventBlock( std::vector< uint8_t > &out, const std::vector< ucc::MetricEventRecord > &events )
+  {
+    if ( events.empty() )
+      return;
+    const uint32_t units = static_cast< uint32_t >( events.size() * ucc::METRIC_EVENT_UNITS );
+    const size_t offset = out.size();
+    out.resize( offset + 1 + sizeof( units ) + events.size() * sizeof( ucc::MetricEventRecord ) );
+    uint8_t *dst = out.data() + offset;
+    *dst++ = ucc::METRIC_EVENT_BLOCK_ID;
+    std::memcpy( dst, &units, sizeof( units ) );
+    std::memcpy( dst + sizeof( units ), events.data(), events.size() * sizeof( ucc::MetricEventRecord ) );
+  }
+
+  /// One querySinceBinary() block; empty series are skipped
+  static void appendBinaryBlock( std::vector< uint8_t > &out, size_t metric,
+                                 const std::vector< MetricDataPoint > &points )
+  {
+    if ( points.empty() )
+      return;
+
+    const uint32_t count = static_cast< uint32_t >( points.size() );
+
+    // --- header: metricId (1 byte) + count (4 bytes) ---
+    const size_t offset = out.size();
+    out.resize( offset + 1 + sizeof( count ) + points.size() * POINT_WIRE_SIZE );
+    uint8_t *dst = out.data() + offset;
+    *dst++ = static_cast< uint8_t >( metric );
+    std::memcpy( dst, &count, sizeof( count ) );
+    dst += sizeof( count );
+
+    // --- data points: int64_t ts + double value (16 bytes each) ---
+    for ( const auto &pt : points )
+    {
+      std::memcpy( dst, &pt.timestampMs, sizeof( pt.timestampMs ) );
+      std::memcpy( dst + sizeof( pt.timestampMs ), &pt.value, sizeof( pt.value ) );
+      dst += POINT_WIRE_SIZE;
+    }
+  }
+
+  /// FNV-1a over everything that determines the on-disk layout
+  static constexpr uint64_t layoutHash( size_t capacityPerMetric ) noexcept
   {
-    const int64_t cutoff = nowMs - m_horizonMs;
-    while ( !buf.empty() && buf.front().timestampMs < cutoff )
-      buf.pop_front();
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h]( uint64_t v ) {
+      for ( int i = 0; i < 8; ++i )
+      {
+        h ^= ( v >> ( 8 * i ) ) & 0xff;
+        h *= 1099511628211ull;
+      }
+    };
+    mix( static_cast< uint64_t >( MetricId::Count ) );
+    mix( capacityPerMetric );
+    for ( const auto &tier : kRollupTiers )
+    {
+      mix( static_cast< uint64_t >( tier.bucketMs ) );
+      mix( static_cast< uint64_t >( tier.horizonMs ) );
+    }
+    return h;
+  }
+
+  /// 0 = raw ring, t = kRollupTiers[ t - 1 ]
+  static size_t selectResolution( const MetricSeries &series, int64_t sinceMs,
+                                  size_t maxPoints ) noexcept
+  {
+    auto fits = [&]( const auto &ring ) {
+      return ring.covers( sinceMs ) && ( maxPoints == 0 || ring.countSince( sinceMs ) <= maxPoints );
+    };
+
+    if ( fits( series.raw() ) )
+      return 0;
+    for ( size_t t = 0; t < MetricSeries::TIER_COUNT; ++t )
+      if ( fits( series.tier( t ) ) )
+        return t + 1;
+    return MetricSeries::TIER_COUNT;
   }
 
-  mutable std::shared_mutex m_mutex;
-  std::array< std::deque< MetricDataPoint >,
-              static_cast< size_t >( MetricId::Count ) > m_buffers;
-  int64_t m_horizonMs = static_cast< int64_t >( DEFAULT_HORIZON_S ) * 1000;
+  MetricRegistry m_registry;
+  size_t m_capacity;
+  MetricsBackingFile m_backing;  ///< Must outlive m_owned
+  std::byte *m_region = nullptr; ///< Built-in series regions in m_backing, if mapped
+  std::mutex m_createMutex;
+  std::array< std::unique_ptr< MetricSeries >, MetricRegistry::MAX_METRICS > m_owned;
+  std::array< std::atomic< MetricSeries * >, MetricRegistry::MAX_METRICS > m_series{};
+  std::atomic< LiveMetricsPublisher * > m_live{ nullptr };
+  std::atomic< AlertEngine * > m_alerts{ nullptr };
+  MetricEventRing m_events;
+  CoreHistoryRing m_cores;
+  std::atomic< int64_t > m_horizonMs{ static_cast< int64_t >( DEFAULT_HORIZON_S ) * 1000 };
 };
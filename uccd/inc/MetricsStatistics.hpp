@@ -0,0 +1,260 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Summary of one metric over a query window.
+ *
+ * Percentiles and the average are time-weighted: each sample stands for the
+ * interval since the previous one, so a burst of fast samples does not skew
+ * them.
+ */
+struct MetricStats
+{
+  uint64_t samples = 0;
+  double seconds = 0.0;       ///< Time covered by the samples
+  double min = 0.0;
+  double max = 0.0;
+  double avg = 0.0;
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+  double secondsAbove = 0.0;  ///< Time spent above the requested threshold
+};
+
+/**
+ * @brief Histogram layout of one metric: StreamingStats::BIN_COUNT bins of
+ *        @c width starting at @c lo.  Values outside are clamped to the
+ *        first / last bin; min and max stay exact.
+ */
+struct StatsBinSpec
+{
+  double lo;
+  double width;
+};
+
+/**
+ * @brief Per-metric streaming aggregates over a sliding two-hour window.
+ *
+ * The window is split into one-minute panes, each holding a fixed-bin
+ * histogram of time spent per value range plus count, sum, min and max.
+ * add() touches exactly one pane (a new minute resets its slot), so updates
+ * are O(1) and allocation-free.  Queries merge the panes back to the
+ * requested start, which bounds their time resolution to one minute and
+ * their value resolution to one bin width.
+ *
+ * Not synchronised; MetricSeries serialises add() and pane copies.
+ */
+class StreamingStats
+{
+public:
+  static constexpr size_t BIN_COUNT = 128;
+  static constexpr size_t PANE_COUNT = 120;
+  static constexpr int64_t PANE_MS = 60'000;
+  static constexpr int64_t WINDOW_MS = PANE_MS * static_cast< int64_t >( PANE_COUNT );
+  static constexpr int64_t DEFAULT_WEIGHT_MS = 1'000;  ///< First sample after start
+  static constexpr int64_t MAX_WEIGHT_MS = 10'000;     ///< Caps gaps (suspend, stalled worker)
+
+  static constexpr int64_t NO_MINUTE = std::numeric_limits< int64_t >::min();
+
+  struct Pane
+  {
+    int64_t minute = NO_MINUTE;  ///< Epoch minute this slot holds
+    uint64_t count = 0;
+    uint64_t weightMs = 0;
+    double sum = 0.0;
+    double weightedSum = 0.0;    ///< Σ value × weight in ms
+    double min = 0.0;
+    double max = 0.0;
+    std::array< uint32_t, BIN_COUNT > binMs{};  ///< Time spent in each bin
+  };
+
+  /**
+   * @brief Reader-side merge of panes into one summary.
+   */
+  class Summary
+  {
+  public:
+    explicit Summary( StatsBinSpec spec ) noexcept : m_spec( spec ) {}
+
+    void merge( const Pane &pane ) noexcept
+    {
+      if ( pane.count == 0 )
+        return;
+      m_min = m_count == 0 ? pane.min : std::min( m_min, pane.min );
+      m_max = m_count == 0 ? pane.max : std::max( m_max, pane.max );
+      m_count += pane.count;
+      m_weightMs += pane.weightMs;
+      m_sum += pane.sum;
+      m_weightedSum += pane.weightedSum;
+      for ( size_t b = 0; b < BIN_COUNT; ++b )
+        m_binMs[ b ] += pane.binMs[ b ];
+    }
+
+    /**
+     * @param threshold Value for MetricStats::secondsAbove; NaN skips it
+     */
+    [[nodiscard]] MetricStats result( double threshold ) const noexcept
+    {
+      MetricStats s;
+      s.samples = m_count;
+      if ( m_count == 0 )
+        return s;
+
+      s.seconds = static_cast< double >( m_weightMs ) / 1000.0;
+      s.min = m_min;
+      s.max = m_max;
+      s.avg = m_weightMs > 0 ? m_weightedSum / static_cast< double >( m_weightMs )
+                             : m_sum / static_cast< double >( m_count );
+      s.p50 = quantile( 0.50 );
+      s.p95 = quantile( 0.95 );
+      s.p99 = quantile( 0.99 );
+      if ( !std::isnan( threshold ) )
+        s.secondsAbove = msAbove( threshold ) / 1000.0;
+      return s;
+    }
+
+  private:
+    /// Linear interpolation inside the bin that crosses q, clamped to [min, max]
+    [[nodiscard]] double quantile( double q ) const noexcept
+    {
+      if ( m_weightMs == 0 )
+        return std::clamp( m_sum / static_cast< double >( m_count ), m_min, m_max );
+
+      const double target = q * static_cast< double >( m_weightMs );
+      double cum = 0.0;
+      for ( size_t b = 0; b < BIN_COUNT; ++b )
+      {
+        const double w = static_cast< double >( m_binMs[ b ] );
+        if ( w > 0.0 && cum + w >= target )
+        {
+          const double v = m_spec.lo + m_spec.width * ( static_cast< double >( b ) + ( target - cum ) / w );
+          return std::clamp( v, m_min, m_max );
+        }
+        cum += w;
+      }
+      return m_max;
+    }
+
+    [[nodiscard]] double msAbove( double threshold ) const noexcept
+    {
+      if ( threshold >= m_max )
+        return 0.0;
+      if ( threshold < m_min )
+        return static_cast< double >( m_weightMs );
+
+      const double pos = ( threshold - m_spec.lo ) / m_spec.width;
+      double ms = 0.0;
+      for ( size_t b = 0; b < BIN_COUNT; ++b )
+      {
+        const double lo = static_cast< double >( b );
+        const double w = static_cast< double >( m_binMs[ b ] );
+        if ( lo >= pos )
+          ms += w;
+        else if ( lo + 1.0 > pos )
+          ms += w * ( lo + 1.0 - pos );
+      }
+      return ms;
+    }
+
+    StatsBinSpec m_spec;
+    uint64_t m_count = 0;
+    uint64_t m_weightMs = 0;
+    double m_sum = 0.0;
+    double m_weightedSum = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+    std::array< uint64_t, BIN_COUNT > m_binMs{};
+  };
+
+  explicit StreamingStats( StatsBinSpec spec ) noexcept : m_spec( spec ) {}
+
+  /**
+   * @brief Fold one sample into the pane of its minute.
+   *
+   * Samples for a minute whose slot has already been reused are dropped.
+   * A sample at or before the previous timestamp (second producer, clock
+   * step) still counts towards count/min/max but carries no time weight.
+   */
+  void add( int64_t timestampMs, double value ) noexcept
+  {
+    if ( !std::isfinite( value ) )
+      return;
+
+    int64_t weight = DEFAULT_WEIGHT_MS;
+    if ( m_lastMs != NO_MINUTE )
+      weight = std::clamp< int64_t >( timestampMs - m_lastMs, 0, MAX_WEIGHT_MS );
+    m_lastMs = std::max( m_lastMs, timestampMs );
+
+    const int64_t minute = minuteOf( timestampMs );
+    Pane &pane = m_panes[ slotOf( minute ) ];
+    if ( pane.minute != minute )
+    {
+      if ( pane.minute != NO_MINUTE && pane.minute > minute )
+        return;
+      pane = Pane{};
+      pane.minute = minute;
+    }
+
+    if ( pane.count == 0 )
+      pane.min = pane.max = value;
+    else
+    {
+      pane.min = std::min( pane.min, value );
+      pane.max = std::max( pane.max, value );
+    }
+    ++pane.count;
+    pane.sum += value;
+    pane.weightMs += static_cast< uint64_t >( weight );
+    pane.weightedSum += value * static_cast< double >( weight );
+    pane.binMs[ binOf( value ) ] += static_cast< uint32_t >( weight );
+  }
+
+  [[nodiscard]] const Pane &pane( size_t slot ) const noexcept { return m_panes[ slot ]; }
+  [[nodiscard]] StatsBinSpec spec() const noexcept { return m_spec; }
+
+  /// Newest timestamp seen, NO_MINUTE before the first sample
+  [[nodiscard]] int64_t lastTimestampMs() const noexcept { return m_lastMs; }
+
+  static constexpr int64_t minuteOf( int64_t timestampMs ) noexcept
+  {
+    return timestampMs / PANE_MS - ( timestampMs % PANE_MS < 0 ? 1 : 0 );
+  }
+
+private:
+  static constexpr size_t slotOf( int64_t minute ) noexcept
+  {
+    const int64_t n = static_cast< int64_t >( PANE_COUNT );
+    return static_cast< size_t >( ( minute % n + n ) % n );
+  }
+
+  [[nodiscard]] size_t binOf( double value ) const noexcept
+  {
+    const double b = std::floor( ( value - m_spec.lo ) / m_spec.width );
+    return static_cast< size_t >( std::clamp( b, 0.0, static_cast< double >( BIN_COUNT - 1 ) ) );
+  }
+
+  StatsBinSpec m_spec;
+  int64_t m_lastMs = NO_MINUTE;
+  std::array< Pane, PANE_COUNT > m_panes{};
+};
@@ -0,0 +1,190 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PersistQueue.hpp"
+
+/// What NvmlWrapper learns about a GPU's overclocking support at startup
+struct NvmlProbeResult
+{
+  /// Supported P-states, in driver order
+  std::vector< unsigned int > pstates;
+  /// clockType * 100 + pstate → whether an offset write was accepted
+  std::map< int, bool > writableOffsets;
+
+  bool operator==( const NvmlProbeResult & ) const = default;
+};
+
+/// Identity of a GPU as far as its probe results are concerned
+struct NvmlGpuIdentity
+{
+  std::string uuid;
+  std::string vbios;
+};
+
+/**
+ * @brief NVML capability probe results kept across daemon restarts.
+ *
+ * Probing costs a trial offset write per clock and P-state on every GPU,
+ * on every daemon start and resume.  The answers only change with the
+ * driver or the hardware, so they are stored under the NVML driver
+ * version and each GPU's UUID and VBIOS version; a different driver drops
+ * every GPU, a different VBIOS drops that GPU.
+ *
+ * File format: "ucc-nvml-probe 1", "driver\t<version>", then per GPU a line
+ * "@\t<uuid>\t<vbios>" followed by "pstates\t<p> <p> ..." and
+ * "offsets\t<key>=<0|1> ...".
+ *
+ * Not thread-safe: NvmlWrapper::initOcFeatures() is its only user.
+ */
+class NvmlProbeCache
+{
+public:
+  static constexpr const char *DEFAULT_PATH = "/var/cache/ucc/nvml-probe";
+
+  explicit NvmlProbeCache( std::string cachePath = DEFAULT_PATH ) : m_cachePath( std::move( cachePath ) ) {}
+
+  /// Results stored for @p gpu under @p driverVersion; nullopt means probe it
+  [[nodiscard]] std::optional< NvmlProbeResult > find( const std::string &driverVersion,
+                                                       const NvmlGpuIdentity &gpu )
+  {
+    load();
+    if ( driverVersion != m_driverVersion )
+      return std::nullopt;
+    const auto it = m_gpus.find( gpu.uuid );
+    if ( it == m_gpus.end() || it->second.vbios != gpu.vbios )
+      return std::nullopt;
+    return it->second.result;
+  }
+
+  /// Remember @p result for @p gpu and write the file; fields with tabs or newlines are not cached
+  void store( const std::string &driverVersion, const NvmlGpuIdentity &gpu, NvmlProbeResult result )
+  {
+    if ( !storable( driverVersion ) || !storable( gpu.uuid ) || !storable( gpu.vbios ) || gpu.uuid.empty() )
+      return;
+    load();
+    if ( driverVersion != m_driverVersion )
+    {
+      m_driverVersion = driverVersion;
+      m_gpus.clear();
+    }
+    m_gpus[ gpu.uuid ] = Entry{ gpu.vbios, std::move( result ) };
+    save();
+  }
+
+private:
+  static constexpr const char *MAGIC = "ucc-nvml-probe 1";
+
+  struct Entry
+  {
+    std::string vbios;
+    NvmlProbeResult result;
+  };
+
+  static bool storable( const std::string &field ) { return field.find_first_of( "\t\n" ) == std::string::npos; }
+
+  /// Read the cache file once; a damaged one is ignored and rewritten after the next probe
+  void load()
+  {
+    if ( m_loaded )
+      return;
+    m_loaded = true;
+
+    std::ifstream in( m_cachePath );
+    std::string line;
+    if ( !std::getline( in, line ) || line != MAGIC || !std::getline( in, line ) || !line.starts_with( "driver\t" ) )
+      return;
+    std::string driverVersion = line.substr( 7 );
+
+    std::map< std::string, Entry > gpus;
+    Entry *entry = nullptr;
+    try
+    {
+      while ( std::getline( in, line ) )
+      {
+        if ( line.starts_with( "@\t" ) )
+        {
+          const auto tab = line.find( '\t', 2 );
+          if ( tab == std::string::npos )
+            return;
+          entry = &gpus[ line.substr( 2, tab - 2 ) ];
+          entry->vbios = line.substr( tab + 1 );
+        }
+        else if ( entry && line.starts_with( "pstates\t" ) )
+        {
+          std::istringstream values( line.substr( 8 ) );
+          for ( std::string value; values >> value; )
+            entry->result.pstates.push_back( static_cast< unsigned int >( std::stoul( value ) ) );
+        }
+        else if ( entry && line.starts_with( "offsets\t" ) )
+        {
+          std::istringstream values( line.substr( 8 ) );
+          for ( std::string value; values >> value; )
+          {
+            const auto eq = value.find( '=' );
+            if ( eq == std::string::npos || eq + 2 != value.size() )
+              return;
+            entry->result.writableOffsets[ std::stoi( value.substr( 0, eq ) ) ] = value[ eq + 1 ] == '1';
+          }
+        }
+        else
+        {
+          return;
+        }
+      }
+    }
+    catch ( const std::exception & )
+    {
+      return;
+    }
+    m_driverVersion = std::move( driverVersion );
+    m_gpus = std::move( gpus );
+  }
+
+  void save() const
+  {
+    std::string content = std::string( MAGIC ) + "\ndriver\t" + m_driverVersion + '\n';
+    for ( const auto &[ uuid, entry ] : m_gpus )
+    {
+      content += "@\t" + uuid + '\t' + entry.vbios + "\npstates\t";
+      for ( size_t i = 0; i < entry.result.pstates.size(); ++i )
+        content += ( i ? " " : "" ) + std::to_string( entry.result.pstates[ i ] );
+      content += "\noffsets\t";
+      bool first = true;
+      for ( const auto &[ key, writable ] : entry.result.writableOffsets )
+      {
+        content += ( first ? "" : " " ) + std::to_string( key ) + ( writable ? "=1" : "=0" );
+        first = false;
+      }
+      content += '\n';
+    }
+    // best effort: a cache that cannot be written only costs the next probe
+    (void)writeFileDurably( m_cachePath, content, 0644 );
+  }
+
+  std::string m_cachePath;
+  bool m_loaded = false;
+  std::string m_driverVersion;
+  std::map< std::string, Entry > m_gpus;
+};
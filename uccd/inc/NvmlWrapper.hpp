@@ -15,14 +15,19 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <dlfcn.h>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "NvmlProbeCache.hpp"
+
 /**
  * @brief Minimal NVML type definitions for dlopen-based access.
  *
@@ -110,6 +115,67 @@ static constexpr nvmlClocksThrottleReasons_t NVML_CLOCKS_THROTTLE_REASON_HW_THER
 static constexpr nvmlClocksThrottleReasons_t NVML_CLOCKS_THROTTLE_REASON_HW_POWER_BRAKE_SLOWDOWN = 0x0000000000000080ULL;
 static constexpr nvmlClocksThrottleReasons_t NVML_CLOCKS_THROTTLE_REASON_DISPLAY_CLOCK_SETTING = 0x0000000000000100ULL;
 
+/// Field identifiers for nvmlDeviceGetFieldValues (values in milliwatts)
+static constexpr unsigned int NVML_FI_DEV_POWER_INSTANT = 186;
+static constexpr unsigned int NVML_FI_DEV_POWER_MAX_LIMIT = 188;
+static constexpr unsigned int NVML_FI_DEV_POWER_CURRENT_LIMIT = 190;
+
+enum nvmlValueType_t : unsigned int
+{
+  NVML_VALUE_TYPE_DOUBLE = 0,
+  NVML_VALUE_TYPE_UNSIGNED_INT = 1,
+  NVML_VALUE_TYPE_UNSIGNED_LONG = 2,
+  NVML_VALUE_TYPE_UNSIGNED_LONG_LONG = 3,
+  NVML_VALUE_TYPE_SIGNED_LONG_LONG = 4,
+  NVML_VALUE_TYPE_SIGNED_INT = 5,
+  NVML_VALUE_TYPE_UNSIGNED_SHORT = 6,
+};
+
+union nvmlValue_t
+{
+  double dVal;
+  int siVal;
+  unsigned int uiVal;
+  unsigned long ulVal;
+  unsigned long long ullVal;
+  signed long long sllVal;
+  unsigned short usVal;
+};
+
+/// Driver-side sample buffers read by nvmlDeviceGetSamples
+enum nvmlSamplingType_t : unsigned int
+{
+  NVML_TOTAL_POWER_SAMPLES = 0,        ///< mW
+  NVML_GPU_UTILIZATION_SAMPLES = 1,    ///< %
+  NVML_MEMORY_UTILIZATION_SAMPLES = 2, ///< %
+  NVML_ENC_UTILIZATION_SAMPLES = 3,
+  NVML_DEC_UTILIZATION_SAMPLES = 4,
+  NVML_PROCESSOR_CLK_SAMPLES = 5,      ///< MHz
+  NVML_MEMORY_CLK_SAMPLES = 6,         ///< MHz
+};
+
+static constexpr nvmlReturn_t NVML_ERROR_NOT_FOUND = 6;
+static constexpr nvmlReturn_t NVML_ERROR_INSUFFICIENT_SIZE = 7;
+
+/// One request/result slot of nvmlDeviceGetFieldValues
+struct nvmlFieldValue_t
+{
+  unsigned int fieldId;
+  unsigned int scopeId;        ///< 0 = whole GPU for the power fields
+  long long timestamp;         ///< CPU timestamp of the reading in µs
+  long long latencyUsec;
+  nvmlValueType_t valueType;
+  nvmlReturn_t nvmlReturn;     ///< Per-field result
+  nvmlValue_t value;
+};
+
+
+struct nvmlSample_t
+{
+  unsigned long long timeStamp;  ///< CPU timestamp in µs
+  nvmlValue_t sampleValue;
+};
+
 } // namespace nvml
 
 /**
@@ -160,6 +226,42 @@ struct NvmlOCState
   bool lockedClocksSupported = false;
 };
 
+/**
+ * @brief One point of an NVML sample buffer.
+ */
+struct NvmlSample
+{
+  int64_t timestampMs;  ///< Unix epoch milliseconds
+  double value;         ///< In the unit of the sampling type (mW, %, MHz)
+};
+
+/**
+ * @brief Live monitoring values of one GPU, read in a single pass.
+ *
+ * Each field is empty when the driver does not report it.
+ */
+struct NvmlTelemetry
+{
+  std::optional< unsigned int > tempC;
+  std::optional< double > powerDrawW;
+  std::optional< double > enforcedPowerLimitW;
+  std::optional< double > powerMaxLimitW;
+  std::optional< unsigned int > gpuClockMHz;
+  std::optional< unsigned int > maxGpuClockMHz;
+  std::optional< unsigned int > memClockMHz;
+  std::optional< unsigned int > coreVoltageMv;
+  std::optional< unsigned int > computeUtilPct;
+  std::optional< unsigned int > memoryUtilPct;
+  std::optional< unsigned int > vramUsedMiB;
+  std::optional< unsigned int > vramTotalMiB;
+  std::optional< std::string > perfLimitReason;
+  std::optional< unsigned int > encoderUtilPct;
+  std::optional< unsigned int > decoderUtilPct;
+  std::optional< unsigned int > currentPstate;
+  std::optional< int > grClockOffsetMHz;
+  std::optional< int > memClockOffsetMHz;
+};
+
 /**
  * @brief Runtime NVML wrapper using dlopen/dlsym.
  *
@@ -186,6 +288,17 @@ public:
    */
   [[nodiscard]] unsigned int deviceCount() const noexcept { return m_deviceCount; }
 
+  /**
+   * @brief Cache the supported P-states and probe which clock offsets are writable.
+   *
+   * Needed by getOCState() and the offset setters only.  The constructor
+   * does it when enableOcFeatures is set; otherwise call this before the
+   * first overclocking request.  Runs once, later calls return at once.
+   * Results are reused from NvmlProbeCache while the driver version and
+   * the GPU's UUID and VBIOS are unchanged.
+   */
+  void initOcFeatures();
+
   /**
    * @brief Read complete OC state for a GPU by index.
    */
@@ -310,6 +423,35 @@ public:
   /** @brief Current memory-clock offset in MHz at the current P-state. */
   [[nodiscard]] std::optional< int > getMemClockOffsetMHz( unsigned int deviceIndex ) const noexcept;
 
+  /**
+   * @brief All live monitoring values of one GPU.
+   *
+   * Equivalent to calling every getter above, but resolves the device
+   * handle once, reads shared NVML structs (utilization, memory, P-state)
+   * once, and fetches the power readings with one nvmlDeviceGetFieldValues
+   * batch on drivers that support it.
+   */
+  [[nodiscard]] NvmlTelemetry getTelemetry( unsigned int deviceIndex ) const noexcept;
+
+  /** @brief Whether the driver exposes nvmlDeviceGetSamples. */
+  [[nodiscard]] bool supportsSampleBuffers() const noexcept { return m_initialized && m_getSamples; }
+
+  /**
+   * @brief Append the driver's buffered samples newer than @p lastSeenUs.
+   *
+   * NVML records power, utilization and clocks internally at a much finer
+   * interval than our polling tick; this returns every point recorded since
+   * the previous call with its original timestamp.  @p lastSeenUs is the
+   * cursor: start at 0 and pass the same variable on every call.
+   *
+   * @return false if the buffer cannot be read (no new samples is success)
+   */
+  bool drainSamples( unsigned int deviceIndex, nvml::nvmlSamplingType_t type,
+                     unsigned long long &lastSeenUs, std::vector< NvmlSample > &out ) const noexcept;
+
+  /** @brief Marketing name of the GPU, e.g. "NVIDIA GeForce RTX 4070 Laptop GPU". */
+  [[nodiscard]] std::optional< std::string > getName( unsigned int deviceIndex ) const noexcept;
+
   /** @brief Returns true if the NVML library was loaded and initialized. */
   bool isInitialized() const { return m_initialized; }
 
@@ -328,6 +470,7 @@ private:
   bool m_initialized = false;
   bool m_nvapiInitialized = false;
   bool m_enableOcFeatures = true;
+  std::once_flag m_ocFeaturesOnce;
   unsigned int m_deviceCount = 0;
   std::vector< void * > m_nvapiGpuHandles;
 
@@ -338,6 +481,9 @@ private:
   std::map< unsigned int, std::map< int /*clockType*pstate*/, bool > > m_writableOffsets;
   std::map< unsigned int, std::vector< nvml::nvmlPstates_t > > m_supportedPstates;
 
+  /// Devices whose driver rejected nvmlDeviceGetFieldValues (per-call fallback)
+  std::unique_ptr< std::atomic< bool >[] > m_fieldValuesUnsupported;
+
   // Function pointer types
   using InitFn = nvml::nvmlReturn_t ( * )();
   using ShutdownFn = nvml::nvmlReturn_t ( * )();
@@ -345,6 +491,9 @@ private:
   using DeviceGetHandleByIndexFn = nvml::nvmlReturn_t ( * )( unsigned int, nvml::nvmlDevice_t* );
   using DeviceGetNameFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, char*, unsigned int );
   using DeviceGetPciBusIdFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, char*, unsigned int );
+  using SystemGetDriverVersionFn = nvml::nvmlReturn_t ( * )( char*, unsigned int );
+  using DeviceGetUUIDFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, char*, unsigned int );
+  using DeviceGetVbiosVersionFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, char*, unsigned int );
   using DeviceGetSupportedPstatesFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, nvml::nvmlPstates_t*, unsigned int );
   using DeviceGetMinMaxClockFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, nvml::nvmlClockType_t, nvml::nvmlPstates_t, unsigned int*, unsigned int* );
   using DeviceGetClockOffsetsFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, nvml::nvmlClockOffset_t* );
@@ -369,6 +518,9 @@ private:
   using DeviceGetCurrentClocksThrottleReasonsFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, nvml::nvmlClocksThrottleReasons_t* );
   using DeviceGetEncoderUtilizationFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, unsigned int*, unsigned int* );
   using DeviceGetDecoderUtilizationFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, unsigned int*, unsigned int* );
+  using DeviceGetFieldValuesFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, int, nvml::nvmlFieldValue_t* );
+  using DeviceGetSamplesFn = nvml::nvmlReturn_t ( * )( nvml::nvmlDevice_t, nvml::nvmlSamplingType_t, unsigned long long,
+                                                       nvml::nvmlValueType_t*, unsigned int*, nvml::nvmlSample_t* );
 
   using NvApiQueryInterfaceFn = void * ( * )( uint32_t );
   using NvApiInitializeFn = int32_t ( * )( void );
@@ -383,6 +535,9 @@ private:
   DeviceGetHandleByIndexFn m_getHandle = nullptr;
   DeviceGetNameFn m_getName = nullptr;
   DeviceGetPciBusIdFn m_getPciBusId = nullptr;
+  SystemGetDriverVersionFn m_getDriverVersion = nullptr;
+  DeviceGetUUIDFn m_getUuid = nullptr;
+  DeviceGetVbiosVersionFn m_getVbiosVersion = nullptr;
   DeviceGetSupportedPstatesFn m_getSupportedPstates = nullptr;
   DeviceGetMinMaxClockFn m_getMinMaxClock = nullptr;
   DeviceGetClockOffsetsFn m_getClockOffsets = nullptr;
@@ -407,6 +562,8 @@ private:
   DeviceGetCurrentClocksThrottleReasonsFn m_getCurrentClocksThrottleReasons = nullptr;
   DeviceGetEncoderUtilizationFn m_getEncoderUtilization = nullptr;
   DeviceGetDecoderUtilizationFn m_getDecoderUtilization = nullptr;
+  DeviceGetFieldValuesFn m_getFieldValues = nullptr;
+  DeviceGetSamplesFn m_getSamples = nullptr;
 
   NvApiQueryInterfaceFn m_nvapiQueryInterface = nullptr;
   NvApiInitializeFn m_nvapiInitialize = nullptr;
@@ -431,7 +588,13 @@ private:
    */
   [[nodiscard]] std::optional< nvml::nvmlDevice_t > getDevice( unsigned int index ) const;
 
-  void cacheSupportedPstates();
+  /// NVML driver version, nullopt if the driver does not report it
+  [[nodiscard]] std::optional< std::string > getDriverVersion() const;
+  /// UUID and VBIOS version of @p deviceIndex, the key of its probe cache entry
+  [[nodiscard]] std::optional< NvmlGpuIdentity > getGpuIdentity( unsigned int deviceIndex ) const;
+
+  /// @return false if the driver could not list the P-states (nothing to cache)
+  bool cacheSupportedPstates( unsigned int deviceIndex );
   void initNvapi();
-  void probeWritableOffsetPstates();
+  void probeWritableOffsetPstates( unsigned int deviceIndex );
 };
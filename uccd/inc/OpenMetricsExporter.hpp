@@ -0,0 +1,283 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include "MetricsHistoryStore.hpp"
+
+/**
+ * @brief Values the exporter needs besides the history store.
+ *
+ * Filled by the service from data that was already sampled (UccDBusData
+ * fans, last NVML reading), so rendering never touches hardware.
+ */
+struct TelemetrySnapshot
+{
+  struct Fan
+  {
+    int64_t speedTimestampMs = 0;  ///< 0 = never sampled
+    int32_t speedPercent = -1;
+    int64_t tempTimestampMs = 0;
+    int32_t tempCelsius = -1;
+  };
+
+  struct Gpu
+  {
+    int computeUtilPct = -1;
+    int memoryUtilPct = -1;
+    int encoderUtilPct = -1;
+    int decoderUtilPct = -1;
+    int vramUsedMiB = -1;
+    int vramTotalMiB = -1;
+    int currentPstate = -1;
+    double enforcedPowerLimitW = -1.0;
+  };
+
+  std::vector< Fan > fans;
+  Gpu gpu;
+};
+
+/**
+ * @brief Renders uccd telemetry in OpenMetrics text format.
+ *
+ * Output is meant for the node_exporter textfile collector: no sample
+ * timestamps (the collector rejects them), and samples older than
+ * @c STALE_MS are left out instead of being reported as current.  The
+ * render buffer is reused, so steady-state rendering does not allocate.
+ */
+class OpenMetricsExporter
+{
+public:
+  static constexpr int64_t STALE_MS = 30'000;
+
+  /**
+   * @brief Render the current values into an internal buffer.
+   * @param nowMs Wall-clock time used for the staleness check
+   */
+  const std::string &render( const MetricsHistoryStore &store, const TelemetrySnapshot &snapshot,
+                             int64_t nowMs )
+  {
+    m_out.clear();
+
+    for ( const auto &def : kStoreMetrics )
+    {
+      if ( def.name == nullptr )
+        continue;
+      const auto pt = store.latest( def.id );
+      if ( !pt || nowMs - pt->timestampMs > STALE_MS )
+        continue;
+      family( def.name, def.unit, def.help );
+      sample( def.name, {}, pt->value * def.scale );
+    }
+
+    bool any = false;
+    for ( size_t i = 0; i < snapshot.fans.size(); ++i )
+    {
+      const auto &fan = snapshot.fans[ i ];
+      if ( fan.speedTimestampMs == 0 || nowMs - fan.speedTimestampMs > STALE_MS || fan.speedPercent < 0 )
+        continue;
+      if ( !any )
+        family( "ucc_fan_duty_percent", "percent", "Fan duty cycle per fan." );
+      any = true;
+      sample( "ucc_fan_duty_percent", fanLabel( i ), fan.speedPercent );
+    }
+
+    any = false;
+    for ( size_t i = 0; i < snapshot.fans.size(); ++i )
+    {
+      const auto &fan = snapshot.fans[ i ];
+      if ( fan.tempTimestampMs == 0 || nowMs - fan.tempTimestampMs > STALE_MS || fan.tempCelsius < 0 )
+        continue;
+      if ( !any )
+        family( "ucc_fan_sensor_temperature_celsius", "celsius", "Temperature of the sensor driving each fan." );
+      any = true;
+      sample( "ucc_fan_sensor_temperature_celsius", fanLabel( i ), fan.tempCelsius );
+    }
+
+    const auto &gpu = snapshot.gpu;
+    const std::array< std::pair< std::string_view, int >, 4 > engines{ {
+      { "compute", gpu.computeUtilPct }, { "memory", gpu.memoryUtilPct },
+      { "encoder", gpu.encoderUtilPct }, { "decoder", gpu.decoderUtilPct } } };
+    any = false;
+    for ( const auto &[engine, pct] : engines )
+    {
+      if ( pct < 0 )
+        continue;
+      if ( !any )
+        family( "ucc_gpu_utilization_percent", "percent", "NVIDIA dGPU engine utilization." );
+      any = true;
+      m_label.assign( "engine=\"" ).append( engine ).push_back( '"' );
+      sample( "ucc_gpu_utilization_percent", m_label, pct );
+    }
+
+    if ( gpu.vramUsedMiB >= 0 )
+    {
+      family( "ucc_gpu_vram_used_bytes", "bytes", "NVIDIA dGPU VRAM in use." );
+      sample( "ucc_gpu_vram_used_bytes", {}, static_cast< double >( gpu.vramUsedMiB ) * MIB );
+    }
+    if ( gpu.vramTotalMiB >= 0 )
+    {
+      family( "ucc_gpu_vram_total_bytes", "bytes", "NVIDIA dGPU VRAM size." );
+      sample( "ucc_gpu_vram_total_bytes", {}, static_cast< double >( gpu.vramTotalMiB ) * MIB );
+    }
+    if ( gpu.currentPstate >= 0 )
+    {
+      family( "ucc_gpu_pstate", {}, "NVIDIA dGPU performance state (0 = fastest)." );
+      sample( "ucc_gpu_pstate", {}, gpu.currentPstate );
+    }
+    if ( gpu.enforcedPowerLimitW >= 0.0 )
+    {
+      family( "ucc_gpu_power_limit_watts", "watts", "NVIDIA dGPU enforced power limit." );
+      sample( "ucc_gpu_power_limit_watts", {}, gpu.enforcedPowerLimitW );
+    }
+
+    m_out.append( "# EOF\n" );
+    return m_out;
+  }
+
+  /**
+   * @brief Atomically replace @p path with @p content (write temp + rename).
+   */
+  static bool writeTextfile( const std::string &path, std::string_view content ) noexcept
+  {
+    const std::string tmp = path + ".tmp";
+    const int fd = ::open( tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if ( fd < 0 )
+    {
+      syslog( LOG_WARNING, "OpenMetricsExporter: cannot open %s: %s", tmp.c_str(), strerror( errno ) );
+      return false;
+    }
+
+    size_t done = 0;
+    while ( done < content.size() )
+    {
+      const ssize_t n = ::write( fd, content.data() + done, content.size() - done );
+      if ( n < 0 && errno == EINTR )
+        continue;
+      if ( n <= 0 )
+        break;
+      done += static_cast< size_t >( n );
+    }
+    ::close( fd );
+
+    if ( done != content.size() || ::rename( tmp.c_str(), path.c_str() ) != 0 )
+    {
+      syslog( LOG_WARNING, "OpenMetricsExporter: cannot write %s: %s", path.c_str(), strerror( errno ) );
+      ::unlink( tmp.c_str() );
+      return false;
+    }
+    return true;
+  }
+
+private:
+  struct StoreMetric
+  {
+    MetricId id;
+    const char *name;
+    const char *unit;
+    const char *help;
+    double scale;  ///< Store unit → base unit
+  };
+
+  static constexpr double MIB = 1024.0 * 1024.0;
+
+  static constexpr std::array< StoreMetric, static_cast< size_t >( MetricId::Count ) > kStoreMetrics{ {
+    { MetricId::CpuTemp,          "ucc_cpu_temperature_celsius", "celsius", "CPU temperature.", 1.0 },
+    { MetricId::CpuFanDuty,       "ucc_cpu_fan_duty_percent",    "percent", "CPU fan duty cycle.", 1.0 },
+    { MetricId::CpuPower,         "ucc_cpu_power_watts",         "watts",   "CPU package power.", 1.0 },
+    { MetricId::CpuFrequency,     "ucc_cpu_frequency_hertz",     "hertz",   "Average CPU core frequency.", 1e6 },
+    { MetricId::GpuTemp,          "ucc_gpu_temperature_celsius", "celsius", "GPU temperature.", 1.0 },
+    { MetricId::GpuFanDuty,       "ucc_gpu_fan_duty_percent",    "percent", "GPU fan duty cycle.", 1.0 },
+    { MetricId::GpuPower,         "ucc_gpu_power_watts",         "watts",   "NVIDIA dGPU power draw.", 1.0 },
+    { MetricId::GpuFrequency,     "ucc_gpu_frequency_hertz",     "hertz",   "NVIDIA dGPU core clock.", 1e6 },
+    { MetricId::GpuVramFrequency, "ucc_gpu_vram_frequency_hertz", "hertz",  "NVIDIA dGPU memory clock.", 1e6 },
+    { MetricId::GpuCoreVoltage,   "ucc_gpu_core_voltage_volts",  "volts",   "NVIDIA dGPU core voltage.", 1e-3 },
+    { MetricId::Gpu2Temp,         "ucc_gpu2_temperature_celsius", "celsius", "Second NVIDIA GPU temperature.", 1.0 },
+    { MetricId::Gpu2Power,        "ucc_gpu2_power_watts",        "watts",   "Second NVIDIA GPU power draw.", 1.0 },
+    { MetricId::Gpu2Frequency,    "ucc_gpu2_frequency_hertz",    "hertz",   "Second NVIDIA GPU core clock.", 1e6 },
+    // Exported with the other engines in ucc_gpu_utilization_percent
+    { MetricId::GpuComputeUtil,   nullptr, nullptr, nullptr, 1.0 },
+    { MetricId::GpuMemoryUtil,    nullptr, nullptr, nullptr, 1.0 },
+    { MetricId::CpuPowerCore,     "ucc_cpu_core_power_watts",    "watts",   "CPU cores power (RAPL core domain).", 1.0 },
+    { MetricId::CpuPowerUncore,   "ucc_cpu_uncore_power_watts",  "watts",   "CPU uncore and iGPU power (RAPL uncore domain).", 1.0 },
+    { MetricId::CpuPowerDram,     "ucc_dram_power_watts",        "watts",   "Memory power (RAPL dram domain).", 1.0 },
+    { MetricId::CpuPowerPsys,     "ucc_platform_power_watts",    "watts",   "Platform power (RAPL psys domain).", 1.0 },
+    { MetricId::CpuFrequencyMax,  "ucc_cpu_frequency_max_hertz", "hertz",   "Fastest CPU core frequency.", 1e6 },
+    { MetricId::CpuFrequencyPCore, "ucc_cpu_pcore_frequency_hertz", "hertz", "Average performance-core frequency.", 1e6 },
+    { MetricId::CpuFrequencyECore, "ucc_cpu_ecore_frequency_hertz", "hertz", "Average efficiency-core frequency.", 1e6 },
+    { MetricId::CpuThrottleCore,  "ucc_cpu_core_throttle_percent", "percent", "Share of time the most throttled core was thermally throttled.", 1.0 },
+    { MetricId::CpuThrottlePackage, "ucc_cpu_package_throttle_percent", "percent", "Share of time the CPU package was thermally throttled.", 1.0 },
+    { MetricId::CpuPowerLimited,  "ucc_cpu_power_limited_percent", "percent", "Share of samples with package power at a RAPL limit.", 1.0 },
+    { MetricId::CpuPkgCstate,     "ucc_cpu_package_cstate_percent", "percent", "Package C-state residency.", 1.0 },
+    { MetricId::WaterCoolerFanDuty, "ucc_water_cooler_fan_duty_percent", "percent", "Water cooler fan duty cycle.", 1.0 },
+    { MetricId::WaterCoolerPumpLevel, "ucc_water_cooler_pump_level_percent", "percent", "Water cooler pump voltage, share of the 12 V level.", 1.0 },
+    { MetricId::WaterCoolerRssi,  "ucc_water_cooler_rssi_dbm",   "dbm",     "Water cooler BLE link RSSI.", 1.0 },
+    { MetricId::WaterCoolerLatency, "ucc_water_cooler_command_latency_seconds", "seconds", "Time a water cooler BLE command waited before it was written.", 1e-3 },
+    { MetricId::BatteryPower,     "ucc_battery_power_watts",     "watts",   "Battery charge or discharge rate.", 1.0 },
+    { MetricId::BatteryVoltage,   "ucc_battery_voltage_volts",   "volts",   "Battery voltage.", 1.0 },
+    { MetricId::BatteryEnergy,    "ucc_battery_energy_joules",   "joules",  "Energy left in the battery.", 3600.0 },
+    { MetricId::BatteryCapacity,  "ucc_battery_capacity_percent", "percent", "Battery charge level.", 1.0 },
+    { MetricId::BatteryTimeToEmpty, "ucc_battery_time_to_empty_seconds", "seconds", "Battery runtime left at the current discharge rate.", 60.0 },
+    { MetricId::SystemPowerOnBattery, "ucc_system_power_on_battery_watts", "watts", "Whole-system power draw while running on battery.", 1.0 },
+  } };
+
+  void family( std::string_view name, std::string_view unit, std::string_view help )
+  {
+    m_out.append( "# TYPE " ).append( name ).append( " gauge\n" );
+    if ( !unit.empty() )
+      m_out.append( "# UNIT " ).append( name ).append( " " ).append( unit ).push_back( '\n' );
+    m_out.append( "# HELP " ).append( name ).append( " " ).append( help ).push_back( '\n' );
+  }
+
+  void sample( std::string_view name, std::string_view labels, double value )
+  {
+    m_out.append( name );
+    if ( !labels.empty() )
+      m_out.append( "{" ).append( labels ).push_back( '}' );
+    m_out.push_back( ' ' );
+
+    // Whole numbers (clocks in Hz, byte counts) read better without an exponent
+    char buf[ 32 ];
+    const auto res = std::trunc( value ) == value && std::abs( value ) < 1e15
+      ? std::to_chars( buf, buf + sizeof( buf ), static_cast< int64_t >( value ) )
+      : std::to_chars( buf, buf + sizeof( buf ), value );
+    m_out.append( buf, static_cast< size_t >( res.ptr - buf ) );
+    m_out.push_back( '\n' );
+  }
+
+  const std::string &fanLabel( size_t index )
+  {
+    char buf[ 24 ];
+    const auto res = std::to_chars( buf, buf + sizeof( buf ), index );
+    m_label.assign( "fan=\"" ).append( buf, static_cast< size_t >( res.ptr - buf ) ).push_back( '"' );
+    return m_label;
+  }
+
+  std::string m_out;
+  std::string m_label;
+};
@@ -0,0 +1,65 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "DrmDisplayModes.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+/**
+ * @brief Refresh rate of the internal panel for the power situation
+ *
+ * Stays at the active resolution and picks among its rates: the lowest
+ * while saving (on battery, or while the session is idle), otherwise the
+ * one closest to the profile's rate, or the highest if the profile sets
+ * none.  A high refresh panel (165/240 Hz) draws noticeably less at 60 Hz,
+ * and so does the GPU that scans it out.
+ */
+struct PanelRefreshPolicy
+{
+  /// Rates closer than this are the same rate
+  static constexpr double TOLERANCE_HZ = 0.1;
+
+  /**
+   * @return The rate to run at, nullopt if the active mode is unknown
+   * @param profileRate The profile's rate in Hz, 0 or less for none
+   */
+  [[nodiscard]] static std::optional< double > target( const DisplayInfo &info, bool saving, int profileRate )
+  {
+    const auto mode = std::find_if( info.displayModes.begin(), info.displayModes.end(), [ &info ]( const DisplayMode &m ) {
+      return m.xResolution == info.activeMode.xResolution and m.yResolution == info.activeMode.yResolution;
+    } );
+    if ( mode == info.displayModes.end() or mode->refreshRates.empty() )
+      return std::nullopt;
+
+    const auto &rates = mode->refreshRates;
+    if ( saving )
+      return *std::min_element( rates.begin(), rates.end() );
+    if ( profileRate <= 0 )
+      return *std::max_element( rates.begin(), rates.end() );
+    return *std::min_element( rates.begin(), rates.end(), [ profileRate ]( double a, double b ) {
+      return std::abs( a - profileRate ) < std::abs( b - profileRate );
+    } );
+  }
+
+  /// Whether the panel runs at @p rate already
+  [[nodiscard]] static bool isActive( const DisplayInfo &info, double rate ) noexcept
+  {
+    return not info.activeMode.refreshRates.empty()
+           and std::abs( info.activeMode.refreshRates[ 0 ] - rate ) < TOLERANCE_HZ;
+  }
+};
@@ -0,0 +1,232 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <sys/stat.h>
+
+#include "PersistQueue.hpp"
+
+/**
+ * @brief Name of PCI device @p vendor:@p device in a pci.ids database.
+ *
+ * The file uses a simple text format:
+ *   VVVV  Vendor Name          (vendor line, no indent, 4-digit lowercase hex)
+ *   \tDDDD  Device Name        (device line, one tab indent, under that vendor)
+ *
+ * @return Empty if the device is not listed
+ */
+[[nodiscard]] inline std::string scanPciIds( std::istream &in, unsigned vendor, unsigned device )
+{
+  // Format vendor/device as lowercase 4-digit hex for matching
+  char vendorHex[ 5 ], deviceHex[ 5 ];
+  std::snprintf( vendorHex, sizeof( vendorHex ), "%04x", vendor & 0xffffu );
+  std::snprintf( deviceHex, sizeof( deviceHex ), "%04x", device & 0xffffu );
+
+  bool inVendor = false;
+  std::string line;
+  while ( std::getline( in, line ) )
+  {
+    // Skip comments and empty lines
+    if ( line.empty() || line[ 0 ] == '#' )
+      continue;
+
+    // Vendor line: starts with hex digit at column 0
+    if ( line[ 0 ] != '\t' )
+    {
+      if ( line.size() >= 4 && line.compare( 0, 4, vendorHex ) == 0 )
+        inVendor = true;
+      else if ( inVendor )
+        break;  // Passed our vendor section, stop searching
+      continue;
+    }
+
+    // Device line: tab + 4-digit hex + spaces + name
+    if ( inVendor && line.size() >= 6 && line[ 1 ] != '\t' && line.compare( 1, 4, deviceHex ) == 0 )
+    {
+      const auto nameStart = line.find_first_not_of( " \t", 5 );
+      if ( nameStart == std::string::npos )
+        return {};
+      const auto nameEnd = line.find_last_not_of( " \t\r\n" );
+      return line.substr( nameStart, nameEnd - nameStart + 1 );
+    }
+  }
+  return {};
+}
+
+/**
+ * @brief pci.ids lookups kept across daemon restarts.
+ *
+ * Each GPU name would otherwise cost every daemon start a scan of the
+ * >1 MB text database.  The cache file
+ * holds every answer, "not listed" included, under the size and mtime of
+ * the database it came from; a database that changed drops its answers.
+ *
+ * File format: "ucc-pci-names 1", then per database a line
+ * "@\t<path>\t<size>\t<mtime ns>" followed by one "vvvvdddd\t<name>" line
+ * per device looked up in it.
+ *
+ * Not thread-safe: SystemInfo detection is its only user.
+ */
+class PciNameCache
+{
+public:
+  /// Identity of a pci.ids file; a changed one invalidates its answers
+  struct Source
+  {
+    std::string path;
+    int64_t size = 0;
+    int64_t mtimeNs = 0;
+
+    bool operator==( const Source & ) const = default;
+  };
+
+  static constexpr const char *DEFAULT_PATH = "/var/cache/ucc/pci-names";
+
+  explicit PciNameCache( std::string cachePath = DEFAULT_PATH ) : m_cachePath( std::move( cachePath ) ) {}
+
+  /// @p path's identity, nullopt if it is not a regular file
+  [[nodiscard]] static std::optional< Source > identify( const std::string &path )
+  {
+    struct stat st{};
+    if ( ::stat( path.c_str(), &st ) != 0 || !S_ISREG( st.st_mode ) )
+      return std::nullopt;
+    return Source{ path, static_cast< int64_t >( st.st_size ),
+                   static_cast< int64_t >( st.st_mtim.tv_sec ) * 1'000'000'000 + st.st_mtim.tv_nsec };
+  }
+
+  /**
+   * @brief Name of @p vendor:@p device in @p source, scanning it only on a cache miss.
+   * @return Empty if the device is not listed or @p source cannot be read
+   */
+  [[nodiscard]] std::string lookup( const Source &source, unsigned vendor, unsigned device )
+  {
+    load();
+    const uint32_t key = ( ( vendor & 0xffffu ) << 16 ) | ( device & 0xffffu );
+    Database &db = m_databases[ source.path ];
+    if ( db.source == source )
+    {
+      if ( const auto it = db.names.find( key ); it != db.names.end() )
+      {
+        ++m_hits;
+        return it->second;
+      }
+    }
+    else
+    {
+      db = Database{ source, {} };
+    }
+
+    std::ifstream in( source.path );
+    if ( !in.is_open() )
+      return {};
+    ++m_scans;
+    std::string name = scanPciIds( in, vendor, device );
+    db.names[ key ] = name;
+    save();
+    return name;
+  }
+
+  [[nodiscard]] uint64_t hits() const noexcept { return m_hits; }
+  /// Lookups that had to read a database
+  [[nodiscard]] uint64_t scans() const noexcept { return m_scans; }
+
+private:
+  static constexpr const char *MAGIC = "ucc-pci-names 1";
+
+  struct Database
+  {
+    Source source;
+    std::map< uint32_t, std::string > names;
+  };
+
+  /// Read the cache file once; a damaged one is ignored and rewritten on the next miss
+  void load()
+  {
+    if ( m_loaded )
+      return;
+    m_loaded = true;
+
+    std::ifstream in( m_cachePath );
+    std::string line;
+    if ( !std::getline( in, line ) || line != MAGIC )
+      return;
+
+    std::map< std::string, Database > databases;
+    Database *db = nullptr;
+    try
+    {
+      while ( std::getline( in, line ) )
+      {
+        if ( line.starts_with( "@\t" ) )
+        {
+          std::istringstream header( line.substr( 2 ) );
+          std::string path, size, mtime;
+          if ( !std::getline( header, path, '\t' ) || !std::getline( header, size, '\t' )
+               || !std::getline( header, mtime ) )
+            return;
+          db = &databases[ path ];
+          db->source = Source{ path, std::stoll( size ), std::stoll( mtime ) };
+          continue;
+        }
+        if ( !db || line.size() < 9 || line[ 8 ] != '\t' )
+          return;
+        db->names[ static_cast< uint32_t >( std::stoul( line.substr( 0, 8 ), nullptr, 16 ) ) ] = line.substr( 9 );
+      }
+    }
+    catch ( const std::exception & )
+    {
+      return;
+    }
+    m_databases = std::move( databases );
+  }
+
+  void save() const
+  {
+    std::string content = std::string( MAGIC ) + '\n';
+    char key[ 9 ];
+    for ( const auto &[ path, db ] : m_databases )
+    {
+      content += "@\t" + path + '\t' + std::to_string( db.source.size ) + '\t'
+                 + std::to_string( db.source.mtimeNs ) + '\n';
+      for ( const auto &[ id, name ] : db.names )
+      {
+        std::snprintf( key, sizeof( key ), "%08x", id );
+        content += key;
+        content += '\t';
+        content += name;
+        content += '\n';
+      }
+    }
+    // best effort: a cache that cannot be written only costs the next scan
+    (void)writeFileDurably( m_cachePath, content, 0644 );
+  }
+
+  std::string m_cachePath;
+  bool m_loaded = false;
+  std::map< std::string, Database > m_databases;
+  uint64_t m_hits = 0;
+  uint64_t m_scans = 0;
+};
@@ -0,0 +1,357 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QSocketNotifier>
+#include <QString>
+#include <QTimer>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "PeerChannelProtocol.hpp"
+
+/**
+ * @brief The bus caller a peer channel connection acts for.
+ */
+struct PeerCaller
+{
+  QString sender;    ///< Unique bus name that requested the channel
+  uint32_t pid = 0;  ///< SO_PEERCRED of the socket
+  uint32_t uid = 0;
+};
+
+/**
+ * @brief Unix socket server of the private peer channel (see PeerChannelProtocol.hpp).
+ *
+ * Listens in the abstract namespace once the first client asks for it.
+ * A connection is only served after HELLO with a token from issueToken();
+ * tokens are single-use, expire after TOKEN_TTL_MS and must be presented
+ * by a process of the uid they were issued to.  Requests are dispatched
+ * synchronously on the thread that owns the notifiers (the main thread),
+ * i.e. like D-Bus method calls.
+ *
+ * Until HELLO a connection may send MAX_HELLO_BYTES per frame and has
+ * AUTH_TIMEOUT_MS to do so, so idle or oversized strangers cannot hold
+ * the MAX_CLIENTS slots or the daemon's memory.  Replies are written
+ * without blocking: what the socket does not take is queued and sent as
+ * it becomes writable.  One reply is in flight per connection; the next
+ * request is only read once it is out, and a reply that does not drain
+ * within SEND_TIMEOUT_MS drops the connection.
+ */
+class PeerChannelServer
+{
+public:
+  using Dispatch = std::function< std::optional< QVariant >( const PeerCaller &caller, const QString &method,
+                                                             const QVariantList &args, QString &error ) >;
+
+  static constexpr int64_t TOKEN_TTL_MS = 10000;
+  static constexpr size_t MAX_CLIENTS = 16;
+  static constexpr int AUTH_TIMEOUT_MS = 2000;
+  static constexpr int SEND_TIMEOUT_MS = 5000;
+
+  explicit PeerChannelServer( Dispatch dispatch ) : m_dispatch( std::move( dispatch ) ) {}
+  ~PeerChannelServer() { stop(); }
+
+  PeerChannelServer( const PeerChannelServer & ) = delete;
+  PeerChannelServer &operator=( const PeerChannelServer & ) = delete;
+
+  /// Start listening (no-op when already listening); false if the socket cannot be created
+  bool listen()
+  {
+    if ( m_listenFd >= 0 )
+      return true;
+
+    const int fd = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0 );
+    if ( fd < 0 )
+      return false;
+
+    std::random_device random;
+    const std::string name = "uccd-peer-" + std::to_string( ::getpid() ) + "-" + std::to_string( random() );
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::copy( name.begin(), name.end(), addr.sun_path + 1 );  // leading NUL: abstract namespace
+    const auto len = static_cast< socklen_t >( offsetof( sockaddr_un, sun_path ) + 1 + name.size() );
+    if ( ::bind( fd, reinterpret_cast< sockaddr * >( &addr ), len ) < 0 || ::listen( fd, 8 ) < 0 )
+    {
+      ::close( fd );
+      return false;
+    }
+
+    m_listenFd = fd;
+    m_address = QString::fromLatin1( ucc::peer::ABSTRACT_PREFIX ) + QString::fromStdString( name );
+    m_listenNotifier = std::make_unique< QSocketNotifier >( fd, QSocketNotifier::Read );
+    QObject::connect( m_listenNotifier.get(), &QSocketNotifier::activated, [this]() { acceptClients(); } );
+    return true;
+  }
+
+  void stop()
+  {
+    m_clients.clear();
+    m_listenNotifier.reset();
+    if ( m_listenFd >= 0 )
+      ::close( m_listenFd );
+    m_listenFd = -1;
+    m_address.clear();
+  }
+
+  [[nodiscard]] QString address() const { return m_address; }
+
+  /// Single-use token for a connection of @p uid acting for bus name @p sender
+  QByteArray issueToken( const QString &sender, uint32_t uid )
+  {
+    expireTokens();
+    std::random_device random;
+    QByteArray token( 32, '\0' );
+    for ( auto &byte : token )
+      byte = static_cast< char >( random() & 0xFF );
+    m_tokens[ token ] = Token{ sender, uid, nowMs() };
+    return token;
+  }
+
+  /// Close every connection acting for @p sender (it left the bus)
+  void dropSender( const QString &sender )
+  {
+    for ( auto it = m_tokens.begin(); it != m_tokens.end(); )
+      it = it->second.sender == sender ? m_tokens.erase( it ) : std::next( it );
+    for ( auto it = m_clients.begin(); it != m_clients.end(); )
+      it = it->second->caller.sender == sender ? m_clients.erase( it ) : std::next( it );
+  }
+
+  [[nodiscard]] size_t clients() const noexcept { return m_clients.size(); }
+
+private:
+  struct Token
+  {
+    QString sender;
+    uint32_t uid = 0;
+    int64_t issuedMs = 0;
+  };
+
+  struct Client
+  {
+    int fd = -1;
+    std::unique_ptr< QSocketNotifier > reader;
+    std::unique_ptr< QSocketNotifier > writer;
+    std::unique_ptr< QTimer > deadline;  ///< HELLO, then each queued reply, must be done by then
+    QByteArray in;
+    QByteArray out;                      ///< Reply being sent, from outSent on
+    qsizetype outSent = 0;
+    bool authenticated = false;
+    PeerCaller caller;
+
+    ~Client()
+    {
+      deadline.reset();
+      writer.reset();
+      reader.reset();
+      if ( fd >= 0 )
+        ::close( fd );
+    }
+  };
+
+  static int64_t nowMs()
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  void expireTokens()
+  {
+    const int64_t now = nowMs();
+    for ( auto it = m_tokens.begin(); it != m_tokens.end(); )
+      it = now - it->second.issuedMs > TOKEN_TTL_MS ? m_tokens.erase( it ) : std::next( it );
+  }
+
+  void acceptClients()
+  {
+    for ( ;; )
+    {
+      const int fd = ::accept4( m_listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK );
+      if ( fd < 0 )
+        return;
+
+      ucred cred{};
+      socklen_t credLen = sizeof( cred );
+      if ( m_clients.size() >= MAX_CLIENTS
+           || ::getsockopt( fd, SOL_SOCKET, SO_PEERCRED, &cred, &credLen ) < 0 )
+      {
+        ::close( fd );
+        continue;
+      }
+
+      auto client = std::make_unique< Client >();
+      client->fd = fd;
+      client->caller.pid = static_cast< uint32_t >( cred.pid );
+      client->caller.uid = static_cast< uint32_t >( cred.uid );
+      client->reader = std::make_unique< QSocketNotifier >( fd, QSocketNotifier::Read );
+      QObject::connect( client->reader.get(), &QSocketNotifier::activated, [this, fd]() { serve( fd ); } );
+      client->writer = std::make_unique< QSocketNotifier >( fd, QSocketNotifier::Write );
+      client->writer->setEnabled( false );
+      QObject::connect( client->writer.get(), &QSocketNotifier::activated, [this, fd]() { resume( fd ); } );
+      client->deadline = std::make_unique< QTimer >();
+      client->deadline->setSingleShot( true );
+      QObject::connect( client->deadline.get(), &QTimer::timeout, [this, fd]() { m_clients.erase( fd ); } );
+      client->deadline->start( AUTH_TIMEOUT_MS );
+      m_clients[ fd ] = std::move( client );
+    }
+  }
+
+  void serve( int fd )
+  {
+    const auto it = m_clients.find( fd );
+    if ( it == m_clients.end() )
+      return;
+    Client &client = *it->second;
+
+    char chunk[ 4096 ];
+    const ssize_t n = ::recv( fd, chunk, sizeof( chunk ), MSG_DONTWAIT );
+    if ( n <= 0 )
+    {
+      if ( n == 0 || ( errno != EAGAIN && errno != EINTR ) )
+        m_clients.erase( it );
+      return;
+    }
+    client.in.append( chunk, n );
+    process( fd );
+  }
+
+  /// The socket takes more of the queued reply
+  void resume( int fd )
+  {
+    const auto it = m_clients.find( fd );
+    if ( it == m_clients.end() )
+      return;
+    if ( !flush( *it->second ) )
+    {
+      m_clients.erase( it );
+      return;
+    }
+    if ( it->second->out.isEmpty() )
+      process( fd );
+  }
+
+  /// Answer the complete requests in the input buffer until a reply has to wait for the socket
+  void process( int fd )
+  {
+    const auto it = m_clients.find( fd );
+    if ( it == m_clients.end() )
+      return;
+    Client &client = *it->second;
+
+    bool corrupt = false;
+    while ( client.out.isEmpty() )
+    {
+      const uint32_t limit = client.authenticated ? ucc::peer::MAX_FRAME_BYTES : ucc::peer::MAX_HELLO_BYTES;
+      const auto payload = ucc::peer::takeFrame( client.in, corrupt, limit );
+      if ( !payload )
+        break;
+      const auto request = ucc::peer::decodeRequest( *payload );
+      if ( !request || !handle( client, *request ) || !flush( client ) )
+      {
+        m_clients.erase( it );
+        return;
+      }
+    }
+    if ( corrupt )
+    {
+      m_clients.erase( it );
+      return;
+    }
+
+    const bool sending = !client.out.isEmpty();
+    client.reader->setEnabled( !sending );
+    client.writer->setEnabled( sending );
+    if ( sending && !client.deadline->isActive() )
+      client.deadline->start( SEND_TIMEOUT_MS );
+    else if ( client.authenticated )
+      client.deadline->stop();
+  }
+
+  /// Send what the socket takes without blocking; false drops the connection
+  static bool flush( Client &client )
+  {
+    while ( client.outSent < client.out.size() )
+    {
+      const ssize_t n = ::send( client.fd, client.out.constData() + client.outSent,
+                                static_cast< size_t >( client.out.size() - client.outSent ),
+                                MSG_NOSIGNAL | MSG_DONTWAIT );
+      if ( n < 0 && errno == EINTR )
+        continue;
+      if ( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+        return true;
+      if ( n <= 0 )
+        return false;
+      client.outSent += n;
+    }
+    client.out.clear();
+    client.outSent = 0;
+    return true;
+  }
+
+  /// Queue the reply to one request; false drops the connection
+  bool handle( Client &client, const ucc::peer::Request &request )
+  {
+    ucc::peer::Reply reply;
+    reply.serial = request.serial;
+
+    if ( !client.authenticated )
+    {
+      // the first request must present a token issued to this uid
+      expireTokens();
+      if ( request.method != QLatin1String( ucc::peer::HELLO ) || request.args.size() != 1 )
+        return false;
+      const auto token = m_tokens.find( request.args.front().toByteArray() );
+      if ( token == m_tokens.end() || token->second.uid != client.caller.uid )
+        return false;
+      client.caller.sender = token->second.sender;
+      client.authenticated = true;
+      client.deadline->stop();
+      m_tokens.erase( token );
+      reply.ok = true;
+    }
+    else if ( !ucc::peer::peerServes( request.method ) )
+      reply.error = QStringLiteral( "UnknownMethod" );
+    else if ( auto value = m_dispatch( client.caller, request.method, request.args, reply.error ) )
+    {
+      reply.ok = true;
+      reply.value = std::move( *value );
+    }
+
+    client.out = ucc::peer::encodeReply( reply );
+    client.outSent = 0;
+    return true;
+  }
+
+  Dispatch m_dispatch;
+  int m_listenFd = -1;
+  QString m_address;
+  std::unique_ptr< QSocketNotifier > m_listenNotifier;
+  std::map< int, std::unique_ptr< Client > > m_clients;  ///< Keyed by fd
+  std::map< QByteArray, Token > m_tokens;
+};
@@ -0,0 +1,177 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Replace @p path with @p content so that a crash leaves the old or the new file.
+ *
+ * The content goes to "<path>.tmp", which is fsync'd before the rename;
+ * the directory is fsync'd after it so the rename itself is durable.
+ * @param error Set to a description of the failing step, if not null
+ */
+[[nodiscard]] inline bool writeFileDurably( const std::string &path, std::string_view content,
+                                            mode_t mode, std::string *error = nullptr ) noexcept
+{
+  const std::string tmp = path + ".tmp";
+  auto fail = [&]( const char *step ) {
+    if ( error )
+      *error = std::string( step ) + " " + tmp + ": " + std::strerror( errno );
+    ::unlink( tmp.c_str() );
+    return false;
+  };
+
+  const int fd = ::open( tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode );
+  if ( fd < 0 )
+    return fail( "cannot open" );
+
+  size_t done = 0;
+  while ( done < content.size() )
+  {
+    const ssize_t n = ::write( fd, content.data() + done, content.size() - done );
+    if ( n < 0 && errno == EINTR )
+      continue;
+    if ( n <= 0 )
+      break;
+    done += static_cast< size_t >( n );
+  }
+  // the umask must not narrow the mode of an existing setting file
+  const bool ok = done == content.size() && ::fchmod( fd, mode ) == 0 && ::fsync( fd ) == 0;
+  if ( ::close( fd ) != 0 || !ok )
+    return fail( "cannot write" );
+
+  if ( ::rename( tmp.c_str(), path.c_str() ) != 0 )
+    return fail( "cannot rename" );
+
+  std::string dir = std::filesystem::path( path ).parent_path().string();
+  if ( const int dirFd = ::open( dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC ); dirFd >= 0 )
+  {
+    ::fsync( dirFd );
+    ::close( dirFd );
+  }
+  return true;
+}
+
+/**
+ * @brief Coalesces changes to one persisted document into a single write.
+ *
+ * markDirty() records a change; the write is due once no further change
+ * came for the quiet period, or at the latest maxDelay after the first
+ * unwritten change, so a slider dragged for minutes still gets saved.
+ * The owner polls deadline() to arm a timer and calls flushIfDue() when
+ * it fires, and flush() on shutdown and before suspend.  A failed write
+ * keeps the document dirty and is retried one quiet period later.
+ *
+ * Not thread-safe: the service drives it from the main thread only.
+ */
+class PersistQueue
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  PersistQueue( std::function< bool() > write,
+                std::chrono::milliseconds quietPeriod,
+                std::chrono::milliseconds maxDelay )
+    : m_write( std::move( write ) ), m_quietPeriod( quietPeriod ), m_maxDelay( std::max( maxDelay, quietPeriod ) )
+  {
+  }
+
+  /// A quiet period of 0 writes on the next flushIfDue()
+  void setQuietPeriod( std::chrono::milliseconds quietPeriod ) noexcept
+  {
+    m_maxDelay = std::max( m_maxDelay, quietPeriod );
+    m_quietPeriod = quietPeriod;
+  }
+
+  [[nodiscard]] std::chrono::milliseconds quietPeriod() const noexcept { return m_quietPeriod; }
+
+  void markDirty( Clock::time_point now ) noexcept
+  {
+    if ( m_dirty )
+      ++m_coalesced;
+    else
+      m_firstChange = now;
+    m_dirty = true;
+    m_lastChange = now;
+  }
+
+  [[nodiscard]] bool dirty() const noexcept { return m_dirty; }
+
+  /// When the pending write is due; nullopt if nothing is pending
+  [[nodiscard]] std::optional< Clock::time_point > deadline() const noexcept
+  {
+    if ( !m_dirty )
+      return std::nullopt;
+    return std::min( m_lastChange + m_quietPeriod, m_firstChange + m_maxDelay );
+  }
+
+  /// Write if the deadline has passed; false only if a write failed
+  bool flushIfDue( Clock::time_point now )
+  {
+    const auto due = deadline();
+    return !due || now < *due || write( now );
+  }
+
+  /// Write now if anything is pending; false if the write failed
+  bool flush()
+  {
+    return !m_dirty || write( Clock::now() );
+  }
+
+  [[nodiscard]] uint64_t writes() const noexcept { return m_writes; }
+  [[nodiscard]] uint64_t failures() const noexcept { return m_failures; }
+  /// Changes absorbed by an already pending write
+  [[nodiscard]] uint64_t coalesced() const noexcept { return m_coalesced; }
+
+private:
+  bool write( Clock::time_point now )
+  {
+    if ( m_write() )
+    {
+      m_dirty = false;
+      ++m_writes;
+      return true;
+    }
+    ++m_failures;
+    m_firstChange = m_lastChange = now;
+    return false;
+  }
+
+  std::function< bool() > m_write;
+  std::chrono::milliseconds m_quietPeriod;
+  std::chrono::milliseconds m_maxDelay;
+  bool m_dirty = false;
+  Clock::time_point m_firstChange{};
+  Clock::time_point m_lastChange{};
+  uint64_t m_writes = 0;
+  uint64_t m_failures = 0;
+  uint64_t m_coalesced = 0;
+};
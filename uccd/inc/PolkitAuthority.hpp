@@ -15,6 +15,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <syslog.h>
 #include <QDBusConnection>
@@ -56,33 +60,92 @@ public:
   static bool checkAuthorization( const QDBusConnection &connection,
                                   const QDBusMessage &message,
                                   const char *actionId ) noexcept
+  {
+    const auto pid = callerPid( connection, message );
+    return pid && checkAuthorization( connection, *pid, processStartTime( *pid ), actionId );
+  }
+
+  /**
+   * @brief PID of the process behind the message's sender, from the bus daemon.
+   */
+  static std::optional< uint > callerPid( const QDBusConnection &connection,
+                                          const QDBusMessage &message ) noexcept
   {
     try
     {
-      // Retrieve the caller's PID via the bus daemon
-      const QString sender = message.service();
-
       QDBusMessage getPid = QDBusMessage::createMethodCall(
           "org.freedesktop.DBus",
           "/org/freedesktop/DBus",
           "org.freedesktop.DBus",
           "GetConnectionUnixProcessID" );
-      getPid << sender;
+      getPid << message.service();
 
       QDBusReply< uint > pidReply = connection.call( getPid );
       if ( not pidReply.isValid() )
       {
         syslog( LOG_WARNING, "PolkitAuthority: Failed to get caller PID: %s",
                 pidReply.error().message().toStdString().c_str() );
-        return false;
+        return std::nullopt;
       }
-      const uint callerPid = pidReply.value();
+      return pidReply.value();
+    }
+    catch ( ... )
+    {
+      syslog( LOG_ERR, "PolkitAuthority: Unknown exception while resolving caller PID" );
+      return std::nullopt;
+    }
+  }
 
+  /**
+   * @brief Start time of @p pid in clock ticks since boot (/proc/<pid>/stat
+   *        field 22), 0 if unreadable.
+   */
+  static uint64_t processStartTime( uint pid ) noexcept
+  {
+    try
+    {
+      std::ifstream stat( "/proc/" + std::to_string( pid ) + "/stat" );
+      std::string line;
+      if ( not std::getline( stat, line ) )
+        return 0;
+
+      // comm (field 2) may contain spaces and parentheses; fields after
+      // the last ')' start at 3 (state)
+      const auto close = line.rfind( ')' );
+      if ( close == std::string::npos )
+        return 0;
+      std::istringstream fields( line.substr( close + 1 ) );
+      std::string field;
+      for ( int i = 3; i <= 22 && fields >> field; ++i )
+      {
+        if ( i == 22 )
+          return std::stoull( field );
+      }
+      return 0;
+    }
+    catch ( ... )
+    {
+      return 0;
+    }
+  }
+
+  /**
+   * @brief Ask Polkit whether process @p callerPid may perform @p actionId.
+   *
+   * @param startTime  processStartTime() of the caller; 0 lets Polkit read it
+   */
+  static bool checkAuthorization( const QDBusConnection &connection,
+                                  uint callerPid,
+                                  uint64_t startTime,
+                                  const char *actionId ) noexcept
+  {
+    try
+    {
       // Build the Polkit subject: ("unix-process", { "pid": uint32, "start-time": uint64 })
       // start-time = 0 means "don't check" (Polkit falls back to /proc/<pid>)
       QVariantMap subjectDetails;
       subjectDetails["pid"] = QVariant::fromValue( callerPid );
-      subjectDetails["start-time"] = QVariant::fromValue( static_cast< quint64 >( 0 ) );
+      subjectDetails["start-time"] = QVariant::fromValue( static_cast< quint64 >( startTime ) );
 
       // The Polkit CheckAuthorization call uses (sa{sv}) for the subject struct.
       // We must build the struct using QDBusArgument.
@@ -0,0 +1,123 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/// Filtered readings of one arbitration step; < 0 where unknown
+struct PowerBudgetSample
+{
+  double cpuWatts = -1.0;       ///< package power
+  double cpuLimitedPct = -1.0;  ///< time at PL1/PL2
+  double cpuLimitWatts = 0.0;   ///< sustained CPU limit in force (TDP 1)
+  double gpuWatts = -1.0;
+  double gpuUtilPct = -1.0;
+  double gpuLimitWatts = 0.0;   ///< default GPU limit plus the cTGP offset in force
+};
+
+enum class PowerBottleneck { None, Cpu, Gpu, Idle };
+
+/**
+ * @brief Moves power budget between CPU TDP and dGPU cTGP on a shared cooler
+ *
+ * The shift is the watts taken from every CPU TDP and given to the cTGP
+ * offset (negative: the other way), so their sum stays what the profile
+ * set.  A component is the bottleneck while it runs at its limit and the
+ * other one leaves a quarter of its own unused; the shift then moves
+ * towards it at SHIFT_WATTS_PER_SECOND.  While both are loaded it holds,
+ * so a budget a game or a compile has taken is not handed back as soon as
+ * it stops looking starved; only when both idle does it drift back to the
+ * profile split at RELAX_WATTS_PER_SECOND.
+ *
+ * The result is quantized to SHIFT_STEP_WATTS: the firmware rounds the
+ * cTGP offset anyway, and every change is an EC and a sysfs write.
+ */
+class PowerBudgetArbiter
+{
+public:
+  static constexpr double AT_LIMIT = 0.9;           ///< Power / limit of a component at its limit
+  static constexpr double SLACK = 0.75;             ///< Power / limit of a component with budget to spare
+  static constexpr double CPU_LIMITED_PCT = 50.0;   ///< Time at PL1/PL2 that counts as power-bound
+  static constexpr double GPU_BUSY_PCT = 90.0;
+  static constexpr double GPU_IDLE_PCT = 50.0;
+  static constexpr double SHIFT_WATTS_PER_SECOND = 2.0;
+  static constexpr double RELAX_WATTS_PER_SECOND = 0.5;
+  static constexpr int32_t SHIFT_STEP_WATTS = 5;
+  static constexpr double MAX_DT_SECONDS = 10.0;
+
+  [[nodiscard]] static PowerBottleneck classify( const PowerBudgetSample &s ) noexcept
+  {
+    if ( s.cpuWatts < 0.0 || s.cpuLimitWatts <= 0.0 || s.gpuWatts < 0.0 || s.gpuLimitWatts <= 0.0 )
+      return PowerBottleneck::None;
+
+    const double cpu = s.cpuWatts / s.cpuLimitWatts;
+    const double gpu = s.gpuWatts / s.gpuLimitWatts;
+    const bool cpuAtLimit = cpu >= AT_LIMIT || s.cpuLimitedPct >= CPU_LIMITED_PCT;
+    const bool cpuSlack = cpu < SLACK && s.cpuLimitedPct < CPU_LIMITED_PCT;
+    const bool gpuAtLimit = gpu >= AT_LIMIT && ( s.gpuUtilPct < 0.0 || s.gpuUtilPct >= GPU_BUSY_PCT );
+    const bool gpuSlack = gpu < SLACK || ( s.gpuUtilPct >= 0.0 && s.gpuUtilPct < GPU_IDLE_PCT );
+
+    if ( gpuAtLimit && cpuSlack )
+      return PowerBottleneck::Gpu;
+    if ( cpuAtLimit && gpuSlack )
+      return PowerBottleneck::Cpu;
+    if ( cpuSlack && gpuSlack )
+      return PowerBottleneck::Idle;
+    return PowerBottleneck::None;
+  }
+
+  void reset() noexcept { m_shift = 0.0; }
+
+  [[nodiscard]] int32_t shift() const noexcept { return quantize( m_shift ); }
+
+  /**
+   * @param minShift Largest shift towards the CPU, <= 0
+   * @param maxShift Largest shift towards the GPU, >= 0
+   * @return Watts to move from the CPU TDPs to the cTGP offset
+   */
+  int32_t update( const PowerBudgetSample &s, int32_t minShift, int32_t maxShift, double dtSeconds ) noexcept
+  {
+    const double dt = std::clamp( dtSeconds, 0.0, MAX_DT_SECONDS );
+    switch ( classify( s ) )
+    {
+      case PowerBottleneck::Gpu:
+        m_shift += SHIFT_WATTS_PER_SECOND * dt;
+        break;
+      case PowerBottleneck::Cpu:
+        m_shift -= SHIFT_WATTS_PER_SECOND * dt;
+        break;
+      case PowerBottleneck::Idle:
+        m_shift = m_shift > 0.0 ? std::max( 0.0, m_shift - RELAX_WATTS_PER_SECOND * dt )
+                                : std::min( 0.0, m_shift + RELAX_WATTS_PER_SECOND * dt );
+        break;
+      case PowerBottleneck::None:
+        break;
+    }
+    m_shift = std::clamp( m_shift, static_cast< double >( std::min( minShift, 0 ) ),
+                          static_cast< double >( std::max( maxShift, 0 ) ) );
+    return shift();
+  }
+
+private:
+  [[nodiscard]] static int32_t quantize( double watts ) noexcept
+  {
+    return static_cast< int32_t >( std::trunc( watts / SHIFT_STEP_WATTS ) ) * SHIFT_STEP_WATTS;
+  }
+
+  double m_shift = 0.0;
+};
@@ -0,0 +1,144 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "profiles/UccProfile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Range one TDP index may move in, watts
+struct PowerLimitBounds
+{
+  int32_t min = 0;
+  int32_t max = 0;
+
+  bool operator==( const PowerLimitBounds & ) const = default;
+};
+
+/**
+ * @brief Thermal-headroom controller for the ODM power limits
+ *
+ * All TDP indices move together along one level in [0, 1], from their
+ * floor (0) to the profile values (1), so PL1, PL2 and PL4 keep their
+ * relation: when the chassis runs out of cooling the bursts shrink with
+ * the sustained limit instead of overshooting into thermal throttling.
+ *
+ *   rate = WATTS_PER_DEG * ( target - T ), outside a ±DEADBAND_DEG band
+ *
+ * clamped to -fallWattsPerSecond and +riseWattsPerSecond.  Within
+ * FAN_GUARD_DEG of the target a rise is also faded out over the last
+ * FAN_MARGIN % below fanDutyLimit: close to the target power is only
+ * granted while the fan can still take the extra heat, and with the fan
+ * at its limit the level rests between the guard and the deadband instead
+ * of hunting around the target.  Watts are counted on the widest index.  The caller passes filtered readings: the deadband
+ * and the slew limits absorb what is left of the noise.
+ *
+ * The first update after reset() starts at the profile values, which is
+ * what static mode applies, so switching modes is bumpless.
+ */
+class PowerLimitController
+{
+public:
+  static constexpr double DEADBAND_DEG = 1.0;
+  static constexpr double WATTS_PER_DEG = 0.5;  ///< W/s per °C of headroom beyond the deadband
+  static constexpr double FAN_MARGIN = 10.0;    ///< % of duty under fanDutyLimit over which rising fades out
+  static constexpr double FAN_GUARD_DEG = 5.0;  ///< Headroom below which the fan duty limits rising
+  static constexpr double MAX_DT_SECONDS = 10.0;
+
+  /**
+   * @brief Bounds of every index: the profile value and floorPercent of it,
+   *        kept within [hardwareMin, hardwareMax]
+   */
+  [[nodiscard]] static std::vector< PowerLimitBounds > boundsFor( const PowerLimitControllerSettings &s,
+                                                                  const std::vector< int32_t > &profileValues,
+                                                                  const std::vector< PowerLimitBounds > &hardware )
+  {
+    std::vector< PowerLimitBounds > bounds;
+    const size_t count = std::min( profileValues.size(), hardware.size() );
+    bounds.reserve( count );
+    for ( size_t i = 0; i < count; ++i )
+    {
+      const int32_t hi = std::clamp( profileValues[ i ], hardware[ i ].min, std::max( hardware[ i ].min, hardware[ i ].max ) );
+      const int32_t floor = static_cast< int32_t >( std::lround( hi * std::clamp( s.floorPercent, 0, 100 ) / 100.0 ) );
+      bounds.push_back( { std::clamp( floor, hardware[ i ].min, hi ), hi } );
+    }
+    return bounds;
+  }
+
+  void reset() noexcept { m_primed = false; }
+
+  [[nodiscard]] double level() const noexcept { return m_level; }
+
+  /**
+   * @param temp Filtered CPU temperature, °C
+   * @param fanDuty Filtered CPU fan duty, %, < 0 if unknown
+   * @return The limit of every index, watts
+   */
+  std::vector< int32_t > update( const PowerLimitControllerSettings &s, const std::vector< PowerLimitBounds > &bounds,
+                                 double temp, double fanDuty, double dtSeconds )
+  {
+    if ( !m_primed )
+    {
+      m_primed = true;
+      m_level = 1.0;
+      return valuesAt( bounds );
+    }
+
+    double span = 0.0;
+    for ( const auto &b : bounds )
+      span = std::max( span, static_cast< double >( b.max - b.min ) );
+
+    const double dt = std::clamp( dtSeconds, 0.0, MAX_DT_SECONDS );
+    const double rate = wattsPerSecond( s, temp, fanDuty );
+    if ( span > 0.0 && rate != 0.0 )
+      m_level = std::clamp( m_level + rate * dt / span, 0.0, 1.0 );
+    return valuesAt( bounds );
+  }
+
+  /// Signed change the readings call for, W/s
+  [[nodiscard]] static double wattsPerSecond( const PowerLimitControllerSettings &s, double temp, double fanDuty ) noexcept
+  {
+    const double headroom = static_cast< double >( s.targetTemp ) - temp;
+    if ( std::abs( headroom ) <= DEADBAND_DEG )
+      return 0.0;
+
+    const double rate = WATTS_PER_DEG * ( headroom > 0.0 ? headroom - DEADBAND_DEG : headroom + DEADBAND_DEG );
+    if ( rate < 0.0 )
+      return std::max( rate, -std::max( 0.0, s.fallWattsPerSecond ) );
+
+    double fanRoom = 1.0;
+    if ( fanDuty >= 0.0 )
+      fanRoom = std::max( std::clamp( ( static_cast< double >( s.fanDutyLimit ) - fanDuty ) / FAN_MARGIN, 0.0, 1.0 ),
+                          std::clamp( ( headroom - FAN_GUARD_DEG ) / FAN_GUARD_DEG, 0.0, 1.0 ) );
+    return std::min( rate, std::max( 0.0, s.riseWattsPerSecond ) ) * fanRoom;
+  }
+
+private:
+  [[nodiscard]] std::vector< int32_t > valuesAt( const std::vector< PowerLimitBounds > &bounds ) const
+  {
+    std::vector< int32_t > values;
+    values.reserve( bounds.size() );
+    for ( const auto &b : bounds )
+      values.push_back( b.min + static_cast< int32_t >( std::lround( m_level * ( b.max - b.min ) ) ) );
+    return values;
+  }
+
+  double m_level = 1.0;
+  bool m_primed = false;
+};
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
 #include <string>
 #include <vector>
 #include <optional>
@@ -61,6 +62,8 @@ enum class ChargeType
 class PowerSupplyController
 {
 public:
+  static constexpr const char *POWER_SUPPLY_ROOT = "/sys/class/power_supply";
+
   /**
    * @brief Constructor
    * @param basePath Base path to power supply sysfs directory
@@ -224,25 +227,34 @@ public:
   }
 
   /**
-   * @brief Get all battery power supplies
-   * @return Vector of PowerSupplyController instances for batteries
+   * @brief Get the supply's name, the last component of its path (e.g. "AC", "BAT0")
    */
-  [[nodiscard]] static std::vector< PowerSupplyController > getPowerSupplyBatteries() noexcept
+  [[nodiscard]] std::string getName() const
   {
-    std::vector< PowerSupplyController > batteries;
-    const std::string psPath = "/sys/class/power_supply";
+    return std::filesystem::path( m_basePath ).filename().string();
+  }
+
+  /**
+   * @brief Get all power supplies of one type
+   * @param root Directory of the power supply class
+   * @return Vector of PowerSupplyController instances in directory order
+   */
+  [[nodiscard]] static std::vector< PowerSupplyController >
+  getPowerSupplies( PowerSupplyType type, const std::string &root = ucc::sysfsPath( POWER_SUPPLY_ROOT ) ) noexcept
+  {
+    std::vector< PowerSupplyController > supplies;
 
     try
     {
-      if ( not std::filesystem::exists( psPath ) )
-        return batteries;
+      if ( not std::filesystem::exists( root ) )
+        return supplies;
 
-      for ( const auto &entry : std::filesystem::directory_iterator( psPath ) )
+      for ( const auto &entry : std::filesystem::directory_iterator( root ) )
       {
         if ( entry.is_directory() or entry.is_symlink() )
         {
-          if ( PowerSupplyController ps( entry.path().string() ); ps.getType() == PowerSupplyType::Battery )
-            batteries.push_back( std::move( ps ) );
+          if ( PowerSupplyController ps( entry.path().string() ); ps.getType() == type )
+            supplies.push_back( std::move( ps ) );
         }
       }
     }
@@ -251,7 +263,32 @@ public:
       // Return empty vector on error
     }
 
-    return batteries;
+    return supplies;
+  }
+
+  /**
+   * @brief Get all battery power supplies
+   * @return Vector of PowerSupplyController instances for batteries
+   */
+  [[nodiscard]] static std::vector< PowerSupplyController > getPowerSupplyBatteries() noexcept
+  {
+    return getPowerSupplies( PowerSupplyType::Battery );
+  }
+
+  /**
+   * @brief Get the first AC adapter ('Mains' supply) that reports 'online'
+   * @return nullopt on systems without one (desktops without ACPI AC)
+   */
+  [[nodiscard]] static std::optional< PowerSupplyController >
+  getFirstMains( const std::string &root = ucc::sysfsPath( POWER_SUPPLY_ROOT ) ) noexcept
+  {
+    for ( auto &mains : getPowerSupplies( PowerSupplyType::Mains, root ) )
+    {
+      std::error_code ec;
+      if ( std::filesystem::exists( mains.getBasePath() + "/online", ec ) )
+        return std::move( mains );
+    }
+    return std::nullopt;
   }
 
   /**
@@ -0,0 +1,112 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include "PowerSupplyController.hpp"
+#include "TccSettings.hpp"
+#include "UdevMonitor.hpp"
+
+/**
+ * @brief AC/BAT state kept up to date from udev "power_supply" uevents.
+ *
+ * The mains supply is looked up once at start(); after that the state
+ * follows the POWER_SUPPLY_ONLINE property of its uevents, so no sysfs
+ * file is read while the state holds.  The owner watches fd() in its
+ * event loop and calls drain() when it is readable; state() may be read
+ * from any thread.
+ */
+class PowerSupplyMonitor
+{
+public:
+  /**
+   * @brief Resolve the mains supply and start listening
+   * @return false without udev; the owner then has to poll determineState()
+   */
+  bool start( const std::string &root = ucc::sysfsPath( PowerSupplyController::POWER_SUPPLY_ROOT ) ) noexcept
+  {
+    if ( const auto mains = PowerSupplyController::getFirstMains( root ) )
+    {
+      m_mainsName = mains->getName();
+      m_state = mains->isOnline() ? ProfileState::AC : ProfileState::BAT;
+    }
+    return m_events.start( { "power_supply" } );
+  }
+
+  void stop() noexcept { m_events.stop(); }
+
+  [[nodiscard]] bool active() const noexcept { return m_events.active(); }
+
+  [[nodiscard]] int fd() const noexcept { return m_events.fd(); }
+
+  /// AC or BAT; AC on systems without a mains supply
+  [[nodiscard]] ProfileState state() const noexcept { return m_state.load( std::memory_order_relaxed ); }
+
+  /**
+   * @brief Apply the queued uevents
+   * @return true if the AC/BAT state changed
+   */
+  bool drain() noexcept
+  {
+    const ProfileState before = state();
+    m_events.drain( [ this ]( const UdevEvent &event ) {
+      if ( auto next = apply( event.action(), event.property( "POWER_SUPPLY_NAME" ),
+                              event.property( "POWER_SUPPLY_TYPE" ), event.property( "POWER_SUPPLY_ONLINE" ) ) )
+        m_state.store( *next, std::memory_order_relaxed );
+    } );
+    return state() != before;
+  }
+
+  /**
+   * @brief The state after one uevent of a power supply
+   * @return nullopt if the event does not concern the mains supply
+   *
+   * An adapter that appears after start() becomes the tracked one; one
+   * that goes away leaves the system on AC, as determineState() would.
+   */
+  [[nodiscard]] std::optional< ProfileState > apply( const char *action, const char *name, const char *type,
+                                                     const char *online ) noexcept
+  {
+    const bool isMains = std::strcmp( type, "Mains" ) == 0 or ( not m_mainsName.empty() and m_mainsName == name );
+    if ( not isMains )
+      return std::nullopt;
+
+    if ( std::strcmp( action, "remove" ) == 0 )
+    {
+      if ( m_mainsName != name )
+        return std::nullopt;
+      m_mainsName.clear();
+      return ProfileState::AC;
+    }
+
+    if ( *online == '\0' )
+      return std::nullopt;
+    if ( m_mainsName.empty() )
+      m_mainsName = name;
+    else if ( m_mainsName != name )
+      return std::nullopt;
+    return std::strcmp( online, "0" ) == 0 ? ProfileState::BAT : ProfileState::AC;
+  }
+
+private:
+  UdevMonitor m_events;
+  std::string m_mainsName;  ///< e.g. "AC", "ADP1"; only touched by the draining thread
+  std::atomic< ProfileState > m_state{ ProfileState::AC };
+};
@@ -0,0 +1,230 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "SysfsRoot.hpp"
+
+/// What a process runs and where, read from procfs when it shows up
+struct ProcessIdentity
+{
+  std::string exe;    ///< resolved /proc/<pid>/exe
+  std::string cgroup; ///< unified (v2) cgroup path, e.g. "/user.slice/.../app-steam-1234.scope"
+
+  /// @return nullopt if the process is gone or not ours to inspect (kernel threads have no exe)
+  static std::optional< ProcessIdentity > read( pid_t pid )
+  {
+    const std::string base = ucc::sysfsPath( "/proc/" ) + std::to_string( pid );
+    char target[ 4096 ];
+    const ssize_t length = ::readlink( ( base + "/exe" ).c_str(), target, sizeof( target ) - 1 );
+    if ( length <= 0 )
+      return std::nullopt;
+
+    ProcessIdentity identity;
+    identity.exe.assign( target, static_cast< size_t >( length ) );
+    // an unlinked binary (updated while running) still names its path
+    if ( constexpr std::string_view deleted = " (deleted)"; identity.exe.ends_with( deleted ) )
+      identity.exe.resize( identity.exe.size() - deleted.size() );
+
+    std::ifstream cgroups( base + "/cgroup" );
+    for ( std::string line; std::getline( cgroups, line ); )
+    {
+      if ( line.starts_with( "0::" ) )
+      {
+        identity.cgroup = line.substr( 3 );
+        break;
+      }
+    }
+    return identity;
+  }
+
+  /// Calls @p fn( pid ) for every process alive now; a one-off scan, not a poll
+  template< typename Fn >
+  static void forEachProcess( Fn &&fn )
+  {
+    DIR *dir = ::opendir( ucc::sysfsPath( "/proc" ).c_str() );
+    if ( dir == nullptr )
+      return;
+    while ( const dirent *entry = ::readdir( dir ) )
+    {
+      char *end = nullptr;
+      const long pid = std::strtol( entry->d_name, &end, 10 );
+      if ( pid > 0 && end != entry->d_name && *end == '\0' )
+        fn( static_cast< pid_t >( pid ) );
+    }
+    ::closedir( dir );
+  }
+};
+
+/// One process event of the proc connector
+struct ProcEvent
+{
+  enum class Kind
+  {
+    Exec, ///< pid now runs another executable
+    Exit, ///< process pid is gone
+    Lost, ///< the socket overflowed: events were dropped, rescan
+  };
+
+  Kind kind;
+  pid_t pid = 0;
+};
+
+/**
+ * @brief Non-blocking listener for process exec/exit on the netlink proc
+ *        connector.
+ *
+ * The kernel multicasts an event for every fork, exec and exit on the
+ * system; only execs and exits of whole processes (not threads) are
+ * passed on.  Needs CAP_NET_ADMIN.  Like UdevMonitor the owner watches
+ * fd() from its own loop and calls drain(); there is no extra thread.
+ */
+class ProcExecMonitor
+{
+public:
+  ProcExecMonitor() noexcept = default;
+  ~ProcExecMonitor() { stop(); }
+
+  ProcExecMonitor( const ProcExecMonitor & ) = delete;
+  ProcExecMonitor &operator=( const ProcExecMonitor & ) = delete;
+
+  /// @return false if the connector is unavailable (no CONFIG_PROC_EVENTS, no privilege)
+  bool start() noexcept
+  {
+    stop();
+    m_fd = ::socket( PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR );
+    if ( m_fd < 0 )
+      return false;
+
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    if ( ::bind( m_fd, reinterpret_cast< sockaddr * >( &address ), sizeof( address ) ) < 0
+         || !subscribe( PROC_CN_MCAST_LISTEN ) )
+    {
+      ::close( m_fd );
+      m_fd = -1;
+      return false;
+    }
+    return true;
+  }
+
+  void stop() noexcept
+  {
+    if ( m_fd < 0 )
+      return;
+    (void)subscribe( PROC_CN_MCAST_IGNORE );
+    ::close( m_fd );
+    m_fd = -1;
+  }
+
+  [[nodiscard]] bool active() const noexcept { return m_fd >= 0; }
+
+  /// Readable when events are queued, for an event loop to watch; -1 if stopped
+  [[nodiscard]] int fd() const noexcept { return m_fd; }
+
+  /**
+   * @brief Consume all queued events, passing each one to @p onEvent
+   * @return Number of events passed on
+   */
+  template< typename Fn >
+  size_t drain( Fn &&onEvent )
+  {
+    if ( m_fd < 0 )
+      return 0;
+
+    size_t events = 0;
+    alignas( nlmsghdr ) char buffer[ 8192 ];
+    for ( ;; )
+    {
+      const ssize_t received = ::recv( m_fd, buffer, sizeof( buffer ), 0 );
+      if ( received < 0 )
+      {
+        if ( errno == ENOBUFS )
+        {
+          onEvent( ProcEvent{ ProcEvent::Kind::Lost } );
+          ++events;
+          continue;
+        }
+        if ( errno == EINTR )
+          continue;
+        break; // EAGAIN: drained
+      }
+
+      auto remaining = static_cast< unsigned int >( received );
+      for ( auto *header = reinterpret_cast< nlmsghdr * >( buffer ); NLMSG_OK( header, remaining );
+            header = NLMSG_NEXT( header, remaining ) )
+      {
+        if ( header->nlmsg_type == NLMSG_NOOP || header->nlmsg_type == NLMSG_ERROR )
+          continue;
+        const auto *message = static_cast< const cn_msg * >( NLMSG_DATA( header ) );
+        if ( message->id.idx != CN_IDX_PROC || message->len < sizeof( proc_event ) )
+          continue;
+
+        proc_event event;
+        std::memcpy( &event, message->data, sizeof( event ) );
+        if ( event.what == proc_event::PROC_EVENT_EXEC )
+        {
+          onEvent( ProcEvent{ ProcEvent::Kind::Exec, event.event_data.exec.process_tgid } );
+          ++events;
+        }
+        else if ( event.what == proc_event::PROC_EVENT_EXIT
+                  && event.event_data.exit.process_pid == event.event_data.exit.process_tgid )
+        {
+          onEvent( ProcEvent{ ProcEvent::Kind::Exit, event.event_data.exit.process_tgid } );
+          ++events;
+        }
+      }
+    }
+    return events;
+  }
+
+private:
+  bool subscribe( proc_cn_mcast_op op ) noexcept
+  {
+    alignas( nlmsghdr ) char buffer[ NLMSG_SPACE( sizeof( cn_msg ) + sizeof( op ) ) ]{};
+    auto *header = reinterpret_cast< nlmsghdr * >( buffer );
+    header->nlmsg_len = NLMSG_LENGTH( sizeof( cn_msg ) + sizeof( op ) );
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = static_cast< uint32_t >( ::getpid() );
+
+    auto *message = static_cast< cn_msg * >( NLMSG_DATA( header ) );
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof( op );
+    std::memcpy( message->data, &op, sizeof( op ) );
+
+    return ::send( m_fd, buffer, header->nlmsg_len, 0 ) == static_cast< ssize_t >( header->nlmsg_len );
+  }
+
+  int m_fd = -1;
+};
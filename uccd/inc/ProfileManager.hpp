@@ -19,12 +19,17 @@
 #include "profiles/DefaultProfiles.hpp"
 #include "CommonTypes.hpp"
 #include "StateUtils.hpp"
+#include "ProfileRepository.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <sstream>
 #include <optional>
 #include <algorithm>
+#include <climits>
+#include <cmath>
 #include <cstdlib>
 #include <sys/stat.h>
 #include <cstring>
@@ -151,106 +156,107 @@ public:
     return parseFanTable( json );
   }
 
-  /**
-   * @brief Parse a single profile from JSON object
-   * @param json JSON object string
-   * @return Parsed profile
-   */
   /**
    * @brief Parse profile from JSON string
-   * 
-   * SECURITY NOTE (VULN-27): This function uses hand-rolled JSON parsing.
-   * For better security and maintainability, this should be refactored to use
-   * nlohmann::json instead. The library is already a project dependency and
-   * provides automatic escaping, proper error handling, and type safety.
-  * Refactoring should preserve support for the current profile JSON schema.
+   *
+   * @throws nlohmann::json::parse_error when @p json is not valid JSON
    */
   [[nodiscard]] static UccProfile parseProfileJSON( const std::string &json )
+  {
+    return profileFromJson( nlohmann::json::parse( json ) );
+  }
+
+  /**
+   * @brief Fill a profile from an already parsed JSON object
+   *
+   * Missing keys and values of the wrong type keep the UccProfile defaults,
+   * so profiles written by older versions still load.  Nested keys are
+   * looked up in their own object only.
+   */
+  [[nodiscard]] static UccProfile profileFromJson( const nlohmann::json &json )
   {
     UccProfile profile;
 
-    profile.id = extractString( json, "id" );
-    profile.name = extractString( json, "name" );
-    profile.description = extractString( json, "description" );
+    profile.id = jsonValue( json, "id", std::string() );
+    profile.name = jsonValue( json, "name", std::string() );
+    profile.description = jsonValue( json, "description", std::string() );
 
     // Parse display settings
-    std::string displayJson = extractObject( json, "display" );
-    if ( !displayJson.empty() )
+    if ( const nlohmann::json *display = jsonObject( json, "display" ) )
     {
-      profile.display.brightness = extractInt( displayJson, "brightness", 100 );
-      profile.display.useBrightness = extractBool( displayJson, "useBrightness", false );
-      profile.display.refreshRate = extractInt( displayJson, "refreshRate", -1 );
-      profile.display.useRefRate = extractBool( displayJson, "useRefRate", false );
-      profile.display.xResolution = extractInt( displayJson, "xResolution", -1 );
-      profile.display.yResolution = extractInt( displayJson, "yResolution", -1 );
-      profile.display.useResolution = extractBool( displayJson, "useResolution", false );
+      profile.display.brightness = jsonValue( *display, "brightness", 100 );
+      profile.display.useBrightness = jsonValue( *display, "useBrightness", false );
+      profile.display.refreshRate = jsonValue( *display, "refreshRate", -1 );
+      profile.display.useRefRate = jsonValue( *display, "useRefRate", false );
+      profile.display.xResolution = jsonValue( *display, "xResolution", -1 );
+      profile.display.yResolution = jsonValue( *display, "yResolution", -1 );
+      profile.display.useResolution = jsonValue( *display, "useResolution", false );
     }
 
     // Parse CPU settings
-    std::string cpuJson = extractObject( json, "cpu" );
-    if ( !cpuJson.empty() )
+    if ( const nlohmann::json *cpu = jsonObject( json, "cpu" ) )
     {
-      int32_t onlineCores = extractInt( cpuJson, "onlineCores", -1 );
-      if ( onlineCores >= 0 )
-      {
+      if ( const int32_t onlineCores = jsonValue( *cpu, "onlineCores", -1 ); onlineCores >= 0 )
         profile.cpu.onlineCores = onlineCores;
-      }
 
-      int32_t scalingMin = extractInt( cpuJson, "scalingMinFrequency", -1 );
-      if ( scalingMin >= 0 )
-      {
+      if ( const int32_t scalingMin = jsonValue( *cpu, "scalingMinFrequency", -1 ); scalingMin >= 0 )
         profile.cpu.scalingMinFrequency = scalingMin;
-      }
 
-      int32_t scalingMax = extractInt( cpuJson, "scalingMaxFrequency", -1 );
-      if ( scalingMax >= 0 )
-      {
+      if ( const int32_t scalingMax = jsonValue( *cpu, "scalingMaxFrequency", -1 ); scalingMax >= 0 )
         profile.cpu.scalingMaxFrequency = scalingMax;
-      }
 
-      profile.cpu.governor = extractString( cpuJson, "governor", "" );
-      profile.cpu.energyPerformancePreference = extractString( cpuJson, "energyPerformancePreference", "" );
-      profile.cpu.noTurbo = extractBool( cpuJson, "noTurbo", false );
+      profile.cpu.governor = jsonValue( *cpu, "governor", std::string() );
+      profile.cpu.energyPerformancePreference = jsonValue( *cpu, "energyPerformancePreference", std::string() );
+      profile.cpu.noTurbo = jsonValue( *cpu, "noTurbo", false );
+
+      if ( const nlohmann::json *coreClass = jsonObject( *cpu, "performanceCores" ) )
+        profile.cpu.performanceCores = coreClassFromJson( *coreClass );
+      if ( const nlohmann::json *coreClass = jsonObject( *cpu, "efficiencyCores" ) )
+        profile.cpu.efficiencyCores = coreClassFromJson( *coreClass );
+
+      if ( const std::string parking = jsonValue( *cpu, "coreParking", std::string() );
+           coreParkingPolicyFromString( parking ) != CoreParkingPolicy::Off )
+        profile.cpu.coreParking = parking;
+
+      // one level is no choice at all
+      if ( const auto levels = cpu->find( "adaptiveEpp" ); levels != cpu->end() && levels->is_array() )
+      {
+        for ( const auto &level : *levels )
+          if ( level.is_string() && !level.get_ref< const std::string & >().empty() )
+            profile.cpu.adaptiveEpp.push_back( level.get< std::string >() );
+        if ( profile.cpu.adaptiveEpp.size() < 2 )
+          profile.cpu.adaptiveEpp.clear();
+      }
     }
 
     // Parse webcam settings
-    std::string webcamJson = extractObject( json, "webcam" );
-    if ( !webcamJson.empty() )
+    if ( const nlohmann::json *webcam = jsonObject( json, "webcam" ) )
     {
-      profile.webcam.status = extractBool( webcamJson, "status", true );
-      profile.webcam.useStatus = extractBool( webcamJson, "useStatus", true );
+      profile.webcam.status = jsonValue( *webcam, "status", true );
+      profile.webcam.useStatus = jsonValue( *webcam, "useStatus", true );
     }
 
     // Parse fan settings
-    std::string fanJson = extractObject( json, "fan" );
-    if ( !fanJson.empty() )
+    if ( const nlohmann::json *fan = jsonObject( json, "fan" ) )
     {
-      profile.fan.useControl = extractBool( fanJson, "useControl", true );
-      profile.fan.fanProfile = extractString( fanJson, "fanProfile", "fan-balanced" );
-      profile.fan.sameSpeed = extractBool( fanJson, "sameSpeed", true );
-      profile.fan.autoControlWC = extractBool( fanJson, "autoControlWC", true );
-      profile.fan.enableWaterCooler = extractBool( fanJson, "enableWaterCooler", ucc::WATER_COOLER_INITIAL_STATE );
+      profile.fan.useControl = jsonValue( *fan, "useControl", true );
+      profile.fan.fanProfile = jsonValue( *fan, "fanProfile", std::string( "fan-balanced" ) );
+      profile.fan.sameSpeed = jsonValue( *fan, "sameSpeed", true );
+      profile.fan.autoControlWC = jsonValue( *fan, "autoControlWC", true );
+      profile.fan.enableWaterCooler = jsonValue( *fan, "enableWaterCooler", ucc::WATER_COOLER_INITIAL_STATE );
 
       // Debug: log the parsed fan settings
       std::cout << "[ProfileManager] Parsed profile '" << profile.name
                 << "' sameSpeed: " << ( profile.fan.sameSpeed ? "true" : "false" ) << std::endl;
 
       // Parse embedded fan tables if present (GUI embeds full fan curves in custom profiles)
-      std::string tableCPUJson = extractArray( fanJson, "tableCPU" );
-      if ( !tableCPUJson.empty() )
-        profile.fan.tableCPU = parseFanTable( tableCPUJson );
-
-      std::string tableGPUJson = extractArray( fanJson, "tableGPU" );
-      if ( !tableGPUJson.empty() )
-        profile.fan.tableGPU = parseFanTable( tableGPUJson );
-
-      std::string tablePumpJson = extractArray( fanJson, "tablePump" );
-      if ( !tablePumpJson.empty() )
-        profile.fan.tablePump = parseFanTable( tablePumpJson );
+      profile.fan.tableCPU = fanTableFromJson( fan->value( "tableCPU", nlohmann::json() ) );
+      profile.fan.tableGPU = fanTableFromJson( fan->value( "tableGPU", nlohmann::json() ) );
+      profile.fan.tablePump = fanTableFromJson( fan->value( "tablePump", nlohmann::json() ) );
+      profile.fan.tableWaterCoolerFan = fanTableFromJson( fan->value( "tableWaterCoolerFan", nlohmann::json() ) );
 
-      std::string tableWCFanJson = extractArray( fanJson, "tableWaterCoolerFan" );
-      if ( !tableWCFanJson.empty() )
-        profile.fan.tableWaterCoolerFan = parseFanTable( tableWCFanJson );
+      if ( const nlohmann::json *controller = jsonObject( *fan, "controller" ) )
+        profile.fan.controller = controllerSettingsFromJson( *controller );
 
       if ( profile.fan.hasEmbeddedTables() )
       {
@@ -263,48 +269,47 @@ public:
     }
 
     // Parse ODM profile
-    std::string odmProfileJson = extractObject( json, "odmProfile" );
-    if ( !odmProfileJson.empty() )
+    if ( const nlohmann::json *odmProfile = jsonObject( json, "odmProfile" ) )
     {
-      std::string odmName = extractString( odmProfileJson, "name" );
-      if ( !odmName.empty() )
-      {
-        profile.odmProfile.name = odmName;
-      }
+      if ( std::string odmName = jsonValue( *odmProfile, "name", std::string() ); !odmName.empty() )
+        profile.odmProfile.name = std::move( odmName );
     }
 
     // Parse ODM power limits
-    std::string odmPowerJson = extractObject( json, "odmPowerLimits" );
-    if ( !odmPowerJson.empty() )
+    if ( const nlohmann::json *odmPower = jsonObject( json, "odmPowerLimits" ) )
     {
-      profile.odmPowerLimits.tdpValues = extractIntArray( odmPowerJson, "tdpValues" );
+      if ( const auto tdp = odmPower->find( "tdpValues" ); tdp != odmPower->end() && tdp->is_array() )
+      {
+        for ( const auto &value : *tdp )
+          if ( value.is_number() )
+            profile.odmPowerLimits.tdpValues.push_back( jsonInt( value, 0 ) );
+      }
+      if ( const nlohmann::json *controller = jsonObject( *odmPower, "controller" ) )
+        profile.odmPowerLimits.controller = powerLimitControllerFromJson( *controller );
     }
 
-    // Parse keyboard settings
-    std::string keyboardJson = extractObject( json, "keyboard" );
-    if ( !keyboardJson.empty() )
+    // Parse keyboard settings; the object is kept whole for the keyboard controller
+    if ( const nlohmann::json *keyboard = jsonObject( json, "keyboard" ) )
     {
-      profile.keyboard.keyboardProfileData = keyboardJson;
-      profile.keyboard.keyboardProfileName = extractString( keyboardJson, "keyboardProfileName", "" );
+      profile.keyboard.keyboardProfileData = keyboard->dump();
+      profile.keyboard.keyboardProfileName = jsonValue( *keyboard, "keyboardProfileName", std::string() );
     }
 
     // Top-level selectedKeyboardProfile is the UUID written by the GUI
-    std::string topLevelKeyboardProfile = extractString( json, "selectedKeyboardProfile", "" );
-    if ( !topLevelKeyboardProfile.empty() )
-    {
-      profile.keyboard.keyboardProfileId = topLevelKeyboardProfile;
-    }
+    if ( std::string kbRef = jsonValue( json, "selectedKeyboardProfile", std::string() ); !kbRef.empty() )
+      profile.keyboard.keyboardProfileId = std::move( kbRef );
 
     // Parse GPU profile reference and embedded GPU OC data
-    profile.gpuProfileId = extractString( json, "gpuProfileId", "" );
-    profile.gpuOCProfileData = extractObject( json, "gpuOCProfileData" );
+    profile.gpuProfileId = jsonValue( json, "gpuProfileId", std::string() );
+    if ( const nlohmann::json *gpuOC = jsonObject( json, "gpuOCProfileData" ) )
+      profile.gpuOCProfileData = gpuOC->dump();
 
     // Parse charging profile (firmware-level charging mode stored per-profile)
-    profile.chargingProfile = extractString( json, "chargingProfile", "" );
-    profile.chargingPriority = extractString( json, "chargingPriority", "" );
-    profile.chargeType = extractString( json, "chargeType", "" );
-    profile.chargeStartThreshold = extractInt( json, "chargeStartThreshold", -1 );
-    profile.chargeEndThreshold = extractInt( json, "chargeEndThreshold", -1 );
+    profile.chargingProfile = jsonValue( json, "chargingProfile", std::string() );
+    profile.chargingPriority = jsonValue( json, "chargingPriority", std::string() );
+    profile.chargeType = jsonValue( json, "chargeType", std::string() );
+    profile.chargeStartThreshold = jsonValue( json, "chargeStartThreshold", -1 );
+    profile.chargeEndThreshold = jsonValue( json, "chargeEndThreshold", -1 );
 
     return profile;
   }
@@ -325,48 +330,28 @@ public:
 
   /**
    * @brief Parse JSON array of profiles
+   *
+   * The buffer is parsed once and every element filled in place; elements
+   * that are not objects or have no id are skipped.
    * @param json JSON string containing profile array
-   * @return Vector of parsed profiles
+   * @return Vector of parsed profiles, empty if @p json is not a JSON array
    */
-  [[nodiscard]] static std::vector< UccProfile > parseProfilesJSON( const std::string &json )
+  [[nodiscard]] static std::vector< UccProfile > parseProfilesJSON( std::string_view json )
   {
     std::vector< UccProfile > profiles;
 
-    // Simple JSON array parser
-    size_t pos = json.find( '[' );
-    if ( pos == std::string::npos )
-    {
+    const auto array = nlohmann::json::parse( json, nullptr, false );
+    if ( array.is_discarded() || !array.is_array() )
       return profiles;
-    }
 
-    size_t depth = 0;
-    size_t start = pos + 1;
-
-    for ( size_t i = pos; i < json.length(); ++i )
+    profiles.reserve( array.size() );
+    for ( const auto &element : array )
     {
-      char c = json[ i ];
-
-      if ( c == '{' )
-      {
-        if ( depth == 0 )
-        {
-          start = i;
-        }
-        ++depth;
-      }
-      else if ( c == '}' )
-      {
-        --depth;
-        if ( depth == 0 )
-        {
-          std::string profileJson = json.substr( start, i - start + 1 );
-          auto profile = parseProfileJSON( profileJson );
-          if ( !profile.id.empty() )
-          {
-            profiles.push_back( profile );
-          }
-        }
-      }
+      if ( !element.is_object() )
+        continue;
+      auto profile = profileFromJson( element );
+      if ( !profile.id.empty() )
+        profiles.push_back( std::move( profile ) );
     }
 
     return profiles;
@@ -376,17 +361,17 @@ public:
    * @brief Resolve the startup profile for the current power state.
    *
    * Determines power state, looks up the assigned profile ID from the state map,
-   * and returns the parsed profile (from saved or built-in sources).
+   * and returns it from the saved or the built-in profiles.
    *
    * @param deviceId  Device identifier for device-specific built-in profiles
    * @param stateMap  Map of power-state string -> profile ID
-   * @param savedProfiles  Map of profile ID -> serialized JSON
+   * @param savedProfiles  Custom profiles, already parsed
    * @return The resolved UccProfile, or a default-constructed (empty) profile on failure
    */
   [[nodiscard]] UccProfile resolveStartupProfile(
     std::optional< UniwillDeviceID > deviceId,
     const std::map< std::string, std::string > &stateMap,
-    const std::map< std::string, std::string > &savedProfiles ) noexcept
+    const ProfileRepository &savedProfiles ) noexcept
   {
     ProfileState currentState = determineState();
     std::string stateKey = profileStateToString( currentState );
@@ -404,18 +389,10 @@ public:
     syslog( LOG_INFO, "[ProfileManager] State '%s' maps to profile: %s", stateKey.c_str(), profileId.c_str() );
 
     // Try saved (custom/persistent) profiles first
-    if ( auto savedProfileIt = savedProfiles.find( profileId ); savedProfileIt != savedProfiles.end() )
+    if ( const auto saved = savedProfiles.find( profileId ) )
     {
-      try
-      {
-        UccProfile profile = parseProfileJSON( savedProfileIt->second );
-        syslog( LOG_INFO, "[ProfileManager] Resolved saved profile: %s (ID: %s)", profile.name.c_str(), profile.id.c_str() );
-        return profile;
-      }
-      catch ( const std::exception &e )
-      {
-        syslog( LOG_ERR, "[ProfileManager] Failed to parse saved profile '%s': %s", profileId.c_str(), e.what() );
-      }
+      syslog( LOG_INFO, "[ProfileManager] Resolved saved profile: %s (ID: %s)", saved->name.c_str(), saved->id.c_str() );
+      return *saved;
     }
 
     // Fall back to built-in profiles
@@ -534,40 +511,34 @@ private:
    */
   [[nodiscard]] static std::vector< FanTableEntry > parseFanTable( const std::string &json )
   {
-    std::vector< FanTableEntry > table;
+    return fanTableFromJson( nlohmann::json::parse( json, nullptr, false ) );
+  }
 
-    size_t depth = 0;
-    size_t start = 0;
+  /**
+   * @brief Fan table entries of a JSON array of {temp, speed}; anything else is empty
+   */
+  [[nodiscard]] static std::vector< FanTableEntry > fanTableFromJson( const nlohmann::json &json )
+  {
+    std::vector< FanTableEntry > table;
+    if ( !json.is_array() )
+      return table;
 
-    for ( size_t i = 0; i < json.length(); ++i )
+    table.reserve( json.size() );
+    for ( const auto &entryJson : json )
     {
-      char c = json[ i ];
-
-      if ( c == '{' )
-      {
-        if ( depth == 0 )
-        {
-          start = i;
-        }
-        ++depth;
-      }
-      else if ( c == '}' )
-      {
-        --depth;
-        if ( depth == 0 )
-        {
-          std::string entryJson = json.substr( start, i - start + 1 );
-          FanTableEntry entry;
-          entry.temp = extractInt( entryJson, "temp", 0 );
-          entry.speed = extractInt( entryJson, "speed", 0 );
-          table.push_back( entry );
-        }
-      }
+      if ( !entryJson.is_object() )
+        continue;
+      FanTableEntry entry;
+      entry.temp = jsonValue( entryJson, "temp", 0 );
+      entry.speed = jsonValue( entryJson, "speed", 0 );
+      table.push_back( entry );
     }
 
     return table;
   }
 
+  // --- Public serialization utilities ---
+public:
   /**
    * @brief Serialize profiles to JSON array
    */
@@ -589,8 +560,6 @@ private:
     return oss.str();
   }
 
-  // --- Public serialization utilities ---
-public:
   /**
    * @brief Serialize single profile to JSON (complete format for file storage)
    * 
@@ -621,8 +590,24 @@ public:
         << "\"scalingMaxFrequency\":" << ( profile.cpu.scalingMaxFrequency.has_value() ? std::to_string( *profile.cpu.scalingMaxFrequency ) : "-1" ) << ","
         << "\"governor\":\"" << jsonEscape( profile.cpu.governor ) << "\","
         << "\"energyPerformancePreference\":\"" << jsonEscape( profile.cpu.energyPerformancePreference ) << "\","
-        << "\"noTurbo\":" << ( profile.cpu.noTurbo ? "true" : "false" )
-        << "},"
+        << "\"noTurbo\":" << ( profile.cpu.noTurbo ? "true" : "false" );
+    if ( profile.cpu.performanceCores != UccProfileCpuClass() )
+    {
+      oss << ",\"performanceCores\":" << coreClassToJSON( profile.cpu.performanceCores );
+    }
+    if ( profile.cpu.efficiencyCores != UccProfileCpuClass() )
+    {
+      oss << ",\"efficiencyCores\":" << coreClassToJSON( profile.cpu.efficiencyCores );
+    }
+    if ( not profile.cpu.coreParking.empty() )
+    {
+      oss << ",\"coreParking\":\"" << jsonEscape( profile.cpu.coreParking ) << "\"";
+    }
+    if ( not profile.cpu.adaptiveEpp.empty() )
+    {
+      oss << ",\"adaptiveEpp\":" << stringsToJSON( profile.cpu.adaptiveEpp );
+    }
+    oss << "},"
         << "\"webcam\":{"
         << "\"status\":" << ( profile.webcam.status ? "true" : "false" ) << ","
         << "\"useStatus\":" << ( profile.webcam.useStatus ? "true" : "false" )
@@ -651,6 +636,10 @@ public:
     {
       oss << ",\"tableWaterCoolerFan\":" << fanTableToJSON( profile.fan.tableWaterCoolerFan );
     }
+    if ( profile.fan.controller != FanControllerSettings() )
+    {
+      oss << ",\"controller\":" << controllerToJSON( profile.fan.controller );
+    }
 
     oss << "},"
         << "\"odmProfile\":{"
@@ -665,7 +654,12 @@ public:
       oss << profile.odmPowerLimits.tdpValues[ i ];
     }
 
-    oss << "]}";
+    oss << "]";
+    if ( profile.odmPowerLimits.controller != PowerLimitControllerSettings() )
+    {
+      oss << ",\"controller\":" << powerLimitControllerToJSON( profile.odmPowerLimits.controller );
+    }
+    oss << "}";
 
     // GPU OC profile reference and embedded data
     if ( !profile.gpuProfileId.empty() )
@@ -747,268 +741,205 @@ public:
     return oss.str();
   }
 
-private:
-  // JSON parsing helper functions
-  [[nodiscard]] static std::string extractString( const std::string &json, const std::string &key, const std::string &defaultValue = "" )
+  /**
+   * @brief Serialize fan controller settings to JSON
+   */
+  [[nodiscard]] static std::string controllerToJSON( const FanControllerSettings &controller )
   {
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = json.find( searchKey );
-    if ( pos == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    pos = json.find( ':', pos );
-    if ( pos == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    pos = json.find( '"', pos );
-    if ( pos == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    size_t end = json.find( '"', pos + 1 );
-    if ( end == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    return json.substr( pos + 1, end - pos - 1 );
+    std::ostringstream oss;
+    oss << "{"
+        << "\"mode\":\"" << FanControllerSettings::modeName( controller.mode ) << "\","
+        << "\"targetTemp\":" << controller.targetTemp << ","
+        << "\"kp\":" << controller.kp << ","
+        << "\"ki\":" << controller.ki << ","
+        << "\"kd\":" << controller.kd << ","
+        << "\"feedForwardPerWatt\":" << controller.feedForwardPerWatt << ","
+        << "\"idleWatts\":" << controller.idleWatts << ","
+        << "\"preRampDegPerWatt\":" << controller.preRampDegPerWatt << ","
+        << "\"preRampMaxDeg\":" << controller.preRampMaxDeg
+        << "}";
+    return oss.str();
   }
 
-  [[nodiscard]] static int32_t extractInt( const std::string &json, const std::string &key, int32_t defaultValue = 0 )
+  /**
+   * @brief Serialize ODM power limit controller settings to JSON
+   */
+  [[nodiscard]] static std::string powerLimitControllerToJSON( const PowerLimitControllerSettings &controller )
   {
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = json.find( searchKey );
-    if ( pos == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    pos = json.find( ':', pos );
-    if ( pos == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    // Skip whitespace
-    ++pos;
-    while ( pos < json.length() && std::isspace( json[ pos ] ) )
-    {
-      ++pos;
-    }
-
-    if ( pos >= json.length() )
-    {
-      return defaultValue;
-    }
-
-    // Parse number
-    size_t end = pos;
-    if ( json[ end ] == '-' )
-    {
-      ++end;
-    }
-
-    while ( end < json.length() && std::isdigit( json[ end ] ) )
-    {
-      ++end;
-    }
-
-    if ( end == pos || ( end == pos + 1 && json[ pos ] == '-' ) )
-    {
-      return defaultValue;
-    }
-
-    try
-    {
-      return std::stoi( json.substr( pos, end - pos ) );
-    }
-    catch ( ... )
-    {
-      return defaultValue;
-    }
+    std::ostringstream oss;
+    oss << "{"
+        << "\"mode\":\"" << PowerLimitControllerSettings::modeName( controller.mode ) << "\","
+        << "\"targetTemp\":" << controller.targetTemp << ","
+        << "\"fanDutyLimit\":" << controller.fanDutyLimit << ","
+        << "\"floorPercent\":" << controller.floorPercent << ","
+        << "\"riseWattsPerSecond\":" << controller.riseWattsPerSecond << ","
+        << "\"fallWattsPerSecond\":" << controller.fallWattsPerSecond << ","
+        << "\"gpuShareWatts\":" << controller.gpuShareWatts
+        << "}";
+    return oss.str();
   }
 
-  [[nodiscard]] static bool extractBool( const std::string &json, const std::string &key, bool defaultValue = false )
+  /**
+   * @brief Serialize the limits of one core class to JSON
+   */
+  [[nodiscard]] static std::string coreClassToJSON( const UccProfileCpuClass &coreClass )
   {
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = json.find( searchKey );
-    if ( pos == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    pos = json.find( ':', pos );
-    if ( pos == std::string::npos )
-    {
-      return defaultValue;
-    }
-
-    size_t truePos = json.find( "true", pos );
-    size_t falsePos = json.find( "false", pos );
-    size_t commaPos = json.find( ',', pos );
-    size_t bracePos = json.find( '}', pos );
-
-    size_t nextDelimiter = std::min( commaPos, bracePos );
-
-    if ( truePos != std::string::npos && truePos < nextDelimiter )
-    {
-      return true;
-    }
-    if ( falsePos != std::string::npos && falsePos < nextDelimiter )
-    {
-      return false;
-    }
-
-    return defaultValue;
+    std::ostringstream oss;
+    oss << "{"
+        << "\"onlineCores\":" << coreClass.onlineCores.value_or( -1 ) << ","
+        << "\"scalingMaxFrequency\":" << coreClass.scalingMaxFrequency.value_or( -1 ) << ","
+        << "\"energyPerformancePreference\":\"" << jsonEscape( coreClass.energyPerformancePreference ) << "\""
+        << "}";
+    return oss.str();
   }
 
-  [[nodiscard]] static std::string extractObject( const std::string &json, const std::string &key )
+  /**
+   * @brief Serialize a list of strings to a JSON array
+   */
+  [[nodiscard]] static std::string stringsToJSON( const std::vector< std::string > &strings )
   {
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = json.find( searchKey );
-    if ( pos == std::string::npos )
-    {
-      return "";
-    }
-
-    pos = json.find( ':', pos );
-    if ( pos == std::string::npos )
-    {
-      return "";
-    }
-
-    pos = json.find( '{', pos );
-    if ( pos == std::string::npos )
-    {
-      return "";
-    }
-
-    size_t depth = 1;
-    size_t start = pos;
-    ++pos;
-
-    while ( pos < json.length() && depth > 0 )
-    {
-      if ( json[ pos ] == '{' )
-      {
-        ++depth;
-      }
-      else if ( json[ pos ] == '}' )
-      {
-        --depth;
-      }
-      ++pos;
-    }
-
-    if ( depth == 0 )
+    std::ostringstream oss;
+    oss << "[";
+    for ( size_t i = 0; i < strings.size(); ++i )
     {
-      return json.substr( start, pos - start );
+      if ( i > 0 ) oss << ",";
+      oss << "\"" << jsonEscape( strings[ i ] ) << "\"";
     }
+    oss << "]";
+    return oss.str();
+  }
 
-    return "";
+  [[nodiscard]] static UccProfileCpuClass coreClassFromJson( const nlohmann::json &json )
+  {
+    UccProfileCpuClass coreClass;
+    if ( const int32_t onlineCores = jsonValue( json, "onlineCores", -1 ); onlineCores >= 0 )
+      coreClass.onlineCores = onlineCores;
+    if ( const int32_t scalingMax = jsonValue( json, "scalingMaxFrequency", -1 ); scalingMax >= 0 )
+      coreClass.scalingMaxFrequency = scalingMax;
+    coreClass.energyPerformancePreference = jsonValue( json, "energyPerformancePreference", std::string() );
+    return coreClass;
   }
 
-  [[nodiscard]] static std::string extractArray( const std::string &json, const std::string &key )
+  /**
+   * @brief Parse a fan "controller" object; missing or invalid fields keep their defaults
+   */
+  [[nodiscard]] static FanControllerSettings parseControllerSettings( const std::string &json )
   {
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = json.find( searchKey );
-    if ( pos == std::string::npos )
-    {
-      return "";
-    }
+    return controllerSettingsFromJson( nlohmann::json::parse( json, nullptr, false ) );
+  }
 
-    pos = json.find( ':', pos );
-    if ( pos == std::string::npos )
-    {
-      return "";
-    }
+  [[nodiscard]] static FanControllerSettings controllerSettingsFromJson( const nlohmann::json &json )
+  {
+    FanControllerSettings controller;
+    if ( const auto mode = FanControllerSettings::parseMode( jsonValue( json, "mode", std::string( "curve" ) ) ) )
+      controller.mode = *mode;
+    else
+      syslog( LOG_WARNING, "ProfileManager: unknown fan controller mode, using curve" );
+
+    controller.targetTemp = jsonValue( json, "targetTemp", controller.targetTemp );
+    controller.kp = jsonValue( json, "kp", controller.kp );
+    controller.ki = jsonValue( json, "ki", controller.ki );
+    controller.kd = jsonValue( json, "kd", controller.kd );
+    controller.feedForwardPerWatt = jsonValue( json, "feedForwardPerWatt", controller.feedForwardPerWatt );
+    controller.idleWatts = jsonValue( json, "idleWatts", controller.idleWatts );
+    controller.preRampDegPerWatt = jsonValue( json, "preRampDegPerWatt", controller.preRampDegPerWatt );
+    controller.preRampMaxDeg = jsonValue( json, "preRampMaxDeg", controller.preRampMaxDeg );
+    return clampControllerSettings( controller );
+  }
 
-    pos = json.find( '[', pos );
-    if ( pos == std::string::npos )
-    {
-      return "";
-    }
+  /**
+   * @brief Parse an ODM power limit "controller" object; missing or invalid fields keep their defaults
+   */
+  [[nodiscard]] static PowerLimitControllerSettings powerLimitControllerFromJson( const nlohmann::json &json )
+  {
+    PowerLimitControllerSettings controller;
+    if ( const auto mode = PowerLimitControllerSettings::parseMode( jsonValue( json, "mode", std::string( "static" ) ) ) )
+      controller.mode = *mode;
+    else
+      syslog( LOG_WARNING, "ProfileManager: unknown power limit controller mode, using static" );
+
+    controller.targetTemp = jsonValue( json, "targetTemp", controller.targetTemp );
+    controller.fanDutyLimit = jsonValue( json, "fanDutyLimit", controller.fanDutyLimit );
+    controller.floorPercent = jsonValue( json, "floorPercent", controller.floorPercent );
+    controller.riseWattsPerSecond = jsonValue( json, "riseWattsPerSecond", controller.riseWattsPerSecond );
+    controller.fallWattsPerSecond = jsonValue( json, "fallWattsPerSecond", controller.fallWattsPerSecond );
+    controller.gpuShareWatts = jsonValue( json, "gpuShareWatts", controller.gpuShareWatts );
+    return clampPowerLimitController( controller );
+  }
 
-    size_t depth = 1;
-    size_t start = pos;
-    ++pos;
+  /**
+   * @brief Bring client-supplied power limit controller settings into their valid ranges
+   */
+  [[nodiscard]] static PowerLimitControllerSettings clampPowerLimitController( PowerLimitControllerSettings controller )
+  {
+    controller.targetTemp = std::clamp( controller.targetTemp, 50, 100 );
+    controller.fanDutyLimit = std::clamp( controller.fanDutyLimit, 10, 100 );
+    controller.floorPercent = std::clamp( controller.floorPercent, 10, 100 );
+    controller.riseWattsPerSecond = std::clamp( controller.riseWattsPerSecond, 0.05, 20.0 );
+    controller.fallWattsPerSecond = std::clamp( controller.fallWattsPerSecond, 0.05, 50.0 );
+    controller.gpuShareWatts = std::clamp( controller.gpuShareWatts, 0, 100 );
+    return controller;
+  }
 
-    while ( pos < json.length() && depth > 0 )
-    {
-      if ( json[ pos ] == '[' )
-      {
-        ++depth;
-      }
-      else if ( json[ pos ] == ']' )
-      {
-        --depth;
-      }
-      ++pos;
-    }
+  /**
+   * @brief Bring client-supplied controller settings into their valid ranges
+   */
+  [[nodiscard]] static FanControllerSettings clampControllerSettings( FanControllerSettings controller )
+  {
+    controller.targetTemp = std::clamp( controller.targetTemp, 30, 95 );
+    controller.kp = std::max( 0.0, controller.kp );
+    controller.ki = std::max( 0.0, controller.ki );
+    controller.kd = std::max( 0.0, controller.kd );
+    controller.feedForwardPerWatt = std::max( 0.0, controller.feedForwardPerWatt );
+    controller.idleWatts = std::max( 0.0, controller.idleWatts );
+    controller.preRampDegPerWatt = std::clamp( controller.preRampDegPerWatt, 0.0, 5.0 );
+    controller.preRampMaxDeg = std::clamp( controller.preRampMaxDeg, 0, 30 );
+    return controller;
+  }
 
-    if ( depth == 0 )
-    {
-      return json.substr( start, pos - start );
-    }
+private:
+  // JSON parsing helper functions
 
-    return "";
+  /// @p key of @p object if it is an object itself, nullptr otherwise
+  [[nodiscard]] static const nlohmann::json *jsonObject( const nlohmann::json &object, const char *key )
+  {
+    if ( !object.is_object() )
+      return nullptr;
+    const auto it = object.find( key );
+    return it != object.end() && it->is_object() ? &*it : nullptr;
   }
 
-  [[nodiscard]] static std::vector< int32_t > extractIntArray( const std::string &json, const std::string &key )
+  /// Number as int32_t; fractions are truncated, out-of-range values give @p defaultValue
+  [[nodiscard]] static int32_t jsonInt( const nlohmann::json &value, int32_t defaultValue )
   {
-    std::vector< int32_t > result;
-    std::string arrayJson = extractArray( json, key );
+    const double number = value.get< double >();
+    if ( !std::isfinite( number ) || number < INT32_MIN || number > INT32_MAX )
+      return defaultValue;
+    return value.is_number_integer() ? static_cast< int32_t >( value.get< int64_t >() )
+                                     : static_cast< int32_t >( number );
+  }
 
-    if ( arrayJson.empty() )
-    {
-      return result;
-    }
+  /// @p key of @p object, or @p defaultValue when it is missing or of another type
+  template< typename T >
+  [[nodiscard]] static T jsonValue( const nlohmann::json &object, const char *key, T defaultValue )
+  {
+    if ( !object.is_object() )
+      return defaultValue;
+    const auto it = object.find( key );
+    if ( it == object.end() )
+      return defaultValue;
 
-    size_t pos = 1; // Skip opening '['
-    while ( pos < arrayJson.length() )
+    if constexpr ( std::is_same_v< T, bool > )
+      return it->is_boolean() ? it->template get< bool >() : defaultValue;
+    else if constexpr ( std::is_same_v< T, std::string > )
+      return it->is_string() ? it->template get< std::string >() : defaultValue;
+    else if constexpr ( std::is_integral_v< T > )
+      return it->is_number() ? static_cast< T >( jsonInt( *it, defaultValue ) ) : defaultValue;
+    else
     {
-      // Skip whitespace and commas
-      while ( pos < arrayJson.length() && ( std::isspace( arrayJson[ pos ] ) || arrayJson[ pos ] == ',' ) )
-      {
-        ++pos;
-      }
-
-      if ( pos >= arrayJson.length() || arrayJson[ pos ] == ']' )
-      {
-        break;
-      }
-
-      // Parse number
-      size_t start = pos;
-      if ( arrayJson[ pos ] == '-' )
-      {
-        ++pos;
-      }
-
-      while ( pos < arrayJson.length() && std::isdigit( arrayJson[ pos ] ) )
-      {
-        ++pos;
-      }
-
-      if ( pos > start )
-      {
-        try
-        {
-          result.push_back( std::stoi( arrayJson.substr( start, pos - start ) ) );
-        }
-        catch ( ... )
-        {
-          // Skip invalid numbers
-        }
-      }
+      static_assert( std::is_floating_point_v< T > );
+      return it->is_number() && std::isfinite( it->template get< double >() ) ? it->template get< T >() : defaultValue;
     }
-
-    return result;
   }
 
   [[nodiscard]] static std::string jsonEscape( const std::string &value )
@@ -1031,3 +962,9 @@ private:
     return oss.str();
   }
 };
+
+/// nlohmann ADL hook, so that a parsed array converts with get< std::vector< UccProfile > >()
+inline void from_json( const nlohmann::json &json, UccProfile &profile )
+{
+  profile = ProfileManager::profileFromJson( json );
+}
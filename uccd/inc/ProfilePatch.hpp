@@ -0,0 +1,145 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "ProfileManager.hpp"
+
+/**
+ * @brief Parts of a profile that are applied to hardware independently.
+ *
+ * UccDBusService::applyProfileSubsystems() runs one applier per bit, so a
+ * change confined to the fan curves leaves cpufreq, ODM/TDP, keyboard and
+ * GPU state alone.  Passive covers what the daemon only stores and
+ * publishes (names, refresh rate, webcam, profile references).
+ */
+namespace ProfileSubsystem
+{
+inline constexpr uint32_t Cpu      = 1u << 0;  ///< cores, cpufreq, governor, EPP, turbo
+inline constexpr uint32_t Tdp      = 1u << 1;  ///< ODM profile and power limits
+inline constexpr uint32_t Fan      = 1u << 2;  ///< fan curves, controller, pump
+inline constexpr uint32_t Keyboard = 1u << 3;  ///< keyboard backlight states
+inline constexpr uint32_t Charging = 1u << 4;  ///< charging profile, priority, thresholds
+inline constexpr uint32_t GpuOC    = 1u << 5;  ///< cTGP offset and NVIDIA OC data
+inline constexpr uint32_t Passive  = 1u << 6;
+inline constexpr uint32_t Display  = 1u << 7;  ///< backlight brightness
+inline constexpr uint32_t All      = ( 1u << 8 ) - 1;
+}
+
+/// Embedded JSON objects compare by value; a merge patch re-serializes them
+[[nodiscard]] inline bool sameJsonDocument( const std::string &a, const std::string &b )
+{
+  if ( a == b )
+    return true;
+  const auto ja = nlohmann::json::parse( a, nullptr, false );
+  const auto jb = nlohmann::json::parse( b, nullptr, false );
+  return !ja.is_discarded() && !jb.is_discarded() && ja == jb;
+}
+
+/// ProfileSubsystem bits in which @p a and @p b differ
+[[nodiscard]] inline uint32_t changedProfileSubsystems( const UccProfile &a, const UccProfile &b )
+{
+  uint32_t changed = 0;
+
+  if ( a.cpu.onlineCores != b.cpu.onlineCores
+       || a.cpu.scalingMinFrequency != b.cpu.scalingMinFrequency
+       || a.cpu.scalingMaxFrequency != b.cpu.scalingMaxFrequency
+       || a.cpu.governor != b.cpu.governor
+       || a.cpu.energyPerformancePreference != b.cpu.energyPerformancePreference
+       || a.cpu.noTurbo != b.cpu.noTurbo
+       || a.cpu.performanceCores != b.cpu.performanceCores
+       || a.cpu.efficiencyCores != b.cpu.efficiencyCores
+       || a.cpu.coreParking != b.cpu.coreParking
+       || a.cpu.adaptiveEpp != b.cpu.adaptiveEpp )
+    changed |= ProfileSubsystem::Cpu;
+
+  if ( a.odmProfile.name != b.odmProfile.name
+       || a.odmPowerLimits.tdpValues != b.odmPowerLimits.tdpValues
+       || a.odmPowerLimits.controller != b.odmPowerLimits.controller )
+    changed |= ProfileSubsystem::Tdp;
+
+  if ( a.fan.useControl != b.fan.useControl
+       || a.fan.fanProfile != b.fan.fanProfile
+       || a.fan.sameSpeed != b.fan.sameSpeed
+       || a.fan.autoControlWC != b.fan.autoControlWC
+       || a.fan.tableCPU != b.fan.tableCPU
+       || a.fan.tableGPU != b.fan.tableGPU
+       || a.fan.tablePump != b.fan.tablePump
+       || a.fan.tableWaterCoolerFan != b.fan.tableWaterCoolerFan
+       || a.fan.controller != b.fan.controller )
+    changed |= ProfileSubsystem::Fan;
+
+  if ( !sameJsonDocument( a.keyboard.keyboardProfileData, b.keyboard.keyboardProfileData ) )
+    changed |= ProfileSubsystem::Keyboard;
+
+  if ( a.chargingProfile != b.chargingProfile
+       || a.chargingPriority != b.chargingPriority
+       || a.chargeType != b.chargeType
+       || a.chargeStartThreshold != b.chargeStartThreshold
+       || a.chargeEndThreshold != b.chargeEndThreshold )
+    changed |= ProfileSubsystem::Charging;
+
+  if ( !sameJsonDocument( a.gpuOCProfileData, b.gpuOCProfileData ) )
+    changed |= ProfileSubsystem::GpuOC;
+
+  const auto &da = a.display;
+  const auto &db = b.display;
+  if ( da.brightness != db.brightness || da.useBrightness != db.useBrightness )
+    changed |= ProfileSubsystem::Display;
+
+  if ( a.id != b.id || a.name != b.name || a.description != b.description
+       || da.refreshRate != db.refreshRate || da.useRefRate != db.useRefRate
+       || da.xResolution != db.xResolution || da.yResolution != db.yResolution
+       || da.useResolution != db.useResolution
+       || a.webcam.status != b.webcam.status || a.webcam.useStatus != b.webcam.useStatus
+       || a.fan.enableWaterCooler != b.fan.enableWaterCooler
+       || a.keyboard.keyboardProfileName != b.keyboard.keyboardProfileName
+       || a.keyboard.keyboardProfileId != b.keyboard.keyboardProfileId
+       || a.gpuProfileId != b.gpuProfileId )
+    changed |= ProfileSubsystem::Passive;
+
+  return changed;
+}
+
+/**
+ * @brief Apply a JSON merge patch (RFC 7386) to a profile.
+ *
+ * The patch is merged into the profile's ProfileManager::profileToJSON()
+ * form and the result parsed back, so keys it leaves out keep their value
+ * and null removes a key (which then takes the parser's default).
+ * @return nullopt when @p patchJSON is not a JSON object or changes the id
+ */
+[[nodiscard]] inline std::optional< UccProfile > mergePatchProfile( const UccProfile &base,
+                                                                   const std::string &patchJSON )
+{
+  const auto patch = nlohmann::json::parse( patchJSON, nullptr, false );
+  if ( patch.is_discarded() || !patch.is_object() )
+    return std::nullopt;
+  if ( auto id = patch.find( "id" ); id != patch.end() && *id != base.id )
+    return std::nullopt;
+
+  auto merged = nlohmann::json::parse( ProfileManager::profileToJSON( base ), nullptr, false );
+  if ( merged.is_discarded() )
+    return std::nullopt;
+  merged.merge_patch( patch );
+
+  return ProfileManager::parseProfileJSON( merged.dump() );
+}
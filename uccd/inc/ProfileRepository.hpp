@@ -0,0 +1,138 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "profiles/UccProfile.hpp"
+
+/**
+ * @brief Parsed custom profiles, indexed by id.
+ *
+ * Profiles are parsed once, when loaded from the settings or received
+ * from a client, and are immutable from then on: every change builds a
+ * new ProfileSet sharing the untouched profiles with the previous one.  A
+ * snapshot() keeps seeing the set it was taken from, so a caller can walk
+ * it while the repository changes underneath.  Lookups by id are O(1);
+ * JSON is produced only when the profiles are saved or exported.
+ *
+ * Not thread-safe: the service touches it from the main thread only.
+ */
+class ProfileRepository
+{
+public:
+  using ProfilePtr = std::shared_ptr< const UccProfile >;
+
+  struct ProfileSet
+  {
+    std::unordered_map< std::string, ProfilePtr > byId;
+    std::vector< ProfilePtr > ordered;  ///< Insertion order, for listing and export
+  };
+  using Snapshot = std::shared_ptr< const ProfileSet >;
+
+  ProfileRepository() : m_set( std::make_shared< const ProfileSet >() ) {}
+
+  [[nodiscard]] Snapshot snapshot() const noexcept { return m_set; }
+
+  /// Profile with @p id, nullptr if there is none
+  [[nodiscard]] ProfilePtr find( const std::string &id ) const
+  {
+    const auto it = m_set->byId.find( id );
+    return it != m_set->byId.end() ? it->second : nullptr;
+  }
+
+  /// First profile named @p name in insertion order; O(n), names are not keys
+  [[nodiscard]] ProfilePtr findByName( const std::string &name ) const
+  {
+    for ( const auto &profile : m_set->ordered )
+      if ( profile->name == name )
+        return profile;
+    return nullptr;
+  }
+
+  [[nodiscard]] bool contains( const std::string &id ) const { return m_set->byId.contains( id ); }
+  [[nodiscard]] size_t size() const noexcept { return m_set->ordered.size(); }
+  [[nodiscard]] bool empty() const noexcept { return m_set->ordered.empty(); }
+
+  /// Copies of all profiles in insertion order
+  [[nodiscard]] std::vector< UccProfile > list() const
+  {
+    std::vector< UccProfile > profiles;
+    profiles.reserve( m_set->ordered.size() );
+    for ( const auto &profile : m_set->ordered )
+      profiles.push_back( *profile );
+    return profiles;
+  }
+
+  /// Insert @p profile, or replace the one with its id in place
+  void upsert( UccProfile profile )
+  {
+    auto next = std::make_shared< ProfileSet >( *m_set );
+    auto ptr = std::make_shared< const UccProfile >( std::move( profile ) );
+    if ( auto it = next->byId.find( ptr->id ); it != next->byId.end() )
+    {
+      for ( auto &slot : next->ordered )
+        if ( slot == it->second )
+          slot = ptr;
+      it->second = ptr;
+    }
+    else
+    {
+      next->byId.emplace( ptr->id, ptr );
+      next->ordered.push_back( ptr );
+    }
+    m_set = std::move( next );
+  }
+
+  /// Remove the profiles @p pred accepts; returns how many
+  template< typename Pred >
+  size_t eraseIf( Pred pred )
+  {
+    auto next = std::make_shared< ProfileSet >();
+    for ( const auto &profile : m_set->ordered )
+    {
+      if ( pred( *profile ) )
+        continue;
+      next->byId.emplace( profile->id, profile );
+      next->ordered.push_back( profile );
+    }
+    const size_t erased = m_set->ordered.size() - next->ordered.size();
+    if ( erased > 0 )
+      m_set = std::move( next );
+    return erased;
+  }
+
+  bool erase( const std::string &id )
+  {
+    return contains( id ) && eraseIf( [&id]( const UccProfile &p ) { return p.id == id; } ) > 0;
+  }
+
+  /// Replace everything; of profiles sharing an id the last one wins
+  void assign( std::vector< UccProfile > profiles )
+  {
+    m_set = std::make_shared< const ProfileSet >();
+    for ( auto &profile : profiles )
+      upsert( std::move( profile ) );
+  }
+
+private:
+  Snapshot m_set;
+};
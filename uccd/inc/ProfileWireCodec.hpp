@@ -0,0 +1,355 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ProfileManager.hpp"
+#include "ProfileWireTypes.hpp"
+
+#include <QJsonDocument>
+
+/**
+ * @brief UccProfile ↔ typed D-Bus form (see ProfileWireTypes.hpp).
+ *
+ * Field for field the counterpart of ProfileManager::profileToJSON() and
+ * parseProfileJSON(): same keys, same defaults for what is missing, same
+ * "-1 = not set" conventions and the same controller clamps.  Only the
+ * keyboard and GPU OC blobs, which UccProfile keeps as JSON text, pass
+ * through QJsonDocument.
+ */
+namespace profile_wire
+{
+
+inline ucc::WireFanTable fanTableToWire( const std::vector< FanTableEntry > &table )
+{
+  ucc::WireFanTable wire;
+  wire.reserve( static_cast< qsizetype >( table.size() ) );
+  for ( const auto &entry : table )
+    wire.append( { entry.temp, entry.speed } );
+  return wire;
+}
+
+inline std::vector< FanTableEntry > fanTableFromWire( const QVariant &value )
+{
+  std::vector< FanTableEntry > table;
+  for ( const auto &point : value.value< ucc::WireFanTable >() )
+    table.push_back( FanTableEntry{ point.temp, point.speed } );
+  return table;
+}
+
+/// JSON object text (keyboard, GPU OC) → a{sv}; empty for "{}" or bad JSON
+inline QVariantMap blobToWire( const std::string &json )
+{
+  if ( json.empty() || json == "{}" )
+    return {};
+  return ucc::jsonToWire( QJsonDocument::fromJson( QByteArray::fromStdString( json ) ).object() );
+}
+
+inline std::string blobFromWire( const QVariant &value )
+{
+  const QJsonObject object = ucc::wireToJson( value.toMap() );
+  if ( object.isEmpty() )
+    return {};
+  return QJsonDocument( object ).toJson( QJsonDocument::Compact ).toStdString();
+}
+
+inline QString qs( const std::string &s )
+{
+  return QString::fromStdString( s );
+}
+
+} // namespace profile_wire
+
+/// Profile → a{sv} with the keys of ProfileManager::profileToJSON()
+inline QVariantMap profileToWire( const UccProfile &profile )
+{
+  using profile_wire::qs;
+
+  QVariantMap display{
+    { QStringLiteral( "brightness" ), profile.display.brightness },
+    { QStringLiteral( "useBrightness" ), profile.display.useBrightness },
+    { QStringLiteral( "refreshRate" ), profile.display.refreshRate },
+    { QStringLiteral( "useRefRate" ), profile.display.useRefRate },
+    { QStringLiteral( "xResolution" ), profile.display.xResolution },
+    { QStringLiteral( "yResolution" ), profile.display.yResolution },
+    { QStringLiteral( "useResolution" ), profile.display.useResolution },
+  };
+
+  QVariantMap cpu{
+    { QStringLiteral( "onlineCores" ), profile.cpu.onlineCores.value_or( -1 ) },
+    { QStringLiteral( "scalingMinFrequency" ), profile.cpu.scalingMinFrequency.value_or( -1 ) },
+    { QStringLiteral( "scalingMaxFrequency" ), profile.cpu.scalingMaxFrequency.value_or( -1 ) },
+    { QStringLiteral( "governor" ), qs( profile.cpu.governor ) },
+    { QStringLiteral( "energyPerformancePreference" ), qs( profile.cpu.energyPerformancePreference ) },
+    { QStringLiteral( "noTurbo" ), profile.cpu.noTurbo },
+  };
+  const auto putCoreClass = [&cpu]( const char *key, const UccProfileCpuClass &coreClass ) {
+    if ( coreClass != UccProfileCpuClass() )
+      cpu.insert( QLatin1String( key ), QVariantMap{
+        { QStringLiteral( "onlineCores" ), coreClass.onlineCores.value_or( -1 ) },
+        { QStringLiteral( "scalingMaxFrequency" ), coreClass.scalingMaxFrequency.value_or( -1 ) },
+        { QStringLiteral( "energyPerformancePreference" ), qs( coreClass.energyPerformancePreference ) },
+      } );
+  };
+  putCoreClass( "performanceCores", profile.cpu.performanceCores );
+  putCoreClass( "efficiencyCores", profile.cpu.efficiencyCores );
+  if ( !profile.cpu.coreParking.empty() )
+    cpu.insert( QStringLiteral( "coreParking" ), qs( profile.cpu.coreParking ) );
+  if ( !profile.cpu.adaptiveEpp.empty() )
+  {
+    QStringList levels;
+    for ( const auto &level : profile.cpu.adaptiveEpp )
+      levels.append( qs( level ) );
+    cpu.insert( QStringLiteral( "adaptiveEpp" ), levels );
+  }
+
+  QVariantMap webcam{
+    { QStringLiteral( "status" ), profile.webcam.status },
+    { QStringLiteral( "useStatus" ), profile.webcam.useStatus },
+  };
+
+  QVariantMap fan{
+    { QStringLiteral( "useControl" ), profile.fan.useControl },
+    { QStringLiteral( "fanProfile" ), qs( profile.fan.fanProfile ) },
+    { QStringLiteral( "sameSpeed" ), profile.fan.sameSpeed },
+    { QStringLiteral( "autoControlWC" ), profile.fan.autoControlWC },
+    { QStringLiteral( "enableWaterCooler" ), profile.fan.enableWaterCooler },
+  };
+  const auto putTable = [&fan]( const char *key, const std::vector< FanTableEntry > &table ) {
+    if ( !table.empty() )
+      fan.insert( QLatin1String( key ), QVariant::fromValue( profile_wire::fanTableToWire( table ) ) );
+  };
+  putTable( "tableCPU", profile.fan.tableCPU );
+  putTable( "tableGPU", profile.fan.tableGPU );
+  putTable( "tablePump", profile.fan.tablePump );
+  putTable( "tableWaterCoolerFan", profile.fan.tableWaterCoolerFan );
+  if ( const auto &c = profile.fan.controller; c != FanControllerSettings() )
+  {
+    fan.insert( QStringLiteral( "controller" ), QVariantMap{
+      { QStringLiteral( "mode" ), QString::fromLatin1( FanControllerSettings::modeName( c.mode ) ) },
+      { QStringLiteral( "targetTemp" ), c.targetTemp },
+      { QStringLiteral( "kp" ), c.kp },
+      { QStringLiteral( "ki" ), c.ki },
+      { QStringLiteral( "kd" ), c.kd },
+      { QStringLiteral( "feedForwardPerWatt" ), c.feedForwardPerWatt },
+      { QStringLiteral( "idleWatts" ), c.idleWatts },
+      { QStringLiteral( "preRampDegPerWatt" ), c.preRampDegPerWatt },
+      { QStringLiteral( "preRampMaxDeg" ), c.preRampMaxDeg },
+    } );
+  }
+
+  QList< int > tdpValues;
+  for ( const int32_t value : profile.odmPowerLimits.tdpValues )
+    tdpValues.append( value );
+  QVariantMap odmPowerLimits{ { QStringLiteral( "tdpValues" ), QVariant::fromValue( tdpValues ) } };
+  if ( const auto &c = profile.odmPowerLimits.controller; c != PowerLimitControllerSettings() )
+  {
+    odmPowerLimits.insert( QStringLiteral( "controller" ), QVariantMap{
+      { QStringLiteral( "mode" ), QString::fromLatin1( PowerLimitControllerSettings::modeName( c.mode ) ) },
+      { QStringLiteral( "targetTemp" ), c.targetTemp },
+      { QStringLiteral( "fanDutyLimit" ), c.fanDutyLimit },
+      { QStringLiteral( "floorPercent" ), c.floorPercent },
+      { QStringLiteral( "riseWattsPerSecond" ), c.riseWattsPerSecond },
+      { QStringLiteral( "fallWattsPerSecond" ), c.fallWattsPerSecond },
+      { QStringLiteral( "gpuShareWatts" ), c.gpuShareWatts },
+    } );
+  }
+
+  QVariantMap map{
+    { QStringLiteral( "id" ), qs( profile.id ) },
+    { QStringLiteral( "name" ), qs( profile.name ) },
+    { QStringLiteral( "description" ), qs( profile.description ) },
+    { QStringLiteral( "display" ), display },
+    { QStringLiteral( "cpu" ), cpu },
+    { QStringLiteral( "webcam" ), webcam },
+    { QStringLiteral( "fan" ), fan },
+    { QStringLiteral( "odmProfile" ),
+      QVariantMap{ { QStringLiteral( "name" ), qs( profile.odmProfile.name.value_or( "" ) ) } } },
+    { QStringLiteral( "odmPowerLimits" ), odmPowerLimits },
+    { QStringLiteral( "keyboard" ), profile_wire::blobToWire( profile.keyboard.keyboardProfileData ) },
+  };
+
+  const auto putString = [&map]( const char *key, const std::string &value ) {
+    if ( !value.empty() )
+      map.insert( QLatin1String( key ), qs( value ) );
+  };
+  putString( "gpuProfileId", profile.gpuProfileId );
+  putString( "selectedKeyboardProfile", profile.keyboard.keyboardProfileId );
+  putString( "chargingProfile", profile.chargingProfile );
+  putString( "chargingPriority", profile.chargingPriority );
+  putString( "chargeType", profile.chargeType );
+  if ( const QVariantMap gpuOC = profile_wire::blobToWire( profile.gpuOCProfileData ); !gpuOC.isEmpty() )
+    map.insert( QStringLiteral( "gpuOCProfileData" ), gpuOC );
+  if ( profile.chargeStartThreshold >= 0 )
+    map.insert( QStringLiteral( "chargeStartThreshold" ), profile.chargeStartThreshold );
+  if ( profile.chargeEndThreshold >= 0 )
+    map.insert( QStringLiteral( "chargeEndThreshold" ), profile.chargeEndThreshold );
+  return map;
+}
+
+/**
+ * @brief a{sv} → profile, with the defaults of ProfileManager::parseProfileJSON()
+ * @param map  Already passed through ucc::plainDBusValue()
+ */
+inline UccProfile profileFromWire( const QVariantMap &map )
+{
+  const auto str = []( const QVariantMap &m, const char *key, const char *fallback = "" ) {
+    const auto it = m.constFind( QLatin1String( key ) );
+    return it == m.constEnd() ? std::string( fallback ) : it->toString().toStdString();
+  };
+  const auto num = []( const QVariantMap &m, const char *key, int32_t fallback ) {
+    const auto it = m.constFind( QLatin1String( key ) );
+    return it == m.constEnd() ? fallback : static_cast< int32_t >( it->toInt() );
+  };
+  const auto real = []( const QVariantMap &m, const char *key, double fallback ) {
+    const auto it = m.constFind( QLatin1String( key ) );
+    return it == m.constEnd() ? fallback : it->toDouble();
+  };
+  const auto flag = []( const QVariantMap &m, const char *key, bool fallback ) {
+    const auto it = m.constFind( QLatin1String( key ) );
+    return it == m.constEnd() ? fallback : it->toBool();
+  };
+  const auto section = [&map]( const char *key ) {
+    return map.value( QLatin1String( key ) ).toMap();
+  };
+
+  UccProfile profile;
+  profile.id = str( map, "id" );
+  profile.name = str( map, "name" );
+  profile.description = str( map, "description" );
+
+  if ( const QVariantMap display = section( "display" ); !display.isEmpty() )
+  {
+    profile.display.brightness = num( display, "brightness", 100 );
+    profile.display.useBrightness = flag( display, "useBrightness", false );
+    profile.display.refreshRate = num( display, "refreshRate", -1 );
+    profile.display.useRefRate = flag( display, "useRefRate", false );
+    profile.display.xResolution = num( display, "xResolution", -1 );
+    profile.display.yResolution = num( display, "yResolution", -1 );
+    profile.display.useResolution = flag( display, "useResolution", false );
+  }
+
+  if ( const QVariantMap cpu = section( "cpu" ); !cpu.isEmpty() )
+  {
+    const auto optionalNum = [&cpu, &num]( const char *key ) -> std::optional< int32_t > {
+      const int32_t value = num( cpu, key, -1 );
+      return value >= 0 ? std::optional< int32_t >( value ) : std::nullopt;
+    };
+    profile.cpu.onlineCores = optionalNum( "onlineCores" );
+    profile.cpu.scalingMinFrequency = optionalNum( "scalingMinFrequency" );
+    profile.cpu.scalingMaxFrequency = optionalNum( "scalingMaxFrequency" );
+    profile.cpu.governor = str( cpu, "governor" );
+    profile.cpu.energyPerformancePreference = str( cpu, "energyPerformancePreference" );
+    profile.cpu.noTurbo = flag( cpu, "noTurbo", false );
+
+    const auto coreClass = [&cpu, &num, &str]( const char *key ) {
+      const QVariantMap m = cpu.value( QLatin1String( key ) ).toMap();
+      UccProfileCpuClass limits;
+      if ( const int32_t onlineCores = num( m, "onlineCores", -1 ); onlineCores >= 0 )
+        limits.onlineCores = onlineCores;
+      if ( const int32_t scalingMax = num( m, "scalingMaxFrequency", -1 ); scalingMax >= 0 )
+        limits.scalingMaxFrequency = scalingMax;
+      limits.energyPerformancePreference = str( m, "energyPerformancePreference" );
+      return limits;
+    };
+    profile.cpu.performanceCores = coreClass( "performanceCores" );
+    profile.cpu.efficiencyCores = coreClass( "efficiencyCores" );
+    if ( const std::string parking = str( cpu, "coreParking" );
+         coreParkingPolicyFromString( parking ) != CoreParkingPolicy::Off )
+      profile.cpu.coreParking = parking;
+    for ( const QString &level : cpu.value( QStringLiteral( "adaptiveEpp" ) ).toStringList() )
+      if ( !level.isEmpty() )
+        profile.cpu.adaptiveEpp.push_back( level.toStdString() );
+    if ( profile.cpu.adaptiveEpp.size() < 2 )
+      profile.cpu.adaptiveEpp.clear();
+  }
+
+  if ( const QVariantMap webcam = section( "webcam" ); !webcam.isEmpty() )
+  {
+    profile.webcam.status = flag( webcam, "status", true );
+    profile.webcam.useStatus = flag( webcam, "useStatus", true );
+  }
+
+  if ( const QVariantMap fan = section( "fan" ); !fan.isEmpty() )
+  {
+    profile.fan.useControl = flag( fan, "useControl", true );
+    profile.fan.fanProfile = str( fan, "fanProfile", "fan-balanced" );
+    profile.fan.sameSpeed = flag( fan, "sameSpeed", true );
+    profile.fan.autoControlWC = flag( fan, "autoControlWC", true );
+    profile.fan.enableWaterCooler = flag( fan, "enableWaterCooler", ucc::WATER_COOLER_INITIAL_STATE );
+    profile.fan.tableCPU = profile_wire::fanTableFromWire( fan.value( QStringLiteral( "tableCPU" ) ) );
+    profile.fan.tableGPU = profile_wire::fanTableFromWire( fan.value( QStringLiteral( "tableGPU" ) ) );
+    profile.fan.tablePump = profile_wire::fanTableFromWire( fan.value( QStringLiteral( "tablePump" ) ) );
+    profile.fan.tableWaterCoolerFan =
+      profile_wire::fanTableFromWire( fan.value( QStringLiteral( "tableWaterCoolerFan" ) ) );
+
+    if ( const QVariantMap c = fan.value( QStringLiteral( "controller" ) ).toMap(); !c.isEmpty() )
+    {
+      FanControllerSettings controller;
+      if ( const auto mode = FanControllerSettings::parseMode( str( c, "mode", "curve" ) ) )
+        controller.mode = *mode;
+      else
+        syslog( LOG_WARNING, "ProfileManager: unknown fan controller mode, using curve" );
+      controller.targetTemp = num( c, "targetTemp", controller.targetTemp );
+      controller.kp = real( c, "kp", controller.kp );
+      controller.ki = real( c, "ki", controller.ki );
+      controller.kd = real( c, "kd", controller.kd );
+      controller.feedForwardPerWatt = real( c, "feedForwardPerWatt", controller.feedForwardPerWatt );
+      controller.idleWatts = real( c, "idleWatts", controller.idleWatts );
+      controller.preRampDegPerWatt = real( c, "preRampDegPerWatt", controller.preRampDegPerWatt );
+      controller.preRampMaxDeg = num( c, "preRampMaxDeg", controller.preRampMaxDeg );
+      profile.fan.controller = ProfileManager::clampControllerSettings( controller );
+    }
+  }
+
+  if ( const std::string odmName = str( section( "odmProfile" ), "name" ); !odmName.empty() )
+    profile.odmProfile.name = odmName;
+
+  const QVariantMap odmPowerLimits = section( "odmPowerLimits" );
+  for ( const int value : odmPowerLimits.value( QStringLiteral( "tdpValues" ) ).value< QList< int > >() )
+    profile.odmPowerLimits.tdpValues.push_back( value );
+  if ( const QVariantMap c = odmPowerLimits.value( QStringLiteral( "controller" ) ).toMap(); !c.isEmpty() )
+  {
+    PowerLimitControllerSettings controller;
+    if ( const auto mode = PowerLimitControllerSettings::parseMode( str( c, "mode", "static" ) ) )
+      controller.mode = *mode;
+    else
+      syslog( LOG_WARNING, "ProfileManager: unknown power limit controller mode, using static" );
+    controller.targetTemp = num( c, "targetTemp", controller.targetTemp );
+    controller.fanDutyLimit = num( c, "fanDutyLimit", controller.fanDutyLimit );
+    controller.floorPercent = num( c, "floorPercent", controller.floorPercent );
+    controller.riseWattsPerSecond = real( c, "riseWattsPerSecond", controller.riseWattsPerSecond );
+    controller.fallWattsPerSecond = real( c, "fallWattsPerSecond", controller.fallWattsPerSecond );
+    controller.gpuShareWatts = num( c, "gpuShareWatts", controller.gpuShareWatts );
+    profile.odmPowerLimits.controller = ProfileManager::clampPowerLimitController( controller );
+  }
+
+  if ( const QVariant keyboard = map.value( QStringLiteral( "keyboard" ) ); !keyboard.toMap().isEmpty() )
+  {
+    profile.keyboard.keyboardProfileData = profile_wire::blobFromWire( keyboard );
+    profile.keyboard.keyboardProfileName = str( keyboard.toMap(), "keyboardProfileName" );
+  }
+  profile.keyboard.keyboardProfileId = str( map, "selectedKeyboardProfile" );
+
+  profile.gpuProfileId = str( map, "gpuProfileId" );
+  profile.gpuOCProfileData = profile_wire::blobFromWire( map.value( QStringLiteral( "gpuOCProfileData" ) ) );
+
+  profile.chargingProfile = str( map, "chargingProfile" );
+  profile.chargingPriority = str( map, "chargingPriority" );
+  profile.chargeType = str( map, "chargeType" );
+  profile.chargeStartThreshold = num( map, "chargeStartThreshold", -1 );
+  profile.chargeEndThreshold = num( map, "chargeEndThreshold", -1 );
+  return profile;
+}
@@ -0,0 +1,98 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+/// Value of one exported D-Bus property (b, i or s)
+using PropertyValue = std::variant< bool, int32_t, std::string >;
+
+/// Property name → value, ordered so change sets come out deterministic
+using PropertyMap = std::map< std::string, PropertyValue, std::less<> >;
+
+/**
+ * @brief Remembers the last published value of each property and reports
+ *        only the ones that differ.
+ *
+ * Feed it a full snapshot each tick, or set() the properties one by one
+ * and takeChanged(); the returned map is what belongs in
+ * org.freedesktop.DBus.Properties.PropertiesChanged.  The first snapshot
+ * is returned whole so the published set starts complete.  set() compares
+ * in place, so a tick on which nothing changed allocates nothing.
+ *
+ * Not thread-safe; owned by the service worker.
+ */
+class PropertyChangeTracker
+{
+public:
+  /**
+   * @brief Store @p snapshot as the published state.
+   * @return Entries that are new or changed since the previous call
+   */
+  [[nodiscard]] PropertyMap update( PropertyMap snapshot )
+  {
+    PropertyMap changed;
+    for ( auto &[ name, value ] : snapshot )
+    {
+      const auto it = m_published.find( name );
+      if ( it == m_published.end() || it->second != value )
+        changed.emplace( name, value );
+    }
+    m_published = std::move( snapshot );
+    return changed;
+  }
+
+  /// Compare one property with its published value; a changed one is queued for takeChanged()
+  void set( std::string_view name, bool value ) { stage< bool >( name, value ); }
+  void set( std::string_view name, int32_t value ) { stage< int32_t >( name, value ); }
+  void set( std::string_view name, std::string_view value ) { stage< std::string >( name, value ); }
+  void set( std::string_view name, const char *value ) { stage< std::string >( name, std::string_view( value ) ); }
+
+  /// Entries set() found new or changed since the previous call
+  [[nodiscard]] PropertyMap takeChanged() { return std::exchange( m_changed, PropertyMap() ); }
+
+  /// Last snapshot passed to update()
+  [[nodiscard]] const PropertyMap &published() const noexcept { return m_published; }
+
+  /// Forget the published state; the next update() reports everything
+  void reset() noexcept
+  {
+    m_published.clear();
+    m_changed.clear();
+  }
+
+private:
+  template< typename T, typename V >
+  void stage( std::string_view name, const V &value )
+  {
+    auto it = m_published.find( name );
+    if ( it != m_published.end() && std::holds_alternative< T >( it->second ) && std::get< T >( it->second ) == value )
+      return;
+    if ( it == m_published.end() )
+      it = m_published.emplace( std::string( name ), T( value ) ).first;
+    else
+      it->second = T( value );
+    m_changed.insert_or_assign( it->first, it->second );
+  }
+
+  PropertyMap m_published;
+  PropertyMap m_changed;  ///< What set() found changed since takeChanged()
+};
@@ -0,0 +1,418 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief RAPL power domains, summed over all CPU packages.
+ */
+enum class RaplDomain : uint8_t
+{
+  Package,  ///< Whole socket (package-N)
+  Core,     ///< CPU cores (PP0)
+  Uncore,   ///< Integrated GPU and uncore (PP1)
+  Dram,
+  Psys,     ///< Platform (SoC + PCH + eDRAM)
+  Count     ///< Sentinel — must be last
+};
+
+static constexpr size_t RAPL_DOMAIN_COUNT = static_cast< size_t >( RaplDomain::Count );
+
+/// Watts per RaplDomain, -1.0 where the domain is absent or not yet sampled
+using RaplDomainWatts = std::array< double, RAPL_DOMAIN_COUNT >;
+
+/**
+ * @brief Key of a domain in the CPU power JSON.
+ */
+constexpr const char *raplDomainName( RaplDomain domain ) noexcept
+{
+  switch ( domain )
+  {
+    case RaplDomain::Package: return "package";
+    case RaplDomain::Core:    return "core";
+    case RaplDomain::Uncore:  return "uncore";
+    case RaplDomain::Dram:    return "dram";
+    case RaplDomain::Psys:    return "psys";
+    default:                  return "unknown";
+  }
+}
+
+/**
+ * @brief Turns successive readings of an energy counter into watts.
+ *
+ * Intervals come from the steady clock, so NTP steps and suspend-time
+ * wall-clock changes do not distort the result.  A reading below the
+ * previous one is taken as a single wrap at @p maxRangeUj
+ * (max_energy_range_uj); without a known range it restarts the counter.
+ */
+class EnergyCounter
+{
+public:
+  explicit EnergyCounter( uint64_t maxRangeUj = 0 ) noexcept
+    : m_maxRangeUj( maxRangeUj )
+  {
+  }
+
+  static int64_t nowNs() noexcept
+  {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  /**
+   * @brief Feed a reading (µJ) taken at @p timestampNs.
+   * @return Average power since the previous reading, nullopt on the first
+   *         call, after a counter restart or for a non-advancing timestamp
+   */
+  [[nodiscard]] std::optional< double > update( uint64_t energyUj, int64_t timestampNs = nowNs() ) noexcept
+  {
+    if ( !m_primed )
+    {
+      prime( energyUj, timestampNs );
+      return std::nullopt;
+    }
+
+    const int64_t elapsedNs = timestampNs - m_lastNs;
+    if ( elapsedNs <= 0 )
+      return std::nullopt;
+
+    uint64_t deltaUj;
+    if ( energyUj >= m_lastUj )
+      deltaUj = energyUj - m_lastUj;
+    else if ( m_maxRangeUj > 0 && m_lastUj <= m_maxRangeUj )
+      deltaUj = ( m_maxRangeUj - m_lastUj ) + energyUj;
+    else
+    {
+      prime( energyUj, timestampNs );
+      return std::nullopt;
+    }
+
+    m_lastUj = energyUj;
+    m_lastNs = timestampNs;
+    // µJ / ns = 1e3 W
+    return static_cast< double >( deltaUj ) * 1e3 / static_cast< double >( elapsedNs );
+  }
+
+  void reset() noexcept { m_primed = false; }
+
+  [[nodiscard]] uint64_t maxRangeUj() const noexcept { return m_maxRangeUj; }
+
+private:
+  void prime( uint64_t energyUj, int64_t timestampNs ) noexcept
+  {
+    m_primed = true;
+    m_lastUj = energyUj;
+    m_lastNs = timestampNs;
+  }
+
+  uint64_t m_maxRangeUj;
+  uint64_t m_lastUj = 0;
+  int64_t m_lastNs = 0;
+  bool m_primed = false;
+};
+
+/**
+ * @brief Per-domain power from the kernel energy counters.
+ *
+ * discover() looks for the powercap "intel-rapl" zones, which the kernel
+ * also registers for AMD Zen (package and core).  Zones are matched by
+ * their name attribute, so package-0/package-1 and their subzones are
+ * summed per domain regardless of numbering; the MMIO duplicate of the
+ * package zone is skipped.  Without powercap zones it falls back to the
+ * amd_energy hwmon driver (Esocket* → package, Ecore* → core).
+ *
+ * A domain reports -1.0 until every one of its counters has two readings.
+ */
+class RaplDomainSampler
+{
+public:
+  enum class Source
+  {
+    None,
+    Powercap,
+    AmdEnergy,
+  };
+
+  explicit RaplDomainSampler( std::string powercapRoot = ucc::sysfsPath( "/sys/class/powercap" ),
+                              std::string hwmonRoot = ucc::sysfsPath( "/sys/class/hwmon" ) )
+    : m_powercapRoot( std::move( powercapRoot ) )
+    , m_hwmonRoot( std::move( hwmonRoot ) )
+  {
+  }
+
+  /**
+   * @brief (Re)scan the counters; previous readings are dropped.
+   */
+  void discover() noexcept
+  {
+    m_counters.clear();
+    m_source = Source::None;
+    try
+    {
+      if ( discoverPowercap() )
+        m_source = Source::Powercap;
+      else if ( discoverAmdEnergy() )
+        m_source = Source::AmdEnergy;
+    }
+    catch ( ... )
+    {
+      m_counters.clear();
+    }
+  }
+
+  [[nodiscard]] Source source() const noexcept { return m_source; }
+
+  [[nodiscard]] bool available( RaplDomain domain ) const noexcept
+  {
+    return std::any_of( m_counters.begin(), m_counters.end(),
+                        [domain]( const Counter &c ) { return c.domain == domain; } );
+  }
+
+  /**
+   * @brief Read every counter once and return the watts per domain.
+   */
+  [[nodiscard]] RaplDomainWatts sample( int64_t timestampNs = EnergyCounter::nowNs() ) noexcept
+  {
+    RaplDomainWatts watts;
+    watts.fill( -1.0 );
+    std::array< bool, RAPL_DOMAIN_COUNT > incomplete{};
+
+    for ( auto &counter : m_counters )
+    {
+      const size_t i = static_cast< size_t >( counter.domain );
+      const auto energy = counter.node.read();
+      std::optional< double > w;
+      if ( energy && *energy >= 0 )
+        w = counter.energy.update( static_cast< uint64_t >( *energy ), timestampNs );
+
+      if ( !w )
+      {
+        // a partial sum over the packages would under-report
+        incomplete[ i ] = true;
+        continue;
+      }
+      watts[ i ] = watts[ i ] < 0.0 ? *w : watts[ i ] + *w;
+    }
+
+    for ( size_t i = 0; i < RAPL_DOMAIN_COUNT; ++i )
+      if ( incomplete[ i ] )
+        watts[ i ] = -1.0;
+    return watts;
+  }
+
+private:
+  struct Counter
+  {
+    RaplDomain domain;
+    SysfsNode< int64_t > node;
+    EnergyCounter energy;
+  };
+
+  static std::optional< RaplDomain > powercapDomain( const std::string &name ) noexcept
+  {
+    if ( name.rfind( "package-", 0 ) == 0 )
+      return RaplDomain::Package;
+    if ( name == "core" )
+      return RaplDomain::Core;
+    if ( name == "uncore" )
+      return RaplDomain::Uncore;
+    if ( name == "dram" )
+      return RaplDomain::Dram;
+    if ( name == "psys" )
+      return RaplDomain::Psys;
+    return std::nullopt;
+  }
+
+  static std::vector< std::filesystem::path > sortedEntries( const std::string &root )
+  {
+    std::vector< std::filesystem::path > entries;
+    std::error_code ec;
+    for ( const auto &entry : std::filesystem::directory_iterator( root, ec ) )
+      entries.push_back( entry.path() );
+    std::sort( entries.begin(), entries.end() );
+    return entries;
+  }
+
+  bool discoverPowercap()
+  {
+    for ( const auto &zone : sortedEntries( m_powercapRoot ) )
+    {
+      // intel-rapl:N and intel-rapl:N:M; not the control type or intel-rapl-mmio:N
+      if ( zone.filename().string().rfind( "intel-rapl:", 0 ) != 0 )
+        continue;
+
+      const auto name = SysfsNode< std::string >( ( zone / "name" ).string() ).read();
+      const auto domain = name ? powercapDomain( *name ) : std::nullopt;
+      if ( !domain )
+        continue;
+
+      SysfsNode< int64_t > energy( ( zone / "energy_uj" ).string(), SysfsReadMode::Cached );
+      if ( !energy.read() )
+        continue;
+
+      const auto range = SysfsNode< int64_t >( ( zone / "max_energy_range_uj" ).string() ).read();
+      const uint64_t maxRange = range && *range > 0 ? static_cast< uint64_t >( *range ) : 0;
+      m_counters.push_back( Counter{ *domain, std::move( energy ), EnergyCounter( maxRange ) } );
+    }
+    return !m_counters.empty();
+  }
+
+  bool discoverAmdEnergy()
+  {
+    for ( const auto &hwmon : sortedEntries( m_hwmonRoot ) )
+    {
+      const auto name = SysfsNode< std::string >( ( hwmon / "name" ).string() ).read();
+      if ( !name || *name != "amd_energy" )
+        continue;
+
+      for ( const auto &file : sortedEntries( hwmon.string() ) )
+      {
+        const std::string fileName = file.filename().string();
+        if ( fileName.rfind( "energy", 0 ) != 0 || !fileName.ends_with( "_label" ) )
+          continue;
+
+        const auto label = SysfsNode< std::string >( file.string() ).read();
+        std::optional< RaplDomain > domain;
+        if ( label && label->rfind( "Esocket", 0 ) == 0 )
+          domain = RaplDomain::Package;
+        else if ( label && label->rfind( "Ecore", 0 ) == 0 )
+          domain = RaplDomain::Core;
+        if ( !domain )
+          continue;
+
+        const std::string input = fileName.substr( 0, fileName.size() - 6 ) + "_input";
+        SysfsNode< int64_t > energy( ( hwmon / input ).string(), SysfsReadMode::Cached );
+        if ( !energy.read() )
+          continue;
+        // the driver accumulates the 32-bit MSRs into 64-bit counters
+        m_counters.push_back( Counter{ *domain, std::move( energy ), EnergyCounter() } );
+      }
+    }
+    return !m_counters.empty();
+  }
+
+  std::string m_powercapRoot;
+  std::string m_hwmonRoot;
+  std::vector< Counter > m_counters;
+  Source m_source = Source::None;
+};
+
+/**
+ * @brief The writable RAPL package limits: PL1 ("long_term") and PL2
+ *        ("short_term") of every package zone.
+ *
+ * Firmware locks them on many machines; discover() then finds nothing and
+ * write() does nothing.  The limits found at discover() are put back by
+ * restore() once the caller stops managing them.
+ */
+class RaplPowerLimits
+{
+public:
+  explicit RaplPowerLimits( std::string powercapRoot = ucc::sysfsPath( "/sys/class/powercap" ) )
+    : m_powercapRoot( std::move( powercapRoot ) )
+  {
+  }
+
+  void discover()
+  {
+    m_limits.clear();
+    std::error_code ec;
+    for ( const auto &entry : std::filesystem::directory_iterator( m_powercapRoot, ec ) )
+    {
+      const auto zone = entry.path();
+      const std::string dir = zone.filename().string();
+      // package zones only: intel-rapl:N, not their subzones nor intel-rapl-mmio:N
+      if ( dir.rfind( "intel-rapl:", 0 ) != 0 || dir.find( ':', 11 ) != std::string::npos )
+        continue;
+      const auto name = SysfsNode< std::string >( ( zone / "name" ).string() ).read();
+      if ( !name || name->rfind( "package-", 0 ) != 0 )
+        continue;
+
+      for ( int constraint = 0; constraint < 2; ++constraint )
+      {
+        const std::string prefix = ( zone / ( "constraint_" + std::to_string( constraint ) + "_" ) ).string();
+        const auto kind = SysfsNode< std::string >( prefix + "name" ).read();
+        const bool pl1 = kind && *kind == "long_term";
+        if ( !pl1 && !( kind && *kind == "short_term" ) )
+          continue;
+        const std::string path = prefix + "power_limit_uw";
+        const auto original = SysfsNode< int64_t >( path ).read();
+        if ( !original || *original <= 0 || ::access( path.c_str(), W_OK ) != 0 )
+          continue;
+        m_limits.push_back( Limit{ pl1, path, *original, *original } );
+      }
+    }
+  }
+
+  [[nodiscard]] bool available() const noexcept { return !m_limits.empty(); }
+
+  /**
+   * @brief Set PL1 and PL2 of every package; a value <= 0 leaves that limit alone
+   * @return false if a write failed
+   */
+  bool write( int32_t pl1Watts, int32_t pl2Watts )
+  {
+    bool ok = true;
+    for ( auto &limit : m_limits )
+    {
+      const int32_t watts = limit.pl1 ? pl1Watts : pl2Watts;
+      if ( watts > 0 )
+        ok = set( limit, static_cast< int64_t >( watts ) * 1'000'000 ) && ok;
+    }
+    return ok;
+  }
+
+  void restore()
+  {
+    for ( auto &limit : m_limits )
+      set( limit, limit.original );
+  }
+
+private:
+  struct Limit
+  {
+    bool pl1;
+    std::string path;
+    int64_t original;  ///< µW
+    int64_t current;   ///< µW
+  };
+
+  static bool set( Limit &limit, int64_t microwatts )
+  {
+    if ( limit.current == microwatts )
+      return true;
+    if ( !SysfsNode< int64_t >( limit.path ).write( microwatts ) )
+      return false;
+    limit.current = microwatts;
+    return true;
+  }
+
+  std::string m_powercapRoot;
+  std::vector< Limit > m_limits;
+};
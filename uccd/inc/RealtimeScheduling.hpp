@@ -0,0 +1,67 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace ucc
+{
+
+/// How far raiseCurrentThread() got
+enum class ThreadPriority
+{
+  Realtime,  ///< SCHED_FIFO
+  Nice,      ///< refused real time; a negative nice instead
+  Unchanged,
+};
+
+/**
+ * @brief Run the calling thread at SCHED_FIFO @p priority
+ *
+ * A low priority is enough: above it is every CFS task of a loaded
+ * machine, below it the kernel's threaded interrupts (50).  Where real
+ * time is refused (a cgroup without an RT budget, no CAP_SYS_NICE) the
+ * thread gets @p fallbackNice instead, which still shortens its wakeup
+ * latency under CFS.  Children do not inherit either.
+ */
+inline ThreadPriority raiseCurrentThread( int priority, int fallbackNice ) noexcept
+{
+  sched_param param{};
+  param.sched_priority = priority;
+  if ( ::sched_setscheduler( 0, SCHED_FIFO | SCHED_RESET_ON_FORK, &param ) == 0 )
+    return ThreadPriority::Realtime;
+  // nice is per thread on Linux
+  if ( ::setpriority( PRIO_PROCESS, static_cast< id_t >( ::gettid() ), fallbackNice ) == 0 )
+    return ThreadPriority::Nice;
+  return ThreadPriority::Unchanged;
+}
+
+/**
+ * @brief Keep the pages of the process resident
+ *
+ * Locked as they are touched (MCL_ONFAULT), so the working set of a loop
+ * is pinned after its first cycle without committing every mapping up
+ * front; a cycle then never waits for a page to come back from swap.
+ */
+inline bool lockProcessMemory() noexcept
+{
+  return ::mlockall( MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT ) == 0;
+}
+
+} // namespace ucc
@@ -0,0 +1,182 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Sampling cadence shared by the polling workers.
+ */
+enum class SamplingMode
+{
+  Fast,    ///< Temperature ramping or an interactive client wants live data
+  Normal,  ///< Each worker's historic period
+  Idle,    ///< Temperatures stable and nobody watching
+};
+
+/**
+ * @brief Picks the polling interval of the sampling workers.
+ *
+ * FanControlWorker reports the hottest fan sensor each cycle; the service
+ * reports client activity (fast-sampling subscriptions, history queries).
+ * From that the governor derives one mode for all workers:
+ *   - Fast while a client asked for it, and for FAST_HOLD_MS after the
+ *     temperature rose by RAMP_CELSIUS within RAMP_WINDOW_MS.
+ *   - Idle once the temperature stayed inside STABLE_BAND_CELSIUS for
+ *     IDLE_AFTER_MS and no client was active for CLIENT_TIMEOUT_MS.
+ *   - Normal otherwise.
+ * interval() maps the mode onto a worker's own period, so workers keep
+ * their relative cadences.
+ *
+ * Timestamps are steady-clock milliseconds (nowMs()); all methods are
+ * thread-safe.
+ */
+class SamplingGovernor
+{
+public:
+  static constexpr std::chrono::milliseconds FAST_INTERVAL{ 250 };
+  static constexpr std::chrono::milliseconds IDLE_INTERVAL{ 4000 };
+
+  static constexpr double RAMP_CELSIUS = 3.0;
+  static constexpr int64_t RAMP_WINDOW_MS = 5'000;   ///< Covers at least one idle-rate sample
+  static constexpr int64_t FAST_HOLD_MS = 10'000;
+  static constexpr double STABLE_BAND_CELSIUS = 2.0;
+  static constexpr int64_t IDLE_AFTER_MS = 30'000;
+  static constexpr int64_t CLIENT_TIMEOUT_MS = 5'000;
+
+  explicit SamplingGovernor( int64_t startMs = nowMs() ) noexcept
+    : m_stableSinceMs( startMs )
+  {
+  }
+
+  static int64_t nowMs() noexcept
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  /**
+   * @brief Feed the current temperature (°C) of the hottest sensor.
+   */
+  void reportTemperature( double celsius, int64_t timestampMs = nowMs() ) noexcept
+  {
+    if ( !std::isfinite( celsius ) )
+      return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    double windowMin = celsius;
+    for ( size_t i = 0; i < m_historySize; ++i )
+    {
+      const Sample &s = m_history[ i ];
+      if ( timestampMs - s.timestampMs <= RAMP_WINDOW_MS )
+        windowMin = std::min( windowMin, s.celsius );
+    }
+    if ( celsius - windowMin >= RAMP_CELSIUS )
+      m_fastUntilMs = timestampMs + FAST_HOLD_MS;
+
+    m_history[ m_historyNext ] = Sample{ timestampMs, celsius };
+    m_historyNext = ( m_historyNext + 1 ) % HISTORY;
+    m_historySize = std::min( m_historySize + 1, HISTORY );
+
+    if ( !m_hasAnchor || std::abs( celsius - m_stableAnchor ) > STABLE_BAND_CELSIUS )
+    {
+      m_hasAnchor = true;
+      m_stableAnchor = celsius;
+      m_stableSinceMs = timestampMs;
+    }
+  }
+
+  /**
+   * @brief Record that an interactive client consumed monitoring data.
+   */
+  void noteClientActivity( int64_t timestampMs = nowMs() ) noexcept
+  {
+    m_lastClientMs.store( timestampMs, std::memory_order_relaxed );
+  }
+
+  /**
+   * @brief Clients that asked for live data until they cancel.
+   */
+  void setFastClients( int count ) noexcept
+  {
+    m_fastClients.store( count, std::memory_order_relaxed );
+  }
+
+  [[nodiscard]] SamplingMode mode( int64_t timestampMs = nowMs() ) const noexcept
+  {
+    if ( m_fastClients.load( std::memory_order_relaxed ) > 0 )
+      return SamplingMode::Fast;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    if ( timestampMs < m_fastUntilMs )
+      return SamplingMode::Fast;
+
+    const int64_t lastClient = m_lastClientMs.load( std::memory_order_relaxed );
+    const bool clientActive = lastClient != NEVER && timestampMs - lastClient < CLIENT_TIMEOUT_MS;
+    if ( !clientActive && timestampMs - m_stableSinceMs >= IDLE_AFTER_MS )
+      return SamplingMode::Idle;
+    return SamplingMode::Normal;
+  }
+
+  /**
+   * @brief Interval for a worker whose regular period is @p normal.
+   * @param allowFast false for workers that should not go below @p normal
+   */
+  [[nodiscard]] std::chrono::milliseconds interval( std::chrono::milliseconds normal, bool allowFast = true,
+                                                    int64_t timestampMs = nowMs() ) const noexcept
+  {
+    switch ( mode( timestampMs ) )
+    {
+      case SamplingMode::Fast:
+        return allowFast ? std::min( FAST_INTERVAL, normal ) : normal;
+      case SamplingMode::Idle:
+        return std::max( IDLE_INTERVAL, normal );
+      case SamplingMode::Normal:
+      default:
+        return normal;
+    }
+  }
+
+private:
+  static constexpr size_t HISTORY = 32;
+  static constexpr int64_t NEVER = INT64_MIN;
+
+  struct Sample
+  {
+    int64_t timestampMs = 0;
+    double celsius = 0.0;
+  };
+
+  mutable std::mutex m_mutex;
+  std::array< Sample, HISTORY > m_history{};
+  size_t m_historyNext = 0;
+  size_t m_historySize = 0;
+  bool m_hasAnchor = false;
+  double m_stableAnchor = 0.0;
+  int64_t m_stableSinceMs;
+  int64_t m_fastUntilMs = NEVER;
+
+  std::atomic< int64_t > m_lastClientMs{ NEVER };
+  std::atomic< int > m_fastClients{ 0 };
+};
@@ -0,0 +1,468 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include "UccTrace.hpp"
+
+#if __has_include( <linux/io_uring.h> )
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined( __NR_io_uring_setup ) && defined( __NR_io_uring_enter )
+#define UCCD_SENSOR_POLLER_IO_URING 1
+#endif
+#endif
+
+/**
+ * @brief Shared batch reader for periodically sampled sysfs nodes.
+ *
+ * Workers register the hwmon / cpufreq / power_supply attributes they poll
+ * with add() and read the last values from the snapshot instead of opening
+ * the files themselves.  refresh() re-reads every node in one go: the files
+ * stay open and each one is read at offset 0, submitted as a single
+ * io_uring batch when the kernel allows it (raw syscalls, no liburing) and
+ * as a pread() loop otherwise.  That turns the scattered open/read/close
+ * triples of each tick into one short syscall burst.
+ *
+ * add() and refresh() serialise on one mutex; readers only take the
+ * snapshot mutex for the copy of a single value, so they never wait for a
+ * refresh in progress.
+ */
+class SensorPoller
+{
+public:
+  using Handle = uint32_t;
+
+  static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+  static constexpr size_t DEFAULT_READ_SIZE = 64;
+  static constexpr size_t MAX_READ_SIZE = 4096;
+  static constexpr uint32_t REOPEN_INTERVAL = 10;  ///< Refreshes between retries of a missing node
+
+  SensorPoller() noexcept
+  {
+#ifdef UCCD_SENSOR_POLLER_IO_URING
+    m_ring.init();
+#endif
+  }
+
+  ~SensorPoller()
+  {
+    for ( auto &node : m_nodes )
+      if ( node.fd >= 0 )
+        ::close( node.fd );
+  }
+
+  SensorPoller( const SensorPoller & ) = delete;
+  SensorPoller &operator=( const SensorPoller & ) = delete;
+
+  /**
+   * @brief Register a node; registering the same path again returns its handle.
+   *
+   * The node is read for the first time by the next refresh().  A node that
+   * cannot be opened stays registered and is retried every REOPEN_INTERVAL
+   * refreshes (hwmon directories appear late after resume).
+   *
+   * @param maxBytes Read size, clamped to MAX_READ_SIZE; longer content is truncated
+   */
+  Handle add( const std::string &path, size_t maxBytes = DEFAULT_READ_SIZE )
+  {
+    std::lock_guard< std::mutex > lock( m_nodesMutex );
+    for ( size_t i = 0; i < m_nodes.size(); ++i )
+      if ( m_nodes[ i ].path == path )
+        return static_cast< Handle >( i );
+
+    Node node;
+    node.path = path;
+    node.offset = static_cast< uint32_t >( m_bufferBytes );
+    node.capacity = static_cast< uint32_t >( std::clamp< size_t >( maxBytes, 1, MAX_READ_SIZE ) );
+    m_bufferBytes += node.capacity;
+    m_nodes.push_back( std::move( node ) );
+    return static_cast< Handle >( m_nodes.size() - 1 );
+  }
+
+  /**
+   * @brief Re-read all registered nodes and publish them as the new snapshot.
+   */
+  void refresh() noexcept
+  {
+    UCC_TRACE_SCOPE( "sysfs", "SensorPoller::refresh" );
+    std::lock_guard< std::mutex > lock( m_nodesMutex );
+    try
+    {
+      m_back.resize( m_bufferBytes );
+      m_backSlots.resize( m_nodes.size() );
+      m_pending.clear();
+    }
+    catch ( const std::bad_alloc & )
+    {
+      return;
+    }
+
+    for ( size_t i = 0; i < m_nodes.size(); ++i )
+    {
+      Node &node = m_nodes[ i ];
+      m_backSlots[ i ] = Slot{ node.offset, -ENODATA };
+      if ( node.fd < 0 && !reopen( node, m_backSlots[ i ] ) )
+        continue;
+      m_pending.push_back( static_cast< Handle >( i ) );
+    }
+
+    readPending();
+
+    for ( Handle h : m_pending )
+    {
+      Node &node = m_nodes[ h ];
+      const int32_t res = m_backSlots[ h ].length;
+      if ( res == -ENODEV || res == -ENOENT || res == -ESTALE || res == -EBADF )
+      {
+        // Device went away (hot-unplug, driver reload); reopen on the next tick
+        ::close( node.fd );
+        node.fd = -1;
+        node.retryIn = 0;
+      }
+    }
+
+    const int64_t now = std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::system_clock::now().time_since_epoch() ).count();
+
+    std::lock_guard< std::mutex > snapLock( m_snapshotMutex );
+    m_front.swap( m_back );
+    m_frontSlots.swap( m_backSlots );
+    m_snapshotMs = now;
+  }
+
+  /**
+   * @brief Integer content of a node in the last snapshot (first token).
+   */
+  [[nodiscard]] std::optional< int64_t > readInt( Handle handle ) const noexcept
+  {
+    char buf[ 32 ];
+    const size_t n = copyValue( handle, buf, sizeof( buf ) );
+    if ( n == 0 )
+      return std::nullopt;
+
+    std::string_view sv( buf, n );
+    while ( !sv.empty() && ( sv.front() == ' ' || sv.front() == '\t' || sv.front() == '+' ) )
+      sv.remove_prefix( 1 );
+    int64_t value = 0;
+    const auto res = std::from_chars( sv.data(), sv.data() + sv.size(), value );
+    if ( res.ec != std::errc() )
+      return std::nullopt;
+    return value;
+  }
+
+  /**
+   * @brief Content of a node in the last snapshot, trailing newline stripped.
+   */
+  [[nodiscard]] std::optional< std::string > readString( Handle handle ) const
+  {
+    std::lock_guard< std::mutex > lock( m_snapshotMutex );
+    if ( handle >= m_frontSlots.size() || m_frontSlots[ handle ].length < 0 )
+      return std::nullopt;
+    const Slot &slot = m_frontSlots[ handle ];
+    std::string_view sv( m_front.data() + slot.offset, static_cast< size_t >( slot.length ) );
+    while ( !sv.empty() && ( sv.back() == '\n' || sv.back() == ' ' ) )
+      sv.remove_suffix( 1 );
+    return std::string( sv );
+  }
+
+  /**
+   * @brief Raw bytes of a node in the last snapshot (binary tables).
+   * @return Bytes copied, 0 if the node has no value
+   */
+  size_t readBytes( Handle handle, void *buf, size_t size ) const noexcept
+  {
+    return copyValue( handle, static_cast< char * >( buf ), size );
+  }
+
+  /// Wall-clock time of the last refresh(), 0 before the first one
+  [[nodiscard]] int64_t snapshotTimestampMs() const noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_snapshotMutex );
+    return m_snapshotMs;
+  }
+
+  [[nodiscard]] bool usesIoUring() const noexcept
+  {
+#ifdef UCCD_SENSOR_POLLER_IO_URING
+    return m_ring.active();
+#else
+    return false;
+#endif
+  }
+
+  [[nodiscard]] size_t size() const noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_nodesMutex );
+    return m_nodes.size();
+  }
+
+private:
+  struct Node
+  {
+    std::string path;
+    int fd = -1;
+    uint32_t offset = 0;    ///< Position of the node's bytes in the value buffers
+    uint32_t capacity = 0;
+    uint32_t retryIn = 0;   ///< Refreshes left until the next open attempt
+  };
+
+  /// Bytes read (>= 0) or -errno
+  struct Slot
+  {
+    uint32_t offset = 0;
+    int32_t length = -ENODATA;
+  };
+
+  static bool reopen( Node &node, Slot &slot ) noexcept
+  {
+    if ( node.retryIn > 0 )
+    {
+      --node.retryIn;
+      return false;
+    }
+    node.fd = ::open( node.path.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( node.fd < 0 )
+    {
+      slot.length = -errno;
+      node.retryIn = REOPEN_INTERVAL;
+      return false;
+    }
+    return true;
+  }
+
+  void readPending() noexcept
+  {
+#ifdef UCCD_SENSOR_POLLER_IO_URING
+    if ( m_ring.active() )
+    {
+      if ( m_ring.readAll( m_nodes, m_pending, m_back.data(), m_backSlots ) )
+        return;
+      syslog( LOG_INFO, "SensorPoller: io_uring reads unavailable, using pread" );
+      m_ring.shutdown();
+    }
+#endif
+    for ( Handle h : m_pending )
+    {
+      const Node &node = m_nodes[ h ];
+      ssize_t n;
+      do
+        n = ::pread( node.fd, m_back.data() + node.offset, node.capacity, 0 );
+      while ( n < 0 && errno == EINTR );
+      m_backSlots[ h ].length = n < 0 ? -errno : static_cast< int32_t >( n );
+    }
+  }
+
+  size_t copyValue( Handle handle, char *buf, size_t size ) const noexcept
+  {
+    std::lock_guard< std::mutex > lock( m_snapshotMutex );
+    if ( handle >= m_frontSlots.size() || m_frontSlots[ handle ].length <= 0 )
+      return 0;
+    const Slot &slot = m_frontSlots[ handle ];
+    const size_t n = std::min( size, static_cast< size_t >( slot.length ) );
+    std::memcpy( buf, m_front.data() + slot.offset, n );
+    return n;
+  }
+
+#ifdef UCCD_SENSOR_POLLER_IO_URING
+  /**
+   * @brief Minimal io_uring wrapper: one submitter, reads only.
+   */
+  class Ring
+  {
+  public:
+    static constexpr unsigned ENTRIES = 64;
+
+    Ring() = default;
+    Ring( const Ring & ) = delete;
+    Ring &operator=( const Ring & ) = delete;
+    ~Ring() { shutdown(); }
+
+    void init() noexcept
+    {
+      io_uring_params params{};
+      const long fd = ::syscall( __NR_io_uring_setup, ENTRIES, &params );
+      if ( fd < 0 )
+        return;  // ENOSYS, or disabled by sysctl / seccomp
+      m_fd = static_cast< int >( fd );
+
+      // IORING_OP_READ arrived in 5.6 together with this feature bit
+      if ( ( params.features & IORING_FEAT_RW_CUR_POS ) == 0 )
+      {
+        shutdown();
+        return;
+      }
+
+      m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+      m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+      const bool single = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+      if ( single )
+        m_sqRingSize = m_cqRingSize = std::max( m_sqRingSize, m_cqRingSize );
+
+      m_sqRing = map( m_sqRingSize, IORING_OFF_SQ_RING );
+      m_cqRing = single ? m_sqRing : map( m_cqRingSize, IORING_OFF_CQ_RING );
+      m_sqesSize = params.sq_entries * sizeof( io_uring_sqe );
+      void *sqes = map( m_sqesSize, IORING_OFF_SQES );
+      if ( m_sqRing == nullptr || m_cqRing == nullptr || sqes == nullptr )
+      {
+        if ( sqes != nullptr )
+          ::munmap( sqes, m_sqesSize );
+        shutdown();
+        return;
+      }
+      m_sqes = static_cast< io_uring_sqe * >( sqes );
+
+      auto *sq = static_cast< std::byte * >( m_sqRing );
+      auto *cq = static_cast< std::byte * >( m_cqRing );
+      m_sqTail = reinterpret_cast< unsigned * >( sq + params.sq_off.tail );
+      m_sqMask = *reinterpret_cast< unsigned * >( sq + params.sq_off.ring_mask );
+      m_sqArray = reinterpret_cast< unsigned * >( sq + params.sq_off.array );
+      m_cqHead = reinterpret_cast< unsigned * >( cq + params.cq_off.head );
+      m_cqTail = reinterpret_cast< unsigned * >( cq + params.cq_off.tail );
+      m_cqMask = *reinterpret_cast< unsigned * >( cq + params.cq_off.ring_mask );
+      m_cqes = reinterpret_cast< io_uring_cqe * >( cq + params.cq_off.cqes );
+      m_entries = params.sq_entries;
+    }
+
+    void shutdown() noexcept
+    {
+      if ( m_sqes != nullptr )
+        ::munmap( m_sqes, m_sqesSize );
+      if ( m_cqRing != nullptr && m_cqRing != m_sqRing )
+        ::munmap( m_cqRing, m_cqRingSize );
+      if ( m_sqRing != nullptr )
+        ::munmap( m_sqRing, m_sqRingSize );
+      if ( m_fd >= 0 )
+        ::close( m_fd );
+      m_sqes = nullptr;
+      m_sqRing = m_cqRing = nullptr;
+      m_fd = -1;
+    }
+
+    [[nodiscard]] bool active() const noexcept { return m_fd >= 0; }
+
+    /**
+     * @brief Read every pending node at offset 0, ENTRIES at a time.
+     * @return false if io_uring_enter fails; the caller then reads
+     *         everything again with pread()
+     */
+    bool readAll( const std::vector< Node > &nodes, const std::vector< Handle > &pending,
+                  char *buffer, std::vector< Slot > &results ) noexcept
+    {
+      for ( size_t begin = 0; begin < pending.size(); begin += m_entries )
+      {
+        const size_t count = std::min< size_t >( m_entries, pending.size() - begin );
+        unsigned tail = *m_sqTail;
+        for ( size_t i = 0; i < count; ++i )
+        {
+          const Handle h = pending[ begin + i ];
+          const unsigned idx = tail & m_sqMask;
+          io_uring_sqe &sqe = m_sqes[ idx ];
+          std::memset( &sqe, 0, sizeof( sqe ) );
+          sqe.opcode = IORING_OP_READ;
+          sqe.fd = nodes[ h ].fd;
+          sqe.addr = reinterpret_cast< uintptr_t >( buffer + nodes[ h ].offset );
+          sqe.len = nodes[ h ].capacity;
+          sqe.off = 0;
+          sqe.user_data = h;
+          m_sqArray[ idx ] = idx;
+          ++tail;
+        }
+        std::atomic_ref< unsigned >( *m_sqTail ).store( tail, std::memory_order_release );
+
+        size_t toSubmit = count;
+        size_t reaped = 0;
+        while ( reaped < count )
+        {
+          const long ret = ::syscall( __NR_io_uring_enter, m_fd, static_cast< unsigned >( toSubmit ),
+                                      static_cast< unsigned >( count - reaped ), IORING_ENTER_GETEVENTS,
+                                      nullptr, 0 );
+          if ( ret < 0 && errno != EINTR )
+            return false;
+          if ( ret > 0 )
+            toSubmit -= std::min( toSubmit, static_cast< size_t >( ret ) );
+
+          unsigned head = *m_cqHead;
+          const unsigned cqTail = std::atomic_ref< unsigned >( *m_cqTail ).load( std::memory_order_acquire );
+          for ( ; head != cqTail; ++head, ++reaped )
+          {
+            const io_uring_cqe &cqe = m_cqes[ head & m_cqMask ];
+            if ( cqe.user_data < results.size() )
+              results[ cqe.user_data ].length = cqe.res;
+          }
+          std::atomic_ref< unsigned >( *m_cqHead ).store( head, std::memory_order_release );
+        }
+      }
+      return true;
+    }
+
+  private:
+    void *map( size_t size, uint64_t offset ) const noexcept
+    {
+      void *p = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                        static_cast< off_t >( offset ) );
+      return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int m_fd = -1;
+    unsigned m_entries = 0;
+    void *m_sqRing = nullptr;
+    void *m_cqRing = nullptr;
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    size_t m_sqesSize = 0;
+    io_uring_sqe *m_sqes = nullptr;
+    io_uring_cqe *m_cqes = nullptr;
+    unsigned *m_sqTail = nullptr;
+    unsigned *m_sqArray = nullptr;
+    unsigned *m_cqHead = nullptr;
+    unsigned *m_cqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_cqMask = 0;
+  };
+
+  Ring m_ring;
+#endif
+
+  mutable std::mutex m_nodesMutex;
+  std::vector< Node > m_nodes;
+  size_t m_bufferBytes = 0;
+  std::vector< char > m_back;
+  std::vector< Slot > m_backSlots;
+  std::vector< Handle > m_pending;
+
+  mutable std::mutex m_snapshotMutex;
+  std::vector< char > m_front;
+  std::vector< Slot > m_frontSlots;
+  int64_t m_snapshotMs = 0;
+};
@@ -0,0 +1,68 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "SensorGroups.hpp"
+
+/**
+ * @brief Sensor group subscriptions per D-Bus caller.
+ *
+ * Each sender holds one mask of ucc::SensorGroup bits; subscribing again
+ * replaces it.  mask() is the union over all senders, i.e. what the
+ * hardware monitor has to sample.  Drop a sender with unsubscribe() once
+ * it leaves the bus.  Not thread-safe; used from the D-Bus (main) thread
+ * only, publish mask() to workers through an atomic.
+ */
+class SensorSubscriptions
+{
+public:
+  /// Set the groups of @p sender; an empty mask unsubscribes.  Returns the new union
+  uint32_t subscribe( const std::string &sender, uint32_t groups )
+  {
+    groups &= ucc::SensorGroup::All;
+    if ( groups == 0 )
+      return unsubscribe( sender );
+    m_groups[ sender ] = groups;
+    return recompute();
+  }
+
+  /// Drop @p sender; returns the new union
+  uint32_t unsubscribe( const std::string &sender )
+  {
+    m_groups.erase( sender );
+    return recompute();
+  }
+
+  [[nodiscard]] bool contains( const std::string &sender ) const { return m_groups.count( sender ) > 0; }
+  [[nodiscard]] uint32_t mask() const noexcept { return m_mask; }
+  [[nodiscard]] size_t subscribers() const noexcept { return m_groups.size(); }
+
+private:
+  uint32_t recompute() noexcept
+  {
+    m_mask = 0;
+    for ( const auto &entry : m_groups )
+      m_mask |= entry.second;
+    return m_mask;
+  }
+
+  std::map< std::string, uint32_t > m_groups;
+  uint32_t m_mask = 0;
+};
@@ -16,6 +16,8 @@
 #pragma once
 
 #include "TccSettings.hpp"
+#include "PersistQueue.hpp"
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
 #include <sstream>
@@ -143,38 +145,16 @@ public:
         }
       }
 
-      // Write to temporary file, then atomically rename (prevents corruption on crash)
-      std::string tempFile = std::string(SETTINGS_FILE) + ".tmp";
-      try
+      // Write to temporary file, fsync, then atomically rename (prevents corruption on crash)
+      std::string error;
+      if ( !writeFileDurably( SETTINGS_FILE, json, 0644, &error ) )
       {
-        std::ofstream file( tempFile );
-        if ( !file )
-        {
-          std::cerr << "[Settings] Failed to create temporary file" << std::endl;
-          return false;
-        }
-
-        file << json;
-        file.close();
-
-        // Atomic rename replaces the target file
-        fs::rename( tempFile, SETTINGS_FILE );
-
-        // Set permissions
-        fs::permissions( SETTINGS_FILE,
-                        fs::perms::owner_read | fs::perms::owner_write |
-                        fs::perms::group_read | fs::perms::others_read );
-
-        std::cout << "[Settings] Settings written successfully" << std::endl;
-        return true;
-      }
-      catch ( const std::exception &e )
-      {
-        std::cerr << "[Settings] Failed to write settings atomically: " << e.what() << std::endl;
-        // Clean up temp file if it exists
-        try { fs::remove( tempFile ); } catch (...) { }
+        std::cerr << "[Settings] Failed to write settings atomically: " << error << std::endl;
         return false;
       }
+
+      std::cout << "[Settings] Settings written successfully" << std::endl;
+      return true;
     }
     catch ( const std::exception &e )
     {
@@ -205,6 +185,37 @@ private:
         if (stateMap.contains("power_wc")) settings.stateMap["power_wc"] = stateMap["power_wc"];
       }
 
+      // Parse workloadRules array; rules without a pattern or a profile are dropped
+      if (j.contains("workloadRules") && j["workloadRules"].is_array()) {
+        for (const auto& r : j["workloadRules"]) {
+          const auto field = [&r](const char* key) {
+            return r.is_object() && r.contains(key) && r[key].is_string() ? r[key].get<std::string>() : std::string();
+          };
+          WorkloadRule rule{ field("exe"), field("cgroup"), field("profile") };
+          if (!rule.profileId.empty() && (!rule.exe.empty() || !rule.cgroup.empty()))
+            settings.workloadRules.push_back(std::move(rule));
+        }
+      }
+
+      // Parse alertRules array; rules are validated against the metric registry when armed
+      if (j.contains("alertRules") && j["alertRules"].is_array()) {
+        for (const auto& r : j["alertRules"]) {
+          if (!r.is_object())
+            continue;
+          const auto field = [&r](const char* key) {
+            return r.contains(key) && r[key].is_string() ? r[key].get<std::string>() : std::string();
+          };
+          AlertRule rule;
+          rule.id = field("id");
+          rule.metric = field("metric");
+          rule.condition = field("condition");
+          if (r.contains("threshold") && r["threshold"].is_number()) rule.threshold = r["threshold"];
+          if (r.contains("forSeconds") && r["forSeconds"].is_number_integer()) rule.forSeconds = r["forSeconds"];
+          if (r.contains("hysteresis") && r["hysteresis"].is_number()) rule.hysteresis = r["hysteresis"];
+          settings.alertRules.push_back(std::move(rule));
+        }
+      }
+
       // Parse profiles map
       if (j.contains("profiles")) {
         auto& profiles = j["profiles"];
@@ -217,7 +228,16 @@ private:
       if (j.contains("fahrenheit")) settings.fahrenheit = j["fahrenheit"];
       if (j.contains("cpuSettingsEnabled")) settings.cpuSettingsEnabled = j["cpuSettingsEnabled"];
       if (j.contains("fanControlEnabled")) settings.fanControlEnabled = j["fanControlEnabled"];
+      if (j.contains("fanControlFastLoop")) settings.fanControlFastLoop = j["fanControlFastLoop"];
+      if (j.contains("fanControlRealtime")) settings.fanControlRealtime = j["fanControlRealtime"];
       if (j.contains("keyboardBacklightControlEnabled")) settings.keyboardBacklightControlEnabled = j["keyboardBacklightControlEnabled"];
+      if (j.contains("keyboardIdleTimeoutAcS") && j["keyboardIdleTimeoutAcS"].is_number_integer())
+        settings.keyboardIdleTimeoutAcS = std::clamp( j["keyboardIdleTimeoutAcS"].get< int >(), 0, 3600 );
+      if (j.contains("keyboardIdleTimeoutBatS") && j["keyboardIdleTimeoutBatS"].is_number_integer())
+        settings.keyboardIdleTimeoutBatS = std::clamp( j["keyboardIdleTimeoutBatS"].get< int >(), 0, 3600 );
+      if (j.contains("displayBrightnessRampMs") && j["displayBrightnessRampMs"].is_number_integer())
+        settings.displayBrightnessRampMs = std::clamp( j["displayBrightnessRampMs"].get< int >(), 0, 5000 );
+      if (j.contains("displayRefreshSaver")) settings.displayRefreshSaver = j["displayRefreshSaver"];
 
       // Parse optional string fields
       if (j.contains("shutdownTime") && j["shutdownTime"].is_string()) settings.shutdownTime = j["shutdownTime"];
@@ -263,6 +283,31 @@ private:
     }
     json << "  },\n";
 
+    json << "  \"workloadRules\": [";
+    for ( size_t i = 0; i < settings.workloadRules.size(); ++i )
+    {
+      const auto &rule = settings.workloadRules[i];
+      if ( i > 0 ) json << ",";
+      json << "\n    { \"exe\": " << nlohmann::json( rule.exe ).dump()
+           << ", \"cgroup\": " << nlohmann::json( rule.cgroup ).dump()
+           << ", \"profile\": " << nlohmann::json( rule.profileId ).dump() << " }";
+    }
+    json << ( settings.workloadRules.empty() ? "],\n" : "\n  ],\n" );
+
+    json << "  \"alertRules\": [";
+    for ( size_t i = 0; i < settings.alertRules.size(); ++i )
+    {
+      const auto &rule = settings.alertRules[i];
+      if ( i > 0 ) json << ",";
+      json << "\n    { \"id\": " << nlohmann::json( rule.id ).dump()
+           << ", \"metric\": " << nlohmann::json( rule.metric ).dump()
+           << ", \"condition\": " << nlohmann::json( rule.condition ).dump()
+           << ", \"threshold\": " << nlohmann::json( rule.threshold ).dump()
+           << ", \"forSeconds\": " << rule.forSeconds
+           << ", \"hysteresis\": " << nlohmann::json( rule.hysteresis ).dump() << " }";
+    }
+    json << ( settings.alertRules.empty() ? "],\n" : "\n  ],\n" );
+
     // Serialize profiles map
     json << "  \"profiles\": {\n";
     size_t profileCount = 0;
@@ -276,7 +321,13 @@ private:
     json << "  \"shutdownTime\": " << ( settings.shutdownTime.has_value() ? "\"" + settings.shutdownTime.value() + "\"" : "null" ) << ",\n";
     json << "  \"cpuSettingsEnabled\": " << ( settings.cpuSettingsEnabled ? "true" : "false" ) << ",\n";
     json << "  \"fanControlEnabled\": " << ( settings.fanControlEnabled ? "true" : "false" ) << ",\n";
+    json << "  \"fanControlFastLoop\": " << ( settings.fanControlFastLoop ? "true" : "false" ) << ",\n";
+    json << "  \"fanControlRealtime\": " << ( settings.fanControlRealtime ? "true" : "false" ) << ",\n";
     json << "  \"keyboardBacklightControlEnabled\": " << ( settings.keyboardBacklightControlEnabled ? "true" : "false" ) << ",\n";
+    json << "  \"keyboardIdleTimeoutAcS\": " << settings.keyboardIdleTimeoutAcS << ",\n";
+    json << "  \"keyboardIdleTimeoutBatS\": " << settings.keyboardIdleTimeoutBatS << ",\n";
+    json << "  \"displayBrightnessRampMs\": " << settings.displayBrightnessRampMs << ",\n";
+    json << "  \"displayRefreshSaver\": " << ( settings.displayRefreshSaver ? "true" : "false" ) << ",\n";
 
     // Serialize ycbcr420Workaround array
     json << "  \"ycbcr420Workaround\": [";
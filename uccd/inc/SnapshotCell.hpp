@@ -0,0 +1,117 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief An immutable value, replaced as a whole.
+ *
+ * Readers load() a reference to the current value and keep it as long as
+ * they like; writers build a new value and swap the pointer.  Neither side
+ * takes a lock, and a reader never sees a half-written value nor holds up
+ * a writer (the sampling threads publish here while D-Bus calls read).
+ *
+ * update() copies the current value, changes the copy and publishes it if
+ * no other writer got in first, else starts over from the newer value; the
+ * change must therefore only modify its argument.  updateRecycled() does
+ * the same into a buffer no reader holds any more, for values published
+ * every tick.
+ */
+template< typename T >
+class SnapshotCell
+{
+public:
+  using Ptr = std::shared_ptr< const T >;
+
+  explicit SnapshotCell( T initial = T{} ) : m_current( std::make_shared< const T >( std::move( initial ) ) ) {}
+
+  SnapshotCell( const SnapshotCell & ) = delete;
+  SnapshotCell &operator=( const SnapshotCell & ) = delete;
+
+  [[nodiscard]] Ptr load() const noexcept { return m_current.load( std::memory_order_acquire ); }
+
+  /// Publish @p value as is
+  void store( T value ) { m_current.store( std::make_shared< const T >( std::move( value ) ), std::memory_order_release ); }
+
+  /// Publish a copy of the current value modified by @p change( T & )
+  template< typename Change >
+  void update( Change &&change )
+  {
+    Ptr expected = load();
+    for ( ;; )
+    {
+      auto next = std::make_shared< T >( *expected );
+      change( *next );
+      if ( m_current.compare_exchange_weak( expected, Ptr( std::move( next ) ),
+                                            std::memory_order_acq_rel, std::memory_order_acquire ) )
+        return;
+    }
+  }
+
+  /**
+   * @brief update() without an allocation once warmed up
+   *
+   * The copy goes into one of up to MAX_RECYCLED buffers that is neither
+   * published nor loaded by a reader; copy-assigning T must then not
+   * allocate either (e.g. a vector of the same size).  Only when every
+   * buffer is still held does it fall back to a fresh one.  Writers using
+   * this serialise among themselves; readers still take no lock.
+   */
+  template< typename Change >
+  void updateRecycled( Change &&change )
+  {
+    std::lock_guard lock( m_recycleMutex );
+    std::shared_ptr< T > next;
+    for ( const auto &buffer : m_recycled )
+    {
+      if ( buffer.use_count() == 1 )
+      {
+        // the last reader let go: its reads happen before our writes
+        std::atomic_thread_fence( std::memory_order_acquire );
+        next = buffer;
+        break;
+      }
+    }
+    if ( !next )
+    {
+      next = std::make_shared< T >( *load() );
+      if ( m_recycled.size() < MAX_RECYCLED )
+        m_recycled.push_back( next );
+    }
+
+    Ptr expected = load();
+    for ( ;; )
+    {
+      *next = *expected;
+      change( *next );
+      if ( m_current.compare_exchange_weak( expected, Ptr( next ),
+                                            std::memory_order_acq_rel, std::memory_order_acquire ) )
+        return;
+    }
+  }
+
+private:
+  static constexpr size_t MAX_RECYCLED = 4;
+
+  std::atomic< std::shared_ptr< const T > > m_current;
+  std::mutex m_recycleMutex;
+  std::vector< std::shared_ptr< T > > m_recycled;  ///< Buffers of updateRecycled(), free at use_count() 1
+};
@@ -0,0 +1,218 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "JsonWriter.hpp"
+
+/**
+ * @brief When each daemon initializer ran and for how long.
+ *
+ * Main phases run on the constructing thread.  Parallel phases are started
+ * with spawn() and joined through their future right before the first
+ * phase that needs the result, which is all the dependency tracking the
+ * startup needs.  Deferred phases are subsystems built on first use, maybe
+ * long after startup; they are recorded with the same origin.
+ *
+ * Thread-safe: parallel phases finish on their own threads.
+ */
+class StartupTimeline
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class Lane
+  {
+    Main,
+    Parallel,
+    Deferred,
+  };
+
+  struct Phase
+  {
+    std::string name;
+    Lane lane = Lane::Main;
+    int64_t startUs = 0;     ///< since the origin
+    int64_t durationUs = 0;
+  };
+
+  /// Records the enclosing scope as one phase, also when it throws
+  class Scope
+  {
+  public:
+    Scope( StartupTimeline &timeline, std::string_view name, Lane lane = Lane::Main )
+      : m_timeline( timeline ), m_name( name ), m_lane( lane ), m_begin( Clock::now() )
+    {
+    }
+    ~Scope() { m_timeline.record( m_name, m_lane, m_begin, Clock::now() ); }
+
+    Scope( const Scope & ) = delete;
+    Scope &operator=( const Scope & ) = delete;
+
+  private:
+    StartupTimeline &m_timeline;
+    std::string m_name;
+    Lane m_lane;
+    Clock::time_point m_begin;
+  };
+
+  explicit StartupTimeline( Clock::time_point origin = Clock::now() ) noexcept : m_origin( origin ) {}
+
+  [[nodiscard]] static constexpr std::string_view laneName( Lane lane ) noexcept
+  {
+    switch ( lane )
+    {
+      case Lane::Parallel: return "parallel";
+      case Lane::Deferred: return "deferred";
+      case Lane::Main: break;
+    }
+    return "main";
+  }
+
+  /// Run @p fn on the calling thread as phase @p name
+  template< typename Fn >
+  decltype( auto ) run( std::string_view name, Fn &&fn )
+  {
+    const Scope phase( *this, name );
+    return std::forward< Fn >( fn )();
+  }
+
+  /**
+   * @brief Run @p fn on a thread of its own as phase @p name.
+   *
+   * The returned future must be joined before @p fn's captures go away;
+   * an exception thrown by @p fn is rethrown by get().
+   */
+  template< typename Fn >
+  [[nodiscard]] std::future< std::invoke_result_t< std::decay_t< Fn > > > spawn( std::string_view name, Fn &&fn )
+  {
+    return std::async( std::launch::async,
+                       [this, name = std::string( name ), fn = std::forward< Fn >( fn )]() mutable {
+                         const Scope phase( *this, name, Lane::Parallel );
+                         return fn();
+                       } );
+  }
+
+  void record( std::string_view name, Lane lane, Clock::time_point begin, Clock::time_point end )
+  {
+    Phase phase{ std::string( name ), lane, sinceOrigin( begin ), sinceOrigin( end ) - sinceOrigin( begin ) };
+    std::lock_guard lock( m_mutex );
+    m_phases.push_back( std::move( phase ) );
+  }
+
+  /// The daemon serves requests from @p when on; later calls are ignored
+  void markReady( Clock::time_point when = Clock::now() )
+  {
+    std::lock_guard lock( m_mutex );
+    if ( !m_readyUs )
+      m_readyUs = sinceOrigin( when );
+  }
+
+  [[nodiscard]] std::optional< int64_t > readyUs() const
+  {
+    std::lock_guard lock( m_mutex );
+    return m_readyUs;
+  }
+
+  /// All phases ordered by start
+  [[nodiscard]] std::vector< Phase > phases() const
+  {
+    std::vector< Phase > copy;
+    {
+      std::lock_guard lock( m_mutex );
+      copy = m_phases;
+    }
+    std::ranges::stable_sort( copy, std::less<>{}, &Phase::startUs );
+    return copy;
+  }
+
+  /// Sum of the main phases; the parallel ones overlap them
+  [[nodiscard]] int64_t mainUs() const
+  {
+    std::lock_guard lock( m_mutex );
+    int64_t sum = 0;
+    for ( const auto &phase : m_phases )
+      if ( phase.lane == Lane::Main )
+        sum += phase.durationUs;
+    return sum;
+  }
+
+  void toJSON( JsonWriter &w ) const
+  {
+    const auto ready = readyUs();
+    w.beginObject()
+      .key( "readyMs" ).value( ready ? static_cast< double >( *ready ) / 1000.0 : -1.0, 1 )
+      .key( "mainMs" ).value( static_cast< double >( mainUs() ) / 1000.0, 1 )
+      .key( "phases" ).beginArray();
+    for ( const auto &phase : phases() )
+      w.beginObject()
+        .key( "name" ).value( phase.name )
+        .key( "lane" ).value( laneName( phase.lane ) )
+        .key( "startMs" ).value( static_cast< double >( phase.startUs ) / 1000.0, 1 )
+        .key( "durationMs" ).value( static_cast< double >( phase.durationUs ) / 1000.0, 1 )
+        .endObject();
+    w.endArray().endObject();
+  }
+
+  /// One line for the log, e.g. "ready after 412.0 ms: nvml 380.2 ms (parallel), ..."
+  [[nodiscard]] std::string summary() const
+  {
+    const auto ready = readyUs();
+    std::string line = ready ? "ready after " + formatMs( *ready ) : std::string( "not ready" );
+    const char *separator = ": ";
+    for ( const auto &phase : phases() )
+    {
+      if ( phase.lane == Lane::Deferred )
+        continue;
+      line += separator + phase.name + " " + formatMs( phase.durationUs );
+      if ( phase.lane == Lane::Parallel )
+        line += " (parallel)";
+      separator = ", ";
+    }
+    return line;
+  }
+
+private:
+  [[nodiscard]] int64_t sinceOrigin( Clock::time_point t ) const noexcept
+  {
+    return std::chrono::duration_cast< std::chrono::microseconds >( t - m_origin ).count();
+  }
+
+  [[nodiscard]] static std::string formatMs( int64_t us )
+  {
+    char buf[ 32 ];
+    std::snprintf( buf, sizeof( buf ), "%.1f ms", static_cast< double >( us ) / 1000.0 );
+    return buf;
+  }
+
+  Clock::time_point m_origin;
+  mutable std::mutex m_mutex;
+  std::vector< Phase > m_phases;
+  std::optional< int64_t > m_readyUs;
+};
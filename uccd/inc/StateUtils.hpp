@@ -17,75 +17,53 @@
 
 #include "TccSettings.hpp"
 #include "PowerSupplyController.hpp"
+#include "SensorPoller.hpp"
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <syslog.h>
 
+/**
+ * @brief AC when the first 'Mains' supply is online (or there is none), else BAT.
+ *
+ * Resolves the supply on every call; the service uses it only where no
+ * PowerSupplyMonitor or SensorPoller snapshot is available.
+ */
 inline ProfileState determineState() noexcept
 {
-  ProfileState state = ProfileState::AC; // Default to AC
-
-  try
-  {
-    namespace fs = std::filesystem;
-    const fs::path pathPowerSupplies = "/sys/class/power_supply";
-
-    if ( !fs::exists( pathPowerSupplies ) )
-    {
-      return state;
-    }
-
-    // Find a 'Mains' type power supply
-    for ( const auto &entry : fs::directory_iterator( pathPowerSupplies ) )
-    {
-      if ( !entry.is_directory() )
-        continue;
-
-      fs::path typePath = entry.path() / "type";
-      if ( !fs::exists( typePath ) )
-        continue;
-
-      // Read type
-      std::ifstream typeFile( typePath );
-      if ( !typeFile )
-        continue;
-
-      std::string type;
-      std::getline( typeFile, type );
-
-      if ( type == "Mains" )
-      {
-        // Found AC power supply, check if it's online
-        fs::path onlinePath = entry.path() / "online";
-        if ( !fs::exists( onlinePath ) )
-          continue;
-
-        std::ifstream onlineFile( onlinePath );
-        if ( !onlineFile )
-          continue;
+  if ( const auto mains = PowerSupplyController::getFirstMains() )
+    return mains->isOnline() ? ProfileState::AC : ProfileState::BAT;
+  return ProfileState::AC;
+}
 
-        std::string online;
-        std::getline( onlineFile, online );
+/**
+ * @brief Path of the 'online' attribute of the first 'Mains' power supply.
+ * @return Empty string when the system has none (desktops without ACPI AC)
+ */
+inline std::string findMainsOnlinePath() noexcept
+{
+  if ( const auto mains = PowerSupplyController::getFirstMains() )
+    return mains->getBasePath() + "/online";
+  return "";
+}
 
-        if ( online == "1" )
-        {
-          state = ProfileState::AC;
-        }
-        else
-        {
-          state = ProfileState::BAT;
-        }
+/**
+ * @brief determineState() from the SensorPoller snapshot of the mains
+ *        'online' node; falls back to the directory scan while the
+ *        snapshot is missing or older than five seconds.
+ */
+inline ProfileState determineState( const SensorPoller &poller, SensorPoller::Handle mainsOnline ) noexcept
+{
+  constexpr int64_t maxAgeMs = 5000;
+  const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::system_clock::now().time_since_epoch() ).count();
 
-        break; // Found what we need
-      }
-    }
-  }
-  catch ( const std::exception &e )
+  if ( mainsOnline != SensorPoller::INVALID_HANDLE and nowMs - poller.snapshotTimestampMs() <= maxAgeMs )
   {
-    syslog( LOG_ERR, "[State] Exception determining power state: %s", e.what() );
+    if ( auto online = poller.readInt( mainsOnline ) )
+      return *online == 1 ? ProfileState::AC : ProfileState::BAT;
   }
-
-  return state;
+  return determineState();
 }
 
 inline std::string profileStateToString( ProfileState state ) noexcept
@@ -45,15 +45,57 @@ struct YCbCr420Card
   std::vector< YCbCr420Port > ports;
 };
 
+/**
+ * @brief Profile to run while a matching application is running
+ *
+ * Patterns are shell globs ('*' also crosses '/'); a rule with both
+ * matches processes that satisfy both.  Earlier rules win.
+ */
+struct WorkloadRule
+{
+  std::string exe;        // executable path, e.g. "*/steamapps/common/*", "/usr/bin/blender"
+  std::string cgroup;     // cgroup v2 path, e.g. "*/app-steam-*.scope"
+  std::string profileId;
+
+  bool operator==( const WorkloadRule & ) const = default;
+};
+
+/**
+ * @brief Condition on one metric that raises an alert while it holds
+ *
+ * "above" / "below" compare the value with threshold and must hold for
+ * forSeconds; "rising" / "falling" compare the rate of change in units
+ * per second, averaged over forSeconds.  See AlertEngine.
+ */
+struct AlertRule
+{
+  std::string id;          // reported in AlertRaised / AlertCleared
+  std::string metric;      // metric key, e.g. "gpuTemp" (see GetMetricCatalog)
+  std::string condition;   // "above", "below", "rising" or "falling"
+  double threshold = 0.0;
+  int forSeconds = 0;
+  double hysteresis = 0.0;  // the alert clears only this far back past the threshold
+
+  bool operator==( const AlertRule & ) const = default;
+};
+
 struct TccSettings
 {
   bool fahrenheit = false;
   std::map< std::string, std::string > stateMap;  // Maps "power_ac" and "power_bat" to profile IDs
+  std::vector< WorkloadRule > workloadRules;  // Per-application profiles, on top of the stateMap
+  std::vector< AlertRule > alertRules;  // Metric conditions signalled as AlertRaised / AlertCleared
   std::map< std::string, std::string > profiles;  // Maps profile IDs to full profile JSON
   std::optional< std::string > shutdownTime;  // null in TypeScript
   bool cpuSettingsEnabled = true;
   bool fanControlEnabled = true;
+  bool fanControlFastLoop = false;  // 500 ms fan loop instead of 1 s (EC writes only on change)
+  bool fanControlRealtime = false;  // fan loop and EC thread at SCHED_FIFO, memory locked, watchdog to EC auto
   bool keyboardBacklightControlEnabled = true;
+  int keyboardIdleTimeoutAcS = 0;   // seconds without input before the keyboard backlight fades out; 0 = never
+  int keyboardIdleTimeoutBatS = 0;  // the same on battery
+  int displayBrightnessRampMs = 250;  // brightness fade on profile/power switches; 0 = instant
+  bool displayRefreshSaver = false;  // internal panel at its lowest refresh rate on battery and while idle
   std::vector< YCbCr420Card > ycbcr420Workaround;  // YUV420 workaround per card/port
   std::optional< std::string > chargingProfile;  // null in TypeScript
   std::optional< std::string > chargingPriority;  // null in TypeScript
@@ -22,7 +22,16 @@
 #include <QDBusMessage>
 #include <QDBusError>
 #include <QDBusContext>
+#include <QDBusServiceWatcher>
+#include <QDBusUnixFileDescriptor>
+#include <QJsonObject>
 #include <QVariantMap>
+#include <QVariantList>
+#include <QList>
+#include <QSet>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <array>
 #include <atomic>
 #include <string>
 #include <vector>
@@ -36,18 +45,43 @@
 #include "workers/DisplayWorker.hpp"
 #include "workers/CpuWorker.hpp"
 #include "workers/FanControlWorker.hpp"
+#include "workers/KeyboardEffectWorker.hpp"
 #include "KeyboardBacklightController.hpp"
 #include "workers/ProfileSettingsWorker.hpp"
 #include "workers/LCTWaterCoolerWorker.hpp"
 #include "workers/NvidiaOCWorker.hpp"
+#include "GpuOcTuner.hpp"
+#include "HardwareReconciler.hpp"
 #include "FnLockController.hpp"
 #include "profiles/UccProfile.hpp"
 #include "profiles/DefaultProfiles.hpp"
 #include "ProfileManager.hpp"
+#include "ProfileRepository.hpp"
+#include "ProfileWireCodec.hpp"
 #include "SettingsManager.hpp"
+#include "StartupTimeline.hpp"
+#include "AuthDecisionCache.hpp"
+#include "IpcStats.hpp"
+#include "SensorSubscriptions.hpp"
+#include "PeerChannelServer.hpp"
 #include "AutosaveManager.hpp"
+#include "PersistQueue.hpp"
+#include "PowerSupplyMonitor.hpp"
+#include "ProcExecMonitor.hpp"
+#include "InputActivityMonitor.hpp"
+#include "WorkloadProfileSelector.hpp"
 #include "TccSettings.hpp"
+#include "AlertEngine.hpp"
 #include "MetricsHistoryStore.hpp"
+#include "OpenMetricsExporter.hpp"
+#include "ProfilePatch.hpp"
+#include "PropertyChangeTracker.hpp"
+#include "VersionedDocument.hpp"
+#include "SnapshotCell.hpp"
+#include "EcIoService.hpp"
+#include "CapabilityCache.hpp"
+#include "FanWatchdog.hpp"
+#include "RealtimeScheduling.hpp"
 #include "SystemInfo.hpp"
 #include "tuxedo_io_lib/tuxedo_io_api.hh"
 
@@ -55,10 +89,6 @@
 class HardwareMonitorWorker;
 class UccDBusService;
 
-// helper functions for JSON serialization
-std::string dgpuInfoToJSON( const DGpuInfo &info );
-std::string igpuInfoToJSON( const IGpuInfo &info );
-
 /**
  * @brief Time-stamped data structure
  *
@@ -94,54 +124,100 @@ struct FanData
   FanData() : speed(), temp() {}
 };
 
+/// Device description, set at startup and when the display or ODM data changes
+struct DeviceSnapshot
+{
+  std::string device = "unknown";
+  std::string displayModes = "[]";
+  std::string uccdVersion = "0.0.0";
+  std::string systemInfoJSON;
+  std::vector< std::string > odmProfilesAvailable;
+  std::string odmPowerLimitsJSON = "[]";
+  std::string keyboardBacklightCapabilitiesJSON = "{}";
+};
+
+/// Latest GPU sample, published by the hardware monitor
+struct GpuSnapshot
+{
+  std::string dGpuInfoValuesJSON = "{}";
+  std::string dGpuInfoListJSON = "[]";  ///< JSON array, one object per dGPU
+  std::string iGpuInfoValuesJSON = "{}";
+  DGpuInfo dGpuInfo;                    ///< First dGPU, for GetLiveSnapshot
+  IGpuInfo iGpuInfo;
+  std::string primeState = "unknown";
+};
+
+/// Latest CPU power and per-core sample
+struct CpuSnapshot
+{
+  std::string cpuPowerValuesJSON = "{}";
+  std::string cpuCoresJSON = "{}";
+  double cpuPowerDraw = -1.0;  ///< RAPL package power in W, -1 if unknown
+};
+
+/// Profile documents, with a version for the Get*JSONIfChanged methods
+struct ProfileSnapshot
+{
+  VersionedDocument activeProfileJSON{ "{}" };
+  VersionedDocument profilesJSON{ "[]" };
+  VersionedDocument customProfilesJSON{ "[]" };
+  VersionedDocument defaultProfilesJSON{ "[]" };
+  std::string defaultValuesProfileJSON = "{}";
+  QVariantMap activeProfileWire;     ///< activeProfileJSON in typed form (ProfileWireTypes.hpp)
+  QVariantList defaultProfilesWire;  ///< defaultProfilesJSON in typed form
+};
+
+/// Settings document, rebuilt whenever one of its inputs changes
+struct SettingsSnapshot
+{
+  VersionedDocument settingsJSON{ "{}" };  ///< From the states, charging profile and TccSettings
+  VersionedDocument keyboardBacklightStatesJSON{ "{}" };
+};
+
+/// Charging options and the current choice
+struct ChargingSnapshot
+{
+  std::string chargingProfilesAvailable = "[]";
+  std::string currentChargingProfile;
+  std::string chargingPrioritiesAvailable = "[]";
+  std::string currentChargingPriority;
+  std::string chargeStartAvailableThresholds = "[]";
+  std::string chargeEndAvailableThresholds = "[]";
+  std::string chargeType = "Unknown";
+};
+
 /**
  * @brief DBus data container
  *
  * Contains all data that is exposed via the DBus interface.
  * This structure mirrors the UccDBusData TypeScript class.
+ *
+ * Scalars are atomics; everything else is an immutable snapshot per
+ * domain, so D-Bus getters read without a lock while the sampling threads
+ * publish new values.
  */
 class UccDBusData
 {
 public:
-  std::string device;
-  std::string displayModes;
+  SnapshotCell< DeviceSnapshot > device;
+  SnapshotCell< GpuSnapshot > gpu;
+  SnapshotCell< CpuSnapshot > cpu;
+  SnapshotCell< std::vector< FanData > > fans;
+  SnapshotCell< ProfileSnapshot > profiles;
+  SnapshotCell< SettingsSnapshot > settings;
+  SnapshotCell< ChargingSnapshot > charging;
+
   std::atomic< bool > isX11;
   std::atomic< bool > tuxedoWmiAvailable;
   std::atomic< bool > fanHwmonAvailable;
-  std::string uccdVersion;
-  std::string systemInfoJSON;
-  std::vector< FanData > fans;
   std::atomic< bool > webcamSwitchAvailable;
   std::atomic< bool > webcamSwitchStatus;
   std::atomic< bool > forceYUV420OutputSwitchAvailable;
-  std::string dGpuInfoValuesJSON;
-  std::string iGpuInfoValuesJSON;
-  std::string cpuPowerValuesJSON;
-  std::string primeState;
   std::atomic< bool > modeReapplyPending;
-  std::string tempProfileName;
-  std::string tempProfileId;
-  std::string activeProfileJSON;
-  std::string profilesJSON;
-  std::string customProfilesJSON;
-  std::string defaultProfilesJSON;
-  std::string defaultValuesProfileJSON;
-  std::string settingsJSON;
-  std::vector< std::string > odmProfilesAvailable;
-  std::string odmPowerLimitsJSON;
-  std::string keyboardBacklightCapabilitiesJSON;
-  std::string keyboardBacklightStatesJSON;
   std::atomic< int32_t > fansMinSpeed;
   std::atomic< bool > fansOffAvailable;
-  std::string chargingProfilesAvailable;
-  std::string currentChargingProfile;
-  std::string chargingPrioritiesAvailable;
-  std::string currentChargingPriority;
-  std::string chargeStartAvailableThresholds;
-  std::string chargeEndAvailableThresholds;
   std::atomic< int32_t > chargeStartThreshold;
   std::atomic< int32_t > chargeEndThreshold;
-  std::string chargeType;
   std::atomic< bool > fnLockSupported;
   std::atomic< bool > fnLockStatus;
   std::atomic< bool > sensorDataCollectionStatus;
@@ -157,47 +233,24 @@ public:
   std::atomic< bool > deviceSupported{ false };
   std::atomic< int32_t > cpuFrequencyMHz;
 
-  std::mutex dataMutex;
+  // temp profile requests, taken over by the service tick
+  std::string tempProfileName;
+  std::string tempProfileId;
+  std::mutex tempProfileMutex;
 
   explicit UccDBusData( int numberFans = 3 )
-    : device( "unknown" ),
-      displayModes( "[]" ),
+    : fans( std::vector< FanData >( static_cast< size_t >( numberFans ) ) ),
       isX11( false ),
       tuxedoWmiAvailable( false ),
       fanHwmonAvailable( false ),
-      uccdVersion( "0.0.0" ),
-      fans( static_cast< size_t >( numberFans ) ),
       webcamSwitchAvailable( false ),
       webcamSwitchStatus( false ),
       forceYUV420OutputSwitchAvailable( false ),
-      dGpuInfoValuesJSON( "{}" ),
-      iGpuInfoValuesJSON( "{}" ),
-      cpuPowerValuesJSON( "{}" ),
-      primeState( "unknown" ),
       modeReapplyPending( false ),
-      tempProfileName( "" ),
-      tempProfileId( "" ),
-      activeProfileJSON( "{}" ),
-      profilesJSON( "[]" ),
-      customProfilesJSON( "[]" ),
-      defaultProfilesJSON( "[]" ),
-      defaultValuesProfileJSON( "{}" ),
-      settingsJSON( "{}" ),
-      odmProfilesAvailable(),
-      odmPowerLimitsJSON( "[]" ),
-      keyboardBacklightCapabilitiesJSON( "{}" ),
-      keyboardBacklightStatesJSON( "{}" ),
       fansMinSpeed( 0 ),
       fansOffAvailable( false ),
-      chargingProfilesAvailable( "[]" ),
-      currentChargingProfile( "" ),
-      chargingPrioritiesAvailable( "[]" ),
-      currentChargingPriority( "" ),
-      chargeStartAvailableThresholds( "[]" ),
-      chargeEndAvailableThresholds( "[]" ),
       chargeStartThreshold( -1 ),
       chargeEndThreshold( -1 ),
-      chargeType( "Unknown" ),
       fnLockSupported( false ),
       fnLockStatus( false ),
       sensorDataCollectionStatus( false ),
@@ -205,12 +258,12 @@ public:
       nvidiaPowerCTRLDefaultPowerLimit( 0 ),
       nvidiaPowerCTRLMaxPowerLimit( 1000 ),
       nvidiaPowerCTRLAvailable( false ),
-        waterCoolerAvailable( false ),
-        waterCoolerConnected( false ),
-        waterCoolerScanningEnabled( ucc::WATER_COOLER_INITIAL_STATE ),
-        waterCoolerSupported( false ),
-        cTGPAdjustmentSupported( false ),
-        cpuFrequencyMHz( -1 )
+      waterCoolerAvailable( false ),
+      waterCoolerConnected( false ),
+      waterCoolerScanningEnabled( ucc::WATER_COOLER_INITIAL_STATE ),
+      waterCoolerSupported( false ),
+      cTGPAdjustmentSupported( false ),
+      cpuFrequencyMHz( -1 )
   {
   }
 };
@@ -228,6 +281,7 @@ public:
   explicit UccDBusObject( QObject *parent = nullptr ) : QObject( parent ) {}
   using QDBusContext::connection;
   using QDBusContext::message;
+  using QDBusContext::calledFromDBus;
 };
 
 /**
@@ -241,6 +295,24 @@ class UccDBusInterfaceAdaptor : public QDBusAbstractAdaptor
   Q_OBJECT
   Q_CLASSINFO( "D-Bus Interface", "com.uniwill.uccd" )
 
+  // Slow-changing state as read-only D-Bus properties; changes are announced
+  // with org.freedesktop.DBus.Properties.PropertiesChanged, so clients need
+  // not poll them.  Values are those of the last publishPropertyChanges().
+  Q_PROPERTY( QString ActiveProfileJSON READ propActiveProfileJSON )
+  Q_PROPERTY( QString PowerState READ propPowerState )
+  Q_PROPERTY( QString SettingsJSON READ propSettingsJSON )
+  Q_PROPERTY( QString ProfilesJSON READ propProfilesJSON )
+  Q_PROPERTY( bool WebcamSWStatus READ propWebcamSWStatus )
+  Q_PROPERTY( bool FnLockStatus READ propFnLockStatus )
+  Q_PROPERTY( int DisplayBrightness READ propDisplayBrightness )
+  Q_PROPERTY( bool WaterCoolerEnabled READ propWaterCoolerEnabled )
+  Q_PROPERTY( bool WaterCoolerAvailable READ propWaterCoolerAvailable )
+  Q_PROPERTY( bool WaterCoolerConnected READ propWaterCoolerConnected )
+  Q_PROPERTY( QString CurrentChargingProfile READ propCurrentChargingProfile )
+  Q_PROPERTY( QString CurrentChargingPriority READ propCurrentChargingPriority )
+  Q_PROPERTY( int ChargeStartThreshold READ propChargeStartThreshold )
+  Q_PROPERTY( int ChargeEndThreshold READ propChargeEndThreshold )
+
 public:
   static constexpr const char* INTERFACE_NAME = "com.uniwill.uccd";
 
@@ -272,6 +344,10 @@ public slots:
   QVariantMap GetFanDataGPU1();
   QVariantMap GetFanDataGPU2();
 
+  // every live reading in one call: temperatures, clocks, power, fan duty,
+  // extended dGPU metrics, water cooler; unavailable values are omitted
+  QVariantMap GetLiveSnapshot();
+
   // webcam and display methods
   bool WebcamSWAvailable();
   bool GetWebcamSWStatus();
@@ -282,6 +358,7 @@ public slots:
 
   // gpu information methods
   QString GetDGpuInfoValuesJSON();
+  QString GetDGpuInfoListJSON();
   QString GetIGpuInfoValuesJSON();
   QString GetCpuPowerValuesJSON();
 
@@ -302,13 +379,34 @@ public slots:
   bool SetFanProfileDGPU( const QString &pointsJSON );
   bool ApplyFanProfiles( const QString &fanProfilesJSON );
   bool RevertFanProfiles();
+
+  // fan response calibration: steps the duty, measures how the fans follow
+  // and tunes the fan logics with the result; see FanCalibrationRun
+  bool StartFanCalibration();
+  void CancelFanCalibration();
+  QString GetFanCalibrationJSON();
   QString GetDefaultProfilesJSON();
   QString GetCpuFrequencyLimitsJSON();
   QString GetDefaultValuesProfileJSON();
   bool AddCustomProfile( const QString &profileJSON );
   bool SaveCustomProfile( const QString &profileJSON );
   bool DeleteCustomProfile( const QString &profileId );
+  // typed counterparts of the *ProfileJSON methods: profiles as a{sv},
+  // fan tables a(ii), keyboard states a(iiii); see ProfileWireTypes.hpp
+  QVariantMap GetActiveProfile();
+  QVariantList GetDefaultProfiles();
+  QVariantList GetCustomProfiles();
+  bool ApplyProfileData( const QVariantMap &profile );
+  bool SaveCustomProfileData( const QVariantMap &profile );
   bool UpdateCustomProfile( const QString &profileJSON );
+  // JSON merge patch (RFC 7386) of a custom or the active profile; only the
+  // subsystems the patch changes are reapplied
+  bool PatchProfile( const QString &id, const QString &patchJSON );
+  // JSON array of {"op": ..., ...} operations (saveCustomProfile, applyProfile,
+  // setActiveProfile, patchProfile, setStateMap, applyFanProfiles,
+  // setKeyboardStates, applyGpuOC), authorized together and applied as one
+  // profile switch with the fan/keyboard/GPU overrides on top
+  bool ApplyTransaction( const QString &operationsJSON );
   QString GetFanProfile( const QString &name );
   QString GetFanProfileNames();
   QString GetGpuProfile( const QString &id );
@@ -319,6 +417,11 @@ public slots:
   QString GetSettingsJSON();
   bool SetStateMap( const QString &state, const QString &profileId );
   bool SetBatchStateMap( const QString &stateMapJSON );
+  /// Replace the per-application profile rules: a JSON array of
+  /// { "exe": glob, "cgroup": glob, "profile": id }, first match wins
+  bool SetWorkloadRules( const QString &rulesJSON );
+  bool SetAlertRules( const QString &rulesJSON );
+  QString GetActiveAlerts();
 
   // odm methods
   QStringList ODMProfilesAvailable();
@@ -328,6 +431,18 @@ public slots:
   QString GetKeyboardBacklightCapabilitiesJSON();
   QString GetKeyboardBacklightStatesJSON();
   bool SetKeyboardBacklightStatesJSON( const QString &keyboardBacklightStatesJSON );
+  /// One frame of packed RGB, three bytes per zone, from a client rendering
+  /// its own lighting; an empty frame hands the keyboard back
+  bool SetKeyboardBacklightFrame( const QByteArray &rgb );
+
+  // versioned JSON getters: {"version": t, "json": s}, where json is left out
+  // while knownVersion is still current; 0 never matches
+  QVariantMap GetActiveProfileJSONIfChanged( qulonglong knownVersion );
+  QVariantMap GetProfilesJSONIfChanged( qulonglong knownVersion );
+  QVariantMap GetCustomProfilesJSONIfChanged( qulonglong knownVersion );
+  QVariantMap GetDefaultProfilesJSONIfChanged( qulonglong knownVersion );
+  QVariantMap GetSettingsJSONIfChanged( qulonglong knownVersion );
+  QVariantMap GetKeyboardBacklightStatesJSONIfChanged( qulonglong knownVersion );
 
   // fan control methods
   int GetFansMinSpeed();
@@ -382,6 +497,13 @@ public slots:
   bool ApplyNvidiaGpuOCProfile( const QString &profileJSON, int deviceIndex );
   bool ResetNvidiaGpuOCAll( int deviceIndex );
 
+  // NVIDIA OC tuning job (GpuOcTuner): steps clock offsets while the caller
+  // runs a load, then recommends a GPU OC profile; the active profile's GPU
+  // settings are restored when it ends
+  bool StartNvidiaOCTuning( int deviceIndex, const QString &optionsJSON );
+  QString GetNvidiaOCTuningStatus();
+  bool CancelNvidiaOCTuning();
+
   // water cooler methods
   bool GetWaterCoolerAvailable();
   bool GetWaterCoolerConnected();
@@ -403,9 +525,51 @@ public slots:
 
   // monitoring history methods
   QByteArray GetMonitorDataSince( qlonglong sinceTimestampMs );
+  QByteArray GetMonitorDataSinceCompressed( qlonglong sinceTimestampMs );
+  QByteArray GetMonitorDataSinceDecimated( qlonglong sinceTimestampMs, uint metricMask,
+                                          int maxPointsPerSeries, int mode );
+  QByteArray GetMonitorRollupSince( qlonglong sinceTimestampMs, int maxPointsPerSeries );
+  QByteArray GetMonitorFramesSince( qlonglong sinceTimestampMs, qulonglong metricMask );
+  QByteArray GetMonitorFramesPage( qlonglong sinceTimestampMs, qulonglong metricMask, int maxRows );
+  QByteArray GetMonitorEventsSince( qlonglong sinceTimestampMs );
+  QString GetMonitorStatsJSON( qlonglong sinceTimestampMs, const QVariantMap &thresholds );
+  QString GetMetricCatalog();
+  QDBusUnixFileDescriptor GetLiveMetricsSegment();
   void SetMonitorHistoryHorizon( int seconds );
   int GetMonitorHistoryHorizon();
   int GetCpuFrequencyMHz();
+  QString GetCpuCoresJSON();
+  QByteArray GetCpuCoreHistorySince( qlonglong sinceTimestampMs );
+
+  // per-worker cycle timing: onWork() duration histogram, overruns, periods;
+  // drift reconciliation counters per setting
+  QString GetWorkerStatsJSON();
+
+  // fan loop latency histograms per stage, sensor read to EC write
+  QString GetFanTraceJSON();
+
+  // per-method call counts, recent rate and latency histograms, by sender
+  QString GetIpcStatsJSON();
+
+  // when each startup phase ran and for how long, plus subsystems built on first use
+  QString GetStartupTimelineJSON();
+
+  // metrics push subscription (MetricsSample is only emitted while subscribed)
+  void SubscribeMetricsSamples();
+  void UnsubscribeMetricsSamples();
+
+  // fast sampling (an open monitor view): workers sample at 250 ms until unsubscribed
+  void SubscribeFastSampling();
+  void UnsubscribeFastSampling();
+
+  // sensor groups (ucc::SensorGroup bits) to sample for this caller until it
+  // unsubscribes or leaves the bus; a new mask replaces the caller's old one
+  void SubscribeSensors( uint groups );
+  void UnsubscribeSensors();
+
+  // private peer channel beside the bus: { "address": s, "token": ay } for
+  // the monitoring reads and fan-curve calls listed in ucc::peer::peerServes()
+  QVariantMap RequestPeerChannel();
 
 signals:
   void ProfileChanged( const QString &profileId,
@@ -416,6 +580,20 @@ signals:
   void PowerStateChanged( const QString &state );
   void WaterCoolerStatusChanged( const QString &status );
 
+  /**
+   * @brief Newest value of every metric, indexed by MetricId (NaN = no sample).
+   */
+  void MetricsSample( qlonglong timestampMs, const QList< double > &values );
+
+  /**
+   * @brief An alert rule (see SetAlertRules) started or stopped holding.
+   *
+   * @p value is the metric's value, or its rate per second for "rising" /
+   * "falling" rules.
+   */
+  void AlertRaised( const QString &ruleId, const QString &metric, double value, qlonglong timestampMs );
+  void AlertCleared( const QString &ruleId, const QString &metric, double value, qlonglong timestampMs );
+
 public:
   // signal emitters (call these from service code)
   void emitModeReapplyPendingChanged( bool pending );
@@ -425,14 +603,104 @@ public:
                            const std::string &gpuProfileId = {} );
   void emitPowerStateChanged( const std::string &state );
   void emitWaterCoolerStatusChanged( const std::string &status );
+  void emitMetricsSample( qlonglong timestampMs, QList< double > values );
+  void emitAlert( const AlertEngine::Event &event );
+
+  /**
+   * @brief Update the exported properties and send PropertiesChanged.
+   *
+   * Safe to call from worker threads.  @p changed holds only the entries
+   * that differ from the previous call (see PropertyChangeTracker).
+   */
+  void publishPropertyChanges( const PropertyMap &changed );
+
+  /**
+   * @brief True while at least one client is subscribed to MetricsSample.
+   *
+   * Safe to call from worker threads.
+   */
+  [[nodiscard]] bool hasMetricsSampleSubscribers() const noexcept
+  { return m_sampleSubscriberCount.load( std::memory_order_relaxed ) > 0; }
+
+  /**
+   * @brief Union of the sensor groups subscribed with SubscribeSensors.
+   *
+   * Safe to call from worker threads.
+   */
+  [[nodiscard]] uint32_t subscribedSensorGroups() const noexcept
+  { return m_sensorGroups.load( std::memory_order_relaxed ); }
 
   // allow UccDBusService to access timeout handling
   friend class UccDBusService;
 
+protected:
+  /**
+   * @brief Account one call for GetIpcStatsJSON.
+   *
+   * @param sender Unique bus name of the caller, empty if unknown
+   */
+  void recordIpcCall( std::string_view method, std::string_view sender,
+                      std::chrono::steady_clock::time_point begin ) noexcept;
+
+  /// Sender of the D-Bus call being dispatched, empty outside one
+  [[nodiscard]] QString dbusCaller() const;
+
 private:
   UccDBusData &m_data;
   UccDBusService *m_service;
-  std::chrono::steady_clock::time_point m_lastDataCollectionAccess;
+  std::atomic< std::chrono::steady_clock::time_point > m_lastDataCollectionAccess;
+
+  // MetricsSample and fast-sampling subscribers by unique bus name; only touched on the main thread
+  QDBusServiceWatcher m_sampleWatcher;
+  QSet< QString > m_sampleSubscribers;
+  QSet< QString > m_fastSamplingClients;
+  std::atomic< int > m_sampleSubscriberCount{ 0 };
+
+  // SubscribeSensors callers, also watched by m_sampleWatcher; the union is mirrored for workers
+  SensorSubscriptions m_sensorSubscriptions;
+  std::atomic< uint32_t > m_sensorGroups{ 0 };
+
+  // Polkit grants per sender; its senders are watched by m_sampleWatcher too
+  AuthDecisionCache m_authCache;
+
+  // peer channel server, listening from the first RequestPeerChannel on; while
+  // one of its calls is dispatched m_peerCaller names the caller
+  std::unique_ptr< PeerChannelServer > m_peerServer;
+  const PeerCaller *m_peerCaller = nullptr;
+
+  // Polkit actions ApplyTransaction has already authorized for the current call
+  std::vector< std::string > m_transactionActions;
+
+  // D-Bus and peer-channel calls as seen by InstrumentedDBusAdaptor; main thread only
+  IpcStats m_ipcStats;
+
+  // exported property values; only touched on the main thread
+  QVariantMap m_properties;
+  QString propActiveProfileJSON() const { return m_properties.value( QStringLiteral( "ActiveProfileJSON" ) ).toString(); }
+  QString propPowerState() const { return m_properties.value( QStringLiteral( "PowerState" ) ).toString(); }
+  QString propSettingsJSON() const { return m_properties.value( QStringLiteral( "SettingsJSON" ) ).toString(); }
+  QString propProfilesJSON() const { return m_properties.value( QStringLiteral( "ProfilesJSON" ) ).toString(); }
+  bool propWebcamSWStatus() const { return m_properties.value( QStringLiteral( "WebcamSWStatus" ) ).toBool(); }
+  bool propFnLockStatus() const { return m_properties.value( QStringLiteral( "FnLockStatus" ) ).toBool(); }
+  int propDisplayBrightness() const { return m_properties.value( QStringLiteral( "DisplayBrightness" ) ).toInt(); }
+  bool propWaterCoolerEnabled() const { return m_properties.value( QStringLiteral( "WaterCoolerEnabled" ) ).toBool(); }
+  bool propWaterCoolerAvailable() const { return m_properties.value( QStringLiteral( "WaterCoolerAvailable" ) ).toBool(); }
+  bool propWaterCoolerConnected() const { return m_properties.value( QStringLiteral( "WaterCoolerConnected" ) ).toBool(); }
+  QString propCurrentChargingProfile() const { return m_properties.value( QStringLiteral( "CurrentChargingProfile" ) ).toString(); }
+  QString propCurrentChargingPriority() const { return m_properties.value( QStringLiteral( "CurrentChargingPriority" ) ).toString(); }
+  int propChargeStartThreshold() const { return m_properties.value( QStringLiteral( "ChargeStartThreshold" ) ).toInt(); }
+  int propChargeEndThreshold() const { return m_properties.value( QStringLiteral( "ChargeEndThreshold" ) ).toInt(); }
+
+  bool saveCustomProfile( UccProfile profile );  ///< SaveCustomProfile after decoding
+  void removeMetricsSampleSubscriber( const QString &service );
+  void removeFastSamplingClient( const QString &service );
+  void removeSensorSubscriber( const QString &service );
+  void unwatchIfUnused( const QString &service );
+  bool mergeStateMap( const QJsonObject &map );
+  std::optional< QVariant > dispatchPeerCall( const PeerCaller &caller, const QString &method,
+                                              const QVariantList &args, QString &error );
+  void noteMonitorClient() noexcept;
+  QVariantMap versionedReply( const VersionedDocument &document, qulonglong knownVersion );
 
   void resetDataCollectionTimeout();
   QVariantMap exportFanData( const FanData &fanData );
@@ -443,12 +711,31 @@ private:
    * Retrieves the incoming D-Bus message from the parent UccDBusObject
    * (which inherits QDBusContext) and delegates to PolkitAuthority.
    *
+   * Calls arriving over the peer channel never prompt: they pass only with
+   * a grant the caller already holds from a call on the bus.
+   *
    * @param actionId One of PolkitAuthority::ACTION_* constants
    * @return true if the caller is authorized
    */
   bool checkAuth( const char *actionId ) noexcept;
 };
 
+/**
+ * @brief UccDBusInterfaceAdaptor that times every exported method.
+ *
+ * QtDBus invokes adaptor slots through qt_metacall(); overriding it here
+ * (deliberately without Q_OBJECT, so the meta-object and method indices
+ * stay those of the base) wraps all of them without touching each slot.
+ * Calls arriving over the peer channel are recorded by dispatchPeerCall().
+ */
+class InstrumentedDBusAdaptor final : public UccDBusInterfaceAdaptor
+{
+public:
+  using UccDBusInterfaceAdaptor::UccDBusInterfaceAdaptor;
+
+  int qt_metacall( QMetaObject::Call call, int id, void **args ) override;
+};
+
 /**
  * @brief TCC DBus Service Worker
  *
@@ -457,6 +744,7 @@ private:
  */
 class UccDBusService : public DaemonWorker
 {
+  Q_OBJECT
 public:
   /**
    * @brief Constructor
@@ -505,27 +793,48 @@ public:
   bool setCurrentProfileByName( const std::string &profileName );
   bool setCurrentProfileById( const std::string &id );
   bool applyProfileJSON( const std::string &profileJSON );
+  bool applyProfile( const UccProfile &profile );
   std::vector< UccProfile > getAllProfiles() const;
   std::vector< UccProfile > getDefaultProfiles() const;
   std::vector< UccProfile > getCustomProfiles() const;
   UccProfile getDefaultProfile() const;
   void updateDBusActiveProfileData();
   void updateDBusSettingsData();
+  void updateDBusKeyboardBacklightStates( const std::string &statesJSON );
 
   // profile manipulation methods
   bool addCustomProfile( const UccProfile &profile );
   bool deleteCustomProfile( const std::string &profileId );
   bool updateCustomProfile( const UccProfile &profile );
+  bool patchProfile( const std::string &id, const std::string &patchJSON );
+  std::optional< UccProfile > resolveProfile( const std::string &id ) const;  ///< custom, then built-in; O(1) for custom
+  bool profileExists( const std::string &id ) const;
+  /// Make @p profile active, applying the subsystems that differ from the
+  /// previous one or are stale, except those in @p skip
+  void activateProfile( const UccProfile &profile, uint32_t skip = 0 );
 
   // Allow UccDBusInterfaceAdaptor to access private members
   friend class UccDBusInterfaceAdaptor;
 
 public:
-  /// Register the D-Bus service.  Call from the main thread before start().
+  /// Register the D-Bus service.  Call from the main thread before initialize(),
+  /// so the name is claimed at once; calls wait until the event loop runs.
   bool initDBus();
 
+  /// Detect the hardware, load profiles and settings and start the workers.
+  /// Call from the main thread after initDBus() and before start().
+  void initialize();
+
+  /// Periodically write OpenMetrics text to @p path (node_exporter textfile
+  /// collector); empty disables.  Call before start().
+  void setMetricsTextfilePath( std::string path ) { m_metricsTextfilePath = std::move( path ); }
+
+  /// How long settings and autosave changes must rest before they are
+  /// written; 0 writes on the next event loop pass.  Call before start().
+  void setPersistQuietPeriod( std::chrono::milliseconds quietPeriod );
+
   /// Resolve and apply the startup profile for the current power state.
-  /// Call after initDBus() and before start().
+  /// Call after initialize() and before start().
   void initializeStartupProfile();
 
   /// Gracefully stop all worker threads and the service itself.
@@ -538,7 +847,40 @@ protected:
   void onWork() override;
   void onExit() override;
 
+private slots:
+  /// logind PrepareForSleep: pause the workers and write pending settings
+  /// before the system sleeps, restore the hardware state after it woke up
+  void onPrepareForSleep( bool suspending );
+
 private:
+  /// Queue a settings / autosave write; see PersistQueue
+  void persistSettings();
+  void persistAutosave();
+  void armPersistTimer();
+  /// Write whatever is pending now; false if a write failed
+  bool flushPersistQueues();
+
+  /// logind delay lock, held while awake so onPrepareForSleep() can finish
+  /// before the system sleeps
+  void takeSleepInhibitor();
+  /// logind's IdleHint: every session of the seat reports idle
+  bool sessionsIdle();
+  /// The workers paused over a suspend
+  std::array< DaemonWorker *, 6 > sleepingWorkers() noexcept;
+  void quiesceForSleep();
+  void restoreAfterSleep();
+
+  void emitMetricsSampleIfNew();
+  void publishPropertyChanges();
+  void stageSlowState();
+  void writeMetricsTextfile();
+  void updateDynamicPowerLimits( int64_t tickMs );
+  void updatePowerBudget( int64_t tickMs );
+
+  /// Sensor groups HardwareMonitorWorker samples: SubscribeSensors callers, plus
+  /// everything while legacy getters were used recently or the textfile export runs
+  uint32_t activeSensorGroups() const noexcept;
+
   struct BuiltinGpuProfile
   {
     std::string id;
@@ -549,6 +891,7 @@ private:
   static constexpr const char* INTERFACE_NAME = "com.uniwill.uccd";
   UccDBusData m_dbusData;
   TuxedoIOAPI m_io;
+  EcIoService m_ec;  // the only thread issuing tuxedo_io ioctls
   std::unique_ptr< UccDBusObject > m_dbusObject;  // The QObject registered on the D-Bus bus
   std::unique_ptr< UccDBusInterfaceAdaptor > m_adaptor;
   bool m_started;
@@ -559,9 +902,28 @@ private:
   AutosaveManager m_autosaveManager;
   TccSettings m_settings;
   TccAutosave m_autosave;
+
+  // Slider drags and batched map updates mark these dirty many times a
+  // second; each document is written once it has been quiet for a while
+  static constexpr std::chrono::milliseconds PERSIST_QUIET_PERIOD{ 1500 };
+  static constexpr std::chrono::milliseconds PERSIST_MAX_DELAY{ 10000 };
+  PersistQueue m_settingsPersist{ [this] { return m_settingsManager.writeSettings( m_settings ); },
+                                  PERSIST_QUIET_PERIOD, PERSIST_MAX_DELAY };
+  PersistQueue m_autosavePersist{ [this] { return m_autosaveManager.writeAutosave( m_autosave ); },
+                                  PERSIST_QUIET_PERIOD, PERSIST_MAX_DELAY };
+  QTimer m_persistTimer;  ///< single-shot, armed for the earliest deadline
+  QDBusUnixFileDescriptor m_sleepInhibitor;  ///< invalid while not held
+
+  // logind waits at most InhibitDelayMaxSec (5 s by default) for the delay lock
+  static constexpr std::chrono::milliseconds SLEEP_QUIESCE_TIMEOUT{ 2000 };
   UccProfile m_activeProfile;
+  uint32_t m_staleSubsystems = ProfileSubsystem::All;  ///< not applied since m_activeProfile was set
+  // while set (ApplyTransaction), saving or patching the active profile only
+  // records it in m_deferredProfile
+  bool m_deferProfileApply = false;
+  std::optional< UccProfile > m_deferredProfile;
   std::vector< UccProfile > m_defaultProfiles;
-  std::vector< UccProfile > m_customProfiles;
+  ProfileRepository m_customProfiles;  ///< parsed once from m_settings.profiles, which is written on save
   std::vector< BuiltinGpuProfile > m_builtinGpuProfiles;
 
   // state switching
@@ -596,21 +958,59 @@ private:
   static constexpr int WC_DISCONNECT_DEBOUNCE_S = 10;         // seconds stable before accepting "disconnected"
 
   void setupGpuDataCallback();
+  void createWorkers();
+  /// NvidiaOCWorker, built with the builtin GPU profiles on the first call;
+  /// nullptr on unsupported devices.  Any thread.
+  NvidiaOCWorker *nvidiaOC();
+  const std::vector< BuiltinGpuProfile > &builtinGpuProfiles();
   void rebuildBuiltinGpuProfiles();
+  /// The water cooler worker, nullptr until scanning was first enabled.  Any thread.
+  LCTWaterCoolerWorker *waterCooler() const noexcept { return m_waterCooler.load( std::memory_order_acquire ); }
+  /// Build the water cooler worker on the main thread if it does not exist yet
+  LCTWaterCoolerWorker *ensureWaterCooler();
   int readCurrentCTGPOffset() const;
   void readHardwareCapabilities();
-  void updateFanData();
+  /// Load this machine's capability profile and publish what it answers
+  void openCapabilityProfile();
+  /// Probe what openCapabilityProfile() answered from the profile (service tick, once)
+  void revalidateCapabilities();
+  /// TDP limits from the capability profile and the current values from the EC
+  std::vector< TDPInfo > readTDPInfo();
+  /// Drive the water cooler fan and pump from the CPU fan temperature (auto-control profiles)
+  void autoControlWaterCooler( int temp );
   void loadProfiles();
   void loadSettings();
   void applyStartupProfile();
   void loadAutosave();
-  void saveAutosave();
   void initializeProfiles();
   void initializeDisplayModes();
   void serializeProfilesJSON();
   void applyProfileForCurrentState();
+  /// Arm the selector and the proc connector for m_settings.workloadRules (main thread)
+  void updateWorkloadRules();
+  /// Arm m_alertEngine with m_settings.alertRules
+  void updateAlertRules();
+  void drainProcEvents();
+  void scanWorkloadProcesses();
+  /// Start, stop or retime the keyboard idle timeout for the power source (main thread)
+  void armKeyboardIdle();
+  void checkKeyboardIdle();
+  void onInputActivity();
+  [[nodiscard]] int64_t keyboardIdleTimeoutMs() const noexcept;
+  /// Switch to the profile of the running applications, or back (service tick)
+  void updateWorkloadProfile();
+  /// Run the appliers of the ProfileSubsystem bits in @p subsystems for @p profile
+  void applyProfileSubsystems( const UccProfile &profile, uint32_t subsystems );
   void applyFanAndPumpSettings( const UccProfile &profile );
   void applyGpuOCFromProfile( const UccProfile &profile );
+  /// Start a GPU OC tuning job on device 0; false if one runs or @p options are invalid
+  bool startGpuTuning( GpuOcTuningOptions options );
+  /// Feed the newest dGPU telemetry to the tuning job (m_gpuTuningTimer)
+  void stepGpuTuning();
+  /// Apply the tuner's @p next setting, skipping ones the driver refuses; ends the job once it stopped
+  void advanceGpuTuning( std::optional< GpuOcSetting > next );
+  /// Stop the tuning job (cancelled unless it ended by itself) and restore the active GPU settings
+  void endGpuTuning( bool restore = true );
   void fillDeviceSpecificDefaults( std::vector< UccProfile > &profiles );
   void snapProfileFrequencies( UccProfile &profile );
   std::optional< UniwillDeviceID > identifyDevice();
@@ -619,28 +1019,109 @@ private:
   std::vector< std::vector< std::string > > getOutputPorts();
 
   // workers
+  static constexpr int FAN_RT_PRIORITY = 5;
+  static constexpr int FAN_FALLBACK_NICE = -10;
+  std::unique_ptr< WorkerScheduler > m_fanScheduler;  ///< only with fanControlRealtime; declared before the worker it runs
+  std::shared_ptr< FanWatchdog > m_fanWatchdog;       ///< only with fanControlRealtime
   std::unique_ptr< HardwareMonitorWorker > m_hardwareMonitorWorker;
   std::unique_ptr< DisplayWorker > m_displayWorker;
   std::unique_ptr< CpuWorker > m_cpuWorker;
   std::unique_ptr< ProfileSettingsWorker > m_profileSettingsWorker;
   std::unique_ptr< FanControlWorker > m_fanControlWorker;
   KeyboardBacklightController m_keyboardBacklightController;
-  std::unique_ptr< LCTWaterCoolerWorker > m_waterCoolerWorker;
-  std::unique_ptr< NvidiaOCWorker > m_nvidiaOCWorker;
+  std::unique_ptr< KeyboardEffectWorker > m_keyboardEffectWorker;  ///< declared after the controller it plays on
+  std::unique_ptr< LCTWaterCoolerWorker > m_waterCoolerWorker;  ///< owner; read through waterCooler()
+  std::atomic< LCTWaterCoolerWorker * > m_waterCooler{ nullptr };
+  std::unique_ptr< NvidiaOCWorker > m_nvidiaOCWorker;  ///< read through nvidiaOC()
+  std::once_flag m_nvidiaOCOnce;
+
+  // GPU OC tuning job, main thread only; kept after it ended for its status
+  std::unique_ptr< GpuOcTuner > m_gpuTuner;
+  QTimer m_gpuTuningTimer;
+  std::atomic< bool > m_gpuTuningActive{ false };  ///< keeps the dGPU sensor group sampled
+  std::atomic< bool > m_powerBudgetActive{ false };  ///< keeps CPU power and the dGPU sampled for the arbiter
+  std::atomic< bool > m_cpuLoadActive{ false };  ///< core parking or adaptive EPP: keeps per-core load and CPU power sampled
+  std::atomic< bool > m_batteryDischarging{ false };  ///< from the monitor's battery sample, for adaptive EPP
+  static constexpr std::chrono::milliseconds GPU_TUNING_SAMPLE_PERIOD{ 1000 };
 
   // Shared NVML instance — created once, used by all workers and readHardwareCapabilities
   std::shared_ptr< NvmlWrapper > m_nvml;
 
+  // Adaptive cycle length of HardwareMonitorWorker, FanControlWorker and the service tick
+  std::shared_ptr< SamplingGovernor > m_samplingGovernor;
+
+  // Fan loop stage timing and tuxedo_io ioctl durations (GetFanTraceJSON)
+  std::shared_ptr< FanLatencyTrace > m_fanTrace;
+
+  // Shared batch reader for polled sysfs nodes — refreshed by HardwareMonitorWorker each cycle
+  std::shared_ptr< SensorPoller > m_sensorPoller;
+  SensorPoller::Handle m_mainsOnlineNode = SensorPoller::INVALID_HANDLE;  ///< only polled without udev
+
+  // AC/BAT from power_supply uevents, drained on the main thread
+  PowerSupplyMonitor m_powerSupply;
+  std::unique_ptr< QSocketNotifier > m_powerSupplyNotifier;  ///< declared after the monitor it watches
+
+  // keyboard backlight idle timeout from evdev activity, main thread only
+  InputActivityMonitor m_inputActivity;
+  std::unique_ptr< QSocketNotifier > m_inputNotifier;  ///< enabled only while dark; declared after the monitor
+  QTimer m_keyboardIdleTimer;   ///< single-shot, at the end of the timeout
+  int64_t m_lastInputMs = 0;
+  bool m_keyboardIdle = false;
+  bool m_keyboardOnBattery = false;
+
+  // per-application profiles from proc connector exec/exit events, drained on the main thread
+  ProcExecMonitor m_procMonitor;
+  std::unique_ptr< QSocketNotifier > m_procNotifier;  ///< declared after the monitor it watches
+  std::mutex m_workloadMutex;
+  WorkloadProfileSelector m_workloadSelector;  ///< guarded by m_workloadMutex
+  std::string m_workloadProfileId;             ///< service tick: rule profile switched to, empty if none
+  std::string m_workloadBaseProfileId;         ///< service tick: the profile it replaced
+  ProfileState m_workloadBaseState = ProfileState::AC;
+  [[nodiscard]] ProfileState currentPowerState() const noexcept;
+
+  // per-phase timing of initialize() and of the subsystems deferred to first use
+  StartupTimeline m_startup;
+
   // identified device
   std::optional< UniwillDeviceID > m_deviceId;
   SystemInfo m_systemInfo;
 
-  // periodic validation counters
-  uint32_t m_nvidiaValidationCounter = 0;
+  // hardware facts of this machine kept across restarts (/var/cache/ucc)
+  CapabilityCache m_capabilities;
+  bool m_capabilityProfileFound = false;
+  bool m_capabilitiesRevalidated = false;             ///< service tick only
+  std::atomic< bool > m_fanLimitsRevalidated{ false };
+
+  // service tick; the sampling governor stretches it while nothing is watched
+  static constexpr std::chrono::milliseconds SERVICE_INTERVAL{ 1000 };
+  static constexpr int64_t METRICS_TEXTFILE_PERIOD_MS = 5000;
+  static constexpr int64_t IDLE_HINT_PERIOD_MS = 2000;
+
+  // probes CPU and cTGP settings for external changes, driven by the service tick
+  HardwareReconciler m_reconciler;
   bool m_nvidiaPowerLimitsInitialized = false;
 
-  // monitoring history ring buffer (daemon-side storage for graph tab)
+  // shared-memory mirror of the newest samples, handed to local clients
+  LiveMetricsPublisher m_liveMetrics{ static_cast< size_t >( MetricId::Count ) };
+
+  // threshold / rate alerts on every history sample, signalled as AlertRaised / AlertCleared
+  AlertEngine m_alertEngine;
+
+  // monitoring history ring buffer (daemon-side storage for graph tab),
+  // file-backed so history survives daemon restarts
   MetricsHistoryStore m_metricsStore;
+  int64_t m_lastMetricsSampleMs = 0;  ///< Newest timestamp already sent as MetricsSample
+  PropertyChangeTracker m_propertyTracker;  ///< Slow state last sent as PropertiesChanged
+
+  // optional OpenMetrics textfile export, rendered from already-sampled data
+  std::string m_metricsTextfilePath;
+  OpenMetricsExporter m_openMetrics;
+  TelemetrySnapshot m_telemetrySnapshot;
+  int64_t m_lastMetricsTextfileMs = 0;
+  int64_t m_lastPowerLimitMs = 0;  ///< last dynamic power limit step, 0 while in static mode
+  int64_t m_lastPowerBudgetMs = 0; ///< last CPU/GPU budget step, 0 while not sharing
+  int64_t m_lastIdleHintMs = 0;    ///< last IdleHint poll for the refresh saver
+  bool m_sessionsIdle = false;
 
   // controllers
   FnLockController m_fnLockController;
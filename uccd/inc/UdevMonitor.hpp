@@ -0,0 +1,135 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <libudev.h>
+#include <poll.h>
+
+/**
+ * @brief One received udev event, valid inside the drain() callback
+ */
+class UdevEvent
+{
+public:
+  explicit UdevEvent( udev_device *device ) noexcept : m_device( device ) {}
+
+  /// "add", "remove", "change", ...; empty if the event has none
+  [[nodiscard]] const char *action() const noexcept { return orEmpty( udev_device_get_action( m_device ) ); }
+
+  /// Value of the uevent property @p key, e.g. "POWER_SUPPLY_ONLINE"; empty if unset
+  [[nodiscard]] const char *property( const char *key ) const noexcept
+  {
+    return orEmpty( udev_device_get_property_value( m_device, key ) );
+  }
+
+private:
+  static const char *orEmpty( const char *value ) noexcept { return value != nullptr ? value : ""; }
+
+  udev_device *m_device;
+};
+
+/**
+ * @brief Non-blocking libudev monitor for device hotplug.
+ *
+ * Listens on the "udev" netlink source, i.e. events arrive after the udev
+ * rules ran and the sysfs attributes are ready.  The owner polls drain()
+ * from its own loop; there is no extra thread.
+ */
+class UdevMonitor
+{
+public:
+  UdevMonitor() noexcept = default;
+  ~UdevMonitor() { stop(); }
+
+  UdevMonitor( const UdevMonitor & ) = delete;
+  UdevMonitor &operator=( const UdevMonitor & ) = delete;
+
+  /**
+   * @brief Start listening for events of the given subsystems.
+   * @return false if libudev or the netlink socket is unavailable
+   */
+  bool start( std::initializer_list< const char * > subsystems ) noexcept
+  {
+    stop();
+    m_udev = udev_new();
+    if ( m_udev == nullptr )
+      return false;
+
+    m_monitor = udev_monitor_new_from_netlink( m_udev, "udev" );
+    bool ok = m_monitor != nullptr;
+    for ( const char *subsystem : subsystems )
+      ok = ok && udev_monitor_filter_add_match_subsystem_devtype( m_monitor, subsystem, nullptr ) >= 0;
+    ok = ok && udev_monitor_enable_receiving( m_monitor ) >= 0;
+
+    if ( not ok )
+      stop();
+    return ok;
+  }
+
+  void stop() noexcept
+  {
+    if ( m_monitor != nullptr )
+      udev_monitor_unref( m_monitor );
+    if ( m_udev != nullptr )
+      udev_unref( m_udev );
+    m_monitor = nullptr;
+    m_udev = nullptr;
+  }
+
+  [[nodiscard]] bool active() const noexcept { return m_monitor != nullptr; }
+
+  /// Readable when events are queued, for an event loop to watch; -1 if stopped
+  [[nodiscard]] int fd() const noexcept { return m_monitor != nullptr ? udev_monitor_get_fd( m_monitor ) : -1; }
+
+  /**
+   * @brief Consume all queued events without blocking.
+   * @return Number of events received since the last call
+   */
+  size_t drain() noexcept
+  {
+    return drain( []( const UdevEvent & ) {} );
+  }
+
+  /**
+   * @brief Consume all queued events, passing each one to @p onEvent
+   * @return Number of events received since the last call
+   */
+  template< typename Fn >
+  size_t drain( Fn &&onEvent ) noexcept
+  {
+    if ( m_monitor == nullptr )
+      return 0;
+
+    size_t events = 0;
+    pollfd pfd{ udev_monitor_get_fd( m_monitor ), POLLIN, 0 };
+    while ( poll( &pfd, 1, 0 ) > 0 and ( pfd.revents & POLLIN ) )
+    {
+      udev_device *device = udev_monitor_receive_device( m_monitor );
+      if ( device == nullptr )
+        break;
+      onEvent( UdevEvent( device ) );
+      udev_device_unref( device );
+      ++events;
+    }
+    return events;
+  }
+
+private:
+  udev *m_udev = nullptr;
+  udev_monitor *m_monitor = nullptr;
+};
@@ -0,0 +1,105 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief A JSON document served over D-Bus, with a version as its ETag.
+ *
+ * Either set() the content directly or give it a builder and invalidate()
+ * it whenever an input changes; the builder then runs on the first read
+ * after the last invalidation, however many there were.  The version only
+ * moves when the content actually differs.  Versions come from one
+ * process-wide counter seeded from the wall clock, so a version never
+ * repeats, not even across daemon restarts.
+ *
+ * Not thread-safe; UccDBusData keeps its documents in SnapshotCells and
+ * changes only copies.
+ */
+class VersionedDocument
+{
+public:
+  using Builder = std::function< std::string() >;
+
+  explicit VersionedDocument( std::string initial = {} )
+    : m_json( std::move( initial ) ), m_version( nextVersion() )
+  {
+  }
+
+  VersionedDocument &operator=( std::string json )
+  {
+    set( std::move( json ) );
+    return *this;
+  }
+
+  /// Replace the content
+  void set( std::string json )
+  {
+    m_stale = false;
+    if ( json == m_json )
+      return;
+    m_json = std::move( json );
+    m_version = nextVersion();
+  }
+
+  /// Build the content with @p builder from now on; the next read runs it
+  void setBuilder( Builder builder )
+  {
+    m_builder = std::move( builder );
+    invalidate();
+  }
+
+  /// An input of the builder changed
+  void invalidate() noexcept { m_stale = static_cast< bool >( m_builder ); }
+
+  [[nodiscard]] const std::string &get()
+  {
+    if ( m_stale )
+      set( m_builder() );
+    return m_json;
+  }
+
+  [[nodiscard]] uint64_t version()
+  {
+    ( void ) get();
+    return m_version;
+  }
+
+  /// Content as last set or built; does not run the builder
+  [[nodiscard]] const std::string &current() const noexcept { return m_json; }
+
+  /// Version of current()
+  [[nodiscard]] uint64_t currentVersion() const noexcept { return m_version; }
+
+private:
+  static uint64_t nextVersion() noexcept
+  {
+    static std::atomic< uint64_t > counter{ static_cast< uint64_t >(
+      std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::system_clock::now().time_since_epoch() ).count() ) };
+    return counter.fetch_add( 1, std::memory_order_relaxed ) + 1;
+  }
+
+  std::string m_json;
+  uint64_t m_version;
+  Builder m_builder;
+  bool m_stale = false;
+};
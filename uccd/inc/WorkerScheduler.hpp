@@ -0,0 +1,408 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <syslog.h>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+/**
+ * @brief Shared timer for the periodic daemon workers.
+ *
+ * One dispatcher thread waits in epoll on a timerfd and an eventfd.  The
+ * timerfd is armed for the earliest deadline only, so an idle daemon wakes
+ * exactly when some task is due, never to poll.  Deadlines are kept in a
+ * hashed timer wheel of WHEEL_SLOTS buckets of TICK each; tasks further
+ * out than one revolution stay in their bucket until their round comes.
+ * The eventfd interrupts the wait whenever a task is added, woken or the
+ * scheduler shuts down.
+ *
+ * Due tasks run on a small thread pool.  A task never runs concurrently
+ * with itself: it is re-armed only after its callback returned, or removed
+ * if it returned nullopt.  The next deadline is the one just served plus
+ * the interval the callback asked for, so the period does not grow by the
+ * callback's run time.  A callback that overran its period runs again at
+ * once, without catching up on the missed cycles; a wake() starts the
+ * count afresh from the time of the wake.
+ *
+ * The clock is steady_clock, which is CLOCK_MONOTONIC on Linux, the clock
+ * the timerfd runs on.
+ *
+ * A private scheduler (e.g. for a loop that runs at real-time priority)
+ * passes a thread init function, called first on the dispatcher and on
+ * every pool thread.
+ */
+class WorkerScheduler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using TaskId = uint64_t;
+
+  /// Run once per call; return the delay to the next run, or nullopt to finish
+  using Callback = std::function< std::optional< std::chrono::milliseconds >() >;
+  using ThreadInit = std::function< void() >;
+
+  static constexpr auto TICK = std::chrono::milliseconds( 10 );
+  static constexpr size_t WHEEL_SLOTS = 1024;  ///< One revolution ≈ 10 s
+  static constexpr size_t POOL_THREADS = 3;
+
+  /**
+   * @brief Scheduler shared by all DaemonWorkers of the process.
+   */
+  static WorkerScheduler &instance()
+  {
+    static WorkerScheduler scheduler( POOL_THREADS );
+    return scheduler;
+  }
+
+  explicit WorkerScheduler( size_t threads, ThreadInit threadInit = nullptr )
+    : m_threadInit( std::move( threadInit ) )
+  {
+    m_epollFd = epoll_create1( EPOLL_CLOEXEC );
+    m_timerFd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+    m_eventFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if ( m_epollFd < 0 || m_timerFd < 0 || m_eventFd < 0 )
+    {
+      closeFds();
+      throw std::runtime_error( "WorkerScheduler: cannot create epoll/timerfd/eventfd" );
+    }
+
+    for ( const int fd : { m_timerFd, m_eventFd } )
+    {
+      epoll_event ev{};
+      ev.events = EPOLLIN;
+      ev.data.fd = fd;
+      epoll_ctl( m_epollFd, EPOLL_CTL_ADD, fd, &ev );
+    }
+
+    m_cursor = tickOf( Clock::now() );
+    m_dispatcher = std::thread( [this] {
+      if ( m_threadInit )
+        m_threadInit();
+      dispatchLoop();
+    } );
+    for ( size_t i = 0; i < std::max< size_t >( threads, 1 ); ++i )
+      m_pool.emplace_back( [this] {
+        if ( m_threadInit )
+          m_threadInit();
+        poolLoop();
+      } );
+  }
+
+  ~WorkerScheduler()
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_stopping = true;
+    }
+    signal();
+    m_queueCv.notify_all();
+    if ( m_dispatcher.joinable() )
+      m_dispatcher.join();
+    for ( auto &t : m_pool )
+      t.join();
+    closeFds();
+  }
+
+  WorkerScheduler( const WorkerScheduler & ) = delete;
+  WorkerScheduler &operator=( const WorkerScheduler & ) = delete;
+
+  /**
+   * @brief Register a task.
+   * @param first When the first run is due; now by default
+   */
+  TaskId add( Callback callback, Clock::time_point first = Clock::now() )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    const TaskId id = ++m_lastId;
+    auto task = std::make_shared< Task >();
+    task->callback = std::move( callback );
+    m_tasks.emplace( id, std::move( task ) );
+    arm( id, first );
+    signal();
+    return id;
+  }
+
+  /**
+   * @brief Make a task due now.
+   *
+   * A task that is running is re-run as soon as its current call returns.
+   * Unknown (finished) ids are ignored.
+   */
+  void wake( TaskId id )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    const auto it = m_tasks.find( id );
+    if ( it == m_tasks.end() )
+      return;
+    if ( it->second->busy )
+    {
+      it->second->wakePending = true;
+      return;
+    }
+    arm( id, Clock::now() );
+    signal();
+  }
+
+  /// Number of registered tasks
+  [[nodiscard]] size_t size() const
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_tasks.size();
+  }
+
+private:
+  struct Task
+  {
+    Callback callback;
+    uint64_t generation = 0;   ///< Bumped on re-arm; older wheel entries are stale
+    bool busy = false;         ///< Queued or running
+    bool wakePending = false;
+    Clock::time_point deadline;  ///< Of the current or last run
+  };
+
+  struct Entry
+  {
+    TaskId id;
+    uint64_t generation;
+    int64_t tick;
+    Clock::time_point deadline;
+  };
+
+  static int64_t tickOf( Clock::time_point t ) noexcept
+  {
+    const auto ticks = std::chrono::ceil< std::chrono::milliseconds >( t.time_since_epoch() ) / TICK;
+    return static_cast< int64_t >( ticks );
+  }
+
+  std::vector< Entry > &slot( int64_t tick ) noexcept
+  {
+    return m_wheel[ static_cast< size_t >( tick ) % WHEEL_SLOTS ];
+  }
+
+  bool current( const Entry &e ) const
+  {
+    const auto it = m_tasks.find( e.id );
+    return it != m_tasks.end() && !it->second->busy && it->second->generation == e.generation;
+  }
+
+  /// Caller holds m_mutex
+  void arm( TaskId id, Clock::time_point deadline )
+  {
+    Task &task = *m_tasks.at( id );
+    const int64_t tick = std::max( tickOf( deadline ), m_cursor );
+    slot( tick ).push_back( Entry{ id, ++task.generation, tick, deadline } );
+  }
+
+  void signal() noexcept
+  {
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t n = ::write( m_eventFd, &one, sizeof( one ) );
+  }
+
+  /// Move every due task to the run queue; caller holds m_mutex
+  void collectDue( Clock::time_point now )
+  {
+    const int64_t nowTick = tickOf( now );
+    // after a long gap every bucket has been passed once
+    const int64_t from = std::max( m_cursor, nowTick - static_cast< int64_t >( WHEEL_SLOTS ) + 1 );
+    for ( int64_t t = from; t <= nowTick; ++t )
+    {
+      auto &entries = slot( t );
+      for ( size_t i = 0; i < entries.size(); )
+      {
+        const Entry &e = entries[ i ];
+        const bool stale = !current( e );
+        const bool due = !stale && e.tick <= nowTick && e.deadline <= now;
+        if ( due )
+        {
+          Task &task = *m_tasks.at( e.id );
+          task.busy = true;
+          task.deadline = e.deadline;
+          m_queue.push_back( e.id );
+        }
+        if ( stale || due )
+        {
+          entries[ i ] = entries.back();
+          entries.pop_back();
+        }
+        else
+          ++i;
+      }
+    }
+    // the current tick may still hold entries due later within it
+    m_cursor = nowTick;
+  }
+
+  /// Earliest pending deadline; caller holds m_mutex
+  std::optional< Clock::time_point > nextDeadline() const
+  {
+    std::optional< Clock::time_point > next;
+    for ( size_t k = 0; k < WHEEL_SLOTS && !next; ++k )
+    {
+      const int64_t tick = m_cursor + static_cast< int64_t >( k );
+      for ( const Entry &e : m_wheel[ static_cast< size_t >( tick ) % WHEEL_SLOTS ] )
+        if ( e.tick == tick && current( e ) && ( !next || e.deadline < *next ) )
+          next = e.deadline;
+    }
+    if ( next )
+      return next;
+
+    // nothing within one revolution
+    for ( const auto &entries : m_wheel )
+      for ( const Entry &e : entries )
+        if ( current( e ) && ( !next || e.deadline < *next ) )
+          next = e.deadline;
+    return next;
+  }
+
+  void setTimer( std::optional< Clock::time_point > deadline ) noexcept
+  {
+    itimerspec spec{};
+    if ( deadline )
+    {
+      const auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >( deadline->time_since_epoch() ).count();
+      // 0/0 would disarm the timer; a deadline at the epoch is long past anyway
+      spec.it_value.tv_sec = static_cast< time_t >( ns / 1000000000 );
+      spec.it_value.tv_nsec = static_cast< long >( ns % 1000000000 );
+      if ( spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0 )
+        spec.it_value.tv_nsec = 1;
+    }
+    timerfd_settime( m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr );
+  }
+
+  void dispatchLoop()
+  {
+    std::array< epoll_event, 2 > events{};
+    while ( true )
+    {
+      uint64_t drained = 0;
+      while ( ::read( m_eventFd, &drained, sizeof( drained ) ) > 0 ) {}
+      while ( ::read( m_timerFd, &drained, sizeof( drained ) ) > 0 ) {}
+
+      std::optional< Clock::time_point > next;
+      bool queued = false;
+      {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if ( m_stopping )
+          return;
+        const size_t before = m_queue.size();
+        collectDue( Clock::now() );
+        queued = m_queue.size() != before;
+        next = nextDeadline();
+      }
+      if ( queued )
+        m_queueCv.notify_all();
+      setTimer( next );
+
+      if ( epoll_wait( m_epollFd, events.data(), static_cast< int >( events.size() ), -1 ) < 0 && errno != EINTR )
+      {
+        syslog( LOG_ERR, "WorkerScheduler: epoll_wait failed" );
+        return;
+      }
+    }
+  }
+
+  void poolLoop()
+  {
+    while ( true )
+    {
+      TaskId id = 0;
+      std::shared_ptr< Task > task;
+      {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        m_queueCv.wait( lock, [this] { return m_stopping || !m_queue.empty(); } );
+        if ( m_stopping )
+          return;
+        id = m_queue.front();
+        m_queue.pop_front();
+        task = m_tasks.at( id );
+      }
+
+      std::optional< std::chrono::milliseconds > delay;
+      try
+      {
+        delay = task->callback();
+      }
+      catch ( const std::exception &e )
+      {
+        syslog( LOG_ERR, "WorkerScheduler: task %llu threw: %s", static_cast< unsigned long long >( id ), e.what() );
+      }
+      catch ( ... )
+      {
+        syslog( LOG_ERR, "WorkerScheduler: task %llu threw", static_cast< unsigned long long >( id ) );
+      }
+
+      std::lock_guard< std::mutex > lock( m_mutex );
+      task->busy = false;
+      if ( !delay )
+      {
+        m_tasks.erase( id );
+        continue;
+      }
+      const auto now = Clock::now();
+      const auto next = task->deadline + *delay;
+      arm( id, task->wakePending || next < now ? now : next );
+      task->wakePending = false;
+      signal();
+    }
+  }
+
+  void closeFds() noexcept
+  {
+    for ( int *fd : { &m_epollFd, &m_timerFd, &m_eventFd } )
+    {
+      if ( *fd >= 0 )
+        ::close( *fd );
+      *fd = -1;
+    }
+  }
+
+  const ThreadInit m_threadInit;
+  int m_epollFd = -1;
+  int m_timerFd = -1;
+  int m_eventFd = -1;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_queueCv;
+  std::unordered_map< TaskId, std::shared_ptr< Task > > m_tasks;
+  std::array< std::vector< Entry >, WHEEL_SLOTS > m_wheel;
+  std::deque< TaskId > m_queue;
+  int64_t m_cursor = 0;      ///< Tick up to which buckets have been collected
+  TaskId m_lastId = 0;
+  bool m_stopping = false;
+
+  std::thread m_dispatcher;
+  std::vector< std::thread > m_pool;
+};
@@ -0,0 +1,153 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fnmatch.h>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ProcExecMonitor.hpp"
+#include "TccSettings.hpp"
+
+/**
+ * @brief Picks the profile of the running applications from the workload rules
+ *
+ * Fed with the exec and exit events of the proc connector, it tracks the
+ * processes some rule matches.  The first rule with a live process wins
+ * at once, so a game gets its profile as soon as it is launched; once the
+ * winning rule has lost its last process it is held for RELEASE_MS more
+ * before a lower one, or the stateMap profile, takes over.  A build that
+ * runs thousands of short compiler processes, or a launcher that restarts
+ * its game, thus keeps one profile instead of flapping between two.
+ *
+ * Not thread-safe: the owner serializes event delivery and profile().
+ */
+class WorkloadProfileSelector
+{
+public:
+  static constexpr int64_t RELEASE_MS = 10000;
+
+  void setRules( std::vector< WorkloadRule > rules )
+  {
+    m_rules = std::move( rules );
+    m_processes.clear();
+    m_held = NONE;
+    m_releaseAtMs = 0;
+  }
+
+  [[nodiscard]] const std::vector< WorkloadRule > &rules() const noexcept { return m_rules; }
+
+  /// Index of the first rule @p process matches
+  [[nodiscard]] std::optional< size_t > match( const ProcessIdentity &process ) const
+  {
+    for ( size_t i = 0; i < m_rules.size(); ++i )
+    {
+      const WorkloadRule &rule = m_rules[ i ];
+      if ( rule.exe.empty() && rule.cgroup.empty() )
+        continue;
+      if ( ( rule.exe.empty() || ::fnmatch( rule.exe.c_str(), process.exe.c_str(), 0 ) == 0 )
+           && ( rule.cgroup.empty() || ::fnmatch( rule.cgroup.c_str(), process.cgroup.c_str(), 0 ) == 0 ) )
+        return i;
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief @p pid runs a new executable, @p process if it could be read
+   * @return true if that changed the set of matched processes
+   */
+  bool exec( pid_t pid, const std::optional< ProcessIdentity > &process, int64_t nowMs )
+  {
+    const auto rule = process ? match( *process ) : std::nullopt;
+    if ( !rule )
+      return exit( pid, nowMs );
+
+    m_processes[ pid ] = *rule;
+    if ( *rule == m_held )
+      m_releaseAtMs = 0;
+    return true;
+  }
+
+  /// @return true if @p pid was a matched process
+  bool exit( pid_t pid, int64_t nowMs )
+  {
+    if ( m_processes.erase( pid ) == 0 )
+      return false;
+    if ( m_held != NONE && m_releaseAtMs == 0 && !running( m_held ) )
+      m_releaseAtMs = nowMs + RELEASE_MS;
+    return true;
+  }
+
+  /// Forget every process, e.g. before a rescan after lost events; the held profile stays
+  void forgetProcesses() { m_processes.clear(); }
+
+  /// Profile id to run at @p nowMs; empty: no rule applies
+  [[nodiscard]] std::string profile( int64_t nowMs )
+  {
+    const size_t live = liveRule();
+    if ( live <= m_held )
+    {
+      m_held = live;
+      m_releaseAtMs = 0;
+    }
+    else
+    {
+      // the held rule has no process left
+      if ( m_releaseAtMs == 0 )
+        m_releaseAtMs = nowMs + RELEASE_MS;
+      if ( nowMs >= m_releaseAtMs )
+      {
+        m_held = live;
+        m_releaseAtMs = 0;
+      }
+    }
+    return m_held != NONE ? m_rules[ m_held ].profileId : std::string();
+  }
+
+  /// When a held profile is due to be released, if one is lingering
+  [[nodiscard]] std::optional< int64_t > releaseAtMs() const noexcept
+  {
+    return m_releaseAtMs != 0 ? std::optional< int64_t >( m_releaseAtMs ) : std::nullopt;
+  }
+
+private:
+  static constexpr size_t NONE = std::numeric_limits< size_t >::max();
+
+  [[nodiscard]] size_t liveRule() const noexcept
+  {
+    size_t best = NONE;
+    for ( const auto &[ pid, rule ] : m_processes )
+      best = std::min( best, rule );
+    return best;
+  }
+
+  [[nodiscard]] bool running( size_t rule ) const noexcept
+  {
+    return std::ranges::any_of( m_processes, [rule]( const auto &entry ) { return entry.second == rule; } );
+  }
+
+  std::vector< WorkloadRule > m_rules;
+  std::map< pid_t, size_t > m_processes; ///< matched pid -> rule index
+  size_t m_held = NONE;
+  int64_t m_releaseAtMs = 0;
+};
@@ -15,11 +15,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <cmath>
 #include <iostream>
+#include <optional>
+#include <string_view>
 
 #include "CommonTypes.hpp"
 
@@ -36,6 +40,97 @@ struct FanTableEntry
   FanTableEntry() : temp( 0 ), speed( 0 ) {}
 
   FanTableEntry( int32_t t, int32_t s ) : temp( t ), speed( s ) {}
+
+  bool operator==( const FanTableEntry & ) const = default;
+};
+
+enum class FanControlMode { Curve, Pid };
+
+/**
+ * @brief How a fan profile turns temperature into fan speed
+ *
+ * Curve looks the speed up in the tables.  Pid holds targetTemp with a
+ * PID on the temperature error plus a feed-forward from package power, and
+ * keeps the curve as the lowest speed it will command.
+ *
+ * Either mode can pre-ramp: on a sustained package power step the curve
+ * is read preRampDegPerWatt °C per watt of step higher (at most
+ * preRampMaxDeg), before the heat reaches the sensor.
+ */
+struct FanControllerSettings
+{
+  FanControlMode mode = FanControlMode::Curve;
+  int32_t targetTemp = 75;          ///< °C the PID holds
+  double kp = 3.0;                  ///< % per °C of error
+  double ki = 0.1;                  ///< % per °C·s of accumulated error
+  double kd = 6.0;                  ///< % per °C/s of temperature rise
+  double feedForwardPerWatt = 0.6;  ///< % per W of package power above idleWatts
+  double idleWatts = 10.0;
+  double preRampDegPerWatt = 0.0;   ///< °C of curve boost per W of power step, 0 disables
+  int32_t preRampMaxDeg = 10;       ///< Largest curve boost
+
+  bool operator==( const FanControllerSettings & ) const = default;
+
+  [[nodiscard]] static const char *modeName( FanControlMode mode ) noexcept
+  {
+    return mode == FanControlMode::Pid ? "pid" : "curve";
+  }
+
+  [[nodiscard]] static std::optional< FanControlMode > parseMode( std::string_view name ) noexcept
+  {
+    if ( name == "curve" )
+      return FanControlMode::Curve;
+    if ( name == "pid" )
+      return FanControlMode::Pid;
+    return std::nullopt;
+  }
+};
+
+/**
+ * @brief Fan curve evaluated at every whole degree from 0 to MAX_TEMP °C
+ *
+ * Holds exactly what the interpolating lookup returns at those
+ * temperatures, so evaluating the curve is a single indexed load.
+ * Temperatures outside the range clamp to its ends.
+ */
+class FanCurveLut
+{
+public:
+  static constexpr int32_t MAX_TEMP = 127;
+
+  FanCurveLut() = default;
+
+  /**
+   * @param speedForTemp Curve to sample; a negative result leaves the table empty
+   */
+  template< typename Fn >
+  [[nodiscard]] static FanCurveLut sample( Fn &&speedForTemp )
+  {
+    FanCurveLut lut;
+    for ( int32_t temp = 0; temp <= MAX_TEMP; ++temp )
+    {
+      const int32_t speed = speedForTemp( temp );
+      if ( speed < 0 )
+        return FanCurveLut();
+      lut.m_speed[ static_cast< size_t >( temp ) ] = static_cast< uint8_t >( std::min( speed, 255 ) );
+    }
+    lut.m_valid = true;
+    return lut;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return not m_valid; }
+
+  /// Speed at @p temp, or -1 if the curve has no points
+  [[nodiscard]] int32_t operator()( int32_t temp ) const noexcept
+  {
+    if ( not m_valid )
+      return -1;
+    return m_speed[ static_cast< size_t >( std::clamp( temp, 0, MAX_TEMP ) ) ];
+  }
+
+private:
+  std::array< uint8_t, MAX_TEMP + 1 > m_speed{};
+  bool m_valid = false;
 };
 
 /**
@@ -53,6 +148,7 @@ public:
   std::vector< FanTableEntry > tableGPU;
   std::vector< FanTableEntry > tablePump;
   std::vector< FanTableEntry > tableWaterCoolerFan;
+  FanControllerSettings controller;
 
   FanProfile() = default;
 
@@ -120,34 +216,7 @@ public:
    */
   [[nodiscard]] int32_t getSpeedForTemp( int32_t temp, bool useCPU = true ) const noexcept
   {
-    const auto &table = useCPU ? tableCPU : tableGPU;
-
-    if ( table.empty() )
-      return -1;
-
-    // If temp is at or below first entry, return first speed
-    if ( temp <= table.front().temp )
-      return table.front().speed;
-
-    // find exact match or interpolate
-    for ( size_t i = 1; i < table.size(); ++i )
-    {
-      const auto &prev = table[i-1];
-      const auto &entry = table[i];
-
-      if ( entry.temp == temp ) return entry.speed;
-
-      if ( temp > prev.temp && temp < entry.temp )
-      {
-        int32_t tempDiff = entry.temp - prev.temp;
-        if ( tempDiff == 0 ) return prev.speed;
-        double frac = static_cast<double>( temp - prev.temp ) / static_cast<double>( tempDiff );
-        return static_cast<int32_t>( std::lround( prev.speed + frac * ( entry.speed - prev.speed ) ) );
-      }
-    }
-
-    // temperature is beyond the table, return last speed
-    return table.back().speed;
+    return interpolate( useCPU ? tableCPU : tableGPU, temp );
   }
 
   /**
@@ -169,28 +238,35 @@ public:
       return std::max( cpuSpeed, gpuSpeed );
     }
 
-    const auto &table = tableWaterCoolerFan;
-
-    if ( temp <= table.front().temp )
-      return table.front().speed;
+    return interpolate( tableWaterCoolerFan, temp );
+  }
 
-    for ( size_t i = 1; i < table.size(); ++i )
-    {
-      const auto &prev = table[i-1];
-      const auto &entry = table[i];
-      if ( entry.temp == temp ) return entry.speed;
-      if ( temp > prev.temp && temp < entry.temp )
-      {
-        int32_t tempDiff = entry.temp - prev.temp;
-        if ( tempDiff == 0 ) return prev.speed;
-        double frac = static_cast<double>( temp - prev.temp ) / static_cast<double>( tempDiff );
-        return static_cast<int32_t>( std::lround( prev.speed + frac * ( entry.speed - prev.speed ) ) );
-      }
-    }
+  /**
+   * @brief Sample the CPU, GPU and water cooler fan curves into lookup tables
+   *
+   * Must be called again after changing the tables; the *Curve() accessors
+   * are empty until then.
+   */
+  void compileCurves()
+  {
+    m_cpuCurve = FanCurveLut::sample( [this]( int32_t t ) { return getSpeedForTemp( t, true ); } );
+    m_gpuCurve = FanCurveLut::sample( [this]( int32_t t ) { return getSpeedForTemp( t, false ); } );
+    m_waterCoolerFanCurve = FanCurveLut::sample( [this]( int32_t t ) { return getWaterCoolerFanSpeedForTemp( t ); } );
+  }
 
-    return table.back().speed;
+  /**
+   * @brief True if the tables compileCurves() samples are equal to @p other's
+   */
+  [[nodiscard]] bool sameCurves( const FanProfile &other ) const noexcept
+  {
+    return tableCPU == other.tableCPU and tableGPU == other.tableGPU
+           and tableWaterCoolerFan == other.tableWaterCoolerFan;
   }
 
+  [[nodiscard]] const FanCurveLut &cpuCurve() const noexcept { return m_cpuCurve; }
+  [[nodiscard]] const FanCurveLut &gpuCurve() const noexcept { return m_gpuCurve; }
+  [[nodiscard]] const FanCurveLut &waterCoolerFanCurve() const noexcept { return m_waterCoolerFanCurve; }
+
   /**
    * @brief Get pump speed value for a given temperature from tablePump
    *
@@ -217,6 +293,42 @@ public:
 
     return result;
   }
+
+private:
+  /// Linear interpolation between table points, clamped to the first and last speed
+  static int32_t interpolate( const std::vector< FanTableEntry > &table, int32_t temp ) noexcept
+  {
+    if ( table.empty() )
+      return -1;
+
+    // If temp is at or below first entry, return first speed
+    if ( temp <= table.front().temp )
+      return table.front().speed;
+
+    // find exact match or interpolate
+    for ( size_t i = 1; i < table.size(); ++i )
+    {
+      const auto &prev = table[i-1];
+      const auto &entry = table[i];
+
+      if ( entry.temp == temp ) return entry.speed;
+
+      if ( temp > prev.temp && temp < entry.temp )
+      {
+        int32_t tempDiff = entry.temp - prev.temp;
+        if ( tempDiff == 0 ) return prev.speed;
+        double frac = static_cast<double>( temp - prev.temp ) / static_cast<double>( tempDiff );
+        return static_cast<int32_t>( std::lround( prev.speed + frac * ( entry.speed - prev.speed ) ) );
+      }
+    }
+
+    // temperature is beyond the table, return last speed
+    return table.back().speed;
+  }
+
+  FanCurveLut m_cpuCurve;
+  FanCurveLut m_gpuCurve;
+  FanCurveLut m_waterCoolerFanCurve;
 };
 
 // Stable built-in fan profile IDs
@@ -21,6 +21,7 @@
 #include <vector>
 #include <map>
 #include <optional>
+#include <string_view>
 #include <cstdint>
 
 /**
@@ -87,6 +88,40 @@ struct UccProfileDisplay
   }
 };
 
+/**
+ * @brief Limits for one core class of a hybrid CPU
+ *
+ * Unset fields follow the CPU-wide setting.  onlineCores counts the cores
+ * of the class kept online, e.g. 0 parks every E-core.
+ */
+struct UccProfileCpuClass
+{
+  std::optional< int32_t > onlineCores;
+  std::optional< int32_t > scalingMaxFrequency;
+  std::string energyPerformancePreference;
+
+  bool operator==( const UccProfileCpuClass & ) const = default;
+};
+
+/**
+ * @brief Which cores dynamic parking keeps online the longest
+ */
+enum class CoreParkingPolicy
+{
+  Off,
+  Efficiency,   ///< "efficiency": park P-cores first, light loads run on the E-cores
+  Performance,  ///< "performance": park E-cores first
+};
+
+[[nodiscard]] inline CoreParkingPolicy coreParkingPolicyFromString( const std::string &policy ) noexcept
+{
+  if ( policy == "efficiency" )
+    return CoreParkingPolicy::Efficiency;
+  if ( policy == "performance" )
+    return CoreParkingPolicy::Performance;
+  return CoreParkingPolicy::Off;
+}
+
 /**
  * @brief CPU settings for a profile
  */
@@ -98,6 +133,10 @@ struct UccProfileCpu
   std::string governor;
   std::string energyPerformancePreference;
   bool noTurbo;
+  UccProfileCpuClass performanceCores;  ///< ignored on CPUs without core classes
+  UccProfileCpuClass efficiencyCores;
+  std::string coreParking;  ///< "efficiency" or "performance" parks idle cores within the limits above; empty: off
+  std::vector< std::string > adaptiveEpp;  ///< EPP levels, most efficient first, picked by load instead of the EPPs above
 
   UccProfileCpu()
     : noTurbo( false )
@@ -139,6 +178,8 @@ struct UccProfileFanControl
   std::vector< FanTableEntry > tablePump;
   std::vector< FanTableEntry > tableWaterCoolerFan;
 
+  FanControllerSettings controller; // "controller" object; curve mode when absent
+
   UccProfileFanControl()
     : useControl( true ),
       fanProfile( "fan-balanced" ),
@@ -173,12 +214,55 @@ struct UccODMProfile
   }
 };
 
+enum class PowerLimitMode { Static, Dynamic };
+
+/**
+ * @brief How the ODM power limits are applied
+ *
+ * Static writes tdpValues once.  Dynamic starts from them and lets
+ * PowerLimitController trade power for temperature: above targetTemp the
+ * limits fall at up to fallWattsPerSecond, never below floorPercent of
+ * tdpValues; below it, and while the CPU fan still has duty to spare under
+ * fanDutyLimit, they rise back towards tdpValues at riseWattsPerSecond.
+ *
+ * In either mode gpuShareWatts lets PowerBudgetArbiter move up to that
+ * many watts between the CPU TDPs and the NVIDIA cTGP offset, towards
+ * whichever of the two is power-bound on a shared cooler.
+ */
+struct PowerLimitControllerSettings
+{
+  PowerLimitMode mode = PowerLimitMode::Static;
+  int32_t targetTemp = 90;           ///< °C the package may settle at
+  int32_t fanDutyLimit = 95;         ///< % CPU fan duty above which no more power is granted
+  int32_t floorPercent = 50;         ///< Lowest limit, in % of tdpValues
+  double riseWattsPerSecond = 0.5;
+  double fallWattsPerSecond = 3.0;
+  int32_t gpuShareWatts = 0;         ///< Budget movable between CPU and dGPU, 0 disables
+
+  bool operator==( const PowerLimitControllerSettings & ) const = default;
+
+  [[nodiscard]] static const char *modeName( PowerLimitMode mode ) noexcept
+  {
+    return mode == PowerLimitMode::Dynamic ? "dynamic" : "static";
+  }
+
+  [[nodiscard]] static std::optional< PowerLimitMode > parseMode( std::string_view name ) noexcept
+  {
+    if ( name == "static" )
+      return PowerLimitMode::Static;
+    if ( name == "dynamic" )
+      return PowerLimitMode::Dynamic;
+    return std::nullopt;
+  }
+};
+
 /**
  * @brief ODM power limits
  */
 struct UccODMPowerLimits
 {
   std::vector< int32_t > tdpValues;
+  PowerLimitControllerSettings controller; // "controller" object; static mode when absent
 
   UccODMPowerLimits() = default;
 
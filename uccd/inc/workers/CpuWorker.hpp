@@ -17,8 +17,14 @@
 
 #include "DaemonWorker.hpp"
 #include "../CpuController.hpp"
+#include "../CpuCoreSampler.hpp"
+#include "../CoreParkingGovernor.hpp"
+#include "../AdaptiveEppGovernor.hpp"
 #include "../profiles/UccProfile.hpp"
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <set>
@@ -29,9 +35,9 @@
  *
  * Applies CPU settings from the active profile including:
  * - Scaling governor
- * - Energy performance preference
+ * - Energy performance preference, fixed or adaptive to the load
  * - Min/max scaling frequencies
- * - Online core count
+ * - Online core count, or dynamic core parking within it
  * - Turbo/boost settings
  */
 class CpuWorker : public DaemonWorker
@@ -41,14 +47,13 @@ public:
     std::function< UccProfile() > getActiveProfile,
     std::function< bool() > getCpuSettingsEnabled,
     std::function< void( const std::string & ) > logFunction )
-    : DaemonWorker( std::chrono::milliseconds( 10000 ), false )
+    // nothing periodic: HardwareReconciler probes the settings through validateCpuFreq()
+    : DaemonWorker( std::chrono::hours( 1 ), false )
     , m_cpuCtrl()
     , m_getActiveProfile( std::move( getActiveProfile ) )
     , m_getCpuSettingsEnabled( std::move( getCpuSettingsEnabled ) )
     , m_logFunction( std::move( logFunction ) )
     , m_noEPPWriteQuirk( false )
-    , m_validationFailureCount( 0 )
-    , m_reapplyGaveUp( false )
   {
     // capture the system's current governor and EPP as defaults
     // these are the values the system was booted with, before we modify anything
@@ -63,6 +68,12 @@ public:
       if ( m_systemDefaultEPP.has_value() )
         logLine( "CpuWorker: System default EPP: '" + *m_systemDefaultEPP + "'", LOG_INFO );
     }
+
+    if ( m_cpuCtrl.topology.isHybrid() )
+      logLine( "CpuWorker: Hybrid CPU with "
+               + std::to_string( m_cpuCtrl.topology.count( CpuCoreType::Performance ) ) + " performance and "
+               + std::to_string( m_cpuCtrl.topology.count( CpuCoreType::Efficiency ) ) + " efficiency cores",
+               LOG_INFO );
   }
 
   void onStart() override
@@ -71,57 +82,135 @@ public:
       applyCpuProfile( m_getActiveProfile() );
   }
 
-  void onWork() override
+  void onWork() override {}
+
+  void onExit() override
   {
-    // validate current CPU settings match profile
-    if ( m_getCpuSettingsEnabled() and not validateCpuFreq() )
-    {
-      if ( m_reapplyGaveUp )
-        return;
+    std::lock_guard lock( m_cpuMutex );
+    setCpuDefaultConfig();
+  }
+
+  /**
+   * @brief Re-apply CPU settings from active profile
+   *
+   * Call this when the profile changes to re-apply CPU settings
+   *
+   * @return false while CPU settings are disabled
+   */
+  bool reapplyProfile()
+  {
+    if ( not m_getCpuSettingsEnabled() )
+      return false;
+    applyCpuProfile( m_getActiveProfile() );
+    return true;
+  }
 
-      ++m_validationFailureCount;
+  /**
+   * @brief Follow the load in @p cores with core parking and adaptive EPP
+   * @param powerLimited The package ran at its power limit most of the last interval
+   *
+   * Called at the monitor cadence.  Does nothing unless the active profile
+   * enables either.  A change re-applies the profile, which writes only what
+   * differs, so cores that come back online get its settings again and the
+   * validation passes expect the new values instead of reverting them.
+   */
+  void updateForLoad( const CpuCoreMetrics &cores, bool onBattery, bool powerLimited, int64_t nowMs )
+  {
+    if ( not m_getCpuSettingsEnabled() )
+      return;
 
-      if ( m_validationFailureCount >= maxReapplyAttempts )
-      {
-        logLine( "CpuWorker: CPU settings keep being reverted by another service "
-                 "(e.g. tuned, power-profiles-daemon). Giving up after "
-                 + std::to_string( maxReapplyAttempts ) + " attempts.", LOG_WARNING );
-        m_reapplyGaveUp = true;
-        return;
-      }
+    std::lock_guard lock( m_cpuMutex );
+    if ( not m_coreParking.enabled() and not m_adaptiveEpp.enabled() )
+      return;
 
-      logLine( "CpuWorker: Incorrect settings, reapplying profile "
-               "(attempt " + std::to_string( m_validationFailureCount )
-               + "/" + std::to_string( maxReapplyAttempts ) + ")", LOG_INFO );
-      applyCpuProfile( m_getActiveProfile() );
+    // parked cores have no line in /proc/stat, so only online ones count
+    double busyCores = 0.0, peakBusy = 0.0;
+    size_t online = 0;
+    for ( const double busy : cores.busyPct )
+    {
+      if ( busy < 0.0 )
+        continue;
+      busyCores += busy / 100.0;
+      peakBusy = std::max( peakBusy, busy / 100.0 );
+      ++online;
     }
-    else
+
+    bool changed = false;
+    const int32_t before = m_coreParking.online();
+    if ( m_coreParking.update( nowMs, busyCores, cores.runnable ) )
     {
-      if ( m_validationFailureCount > 0 )
-        m_validationFailureCount = 0;
-      if ( m_reapplyGaveUp )
-        m_reapplyGaveUp = false;
+      logLine( "CpuWorker: Core parking " + std::to_string( before ) + " -> "
+               + std::to_string( m_coreParking.online() ) + " cores online", LOG_DEBUG );
+      changed = true;
     }
+
+    if ( online > 0 )
+    {
+      const AdaptiveEppSample sample{ busyCores / static_cast< double >( online ), peakBusy, onBattery, powerLimited };
+      if ( m_adaptiveEpp.update( nowMs, sample ) )
+      {
+        logLine( "CpuWorker: Adaptive EPP '" + m_appliedProfile.cpu.adaptiveEpp[ m_adaptiveEpp.level() ] + "'",
+                 LOG_DEBUG );
+        changed = true;
+      }
+    }
+
+    if ( changed )
+      applyCpuProfileLocked( m_appliedProfile );
   }
 
-  void onExit() override
+  /**
+   * @brief Changes whenever an apply records new expected settings
+   *
+   * HardwareReconciler's desired-state token for the CPU.
+   */
+  uint64_t appliedGeneration() const noexcept
   {
-    setCpuDefaultConfig();
+    return m_appliedGeneration.load();
   }
 
   /**
-   * @brief Re-apply CPU settings from active profile
+   * @brief Check that the settings of the last apply are still in place
    *
-   * Call this when the profile changes to re-apply CPU settings
+   * Samples the next coresPerValidationPass cores of the plan in turn
+   * instead of recomputing and rereading every core each pass.  Always
+   * true while CPU settings are disabled.
    */
-  void reapplyProfile()
+  bool validateCpuFreq()
   {
-    if ( m_getCpuSettingsEnabled() )
+    if ( not m_getCpuSettingsEnabled() )
+      return true;
+
+    std::lock_guard lock( m_cpuMutex );
+
+    const size_t count = std::min( coresPerValidationPass, m_expected.size() );
+    for ( size_t n = 0; n < count; ++n )
     {
-      m_validationFailureCount = 0;
-      m_reapplyGaveUp = false;
-      applyCpuProfile( m_getActiveProfile() );
+      const auto &expected = m_expected[ m_validationCursor ];
+      m_validationCursor = ( m_validationCursor + 1 ) % m_expected.size();
+
+      if ( auto mismatch = m_cpuCtrl.findMismatch( expected ) )
+      {
+        logLine( "CpuWorker: Unexpected value " + *mismatch, LOG_DEBUG );
+        return false;
+      }
     }
+
+    // check no_turbo setting
+    if ( m_cpuCtrl.noTurboShadow.has_value() )
+    {
+      auto currentNoTurbo = m_cpuCtrl.intelPstateNoTurbo.read();
+
+      if ( currentNoTurbo.has_value() and *currentNoTurbo != *m_cpuCtrl.noTurboShadow )
+      {
+        logLine( "CpuWorker: Unexpected value noTurbo => '"
+                 + std::string( *currentNoTurbo ? "true" : "false" )
+                 + "' instead of '" + std::string( *m_cpuCtrl.noTurboShadow ? "true" : "false" ) + "'", LOG_DEBUG );
+        return false;
+      }
+    }
+
+    return true;
   }
 
   /**
@@ -218,15 +307,22 @@ private:
   std::function< bool() > m_getCpuSettingsEnabled;
   std::function< void( const std::string & ) > m_logFunction;
   bool m_noEPPWriteQuirk;
-  int m_validationFailureCount;
-  bool m_reapplyGaveUp;
   std::optional< std::string > m_defaultGovernor;
   std::optional< std::string > m_systemDefaultGovernor;
   std::optional< std::string > m_systemDefaultEPP;
   std::set< std::string > m_warnedGovernors;
   std::set< std::string > m_warnedEPPs;
 
-  static constexpr int maxReapplyAttempts = 3;
+  // reapplyProfile() applies on the caller's thread, validation runs on the scheduler's
+  std::mutex m_cpuMutex;
+  std::vector< CpuController::ExpectedCoreState > m_expected;  ///< Guarded by m_cpuMutex
+  size_t m_validationCursor = 0;                                 ///< Guarded by m_cpuMutex
+  UccProfile m_appliedProfile;                                   ///< Guarded by m_cpuMutex
+  CoreParkingGovernor m_coreParking;                             ///< Guarded by m_cpuMutex
+  AdaptiveEppGovernor m_adaptiveEpp;                             ///< Guarded by m_cpuMutex
+  std::atomic< uint64_t > m_appliedGeneration{ 0 };
+  // Another service rewrites every core at once, so a few per pass catch it
+  static constexpr size_t coresPerValidationPass = 4;
 
   void logLine( const std::string &message, int priority = LOG_INFO )
   {
@@ -288,19 +384,64 @@ private:
    */
   void applyCpuProfile( const UccProfile &profile )
   {
-    // reset everything to default before applying new settings
-    setCpuDefaultConfig();
+    std::lock_guard lock( m_cpuMutex );
+    m_appliedProfile = profile;
+    configureCoreParking( profile );
+    m_adaptiveEpp.configure( profile.cpu.adaptiveEpp.size() );
+    applyCpuProfileLocked( profile );
+  }
+
+  /**
+   * @brief Let the parking governor work within the profile's static core limits
+   */
+  void configureCoreParking( const UccProfile &profile )
+  {
+    const int32_t total = static_cast< int32_t >( m_cpuCtrl.cores.size() );
+    const auto classCores = [this]( CpuCoreType type, const std::optional< int32_t > &limit ) {
+      const int32_t count = static_cast< int32_t >( m_cpuCtrl.topology.count( type ) );
+      return limit ? std::min( *limit, count ) : count;
+    };
+    m_coreParking.configure( coreParkingPolicyFromString( profile.cpu.coreParking ),
+                             std::min( profile.cpu.onlineCores.value_or( total ), total ),
+                             classCores( CpuCoreType::Performance, profile.cpu.performanceCores.onlineCores ),
+                             classCores( CpuCoreType::Efficiency, profile.cpu.efficiencyCores.onlineCores ) );
+  }
+
+  void applyCpuProfileLocked( const UccProfile &profile )
+  {
+    // Each setting goes straight to its target instead of through the
+    // defaults first; the controller skips whatever already matches, so
+    // re-applying an unchanged profile writes nothing.  Cores come online
+    // first so that they get the settings below too.  The per-class limits
+    // only take effect on hybrid CPUs, where cores have a class; core
+    // parking narrows them further.
+    PerCoreClass< int32_t > onlineCores{ profile.cpu.onlineCores,
+                                         profile.cpu.performanceCores.onlineCores,
+                                         profile.cpu.efficiencyCores.onlineCores };
+    if ( m_coreParking.enabled() )
+    {
+      const PerCoreClass< int32_t > parked = m_coreParking.limits();
+      if ( parked.all )
+        onlineCores.all = parked.all;
+      if ( parked.performance )
+        onlineCores.performance = parked.performance;
+      if ( parked.efficiency )
+        onlineCores.efficiency = parked.efficiency;
+    }
+    m_cpuCtrl.useCores( onlineCores );
 
     // resolve desired governor (profile value or system default)
     auto governor = not profile.cpu.governor.empty()
                       ? std::optional< std::string >( profile.cpu.governor )
                       : getDefaultGovernor();
+    bool governorApplied = false;
 
     if ( governor.has_value() )
     {
       if ( isGovernorAvailable( *governor ) )
       {
         m_cpuCtrl.setGovernor( governor );
+        governorApplied = true;
       }
       else if ( m_warnedGovernors.insert( *governor ).second )
       {
@@ -309,29 +450,85 @@ private:
       }
     }
 
-    // validate and set EPP
-    if ( not m_noEPPWriteQuirk and not profile.cpu.energyPerformancePreference.empty() )
-    {
-      if ( isEPPAvailable( profile.cpu.energyPerformancePreference ) )
-      {
-        m_cpuCtrl.setEnergyPerformancePreference( profile.cpu.energyPerformancePreference );
-      }
-      else if ( m_warnedEPPs.insert( profile.cpu.energyPerformancePreference ).second )
-      {
-        logLine( "CpuWorker: Energy performance preference '" + profile.cpu.energyPerformancePreference
-                 + "' is not available on this system, leaving EPP unmodified", LOG_WARNING );
-      }
-    }
+    // validate and set EPP, the system's original one where the profile has none
+    // an adaptive level replaces the CPU-wide and per-class preferences
+    const PerCoreClass< std::string > profileEPP =
+      m_adaptiveEpp.enabled()
+        ? PerCoreClass< std::string >{ usableEPP( profile.cpu.adaptiveEpp[ m_adaptiveEpp.level() ] ),
+                                       std::nullopt, std::nullopt }
+        : PerCoreClass< std::string >{ usableEPP( profile.cpu.energyPerformancePreference ),
+                                       usableEPP( profile.cpu.performanceCores.energyPerformancePreference ),
+                                       usableEPP( profile.cpu.efficiencyCores.energyPerformancePreference ) };
+    PerCoreClass< std::string > epp = profileEPP;
+    if ( not epp.all )
+      epp.all = defaultEPP();
+    m_cpuCtrl.setEnergyPerformancePreference( epp );
+
+    const PerCoreClass< int32_t > maxFrequency{ profile.cpu.scalingMaxFrequency,
+                                                profile.cpu.performanceCores.scalingMaxFrequency,
+                                                profile.cpu.efficiencyCores.scalingMaxFrequency };
+    m_cpuCtrl.setScalingFrequencies( profile.cpu.scalingMinFrequency, maxFrequency );
+
+    m_cpuCtrl.setNoTurbo( profile.cpu.noTurbo );
+
+    buildValidationPlan( profile.cpu.scalingMinFrequency.has_value(), maxFrequency, governorApplied, profileEPP );
+  }
 
-    m_cpuCtrl.setGovernorScalingMinFrequency( profile.cpu.scalingMinFrequency );
-    m_cpuCtrl.setGovernorScalingMaxFrequency( profile.cpu.scalingMaxFrequency );
+  /// @p epp if the profile sets it and it can be written, warning once per unavailable value
+  std::optional< std::string > usableEPP( const std::string &epp )
+  {
+    if ( m_noEPPWriteQuirk or epp.empty() )
+      return std::nullopt;
+    if ( isEPPAvailable( epp ) )
+      return epp;
+    if ( m_warnedEPPs.insert( epp ).second )
+      logLine( "CpuWorker: Energy performance preference '" + epp
+               + "' is not available on this system, leaving EPP unmodified", LOG_WARNING );
+    return std::nullopt;
+  }
 
-    // set number of online cores
-    m_cpuCtrl.useCores( profile.cpu.onlineCores );
+  /// The system's original EPP, if it can be written back
+  std::optional< std::string > defaultEPP()
+  {
+    if ( not m_noEPPWriteQuirk and m_systemDefaultEPP.has_value() and isEPPAvailable( *m_systemDefaultEPP ) )
+      return m_systemDefaultEPP;
+    return std::nullopt;
+  }
 
-    // set no_turbo if available
-    if ( m_cpuCtrl.intelPstateNoTurbo.isAvailable() )
-      m_cpuCtrl.intelPstateNoTurbo.write( profile.cpu.noTurbo );
+  /**
+   * @brief Record what the validation passes expect after applying a profile
+   *
+   * Only the settings the profile asks for are checked, for each core those
+   * of its class, against the values the controller wrote to it (clamped
+   * and snapped per core, see computeEffectiveMinFreq()).
+   */
+  void buildValidationPlan( bool checkMin, const PerCoreClass< int32_t > &maxFrequency, bool checkGovernor,
+                            const PerCoreClass< std::string > &epp )
+  {
+    m_expected.clear();
+    m_validationCursor = 0;
+    for ( size_t i = 0; i < m_cpuCtrl.cores.size(); ++i )
+    {
+      const LogicalCpuController::Shadow &shadow = m_cpuCtrl.cores[ i ].shadow;
+      if ( shadow.online.has_value() and not *shadow.online )
+        continue;
+
+      CpuController::ExpectedCoreState expected;
+      expected.core = i;
+      const CpuCoreType type = m_cpuCtrl.cores[ i ].type;
+      if ( checkMin )
+        expected.scalingMinFreq = shadow.scalingMinFreq;
+      if ( maxFrequency.of( type ).has_value() )
+        expected.scalingMaxFreq = shadow.scalingMaxFreq;
+      if ( checkGovernor )
+        expected.governor = shadow.governor;
+      if ( epp.of( type ).has_value() )
+        expected.energyPerformancePreference = shadow.energyPerformancePreference;
+      if ( expected.scalingMinFreq or expected.scalingMaxFreq or expected.governor
+           or expected.energyPerformancePreference )
+        m_expected.push_back( std::move( expected ) );
+    }
+    ++m_appliedGeneration;
   }
 
   /**
@@ -340,125 +537,14 @@ private:
   void setCpuDefaultConfig()
   {
     m_cpuCtrl.useCores( std::nullopt ); // all cores
-    m_cpuCtrl.setGovernorScalingMinFrequency( std::nullopt ); // min
-    m_cpuCtrl.setGovernorScalingMaxFrequency( std::nullopt ); // max
-
-    // restore the system's original EPP
-    if ( not m_noEPPWriteQuirk and m_systemDefaultEPP.has_value()
-         and isEPPAvailable( *m_systemDefaultEPP ) )
-      m_cpuCtrl.setEnergyPerformancePreference( *m_systemDefaultEPP );
-
-    if ( m_cpuCtrl.intelPstateNoTurbo.isAvailable() )
-      m_cpuCtrl.intelPstateNoTurbo.write( false );
+    m_cpuCtrl.setScalingFrequencies( std::nullopt, std::nullopt ); // full range
+    restoreDefaultEPP();
+    m_cpuCtrl.setNoTurbo( false );
   }
 
-  /**
-   * @brief Validate current CPU frequency settings match profile
-   */
-  bool validateCpuFreq()
+  // restore the system's original EPP
+  void restoreDefaultEPP()
   {
-    const UccProfile profile = m_getActiveProfile();
-    {
-      // Determine acpi-cpufreq fallback flag once — mirrors setGovernorScalingMaxFrequency
-      bool acpiFallback = false;
-      if ( m_cpuCtrl.boost.isAvailable() )
-      {
-        for ( const auto &firstCore : m_cpuCtrl.cores )
-        {
-          if ( auto driverStr = firstCore.scalingDriver.read() )
-          {
-            acpiFallback = ( *driverStr == "acpi-cpufreq" );
-            break;
-          }
-        }
-      }
-
-      // validate scaling frequencies match profile
-      for ( const auto &core : m_cpuCtrl.cores )
-      {
-        if ( core.coreIndex == 0 or core.online.read().value_or( false ) )
-        {
-          // check minimum frequency — compare against the per-core clamped+snapped value
-          // that setGovernorScalingMinFrequency() actually wrote, not the raw profile target
-          // (which would differ for E-cores / lower-binned P-cores)
-          if ( profile.cpu.scalingMinFrequency.has_value() )
-          {
-            auto currentMin = core.scalingMinFreq.read();
-            auto expectedMin = CpuController::computeEffectiveMinFreq( core, profile.cpu.scalingMinFrequency );
-
-            if ( currentMin.has_value() and expectedMin.has_value() and *currentMin != *expectedMin )
-            {
-              logLine( "CpuWorker: Unexpected value core" + std::to_string( core.coreIndex )
-                       + " minimum scaling frequency " + std::to_string( *currentMin )
-                       + " instead of " + std::to_string( *expectedMin ), LOG_DEBUG );
-              return false;
-            }
-          }
-
-          // check maximum frequency — compare against the per-core clamped+snapped value.
-          // On heterogeneous CPUs (Intel Turbo Boost Max 3.0, P+E cores) every core type
-          // has its own cpuinfo_max_freq ceiling; the profile stores the global requested
-          // max but each core will have been written a different effective value.
-          if ( profile.cpu.scalingMaxFrequency.has_value() )
-          {
-            auto currentMax = core.scalingMaxFreq.read();
-            auto expectedMax = CpuController::computeEffectiveMaxFreq( core, profile.cpu.scalingMaxFrequency, acpiFallback );
-
-            if ( currentMax.has_value() and expectedMax.has_value() and *currentMax != *expectedMax )
-            {
-              logLine( "CpuWorker: Unexpected value core" + std::to_string( core.coreIndex )
-                       + " maximum scaling frequency " + std::to_string( *currentMax )
-                       + " instead of " + std::to_string( *expectedMax ), LOG_DEBUG );
-              return false;
-            }
-          }
-
-          const auto expectedGovernor = not profile.cpu.governor.empty() ? std::optional< std::string >( profile.cpu.governor )
-                                                                         : getDefaultGovernor();
-          if ( expectedGovernor.has_value() and isGovernorAvailable( *expectedGovernor ) )
-          {
-            auto currentGovernor = core.scalingGovernor.read();
-
-            if ( currentGovernor.has_value() and *currentGovernor != *expectedGovernor )
-            {
-              logLine( "CpuWorker: Unexpected value core" + std::to_string( core.coreIndex )
-                       + " scaling governor '" + *currentGovernor + "' instead of '" + *expectedGovernor + "'", LOG_DEBUG );
-              return false;
-            }
-          }
-
-          // check energy performance preference (skip if value is not available on this system)
-          if ( not m_noEPPWriteQuirk and not profile.cpu.energyPerformancePreference.empty()
-               and isEPPAvailable( profile.cpu.energyPerformancePreference ) )
-          {
-            auto currentEPP = core.energyPerformancePreference.read();
-
-            if ( currentEPP.has_value() and *currentEPP != profile.cpu.energyPerformancePreference )
-            {
-              logLine( "CpuWorker: Unexpected value core" + std::to_string( core.coreIndex )
-                       + " energy performance preference => '" + *currentEPP
-                       + "' instead of '" + profile.cpu.energyPerformancePreference + "'", LOG_DEBUG );
-              return false;
-            }
-          }
-        }
-      }
-
-      // check no_turbo setting
-      if ( m_cpuCtrl.intelPstateNoTurbo.isAvailable() )
-      {
-        auto currentNoTurbo = m_cpuCtrl.intelPstateNoTurbo.read();
-
-        if ( currentNoTurbo.has_value() and *currentNoTurbo != profile.cpu.noTurbo )
-        {
-          logLine( "CpuWorker: Unexpected value noTurbo => '"
-                   + std::string( *currentNoTurbo ? "true" : "false" )
-                   + "' instead of '" + std::string( profile.cpu.noTurbo ? "true" : "false" ) + "'", LOG_DEBUG );
-          return false;
-        }
-      }
-    }
-
-    return true;
+    m_cpuCtrl.setEnergyPerformancePreference( defaultEPP() );
   }
 };
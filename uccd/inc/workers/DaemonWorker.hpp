@@ -15,12 +15,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
 #include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <condition_variable>
+#include <mutex>
 #include <syslog.h>
 #include <cstdio>
+#include <QObject>
 #include <QThread>
 #include <typeinfo>
+#include "../AsyncLog.hpp"
+#include "../WorkerScheduler.hpp"
+#include "UccTrace.hpp"
 
 namespace ucc {
   // Worker debug flag: when true, worker classes will emit debug messages.
@@ -45,8 +56,9 @@ namespace ucc {
 #if defined(__GNUC__)
 #pragma GCC diagnostic pop
 #endif
+    // queued: a busy journald must not stall the worker
     if ( n >= 0 )
-      syslog(LOG_DEBUG, "%s", buf);
+      ucc::asyncLog(LOG_DEBUG, std::string_view(buf, std::min(static_cast<size_t>(n), sizeof(buf) - 1)));
   }
 
   template<typename Func>
@@ -68,25 +80,63 @@ namespace ucc {
 }
 
 /**
- * @brief Abstract base class for daemon worker threads
+ * @brief Cycle timing of one DaemonWorker since it started
+ *
+ * Durations are of onWork() alone.  Periods are start-to-start intervals
+ * of timer-driven cycles; a cycle started early by wake() ends the
+ * preceding period without being counted.
+ */
+struct DaemonWorkerStats
+{
+  /// onWork() duration bucket i counts [2^(i-1), 2^i) ms; 0 is < 1 ms, the last is open
+  static constexpr size_t HISTOGRAM_BUCKETS = 12;
+
+  uint64_t cycles = 0;
+  uint64_t overruns = 0;           ///< onWork() longer than the timeout
+  uint64_t wakes = 0;              ///< Cycles run early by wake()
+  std::array< uint64_t, HISTOGRAM_BUCKETS > durationHistogram{};
+  double lastWorkMs = 0.0;
+  double maxWorkMs = 0.0;
+  double totalWorkMs = 0.0;
+  double totalCpuMs = 0.0;         ///< Thread CPU time spent in onWork()
+  uint64_t periods = 0;
+  double totalPeriodMs = 0.0;
+  double totalNominalMs = 0.0;     ///< Sum of the timeouts over the same periods
+  double maxLateMs = 0.0;          ///< Largest period minus its timeout
+  double nominalPeriodMs = 0.0;    ///< Current timeout
+
+  static size_t bucketOf( double ms ) noexcept
+  {
+    const auto whole = static_cast< uint64_t >( std::max( ms, 0.0 ) );
+    return std::min< size_t >( static_cast< size_t >( std::bit_width( whole ) ), HISTOGRAM_BUCKETS - 1 );
+  }
+};
+
+/**
+ * @brief Abstract base class for periodic daemon workers
  *
  * Provides a framework for periodic work execution with automatic timer management.
  * Subclasses must implement onStart(), onWork(), and onExit() lifecycle methods.
  *
- * The worker automatically creates a background thread that:
+ * Workers do not own a thread.  Each one is a task of the process-wide
+ * WorkerScheduler (or of a private one given to the constructor), whose pool:
  *   - Calls onStart() once at initialization
  *   - Calls onWork() repeatedly at the specified timeout interval
  *   - Calls onExit() during cleanup
  *
- * Uses QThread for proper Qt object threading support.
+ * The calls of one worker never overlap, but they may run on different
+ * pool threads; workers must not rely on thread-local state between cycles.
+ * Cycles start on absolute steady_clock deadlines, one timeout apart, so
+ * the time onWork() takes does not stretch the period.  wake() runs a
+ * cycle immediately and restarts the period from there.
  *
  * Usage:
  *   - Create concrete subclass inheriting from DaemonWorker
  *   - Implement pure virtual methods: onStart(), onWork(), onExit()
- *   - Constructor automatically starts the timer thread
+ *   - Constructor automatically schedules the worker
  *   - Call stop() to gracefully shutdown the worker
  */
-class DaemonWorker : public QThread
+class DaemonWorker : public QObject
 {
   Q_OBJECT
 
@@ -94,17 +144,20 @@ public:
   /**
    * @brief Constructor
    *
-   * Creates the worker and automatically starts the timer thread if autoStart is true.
-   * The thread will:
+   * Creates the worker and automatically schedules it if autoStart is true.
+   * The scheduler will:
    *   1. Call onStart() once on startup
    *   2. Repeatedly call onWork() at timeout intervals
-   *   3. Call onExit() when the thread stops
+   *   3. Call onExit() when the worker stops
    *
    * @param timeout Duration in milliseconds between work cycles
-   * @param autoStart Whether to automatically start the worker thread
+   * @param autoStart Whether to automatically start the worker
+   * @param scheduler Scheduler to run on; the process-wide one unless the
+   *        worker needs threads of its own
    */
-  explicit DaemonWorker( std::chrono::milliseconds timeout, bool autoStart = true )
-    : m_timeout( timeout ), m_isRunning( false )
+  explicit DaemonWorker( std::chrono::milliseconds timeout, bool autoStart = true,
+                         WorkerScheduler &scheduler = WorkerScheduler::instance() )
+    : m_timeout( timeout ), m_isRunning( false ), m_scheduler( scheduler )
   {
     if ( autoStart )
       start();
@@ -113,8 +166,8 @@ public:
   /**
    * @brief Virtual destructor
    *
-   * Automatically stops the timer thread.
-   * Note: onExit() is NOT called when the thread stops due to destruction,
+   * Automatically stops the worker.
+   * Note: onExit() is NOT called when the worker stops due to destruction,
    * because the derived class vtable is no longer valid at this point.
    * Derived classes that need cleanup should call stop() in their own destructor.
    */
@@ -131,36 +184,120 @@ public:
   DaemonWorker &operator=( DaemonWorker && ) = delete;
 
   /**
-   * @brief Gracefully stop the worker thread
+   * @brief Gracefully stop the worker and wait for its last cycle
    */
   void stop()
   {
-    if ( m_isRunning )
-    {
-      m_isRunning = false;
-      QThread::wait();
-    }
+    requestStop();
+    waitForFinished();
   }
 
   /**
-   * @brief Signal the worker to stop without waiting for the thread to finish.
-   * Call waitForFinished() afterwards to join the thread.
+   * @brief Signal the worker to stop without waiting for it to finish.
+   * Call waitForFinished() afterwards to join.
    */
   void requestStop() noexcept
   {
-    m_isRunning = false;
+    if ( !m_isRunning.exchange( false ) )
+      return;
+    // run the exit cycle now instead of at the next deadline
+    m_scheduler.wake( m_task );
   }
 
   /**
-   * @brief Start the worker thread
+   * @brief Block until onExit() (or the aborted cycle) has returned.
+   */
+  void waitForFinished()
+  {
+    std::unique_lock< std::mutex > lock( m_stateMutex );
+    m_finishedCv.wait( lock, [this] { return m_finished; } );
+  }
+
+  /**
+   * @brief True once the worker has stopped, or if it never started.
+   */
+  [[nodiscard]] bool isFinished() const
+  {
+    std::lock_guard< std::mutex > lock( m_stateMutex );
+    return m_finished;
+  }
+
+  /**
+   * @brief Cut the current sleep short and run the next work cycle now.
+   */
+  void wake() noexcept
+  {
+    if ( !m_isRunning )
+      return;
+    m_wakeRequested = true;
+    m_scheduler.wake( m_task );
+  }
+
+  /**
+   * @brief Skip the work cycles until resume(), without stopping the worker.
+   *
+   * Does not wait: isPaused() turns true once a cycle in progress has
+   * returned.  stop() still runs onExit() while paused.
+   */
+  void pause() noexcept
+  {
+    if ( m_pauseRequested.exchange( true ) || !m_isRunning )
+      return;
+    m_scheduler.wake( m_task );
+  }
+
+  /**
+   * @brief Undo pause() and run a work cycle right away
+   */
+  void resume() noexcept
+  {
+    if ( m_pauseRequested.exchange( false ) )
+      wake();
+  }
+
+  /**
+   * @brief True while paused with no cycle running, or once finished
+   */
+  [[nodiscard]] bool isPaused() const
+  {
+    std::lock_guard< std::mutex > lock( m_stateMutex );
+    return m_paused || m_finished;
+  }
+
+  /**
+   * @brief Snapshot of the cycle timing; safe from any thread
+   */
+  [[nodiscard]] DaemonWorkerStats stats() const
+  {
+    std::lock_guard< std::mutex > lock( m_statsMutex );
+    DaemonWorkerStats s = m_stats;
+    s.nominalPeriodMs = static_cast< double >( getTimeout().count() );
+    return s;
+  }
+
+  /**
+   * @brief Change the interval between work cycles; applies from the next sleep.
+   */
+  void setTimeout( std::chrono::milliseconds timeout ) noexcept
+  {
+    m_timeout.store( timeout, std::memory_order_relaxed );
+  }
+
+  /**
+   * @brief Schedule the worker; onStart() and the first onWork() run right away
    */
   void start()
   {
     if ( m_isRunning )
       return;
 
+    {
+      std::lock_guard< std::mutex > lock( m_stateMutex );
+      m_finished = false;
+      m_started = false;
+    }
     m_isRunning = true;
-    QThread::start();
+    m_task = m_scheduler.add( [this] { return cycle(); } );
   }
 
   /**
@@ -169,12 +306,12 @@ public:
    */
   [[nodiscard]] std::chrono::milliseconds getTimeout() const noexcept
   {
-    return m_timeout;
+    return m_timeout.load( std::memory_order_relaxed );
   }
 
   /**
    * @brief Check if the worker is running
-   * @return True if the worker thread is active
+   * @return True until stop is requested
    */
   [[nodiscard]] bool isRunning() const noexcept
   {
@@ -182,53 +319,10 @@ public:
   }
 
 protected:
-  /**
-   * @brief QThread run method override
-   */
-  void run() override
-  {
-    try
-    {
-      ucc::wDebug("[DEBUG] DaemonWorker: starting %s on thread %p", typeid(*this).name(), reinterpret_cast<void*>(QThread::currentThreadId()) );
-      onStart();
-
-      bool firstLoop = true;
-      while ( m_isRunning )
-      {
-        if ( firstLoop ) {
-          ucc::wDebug("[DEBUG] DaemonWorker: first onWork for %s", typeid(*this).name());
-          firstLoop = false;
-        }
-        onWork();
-
-        // Interruptible sleep: check m_isRunning every 200ms so that
-        // requestStop() is noticed promptly, not after the full timeout.
-        // Without this, CpuWorker (10s) alone would exceed the SIGTERM
-        // grace period.
-        auto remaining = m_timeout;
-        constexpr auto step = std::chrono::milliseconds( 200 );
-        while ( remaining > std::chrono::milliseconds::zero() && m_isRunning )
-        {
-          auto chunk = std::min( remaining, step );
-          QThread::msleep( static_cast< unsigned long >( chunk.count() ) );
-          remaining -= chunk;
-        }
-      }
-
-      ucc::wDebug("[DEBUG] DaemonWorker: exiting %s", typeid(*this).name());
-      if ( !m_destroying )
-        onExit();
-    }
-    catch ( const std::exception &e )
-    {
-      // Log exception to prevent silent thread failures
-      syslog( LOG_ERR, "DaemonWorker %s caught exception: %s", typeid(*this).name(), e.what() );
-    }
-  }
   /**
    * @brief Called once when the worker starts
    *
-   * Invoked by the timer thread on startup, before the periodic work loop begins.
+   * Invoked on a scheduler thread before the periodic work cycles begin.
    * Must be implemented by derived classes.
    */
   virtual void onStart() = 0;
@@ -236,7 +330,7 @@ protected:
   /**
    * @brief Called repeatedly during the work cycle
    *
-   * Invoked by the timer thread at each timeout interval.
+   * Invoked on a scheduler thread at each timeout interval.
    * Must be implemented by derived classes.
    */
   virtual void onWork() = 0;
@@ -244,13 +338,125 @@ protected:
   /**
    * @brief Called when the worker exits
    *
-   * Invoked by the timer thread when stop() is called.
+   * Invoked on a scheduler thread when stop() is called.
    * Must be implemented by derived classes.
    */
   virtual void onExit() = 0;
 
 private:
-  const std::chrono::milliseconds m_timeout;
+  /**
+   * @brief One scheduler call: start, work or exit
+   * @return Delay to the next cycle, nullopt once finished
+   */
+  std::optional< std::chrono::milliseconds > cycle() noexcept
+  {
+    try
+    {
+      if ( m_isRunning && m_pauseRequested )
+      {
+        std::lock_guard< std::mutex > lock( m_stateMutex );
+        m_paused = true;
+        return getTimeout();
+      }
+      if ( m_paused )
+      {
+        std::lock_guard< std::mutex > lock( m_stateMutex );
+        m_paused = false;
+      }
+
+      if ( m_isRunning )
+      {
+        if ( !m_started )
+        {
+          ucc::wDebug("[DEBUG] DaemonWorker: starting %s on thread %p", typeid(*this).name(), reinterpret_cast<void*>(QThread::currentThreadId()) );
+          onStart();
+          m_started = true;
+          ucc::wDebug("[DEBUG] DaemonWorker: first onWork for %s", typeid(*this).name());
+        }
+        timedWork();
+        if ( m_isRunning )
+          return getTimeout();
+      }
+
+      ucc::wDebug("[DEBUG] DaemonWorker: exiting %s", typeid(*this).name());
+      if ( m_started && !m_destroying )
+        onExit();
+    }
+    catch ( const std::exception &e )
+    {
+      // Log exception to prevent silent worker failures
+      syslog( LOG_ERR, "DaemonWorker %s caught exception: %s", typeid(*this).name(), e.what() );
+      m_isRunning = false;
+    }
+
+    // Notify under the lock: the waiter may destroy this worker as soon
+    // as it can observe m_finished.
+    std::lock_guard< std::mutex > lock( m_stateMutex );
+    m_finished = true;
+    m_finishedCv.notify_all();
+    return std::nullopt;
+  }
+
+  static double cpuTimeMs() noexcept
+  {
+    timespec ts{};
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+    return static_cast< double >( ts.tv_sec ) * 1e3 + static_cast< double >( ts.tv_nsec ) / 1e6;
+  }
+
+  /// onWork() with its wall and CPU time recorded
+  void timedWork()
+  {
+    using Clock = std::chrono::steady_clock;
+    const bool woken = m_wakeRequested.exchange( false );
+    const Clock::time_point begin = Clock::now();
+    const double cpuBegin = cpuTimeMs();
+    const double nominalMs = static_cast< double >( getTimeout().count() );
+
+    {
+      UCC_TRACE_SCOPE( "worker", typeid( *this ).name() );
+      onWork();
+    }
+
+    const double workMs = std::chrono::duration< double, std::milli >( Clock::now() - begin ).count();
+    const double cpuMs = cpuTimeMs() - cpuBegin;
+
+    std::lock_guard< std::mutex > lock( m_statsMutex );
+    DaemonWorkerStats &s = m_stats;
+    ++s.cycles;
+    ++s.durationHistogram[ DaemonWorkerStats::bucketOf( workMs ) ];
+    s.lastWorkMs = workMs;
+    s.maxWorkMs = std::max( s.maxWorkMs, workMs );
+    s.totalWorkMs += workMs;
+    s.totalCpuMs += cpuMs;
+    if ( workMs > nominalMs )
+      ++s.overruns;
+    if ( woken )
+      ++s.wakes;
+    else if ( m_lastCycleStart != Clock::time_point() )
+    {
+      const double periodMs = std::chrono::duration< double, std::milli >( begin - m_lastCycleStart ).count();
+      ++s.periods;
+      s.totalPeriodMs += periodMs;
+      s.totalNominalMs += nominalMs;
+      s.maxLateMs = std::max( s.maxLateMs, periodMs - nominalMs );
+    }
+    m_lastCycleStart = begin;
+  }
+
+  std::atomic< std::chrono::milliseconds > m_timeout;
   std::atomic< bool > m_isRunning;
+  WorkerScheduler &m_scheduler;
   std::atomic< bool > m_destroying { false };
+  std::atomic< WorkerScheduler::TaskId > m_task { 0 };
+  bool m_started = false;        ///< onStart() ran; touched by the running cycle only
+  mutable std::mutex m_stateMutex;
+  std::condition_variable m_finishedCv;
+  bool m_finished = true;        ///< Guarded by m_stateMutex
+  bool m_paused = false;         ///< Guarded by m_stateMutex; written by the running cycle only
+  std::atomic< bool > m_pauseRequested { false };
+  std::atomic< bool > m_wakeRequested { false };
+  mutable std::mutex m_statsMutex;
+  DaemonWorkerStats m_stats;     ///< Guarded by m_statsMutex
+  std::chrono::steady_clock::time_point m_lastCycleStart;  ///< Guarded by m_statsMutex
 };
@@ -16,62 +16,56 @@
 #pragma once
 
 #include "DaemonWorker.hpp"
+#include "../BrightnessRamp.hpp"
+#include "../DrmDisplayModes.hpp"
+#include "../PanelRefreshPolicy.hpp"
+#include "../UdevMonitor.hpp"
 #include "SysfsNode.hpp"
 #include "Utils.hpp"
 #include "../profiles/UccProfile.hpp"
+#include <atomic>
 #include <string>
 #include <vector>
 #include <optional>
 #include <functional>
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <syslog.h>
 
-/**
- * @brief Display mode structure
- */
-struct DisplayMode
-{
-  std::vector< double > refreshRates;
-  int xResolution;
-  int yResolution;
-
-  DisplayMode() : xResolution( 0 ), yResolution( 0 ) {}
-};
-
-/**
- * @brief Display information structure
- */
-struct DisplayInfo
-{
-  std::string displayName;
-  DisplayMode activeMode;
-  std::vector< DisplayMode > displayModes;
-
-  DisplayInfo() : displayName( "" ) {}
-};
-
 /**
  * @brief Controller for display backlight brightness via sysfs
  *
  * Reads and writes brightness through sysfs LED interface.
  * Includes workaround for amdgpu_bl driver brightness inversion.
+ * The brightness attribute stays open, so the steps of a fade cost one
+ * pwrite() each.  Raw values are 0..max with 0 darkest on every driver.
  */
 class DisplayBacklightController
 {
 public:
   explicit DisplayBacklightController( const std::string &basePath, int maxBrightness, bool isAmdgpuBl );
+  ~DisplayBacklightController();
+
+  DisplayBacklightController( const DisplayBacklightController & ) = delete;
+  DisplayBacklightController &operator=( const DisplayBacklightController & ) = delete;
 
   [[nodiscard]] int getBrightness() const noexcept;
   bool setBrightness( int brightness ) noexcept;
   [[nodiscard]] const std::string &getDriverName() const noexcept { return m_driverName; }
 
+  /// Raw value of a brightness percentage
+  [[nodiscard]] int toRaw( int brightness ) const noexcept;
+  [[nodiscard]] std::optional< int > readRaw() const noexcept;
+  bool writeRaw( int raw ) noexcept;
+
 private:
   std::string m_basePath;
   std::string m_driverName;
   int m_maxBrightness;
   bool m_isAmdgpuBl;
+  int m_brightnessFd = -1;
 };
 
 /**
@@ -85,11 +79,20 @@ private:
  *   - Applies brightness from active profile on start
  *   - Periodically persists brightness to autosave
  *   - Works with Intel, AMD, and amdgpu_bl backlight drivers
+ *   - Re-enumerates the drivers on udev "backlight" add/remove events only
+ *   - Fades brightness changes in fixed steps (BrightnessRamp) when a ramp
+ *     duration is set; the worker runs one cycle per step while fading
  *
- * Refresh rate features (X11 only):
- *   - Detects available display modes and refresh rates via xrandr
- *   - Applies refresh rate from active profile
- *   - Only active on X11 sessions (disabled on Wayland)
+ * Refresh rate features:
+ *   - Reads the panel's modes and refresh rates from DRM/KMS, falling back
+ *     to xrandr where no KMS driver drives the panel
+ *   - Re-reads them only on login changes and udev "drm" events (hotplug,
+ *     mode list changes), so no X client is spawned while idle
+ *   - Applies refresh rate from active profile: by DRM mode-set while no
+ *     compositor holds the card, else through xrandr on X11 and through the
+ *     compositor's output management on Wayland (wlr-randr, kscreen-doctor)
+ *   - With the refresh saver on, drops the panel to its lowest rate on
+ *     battery or while the session is idle (PanelRefreshPolicy)
  *   - Monitors user login/logout to reset state
  */
 class DisplayWorker : public DaemonWorker
@@ -119,6 +122,17 @@ public:
    */
   bool setBrightness( int32_t brightness ) noexcept;
 
+  /**
+   * @brief Fade to the active profile's brightness, if it sets one
+   */
+  void reapplyProfile() noexcept;
+
+  /**
+   * @brief Duration of brightness fades; zero writes changes at once.
+   *        Set before start().
+   */
+  void setBrightnessRamp( std::chrono::milliseconds duration ) noexcept { m_rampDuration = duration; }
+
   /**
    * @brief Get current active display mode
    * @return Active display mode or nullopt if not available
@@ -132,6 +146,18 @@ public:
    */
   bool setRefreshRate( int refreshRate ) noexcept;
 
+  /**
+   * @brief Follow the power hints with the panel's refresh rate.
+   *        Set before start().
+   */
+  void setRefreshSaver( bool enabled ) noexcept { m_refreshSaver = enabled; }
+
+  /**
+   * @brief Power source and session idle state for the refresh saver;
+   *        a change is applied at once
+   */
+  void setPowerHints( bool onBattery, bool idle ) noexcept;
+
 protected:
   void onStart() override;
   void onWork() override;
@@ -145,10 +171,17 @@ private:
   std::string m_autosavePath;
   std::function< int32_t() > m_getAutosaveBrightness;
   std::function< void( int32_t ) > m_setAutosaveBrightness;
+  // guards the controller and the ramp: D-Bus calls come from the main thread
+  std::mutex m_backlightMutex;
   std::unique_ptr< DisplayBacklightController > m_backlightController;
+  UdevMonitor m_backlightEvents;
+  BrightnessRamp m_ramp;
+  std::chrono::milliseconds m_rampDuration{ 0 };
 
   void initBacklight();
-  void applyBacklightFromProfile();
+  bool applyBacklightFromProfile( std::chrono::milliseconds duration );
+  bool fadeBrightness( int brightness, std::chrono::milliseconds duration ) noexcept;
+  bool stepBrightnessRamp() noexcept;
   void reenumerateBacklightDrivers();
 
   // --- Refresh rate state ---
@@ -158,14 +191,25 @@ private:
 
   DisplayInfo m_displayInfo;
   bool m_displayInfoFound;
+  UdevMonitor m_drmEvents;
   std::string m_previousUsers;
   bool m_isX11;
   bool m_isWayland;
   std::string m_displayEnvVariable;
   std::string m_xAuthorityFile;
   std::string m_displayName;
+  std::string m_waylandDisplay;
+  std::string m_runtimeDir;
+  std::string m_currentDesktop;
+  std::string m_sessionBusAddress;
+  uid_t m_sessionUid = 0;
   uint32_t m_refreshRateCycleCounter;
 
+  bool m_refreshSaver = false;
+  std::atomic< bool > m_onBattery{ false };
+  std::atomic< bool > m_idle{ false };
+  std::atomic< bool > m_powerHintsChanged{ false };
+
   std::pair< bool, bool > checkUsers() noexcept;
   void resetRefreshRateState() noexcept;
   void setEnvVariables() noexcept;
@@ -174,5 +218,6 @@ private:
   void updateDisplayData() noexcept;
   std::string serializeDisplayInfo( const DisplayInfo &info ) const noexcept;
   void setActiveDisplayMode() noexcept;
-  void setDisplayMode( int xRes, int yRes, int refRate ) noexcept;
+  bool setDisplayMode( int xRes, int yRes, double refRate ) noexcept;
+  bool setWaylandDisplayMode( int xRes, int yRes, double refRate ) noexcept;
 };
@@ -16,303 +16,219 @@
 #pragma once
 
 #include "DaemonWorker.hpp"
+#include "../SamplingGovernor.hpp"
+#include "../FanCalibration.hpp"
+#include "../FanControlLogic.hpp"
+#include "../FanLatencyTrace.hpp"
+#include "../EcIoService.hpp"
+#include "../MetricsHistoryStore.hpp"
+#include "../FanWatchdog.hpp"
 #include "../profiles/UccProfile.hpp"
 #include "../profiles/FanProfile.hpp"
-#include "tuxedo_io_lib/tuxedo_io_api.hh"
 #include <vector>
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <syslog.h>
 
-enum class FanLogicType { CPU, GPU };
-
 /**
- * @brief Temperature filter using Exponentially Weighted Moving Average (EWMA)
+ * @brief Everything the fan worker read from the EC in one cycle
  *
- * Replaces the old trimmed-mean buffer.  EWMA reacts faster to genuine
- * temperature changes while still rejecting single-sample noise.
- * Two different smoothing factors are used:
- *   - alphaRising  (0.5) — when new reading is above current estimate,
- *                           respond quickly to heating.
- *   - alphaFalling (0.15) — when new reading is below current estimate,
- *                           cool-down is smoothed more aggressively to
- *                           prevent premature fan-speed drops.
+ * Published once per cycle, so the D-Bus data and the history store reuse
+ * these readings instead of repeating the ioctls.
  */
-class TemperatureFilter
+struct FanTelemetry
 {
-public:
-  TemperatureFilter()
-    : m_value( -1.0 )
-    , m_alphaRising( 0.5 )
-    , m_alphaFalling( 0.15 )
-  {}
-
-  void addValue( int raw )
+  struct Fan
   {
-    if ( m_value < 0.0 )
-    {
-      // First sample — initialise immediately
-      m_value = static_cast< double >( raw );
-      return;
-    }
-
-    const double alpha = ( raw > m_value ) ? m_alphaRising : m_alphaFalling;
-    m_value = m_value + alpha * ( static_cast< double >( raw ) - m_value );
-  }
-
-  int getFilteredValue() const
-  {
-    return ( m_value < 0.0 ) ? 0 : static_cast< int >( std::round( m_value ) );
-  }
-
-private:
-  double m_value;
-  double m_alphaRising;   // weight for rising temperatures (fast response)
-  double m_alphaFalling;  // weight for falling temperatures (slow decay)
+    int temp = -1;   ///< °C, -1 if the sensor read failed
+    int speed = -1;  ///< Commanded duty, or the hardware duty while control is off
+  };
+
+  int64_t timestampMs = 0;  ///< Unix epoch milliseconds
+  bool available = false;   ///< Fans were detected
+  int32_t minSpeed = 0;     ///< Lowest duty the EC accepts other than off
+  bool offAvailable = false;
+  std::vector< Fan > fans;
 };
 
 /**
- * @brief Fan speed controller with interpolation, hysteresis, and EWMA smoothing
- *
- * Improvements over the original algorithm:
- *
- * 1. **Linear interpolation** — Uses FanProfile::getSpeedForTemp() instead of
- *    step-wise table lookup. Eliminates discrete jumps between curve points.
- *
- * 2. **Hysteresis** — The temperature used for curve lookup is biased:
- *    when the filtered temperature is falling and near a curve inflection
- *    point, the effective temperature is held slightly higher (by HYSTERESIS_DEG)
- *    to prevent the fan from dropping prematurely. This avoids the classic
- *    heat→fan-up→cool→fan-down→heat cycle.
- *
- * 3. **EWMA speed smoothing** — The raw curve speed is fed through an
- *    exponentially weighted moving average with asymmetric weights:
- *      - Rising (alphaUp = 0.4): fans spin up within 2-3 seconds
- *      - Falling (alphaDown = 0.08): fans spin down over ~12 seconds
- *    This replaces both the old trimmed-mean temperature filter and the
- *    hard −2%/sec rate limiter, giving much smoother transitions.
- *
- * 4. **Critical temperature override** is preserved unchanged.
+ * @brief Where the fan calibration stands, see FanControlWorker::startCalibration()
  */
-class FanControlLogic
+struct FanCalibrationStatus
+{
+  FanCalibrationRun::Phase phase = FanCalibrationRun::Phase::Idle;
+  int duty = 0;                     ///< Duty the run commands
+  std::string error;                ///< Why the last run failed
+  std::vector< FanResponse > model; ///< Response model in use, empty if none
+};
+
+class FanControlWorker : public DaemonWorker
 {
 public:
-  FanControlLogic( const FanProfile &fanProfile, FanLogicType type )
-    : m_fanProfile( fanProfile )
-    , m_type( type )
-    , m_latestSpeedPercent( 0 )
-    , m_smoothedSpeed( -1.0 )
-    , m_lastEffectiveTemp( -1 )
+  using TelemetryCallback = std::function< void( const FanTelemetry & ) >;
+
+  /**
+   * @param publishTelemetry Called at the end of every cycle with that cycle's readings
+   * @param scheduler Where the loop runs; a private one keeps it off the shared pool
+   */
+  FanControlWorker(
+    EcIoService &ec,
+    std::function< const UccProfile &() > getActiveProfile,
+    std::function< bool() > getFanControlEnabled,
+    TelemetryCallback publishTelemetry,
+    std::shared_ptr< SamplingGovernor > governor = nullptr,
+    WorkerScheduler &scheduler = WorkerScheduler::instance()
+  )
+    : DaemonWorker( NORMAL_INTERVAL, true, scheduler )
+    , m_ec( ec )
+    , m_getActiveProfile( getActiveProfile )
+    , m_getFanControlEnabled( getFanControlEnabled )
+    , m_publishTelemetry( std::move( publishTelemetry ) )
+    , m_governor( std::move( governor ) )
+    , m_modeSameSpeed( true )
+    , m_controlAvailableMessageShown( false )
     , m_fansMinSpeedHWLimit( 0 )
     , m_fansOffAvailable( true )
+    , m_hasTemporaryCurves( false )
   {
   }
 
-  void setFansMinSpeedHWLimit( int speed )
-  { m_fansMinSpeedHWLimit = std::clamp( speed, 0, 100 ); }
-
-  void setFansOffAvailable( bool available )
-  { m_fansOffAvailable = available; }
-
-  void updateFanProfile( const FanProfile &fanProfile )
-  { m_fanProfile = fanProfile; }
+  ~FanControlWorker() override = default;
 
-  void reportTemperature( int temperatureValue )
+  // Allow external callers to change same-speed mode at runtime
+  void setSameSpeed( bool same )
   {
-    m_tempFilter.addValue( temperatureValue );
-    m_latestSpeedPercent = calculateSpeedPercent();
+    m_modeSameSpeed = same;
+    syslog( LOG_INFO, "FanControlWorker: setSameSpeed = %d", m_modeSameSpeed ? 1 : 0 );
+    wake();
   }
 
-  int getSpeedPercent() const
-  { return m_latestSpeedPercent; }
-
-  const FanProfile &getFanProfile() const
-  { return m_fanProfile; }
+  [[nodiscard]] bool getSameSpeed() const noexcept { return m_modeSameSpeed; }
 
-private:
   /**
-   * @brief Apply hysteresis to prevent oscillation at curve boundaries.
-   *
-   * When temperature is falling, the effective temperature is held up to
-   * HYSTERESIS_DEG above the filtered reading.  It tracks
-   * min(lastEffective, filteredTemp + HYSTERESIS_DEG), so large drops
-   * are damped but it still converges.
-   * When temperature is rising, the effective temperature follows immediately.
+   * @brief Run the control loop every FAST_LOOP_INTERVAL instead of every second
    */
-  int applyHysteresis( int filteredTemp )
+  void setFastLoop( bool fast )
   {
-    static constexpr int HYSTERESIS_DEG = 3;
-
-    if ( m_lastEffectiveTemp < 0 )
-    {
-      // First call — no history
-      m_lastEffectiveTemp = filteredTemp;
-      return filteredTemp;
-    }
-
-    if ( filteredTemp >= m_lastEffectiveTemp )
-    {
-      // Temperature rising or stable — follow immediately
-      m_lastEffectiveTemp = filteredTemp;
-    }
-    else
-    {
-      // Temperature falling — hold the effective temp higher by up to HYSTERESIS_DEG
-      int floor = filteredTemp + HYSTERESIS_DEG;
-      int newEffective = std::min( m_lastEffectiveTemp, floor );
-      // Never go below the actual filtered temperature
-      newEffective = std::max( newEffective, filteredTemp );
-      m_lastEffectiveTemp = newEffective;
-    }
-
-    return m_lastEffectiveTemp;
+    if ( m_fastLoop.exchange( fast ) == fast )
+      return;
+    syslog( LOG_INFO, "FanControlWorker: fast loop %s", fast ? "enabled" : "disabled" );
+    wake();
   }
 
-  int applyHwFanLimitations( int speed ) const
-  {
-    const int minSpeed = m_fansMinSpeedHWLimit;
-    const int halfMinSpeed = minSpeed / 2;
+  /**
+   * @brief Write every fan duty on the next cycle, also unchanged ones
+   *
+   * The EC forgets the duties over a suspend; the deadband would otherwise
+   * hold them back until the next refresh.
+   */
+  void resendFanSpeeds() noexcept { m_resendSpeeds = true; }
 
-    if ( speed < minSpeed )
-    {
-      if ( m_fansOffAvailable && speed < halfMinSpeed )
-      {
-        return 0;
-      }
-      else if ( m_fansOffAvailable || speed >= halfMinSpeed )
-      {
-        return minSpeed;
-      }
-    }
+  /**
+   * @brief Package power in W of the CPU or GPU, < 0 if unknown
+   */
+  using PackagePowerProvider = std::function< double( FanLogicType ) >;
 
-    return speed;
-  }
+  /**
+   * @brief Set the power source of the PID feed-forward; call before start()
+   */
+  void setPackagePowerProvider( PackagePowerProvider provider ) { m_packagePower = std::move( provider ); }
 
   /**
-   * @brief EWMA smoothing on the speed output.
-   *
-   * Uses asymmetric alpha:
-   *   - alphaUp   = 0.4  → fans reach target in ~3 cycles (3 sec)
-   *   - alphaDown = 0.08 → fans take ~12 cycles to settle
+   * @brief Recent package power of the CPU or GPU, see FanPowerTrend
    *
-   * This replaces both the old trimmed-mean filter and the hard rate limiter.
+   * @p samples is the worker's scratch buffer for the power history, kept
+   * across cycles so that reading it does not allocate.
    */
-  int smoothSpeed( int targetSpeed )
-  {
-    static constexpr double ALPHA_UP   = 0.4;
-    static constexpr double ALPHA_DOWN = 0.08;
+  using PowerTrendProvider = std::function< FanPowerTrend( FanLogicType, std::vector< MetricDataPoint > &samples ) >;
 
-    if ( m_smoothedSpeed < 0.0 )
-    {
-      m_smoothedSpeed = static_cast< double >( targetSpeed );
-      return targetSpeed;
-    }
+  /**
+   * @brief Set the power history source of the curve pre-ramp; call before start()
+   *
+   * Only asked for fans whose profile enables the pre-ramp.
+   */
+  void setPowerTrendProvider( PowerTrendProvider provider ) { m_powerTrend = std::move( provider ); }
 
-    const double alpha = ( targetSpeed > m_smoothedSpeed ) ? ALPHA_UP : ALPHA_DOWN;
-    m_smoothedSpeed = m_smoothedSpeed + alpha * ( static_cast< double >( targetSpeed ) - m_smoothedSpeed );
+  /**
+   * @brief Record per-stage timing of every cycle into @p trace; call before start()
+   */
+  void setLatencyTrace( std::shared_ptr< FanLatencyTrace > trace ) { m_trace = std::move( trace ); }
 
-    return static_cast< int >( std::round( m_smoothedSpeed ) );
-  }
+  /**
+   * @brief Beat @p watchdog after every cycle that drives the fans; call before start()
+   */
+  void setWatchdog( std::shared_ptr< FanWatchdog > watchdog ) { m_watchdog = std::move( watchdog ); }
 
-  int manageCriticalTemperature( int temp, int speed ) const
-  {
-    constexpr int CRITICAL_TEMPERATURE = 85;
-    constexpr int OVERHEAT_TEMPERATURE = 90;
+  /**
+   * @brief Called with the measured responses when a calibration completes
+   */
+  using CalibrationCallback = std::function< void( const std::vector< FanResponse > & ) >;
 
-    if ( temp >= OVERHEAT_TEMPERATURE )
-    {
-      return 100;
-    }
-    else if ( temp >= CRITICAL_TEMPERATURE )
-    {
-      return std::max( speed, 80 );
-    }
+  /**
+   * @brief Set who stores a completed calibration; call before start()
+   */
+  void setCalibrationCallback( CalibrationCallback callback ) { m_calibrated = std::move( callback ); }
 
-    return speed;
+  /**
+   * @brief Use a stored response model, one entry per fan; call before start()
+   *
+   * Ignored if the fan count differs from the one detected.
+   */
+  void setResponseModel( std::vector< FanResponse > model )
+  {
+    std::lock_guard lock( m_calibrationMutex );
+    m_calibrationStatus.model = std::move( model );
   }
 
-  int calculateSpeedPercent()
+  /**
+   * @brief Measure how the fans answer duty changes, see FanCalibrationRun
+   *
+   * Opt-in and only while the daemon drives the fans: the run takes the
+   * fans over for one to three minutes, cycling every CALIBRATION_INTERVAL,
+   * and is abandoned when a sensor reaches CALIBRATION_MAX_TEMP or fan
+   * control is switched off.  The result replaces the response model at
+   * once.
+   * @return false if there are no fans to calibrate
+   */
+  bool startCalibration()
   {
-    const int filteredTemp = m_tempFilter.getFilteredValue();
-
-    // Apply hysteresis — effective temp may lag behind during cool-down
-    const int effectiveTemp = applyHysteresis( filteredTemp );
-
-    // Linear interpolation on the fan curve (instead of step-wise lookup)
-    const bool isCPU = ( m_type == FanLogicType::CPU );
-    int curveSpeed = m_fanProfile.getSpeedForTemp( effectiveTemp, isCPU );
-    if ( curveSpeed < 0 ) curveSpeed = 0;
-
-    curveSpeed = std::clamp( curveSpeed, 0, 100 );
-
-    // Apply hardware limitations
-    curveSpeed = applyHwFanLimitations( curveSpeed );
-
-    // EWMA smoothing (replaces old rate limiter)
-    int speed = smoothSpeed( curveSpeed );
-
-    // Critical temperature override (uses raw filtered temp, not hysteresis-adjusted)
-    speed = manageCriticalTemperature( filteredTemp, speed );
-
-    return speed;
+    if ( m_fanCount.load() == 0 )
+      return false;
+    m_calibrationRequest = CalibrationRequest::Start;
+    wake();
+    return true;
   }
 
-  FanProfile m_fanProfile;
-  FanLogicType m_type;
-  TemperatureFilter m_tempFilter;
-  int m_latestSpeedPercent;
-  double m_smoothedSpeed;       // EWMA state for speed output
-  int m_lastEffectiveTemp;      // hysteresis state
-
-  int m_fansMinSpeedHWLimit;
-  bool m_fansOffAvailable;
-};
-
-class FanControlWorker : public DaemonWorker
-{
-public:
-  FanControlWorker(
-    TuxedoIOAPI &io,
-    std::function< UccProfile() > getActiveProfile,
-    std::function< bool() > getFanControlEnabled,
-    std::function< void( size_t, int64_t, int ) > updateFanSpeed,
-    std::function< void( size_t, int64_t, int ) > updateFanTemp
-  )
-    : DaemonWorker( std::chrono::milliseconds( 1000 ) )
-    , m_io( io )
-    , m_getActiveProfile( getActiveProfile )
-    , m_getFanControlEnabled( getFanControlEnabled )
-    , m_updateFanSpeed( updateFanSpeed )
-    , m_updateFanTemp( updateFanTemp )
-    , m_modeSameSpeed( true )
-    , m_controlAvailableMessageShown( false )
-    , m_hasTemporaryCurves( false )
+  void cancelCalibration()
   {
+    m_calibrationRequest = CalibrationRequest::Cancel;
+    wake();
   }
 
-  ~FanControlWorker() override = default;
-
-  // Allow external callers to change same-speed mode at runtime
-  void setSameSpeed( bool same )
+  [[nodiscard]] FanCalibrationStatus calibrationStatus() const
   {
-    m_modeSameSpeed = same;
-    syslog( LOG_INFO, "FanControlWorker: setSameSpeed = %d", m_modeSameSpeed ? 1 : 0 );
+    std::lock_guard lock( m_calibrationMutex );
+    return m_calibrationStatus;
   }
 
-  [[nodiscard]] bool getSameSpeed() const noexcept { return m_modeSameSpeed; }
-
   /**
    * @brief Clear temporary fan curves and revert to profile curves
    */
   void clearTemporaryCurves()
   {
     m_hasTemporaryCurves = false;
+    ++m_curvesRevision;
     m_tempCpuTable.clear();
     m_tempGpuTable.clear();
     m_tempWaterCoolerFanTable.clear();
     m_tempPumpTable.clear();
+    wake();
   }
 
   [[nodiscard]] bool hasTemporaryCurves() const noexcept { return m_hasTemporaryCurves; }
@@ -330,6 +246,7 @@ public:
     m_tempWaterCoolerFanTable = waterCoolerFanTable;
     m_tempPumpTable = pumpTable;
     m_hasTemporaryCurves = true;
+    ++m_curvesRevision;
 
     for ( size_t i = 0; i < m_fanLogics.size(); ++i )
     {
@@ -351,19 +268,24 @@ public:
 
       m_fanLogics[i].updateFanProfile( tempProfile );
     }
+
+    // drive the fans to the new curves now, not at the next cycle
+    wake();
   }
 
 protected:
   void onStart() override
   {
     int numberFans = 0;
-    bool fansDetected = m_io.getNumberFans( numberFans ) && numberFans > 0;
+    bool fansDetected = m_ec.call( [&numberFans]( DeviceInterface &device ) {
+      return device.getNumberFans( numberFans ) && numberFans > 0;
+    } );
 
     // If getNumberFans fails, try to detect fans by reading temperature from fan 0
     if ( !fansDetected )
     {
-      int temp = -1;
-      if ( m_io.getFanTemperature( 0, temp ) && temp >= 0 )
+      EcBatch probe{ EcRequest::fanTemperature( 0 ) };
+      if ( m_ec.execute( probe ) && probe[0].value >= 0 )
       {
         // We can read from at least fan 0, assume we have CPU and GPU fans
         numberFans = 2;
@@ -377,7 +299,7 @@ protected:
       // Initialize fan logic for each fan
       for ( int i = 0; i < numberFans; ++i )
       {
-        auto profile = m_getActiveProfile();
+        const UccProfile &profile = m_getActiveProfile();
 
         // Fan 0 is CPU, others are GPU
         FanLogicType type = ( i == 0 ) ? FanLogicType::CPU : FanLogicType::GPU;
@@ -387,14 +309,16 @@ protected:
       }
 
       // Get hardware fan limits
-      int minSpeed = 0;
-      bool fansOffAvailable = true;
+      m_ec.call( [this]( DeviceInterface &device ) {
+        int minSpeed = 0;
+        bool fansOffAvailable = true;
 
-      if ( m_io.getFansMinSpeed( minSpeed ) )
-        m_fansMinSpeedHWLimit = minSpeed;
+        if ( device.getFansMinSpeed( minSpeed ) )
+          m_fansMinSpeedHWLimit = minSpeed;
 
-      if ( m_io.getFansOffAvailable( fansOffAvailable ) )
-        m_fansOffAvailable = fansOffAvailable;
+        if ( device.getFansOffAvailable( fansOffAvailable ) )
+          m_fansOffAvailable = fansOffAvailable;
+      } );
 
       // Apply hardware limits to all fan logics
       for ( auto &logic : m_fanLogics )
@@ -402,6 +326,16 @@ protected:
         logic.setFansMinSpeedHWLimit( m_fansMinSpeedHWLimit );
         logic.setFansOffAvailable( m_fansOffAvailable );
       }
+      m_writeLimiter.resize( m_fanLogics.size() );
+      m_readbackSpeeds.assign( m_fanLogics.size(), -1 );
+      m_cycle.reserve( m_fanLogics.size() );
+
+      const std::vector< FanResponse > model = calibrationStatus().model;
+      if ( model.size() == m_fanLogics.size() )
+        applyResponseModel( model );
+      else if ( !model.empty() )
+        setResponseModel( {} );
+      m_fanCount = m_fanLogics.size();
 
       syslog( LOG_INFO, "FanControlWorker started with %d fans", numberFans );
     }
@@ -409,6 +343,17 @@ protected:
     {
       syslog( LOG_INFO, "FanControlWorker: No fans detected" );
     }
+
+    m_telemetry.available = !m_fanLogics.empty();
+    m_telemetry.minSpeed = m_fansMinSpeedHWLimit;
+    m_telemetry.offAvailable = m_fansOffAvailable;
+    m_telemetry.fans.assign( m_fanLogics.size(), FanTelemetry::Fan{} );
+    if ( m_fanLogics.empty() && m_publishTelemetry )
+    {
+      m_telemetry.timestampMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+        std::chrono::system_clock::now().time_since_epoch() ).count();
+      m_publishTelemetry( m_telemetry );
+    }
   }
 
   void onWork() override
@@ -429,26 +374,50 @@ protected:
       m_controlAvailableMessageShown = false;
     }
 
-    // Get current profile and update fan logics if profile changed
-    auto profile = m_getActiveProfile();
-    if ( !profile.id.empty() )
+    FanLatencyTrace *const trace = m_trace.get();
+    const FanLatencyTrace::Span cycleSpan( trace, FanTraceStage::Cycle );
+
+    // Update fan logics if the profile's fan settings or the temporary curves changed
+    const UccProfile &profile = m_getActiveProfile();
+    const uint64_t curvesRevision = m_curvesRevision.load();
+    if ( !profile.id.empty()
+         && ( m_appliedFan.differs( profile.fan, curvesRevision ) || profile.fan.sameSpeed != m_modeSameSpeed ) )
     {
       updateFanLogicsFromProfile( profile );
+      m_appliedFan.assign( profile.fan, curvesRevision );
     }
 
     const bool useFanControl = m_getFanControlEnabled();
     const int64_t timestamp = std::chrono::duration_cast< std::chrono::milliseconds >(
       std::chrono::system_clock::now().time_since_epoch() ).count();
 
-    std::vector< int > fanTemps;
-    std::vector< int > fanSpeedsSet;
-    std::vector< bool > tempSensorAvailable;
+    // Smoothing is tuned per second; scale it to the actual cycle length
+    const int64_t cycleMs = SamplingGovernor::nowMs();
+    const double dtSeconds = m_lastCycleMs > 0 ? static_cast< double >( cycleMs - m_lastCycleMs ) / 1000.0 : 1.0;
+    m_lastCycleMs = cycleMs;
+    if ( m_resendSpeeds.exchange( false ) )
+      m_writeLimiter.invalidate();
+
+    // Per-cycle buffers keep their capacity from one cycle to the next
+    m_cycle.clear();
+    auto &fanTemps = m_cycle.fanTemps;
+    auto &fanSpeedsSet = m_cycle.fanSpeedsSet;
+    auto &tempSensorAvailable = m_cycle.tempSensorAvailable;
+
+    // Read all temperatures in one EC batch, then calculate fan speeds
+    const auto readBegin = trace ? FanLatencyTrace::Clock::now() : FanLatencyTrace::Clock::time_point{};
+    EcBatch &temps = m_cycle.temps;
+    for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
+      temps.push_back( EcRequest::fanTemperature( static_cast< int >( fanIndex ) ) );
+    {
+      const FanLatencyTrace::Span span( trace, FanTraceStage::SensorRead );
+      m_ec.execute( temps );
+    }
 
-    // Read temperatures and calculate fan speeds
     for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
     {
-      int tempCelsius = -1;
-      bool tempReadSuccess = m_io.getFanTemperature( static_cast< int >( fanIndex ), tempCelsius );
+      const int tempCelsius = temps[fanIndex].value;
+      const bool tempReadSuccess = temps[fanIndex].ok;
 
       tempSensorAvailable.push_back( tempReadSuccess );
 
@@ -457,7 +426,18 @@ protected:
         fanTemps.push_back( tempCelsius );
 
         // Report temperature to logic and get calculated speed
-        m_fanLogics[fanIndex].reportTemperature( tempCelsius );
+        const FanLogicType type = ( fanIndex == 0 ) ? FanLogicType::CPU : FanLogicType::GPU;
+        const double watts = m_packagePower ? m_packagePower( type ) : -1.0;
+        const FanPowerTrend powerTrend = m_powerTrend && m_fanLogics[fanIndex].wantsPowerTrend()
+                                           ? m_powerTrend( type, m_cycle.powerSamples ) : FanPowerTrend{};
+        {
+          const FanLatencyTrace::Span span( trace, FanTraceStage::Filter );
+          m_fanLogics[fanIndex].addTemperature( tempCelsius, dtSeconds );
+        }
+        {
+          const FanLatencyTrace::Span span( trace, FanTraceStage::Control );
+          m_fanLogics[fanIndex].updateSpeed( dtSeconds, watts, powerTrend );
+        }
         int calculatedSpeed = m_fanLogics[fanIndex].getSpeedPercent();
         fanSpeedsSet.push_back( calculatedSpeed );
       }
@@ -468,8 +448,11 @@ protected:
       }
     }
 
+    // A calibration run drives the fans itself while it lasts
+    const bool calibrating = runCalibration( useFanControl, fanTemps, cycleMs, fanSpeedsSet );
+
     // Write fan speeds if fan control is enabled
-    if ( useFanControl )
+    if ( useFanControl && !calibrating )
     {
       // Find highest speed for "same speed" mode
       int highestSpeed = 0;
@@ -479,7 +462,8 @@ protected:
           highestSpeed = speed;
       }
 
-      // Set fan speeds
+      // Set fan speeds, all changed duties in one EC batch
+      EcBatch &writes = m_cycle.writes;
       for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
       {
         int speedToSet = fanSpeedsSet[fanIndex];
@@ -495,11 +479,48 @@ protected:
         //syslog( LOG_DEBUG, "FanControlWorker: fan %d temp=%d calculated=%d set=%d sameSpeed=%d",
         //        static_cast< int >( fanIndex ), fanTemps[fanIndex], fanSpeedsSet[fanIndex], speedToSet, m_modeSameSpeed ? 1 : 0 );
 
-        m_io.setFanSpeedPercent( static_cast< int >( fanIndex ), speedToSet );
+        // Skip the ioctl while the duty stays within the deadband and
+        // report what the fan is actually running at
+        if ( m_writeLimiter.shouldWrite( fanIndex, speedToSet, cycleMs ) )
+          writes.push_back( EcRequest::setFanSpeed( static_cast< int >( fanIndex ), speedToSet ) );
+        else
+          fanSpeedsSet[fanIndex] = m_writeLimiter.sent( fanIndex );
+      }
+
+      if ( !writes.empty() )
+      {
+        {
+          const FanLatencyTrace::Span span( trace, FanTraceStage::EcWrite );
+          m_ec.execute( writes );
+        }
+        if ( trace )
+          trace->record( FanTraceStage::ReadToWrite, readBegin );
+        for ( const EcRequest &write : writes )
+          if ( write.ok )
+            m_writeLimiter.written( static_cast< size_t >( write.index ), write.value, cycleMs );
+      }
+    }
+    else if ( !useFanControl )
+    {
+      // Whatever drives the fans meanwhile, re-send every duty on resume
+      m_writeLimiter.invalidate();
+
+      // Hardware speeds are only reported, so read them all in one pass
+      // and only every READBACK_INTERVAL_MS
+      if ( cycleMs - m_lastReadbackMs >= READBACK_INTERVAL_MS )
+      {
+        m_lastReadbackMs = cycleMs;
+        EcBatch &readback = m_cycle.readback;
+        for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
+          readback.push_back( EcRequest::fanSpeed( static_cast< int >( fanIndex ) ) );
+        m_ec.execute( readback );
+        for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
+          m_readbackSpeeds[fanIndex] = readback[fanIndex].ok ? readback[fanIndex].value : -1;
       }
     }
 
-    // Publish data via callbacks
+    // Publish this cycle's readings in one snapshot
+    m_telemetry.timestampMs = timestamp;
     for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
     {
       int currentSpeed;
@@ -516,13 +537,37 @@ protected:
       else
       {
         // Report hardware speed when control is disabled
-        int hwSpeed = -1;
-        m_io.getFanSpeedPercent( static_cast< int >( fanIndex ), hwSpeed );
-        currentSpeed = hwSpeed;
+        currentSpeed = m_readbackSpeeds[fanIndex];
       }
 
-      m_updateFanTemp( fanIndex, timestamp, fanTemps[fanIndex] );
-      m_updateFanSpeed( fanIndex, timestamp, currentSpeed );
+      m_telemetry.fans[fanIndex] = FanTelemetry::Fan{ fanTemps[fanIndex], currentSpeed };
+    }
+    if ( m_publishTelemetry )
+      m_publishTelemetry( m_telemetry );
+
+    if ( calibrating )
+    {
+      setTimeout( CALIBRATION_INTERVAL );
+    }
+    else if ( m_governor )
+    {
+      const int hottest = *std::max_element( fanTemps.begin(), fanTemps.end() );
+      if ( hottest >= 0 )
+        m_governor->reportTemperature( static_cast< double >( hottest ), cycleMs );
+      setTimeout( m_governor->interval( controlInterval( useFanControl ) ) );
+    }
+    else
+    {
+      setTimeout( controlInterval( useFanControl ) );
+    }
+
+    // a cycle that drove the fans vouches for the next one
+    if ( m_watchdog )
+    {
+      if ( useFanControl )
+        m_watchdog->beat( cycleMs, getTimeout().count() );
+      else
+        m_watchdog->disarm();
     }
   }
 
@@ -532,6 +577,119 @@ protected:
   }
 
 private:
+  static constexpr std::chrono::milliseconds NORMAL_INTERVAL{ 1000 };
+  static constexpr std::chrono::milliseconds FAST_LOOP_INTERVAL{ 500 };
+  static constexpr int64_t READBACK_INTERVAL_MS = 2000;
+  static constexpr std::chrono::milliseconds CALIBRATION_INTERVAL{ 250 };
+  static constexpr int CALIBRATION_MAX_TEMP = 80;
+
+  enum class CalibrationRequest : uint8_t { None, Start, Cancel };
+
+  void applyResponseModel( const std::vector< FanResponse > &model )
+  {
+    for ( size_t i = 0; i < m_fanLogics.size() && i < model.size(); ++i )
+      m_fanLogics[i].setResponseModel( model[i] );
+  }
+
+  void publishCalibration()
+  {
+    m_publishedPhase = m_calibration.phase();
+    std::lock_guard lock( m_calibrationMutex );
+    m_calibrationStatus.phase = m_calibration.phase();
+    m_calibrationStatus.duty = m_calibration.duty();
+    m_calibrationStatus.error = m_calibration.error();
+  }
+
+  /**
+   * @brief Advance a calibration run by one cycle
+   * @return true if the run commanded the fans this cycle; @p fanSpeedsSet
+   *         then holds its duty
+   */
+  bool runCalibration( bool useFanControl, const std::vector< int > &fanTemps, int64_t cycleMs,
+                       std::vector< int > &fanSpeedsSet )
+  {
+    const CalibrationRequest request = m_calibrationRequest.exchange( CalibrationRequest::None );
+    if ( request == CalibrationRequest::Start && !m_calibration.running() )
+    {
+      if ( useFanControl )
+      {
+        m_calibration.start( m_fanLogics.size(), m_fansOffAvailable ? 0 : m_fansMinSpeedHWLimit, cycleMs );
+        syslog( LOG_INFO, "FanControlWorker: fan calibration started" );
+      }
+      else
+        m_calibration.fail( "fan control is disabled" );
+    }
+    else if ( request == CalibrationRequest::Cancel && m_calibration.running() )
+      m_calibration.fail( "cancelled" );
+
+    if ( m_calibration.running() )
+    {
+      const int hottest = *std::max_element( fanTemps.begin(), fanTemps.end() );
+      if ( !useFanControl )
+        m_calibration.fail( "fan control was disabled" );
+      else if ( hottest >= CALIBRATION_MAX_TEMP )
+        m_calibration.fail( "temperature reached " + std::to_string( hottest ) + " °C" );
+    }
+
+    if ( !m_calibration.running() )
+    {
+      if ( request != CalibrationRequest::None || m_calibration.phase() != m_publishedPhase )
+      {
+        if ( m_calibration.phase() == FanCalibrationRun::Phase::Failed )
+          syslog( LOG_WARNING, "FanControlWorker: fan calibration failed: %s", m_calibration.error().c_str() );
+        m_writeLimiter.invalidate();
+        publishCalibration();
+      }
+      return false;
+    }
+
+    EcBatch &readback = m_cycle.readback;
+    for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
+      readback.push_back( EcRequest::fanSpeed( static_cast< int >( fanIndex ) ) );
+    m_ec.execute( readback );
+    std::vector< int > &speeds = m_cycle.speeds;
+    speeds.assign( m_fanLogics.size(), -1 );
+    for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
+      if ( readback[fanIndex].ok )
+        speeds[fanIndex] = readback[fanIndex].value;
+
+    const int duty = m_calibration.update( cycleMs, speeds );
+    EcBatch &writes = m_cycle.writes;
+    for ( size_t fanIndex = 0; fanIndex < m_fanLogics.size(); ++fanIndex )
+    {
+      fanSpeedsSet[fanIndex] = duty;
+      if ( m_writeLimiter.sent( fanIndex ) != duty )
+        writes.push_back( EcRequest::setFanSpeed( static_cast< int >( fanIndex ), duty ) );
+    }
+    m_ec.execute( writes );
+    for ( const EcRequest &write : writes )
+      if ( write.ok )
+        m_writeLimiter.written( static_cast< size_t >( write.index ), write.value, cycleMs );
+
+    if ( m_calibration.phase() == FanCalibrationRun::Phase::Done )
+    {
+      const std::vector< FanResponse > model = m_calibration.result();
+      applyResponseModel( model );
+      {
+        std::lock_guard lock( m_calibrationMutex );
+        m_calibrationStatus.model = model;
+      }
+      syslog( LOG_INFO, "FanControlWorker: fan calibration done" );
+      if ( m_calibrated )
+        m_calibrated( model );
+      // regular control takes over from the low duty on the next cycle
+      m_writeLimiter.invalidate();
+    }
+    publishCalibration();
+    return true;
+  }
+
+  /// Regular period; the fast loop only pays off while the daemon drives the fans
+  [[nodiscard]] std::chrono::milliseconds controlInterval( bool useFanControl ) const noexcept
+  {
+    return useFanControl && m_fastLoop.load( std::memory_order_relaxed ) ? FAST_LOOP_INTERVAL : NORMAL_INTERVAL;
+  }
+
   void updateFanLogicsFromProfile( const UccProfile &profile )
   {
     // Respect profile setting for same-speed mode
@@ -574,15 +732,36 @@ private:
           fanProfile.tablePump = m_tempPumpTable;
       }
 
+      fanProfile.controller = profile.fan.controller;
       m_fanLogics[i].updateFanProfile( fanProfile );
     }
   }
 
-  TuxedoIOAPI &m_io;
-  std::function< UccProfile() > m_getActiveProfile;
+  EcIoService &m_ec;
+  std::function< const UccProfile &() > m_getActiveProfile;
   std::function< bool() > m_getFanControlEnabled;
-  std::function< void( size_t, int64_t, int ) > m_updateFanSpeed;
-  std::function< void( size_t, int64_t, int ) > m_updateFanTemp;
+  TelemetryCallback m_publishTelemetry;
+  FanTelemetry m_telemetry;
+  std::shared_ptr< SamplingGovernor > m_governor;
+  PackagePowerProvider m_packagePower;
+  PowerTrendProvider m_powerTrend;
+  std::shared_ptr< FanLatencyTrace > m_trace;
+  std::shared_ptr< FanWatchdog > m_watchdog;
+  std::atomic< bool > m_fastLoop{ false };
+  std::atomic< bool > m_resendSpeeds{ false };
+  int64_t m_lastCycleMs = 0;
+  int64_t m_lastReadbackMs = 0;
+
+  FanCalibrationRun m_calibration;
+  CalibrationCallback m_calibrated;
+  FanCalibrationRun::Phase m_publishedPhase = FanCalibrationRun::Phase::Idle;
+  std::atomic< CalibrationRequest > m_calibrationRequest{ CalibrationRequest::None };
+  std::atomic< size_t > m_fanCount{ 0 };
+  mutable std::mutex m_calibrationMutex;
+  FanCalibrationStatus m_calibrationStatus;
+
+  FanWriteLimiter m_writeLimiter;
+  std::vector< int > m_readbackSpeeds;  // hardware duty per fan while control is off
 
   std::vector< FanControlLogic > m_fanLogics;
   bool m_modeSameSpeed;
@@ -590,8 +769,67 @@ private:
   int m_fansMinSpeedHWLimit;
   bool m_fansOffAvailable;
 
+  /// Buffers of one control cycle, members so a steady cycle does not allocate
+  struct CycleBuffers
+  {
+    std::vector< int > fanTemps;
+    std::vector< int > fanSpeedsSet;
+    std::vector< bool > tempSensorAvailable;
+    std::vector< int > speeds;
+    std::vector< MetricDataPoint > powerSamples;
+    EcBatch temps;
+    EcBatch writes;
+    EcBatch readback;
+
+    void reserve( size_t fans )
+    {
+      fanTemps.reserve( fans );
+      fanSpeedsSet.reserve( fans );
+      tempSensorAvailable.reserve( fans );
+      speeds.reserve( fans );
+      temps.reserve( fans );
+      writes.reserve( fans );
+      readback.reserve( fans );
+    }
+
+    void clear() noexcept
+    {
+      fanTemps.clear();
+      fanSpeedsSet.clear();
+      tempSensorAvailable.clear();
+      temps.clear();
+      writes.clear();
+      readback.clear();
+    }
+  };
+  CycleBuffers m_cycle;
+
+  /// Profile fan settings the logics were last built from
+  struct AppliedFanSettings
+  {
+    bool valid = false;
+    std::string fanProfile;
+    FanControllerSettings controller;
+    uint64_t curvesRevision = 0;
+
+    [[nodiscard]] bool differs( const UccProfileFanControl &fan, uint64_t revision ) const noexcept
+    {
+      return !valid || fan.fanProfile != fanProfile || fan.controller != controller || revision != curvesRevision;
+    }
+
+    void assign( const UccProfileFanControl &fan, uint64_t revision )
+    {
+      valid = true;
+      fanProfile = fan.fanProfile;
+      controller = fan.controller;
+      curvesRevision = revision;
+    }
+  };
+  AppliedFanSettings m_appliedFan;
+
   // Temporary fan curve tracking
   bool m_hasTemporaryCurves;
+  std::atomic< uint64_t > m_curvesRevision{ 0 };  ///< Bumped whenever the temporary curves change
   std::vector< FanTableEntry > m_tempCpuTable;
   std::vector< FanTableEntry > m_tempGpuTable;
   std::vector< FanTableEntry > m_tempWaterCoolerFanTable;
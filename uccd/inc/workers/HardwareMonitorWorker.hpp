@@ -17,11 +17,24 @@
 
 #include "DaemonWorker.hpp"
 #include "../NvmlWrapper.hpp"
+#include "../SensorPoller.hpp"
+#include "../SamplingGovernor.hpp"
+#include "../RaplDomains.hpp"
+#include "../CpuCoreSampler.hpp"
+#include "../CpuThrottleSampler.hpp"
+#include "../BatterySampler.hpp"
+#include "../GpuTopology.hpp"
+#include "../AmdGpuMetrics.hpp"
+#include "../UdevMonitor.hpp"
+#include "../GpuInfo.hpp"
+#include "SensorGroups.hpp"
+#include <array>
 #include <climits>
 #include <string>
 #include <optional>
 #include <memory>
 #include <functional>
+#include <vector>
 #include <set>
 #include <fstream>
 #include <filesystem>
@@ -39,47 +52,18 @@ struct GpuDeviceCounts
 };
 
 /**
- * @brief Data structure for discrete GPU information
- */
-struct DGpuInfo
-{
-  double m_temp = -1.0;
-  double m_coreFrequency = -1.0;
-  double m_vramFrequency = -1.0;
-  double m_maxCoreFrequency = -1.0;
-  double m_powerDraw = -1.0;
-  double m_maxPowerLimit = -1.0;
-  double m_enforcedPowerLimit = -1.0;
-  bool m_d0MetricsUsage = false;
-
-  // Extended metrics (NVIDIA only, -1 / INT_MIN when unavailable)
-  int m_computeUtilPct = -1;     ///< GPU compute utilization in % (0–100), or -1
-  int m_memoryUtilPct  = -1;     ///< GPU memory-controller utilization in % (0–100), or -1
-  int m_vramUsedMiB    = -1;     ///< Used VRAM in MiB, or -1
-  int m_vramTotalMiB   = -1;     ///< Total VRAM in MiB, or -1
-  std::string m_perfLimitReason; ///< Current perf-cap/throttle reason, empty when unavailable
-  int m_encoderUtilPct = -1;     ///< NVENC utilization in %, or -1
-  int m_decoderUtilPct = -1;     ///< NVDEC utilization in %, or -1
-  int m_currentPstate  = -1;     ///< Current P-state index (0–15), or -1 if unknown
-  int m_grClockOffsetMHz  = INT_MIN; ///< Graphics-clock offset at current P-state, INT_MIN = unavailable
-  int m_memClockOffsetMHz = INT_MIN; ///< Memory-clock offset at current P-state, INT_MIN = unavailable
-  int m_coreVoltageMv = -1;      ///< Core voltage in mV, or -1
-
-  void print() const noexcept;
-};
-
-/**
- * @brief Data structure for integrated GPU information
+ * @brief Points drained from the NVML sample buffers of the primary dGPU
+ *
+ * Values are converted to the units of DGpuInfo (W, %, MHz) and keep the
+ * driver's own timestamps.
  */
-struct IGpuInfo
+struct GpuSampleBatch
 {
-  double m_temp = -1.0;
-  double m_coreFrequency = -1.0;
-  double m_maxCoreFrequency = -1.0;
-  double m_powerDraw = -1.0;
-  std::string m_vendor = "unknown";
-
-  void print() const noexcept;
+  std::vector< NvmlSample > powerW;
+  std::vector< NvmlSample > computeUtilPct;
+  std::vector< NvmlSample > memoryUtilPct;
+  std::vector< NvmlSample > coreClockMHz;
+  std::vector< NvmlSample > memClockMHz;
 };
 
 // Forward declarations for internal implementation classes
@@ -104,8 +88,11 @@ public:
     return counts;
   }
 
-  /// Expose the Intel iGPU PCI ID regex pattern for DRM path discovery.
-  [[nodiscard]] std::string getIntelIGpuPatternPublic() const noexcept { return getIntelIGpuPattern(); }
+  /// PCI ID patterns for the hwmon/DRM path discovery
+  [[nodiscard]] GpuTopologyScanner::Patterns topologyPatterns() const
+  {
+    return { getIntelIGpuPattern(), getAmdIGpuPattern(), getAmdDGpuPattern() };
+  }
 
 private:
   [[nodiscard]] std::string getIntelIGpuPattern() const noexcept
@@ -165,7 +152,7 @@ private:
       const std::regex idRegex( "PCI_ID=" + pattern );
       int count = 0;
 
-      for ( const auto &entry : fs::directory_iterator( "/sys/bus/pci/devices" ) )
+      for ( const auto &entry : fs::directory_iterator( ucc::sysfsPath( "/sys/bus/pci/devices" ) ) )
       {
         auto ueventPath = entry.path() / "uevent";
         std::ifstream ueventFile( ueventPath );
@@ -201,7 +188,7 @@ private:
       const std::string nvidiaVendorId = "0x10de";
       std::set< std::string > uniqueDevices;
 
-      for ( const auto &entry : fs::directory_iterator( "/sys/bus/pci/devices" ) )
+      for ( const auto &entry : fs::directory_iterator( ucc::sysfsPath( "/sys/bus/pci/devices" ) ) )
       {
         auto vendorPath = entry.path() / "vendor";
         std::ifstream vendorFile( vendorPath );
@@ -240,48 +227,73 @@ private:
  *
  * GPU monitoring (every cycle, 800ms):
  *   - Intel iGPU via RAPL energy counters and DRM frequency
- *   - AMD iGPU via hwmon sysfs interface
- *   - AMD dGPU via hwmon sysfs interface
+ *   - AMD iGPU/dGPU via the gpu_metrics table, or hwmon without one
  *   - NVIDIA dGPU via nvidia-smi command
+ *   The sysfs paths are scanned once at start and rescanned only when the
+ *   udev monitor reports a drm/hwmon/pci event.
  *
  * CPU power monitoring (every 3rd cycle ≈ 2400ms):
- *   - Intel RAPL power data for CPU package
+ *   - RAPL energy counters per domain (package, core, uncore, dram, psys)
+ *     via powercap, or amd_energy hwmon
  *   - Power constraints (PL1/PL2/PL4)
  *
  * Prime state monitoring (every 12th cycle ≈ 9600ms):
  *   - NVIDIA Prime GPU switching status
  *   - Requires prime-select utility (Ubuntu/TUXEDO OS)
+ *   - Also re-checked right after a GPU hotplug
  */
 class HardwareMonitorWorker : public DaemonWorker
 {
 public:
   /**
    * @brief Callback function type for GPU data updates
+   *
+   * The dGPU list holds one entry per NVIDIA device (NVML index order), or a
+   * single AMD / placeholder entry; it is never empty and entry 0 is the
+   * primary dGPU.  The sample batch is non-null on cycles that drained the
+   * NVML sample buffers; its points supersede the instantaneous power,
+   * utilization and clock values of entry 0.
    */
-  using GpuDataCallback = std::function< void( const IGpuInfo &, const DGpuInfo & ) >;
+  using GpuDataCallback =
+    std::function< void( const IGpuInfo &, const std::vector< DGpuInfo > &, const GpuSampleBatch * ) >;
 
   /**
    * @brief Callback function type for CPU power data updates
    * @param json JSON string with power data
-   * @param cpuPowerWatts Current CPU power draw in watts (or -1.0 if unavailable)
+   * @param domainWatts Power per RAPL domain in watts (-1.0 where unavailable);
+   *                    RaplDomain::Package is the CPU power draw
+   */
+  using CpuPowerCallback = std::function< void( const std::string &json, const RaplDomainWatts &domainWatts ) >;
+
+  /**
+   * @brief Callback function type for per-core CPU frequency / busy updates
    */
-  using CpuPowerCallback = std::function< void( const std::string &json, double cpuPowerWatts ) >;
+  using CpuFrequencyCallback = std::function< void( const CpuCoreMetrics &cores ) >;
 
   /**
-   * @brief Callback function type for CPU frequency updates (MHz)
+   * @brief Callback function type for thermal / power-limit throttling updates
    */
-  using CpuFrequencyCallback = std::function< void( int frequencyMHz ) >;
+  using CpuThrottleCallback = std::function< void( const CpuThrottleMetrics &throttle ) >;
+
+  /**
+   * @brief Callback function type for battery charge / discharge updates
+   */
+  using BatteryCallback = std::function< void( const BatteryMetrics &battery ) >;
 
   /**
    * @brief Constructor
+   * @param sensorPoller Shared batch reader; refreshed at the start of every cycle
+   * @param governor Adaptive cycle length (nullptr keeps the fixed 800 ms)
    * @param cpuPowerUpdateCallback Called with CPU power JSON + raw watts when updated
-   * @param getSensorDataCollectionStatus Returns whether sensor data collection is enabled
+   * @param getSensorGroups Returns the ucc::SensorGroup bits some client needs; other groups are not read
    * @param setPrimeStateCallback Called with prime state string when updated
    */
   explicit HardwareMonitorWorker(
     std::shared_ptr< NvmlWrapper > nvml,
+    std::shared_ptr< SensorPoller > sensorPoller,
+    std::shared_ptr< SamplingGovernor > governor,
     CpuPowerCallback cpuPowerUpdateCallback,
-    std::function< bool() > getSensorDataCollectionStatus,
+    std::function< uint32_t() > getSensorGroups,
     std::function< void( const std::string & ) > setPrimeStateCallback,
     bool isDisplayMuxDevice = false );
 
@@ -325,13 +337,33 @@ public:
   /**
    * @brief Set callback for CPU frequency updates
    *
-   * Called every cycle (~800ms) with the current CPU frequency in MHz.
-   * Must be called before start().
+   * Called every cycle (~800ms) with the frequency and busy time of every
+   * online core and their aggregates.  Must be called before start().
    *
-   * @param callback Function called with frequency in MHz (or -1 if unavailable)
+   * @param callback Function called with the per-core sample
    */
   void setCpuFrequencyCallback( CpuFrequencyCallback callback ) noexcept;
 
+  /**
+   * @brief Set callback for throttling and package C-state residency
+   *
+   * Called with every CPU power update while sensor data collection is
+   * enabled.  Must be called before start().
+   *
+   * @param callback Function called with the interval's throttle counters
+   */
+  void setCpuThrottleCallback( CpuThrottleCallback callback ) noexcept;
+
+  /**
+   * @brief Set callback for battery power, energy and capacity
+   *
+   * Called every cycle on systems with a battery.  Must be called before
+   * start().
+   *
+   * @param callback Function called with the battery sample
+   */
+  void setBatteryCallback( BatteryCallback callback ) noexcept;
+
   /**
    * @brief Check if NVIDIA Prime is supported on this system
    * @return true if Prime is supported
@@ -349,27 +381,61 @@ private:
   GpuDeviceCounts m_deviceCounts;
   std::shared_ptr< NvmlWrapper > m_nvml; ///< NVML API wrapper (shared, no-op if libnvidia-ml not present)
   GpuDataCallback m_gpuDataCallback;
-  std::optional< std::string > m_amdIGpuHwmonPath;
-  std::optional< std::string > m_amdDGpuHwmonPath;
-  std::optional< std::string > m_intelIGpuDrmPath;
-  int m_hwmonIGpuRetryCount;
-  int m_hwmonDGpuRetryCount;
+  std::vector< DGpuInfo > m_dGpuValues;            ///< Reused across cycles
+  std::vector< std::string > m_nvidiaNames;        ///< Cached per NVML index
+  GpuSampleBatch m_gpuSamples;                     ///< Reused across cycles
+  std::array< unsigned long long, 5 > m_gpuSampleCursors{};  ///< lastSeen µs per GpuSampleBatch series
+
+  // --- Device topology: scanned once, rescanned only on udev hotplug events ---
+  GpuTopologyScanner m_topologyScanner;
+  GpuTopology m_topology;
+  UdevMonitor m_udevMonitor;
+
+  // --- Batched sysfs reads (GPU hwmon/DRM nodes, per-core cpufreq) ---
+  std::shared_ptr< SensorPoller > m_sensorPoller;
+
+  /// SensorPoller handles of the nodes read every cycle
+  struct PolledNodes
+  {
+    SensorPoller::Handle intelCurFreq = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle intelMaxFreq = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle amdITemp = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle amdIFreq = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle amdIMetrics = SensorPoller::INVALID_HANDLE;  ///< gpu_metrics; replaces the hwmon nodes
+    SensorPoller::Handle amdIPower = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle amdDTemp = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle amdDFreq = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle amdDPower = SensorPoller::INVALID_HANDLE;
+    SensorPoller::Handle amdDMetrics = SensorPoller::INVALID_HANDLE;
+  } m_polled;
+  double m_amdIGpuMaxClockMHz;  ///< Top pp_dpm_sclk level, read once per topology change
 
   // GPU RAPL for Intel iGPU power
   std::unique_ptr< IntelRAPLController > m_intelRAPLGpu;
   std::unique_ptr< PowerController > m_intelGpuPowerController;
 
   // --- CPU power state ---
-  std::unique_ptr< IntelRAPLController > m_intelRAPLCpu;
-  std::unique_ptr< PowerController > m_cpuPowerController;
+  std::unique_ptr< IntelRAPLController > m_intelRAPLCpu;  ///< Package zone, for the power limits
+  RaplDomainSampler m_raplDomains;
   bool m_RAPLConstraint0Status;
   bool m_RAPLConstraint1Status;
   bool m_RAPLConstraint2Status;
   CpuPowerCallback m_cpuPowerUpdateCallback;
-  std::function< bool() > m_getSensorDataCollectionStatus;
+  std::string m_cpuPowerJSON;  ///< Reused serialisation buffer
+  std::function< uint32_t() > m_getSensorGroups;
+  uint32_t m_sensorGroups = 0;  ///< m_getSensorGroups() at the start of the current cycle
 
-  // --- CPU frequency callback ---
+  // --- CPU frequency / busy time per core ---
   CpuFrequencyCallback m_cpuFrequencyCallback;
+  std::unique_ptr< CpuCoreSampler > m_cpuCores;
+
+  // --- Thermal / power-limit throttling ---
+  CpuThrottleCallback m_cpuThrottleCallback;
+  CpuThrottleSampler m_cpuThrottle;
+
+  // --- Battery charge / discharge ---
+  BatteryCallback m_batteryCallback;
+  std::unique_ptr< BatterySampler > m_battery;
 
   // --- Prime state ---
   std::function< void( const std::string & ) > m_setPrimeState;
@@ -381,28 +447,36 @@ private:
   WebcamHwReader m_webcamHwReader;
   WebcamStatusCallback m_webcamStatusCallback;
 
-  // --- Cycle counters for staggered polling ---
-  uint32_t m_cycleCounter;
+  // --- Staggered polling: slower readings run on their own wall-clock period ---
+  static constexpr std::chrono::milliseconds NORMAL_INTERVAL{ 800 };
+  static constexpr int64_t CPU_POWER_PERIOD_MS = 2400;
+  static constexpr int64_t WEBCAM_PERIOD_MS = 2400;
+  static constexpr int64_t PRIME_PERIOD_MS = 9600;
+  /// requires_offloading is only settled a while after boot; the first
+  /// PRIME read waits this long instead of blocking onStart()
+  static constexpr int64_t PRIME_SETTLE_MS = 2000;
+
+  std::shared_ptr< SamplingGovernor > m_governor;
+  int64_t m_lastCpuPowerMs;
+  int64_t m_lastWebcamMs;
+  int64_t m_lastPrimeMs;
 
   // GPU methods
   void initGpu();
-  [[nodiscard]] bool checkAmdIGpuHwmonPath() noexcept;
-  [[nodiscard]] bool checkAmdDGpuHwmonPath() noexcept;
-  [[nodiscard]] std::string getAmdIGpuHwmonPathImpl() const noexcept;
-  [[nodiscard]] std::string getAmdDGpuHwmonPathImpl() const noexcept;
-  [[nodiscard]] std::string getIntelIGpuDrmPathImpl() const noexcept;
+  void refreshGpuTopology() noexcept;
+  bool applyGpuTopology( const GpuTopology &topology ) noexcept;
   [[nodiscard]] IGpuInfo getIGpuValues() noexcept;
   [[nodiscard]] IGpuInfo getIntelIGpuValues( const IGpuInfo &base ) const noexcept;
   [[nodiscard]] IGpuInfo getAmdIGpuValues( const IGpuInfo &base ) const noexcept;
-  [[nodiscard]] DGpuInfo getDGpuValues() noexcept;
-  [[nodiscard]] DGpuInfo getNvidiaDGpuValues() const noexcept;
+  [[nodiscard]] const std::vector< DGpuInfo > &getDGpuValues() noexcept;
+  void getNvidiaDGpuValues( unsigned int deviceIndex, DGpuInfo &values ) const noexcept;
+  [[nodiscard]] const GpuSampleBatch *drainGpuSamples() noexcept;
   [[nodiscard]] DGpuInfo getAmdDGpuValues( const DGpuInfo &base ) const noexcept;
-  [[nodiscard]] double parseMaxAmdFreq( const std::string &frequencyString ) const noexcept;
+  [[nodiscard]] std::optional< AmdGpuMetrics > readAmdGpuMetrics( SensorPoller::Handle handle ) const;
 
   // CPU power methods
   void initCpuPower();
   void updateCpuPower();
-  [[nodiscard]] double getCpuCurrentPower();
   [[nodiscard]] double getCpuMaxPowerLimit();
 
   // Prime methods
@@ -411,11 +485,13 @@ private:
   [[nodiscard]] bool checkPrimeSupported() const noexcept;
   [[nodiscard]] std::string checkPrimeStatus() const noexcept;
   [[nodiscard]] std::string transformPrimeStatus( const std::string &status ) const noexcept;
-  [[nodiscard]] bool getDisplayConnectedToNvidia() const noexcept;
 
   // Webcam methods
   void updateWebcamStatus() noexcept;
 
   // CPU frequency methods
   void updateCpuFrequency() noexcept;
+
+  // Battery methods
+  void updateBattery() noexcept;
 };
@@ -0,0 +1,184 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "DaemonWorker.hpp"
+#include "KeyboardBacklightController.hpp"
+#include "KeyboardEffects.hpp"
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <unistd.h>
+
+/**
+ * @brief Counts key presses of the built-in keyboard for reactive effects.
+ *
+ * Reads the evdev node without blocking and without a grab, so the
+ * presses still reach the session; only the fact that a key went down is
+ * kept, never which one.
+ */
+class KeyActivityMonitor
+{
+public:
+  static constexpr const char *INPUT_BY_PATH = "/dev/input/by-path";
+
+  KeyActivityMonitor() = default;
+  ~KeyActivityMonitor() { close(); }
+
+  KeyActivityMonitor( const KeyActivityMonitor & ) = delete;
+  KeyActivityMonitor &operator=( const KeyActivityMonitor & ) = delete;
+
+  /// The i8042 keyboard if there is one, else the first keyboard in @p byPath
+  [[nodiscard]] static std::string findKeyboard( const std::string &byPath = INPUT_BY_PATH )
+  {
+    std::error_code ec;
+    std::string first;
+    for ( const auto &entry : std::filesystem::directory_iterator( byPath, ec ) )
+    {
+      const std::string name = entry.path().filename().string();
+      if ( not name.ends_with( "-event-kbd" ) )
+        continue;
+      if ( name.find( "i8042" ) != std::string::npos )
+        return entry.path().string();
+      if ( first.empty() or entry.path().string() < first )
+        first = entry.path().string();
+    }
+    return first;
+  }
+
+  bool open( const std::string &path )
+  {
+    close();
+    if ( not path.empty() )
+      m_fd = ::open( path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+    return m_fd >= 0;
+  }
+
+  void close()
+  {
+    if ( m_fd >= 0 )
+      ::close( m_fd );
+    m_fd = -1;
+  }
+
+  [[nodiscard]] bool isOpen() const noexcept { return m_fd >= 0; }
+
+  /// True if a key went down since the last call
+  bool pressed()
+  {
+    bool down = false;
+    input_event events[ 64 ];
+    ssize_t n;
+    while ( m_fd >= 0 and ( n = ::read( m_fd, events, sizeof( events ) ) ) > 0 )
+      for ( size_t i = 0; i < static_cast< size_t >( n ) / sizeof( input_event ); ++i )
+        down = down or ( events[ i ].type == EV_KEY and events[ i ].value == 1 );
+    return down;
+  }
+
+private:
+  int m_fd = -1;
+};
+
+/**
+ * @brief Plays the effect of a KeyboardBacklightController.
+ *
+ * Idle while no effect runs; the controller's effect listener wakes it,
+ * and it then renders and writes one frame per 1 / fps.  Frames of an
+ * effect that was replaced meanwhile are dropped by the controller.
+ *
+ * It also steps the controller's idle fade, on white backlights too, and
+ * renders nothing while the backlight is dark for idle.
+ */
+class KeyboardEffectWorker : public DaemonWorker
+{
+public:
+  static constexpr std::chrono::milliseconds IDLE_TIMEOUT{ 60'000 };
+
+  explicit KeyboardEffectWorker( KeyboardBacklightController &controller,
+                                 std::string keyboardInput = KeyActivityMonitor::findKeyboard() )
+    : DaemonWorker( IDLE_TIMEOUT, false ), m_controller( controller ), m_keyboardInput( std::move( keyboardInput ) )
+  {
+    m_controller.setEffectListener( [ this ] { wake(); } );
+  }
+
+  ~KeyboardEffectWorker() override
+  {
+    m_controller.setEffectListener( nullptr );
+    stop();
+  }
+
+  KeyboardEffectWorker( const KeyboardEffectWorker & ) = delete;
+  KeyboardEffectWorker &operator=( const KeyboardEffectWorker & ) = delete;
+
+protected:
+  void onStart() override {}
+
+  void onWork() override
+  {
+    const bool fading = m_controller.stepIdleFade();
+
+    uint64_t generation = 0;
+    const auto effect = m_controller.effect( generation );
+    if ( not effect or m_controller.idleDark() )
+    {
+      // dark for idle: the effect starts over once the backlight is lit
+      m_keys.close();
+      m_generation = effect ? 0 : generation;
+      setTimeout( fading ? BrightnessRamp::STEP : IDLE_TIMEOUT );
+      return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if ( generation != m_generation )
+    {
+      m_generation = generation;
+      m_origin = now;
+      m_lastPress.reset();
+      m_frame.assign( static_cast< size_t >( m_controller.capabilities().zones ), KeyboardRgb{} );
+      if ( effect->type == KeyboardEffectType::Reactive )
+        m_keys.open( m_keyboardInput );
+      else
+        m_keys.close();
+    }
+
+    if ( m_keys.pressed() )
+      m_lastPress = now;
+
+    const auto seconds = []( std::chrono::steady_clock::duration d ) {
+      return std::chrono::duration< double >( d ).count();
+    };
+    KeyboardEffectRenderer::render( *effect, seconds( now - m_origin ),
+                                    m_lastPress ? seconds( now - *m_lastPress ) : -1.0, m_frame );
+    m_controller.writeFrame( m_frame, generation );
+    setTimeout( fading ? BrightnessRamp::STEP : std::chrono::milliseconds( 1000 / effect->fps ) );
+  }
+
+  void onExit() override { m_keys.close(); }
+
+private:
+  KeyboardBacklightController &m_controller;
+  std::string m_keyboardInput;
+  KeyActivityMonitor m_keys;
+  uint64_t m_generation = 0;
+  std::chrono::steady_clock::time_point m_origin;
+  std::optional< std::chrono::steady_clock::time_point > m_lastPress;
+  std::vector< KeyboardRgb > m_frame;
+};
@@ -28,11 +28,15 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <optional>
 
+#include "BleCommandQueue.hpp"
 #include "CommonTypes.hpp"
+#include "KnownBleDevice.hpp"
 
 // Forward declarations
 class UccDBusData;
+class MetricsHistoryStore;
 
 /**
  * @brief Water cooler connection states
@@ -58,7 +62,9 @@ enum class WaterCoolerState
  *
  * Thread safety: public control methods (setFanSpeed, setPumpVoltage, etc.)
  * are safe to call from any thread — they dispatch to the main thread when
- * needed via BlockingQueuedConnection.
+ * needed via BlockingQueuedConnection.  They only queue the BLE write, so
+ * the dispatch never waits for the write gap; a single-shot timer sends
+ * the queue out most urgent first.
  */
 class LCTWaterCoolerWorker : public QObject
 {
@@ -98,6 +104,17 @@ public:
    */
   void stop();
 
+  /**
+   * @brief Record fan duty, pump level, link RSSI and command latency in @p store
+   *
+   * Samples are pushed as BLE writes go out, so the history shows what the
+   * device was actually sent.  Call before start().
+   */
+  void setMetricsStore( MetricsHistoryStore* store )
+  {
+    m_metricsStore = store;
+  }
+
   /**
    * @brief Check if connected to device (thread-safe)
    * @return true if connected
@@ -203,7 +220,9 @@ private:
   // BLE helpers
   bool setupBleController( const QBluetoothDeviceInfo& deviceInfo );
   void cleanupBleController();
-  void throttledBleWrite( const QByteArray& data );
+  void enqueueBleWrite( const QByteArray& data );
+  void sendQueuedBleWrites();
+  void onBleCommandFinished( const BleCommandQueue< QByteArray >::Command& command, BleCommandOutcome outcome );
   bool writeCommand( const QByteArray& data );
   bool writeReceive( const QByteArray& data );
   bool turnOffDevice( uint8_t cmd );
@@ -267,6 +286,8 @@ private:
   QBluetoothDeviceInfo m_connectedDeviceInfo;
   QBluetoothDeviceInfo m_lastKnownDeviceInfo;
   bool m_hasKnownDevice = false;
+  // m_lastKnownDeviceInfo as saved for the next daemon start
+  std::optional< KnownBleDevice > m_savedDevice;
 
   // Store trusted MAC to prevent impersonation
   QString m_trustedDeviceMacAddress;
@@ -287,9 +308,14 @@ private:
   bool m_waitingForResponse = false;
   QByteArray m_pendingData;
 
-  // BLE write throttle – minimum gap between successive UART writes
+  // BLE write queue – minimum gap between successive UART writes, kept
+  // by m_bleQueueTimer instead of sleeping on the event loop
   static constexpr int BLE_WRITE_GAP_MS = 80;
   std::chrono::steady_clock::time_point m_lastBleWrite{};
+  BleCommandQueue< QByteArray > m_bleQueue;
+  QTimer* m_bleQueueTimer = nullptr;
+
+  MetricsHistoryStore* m_metricsStore = nullptr;
 
   // Keepalive tracking
   std::chrono::steady_clock::time_point m_lastKeepalive{};
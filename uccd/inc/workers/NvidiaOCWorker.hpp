@@ -16,8 +16,11 @@
 #pragma once
 
 #include "../NvmlWrapper.hpp"
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 /**
@@ -27,6 +30,11 @@
  * service can call directly.  Lives on the main thread (like
  * ProfileSettingsWorker), no DaemonWorker/QThread inheritance needed
  * since all calls are on-demand.
+ *
+ * The OC state is cached per device: successful writes through this class
+ * invalidate it, and it is re-read from the driver at most every
+ * OC_STATE_REFRESH to pick up changes made outside uccd (nvidia-smi etc.).
+ * tempC / powerDrawW in it are therefore a snapshot, not live telemetry.
  */
 class NvidiaOCWorker
 {
@@ -42,7 +50,10 @@ public:
   /** @return true if NVML initialised and at least one GPU found */
   [[nodiscard]] bool isAvailable() const noexcept;
 
-  /** @return JSON string with full OC state for device 0 */
+  /// Maximum age of a cached OC state before it is re-read from NVML
+  static constexpr std::chrono::seconds OC_STATE_REFRESH { 30 };
+
+  /** @return JSON string with full OC state for device 0 (cached, see class doc) */
   [[nodiscard]] std::string getOCStateJSON( unsigned int deviceIndex = 0 ) const;
 
   /** Set clock offset for a specific P-state */
@@ -83,8 +94,20 @@ public:
   bool resetAll( unsigned int deviceIndex = 0 );
 
 private:
+  struct CachedState
+  {
+    std::string json;
+    std::chrono::steady_clock::time_point fetched;
+  };
+
+  [[nodiscard]] std::string buildOCStateJSON( unsigned int deviceIndex ) const;
+  /// Drop the cached state of @p deviceIndex after a successful write
+  void invalidate( unsigned int deviceIndex );
   void log( const std::string &msg ) const;
 
   std::shared_ptr< NvmlWrapper > m_nvml;
   std::function< void( const std::string & ) > m_logFunction;
+
+  mutable std::mutex m_cacheMutex;
+  mutable std::map< unsigned int, CachedState > m_stateCache;
 };
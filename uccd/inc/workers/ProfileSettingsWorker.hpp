@@ -19,18 +19,23 @@
 #include "SysfsNode.hpp"
 #include "../TccSettings.hpp"
 #include "../NvmlWrapper.hpp"
+#include "../PowerBudgetArbiter.hpp"
+#include "../PowerLimitController.hpp"
+#include "../RaplDomains.hpp"
 
 #include <atomic>
 #include <filesystem>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <syslog.h>
 #include <vector>
 
-// Forward declaration
-class TuxedoIOAPI;
+// Forward declarations
+class DeviceInterface;
+class EcIoService;
 
 namespace fs = std::filesystem;
 
@@ -59,7 +64,7 @@ class ProfileSettingsWorker
 {
 public:
   ProfileSettingsWorker(
-    TuxedoIOAPI &ioApi,
+    EcIoService &ec,
     std::shared_ptr< NvmlWrapper > nvml,
     std::function< UccProfile() > getActiveProfileCallback,
     std::function< void( const std::vector< std::string > & ) > setOdmProfilesAvailableCallback,
@@ -72,7 +77,7 @@ public:
     std::atomic< bool > &nvidiaPowerCTRLAvailable,
     std::atomic< bool > &cTGPAdjustmentSupported,
     bool skipAcpiPlatformProfile = false )
-    : m_ioApi( ioApi ),
+    : m_ec( ec ),
       m_nvml( std::move( nvml ) ),
       m_getActiveProfile( std::move( getActiveProfileCallback ) ),
       m_setOdmProfilesAvailable( std::move( setOdmProfilesAvailableCallback ) ),
@@ -99,6 +104,33 @@ public:
   //  ODM Power Limit API  (was ODMPowerLimitWorker)
   // =====================================================================
 
+  /**
+   * @brief Descriptors and limits of every TDP; run it through EcIoService::call()
+   */
+  static std::vector< TDPInfo > readTDPInfo( DeviceInterface &device );
+
+  /**
+   * @brief One step of the dynamic power limits (PowerLimitMode::Dynamic)
+   *
+   * Moves the ODM TDPs, and the RAPL PL1/PL2 where they are writable, by
+   * what the filtered CPU temperature and fan duty allow.  Does nothing
+   * unless the last applyODMPowerLimits() found the profile in dynamic mode.
+   *
+   * @param fanDuty CPU fan duty in %, < 0 if unknown
+   */
+  void updateDynamicPowerLimits( const PowerLimitControllerSettings &settings, double cpuTemp, double fanDuty,
+                                 double dtSeconds );
+
+  /**
+   * @brief One step of the CPU/GPU power budget arbiter (gpuShareWatts > 0)
+   *
+   * Moves up to gpuShareWatts between every CPU TDP and the cTGP offset,
+   * towards whichever side @p sample shows power-bound.  The limits of
+   * @p sample are filled in here.  Call it before updateDynamicPowerLimits(),
+   * which then writes the moved TDP ceilings in dynamic mode.
+   */
+  void updatePowerBudget( const PowerLimitControllerSettings &settings, PowerBudgetSample sample, double dtSeconds );
+
   void reapplyProfile()
   {
     logLine( "ProfileSettingsWorker: reapplyProfile() called" );
@@ -133,12 +165,21 @@ public:
   bool applyNVIDIAPowerOffset( int32_t offset );
 
   /**
-   * @brief Periodic validation — checks if an external process changed the cTGP offset
-   *        and re-applies the profile value if needed.
+   * @brief The cTGP offset the hardware last accepted from us.
    *
-   * Call this from the service's onWork() loop (original interval was 5 000 ms).
+   * HardwareReconciler's desired-state token for the cTGP offset.
+   */
+  int32_t appliedNVIDIACTGPOffset() const noexcept { return m_lastAppliedNVIDIAOffset.load(); }
+
+  /**
+   * @brief True unless an external process changed the cTGP offset.
+   */
+  bool nvidiaCTGPOffsetInPlace();
+
+  /**
+   * @brief Write the last accepted cTGP offset again.
    */
-  void validateNVIDIACTGPOffset();
+  bool reapplyNVIDIACTGPOffset();
 
 private:
   // ----- ODM Profile internals -----
@@ -151,7 +192,7 @@ private:
     TuxedoIOAPI
   };
 
-  TuxedoIOAPI &m_ioApi;
+  EcIoService &m_ec;
   std::shared_ptr< NvmlWrapper > m_nvml;
   std::function< UccProfile() > m_getActiveProfile;
   std::function< void( const std::vector< std::string > & ) > m_setOdmProfilesAvailable;
@@ -210,6 +251,23 @@ private:
   void publishODMPowerLimitsJSON( const std::vector< TDPInfo > &tdpInfo );
   void applyODMPowerLimits();
 
+  // ----- Dynamic power limit internals -----
+
+  std::mutex m_powerLimitMutex;
+  std::vector< int32_t > m_profileTDPValues;           ///< as applied from the profile; empty if that failed
+  std::vector< PowerLimitBounds > m_tdpHardware;
+  std::vector< TDPInfo > m_appliedTDPInfo;             ///< as last written and published
+  PowerLimitController m_powerLimitController;
+  std::vector< PowerLimitBounds > m_powerLimitBounds;  ///< empty unless in dynamic mode
+  RaplPowerLimits m_raplLimits;
+  bool m_raplDiscovered = false;
+  PowerBudgetArbiter m_powerBudgetArbiter;
+  int32_t m_budgetShift = 0;                           ///< W moved from the CPU TDPs to the cTGP offset
+  int32_t m_profileNVIDIAOffset = 0;                   ///< cTGP offset of the GPU profile
+
+  /// Write TDP values the profile did not set literally (dynamic or budget step)
+  bool writeManagedTDPValues( const std::vector< int32_t > &values );
+
   // ----- Charging internals -----
 
   std::string m_currentChargingProfile;
@@ -256,7 +314,8 @@ private:
 
   // ----- NVIDIA Power Control internals -----
 
-  int32_t m_lastAppliedNVIDIAOffset = 0;
+  std::atomic< int32_t > m_lastAppliedNVIDIAOffset{ 0 };
+  SysfsNode< int32_t > m_ctgpOffsetNode{ NVIDIA_CTGP_OFFSET, "", SysfsReadMode::Cached };
   std::atomic< int32_t > &m_nvidiaPowerCTRLDefaultPowerLimit;
   std::atomic< int32_t > &m_nvidiaPowerCTRLMaxPowerLimit;
   std::atomic< bool > &m_nvidiaPowerCTRLAvailable;
@@ -14,8 +14,14 @@
  */
 
 #include "NvmlWrapper.hpp"
+#include "UccTrace.hpp"
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
+#include <limits>
 
 namespace
 {
@@ -35,16 +41,59 @@ inline int offsetKey( nvml::nvmlClockType_t clockType, nvml::nvmlPstates_t pstat
 {
   return static_cast< int >( clockType ) * 100 + static_cast< int >( pstate );
 }
+
+std::string perfLimitReasonName( nvml::nvmlClocksThrottleReasons_t reasons )
+{
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_HW_POWER_BRAKE_SLOWDOWN ) return "HW Power Brake";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_SW_POWER_CAP ) return "Power Limit";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_HW_THERMAL_SLOWDOWN ) return "HW Thermal";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_SW_THERMAL_SLOWDOWN ) return "SW Thermal";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_HW_SLOWDOWN ) return "HW Slowdown";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_APPLICATIONS_CLOCKS_SETTING ) return "App Clocks";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_DISPLAY_CLOCK_SETTING ) return "Display Limit";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_SYNC_BOOST ) return "Sync Boost";
+  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_GPU_IDLE ) return "Idle";
+  return "None";
+}
+
+double nvmlValueToDouble( nvml::nvmlValueType_t type, const nvml::nvmlValue_t &value )
+{
+  switch ( type )
+  {
+    case nvml::NVML_VALUE_TYPE_DOUBLE:             return value.dVal;
+    case nvml::NVML_VALUE_TYPE_UNSIGNED_INT:       return static_cast< double >( value.uiVal );
+    case nvml::NVML_VALUE_TYPE_UNSIGNED_LONG:      return static_cast< double >( value.ulVal );
+    case nvml::NVML_VALUE_TYPE_UNSIGNED_LONG_LONG: return static_cast< double >( value.ullVal );
+    case nvml::NVML_VALUE_TYPE_SIGNED_LONG_LONG:   return static_cast< double >( value.sllVal );
+    case nvml::NVML_VALUE_TYPE_SIGNED_INT:         return static_cast< double >( value.siVal );
+    case nvml::NVML_VALUE_TYPE_UNSIGNED_SHORT:     return static_cast< double >( value.usVal );
+    default:                                       return std::numeric_limits< double >::quiet_NaN();
+  }
+}
+
+/// Milliwatt field value as watts, if the driver filled it
+std::optional< double > fieldMilliwattsToW( const nvml::nvmlFieldValue_t &field )
+{
+  if ( field.nvmlReturn != nvml::NVML_SUCCESS )
+    return std::nullopt;
+  const double mw = nvmlValueToDouble( field.valueType, field.value );
+  if ( !std::isfinite( mw ) )
+    return std::nullopt;
+  return mw / 1000.0;
+}
 }
 
 NvmlWrapper::NvmlWrapper( bool enableOcFeatures )
   : m_enableOcFeatures( enableOcFeatures )
 {
-  // Try to load the NVML library
-  m_lib = dlopen( "libnvidia-ml.so.1", RTLD_LAZY | RTLD_LOCAL );
+  // Try to load the NVML library; UCCD_NVML_LIBRARY substitutes a fake one
+  // for simulated hardware
+  const char *override = std::getenv( "UCCD_NVML_LIBRARY" );
+  const char *library = override && *override ? override : "libnvidia-ml.so.1";
+  m_lib = dlopen( library, RTLD_LAZY | RTLD_LOCAL );
   if ( !m_lib )
   {
-    std::cerr << "[NvmlWrapper] Could not load libnvidia-ml.so.1: " << dlerror() << std::endl;
+    std::cerr << "[NvmlWrapper] Could not load " << library << ": " << dlerror() << std::endl;
     return;
   }
 
@@ -55,6 +104,9 @@ NvmlWrapper::NvmlWrapper( bool enableOcFeatures )
   m_getHandle = loadSym< DeviceGetHandleByIndexFn >( "nvmlDeviceGetHandleByIndex_v2" );
   m_getName = loadSym< DeviceGetNameFn >( "nvmlDeviceGetName" );
   m_getPciBusId = loadSym< DeviceGetPciBusIdFn >( "nvmlDeviceGetPciInfo_v3" );
+  m_getDriverVersion = loadSym< SystemGetDriverVersionFn >( "nvmlSystemGetDriverVersion" );
+  m_getUuid = loadSym< DeviceGetUUIDFn >( "nvmlDeviceGetUUID" );
+  m_getVbiosVersion = loadSym< DeviceGetVbiosVersionFn >( "nvmlDeviceGetVbiosVersion" );
   m_getTemperature = loadSym< DeviceGetTemperatureFn >( "nvmlDeviceGetTemperature" );
   m_getTemperatureThreshold = loadSym< DeviceGetTemperatureThresholdFn >( "nvmlDeviceGetTemperatureThreshold" );
   m_getPowerUsage = loadSym< DeviceGetPowerUsageFn >( "nvmlDeviceGetPowerUsage" );
@@ -73,6 +125,8 @@ NvmlWrapper::NvmlWrapper( bool enableOcFeatures )
   m_getCurrentClocksThrottleReasons = loadSym< DeviceGetCurrentClocksThrottleReasonsFn >( "nvmlDeviceGetCurrentClocksThrottleReasons" );
   m_getEncoderUtilization = loadSym< DeviceGetEncoderUtilizationFn >( "nvmlDeviceGetEncoderUtilization" );
   m_getDecoderUtilization = loadSym< DeviceGetDecoderUtilizationFn >( "nvmlDeviceGetDecoderUtilization" );
+  m_getFieldValues = loadSym< DeviceGetFieldValuesFn >( "nvmlDeviceGetFieldValues" );
+  m_getSamples = loadSym< DeviceGetSamplesFn >( "nvmlDeviceGetSamples" );
 
   // OC-specific functions (may not exist on older drivers)
   m_getSupportedPstates = loadSym< DeviceGetSupportedPstatesFn >( "nvmlDeviceGetSupportedPerformanceStates" );
@@ -114,91 +168,152 @@ NvmlWrapper::NvmlWrapper( bool enableOcFeatures )
     return;
   }
 
+  m_fieldValuesUnsupported = std::make_unique< std::atomic< bool >[] >( m_deviceCount );
   m_initialized = true;
   std::cerr << "[NvmlWrapper] Initialized successfully, found " << m_deviceCount << " GPU(s)" << std::endl;
 
   if ( m_enableOcFeatures )
-  {
-    cacheSupportedPstates();
-    probeWritableOffsetPstates();
-  }
+    initOcFeatures();
   initNvapi();
 }
 
-void NvmlWrapper::cacheSupportedPstates()
+void NvmlWrapper::initOcFeatures()
 {
-  if ( !m_getSupportedPstates )
-    return;
-
-  for ( unsigned int deviceIndex = 0; deviceIndex < m_deviceCount; ++deviceIndex )
-  {
-    auto devOpt = getDevice( deviceIndex );
-    if ( !devOpt )
-      continue;
+  std::call_once( m_ocFeaturesOnce, [this]() {
+    if ( !m_initialized )
+      return;
 
-    nvml::nvmlPstates_t pstateArr[nvml::NVML_MAX_GPU_PERF_PSTATES];
-    std::memset( pstateArr, 0xFF, sizeof( pstateArr ) );
+    NvmlProbeCache cache;
+    const auto driverVersion = getDriverVersion();
+    for ( unsigned int deviceIndex = 0; deviceIndex < m_deviceCount; ++deviceIndex )
+    {
+      const auto identity = driverVersion ? getGpuIdentity( deviceIndex ) : std::nullopt;
+      if ( identity )
+      {
+        if ( auto cached = cache.find( *driverVersion, *identity ) )
+        {
+          auto &pstates = m_supportedPstates[deviceIndex];
+          for ( unsigned int pstate : cached->pstates )
+            pstates.push_back( static_cast< nvml::nvmlPstates_t >( pstate ) );
+          m_writableOffsets[deviceIndex] = std::move( cached->writableOffsets );
+          std::cerr << "[NvmlWrapper] Reusing cached OC probe for GPU " << deviceIndex
+                    << " (" << pstates.size() << " P-state(s))" << std::endl;
+          continue;
+        }
+      }
 
-    if ( m_getSupportedPstates( *devOpt, pstateArr, nvml::NVML_MAX_GPU_PERF_PSTATES )
-         != nvml::NVML_SUCCESS )
-      continue;
+      if ( !cacheSupportedPstates( deviceIndex ) )
+        continue;
+      probeWritableOffsetPstates( deviceIndex );
 
-    auto &cached = m_supportedPstates[deviceIndex];
-    cached.clear();
-    for ( unsigned int i = 0; i < nvml::NVML_MAX_GPU_PERF_PSTATES; ++i )
-    {
-      if ( pstateArr[i] == nvml::NVML_PSTATE_UNKNOWN )
-        break;
-      cached.push_back( pstateArr[i] );
+      if ( identity )
+      {
+        NvmlProbeResult result;
+        for ( auto pstate : m_supportedPstates[deviceIndex] )
+          result.pstates.push_back( static_cast< unsigned int >( pstate ) );
+        result.writableOffsets = m_writableOffsets[deviceIndex];
+        cache.store( *driverVersion, *identity, std::move( result ) );
+      }
     }
+  } );
+}
 
-    std::cerr << "[NvmlWrapper] Found " << cached.size()
-              << " supported P-state(s) on GPU " << deviceIndex << std::endl;
+std::optional< std::string > NvmlWrapper::getDriverVersion() const
+{
+  if ( !m_getDriverVersion )
+    return std::nullopt;
+
+  char version[96] = {};
+  if ( m_getDriverVersion( version, sizeof( version ) ) != nvml::NVML_SUCCESS || version[0] == '\0' )
+    return std::nullopt;
+  return std::string( version );
+}
+
+std::optional< NvmlGpuIdentity > NvmlWrapper::getGpuIdentity( unsigned int deviceIndex ) const
+{
+  if ( !m_getUuid || !m_getVbiosVersion )
+    return std::nullopt;
+  auto devOpt = getDevice( deviceIndex );
+  if ( !devOpt )
+    return std::nullopt;
+
+  char uuid[96] = {};
+  char vbios[64] = {};
+  if ( m_getUuid( *devOpt, uuid, sizeof( uuid ) ) != nvml::NVML_SUCCESS || uuid[0] == '\0'
+       || m_getVbiosVersion( *devOpt, vbios, sizeof( vbios ) ) != nvml::NVML_SUCCESS )
+    return std::nullopt;
+  return NvmlGpuIdentity{ uuid, vbios };
+}
+
+bool NvmlWrapper::cacheSupportedPstates( unsigned int deviceIndex )
+{
+  if ( !m_getSupportedPstates )
+    return false;
+
+  auto devOpt = getDevice( deviceIndex );
+  if ( !devOpt )
+    return false;
+
+  nvml::nvmlPstates_t pstateArr[nvml::NVML_MAX_GPU_PERF_PSTATES];
+  std::memset( pstateArr, 0xFF, sizeof( pstateArr ) );
+
+  if ( m_getSupportedPstates( *devOpt, pstateArr, nvml::NVML_MAX_GPU_PERF_PSTATES )
+       != nvml::NVML_SUCCESS )
+    return false;
+
+  auto &cached = m_supportedPstates[deviceIndex];
+  cached.clear();
+  for ( unsigned int i = 0; i < nvml::NVML_MAX_GPU_PERF_PSTATES; ++i )
+  {
+    if ( pstateArr[i] == nvml::NVML_PSTATE_UNKNOWN )
+      break;
+    cached.push_back( pstateArr[i] );
   }
+
+  std::cerr << "[NvmlWrapper] Found " << cached.size()
+            << " supported P-state(s) on GPU " << deviceIndex << std::endl;
+  return true;
 }
 
-void NvmlWrapper::probeWritableOffsetPstates()
+void NvmlWrapper::probeWritableOffsetPstates( unsigned int deviceIndex )
 {
   if ( !m_getClockOffsets || !m_setClockOffsets )
     return;
 
-  for ( unsigned int deviceIndex = 0; deviceIndex < m_deviceCount; ++deviceIndex )
-  {
-    auto devOpt = getDevice( deviceIndex );
-    if ( !devOpt )
-      continue;
+  auto devOpt = getDevice( deviceIndex );
+  if ( !devOpt )
+    return;
 
-    auto device = *devOpt;
+  auto device = *devOpt;
 
-    auto pstatesIt = m_supportedPstates.find( deviceIndex );
-    if ( pstatesIt == m_supportedPstates.end() || pstatesIt->second.empty() )
-      continue;
+  auto pstatesIt = m_supportedPstates.find( deviceIndex );
+  if ( pstatesIt == m_supportedPstates.end() || pstatesIt->second.empty() )
+    return;
 
-    for ( auto pstate : pstatesIt->second )
+  for ( auto pstate : pstatesIt->second )
+  {
+    for ( auto clockType : { nvml::NVML_CLOCK_GRAPHICS, nvml::NVML_CLOCK_MEM } )
     {
-      for ( auto clockType : { nvml::NVML_CLOCK_GRAPHICS, nvml::NVML_CLOCK_MEM } )
-      {
-        nvml::nvmlClockOffset_t info{};
-        info.version = NVML_CLOCK_OFFSET_VER1;
-        info.type = clockType;
-        info.pstate = pstate;
+      nvml::nvmlClockOffset_t info{};
+      info.version = NVML_CLOCK_OFFSET_VER1;
+      info.type = clockType;
+      info.pstate = pstate;
 
-        if ( m_getClockOffsets( device, &info ) != nvml::NVML_SUCCESS )
-        {
-          m_writableOffsets[deviceIndex][offsetKey( clockType, pstate )] = false;
-          continue;
-        }
+      if ( m_getClockOffsets( device, &info ) != nvml::NVML_SUCCESS )
+      {
+        m_writableOffsets[deviceIndex][offsetKey( clockType, pstate )] = false;
+        continue;
+      }
 
-        const int currentOffset = info.clockOffsetMHz;
-        nvml::nvmlClockOffset_t writeInfo{};
-        writeInfo.version = NVML_CLOCK_OFFSET_VER1;
-        writeInfo.type = clockType;
-        writeInfo.pstate = pstate;
-        writeInfo.clockOffsetMHz = currentOffset;
+      const int currentOffset = info.clockOffsetMHz;
+      nvml::nvmlClockOffset_t writeInfo{};
+      writeInfo.version = NVML_CLOCK_OFFSET_VER1;
+      writeInfo.type = clockType;
+      writeInfo.pstate = pstate;
+      writeInfo.clockOffsetMHz = currentOffset;
 
-        const auto ret = m_setClockOffsets( device, &writeInfo );
-        m_writableOffsets[deviceIndex][offsetKey( clockType, pstate )] = ( ret == nvml::NVML_SUCCESS );
-      }
+      const auto ret = m_setClockOffsets( device, &writeInfo );
+      m_writableOffsets[deviceIndex][offsetKey( clockType, pstate )] = ( ret == nvml::NVML_SUCCESS );
     }
   }
 }
@@ -835,16 +950,7 @@ std::optional< std::string > NvmlWrapper::getPerfLimitReason( unsigned int devic
   if ( m_getCurrentClocksThrottleReasons( *devOpt, &reasons ) != nvml::NVML_SUCCESS )
     return std::nullopt;
 
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_HW_POWER_BRAKE_SLOWDOWN ) return std::string( "HW Power Brake" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_SW_POWER_CAP ) return std::string( "Power Limit" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_HW_THERMAL_SLOWDOWN ) return std::string( "HW Thermal" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_SW_THERMAL_SLOWDOWN ) return std::string( "SW Thermal" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_HW_SLOWDOWN ) return std::string( "HW Slowdown" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_APPLICATIONS_CLOCKS_SETTING ) return std::string( "App Clocks" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_DISPLAY_CLOCK_SETTING ) return std::string( "Display Limit" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_SYNC_BOOST ) return std::string( "Sync Boost" );
-  if ( reasons & nvml::NVML_CLOCKS_THROTTLE_REASON_GPU_IDLE ) return std::string( "Idle" );
-  return std::string( "None" );
+  return perfLimitReasonName( reasons );
 }
 
 std::optional< unsigned int > NvmlWrapper::getEncoderUtilPct( unsigned int deviceIndex ) const noexcept
@@ -911,3 +1017,179 @@ std::optional< int > NvmlWrapper::getMemClockOffsetMHz( unsigned int deviceIndex
   if ( m_getClockOffsets( *devOpt, &info ) != nvml::NVML_SUCCESS ) return std::nullopt;
   return info.clockOffsetMHz;
 }
+
+std::optional< std::string > NvmlWrapper::getName( unsigned int deviceIndex ) const noexcept
+{
+  if ( !m_getName ) return std::nullopt;
+  auto devOpt = getDevice( deviceIndex );
+  if ( !devOpt ) return std::nullopt;
+  char name[256] = {};
+  if ( m_getName( *devOpt, name, sizeof( name ) ) != nvml::NVML_SUCCESS ) return std::nullopt;
+  return std::string( name );
+}
+
+NvmlTelemetry NvmlWrapper::getTelemetry( unsigned int deviceIndex ) const noexcept
+{
+  UCC_TRACE_SCOPE_ARG( "nvml", "getTelemetry", deviceIndex );
+  NvmlTelemetry t;
+  auto devOpt = getDevice( deviceIndex );
+  if ( !devOpt ) return t;
+  const nvml::nvmlDevice_t device = *devOpt;
+
+  // Power readings in one driver round trip; a driver that rejects the call
+  // (or knows none of the fields) is remembered so later ticks go straight
+  // to the per-value fallback.
+  if ( m_getFieldValues && !m_fieldValuesUnsupported[deviceIndex].load( std::memory_order_relaxed ) )
+  {
+    std::array< nvml::nvmlFieldValue_t, 3 > fields{};
+    fields[0].fieldId = nvml::NVML_FI_DEV_POWER_INSTANT;
+    fields[1].fieldId = nvml::NVML_FI_DEV_POWER_CURRENT_LIMIT;
+    fields[2].fieldId = nvml::NVML_FI_DEV_POWER_MAX_LIMIT;
+    const nvml::nvmlReturn_t ret = m_getFieldValues( device, static_cast< int >( fields.size() ), fields.data() );
+    if ( ret == nvml::NVML_SUCCESS )
+    {
+      t.powerDrawW = fieldMilliwattsToW( fields[0] );
+      t.enforcedPowerLimitW = fieldMilliwattsToW( fields[1] );
+      t.powerMaxLimitW = fieldMilliwattsToW( fields[2] );
+    }
+    if ( ret != nvml::NVML_SUCCESS || ( !t.powerDrawW && !t.enforcedPowerLimitW && !t.powerMaxLimitW ) )
+    {
+      m_fieldValuesUnsupported[deviceIndex].store( true, std::memory_order_relaxed );
+    }
+  }
+
+  unsigned int value = 0;
+  if ( !t.powerDrawW && m_getPowerUsage && m_getPowerUsage( device, &value ) == nvml::NVML_SUCCESS )
+    t.powerDrawW = static_cast< double >( value ) / 1000.0;
+  if ( !t.enforcedPowerLimitW && m_getEnforcedPowerLimit && m_getEnforcedPowerLimit( device, &value ) == nvml::NVML_SUCCESS )
+    t.enforcedPowerLimitW = static_cast< double >( value ) / 1000.0;
+  if ( !t.powerMaxLimitW && m_getPowerLimitConstraints )
+  {
+    unsigned int minMw = 0, maxMw = 0;
+    if ( m_getPowerLimitConstraints( device, &minMw, &maxMw ) == nvml::NVML_SUCCESS )
+      t.powerMaxLimitW = static_cast< double >( maxMw ) / 1000.0;
+  }
+
+  // 0 = NVML_TEMPERATURE_GPU
+  if ( m_getTemperature && m_getTemperature( device, 0, &value ) == nvml::NVML_SUCCESS )
+    t.tempC = value;
+  if ( m_getClockInfo && m_getClockInfo( device, nvml::NVML_CLOCK_GRAPHICS, &value ) == nvml::NVML_SUCCESS )
+    t.gpuClockMHz = value;
+  if ( m_getClockInfo && m_getClockInfo( device, nvml::NVML_CLOCK_MEM, &value ) == nvml::NVML_SUCCESS )
+    t.memClockMHz = value;
+  if ( m_getMaxClockInfo && m_getMaxClockInfo( device, nvml::NVML_CLOCK_GRAPHICS, &value ) == nvml::NVML_SUCCESS )
+    t.maxGpuClockMHz = value;
+
+  if ( m_getUtilizationRates )
+  {
+    nvml::nvmlUtilization_t util{};
+    if ( m_getUtilizationRates( device, &util ) == nvml::NVML_SUCCESS )
+    {
+      t.computeUtilPct = util.gpu;
+      t.memoryUtilPct = util.memory;
+    }
+  }
+
+  if ( m_getMemoryInfo )
+  {
+    nvml::nvmlMemory_t mem{};
+    if ( m_getMemoryInfo( device, &mem ) == nvml::NVML_SUCCESS )
+    {
+      t.vramUsedMiB = static_cast< unsigned int >( mem.used / ( 1024ULL * 1024ULL ) );
+      t.vramTotalMiB = static_cast< unsigned int >( mem.total / ( 1024ULL * 1024ULL ) );
+    }
+  }
+
+  if ( m_getCurrentClocksThrottleReasons )
+  {
+    nvml::nvmlClocksThrottleReasons_t reasons = 0;
+    if ( m_getCurrentClocksThrottleReasons( device, &reasons ) == nvml::NVML_SUCCESS )
+      t.perfLimitReason = perfLimitReasonName( reasons );
+  }
+
+  unsigned int sampleUs = 0;
+  if ( m_getEncoderUtilization && m_getEncoderUtilization( device, &value, &sampleUs ) == nvml::NVML_SUCCESS )
+    t.encoderUtilPct = value;
+  if ( m_getDecoderUtilization && m_getDecoderUtilization( device, &value, &sampleUs ) == nvml::NVML_SUCCESS )
+    t.decoderUtilPct = value;
+
+  // The P-state is shared by the P-state report and both offset lookups
+  nvml::nvmlPstates_t pstate = nvml::NVML_PSTATE_UNKNOWN;
+  if ( m_getPerformanceState && m_getPerformanceState( device, &pstate ) == nvml::NVML_SUCCESS
+       && pstate != nvml::NVML_PSTATE_UNKNOWN )
+  {
+    t.currentPstate = static_cast< unsigned int >( pstate );
+
+    if ( m_getClockOffsets )
+    {
+      nvml::nvmlClockOffset_t info{};
+      info.version = NVML_CLOCK_OFFSET_VER1;
+      info.type    = nvml::NVML_CLOCK_GRAPHICS;
+      info.pstate  = pstate;
+      if ( m_getClockOffsets( device, &info ) == nvml::NVML_SUCCESS )
+        t.grClockOffsetMHz = info.clockOffsetMHz;
+
+      info = nvml::nvmlClockOffset_t{};
+      info.version = NVML_CLOCK_OFFSET_VER1;
+      info.type    = nvml::NVML_CLOCK_MEM;
+      info.pstate  = pstate;
+      if ( m_getClockOffsets( device, &info ) == nvml::NVML_SUCCESS )
+        t.memClockOffsetMHz = info.clockOffsetMHz;
+    }
+  }
+
+  t.coreVoltageMv = getCoreVoltageMv( deviceIndex );
+  return t;
+}
+
+bool NvmlWrapper::drainSamples( unsigned int deviceIndex, nvml::nvmlSamplingType_t type,
+                                unsigned long long &lastSeenUs, std::vector< NvmlSample > &out ) const noexcept
+{
+  if ( !m_getSamples ) return false;
+  auto devOpt = getDevice( deviceIndex );
+  if ( !devOpt ) return false;
+
+  // Scratch buffer of the calling (monitor) thread, grown to the driver's
+  // buffer length once and then reused
+  static thread_local std::vector< nvml::nvmlSample_t > buffer( 128 );
+
+  nvml::nvmlValueType_t valueType = nvml::NVML_VALUE_TYPE_UNSIGNED_INT;
+  unsigned int count = static_cast< unsigned int >( buffer.size() );
+  nvml::nvmlReturn_t ret = m_getSamples( *devOpt, type, lastSeenUs, &valueType, &count, buffer.data() );
+  if ( ret == nvml::NVML_ERROR_INSUFFICIENT_SIZE )
+  {
+    count = 0;
+    if ( m_getSamples( *devOpt, type, lastSeenUs, &valueType, &count, nullptr ) != nvml::NVML_SUCCESS )
+      return false;
+    try { buffer.resize( count ); }
+    catch ( ... ) { return false; }
+    ret = m_getSamples( *devOpt, type, lastSeenUs, &valueType, &count, buffer.data() );
+  }
+  if ( ret == nvml::NVML_ERROR_NOT_FOUND )
+    return true;
+  if ( ret != nvml::NVML_SUCCESS )
+    return false;
+
+  // Samples carry CPU wall-clock timestamps; anything far from now would
+  // land in the wrong place of the history timeline
+  const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::system_clock::now().time_since_epoch() ).count();
+  constexpr int64_t MAX_AGE_MS = 60'000;
+
+  count = std::min( count, static_cast< unsigned int >( buffer.size() ) );
+  for ( unsigned int i = 0; i < count; ++i )
+  {
+    const nvml::nvmlSample_t &sample = buffer[i];
+    if ( sample.timeStamp <= lastSeenUs )
+      continue;
+    lastSeenUs = sample.timeStamp;
+
+    const int64_t tsMs = static_cast< int64_t >( sample.timeStamp / 1000ULL );
+    const double value = nvmlValueToDouble( valueType, sample.sampleValue );
+    if ( tsMs < nowMs - MAX_AGE_MS || tsMs > nowMs + 1000 || !std::isfinite( value ) )
+      continue;
+    try { out.push_back( NvmlSample{ tsMs, value } ); }
+    catch ( ... ) { return false; }
+  }
+  return true;
+}
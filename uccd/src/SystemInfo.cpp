@@ -15,9 +15,10 @@
 
 #include "SystemInfo.hpp"
 #include "SysfsNode.hpp"
+#include "SysfsRoot.hpp"
+#include "PciNameCache.hpp"
 
 #include <algorithm>
-#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -106,9 +107,8 @@ struct PciGpu
 /**
  * @brief Look up a device name from the system pci.ids database
  *
- * The pci.ids file uses a simple text format:
- *   VVVV  Vendor Name          (vendor line, no indent, 4-digit lowercase hex)
- *   \tDDDD  Device Name        (device line, one tab indent, under that vendor)
+ * Answers come from PciNameCache, so the text database is only scanned
+ * for a device not seen since it last changed.
  *
  * Common locations: /usr/share/hwdata/pci.ids (Fedora/Arch/NixOS),
  *                   /usr/share/misc/pci.ids  (Debian/Ubuntu)
@@ -121,49 +121,17 @@ std::string lookupPciIds( unsigned vendor, unsigned device )
     "/usr/share/pci.ids",
     nullptr
   };
-
-  // Format vendor/device as lowercase 4-digit hex for matching
-  char vendorHex[5], deviceHex[5];
-  std::snprintf( vendorHex, sizeof( vendorHex ), "%04x", vendor );
-  std::snprintf( deviceHex, sizeof( deviceHex ), "%04x", device );
+  static PciNameCache cache;
 
   for ( const char **p = pciIdsPaths; *p; ++p )
   {
-    std::ifstream file( *p );
-    if ( !file.is_open() )
+    const auto source = PciNameCache::identify( *p );
+    if ( !source )
       continue;
 
-    bool inVendor = false;
-    std::string line;
-    while ( std::getline( file, line ) )
-    {
-      // Skip comments and empty lines
-      if ( line.empty() || line[0] == '#' )
-        continue;
-
-      // Vendor line: starts with hex digit at column 0
-      if ( line[0] != '\t' )
-      {
-        // Check if this is our vendor
-        if ( line.size() >= 4 && line.compare( 0, 4, vendorHex ) == 0 )
-          inVendor = true;
-        else if ( inVendor )
-          break; // Passed our vendor section, stop searching
-        continue;
-      }
-
-      // Device line: tab + 4-digit hex + spaces + name
-      if ( inVendor && line.size() >= 6 && line[0] == '\t' && line[1] != '\t' )
-      {
-        if ( line.compare( 1, 4, deviceHex ) == 0 )
-        {
-          // Found it — extract the name after "DDDD  "
-          auto nameStart = line.find_first_not_of( " \t", 5 );
-          if ( nameStart != std::string::npos )
-            return trim( line.substr( nameStart ) );
-        }
-      }
-    }
+    std::string name = cache.lookup( *source, vendor, device );
+    if ( !name.empty() )
+      return name;
   }
 
   return {};
@@ -268,7 +236,7 @@ std::string decodePciName( unsigned vendor, [[maybe_unused]] unsigned device,
  */
 void detectGpus( std::string &iGpu, std::string &dGpu )
 {
-  const std::string pciBasePath = "/sys/bus/pci/devices";
+  const std::string pciBasePath = ucc::sysfsPath( "/sys/bus/pci/devices" );
 
   if ( !fs::exists( pciBasePath ) )
     return;
@@ -481,7 +449,7 @@ std::string buildLaptopModel( std::optional< UniwillDeviceID > deviceId,
   }
 
   // Fallback: use raw DMI product_name
-  std::string productName = readFile( "/sys/class/dmi/id/product_name" );
+  std::string productName = readFile( ucc::sysfsPath( "/sys/class/dmi/id/product_name" ) );
   if ( !productName.empty() )
   {
     if ( manufacturer != LaptopManufacturer::Unknown )
@@ -545,7 +513,7 @@ SystemInfo detectSystemInfo( std::optional< UniwillDeviceID > deviceId )
   info.deviceId = deviceId;
 
   // DMI data
-  const std::string dmiBase = "/sys/class/dmi/id";
+  const std::string dmiBase = ucc::sysfsPath( "/sys/class/dmi/id" );
   info.productSKU  = readFile( dmiBase + "/product_sku" );
   info.boardName   = readFile( dmiBase + "/board_name" );
   info.boardVendor = readFile( dmiBase + "/board_vendor" );
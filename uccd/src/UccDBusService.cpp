@@ -14,7 +14,9 @@
  */
 
 #include "UccDBusService.hpp"
+#include "AsyncLog.hpp"
 #include "CommonTypes.hpp"
+#include "UccTrace.hpp"
 #include "NvmlWrapper.hpp"
 #include "profiles/DefaultProfiles.hpp"
 #include "profiles/FanProfile.hpp"
@@ -22,22 +24,32 @@
 #include "StateUtils.hpp"
 #include "Utils.hpp"
 #include "SysfsNode.hpp"
+#include "JsonWriter.hpp"
+#include <array>
 #include <sstream>
 #include <iomanip>
 #include <map>
 #include <thread>
 #include <cmath>
 #include <climits>
+#include <limits>
+#include <string_view>
 #include <fstream>
 #include <filesystem>
 #include <syslog.h>
 #include <libudev.h>
 #include <algorithm>
+#include <type_traits>
+#include <variant>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QCoreApplication>
 #include <QEventLoop>
+#include <QDBusConnectionInterface>
+#include <QDBusReply>
+#include <QScopeGuard>
+#include <QThread>
 
 namespace
 {
@@ -47,49 +59,6 @@ constexpr const char *BUILTIN_GPU_PROFILE_NAME = "Default [Built-in]";
 
 static std::string jsonEscape( const std::string &value );
 
-// helper function to convert GPU info to JSON
-std::string dgpuInfoToJSON( const DGpuInfo &info )
-{
-  std::ostringstream oss;
-  oss << std::fixed << std::setprecision( 2 );
-  oss << "{"
-  << "\"temp\":" << info.m_temp << ","
-      << "\"coreFrequency\":" << info.m_coreFrequency << ","
-      << "\"vramFrequency\":" << info.m_vramFrequency << ","
-      << "\"maxCoreFrequency\":" << info.m_maxCoreFrequency << ","
-      << "\"powerDraw\":" << info.m_powerDraw << ","
-      << "\"maxPowerLimit\":" << info.m_maxPowerLimit << ","
-      << "\"enforcedPowerLimit\":" << info.m_enforcedPowerLimit << ","
-      << "\"computeUtilPct\":" << info.m_computeUtilPct << ","
-      << "\"memoryUtilPct\":" << info.m_memoryUtilPct << ","
-      << "\"vramUsedMiB\":" << info.m_vramUsedMiB << ","
-      << "\"vramTotalMiB\":" << info.m_vramTotalMiB << ","
-      << "\"perfLimitReason\":\"" << jsonEscape( info.m_perfLimitReason ) << "\","
-      << "\"encoderUtilPct\":" << info.m_encoderUtilPct << ","
-      << "\"decoderUtilPct\":" << info.m_decoderUtilPct << ","
-      << "\"currentPstate\":" << info.m_currentPstate << ","
-      << "\"grClockOffsetMHz\":" << ( info.m_grClockOffsetMHz == INT_MIN ? -999 : info.m_grClockOffsetMHz ) << ","
-      << "\"memClockOffsetMHz\":" << ( info.m_memClockOffsetMHz == INT_MIN ? -999 : info.m_memClockOffsetMHz ) << ","
-      << "\"coreVoltageMv\":" << info.m_coreVoltageMv << ","
-      << "\"d0MetricsUsage\":" << ( info.m_d0MetricsUsage ? "true" : "false" )
-      << "}";
-  return oss.str();
-}
-
-std::string igpuInfoToJSON( const IGpuInfo &info )
-{
-  std::ostringstream oss;
-  oss << std::fixed << std::setprecision( 2 );
-  oss << "{"
-      << "\"temp\":" << info.m_temp << ","
-      << "\"coreFrequency\":" << info.m_coreFrequency << ","
-      << "\"maxCoreFrequency\":" << info.m_maxCoreFrequency << ","
-      << "\"powerDraw\":" << info.m_powerDraw << ","
-      << "\"vendor\":\"" << info.m_vendor << "\""
-      << "}";
-  return oss.str();
-}
-
 static std::string jsonEscape( const std::string &value )
 {
   std::ostringstream oss;
@@ -133,13 +102,13 @@ static int32_t readSysFsInt( const std::string &path, int32_t defaultValue )
 static int32_t getCpuMinFrequency()
 {
   // Read from cpu0 cpuinfo_min_freq
-  return readSysFsInt( "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_min_freq", -1 );
+  return readSysFsInt( ucc::sysfsPath( "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_min_freq" ), -1 );
 }
 
 static int32_t getCpuMaxFrequency()
 {
   // Read from cpu0 cpuinfo_max_freq
-  return readSysFsInt( "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", -1 );
+  return readSysFsInt( ucc::sysfsPath( "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq" ), -1 );
 }
 
 static int32_t optionalValueOr( const std::optional< int32_t > &value, int32_t fallback )
@@ -147,6 +116,68 @@ static int32_t optionalValueOr( const std::optional< int32_t > &value, int32_t f
   return value.has_value() ? value.value() : fallback;
 }
 
+// TDP limits in the capability profile: "min,max,descriptor" per TDP, joined by ';'
+static std::optional< std::string > encodeTDPLimits( const std::vector< TDPInfo > &tdps )
+{
+  std::string encoded;
+  for ( const TDPInfo &tdp : tdps )
+  {
+    if ( tdp.descriptor.find_first_of( ",;" ) != std::string::npos )
+      return std::nullopt;
+    if ( not encoded.empty() )
+      encoded += ';';
+    encoded += std::to_string( tdp.min ) + ',' + std::to_string( tdp.max ) + ',' + tdp.descriptor;
+  }
+  return encoded;
+}
+
+// ODM profile names never contain blanks: the platform_profile choices are blank-separated
+static std::string encodeODMProfiles( const std::vector< std::string > &profiles )
+{
+  std::string encoded;
+  for ( const std::string &profile : profiles )
+    encoded += ( encoded.empty() ? "" : " " ) + profile;
+  return encoded;
+}
+
+static std::vector< std::string > decodeODMProfiles( const std::string &encoded )
+{
+  std::vector< std::string > profiles;
+  std::istringstream names( encoded );
+  for ( std::string name; names >> name; )
+    profiles.push_back( name );
+  return profiles;
+}
+
+static std::string encodeFanLimits( size_t fans, int32_t minSpeed, bool offAvailable )
+{
+  return std::to_string( fans ) + ' ' + std::to_string( minSpeed ) + ( offAvailable ? " 1" : " 0" );
+}
+
+static std::optional< std::vector< TDPInfo > > decodeTDPLimits( const std::string &encoded )
+{
+  std::vector< TDPInfo > tdps;
+  std::istringstream entries( encoded );
+  for ( std::string entry; std::getline( entries, entry, ';' ); )
+  {
+    const auto first = entry.find( ',' );
+    const auto second = first == std::string::npos ? first : entry.find( ',', first + 1 );
+    if ( second == std::string::npos )
+      return std::nullopt;
+    try
+    {
+      tdps.push_back( TDPInfo{ static_cast< uint32_t >( std::stoul( entry.substr( 0, first ) ) ),
+                               static_cast< uint32_t >( std::stoul( entry.substr( first + 1, second - first - 1 ) ) ),
+                               0, entry.substr( second + 1 ) } );
+    }
+    catch ( const std::exception & )
+    {
+      return std::nullopt;
+    }
+  }
+  return tdps;
+}
+
 static std::string profileToJSON( const UccProfile &profile,
                                   int32_t defaultOnlineCores,
                                   int32_t defaultScalingMin,
@@ -172,8 +203,16 @@ static std::string profileToJSON( const UccProfile &profile,
       << "\"noTurbo\":" << ( profile.cpu.noTurbo ? "true" : "false" ) << ","
       << "\"onlineCores\":" << optionalValueOr( profile.cpu.onlineCores, defaultOnlineCores ) << ","
       << "\"scalingMinFrequency\":" << optionalValueOr( profile.cpu.scalingMinFrequency, defaultScalingMin ) << ","
-      << "\"scalingMaxFrequency\":" << optionalValueOr( profile.cpu.scalingMaxFrequency, defaultScalingMax )
-      << "},"
+      << "\"scalingMaxFrequency\":" << optionalValueOr( profile.cpu.scalingMaxFrequency, defaultScalingMax );
+  if ( profile.cpu.performanceCores != UccProfileCpuClass() )
+    oss << ",\"performanceCores\":" << ProfileManager::coreClassToJSON( profile.cpu.performanceCores );
+  if ( profile.cpu.efficiencyCores != UccProfileCpuClass() )
+    oss << ",\"efficiencyCores\":" << ProfileManager::coreClassToJSON( profile.cpu.efficiencyCores );
+  if ( not profile.cpu.coreParking.empty() )
+    oss << ",\"coreParking\":\"" << jsonEscape( profile.cpu.coreParking ) << "\"";
+  if ( not profile.cpu.adaptiveEpp.empty() )
+    oss << ",\"adaptiveEpp\":" << ProfileManager::stringsToJSON( profile.cpu.adaptiveEpp );
+  oss << "},"
       << "\"webcam\":{"
       << "\"status\":" << ( profile.webcam.status ? "true" : "false" ) << ","
       << "\"useStatus\":" << ( profile.webcam.useStatus ? "true" : "false" )
@@ -194,6 +233,8 @@ static std::string profileToJSON( const UccProfile &profile,
     oss << ",\"tablePump\":" << ProfileManager::fanTableToJSON( profile.fan.tablePump );
   if ( !profile.fan.tableWaterCoolerFan.empty() )
     oss << ",\"tableWaterCoolerFan\":" << ProfileManager::fanTableToJSON( profile.fan.tableWaterCoolerFan );
+  if ( profile.fan.controller != FanControllerSettings() )
+    oss << ",\"controller\":" << ProfileManager::controllerToJSON( profile.fan.controller );
 
   oss << "},"
       << "\"odmProfile\":{"
@@ -209,7 +250,10 @@ static std::string profileToJSON( const UccProfile &profile,
     oss << profile.odmPowerLimits.tdpValues[ i ];
   }
 
-  oss << "]}";
+  oss << "]";
+  if ( profile.odmPowerLimits.controller != PowerLimitControllerSettings() )
+    oss << ",\"controller\":" << ProfileManager::powerLimitControllerToJSON( profile.odmPowerLimits.controller );
+  oss << "}";
 
   // GPU OC profile reference and embedded data
   if ( !profile.gpuProfileId.empty() )
@@ -267,6 +311,33 @@ static std::string profileToJSON( const UccProfile &profile,
   return oss.str();
 }
 
+// Typed counterpart of profileToJSON(), with the same substitutions
+static QVariantMap profileToDBusWire( const UccProfile &profile,
+                                      int32_t defaultOnlineCores,
+                                      int32_t defaultScalingMin,
+                                      int32_t defaultScalingMax )
+{
+  UccProfile published = profile;
+  published.cpu.onlineCores = optionalValueOr( profile.cpu.onlineCores, defaultOnlineCores );
+  published.cpu.scalingMinFrequency = optionalValueOr( profile.cpu.scalingMinFrequency, defaultScalingMin );
+  published.cpu.scalingMaxFrequency = optionalValueOr( profile.cpu.scalingMaxFrequency, defaultScalingMax );
+  if ( published.keyboard.keyboardProfileId.empty() )
+    published.keyboard.keyboardProfileId = profile.keyboard.keyboardProfileName;
+  return profileToWire( published );
+}
+
+static QVariantList profilesToDBusWire( const std::vector< UccProfile > &profiles,
+                                        int32_t defaultOnlineCores,
+                                        int32_t defaultScalingMin,
+                                        int32_t defaultScalingMax )
+{
+  QVariantList list;
+  list.reserve( static_cast< qsizetype >( profiles.size() ) );
+  for ( const auto &profile : profiles )
+    list.append( profileToDBusWire( profile, defaultOnlineCores, defaultScalingMin, defaultScalingMax ) );
+  return list;
+}
+
 
 static std::string buildSettingsJSON( const std::string &keyboardBacklightStatesJSON,
                                       const std::string &chargingProfile,
@@ -287,11 +358,35 @@ static std::string buildSettingsJSON( const std::string &keyboardBacklightStates
     oss << "\"" << jsonEscape( key ) << "\":\"" << jsonEscape( value ) << "\"";
   }
 
-  oss << "},"
+  oss << "},\"workloadRules\":[";
+  for ( size_t i = 0; i < settings.workloadRules.size(); ++i )
+  {
+    const WorkloadRule &rule = settings.workloadRules[ i ];
+    oss << ( i > 0 ? "," : "" ) << "{\"exe\":\"" << jsonEscape( rule.exe ) << "\",\"cgroup\":\""
+        << jsonEscape( rule.cgroup ) << "\",\"profile\":\"" << jsonEscape( rule.profileId ) << "\"}";
+  }
+
+  oss << "],\"alertRules\":[";
+  for ( size_t i = 0; i < settings.alertRules.size(); ++i )
+  {
+    const AlertRule &rule = settings.alertRules[ i ];
+    oss << ( i > 0 ? "," : "" ) << "{\"id\":\"" << jsonEscape( rule.id ) << "\",\"metric\":\""
+        << jsonEscape( rule.metric ) << "\",\"condition\":\"" << jsonEscape( rule.condition )
+        << "\",\"threshold\":" << rule.threshold << ",\"forSeconds\":" << rule.forSeconds
+        << ",\"hysteresis\":" << rule.hysteresis << "}";
+  }
+
+  oss << "],"
       << "\"shutdownTime\":" << ( settings.shutdownTime.has_value() ? "\"" + jsonEscape( *settings.shutdownTime ) + "\"" : "null" ) << ","
       << "\"cpuSettingsEnabled\":" << ( settings.cpuSettingsEnabled ? "true" : "false" ) << ","
       << "\"fanControlEnabled\":" << ( settings.fanControlEnabled ? "true" : "false" ) << ","
+      << "\"fanControlFastLoop\":" << ( settings.fanControlFastLoop ? "true" : "false" ) << ","
+      << "\"fanControlRealtime\":" << ( settings.fanControlRealtime ? "true" : "false" ) << ","
+      << "\"displayBrightnessRampMs\":" << settings.displayBrightnessRampMs << ","
+      << "\"displayRefreshSaver\":" << ( settings.displayRefreshSaver ? "true" : "false" ) << ","
       << "\"keyboardBacklightControlEnabled\":" << ( settings.keyboardBacklightControlEnabled ? "true" : "false" ) << ","
+      << "\"keyboardIdleTimeoutAcS\":" << settings.keyboardIdleTimeoutAcS << ","
+      << "\"keyboardIdleTimeoutBatS\":" << settings.keyboardIdleTimeoutBatS << ","
       << "\"ycbcr420Workaround\":[],"
       << "\"chargingProfile\":\"" << jsonEscape( chargingProfile ) << "\" ,"
       << "\"chargingPriority\":" << ( settings.chargingPriority.has_value() ? "\"" + jsonEscape( *settings.chargingPriority ) + "\"" : "null" ) << ","
@@ -308,34 +403,96 @@ UccDBusInterfaceAdaptor::UccDBusInterfaceAdaptor( QObject *parent,
   : QDBusAbstractAdaptor( parent ),
     m_data( data ),
     m_service( service ),
-    m_lastDataCollectionAccess( std::chrono::steady_clock::now() )
+    m_lastDataCollectionAccess( std::chrono::steady_clock::now() ),
+    m_sampleWatcher( QString(), QDBusConnection::systemBus(),
+                     QDBusServiceWatcher::WatchForUnregistration ),
+    m_ipcStats( std::chrono::duration_cast< std::chrono::milliseconds >(
+      m_lastDataCollectionAccess.load().time_since_epoch() ).count() )
 {
   // Qt's MOC handles introspection and method dispatch automatically
   // via Q_CLASSINFO and public slots declarations
   setAutoRelaySignals( true );
+  ucc::registerProfileWireTypes();
+
+  // Drop MetricsSample / fast-sampling subscribers that leave the bus without
+  // unsubscribing, and the Polkit grants of every caller that leaves
+  connect( &m_sampleWatcher, &QDBusServiceWatcher::serviceUnregistered,
+           this, [this]( const QString &service ) {
+             m_authCache.forgetSender( service.toStdString() );
+             removeMetricsSampleSubscriber( service );
+             removeFastSamplingClient( service );
+             removeSensorSubscriber( service );
+             if ( m_peerServer )
+               m_peerServer->dropSender( service );
+             unwatchIfUnused( service );
+           } );
   syslog( LOG_INFO, "UccDBusInterfaceAdaptor: registered interface %s", UccDBusInterfaceAdaptor::INTERFACE_NAME );
 }
 
 bool UccDBusInterfaceAdaptor::checkAuth( const char *actionId ) noexcept
 {
+  // ApplyTransaction asks once per action up front
+  if ( std::ranges::find( m_transactionActions, std::string_view( actionId ) ) != m_transactionActions.end() )
+    return true;
+
+  if ( m_peerCaller )
+  {
+    const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+    return m_authCache.allowed( m_peerCaller->sender.toStdString(),
+                                PolkitAuthority::processStartTime( m_peerCaller->pid ), actionId, nowMs );
+  }
+
   auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
   if ( not dbusObj )
   {
     syslog( LOG_ERR, "PolkitAuth: parent is not UccDBusObject" );
     return false;
   }
-  const QString methodName = dbusObj->message().member();
-  std::cerr << "[PolkitAuth] method='" << methodName.toStdString()
-            << "' action='" << actionId << "'\n";
-  return PolkitAuthority::checkAuthorization(
-      dbusObj->connection(), dbusObj->message(), actionId );
+
+  try
+  {
+    // Slider drags send many calls per second; only the first of each
+    // sender and action within AuthDecisionCache::TTL_MS asks Polkit
+    const QDBusMessage &message = dbusObj->message();
+    const QString service = message.service();
+    const std::string sender = service.toStdString();
+
+    auto pid = m_authCache.pid( sender );
+    if ( not pid )
+    {
+      pid = PolkitAuthority::callerPid( dbusObj->connection(), message );
+      if ( not pid )
+        return false;
+      m_authCache.setPid( sender, *pid );
+      m_sampleWatcher.addWatchedService( service );
+    }
+
+    const uint64_t startTime = PolkitAuthority::processStartTime( *pid );
+    const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+    if ( m_authCache.allowed( sender, startTime, actionId, nowMs ) )
+      return true;
+
+    std::cerr << "[PolkitAuth] method='" << message.member().toStdString()
+              << "' action='" << actionId << "'\n";
+    if ( not PolkitAuthority::checkAuthorization( dbusObj->connection(), *pid, startTime, actionId ) )
+      return false;
+
+    m_authCache.grant( sender, startTime, actionId, nowMs );
+    return true;
+  }
+  catch ( const std::exception &e )
+  {
+    syslog( LOG_ERR, "PolkitAuth: %s", e.what() );
+    return false;
+  }
 }
 
 
 void UccDBusInterfaceAdaptor::resetDataCollectionTimeout()
 {
-  // Note: caller must hold m_data.dataMutex lock (for m_lastDataCollectionAccess)
-  m_lastDataCollectionAccess = std::chrono::steady_clock::now();
+  m_lastDataCollectionAccess.store( std::chrono::steady_clock::now() );
   m_data.sensorDataCollectionStatus = true;
 }
 
@@ -363,14 +520,12 @@ UccDBusInterfaceAdaptor::exportFanData( const FanData &fanData )
 
 QString UccDBusInterfaceAdaptor::GetDeviceName()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.device );
+  return QString::fromStdString( m_data.device.load()->device );
 }
 
 QString UccDBusInterfaceAdaptor::GetSystemInfoJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.systemInfoJSON );
+  return QString::fromStdString( m_data.device.load()->systemInfoJSON );
 }
 
 bool UccDBusInterfaceAdaptor::IsDeviceSupported()
@@ -380,8 +535,7 @@ bool UccDBusInterfaceAdaptor::IsDeviceSupported()
 
 QString UccDBusInterfaceAdaptor::GetDisplayModesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.displayModes );
+  return QString::fromStdString( m_data.device.load()->displayModes );
 }
 
 bool UccDBusInterfaceAdaptor::GetIsX11()
@@ -401,8 +555,7 @@ bool UccDBusInterfaceAdaptor::FanHwmonAvailable()
 
 QString UccDBusInterfaceAdaptor::UccdVersion()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.uccdVersion );
+  return QString::fromStdString( m_data.device.load()->uccdVersion );
 }
 
 // fan data methods
@@ -410,9 +563,9 @@ QString UccDBusInterfaceAdaptor::UccdVersion()
 QVariantMap
 UccDBusInterfaceAdaptor::GetFanDataCPU()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  if ( m_data.fans.size() > 0 )
-    return exportFanData( m_data.fans[ 0 ] );
+  const auto fans = m_data.fans.load();
+  if ( fans->size() > 0 )
+    return exportFanData( ( *fans )[ 0 ] );
 
   return {};
 }
@@ -420,9 +573,9 @@ UccDBusInterfaceAdaptor::GetFanDataCPU()
 QVariantMap
 UccDBusInterfaceAdaptor::GetFanDataGPU1()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  if ( m_data.fans.size() > 1 )
-    return exportFanData( m_data.fans[ 1 ] );
+  const auto fans = m_data.fans.load();
+  if ( fans->size() > 1 )
+    return exportFanData( ( *fans )[ 1 ] );
 
   return {};
 }
@@ -430,9 +583,9 @@ UccDBusInterfaceAdaptor::GetFanDataGPU1()
 QVariantMap
 UccDBusInterfaceAdaptor::GetFanDataGPU2()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  if ( m_data.fans.size() > 2 )
-    return exportFanData( m_data.fans[ 2 ] );
+  const auto fans = m_data.fans.load();
+  if ( fans->size() > 2 )
+    return exportFanData( ( *fans )[ 2 ] );
 
   return {};
 }
@@ -490,6 +643,7 @@ bool UccDBusInterfaceAdaptor::SetDisplayBrightness( int brightness )
 
     // update autosave
     m_service->m_autosave.displayBrightness = brightness;
+    m_service->persistAutosave();
 
     // try to apply immediately via DisplayWorker if available
     if ( m_service->m_displayWorker )
@@ -505,33 +659,115 @@ bool UccDBusInterfaceAdaptor::SetDisplayBrightness( int brightness )
 
 // gpu information methods
 
+QVariantMap UccDBusInterfaceAdaptor::GetLiveSnapshot()
+{
+  QVariantMap snapshot;
+  const auto putInt = [&snapshot]( const char *key, double value ) {
+    if ( value >= 0.0 )
+      snapshot.insert( QLatin1String( key ), static_cast< int >( std::lround( value ) ) );
+  };
+  const auto putDouble = [&snapshot]( const char *key, double value ) {
+    if ( value >= 0.0 )
+      snapshot.insert( QLatin1String( key ), value );
+  };
+  const auto fanValue = []( const TimeData< int32_t > &data ) {
+    return data.timestamp != 0 ? static_cast< double >( data.data ) : -1.0;
+  };
+
+  {
+    resetDataCollectionTimeout();
+
+    const auto gpu = m_data.gpu.load();
+    const auto fans = m_data.fans.load();
+    const DGpuInfo &dGpu = gpu->dGpuInfo;
+    const IGpuInfo &iGpu = gpu->iGpuInfo;
+
+    if ( !fans->empty() )
+    {
+      putInt( "cpuTemp", fanValue( ( *fans )[ 0 ].temp ) );
+      putInt( "cpuFanPercent", fanValue( ( *fans )[ 0 ].speed ) );
+    }
+    // GPU fans: mean of the ones that report
+    double gpuFanSum = 0.0;
+    int gpuFans = 0;
+    for ( size_t i = 1; i < fans->size() && i < 3; ++i )
+    {
+      const double speed = fanValue( ( *fans )[ i ].speed );
+      if ( speed >= 0.0 )
+      {
+        gpuFanSum += speed;
+        ++gpuFans;
+      }
+    }
+    if ( gpuFans > 0 )
+      snapshot.insert( QStringLiteral( "gpuFanPercent" ), static_cast< int >( gpuFanSum / gpuFans ) );
+
+    putInt( "gpuTemp", dGpu.m_temp >= 0.0 ? dGpu.m_temp : iGpu.m_temp );
+    putInt( "iGpuTemp", iGpu.m_temp );
+    putInt( "gpuFrequencyMHz", dGpu.m_coreFrequency );
+    putInt( "iGpuFrequencyMHz", iGpu.m_coreFrequency );
+    putDouble( "cpuPowerW", m_data.cpu.load()->cpuPowerDraw );
+    putDouble( "gpuPowerW", dGpu.m_powerDraw >= 0.0 ? dGpu.m_powerDraw : iGpu.m_powerDraw );
+    putDouble( "iGpuPowerW", iGpu.m_powerDraw );
+
+    putInt( "dGpuComputeUtilPct", dGpu.m_computeUtilPct );
+    putInt( "dGpuMemoryUtilPct", dGpu.m_memoryUtilPct );
+    putInt( "dGpuVramUsedMiB", dGpu.m_vramUsedMiB );
+    putInt( "dGpuVramTotalMiB", dGpu.m_vramTotalMiB );
+    putInt( "dGpuEncoderUtilPct", dGpu.m_encoderUtilPct );
+    putInt( "dGpuDecoderUtilPct", dGpu.m_decoderUtilPct );
+    putInt( "dGpuCurrentPstate", dGpu.m_currentPstate );
+    putInt( "dGpuVramFrequencyMHz", dGpu.m_vramFrequency );
+    putInt( "dGpuCoreVoltageMv", dGpu.m_coreVoltageMv );
+    if ( dGpu.m_grClockOffsetMHz != INT_MIN )
+      snapshot.insert( QStringLiteral( "dGpuGrClockOffsetMHz" ), dGpu.m_grClockOffsetMHz );
+    if ( dGpu.m_memClockOffsetMHz != INT_MIN )
+      snapshot.insert( QStringLiteral( "dGpuMemClockOffsetMHz" ), dGpu.m_memClockOffsetMHz );
+    if ( !dGpu.m_perfLimitReason.empty() )
+      snapshot.insert( QStringLiteral( "dGpuPerfLimitReason" ), QString::fromStdString( dGpu.m_perfLimitReason ) );
+  }
+
+  putInt( "cpuFrequencyMHz", static_cast< double >( m_data.cpuFrequencyMHz.load() ) );
+  if ( m_service && m_service->waterCooler() )
+  {
+    putInt( "waterCoolerFanSpeed", static_cast< double >( m_service->waterCooler()->getLastFanSpeed() ) );
+    putInt( "waterCoolerPumpLevel", static_cast< double >( m_service->waterCooler()->getLastPumpVoltage() ) );
+  }
+  snapshot.insert( QStringLiteral( "timestampMs" ),
+                   static_cast< qlonglong >( std::chrono::duration_cast< std::chrono::milliseconds >(
+                     std::chrono::system_clock::now().time_since_epoch() ).count() ) );
+  return snapshot;
+}
+
 QString UccDBusInterfaceAdaptor::GetDGpuInfoValuesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
   resetDataCollectionTimeout();
-  return QString::fromStdString( m_data.dGpuInfoValuesJSON );
+  return QString::fromStdString( m_data.gpu.load()->dGpuInfoValuesJSON );
+}
+
+QString UccDBusInterfaceAdaptor::GetDGpuInfoListJSON()
+{
+  resetDataCollectionTimeout();
+  return QString::fromStdString( m_data.gpu.load()->dGpuInfoListJSON );
 }
 
 QString UccDBusInterfaceAdaptor::GetIGpuInfoValuesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
   resetDataCollectionTimeout();
-  return QString::fromStdString( m_data.iGpuInfoValuesJSON );
+  return QString::fromStdString( m_data.gpu.load()->iGpuInfoValuesJSON );
 }
 
 QString UccDBusInterfaceAdaptor::GetCpuPowerValuesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
   resetDataCollectionTimeout();
-  return QString::fromStdString( m_data.cpuPowerValuesJSON );
+  return QString::fromStdString( m_data.cpu.load()->cpuPowerValuesJSON );
 }
 
 // graphics methods
 
 QString UccDBusInterfaceAdaptor::GetPrimeState()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.primeState );
+  return QString::fromStdString( m_data.gpu.load()->primeState );
 }
 
 bool UccDBusInterfaceAdaptor::ConsumeModeReapplyPending()
@@ -543,8 +779,7 @@ bool UccDBusInterfaceAdaptor::ConsumeModeReapplyPending()
 
 QString UccDBusInterfaceAdaptor::GetActiveProfileJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.activeProfileJSON );
+  return QString::fromStdString( m_data.profiles.load()->activeProfileJSON.current() );
 }
 
 bool UccDBusInterfaceAdaptor::SetFanProfileCPU( const QString &pointsJSON )
@@ -565,12 +800,7 @@ bool UccDBusInterfaceAdaptor::SetFanProfileCPU( const QString &pointsJSON )
 
     UccProfile profile = m_service->getCurrentProfile();
     std::cerr << "[DBus] Current profile ID: " << profile.id << std::endl;
-    auto custom = m_service->getCustomProfiles();
-    bool editable = false;
-    for ( const auto &p : custom )
-    {
-      if ( p.id == profile.id ) { editable = true; break; }
-    }
+    const bool editable = m_service->m_customProfiles.contains( profile.id );
     std::cerr << "[DBus] Profile editable: " << editable << std::endl;
     if ( !editable )
       return false;
@@ -579,6 +809,7 @@ bool UccDBusInterfaceAdaptor::SetFanProfileCPU( const QString &pointsJSON )
     if ( m_service->m_fanControlWorker )
     {
       m_service->m_fanControlWorker->applyTemporaryFanCurves( table, {} );
+      m_service->m_staleSubsystems |= ProfileSubsystem::Fan;
       return true;
     }
     return false;
@@ -607,12 +838,7 @@ bool UccDBusInterfaceAdaptor::SetFanProfileDGPU( const QString &pointsJSON )
 
     UccProfile profile = m_service->getCurrentProfile();
     std::cerr << "[DBus] Current profile ID: " << profile.id << std::endl;
-    auto custom = m_service->getCustomProfiles();
-    bool editable = false;
-    for ( const auto &p : custom )
-    {
-      if ( p.id == profile.id ) { editable = true; break; }
-    }
+    const bool editable = m_service->m_customProfiles.contains( profile.id );
     std::cerr << "[DBus] Profile editable: " << editable << std::endl;
     if ( !editable )
       return false;
@@ -621,6 +847,7 @@ bool UccDBusInterfaceAdaptor::SetFanProfileDGPU( const QString &pointsJSON )
     if ( m_service->m_fanControlWorker )
     {
       m_service->m_fanControlWorker->applyTemporaryFanCurves( {}, table );
+      m_service->m_staleSubsystems |= ProfileSubsystem::Fan;
       return true;
     }
     return false;
@@ -676,6 +903,7 @@ bool UccDBusInterfaceAdaptor::ApplyFanProfiles( const QString &fanProfilesJSONq
     if ( m_service->m_fanControlWorker )
     {
       m_service->m_fanControlWorker->applyTemporaryFanCurves( cpuTable, gpuTable, waterCoolerFanTable, pumpTable );
+      m_service->m_staleSubsystems |= ProfileSubsystem::Fan;
       std::cerr << "[DBus] Applied temporary fan profiles" << std::endl;
     }
 
@@ -743,8 +971,13 @@ bool UccDBusInterfaceAdaptor::RevertFanProfiles()
 bool UccDBusInterfaceAdaptor::SetTempProfile( const QString &profileName )
 {
   if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  m_data.tempProfileName = profileName.toStdString();
+  {
+    std::lock_guard< std::mutex > lock( m_data.tempProfileMutex );
+    m_data.tempProfileName = profileName.toStdString();
+  }
+  // applied by the service tick, which may be stretched while idle
+  if ( m_service )
+    m_service->wake();
   return true;
 }
 
@@ -762,26 +995,43 @@ bool UccDBusInterfaceAdaptor::ApplyProfile( const QString &profileJSON )
   return m_service->applyProfileJSON( profileJSON.toStdString() );
 }
 
+bool UccDBusInterfaceAdaptor::ApplyProfileData( const QVariantMap &profile )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
+  return m_service->applyProfile( profileFromWire( ucc::plainDBusValue( profile ).toMap() ) );
+}
+
+QVariantMap UccDBusInterfaceAdaptor::GetActiveProfile()
+{
+  return m_data.profiles.load()->activeProfileWire;
+}
+
+QVariantList UccDBusInterfaceAdaptor::GetDefaultProfiles()
+{
+  return m_data.profiles.load()->defaultProfilesWire;
+}
+
+QVariantList UccDBusInterfaceAdaptor::GetCustomProfiles()
+{
+  // like GetCustomProfilesJSON: custom profiles live in the GUI's settings
+  return {};
+}
+
 
 
 QString UccDBusInterfaceAdaptor::GetProfilesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.profilesJSON );
+  return QString::fromStdString( m_data.profiles.load()->profilesJSON.current() );
 }
 
 QString UccDBusInterfaceAdaptor::GetCustomProfilesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  //std::cout << "[DBus] GetCustomProfilesJSON called, returning "
-  //          << m_data.customProfilesJSON.length() << " bytes" << std::endl;
-  return QString::fromStdString( m_data.customProfilesJSON );
+  return QString::fromStdString( m_data.profiles.load()->customProfilesJSON.current() );
 }
 
 QString UccDBusInterfaceAdaptor::GetDefaultProfilesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.defaultProfilesJSON );
+  return QString::fromStdString( m_data.profiles.load()->defaultProfilesJSON.current() );
 }
 
 QString UccDBusInterfaceAdaptor::GetCpuFrequencyLimitsJSON()
@@ -796,8 +1046,7 @@ QString UccDBusInterfaceAdaptor::GetCpuFrequencyLimitsJSON()
 
 QString UccDBusInterfaceAdaptor::GetDefaultValuesProfileJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.defaultValuesProfileJSON );
+  return QString::fromStdString( m_data.profiles.load()->defaultValuesProfileJSON );
 }
 
 bool UccDBusInterfaceAdaptor::AddCustomProfile( const QString &profileJSON )
@@ -930,6 +1179,203 @@ bool UccDBusInterfaceAdaptor::UpdateCustomProfile( const QString &profileJSON )
   }
 }
 
+bool UccDBusInterfaceAdaptor::PatchProfile( const QString &id, const QString &patchJSON )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service )
+    return false;
+  return m_service->patchProfile( id.toStdString(), patchJSON.toStdString() );
+}
+
+namespace
+{
+/// Polkit action an ApplyTransaction operation needs (that of the method it
+/// stands for), or nullptr when the operation is unknown or malformed
+const char *transactionAction( const QString &op, const QJsonObject &args )
+{
+  if ( op == "saveCustomProfile" || op == "applyProfile" )
+    return args.value( "profile" ).isObject() ? PolkitAuthority::ACTION_MANAGE_HARDWARE : nullptr;
+  if ( op == "setActiveProfile" )
+    return !args.value( "id" ).toString().isEmpty() ? PolkitAuthority::ACTION_CONTROL : nullptr;
+  if ( op == "patchProfile" )
+    return !args.value( "id" ).toString().isEmpty() && args.value( "patch" ).isObject()
+             ? PolkitAuthority::ACTION_CONTROL : nullptr;
+  if ( op == "setStateMap" )
+    return args.value( "stateMap" ).isObject() ? PolkitAuthority::ACTION_MANAGE_HARDWARE : nullptr;
+  if ( op == "applyFanProfiles" )
+    return args.value( "fanProfiles" ).isObject() ? PolkitAuthority::ACTION_MANAGE_HARDWARE : nullptr;
+  if ( op == "setKeyboardStates" )
+    return args.value( "states" ).isObject() ? PolkitAuthority::ACTION_CONTROL : nullptr;
+  if ( op == "applyGpuOC" )
+    return args.value( "profile" ).isObject() ? PolkitAuthority::ACTION_CONTROL : nullptr;
+  return nullptr;
+}
+
+QString compactJson( const QJsonValue &value )
+{
+  return QString::fromUtf8( QJsonDocument( value.toObject() ).toJson( QJsonDocument::Compact ) );
+}
+}
+
+bool UccDBusInterfaceAdaptor::ApplyTransaction( const QString &operationsJSON )
+{
+  if ( !m_service )
+    return false;
+
+  const QJsonDocument doc = QJsonDocument::fromJson( operationsJSON.toUtf8() );
+  if ( !doc.isArray() )
+  {
+    std::cerr << "[DBus] ApplyTransaction: expected a JSON array of operations" << std::endl;
+    return false;
+  }
+
+  // Validate all operations and authorize each distinct action once, before
+  // anything is touched
+  std::vector< QJsonObject > operations;
+  std::vector< std::string > actions;
+  for ( const auto &value : doc.array() )
+  {
+    const QJsonObject operation = value.toObject();
+    const QString op = operation.value( "op" ).toString();
+    const char *action = transactionAction( op, operation );
+    if ( !action )
+    {
+      std::cerr << "[DBus] ApplyTransaction: invalid operation '" << op.toStdString() << "'" << std::endl;
+      return false;
+    }
+    if ( std::ranges::find( actions, std::string_view( action ) ) == actions.end() )
+      actions.emplace_back( action );
+    operations.push_back( operation );
+  }
+  for ( const auto &action : actions )
+  {
+    if ( !checkAuth( action.c_str() ) )
+      return false;
+  }
+
+  m_transactionActions = std::move( actions );
+  m_service->m_deferProfileApply = true;
+  auto restore = qScopeGuard( [this]() {
+    m_transactionActions.clear();
+    m_service->m_deferProfileApply = false;
+    m_service->m_deferredProfile.reset();
+  } );
+
+  // First pass: stored state (profiles, stateMap) and the profile to end up
+  // with; hardware-facing overrides wait for the second pass
+  bool ok = true;
+  std::optional< UccProfile > target;
+  bool stateMapChanged = false;
+  uint32_t overridden = 0;
+  try
+  {
+    for ( const auto &operation : operations )
+    {
+      const QString op = operation.value( "op" ).toString();
+      if ( op == "saveCustomProfile" )
+      {
+        const QString json = compactJson( operation.value( "profile" ) );
+        ok = saveCustomProfile( ProfileManager::parseProfileJSON( json.toStdString() ) ) && ok;
+      }
+      else if ( op == "applyProfile" )
+      {
+        const QString json = compactJson( operation.value( "profile" ) );
+        target = ProfileManager::parseProfileJSON( json.toStdString() );
+      }
+      else if ( op == "setActiveProfile" )
+      {
+        const std::string id = operation.value( "id" ).toString().toStdString();
+        if ( auto profile = m_service->resolveProfile( id ) )
+          target = std::move( profile );
+        else
+          ok = false;
+      }
+      else if ( op == "patchProfile" )
+      {
+        const std::string id = operation.value( "id" ).toString().toStdString();
+        const std::string patch = compactJson( operation.value( "patch" ) ).toStdString();
+        if ( target && target->id == id )
+        {
+          if ( auto patched = mergePatchProfile( *target, patch ) )
+            target = std::move( patched );
+          else
+            ok = false;
+        }
+        else
+          ok = m_service->patchProfile( id, patch ) && ok;
+      }
+      else if ( op == "setStateMap" )
+      {
+        if ( mergeStateMap( operation.value( "stateMap" ).toObject() ) )
+          stateMapChanged = true;
+        else
+          ok = false;
+      }
+      else if ( op == "applyFanProfiles" )
+        overridden |= ProfileSubsystem::Fan;
+      else if ( op == "setKeyboardStates" )
+        overridden |= ProfileSubsystem::Keyboard;
+      else if ( op == "applyGpuOC" )
+        overridden |= ProfileSubsystem::GpuOC;
+
+      // a saved or patched active profile is applied below, unless the
+      // transaction switches to another one
+      if ( auto &deferred = m_service->m_deferredProfile )
+      {
+        if ( !target || target->id == deferred->id )
+          target = std::move( *deferred );
+        deferred.reset();
+      }
+    }
+  }
+  catch ( const std::exception &e )
+  {
+    std::cerr << "[DBus] ApplyTransaction: " << e.what() << std::endl;
+    return false;
+  }
+
+  uint32_t skip = overridden;
+  if ( stateMapChanged )
+  {
+    m_service->persistSettings();
+    m_service->updateDBusSettingsData();
+
+    // the current state got another profile: take it like a power-state switch
+    const std::string stateKey = profileStateToString( m_service->m_currentState );
+    if ( auto it = m_service->m_settings.stateMap.find( stateKey );
+         !target && it != m_service->m_settings.stateMap.end() && it->second != m_service->m_activeProfile.id )
+    {
+      m_service->m_currentStateProfileId = it->second;
+      target = m_service->resolveProfile( it->second );
+      skip |= ProfileSubsystem::Charging;
+    }
+  }
+
+  // Second pass: apply the merged profile once, then the overrides on top
+  if ( target )
+  {
+    if ( target->id != m_service->m_activeProfile.id )
+      m_service->m_metricsStore.recordEvent( ucc::MetricEventKind::ProfileSwitch, 0,
+                                             target->name.empty() ? target->id : target->name );
+    m_service->activateProfile( *target, skip );
+  }
+  for ( const auto &operation : operations )
+  {
+    const QString op = operation.value( "op" ).toString();
+    if ( op == "applyFanProfiles" )
+      ok = ApplyFanProfiles( compactJson( operation.value( "fanProfiles" ) ) ) && ok;
+    else if ( op == "setKeyboardStates" )
+      ok = SetKeyboardBacklightStatesJSON( compactJson( operation.value( "states" ) ) ) && ok;
+    else if ( op == "applyGpuOC" )
+      ok = ApplyNvidiaGpuOCProfile( compactJson( operation.value( "profile" ) ),
+                                    operation.value( "deviceIndex" ).toInt( 0 ) ) && ok;
+  }
+
+  std::cout << "[DBus] ApplyTransaction: " << operations.size() << " operations, "
+            << ( ok ? "all applied" : "some failed" ) << std::endl;
+  return ok;
+}
+
 bool UccDBusInterfaceAdaptor::SaveCustomProfile( const QString &profileJSON )
 {
   if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
@@ -945,9 +1391,31 @@ bool UccDBusInterfaceAdaptor::SaveCustomProfile( const QString &profileJSON )
     std::cout << "[Profile] Received SaveCustomProfile JSON (first 200 chars): "
               << jsonStr.substr(0, 200) << "..." << std::endl;
 
-    // Parse the profile JSON
-    auto profile = ProfileManager::parseProfileJSON( jsonStr );
+    return saveCustomProfile( ProfileManager::parseProfileJSON( jsonStr ) );
+  }
+  catch ( const std::exception &e )
+  {
+    std::cerr << "[Profile] Exception in SaveCustomProfile: " << e.what() << std::endl;
+    return false;
+  }
+}
+
+bool UccDBusInterfaceAdaptor::SaveCustomProfileData( const QVariantMap &profile )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
+  if ( !m_service )
+  {
+    std::cerr << "[Profile] SaveCustomProfileData called but service not available" << std::endl;
+    return false;
+  }
+
+  return saveCustomProfile( profileFromWire( ucc::plainDBusValue( profile ).toMap() ) );
+}
 
+bool UccDBusInterfaceAdaptor::saveCustomProfile( UccProfile profile )
+{
+  try
+  {
     // Check if name collides with a built-in profile
     for ( const auto &builtIn : m_service->m_defaultProfiles )
     {
@@ -959,36 +1427,16 @@ bool UccDBusInterfaceAdaptor::SaveCustomProfile( const QString &profileJSON )
       }
     }
 
-    // Check if a profile with the same name already exists in memory
-    auto existingProfileIt = std::ranges::find_if( m_service->m_customProfiles,
-                                          [&profile]( const UccProfile &p ) { return p.name == profile.name; } );
-
-    // Also check settings for profiles with the same name (in case parsing failed on load)
-    std::string existingIdFromSettings;
-    for ( const auto &[profileId, profileJson] : m_service->m_settings.profiles )
-    {
-      try
-      {
-        auto parsedProfile = ProfileManager::parseProfileJSON( profileJson );
-        if ( parsedProfile.name == profile.name )
-        {
-          existingIdFromSettings = profileId;
-          break;
-        }
-      }
-      catch ( const std::exception &e )
-      {
-        // Skip malformed entries
-        continue;
-      }
-    }
+    // Check if a profile with the same name already exists; the repository
+    // holds every profile of the settings that parsed
+    const auto existing = m_service->m_customProfiles.findByName( profile.name );
 
     bool result;
-    if ( existingProfileIt != m_service->m_customProfiles.end() )
+    if ( existing )
     {
-      // Profile with same name exists in memory
+      // Profile with same name exists
       // Check if they have the SAME ID (genuine update) or DIFFERENT ID (name collision)
-      if ( profile.id == existingProfileIt->id )
+      if ( profile.id == existing->id )
       {
         // Same profile, update it
         std::cout << "[Profile] SaveCustomProfile: updating existing profile '" << profile.name << "' (id: " << profile.id << ")" << std::endl;
@@ -998,45 +1446,18 @@ bool UccDBusInterfaceAdaptor::SaveCustomProfile( const QString &profileJSON )
       {
         // Different ID but same name - GUI sent a new profile with same name
         // Respect the GUI's ID, don't overwrite it with the old one
-        std::cout << "[Profile] SaveCustomProfile: received profile with new ID '" << profile.id << "' but same name as existing profile (id: " << existingProfileIt->id << ")" << std::endl;
+        std::cout << "[Profile] SaveCustomProfile: received profile with new ID '" << profile.id << "' but same name as existing profile (id: " << existing->id << ")" << std::endl;
         std::cout << "[Profile] Treating as NEW profile since IDs differ" << std::endl;
         result = m_service->addCustomProfile( profile );
       }
       else
       {
         // Received profile has no ID but same name exists - assign old ID
-        profile.id = existingProfileIt->id;
+        profile.id = existing->id;
         std::cout << "[Profile] SaveCustomProfile: received profile with no ID, using existing ID '" << profile.id << "'" << std::endl;
         result = m_service->updateCustomProfile( profile );
       }
     }
-    else if ( !existingIdFromSettings.empty() )
-    {
-      // Profile with same name exists in settings but not in memory
-      // Check if ID matches
-      if ( profile.id == existingIdFromSettings )
-      {
-        // Same profile, reuse the ID
-        std::cout << "[Profile] SaveCustomProfile: updating existing profile '" << profile.name << "' from settings (id: " << profile.id << ")" << std::endl;
-        m_service->m_customProfiles.push_back( profile );
-        result = true;
-      }
-      else if ( !profile.id.empty() )
-      {
-        // Different ID but same name - treat as new profile
-        std::cout << "[Profile] SaveCustomProfile: received profile with new ID '" << profile.id << "' but same name in settings (id: " << existingIdFromSettings << ")" << std::endl;
-        std::cout << "[Profile] Treating as NEW profile since IDs differ" << std::endl;
-        result = m_service->addCustomProfile( profile );
-      }
-      else
-      {
-        // No ID provided, use the one from settings
-        profile.id = existingIdFromSettings;
-        std::cout << "[Profile] SaveCustomProfile: received profile with no ID, using existing ID from settings '" << profile.id << "'" << std::endl;
-        m_service->m_customProfiles.push_back( profile );
-        result = true;
-      }
-    }
     else
     {
       // No profile with this name exists, add as new
@@ -1061,69 +1482,23 @@ bool UccDBusInterfaceAdaptor::SaveCustomProfile( const QString &profileJSON )
       }
     }
 
-    // Store the profile in settings for persistence using the corrected ID
-    std::string storedJSON = ProfileManager::profileToJSON( profile );
-    m_service->m_settings.profiles[profile.id] = storedJSON;
+    // Store the profile in settings for persistence using the corrected ID;
+    // this is the only place it is serialized
+    m_service->m_settings.profiles[profile.id] = ProfileManager::profileToJSON( profile );
 
-    // Clean up old profile entries with same name but different ID
+    // Clean up old profiles with same name but different ID
     // This prevents accumulating duplicate profiles in settings
-    std::vector<std::string> keysToDelete;
-    for ( const auto &[mapKey, mapJson] : m_service->m_settings.profiles )
-    {
-      if ( mapKey != profile.id )  // Different key
-      {
-        try
-        {
-          auto parsedProfile = ProfileManager::parseProfileJSON( mapJson );
-          if ( parsedProfile.name == profile.name )  // Same name
-          {
-            std::cout << "[Settings] Removing old profile entry with key '" << mapKey << "' (name: " << parsedProfile.name << ", same name as new id: " << profile.id << ")" << std::endl;
-            keysToDelete.push_back( mapKey );
-          }
-        }
-        catch ( const std::exception &e )
-        {
-          // Ignore parse errors
-          continue;
-        }
-      }
-    }
-
-    // Delete the old entries
-    for ( const auto &keyToDelete : keysToDelete )
-    {
-      m_service->m_settings.profiles.erase( keyToDelete );
-    }
+    m_service->m_customProfiles.eraseIf( [this, &profile]( const UccProfile &old ) {
+      if ( old.name != profile.name || old.id == profile.id )
+        return false;
+      std::cout << "[Settings] Removing old profile with id '" << old.id << "' (name: " << old.name
+                << ", same name as new id: " << profile.id << ")" << std::endl;
+      m_service->m_settings.profiles.erase( old.id );
+      return true;
+    } );
 
-    // Also remove from m_customProfiles if it exists with old ID
-    for ( auto &memProfile : m_service->m_customProfiles )
-    {
-      if ( memProfile.name == profile.name && memProfile.id != profile.id )
-      {
-        std::cout << "[Settings] Removing old profile from memory with id '" << memProfile.id << "' (name: " << memProfile.name << ")" << std::endl;
-        // Mark for deletion by swapping with last element
-        // Will be erased below
-        memProfile.id = "";  // Mark for deletion
-      }
-    }
-
-    // Remove marked entries
-    if ( auto it = std::remove_if( m_service->m_customProfiles.begin(), m_service->m_customProfiles.end(),
-                             [](const UccProfile &p) { return p.id.empty(); } );
-         it != m_service->m_customProfiles.end() )
-    {
-      m_service->m_customProfiles.erase( it, m_service->m_customProfiles.end() );
-    }
-
-    // Always persist settings after saving a profile
-    if ( m_service->m_settingsManager.writeSettings( m_service->m_settings ) )
-    {
-      std::cout << "[Settings] Settings persisted after saving profile" << std::endl;
-    }
-    else
-    {
-      std::cerr << "[Settings] Failed to persist settings after saving profile" << std::endl;
-    }
+    // Always persist settings after saving a profile
+    m_service->persistSettings();
 
     return result;
   }
@@ -1164,13 +1539,14 @@ QString UccDBusInterfaceAdaptor::GetGpuProfile( const QString &id )
     return QStringLiteral( "{}" );
 
   const std::string requestedId = id.toStdString();
-  auto it = std::find_if( m_service->m_builtinGpuProfiles.begin(),
-                          m_service->m_builtinGpuProfiles.end(),
+  const auto &builtins = m_service->builtinGpuProfiles();
+  auto it = std::find_if( builtins.begin(),
+                          builtins.end(),
                           [&requestedId]( const UccDBusService::BuiltinGpuProfile &profile ) {
                             return profile.id == requestedId;
                           } );
 
-  if ( it == m_service->m_builtinGpuProfiles.end() )
+  if ( it == builtins.end() )
     return QStringLiteral( "{}" );
 
   return QString::fromStdString( it->json );
@@ -1182,7 +1558,7 @@ QString UccDBusInterfaceAdaptor::GetGpuProfileNames()
     return QStringLiteral( "[]" );
 
   QJsonArray arr;
-  for ( const auto &profile : m_service->m_builtinGpuProfiles )
+  for ( const auto &profile : m_service->builtinGpuProfiles() )
   {
     QJsonObject obj;
     obj[ "id" ] = QString::fromStdString( profile.id );
@@ -1203,8 +1579,7 @@ bool UccDBusInterfaceAdaptor::SetFanProfile( const QString &name, const QString
 
 QString UccDBusInterfaceAdaptor::GetSettingsJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.settingsJSON );
+  return QString::fromStdString( m_data.settings.load()->settingsJSON.current() );
 }
 
 QString UccDBusInterfaceAdaptor::GetPowerState()
@@ -1239,39 +1614,8 @@ bool UccDBusInterfaceAdaptor::SetStateMap( const QString &state, const QString &
   // Verify the profile exists before updating stateMap
   if ( stateStr == "power_ac" || stateStr == "power_bat" || stateStr == "power_wc" )
   {
-    // Check if profile exists in:
-    // 1. m_customProfiles (parsed objects)
-    // 2. m_settings.profiles (authoritative source from file)
-    // 3. m_defaultProfiles (built-in profiles)
-    bool profileExists = false;
-
-    for ( const auto &profile : m_service->m_customProfiles )
-    {
-      if ( profile.id == profileIdStr )
-      {
-        profileExists = true;
-        break;
-      }
-    }
-
-    if ( !profileExists && m_service->m_settings.profiles.find( profileIdStr ) != m_service->m_settings.profiles.end() )
-    {
-      profileExists = true;
-    }
-
-    if ( !profileExists )
-    {
-      for ( const auto &profile : m_service->m_defaultProfiles )
-      {
-        if ( profile.id == profileIdStr )
-        {
-          profileExists = true;
-          break;
-        }
-      }
-    }
-
-    if ( !profileExists )
+    // Check if profile exists among the custom or the built-in profiles
+    if ( !m_service->profileExists( profileIdStr ) )
     {
       std::cerr << "[DBus] SetStateMap: Profile ID '" << profileIdStr << "' does not exist, rejecting" << std::endl;
       return false;
@@ -1279,30 +1623,18 @@ bool UccDBusInterfaceAdaptor::SetStateMap( const QString &state, const QString &
 
     // Profile exists, safe to update
     m_service->m_settings.stateMap[stateStr] = profileIdStr;
-    const bool wrote = m_service->m_settingsManager.writeSettings( m_service->m_settings );
-    if ( !wrote )
-      std::cerr << "[Settings] Failed to persist stateMap update" << std::endl;
+    m_service->persistSettings();
     m_service->updateDBusSettingsData();
-    return wrote;
+    return true;
   }
 
   return false;
 }
 
-bool UccDBusInterfaceAdaptor::SetBatchStateMap( const QString &stateMapJSON )
+// Take the valid state → profile id entries of @p map into the stateMap;
+// returns whether there were any.  Persisting is up to the caller.
+bool UccDBusInterfaceAdaptor::mergeStateMap( const QJsonObject &map )
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
-  if ( !m_service )
-    return false;
-
-  QJsonDocument doc = QJsonDocument::fromJson( stateMapJSON.toUtf8() );
-  if ( !doc.isObject() )
-  {
-    std::cerr << "[DBus] SetBatchStateMap: Invalid JSON" << std::endl;
-    return false;
-  }
-
-  QJsonObject map = doc.object();
   static const QStringList validStates = { "power_ac", "power_bat", "power_wc" };
   bool anyChanged = false;
 
@@ -1318,21 +1650,7 @@ bool UccDBusInterfaceAdaptor::SetBatchStateMap( const QString &stateMapJSON )
     }
 
     // Verify the profile exists (same checks as SetStateMap)
-    bool profileExists = false;
-    for ( const auto &profile : m_service->m_customProfiles )
-    {
-      if ( profile.id == profileIdStr ) { profileExists = true; break; }
-    }
-    if ( !profileExists && m_service->m_settings.profiles.find( profileIdStr ) != m_service->m_settings.profiles.end() )
-      profileExists = true;
-    if ( !profileExists )
-    {
-      for ( const auto &profile : m_service->m_defaultProfiles )
-      {
-        if ( profile.id == profileIdStr ) { profileExists = true; break; }
-      }
-    }
-    if ( !profileExists )
+    if ( !m_service->profileExists( profileIdStr ) )
     {
       std::cerr << "[DBus] SetBatchStateMap: Profile ID '" << profileIdStr << "' does not exist, skipping" << std::endl;
       continue;
@@ -1343,13 +1661,28 @@ bool UccDBusInterfaceAdaptor::SetBatchStateMap( const QString &stateMapJSON )
     anyChanged = true;
   }
 
-  if ( !anyChanged )
+  return anyChanged;
+}
+
+bool UccDBusInterfaceAdaptor::SetBatchStateMap( const QString &stateMapJSON )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
+  if ( !m_service )
+    return false;
+
+  QJsonDocument doc = QJsonDocument::fromJson( stateMapJSON.toUtf8() );
+  if ( !doc.isObject() )
+  {
+    std::cerr << "[DBus] SetBatchStateMap: Invalid JSON" << std::endl;
+    return false;
+  }
+
+  QJsonObject map = doc.object();
+  if ( !mergeStateMap( map ) )
     return false;
 
-  // Write settings only once for the entire batch
-  const bool wrote = m_service->m_settingsManager.writeSettings( m_service->m_settings );
-  if ( !wrote )
-    std::cerr << "[Settings] Failed to persist batch stateMap update" << std::endl;
+  // One queued write for the entire batch
+  m_service->persistSettings();
   m_service->updateDBusSettingsData();
 
   // If the current power state was among the changed entries, apply the new profile immediately
@@ -1361,38 +1694,178 @@ bool UccDBusInterfaceAdaptor::SetBatchStateMap( const QString &stateMapJSON )
     m_service->applyProfileForCurrentState();
   }
 
-  return wrote;
+  return true;
+}
+
+bool UccDBusInterfaceAdaptor::SetWorkloadRules( const QString &rulesJSON )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
+  if ( !m_service )
+    return false;
+
+  const QJsonDocument doc = QJsonDocument::fromJson( rulesJSON.toUtf8() );
+  if ( !doc.isArray() )
+  {
+    std::cerr << "[DBus] SetWorkloadRules: expected a JSON array of rules" << std::endl;
+    return false;
+  }
+
+  // all or nothing: a rule list with a hole would hand its processes to the next rule
+  std::vector< WorkloadRule > rules;
+  for ( const auto &value : doc.array() )
+  {
+    const QJsonObject object = value.toObject();
+    WorkloadRule rule{ object.value( "exe" ).toString().toStdString(),
+                       object.value( "cgroup" ).toString().toStdString(),
+                       object.value( "profile" ).toString().toStdString() };
+    if ( rule.exe.empty() && rule.cgroup.empty() )
+    {
+      std::cerr << "[DBus] SetWorkloadRules: rule without an exe or cgroup pattern, rejecting" << std::endl;
+      return false;
+    }
+    if ( !m_service->profileExists( rule.profileId ) )
+    {
+      std::cerr << "[DBus] SetWorkloadRules: Profile ID '" << rule.profileId << "' does not exist, rejecting" << std::endl;
+      return false;
+    }
+    rules.push_back( std::move( rule ) );
+  }
+
+  std::cout << "[DBus] SetWorkloadRules: " << rules.size() << " rule(s)" << std::endl;
+  m_service->m_settings.workloadRules = std::move( rules );
+  m_service->persistSettings();
+  m_service->updateDBusSettingsData();
+  m_service->updateWorkloadRules();
+  return true;
+}
+
+bool UccDBusInterfaceAdaptor::SetAlertRules( const QString &rulesJSON )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
+  if ( !m_service )
+    return false;
+
+  const QJsonDocument doc = QJsonDocument::fromJson( rulesJSON.toUtf8() );
+  if ( !doc.isArray() )
+  {
+    std::cerr << "[DBus] SetAlertRules: expected a JSON array of rules" << std::endl;
+    return false;
+  }
+  if ( static_cast< size_t >( doc.array().size() ) > AlertEngine::MAX_RULES )
+  {
+    std::cerr << "[DBus] SetAlertRules: more than " << AlertEngine::MAX_RULES << " rules, rejecting" << std::endl;
+    return false;
+  }
+
+  // all or nothing, like SetWorkloadRules
+  std::vector< AlertRule > rules;
+  for ( const auto &value : doc.array() )
+  {
+    const QJsonObject object = value.toObject();
+    AlertRule rule{ object.value( "id" ).toString().toStdString(),
+                    object.value( "metric" ).toString().toStdString(),
+                    object.value( "condition" ).toString().toStdString(),
+                    object.value( "threshold" ).toDouble(),
+                    object.value( "forSeconds" ).toInt(),
+                    object.value( "hysteresis" ).toDouble() };
+    if ( const auto error = AlertEngine::validate( rule, m_service->m_metricsStore.registry() ) )
+    {
+      std::cerr << "[DBus] SetAlertRules: " << *error << ", rejecting" << std::endl;
+      return false;
+    }
+    if ( std::any_of( rules.begin(), rules.end(), [ &rule ]( const AlertRule &r ) { return r.id == rule.id; } ) )
+    {
+      std::cerr << "[DBus] SetAlertRules: duplicate rule id '" << rule.id << "', rejecting" << std::endl;
+      return false;
+    }
+    rules.push_back( std::move( rule ) );
+  }
+
+  std::cout << "[DBus] SetAlertRules: " << rules.size() << " rule(s)" << std::endl;
+  m_service->m_settings.alertRules = std::move( rules );
+  m_service->persistSettings();
+  m_service->updateDBusSettingsData();
+  m_service->updateAlertRules();
+  return true;
+}
+
+QString UccDBusInterfaceAdaptor::GetActiveAlerts()
+{
+  if ( !m_service )
+    return QStringLiteral( "[]" );
+  std::string json;
+  m_service->m_alertEngine.activeJSON( json );
+  return QString::fromStdString( json );
 }
 
 // odm methods
 
 QStringList UccDBusInterfaceAdaptor::ODMProfilesAvailable()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
+  const auto device = m_data.device.load();
   QStringList result;
-  for ( const auto &s : m_data.odmProfilesAvailable )
+  for ( const auto &s : device->odmProfilesAvailable )
     result.append( QString::fromStdString( s ) );
   return result;
 }
 
 QString UccDBusInterfaceAdaptor::ODMPowerLimitsJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.odmPowerLimitsJSON );
+  return QString::fromStdString( m_data.device.load()->odmPowerLimitsJSON );
 }
 
 // keyboard backlight methods
 
 QString UccDBusInterfaceAdaptor::GetKeyboardBacklightCapabilitiesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.keyboardBacklightCapabilitiesJSON );
+  return QString::fromStdString( m_data.device.load()->keyboardBacklightCapabilitiesJSON );
 }
 
 QString UccDBusInterfaceAdaptor::GetKeyboardBacklightStatesJSON()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.keyboardBacklightStatesJSON );
+  return QString::fromStdString( m_data.settings.load()->keyboardBacklightStatesJSON.current() );
+}
+
+// versioned JSON getters
+
+QVariantMap UccDBusInterfaceAdaptor::versionedReply( const VersionedDocument &document, qulonglong knownVersion )
+{
+  QVariantMap reply;
+  const qulonglong version = document.currentVersion();
+  reply[ "version" ] = version;
+  if ( version != knownVersion )
+    reply[ "json" ] = QString::fromStdString( document.current() );
+  return reply;
+}
+
+QVariantMap UccDBusInterfaceAdaptor::GetActiveProfileJSONIfChanged( qulonglong knownVersion )
+{
+  return versionedReply( m_data.profiles.load()->activeProfileJSON, knownVersion );
+}
+
+QVariantMap UccDBusInterfaceAdaptor::GetProfilesJSONIfChanged( qulonglong knownVersion )
+{
+  return versionedReply( m_data.profiles.load()->profilesJSON, knownVersion );
+}
+
+QVariantMap UccDBusInterfaceAdaptor::GetCustomProfilesJSONIfChanged( qulonglong knownVersion )
+{
+  return versionedReply( m_data.profiles.load()->customProfilesJSON, knownVersion );
+}
+
+QVariantMap UccDBusInterfaceAdaptor::GetDefaultProfilesJSONIfChanged( qulonglong knownVersion )
+{
+  return versionedReply( m_data.profiles.load()->defaultProfilesJSON, knownVersion );
+}
+
+QVariantMap UccDBusInterfaceAdaptor::GetSettingsJSONIfChanged( qulonglong knownVersion )
+{
+  return versionedReply( m_data.settings.load()->settingsJSON, knownVersion );
+}
+
+QVariantMap UccDBusInterfaceAdaptor::GetKeyboardBacklightStatesJSONIfChanged( qulonglong knownVersion )
+{
+  return versionedReply( m_data.settings.load()->keyboardBacklightStatesJSON, knownVersion );
 }
 
 bool UccDBusInterfaceAdaptor::SetKeyboardBacklightStatesJSON( const QString &keyboardBacklightStatesJSON )
@@ -1419,14 +1892,11 @@ bool UccDBusInterfaceAdaptor::SetKeyboardBacklightStatesJSON( const QString &key
   // Apply the states array to hardware (extracts "states" from the object)
   if ( !m_service->m_keyboardBacklightController.applyProfileKeyboardStates( inputJSON ) )
     return false;
+  m_service->m_staleSubsystems |= ProfileSubsystem::Keyboard;
 
   // Update the D-Bus readable state with the states *array* so
   // GetKeyboardBacklightStatesJSON returns a clean array.
-  {
-    std::lock_guard< std::mutex > lock( m_data.dataMutex );
-    m_data.keyboardBacklightStatesJSON =
-      m_service->m_keyboardBacklightController.currentStatesJSON();
-  }
+  m_service->updateDBusKeyboardBacklightStates( m_service->m_keyboardBacklightController.currentStatesJSON() );
 
   // If the caller provided a keyboard profile ID, update the active profile
   // reference and notify all clients so they stay in sync.
@@ -1443,6 +1913,20 @@ bool UccDBusInterfaceAdaptor::SetKeyboardBacklightStatesJSON( const QString &key
   return true;
 }
 
+bool UccDBusInterfaceAdaptor::SetKeyboardBacklightFrame( const QByteArray &rgb )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service->m_settings.keyboardBacklightControlEnabled ) return false;
+  if ( rgb.size() % 3 != 0 ) return false;
+
+  // packed RGB per zone; transient, so neither the states nor the profile change
+  std::vector< KeyboardRgb > frame( static_cast< size_t >( rgb.size() / 3 ) );
+  const auto *bytes = reinterpret_cast< const uint8_t * >( rgb.constData() );
+  for ( size_t i = 0; i < frame.size(); ++i )
+    frame[ i ] = { bytes[ i * 3 ], bytes[ i * 3 + 1 ], bytes[ i * 3 + 2 ] };
+  return m_service->m_keyboardBacklightController.showStreamFrame( frame );
+}
+
 
 
 // fan control methods
@@ -1461,14 +1945,12 @@ bool UccDBusInterfaceAdaptor::GetFansOffAvailable()
 
 QString UccDBusInterfaceAdaptor::GetChargingProfilesAvailable()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.chargingProfilesAvailable );
+  return QString::fromStdString( m_data.charging.load()->chargingProfilesAvailable );
 }
 
 QString UccDBusInterfaceAdaptor::GetCurrentChargingProfile()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.currentChargingProfile );
+  return QString::fromStdString( m_data.charging.load()->currentChargingProfile );
 }
 
 bool UccDBusInterfaceAdaptor::SetChargingProfile( const QString &profileDescriptor )
@@ -1478,8 +1960,10 @@ bool UccDBusInterfaceAdaptor::SetChargingProfile( const QString &profileDescript
 
   if ( result )
   {
-    std::lock_guard< std::mutex > lock( m_data.dataMutex );
-    m_data.currentChargingProfile = profileDescriptor.toStdString();
+    m_data.charging.update( [profile = profileDescriptor.toStdString()]( ChargingSnapshot &charging ) {
+      charging.currentChargingProfile = profile;
+    } );
+    m_service->updateDBusSettingsData();
   }
 
   return result;
@@ -1487,14 +1971,12 @@ bool UccDBusInterfaceAdaptor::SetChargingProfile( const QString &profileDescript
 
 QString UccDBusInterfaceAdaptor::GetChargingPrioritiesAvailable()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.chargingPrioritiesAvailable );
+  return QString::fromStdString( m_data.charging.load()->chargingPrioritiesAvailable );
 }
 
 QString UccDBusInterfaceAdaptor::GetCurrentChargingPriority()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.currentChargingPriority );
+  return QString::fromStdString( m_data.charging.load()->currentChargingPriority );
 }
 
 bool UccDBusInterfaceAdaptor::SetChargingPriority( const QString &priorityDescriptor )
@@ -1504,8 +1986,9 @@ bool UccDBusInterfaceAdaptor::SetChargingPriority( const QString &priorityDescri
 
   if ( result )
   {
-    std::lock_guard< std::mutex > lock( m_data.dataMutex );
-    m_data.currentChargingPriority = priorityDescriptor.toStdString();
+    m_data.charging.update( [priority = priorityDescriptor.toStdString()]( ChargingSnapshot &charging ) {
+      charging.currentChargingPriority = priority;
+    } );
   }
 
   return result;
@@ -1513,14 +1996,12 @@ bool UccDBusInterfaceAdaptor::SetChargingPriority( const QString &priorityDescri
 
 QString UccDBusInterfaceAdaptor::GetChargeStartAvailableThresholds()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.chargeStartAvailableThresholds );
+  return QString::fromStdString( m_data.charging.load()->chargeStartAvailableThresholds );
 }
 
 QString UccDBusInterfaceAdaptor::GetChargeEndAvailableThresholds()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.chargeEndAvailableThresholds );
+  return QString::fromStdString( m_data.charging.load()->chargeEndAvailableThresholds );
 }
 
 int UccDBusInterfaceAdaptor::GetChargeStartThreshold()
@@ -1561,8 +2042,7 @@ bool UccDBusInterfaceAdaptor::SetChargeEndThreshold( int value )
 
 QString UccDBusInterfaceAdaptor::GetChargeType()
 {
-  std::lock_guard< std::mutex > lock( m_data.dataMutex );
-  return QString::fromStdString( m_data.chargeType );
+  return QString::fromStdString( m_data.charging.load()->chargeType );
 }
 
 bool UccDBusInterfaceAdaptor::SetChargeType( const QString &type )
@@ -1571,10 +2051,7 @@ bool UccDBusInterfaceAdaptor::SetChargeType( const QString &type )
   bool result = m_service->m_profileSettingsWorker->setChargeType( type.toStdString() );
 
   if ( result )
-  {
-    std::lock_guard< std::mutex > lock( m_data.dataMutex );
-    m_data.chargeType = type.toStdString();
-  }
+    m_data.charging.update( [chargeType = type.toStdString()]( ChargingSnapshot &charging ) { charging.chargeType = chargeType; } );
 
   return result;
 }
@@ -1639,6 +2116,7 @@ bool UccDBusInterfaceAdaptor::SetNVIDIAPowerOffset( int offset )
   if ( !m_service || !m_service->m_profileSettingsWorker ) return false;
   if ( !m_data.nvidiaPowerCTRLAvailable ) return false;
 
+  m_service->m_staleSubsystems |= ProfileSubsystem::GpuOC;
   return m_service->m_profileSettingsWorker->applyNVIDIAPowerOffset( offset );
 }
 
@@ -1702,10 +2180,10 @@ bool UccDBusInterfaceAdaptor::GetWaterCoolerConnected()
 }
 
 int UccDBusInterfaceAdaptor::GetWaterCoolerFanSpeed()
-{ return m_service ? static_cast< int >( m_service->m_waterCoolerWorker->getLastFanSpeed() ) : -1; }
+{ return m_service && m_service->waterCooler() ? static_cast< int >( m_service->waterCooler()->getLastFanSpeed() ) : -1; }
 
 int UccDBusInterfaceAdaptor::GetWaterCoolerPumpLevel()
-{ return m_service ? static_cast< int >( m_service->m_waterCoolerWorker->getLastPumpVoltage() ) : -1; }
+{ return m_service && m_service->waterCooler() ? static_cast< int >( m_service->waterCooler()->getLastPumpVoltage() ) : -1; }
 
 bool UccDBusInterfaceAdaptor::EnableWaterCooler( bool enable )
 {
@@ -1744,8 +2222,8 @@ bool UccDBusInterfaceAdaptor::SetWaterCoolerFanSpeed( int dutyCyclePercent )
   if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
   if ( dutyCyclePercent < 0 || dutyCyclePercent > 100 )
     return false;
-  if ( m_service && m_service->m_waterCoolerWorker )
-    return m_service->m_waterCoolerWorker->setFanSpeed( dutyCyclePercent );
+  if ( m_service && m_service->waterCooler() )
+    return m_service->waterCooler()->setFanSpeed( dutyCyclePercent );
 
   return false;
 }
@@ -1756,8 +2234,8 @@ bool UccDBusInterfaceAdaptor::SetWaterCoolerPumpVoltage( int voltage )
   // V12(1) is reserved and V1bis excluded. Valid: {0, 2, 3, 4}
   if ( voltage != 0 && voltage != 2 && voltage != 3 && voltage != 4 )
     return false;
-  if ( m_service && m_service->m_waterCoolerWorker )
-    return m_service->m_waterCoolerWorker->setPumpVoltage( voltage );
+  if ( m_service && m_service->waterCooler() )
+    return m_service->waterCooler()->setPumpVoltage( voltage );
 
   return false;
 }
@@ -1765,7 +2243,7 @@ bool UccDBusInterfaceAdaptor::SetWaterCoolerPumpVoltage( int voltage )
 bool UccDBusInterfaceAdaptor::SetWaterCoolerLEDColor( int red, int green, int blue, int mode )
 {
   if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( m_service && m_service->m_waterCoolerWorker )
+  if ( m_service && m_service->waterCooler() )
   {
     m_service->m_waterCoolerLedMode.store( mode );
 
@@ -1774,7 +2252,7 @@ bool UccDBusInterfaceAdaptor::SetWaterCoolerLEDColor( int red, int green, int bl
                              ? static_cast< int >( ucc::RGBState::Static )
                              : mode;
 
-    return m_service->m_waterCoolerWorker->setLEDColor( red, green, blue, hwMode );
+    return m_service->waterCooler()->setLEDColor( red, green, blue, hwMode );
   }
   return false;
 }
@@ -1782,9 +2260,9 @@ bool UccDBusInterfaceAdaptor::SetWaterCoolerLEDColor( int red, int green, int bl
 bool UccDBusInterfaceAdaptor::TurnOffWaterCoolerLED()
 {
   if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( m_service && m_service->m_waterCoolerWorker )
+  if ( m_service && m_service->waterCooler() )
   {
-    return m_service->m_waterCoolerWorker->turnOffLED();
+    return m_service->waterCooler()->turnOffLED();
   }
   return false;
 }
@@ -1792,9 +2270,9 @@ bool UccDBusInterfaceAdaptor::TurnOffWaterCoolerLED()
 bool UccDBusInterfaceAdaptor::TurnOffWaterCoolerFan()
 {
   if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( m_service && m_service->m_waterCoolerWorker )
+  if ( m_service && m_service->waterCooler() )
   {
-    return m_service->m_waterCoolerWorker->turnOffFan();
+    return m_service->waterCooler()->turnOffFan();
   }
   return false;
 }
@@ -1802,9 +2280,9 @@ bool UccDBusInterfaceAdaptor::TurnOffWaterCoolerFan()
 bool UccDBusInterfaceAdaptor::TurnOffWaterCoolerPump()
 {
   if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( m_service && m_service->m_waterCoolerWorker )
+  if ( m_service && m_service->waterCooler() )
   {
-    return m_service->m_waterCoolerWorker->turnOffPump();
+    return m_service->waterCooler()->turnOffPump();
   }
   return false;
 }
@@ -1834,128 +2312,686 @@ QByteArray UccDBusInterfaceAdaptor::GetMonitorDataSince( qlonglong sinceTimestam
 {
   if ( !m_service )
     return QByteArray{};
+  noteMonitorClient();
   const auto raw = m_service->m_metricsStore.querySinceBinary( sinceTimestampMs );
   return QByteArray( reinterpret_cast< const char * >( raw.data() ),
                      static_cast< qsizetype >( raw.size() ) );
 }
 
-void UccDBusInterfaceAdaptor::SetMonitorHistoryHorizon( int seconds )
+QByteArray UccDBusInterfaceAdaptor::GetMonitorDataSinceCompressed( qlonglong sinceTimestampMs )
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return;
-  if ( m_service )
-    m_service->m_metricsStore.setHorizon( seconds );
+  if ( !m_service )
+    return QByteArray{};
+  noteMonitorClient();
+  const auto raw = m_service->m_metricsStore.querySinceCompressed( sinceTimestampMs );
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
 }
 
-int UccDBusInterfaceAdaptor::GetMonitorHistoryHorizon()
+QByteArray UccDBusInterfaceAdaptor::GetMonitorDataSinceDecimated( qlonglong sinceTimestampMs, uint metricMask,
+                                                                  int maxPointsPerSeries, int mode )
 {
-  return m_service ? m_service->m_metricsStore.horizonSeconds() : 0;
+  if ( !m_service )
+    return QByteArray{};
+  noteMonitorClient();
+  const auto raw = m_service->m_metricsStore.querySinceDecimated(
+    sinceTimestampMs, metricMask, static_cast< size_t >( std::max( maxPointsPerSeries, 0 ) ),
+    mode == 1 ? DecimationMode::MinMax : DecimationMode::Lttb );
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
 }
 
-int UccDBusInterfaceAdaptor::GetCpuFrequencyMHz()
+QByteArray UccDBusInterfaceAdaptor::GetMonitorRollupSince( qlonglong sinceTimestampMs, int maxPointsPerSeries )
 {
-  return m_data.cpuFrequencyMHz.load();
+  if ( !m_service )
+    return QByteArray{};
+  const auto raw = m_service->m_metricsStore.querySinceRollup(
+    sinceTimestampMs, static_cast< size_t >( std::max( maxPointsPerSeries, 0 ) ) );
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
 }
 
-// ---------------------------------------------------------------------------
-// NVIDIA GPU OC methods
-// ---------------------------------------------------------------------------
+QByteArray UccDBusInterfaceAdaptor::GetMonitorFramesSince( qlonglong sinceTimestampMs, qulonglong metricMask )
+{
+  if ( !m_service )
+    return QByteArray{};
+  noteMonitorClient();
+  const auto raw = m_service->m_metricsStore.querySinceFrames( sinceTimestampMs, metricMask );
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
+}
 
-bool UccDBusInterfaceAdaptor::GetNvidiaOCAvailable()
+QByteArray UccDBusInterfaceAdaptor::GetMonitorFramesPage( qlonglong sinceTimestampMs, qulonglong metricMask, int maxRows )
 {
-  return m_service && m_service->m_nvidiaOCWorker && m_service->m_nvidiaOCWorker->isAvailable();
+  if ( !m_service )
+    return QByteArray{};
+  const auto raw = m_service->m_metricsStore.querySinceFrames( sinceTimestampMs, metricMask,
+                                                               static_cast< size_t >( std::max( maxRows, 0 ) ) );
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
 }
 
-QString UccDBusInterfaceAdaptor::GetNvidiaOCState( int deviceIndex )
+QByteArray UccDBusInterfaceAdaptor::GetMonitorEventsSince( qlonglong sinceTimestampMs )
 {
-  if ( !m_service || !m_service->m_nvidiaOCWorker )
-    return QStringLiteral( "{}" );
-  return QString::fromStdString(
-      m_service->m_nvidiaOCWorker->getOCStateJSON( static_cast< unsigned int >( deviceIndex ) ) );
+  if ( !m_service )
+    return QByteArray{};
+  const auto raw = m_service->m_metricsStore.queryEventsSinceBinary( sinceTimestampMs );
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
 }
 
-bool UccDBusInterfaceAdaptor::SetNvidiaClockOffset( int deviceIndex, int clockType, int pstate, int offsetMHz )
+QString UccDBusInterfaceAdaptor::GetMetricCatalog()
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->setClockOffset(
-      static_cast< unsigned int >( deviceIndex ),
-      static_cast< unsigned int >( clockType ),
-      static_cast< unsigned int >( pstate ),
-      offsetMHz );
+  if ( !m_service )
+    return QStringLiteral( "[]" );
+  std::string json;
+  m_service->m_metricsStore.catalogJSON( json );
+  return QString::fromStdString( json );
 }
 
-bool UccDBusInterfaceAdaptor::SetNvidiaGpuLockedClocks( int deviceIndex, int minMHz, int maxMHz )
+QDBusUnixFileDescriptor UccDBusInterfaceAdaptor::GetLiveMetricsSegment()
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->setGpuLockedClocks(
-      static_cast< unsigned int >( deviceIndex ),
-      static_cast< unsigned int >( minMHz ),
-      static_cast< unsigned int >( maxMHz ) );
+  if ( !checkAuth( PolkitAuthority::ACTION_READ ) ) return QDBusUnixFileDescriptor{};
+  if ( !m_service || !m_service->m_liveMetrics.isValid() )
+    return QDBusUnixFileDescriptor{};
+  return QDBusUnixFileDescriptor( m_service->m_liveMetrics.readOnlyFd() );
 }
 
-bool UccDBusInterfaceAdaptor::SetNvidiaVramLockedClocks( int deviceIndex, int minMHz, int maxMHz )
+QString UccDBusInterfaceAdaptor::GetMonitorStatsJSON( qlonglong sinceTimestampMs, const QVariantMap &thresholds )
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->setVramLockedClocks(
-      static_cast< unsigned int >( deviceIndex ),
-      static_cast< unsigned int >( minMHz ),
-      static_cast< unsigned int >( maxMHz ) );
+  if ( !m_service )
+    return QStringLiteral( "{}" );
+
+  // Keys are metric names as in the JSON output, values the thresholds
+  std::array< double, MetricRegistry::MAX_METRICS > limits;
+  limits.fill( std::numeric_limits< double >::quiet_NaN() );
+  const MetricRegistry &registry = m_service->m_metricsStore.registry();
+  for ( auto it = thresholds.constBegin(); it != thresholds.constEnd(); ++it )
+  {
+    const auto id = registry.find( it.key().toStdString() );
+    bool ok = false;
+    const double v = it.value().toDouble( &ok );
+    if ( id && ok )
+      limits[ static_cast< size_t >( *id ) ] = v;
+  }
+
+  std::string json;
+  m_service->m_metricsStore.queryStatsJSON( sinceTimestampMs, limits, json );
+  return QString::fromStdString( json );
 }
 
-bool UccDBusInterfaceAdaptor::ResetNvidiaGpuLockedClocks( int deviceIndex )
+void UccDBusInterfaceAdaptor::SetMonitorHistoryHorizon( int seconds )
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->resetGpuLockedClocks( static_cast< unsigned int >( deviceIndex ) );
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return;
+  if ( m_service )
+    m_service->m_metricsStore.setHorizon( seconds );
 }
 
-bool UccDBusInterfaceAdaptor::ResetNvidiaVramLockedClocks( int deviceIndex )
+int UccDBusInterfaceAdaptor::GetMonitorHistoryHorizon()
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->resetVramLockedClocks( static_cast< unsigned int >( deviceIndex ) );
+  return m_service ? m_service->m_metricsStore.horizonSeconds() : 0;
 }
 
-bool UccDBusInterfaceAdaptor::ResetNvidiaAllClockOffsets( int deviceIndex )
+int UccDBusInterfaceAdaptor::GetCpuFrequencyMHz()
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->resetAllClockOffsets( static_cast< unsigned int >( deviceIndex ) );
+  return m_data.cpuFrequencyMHz.load();
 }
 
-bool UccDBusInterfaceAdaptor::SetNvidiaGpuPowerLimit( int deviceIndex, double watts )
+QString UccDBusInterfaceAdaptor::GetCpuCoresJSON()
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->setPowerLimit( static_cast< unsigned int >( deviceIndex ), watts );
+  return QString::fromStdString( m_data.cpu.load()->cpuCoresJSON );
 }
 
-bool UccDBusInterfaceAdaptor::ResetNvidiaGpuPowerLimit( int deviceIndex )
+QByteArray UccDBusInterfaceAdaptor::GetCpuCoreHistorySince( qlonglong sinceTimestampMs )
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->resetPowerLimit( static_cast< unsigned int >( deviceIndex ) );
+  if ( !m_service )
+    return QByteArray{};
+  noteMonitorClient();
+  const auto raw = m_service->m_metricsStore.queryCoresSinceBinary( sinceTimestampMs );
+  return QByteArray( reinterpret_cast< const char * >( raw.data() ),
+                     static_cast< qsizetype >( raw.size() ) );
 }
 
-bool UccDBusInterfaceAdaptor::ApplyNvidiaGpuOCProfile( const QString &profileJSON, int deviceIndex )
+QString UccDBusInterfaceAdaptor::GetWorkerStatsJSON()
 {
-  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
+  if ( !m_service )
+    return QStringLiteral( "{}" );
 
-  const std::string profileJsonStd = profileJSON.toStdString();
-  const bool result = m_service->m_nvidiaOCWorker->applyGpuOCProfile(
-      profileJsonStd, static_cast< unsigned int >( deviceIndex ) );
+  std::string json;
+  JsonWriter w( json );
+  w.beginObject().key( "histogramUpperMs" ).beginArray();
+  for ( size_t i = 0; i + 1 < DaemonWorkerStats::HISTOGRAM_BUCKETS; ++i )
+    w.value( uint64_t( 1 ) << i );
+  w.endArray().key( "workers" ).beginArray();
+
+  const std::pair< const char *, const DaemonWorker * > workers[] = {
+    { "service", m_service },
+    { "hardwareMonitor", m_service->m_hardwareMonitorWorker.get() },
+    { "fanControl", m_service->m_fanControlWorker.get() },
+    { "cpu", m_service->m_cpuWorker.get() },
+    { "display", m_service->m_displayWorker.get() },
+  };
+  for ( const auto &[ name, worker ] : workers )
+  {
+    if ( worker == nullptr )
+      continue;
+    const DaemonWorkerStats s = worker->stats();
+    const double cycles = static_cast< double >( std::max< uint64_t >( s.cycles, 1 ) );
+    const double periods = static_cast< double >( std::max< uint64_t >( s.periods, 1 ) );
+    w.beginObject()
+      .key( "name" ).value( name )
+      .key( "cycles" ).value( s.cycles )
+      .key( "overruns" ).value( s.overruns )
+      .key( "wakes" ).value( s.wakes )
+      .key( "workAvgMs" ).value( s.totalWorkMs / cycles, 2 )
+      .key( "workMaxMs" ).value( s.maxWorkMs, 2 )
+      .key( "workLastMs" ).value( s.lastWorkMs, 2 )
+      .key( "cpuTotalMs" ).value( s.totalCpuMs, 1 )
+      .key( "nominalPeriodMs" ).value( s.nominalPeriodMs, 0 )
+      .key( "avgPeriodMs" ).value( s.periods > 0 ? s.totalPeriodMs / periods : -1.0, 1 )
+      .key( "avgNominalMs" ).value( s.periods > 0 ? s.totalNominalMs / periods : -1.0, 1 )
+      .key( "maxLateMs" ).value( s.maxLateMs, 1 )
+      .key( "histogram" ).beginArray();
+    for ( const uint64_t count : s.durationHistogram )
+      w.value( count );
+    w.endArray().endObject();
+  }
+  w.endArray().key( "reconcile" ).beginArray();
+  for ( const ReconcileStatus &r : m_service->m_reconciler.status() )
+  {
+    w.beginObject()
+      .key( "name" ).value( r.name )
+      .key( "probes" ).value( r.probes )
+      .key( "drifts" ).value( r.drifts )
+      .key( "reapplies" ).value( r.reapplies )
+      .key( "intervalMs" ).value( r.intervalMs )
+      .key( "gaveUp" ).value( r.gaveUp )
+      .key( "agents" ).beginObject();
+    for ( const auto &[ agent, count ] : r.agents )
+      w.key( agent ).value( count );
+    w.endObject().endObject();
+  }
+  w.endArray().endObject();
+  return QString::fromStdString( json );
+}
 
-  if ( !result )
+bool UccDBusInterfaceAdaptor::StartFanCalibration()
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return false;
+  if ( !m_service || !m_service->m_fanControlWorker )
     return false;
 
-  // Apply cTGP offset from GPU profile payload (GPU-profile path only)
-  if ( m_service->m_profileSettingsWorker && m_service->m_dbusData.nvidiaPowerCTRLAvailable.load() )
+  if ( !m_service->m_settings.fanControlEnabled )
   {
-    QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( profileJsonStd ) );
-    if ( doc.isObject() )
+    std::cerr << "[DBus] StartFanCalibration: fan control is disabled" << std::endl;
+    return false;
+  }
+  std::cout << "[DBus] StartFanCalibration" << std::endl;
+  return m_service->m_fanControlWorker->startCalibration();
+}
+
+void UccDBusInterfaceAdaptor::CancelFanCalibration()
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) ) return;
+  if ( m_service && m_service->m_fanControlWorker )
+    m_service->m_fanControlWorker->cancelCalibration();
+}
+
+QString UccDBusInterfaceAdaptor::GetFanCalibrationJSON()
+{
+  if ( !m_service || !m_service->m_fanControlWorker )
+    return QStringLiteral( "{}" );
+
+  const FanCalibrationStatus status = m_service->m_fanControlWorker->calibrationStatus();
+  std::string json;
+  JsonWriter w( json );
+  w.beginObject()
+    .key( "phase" ).value( FanCalibrationRun::phaseName( status.phase ) )
+    .key( "duty" ).value( status.duty )
+    .key( "error" ).value( status.error )
+    .key( "fans" );
+  FanResponseModel::fansJSON( w, status.model );
+  w.endObject();
+  return QString::fromStdString( json );
+}
+
+QString UccDBusInterfaceAdaptor::GetFanTraceJSON()
+{
+  if ( !m_service || !m_service->m_fanTrace )
+    return QStringLiteral( "{}" );
+
+  std::string json;
+  JsonWriter w( json );
+  w.beginObject().key( "histogramUpperUs" ).beginArray();
+  for ( size_t i = 0; i + 1 < LatencySnapshot::BUCKETS; ++i )
+    w.value( LatencySnapshot::upperUs( i ) );
+  w.endArray().key( "stages" ).beginArray();
+
+  for ( size_t i = 0; i < FanLatencyTrace::STAGES; ++i )
+  {
+    const auto stage = static_cast< FanTraceStage >( i );
+    const LatencySnapshot s = m_service->m_fanTrace->snapshot( stage );
+    const double count = static_cast< double >( std::max< uint64_t >( s.count, 1 ) );
+    w.beginObject()
+      .key( "name" ).value( fanTraceStageName( stage ) )
+      .key( "count" ).value( s.count )
+      .key( "avgUs" ).value( static_cast< double >( s.totalNs ) / count / 1000.0, 1 )
+      .key( "maxUs" ).value( static_cast< double >( s.maxNs ) / 1000.0, 1 )
+      .key( "p50Us" ).value( s.quantileUpperUs( 0.50 ) )
+      .key( "p95Us" ).value( s.quantileUpperUs( 0.95 ) )
+      .key( "p99Us" ).value( s.quantileUpperUs( 0.99 ) )
+      .key( "histogram" ).beginArray();
+    for ( const uint64_t bucket : s.buckets )
+      w.value( bucket );
+    w.endArray().endObject();
+  }
+  w.endArray().endObject();
+  return QString::fromStdString( json );
+}
+
+QString UccDBusInterfaceAdaptor::GetIpcStatsJSON()
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  QDBusConnectionInterface *bus = dbusObj ? dbusObj->connection().interface() : nullptr;
+
+  // pid and command of senders still on the bus, asked only now so that
+  // recording stays free of bus round trips
+  const auto describe = [this, bus]( std::string_view sender ) -> std::string {
+    const std::string name( sender );
+    auto pid = m_authCache.pid( name );
+    if ( !pid && bus && sender.starts_with( ':' ) )
+    {
+      const QDBusReply< uint > reply = bus->servicePid( QString::fromStdString( name ) );
+      if ( reply.isValid() )
+        pid = reply.value();
+    }
+    if ( !pid )
+      return {};
+    std::string comm;
+    std::ifstream( "/proc/" + std::to_string( *pid ) + "/comm" ) >> comm;
+    return ( comm.empty() ? std::string( "?" ) : comm ) + " (" + std::to_string( *pid ) + ")";
+  };
+
+  const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::steady_clock::now().time_since_epoch() ).count();
+  std::string json;
+  JsonWriter w( json );
+  m_ipcStats.toJSON( w, nowMs, describe );
+  return QString::fromStdString( json );
+}
+
+QString UccDBusInterfaceAdaptor::GetStartupTimelineJSON()
+{
+  if ( !m_service )
+    return QStringLiteral( "{}" );
+
+  std::string json;
+  JsonWriter w( json );
+  m_service->m_startup.toJSON( w );
+  return QString::fromStdString( json );
+}
+
+void UccDBusInterfaceAdaptor::recordIpcCall( std::string_view method, std::string_view sender,
+                                             std::chrono::steady_clock::time_point begin ) noexcept
+{
+  const auto end = std::chrono::steady_clock::now();
+  const auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >( end - begin ).count();
+  try
+  {
+    m_ipcStats.record( method, sender, ns > 0 ? static_cast< uint64_t >( ns ) : 0,
+                       std::chrono::duration_cast< std::chrono::milliseconds >( end.time_since_epoch() ).count() );
+  }
+  catch ( const std::bad_alloc & )
+  {
+  }
+}
+
+QString UccDBusInterfaceAdaptor::dbusCaller() const
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  return dbusObj && dbusObj->calledFromDBus() ? dbusObj->message().service() : QString();
+}
+
+int InstrumentedDBusAdaptor::qt_metacall( QMetaObject::Call call, int id, void **args )
+{
+  if ( call != QMetaObject::InvokeMetaMethod )
+    return UccDBusInterfaceAdaptor::qt_metacall( call, id, args );
+
+  // id is still absolute here; the base call makes it relative
+  const QString sender = dbusCaller();
+  if ( sender.isEmpty() )
+    return UccDBusInterfaceAdaptor::qt_metacall( call, id, args );
+
+  const QByteArray method = metaObject()->method( id ).name();
+  const auto begin = std::chrono::steady_clock::now();
+  int result = 0;
+  {
+    UCC_TRACE_SCOPE( "dbus", method.constData() );
+    result = UccDBusInterfaceAdaptor::qt_metacall( call, id, args );
+  }
+  recordIpcCall( std::string_view( method.constData(), static_cast< size_t >( method.size() ) ),
+                 sender.toStdString(), begin );
+  return result;
+}
+
+void UccDBusInterfaceAdaptor::SubscribeMetricsSamples()
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  if ( not dbusObj )
+    return;
+
+  const QString sender = dbusObj->message().service();
+  if ( sender.isEmpty() || m_sampleSubscribers.contains( sender ) )
+    return;
+
+  m_sampleSubscribers.insert( sender );
+  m_sampleWatcher.addWatchedService( sender );
+  m_sampleSubscriberCount.store( static_cast< int >( m_sampleSubscribers.size() ), std::memory_order_relaxed );
+}
+
+void UccDBusInterfaceAdaptor::UnsubscribeMetricsSamples()
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  if ( dbusObj )
+    removeMetricsSampleSubscriber( dbusObj->message().service() );
+}
+
+void UccDBusInterfaceAdaptor::removeMetricsSampleSubscriber( const QString &service )
+{
+  if ( !m_sampleSubscribers.remove( service ) )
+    return;
+
+  unwatchIfUnused( service );
+  m_sampleSubscriberCount.store( static_cast< int >( m_sampleSubscribers.size() ), std::memory_order_relaxed );
+}
+
+void UccDBusInterfaceAdaptor::SubscribeFastSampling()
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  if ( not dbusObj || not m_service || not m_service->m_samplingGovernor )
+    return;
+
+  const QString sender = dbusObj->message().service();
+  if ( sender.isEmpty() || m_fastSamplingClients.contains( sender ) )
+    return;
+
+  m_fastSamplingClients.insert( sender );
+  m_sampleWatcher.addWatchedService( sender );
+  m_service->m_samplingGovernor->setFastClients( static_cast< int >( m_fastSamplingClients.size() ) );
+
+  // start the faster cadence now instead of after an idle-length sleep
+  if ( m_service->m_hardwareMonitorWorker )
+    m_service->m_hardwareMonitorWorker->wake();
+  if ( m_service->m_fanControlWorker )
+    m_service->m_fanControlWorker->wake();
+}
+
+void UccDBusInterfaceAdaptor::UnsubscribeFastSampling()
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  if ( dbusObj )
+    removeFastSamplingClient( dbusObj->message().service() );
+}
+
+void UccDBusInterfaceAdaptor::removeFastSamplingClient( const QString &service )
+{
+  if ( !m_fastSamplingClients.remove( service ) )
+    return;
+
+  unwatchIfUnused( service );
+  if ( m_service && m_service->m_samplingGovernor )
+    m_service->m_samplingGovernor->setFastClients( static_cast< int >( m_fastSamplingClients.size() ) );
+}
+
+void UccDBusInterfaceAdaptor::SubscribeSensors( uint groups )
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  if ( not dbusObj )
+    return;
+
+  const QString sender = dbusObj->message().service();
+  if ( sender.isEmpty() )
+    return;
+
+  const uint32_t previous = m_sensorSubscriptions.mask();
+  m_sensorGroups.store( m_sensorSubscriptions.subscribe( sender.toStdString(), groups ), std::memory_order_relaxed );
+  if ( m_sensorSubscriptions.contains( sender.toStdString() ) )
+    m_sampleWatcher.addWatchedService( sender );
+  else
+    unwatchIfUnused( sender );
+
+  // sample newly requested groups now instead of after an idle-length sleep
+  if ( ( m_sensorSubscriptions.mask() & ~previous ) != 0 && m_service && m_service->m_hardwareMonitorWorker )
+    m_service->m_hardwareMonitorWorker->wake();
+}
+
+void UccDBusInterfaceAdaptor::UnsubscribeSensors()
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  if ( dbusObj )
+    removeSensorSubscriber( dbusObj->message().service() );
+}
+
+void UccDBusInterfaceAdaptor::removeSensorSubscriber( const QString &service )
+{
+  const std::string sender = service.toStdString();
+  if ( !m_sensorSubscriptions.contains( sender ) )
+    return;
+
+  m_sensorGroups.store( m_sensorSubscriptions.unsubscribe( sender ), std::memory_order_relaxed );
+  unwatchIfUnused( service );
+}
+
+QVariantMap UccDBusInterfaceAdaptor::RequestPeerChannel()
+{
+  auto *dbusObj = qobject_cast< UccDBusObject * >( parent() );
+  if ( not dbusObj )
+    return {};
+
+  const QDBusMessage &message = dbusObj->message();
+  const QString sender = message.service();
+  auto *busInterface = dbusObj->connection().interface();
+  if ( sender.isEmpty() || !busInterface )
+    return {};
+
+  const QDBusReply< uint > uid = busInterface->serviceUid( sender );
+  if ( !uid.isValid() )
+    return {};
+
+  // remembering the PID keeps the sender watched, so its channel closes when it leaves
+  if ( !m_authCache.knowsSender( sender.toStdString() ) )
+  {
+    const auto pid = PolkitAuthority::callerPid( dbusObj->connection(), message );
+    if ( not pid )
+      return {};
+    m_authCache.setPid( sender.toStdString(), *pid );
+    m_sampleWatcher.addWatchedService( sender );
+  }
+
+  if ( !m_peerServer )
+    m_peerServer = std::make_unique< PeerChannelServer >(
+      [this]( const PeerCaller &caller, const QString &method, const QVariantList &args, QString &error ) {
+        return dispatchPeerCall( caller, method, args, error );
+      } );
+  if ( !m_peerServer->listen() )
+  {
+    syslog( LOG_WARNING, "UccDBusInterfaceAdaptor: peer channel socket unavailable" );
+    return {};
+  }
+
+  QVariantMap channel;
+  channel[ QStringLiteral( "address" ) ] = m_peerServer->address();
+  channel[ QStringLiteral( "token" ) ] = m_peerServer->issueToken( sender, uid.value() );
+  return channel;
+}
+
+std::optional< QVariant > UccDBusInterfaceAdaptor::dispatchPeerCall( const PeerCaller &caller, const QString &method,
+                                                                     const QVariantList &args, QString &error )
+{
+  const auto arg = [&args]( qsizetype i ) { return i < args.size() ? args[ i ] : QVariant(); };
+
+  m_peerCaller = &caller;
+  const auto begin = std::chrono::steady_clock::now();
+  const auto done = qScopeGuard( [this, &caller, &method, begin]() {
+    m_peerCaller = nullptr;
+    recordIpcCall( method.toStdString(), caller.sender.toStdString(), begin );
+  } );
+
+  if ( method == QLatin1String( "GetMonitorDataSince" ) )
+    return QVariant( GetMonitorDataSince( arg( 0 ).toLongLong() ) );
+  if ( method == QLatin1String( "GetMonitorDataSinceCompressed" ) )
+    return QVariant( GetMonitorDataSinceCompressed( arg( 0 ).toLongLong() ) );
+  if ( method == QLatin1String( "GetMonitorDataSinceDecimated" ) )
+    return QVariant( GetMonitorDataSinceDecimated( arg( 0 ).toLongLong(), arg( 1 ).toUInt(),
+                                                   arg( 2 ).toInt(), arg( 3 ).toInt() ) );
+  if ( method == QLatin1String( "GetMonitorFramesSince" ) )
+    return QVariant( GetMonitorFramesSince( arg( 0 ).toLongLong(), arg( 1 ).toULongLong() ) );
+  if ( method == QLatin1String( "GetCpuCoreHistorySince" ) )
+    return QVariant( GetCpuCoreHistorySince( arg( 0 ).toLongLong() ) );
+  if ( method == QLatin1String( "GetLiveSnapshot" ) )
+    return QVariant( GetLiveSnapshot() );
+
+  // writes: refused without a cached grant so the client repeats them on the bus
+  if ( method == QLatin1String( "SetKeyboardBacklightFrame" ) )
+  {
+    if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) )
+    {
+      error = QLatin1String( ucc::peer::ERROR_NOT_AUTHORIZED );
+      return std::nullopt;
+    }
+    return QVariant( SetKeyboardBacklightFrame( arg( 0 ).toByteArray() ) );
+  }
+  if ( !checkAuth( PolkitAuthority::ACTION_MANAGE_HARDWARE ) )
+  {
+    error = QLatin1String( ucc::peer::ERROR_NOT_AUTHORIZED );
+    return std::nullopt;
+  }
+  if ( method == QLatin1String( "SetFanProfileCPU" ) )
+    return QVariant( SetFanProfileCPU( arg( 0 ).toString() ) );
+  if ( method == QLatin1String( "SetFanProfileDGPU" ) )
+    return QVariant( SetFanProfileDGPU( arg( 0 ).toString() ) );
+  if ( method == QLatin1String( "ApplyFanProfiles" ) )
+    return QVariant( ApplyFanProfiles( arg( 0 ).toString() ) );
+
+  error = QStringLiteral( "UnknownMethod" );
+  return std::nullopt;
+}
+
+void UccDBusInterfaceAdaptor::unwatchIfUnused( const QString &service )
+{
+  const std::string sender = service.toStdString();
+  if ( !m_sampleSubscribers.contains( service ) && !m_fastSamplingClients.contains( service )
+       && !m_sensorSubscriptions.contains( sender ) && !m_authCache.knowsSender( sender ) )
+    m_sampleWatcher.removeWatchedService( service );
+}
+
+void UccDBusInterfaceAdaptor::noteMonitorClient() noexcept
+{
+  if ( m_service && m_service->m_samplingGovernor )
+    m_service->m_samplingGovernor->noteClientActivity();
+}
+
+// ---------------------------------------------------------------------------
+// NVIDIA GPU OC methods
+// ---------------------------------------------------------------------------
+
+bool UccDBusInterfaceAdaptor::GetNvidiaOCAvailable()
+{
+  return m_service && m_service->nvidiaOC() && m_service->nvidiaOC()->isAvailable();
+}
+
+QString UccDBusInterfaceAdaptor::GetNvidiaOCState( int deviceIndex )
+{
+  if ( !m_service || !m_service->nvidiaOC() )
+    return QStringLiteral( "{}" );
+  return QString::fromStdString(
+      m_service->nvidiaOC()->getOCStateJSON( static_cast< unsigned int >( deviceIndex ) ) );
+}
+
+bool UccDBusInterfaceAdaptor::SetNvidiaClockOffset( int deviceIndex, int clockType, int pstate, int offsetMHz )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->setClockOffset(
+      static_cast< unsigned int >( deviceIndex ),
+      static_cast< unsigned int >( clockType ),
+      static_cast< unsigned int >( pstate ),
+      offsetMHz );
+}
+
+bool UccDBusInterfaceAdaptor::SetNvidiaGpuLockedClocks( int deviceIndex, int minMHz, int maxMHz )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->setGpuLockedClocks(
+      static_cast< unsigned int >( deviceIndex ),
+      static_cast< unsigned int >( minMHz ),
+      static_cast< unsigned int >( maxMHz ) );
+}
+
+bool UccDBusInterfaceAdaptor::SetNvidiaVramLockedClocks( int deviceIndex, int minMHz, int maxMHz )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->setVramLockedClocks(
+      static_cast< unsigned int >( deviceIndex ),
+      static_cast< unsigned int >( minMHz ),
+      static_cast< unsigned int >( maxMHz ) );
+}
+
+bool UccDBusInterfaceAdaptor::ResetNvidiaGpuLockedClocks( int deviceIndex )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->resetGpuLockedClocks( static_cast< unsigned int >( deviceIndex ) );
+}
+
+bool UccDBusInterfaceAdaptor::ResetNvidiaVramLockedClocks( int deviceIndex )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->resetVramLockedClocks( static_cast< unsigned int >( deviceIndex ) );
+}
+
+bool UccDBusInterfaceAdaptor::ResetNvidiaAllClockOffsets( int deviceIndex )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->resetAllClockOffsets( static_cast< unsigned int >( deviceIndex ) );
+}
+
+bool UccDBusInterfaceAdaptor::SetNvidiaGpuPowerLimit( int deviceIndex, double watts )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->setPowerLimit( static_cast< unsigned int >( deviceIndex ), watts );
+}
+
+bool UccDBusInterfaceAdaptor::ResetNvidiaGpuPowerLimit( int deviceIndex )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->resetPowerLimit( static_cast< unsigned int >( deviceIndex ) );
+}
+
+bool UccDBusInterfaceAdaptor::ApplyNvidiaGpuOCProfile( const QString &profileJSON, int deviceIndex )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+
+  const std::string profileJsonStd = profileJSON.toStdString();
+  m_service->m_staleSubsystems |= ProfileSubsystem::GpuOC;
+  const bool result = m_service->nvidiaOC()->applyGpuOCProfile(
+      profileJsonStd, static_cast< unsigned int >( deviceIndex ) );
+
+  if ( !result )
+    return false;
+
+  // Apply cTGP offset from GPU profile payload (GPU-profile path only)
+  if ( m_service->m_profileSettingsWorker && m_service->m_dbusData.nvidiaPowerCTRLAvailable.load() )
+  {
+    QJsonDocument doc = QJsonDocument::fromJson( QByteArray::fromStdString( profileJsonStd ) );
+    if ( doc.isObject() )
     {
       QJsonObject obj = doc.object();
       if ( obj.contains( "nvidiaPowerCTRLProfile" ) && obj[ "nvidiaPowerCTRLProfile" ].isObject() )
@@ -2000,8 +3036,84 @@ bool UccDBusInterfaceAdaptor::ApplyNvidiaGpuOCProfile( const QString &profileJSO
 bool UccDBusInterfaceAdaptor::ResetNvidiaGpuOCAll( int deviceIndex )
 {
   if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
-  if ( !m_service || !m_service->m_nvidiaOCWorker ) return false;
-  return m_service->m_nvidiaOCWorker->resetAll( static_cast< unsigned int >( deviceIndex ) );
+  if ( !m_service || !m_service->nvidiaOC() ) return false;
+  return m_service->nvidiaOC()->resetAll( static_cast< unsigned int >( deviceIndex ) );
+}
+
+namespace
+{
+/// GpuOcTuningOptions from StartNvidiaOCTuning's JSON; absent keys keep their defaults
+std::optional< GpuOcTuningOptions > gpuTuningOptionsFromJSON( const QString &json )
+{
+  GpuOcTuningOptions options;
+  if ( json.trimmed().isEmpty() )
+    return options;
+  const QJsonDocument doc = QJsonDocument::fromJson( json.toUtf8() );
+  if ( !doc.isObject() )
+    return std::nullopt;
+  const QJsonObject obj = doc.object();
+
+  if ( obj.contains( "powerLimitsW" ) )
+  {
+    options.powerLimitsW.clear();
+    for ( const QJsonValue &v : obj.value( "powerLimitsW" ).toArray() )
+      options.powerLimitsW.push_back( v.toDouble( -1.0 ) );
+  }
+  if ( obj.contains( "lockedMaxMHz" ) )
+  {
+    options.lockedMaxMHz.clear();
+    for ( const QJsonValue &v : obj.value( "lockedMaxMHz" ).toArray() )
+      options.lockedMaxMHz.push_back( static_cast< unsigned >( std::max( 0, v.toInt() ) ) );
+  }
+  options.lockedMinMHz = static_cast< unsigned >( std::max( 0, obj.value( "lockedMinMHz" ).toInt( 0 ) ) );
+  options.offsetStepMHz = obj.value( "offsetStepMHz" ).toInt( options.offsetStepMHz );
+  options.maxOffsetMHz = obj.value( "maxOffsetMHz" ).toInt( options.maxOffsetMHz );
+  options.safetySteps = obj.value( "safetySteps" ).toInt( options.safetySteps );
+  options.settleS = obj.value( "settleS" ).toDouble( options.settleS );
+  options.measureS = obj.value( "measureS" ).toDouble( options.measureS );
+  options.minUtilPct = obj.value( "minUtilPct" ).toInt( options.minUtilPct );
+  options.maxClockCv = obj.value( "maxClockCv" ).toDouble( options.maxClockCv );
+  options.maxHwLimitedFraction = obj.value( "maxHwLimitedFraction" ).toDouble( options.maxHwLimitedFraction );
+  options.loadTimeoutS = obj.value( "loadTimeoutS" ).toDouble( options.loadTimeoutS );
+
+  const QString objective = obj.value( "objective" ).toString( "efficiency" );
+  if ( objective == "performance" )
+    options.objective = GpuOcObjective::Performance;
+  else if ( objective != "efficiency" )
+    return std::nullopt;
+  return options;
+}
+}
+
+bool UccDBusInterfaceAdaptor::StartNvidiaOCTuning( int deviceIndex, const QString &optionsJSON )
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  // the job measures the telemetry of the first dGPU only
+  if ( !m_service || deviceIndex != 0 ) return false;
+
+  auto options = gpuTuningOptionsFromJSON( optionsJSON );
+  if ( !options )
+  {
+    syslog( LOG_WARNING, "[GpuTune] Rejected malformed tuning options" );
+    return false;
+  }
+  return m_service->startGpuTuning( std::move( *options ) );
+}
+
+QString UccDBusInterfaceAdaptor::GetNvidiaOCTuningStatus()
+{
+  if ( !m_service || !m_service->m_gpuTuner )
+    return QStringLiteral( "{\"state\":\"idle\"}" );
+  return QString::fromStdString( m_service->m_gpuTuner->statusJSON() );
+}
+
+bool UccDBusInterfaceAdaptor::CancelNvidiaOCTuning()
+{
+  if ( !checkAuth( PolkitAuthority::ACTION_CONTROL ) ) return false;
+  if ( !m_service || !m_service->m_gpuTuner || m_service->m_gpuTuner->state() != GpuOcTuningState::Running )
+    return false;
+  m_service->endGpuTuning();
+  return true;
 }
 
 // signal emitters
@@ -2051,12 +3163,61 @@ void UccDBusInterfaceAdaptor::emitWaterCoolerStatusChanged( const std::string &s
   }, Qt::QueuedConnection );
 }
 
+void UccDBusInterfaceAdaptor::emitMetricsSample( qlonglong timestampMs, QList< double > values )
+{
+  QMetaObject::invokeMethod( this, [this, timestampMs, values = std::move( values )]() {
+    emit MetricsSample( timestampMs, values );
+  }, Qt::QueuedConnection );
+}
+
+void UccDBusInterfaceAdaptor::emitAlert( const AlertEngine::Event &event )
+{
+  const QString ruleId = QString::fromStdString( event.ruleId );
+  const QString metric = QString::fromStdString( event.metric );
+  QMetaObject::invokeMethod( this, [this, ruleId, metric, raised = event.raised, value = event.value,
+                                    timestampMs = static_cast< qlonglong >( event.timestampMs )]() {
+    if ( raised )
+      emit AlertRaised( ruleId, metric, value, timestampMs );
+    else
+      emit AlertCleared( ruleId, metric, value, timestampMs );
+  }, Qt::QueuedConnection );
+}
+
+void UccDBusInterfaceAdaptor::publishPropertyChanges( const PropertyMap &changed )
+{
+  if ( changed.empty() )
+    return;
+
+  QVariantMap props;
+  for ( const auto &[ name, value ] : changed )
+  {
+    props.insert( QString::fromStdString( name ), std::visit( []( const auto &v ) {
+      if constexpr ( std::is_same_v< std::decay_t< decltype( v ) >, std::string > )
+        return QVariant( QString::fromStdString( v ) );
+      else
+        return QVariant( v );
+    }, value ) );
+  }
+
+  QMetaObject::invokeMethod( this, [this, props = std::move( props )]() {
+    for ( auto it = props.constBegin(); it != props.constEnd(); ++it )
+      m_properties.insert( it.key(), it.value() );
+
+    QDBusMessage signal = QDBusMessage::createSignal( QString::fromLatin1( UccDBusService::OBJECT_PATH ),
+                                                      QStringLiteral( "org.freedesktop.DBus.Properties" ),
+                                                      QStringLiteral( "PropertiesChanged" ) );
+    signal << QString::fromLatin1( INTERFACE_NAME ) << props << QStringList();
+    QDBusConnection::systemBus().send( signal );
+  }, Qt::QueuedConnection );
+}
+
 // UccDBusService implementation
 
 UccDBusService::UccDBusService()
-  : DaemonWorker( std::chrono::milliseconds( 1000 ), false ),
+  : DaemonWorker( SERVICE_INTERVAL, false ),
     m_dbusData(),
     m_io(),
+    m_ec( m_io ),
     m_dbusObject( nullptr ),
     m_adaptor( nullptr ),
     m_started( false ),
@@ -2069,98 +3230,248 @@ UccDBusService::UccDBusService()
     m_currentState( ProfileState::AC ),
     m_currentStateProfileId(),
     m_previousWaterCoolerConnected( false ),
-    m_waterCoolerWorker( std::make_unique<LCTWaterCoolerWorker>( m_dbusData ) )
+    m_alertEngine( [this]( const AlertEngine::Event &event ) {
+      if ( m_adaptor )
+        m_adaptor->emitAlert( event );
+    } ),
+    m_metricsStore( MetricsHistoryStore::DEFAULT_CAPACITY, MetricsHistoryStore::DEFAULT_BACKING_PATH )
 {
   // set daemon version
-  m_dbusData.uccdVersion = "2.1.21";
-
-  // identify and set device
-  auto device = identifyDevice();
-  m_deviceId = device;
-  if ( device.has_value() )
-  {
-    m_dbusData.device = std::to_string( static_cast< int >( device.value() ) );
-  }
-  else
-  {
-    m_dbusData.device = "";
-  }
-
-  // compute device-specific feature flags (aquaris, cTGP)
-  computeDeviceCapabilities();
-
-  // detect system hardware info (CPU, GPU, laptop model)
-  m_systemInfo = detectSystemInfo( m_deviceId );
-  m_dbusData.systemInfoJSON = m_systemInfo.toJSON();
+  m_dbusData.device.update( []( DeviceSnapshot &device ) { device.uccdVersion = "2.1.21"; } );
+
+  // mirror every history sample into the shared-memory segment
+  m_metricsStore.setLiveSegment( &m_liveMetrics );
+  m_metricsStore.setAlertEngine( &m_alertEngine );
+
+  // write queued settings / autosave changes once they are due
+  m_persistTimer.setSingleShot( true );
+  QObject::connect( &m_persistTimer, &QTimer::timeout, this, [this]() {
+    const auto now = PersistQueue::Clock::now();
+    if ( !m_settingsPersist.flushIfDue( now ) )
+      std::cerr << "[Settings] Failed to persist settings, retrying" << std::endl;
+    if ( !m_autosavePersist.flushIfDue( now ) )
+      std::cerr << "[Autosave] Failed to save autosave, retrying" << std::endl;
+    armPersistTimer();
+  } );
+
+  QObject::connect( &m_gpuTuningTimer, &QTimer::timeout, this, [this]() { stepGpuTuning(); } );
+
+  m_keyboardIdleTimer.setSingleShot( true );
+  QObject::connect( &m_keyboardIdleTimer, &QTimer::timeout, this, [this]() { checkKeyboardIdle(); } );
+}
+
+void UccDBusService::initialize()
+{
+  // the facts this machine had last time, before any of them is probed
+  m_startup.run( "capability-profile", [this]() { openCapabilityProfile(); } );
+
+  m_startup.run( "identify-device", [this]() {
+    // identify and set device
+    m_deviceId = identifyDevice();
+    m_dbusData.device.update( [this]( DeviceSnapshot &device ) {
+      device.device = m_deviceId.has_value() ? std::to_string( static_cast< int >( m_deviceId.value() ) ) : "";
+    } );
+
+    // compute device-specific feature flags (aquaris, cTGP)
+    computeDeviceCapabilities();
+  } );
+
+  // detect system hardware info (CPU, GPU, laptop model); it is only
+  // published, so the PCI ids lookup runs alongside the setup below.  With
+  // a capability profile it was published already and the detection waits
+  // for the background revalidation.
+  std::future< SystemInfo > systemInfo;
+  if ( not m_capabilities.find( "system-info" ) )
+    systemInfo = m_startup.spawn( "system-info", [deviceId = m_deviceId]() {
+      return detectSystemInfo( deviceId );
+    } );
+  const auto publishSystemInfo = [this, &systemInfo]() {
+    if ( not systemInfo.valid() )
+      return;
+    m_systemInfo = systemInfo.get();
+    const std::string json = m_systemInfo.toJSON();
+    m_capabilities.revalidate( "system-info", json );
+    m_dbusData.device.update( [json]( DeviceSnapshot &device ) { device.systemInfoJSON = json; } );
+  };
 
   // Check device whitelist — unsupported machines get a functional D-Bus
   // service (so clients can query IsDeviceSupported) but no hardware control.
   m_dbusData.deviceSupported = ucc::isDeviceSupported();
   if ( !m_dbusData.deviceSupported.load() )
   {
+    publishSystemInfo();
     syslog( LOG_WARNING, "[uccd] Device not in supported whitelist — running in passive mode" );
     return;
   }
 
+  // Loading NVML and discovering the keyboard LEDs touch nothing else, so
+  // they run alongside until their results are first needed.  The NVML
+  // overclocking probes wait for nvidiaOC().
+  auto nvml = m_startup.spawn( "nvml", []() { return std::make_shared< NvmlWrapper >( false ); } );
+  auto keyboardCaps = m_startup.spawn( "keyboard-backlight", [this]() {
+    return m_keyboardBacklightController.init();
+  } );
+
   // detect display session type and initialize display modes
-  initializeDisplayModes();
+  m_startup.run( "display-modes", [this]() { initializeDisplayModes(); } );
 
-  // check tuxedo wmi availability
+  // check tuxedo wmi availability; /dev/tuxedo_io is opened once, so it cannot change later
   m_dbusData.tuxedoWmiAvailable = m_io.wmiAvailable();
 
   // set default system JSON values (sentinels for GPU/CPU monitoring data)
-  m_dbusData.primeState = "-1";
-  m_dbusData.dGpuInfoValuesJSON = "{\"temp\":-1,\"powerDraw\":-1,\"maxPowerLimit\":-1,\"enforcedPowerLimit\":-1,\"coreFrequency\":-1,\"vramFrequency\":-1,\"maxCoreFrequency\":-1,\"computeUtilPct\":-1,\"memoryUtilPct\":-1,\"vramUsedMiB\":-1,\"vramTotalMiB\":-1,\"perfLimitReason\":\"\",\"encoderUtilPct\":-1,\"decoderUtilPct\":-1,\"currentPstate\":-1,\"grClockOffsetMHz\":-999,\"memClockOffsetMHz\":-999,\"coreVoltageMv\":-1}";
-  m_dbusData.iGpuInfoValuesJSON = "{\"vendor\":\"unknown\",\"temp\":-1,\"coreFrequency\":-1,\"maxCoreFrequency\":-1,\"powerDraw\":-1}";
+  GpuSnapshot gpu;
+  gpu.primeState = "-1";
+  gpu.dGpuInfoValuesJSON = "{\"temp\":-1,\"powerDraw\":-1,\"maxPowerLimit\":-1,\"enforcedPowerLimit\":-1,\"coreFrequency\":-1,\"vramFrequency\":-1,\"maxCoreFrequency\":-1,\"computeUtilPct\":-1,\"memoryUtilPct\":-1,\"vramUsedMiB\":-1,\"vramTotalMiB\":-1,\"perfLimitReason\":\"\",\"encoderUtilPct\":-1,\"decoderUtilPct\":-1,\"currentPstate\":-1,\"grClockOffsetMHz\":-999,\"memClockOffsetMHz\":-999,\"coreVoltageMv\":-1}";
+  gpu.dGpuInfoListJSON = "[" + gpu.dGpuInfoValuesJSON + "]";
+  gpu.iGpuInfoValuesJSON = "{\"vendor\":\"unknown\",\"temp\":-1,\"coreFrequency\":-1,\"maxCoreFrequency\":-1,\"powerDraw\":-1}";
+  m_dbusData.gpu.store( std::move( gpu ) );
+
+  // Keyboard backlight will be detected during worker initialization
+  m_dbusData.device.update( [cached = m_capabilities.find( "keyboard" )]( DeviceSnapshot &device ) {
+    device.keyboardBacklightCapabilitiesJSON = cached.value_or( "null" );
+  } );
+  m_dbusData.settings.update( []( SettingsSnapshot &settings ) { settings.keyboardBacklightStatesJSON.set( "[]" ); } );
+
+  // Read all hardware capabilities directly using m_ec / sysfs BEFORE any
+  // workers or profiles are created.  This populates TDP limits, NVIDIA
+  // power limits, charging profiles, and YCbCr420 availability with real
+  // hardware values so the D-Bus data is never populated with fake defaults.
+  //
+  // The single shared NvmlWrapper instance is reused by
+  // readHardwareCapabilities(), HardwareMonitorWorker, NvidiaOCWorker, and
+  // ProfileSettingsWorker so that NVML is initialised exactly once.
+  m_nvml = nvml.get();
+  m_startup.run( "hardware-capabilities", [this]() { readHardwareCapabilities(); } );
+
+  m_samplingGovernor = std::make_shared< SamplingGovernor >();
+
+  // Time every tuxedo_io ioctl, split by direction
+  m_fanTrace = std::make_shared< FanLatencyTrace >();
+  // (installed on the EC thread, the only one issuing them)
+  m_ec.call( [this]( DeviceInterface & ) {
+    m_io.setIoctlObserver( [trace = m_fanTrace]( unsigned long request, std::chrono::nanoseconds duration ) {
+      const FanTraceStage stage = ( _IOC_DIR( request ) & _IOC_WRITE ) ? FanTraceStage::IoctlWrite : FanTraceStage::IoctlRead;
+      trace->record( stage, static_cast< uint64_t >( std::max< int64_t >( duration.count(), 0 ) ) );
+    } );
+  } );
+
+  // AC/BAT follows the power_supply uevents; without udev the mains
+  // 'online' node is polled through the shared SensorPoller batch instead
+  m_sensorPoller = std::make_shared< SensorPoller >();
+  if ( m_powerSupply.start() )
+  {
+    m_powerSupplyNotifier = std::make_unique< QSocketNotifier >( m_powerSupply.fd(), QSocketNotifier::Read );
+    QObject::connect( m_powerSupplyNotifier.get(), &QSocketNotifier::activated, this, [this]() {
+      // the tick emits PowerStateChanged; run it now instead of within the next second
+      if ( m_powerSupply.drain() )
+        wake();
+    } );
+  }
+  else if ( const std::string mainsOnline = findMainsOnlinePath(); not mainsOnline.empty() )
+    m_mainsOnlineNode = m_sensorPoller->add( mainsOnline );
+  syslog( LOG_INFO, "SensorPoller: batched sysfs reads via %s", m_sensorPoller->usesIoUring() ? "io_uring" : "pread" );
+
+  // initialize profiles first (safer, doesn't start threads)
+  m_startup.run( "profiles", [this]() { initializeProfiles(); } );
+
+  // Load settings (creates defaults if needed)
+  m_startup.run( "settings", [this]() { loadSettings(); } );
+
+  // Settings JSON with the actual stateMap and charging profile
+  updateDBusSettingsData();
+
+  // Per-application profiles; the first tick switches to one if its application already runs
+  updateWorkloadRules();
+  updateAlertRules();
+
+  // Load autosave
+  m_startup.run( "autosave", [this]() { loadAutosave(); } );
+
+  m_startup.run( "create-workers", [this]() { createWorkers(); } );
+
+  // Keyboard backlight controller: detected alongside, applied here; only
+  // the effects of RGB backlights get a worker
+  {
+    const std::string capsJSON = keyboardCaps.get();
+    m_capabilities.revalidate( "keyboard", capsJSON );
+    m_dbusData.device.update( [&capsJSON]( DeviceSnapshot &device ) {
+      device.keyboardBacklightCapabilitiesJSON = capsJSON;
+    } );
+
+    if ( m_keyboardBacklightController.isAvailable() )
+    {
+      std::string defaultStates = m_keyboardBacklightController.buildDefaultStatesJSON();
+      updateDBusKeyboardBacklightStates( defaultStates );
+
+      if ( m_settings.keyboardBacklightControlEnabled )
+        m_keyboardBacklightController.applyStatesFromJSON( defaultStates );
+
+      // the worker also steps the idle fade, on white backlights too
+      if ( m_keyboardBacklightController.capabilities().maxRed > 0 || m_settings.keyboardIdleTimeoutAcS > 0
+           || m_settings.keyboardIdleTimeoutBatS > 0 )
+      {
+        m_keyboardEffectWorker = std::make_unique< KeyboardEffectWorker >( m_keyboardBacklightController );
+        m_keyboardEffectWorker->start();
+      }
+      armKeyboardIdle();
+    }
+  }
 
-  // Keyboard backlight will be detected during worker initialization
-  m_dbusData.keyboardBacklightCapabilitiesJSON = "null";
-  m_dbusData.keyboardBacklightStatesJSON = "[]";
+  publishSystemInfo();
 
-  // Read all hardware capabilities directly using m_io / sysfs BEFORE any
-  // workers or profiles are created.  This populates TDP limits, NVIDIA
-  // power limits, charging profiles, and YCbCr420 availability with real
-  // hardware values so the D-Bus data is never populated with fake defaults.
-  //
-  // Create the single shared NvmlWrapper instance first — it is reused by
-  // readHardwareCapabilities(), HardwareMonitorWorker, NvidiaOCWorker, and
-  // ProfileSettingsWorker so that NVML is initialised exactly once.
-  m_nvml = std::make_shared< NvmlWrapper >();
-  readHardwareCapabilities();
+  // then setup gpu callback before worker starts processing
+  setupGpuDataCallback();
 
-  // initialize profiles first (safer, doesn't start threads)
-  initializeProfiles();
+  // fill device-specific defaults BEFORE starting workers
+  m_startup.run( "profile-defaults", [this]() {
+    fillDeviceSpecificDefaults( m_defaultProfiles );
+    auto customProfiles = m_customProfiles.list();
+    fillDeviceSpecificDefaults( customProfiles );
+    m_customProfiles.assign( std::move( customProfiles ) );
+    serializeProfilesJSON();
+  } );
 
-  // Load settings (creates defaults if needed)
-  loadSettings();
+  // start workers after all callbacks and data are ready
+  m_startup.run( "start-workers", [this]() {
+    m_profileSettingsWorker->start();  // synchronous: detects ODM profile type + inits charging state
+    m_hardwareMonitorWorker->start();
+    m_displayWorker->start();
+    m_cpuWorker->start();
+    m_fanControlWorker->start();
+  } );
 
-  // Now build settings JSON with actual stateMap
-  m_dbusData.settingsJSON = buildSettingsJSON( m_dbusData.keyboardBacklightStatesJSON,
-                                               m_dbusData.currentChargingProfile,
-                                               m_settings );
+  m_capabilities.flush();
 
-  // Load autosave
-  loadAutosave();
+  // NvidiaOCWorker is built by nvidiaOC() and the water cooler worker by
+  // ensureWaterCooler() when first needed
+}
 
+void UccDBusService::createWorkers()
+{
   // Initialize display worker (merged backlight + refresh rate)
   m_displayWorker = std::make_unique< DisplayWorker >(
     m_autosaveManager.getAutosavePath(),
     [this]() { return m_activeProfile; },
     [this]() { return m_autosave.displayBrightness; },
-    [this]( int32_t brightness ) { m_autosave.displayBrightness = brightness; },
+    [this]( int32_t brightness ) {
+      m_autosave.displayBrightness = brightness;
+      // called on a worker thread; the queue and its timer live on the main one
+      QMetaObject::invokeMethod( this, [this] { persistAutosave(); }, Qt::QueuedConnection );
+    },
     [this]() -> bool { return m_dbusData.isX11; },
     [this]( const std::string &json ) {
-      std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-      m_dbusData.displayModes = json;
+      m_dbusData.device.update( [&json]( DeviceSnapshot &device ) { device.displayModes = json; } );
     },
     [this]( bool isX11 ) { m_dbusData.isX11 = isX11; }
   );
+  m_displayWorker->setBrightnessRamp( std::chrono::milliseconds( m_settings.displayBrightnessRampMs ) );
+  m_displayWorker->setRefreshSaver( m_settings.displayRefreshSaver );
 
   // initialize cpu worker
   m_cpuWorker = std::make_unique< CpuWorker >(
     [this]() { return m_activeProfile; },
     [this]() { return m_settings.cpuSettingsEnabled; },
-    []( const std::string &msg ) { syslog( LOG_INFO, "%s", msg.c_str() ); }
+    []( const std::string &msg ) { ucc::asyncLog( LOG_INFO, msg ); }
   );
 
   // initialize profile settings worker (replaces ODMPowerLimitWorker, ODMProfileWorker, ChargingWorker, YCbCr420WorkaroundWorker)
@@ -2172,18 +3483,17 @@ UccDBusService::UccDBusService()
       m_deviceId.value() == UniwillDeviceID::IBM15A10 );
 
   m_profileSettingsWorker = std::make_unique< ProfileSettingsWorker >(
-    m_io,
+    m_ec,
     m_nvml,
     [this]() -> UccProfile { return m_activeProfile; },
     [this]( const std::vector< std::string > &profiles ) {
-      std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-      m_dbusData.odmProfilesAvailable = profiles;
+      m_capabilities.revalidate( "odm-profiles", encodeODMProfiles( profiles ) );
+      m_dbusData.device.update( [&profiles]( DeviceSnapshot &device ) { device.odmProfilesAvailable = profiles; } );
     },
     [this]( const std::string &json ) {
-      std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-      m_dbusData.odmPowerLimitsJSON = json;
+      m_dbusData.device.update( [&json]( DeviceSnapshot &device ) { device.odmPowerLimitsJSON = json; } );
     },
-    []( const std::string &msg ) { syslog( LOG_INFO, "%s", msg.c_str() ); },
+    []( const std::string &msg ) { ucc::asyncLog( LOG_INFO, msg ); },
     m_settings,
     m_dbusData.modeReapplyPending,
     m_dbusData.nvidiaPowerCTRLDefaultPowerLimit,
@@ -2193,6 +3503,19 @@ UccDBusService::UccDBusService()
     skipAcpiPlatformProfile
   );
 
+  m_reconciler.add( ReconcileTarget{
+    "CPU settings",
+    [this]() { return m_cpuWorker->appliedGeneration(); },
+    [this]() { return m_cpuWorker->validateCpuFreq(); },
+    [this]() { return m_cpuWorker->reapplyProfile(); },
+    { "tuned", "power-profiles-daemon", "auto-cpufreq", "system76-power", "tlp", "tccd" } } );
+  m_reconciler.add( ReconcileTarget{
+    "NVIDIA cTGP offset",
+    [this]() -> uint64_t { return static_cast< uint32_t >( m_profileSettingsWorker->appliedNVIDIACTGPOffset() ); },
+    [this]() { return m_profileSettingsWorker->nvidiaCTGPOffsetInPlace(); },
+    [this]() { return m_profileSettingsWorker->reapplyNVIDIACTGPOffset(); },
+    { "nvidia-powerd", "tccd" } } );
+
   // initialize hardware monitor worker (merged GPU info + CPU power + Prime)
   // Quirk: IBM15A10 has a display mux — prime-select is only supported when
   // the eDP display is NOT wired to the NVIDIA GPU (synced from TCC PrimeWorker).
@@ -2201,19 +3524,27 @@ UccDBusService::UccDBusService()
 
   m_hardwareMonitorWorker = std::make_unique< HardwareMonitorWorker >(
     m_nvml,
-    [this]( const std::string &json, double cpuPowerWatts ) {
-      {
-        std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-        m_dbusData.cpuPowerValuesJSON = json;
-      }
-      // Push CPU power to history store
-      if ( cpuPowerWatts > -1.0 )
-        m_metricsStore.push( MetricId::CpuPower, cpuPowerWatts );
+    m_sensorPoller,
+    m_samplingGovernor,
+    [this]( const std::string &json, const RaplDomainWatts &domainWatts ) {
+      m_dbusData.cpu.update( [&]( CpuSnapshot &cpu ) {
+        cpu.cpuPowerValuesJSON = json;
+        cpu.cpuPowerDraw = domainWatts[ static_cast< size_t >( RaplDomain::Package ) ];
+      } );
+      // Push CPU power per RAPL domain to history store
+      static constexpr std::array< MetricId, RAPL_DOMAIN_COUNT > domainMetrics{ {
+        MetricId::CpuPower, MetricId::CpuPowerCore, MetricId::CpuPowerUncore,
+        MetricId::CpuPowerDram, MetricId::CpuPowerPsys,
+      } };
+      MetricFrame frame;
+      for ( size_t i = 0; i < RAPL_DOMAIN_COUNT; ++i )
+        if ( domainWatts[ i ] > -1.0 )
+          frame.add( domainMetrics[ i ], domainWatts[ i ] );
+      m_metricsStore.pushFrame( frame );
     },
-    [this]() { return m_dbusData.sensorDataCollectionStatus.load(); },
+    [this]() { return activeSensorGroups(); },
     [this]( const std::string &primeState ) {
-      std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-      m_dbusData.primeState = primeState;
+      m_dbusData.gpu.update( [&primeState]( GpuSnapshot &gpu ) { gpu.primeState = primeState; } );
     },
     isDisplayMuxDevice
   );
@@ -2221,9 +3552,9 @@ UccDBusService::UccDBusService()
   // webcam monitoring via HardwareMonitorWorker (replaces former WebcamWorker)
   m_hardwareMonitorWorker->setWebcamCallbacks(
     [this]() -> std::pair< bool, bool > {
-      bool status = false;
-      bool available = m_io.getWebcam( status );
-      return { available, status };
+      EcBatch webcam{ EcRequest::webcam() };
+      const bool available = m_ec.execute( webcam );
+      return { available, webcam[ 0 ].value != 0 };
     },
     [this]( bool available, bool status ) {
       m_dbusData.webcamSwitchAvailable = available;
@@ -2231,197 +3562,279 @@ UccDBusService::UccDBusService()
     }
   );
 
-  // CPU frequency monitoring via HardwareMonitorWorker (every cycle ≈ 800ms)
+  // Thermal throttling, power-limit hits and package idle, with each CPU power sample
+  m_hardwareMonitorWorker->setCpuThrottleCallback( [this]( const CpuThrottleMetrics &throttle ) {
+    MetricFrame frame;
+    if ( throttle.coreThrottlePct >= 0.0 )
+      frame.add( MetricId::CpuThrottleCore, throttle.coreThrottlePct );
+    if ( throttle.packageThrottlePct >= 0.0 )
+      frame.add( MetricId::CpuThrottlePackage, throttle.packageThrottlePct );
+    if ( throttle.powerLimitedPct >= 0.0 )
+      frame.add( MetricId::CpuPowerLimited, throttle.powerLimitedPct );
+    if ( throttle.pkgCstatePct >= 0.0 )
+      frame.add( MetricId::CpuPkgCstate, throttle.pkgCstatePct );
+    m_metricsStore.pushFrame( frame );
+  } );
+
+  // Battery rate, energy and charge level (every cycle ≈ 800ms on systems with a battery)
+  m_hardwareMonitorWorker->setBatteryCallback( [this]( const BatteryMetrics &battery ) {
+    m_batteryDischarging = battery.discharging;
+    MetricFrame frame;
+    if ( battery.powerW >= 0.0 )
+      frame.add( MetricId::BatteryPower, battery.powerW );
+    if ( battery.voltageV >= 0.0 )
+      frame.add( MetricId::BatteryVoltage, battery.voltageV );
+    if ( battery.energyWh >= 0.0 )
+      frame.add( MetricId::BatteryEnergy, battery.energyWh );
+    if ( battery.capacityPct >= 0.0 )
+      frame.add( MetricId::BatteryCapacity, battery.capacityPct );
+    if ( battery.timeToEmptyMin >= 0.0 )
+      frame.add( MetricId::BatteryTimeToEmpty, battery.timeToEmptyMin );
+    if ( battery.systemPowerW >= 0.0 )
+      frame.add( MetricId::SystemPowerOnBattery, battery.systemPowerW );
+    m_metricsStore.pushFrame( frame );
+  } );
+
+  // Per-core CPU frequency / busy time via HardwareMonitorWorker (every cycle ≈ 800ms)
   m_hardwareMonitorWorker->setCpuFrequencyCallback(
-    [this]( int frequencyMHz ) {
-      m_dbusData.cpuFrequencyMHz = frequencyMHz;
-      if ( frequencyMHz > 0 )
-        m_metricsStore.push( MetricId::CpuFrequency, static_cast< double >( frequencyMHz ) );
+    [this, layout = std::vector< int32_t >(), json = std::string()]( const CpuCoreMetrics &cores ) mutable {
+      m_dbusData.cpuFrequencyMHz = cores.avgMHz > 0.0 ? static_cast< int32_t >( std::lround( cores.avgMHz ) ) : -1;
+
+      MetricFrame frame;
+      if ( cores.avgMHz > 0.0 )
+        frame.add( MetricId::CpuFrequency, cores.avgMHz );
+      if ( cores.maxMHz > 0.0 )
+        frame.add( MetricId::CpuFrequencyMax, cores.maxMHz );
+      if ( cores.pCoreAvgMHz > 0.0 )
+        frame.add( MetricId::CpuFrequencyPCore, cores.pCoreAvgMHz );
+      if ( cores.eCoreAvgMHz > 0.0 )
+        frame.add( MetricId::CpuFrequencyECore, cores.eCoreAvgMHz );
+      m_metricsStore.pushFrame( frame );
+
+      if ( layout != cores.cpus )
+      {
+        layout = cores.cpus;
+        std::vector< uint8_t > types;
+        for ( const auto type : cores.types )
+          types.push_back( static_cast< uint8_t >( type ) );
+        m_metricsStore.setCoreLayout( layout, types );
+      }
+      m_metricsStore.pushCores( cores.freqMHz, cores.busyPct );
+
+      if ( m_cpuWorker && m_cpuLoadActive.load() )
+      {
+        // the throttle sample of the previous cycle; "most of the interval" at its power limit
+        static constexpr int64_t MAX_AGE_MS = 3000;
+        const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+          std::chrono::system_clock::now().time_since_epoch() ).count();
+        const auto limited = m_metricsStore.latest( MetricId::CpuPowerLimited );
+        const bool powerLimited = limited && nowMs - limited->timestampMs <= MAX_AGE_MS && limited->value > 50.0;
+        m_cpuWorker->updateForLoad( cores, m_batteryDischarging.load(), powerLimited, SamplingGovernor::nowMs() );
+      }
+
+      JsonWriter w( json );
+      w.beginObject()
+        .key( "source" ).value( cores.effective ? "aperf" : "cpufreq" )
+        .key( "avgMHz" ).value( cores.avgMHz, 0 )
+        .key( "maxMHz" ).value( cores.maxMHz, 0 )
+        .key( "pCoreAvgMHz" ).value( cores.pCoreAvgMHz, 0 )
+        .key( "eCoreAvgMHz" ).value( cores.eCoreAvgMHz, 0 )
+        .key( "cores" ).beginArray();
+      for ( size_t i = 0; i < cores.cpus.size(); ++i )
+      {
+        const CpuCoreType type = cores.types[ i ];
+        w.beginObject()
+          .key( "cpu" ).value( cores.cpus[ i ] )
+          .key( "type" ).value( type == CpuCoreType::Performance ? "P"
+                                : type == CpuCoreType::Efficiency ? "E" : "" )
+          .key( "freqMHz" ).value( cores.freqMHz[ i ], 0 )
+          .key( "busyPct" ).value( cores.busyPct[ i ], 1 )
+          .endObject();
+      }
+      w.endArray().endObject();
+
+      m_dbusData.cpu.update( [&json]( CpuSnapshot &cpu ) { cpu.cpuCoresJSON = json; } );
     }
   );
 
+  // Optionally the fan loop on threads of its own, those and the EC thread
+  // at real-time priority: a fully loaded machine does not delay the fans
+  const auto raiseFanThread = []() {
+    switch ( ucc::raiseCurrentThread( FAN_RT_PRIORITY, FAN_FALLBACK_NICE ) )
+    {
+      case ucc::ThreadPriority::Realtime:
+        break;
+      case ucc::ThreadPriority::Nice:
+        syslog( LOG_WARNING, "Fan control: SCHED_FIFO refused, running at nice %d", FAN_FALLBACK_NICE );
+        break;
+      case ucc::ThreadPriority::Unchanged:
+        syslog( LOG_WARNING, "Fan control: cannot raise the thread priority" );
+        break;
+    }
+  };
+  if ( m_settings.fanControlRealtime )
+  {
+    if ( !ucc::lockProcessMemory() )
+      syslog( LOG_WARNING, "Fan control: mlockall failed, pages may be swapped out" );
+    m_fanScheduler = std::make_unique< WorkerScheduler >( 1, raiseFanThread );
+    m_ec.call( [&raiseFanThread]( DeviceInterface & ) { raiseFanThread(); } );
+    m_fanWatchdog = std::make_shared< FanWatchdog >();
+    syslog( LOG_INFO, "Fan control: real-time loop at SCHED_FIFO %d", FAN_RT_PRIORITY );
+  }
+
   // initialize fan control worker
   m_fanControlWorker = std::make_unique< FanControlWorker >(
-    m_io,
-    [this]() { return m_activeProfile; },
+    m_ec,
+    [this]() -> const UccProfile & { return m_activeProfile; },
     [this]() { return m_settings.fanControlEnabled; },
-    [this]( size_t fanIndex, int64_t timestamp, int speed )
+    [this, extraFans = std::vector< std::pair< MetricId, MetricId > >{}]( const FanTelemetry &telemetry ) mutable
     {
-      {
-        std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
+      if ( not m_fanLimitsRevalidated.exchange( true ) )
+        m_capabilities.revalidate( "fans", encodeFanLimits( telemetry.fans.size(), telemetry.minSpeed,
+                                                            telemetry.offAvailable ) );
+      m_dbusData.fanHwmonAvailable = telemetry.available;
+      m_dbusData.fansMinSpeed = telemetry.minSpeed;
+      m_dbusData.fansOffAvailable = telemetry.offAvailable;
+      m_dbusData.fans.updateRecycled( [&telemetry]( std::vector< FanData > &fans ) {
+        const size_t count = std::min( telemetry.fans.size(), fans.size() );
+        for ( size_t fanIndex = 0; fanIndex < count; ++fanIndex )
+        {
+          fans[ fanIndex ].speed.set( telemetry.timestampMs, telemetry.fans[ fanIndex ].speed );
+          fans[ fanIndex ].temp.set( telemetry.timestampMs, telemetry.fans[ fanIndex ].temp );
+        }
+      } );
 
-        if ( fanIndex < m_dbusData.fans.size() )
-          m_dbusData.fans[fanIndex].speed.set( timestamp, speed );
+      // Push fan duty and temperature to history store
+      MetricFrame frame;
+      if ( !telemetry.fans.empty() )
+      {
+        frame.add( MetricId::CpuFanDuty, telemetry.fans[ 0 ].speed );
+        frame.add( MetricId::CpuTemp, telemetry.fans[ 0 ].temp );
       }
-
-      // Push fan duty to history store
-      if ( fanIndex == 0 )
-        m_metricsStore.push( MetricId::CpuFanDuty, timestamp, speed );
-      else if ( fanIndex == 1 )
-        m_metricsStore.push( MetricId::GpuFanDuty, timestamp, speed );
-    },
-    [this]( size_t fanIndex, int64_t timestamp, int temp )
-    {
+      if ( telemetry.fans.size() > 1 )
       {
-        std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-        if ( fanIndex < m_dbusData.fans.size() )
-          m_dbusData.fans[ fanIndex ].temp.set( timestamp, temp );
+        frame.add( MetricId::GpuFanDuty, telemetry.fans[ 1 ].speed );
+        frame.add( MetricId::GpuTemp, telemetry.fans[ 1 ].temp );
       }
-
-      // Push temperature to history store
-      if ( fanIndex == 0 )
-        m_metricsStore.push( MetricId::CpuTemp, timestamp, temp );
-      else if ( fanIndex == 1 )
-        m_metricsStore.push( MetricId::GpuTemp, timestamp, temp );
-
-      // Auto-control water cooler fan and pump voltage based on CPU temperature
-      if ( m_dbusData.waterCoolerConnected.load() && m_activeProfile.fan.autoControlWC && fanIndex == 0 )
+      // Fans beyond the two built-in ones are registered as "fan3Duty" / "fan3Temp" etc.
+      for ( size_t fanIndex = 2; fanIndex < telemetry.fans.size(); ++fanIndex )
       {
-        try
+        if ( extraFans.size() < fanIndex - 1 )
         {
-          // Apply asymmetric EWMA to the raw sensor reading so that the
-          // water-cooler fan and pump see a smooth temperature signal,
-          // matching the filtering the main fan control loop uses.
-          if ( m_wcTempFiltered < 0.0 )
-            m_wcTempFiltered = static_cast< double >( temp );
-          else
-          {
-            const double alpha = ( temp > m_wcTempFiltered )
-                                   ? WC_TEMP_ALPHA_RISING : WC_TEMP_ALPHA_FALLING;
-            m_wcTempFiltered += alpha * ( static_cast< double >( temp ) - m_wcTempFiltered );
-          }
-          const int wcTemp = static_cast< int >( std::round( m_wcTempFiltered ) );
-
-          const std::string &fpName = m_activeProfile.fan.fanProfile;
-          FanProfile fp = getDefaultFanProfile( fpName );
-
-          // Overlay water cooler fan table from profile or temporary curves
-          if ( m_fanControlWorker && m_fanControlWorker->hasTemporaryCurves() )
-          {
-            const auto &wcTable = m_fanControlWorker->tempWaterCoolerFanTable();
-            if ( !wcTable.empty() )
-            {
-              fp.tableWaterCoolerFan = wcTable;
-            }
-          }
-          else if ( !m_activeProfile.fan.tableWaterCoolerFan.empty() )
-          {
-            fp.tableWaterCoolerFan = m_activeProfile.fan.tableWaterCoolerFan;
-          }
-
-          // Overlay pump table from temporary curves or from the active profile
-          if ( m_fanControlWorker && m_fanControlWorker->hasTemporaryCurves() )
-          {
-            const auto &pTable = m_fanControlWorker->tempPumpTable();
-            if ( !pTable.empty() )
-            {
-              fp.tablePump = pTable;
-            }
-          }
-          else if ( !m_activeProfile.fan.tablePump.empty() )
-          {
-            fp.tablePump = m_activeProfile.fan.tablePump;
-          }
-
-          const int snappedTemp = ( ( wcTemp + 2 ) / 5 ) * 5;  // round to nearest 5°C
-          const int wcFanSpeed = fp.getWaterCoolerFanSpeedForTemp( snappedTemp );
-          m_waterCoolerWorker->setFanSpeed( wcFanSpeed );
-
-          // Temperature LED mode: compute gradient color from fan speed
-          if ( m_waterCoolerLedMode.load() == static_cast< int32_t >( ucc::RGBState::Temperature ) )
-          {
-            const float t = static_cast< float >( std::clamp( wcFanSpeed, 0, 100 ) ) / 100.0f;
-            const int ledR = static_cast< int >( t * 255.0f );
-            const int ledG = 0;
-            const int ledB = static_cast< int >( ( 1.0f - t ) * 255.0f );
-            m_waterCoolerWorker->setLEDColor( ledR, ledG, ledB,
-              static_cast< int >( ucc::RGBState::Static ) );
-          }
-
-          // Auto-control pump voltage with hysteresis.
-          // Step-up happens immediately at the table threshold; step-down requires
-          // the temperature to fall at least PUMP_HYSTERESIS_DEG below the
-          // threshold that last triggered an upward transition.
-          static constexpr ucc::PumpVoltage pumpIdxToVoltage[] = {
-              ucc::PumpVoltage::Off, ucc::PumpVoltage::V7, ucc::PumpVoltage::V8,
-              ucc::PumpVoltage::V11, ucc::PumpVoltage::V12 };
-
-          int rawIdx = 0;
-          for ( const auto &[t, s] : fp.tablePump )
-          {
-            if ( wcTemp >= t ) rawIdx = std::min( s, 4 );
-            else               break;
-          }
-
-          if ( rawIdx > m_pumpHysSpeedIdx )
-          {
-            // Temperature rising – apply new level and record its table threshold.
-            m_pumpHysSpeedIdx = rawIdx;
-            m_pumpHysThreshold = 0;
-            for ( const auto &[t, s] : fp.tablePump )
-              if ( std::min( s, 4 ) == rawIdx ) { m_pumpHysThreshold = t; break; }
-          }
-          else if ( rawIdx < m_pumpHysSpeedIdx )
-          {
-            // Temperature falling – only step down once we are past the dead-band.
-            if ( wcTemp < m_pumpHysThreshold - PUMP_HYSTERESIS_DEG )
-            {
-              m_pumpHysSpeedIdx = rawIdx;
-              m_pumpHysThreshold = 0;
-              for ( const auto &[t, s] : fp.tablePump )
-                if ( std::min( s, 4 ) == rawIdx ) { m_pumpHysThreshold = t; break; }
-            }
-          }
-
-          const ucc::PumpVoltage pumpSpeedValue =
-              pumpIdxToVoltage[ std::clamp( m_pumpHysSpeedIdx, 0, 4 ) ];
-          m_waterCoolerWorker->setPumpVoltage( static_cast<int>( pumpSpeedValue ) );
-
-          // std::cout << "[Auto WC] Temp: " << temp << "°C, Fan: " << wcFanSpeed
-          //           << "%, Pump Voltage: " << static_cast<int>(pumpSpeedValue) << std::endl;
+          MetricRegistry &registry = m_metricsStore.registry();
+          const std::string fan = "fan" + std::to_string( fanIndex + 1 );
+          const auto duty = registry.add( fan + "Duty", "%", "duty", statsBinSpec( MetricId::CpuFanDuty ) );
+          const auto temp = registry.add( fan + "Temp", "°C", "temp", statsBinSpec( MetricId::CpuTemp ) );
+          if ( !duty || !temp )
+            break;
+          extraFans.emplace_back( *duty, *temp );
+          // saved rules on this fan were waiting for its metrics
+          m_alertEngine.metricsRegistered( registry );
         }
-        catch ( ... ) { /* ignore errors in water cooler auto-control */ }
+        frame.add( extraFans[ fanIndex - 2 ].first, telemetry.fans[ fanIndex ].speed );
+        frame.add( extraFans[ fanIndex - 2 ].second, telemetry.fans[ fanIndex ].temp );
       }
-    }
+      m_metricsStore.pushFrame( telemetry.timestampMs, frame );
+
+      if ( !telemetry.fans.empty() )
+        autoControlWaterCooler( telemetry.fans[ 0 ].temp );
+    },
+    m_samplingGovernor,
+    m_fanScheduler ? *m_fanScheduler : WorkerScheduler::instance()
   );
 
-  // Initialize keyboard backlight controller (synchronous — no worker thread)
-  {
-    std::string capsJSON = m_keyboardBacklightController.init();
-    m_dbusData.keyboardBacklightCapabilitiesJSON = capsJSON;
+  m_fanControlWorker->setFastLoop( m_settings.fanControlFastLoop );
+  m_fanControlWorker->setLatencyTrace( m_fanTrace );
+  if ( m_fanWatchdog )
+  {
+    m_fanControlWorker->setWatchdog( m_fanWatchdog );
+    m_fanWatchdog->start( [this]() {
+      syslog( LOG_WARNING, "Fan control: loop missed its deadline, fans handed to the EC" );
+      EcBatch fansAuto{ EcRequest::setFansAuto() };
+      m_ec.execute( fansAuto );
+      // taken back, every duty re-sent, once the loop runs again
+      m_fanControlWorker->resendFanSpeeds();
+    }, raiseFanThread );
+  }
+
+  // PID fan profiles feed forward on the latest package power
+  m_fanControlWorker->setPackagePowerProvider( [this]( FanLogicType type ) {
+    static constexpr int64_t MAX_AGE_MS = 3000;
+    const auto sample = m_metricsStore.latest( type == FanLogicType::CPU ? MetricId::CpuPower : MetricId::GpuPower );
+    const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::system_clock::now().time_since_epoch() ).count();
+    if ( !sample || nowMs - sample->timestampMs > MAX_AGE_MS )
+      return -1.0;
+    return sample->value;
+  } );
+  m_fanControlWorker->setPowerTrendProvider( [this]( FanLogicType type, std::vector< MetricDataPoint > &points ) {
+    static constexpr int64_t WINDOW_MS = 4000;
+    const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::system_clock::now().time_since_epoch() ).count();
+    points.clear();
+    m_metricsStore.copySince( type == FanLogicType::CPU ? MetricId::CpuPower : MetricId::GpuPower,
+                              nowMs - WINDOW_MS, points );
+    return FanPowerTrend::fromSamples( points );
+  } );
+
+  // the fan response measured on this machine, if any, tunes the fan logics
+  const std::string dmi = CapabilityIdentity::read( {} ).dmi;
+  if ( auto model = FanResponseModel::load( dmi ) )
+  {
+    syslog( LOG_INFO, "Fan control: using the stored fan response model" );
+    m_fanControlWorker->setResponseModel( std::move( model->fans ) );
+  }
+  m_fanControlWorker->setCalibrationCallback( [this, dmi]( const std::vector< FanResponse > &fans ) {
+    // written from the main thread, off the fan loop
+    QMetaObject::invokeMethod( this, [dmi, fans]() {
+      if ( !FanResponseModel{ dmi, fans }.save() )
+        syslog( LOG_WARNING, "Fan control: cannot store the fan response model" );
+    }, Qt::QueuedConnection );
+  } );
+}
+
+NvidiaOCWorker *UccDBusService::nvidiaOC()
+{
+  if ( !m_dbusData.deviceSupported.load() )
+    return nullptr;
 
-    if ( m_keyboardBacklightController.isAvailable() )
-    {
-      std::string defaultStates = m_keyboardBacklightController.buildDefaultStatesJSON();
-      m_dbusData.keyboardBacklightStatesJSON = defaultStates;
+  std::call_once( m_nvidiaOCOnce, [this]() {
+    const StartupTimeline::Scope phase( m_startup, "nvidia-oc", StartupTimeline::Lane::Deferred );
+    // non-threaded, on-demand calls via D-Bus
+    if ( m_nvml )
+      m_nvml->initOcFeatures();
+    m_nvidiaOCWorker = std::make_unique< NvidiaOCWorker >(
+      m_nvml,
+      []( const std::string &msg ) { ucc::asyncLog( LOG_INFO, msg ); }
+    );
+    rebuildBuiltinGpuProfiles();
+  } );
+  return m_nvidiaOCWorker.get();
+}
 
-      if ( m_settings.keyboardBacklightControlEnabled )
-        m_keyboardBacklightController.applyStatesFromJSON( defaultStates );
-    }
-  }
+const std::vector< UccDBusService::BuiltinGpuProfile > &UccDBusService::builtinGpuProfiles()
+{
+  nvidiaOC();
+  return m_builtinGpuProfiles;
+}
 
-  // then setup gpu callback before worker starts processing
-  setupGpuDataCallback();
+LCTWaterCoolerWorker *UccDBusService::ensureWaterCooler()
+{
+  if ( auto *worker = waterCooler() )
+    return worker;
 
-  // fill device-specific defaults BEFORE starting workers
-  fillDeviceSpecificDefaults( m_defaultProfiles );
-  fillDeviceSpecificDefaults( m_customProfiles );
-  serializeProfilesJSON();
-
-  // start worker threads after all callbacks and data are ready
-  m_profileSettingsWorker->start();  // synchronous: detects ODM profile type + inits charging state
-  m_hardwareMonitorWorker->start();
-  m_displayWorker->start();
-  m_cpuWorker->start();
-  m_fanControlWorker->start();
-
-  // Initialize NVIDIA OC worker (non-threaded, on-demand calls via D-Bus)
-  m_nvidiaOCWorker = std::make_unique< NvidiaOCWorker >(
-    m_nvml,
-    []( const std::string &msg ) { syslog( LOG_INFO, "%s", msg.c_str() ); }
-  );
+  // a QObject with timers and BLE agents: it must live on the main thread
+  if ( QThread::currentThread() != thread() )
+  {
+    QMetaObject::invokeMethod( this, [this]() { ensureWaterCooler(); }, Qt::BlockingQueuedConnection );
+    return waterCooler();
+  }
 
-  rebuildBuiltinGpuProfiles();
+  const StartupTimeline::Scope phase( m_startup, "water-cooler", StartupTimeline::Lane::Deferred );
+  m_waterCoolerWorker = std::make_unique< LCTWaterCoolerWorker >( m_dbusData );
+  m_waterCoolerWorker->setMetricsStore( &m_metricsStore );
+  m_waterCooler.store( m_waterCoolerWorker.get(), std::memory_order_release );
+  return m_waterCoolerWorker.get();
 }
 
 int UccDBusService::readCurrentCTGPOffset() const
@@ -2503,28 +3916,102 @@ void UccDBusService::rebuildBuiltinGpuProfiles()
   m_builtinGpuProfiles.push_back( builtin );
 }
 
+void UccDBusService::openCapabilityProfile()
+{
+  std::string moduleVersion;
+  m_ec.call( [this, &moduleVersion]( DeviceInterface & ) { return m_io.getModuleVersion( moduleVersion ); } );
+  m_capabilityProfileFound = m_capabilities.open( CapabilityIdentity::read( moduleVersion ) );
+  if ( not m_capabilityProfileFound )
+  {
+    syslog( LOG_INFO, "[Capabilities] No stored profile for this machine, probing" );
+    return;
+  }
+  syslog( LOG_INFO, "[Capabilities] Answering from the stored profile, revalidating in the background" );
+
+  // the keyboard capabilities are published with the other startup defaults
+  if ( const auto systemInfo = m_capabilities.find( "system-info" ) )
+    m_dbusData.device.update( [&systemInfo]( DeviceSnapshot &device ) { device.systemInfoJSON = *systemInfo; } );
+  if ( const auto profiles = m_capabilities.find( "odm-profiles" ) )
+    m_dbusData.device.update( [odm = decodeODMProfiles( *profiles )]( DeviceSnapshot &device ) {
+      device.odmProfilesAvailable = odm;
+    } );
+  if ( const auto fans = m_capabilities.find( "fans" ) )
+  {
+    std::istringstream limits( *fans );
+    size_t count = 0;
+    int32_t minSpeed = 0;
+    int offAvailable = 0;
+    if ( limits >> count >> minSpeed >> offAvailable )
+    {
+      m_dbusData.fanHwmonAvailable = count > 0;
+      m_dbusData.fansMinSpeed = minSpeed;
+      m_dbusData.fansOffAvailable = offAvailable != 0;
+    }
+  }
+}
+
+void UccDBusService::revalidateCapabilities()
+{
+  // without a profile everything was probed at startup; the keyboard, fan
+  // and ODM probes run anyway and revalidate their facts themselves
+  if ( not m_capabilityProfileFound )
+    return;
+
+  m_systemInfo = detectSystemInfo( m_deviceId );
+  const std::string systemInfoJSON = m_systemInfo.toJSON();
+  if ( m_capabilities.revalidate( "system-info", systemInfoJSON ) )
+  {
+    syslog( LOG_INFO, "[Capabilities] System info changed since the stored profile" );
+    m_dbusData.device.update( [&systemInfoJSON]( DeviceSnapshot &device ) { device.systemInfoJSON = systemInfoJSON; } );
+  }
+
+  if ( m_dbusData.deviceSupported.load() )
+  {
+    const std::vector< TDPInfo > tdps = m_ec.call( ProfileSettingsWorker::readTDPInfo );
+    if ( const auto encoded = encodeTDPLimits( tdps ); encoded and m_capabilities.revalidate( "tdp-limits", *encoded ) )
+      syslog( LOG_INFO, "[Capabilities] TDP limits changed since the stored profile" );
+  }
+}
+
+std::vector< TDPInfo > UccDBusService::readTDPInfo()
+{
+  // descriptors and limits from the capability profile, only the current values from the EC
+  if ( const auto cached = m_capabilities.find( "tdp-limits" ) )
+  {
+    if ( auto tdps = decodeTDPLimits( *cached ) )
+    {
+      EcBatch current;
+      for ( size_t i = 0; i < tdps->size(); ++i )
+        current.push_back( EcRequest::tdp( static_cast< int >( i ) ) );
+      m_ec.execute( current );
+      for ( size_t i = 0; i < tdps->size(); ++i )
+        ( *tdps )[ i ].current = current[ i ].ok ? static_cast< uint32_t >( current[ i ].value ) : 0;
+      return std::move( *tdps );
+    }
+  }
+
+  std::vector< TDPInfo > tdps = m_ec.call( ProfileSettingsWorker::readTDPInfo );
+  if ( const auto encoded = encodeTDPLimits( tdps ) )
+    m_capabilities.revalidate( "tdp-limits", *encoded );
+  return tdps;
+}
+
 void UccDBusService::readHardwareCapabilities()
 {
   syslog( LOG_INFO, "[uccd] Reading hardware capabilities directly" );
 
   // ---- ODM Power Limits (TDP) ----
-  // Read from TuxedoIOAPI — identical logic to ProfileSettingsWorker::getTDPInfo()
+  // Limits from the capability profile when known, see readTDPInfo()
   {
-    int nrTDPs = 0;
-    if ( m_io.getNumberTDPs( nrTDPs ) and nrTDPs > 0 )
+    const std::vector< TDPInfo > tdps = readTDPInfo();
+    if ( not tdps.empty() )
     {
-      std::vector< std::string > descriptors;
-      m_io.getTDPDescriptors( descriptors );
-
       std::ostringstream jsonStream;
       jsonStream << "[";
 
-      for ( int i = 0; i < nrTDPs; ++i )
+      for ( size_t i = 0; i < tdps.size(); ++i )
       {
-        uint32_t current = 0, min = 0, max = 0;
-        m_io.getTDPMin( i, reinterpret_cast< int & >( min ) );
-        m_io.getTDPMax( i, reinterpret_cast< int & >( max ) );
-        m_io.getTDP( i, reinterpret_cast< int & >( current ) );
+        const uint32_t current = tdps[ i ].current, min = tdps[ i ].min, max = tdps[ i ].max;
 
         if ( i > 0 )
           jsonStream << ",";
@@ -2535,16 +4022,16 @@ void UccDBusService::readHardwareCapabilities()
                    << "\"max\":" << max
                    << "}";
 
-        syslog( LOG_INFO, "[uccd] TDP[%d]: min=%u, max=%u, current=%u", i, min, max, current );
+        syslog( LOG_INFO, "[uccd] TDP[%zu]: min=%u, max=%u, current=%u", i, min, max, current );
       }
 
       jsonStream << "]";
-      m_dbusData.odmPowerLimitsJSON = jsonStream.str();
+      m_dbusData.device.update( [json = jsonStream.str()]( DeviceSnapshot &device ) { device.odmPowerLimitsJSON = json; } );
     }
     else
     {
       syslog( LOG_INFO, "[uccd] No TDP hardware available" );
-      m_dbusData.odmPowerLimitsJSON = "[]";
+      m_dbusData.device.update( []( DeviceSnapshot &device ) { device.odmPowerLimitsJSON = "[]"; } );
     }
   }
 
@@ -2597,6 +4084,8 @@ void UccDBusService::readHardwareCapabilities()
     static const std::string CHARGING_PRIORITIES_AVAILABLE_PATH =
       "/sys/devices/platform/tuxedo_keyboard/charging_priority/charging_prios_available";
 
+    ChargingSnapshot charging = *m_dbusData.charging.load();
+
     // Charging profiles
     if ( SysfsNode< std::string >( CHARGING_PROFILE_PATH ).isAvailable() and
          SysfsNode< std::string >( CHARGING_PROFILES_AVAILABLE_PATH ).isAvailable() )
@@ -2612,15 +4101,15 @@ void UccDBusService::readHardwareCapabilities()
           oss << "\"" << ( *profiles )[ i ] << "\"";
         }
         oss << "]";
-        m_dbusData.chargingProfilesAvailable = oss.str();
+        charging.chargingProfilesAvailable = oss.str();
 
         auto current = SysfsNode< std::string >( CHARGING_PROFILE_PATH ).read();
         if ( current.has_value() )
-          m_dbusData.currentChargingProfile = *current;
+          charging.currentChargingProfile = *current;
 
         syslog( LOG_INFO, "[uccd] Charging profiles: %s, current: %s",
-                m_dbusData.chargingProfilesAvailable.c_str(),
-                m_dbusData.currentChargingProfile.c_str() );
+                charging.chargingProfilesAvailable.c_str(),
+                charging.currentChargingProfile.c_str() );
       }
     }
 
@@ -2639,11 +4128,11 @@ void UccDBusService::readHardwareCapabilities()
           oss << "\"" << ( *prios )[ i ] << "\"";
         }
         oss << "]";
-        m_dbusData.chargingPrioritiesAvailable = oss.str();
+        charging.chargingPrioritiesAvailable = oss.str();
 
         auto current = SysfsNode< std::string >( CHARGING_PRIORITY_PATH ).read();
         if ( current.has_value() )
-          m_dbusData.currentChargingPriority = *current;
+          charging.currentChargingPriority = *current;
       }
     }
 
@@ -2658,15 +4147,15 @@ void UccDBusService::readHardwareCapabilities()
       auto chargeType = battery->getChargeType();
       switch ( chargeType )
       {
-        case ChargeType::Trickle:      m_dbusData.chargeType = "Trickle"; break;
-        case ChargeType::Fast:         m_dbusData.chargeType = "Fast"; break;
-        case ChargeType::Standard:     m_dbusData.chargeType = "Standard"; break;
-        case ChargeType::Adaptive:     m_dbusData.chargeType = "Adaptive"; break;
-        case ChargeType::Custom:       m_dbusData.chargeType = "Custom"; break;
-        case ChargeType::LongLife:     m_dbusData.chargeType = "LongLife"; break;
-        case ChargeType::Bypass:       m_dbusData.chargeType = "Bypass"; break;
-        case ChargeType::NotAvailable: m_dbusData.chargeType = "N/A"; break;
-        default:                       m_dbusData.chargeType = "Unknown"; break;
+        case ChargeType::Trickle:      charging.chargeType = "Trickle"; break;
+        case ChargeType::Fast:         charging.chargeType = "Fast"; break;
+        case ChargeType::Standard:     charging.chargeType = "Standard"; break;
+        case ChargeType::Adaptive:     charging.chargeType = "Adaptive"; break;
+        case ChargeType::Custom:       charging.chargeType = "Custom"; break;
+        case ChargeType::LongLife:     charging.chargeType = "LongLife"; break;
+        case ChargeType::Bypass:       charging.chargeType = "Bypass"; break;
+        case ChargeType::NotAvailable: charging.chargeType = "N/A"; break;
+        default:                       charging.chargeType = "Unknown"; break;
       }
 
       // Threshold ranges
@@ -2683,7 +4172,7 @@ void UccDBusService::readHardwareCapabilities()
           oss << startThresholds[ i ];
         }
         oss << "]";
-        m_dbusData.chargeStartAvailableThresholds = oss.str();
+        charging.chargeStartAvailableThresholds = oss.str();
       }
 
       if ( !endThresholds.empty() )
@@ -2696,9 +4185,11 @@ void UccDBusService::readHardwareCapabilities()
           oss << endThresholds[ i ];
         }
         oss << "]";
-        m_dbusData.chargeEndAvailableThresholds = oss.str();
+        charging.chargeEndAvailableThresholds = oss.str();
       }
     }
+
+    m_dbusData.charging.store( std::move( charging ) );
   }
 
   // ---- YCbCr 4:2:0 ----
@@ -2727,103 +4218,251 @@ void UccDBusService::readHardwareCapabilities()
   }
 
   // Rebuild settings JSON with real charging data
-  m_dbusData.settingsJSON = buildSettingsJSON( m_dbusData.keyboardBacklightStatesJSON,
-                                               m_dbusData.currentChargingProfile,
-                                               m_settings );
+  updateDBusSettingsData();
 }
 
 void UccDBusService::setupGpuDataCallback()
 {
   // Set up callback to update DBus data when GPU info is collected
+  // State and scratch buffers live in the callback: worker cycles may run
+  // on any scheduler thread, but never two at once.
   m_hardwareMonitorWorker->setGpuDataCallback(
-    [this]( const IGpuInfo &iGpuInfo, const DGpuInfo &dGpuInfo )
+    [this, iGpuJSON = std::string(), dGpuJSON = std::string(), dGpuListJSON = std::string(),
+     lastPerfLimitReason = std::string( "None" ),
+     lastPushedMs = std::array< int64_t, static_cast< size_t >( MetricId::Count ) >{}](
+      const IGpuInfo &iGpuInfo, const std::vector< DGpuInfo > &dGpuInfos, const GpuSampleBatch *gpuSamples ) mutable
     {
       // safety check - ensure we're not being called during destruction
-      if ( not m_started )
+      if ( not m_started or dGpuInfos.empty() )
         return;
 
-      std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
+      const DGpuInfo &dGpuInfo = dGpuInfos.front();
 
-      // Convert GPU structures to JSON and update DBus data
-      m_dbusData.iGpuInfoValuesJSON = igpuInfoToJSON( iGpuInfo );
-      m_dbusData.dGpuInfoValuesJSON = dgpuInfoToJSON( dGpuInfo );
+      // Serialise into the callback's buffers, whose capacity is retained
+      // across ticks, then publish them as a new snapshot
+      igpuInfoToJSON( iGpuInfo, iGpuJSON );
+      dgpuInfoToJSON( dGpuInfo, dGpuJSON );
+      dgpuInfoListToJSON( dGpuInfos, dGpuListJSON );
 
-      // Push GPU metrics to history store (outside dataMutex — store has its own lock)
       const auto now = std::chrono::duration_cast< std::chrono::milliseconds >(
         std::chrono::system_clock::now().time_since_epoch() ).count();
 
+      m_dbusData.gpu.update( [&]( GpuSnapshot &gpu ) {
+        gpu.iGpuInfoValuesJSON.assign( iGpuJSON );
+        gpu.dGpuInfoValuesJSON.assign( dGpuJSON );
+        gpu.dGpuInfoListJSON.assign( dGpuListJSON );
+        gpu.dGpuInfo = dGpuInfo;
+        gpu.iGpuInfo = iGpuInfo;
+      } );
+
+      // Expose dGPU temperature through fan data for UI compatibility
+      if ( dGpuInfo.m_temp > -1.0 )
+      {
+        m_dbusData.fans.updateRecycled( [&]( std::vector< FanData > &fans ) {
+          if ( fans.size() > 1 )
+            fans[ 1 ].temp.set( static_cast< int64_t >( now ),
+                                static_cast< int32_t >( std::lround( dGpuInfo.m_temp ) ) );
+        } );
+      }
+
+      // Annotate the timeline when the NVML perf cap changes.  Idle and
+      // "no reason available" count as uncapped so idle GPUs stay quiet.
+      {
+        const std::string &reason = dGpuInfo.m_perfLimitReason;
+        const bool uncapped = reason.empty() || reason == "None" || reason == "Idle";
+        const std::string_view current = uncapped ? std::string_view( "None" ) : std::string_view( reason );
+        if ( current != lastPerfLimitReason )
+        {
+          m_metricsStore.recordEvent( now, ucc::MetricEventKind::GpuPerfLimit, uncapped ? 0 : 1, current );
+          lastPerfLimitReason.assign( current );
+        }
+      }
+
+      // Push GPU metrics to history store (lock-free, independent of the snapshots).
+      // The instantaneous readings go out as one frame at 'now'.  Sample-buffer
+      // points are older than 'now', so while they are being drained they
+      // replace the instantaneous readings of the same series, and every
+      // series only ever moves forward in time.
+      MetricFrame frame;
+      const auto advance = [&lastPushedMs]( MetricId id, int64_t timestampMs ) {
+        int64_t &last = lastPushedMs[ static_cast< size_t >( id ) ];
+        if ( timestampMs <= last )
+          return false;
+        last = timestampMs;
+        return true;
+      };
+      const auto pushGpu = [&advance, &frame, now]( MetricId id, double value ) {
+        if ( advance( id, now ) )
+          frame.add( id, value );
+      };
+      const auto pushSamples = [this, &advance]( MetricId id, const std::vector< NvmlSample > &points ) {
+        for ( const auto &pt : points )
+          if ( advance( id, pt.timestampMs ) )
+            m_metricsStore.push( id, pt.timestampMs, pt.value );
+      };
+
       if ( dGpuInfo.m_temp > -1.0 )
-        m_metricsStore.push( MetricId::GpuTemp, now, dGpuInfo.m_temp );
-      if ( dGpuInfo.m_coreFrequency > -1.0 )
-        m_metricsStore.push( MetricId::GpuFrequency, now, dGpuInfo.m_coreFrequency );
-      if ( dGpuInfo.m_powerDraw > -1.0 )
-        m_metricsStore.push( MetricId::GpuPower, now, dGpuInfo.m_powerDraw );
-      if ( dGpuInfo.m_vramFrequency > -1.0 )
-        m_metricsStore.push( MetricId::GpuVramFrequency, now, dGpuInfo.m_vramFrequency );
+        pushGpu( MetricId::GpuTemp, dGpuInfo.m_temp );
       if ( dGpuInfo.m_coreVoltageMv > -1 )
-        m_metricsStore.push( MetricId::GpuCoreVoltage, now,
-                             static_cast< double >( dGpuInfo.m_coreVoltageMv ) );
+        pushGpu( MetricId::GpuCoreVoltage, static_cast< double >( dGpuInfo.m_coreVoltageMv ) );
 
-      // Expose dGPU temperature through fan data for UI compatibility
-      if ( dGpuInfo.m_temp > -1.0 and m_dbusData.fans.size() > 1 )
+      if ( gpuSamples )
+      {
+        pushSamples( MetricId::GpuPower, gpuSamples->powerW );
+        pushSamples( MetricId::GpuComputeUtil, gpuSamples->computeUtilPct );
+        pushSamples( MetricId::GpuMemoryUtil, gpuSamples->memoryUtilPct );
+        pushSamples( MetricId::GpuFrequency, gpuSamples->coreClockMHz );
+        pushSamples( MetricId::GpuVramFrequency, gpuSamples->memClockMHz );
+      }
+      else
       {
-        m_dbusData.fans[ 1 ].temp.set(
-          static_cast< int64_t >( now ),
-          static_cast< int32_t >( std::lround( dGpuInfo.m_temp ) ) );
+        if ( dGpuInfo.m_coreFrequency > -1.0 )
+          pushGpu( MetricId::GpuFrequency, dGpuInfo.m_coreFrequency );
+        if ( dGpuInfo.m_powerDraw > -1.0 )
+          pushGpu( MetricId::GpuPower, dGpuInfo.m_powerDraw );
+        if ( dGpuInfo.m_vramFrequency > -1.0 )
+          pushGpu( MetricId::GpuVramFrequency, dGpuInfo.m_vramFrequency );
+        if ( dGpuInfo.m_computeUtilPct > -1 )
+          pushGpu( MetricId::GpuComputeUtil, static_cast< double >( dGpuInfo.m_computeUtilPct ) );
+        if ( dGpuInfo.m_memoryUtilPct > -1 )
+          pushGpu( MetricId::GpuMemoryUtil, static_cast< double >( dGpuInfo.m_memoryUtilPct ) );
       }
+
+      // Second NVIDIA GPU (eGPU, dual dGPU) gets its own series
+      if ( dGpuInfos.size() > 1 )
+      {
+        const DGpuInfo &second = dGpuInfos[ 1 ];
+        if ( second.m_temp > -1.0 )
+          pushGpu( MetricId::Gpu2Temp, second.m_temp );
+        if ( second.m_powerDraw > -1.0 )
+          pushGpu( MetricId::Gpu2Power, second.m_powerDraw );
+        if ( second.m_coreFrequency > -1.0 )
+          pushGpu( MetricId::Gpu2Frequency, second.m_coreFrequency );
+      }
+
+      m_metricsStore.pushFrame( now, frame );
     }
   );
 }
 
-void UccDBusService::updateFanData()
+void UccDBusService::autoControlWaterCooler( int temp )
 {
-  int numberFans = 0;
-  bool fansAvailable = m_io.getNumberFans( numberFans ) && numberFans > 0;
-
-  // If getNumberFans fails, try to detect fans by reading temperature from fan 0
-  if ( !fansAvailable )
+  // Auto-control water cooler fan and pump voltage based on CPU temperature
+  auto *waterCoolerWorker = waterCooler();
+  if ( waterCoolerWorker && m_dbusData.waterCoolerConnected.load() && m_activeProfile.fan.autoControlWC )
   {
-    int temp = -1;
-    if ( m_io.getFanTemperature( 0, temp ) && temp >= 0 )
+    try
     {
-      // We can read from at least fan 0, assume fans are available
-      fansAvailable = true;
-      numberFans = 2; // Assume CPU and GPU fans
-      syslog( LOG_INFO, "UccDBusService: Detected fans by temperature reading (getNumberFans failed)" );
-    }
-  }
+      // Apply asymmetric EWMA to the raw sensor reading so that the
+      // water-cooler fan and pump see a smooth temperature signal,
+      // matching the filtering the main fan control loop uses.
+      if ( m_wcTempFiltered < 0.0 )
+        m_wcTempFiltered = static_cast< double >( temp );
+      else
+      {
+        const double alpha = ( temp > m_wcTempFiltered )
+                               ? WC_TEMP_ALPHA_RISING : WC_TEMP_ALPHA_FALLING;
+        m_wcTempFiltered += alpha * ( static_cast< double >( temp ) - m_wcTempFiltered );
+      }
+      const int wcTemp = static_cast< int >( std::round( m_wcTempFiltered ) );
 
-  int minSpeed = 0;
-  bool fansOffAvailable = false;
-  ( void ) m_io.getFansMinSpeed( minSpeed );
-  ( void ) m_io.getFansOffAvailable( fansOffAvailable );
+      const std::string &fpName = m_activeProfile.fan.fanProfile;
+      FanProfile fp = getDefaultFanProfile( fpName );
 
-  const auto now = std::chrono::duration_cast< std::chrono::milliseconds >(
-    std::chrono::system_clock::now().time_since_epoch() ).count();
+      // Overlay water cooler fan table from profile or temporary curves
+      if ( m_fanControlWorker && m_fanControlWorker->hasTemporaryCurves() )
+      {
+        const auto &wcTable = m_fanControlWorker->tempWaterCoolerFanTable();
+        if ( !wcTable.empty() )
+        {
+          fp.tableWaterCoolerFan = wcTable;
+        }
+      }
+      else if ( !m_activeProfile.fan.tableWaterCoolerFan.empty() )
+      {
+        fp.tableWaterCoolerFan = m_activeProfile.fan.tableWaterCoolerFan;
+      }
 
-  std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-  m_dbusData.fanHwmonAvailable = fansAvailable;
-  m_dbusData.fansMinSpeed = minSpeed;
-  m_dbusData.fansOffAvailable = fansOffAvailable;
+      // Overlay pump table from temporary curves or from the active profile
+      if ( m_fanControlWorker && m_fanControlWorker->hasTemporaryCurves() )
+      {
+        const auto &pTable = m_fanControlWorker->tempPumpTable();
+        if ( !pTable.empty() )
+        {
+          fp.tablePump = pTable;
+        }
+      }
+      else if ( !m_activeProfile.fan.tablePump.empty() )
+      {
+        fp.tablePump = m_activeProfile.fan.tablePump;
+      }
 
-  if ( not fansAvailable )
-    return;
+      const int snappedTemp = ( ( wcTemp + 2 ) / 5 ) * 5;  // round to nearest 5°C
+      const int wcFanSpeed = fp.getWaterCoolerFanSpeedForTemp( snappedTemp );
+      waterCoolerWorker->setFanSpeed( wcFanSpeed );
 
-  const int maxFans = std::min( numberFans, static_cast< int >( m_dbusData.fans.size() ) );
-  for ( int fanIndex = 0; fanIndex < maxFans; ++fanIndex )
-  {
-    int speedPercent = -1;
-    int tempCelsius = -1;
+      // Temperature LED mode: compute gradient color from fan speed
+      if ( m_waterCoolerLedMode.load() == static_cast< int32_t >( ucc::RGBState::Temperature ) )
+      {
+        const float t = static_cast< float >( std::clamp( wcFanSpeed, 0, 100 ) ) / 100.0f;
+        const int ledR = static_cast< int >( t * 255.0f );
+        const int ledG = 0;
+        const int ledB = static_cast< int >( ( 1.0f - t ) * 255.0f );
+        waterCoolerWorker->setLEDColor( ledR, ledG, ledB,
+          static_cast< int >( ucc::RGBState::Static ) );
+      }
 
-    if ( m_io.getFanSpeedPercent( fanIndex, speedPercent ) )
-    {
-      m_dbusData.fans[ static_cast< size_t >( fanIndex ) ].speed.set( static_cast< int64_t >( now ), speedPercent );
-    }
+      // Auto-control pump voltage with hysteresis.
+      // Step-up happens immediately at the table threshold; step-down requires
+      // the temperature to fall at least PUMP_HYSTERESIS_DEG below the
+      // threshold that last triggered an upward transition.
+      static constexpr ucc::PumpVoltage pumpIdxToVoltage[] = {
+          ucc::PumpVoltage::Off, ucc::PumpVoltage::V7, ucc::PumpVoltage::V8,
+          ucc::PumpVoltage::V11, ucc::PumpVoltage::V12 };
 
-    if ( m_io.getFanTemperature( fanIndex, tempCelsius ) )
-    {
-      m_dbusData.fans[ static_cast< size_t >( fanIndex ) ].temp.set( static_cast< int64_t >( now ), tempCelsius );
+      int rawIdx = 0;
+      for ( const auto &[t, s] : fp.tablePump )
+      {
+        if ( wcTemp >= t ) rawIdx = std::min( s, 4 );
+        else               break;
+      }
+
+      const int previousIdx = m_pumpHysSpeedIdx;
+      if ( rawIdx > m_pumpHysSpeedIdx )
+      {
+        // Temperature rising – apply new level and record its table threshold.
+        m_pumpHysSpeedIdx = rawIdx;
+        m_pumpHysThreshold = 0;
+        for ( const auto &[t, s] : fp.tablePump )
+          if ( std::min( s, 4 ) == rawIdx ) { m_pumpHysThreshold = t; break; }
+      }
+      else if ( rawIdx < m_pumpHysSpeedIdx )
+      {
+        // Temperature falling – only step down once we are past the dead-band.
+        if ( wcTemp < m_pumpHysThreshold - PUMP_HYSTERESIS_DEG )
+        {
+          m_pumpHysSpeedIdx = rawIdx;
+          m_pumpHysThreshold = 0;
+          for ( const auto &[t, s] : fp.tablePump )
+            if ( std::min( s, 4 ) == rawIdx ) { m_pumpHysThreshold = t; break; }
+        }
+      }
+
+      // Annotate the timeline so the pump curve and its dead-band can be
+      // tuned against the wcPumpLevel series
+      if ( m_pumpHysSpeedIdx != previousIdx )
+        m_metricsStore.recordEvent( ucc::MetricEventKind::PumpStep, m_pumpHysSpeedIdx,
+                                    ( m_pumpHysSpeedIdx > previousIdx ? "up at " : "down at " )
+                                      + std::to_string( wcTemp ) + " °C" );
+
+      const ucc::PumpVoltage pumpSpeedValue =
+          pumpIdxToVoltage[ std::clamp( m_pumpHysSpeedIdx, 0, 4 ) ];
+      waterCoolerWorker->setPumpVoltage( static_cast<int>( pumpSpeedValue ) );
+
+      // std::cout << "[Auto WC] Temp: " << temp << "°C, Fan: " << wcFanSpeed
+      //           << "%, Pump Voltage: " << static_cast<int>(pumpSpeedValue) << std::endl;
     }
+    catch ( ... ) { /* ignore errors in water cooler auto-control */ }
   }
 }
 
@@ -2832,6 +4471,7 @@ bool UccDBusService::initDBus()
   // Must be called from the main thread (before start()) so that
   // m_dbusObject lives in the main thread's event loop and
   // QDBusConnection::registerObject() can create child QObjects there.
+  const StartupTimeline::Scope phase( m_startup, "dbus-name" );
   try
   {
     QDBusConnection bus = QDBusConnection::systemBus();
@@ -2845,7 +4485,7 @@ bool UccDBusService::initDBus()
     m_dbusObject = std::make_unique< UccDBusObject >();
 
     // Create the adaptor (attaches to m_dbusObject automatically)
-    m_adaptor = std::make_unique< UccDBusInterfaceAdaptor >( m_dbusObject.get(), m_dbusData, this );
+    m_adaptor = std::make_unique< InstrumentedDBusAdaptor >( m_dbusObject.get(), m_dbusData, this );
 
     // Register the object on the bus
     if ( !bus.registerObject( OBJECT_PATH, m_dbusObject.get() ) )
@@ -2869,6 +4509,15 @@ bool UccDBusService::initDBus()
     }
 
     syslog( LOG_INFO, "DBus service registered on %s (Qt D-Bus)", SERVICE_NAME );
+
+    // The daemon stays up over a suspend: it quiesces before the system
+    // sleeps and restores the hardware state once it is awake again
+    if ( bus.connect( "org.freedesktop.login1", "/org/freedesktop/login1",
+                      "org.freedesktop.login1.Manager", "PrepareForSleep",
+                      this, SLOT( onPrepareForSleep( bool ) ) ) )
+      takeSleepInhibitor();
+    else
+      syslog( LOG_WARNING, "Failed to connect PrepareForSleep signal, hardware state is not restored after resume" );
     return true;
   }
   catch ( const std::exception &e )
@@ -2880,44 +4529,54 @@ bool UccDBusService::initDBus()
 
 void UccDBusService::shutdown()
 {
+  // leave the GPU as the active profile set it, not at a trial setting
+  endGpuTuning();
+
   syslog( LOG_INFO, "Shutting down workers..." );
 
+  // the fan loop stops on purpose
+  if ( m_fanWatchdog )
+    m_fanWatchdog->stop();
+
   // Phase 1: Signal ALL workers to stop (non-blocking).
   // This must happen before waiting, because some onWork() callbacks
   // use BlockingQueuedConnection to the main thread.  If we stop()+wait
   // sequentially, a worker stuck in BlockingQueuedConnection will deadlock
-  // because the main thread is blocked in QThread::wait().
+  // because the main thread is blocked in waitForFinished().
   requestStop();
   if ( m_fanControlWorker ) m_fanControlWorker->requestStop();
   if ( m_cpuWorker ) m_cpuWorker->requestStop();
   if ( m_displayWorker ) m_displayWorker->requestStop();
   if ( m_hardwareMonitorWorker ) m_hardwareMonitorWorker->requestStop();
 
-  // Phase 2: Wait for all threads to finish while keeping the Qt event
+  // Phase 2: Wait for all workers to finish while keeping the Qt event
   // loop alive.  Workers may have pending BlockingQueuedConnection calls
   // (e.g. LCTWaterCoolerWorker) that need the main thread to dispatch.
   // Pumping events here prevents deadlocks.
-  auto waitPumpingEvents = []( QThread *t ) {
-    if ( !t || !t->isRunning() )
+  auto waitPumpingEvents = []( DaemonWorker *w ) {
+    if ( !w )
       return;
     auto *app = QCoreApplication::instance();
-    while ( !t->isFinished() )
+    while ( !w->isFinished() )
     {
       if ( app )
         app->processEvents( QEventLoop::AllEvents, 50 );
       else
         QThread::msleep( 10 );
     }
-    t->wait();   // join the thread
+    w->waitForFinished();
   };
 
-  // Wait for the main service thread first, then sub-workers
+  // Wait for the main service worker first, then sub-workers
   waitPumpingEvents( this );
   waitPumpingEvents( m_fanControlWorker.get() );
   waitPumpingEvents( m_cpuWorker.get() );
   waitPumpingEvents( m_displayWorker.get() );
   waitPumpingEvents( m_hardwareMonitorWorker.get() );
 
+  // Nothing changes the settings any more; write what is still queued
+  flushPersistQueues();
+
   // Phase 3: DBus cleanup on the main thread (where the objects live).
   // onExit() runs on the worker thread, so DBus operations there would
   // violate Qt's thread-affinity rules.
@@ -2945,6 +4604,9 @@ void UccDBusService::shutdown()
 void UccDBusService::onStart()
 {
   m_started = true;
+
+  m_startup.markReady();
+  syslog( LOG_INFO, "[Startup] %s", m_startup.summary().c_str() );
 }
 
 void UccDBusService::onWork()
@@ -2952,33 +4614,73 @@ void UccDBusService::onWork()
   if ( not m_started )
     return;
 
+  // answered from the capability profile at startup: probe in the background once
+  if ( not m_capabilitiesRevalidated )
+  {
+    m_capabilitiesRevalidated = true;
+    revalidateCapabilities();
+  }
+  m_capabilities.flush();
+
   // On unsupported devices, skip all hardware polling
   if ( !m_dbusData.deviceSupported.load() )
     return;
 
-  // update tuxedo wmi availability (matches typescript implementation)
-  m_dbusData.tuxedoWmiAvailable = m_io.wmiAvailable();
+  const int64_t tickMs = SamplingGovernor::nowMs();
+  const auto due = [tickMs]( int64_t &last, int64_t period ) {
+    if ( last == 0 )
+      last = tickMs;
+    if ( tickMs - last < period )
+      return false;
+    last = tickMs;
+    return true;
+  };
 
-  // Periodic NVIDIA cTGP offset validation (every 5 ticks = 5 s)
-  if ( m_dbusData.nvidiaPowerCTRLAvailable.load() && m_profileSettingsWorker )
-  {
-    ++m_nvidiaValidationCounter;
-    if ( m_nvidiaValidationCounter >= 5 )
-    {
-      m_nvidiaValidationCounter = 0;
-      m_profileSettingsWorker->validateNVIDIACTGPOffset();
-    }
-  }
+  // Put back CPU and cTGP settings another agent changed (probes back off while they hold)
+  m_reconciler.runDue( tickMs );
+
+  // Shared cooler: move budget between CPU TDP and cTGP, ahead of the thermal step that writes the TDPs
+  m_powerBudgetActive = m_activeProfile.odmPowerLimits.controller.gpuShareWatts > 0
+                        && m_dbusData.nvidiaPowerCTRLAvailable.load();
+  if ( m_powerBudgetActive )
+    updatePowerBudget( tickMs );
+  else
+    m_lastPowerBudgetMs = 0;
+
+  // Core parking and adaptive EPP follow the per-core load sampled by the monitor
+  m_cpuLoadActive = m_settings.cpuSettingsEnabled
+                    && ( !m_activeProfile.cpu.coreParking.empty() || !m_activeProfile.cpu.adaptiveEpp.empty() );
+
+  // Dynamic ODM power limits follow the thermal headroom
+  if ( m_activeProfile.odmPowerLimits.controller.mode == PowerLimitMode::Dynamic )
+    updateDynamicPowerLimits( tickMs );
+  else
+    m_lastPowerLimitMs = 0;
 
   // Fan data is now updated by FanControlWorker
 
+  // Push the newest samples to MetricsSample subscribers (no-op when nobody listens)
+  if ( m_adaptor && m_adaptor->hasMetricsSampleSubscribers() )
+    emitMetricsSampleIfNew();
+
+  // Announce changed profiles, toggles, charging and water-cooler state
+  if ( m_adaptor )
+    publishPropertyChanges();
+
+  // OpenMetrics textfile export (every 5 s)
+  if ( !m_metricsTextfilePath.empty() && due( m_lastMetricsTextfileMs, METRICS_TEXTFILE_PERIOD_MS ) )
+    writeMetricsTextfile();
+
+  // Wake less often while temperatures are stable and nobody is watching;
+  // the tick also serves D-Bus requests, so it never runs faster than normal
+  setTimeout( m_samplingGovernor->interval( SERVICE_INTERVAL, false ) );
+
   // check sensor data collection timeout
   auto now = std::chrono::steady_clock::now();
   if ( m_adaptor )
   {
-    std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
     auto elapsed = std::chrono::duration_cast< std::chrono::milliseconds >(
-      now - m_adaptor->m_lastDataCollectionAccess ).count();
+      now - m_adaptor->m_lastDataCollectionAccess.load() ).count();
 
     if ( elapsed > 10000 )
       m_dbusData.sensorDataCollectionStatus = false;
@@ -2992,33 +4694,48 @@ void UccDBusService::onWork()
   // Skip AC/BAT changes when water cooler is connected (power_wc takes priority)
   if ( m_currentState != ProfileState::WC )
   {
-    const ProfileState newState = determineState();
-    const std::string stateKey = profileStateToString( newState );
-
+    const ProfileState newState = currentPowerState();
     if ( newState != m_currentState )
     {
+      const std::string stateKey = profileStateToString( newState );
       m_currentState = newState;
 
       // Update m_currentStateProfileId only if the state is mapped
       auto it = m_settings.stateMap.find( stateKey );
       m_currentStateProfileId = ( it != m_settings.stateMap.end() ) ? it->second : std::string();
 
-      std::cout << "[State] Power state changed to " << stateKey << std::endl;
+      ucc::asyncOut( "[State] Power state changed to " + stateKey );
+      m_metricsStore.recordEvent( ucc::MetricEventKind::PowerState, static_cast< int32_t >( newState ), stateKey );
 
       // Emit signal for UCC to handle profile switching
       m_adaptor->emitPowerStateChanged( stateKey );
+
+      // the keyboard idle timeout differs per power source
+      const bool onBattery = newState == ProfileState::BAT;
+      QMetaObject::invokeMethod( this, [this, onBattery]() {
+        m_keyboardOnBattery = onBattery;
+        armKeyboardIdle();
+      }, Qt::QueuedConnection );
     }
   }
 
-  // Check for temp profile requests
-  const std::string oldActiveProfileId = m_activeProfile.id;
-  const std::string oldActiveProfileName = m_activeProfile.name;
+  // Refresh saver: the panel drops its refresh rate on battery and while idle
+  if ( m_settings.displayRefreshSaver && m_displayWorker )
+  {
+    if ( due( m_lastIdleHintMs, IDLE_HINT_PERIOD_MS ) )
+      m_sessionsIdle = sessionsIdle();
+    m_displayWorker->setPowerHints( m_currentState == ProfileState::BAT, m_sessionsIdle );
+  }
+
+  // Applications with a profile of their own started or exited
+  updateWorkloadProfile();
 
+  // Check for temp profile requests; compared in place, nothing is copied unless one is pending
   // Check if a temp profile by ID was requested
   std::string profileId;
   {
-    std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-    if ( m_dbusData.tempProfileId.empty() || m_dbusData.tempProfileId == oldActiveProfileId )
+    std::lock_guard< std::mutex > lock( m_dbusData.tempProfileMutex );
+    if ( m_dbusData.tempProfileId.empty() || m_dbusData.tempProfileId == m_activeProfile.id )
     {
       profileId.clear();
     }
@@ -3031,14 +4748,14 @@ void UccDBusService::onWork()
 
   if ( !profileId.empty() )
   {
-    std::cout << "[Profile] Applying temp profile by ID: " << profileId << std::endl;
+    ucc::asyncOut( "[Profile] Applying temp profile by ID: " + profileId );
     if ( setCurrentProfileById( profileId ) )
     {
-      std::cout << "[Profile] Successfully switched to profile ID: " << profileId << std::endl;
+      ucc::asyncOut( "[Profile] Successfully switched to profile ID: " + profileId );
     }
     else
     {
-      std::cerr << "[Profile] Failed to switch to profile ID: " << profileId << std::endl;
+      ucc::asyncErr( "[Profile] Failed to switch to profile ID: " + profileId );
     }
 
     return; // Process one change per cycle
@@ -3047,8 +4764,8 @@ void UccDBusService::onWork()
   // Check if a temp profile by name was requested
   std::string profileName;
   {
-    std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-    if ( m_dbusData.tempProfileName.empty() || m_dbusData.tempProfileName == oldActiveProfileName )
+    std::lock_guard< std::mutex > lock( m_dbusData.tempProfileMutex );
+    if ( m_dbusData.tempProfileName.empty() || m_dbusData.tempProfileName == m_activeProfile.name )
     {
       profileName.clear();
     }
@@ -3061,14 +4778,14 @@ void UccDBusService::onWork()
 
   if ( !profileName.empty() )
   {
-    std::cout << "[Profile] Applying temp profile by name: " << profileName << std::endl;
+    ucc::asyncOut( "[Profile] Applying temp profile by name: " + profileName );
     if ( setCurrentProfileByName( profileName ) )
     {
-      std::cout << "[Profile] Successfully switched to profile: " << profileName << std::endl;
+      ucc::asyncOut( "[Profile] Successfully switched to profile: " + profileName );
     }
     else
     {
-      std::cerr << "[Profile] Failed to switch to profile: " << profileName << std::endl;
+      ucc::asyncErr( "[Profile] Failed to switch to profile: " + profileName );
     }
 
     return; // Process one change per cycle
@@ -3122,31 +4839,180 @@ void UccDBusService::onWork()
           m_currentState = ProfileState::WC;
           const std::string stateKey = "power_wc";
           std::cout << "[State] Water cooler connected, switching to " << stateKey << std::endl;
+          m_metricsStore.recordEvent( ucc::MetricEventKind::PowerState,
+                                      static_cast< int32_t >( m_currentState ), stateKey );
           m_adaptor->emitPowerStateChanged( stateKey );
         }
         else
         {
-          m_currentState = determineState();
+          m_currentState = currentPowerState();
           const std::string stateKey = profileStateToString( m_currentState );
           std::cout << "[State] Water cooler disconnected, reverting to " << stateKey << std::endl;
+          m_metricsStore.recordEvent( ucc::MetricEventKind::PowerState,
+                                      static_cast< int32_t >( m_currentState ), stateKey );
           m_adaptor->emitPowerStateChanged( stateKey );
         }
 
-        // Reset pump hysteresis so the auto-control loop picks up the correct
-        // level for the new profile from a clean state.
-        m_pumpHysSpeedIdx = 0;
-        m_pumpHysThreshold = 0;
-        m_wcTempFiltered = -1.0;  // reset EWMA so next sample seeds immediately
+        // Reset pump hysteresis so the auto-control loop picks up the correct
+        // level for the new profile from a clean state.
+        m_pumpHysSpeedIdx = 0;
+        m_pumpHysThreshold = 0;
+        m_wcTempFiltered = -1.0;  // reset EWMA so next sample seeds immediately
+
+        applyProfileForCurrentState();
+      }
+    }
+  }
+  else
+  {
+    // Raw flag matches accepted state – cancel any pending debounce.
+    m_wcDebouncePending = false;
+  }
+}
+
+void UccDBusService::emitMetricsSampleIfNew()
+{
+  // the list is only built for a sample that goes out
+  int64_t newestMs = 0;
+  for ( size_t i = 0; i < static_cast< size_t >( MetricId::Count ); ++i )
+    if ( const auto pt = m_metricsStore.latest( static_cast< MetricId >( i ) ) )
+      newestMs = std::max( newestMs, pt->timestampMs );
+
+  if ( newestMs <= m_lastMetricsSampleMs )
+    return;
+
+  QList< double > values;
+  values.reserve( static_cast< qsizetype >( MetricId::Count ) );
+  for ( size_t i = 0; i < static_cast< size_t >( MetricId::Count ); ++i )
+  {
+    const auto pt = m_metricsStore.latest( static_cast< MetricId >( i ) );
+    values.append( pt ? pt->value : std::numeric_limits< double >::quiet_NaN() );
+  }
+
+  m_lastMetricsSampleMs = newestMs;
+  m_adaptor->emitMetricsSample( newestMs, std::move( values ) );
+}
+
+void UccDBusService::stageSlowState()
+{
+  auto &tracker = m_propertyTracker;
+  {
+    const auto profiles = m_dbusData.profiles.load();
+    const auto charging = m_dbusData.charging.load();
+    tracker.set( "ActiveProfileJSON", profiles->activeProfileJSON.current() );
+    tracker.set( "SettingsJSON", m_dbusData.settings.load()->settingsJSON.current() );
+    tracker.set( "ProfilesJSON", profiles->profilesJSON.current() );
+    tracker.set( "CurrentChargingProfile", charging->currentChargingProfile );
+    tracker.set( "CurrentChargingPriority", charging->currentChargingPriority );
+  }
+  tracker.set( "PowerState", profileStateToString( m_currentState ) );
+  tracker.set( "WebcamSWStatus", m_dbusData.webcamSwitchStatus.load() );
+  tracker.set( "FnLockStatus", m_fnLockController.getStatus() );
+  tracker.set( "DisplayBrightness", m_autosave.displayBrightness );
+  tracker.set( "WaterCoolerEnabled", m_activeProfile.fan.enableWaterCooler );
+  tracker.set( "WaterCoolerAvailable", m_dbusData.waterCoolerAvailable.load() );
+  tracker.set( "WaterCoolerConnected", m_dbusData.waterCoolerConnected.load() );
+  tracker.set( "ChargeStartThreshold", m_dbusData.chargeStartThreshold.load() );
+  tracker.set( "ChargeEndThreshold", m_dbusData.chargeEndThreshold.load() );
+}
+
+void UccDBusService::publishPropertyChanges()
+{
+  // compared in place against what was last sent: an idle tick copies no JSON
+  stageSlowState();
+  m_adaptor->publishPropertyChanges( m_propertyTracker.takeChanged() );
+}
+
+uint32_t UccDBusService::activeSensorGroups() const noexcept
+{
+  if ( m_dbusData.sensorDataCollectionStatus.load() || !m_metricsTextfilePath.empty() )
+    return ucc::SensorGroup::All;
+  // a GPU tuning job and the power budget arbiter measure whether or not anyone watches
+  const uint32_t tuning = m_gpuTuningActive.load() ? ucc::SensorGroup::DGpu : 0;
+  const uint32_t budget = m_powerBudgetActive.load() ? ucc::SensorGroup::DGpu | ucc::SensorGroup::CpuPower : 0;
+  const uint32_t load = m_cpuLoadActive.load() ? ucc::SensorGroup::CpuFrequency | ucc::SensorGroup::CpuPower : 0;
+  return ( m_adaptor ? m_adaptor->subscribedSensorGroups() : 0 ) | tuning | budget | load;
+}
+
+void UccDBusService::updateDynamicPowerLimits( int64_t tickMs )
+{
+  // temperature and fan duty as averaged by the history store over the last samples
+  static constexpr int64_t FILTER_WINDOW_MS = 5000;
+
+  if ( !m_profileSettingsWorker )
+    return;
+
+  const double dtSeconds = m_lastPowerLimitMs > 0 ? static_cast< double >( tickMs - m_lastPowerLimitMs ) / 1000.0 : 0.0;
+  m_lastPowerLimitMs = tickMs;
+
+  const int64_t nowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::system_clock::now().time_since_epoch() ).count();
+  const MetricStats temp = m_metricsStore.statsSince( MetricId::CpuTemp, nowMs - FILTER_WINDOW_MS );
+  if ( temp.samples == 0 )
+    return;  // no fresh reading: hold the limits where they are
+  const MetricStats duty = m_metricsStore.statsSince( MetricId::CpuFanDuty, nowMs - FILTER_WINDOW_MS );
+
+  m_profileSettingsWorker->updateDynamicPowerLimits( m_activeProfile.odmPowerLimits.controller, temp.avg,
+                                                     duty.samples > 0 ? duty.avg : -1.0, dtSeconds );
+}
+
+void UccDBusService::updatePowerBudget( int64_t tickMs )
+{
+  static constexpr int64_t FILTER_WINDOW_MS = 5000;
+
+  if ( !m_profileSettingsWorker )
+    return;
+
+  const double dtSeconds = m_lastPowerBudgetMs > 0 ? static_cast< double >( tickMs - m_lastPowerBudgetMs ) / 1000.0 : 0.0;
+  m_lastPowerBudgetMs = tickMs;
 
-        applyProfileForCurrentState();
-      }
-    }
-  }
-  else
+  const int64_t sinceMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::system_clock::now().time_since_epoch() ).count() - FILTER_WINDOW_MS;
+  const auto average = [this, sinceMs]( MetricId id ) {
+    const MetricStats stats = m_metricsStore.statsSince( id, sinceMs );
+    return stats.samples > 0 ? stats.avg : -1.0;
+  };
+
+  PowerBudgetSample sample;
+  sample.cpuWatts = average( MetricId::CpuPower );
+  sample.cpuLimitedPct = average( MetricId::CpuPowerLimited );
+  sample.gpuWatts = average( MetricId::GpuPower );
+  sample.gpuUtilPct = average( MetricId::GpuComputeUtil );
+  m_profileSettingsWorker->updatePowerBudget( m_activeProfile.odmPowerLimits.controller, sample, dtSeconds );
+}
+
+void UccDBusService::writeMetricsTextfile()
+{
+  // Snapshot the already-sampled values; no hardware is read here
   {
-    // Raw flag matches accepted state – cancel any pending debounce.
-    m_wcDebouncePending = false;
+    const auto fans = m_dbusData.fans.load();
+    m_telemetrySnapshot.fans.resize( fans->size() );
+    for ( size_t i = 0; i < fans->size(); ++i )
+    {
+      auto &fan = m_telemetrySnapshot.fans[ i ];
+      fan.speedTimestampMs = ( *fans )[ i ].speed.timestamp;
+      fan.speedPercent = ( *fans )[ i ].speed.data;
+      fan.tempTimestampMs = ( *fans )[ i ].temp.timestamp;
+      fan.tempCelsius = ( *fans )[ i ].temp.data;
+    }
+
+    const auto gpu = m_dbusData.gpu.load();
+    const DGpuInfo &dGpu = gpu->dGpuInfo;
+    auto &telemetry = m_telemetrySnapshot.gpu;
+    telemetry.computeUtilPct = dGpu.m_computeUtilPct;
+    telemetry.memoryUtilPct = dGpu.m_memoryUtilPct;
+    telemetry.encoderUtilPct = dGpu.m_encoderUtilPct;
+    telemetry.decoderUtilPct = dGpu.m_decoderUtilPct;
+    telemetry.vramUsedMiB = dGpu.m_vramUsedMiB;
+    telemetry.vramTotalMiB = dGpu.m_vramTotalMiB;
+    telemetry.currentPstate = dGpu.m_currentPstate;
+    telemetry.enforcedPowerLimitW = dGpu.m_enforcedPowerLimit;
   }
+
+  const auto now = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::system_clock::now().time_since_epoch() ).count();
+  OpenMetricsExporter::writeTextfile( m_metricsTextfilePath,
+                                      m_openMetrics.render( m_metricsStore, m_telemetrySnapshot, now ) );
 }
 
 void UccDBusService::setWaterCoolerScanningEnabled( bool enable )
@@ -3160,7 +5026,9 @@ void UccDBusService::setWaterCoolerScanningEnabled( bool enable )
     m_dbusData.waterCoolerConnected = false;
   }
 
-  if ( not m_waterCoolerWorker )
+  // the worker (and its Bluetooth adapter lookup) exists once scanning was first enabled
+  auto *worker = enable ? ensureWaterCooler() : waterCooler();
+  if ( not worker )
     return;
 
   if ( enable )
@@ -3169,20 +5037,20 @@ void UccDBusService::setWaterCoolerScanningEnabled( bool enable )
     // startScanning() calls cleanupBleController() which would tear down
     // an active BLE connection, causing pump/fan commands to fail.
     if ( not m_dbusData.waterCoolerAvailable.load() and not m_dbusData.waterCoolerConnected.load() )
-      m_waterCoolerWorker->startScanning();
+      worker->startScanning();
   }
   else
   {
     // Stop discovery and disconnect; stopScanning() now also disconnects the device
-    m_waterCoolerWorker->stopScanning();
+    worker->stopScanning();
   }
 }
 
 void UccDBusService::onExit()
 {
   // Only do thread-safe work here — this runs on the DaemonWorker thread.
-  // DBus cleanup happens in shutdown() on the main thread.
-  saveAutosave();
+  // DBus cleanup and the final settings/autosave writes happen in
+  // shutdown() on the main thread.
 }
 
 // profile management implementation
@@ -3236,6 +5104,7 @@ void UccDBusService::initializeProfiles()
     {
       // Profile no longer exists, clear it
       m_activeProfile = UccProfile();
+      m_staleSubsystems = ProfileSubsystem::All;
     }
   }
 
@@ -3279,33 +5148,29 @@ void UccDBusService::initializeProfiles()
   }
   defaultProfilesJSON << "]";
 
-  std::ostringstream customProfilesJSON;
-  customProfilesJSON << "[";
-  for ( size_t i = 0; i < m_customProfiles.size(); ++i )
-  {
-    if ( i > 0 )
-      customProfilesJSON << ",";
-
-    customProfilesJSON << profileToJSON( m_customProfiles[ i ],
-                       defaultOnlineCores,
-                       defaultScalingMin,
-                       defaultScalingMax );
-  }
-  customProfilesJSON << "]";
+  QVariantList defaultProfilesWire = profilesToDBusWire( m_defaultProfiles,
+                                                         defaultOnlineCores,
+                                                         defaultScalingMin,
+                                                         defaultScalingMax );
 
-  std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-  m_dbusData.profilesJSON = defaultProfilesJSON.str();  // Only default profiles now
-  m_dbusData.defaultProfilesJSON = defaultProfilesJSON.str();
-  m_dbusData.customProfilesJSON = "[]";  // Empty array since custom profiles are local
-  m_dbusData.defaultValuesProfileJSON = profileToJSON( baseCustomProfile,
+  const std::string defaultsJSON = defaultProfilesJSON.str();
+  const std::string customJSON = "[]";  // Empty array since custom profiles are local
+  const std::string defaultValuesJSON = profileToJSON( baseCustomProfile,
                                                        defaultOnlineCores,
                                                        defaultScalingMin,
                                                        defaultScalingMax );
+  m_dbusData.profiles.update( [&]( ProfileSnapshot &profiles ) {
+    profiles.profilesJSON.set( defaultsJSON );  // Only default profiles now
+    profiles.defaultProfilesJSON.set( defaultsJSON );
+    profiles.defaultProfilesWire = defaultProfilesWire;
+    profiles.customProfilesJSON.set( customJSON );
+    profiles.defaultValuesProfileJSON = defaultValuesJSON;
+  } );
 
   std::cout << "[DBus] Updated profile JSONs:" << std::endl;
-  std::cout << "[DBus]   customProfilesJSON: " << m_dbusData.customProfilesJSON.length() << " bytes, "
+  std::cout << "[DBus]   customProfilesJSON: " << customJSON.length() << " bytes, "
             << m_customProfiles.size() << " profiles" << std::endl;
-  std::cout << "[DBus]   defaultProfilesJSON: " << m_dbusData.defaultProfilesJSON.length() << " bytes, "
+  std::cout << "[DBus]   defaultProfilesJSON: " << defaultsJSON.length() << " bytes, "
             << m_defaultProfiles.size() << " profiles" << std::endl;
 
 }
@@ -3317,25 +5182,26 @@ UccProfile UccDBusService::getCurrentProfile() const
 
 bool UccDBusService::setCurrentProfileByName( const std::string &profileName )
 {
-  auto allProfiles = getAllProfiles();
+  auto builtIn = std::ranges::find( m_defaultProfiles, profileName, &UccProfile::name );
+  const auto custom = builtIn == m_defaultProfiles.end() ? m_customProfiles.findByName( profileName ) : nullptr;
 
-  for ( const auto &profile : allProfiles )
+  if ( builtIn != m_defaultProfiles.end() || custom )
   {
-    if ( profile.name == profileName )
-    {
-      const bool preservedWcEnable = m_dbusData.waterCoolerScanningEnabled.load();
-      m_activeProfile = profile;
-      m_activeProfile.fan.enableWaterCooler = preservedWcEnable;
-      snapProfileFrequencies( m_activeProfile );
-      updateDBusActiveProfileData();
-      return true;
-    }
+    const UccProfile &profile = custom ? *custom : *builtIn;
+    const bool preservedWcEnable = m_dbusData.waterCoolerScanningEnabled.load();
+    m_activeProfile = profile;
+    m_activeProfile.fan.enableWaterCooler = preservedWcEnable;
+    m_staleSubsystems = ProfileSubsystem::All;  // selected, not applied
+    snapProfileFrequencies( m_activeProfile );
+    updateDBusActiveProfileData();
+    return true;
   }
 
   // fallback to default profile
   const bool preservedWcEnable = m_dbusData.waterCoolerScanningEnabled.load();
   m_activeProfile = getDefaultProfile();
   m_activeProfile.fan.enableWaterCooler = preservedWcEnable;
+  m_staleSubsystems = ProfileSubsystem::All;
   snapProfileFrequencies( m_activeProfile );
   updateDBusActiveProfileData();
   return false;
@@ -3343,105 +5209,30 @@ bool UccDBusService::setCurrentProfileByName( const std::string &profileName )
 
 bool UccDBusService::setCurrentProfileById( const std::string &id )
 {
-  auto allProfiles = getAllProfiles();
-
-  for ( const auto &profile : allProfiles )
+  if ( const auto found = resolveProfile( id ) )
   {
-    if ( profile.id == id )
-    {
-      std::cout << "[Profile] Switching to profile: " << profile.name << " (ID: " << id << ")" << std::endl;
-      // Preserve runtime water cooler enable state across profile switches.
-      // The user's explicit EnableWaterCooler() D-Bus call is authoritative.
-      const bool preservedWcEnable = m_dbusData.waterCoolerScanningEnabled.load();
-      m_activeProfile = profile;
-      m_activeProfile.fan.enableWaterCooler = preservedWcEnable;
-      snapProfileFrequencies( m_activeProfile );
-      updateDBusActiveProfileData();
-
-      // apply fan curves and pump auto-control
-      applyFanAndPumpSettings( profile );
-
-      // apply new profile to workers
-      if ( m_cpuWorker )
-      {
-        std::cout << "[Profile] Applying CPU settings from profile" << std::endl;
-        m_cpuWorker->reapplyProfile();
-      }
-      if ( m_profileSettingsWorker )
-      {
-        std::cout << "[Profile] Applying TDP settings from profile" << std::endl;
-        m_profileSettingsWorker->reapplyProfile();
-
-        // Re-read TDP values after apply so D-Bus data reflects new hardware state
-        readHardwareCapabilities();
-
-        // Apply charging profile if the profile specifies one
-        if ( !profile.chargingProfile.empty() && m_dbusData.chargingProfilesAvailable != "[]" )
-        {
-          std::cout << "[Profile] Applying charging profile '" << profile.chargingProfile << "'" << std::endl;
-          if ( m_profileSettingsWorker->applyChargingProfile( profile.chargingProfile ) )
-          {
-            std::lock_guard< std::mutex > lk( m_dbusData.dataMutex );
-            m_dbusData.currentChargingProfile = profile.chargingProfile;
-          }
-        }
-
-        // Apply charging priority if the profile specifies one
-        if ( !profile.chargingPriority.empty() && m_dbusData.chargingPrioritiesAvailable != "[]" )
-        {
-          std::cout << "[Profile] Applying charging priority '" << profile.chargingPriority << "'" << std::endl;
-          if ( m_profileSettingsWorker->applyChargingPriority( profile.chargingPriority ) )
-          {
-            std::lock_guard< std::mutex > lk( m_dbusData.dataMutex );
-            m_dbusData.currentChargingPriority = profile.chargingPriority;
-          }
-        }
-
-        // Apply charge type and thresholds if the profile specifies them
-        if ( !profile.chargeType.empty() )
-        {
-          std::cout << "[Profile] Applying charge type '" << profile.chargeType << "'" << std::endl;
-          if ( m_profileSettingsWorker->setChargeType( profile.chargeType ) )
-          {
-            std::lock_guard< std::mutex > lk( m_dbusData.dataMutex );
-            m_dbusData.chargeType = profile.chargeType;
-          }
-        }
-        if ( profile.chargeStartThreshold >= 0 )
-        {
-          std::cout << "[Profile] Applying charge start threshold " << profile.chargeStartThreshold << std::endl;
-          if ( m_profileSettingsWorker->setChargeStartThreshold( profile.chargeStartThreshold ) )
-            m_dbusData.chargeStartThreshold = profile.chargeStartThreshold;
-        }
-        if ( profile.chargeEndThreshold >= 0 )
-        {
-          std::cout << "[Profile] Applying charge end threshold " << profile.chargeEndThreshold << std::endl;
-          if ( m_profileSettingsWorker->setChargeEndThreshold( profile.chargeEndThreshold ) )
-            m_dbusData.chargeEndThreshold = profile.chargeEndThreshold;
-        }
-      }
+    const UccProfile &profile = *found;
+    std::cout << "[Profile] Switching to profile: " << profile.name << " (ID: " << id << ")" << std::endl;
+    m_metricsStore.recordEvent( ucc::MetricEventKind::ProfileSwitch, 0,
+                                profile.name.empty() ? id : profile.name );
+    // Preserve runtime water cooler enable state across profile switches.
+    // The user's explicit EnableWaterCooler() D-Bus call is authoritative.
+    const bool preservedWcEnable = m_dbusData.waterCoolerScanningEnabled.load();
+    m_activeProfile = profile;
+    m_activeProfile.fan.enableWaterCooler = preservedWcEnable;
+    snapProfileFrequencies( m_activeProfile );
+    updateDBusActiveProfileData();
 
-      if ( m_keyboardBacklightController.isAvailable()
-           && m_settings.keyboardBacklightControlEnabled
-           && !profile.keyboard.keyboardProfileData.empty()
-           && profile.keyboard.keyboardProfileData != "{}" )
-      {
-        bool kbResult = m_keyboardBacklightController.applyProfileKeyboardStates( profile.keyboard.keyboardProfileData );
-        std::cout << "[Profile] Keyboard apply result: " << ( kbResult ? "SUCCESS" : "FAILED" ) << std::endl;
-      }
-      else
-      {
-        std::cout << "[Profile] Keyboard apply SKIPPED — one or more conditions not met" << std::endl;
-      }
+    // apply new profile to workers (a switch by id leaves GPU OC alone)
+    applyProfileSubsystems( profile, ProfileSubsystem::All & ~ProfileSubsystem::GpuOC );
 
-      // Emit ProfileChanged signal for DBus clients
-      if ( m_adaptor )
-        m_adaptor->emitProfileChanged( id,
-                                       profile.keyboard.keyboardProfileId,
-                                       profile.fan.fanProfile );
+    // Emit ProfileChanged signal for DBus clients
+    if ( m_adaptor )
+      m_adaptor->emitProfileChanged( id,
+                                     profile.keyboard.keyboardProfileId,
+                                     profile.fan.fanProfile );
 
-      return true;
-    }
+    return true;
   }
 
   // fallback to default profile
@@ -3451,6 +5242,7 @@ bool UccDBusService::setCurrentProfileById( const std::string &id )
     m_activeProfile = getDefaultProfile();
     m_activeProfile.fan.enableWaterCooler = preservedWcEnable;
   }
+  m_staleSubsystems = ProfileSubsystem::All;  // selected, not applied
   snapProfileFrequencies( m_activeProfile );
   updateDBusActiveProfileData();
 
@@ -3469,9 +5261,19 @@ bool UccDBusService::applyProfileJSON( const std::string &profileJSON )
 {
   try
   {
-    // Parse the profile JSON
-    auto profile = m_profileManager.parseProfileJSON( profileJSON );
+    return applyProfile( m_profileManager.parseProfileJSON( profileJSON ) );
+  }
+  catch ( const std::exception &e )
+  {
+    std::cerr << "[Profile] Failed to apply profile JSON: " << e.what() << std::endl;
+    return false;
+  }
+}
 
+bool UccDBusService::applyProfile( const UccProfile &profile )
+{
+  try
+  {
     std::cout << "[Profile] Applying profile from GUI: " << profile.name << std::endl;
 
     // Set as active profile, but preserve the runtime water cooler enable state.
@@ -3483,155 +5285,7 @@ bool UccDBusService::applyProfileJSON( const std::string &profileJSON )
     snapProfileFrequencies( m_activeProfile );
     updateDBusActiveProfileData();
 
-    // If the profile explicitly sets sameSpeed, apply it to fan worker immediately
-    try
-    {
-      if ( m_fanControlWorker )
-      {
-        bool same = m_activeProfile.fan.sameSpeed;
-        m_fanControlWorker->setSameSpeed( same );
-        syslog( LOG_INFO, "UccDBusService: applied sameSpeed=%d from profile", same ? 1 : 0 );
-      }
-    }
-    catch ( ... ) { /* ignore */ }
-
-    // Try to resolve and apply fan curves: prefer embedded tables, fallback to named fan profile
-    try
-    {
-      std::vector< FanTableEntry > cpuTable;
-      std::vector< FanTableEntry > gpuTable;
-      std::vector< FanTableEntry > wcFanTable;
-      std::vector< FanTableEntry > pumpTable;
-
-      // First, try embedded tables from the profile itself
-      if ( profile.fan.hasEmbeddedTables() )
-      {
-        cpuTable = profile.fan.tableCPU;
-        gpuTable = profile.fan.tableGPU;
-        wcFanTable = profile.fan.tableWaterCoolerFan;
-        pumpTable = profile.fan.tablePump;
-        std::cout << "[Profile] Using embedded fan tables from profile" << std::endl;
-      }
-      else
-      {
-        // Fallback: resolve from named fan profile preset
-        const std::string fpName = profile.fan.fanProfile;
-        if ( !fpName.empty() )
-        {
-          FanProfile fp = getDefaultFanProfile( fpName );
-          if ( fp.isValid() )
-          {
-            cpuTable = fp.tableCPU;
-            gpuTable = fp.tableGPU;
-            wcFanTable = fp.tableWaterCoolerFan;
-            pumpTable = fp.tablePump;
-            std::cout << "[Profile] Using fan tables from named profile '" << fpName << "'" << std::endl;
-          }
-        }
-      }
-
-      if ( m_fanControlWorker && !cpuTable.empty() )
-      {
-        m_fanControlWorker->applyTemporaryFanCurves( cpuTable, gpuTable, wcFanTable, pumpTable );
-        std::cout << "[Profile] Applied fan curves (CPU=" << cpuTable.size()
-                  << " GPU=" << gpuTable.size()
-                  << " WCFan=" << wcFanTable.size()
-                  << " Pump=" << pumpTable.size() << ")" << std::endl;
-      }
-
-      // Apply pump auto-control if water cooler is connected and autoControlWC is enabled
-      if ( profile.fan.autoControlWC && m_waterCoolerWorker && m_dbusData.waterCoolerConnected.load()
-           && !pumpTable.empty() )
-      {
-        int maxTemp = 0;
-        {
-          std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-          for ( const auto &fan : m_dbusData.fans )
-            maxTemp = std::max( maxTemp, fan.temp.data );
-        }
-        FanProfile tempFp;
-        tempFp.tablePump = pumpTable;
-        // Reset hysteresis before a one-shot profile apply so the continuous
-        // loop re-initialises to the correct level on the next tick.
-        m_pumpHysSpeedIdx = 0;
-        m_pumpHysThreshold = 0;
-        m_waterCoolerWorker->setPumpVoltage( static_cast<int>( tempFp.getPumpSpeedForTemp( maxTemp ) ) );
-        std::cout << "[Profile] Applied pump voltage for temp " << maxTemp << "°C" << std::endl;
-      }
-    }
-    catch ( ... ) { /* ignore parse errors and continue applying other profile settings */ }
-
-    // Apply to workers
-    if ( m_cpuWorker )
-    {
-      std::cout << "[Profile] Applying CPU settings from profile" << std::endl;
-      m_cpuWorker->reapplyProfile();
-    }
-    if ( m_profileSettingsWorker )
-    {
-      std::cout << "[Profile] Applying TDP settings from profile" << std::endl;
-      m_profileSettingsWorker->reapplyProfile();
-
-      // Re-read TDP values after apply so D-Bus data reflects new hardware state
-      readHardwareCapabilities();
-
-      // Apply charging profile if the profile specifies one
-      if ( !profile.chargingProfile.empty() && m_dbusData.chargingProfilesAvailable != "[]" )
-      {
-        std::cout << "[Profile] Applying charging profile '" << profile.chargingProfile << "'" << std::endl;
-        if ( m_profileSettingsWorker->applyChargingProfile( profile.chargingProfile ) )
-        {
-          std::lock_guard< std::mutex > lk( m_dbusData.dataMutex );
-          m_dbusData.currentChargingProfile = profile.chargingProfile;
-        }
-      }
-
-      // Apply charging priority if the profile specifies one
-      if ( !profile.chargingPriority.empty() && m_dbusData.chargingPrioritiesAvailable != "[]" )
-      {
-        std::cout << "[Profile] Applying charging priority '" << profile.chargingPriority << "'" << std::endl;
-        if ( m_profileSettingsWorker->applyChargingPriority( profile.chargingPriority ) )
-        {
-          std::lock_guard< std::mutex > lk( m_dbusData.dataMutex );
-          m_dbusData.currentChargingPriority = profile.chargingPriority;
-        }
-      }
-
-      // Apply charge type and thresholds if the profile specifies them
-      if ( !profile.chargeType.empty() )
-      {
-        std::cout << "[Profile] Applying charge type '" << profile.chargeType << "'" << std::endl;
-        if ( m_profileSettingsWorker->setChargeType( profile.chargeType ) )
-        {
-          std::lock_guard< std::mutex > lk( m_dbusData.dataMutex );
-          m_dbusData.chargeType = profile.chargeType;
-        }
-      }
-      if ( profile.chargeStartThreshold >= 0 )
-      {
-        std::cout << "[Profile] Applying charge start threshold " << profile.chargeStartThreshold << std::endl;
-        if ( m_profileSettingsWorker->setChargeStartThreshold( profile.chargeStartThreshold ) )
-          m_dbusData.chargeStartThreshold = profile.chargeStartThreshold;
-      }
-      if ( profile.chargeEndThreshold >= 0 )
-      {
-        std::cout << "[Profile] Applying charge end threshold " << profile.chargeEndThreshold << std::endl;
-        if ( m_profileSettingsWorker->setChargeEndThreshold( profile.chargeEndThreshold ) )
-          m_dbusData.chargeEndThreshold = profile.chargeEndThreshold;
-      }
-    }
-
-    if ( m_keyboardBacklightController.isAvailable()
-         && m_settings.keyboardBacklightControlEnabled
-         && !profile.keyboard.keyboardProfileData.empty()
-         && profile.keyboard.keyboardProfileData != "{}" )
-    {
-      std::cout << "[Profile] Applying keyboard backlight settings from profile" << std::endl;
-      m_keyboardBacklightController.applyProfileKeyboardStates( profile.keyboard.keyboardProfileData );
-    }
-
-    // Apply GPU OC and cTGP from the profile
-    applyGpuOCFromProfile( profile );
+    applyProfileSubsystems( profile, ProfileSubsystem::All );
 
     // Emit ProfileChanged signal for DBus clients
     if ( m_adaptor )
@@ -3645,7 +5299,7 @@ bool UccDBusService::applyProfileJSON( const std::string &profileJSON )
   }
   catch ( const std::exception &e )
   {
-    std::cerr << "[Profile] Failed to apply profile JSON: " << e.what() << std::endl;
+    std::cerr << "[Profile] Failed to apply profile: " << e.what() << std::endl;
     return false;
   }
 }
@@ -3657,7 +5311,8 @@ std::vector< UccProfile > UccDBusService::getAllProfiles() const
   allProfiles.reserve( m_defaultProfiles.size() + m_customProfiles.size() );
 
   allProfiles.insert( allProfiles.end(), m_defaultProfiles.begin(), m_defaultProfiles.end() );
-  allProfiles.insert( allProfiles.end(), m_customProfiles.begin(), m_customProfiles.end() );
+  for ( const auto &profile : m_customProfiles.snapshot()->ordered )
+    allProfiles.push_back( *profile );
 
   return allProfiles;
 }
@@ -3669,7 +5324,7 @@ std::vector< UccProfile > UccDBusService::getDefaultProfiles() const
 
 std::vector< UccProfile > UccDBusService::getCustomProfiles() const
 {
-  return m_customProfiles;
+  return m_customProfiles.list();
 }
 
 UccProfile UccDBusService::getDefaultProfile() const
@@ -3678,7 +5333,7 @@ UccProfile UccDBusService::getDefaultProfile() const
     return m_defaultProfiles[0];
 
   if ( not m_customProfiles.empty() )
-    return m_customProfiles[0];
+    return *m_customProfiles.snapshot()->ordered.front();
 
   // ultimate fallback
   return defaultCustomProfile;
@@ -3694,16 +5349,33 @@ void UccDBusService::updateDBusActiveProfileData()
                                            defaultOnlineCores,
                                            defaultScalingMin,
                                            defaultScalingMax );
-  std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-  m_dbusData.activeProfileJSON = profileJSON;
+  QVariantMap profileWire = profileToDBusWire( m_activeProfile,
+                                               defaultOnlineCores,
+                                               defaultScalingMin,
+                                               defaultScalingMax );
+  m_dbusData.profiles.update( [&]( ProfileSnapshot &profiles ) {
+    profiles.activeProfileJSON.set( profileJSON );
+    profiles.activeProfileWire = profileWire;
+  } );
 }
 
 void UccDBusService::updateDBusSettingsData()
 {
-  std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-  m_dbusData.settingsJSON = buildSettingsJSON( m_dbusData.keyboardBacklightStatesJSON,
-                                               m_dbusData.currentChargingProfile,
-                                               m_settings );
+  const auto charging = m_dbusData.charging.load();
+  m_dbusData.settings.update( [&]( SettingsSnapshot &settings ) {
+    settings.settingsJSON.set( buildSettingsJSON( settings.keyboardBacklightStatesJSON.current(),
+                                                  charging->currentChargingProfile,
+                                                  m_settings ) );
+  } );
+}
+
+void UccDBusService::updateDBusKeyboardBacklightStates( const std::string &statesJSON )
+{
+  const auto charging = m_dbusData.charging.load();
+  m_dbusData.settings.update( [&]( SettingsSnapshot &settings ) {
+    settings.keyboardBacklightStatesJSON.set( statesJSON );
+    settings.settingsJSON.set( buildSettingsJSON( statesJSON, charging->currentChargingProfile, m_settings ) );
+  } );
 }
 
 bool UccDBusService::addCustomProfile( const UccProfile &profile )
@@ -3711,7 +5383,7 @@ bool UccDBusService::addCustomProfile( const UccProfile &profile )
   std::cout << "[ProfileManager] Adding profile '" << profile.name << "' to memory" << std::endl;
 
   // Add to in-memory profiles
-  m_customProfiles.push_back( profile );
+  m_customProfiles.upsert( profile );
 
   // Update DBus data
   updateDBusActiveProfileData();
@@ -3724,12 +5396,11 @@ bool UccDBusService::deleteCustomProfile( const std::string &profileId )
 {
   std::cout << "[ProfileManager] Deleting profile '" << profileId << "' from memory" << std::endl;
 
-  // Remove from in-memory profiles
-  if ( auto it = std::remove_if( m_customProfiles.begin(), m_customProfiles.end(),
-                           [&profileId]( const UccProfile &p ) { return p.id == profileId; } );
-       it != m_customProfiles.end() )
+  // Remove from in-memory profiles, and from the settings so that a later
+  // lookup by id cannot bring it back
+  if ( m_customProfiles.erase( profileId ) )
   {
-    m_customProfiles.erase( it, m_customProfiles.end() );
+    m_settings.profiles.erase( profileId );
 
     // Update DBus data
     updateDBusActiveProfileData();
@@ -3750,17 +5421,7 @@ bool UccDBusService::updateCustomProfile( const UccProfile &profile )
             << " bytes, profileName='" << profile.keyboard.keyboardProfileName << "'" << std::endl;
 
   // Check if this is a default (hardcoded) profile
-  bool isDefaultProfile = false;
-  for ( const auto &defaultProf : m_defaultProfiles )
-  {
-    if ( defaultProf.id == profile.id )
-    {
-      isDefaultProfile = true;
-      break;
-    }
-  }
-
-  if ( isDefaultProfile )
+  if ( std::ranges::find( m_defaultProfiles, profile.id, &UccProfile::id ) != m_defaultProfiles.end() )
   {
     std::cout << "[ProfileManager] Cannot update hardcoded default profile '" << profile.id << "'" << std::endl;
     std::cout << "[ProfileManager] Default profiles are read-only." << std::endl;
@@ -3769,17 +5430,20 @@ bool UccDBusService::updateCustomProfile( const UccProfile &profile )
   }
 
   // Update in-memory profile
-  if ( auto it = std::ranges::find_if( m_customProfiles,
-                         [&profile]( const UccProfile &p ) { return p.id == profile.id; } );
-       it != m_customProfiles.end() )
+  if ( m_customProfiles.contains( profile.id ) )
   {
-    *it = profile;
+    m_customProfiles.upsert( profile );
 
     // Update DBus data
     updateDBusActiveProfileData();
 
     // Update active profile if it was the one modified
-    if ( m_activeProfile.id == profile.id )
+    if ( m_activeProfile.id == profile.id && m_deferProfileApply )
+    {
+      std::cout << "[ProfileManager] Updated profile is active, applying it with the transaction" << std::endl;
+      m_deferredProfile = profile;
+    }
+    else if ( m_activeProfile.id == profile.id )
     {
       std::cout << "[ProfileManager] Updated profile is active, reapplying to system" << std::endl;
       const bool preservedWcEnable = m_dbusData.waterCoolerScanningEnabled.load();
@@ -3881,19 +5545,19 @@ void UccDBusService::initializeDisplayModes()
 
   // initialize display modes as empty array - will be populated by display worker if implemented
   // must be valid JSON (empty array, not empty string) for GUI to parse correctly
-  m_dbusData.displayModes = "[]";
+  m_dbusData.device.update( []( DeviceSnapshot &device ) { device.displayModes = "[]"; } );
 }
 
 std::optional< UniwillDeviceID > UccDBusService::identifyDevice()
 {
   // read dmi information from sysfs
-  const std::string dmiBasePath = "/sys/class/dmi/id";
+  const std::string dmiBasePath = ucc::sysfsPath( "/sys/class/dmi/id" );
   const std::string productSKU = SysfsNode< std::string >( dmiBasePath + "/product_sku" ).read().value_or( "" );
   const std::string boardName = SysfsNode< std::string >( dmiBasePath + "/board_name" ).read().value_or( "" );
 
   // get module info from tuxedo_io
   std::string deviceModelId;
-  m_io.deviceModelIdStr( deviceModelId );
+  m_ec.call( [&deviceModelId]( DeviceInterface &device ) { return device.deviceModelIdStr( deviceModelId ); } );
 
   // create dmi sku to device map (matches typescript version)
   std::map< std::string, UniwillDeviceID > dmiSKUDeviceMap;
@@ -4062,14 +5726,15 @@ void UccDBusService::loadSettings()
     updateDBusSettingsData();
   }
 
-  // Load custom profiles from settings BEFORE validating stateMap
+  // Load custom profiles from settings BEFORE validating stateMap; they are
+  // parsed here once and looked up by id from then on
   for ( const auto &[profileId, profileJson] : m_settings.profiles )
   {
     try
     {
       auto profile = m_profileManager.parseProfileJSON( profileJson );
-      m_customProfiles.push_back( profile );
       std::cout << "[Settings] Loaded profile '" << profile.name << "' (ID: " << profile.id << ") from settings" << std::endl;
+      m_customProfiles.upsert( std::move( profile ) );
     }
     catch ( const std::exception &e )
     {
@@ -4099,40 +5764,8 @@ void UccDBusService::loadSettings()
 
     auto &profileId = m_settings.stateMap[stateKey];
 
-    // check if assigned profile exists (either in m_customProfiles OR in m_settings.profiles)
-    bool profileExists = false;
-
-    // First check if it exists as a loaded custom profile object
-    for ( const auto &profile : m_customProfiles )
-    {
-      if ( profile.id == profileId )
-      {
-        profileExists = true;
-        break;
-      }
-    }
-
-    // If not found in objects, check if it exists as a key in m_settings.profiles (JSON map)
-    // This is important because a profile might be in the file but not yet parsed into an object
-    if ( !profileExists )
-    {
-      profileExists = ( m_settings.profiles.find( profileId ) != m_settings.profiles.end() );
-    }
-
-    // Also check default profiles
-    if ( !profileExists )
-    {
-      for ( const auto &profile : m_defaultProfiles )
-      {
-        if ( profile.id == profileId )
-        {
-          profileExists = true;
-          break;
-        }
-      }
-    }
-
-    if ( not profileExists )
+    // check if assigned profile exists among the custom or the default profiles
+    if ( not profileExists( profileId ) )
     {
       std::cout << "[Settings] Profile ID '" << profileId << "' for state '"
                 << stateKey << "' not found, removing assignment" << std::endl;
@@ -4167,6 +5800,8 @@ void UccDBusService::loadSettings()
 
 void UccDBusService::initializeStartupProfile()
 {
+  const StartupTimeline::Scope phase( m_startup, "startup-profile" );
+
   // Skip on unsupported devices — no workers are running
   if ( !m_dbusData.deviceSupported.load() )
     return;
@@ -4174,7 +5809,7 @@ void UccDBusService::initializeStartupProfile()
   UccProfile resolved = m_profileManager.resolveStartupProfile(
     m_deviceId,
     m_settings.stateMap,
-    m_settings.profiles
+    m_customProfiles
   );
 
   if ( resolved.id.empty() )
@@ -4184,7 +5819,7 @@ void UccDBusService::initializeStartupProfile()
   }
 
   m_activeProfile = resolved;
-  m_currentState = determineState();
+  m_currentState = currentPowerState();
   m_currentStateProfileId = resolved.id;
 
   snapProfileFrequencies( m_activeProfile );
@@ -4219,6 +5854,143 @@ void UccDBusService::applyStartupProfile()
 
   if ( m_dbusData.waterCoolerSupported )
     setWaterCoolerScanningEnabled( profile.fan.enableWaterCooler );
+
+  // DisplayWorker::onStart() applied the brightness
+  m_staleSubsystems &= ~( ProfileSubsystem::Fan | ProfileSubsystem::Cpu | ProfileSubsystem::Tdp
+                          | ProfileSubsystem::Keyboard | ProfileSubsystem::GpuOC | ProfileSubsystem::Display );
+}
+
+bool UccDBusService::patchProfile( const std::string &id, const std::string &patchJSON )
+{
+  // the stored custom profile, else the active one (e.g. applied via ApplyProfile)
+  const auto stored = m_customProfiles.find( id );
+  const bool isActive = m_activeProfile.id == id;
+  if ( !stored && !isActive )
+  {
+    std::cerr << "[Profile] PatchProfile: no custom or active profile '" << id << "'" << std::endl;
+    return false;
+  }
+
+  const UccProfile &base = stored ? *stored : m_activeProfile;
+  auto patched = mergePatchProfile( base, patchJSON );
+  if ( !patched )
+  {
+    std::cerr << "[Profile] PatchProfile: invalid patch for '" << id << "'" << std::endl;
+    return false;
+  }
+
+  if ( stored )
+    m_customProfiles.upsert( *patched );
+
+  if ( !isActive )
+    return true;
+
+  if ( m_deferProfileApply )
+    m_deferredProfile = std::move( *patched );
+  else
+    activateProfile( *patched );
+  return true;
+}
+
+void UccDBusService::applyProfileSubsystems( const UccProfile &profile, uint32_t subsystems )
+{
+  UCC_TRACE_SCOPE_ARG( "profile", "applyProfileSubsystems", subsystems );
+  using namespace ProfileSubsystem;
+
+  m_staleSubsystems &= ~subsystems;
+
+  // apply fan curves and pump auto-control
+  if ( subsystems & Fan )
+    applyFanAndPumpSettings( profile );
+
+  if ( ( subsystems & Cpu ) && m_cpuWorker )
+  {
+    std::cout << "[Profile] Applying CPU settings from profile" << std::endl;
+    m_cpuWorker->reapplyProfile();
+  }
+
+  if ( m_profileSettingsWorker && ( subsystems & Tdp ) )
+  {
+    std::cout << "[Profile] Applying TDP settings from profile" << std::endl;
+    m_profileSettingsWorker->reapplyProfile();
+
+    // Re-read TDP values after apply so D-Bus data reflects new hardware state
+    readHardwareCapabilities();
+  }
+
+  if ( m_profileSettingsWorker && ( subsystems & Charging ) )
+  {
+    const auto charging = m_dbusData.charging.load();
+
+    // Apply charging profile if the profile specifies one
+    if ( !profile.chargingProfile.empty() && charging->chargingProfilesAvailable != "[]" )
+    {
+      std::cout << "[Profile] Applying charging profile '" << profile.chargingProfile << "'" << std::endl;
+      if ( m_profileSettingsWorker->applyChargingProfile( profile.chargingProfile ) )
+      {
+        m_dbusData.charging.update( [&profile]( ChargingSnapshot &current ) {
+          current.currentChargingProfile = profile.chargingProfile;
+        } );
+        updateDBusSettingsData();
+      }
+    }
+
+    // Apply charging priority if the profile specifies one
+    if ( !profile.chargingPriority.empty() && charging->chargingPrioritiesAvailable != "[]" )
+    {
+      std::cout << "[Profile] Applying charging priority '" << profile.chargingPriority << "'" << std::endl;
+      if ( m_profileSettingsWorker->applyChargingPriority( profile.chargingPriority ) )
+      {
+        m_dbusData.charging.update( [&profile]( ChargingSnapshot &current ) {
+          current.currentChargingPriority = profile.chargingPriority;
+        } );
+      }
+    }
+
+    // Apply charge type and thresholds if the profile specifies them
+    if ( !profile.chargeType.empty() )
+    {
+      std::cout << "[Profile] Applying charge type '" << profile.chargeType << "'" << std::endl;
+      if ( m_profileSettingsWorker->setChargeType( profile.chargeType ) )
+        m_dbusData.charging.update( [&profile]( ChargingSnapshot &current ) { current.chargeType = profile.chargeType; } );
+    }
+    if ( profile.chargeStartThreshold >= 0 )
+    {
+      std::cout << "[Profile] Applying charge start threshold " << profile.chargeStartThreshold << std::endl;
+      if ( m_profileSettingsWorker->setChargeStartThreshold( profile.chargeStartThreshold ) )
+        m_dbusData.chargeStartThreshold = profile.chargeStartThreshold;
+    }
+    if ( profile.chargeEndThreshold >= 0 )
+    {
+      std::cout << "[Profile] Applying charge end threshold " << profile.chargeEndThreshold << std::endl;
+      if ( m_profileSettingsWorker->setChargeEndThreshold( profile.chargeEndThreshold ) )
+        m_dbusData.chargeEndThreshold = profile.chargeEndThreshold;
+    }
+  }
+
+  if ( subsystems & Keyboard )
+  {
+    if ( m_keyboardBacklightController.isAvailable()
+         && m_settings.keyboardBacklightControlEnabled
+         && !profile.keyboard.keyboardProfileData.empty()
+         && profile.keyboard.keyboardProfileData != "{}" )
+    {
+      bool kbResult = m_keyboardBacklightController.applyProfileKeyboardStates( profile.keyboard.keyboardProfileData );
+      std::cout << "[Profile] Keyboard apply result: " << ( kbResult ? "SUCCESS" : "FAILED" ) << std::endl;
+    }
+    else
+    {
+      std::cout << "[Profile] Keyboard apply SKIPPED — one or more conditions not met" << std::endl;
+    }
+  }
+
+  // Apply GPU OC and cTGP from the profile
+  if ( subsystems & GpuOC )
+    applyGpuOCFromProfile( profile );
+
+  // Fade the backlight to the profile's brightness
+  if ( ( subsystems & Display ) && m_displayWorker )
+    m_displayWorker->reapplyProfile();
 }
 
 void UccDBusService::applyFanAndPumpSettings( const UccProfile &profile )
@@ -4270,22 +6042,20 @@ void UccDBusService::applyFanAndPumpSettings( const UccProfile &profile )
     }
 
     // Apply pump auto-control if water cooler is connected and autoControlWC is enabled
-    if ( profile.fan.autoControlWC && m_waterCoolerWorker && m_dbusData.waterCoolerConnected.load()
+    auto *waterCoolerWorker = waterCooler();
+    if ( profile.fan.autoControlWC && waterCoolerWorker && m_dbusData.waterCoolerConnected.load()
          && !pumpTable.empty() )
     {
       int maxTemp = 0;
-      {
-        std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-        for ( const auto &fan : m_dbusData.fans )
-          maxTemp = std::max( maxTemp, fan.temp.data );
-      }
+      for ( const auto &fan : *m_dbusData.fans.load() )
+        maxTemp = std::max( maxTemp, fan.temp.data );
       FanProfile tempFp;
       tempFp.tablePump = pumpTable;
       // Reset hysteresis before a one-shot profile apply so the continuous
       // loop re-initialises to the correct level on the next tick.
       m_pumpHysSpeedIdx = 0;
       m_pumpHysThreshold = 0;
-      m_waterCoolerWorker->setPumpVoltage( static_cast<int>( tempFp.getPumpSpeedForTemp( maxTemp ) ) );
+      waterCoolerWorker->setPumpVoltage( static_cast<int>( tempFp.getPumpSpeedForTemp( maxTemp ) ) );
       std::cout << "[FanPump] Applied pump voltage for temp " << maxTemp << "°C" << std::endl;
     }
   }
@@ -4297,6 +6067,10 @@ void UccDBusService::applyFanAndPumpSettings( const UccProfile &profile )
 
 void UccDBusService::applyGpuOCFromProfile( const UccProfile &profile )
 {
+  // a profile change takes the GPU over from a running tuning job
+  if ( m_gpuTuningActive )
+    endGpuTuning( false );
+
   // GPU OC / cTGP data lives exclusively inside gpuOCProfileData.
   // Profiles with no GPU profile selected have empty gpuOCProfileData and
   // should not touch GPU state at all.
@@ -4320,15 +6094,157 @@ void UccDBusService::applyGpuOCFromProfile( const UccProfile &profile )
   }
 
   // Apply GPU OC settings (clock offsets, locked clocks, power limit)
-  if ( m_nvidiaOCWorker && m_nvidiaOCWorker->isAvailable() )
+  // profiles without OC data leave NvidiaOCWorker unbuilt
+  if ( profile.gpuOCProfileData.empty() || profile.gpuOCProfileData == "{}" )
+    return;
+  if ( auto *oc = nvidiaOC(); oc && oc->isAvailable() )
   {
     std::cout << "[GpuOc] Applying embedded GPU OC profile data from profile '"
               << profile.name << "'" << std::endl;
-    if ( !m_nvidiaOCWorker->applyGpuOCProfile( profile.gpuOCProfileData, 0 ) )
+    if ( !oc->applyGpuOCProfile( profile.gpuOCProfileData, 0 ) )
       std::cerr << "[GpuOC] Failed to apply GPU OC profile data" << std::endl;
   }
 }
 
+bool UccDBusService::startGpuTuning( GpuOcTuningOptions options )
+{
+  if ( m_gpuTuner && m_gpuTuner->state() == GpuOcTuningState::Running )
+  {
+    syslog( LOG_WARNING, "[GpuTune] A tuning job is already running" );
+    return false;
+  }
+  auto *oc = nvidiaOC();
+  if ( !oc || !oc->isAvailable() )
+    return false;
+
+  // locked clocks keep the GPU's own floor unless the caller chose one
+  if ( options.lockedMinMHz == 0 )
+  {
+    const QJsonDocument state = QJsonDocument::fromJson( QByteArray::fromStdString( oc->getOCStateJSON( 0 ) ) );
+    options.lockedMinMHz = static_cast< unsigned >(
+      std::max( 0, state.object().value( "gpuClockRange" ).toObject().value( "min" ).toInt( 0 ) ) );
+  }
+  if ( const std::string error = options.validate(); !error.empty() )
+  {
+    syslog( LOG_WARNING, "[GpuTune] Rejected tuning options: %s", error.c_str() );
+    return false;
+  }
+
+  m_gpuTuner = std::make_unique< GpuOcTuner >( std::move( options ) );
+  m_gpuTuningActive = true;
+  syslog( LOG_INFO, "[GpuTune] Started, %zu candidate(s)", m_gpuTuner->candidateCount() );
+  advanceGpuTuning( m_gpuTuner->start( SamplingGovernor::nowMs() ) );
+  if ( m_gpuTuner->state() == GpuOcTuningState::Running )
+    m_gpuTuningTimer.start( GPU_TUNING_SAMPLE_PERIOD );
+  return true;
+}
+
+void UccDBusService::stepGpuTuning()
+{
+  if ( !m_gpuTuner || m_gpuTuner->state() != GpuOcTuningState::Running )
+  {
+    m_gpuTuningTimer.stop();
+    return;
+  }
+
+  // keep HardwareMonitorWorker at its normal rate while the job measures
+  m_samplingGovernor->noteClientActivity();
+
+  const auto gpu = m_dbusData.gpu.load();
+  const DGpuInfo &dGpu = gpu->dGpuInfo;
+  const GpuOcSample sample{ SamplingGovernor::nowMs(), dGpu.m_coreFrequency, dGpu.m_powerDraw,
+                            dGpu.m_computeUtilPct, dGpu.m_perfLimitReason };
+  advanceGpuTuning( m_gpuTuner->onSample( sample ) );
+}
+
+void UccDBusService::advanceGpuTuning( std::optional< GpuOcSetting > next )
+{
+  auto *oc = nvidiaOC();
+  while ( next && m_gpuTuner->state() == GpuOcTuningState::Running )
+  {
+    if ( oc && oc->applyGpuOCProfile( GpuOcTuner::profileJSON( *next, m_gpuTuner->options().lockedMinMHz ), 0 ) )
+      break;
+    syslog( LOG_INFO, "[GpuTune] Driver refused %.1f W / %u MHz / %+d MHz", next->powerLimitW,
+            next->lockedMaxMHz, next->offsetMHz );
+    next = m_gpuTuner->onApplyFailed( SamplingGovernor::nowMs() );
+  }
+
+  if ( m_gpuTuner->state() != GpuOcTuningState::Running )
+    endGpuTuning();
+}
+
+void UccDBusService::endGpuTuning( bool restore )
+{
+  if ( !m_gpuTuner || !m_gpuTuningActive )
+    return;
+  m_gpuTuner->cancel();
+  m_gpuTuningTimer.stop();
+  m_gpuTuningActive = false;
+  syslog( LOG_INFO, "[GpuTune] Ended: %s %s", GpuOcTuner::stateName( m_gpuTuner->state() ),
+          m_gpuTuner->error().c_str() );
+
+  if ( !restore )
+    return;
+  // back to what the active profile asked for; a profile without GPU data
+  // leaves the driver defaults
+  if ( auto *oc = nvidiaOC() )
+    oc->resetAll( 0 );
+  applyGpuOCFromProfile( m_activeProfile );
+}
+
+std::optional< UccProfile > UccDBusService::resolveProfile( const std::string &id ) const
+{
+  // Try persistent (custom) profiles first
+  if ( const auto custom = m_customProfiles.find( id ) )
+    return *custom;
+
+  // Fall back to built-in profiles
+  if ( auto it = std::ranges::find( m_defaultProfiles, id, &UccProfile::id ); it != m_defaultProfiles.end() )
+    return *it;
+  return std::nullopt;
+}
+
+bool UccDBusService::profileExists( const std::string &id ) const
+{
+  return m_customProfiles.contains( id )
+         || std::ranges::find( m_defaultProfiles, id, &UccProfile::id ) != m_defaultProfiles.end();
+}
+
+void UccDBusService::activateProfile( const UccProfile &profile, uint32_t skip )
+{
+  // Preserve runtime water cooler enable state across profile re-application.
+  // The user's explicit EnableWaterCooler() D-Bus call is authoritative;
+  // the stored profile may have a stale enableWaterCooler value.
+  UccProfile next = profile;
+  next.fan.enableWaterCooler = m_dbusData.waterCoolerScanningEnabled.load();
+  snapProfileFrequencies( next );
+
+  const uint32_t changed = changedProfileSubsystems( m_activeProfile, next ) | m_staleSubsystems;
+  const uint32_t toApply = changed & ~skip;
+  std::cout << "[Profile] Activating '" << next.name << "', subsystems 0x"
+            << std::hex << toApply << std::dec << std::endl;
+
+  m_activeProfile = std::move( next );
+  if ( changed == 0 )
+    return;
+  updateDBusActiveProfileData();
+  applyProfileSubsystems( m_activeProfile, toApply );
+  m_staleSubsystems |= changed & skip;
+
+  // Emit ProfileChanged signal for DBus clients
+  if ( m_adaptor )
+    m_adaptor->emitProfileChanged( m_activeProfile.id,
+                                   m_activeProfile.keyboard.keyboardProfileId,
+                                   m_activeProfile.fan.fanProfile );
+}
+
+ProfileState UccDBusService::currentPowerState() const noexcept
+{
+  if ( m_powerSupply.active() )
+    return m_powerSupply.state();
+  return m_sensorPoller ? determineState( *m_sensorPoller, m_mainsOnlineNode ) : determineState();
+}
+
 void UccDBusService::applyProfileForCurrentState()
 {
   const std::string stateKey = profileStateToString( m_currentState );
@@ -4344,147 +6260,234 @@ void UccDBusService::applyProfileForCurrentState()
 
   std::cout << "[State] Applying profile for state '" << stateKey << "': " << profileId << std::endl;
 
-  // Lambda to apply all profile settings (fan curves, sameSpeed, CPU, ODM, keyboard, pump auto-control)
-  auto applyFullProfile = [this]( const UccProfile &profile )
+  if ( auto profile = resolveProfile( profileId ) )
   {
-    // Preserve runtime water cooler enable state across profile re-application.
-    // The user's explicit EnableWaterCooler() D-Bus call is authoritative;
-    // the stored profile may have a stale enableWaterCooler value.
-    const bool preservedWcEnable = m_dbusData.waterCoolerScanningEnabled.load();
-    m_activeProfile = profile;
-    m_activeProfile.fan.enableWaterCooler = preservedWcEnable;
-    snapProfileFrequencies( m_activeProfile );
-    updateDBusActiveProfileData();
+    std::cout << "[State] Applied profile: " << profile->name
+              << " (ID: " << profile->id << ")" << std::endl;
+    // charging settings are left to explicit profile switches
+    activateProfile( *profile, ProfileSubsystem::Charging );
+    return;
+  }
+
+  std::cerr << "[State] WARNING: Profile ID '" << profileId << "' not found for state '" << stateKey << "'" << std::endl;
+}
+
+void UccDBusService::updateAlertRules()
+{
+  for ( const AlertRule &rule : m_settings.alertRules )
+  {
+    if ( const auto error = AlertEngine::validateShape( rule ) )
+      syslog( LOG_WARNING, "Alert rule '%s' skipped: %s", rule.id.c_str(), error->c_str() );
+    else if ( !m_metricsStore.registry().find( rule.metric ) )
+      syslog( LOG_INFO, "Alert rule '%s' waits for metric '%s'", rule.id.c_str(), rule.metric.c_str() );
+  }
+  const size_t armed = m_alertEngine.setRules( m_settings.alertRules, m_metricsStore.registry() );
+  if ( armed > 0 )
+    syslog( LOG_INFO, "Alerts: %zu rule(s) armed", armed );
+}
+
+void UccDBusService::updateWorkloadRules()
+{
+  {
+    std::lock_guard< std::mutex > lock( m_workloadMutex );
+    m_workloadSelector.setRules( m_settings.workloadRules );
+  }
+
+  // every exec on the system wakes the socket: only listen while there are rules
+  if ( m_settings.workloadRules.empty() )
+  {
+    m_procNotifier.reset();
+    m_procMonitor.stop();
+    wake();
+    return;
+  }
 
-    // Apply sameSpeed setting to fan worker
-    if ( m_fanControlWorker )
+  if ( !m_procMonitor.active() )
+  {
+    if ( !m_procMonitor.start() )
     {
-      m_fanControlWorker->setSameSpeed( profile.fan.sameSpeed );
+      syslog( LOG_WARNING, "Workload rules: proc connector unavailable, per-application profiles disabled" );
+      return;
     }
+    m_procNotifier = std::make_unique< QSocketNotifier >( m_procMonitor.fd(), QSocketNotifier::Read );
+    QObject::connect( m_procNotifier.get(), &QSocketNotifier::activated, this, [this]() { drainProcEvents(); } );
+  }
 
-    // Resolve and apply fan curves: prefer embedded tables, fallback to named profile
-    try
-    {
-      std::vector< FanTableEntry > cpuTable;
-      std::vector< FanTableEntry > gpuTable;
-      std::vector< FanTableEntry > wcFanTable;
-      std::vector< FanTableEntry > pumpTable;
+  // applications started before the rules (or the daemon)
+  scanWorkloadProcesses();
+  wake();
+}
 
-      if ( profile.fan.hasEmbeddedTables() )
-      {
-        cpuTable = profile.fan.tableCPU;
-        gpuTable = profile.fan.tableGPU;
-        wcFanTable = profile.fan.tableWaterCoolerFan;
-        pumpTable = profile.fan.tablePump;
-        std::cout << "[State] Using embedded fan tables from profile" << std::endl;
-      }
+void UccDBusService::drainProcEvents()
+{
+  // procfs is read as the event arrives, outside the lock the tick takes
+  std::vector< std::pair< ProcEvent, std::optional< ProcessIdentity > > > events;
+  bool lost = false;
+  m_procMonitor.drain( [&events, &lost]( const ProcEvent &event ) {
+    if ( event.kind == ProcEvent::Kind::Lost )
+      lost = true;
+    else
+      events.emplace_back( event, event.kind == ProcEvent::Kind::Exec ? ProcessIdentity::read( event.pid )
+                                                                       : std::nullopt );
+  } );
+
+  bool changed = false;
+  {
+    const int64_t nowMs = SamplingGovernor::nowMs();
+    std::lock_guard< std::mutex > lock( m_workloadMutex );
+    for ( const auto &[ event, process ] : events )
+    {
+      if ( event.kind == ProcEvent::Kind::Exec )
+        changed = m_workloadSelector.exec( event.pid, process, nowMs ) || changed;
       else
-      {
-        const std::string &fpName = profile.fan.fanProfile;
-        if ( !fpName.empty() )
-        {
-          FanProfile fp = getDefaultFanProfile( fpName );
-          if ( fp.isValid() )
-          {
-            cpuTable = fp.tableCPU;
-            gpuTable = fp.tableGPU;
-            wcFanTable = fp.tableWaterCoolerFan;
-            pumpTable = fp.tablePump;
-            std::cout << "[State] Using fan tables from named profile '" << fpName << "'" << std::endl;
-          }
-        }
-      }
+        changed = m_workloadSelector.exit( event.pid, nowMs ) || changed;
+    }
+  }
+  if ( lost )
+  {
+    syslog( LOG_NOTICE, "Workload rules: process events lost, rescanning" );
+    scanWorkloadProcesses();
+    changed = true;
+  }
 
-      if ( m_fanControlWorker && !cpuTable.empty() )
-      {
-        m_fanControlWorker->applyTemporaryFanCurves( cpuTable, gpuTable, wcFanTable, pumpTable );
-        std::cout << "[State] Applied fan curves (CPU=" << cpuTable.size()
-                  << " GPU=" << gpuTable.size()
-                  << " WCFan=" << wcFanTable.size()
-                  << " Pump=" << pumpTable.size() << ")" << std::endl;
-      }
+  // the tick switches profiles; run it now instead of within the next second
+  if ( changed )
+    wake();
+}
 
-      // Apply pump auto-control if water cooler is connected and autoControlWC is enabled
-      if ( profile.fan.autoControlWC && m_waterCoolerWorker && m_dbusData.waterCoolerConnected.load()
-           && !pumpTable.empty() )
-      {
-        int maxTemp = 0;
-        {
-          std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-          for ( const auto &fan : m_dbusData.fans )
-            maxTemp = std::max( maxTemp, fan.temp.data );
-        }
-        FanProfile tempFp;
-        tempFp.tablePump = pumpTable;
-        // Reset hysteresis before a one-shot profile apply so the continuous
-        // loop re-initialises to the correct level on the next tick.
-        m_pumpHysSpeedIdx = 0;
-        m_pumpHysThreshold = 0;
-        m_waterCoolerWorker->setPumpVoltage( static_cast<int>( tempFp.getPumpSpeedForTemp( maxTemp ) ) );
-        std::cout << "[State] Applied pump voltage for temp " << maxTemp << "°C" << std::endl;
-      }
-    }
-    catch ( const std::exception &e )
+int64_t UccDBusService::keyboardIdleTimeoutMs() const noexcept
+{
+  const int seconds = m_keyboardOnBattery ? m_settings.keyboardIdleTimeoutBatS : m_settings.keyboardIdleTimeoutAcS;
+  return m_settings.keyboardBacklightControlEnabled && m_keyboardBacklightController.isAvailable()
+           ? int64_t( seconds ) * 1000
+           : 0;
+}
+
+void UccDBusService::armKeyboardIdle()
+{
+  if ( keyboardIdleTimeoutMs() <= 0 )
+  {
+    m_keyboardIdleTimer.stop();
+    m_inputNotifier.reset();
+    m_inputActivity.close();
+    if ( m_keyboardIdle )
     {
-      std::cerr << "[State] Failed to apply fan curves: " << e.what() << std::endl;
+      m_keyboardIdle = false;
+      m_keyboardBacklightController.setIdle( false );
     }
+    return;
+  }
 
-    // Apply CPU/ODM/keyboard workers
-    if ( m_cpuWorker )
-      m_cpuWorker->reapplyProfile();
-    if ( m_profileSettingsWorker )
-      m_profileSettingsWorker->reapplyProfile();
-    if ( m_keyboardBacklightController.isAvailable()
-         && m_settings.keyboardBacklightControlEnabled
-         && !profile.keyboard.keyboardProfileData.empty()
-         && profile.keyboard.keyboardProfileData != "{}" )
-      m_keyboardBacklightController.applyProfileKeyboardStates( profile.keyboard.keyboardProfileData );
+  if ( !m_inputActivity.sync( InputActivityMonitor::findDevices() ) )
+  {
+    syslog( LOG_WARNING, "Keyboard idle timeout: cannot watch input devices" );
+    return;
+  }
+  if ( !m_inputNotifier )
+  {
+    m_inputNotifier = std::make_unique< QSocketNotifier >( m_inputActivity.fd(), QSocketNotifier::Read );
+    m_inputNotifier->setEnabled( m_keyboardIdle );
+    QObject::connect( m_inputNotifier.get(), &QSocketNotifier::activated, this, [this]() { onInputActivity(); } );
+  }
+  if ( m_lastInputMs == 0 )
+    m_lastInputMs = SamplingGovernor::nowMs();
+  checkKeyboardIdle();
+}
 
-    // Apply GPU OC and cTGP from the profile
-    applyGpuOCFromProfile( profile );
+void UccDBusService::checkKeyboardIdle()
+{
+  // while dark the notifier waits for the first event
+  const int64_t timeoutMs = keyboardIdleTimeoutMs();
+  if ( m_keyboardIdle || timeoutMs <= 0 )
+    return;
 
-    // Water cooler scanning state is preserved from the runtime flag
-    // (set via EnableWaterCooler D-Bus call). Do NOT re-read enableWaterCooler
-    // from the stored profile — it may be stale.
+  // the events queued since the last look; keyboards plugged in meanwhile join
+  m_inputActivity.sync( InputActivityMonitor::findDevices() );
+  const int64_t nowMs = SamplingGovernor::nowMs();
+  if ( const auto newest = m_inputActivity.drain() )
+    m_lastInputMs = std::clamp( *newest, m_lastInputMs, nowMs );
 
-    // Emit ProfileChanged signal for DBus clients
-    if ( m_adaptor )
-      m_adaptor->emitProfileChanged( profile.id,
-                                     profile.keyboard.keyboardProfileId,
-                                     profile.fan.fanProfile );
-  };
+  const int64_t remainingMs = timeoutMs - ( nowMs - m_lastInputMs );
+  if ( remainingMs > 0 )
+  {
+    m_keyboardIdleTimer.start( std::chrono::milliseconds( remainingMs ) );
+    return;
+  }
 
-  // Try persistent (custom) profiles first
-  if ( auto profileIt = m_settings.profiles.find( profileId );
-       profileIt != m_settings.profiles.end() )
+  m_keyboardIdle = true;
+  m_keyboardBacklightController.setIdle( true );
+  m_inputNotifier->setEnabled( true );
+}
+
+void UccDBusService::onInputActivity()
+{
+  m_inputActivity.drain();
+  m_lastInputMs = SamplingGovernor::nowMs();
+  m_inputNotifier->setEnabled( false );
+  if ( m_keyboardIdle )
   {
-    try
-    {
-      auto profile = m_profileManager.parseProfileJSON( profileIt->second );
-      std::cout << "[State] Applied profile from settings: " << profile.name
-                << " (ID: " << profile.id << ")" << std::endl;
-      applyFullProfile( profile );
-      return;
-    }
-    catch ( const std::exception &e )
-    {
-      std::cerr << "[State] Failed to parse profile '" << profileId << "': " << e.what() << std::endl;
-    }
+    m_keyboardIdle = false;
+    m_keyboardBacklightController.setIdle( false );
   }
+  m_keyboardIdleTimer.start( std::chrono::milliseconds( keyboardIdleTimeoutMs() ) );
+}
 
-  // Fall back to built-in profiles
-  for ( const auto &profile : getAllProfiles() )
+void UccDBusService::scanWorkloadProcesses()
+{
+  std::vector< std::pair< pid_t, ProcessIdentity > > processes;
+  ProcessIdentity::forEachProcess( [&processes]( pid_t pid ) {
+    if ( auto process = ProcessIdentity::read( pid ) )
+      processes.emplace_back( pid, std::move( *process ) );
+  } );
+
+  const int64_t nowMs = SamplingGovernor::nowMs();
+  std::lock_guard< std::mutex > lock( m_workloadMutex );
+  m_workloadSelector.forgetProcesses();
+  for ( const auto &[ pid, process ] : processes )
+    m_workloadSelector.exec( pid, process, nowMs );
+}
+
+void UccDBusService::updateWorkloadProfile()
+{
+  std::string wanted;
   {
-    if ( profile.id == profileId )
-    {
-      std::cout << "[State] Applied built-in profile: " << profile.name
-                << " (ID: " << profile.id << ")" << std::endl;
-      applyFullProfile( profile );
-      return;
-    }
+    std::lock_guard< std::mutex > lock( m_workloadMutex );
+    wanted = m_workloadSelector.profile( SamplingGovernor::nowMs() );
   }
+  if ( wanted == m_workloadProfileId )
+    return;
+  const std::string previous = std::exchange( m_workloadProfileId, wanted );
 
-  std::cerr << "[State] WARNING: Profile ID '" << profileId << "' not found for state '" << stateKey << "'" << std::endl;
+  std::string target = wanted;
+  if ( wanted.empty() )
+  {
+    // back to what ran before, or to the state's profile if the power state changed meanwhile
+    target = std::exchange( m_workloadBaseProfileId, std::string() );
+    if ( m_activeProfile.id != previous )
+      return; // switched away from the rule's profile by hand: leave it
+    if ( m_currentState != m_workloadBaseState || target.empty() )
+      target = m_currentStateProfileId;
+  }
+  else if ( previous.empty() )
+  {
+    m_workloadBaseProfileId = m_activeProfile.id;
+    m_workloadBaseState = m_currentState;
+  }
+
+  if ( target.empty() || target == m_activeProfile.id )
+    return;
+  const auto profile = resolveProfile( target );
+  if ( !profile )
+  {
+    ucc::asyncErr( "[Workload] Profile ID '" + target + "' not found" );
+    return;
+  }
+
+  ucc::asyncOut( wanted.empty() ? "[Workload] Applications exited, back to profile: " + target
+                                : "[Workload] Application started, switching to profile: " + target );
+  m_metricsStore.recordEvent( ucc::MetricEventKind::ProfileSwitch, 0, profile->name.empty() ? target : profile->name );
+  // through the diff: only what the two profiles set differently is written
+  activateProfile( *profile, ProfileSubsystem::Charging );
 }
 
 void UccDBusService::serializeProfilesJSON()
@@ -4546,28 +6549,23 @@ void UccDBusService::serializeProfilesJSON()
   }
   defaultProfilesJSON << "]";
 
-  std::ostringstream customProfilesJSON;
-  customProfilesJSON << "[";
-  for ( size_t i = 0; i < m_customProfiles.size(); ++i )
-  {
-    if ( i > 0 )
-      customProfilesJSON << ",";
-
-    customProfilesJSON << profileToJSON( m_customProfiles[ i ],
-                       defaultOnlineCores,
-                       defaultScalingMin,
-                       defaultScalingMax );
-  }
-  customProfilesJSON << "]";
+  QVariantList defaultProfilesWire = profilesToDBusWire( m_defaultProfiles,
+                                                         defaultOnlineCores,
+                                                         defaultScalingMin,
+                                                         defaultScalingMax );
 
-  std::lock_guard< std::mutex > lock( m_dbusData.dataMutex );
-  m_dbusData.profilesJSON = defaultProfilesJSON.str();  // Only default profiles now
-  m_dbusData.defaultProfilesJSON = defaultProfilesJSON.str();
-  m_dbusData.customProfilesJSON = "[]";  // Empty array since custom profiles are local
-  m_dbusData.defaultValuesProfileJSON = profileToJSON( defaultProfile,
+  const std::string defaultsJSON = defaultProfilesJSON.str();
+  const std::string defaultValuesJSON = profileToJSON( defaultProfile,
                                                        defaultOnlineCores,
                                                        defaultScalingMin,
                                                        defaultScalingMax );
+  m_dbusData.profiles.update( [&]( ProfileSnapshot &profiles ) {
+    profiles.profilesJSON.set( defaultsJSON );  // Only default profiles now
+    profiles.defaultProfilesJSON.set( defaultsJSON );
+    profiles.defaultProfilesWire = defaultProfilesWire;
+    profiles.customProfilesJSON.set( "[]" );  // Empty array since custom profiles are local
+    profiles.defaultValuesProfileJSON = defaultValuesJSON;
+  } );
 
   std::cout << "[DBus] Re-serialized profile JSONs" << std::endl;
 }
@@ -4578,43 +6576,20 @@ void UccDBusService::fillDeviceSpecificDefaults( std::vector< UccProfile > &prof
   const int32_t cpuMaxFreq = getCpuMaxFrequency();
 
   // Get TDP info directly from hardware I/O
-  std::vector< TDPInfo > tdpInfo;
+  const std::vector< TDPInfo > tdpInfo = readTDPInfo();
+  if ( not tdpInfo.empty() )
   {
-    int nrTDPs = 0;
-    if ( m_io.getNumberTDPs( nrTDPs ) and nrTDPs > 0 )
-    {
-      std::vector< std::string > descriptors;
-      m_io.getTDPDescriptors( descriptors );
-
-      for ( int i = 0; i < nrTDPs; ++i )
-      {
-        TDPInfo info;
-        info.current = 0;
-        info.min = 0;
-        info.max = 0;
-        info.descriptor = ( i < static_cast< int >( descriptors.size() ) )
-                            ? descriptors[ static_cast< size_t >( i ) ]
-                            : "";
-
-        m_io.getTDPMin( i, reinterpret_cast< int & >( info.min ) );
-        m_io.getTDPMax( i, reinterpret_cast< int & >( info.max ) );
-        m_io.getTDP( i, reinterpret_cast< int & >( info.current ) );
-
-        tdpInfo.push_back( info );
-      }
-
-      std::cout << "[fillDeviceSpecificDefaults] TDP info available: " << tdpInfo.size() << " entries" << std::endl;
-      for ( size_t i = 0; i < tdpInfo.size(); ++i )
-      {
-        std::cout << "[fillDeviceSpecificDefaults]   TDP[" << i << "]: min=" << tdpInfo[i].min
-                  << ", max=" << tdpInfo[i].max << ", current=" << tdpInfo[i].current << std::endl;
-      }
-    }
-    else
+    std::cout << "[fillDeviceSpecificDefaults] TDP info available: " << tdpInfo.size() << " entries" << std::endl;
+    for ( size_t i = 0; i < tdpInfo.size(); ++i )
     {
-      std::cout << "[fillDeviceSpecificDefaults] No TDP hardware available" << std::endl;
+      std::cout << "[fillDeviceSpecificDefaults]   TDP[" << i << "]: min=" << tdpInfo[i].min
+                << ", max=" << tdpInfo[i].max << ", current=" << tdpInfo[i].current << std::endl;
     }
   }
+  else
+  {
+    std::cout << "[fillDeviceSpecificDefaults] No TDP hardware available" << std::endl;
+  }
 
   for ( auto &profile : profiles )
   {
@@ -4699,16 +6674,172 @@ void UccDBusService::loadAutosave()
             << m_autosave.displayBrightness << "%)" << std::endl;
 }
 
-void UccDBusService::saveAutosave()
+void UccDBusService::persistSettings()
+{
+  m_settingsPersist.markDirty( PersistQueue::Clock::now() );
+  armPersistTimer();
+}
+
+void UccDBusService::persistAutosave()
+{
+  m_autosavePersist.markDirty( PersistQueue::Clock::now() );
+  armPersistTimer();
+}
+
+void UccDBusService::armPersistTimer()
+{
+  std::optional< PersistQueue::Clock::time_point > due = m_settingsPersist.deadline();
+  if ( const auto autosaveDue = m_autosavePersist.deadline(); autosaveDue && ( !due || *autosaveDue < *due ) )
+    due = autosaveDue;
+  if ( !due )
+  {
+    m_persistTimer.stop();
+    return;
+  }
+
+  const auto wait = std::chrono::ceil< std::chrono::milliseconds >( *due - PersistQueue::Clock::now() );
+  m_persistTimer.start( std::max( wait, std::chrono::milliseconds( 0 ) ) );
+}
+
+bool UccDBusService::flushPersistQueues()
+{
+  const bool settingsOk = m_settingsPersist.flush();
+  const bool autosaveOk = m_autosavePersist.flush();
+  m_persistTimer.stop();
+  if ( !settingsOk )
+    std::cerr << "[Settings] Failed to persist settings" << std::endl;
+  if ( !autosaveOk )
+    std::cerr << "[Autosave] Failed to save autosave!" << std::endl;
+  return settingsOk && autosaveOk;
+}
+
+void UccDBusService::setPersistQuietPeriod( std::chrono::milliseconds quietPeriod )
+{
+  m_settingsPersist.setQuietPeriod( quietPeriod );
+  m_autosavePersist.setQuietPeriod( quietPeriod );
+}
+
+void UccDBusService::onPrepareForSleep( bool suspending )
 {
-  if ( m_autosaveManager.writeAutosave( m_autosave ) )
+  if ( suspending )
   {
-    std::cout << "[Autosave] Saved autosave" << std::endl;
+    // the driver drops OC settings over suspend; measurements would not carry over
+    endGpuTuning( false );
+    quiesceForSleep();
+    // let the system sleep
+    m_sleepInhibitor = QDBusUnixFileDescriptor();
   }
   else
   {
-    std::cerr << "[Autosave] Failed to save autosave!" << std::endl;
+    restoreAfterSleep();
+    takeSleepInhibitor();
+  }
+}
+
+void UccDBusService::takeSleepInhibitor()
+{
+  if ( m_sleepInhibitor.isValid() )
+    return;
+
+  QDBusMessage call = QDBusMessage::createMethodCall( "org.freedesktop.login1", "/org/freedesktop/login1",
+                                                      "org.freedesktop.login1.Manager", "Inhibit" );
+  call << QStringLiteral( "sleep" ) << QStringLiteral( "uccd" )
+       << QStringLiteral( "Pause hardware control and save settings" ) << QStringLiteral( "delay" );
+  const QDBusReply< QDBusUnixFileDescriptor > reply = QDBusConnection::systemBus().call( call );
+  if ( reply.isValid() )
+    m_sleepInhibitor = reply.value();
+  else
+    syslog( LOG_WARNING, "Cannot take a sleep delay lock, the system may sleep mid-cycle: %s",
+            qPrintable( reply.error().message() ) );
+}
+
+bool UccDBusService::sessionsIdle()
+{
+  // Desktops set it once their idle timeout passes and clear it on input;
+  // a short timeout keeps a stuck logind from stalling the tick
+  QDBusMessage call = QDBusMessage::createMethodCall( "org.freedesktop.login1", "/org/freedesktop/login1",
+                                                      "org.freedesktop.DBus.Properties", "Get" );
+  call << QStringLiteral( "org.freedesktop.login1.Manager" ) << QStringLiteral( "IdleHint" );
+  const QDBusReply< QDBusVariant > reply = QDBusConnection::systemBus().call( call, QDBus::Block, 500 );
+  return reply.isValid() && reply.value().variant().toBool();
+}
+
+std::array< DaemonWorker *, 6 > UccDBusService::sleepingWorkers() noexcept
+{
+  return { this, m_fanControlWorker.get(), m_cpuWorker.get(), m_displayWorker.get(),
+           m_hardwareMonitorWorker.get(), m_keyboardEffectWorker.get() };
+}
+
+void UccDBusService::quiesceForSleep()
+{
+  const auto begin = std::chrono::steady_clock::now();
+  if ( m_fanWatchdog )
+    m_fanWatchdog->disarm();
+  const auto workers = sleepingWorkers();
+  for ( DaemonWorker *worker : workers )
+    if ( worker )
+      worker->pause();
+
+  // A cycle in progress may wait for the main thread (BlockingQueuedConnection)
+  const auto deadline = begin + SLEEP_QUIESCE_TIMEOUT;
+  auto *app = QCoreApplication::instance();
+  const auto allPaused = [&workers]() {
+    return std::ranges::all_of( workers, []( DaemonWorker *w ) { return !w || w->isPaused(); } );
+  };
+  while ( !allPaused() && std::chrono::steady_clock::now() < deadline )
+  {
+    if ( app )
+      app->processEvents( QEventLoop::AllEvents, 10 );
+    else
+      QThread::msleep( 5 );
+  }
+
+  flushPersistQueues();
+
+  const auto elapsedMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::steady_clock::now() - begin ).count();
+  if ( allPaused() )
+    syslog( LOG_INFO, "System suspending, workers paused after %lld ms", static_cast< long long >( elapsedMs ) );
+  else
+    syslog( LOG_WARNING, "System suspending, a worker cycle is still running after %lld ms",
+            static_cast< long long >( elapsedMs ) );
+}
+
+void UccDBusService::restoreAfterSleep()
+{
+  const auto begin = std::chrono::steady_clock::now();
+
+  // The EC drops the fan duties and the keyboard its lighting over a
+  // suspend; those are what the user notices first
+  if ( m_fanControlWorker )
+    m_fanControlWorker->resendFanSpeeds();
+  for ( DaemonWorker *worker : sleepingWorkers() )
+    if ( worker )
+      worker->resume();
+
+  // whoever woke it is at the keyboard: light it and start the idle timeout over
+  if ( m_keyboardIdle )
+  {
+    m_keyboardIdle = false;
+    m_inputNotifier->setEnabled( false );
+    m_keyboardBacklightController.setIdle( false );
   }
+  m_lastInputMs = SamplingGovernor::nowMs();
+  armKeyboardIdle();
+
+  m_keyboardBacklightController.forgetShownState();
+  if ( m_dbusData.deviceSupported.load() )
+  {
+    using namespace ProfileSubsystem;
+    applyProfileSubsystems( m_activeProfile, Keyboard );
+    applyProfileSubsystems( m_activeProfile, Tdp | Cpu | GpuOC );
+  }
+  // firmware may have restored its own values; check everything on the next tick
+  m_reconciler.poke();
+
+  const auto elapsedMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+    std::chrono::steady_clock::now() - begin ).count();
+  syslog( LOG_INFO, "System resumed, hardware state restored in %lld ms", static_cast< long long >( elapsedMs ) );
 }
 
 std::vector< std::vector< std::string > > UccDBusService::getOutputPorts()
@@ -30,6 +30,9 @@
 #include <fcntl.h>
 #include <filesystem>
 #include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <optional>
 
 // Qt includes
 #include <QCoreApplication>
@@ -38,6 +41,7 @@
 
 // Hardware abstraction layer
 #include "tuxedo_io_lib/tuxedo_io_api.hh"
+#include "AsyncLog.hpp"
 #include "workers/HardwareMonitorWorker.hpp"
 #include "UccDBusService.hpp"
 #include "SettingsManager.hpp"
@@ -67,11 +71,14 @@ void init_syslog()
 {
   openlog( DAEMON_NAME.data(), LOG_PID, LOG_DAEMON );
   syslog( LOG_INFO, "uccd starting - version %s", UCC_VERSION_FULL );
+  // start the writer of the queued worker and D-Bus log lines
+  ucc::AsyncLog::instance();
 }
 
 // Cleanup syslog
 void cleanup_syslog()
 {
+  ucc::AsyncLog::instance().flush();
   syslog( LOG_INFO, "uccd shutting down" );
   closelog();
 }
@@ -167,7 +174,7 @@ int check_single_instance()
 }
 
 // Main daemon loop
-int run_daemon()
+int run_daemon( const std::string &metricsTextfile, std::optional< std::chrono::milliseconds > persistDelay )
 {
   // Create Qt application for event loop (needed for Qt Bluetooth)
   int argc = 1;
@@ -232,6 +239,15 @@ int run_daemon()
 
     // Initialize DBus service
     UccDBusService dbusService;
+    if ( !metricsTextfile.empty() )
+    {
+      dbusService.setMetricsTextfilePath( metricsTextfile );
+      syslog( LOG_INFO, "Exporting OpenMetrics to %s", metricsTextfile.c_str() );
+    }
+    if ( persistDelay )
+      dbusService.setPersistQuietPeriod( *persistDelay );
+    // Claim the bus name before the hardware setup: activation completes at
+    // once and calls queue until the event loop runs
     if ( !dbusService.initDBus() )
     {
       syslog( LOG_ERR, "Failed to initialize D-Bus service" );
@@ -239,6 +255,8 @@ int run_daemon()
       return 1;
     }
 
+    dbusService.initialize();
+
     // Initialize startup profile (after workers are ready, before event loop)
     dbusService.initializeStartupProfile();
 
@@ -304,7 +322,13 @@ void print_usage( std::string_view program_name )
             << "  --help         Show this help message\n"
             << "  --debug        Run in debug mode (foreground with verbose logging)\n"
             << "  --start        Start the daemon\n"
-            << "  --stop         Stop the running daemon\n";
+            << "  --stop         Stop the running daemon\n"
+            << "  --metrics-textfile PATH\n"
+            << "                 Write OpenMetrics telemetry to PATH every 5 s\n"
+            << "                 (for the node_exporter textfile collector)\n"
+            << "  --persist-delay MS\n"
+            << "                 Write settings changes once they have rested for MS\n"
+            << "                 milliseconds (default 1500, 0 writes immediately)\n";
 }
 
 // Print version information
@@ -399,6 +423,9 @@ int main( int argc, char* argv[] )
   bool stop_daemon_flag = false;
   std::string new_settings_path;
   std::string new_profiles_path;
+  std::string metrics_textfile;
+  std::optional< std::chrono::milliseconds > persist_delay;
+  size_t option_args = 0;  // arguments that configure, but do not select, an action
 
   // parse command-line arguments
   for ( size_t i = 0; i < arguments.size(); ++i )
@@ -427,10 +454,28 @@ int main( int argc, char* argv[] )
     {
       stop_daemon_flag = true;
     }
+    else if ( arg == "--metrics-textfile" and i + 1 < arguments.size() )
+    {
+      metrics_textfile = arguments[ ++i ];
+      option_args += 2;
+    }
+    else if ( arg == "--persist-delay" and i + 1 < arguments.size() )
+    {
+      try
+      {
+        persist_delay = std::chrono::milliseconds( std::max( std::stol( arguments[ ++i ] ), 0L ) );
+      }
+      catch ( const std::exception & )
+      {
+        std::cerr << "Invalid --persist-delay value: " << arguments[ i ] << std::endl;
+        return 1;
+      }
+      option_args += 2;
+    }
   }
 
   // default action is to start
-  if ( not debug_mode and not start_daemon and arguments.empty() )
+  if ( not debug_mode and not start_daemon and arguments.size() == option_args )
   {
     start_daemon = true;
   }
@@ -444,7 +489,7 @@ int main( int argc, char* argv[] )
     {
       return 1;
     }
-    return run_daemon();
+    return run_daemon( metrics_textfile, persist_delay );
   }
   else if ( stop_daemon_flag )
   {
@@ -460,7 +505,7 @@ int main( int argc, char* argv[] )
     }
     // Modern systemd-friendly behavior: do not daemonize here — run in foreground
     // so systemd (Type=simple) can supervise the process directly.
-    return run_daemon();
+    return run_daemon( metrics_textfile, persist_delay );
   }
 
   return 0;
@@ -18,15 +18,21 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string_view>
+#include <cstdlib>
 #include <algorithm>
 #include <ranges>
 #include <cctype>
 #include <dirent.h>
+#include <fcntl.h>
+#include <pwd.h>
 #include <unistd.h>
 #include <utmpx.h>
 
 namespace fs = std::filesystem;
 
+static constexpr std::chrono::milliseconds WORK_PERIOD{ 3000 };
+
 // ============================================================================
 // DisplayBacklightController
 // ============================================================================
@@ -38,27 +44,23 @@ DisplayBacklightController::DisplayBacklightController( const std::string &baseP
 {
   // Extract driver name from path
   m_driverName = fs::path( basePath ).filename().string();
+  m_brightnessFd = ::open( ( m_basePath + "/brightness" ).c_str(), O_RDWR | O_CLOEXEC );
 }
 
-int DisplayBacklightController::getBrightness() const noexcept
+DisplayBacklightController::~DisplayBacklightController()
 {
-  SysfsNode< int > brightnessNode( m_basePath + "/brightness" );
-  auto value = brightnessNode.read();
+  if ( m_brightnessFd >= 0 )
+    ::close( m_brightnessFd );
+}
 
-  if ( not value.has_value() )
+int DisplayBacklightController::getBrightness() const noexcept
+{
+  const auto rawBrightness = readRaw();
+  if ( not rawBrightness.has_value() or m_maxBrightness <= 0 )
     return -1;
 
-  int rawBrightness = value.value();
-
-  // amdgpu_bl has inverted brightness: 0 = max, max = off
-  if ( m_isAmdgpuBl )
-    rawBrightness = m_maxBrightness - rawBrightness;
-
   // Convert to percentage
-  if ( m_maxBrightness <= 0 )
-    return -1;
-
-  return static_cast< int >( ( static_cast< double >( rawBrightness ) / m_maxBrightness ) * 100.0 );
+  return static_cast< int >( ( static_cast< double >( *rawBrightness ) / m_maxBrightness ) * 100.0 );
 }
 
 bool DisplayBacklightController::setBrightness( int brightness ) noexcept
@@ -66,16 +68,46 @@ bool DisplayBacklightController::setBrightness( int brightness ) noexcept
   if ( m_maxBrightness <= 0 )
     return false;
 
+  return writeRaw( toRaw( brightness ) );
+}
+
+int DisplayBacklightController::toRaw( int brightness ) const noexcept
+{
   // Convert percentage to raw value
-  int rawBrightness = static_cast< int >( ( static_cast< double >( brightness ) / 100.0 ) * m_maxBrightness );
-  rawBrightness = std::clamp( rawBrightness, 0, m_maxBrightness );
+  const int rawBrightness = static_cast< int >( ( static_cast< double >( brightness ) / 100.0 ) * m_maxBrightness );
+  return std::clamp( rawBrightness, 0, std::max( m_maxBrightness, 0 ) );
+}
+
+std::optional< int > DisplayBacklightController::readRaw() const noexcept
+{
+  char buffer[ 16 ];
+  const ssize_t n = m_brightnessFd >= 0 ? ::pread( m_brightnessFd, buffer, sizeof( buffer ) - 1, 0 ) : -1;
+  if ( n <= 0 )
+    return std::nullopt;
+  buffer[ n ] = '\0';
+  char *end = nullptr;
+  int rawBrightness = static_cast< int >( std::strtol( buffer, &end, 10 ) );
+  if ( end == buffer )
+    return std::nullopt;
+
+  // amdgpu_bl has inverted brightness: 0 = max, max = off
+  if ( m_isAmdgpuBl )
+    rawBrightness = m_maxBrightness - rawBrightness;
+
+  return rawBrightness;
+}
+
+bool DisplayBacklightController::writeRaw( int raw ) noexcept
+{
+  int rawBrightness = std::clamp( raw, 0, std::max( m_maxBrightness, 0 ) );
 
   // amdgpu_bl: 0 = max, max = off (inverted)
   if ( m_isAmdgpuBl )
     rawBrightness = m_maxBrightness - rawBrightness;
 
-  SysfsNode< int > brightnessNode( m_basePath + "/brightness" );
-  return brightnessNode.write( rawBrightness );
+  const std::string value = std::to_string( rawBrightness );
+  return m_brightnessFd >= 0
+         and ::pwrite( m_brightnessFd, value.data(), value.size(), 0 ) == static_cast< ssize_t >( value.size() );
 }
 
 // ============================================================================
@@ -90,7 +122,7 @@ DisplayWorker::DisplayWorker(
   std::function< bool() > getIsX11Callback,
   std::function< void( const std::string & ) > setDisplayModesCallback,
   std::function< void( bool ) > setIsX11Callback )
-  : DaemonWorker( std::chrono::milliseconds( 3000 ), false )
+  : DaemonWorker( WORK_PERIOD, false )
   , m_getActiveProfile( getActiveProfile )
   , m_autosavePath( autosavePath )
   , m_getAutosaveBrightness( getAutosaveBrightness )
@@ -112,10 +144,14 @@ DisplayWorker::DisplayWorker(
 
 bool DisplayWorker::setBrightness( int32_t brightness ) noexcept
 {
-  if ( not m_backlightController )
-    return false;
+  return fadeBrightness( brightness, m_rampDuration );
+}
 
-  return m_backlightController->setBrightness( brightness );
+void DisplayWorker::reapplyProfile() noexcept
+{
+  // keep GetDisplayBrightness in step with what the profile set
+  if ( applyBacklightFromProfile( m_rampDuration ) )
+    m_setAutosaveBrightness( m_getActiveProfile().display.brightness );
 }
 
 std::optional< DisplayMode > DisplayWorker::getActiveDisplayMode() noexcept
@@ -137,37 +173,62 @@ bool DisplayWorker::setRefreshRate( int refreshRate ) noexcept
   if ( m_displayInfo.displayName.empty() or m_displayInfo.activeMode.xResolution == 0 )
     return false;
 
-  setDisplayMode( m_displayInfo.activeMode.xResolution,
-                  m_displayInfo.activeMode.yResolution,
-                  refreshRate );
-  return true;
+  return setDisplayMode( m_displayInfo.activeMode.xResolution,
+                         m_displayInfo.activeMode.yResolution,
+                         refreshRate );
+}
+
+void DisplayWorker::setPowerHints( bool onBattery, bool idle ) noexcept
+{
+  const bool batteryChanged = m_onBattery.exchange( onBattery ) != onBattery;
+  const bool idleChanged = m_idle.exchange( idle ) != idle;
+  if ( m_refreshSaver and ( batteryChanged or idleChanged ) )
+  {
+    m_powerHintsChanged = true;
+    wake();
+  }
 }
 
 // ------------ DaemonWorker lifecycle ------------
 
 void DisplayWorker::onStart()
 {
-  // Initialize backlight hardware
+  // Initialize backlight hardware; drivers that bind later arrive as udev events
+  if ( not m_backlightEvents.start( { "backlight" } ) )
+    syslog( LOG_WARNING, "DisplayWorker: no udev monitor, polling for a backlight driver" );
   initBacklight();
-  applyBacklightFromProfile();
+  applyBacklightFromProfile( std::chrono::milliseconds( 0 ) );
 
   // Refresh rate environment variables will be discovered on first onWork() call
+
+  // Hotplug and mode list changes of the panel invalidate the cached modes
+  if ( not m_drmEvents.start( { "drm" } ) )
+    syslog( LOG_WARNING, "DisplayWorker: no udev monitor, display modes are read once per login" );
 }
 
 void DisplayWorker::onWork()
 {
+  // cycles run one ramp step apart while a fade is in progress
+  if ( stepBrightnessRamp() )
+    return;
+
   reenumerateBacklightDrivers();
 
-  // --- Refresh rate work (every 2nd cycle ≈ 6000ms, close to original 5000ms) ---
+  if ( m_drmEvents.drain() > 0 )
+    m_displayInfoFound = false;
+
+  // --- Refresh rate work (every 2nd cycle ≈ 6000ms, close to original 5000ms,
+  //     and at once when the refresh saver's power hints change) ---
   m_refreshRateCycleCounter++;
-  if ( m_refreshRateCycleCounter % 2 == 0 )
+  const bool powerHintsChanged = m_powerHintsChanged.exchange( false );
+  if ( m_refreshRateCycleCounter % 2 == 0 or powerHintsChanged )
   {
     const auto [usersAvailable, usersChanged] = checkUsers();
 
     if ( usersChanged )
       resetRefreshRateState();
 
-    if ( usersAvailable and not m_isWayland )
+    if ( usersAvailable )
     {
       if ( not m_displayInfoFound )
         updateDisplayData();
@@ -179,6 +240,8 @@ void DisplayWorker::onWork()
 
 void DisplayWorker::onExit()
 {
+  m_drmEvents.stop();
+  m_backlightEvents.stop();
 }
 
 // ============================================================================
@@ -187,71 +250,127 @@ void DisplayWorker::onExit()
 
 void DisplayWorker::initBacklight()
 {
+  std::unique_ptr< DisplayBacklightController > controller;
+
   try
   {
     const std::string backlightBase = "/sys/class/backlight";
     std::error_code ec;
 
-    if ( not fs::exists( backlightBase, ec ) )
-      return;
-
-    for ( const auto &entry : fs::directory_iterator( backlightBase, ec ) )
+    if ( fs::exists( backlightBase, ec ) )
     {
-      if ( not entry.is_directory( ec ) )
-        continue;
+      for ( const auto &entry : fs::directory_iterator( backlightBase, ec ) )
+      {
+        if ( not entry.is_directory( ec ) )
+          continue;
 
-      std::string driverPath = entry.path().string();
-      std::string maxBrightnessPath = driverPath + "/max_brightness";
+        std::string driverPath = entry.path().string();
+        std::string maxBrightnessPath = driverPath + "/max_brightness";
 
-      if ( not fs::exists( maxBrightnessPath, ec ) )
-        continue;
+        if ( not fs::exists( maxBrightnessPath, ec ) )
+          continue;
 
-      SysfsNode< int > maxBrightness( maxBrightnessPath );
-      auto maxVal = maxBrightness.read();
-      if ( not maxVal.has_value() or maxVal.value() <= 0 )
-        continue;
+        SysfsNode< int > maxBrightness( maxBrightnessPath );
+        auto maxVal = maxBrightness.read();
+        if ( not maxVal.has_value() or maxVal.value() <= 0 )
+          continue;
 
-      std::string driverName = entry.path().filename().string();
-      bool isAmdgpuBl = ( driverName == "amdgpu_bl0" or driverName == "amdgpu_bl1" );
+        std::string driverName = entry.path().filename().string();
+        bool isAmdgpuBl = ( driverName == "amdgpu_bl0" or driverName == "amdgpu_bl1" );
 
-      m_backlightController = std::make_unique< DisplayBacklightController >(
-        driverPath, maxVal.value(), isAmdgpuBl );
+        controller = std::make_unique< DisplayBacklightController >(
+          driverPath, maxVal.value(), isAmdgpuBl );
 
-      syslog( LOG_INFO, "DisplayWorker: Backlight driver '%s' (max=%d, amdgpu_bl=%d)",
-              driverName.c_str(), maxVal.value(), isAmdgpuBl ? 1 : 0 );
-      break; // Use first available driver
+        syslog( LOG_INFO, "DisplayWorker: Backlight driver '%s' (max=%d, amdgpu_bl=%d)",
+                driverName.c_str(), maxVal.value(), isAmdgpuBl ? 1 : 0 );
+        break; // Use first available driver
+      }
     }
   }
   catch ( const std::exception &e )
   {
     syslog( LOG_WARNING, "DisplayWorker: Failed to init backlight: %s", e.what() );
   }
+
+  std::lock_guard< std::mutex > lock( m_backlightMutex );
+  m_ramp.cancel();
+  m_backlightController = std::move( controller );
 }
 
-void DisplayWorker::applyBacklightFromProfile()
+bool DisplayWorker::applyBacklightFromProfile( std::chrono::milliseconds duration )
 {
-  if ( not m_backlightController )
-    return;
-
   const UccProfile activeProfile = m_getActiveProfile();
 
   // Only apply brightness if the profile explicitly enables it
-  if ( activeProfile.display.useBrightness and activeProfile.display.brightness >= 0 )
+  if ( not activeProfile.display.useBrightness or activeProfile.display.brightness < 0 )
+    return false;
+
+  if ( not fadeBrightness( activeProfile.display.brightness, duration ) )
+    return false;
+
+  syslog( LOG_INFO, "DisplayWorker: Applied profile brightness %d%%",
+          activeProfile.display.brightness );
+  return true;
+}
+
+bool DisplayWorker::fadeBrightness( int brightness, std::chrono::milliseconds duration ) noexcept
+{
   {
-    m_backlightController->setBrightness( activeProfile.display.brightness );
-    syslog( LOG_INFO, "DisplayWorker: Applied profile brightness %d%%",
-            activeProfile.display.brightness );
+    std::lock_guard< std::mutex > lock( m_backlightMutex );
+    if ( not m_backlightController )
+      return false;
+
+    const int target = m_backlightController->toRaw( brightness );
+    if ( duration.count() <= 0 )
+    {
+      m_ramp.cancel();
+      return m_backlightController->writeRaw( target );
+    }
+
+    // a running fade continues from where it is, else from the panel's value
+    const int from = m_ramp.active() ? m_ramp.current() : m_backlightController->readRaw().value_or( target );
+    m_ramp.start( from, target, duration, BrightnessRamp::Clock::now() );
   }
+
+  setTimeout( BrightnessRamp::STEP );
+  wake();
+  return true;
+}
+
+bool DisplayWorker::stepBrightnessRamp() noexcept
+{
+  std::lock_guard< std::mutex > lock( m_backlightMutex );
+  if ( not m_ramp.active() )
+    return false;
+
+  if ( const auto raw = m_ramp.step( BrightnessRamp::Clock::now() ); raw and m_backlightController )
+    m_backlightController->writeRaw( *raw );
+
+  if ( not m_ramp.active() )
+    setTimeout( WORK_PERIOD );
+  return true;
 }
 
 void DisplayWorker::reenumerateBacklightDrivers()
 {
-  // Re-check if backlight controller is still valid
-  // If it was lost (e.g., driver reload), try to reinitialize
-  if ( not m_backlightController )
+  // Backlight devices only come and go with driver (re)loads, e.g. the GPU
+  // driver taking over from acpi_video; brightness changes are "change"
+  // events and leave the driver set alone
+  bool driversChanged = false;
+  m_backlightEvents.drain( [ &driversChanged ]( const UdevEvent &event ) {
+    const std::string_view kind( event.action() );
+    driversChanged = driversChanged or kind == "add" or kind == "remove";
+  } );
+
+  // Without udev, look again for as long as no driver is bound
+  bool missing;
   {
-    initBacklight();
+    std::lock_guard< std::mutex > lock( m_backlightMutex );
+    missing = m_backlightController == nullptr;
   }
+
+  if ( driversChanged or ( missing and not m_backlightEvents.active() ) )
+    initBacklight();
 }
 
 // ============================================================================
@@ -300,6 +419,11 @@ void DisplayWorker::resetRefreshRateState() noexcept
   m_displayEnvVariable = "";
   m_xAuthorityFile = "";
   m_displayName = "";
+  m_waylandDisplay = "";
+  m_runtimeDir = "";
+  m_currentDesktop = "";
+  m_sessionBusAddress = "";
+  m_sessionUid = 0;
 }
 
 /**
@@ -322,6 +446,31 @@ static bool isValidXAuthority( const std::string &v ) noexcept
   return std::regex_match( v, pattern );
 }
 
+/**
+ * @brief Validate WAYLAND_DISPLAY: a socket name, or an absolute path to one
+ */
+static bool isValidWaylandDisplay( const std::string &v ) noexcept
+{
+  static const std::regex pattern( R"(^/?[a-zA-Z0-9/_.-]{1,107}$)" );
+  return std::regex_match( v, pattern );
+}
+
+/**
+ * @brief Validate XDG_RUNTIME_DIR and DBUS_SESSION_BUS_ADDRESS against the
+ *        per-user locations systemd-logind and the user bus set up
+ */
+static bool isValidRuntimeDir( const std::string &v ) noexcept
+{
+  static const std::regex pattern( R"(^/run/user/[0-9]{1,10}$)" );
+  return std::regex_match( v, pattern );
+}
+
+static bool isValidSessionBus( const std::string &v ) noexcept
+{
+  static const std::regex pattern( R"(^unix:path=/run/user/[0-9]{1,10}/bus$)" );
+  return std::regex_match( v, pattern );
+}
+
 /**
  * @brief Read environment variables from /proc/<pid>/environ directly.
  *
@@ -333,12 +482,15 @@ void DisplayWorker::setEnvVariables() noexcept
   try
   {
     std::string display, xauthority, sessionType;
+    std::string waylandDisplay, runtimeDir, currentDesktop, sessionBus;
+    uid_t sessionUid = 0;
     const uid_t rootUid = 0;
 
     // Iterate /proc to find non-root user processes
     for ( const auto &entry : fs::directory_iterator( "/proc" ) )
     {
-      if ( not display.empty() and not xauthority.empty() and not sessionType.empty() )
+      if ( not display.empty() and not xauthority.empty() and not sessionType.empty()
+           and ( sessionType != "wayland" or not waylandDisplay.empty() ) )
         break;
 
       const std::string pidName = entry.path().filename().string();
@@ -356,9 +508,9 @@ void DisplayWorker::setEnvVariables() noexcept
       // Read /proc/<pid>/loginuid to determine the owning user
       std::string loginuidPath = entry.path().string() + "/loginuid";
       std::ifstream loginuidFile( loginuidPath );
+      uid_t loginuid = 0;
       if ( loginuidFile )
       {
-        uid_t loginuid = 0;
         loginuidFile >> loginuid;
         if ( loginuid == rootUid or loginuid == static_cast< uid_t >( -1 ) )
           continue;
@@ -380,6 +532,7 @@ void DisplayWorker::setEnvVariables() noexcept
       // Parse NUL-separated entries
       std::istringstream envStream( envContent );
       std::string envEntry;
+      std::string processWayland, processRuntimeDir, processDesktop, processBus;
       while ( std::getline( envStream, envEntry, '\0' ) )
       {
         if ( display.empty() and envEntry.starts_with( "DISPLAY=" ) )
@@ -388,6 +541,25 @@ void DisplayWorker::setEnvVariables() noexcept
           xauthority = envEntry.substr( 11 );
         else if ( sessionType.empty() and envEntry.starts_with( "XDG_SESSION_TYPE=" ) )
           sessionType = envEntry.substr( 17 );
+        else if ( envEntry.starts_with( "WAYLAND_DISPLAY=" ) )
+          processWayland = envEntry.substr( 16 );
+        else if ( envEntry.starts_with( "XDG_RUNTIME_DIR=" ) )
+          processRuntimeDir = envEntry.substr( 16 );
+        else if ( envEntry.starts_with( "XDG_CURRENT_DESKTOP=" ) )
+          processDesktop = envEntry.substr( 20 );
+        else if ( envEntry.starts_with( "DBUS_SESSION_BUS_ADDRESS=" ) )
+          processBus = envEntry.substr( 25 );
+      }
+
+      // The Wayland socket only means something with the runtime directory
+      // and user of the same process
+      if ( waylandDisplay.empty() and not processWayland.empty() and not processRuntimeDir.empty() )
+      {
+        waylandDisplay = processWayland;
+        runtimeDir = processRuntimeDir;
+        currentDesktop = processDesktop;
+        sessionBus = processBus;
+        sessionUid = loginuid;
       }
     }
 
@@ -416,11 +588,25 @@ void DisplayWorker::setEnvVariables() noexcept
       syslog( LOG_WARNING, "DisplayWorker: Rejected suspicious XAUTHORITY value" );
       xauthority.clear();
     }
+    if ( not waylandDisplay.empty()
+         and ( not isValidWaylandDisplay( waylandDisplay ) or not isValidRuntimeDir( runtimeDir ) ) )
+    {
+      syslog( LOG_WARNING, "DisplayWorker: Rejected suspicious WAYLAND_DISPLAY or XDG_RUNTIME_DIR value" );
+      waylandDisplay.clear();
+      runtimeDir.clear();
+    }
+    if ( not isValidSessionBus( sessionBus ) )
+      sessionBus.clear();
 
     m_displayEnvVariable = display;
     m_xAuthorityFile = xauthority;
     m_isX11 = ( sessionType == "x11" );
     m_isWayland = ( sessionType == "wayland" );
+    m_waylandDisplay = waylandDisplay;
+    m_runtimeDir = runtimeDir;
+    m_currentDesktop = currentDesktop;
+    m_sessionBusAddress = sessionBus;
+    m_sessionUid = waylandDisplay.empty() ? 0 : sessionUid;
   }
   catch ( ... )
   {
@@ -431,9 +617,7 @@ void DisplayWorker::setEnvVariables() noexcept
 
 std::optional< DisplayInfo > DisplayWorker::getDisplayModes() noexcept
 {
-  if ( m_displayEnvVariable.empty() or m_xAuthorityFile.empty() )
-    setEnvVariables();
-
+  // setEnvVariables() ran in updateDisplayData() while the session was unknown
   if ( m_displayEnvVariable.empty() or m_xAuthorityFile.empty() or m_isWayland )
     return std::nullopt;
 
@@ -550,7 +734,14 @@ std::optional< DisplayInfo > DisplayWorker::parseXrandrOutput( const std::string
 
 void DisplayWorker::updateDisplayData() noexcept
 {
-  auto modes = getDisplayModes();
+  // The /proc scan is only needed until the X display, or a Wayland
+  // session that has none, is known
+  if ( m_displayEnvVariable.empty() and not m_isWayland )
+    setEnvVariables();
+
+  auto modes = DrmDisplayModes::readInternalPanel();
+  if ( not modes and not m_isWayland )
+    modes = getDisplayModes();
 
   m_setIsX11( m_isX11 );
 
@@ -610,35 +801,58 @@ std::string DisplayWorker::serializeDisplayInfo( const DisplayInfo &info ) const
 
 void DisplayWorker::setActiveDisplayMode() noexcept
 {
-  const UccProfile activeProfile = m_getActiveProfile();
-
-  if ( not activeProfile.display.useRefRate )
-    return;
-
   if ( m_displayInfo.activeMode.refreshRates.empty() )
     return;
 
-  const double currentRefreshRate = m_displayInfo.activeMode.refreshRates[0];
-  const int32_t desiredRefreshRate = activeProfile.display.refreshRate;
+  const UccProfile activeProfile = m_getActiveProfile();
+  const int32_t profileRate = activeProfile.display.useRefRate ? activeProfile.display.refreshRate : 0;
 
-  if ( desiredRefreshRate <= 0 )
-    return;
+  std::optional< double > desiredRefreshRate;
+  if ( m_refreshSaver )
+    desiredRefreshRate = PanelRefreshPolicy::target( m_displayInfo, m_onBattery or m_idle, profileRate );
+  else if ( profileRate > 0 )
+    desiredRefreshRate = static_cast< double >( profileRate );
 
-  if ( std::abs( currentRefreshRate - static_cast< double >( desiredRefreshRate ) ) < 0.1 )
+  if ( not desiredRefreshRate or PanelRefreshPolicy::isActive( m_displayInfo, *desiredRefreshRate ) )
     return; // Already at desired refresh rate
 
-  setDisplayMode( m_displayInfo.activeMode.xResolution,
-                  m_displayInfo.activeMode.yResolution,
-                  desiredRefreshRate );
+  if ( not setDisplayMode( m_displayInfo.activeMode.xResolution,
+                           m_displayInfo.activeMode.yResolution,
+                           *desiredRefreshRate ) )
+    return;
 
   // Update cached value
-  m_displayInfo.activeMode.refreshRates[0] = static_cast< double >( desiredRefreshRate );
+  m_displayInfo.activeMode.refreshRates[0] = *desiredRefreshRate;
 }
 
-void DisplayWorker::setDisplayMode( int xRes, int yRes, int refRate ) noexcept
+/// A rate as the mode tools take it, e.g. "165.01"
+static std::string formatRate( double refRate )
 {
+  char buffer[ 16 ];
+  std::snprintf( buffer, sizeof( buffer ), "%.2f", refRate );
+  return buffer;
+}
+
+bool DisplayWorker::setDisplayMode( int xRes, int yRes, double refRate ) noexcept
+{
+  // With no compositor or X server holding the card (a text console) the
+  // mode is set directly; otherwise DRM master is taken and this fails
+  if ( DrmDisplayModes::setInternalPanelMode( xRes, yRes, refRate ) )
+  {
+    syslog( LOG_INFO, "DisplayWorker: Set display mode to %dx%d @ %.2fHz (DRM)", xRes, yRes, refRate );
+    return true;
+  }
+
+  if ( m_isWayland )
+    return setWaylandDisplayMode( xRes, yRes, refRate );
+
+  // xrandr's output names follow the X driver, not DRM (eDP1 vs eDP-1);
+  // modes read from DRM leave it to be learned on the first change
+  if ( m_isX11 and m_displayName.empty() )
+    (void) getDisplayModes();
+
   if ( not m_isX11 or m_displayEnvVariable.empty() or m_xAuthorityFile.empty() or m_displayName.empty() )
-    return;
+    return false;
 
   try
   {
@@ -650,13 +864,67 @@ void DisplayWorker::setDisplayMode( int xRes, int yRes, int refRate ) noexcept
         { "-display", m_displayEnvVariable,
           "--output", m_displayName,
           "--mode", modeStr,
-          "-r", std::to_string( refRate ) },
+          "-r", formatRate( refRate ) },
         { "XAUTHORITY=" + m_xAuthorityFile } );
 
-    syslog( LOG_INFO, "DisplayWorker: Set display mode to %dx%d @ %dHz", xRes, yRes, refRate );
+    syslog( LOG_INFO, "DisplayWorker: Set display mode to %dx%d @ %.2fHz", xRes, yRes, refRate );
+    return true;
   }
   catch ( ... )
   {
     syslog( LOG_WARNING, "DisplayWorker: Failed to set display mode" );
+    return false;
+  }
+}
+
+bool DisplayWorker::setWaylandDisplayMode( int xRes, int yRes, double refRate ) noexcept
+{
+  // The compositor owns the mode: ask it through its output management
+  // protocol, as the session user, whose runtime directory holds the socket.
+  // Wayland output names are the DRM connector names read above.
+  if ( m_waylandDisplay.empty() or m_sessionUid == 0 or m_displayInfo.displayName.empty() )
+    return false;
+
+  try
+  {
+    passwd pw{};
+    passwd *result = nullptr;
+    std::vector< char > buffer( 4096 );
+    if ( getpwuid_r( m_sessionUid, &pw, buffer.data(), buffer.size(), &result ) != 0 or result == nullptr )
+      return false;
+
+    std::vector< std::string > env = { "WAYLAND_DISPLAY=" + m_waylandDisplay,
+                                       "XDG_RUNTIME_DIR=" + m_runtimeDir,
+                                       "HOME=" + std::string( pw.pw_dir ) };
+    if ( not m_sessionBusAddress.empty() )
+      env.push_back( "DBUS_SESSION_BUS_ADDRESS=" + m_sessionBusAddress );
+
+    std::vector< std::string > args = { "--reuid=" + std::to_string( pw.pw_uid ),
+                                        "--regid=" + std::to_string( pw.pw_gid ),
+                                        "--init-groups", "--" };
+    const std::string modeStr = std::to_string( xRes ) + "x" + std::to_string( yRes );
+    if ( m_currentDesktop.find( "KDE" ) != std::string::npos )
+    {
+      // KWin: kde_output_management through kscreen, rates as whole Hz
+      args.push_back( "kscreen-doctor" );
+      args.push_back( "output." + m_displayInfo.displayName + ".mode." + modeStr + "@"
+                      + std::to_string( std::lround( refRate ) ) );
+    }
+    else
+    {
+      // wlroots compositors (sway, Hyprland, labwc, ...): wlr-output-management
+      args.insert( args.end(), { "wlr-randr", "--output", m_displayInfo.displayName,
+                                 "--mode", modeStr + "@" + formatRate( refRate ) + "Hz" } );
+    }
+    (void) ucc::executeProcess( "setpriv", args, env );
+
+    syslog( LOG_INFO, "DisplayWorker: Set display mode to %dx%d @ %.2fHz (%s)", xRes, yRes, refRate,
+            args[ 4 ].c_str() );
+    return true;
+  }
+  catch ( ... )
+  {
+    syslog( LOG_WARNING, "DisplayWorker: Failed to set display mode" );
+    return false;
   }
 }
@@ -14,14 +14,11 @@
  */
 
 #include "workers/HardwareMonitorWorker.hpp"
-#include "SysfsNode.hpp"
 #include "Utils.hpp"
+#include "JsonWriter.hpp"
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <regex>
 #include <filesystem>
-#include <thread>
 #include <chrono>
 #include <syslog.h>
 
@@ -32,6 +29,7 @@
 void DGpuInfo::print() const noexcept
 {
   std::cout << "DGPU Info: \n"
+     << "  Device: " << m_deviceIndex << ( m_name.empty() ? "" : " (" + m_name + ")" ) << "\n"
      << "  Temperature: " << m_temp << " °C\n"
      << "  Core Frequency: " << m_coreFrequency << " MHz\n"
      << "  Max Core Frequency: " << m_maxCoreFrequency << " MHz\n"
@@ -103,6 +101,11 @@ public:
     return readIntegerProperty( "energy_uj", -1 );
   }
 
+  [[nodiscard]] int64_t getMaxEnergyRange() const noexcept
+  {
+    return readIntegerProperty( "max_energy_range_uj", 0 );
+  }
+
   void setPowerPL1Limit( std::optional< int64_t > setPowerLimit = std::nullopt ) noexcept
   {
     if ( not getIntelRAPLConstraint0Available() )
@@ -240,8 +243,7 @@ class PowerController
 public:
   explicit PowerController( IntelRAPLController &intelRAPL ) noexcept
     : m_intelRAPL( intelRAPL )
-    , m_currentEnergy( 0 )
-    , m_lastUpdateTime( std::chrono::system_clock::now() )
+    , m_energy( static_cast< uint64_t >( std::max< int64_t >( intelRAPL.getMaxEnergyRange(), 0 ) ) )
     , m_raplPowerStatus( intelRAPL.getIntelRAPLEnergyAvailable() )
   {
   }
@@ -251,28 +253,16 @@ public:
     if ( not m_raplPowerStatus )
       return -1.0;
 
-    auto now = std::chrono::system_clock::now();
-    int64_t currentEnergy = m_intelRAPL.getEnergy();
-    int64_t energyIncrement = currentEnergy - m_currentEnergy;
-
-    auto timeDiff = std::chrono::duration_cast< std::chrono::milliseconds >(
-        now - m_lastUpdateTime ).count();
-    double delaySec = timeDiff > 0 ? static_cast< double >( timeDiff ) / 1000.0 : -1.0;
-
-    double powerDraw = -1.0;
-    if ( delaySec > 0 and m_currentEnergy > 0 )
-      powerDraw = static_cast< double >( energyIncrement ) / delaySec / 1000000.0;
-
-    m_currentEnergy += energyIncrement;
-    m_lastUpdateTime = now;
+    const int64_t currentEnergy = m_intelRAPL.getEnergy();
+    if ( currentEnergy < 0 )
+      return -1.0;
 
-    return powerDraw;
+    return m_energy.update( static_cast< uint64_t >( currentEnergy ) ).value_or( -1.0 );
   }
 
 private:
   IntelRAPLController &m_intelRAPL;
-  int64_t m_currentEnergy;
-  std::chrono::system_clock::time_point m_lastUpdateTime;
+  EnergyCounter m_energy;
   bool m_raplPowerStatus;
 };
 
@@ -288,27 +278,33 @@ private:
 
 HardwareMonitorWorker::HardwareMonitorWorker(
   std::shared_ptr< NvmlWrapper > nvml,
+  std::shared_ptr< SensorPoller > sensorPoller,
+  std::shared_ptr< SamplingGovernor > governor,
   CpuPowerCallback cpuPowerUpdateCallback,
-  std::function< bool() > getSensorDataCollectionStatus,
+  std::function< uint32_t() > getSensorGroups,
   std::function< void( const std::string & ) > setPrimeStateCallback,
   bool isDisplayMuxDevice )
-  : DaemonWorker( std::chrono::milliseconds( 800 ), false )
+  : DaemonWorker( NORMAL_INTERVAL, false )
   , m_gpuDetector()
   , m_deviceCounts( m_gpuDetector.detectGpuDevices() )
   , m_nvml( std::move( nvml ) )
   , m_gpuDataCallback( nullptr )
-  , m_hwmonIGpuRetryCount( 3 )
-  , m_hwmonDGpuRetryCount( 3 )
+  , m_topologyScanner( m_gpuDetector.topologyPatterns() )
+  , m_sensorPoller( sensorPoller ? std::move( sensorPoller ) : std::make_shared< SensorPoller >() )
+  , m_amdIGpuMaxClockMHz( -1.0 )
   , m_RAPLConstraint0Status( false )
   , m_RAPLConstraint1Status( false )
   , m_RAPLConstraint2Status( false )
   , m_cpuPowerUpdateCallback( std::move( cpuPowerUpdateCallback ) )
-  , m_getSensorDataCollectionStatus( std::move( getSensorDataCollectionStatus ) )
+  , m_getSensorGroups( std::move( getSensorGroups ) )
   , m_setPrimeState( std::move( setPrimeStateCallback ) )
   , m_primeSupported( false )
   , m_isDisplayMuxDevice( isDisplayMuxDevice )
   , m_displayConnectedToNvidia( false )
-  , m_cycleCounter( 0 )
+  , m_governor( std::move( governor ) )
+  , m_lastCpuPowerMs( 0 )
+  , m_lastWebcamMs( 0 )
+  , m_lastPrimeMs( 0 )
 {
 }
 
@@ -330,6 +326,16 @@ void HardwareMonitorWorker::setCpuFrequencyCallback( CpuFrequencyCallback callba
   m_cpuFrequencyCallback = std::move( callback );
 }
 
+void HardwareMonitorWorker::setCpuThrottleCallback( CpuThrottleCallback callback ) noexcept
+{
+  m_cpuThrottleCallback = std::move( callback );
+}
+
+void HardwareMonitorWorker::setBatteryCallback( BatteryCallback callback ) noexcept
+{
+  m_batteryCallback = std::move( callback );
+}
+
 bool HardwareMonitorWorker::isPrimeSupported() const noexcept
 {
   return m_primeSupported;
@@ -339,51 +345,82 @@ bool HardwareMonitorWorker::isPrimeSupported() const noexcept
 
 void HardwareMonitorWorker::onStart()
 {
+  m_cpuCores = std::make_unique< CpuCoreSampler >( m_sensorPoller );
+  m_cpuCores->discover();
+  syslog( LOG_INFO, "HardwareMonitorWorker: sampling %zu CPUs, frequency from %s",
+          m_cpuCores->coreCount(), m_cpuCores->usesMsr() ? "APERF/MPERF" : "scaling_cur_freq" );
+  m_battery = std::make_unique< BatterySampler >( m_sensorPoller );
+  if ( m_battery->discover() )
+    syslog( LOG_INFO, "HardwareMonitorWorker: sampling battery %s", m_battery->name().c_str() );
   initGpu();
   initCpuPower();
   initPrime();
 
   // initial webcam read so DBus data is populated before first poll cycle
   updateWebcamStatus();
+
+  // stagger the slower readings instead of running them all in the first cycle;
+  // the first PRIME read comes PRIME_SETTLE_MS after start
+  const int64_t now = SamplingGovernor::nowMs();
+  m_lastWebcamMs = now;
+  m_lastPrimeMs = now - PRIME_PERIOD_MS + PRIME_SETTLE_MS;
 }
 
 void HardwareMonitorWorker::onWork()
 {
-  m_cycleCounter++;
+  const int64_t now = SamplingGovernor::nowMs();
+  const auto due = [now]( int64_t &last, int64_t period ) {
+    if ( last != 0 and now - last < period )
+      return false;
+    last = now;
+    return true;
+  };
 
-  // --- GPU info: every cycle (800ms) ---
-  // retry AMD iGPU path discovery if not found yet
-  if ( m_deviceCounts.amdIGpuCount == 1 and not m_amdIGpuHwmonPath.has_value() and m_hwmonIGpuRetryCount > 0 )
-    ( void ) checkAmdIGpuHwmonPath();
-  if ( m_deviceCounts.amdDGpuCount == 1 and not m_amdDGpuHwmonPath.has_value() and m_hwmonDGpuRetryCount > 0 )
-    ( void ) checkAmdDGpuHwmonPath();
+  // groups nobody subscribed to are skipped, so an idle dGPU can stay in D3cold
+  m_sensorGroups = m_getSensorGroups ? m_getSensorGroups() : ucc::SensorGroup::All;
+
+  // --- GPU info: every cycle (800 ms, 250 ms–4 s with the governor) ---
+  // hotplug (PRIME switch, eGPU, hwmon appearing after resume) arrives as udev events
+  refreshGpuTopology();
+
+  // one batched read of every registered node; the getters below use the snapshot
+  m_sensorPoller->refresh();
 
   try
   {
     if ( m_gpuDataCallback )
-      m_gpuDataCallback( getIGpuValues(), getDGpuValues() );
+    {
+      const auto &dGpuValues = getDGpuValues();
+      m_gpuDataCallback( getIGpuValues(), dGpuValues, drainGpuSamples() );
+    }
   }
   catch ( ... ) { /* ignore callback exceptions */ }
 
-  // --- CPU frequency: every cycle (≈ 800ms) ---
-  updateCpuFrequency();
+  // --- CPU frequency: every cycle ---
+  if ( m_sensorGroups & ucc::SensorGroup::CpuFrequency )
+    updateCpuFrequency();
+
+  // --- Battery: every cycle ---
+  updateBattery();
 
-  // --- CPU power: every 3rd cycle (≈ 2400ms, close to original 2000ms) ---
-  if ( m_cycleCounter % 3 == 0 )
+  // --- CPU power: ≈ 2400 ms (close to original 2000 ms), at most once per cycle ---
+  if ( due( m_lastCpuPowerMs, CPU_POWER_PERIOD_MS ) )
     updateCpuPower();
 
-  // --- Webcam: every 3rd cycle, offset by 1 (≈ 2400ms) ---
-  if ( m_cycleCounter % 3 == 1 )
+  // --- Webcam: ≈ 2400 ms ---
+  if ( due( m_lastWebcamMs, WEBCAM_PERIOD_MS ) )
     updateWebcamStatus();
 
-  // --- Prime state: every 12th cycle (≈ 9600ms, close to original 10000ms) ---
-  if ( m_cycleCounter % 12 == 0 )
+  // --- Prime state: ≈ 9600 ms (close to original 10000 ms) ---
+  if ( due( m_lastPrimeMs, PRIME_PERIOD_MS ) )
     updatePrimeStatus();
+
+  if ( m_governor )
+    setTimeout( m_governor->interval( NORMAL_INTERVAL ) );
 }
 
 void HardwareMonitorWorker::onExit()
 {
-  m_cpuPowerController.reset();
   m_intelRAPLCpu.reset();
   m_intelGpuPowerController.reset();
   m_intelRAPLGpu.reset();
@@ -395,147 +432,137 @@ void HardwareMonitorWorker::onExit()
 
 void HardwareMonitorWorker::initGpu()
 {
-  // Check Intel iGPU availability
-  if ( m_deviceCounts.intelIGpuCount == 1 and not m_intelIGpuDrmPath.has_value() )
-  {
-    if ( std::string intelPath = getIntelIGpuDrmPathImpl(); not intelPath.empty() )
-    {
-      m_intelIGpuDrmPath = intelPath;
-      m_intelRAPLGpu = std::make_unique< IntelRAPLController >(
-        "/sys/devices/virtual/powercap/intel-rapl/intel-rapl:0/intel-rapl:0:1/" );
-      m_intelGpuPowerController = std::make_unique< PowerController >( *m_intelRAPLGpu );
-    }
-  }
-
-  // Check AMD iGPU availability
-  if ( m_deviceCounts.amdIGpuCount == 1 and m_hwmonIGpuRetryCount > 0 )
-    ( void ) checkAmdIGpuHwmonPath();
-
-  // Check AMD dGPU availability
-  if ( m_deviceCounts.amdDGpuCount == 1 and m_hwmonDGpuRetryCount > 0 and not m_amdDGpuHwmonPath.has_value() )
-    ( void ) checkAmdDGpuHwmonPath();
-}
-
-bool HardwareMonitorWorker::checkAmdIGpuHwmonPath() noexcept
-{
-  if ( m_amdIGpuHwmonPath.has_value() )
-    return true;
-
-  if ( m_hwmonIGpuRetryCount > 0 )
+  // listen before scanning so nothing that changes in between is missed
+  if ( not m_udevMonitor.start( { "drm", "hwmon", "pci" } ) )
+    syslog( LOG_WARNING, "HardwareMonitorWorker: udev monitor unavailable, GPU hotplug is not tracked" );
+  ( void ) applyGpuTopology( m_topologyScanner.scan() );
+
+  // NVIDIA model names never change; read them once
+  m_nvidiaNames.clear();
+  if ( m_nvml->isAvailable() )
   {
-    m_hwmonIGpuRetryCount--;
-    if ( std::string path = getAmdIGpuHwmonPathImpl(); not path.empty() )
-    {
-      m_amdIGpuHwmonPath = path;
-      return true;
-    }
+    for ( unsigned int i = 0; i < m_nvml->deviceCount(); ++i )
+      m_nvidiaNames.push_back( m_nvml->getName( i ).value_or( "" ) );
+    if ( m_nvml->deviceCount() > 1 )
+      syslog( LOG_INFO, "HardwareMonitorWorker: monitoring %u NVIDIA GPUs", m_nvml->deviceCount() );
   }
-  return false;
 }
 
-bool HardwareMonitorWorker::checkAmdDGpuHwmonPath() noexcept
+void HardwareMonitorWorker::refreshGpuTopology() noexcept
 {
-  if ( m_amdDGpuHwmonPath.has_value() )
-    return true;
+  // a hotplug emits a burst of events; one rescan covers all of them
+  if ( m_udevMonitor.drain() == 0 )
+    return;
 
-  if ( m_hwmonDGpuRetryCount > 0 )
+  m_deviceCounts = m_gpuDetector.detectGpuDevices();
+  if ( applyGpuTopology( m_topologyScanner.scan() ) )
   {
-    m_hwmonDGpuRetryCount--;
-    if ( std::string path = getAmdDGpuHwmonPathImpl(); not path.empty() )
-    {
-      m_amdDGpuHwmonPath = path;
-      return true;
-    }
+    // PRIME switching rebinds drivers; report the new state right away
+    updatePrimeStatus();
+    m_lastPrimeMs = SamplingGovernor::nowMs();
   }
-  return false;
 }
 
-std::string HardwareMonitorWorker::getIntelIGpuDrmPathImpl() const noexcept
+bool HardwareMonitorWorker::applyGpuTopology( const GpuTopology &topology ) noexcept
 {
-  namespace fs = std::filesystem;
   try
   {
-    const std::string intelIGpuPattern = GpuDeviceDetector().getIntelIGpuPatternPublic();
-    const std::regex idRegex( "PCI_ID=" + intelIGpuPattern );
+    // as before, a device is only read when exactly one of its kind is present
+    GpuTopology next = topology;
+    if ( m_deviceCounts.intelIGpuCount != 1 )
+      next.intelIGpuDrmPath.clear();
+    if ( m_deviceCounts.amdIGpuCount != 1 )
+      next.amdIGpuHwmonPath.clear();
+    if ( m_deviceCounts.amdDGpuCount != 1 )
+      next.amdDGpuHwmonPath.clear();
+
+    if ( next == m_topology )
+      return false;
 
-    for ( const auto &pciDev : fs::directory_iterator( "/sys/bus/pci/devices" ) )
-    {
-      const auto drmDir = pciDev.path() / "drm";
-      std::error_code ec;
-      if ( not fs::is_directory( drmDir, ec ) )
-        continue;
+    const auto announce = []( const char *device, const std::string &path ) {
+      syslog( LOG_INFO, "HardwareMonitorWorker: %s %s", device, path.empty() ? "not present" : path.c_str() );
+    };
 
-      for ( const auto &card : fs::directory_iterator( drmDir ) )
+    if ( const std::string &path = next.intelIGpuDrmPath; path != m_topology.intelIGpuDrmPath )
+    {
+      m_intelGpuPowerController.reset();
+      m_intelRAPLGpu.reset();
+      m_polled.intelCurFreq = m_polled.intelMaxFreq = SensorPoller::INVALID_HANDLE;
+      if ( not path.empty() )
       {
-        auto ueventPath = card.path() / "device" / "uevent";
-        std::ifstream ueventFile( ueventPath );
-        if ( not ueventFile )
-          continue;
+        m_polled.intelCurFreq = m_sensorPoller->add( path + "/gt_act_freq_mhz" );
+        m_polled.intelMaxFreq = m_sensorPoller->add( path + "/gt_RP0_freq_mhz" );
+        m_intelRAPLGpu = std::make_unique< IntelRAPLController >(
+          ucc::sysfsPath( "/sys/devices/virtual/powercap/intel-rapl/intel-rapl:0/intel-rapl:0:1/" ) );
+        m_intelGpuPowerController = std::make_unique< PowerController >( *m_intelRAPLGpu );
+      }
+      announce( "Intel iGPU", path );
+    }
 
-        std::string line;
-        while ( std::getline( ueventFile, line ) )
+    if ( const std::string &path = next.amdIGpuHwmonPath; path != m_topology.amdIGpuHwmonPath )
+    {
+      m_polled.amdITemp = m_polled.amdIFreq = m_polled.amdIPower = m_polled.amdIMetrics = SensorPoller::INVALID_HANDLE;
+      m_amdIGpuMaxClockMHz = -1.0;
+      if ( not path.empty() )
+      {
+        // the DPM levels do not change at runtime; only the current one is in pp_dpm_sclk
+        std::ifstream dpm( path + "/device/pp_dpm_sclk" );
+        const std::string levels( ( std::istreambuf_iterator< char >( dpm ) ), std::istreambuf_iterator< char >() );
+        m_amdIGpuMaxClockMHz = AmdGpuMetricsDecoder::parseDpmMaxMHz( levels );
+
+        if ( const std::string metrics = path + "/device/gpu_metrics"; AmdGpuMetricsDecoder::probe( metrics ) )
+          m_polled.amdIMetrics = m_sensorPoller->add( metrics, AmdGpuMetricsDecoder::MAX_BYTES );
+        else
         {
-          if ( std::regex_search( line, idRegex ) )
-            return card.path().string();
+          m_polled.amdITemp = m_sensorPoller->add( path + "/temp1_input" );
+          m_polled.amdIFreq = m_sensorPoller->add( path + "/freq1_input" );
+          m_polled.amdIPower = m_sensorPoller->add( path + "/power1_input" );
         }
       }
+      announce( "AMD iGPU", path );
     }
-    return "";
-  }
-  catch ( ... ) { return ""; }
-}
 
-std::string HardwareMonitorWorker::getAmdIGpuHwmonPathImpl() const noexcept
-{
-  namespace fs = std::filesystem;
-  try
-  {
-    const std::string amdIGpuPattern = "1002:(164E|1506|15DD|15D8|15E7|1636|1638|164C|164D|1681|15BF|"
-                                 "15C8|1304|1305|1306|1307|1309|130A|130B|130C|130D|130E|130F|"
-                                 "1310|1311|1312|1313|1315|1316|1317|1318|131B|131C|131D|13C0|"
-                                 "9830|9831|9832|9833|9834|9835|9836|9837|9838|9839|983a|983b|983c|"
-                                 "983d|983e|983f|9850|9851|9852|9853|9854|9855|9856|9857|9858|"
-                                 "9859|985A|985B|985C|985D|985E|985F|9870|9874|9875|9876|9877|"
-                                 "98E4|13FE|143F|74A0|1435|163f|1900|1901|1114|150E)";
-    const std::regex idRegex( "PCI_ID=" + amdIGpuPattern );
-
-    for ( const auto &hwmonEntry : fs::directory_iterator( "/sys/class/hwmon" ) )
+    if ( const std::string &path = next.amdDGpuHwmonPath; path != m_topology.amdDGpuHwmonPath )
     {
-      auto ueventPath = hwmonEntry.path() / "device" / "uevent";
-      std::ifstream ueventFile( ueventPath );
-      if ( not ueventFile )
-        continue;
-
-      bool hasAmdGpu = false;
-      bool hasMatchingId = false;
-      std::string line;
-      while ( std::getline( ueventFile, line ) )
+      m_polled.amdDTemp = m_polled.amdDFreq = m_polled.amdDPower = m_polled.amdDMetrics = SensorPoller::INVALID_HANDLE;
+      if ( not path.empty() )
       {
-        if ( line == "DRIVER=amdgpu" )
-          hasAmdGpu = true;
-        if ( std::regex_search( line, idRegex ) )
-          hasMatchingId = true;
-        if ( hasAmdGpu and hasMatchingId )
-          return hwmonEntry.path().string();
+        if ( const std::string metrics = path + "/device/gpu_metrics"; AmdGpuMetricsDecoder::probe( metrics ) )
+          m_polled.amdDMetrics = m_sensorPoller->add( metrics, AmdGpuMetricsDecoder::MAX_BYTES );
+        else
+        {
+          m_polled.amdDTemp = m_sensorPoller->add( path + "/temp1_input" );
+          m_polled.amdDFreq = m_sensorPoller->add( path + "/freq1_input" );
+          m_polled.amdDPower = m_sensorPoller->add( path + "/power1_average" );
+        }
       }
+      announce( "AMD dGPU", path );
     }
-    return "";
-  }
-  catch ( ... ) { return ""; }
-}
 
-std::string HardwareMonitorWorker::getAmdDGpuHwmonPathImpl() const noexcept
-{
-  return "";
+    if ( m_isDisplayMuxDevice and next.nvidiaEdpConnector != m_topology.nvidiaEdpConnector )
+    {
+      m_displayConnectedToNvidia = not next.nvidiaEdpConnector.empty();
+      if ( m_displayConnectedToNvidia )
+        syslog( LOG_INFO, "HardwareMonitorWorker: eDP display '%s' connected to NVIDIA GPU",
+                next.nvidiaEdpConnector.c_str() );
+    }
+
+    m_topology = std::move( next );
+    return true;
+  }
+  catch ( ... ) { return false; }
 }
 
 IGpuInfo HardwareMonitorWorker::getIGpuValues() noexcept
 {
   IGpuInfo values{};
 
-  if ( m_intelIGpuDrmPath.has_value() )
+  if ( not ( m_sensorGroups & ucc::SensorGroup::IGpu ) )
+    return values;
+
+  if ( not m_topology.intelIGpuDrmPath.empty() )
     values = getIntelIGpuValues( values );
-  else if ( m_amdIGpuHwmonPath.has_value() )
+  else if ( not m_topology.amdIGpuHwmonPath.empty() )
     values = getAmdIGpuValues( values );
 
   return values;
@@ -545,18 +572,17 @@ IGpuInfo HardwareMonitorWorker::getIntelIGpuValues( const IGpuInfo &base ) const
 {
   IGpuInfo values = base;
 
-  if ( not m_intelIGpuDrmPath.has_value() )
+  if ( m_topology.intelIGpuDrmPath.empty() )
     return values;
 
   values.m_vendor = "intel";
-  const std::string &drmPath = m_intelIGpuDrmPath.value();
 
   // Current GPU frequency (MHz) — directly readable from DRM sysfs
-  if ( auto curFreq = SysfsNode< int64_t >( drmPath + "/gt_act_freq_mhz" ).read(); curFreq and *curFreq > 0 )
+  if ( auto curFreq = m_sensorPoller->readInt( m_polled.intelCurFreq ); curFreq and *curFreq > 0 )
     values.m_coreFrequency = static_cast< double >( *curFreq );
 
   // Max GPU frequency (MHz)
-  if ( auto maxFreq = SysfsNode< int64_t >( drmPath + "/gt_RP0_freq_mhz" ).read(); maxFreq and *maxFreq > 0 )
+  if ( auto maxFreq = m_sensorPoller->readInt( m_polled.intelMaxFreq ); maxFreq and *maxFreq > 0 )
     values.m_maxCoreFrequency = static_cast< double >( *maxFreq );
 
   // Power draw via Intel RAPL
@@ -570,130 +596,174 @@ IGpuInfo HardwareMonitorWorker::getAmdIGpuValues( const IGpuInfo &base ) const n
 {
   IGpuInfo values = base;
 
-  if ( not m_amdIGpuHwmonPath.has_value() )
+  if ( m_topology.amdIGpuHwmonPath.empty() )
     return values;
 
-  std::string hwmonPath = m_amdIGpuHwmonPath.value();
   values.m_vendor = "amd";
+  values.m_maxCoreFrequency = m_amdIGpuMaxClockMHz;
+
+  if ( m_polled.amdIMetrics != SensorPoller::INVALID_HANDLE )
+  {
+    if ( const auto metrics = readAmdGpuMetrics( m_polled.amdIMetrics ) )
+    {
+      values.m_temp = metrics->temperatureC;
+      values.m_coreFrequency = metrics->gfxClockMHz;
+      if ( metrics->gfxMaxClockMHz > 0.0 )
+        values.m_maxCoreFrequency = metrics->gfxMaxClockMHz;
+      values.m_powerDraw = metrics->socketPowerW;
+      values.m_gfxActivityPct = metrics->gfxActivityPct;
+      values.m_throttleStatus = metrics->throttleStatus;
+      values.m_cpuCoreClocksMHz = metrics->cpuCoreClockMHz;
+    }
+    return values;
+  }
 
-  if ( int64_t tempValue = SysfsNode< int64_t >( hwmonPath + "/temp1_input" ).read().value_or( -1 ); tempValue >= 0 )
+  if ( int64_t tempValue = m_sensorPoller->readInt( m_polled.amdITemp ).value_or( -1 ); tempValue >= 0 )
     values.m_temp = static_cast< double >( tempValue ) / 1000.0;
 
-  if ( int64_t curFreqValue = SysfsNode< int64_t >( hwmonPath + "/freq1_input" ).read().value_or( -1 ); curFreqValue >= 0 )
+  if ( int64_t curFreqValue = m_sensorPoller->readInt( m_polled.amdIFreq ).value_or( -1 ); curFreqValue >= 0 )
     values.m_coreFrequency = static_cast< double >( curFreqValue ) / 1000000.0;
 
-  if ( std::string maxFreqString = SysfsNode< std::string >( hwmonPath + "/device/pp_dpm_sclk" ).read().value_or( "" ); not maxFreqString.empty() )
-    values.m_maxCoreFrequency = parseMaxAmdFreq( maxFreqString );
-
-  if ( int64_t powerValue = SysfsNode< int64_t >( hwmonPath + "/power1_input" ).read().value_or( -1 ); powerValue >= 0 )
+  if ( int64_t powerValue = m_sensorPoller->readInt( m_polled.amdIPower ).value_or( -1 ); powerValue >= 0 )
     values.m_powerDraw = static_cast< double >( powerValue ) / 1000.0;
 
   return values;
 }
 
-DGpuInfo HardwareMonitorWorker::getDGpuValues() noexcept
+const std::vector< DGpuInfo > &HardwareMonitorWorker::getDGpuValues() noexcept
 {
-  DGpuInfo values{};
-  bool metricsUsage = true;
+  const bool metricsUsage = ( m_sensorGroups & ucc::SensorGroup::DGpu ) != 0;
+  const unsigned int nvmlDevices = m_nvml->isAvailable() ? m_nvml->deviceCount() : 0;
 
-  if ( m_deviceCounts.nvidiaCount == 1 and m_nvml->isAvailable() and metricsUsage )
+  if ( m_deviceCounts.nvidiaCount >= 1 and nvmlDevices > 0 and metricsUsage )
   {
-    values = getNvidiaDGpuValues();
+    m_dGpuValues.resize( nvmlDevices );
+    for ( unsigned int i = 0; i < nvmlDevices; ++i )
+      getNvidiaDGpuValues( i, m_dGpuValues[ i ] );
   }
-  else if ( m_deviceCounts.amdDGpuCount == 1 and metricsUsage )
+  else
   {
-    if ( m_amdDGpuHwmonPath.has_value() or checkAmdDGpuHwmonPath() )
-      values = getAmdDGpuValues( values );
+    m_dGpuValues.resize( 1 );
+    m_dGpuValues[ 0 ] = DGpuInfo{};
+    if ( m_deviceCounts.amdDGpuCount == 1 and metricsUsage )
+    {
+      if ( not m_topology.amdDGpuHwmonPath.empty() )
+        m_dGpuValues[ 0 ] = getAmdDGpuValues( m_dGpuValues[ 0 ] );
+    }
   }
 
-  values.m_d0MetricsUsage = metricsUsage;
-  return values;
+  for ( auto &values : m_dGpuValues )
+    values.m_d0MetricsUsage = metricsUsage;
+  return m_dGpuValues;
 }
 
-DGpuInfo HardwareMonitorWorker::getNvidiaDGpuValues() const noexcept
+void HardwareMonitorWorker::getNvidiaDGpuValues( unsigned int deviceIndex, DGpuInfo &values ) const noexcept
 {
-  if ( !m_nvml->isAvailable() )
-    return DGpuInfo{};
-
-  DGpuInfo values{};
-
-  if ( auto v = m_nvml->getTemperatureDegC( 0 ) )
-    values.m_temp = static_cast< double >( *v );
-
-  if ( auto v = m_nvml->getPowerDrawW( 0 ) )
-    values.m_powerDraw = *v;
-
-  if ( auto v = m_nvml->getPowerMaxLimitW( 0 ) )
-    values.m_maxPowerLimit = *v;
-
-  if ( auto v = m_nvml->getEnforcedPowerLimitW( 0 ) )
-    values.m_enforcedPowerLimit = *v;
-
-  if ( auto v = m_nvml->getGpuClockMHz( 0 ) )
-    values.m_coreFrequency = static_cast< double >( *v );
-
-  if ( auto v = m_nvml->getMemClockMHz( 0 ) )
-    values.m_vramFrequency = static_cast< double >( *v );
-
-  if ( auto v = m_nvml->getMaxGpuClockMHz( 0 ) )
-    values.m_maxCoreFrequency = static_cast< double >( *v );
-
-  if ( auto v = m_nvml->getComputeUtilPct( 0 ) )
-    values.m_computeUtilPct = static_cast< int >( *v );
-
-  if ( auto v = m_nvml->getMemoryUtilPct( 0 ) )
-    values.m_memoryUtilPct = static_cast< int >( *v );
-
-  if ( auto v = m_nvml->getVramUsedMiB( 0 ) )
-    values.m_vramUsedMiB = static_cast< int >( *v );
-
-  if ( auto v = m_nvml->getVramTotalMiB( 0 ) )
-    values.m_vramTotalMiB = static_cast< int >( *v );
-
-  if ( auto v = m_nvml->getPerfLimitReason( 0 ) )
-    values.m_perfLimitReason = *v;
-
-  if ( auto v = m_nvml->getEncoderUtilPct( 0 ) )
-    values.m_encoderUtilPct = static_cast< int >( *v );
-
-  if ( auto v = m_nvml->getDecoderUtilPct( 0 ) )
-    values.m_decoderUtilPct = static_cast< int >( *v );
-
-  if ( auto v = m_nvml->getCurrentPstate( 0 ) )
-    values.m_currentPstate = static_cast< int >( *v );
-
-  if ( auto v = m_nvml->getGrClockOffsetMHz( 0 ) )
-    values.m_grClockOffsetMHz = *v;
-
-  if ( auto v = m_nvml->getMemClockOffsetMHz( 0 ) )
-    values.m_memClockOffsetMHz = *v;
-
-  if ( auto v = m_nvml->getCoreVoltageMv( 0 ) )
-    values.m_coreVoltageMv = static_cast< int >( *v );
+  // Assign field by field so the strings keep their capacity across cycles
+  const NvmlTelemetry t = m_nvml->getTelemetry( deviceIndex );
+  const auto toInt = []( const std::optional< unsigned int > &v ) { return v ? static_cast< int >( *v ) : -1; };
+  const auto toDouble = []( const std::optional< unsigned int > &v ) { return v ? static_cast< double >( *v ) : -1.0; };
+
+  values.m_deviceIndex = static_cast< int >( deviceIndex );
+  if ( deviceIndex < m_nvidiaNames.size() )
+    values.m_name.assign( m_nvidiaNames[ deviceIndex ] );
+  else
+    values.m_name.clear();
+
+  values.m_temp = toDouble( t.tempC );
+  values.m_powerDraw = t.powerDrawW.value_or( -1.0 );
+  values.m_maxPowerLimit = t.powerMaxLimitW.value_or( -1.0 );
+  values.m_enforcedPowerLimit = t.enforcedPowerLimitW.value_or( -1.0 );
+  values.m_coreFrequency = toDouble( t.gpuClockMHz );
+  values.m_vramFrequency = toDouble( t.memClockMHz );
+  values.m_maxCoreFrequency = toDouble( t.maxGpuClockMHz );
+  values.m_computeUtilPct = toInt( t.computeUtilPct );
+  values.m_memoryUtilPct = toInt( t.memoryUtilPct );
+  values.m_vramUsedMiB = toInt( t.vramUsedMiB );
+  values.m_vramTotalMiB = toInt( t.vramTotalMiB );
+  if ( t.perfLimitReason )
+    values.m_perfLimitReason.assign( *t.perfLimitReason );
+  else
+    values.m_perfLimitReason.clear();
+  values.m_encoderUtilPct = toInt( t.encoderUtilPct );
+  values.m_decoderUtilPct = toInt( t.decoderUtilPct );
+  values.m_currentPstate = toInt( t.currentPstate );
+  values.m_grClockOffsetMHz = t.grClockOffsetMHz.value_or( INT_MIN );
+  values.m_memClockOffsetMHz = t.memClockOffsetMHz.value_or( INT_MIN );
+  values.m_coreVoltageMv = toInt( t.coreVoltageMv );
+}
 
-  return values;
+const GpuSampleBatch *HardwareMonitorWorker::drainGpuSamples() noexcept
+{
+  // The raw history rings are sized for a few points per second, so the
+  // driver's ~50 Hz buffers are only drained while the governor runs fast:
+  // during a temperature ramp or while a client watches live data.
+  if ( not ( m_sensorGroups & ucc::SensorGroup::DGpu ) )
+    return nullptr;
+  if ( not m_governor or not m_nvml->supportsSampleBuffers() or m_nvml->deviceCount() == 0
+       or m_governor->mode() != SamplingMode::Fast )
+    return nullptr;
+
+  struct Series
+  {
+    nvml::nvmlSamplingType_t type;
+    std::vector< NvmlSample > GpuSampleBatch::*points;
+    double scale;
+  };
+  static constexpr std::array< Series, 5 > SERIES{ {
+    { nvml::NVML_TOTAL_POWER_SAMPLES, &GpuSampleBatch::powerW, 1e-3 },
+    { nvml::NVML_GPU_UTILIZATION_SAMPLES, &GpuSampleBatch::computeUtilPct, 1.0 },
+    { nvml::NVML_MEMORY_UTILIZATION_SAMPLES, &GpuSampleBatch::memoryUtilPct, 1.0 },
+    { nvml::NVML_PROCESSOR_CLK_SAMPLES, &GpuSampleBatch::coreClockMHz, 1.0 },
+    { nvml::NVML_MEMORY_CLK_SAMPLES, &GpuSampleBatch::memClockMHz, 1.0 },
+  } };
+  static_assert( SERIES.size() == std::tuple_size_v< decltype( m_gpuSampleCursors ) > );
+
+  for ( size_t i = 0; i < SERIES.size(); ++i )
+  {
+    auto &points = m_gpuSamples.*SERIES[ i ].points;
+    points.clear();
+    if ( not m_nvml->drainSamples( 0, SERIES[ i ].type, m_gpuSampleCursors[ i ], points ) )
+      points.clear();
+    for ( auto &pt : points )
+      pt.value *= SERIES[ i ].scale;
+  }
+  return &m_gpuSamples;
 }
 
 DGpuInfo HardwareMonitorWorker::getAmdDGpuValues( const DGpuInfo &base ) const noexcept
 {
   DGpuInfo values = base;
 
-  if ( not m_amdDGpuHwmonPath.has_value() )
+  if ( m_topology.amdDGpuHwmonPath.empty() )
     return values;
 
   try
   {
-    const std::string &basePath = m_amdDGpuHwmonPath.value();
+    if ( m_polled.amdDMetrics != SensorPoller::INVALID_HANDLE )
+    {
+      if ( const auto metrics = readAmdGpuMetrics( m_polled.amdDMetrics ) )
+      {
+        values.m_temp = metrics->temperatureC;
+        values.m_coreFrequency = metrics->gfxClockMHz;
+        values.m_vramFrequency = metrics->memClockMHz;
+        values.m_powerDraw = metrics->socketPowerW;
+        values.m_computeUtilPct = metrics->gfxActivityPct >= 0.0 ? static_cast< int >( std::lround( metrics->gfxActivityPct ) ) : -1;
+        values.m_memoryUtilPct = metrics->memActivityPct >= 0.0 ? static_cast< int >( std::lround( metrics->memActivityPct ) ) : -1;
+        values.m_throttleStatus = metrics->throttleStatus;
+      }
+      return values;
+    }
 
-    int64_t tempMilli = SysfsNode< int64_t >( basePath + "/temp1_input" ).read().value_or( -1000 );
+    int64_t tempMilli = m_sensorPoller->readInt( m_polled.amdDTemp ).value_or( -1000 );
     if ( tempMilli > -1000 )
       values.m_temp = static_cast< double >( tempMilli ) / 1000.0;
 
-    int64_t freqHz = SysfsNode< int64_t >( basePath + "/freq1_input" ).read().value_or( -1 );
+    int64_t freqHz = m_sensorPoller->readInt( m_polled.amdDFreq ).value_or( -1 );
     if ( freqHz > 0 )
       values.m_coreFrequency = static_cast< double >( freqHz ) / 1000000.0;
 
-    int64_t powerMicro = SysfsNode< int64_t >( basePath + "/power1_average" ).read().value_or( -1 );
+    int64_t powerMicro = m_sensorPoller->readInt( m_polled.amdDPower ).value_or( -1 );
     if ( powerMicro > 0 )
       values.m_powerDraw = static_cast< double >( powerMicro ) / 1000000.0;
   }
@@ -702,27 +772,11 @@ DGpuInfo HardwareMonitorWorker::getAmdDGpuValues( const DGpuInfo &base ) const n
   return values;
 }
 
-double HardwareMonitorWorker::parseMaxAmdFreq( const std::string &frequencyString ) const noexcept
+std::optional< AmdGpuMetrics > HardwareMonitorWorker::readAmdGpuMetrics( SensorPoller::Handle handle ) const
 {
-  std::regex mhzRegex( R"(\d+Mhz)" );
-  std::smatch match;
-  double maxFreq = -1.0;
-
-  std::string::const_iterator searchStart( frequencyString.cbegin() );
-  while ( std::regex_search( searchStart, frequencyString.cend(), match, mhzRegex ) )
-  {
-    try
-    {
-      std::string numStr = match.str();
-      numStr = numStr.substr( 0, numStr.length() - 3 );
-      double freq = std::stod( numStr );
-      if ( freq > maxFreq )
-        maxFreq = freq;
-    }
-    catch ( ... ) { }
-    searchStart = match.suffix().first;
-  }
-  return maxFreq;
+  std::array< uint8_t, AmdGpuMetricsDecoder::MAX_BYTES > table;
+  const size_t n = m_sensorPoller->readBytes( handle, table.data(), table.size() );
+  return AmdGpuMetricsDecoder::decode( table.data(), n );
 }
 
 // ============================================================================
@@ -732,9 +786,20 @@ double HardwareMonitorWorker::parseMaxAmdFreq( const std::string &frequencyStrin
 void HardwareMonitorWorker::initCpuPower()
 {
   m_intelRAPLCpu = std::make_unique< IntelRAPLController >(
-    "/sys/devices/virtual/powercap/intel-rapl/intel-rapl:0/" );
+    ucc::sysfsPath( "/sys/devices/virtual/powercap/intel-rapl/intel-rapl:0/" ) );
   m_intelRAPLCpu->updateFromSysfs();
-  m_cpuPowerController = std::make_unique< PowerController >( *m_intelRAPLCpu );
+
+  m_raplDomains.discover();
+  if ( m_raplDomains.source() == RaplDomainSampler::Source::AmdEnergy )
+    syslog( LOG_INFO, "HardwareMonitorWorker: CPU power from amd_energy hwmon" );
+  else if ( m_raplDomains.source() == RaplDomainSampler::Source::None )
+    syslog( LOG_INFO, "HardwareMonitorWorker: no RAPL energy counters found" );
+
+  m_cpuThrottle.discover();
+  syslog( LOG_INFO, "HardwareMonitorWorker: throttle counters: thermal %s, power limits %s, %zu C-state residency",
+          m_cpuThrottle.hasThermalCounters() ? "yes" : "no",
+          m_cpuThrottle.hasPowerLimits() ? "yes" : "no",
+          m_cpuThrottle.residencyCounters() );
 
   m_RAPLConstraint0Status = m_intelRAPLCpu->getIntelRAPLConstraint0Available();
   m_RAPLConstraint1Status = m_intelRAPLCpu->getIntelRAPLConstraint1Available();
@@ -746,33 +811,56 @@ void HardwareMonitorWorker::initCpuPower()
 
 void HardwareMonitorWorker::updateCpuPower()
 {
-  std::ostringstream jsonStream;
-  jsonStream << "{";
-  double rawPower = -1.0;
+  JsonWriter json( m_cpuPowerJSON );
+  json.beginObject();
+  RaplDomainWatts domainWatts;
+  domainWatts.fill( -1.0 );
 
-  if ( m_getSensorDataCollectionStatus() )
+  if ( m_sensorGroups & ucc::SensorGroup::CpuPower )
   {
-    rawPower = getCpuCurrentPower();
-    jsonStream << "\"powerDraw\":" << rawPower;
+    domainWatts = m_raplDomains.sample();
+    json.key( "powerDraw" ).value( domainWatts[ static_cast< size_t >( RaplDomain::Package ) ] );
 
     double maxPowerLimit = getCpuMaxPowerLimit();
     if ( maxPowerLimit > 0 )
-      jsonStream << ",\"maxPowerLimit\":" << maxPowerLimit;
+      json.key( "maxPowerLimit" ).value( maxPowerLimit );
+
+    json.key( "domains" ).beginObject();
+    for ( size_t i = 0; i < RAPL_DOMAIN_COUNT; ++i )
+    {
+      const auto domain = static_cast< RaplDomain >( i );
+      if ( m_raplDomains.available( domain ) )
+        json.key( raplDomainName( domain ) ).value( domainWatts[ i ] );
+    }
+    json.endObject();
+
+    const CpuThrottleMetrics throttle =
+      m_cpuThrottle.sample( domainWatts[ static_cast< size_t >( RaplDomain::Package ) ] );
+    json.key( "throttle" ).beginObject()
+      .key( "corePct" ).value( throttle.coreThrottlePct, 1 )
+      .key( "packagePct" ).value( throttle.packageThrottlePct, 1 )
+      .key( "coreEvents" ).value( throttle.coreThrottleEvents )
+      .key( "packageEvents" ).value( throttle.packageThrottleEvents )
+      .key( "powerLimitedPct" ).value( throttle.powerLimitedPct, 0 )
+      .key( "pkgCstatePct" ).value( throttle.pkgCstatePct, 1 )
+      .endObject();
+
+    if ( m_cpuThrottleCallback )
+    {
+      try
+      {
+        m_cpuThrottleCallback( throttle );
+      }
+      catch ( ... ) { /* ignore callback exceptions */ }
+    }
   }
   else
   {
-    jsonStream << "\"powerDraw\":-1";
+    json.key( "powerDraw" ).value( -1 );
   }
 
-  jsonStream << "}";
-  m_cpuPowerUpdateCallback( jsonStream.str(), rawPower );
-}
-
-double HardwareMonitorWorker::getCpuCurrentPower()
-{
-  if ( not m_cpuPowerController )
-    return -1.0;
-  return m_cpuPowerController->getCurrentPower();
+  json.endObject();
+  m_cpuPowerUpdateCallback( m_cpuPowerJSON, domainWatts );
 }
 
 double HardwareMonitorWorker::getCpuMaxPowerLimit()
@@ -813,17 +901,14 @@ double HardwareMonitorWorker::getCpuMaxPowerLimit()
 
 void HardwareMonitorWorker::initPrime()
 {
-  // Wait for requires_offloading file to be updated after boot
-  std::this_thread::sleep_for( std::chrono::milliseconds( 2000 ) );
-
+  // primeState keeps its "-1" sentinel until onWork() reads it, once the
+  // requires_offloading file had PRIME_SETTLE_MS to be updated after boot
   if ( m_isDisplayMuxDevice )
   {
-    m_displayConnectedToNvidia = getDisplayConnectedToNvidia();
+    m_displayConnectedToNvidia = not m_topology.nvidiaEdpConnector.empty();
     syslog( LOG_INFO, "HardwareMonitorWorker: Display mux device — display connected to NVIDIA: %s",
             m_displayConnectedToNvidia ? "yes" : "no" );
   }
-
-  updatePrimeStatus();
 }
 
 void HardwareMonitorWorker::updatePrimeStatus() noexcept
@@ -912,86 +997,34 @@ std::string HardwareMonitorWorker::transformPrimeStatus( const std::string &stat
     return "off";
 }
 
-bool HardwareMonitorWorker::getDisplayConnectedToNvidia() const noexcept
+// ============================================================================
+// CPU frequency
+// ============================================================================
+
+void HardwareMonitorWorker::updateCpuFrequency() noexcept
 {
-  namespace fs = std::filesystem;
+  if ( !m_cpuFrequencyCallback or !m_cpuCores )
+    return;
 
   try
   {
-    const std::string drmPath = "/sys/class/drm/";
-    std::error_code ec;
-
-    if ( not fs::exists( drmPath, ec ) )
-      return false;
-
-    for ( const auto &entry : fs::directory_iterator( drmPath, ec ) )
-    {
-      const std::string name = entry.path().filename().string();
-
-      // Look for eDP connector entries (e.g. card0-eDP-1, card1-eDP-2)
-      if ( name.find( "eDP" ) == std::string::npos )
-        continue;
-
-      const std::string vendorPath = entry.path().string() + "/device/device/vendor";
-      const std::string statusPath = entry.path().string() + "/status";
-
-      std::ifstream vendorFile( vendorPath );
-      std::ifstream statusFile( statusPath );
-
-      if ( not vendorFile.is_open() or not statusFile.is_open() )
-        continue;
-
-      std::string vendorId, status;
-      std::getline( vendorFile, vendorId );
-      std::getline( statusFile, status );
-
-      // Trim whitespace
-      while ( not vendorId.empty() and ( vendorId.back() == '\n' or vendorId.back() == ' ' ) )
-        vendorId.pop_back();
-      while ( not status.empty() and ( status.back() == '\n' or status.back() == ' ' ) )
-        status.pop_back();
-
-      // 0x10de = NVIDIA vendor ID
-      if ( vendorId == "0x10de" and status == "connected" )
-      {
-        syslog( LOG_INFO, "HardwareMonitorWorker: eDP display '%s' connected to NVIDIA GPU",
-                name.c_str() );
-        return true;
-      }
-    }
+    m_cpuFrequencyCallback( m_cpuCores->sample() );
   }
-  catch ( const std::exception &e )
-  {
-    syslog( LOG_WARNING, "HardwareMonitorWorker: getDisplayConnectedToNvidia failed: %s", e.what() );
-  }
-
-  return false;
+  catch ( ... ) { /* ignore callback exceptions */ }
 }
 
 // ============================================================================
-// CPU frequency
+// Battery
 // ============================================================================
 
-void HardwareMonitorWorker::updateCpuFrequency() noexcept
+void HardwareMonitorWorker::updateBattery() noexcept
 {
-  if ( !m_cpuFrequencyCallback )
+  if ( !m_batteryCallback or !m_battery or !m_battery->available() )
     return;
 
   try
   {
-    std::ifstream ifs( "/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq" );
-    if ( ifs.is_open() )
-    {
-      int freqKHz = -1;
-      ifs >> freqKHz;
-      if ( freqKHz > 0 )
-      {
-        m_cpuFrequencyCallback( freqKHz / 1000 );
-        return;
-      }
-    }
+    m_batteryCallback( m_battery->sample() );
   }
-  catch ( ... ) { /* ignore */ }
-
-  m_cpuFrequencyCallback( -1 );
+  catch ( ... ) { /* ignore callback exceptions */ }
 }
@@ -14,9 +14,12 @@
  */
 
 #include "workers/LCTWaterCoolerWorker.hpp"
+#include "MetricsHistoryStore.hpp"
 #include "UccDBusService.hpp"
 #include "workers/DaemonWorker.hpp" // for ucc::wDebug
+#include "UccTrace.hpp"
 
+#include <QBluetoothAddress>
 #include <QBluetoothLocalDevice>
 #include <QProcess>
 #include <QThread>
@@ -60,6 +63,25 @@ LCTWaterCoolerWorker::LCTWaterCoolerWorker( UccDBusData& dbusData, StatusCallbac
   m_tickTimer->setInterval( TICK_INTERVAL_MS );
   connect( m_tickTimer, &QTimer::timeout, this, &LCTWaterCoolerWorker::onTick );
 
+  // Sends queued BLE writes once the write gap has passed
+  m_bleQueueTimer = new QTimer( this );
+  m_bleQueueTimer->setSingleShot( true );
+  connect( m_bleQueueTimer, &QTimer::timeout, this, &LCTWaterCoolerWorker::sendQueuedBleWrites );
+  m_bleQueue.setCompletionHandler( [this]( const auto& command, BleCommandOutcome outcome )
+                                   { onBleCommandFinished( command, outcome ); } );
+
+  // Connect straight to the device of the last run instead of scanning first
+  if ( m_savedDevice = KnownBleDevice::load(); m_savedDevice )
+  {
+    m_lastKnownDeviceInfo = QBluetoothDeviceInfo( QBluetoothAddress( QString::fromStdString( m_savedDevice->address ) ),
+                                                  QString::fromStdString( m_savedDevice->name ), 0 );
+    m_lastKnownDeviceInfo.setCoreConfigurations( QBluetoothDeviceInfo::LowEnergyCoreConfiguration );
+    m_trustedDeviceMacAddress = m_lastKnownDeviceInfo.address().toString();
+    m_hasKnownDevice = true;
+    syslog( LOG_INFO, "LCTWaterCoolerWorker: known device %s (%s) from the last run",
+            m_savedDevice->name.c_str(), m_savedDevice->address.c_str() );
+  }
+
   // Initialize BLE discovery agent
   auto adapters = QBluetoothLocalDevice::allDevices();
   if ( adapters.isEmpty() )
@@ -125,6 +147,7 @@ void LCTWaterCoolerWorker::stop()
 
 void LCTWaterCoolerWorker::onTick()
 {
+  UCC_TRACE_SCOPE( "ble", "LCTWaterCoolerWorker::onTick" );
   // Don't run the state machine while the system is suspending
   if ( m_suspending )
     return;
@@ -198,6 +221,8 @@ void LCTWaterCoolerWorker::handleDisconnected()
               m_fastReconnectFailures );
       m_hasKnownDevice = false;
       m_fastReconnectFailures = 0;
+      m_savedDevice.reset();
+      KnownBleDevice::forget();
       // Fall through to discovery below
     }
     else
@@ -384,6 +409,16 @@ void LCTWaterCoolerWorker::onConnectionReady()
   m_missedKeepalives = 0;
   m_lastKeepalive = std::chrono::steady_clock::now();
 
+  // Remember the device for a direct connect after the next daemon start
+  const KnownBleDevice device{ m_connectedDeviceInfo.address().toString().toStdString(),
+                               m_connectedDeviceInfo.name().toStdString() };
+  if ( device != m_savedDevice and device.save() )
+    m_savedDevice = device;
+
+  // The advertisement's RSSI until the first keepalive reads the link's
+  if ( m_metricsStore and m_connectedDeviceInfo.rssi() != 0 )
+    m_metricsStore->push( MetricId::WaterCoolerRssi, static_cast< double >( m_connectedDeviceInfo.rssi() ) );
+
   // Do NOT send initial pump/fan commands here.  The hardware powers up at its
   // own default voltage (typically V11) and may silently ignore BLE writes
   // issued immediately after service discovery.  Sending "Off" here would
@@ -469,6 +504,11 @@ void LCTWaterCoolerWorker::onBleDisconnected()
   {
     m_state = WaterCoolerState::Disconnected;
   }
+
+  // A dropped link goes straight to the direct reconnect rather than
+  // waiting up to a tick; failed attempts keep the tick's pace
+  if ( currentState == WaterCoolerState::Connected and m_hasKnownDevice and not m_suspending )
+    QTimer::singleShot( 0, this, &LCTWaterCoolerWorker::onTick );
 }
 
 void LCTWaterCoolerWorker::onServiceDiscoveryFinished()
@@ -806,7 +846,7 @@ bool LCTWaterCoolerWorker::setFanSpeedImpl( int dutyCyclePercent )
   data.append( static_cast< char >( 0x00 ) );
   data.append( static_cast< char >( 0xef ) );
 
-  throttledBleWrite( data );
+  enqueueBleWrite( data );
   return true;
 }
 
@@ -836,18 +876,114 @@ bool LCTWaterCoolerWorker::setPumpVoltageImpl( int voltageInt )
   data.append( static_cast< char >( 0x00 ) );
   data.append( static_cast< char >( 0xef ) );
 
-  throttledBleWrite( data );
+  enqueueBleWrite( data );
   return true;
 }
 
-void LCTWaterCoolerWorker::throttledBleWrite( const QByteArray& data )
+void LCTWaterCoolerWorker::enqueueBleWrite( const QByteArray& data )
 {
-  const auto now = std::chrono::steady_clock::now();
-  const auto elapsed = std::chrono::duration_cast< std::chrono::milliseconds >( now - m_lastBleWrite ).count();
+  BleCommandKind kind = BleCommandKind::Other;
+  switch ( data.size() > 1 ? static_cast< uint8_t >( data[ 1 ] ) : 0 )
+  {
+  case CMD_RESET:
+    kind = BleCommandKind::Reset;
+    break;
+  case CMD_PUMP:
+    kind = BleCommandKind::Pump;
+    break;
+  case CMD_FAN:
+    kind = BleCommandKind::Fan;
+    break;
+  case CMD_RGB:
+    kind = BleCommandKind::Led;
+    break;
+  default:
+    break;
+  }
+
+  UCC_TRACE_INSTANT( "ble", "enqueue", static_cast< uint8_t >( kind ) );
+  m_bleQueue.push( kind, data );
+  if ( not m_bleQueueTimer->isActive() )
+    sendQueuedBleWrites();
+}
+
+void LCTWaterCoolerWorker::sendQueuedBleWrites()
+{
+  if ( m_bleQueue.empty() )
+    return;
+
+  if ( not m_isConnected.load() or not m_uartService or not m_txCharacteristic.isValid() )
+  {
+    m_bleQueue.clear();
+    return;
+  }
+
+  const auto elapsed = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() -
+                                                                                m_lastBleWrite ).count();
   if ( elapsed < BLE_WRITE_GAP_MS )
-    QThread::msleep( static_cast< unsigned long >( BLE_WRITE_GAP_MS - elapsed ) );
-  m_uartService->writeCharacteristic( m_txCharacteristic, data, QLowEnergyService::WriteWithoutResponse );
+  {
+    m_bleQueueTimer->start( static_cast< int >( BLE_WRITE_GAP_MS - elapsed ) );
+    return;
+  }
+
+  const auto command = m_bleQueue.pop();
+  {
+    UCC_TRACE_SCOPE_ARG( "ble", "writeCharacteristic", command->data.size() );
+    m_uartService->writeCharacteristic( m_txCharacteristic, command->data, QLowEnergyService::WriteWithoutResponse );
+  }
   m_lastBleWrite = std::chrono::steady_clock::now();
+  m_bleQueue.written( *command );
+
+  if ( not m_bleQueue.empty() )
+    m_bleQueueTimer->start( BLE_WRITE_GAP_MS );
+}
+
+void LCTWaterCoolerWorker::onBleCommandFinished( const BleCommandQueue< QByteArray >::Command& command,
+                                                 BleCommandOutcome outcome )
+{
+  if ( outcome == BleCommandOutcome::Written )
+  {
+    if ( m_metricsStore and command.data.size() > 4 )
+    {
+      const auto waited = std::chrono::steady_clock::now() - command.queuedAt;
+      m_metricsStore->push( MetricId::WaterCoolerLatency,
+                            std::chrono::duration< double, std::milli >( waited ).count() );
+
+      // Packets are fe <cmd> <enable> <duty> <voltage> ...; a cleared
+      // enable byte is the turn-off command
+      const bool enabled = command.data[ 2 ] != 0;
+      if ( command.kind == BleCommandKind::Fan )
+        m_metricsStore->push( MetricId::WaterCoolerFanDuty,
+                              enabled ? static_cast< double >( static_cast< uint8_t >( command.data[ 3 ] ) ) : 0.0 );
+      else if ( command.kind == BleCommandKind::Pump )
+      {
+        double volts = 0.0;
+        switch ( enabled ? static_cast< ucc::PumpVoltage >( command.data[ 4 ] ) : ucc::PumpVoltage::Off )
+        {
+        case ucc::PumpVoltage::V7:  volts = 7.0; break;
+        case ucc::PumpVoltage::V8:  volts = 8.0; break;
+        case ucc::PumpVoltage::V11: volts = 11.0; break;
+        case ucc::PumpVoltage::V12: volts = 12.0; break;
+        case ucc::PumpVoltage::Off: break;
+        }
+        m_metricsStore->push( MetricId::WaterCoolerPumpLevel, volts / 12.0 * 100.0 );
+      }
+    }
+    return;
+  }
+
+  if ( outcome != BleCommandOutcome::Dropped )
+    return;
+
+  // The cached value never reached the device; forget it so the next
+  // request for the same value is not skipped as redundant
+  if ( command.kind == BleCommandKind::Fan )
+    m_lastFanSpeed.store( -1 );
+  else if ( command.kind == BleCommandKind::Pump )
+    m_lastPumpVoltage.store( -1 );
+
+  ucc::wDebug( "[WC-BLE] dropped queued command 0x%02x",
+               command.data.size() > 1 ? static_cast< unsigned >( static_cast< uint8_t >( command.data[ 1 ] ) ) : 0u );
 }
 
 bool LCTWaterCoolerWorker::writeCommandImpl( const QByteArray& data, bool withResponse )
@@ -856,7 +992,7 @@ bool LCTWaterCoolerWorker::writeCommandImpl( const QByteArray& data, bool withRe
   if ( not m_isConnected.load() or not m_txCharacteristic.isValid() or not m_uartService )
     return false;
 
-  throttledBleWrite( data );
+  enqueueBleWrite( data );
   return true;
 }
 
@@ -987,6 +1123,10 @@ void LCTWaterCoolerWorker::disconnectFromDeviceInternal()
 {
   if ( m_bleController and m_isConnected.load() )
   {
+    // Nothing still queued matters once the device is reset; the reset
+    // jumps the queue anyway, and goes out within one write gap
+    m_bleQueue.clear();
+
     // Send reset command before disconnecting, then disconnect after a short delay
     writeCommand( QByteArray::fromHex( "fe190001000000ef" ) );
     QTimer::singleShot( 100, this,
@@ -1025,12 +1165,23 @@ bool LCTWaterCoolerWorker::setupBleController( const QBluetoothDeviceInfo& devic
            } );
   connect( m_bleController, &QLowEnergyController::discoveryFinished, this,
            &LCTWaterCoolerWorker::onServiceDiscoveryFinished );
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 5, 0 )
+  connect( m_bleController, &QLowEnergyController::rssiRead, this,
+           [this]( qint16 rssi )
+           {
+             if ( m_metricsStore )
+               m_metricsStore->push( MetricId::WaterCoolerRssi, static_cast< double >( rssi ) );
+           } );
+#endif
 
   return true;
 }
 
 void LCTWaterCoolerWorker::cleanupBleController()
 {
+  m_bleQueueTimer->stop();
+  m_bleQueue.clear();
+
   if ( m_uartService )
   {
     m_uartService->disconnect();
@@ -1263,6 +1414,10 @@ void LCTWaterCoolerWorker::sendKeepaliveProbe()
   {
     // Successfully verified controller is still alive
     m_missedKeepalives = 0;
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 5, 0 )
+    if ( m_metricsStore )
+      m_bleController->readRssi();
+#endif
     return;
   }
 
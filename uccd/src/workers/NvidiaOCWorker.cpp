@@ -14,6 +14,7 @@
  */
 
 #include "workers/NvidiaOCWorker.hpp"
+#include "UccTrace.hpp"
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -42,6 +43,22 @@ std::string NvidiaOCWorker::getOCStateJSON( unsigned int deviceIndex ) const
   if ( !isAvailable() )
     return "{}";
 
+  // Held across the driver query so concurrent callers share one refresh
+  std::lock_guard< std::mutex > lock( m_cacheMutex );
+  const auto now = std::chrono::steady_clock::now();
+  if ( auto it = m_stateCache.find( deviceIndex );
+       it != m_stateCache.end() && now - it->second.fetched < OC_STATE_REFRESH )
+    return it->second.json;
+
+  std::string json = buildOCStateJSON( deviceIndex );
+  // Failed queries are not cached so the next request retries
+  if ( json != "{}" )
+    m_stateCache[deviceIndex] = CachedState { json, now };
+  return json;
+}
+
+std::string NvidiaOCWorker::buildOCStateJSON( unsigned int deviceIndex ) const
+{
   auto stateOpt = m_nvml->getOCState( deviceIndex );
   if ( !stateOpt )
     return "{}";
@@ -152,9 +169,12 @@ bool NvidiaOCWorker::setClockOffset( unsigned int deviceIndex,
 
   bool ok = m_nvml->setClockOffset( deviceIndex, ct, ps, offsetMHz );
   if ( ok )
+  {
+    invalidate( deviceIndex );
     log( "Set clock offset: type=" + std::to_string( clockType ) +
          " pstate=" + std::to_string( pstate ) +
          " offset=" + std::to_string( offsetMHz ) + " MHz" );
+  }
   return ok;
 }
 
@@ -167,7 +187,10 @@ bool NvidiaOCWorker::setGpuLockedClocks( unsigned int deviceIndex,
 
   bool ok = m_nvml->setGpuLockedClocks( deviceIndex, minMHz, maxMHz );
   if ( ok )
+  {
+    invalidate( deviceIndex );
     log( "Set GPU locked clocks: " + std::to_string( minMHz ) + "-" + std::to_string( maxMHz ) + " MHz" );
+  }
   return ok;
 }
 
@@ -180,7 +203,10 @@ bool NvidiaOCWorker::setVramLockedClocks( unsigned int deviceIndex,
 
   bool ok = m_nvml->setVramLockedClocks( deviceIndex, minMHz, maxMHz );
   if ( ok )
+  {
+    invalidate( deviceIndex );
     log( "Set VRAM locked clocks: " + std::to_string( minMHz ) + "-" + std::to_string( maxMHz ) + " MHz" );
+  }
   return ok;
 }
 
@@ -188,21 +214,33 @@ bool NvidiaOCWorker::resetGpuLockedClocks( unsigned int deviceIndex )
 {
   if ( !isAvailable() )
     return false;
-  return m_nvml->resetGpuLockedClocks( deviceIndex );
+
+  bool ok = m_nvml->resetGpuLockedClocks( deviceIndex );
+  if ( ok )
+    invalidate( deviceIndex );
+  return ok;
 }
 
 bool NvidiaOCWorker::resetVramLockedClocks( unsigned int deviceIndex )
 {
   if ( !isAvailable() )
     return false;
-  return m_nvml->resetVramLockedClocks( deviceIndex );
+
+  bool ok = m_nvml->resetVramLockedClocks( deviceIndex );
+  if ( ok )
+    invalidate( deviceIndex );
+  return ok;
 }
 
 bool NvidiaOCWorker::resetAllClockOffsets( unsigned int deviceIndex )
 {
   if ( !isAvailable() )
     return false;
-  return m_nvml->resetAllClockOffsets( deviceIndex );
+
+  bool ok = m_nvml->resetAllClockOffsets( deviceIndex );
+  if ( ok )
+    invalidate( deviceIndex );
+  return ok;
 }
 
 bool NvidiaOCWorker::setPowerLimit( unsigned int deviceIndex, double watts )
@@ -213,7 +251,10 @@ bool NvidiaOCWorker::setPowerLimit( unsigned int deviceIndex, double watts )
   auto mw = static_cast< unsigned int >( watts * 1000.0 );
   bool ok = m_nvml->setPowerLimit( deviceIndex, mw );
   if ( ok )
+  {
+    invalidate( deviceIndex );
     log( "Set GPU power limit: " + std::to_string( watts ) + " W" );
+  }
   return ok;
 }
 
@@ -221,11 +262,16 @@ bool NvidiaOCWorker::resetPowerLimit( unsigned int deviceIndex )
 {
   if ( !isAvailable() )
     return false;
-  return m_nvml->resetPowerLimit( deviceIndex );
+
+  bool ok = m_nvml->resetPowerLimit( deviceIndex );
+  if ( ok )
+    invalidate( deviceIndex );
+  return ok;
 }
 
 bool NvidiaOCWorker::applyGpuOCProfile( const std::string &profileJSON, unsigned int deviceIndex )
 {
+  UCC_TRACE_SCOPE_ARG( "nvml", "applyGpuOCProfile", deviceIndex );
   if ( !isAvailable() || profileJSON.empty() || profileJSON == "{}" )
     return false;
 
@@ -395,11 +441,19 @@ bool NvidiaOCWorker::resetAll( unsigned int deviceIndex )
   if ( !m_nvml->resetGpuLockedClocks( deviceIndex ) ) ok = false;
   if ( !m_nvml->resetVramLockedClocks( deviceIndex ) ) ok = false;
   if ( !m_nvml->resetPowerLimit( deviceIndex ) ) ok = false;
+  // Even a partial reset changed something
+  invalidate( deviceIndex );
   if ( ok )
     log( "Reset all GPU OC settings to defaults" );
   return ok;
 }
 
+void NvidiaOCWorker::invalidate( unsigned int deviceIndex )
+{
+  std::lock_guard< std::mutex > lock( m_cacheMutex );
+  m_stateCache.erase( deviceIndex );
+}
+
 void NvidiaOCWorker::log( const std::string &msg ) const
 {
   if ( m_logFunction )
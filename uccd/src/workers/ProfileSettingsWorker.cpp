@@ -15,7 +15,7 @@
 
 #include "workers/ProfileSettingsWorker.hpp"
 #include "PowerSupplyController.hpp"
-#include <tuxedo_io_lib/tuxedo_io_api.hh>
+#include "EcIoService.hpp"
 
 // =====================================================================
 //  Public methods
@@ -33,17 +33,17 @@ void ProfileSettingsWorker::start()
   initializeChargingSettings();
 }
 
-std::vector< TDPInfo > ProfileSettingsWorker::getTDPInfo()
+std::vector< TDPInfo > ProfileSettingsWorker::readTDPInfo( DeviceInterface &device )
 {
   std::vector< TDPInfo > tdpInfo;
 
   int nrTDPs = 0;
 
-  if ( not m_ioApi.getNumberTDPs( nrTDPs ) or nrTDPs <= 0 )
+  if ( not device.getNumberTDPs( nrTDPs ) or nrTDPs <= 0 )
     return tdpInfo;
 
   std::vector< std::string > descriptors;
-  m_ioApi.getTDPDescriptors( descriptors );
+  device.getTDPDescriptors( descriptors );
 
   for ( int i = 0; i < nrTDPs; ++i )
   {
@@ -55,9 +55,9 @@ std::vector< TDPInfo > ProfileSettingsWorker::getTDPInfo()
                         ? descriptors[ static_cast< size_t >( i ) ]
                         : "";
 
-    m_ioApi.getTDPMin( i, reinterpret_cast< int & >( info.min ) );
-    m_ioApi.getTDPMax( i, reinterpret_cast< int & >( info.max ) );
-    m_ioApi.getTDP( i, reinterpret_cast< int & >( info.current ) );
+    device.getTDPMin( i, reinterpret_cast< int & >( info.min ) );
+    device.getTDPMax( i, reinterpret_cast< int & >( info.max ) );
+    device.getTDP( i, reinterpret_cast< int & >( info.current ) );
 
     tdpInfo.push_back( info );
   }
@@ -65,19 +65,19 @@ std::vector< TDPInfo > ProfileSettingsWorker::getTDPInfo()
   return tdpInfo;
 }
 
+std::vector< TDPInfo > ProfileSettingsWorker::getTDPInfo()
+{
+  return m_ec.call( readTDPInfo );
+}
+
 bool ProfileSettingsWorker::setTDPValues( const std::vector< uint32_t > &values )
 {
-  bool allSuccess = true;
+  EcBatch writes;
 
   for ( size_t i = 0; i < values.size(); ++i )
-  {
-    if ( not m_ioApi.setTDP( static_cast< int >( i ), static_cast< int >( values[ i ] ) ) )
-    {
-      allSuccess = false;
-    }
-  }
+    writes.push_back( EcRequest::setTdp( static_cast< int >( i ), static_cast< int >( values[ i ] ) ) );
 
-  return allSuccess;
+  return m_ec.execute( writes );
 }
 
 bool ProfileSettingsWorker::applyChargingProfile( const std::string &profileDescriptor ) noexcept
@@ -193,27 +193,22 @@ bool ProfileSettingsWorker::setChargeType( const std::string &type ) noexcept
   return false;
 }
 
-void ProfileSettingsWorker::validateNVIDIACTGPOffset()
+bool ProfileSettingsWorker::nvidiaCTGPOffsetInPlace()
 {
   if ( !m_nvidiaPowerCTRLAvailable )
-    return;
+    return true;
 
-  std::ifstream file( NVIDIA_CTGP_OFFSET );
-  if ( file.is_open() )
-  {
-    int32_t currentValue = 0;
-    file >> currentValue;
-    file.close();
+  // an unreadable node is not a drift we could fix by writing
+  const auto currentValue = m_ctgpOffsetNode.read();
+  return !currentValue || *currentValue == m_lastAppliedNVIDIAOffset.load();
+}
 
-    int32_t expectedOffset = m_lastAppliedNVIDIAOffset;
+bool ProfileSettingsWorker::reapplyNVIDIACTGPOffset()
+{
+  if ( !m_nvidiaPowerCTRLAvailable )
+    return false;
 
-    if ( currentValue != expectedOffset )
-    {
-      std::cout << "[NVIDIAPowerCTRL] External change detected (current: " << currentValue
-                << ", expected: " << expectedOffset << "), re-applying profile" << std::endl;
-      applyNVIDIACTGPOffset( expectedOffset );
-    }
-  }
+  return applyNVIDIACTGPOffset( m_lastAppliedNVIDIAOffset.load() );
 }
 
 // =====================================================================
@@ -428,6 +423,12 @@ void ProfileSettingsWorker::applyODMPowerLimits()
   const UccProfile profile = m_getActiveProfile();
   const auto &odmPowerLimits = profile.odmPowerLimits;
 
+  // a dynamic or budget step must not interleave with the profile's values
+  std::lock_guard< std::mutex > lock( m_powerLimitMutex );
+  m_powerLimitBounds.clear();
+  m_profileTDPValues.clear();
+  m_tdpHardware.clear();
+
   auto tdpInfo = getTDPInfo();
 
   if ( tdpInfo.empty() )
@@ -485,6 +486,138 @@ void ProfileSettingsWorker::applyODMPowerLimits()
   }
 
   publishODMPowerLimitsJSON( tdpInfo );
+
+  // the profile's split between CPU and GPU applies again
+  m_powerBudgetArbiter.reset();
+  if ( m_budgetShift != 0 )
+  {
+    m_budgetShift = 0;
+    if ( m_nvidiaPowerCTRLAvailable )
+      applyNVIDIACTGPOffset( m_profileNVIDIAOffset );
+  }
+
+  if ( not writeSuccess )
+  {
+    m_raplLimits.restore();
+    return;
+  }
+
+  // the values just written are what the thermal controller and the budget arbiter start from
+  m_appliedTDPInfo = tdpInfo;
+  m_profileTDPValues.assign( newTDPValues.begin(), newTDPValues.end() );
+  for ( const auto &tdp : tdpInfo )
+    m_tdpHardware.push_back( { static_cast< int32_t >( tdp.min ), static_cast< int32_t >( tdp.max ) } );
+
+  if ( odmPowerLimits.controller.mode != PowerLimitMode::Dynamic )
+  {
+    m_raplLimits.restore();
+    return;
+  }
+
+  m_powerLimitBounds = PowerLimitController::boundsFor( odmPowerLimits.controller, m_profileTDPValues, m_tdpHardware );
+  m_powerLimitController.reset();
+
+  if ( not m_raplDiscovered )
+  {
+    m_raplDiscovered = true;
+    m_raplLimits.discover();
+  }
+
+  logLine( "ProfileSettingsWorker: Dynamic power limits, target " +
+           std::to_string( odmPowerLimits.controller.targetTemp ) + " °C" +
+           ( m_raplLimits.available() ? ", RAPL PL1/PL2 follow TDP 1/2" : "" ) );
+}
+
+bool ProfileSettingsWorker::writeManagedTDPValues( const std::vector< int32_t > &values )
+{
+  bool changed = false;
+  for ( size_t i = 0; i < values.size() and i < m_appliedTDPInfo.size(); ++i )
+    changed = changed or m_appliedTDPInfo[ i ].current != static_cast< uint32_t >( values[ i ] );
+
+  if ( not changed )
+    return true;
+
+  if ( not setTDPValues( std::vector< uint32_t >( values.begin(), values.end() ) ) )
+    return false;
+
+  for ( size_t i = 0; i < values.size() and i < m_appliedTDPInfo.size(); ++i )
+    m_appliedTDPInfo[ i ].current = static_cast< uint32_t >( values[ i ] );
+
+  if ( not m_powerLimitBounds.empty() and m_raplLimits.available() )
+    m_raplLimits.write( values.front(), values.size() > 1 ? values[ 1 ] : 0 );
+
+  publishODMPowerLimitsJSON( m_appliedTDPInfo );
+  return true;
+}
+
+void ProfileSettingsWorker::updateDynamicPowerLimits( const PowerLimitControllerSettings &settings, double cpuTemp,
+                                                      double fanDuty, double dtSeconds )
+{
+  std::lock_guard< std::mutex > lock( m_powerLimitMutex );
+
+  if ( m_powerLimitBounds.empty() )
+    return;
+
+  const std::vector< int32_t > values =
+    m_powerLimitController.update( settings, m_powerLimitBounds, cpuTemp, fanDuty, dtSeconds );
+
+  if ( not writeManagedTDPValues( values ) )
+  {
+    // leave the hardware alone until the profile is applied again
+    logLine( "ProfileSettingsWorker: Failed to write dynamic TDP values, holding" );
+    m_powerLimitBounds.clear();
+  }
+}
+
+void ProfileSettingsWorker::updatePowerBudget( const PowerLimitControllerSettings &settings, PowerBudgetSample sample,
+                                               double dtSeconds )
+{
+  std::lock_guard< std::mutex > lock( m_powerLimitMutex );
+
+  if ( m_profileTDPValues.empty() or m_tdpHardware.empty() or m_appliedTDPInfo.empty() or
+       settings.gpuShareWatts <= 0 or not m_nvidiaPowerCTRLAvailable or not m_cTGPAdjustmentSupported )
+    return;
+
+  // as far as both sides can follow: the combined limit stays what the profile set
+  const int32_t maxAdjustment = m_nvidiaPowerCTRLMaxPowerLimit - m_nvidiaPowerCTRLDefaultPowerLimit;
+  const int32_t cpuBase = m_profileTDPValues.front();
+  const PowerLimitBounds &cpuHardware = m_tdpHardware.front();
+  const int32_t towardsGpu =
+    std::min( { settings.gpuShareWatts, maxAdjustment - m_profileNVIDIAOffset, cpuBase - cpuHardware.min } );
+  const int32_t towardsCpu =
+    std::min( { settings.gpuShareWatts, maxAdjustment + m_profileNVIDIAOffset, cpuHardware.max - cpuBase } );
+
+  sample.cpuLimitWatts = m_appliedTDPInfo.front().current;
+  sample.gpuLimitWatts = m_nvidiaPowerCTRLDefaultPowerLimit + m_lastAppliedNVIDIAOffset.load();
+  const int32_t shift = m_powerBudgetArbiter.update( sample, -towardsCpu, towardsGpu, dtSeconds );
+  if ( shift == m_budgetShift )
+    return;
+
+  std::vector< int32_t > ceilings;
+  for ( size_t i = 0; i < m_profileTDPValues.size() and i < m_tdpHardware.size(); ++i )
+    ceilings.push_back( std::clamp( m_profileTDPValues[ i ] - shift, m_tdpHardware[ i ].min,
+                                    std::max( m_tdpHardware[ i ].min, m_tdpHardware[ i ].max ) ) );
+
+  const auto moveCpu = [this, &settings, &ceilings]() {
+    if ( m_powerLimitBounds.empty() )
+      return writeManagedTDPValues( ceilings );
+    // dynamic mode: the thermal step writes the new ceilings
+    m_powerLimitBounds = PowerLimitController::boundsFor( settings, ceilings, m_tdpHardware );
+    return true;
+  };
+  const auto moveGpu = [this, shift]() { return applyNVIDIACTGPOffset( m_profileNVIDIAOffset + shift ); };
+
+  // take from one side before giving to the other
+  const bool moved = shift > m_budgetShift ? moveCpu() and moveGpu() : moveGpu() and moveCpu();
+  if ( not moved )
+  {
+    logLine( "ProfileSettingsWorker: Failed to move power budget, holding until the profile is applied again" );
+    m_profileTDPValues.clear();
+    return;
+  }
+
+  m_budgetShift = shift;
+  logLine( "ProfileSettingsWorker: Power budget shifted " + std::to_string( shift ) + " W towards the GPU" );
 }
 
 // =====================================================================
@@ -625,7 +758,10 @@ bool ProfileSettingsWorker::applyNVIDIAPowerOffset( int32_t offset )
   if ( !m_nvidiaPowerCTRLAvailable )
     return false;
 
-  return applyNVIDIACTGPOffset( offset );
+  // the budget arbiter moves the offset relative to this one
+  std::lock_guard< std::mutex > lock( m_powerLimitMutex );
+  m_profileNVIDIAOffset = offset;
+  return applyNVIDIACTGPOffset( offset + m_budgetShift );
 }
 
 bool ProfileSettingsWorker::applyNVIDIACTGPOffset( int32_t ctgpOffset )